@@ -0,0 +1,738 @@
+//  bench.cpp  -------------------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//  Boost.Filesystem benchmark suite. Run with --help for the list of options.
+//
+//  Every benchmark is run for a number of iterations that is calibrated so that a run
+//  takes at least the specified minimum time. The run is repeated several times and
+//  the minimum, median and mean times per iteration are reported in JSON or CSV format,
+//  which is suitable for comparing the results of different library versions.
+
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/backends.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/version.hpp>
+#include <boost/container_hash/hash.hpp>
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <iostream>
+#include <algorithm>
+#include <exception>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+//! Benchmark settings
+struct settings
+{
+    //! Number of entries in every directory of the synthetic tree
+    unsigned int fanout;
+    //! Number of directory levels of the synthetic tree
+    unsigned int depth;
+    //! Size of the file used in copy benchmarks, in bytes
+    std::size_t file_size;
+    //! Minimum duration of one repetition, in milliseconds
+    unsigned int min_time_ms;
+    //! Number of repetitions of every benchmark
+    unsigned int repetitions;
+    //! Only benchmarks whose names contain this string are run
+    std::string filter;
+    //! Output CSV instead of JSON
+    bool csv;
+    //! Directory in which the benchmark files are created
+    fs::path work_dir;
+
+    settings() :
+        fanout(8u),
+        depth(3u),
+        file_size(1024u * 1024u),
+        min_time_ms(200u),
+        repetitions(5u),
+        csv(false)
+    {
+    }
+};
+
+settings g_settings;
+
+//! The clock used for measurements
+typedef std::chrono::steady_clock clock_type;
+
+//! Benchmark function. Runs the benchmark for the given number of iterations and returns the duration of the measured part, in nanoseconds.
+typedef double benchmark_function(std::size_t iterations);
+
+struct benchmark
+{
+    const char* name;
+    benchmark_function* func;
+};
+
+//! Prevents the compiler from optimizing away computations
+volatile std::size_t g_sink = 0u;
+
+inline void consume(std::size_t value)
+{
+    g_sink = g_sink + value;
+}
+
+//! Returns the time elapsed since \a start, in nanoseconds
+inline double elapsed_ns(clock_type::time_point start)
+{
+    return static_cast< double >(std::chrono::duration_cast< std::chrono::nanoseconds >(clock_type::now() - start).count());
+}
+
+void create_file(fs::path const& p, std::size_t size)
+{
+    fs::ofstream file(p, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    std::vector< char > buf(64u * 1024u);
+    for (std::size_t i = 0u; i < buf.size(); ++i)
+        buf[i] = static_cast< char >(i * 7u);
+
+    while (size > 0u)
+    {
+        std::size_t n = (std::min)(size, buf.size());
+        file.write(&buf[0], static_cast< std::streamsize >(n));
+        size -= n;
+    }
+
+    if (!file)
+        throw fs::filesystem_error("failed to create benchmark file", p, boost::system::error_code());
+}
+
+//! Creates a tree of directories with \c fanout entries in each directory, half of which are files
+void create_tree(fs::path const& root, unsigned int depth)
+{
+    fs::create_directory(root);
+    for (unsigned int i = 0u; i < g_settings.fanout; ++i)
+    {
+        const fs::path name = root / ("entry" + std::to_string(i));
+        if (depth > 1u && (i & 1u) == 0u)
+            create_tree(name, depth - 1u);
+        else
+            create_file(name, 0u);
+    }
+}
+
+//------------------------------------------------------------------------------------//
+//                                  path benchmarks                                   //
+//------------------------------------------------------------------------------------//
+
+const char* const g_sample_path = "/usr/local/include/boost/filesystem/../filesystem/./detail/path_traits.hpp";
+
+template< typename Function >
+double run_path_benchmark(std::size_t iterations, Function func)
+{
+    const fs::path p(g_sample_path);
+    const clock_type::time_point start = clock_type::now();
+    for (std::size_t i = 0u; i < iterations; ++i)
+        consume(func(p));
+    return elapsed_ns(start);
+}
+
+double path_construct(std::size_t iterations)
+{
+    return run_path_benchmark(iterations, [](fs::path const&) { return fs::path(g_sample_path).native().size(); });
+}
+
+double path_append(std::size_t iterations)
+{
+    return run_path_benchmark(iterations, [](fs::path const& p) { return (p / "name.ext").native().size(); });
+}
+
+double path_filename(std::size_t iterations)
+{
+    return run_path_benchmark(iterations, [](fs::path const& p) { return p.filename().native().size(); });
+}
+
+double path_stem(std::size_t iterations)
+{
+    return run_path_benchmark(iterations, [](fs::path const& p) { return p.stem().native().size(); });
+}
+
+double path_extension(std::size_t iterations)
+{
+    return run_path_benchmark(iterations, [](fs::path const& p) { return p.extension().native().size(); });
+}
+
+double path_parent_path(std::size_t iterations)
+{
+    return run_path_benchmark(iterations, [](fs::path const& p) { return p.parent_path().native().size(); });
+}
+
+double path_iterate(std::size_t iterations)
+{
+    return run_path_benchmark(iterations, [](fs::path const& p)
+    {
+        std::size_t n = 0u;
+        for (fs::path::iterator it = p.begin(), end = p.end(); it != end; ++it)
+            n += it->native().size();
+        return n;
+    });
+}
+
+double path_compare(std::size_t iterations)
+{
+    const fs::path other("/usr/local/include/boost/filesystem/../filesystem/./detail/path_traits.cpp");
+    return run_path_benchmark(iterations, [&other](fs::path const& p) { return static_cast< std::size_t >(p.compare(other) < 0); });
+}
+
+double path_lexically_normal(std::size_t iterations)
+{
+    return run_path_benchmark(iterations, [](fs::path const& p) { return p.lexically_normal().native().size(); });
+}
+
+double path_lexically_relative(std::size_t iterations)
+{
+    const fs::path base("/usr/local/share/doc");
+    return run_path_benchmark(iterations, [&base](fs::path const& p) { return p.lexically_relative(base).native().size(); });
+}
+
+double path_hash(std::size_t iterations)
+{
+    return run_path_benchmark(iterations, [](fs::path const& p) { return fs::hash_value(p); });
+}
+
+double path_hash_short(std::size_t iterations)
+{
+    const fs::path p("file.txt");
+    const clock_type::time_point start = clock_type::now();
+    for (std::size_t i = 0u; i < iterations; ++i)
+        consume(fs::hash_value(p));
+    return elapsed_ns(start);
+}
+
+//! Inserts paths with a distribution of lengths typical for a source tree into a hash set
+double path_hash_set(std::size_t iterations)
+{
+    std::vector< fs::path > paths;
+    paths.reserve(1024u);
+    for (unsigned int i = 0u; paths.size() < 1024u; ++i)
+    {
+        const std::string name = "file" + std::to_string(i) + (i % 3u == 0u ? ".hpp" : ".cpp");
+        paths.push_back(fs::path(name));
+        paths.push_back(fs::path("src") / name);
+        paths.push_back(fs::path("/home/user/projects/boost/libs/filesystem/src/detail") / name);
+        paths.push_back(fs::path("/home/user/projects/boost/libs/filesystem/test/issues/issue_" + std::to_string(i % 16u)) / "data" / name);
+    }
+
+    std::unordered_set< fs::path, boost::hash< fs::path > > set;
+    set.reserve(paths.size());
+    const clock_type::time_point start = clock_type::now();
+    for (std::size_t i = 0u; i < iterations; ++i)
+    {
+        fs::path const& p = paths[i % paths.size()];
+        if (!set.insert(p).second)
+            set.erase(p);
+    }
+    consume(set.size());
+    return elapsed_ns(start);
+}
+
+//------------------------------------------------------------------------------------//
+//                                iteration benchmarks                                //
+//------------------------------------------------------------------------------------//
+
+fs::path g_tree_root;
+
+void prepare_tree()
+{
+    if (g_tree_root.empty())
+    {
+        g_tree_root = g_settings.work_dir / "tree";
+        create_tree(g_tree_root, g_settings.depth);
+    }
+}
+
+double directory_iterator_bench(std::size_t iterations)
+{
+    prepare_tree();
+    const clock_type::time_point start = clock_type::now();
+    for (std::size_t i = 0u; i < iterations; ++i)
+    {
+        std::size_t n = 0u;
+        for (fs::directory_iterator it(g_tree_root), end; it != end; ++it)
+            ++n;
+        consume(n);
+    }
+    return elapsed_ns(start);
+}
+
+double recursive_directory_iterator_bench(std::size_t iterations)
+{
+    prepare_tree();
+    const clock_type::time_point start = clock_type::now();
+    for (std::size_t i = 0u; i < iterations; ++i)
+    {
+        std::size_t n = 0u;
+        for (fs::recursive_directory_iterator it(g_tree_root), end; it != end; ++it)
+            ++n;
+        consume(n);
+    }
+    return elapsed_ns(start);
+}
+
+double recursive_directory_iterator_status_bench(std::size_t iterations)
+{
+    prepare_tree();
+    const clock_type::time_point start = clock_type::now();
+    for (std::size_t i = 0u; i < iterations; ++i)
+    {
+        std::size_t n = 0u;
+        for (fs::recursive_directory_iterator it(g_tree_root), end; it != end; ++it)
+            n += static_cast< std::size_t >(it->status().type());
+        consume(n);
+    }
+    return elapsed_ns(start);
+}
+
+double remove_all_bench(std::size_t iterations)
+{
+    const fs::path root = g_settings.work_dir / "remove_all";
+    double total = 0.0;
+    for (std::size_t i = 0u; i < iterations; ++i)
+    {
+        create_tree(root, g_settings.depth);
+        const clock_type::time_point start = clock_type::now();
+        consume(static_cast< std::size_t >(fs::remove_all(root)));
+        total += elapsed_ns(start);
+    }
+    return total;
+}
+
+//------------------------------------------------------------------------------------//
+//                                 status benchmarks                                  //
+//------------------------------------------------------------------------------------//
+
+fs::path g_status_file;
+
+void prepare_status_file()
+{
+    if (g_status_file.empty())
+    {
+        g_status_file = g_settings.work_dir / "status_file";
+        create_file(g_status_file, 1024u);
+    }
+}
+
+template< typename Function >
+double run_status_benchmark(std::size_t iterations, Function func)
+{
+    prepare_status_file();
+    const clock_type::time_point start = clock_type::now();
+    for (std::size_t i = 0u; i < iterations; ++i)
+        consume(func(g_status_file));
+    return elapsed_ns(start);
+}
+
+double status_bench(std::size_t iterations)
+{
+    return run_status_benchmark(iterations, [](fs::path const& p) { return static_cast< std::size_t >(fs::status(p).type()); });
+}
+
+double status_ec_bench(std::size_t iterations)
+{
+    return run_status_benchmark(iterations, [](fs::path const& p)
+    {
+        boost::system::error_code ec;
+        return static_cast< std::size_t >(fs::status(p, ec).type());
+    });
+}
+
+double symlink_status_bench(std::size_t iterations)
+{
+    return run_status_benchmark(iterations, [](fs::path const& p) { return static_cast< std::size_t >(fs::symlink_status(p).type()); });
+}
+
+double status_missing_bench(std::size_t iterations)
+{
+    return run_status_benchmark(iterations, [](fs::path const& p)
+    {
+        boost::system::error_code ec;
+        return static_cast< std::size_t >(fs::status(p.parent_path() / "missing", ec).type());
+    });
+}
+
+double exists_bench(std::size_t iterations)
+{
+    return run_status_benchmark(iterations, [](fs::path const& p) { return static_cast< std::size_t >(fs::exists(p)); });
+}
+
+double file_size_bench(std::size_t iterations)
+{
+    return run_status_benchmark(iterations, [](fs::path const& p) { return static_cast< std::size_t >(fs::file_size(p)); });
+}
+
+double last_write_time_bench(std::size_t iterations)
+{
+    return run_status_benchmark(iterations, [](fs::path const& p) { return static_cast< std::size_t >(fs::last_write_time(p)); });
+}
+
+//------------------------------------------------------------------------------------//
+//                                  copy benchmarks                                   //
+//------------------------------------------------------------------------------------//
+
+fs::path g_copy_source;
+
+double run_copy_benchmark(std::size_t iterations, fs::copy_file_backend::type backend, fs::copy_options options)
+{
+    if (g_copy_source.empty())
+    {
+        g_copy_source = g_settings.work_dir / "copy_source";
+        create_file(g_copy_source, g_settings.file_size);
+    }
+
+    if (!fs::set_copy_file_backend(backend))
+        return -1.0;
+
+    const fs::path target = g_settings.work_dir / "copy_target";
+    double total = 0.0;
+    try
+    {
+        for (std::size_t i = 0u; i < iterations; ++i)
+        {
+            boost::system::error_code ec;
+            fs::remove(target, ec);
+            const clock_type::time_point start = clock_type::now();
+            fs::copy_file(g_copy_source, target, options, ec);
+            total += elapsed_ns(start);
+            if (ec)
+            {
+                // The requested implementation or option is not supported by the filesystem
+                total = -1.0;
+                break;
+            }
+        }
+    }
+    catch (...)
+    {
+        fs::set_copy_file_backend(fs::copy_file_backend::system_default);
+        throw;
+    }
+
+    fs::set_copy_file_backend(fs::copy_file_backend::system_default);
+    return total;
+}
+
+double copy_file_default(std::size_t iterations)
+{
+    return run_copy_benchmark(iterations, fs::copy_file_backend::system_default, fs::copy_options::none);
+}
+
+double copy_file_read_write(std::size_t iterations)
+{
+    return run_copy_benchmark(iterations, fs::copy_file_backend::read_write, fs::copy_options::none);
+}
+
+double copy_file_sendfile(std::size_t iterations)
+{
+    return run_copy_benchmark(iterations, fs::copy_file_backend::sendfile, fs::copy_options::none);
+}
+
+double copy_file_copy_file_range(std::size_t iterations)
+{
+    return run_copy_benchmark(iterations, fs::copy_file_backend::copy_file_range, fs::copy_options::none);
+}
+
+double copy_file_unbuffered(std::size_t iterations)
+{
+    return run_copy_benchmark(iterations, fs::copy_file_backend::system_default, fs::copy_options::unbuffered);
+}
+
+double copy_file_drop_cache(std::size_t iterations)
+{
+    return run_copy_benchmark(iterations, fs::copy_file_backend::system_default, fs::copy_options::drop_cache);
+}
+
+double copy_file_preserve_sparse(std::size_t iterations)
+{
+    return run_copy_benchmark(iterations, fs::copy_file_backend::system_default, fs::copy_options::preserve_sparse);
+}
+
+double copy_file_clone(std::size_t iterations)
+{
+    return run_copy_benchmark(iterations, fs::copy_file_backend::system_default, fs::copy_options::clone_required);
+}
+
+const benchmark g_benchmarks[] =
+{
+    { "path/construct", &path_construct },
+    { "path/append", &path_append },
+    { "path/filename", &path_filename },
+    { "path/stem", &path_stem },
+    { "path/extension", &path_extension },
+    { "path/parent_path", &path_parent_path },
+    { "path/iterate", &path_iterate },
+    { "path/compare", &path_compare },
+    { "path/lexically_normal", &path_lexically_normal },
+    { "path/lexically_relative", &path_lexically_relative },
+    { "path/hash_value", &path_hash },
+    { "path/hash_value_short", &path_hash_short },
+    { "path/hash_set", &path_hash_set },
+    { "iteration/directory_iterator", &directory_iterator_bench },
+    { "iteration/recursive_directory_iterator", &recursive_directory_iterator_bench },
+    { "iteration/recursive_directory_iterator_status", &recursive_directory_iterator_status_bench },
+    { "iteration/remove_all", &remove_all_bench },
+    { "status/status", &status_bench },
+    { "status/status_ec", &status_ec_bench },
+    { "status/symlink_status", &symlink_status_bench },
+    { "status/status_missing", &status_missing_bench },
+    { "status/exists", &exists_bench },
+    { "status/file_size", &file_size_bench },
+    { "status/last_write_time", &last_write_time_bench },
+    { "copy_file/default", &copy_file_default },
+    { "copy_file/read_write", &copy_file_read_write },
+    { "copy_file/sendfile", &copy_file_sendfile },
+    { "copy_file/copy_file_range", &copy_file_copy_file_range },
+    { "copy_file/unbuffered", &copy_file_unbuffered },
+    { "copy_file/drop_cache", &copy_file_drop_cache },
+    { "copy_file/preserve_sparse", &copy_file_preserve_sparse },
+    { "copy_file/clone", &copy_file_clone }
+};
+
+//------------------------------------------------------------------------------------//
+//                                       driver                                       //
+//------------------------------------------------------------------------------------//
+
+struct result
+{
+    const char* name;
+    std::size_t iterations;
+    double min_ns;
+    double median_ns;
+    double mean_ns;
+};
+
+//! Runs the benchmark. Returns \c false if the benchmark is not supported.
+bool run_benchmark(benchmark const& b, result& res)
+{
+    const double min_time_ns = static_cast< double >(g_settings.min_time_ms) * 1000000.0;
+
+    // Find the number of iterations that takes at least the minimum time
+    std::size_t iterations = 1u;
+    while (true)
+    {
+        const double duration = b.func(iterations);
+        if (duration < 0.0)
+            return false;
+        if (duration >= min_time_ns)
+            break;
+
+        std::size_t next_iterations = iterations * 10u;
+        if (duration > 0.0)
+            next_iterations = (std::min)(next_iterations, static_cast< std::size_t >(static_cast< double >(iterations) * min_time_ns * 1.2 / duration) + 1u);
+        iterations = (std::max)(next_iterations, iterations + 1u);
+    }
+
+    std::vector< double > samples;
+    samples.reserve(g_settings.repetitions);
+    for (unsigned int i = 0u; i < g_settings.repetitions; ++i)
+    {
+        const double duration = b.func(iterations);
+        if (duration < 0.0)
+            return false;
+        samples.push_back(duration / static_cast< double >(iterations));
+    }
+
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (std::size_t i = 0u; i < samples.size(); ++i)
+        sum += samples[i];
+
+    res.name = b.name;
+    res.iterations = iterations;
+    res.min_ns = samples.front();
+    res.median_ns = samples[samples.size() / 2u];
+    res.mean_ns = sum / static_cast< double >(samples.size());
+    return true;
+}
+
+void print_results(std::vector< result > const& results)
+{
+    std::cout.precision(6);
+    std::cout.setf(std::ios_base::fixed, std::ios_base::floatfield);
+    if (g_settings.csv)
+    {
+        std::cout << "name,iterations,min_ns,median_ns,mean_ns\n";
+        for (std::size_t i = 0u; i < results.size(); ++i)
+        {
+            result const& r = results[i];
+            std::cout << r.name << ',' << r.iterations << ',' << r.min_ns << ',' << r.median_ns << ',' << r.mean_ns << '\n';
+        }
+    }
+    else
+    {
+        std::cout << "{\n"
+            "  \"context\": {\n"
+            "    \"boost_version\": " << BOOST_VERSION << ",\n"
+            "    \"fanout\": " << g_settings.fanout << ",\n"
+            "    \"depth\": " << g_settings.depth << ",\n"
+            "    \"file_size\": " << g_settings.file_size << ",\n"
+            "    \"min_time_ms\": " << g_settings.min_time_ms << ",\n"
+            "    \"repetitions\": " << g_settings.repetitions << "\n"
+            "  },\n"
+            "  \"benchmarks\": [";
+        for (std::size_t i = 0u; i < results.size(); ++i)
+        {
+            result const& r = results[i];
+            std::cout << (i > 0u ? ",\n" : "\n") <<
+                "    { \"name\": \"" << r.name << "\", \"iterations\": " << r.iterations <<
+                ", \"min_ns\": " << r.min_ns << ", \"median_ns\": " << r.median_ns << ", \"mean_ns\": " << r.mean_ns << " }";
+        }
+        std::cout << "\n  ]\n}\n";
+    }
+}
+
+void print_usage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [options]\n"
+        "Options:\n"
+        "  --filter=STRING    Only run benchmarks whose names contain STRING\n"
+        "  --list             List benchmark names and exit\n"
+        "  --format=json|csv  Output format, json by default\n"
+        "  --fanout=N         Number of entries in each directory of the synthetic tree, 8 by default\n"
+        "  --depth=N          Number of directory levels of the synthetic tree, 3 by default\n"
+        "  --file-size=N      Size of the file in copy_file benchmarks, in bytes, 1048576 by default\n"
+        "  --min-time=N       Minimum duration of one repetition, in milliseconds, 200 by default\n"
+        "  --repetitions=N    Number of repetitions of each benchmark, 5 by default\n"
+        "  --dir=PATH         Directory for temporary files, the system temporary directory by default\n"
+        "Results of benchmarks that are not supported on the system or filesystem are omitted.\n";
+}
+
+//! If \a arg starts with \a name, returns a pointer to the value that follows, otherwise returns \c NULL
+const char* match_option(const char* arg, const char* name)
+{
+    const std::size_t size = std::strlen(name);
+    if (std::strncmp(arg, name, size) == 0)
+        return arg + size;
+    return NULL;
+}
+
+bool parse_number(const char* str, unsigned long& value)
+{
+    char* end = NULL;
+    value = std::strtoul(str, &end, 10);
+    return end != str && *end == '\0';
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    bool list = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg = argv[i];
+        const char* value;
+        unsigned long number = 0u;
+        if ((value = match_option(arg, "--filter=")) != NULL)
+        {
+            g_settings.filter = value;
+        }
+        else if (std::strcmp(arg, "--list") == 0)
+        {
+            list = true;
+        }
+        else if ((value = match_option(arg, "--format=")) != NULL && (std::strcmp(value, "json") == 0 || std::strcmp(value, "csv") == 0))
+        {
+            g_settings.csv = std::strcmp(value, "csv") == 0;
+        }
+        else if ((value = match_option(arg, "--fanout=")) != NULL && parse_number(value, number) && number > 0u)
+        {
+            g_settings.fanout = static_cast< unsigned int >(number);
+        }
+        else if ((value = match_option(arg, "--depth=")) != NULL && parse_number(value, number) && number > 0u)
+        {
+            g_settings.depth = static_cast< unsigned int >(number);
+        }
+        else if ((value = match_option(arg, "--file-size=")) != NULL && parse_number(value, number))
+        {
+            g_settings.file_size = static_cast< std::size_t >(number);
+        }
+        else if ((value = match_option(arg, "--min-time=")) != NULL && parse_number(value, number))
+        {
+            g_settings.min_time_ms = static_cast< unsigned int >(number);
+        }
+        else if ((value = match_option(arg, "--repetitions=")) != NULL && parse_number(value, number) && number > 0u)
+        {
+            g_settings.repetitions = static_cast< unsigned int >(number);
+        }
+        else if ((value = match_option(arg, "--dir=")) != NULL)
+        {
+            g_settings.work_dir = value;
+        }
+        else
+        {
+            print_usage(argv[0]);
+            return std::strcmp(arg, "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    const std::size_t benchmark_count = sizeof(g_benchmarks) / sizeof(*g_benchmarks);
+    if (list)
+    {
+        for (std::size_t i = 0u; i < benchmark_count; ++i)
+            std::cout << g_benchmarks[i].name << '\n';
+        return 0;
+    }
+
+    try
+    {
+        if (g_settings.work_dir.empty())
+            g_settings.work_dir = fs::temp_directory_path();
+        g_settings.work_dir /= fs::unique_path("boost_fs_bench-%%%%-%%%%-%%%%");
+        fs::create_directories(g_settings.work_dir);
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Failed to create the benchmark directory: " << e.what() << std::endl;
+        return 1;
+    }
+
+    int exit_code = 0;
+    std::vector< result > results;
+    try
+    {
+        for (std::size_t i = 0u; i < benchmark_count; ++i)
+        {
+            benchmark const& b = g_benchmarks[i];
+            if (!g_settings.filter.empty() && std::strstr(b.name, g_settings.filter.c_str()) == NULL)
+                continue;
+
+            std::cerr << "Running " << b.name << "..." << std::endl;
+            result res;
+            if (run_benchmark(b, res))
+                results.push_back(res);
+            else
+                std::cerr << "  not supported, skipped" << std::endl;
+        }
+
+        print_results(results);
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        exit_code = 1;
+    }
+
+    boost::system::error_code ec;
+    fs::remove_all(g_settings.work_dir, ec);
+
+    return exit_code;
+}
@@ -0,0 +1,639 @@
+//  scalability.cpp  -------------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//  Boost.Filesystem multi-threaded scalability benchmark. Run with --help for the list of options.
+//
+//  Every workload is run concurrently by an increasing number of threads for a fixed duration.
+//  Each thread operates on its own files and directories, so that the operating system does not
+//  serialize the threads and any loss of throughput is caused by the state shared in the library,
+//  such as the path locale, the function pointers resolved at run time or reference counters.
+//  For every thread count, the throughput, the throughput per core and the scaling efficiency
+//  relative to a single thread are reported, along with the number of cache misses (on Linux,
+//  if performance counters are accessible) and the number of voluntary context switches, which
+//  indicate blocking on locks.
+
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/version.hpp>
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <exception>
+
+#if defined(BOOST_POSIX_API)
+#include <sys/resource.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#define BOOST_FILESYSTEM_BENCH_HAS_PERF_EVENTS
+#endif
+#endif
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+//! Benchmark settings
+struct settings
+{
+    //! Thread counts to run every workload with
+    std::vector< unsigned int > thread_counts;
+    //! Duration of the run for every thread count, in milliseconds
+    unsigned int duration_ms;
+    //! Minimum scaling efficiency at the largest thread count, the benchmark fails if any workload scales worse
+    double min_efficiency;
+    //! Only workloads whose names contain this string are run
+    std::string filter;
+    //! Output CSV instead of JSON
+    bool csv;
+    //! Directory in which the benchmark files are created
+    fs::path work_dir;
+
+    settings() :
+        duration_ms(1000u),
+        min_efficiency(0.0),
+        csv(false)
+    {
+    }
+};
+
+settings g_settings;
+
+//! The clock used for measurements
+typedef std::chrono::steady_clock clock_type;
+
+//! Prevents the compiler from optimizing away computations
+std::atomic< std::size_t > g_sink(0u);
+
+//! Number of entries in the directory of every thread
+const unsigned int directory_size = 16u;
+
+//! Returns the directory used by the thread with the given index
+fs::path thread_directory(unsigned int index)
+{
+    return g_settings.work_dir / ("thread" + std::to_string(index));
+}
+
+void create_file(fs::path const& p)
+{
+    fs::ofstream file(p, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    file << "data";
+
+    if (!file)
+        throw fs::filesystem_error("failed to create benchmark file", p, boost::system::error_code());
+}
+
+//! Creates the directory of the thread with the given index, with \c directory_size entries, one of which is a subdirectory
+void create_thread_directory(unsigned int index)
+{
+    const fs::path dir = thread_directory(index);
+    fs::create_directory(dir);
+    fs::create_directory(dir / "subdir");
+    for (unsigned int i = 1u; i < directory_size; ++i)
+        create_file(dir / ("file" + std::to_string(i)));
+}
+
+//------------------------------------------------------------------------------------//
+//                                     workloads                                      //
+//------------------------------------------------------------------------------------//
+
+//! Per-thread state of a workload
+struct thread_context
+{
+    fs::path dir;
+    fs::path file;
+    fs::path dotted;
+    std::size_t sink;
+};
+
+//! Workload function. Performs one operation of the workload.
+typedef void workload_function(thread_context& ctx);
+
+struct workload
+{
+    const char* name;
+    workload_function* func;
+};
+
+//! Constructs a path from a wide string and converts it back, which uses the path locale on POSIX systems
+void path_convert(thread_context& ctx)
+{
+#if defined(BOOST_WINDOWS_API)
+    const fs::path p("C:\\Users\\user\\projects\\boost\\libs\\filesystem\\src\\operations.cpp");
+    ctx.sink += p.string().size();
+#else
+    const fs::path p(L"/home/user/projects/boost/libs/filesystem/src/operations.cpp");
+    ctx.sink += p.wstring().size();
+#endif
+}
+
+//! Decomposes and composes paths without conversions, this workload is expected to scale linearly
+void path_decompose(thread_context& ctx)
+{
+    const fs::path p("/home/user/projects/boost/libs/filesystem/src/../include/./boost/filesystem.hpp");
+    ctx.sink += (p.parent_path() / p.filename()).lexically_normal().native().size();
+}
+
+void status_workload(thread_context& ctx)
+{
+    ctx.sink += static_cast< std::size_t >(fs::status(ctx.file).type());
+}
+
+void status_ec_workload(thread_context& ctx)
+{
+    boost::system::error_code ec;
+    ctx.sink += static_cast< std::size_t >(fs::status(ctx.file, ec).type());
+}
+
+void canonical_workload(thread_context& ctx)
+{
+    ctx.sink += fs::canonical(ctx.dotted).native().size();
+}
+
+void directory_iterator_workload(thread_context& ctx)
+{
+    for (fs::directory_iterator it(ctx.dir), end; it != end; ++it)
+        ++ctx.sink;
+}
+
+void directory_iterator_status_workload(thread_context& ctx)
+{
+    for (fs::directory_iterator it(ctx.dir), end; it != end; ++it)
+        ctx.sink += static_cast< std::size_t >(it->status().type());
+}
+
+const workload g_workloads[] =
+{
+    { "path/convert", &path_convert },
+    { "path/decompose", &path_decompose },
+    { "status/status", &status_workload },
+    { "status/status_ec", &status_ec_workload },
+    { "canonical/canonical", &canonical_workload },
+    { "iteration/directory_iterator", &directory_iterator_workload },
+    { "iteration/directory_iterator_status", &directory_iterator_status_workload }
+};
+
+//------------------------------------------------------------------------------------//
+//                                      counters                                      //
+//------------------------------------------------------------------------------------//
+
+//! Counts events of the process, including the threads created after the counters are started
+class event_counters
+{
+private:
+#if defined(BOOST_FILESYSTEM_BENCH_HAS_PERF_EVENTS)
+    int m_cache_misses_fd;
+#endif
+#if defined(BOOST_POSIX_API)
+    long m_context_switches;
+#endif
+
+public:
+    event_counters()
+    {
+#if defined(BOOST_FILESYSTEM_BENCH_HAS_PERF_EVENTS)
+        // Count the cache misses of the calling thread and the threads it creates afterwards. The counts of the threads
+        // are added to the counter when the threads exit. This fails if perf_event_paranoid does not allow profiling.
+        struct perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.inherit = 1;
+        attr.exclude_hv = 1;
+        m_cache_misses_fd = static_cast< int >(::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+#if defined(BOOST_POSIX_API)
+        m_context_switches = voluntary_context_switches();
+#endif
+    }
+
+    ~event_counters()
+    {
+#if defined(BOOST_FILESYSTEM_BENCH_HAS_PERF_EVENTS)
+        if (m_cache_misses_fd >= 0)
+            ::close(m_cache_misses_fd);
+#endif
+    }
+
+    //! Returns the number of cache misses since construction, or -1 if not supported. Must be called after the measured threads exit.
+    double cache_misses() const
+    {
+#if defined(BOOST_FILESYSTEM_BENCH_HAS_PERF_EVENTS)
+        unsigned long long value = 0u;
+        if (m_cache_misses_fd >= 0 && ::read(m_cache_misses_fd, &value, sizeof(value)) == static_cast< ssize_t >(sizeof(value)))
+            return static_cast< double >(value);
+#endif
+        return -1.0;
+    }
+
+    //! Returns the number of voluntary context switches since construction, or -1 if not supported. Must be called after the measured threads exit.
+    double context_switches() const
+    {
+#if defined(BOOST_POSIX_API)
+        const long value = voluntary_context_switches();
+        if (value >= 0 && m_context_switches >= 0)
+            return static_cast< double >(value - m_context_switches);
+#endif
+        return -1.0;
+    }
+
+    event_counters(event_counters const&) = delete;
+    event_counters& operator=(event_counters const&) = delete;
+
+private:
+#if defined(BOOST_POSIX_API)
+    static long voluntary_context_switches()
+    {
+        struct rusage usage;
+        if (::getrusage(RUSAGE_SELF, &usage) != 0)
+            return -1;
+        return usage.ru_nvcsw;
+    }
+#endif
+};
+
+//------------------------------------------------------------------------------------//
+//                                       driver                                       //
+//------------------------------------------------------------------------------------//
+
+struct result
+{
+    const char* name;
+    unsigned int threads;
+    double operations;
+    double ops_per_sec;
+    double ops_per_sec_per_core;
+    double efficiency;
+    double cache_misses_per_op;
+    double context_switches_per_op;
+};
+
+//! Operation counter of a thread, aligned to avoid false sharing between the threads
+struct alignas(64) thread_counter
+{
+    std::atomic< std::size_t > operations;
+};
+
+//! Synchronizes the start of the threads
+class start_gate
+{
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    unsigned int m_waiting;
+    bool m_open;
+
+public:
+    start_gate() : m_waiting(0u), m_open(false) {}
+
+    void wait()
+    {
+        std::unique_lock< std::mutex > lock(m_mutex);
+        ++m_waiting;
+        m_cond.notify_all();
+        while (!m_open)
+            m_cond.wait(lock);
+    }
+
+    void open_when_waiting(unsigned int count)
+    {
+        std::unique_lock< std::mutex > lock(m_mutex);
+        while (m_waiting < count)
+            m_cond.wait(lock);
+        m_open = true;
+        m_cond.notify_all();
+    }
+};
+
+//! Runs the workload in \a thread_count threads and returns the results, with efficiency unset
+result run_workload(workload const& w, unsigned int thread_count)
+{
+    std::vector< thread_counter > counters(thread_count);
+    std::vector< std::exception_ptr > errors(thread_count);
+    std::atomic< bool > stop(false);
+    start_gate gate;
+
+    event_counters events;
+    std::vector< std::thread > threads;
+    threads.reserve(thread_count);
+    for (unsigned int i = 0u; i < thread_count; ++i)
+    {
+        threads.emplace_back([&w, &counters, &errors, &stop, &gate, i]()
+        {
+            try
+            {
+                thread_context ctx;
+                ctx.dir = thread_directory(i);
+                ctx.file = ctx.dir / "file1";
+                ctx.dotted = ctx.dir / "subdir" / ".." / "." / "file1";
+                ctx.sink = 0u;
+
+                std::size_t operations = 0u;
+                gate.wait();
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    w.func(ctx);
+                    ++operations;
+                }
+
+                counters[i].operations.store(operations, std::memory_order_relaxed);
+                g_sink.fetch_add(ctx.sink, std::memory_order_relaxed);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+                gate.wait();
+            }
+        });
+    }
+
+    gate.open_when_waiting(thread_count);
+    const clock_type::time_point start = clock_type::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(g_settings.duration_ms));
+    stop.store(true, std::memory_order_relaxed);
+    const double duration_s = std::chrono::duration< double >(clock_type::now() - start).count();
+
+    for (std::size_t i = 0u; i < threads.size(); ++i)
+        threads[i].join();
+
+    for (std::size_t i = 0u; i < errors.size(); ++i)
+    {
+        if (errors[i])
+            std::rethrow_exception(errors[i]);
+    }
+
+    double operations = 0.0;
+    for (std::size_t i = 0u; i < counters.size(); ++i)
+        operations += static_cast< double >(counters[i].operations.load(std::memory_order_relaxed));
+
+    unsigned int cores = std::thread::hardware_concurrency();
+    if (cores == 0u || cores > thread_count)
+        cores = thread_count;
+
+    result res;
+    res.name = w.name;
+    res.threads = thread_count;
+    res.operations = operations;
+    res.ops_per_sec = operations / duration_s;
+    res.ops_per_sec_per_core = res.ops_per_sec / static_cast< double >(cores);
+    res.efficiency = 1.0;
+
+    const double cache_misses = events.cache_misses();
+    res.cache_misses_per_op = (cache_misses >= 0.0 && operations > 0.0) ? cache_misses / operations : -1.0;
+    const double context_switches = events.context_switches();
+    res.context_switches_per_op = (context_switches >= 0.0 && operations > 0.0) ? context_switches / operations : -1.0;
+
+    return res;
+}
+
+void print_value(double value)
+{
+    if (value >= 0.0)
+        std::cout << value;
+    else
+        std::cout << (g_settings.csv ? "" : "null");
+}
+
+void print_results(std::vector< result > const& results)
+{
+    std::cout.precision(6);
+    std::cout.setf(std::ios_base::fixed, std::ios_base::floatfield);
+    if (g_settings.csv)
+    {
+        std::cout << "name,threads,operations,ops_per_sec,ops_per_sec_per_core,efficiency,cache_misses_per_op,context_switches_per_op\n";
+        for (std::size_t i = 0u; i < results.size(); ++i)
+        {
+            result const& r = results[i];
+            std::cout << r.name << ',' << r.threads << ',' << r.operations << ',' << r.ops_per_sec << ',' << r.ops_per_sec_per_core << ',' << r.efficiency << ',';
+            print_value(r.cache_misses_per_op);
+            std::cout << ',';
+            print_value(r.context_switches_per_op);
+            std::cout << '\n';
+        }
+    }
+    else
+    {
+        std::cout << "{\n"
+            "  \"context\": {\n"
+            "    \"boost_version\": " << BOOST_VERSION << ",\n"
+            "    \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n"
+            "    \"duration_ms\": " << g_settings.duration_ms << "\n"
+            "  },\n"
+            "  \"benchmarks\": [";
+        for (std::size_t i = 0u; i < results.size(); ++i)
+        {
+            result const& r = results[i];
+            std::cout << (i > 0u ? ",\n" : "\n") <<
+                "    { \"name\": \"" << r.name << "\", \"threads\": " << r.threads << ", \"operations\": " << r.operations <<
+                ", \"ops_per_sec\": " << r.ops_per_sec << ", \"ops_per_sec_per_core\": " << r.ops_per_sec_per_core <<
+                ", \"efficiency\": " << r.efficiency << ", \"cache_misses_per_op\": ";
+            print_value(r.cache_misses_per_op);
+            std::cout << ", \"context_switches_per_op\": ";
+            print_value(r.context_switches_per_op);
+            std::cout << " }";
+        }
+        std::cout << "\n  ]\n}\n";
+    }
+}
+
+void print_usage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [options]\n"
+        "Options:\n"
+        "  --filter=STRING        Only run workloads whose names contain STRING\n"
+        "  --list                 List workload names and exit\n"
+        "  --format=json|csv      Output format, json by default\n"
+        "  --threads=N[,N...]     Thread counts, powers of two up to the number of cores by default\n"
+        "  --duration=N           Duration of the run for every thread count, in milliseconds, 1000 by default\n"
+        "  --min-efficiency=F     Fail if the throughput per core at the largest thread count is less than F\n"
+        "                         times the single-thread throughput for any workload, 0 by default\n"
+        "  --dir=PATH             Directory for temporary files, the system temporary directory by default\n"
+        "The efficiency is relative to the smallest thread count. Cache misses and context switches are\n"
+        "reported per operation and are null if not supported on the system.\n";
+}
+
+//! If \a arg starts with \a name, returns a pointer to the value that follows, otherwise returns \c NULL
+const char* match_option(const char* arg, const char* name)
+{
+    const std::size_t size = std::strlen(name);
+    if (std::strncmp(arg, name, size) == 0)
+        return arg + size;
+    return NULL;
+}
+
+bool parse_number(const char* str, unsigned long& value)
+{
+    char* end = NULL;
+    value = std::strtoul(str, &end, 10);
+    return end != str && *end == '\0';
+}
+
+bool parse_thread_counts(const char* str, std::vector< unsigned int >& counts)
+{
+    counts.clear();
+    while (true)
+    {
+        char* end = NULL;
+        const unsigned long value = std::strtoul(str, &end, 10);
+        if (end == str || value == 0u || value > 4096u)
+            return false;
+        counts.push_back(static_cast< unsigned int >(value));
+        if (*end == '\0')
+            break;
+        if (*end != ',')
+            return false;
+        str = end + 1;
+    }
+
+    std::sort(counts.begin(), counts.end());
+    counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+    return true;
+}
+
+bool parse_fraction(const char* str, double& value)
+{
+    char* end = NULL;
+    value = std::strtod(str, &end);
+    return end != str && *end == '\0' && value >= 0.0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    bool list = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg = argv[i];
+        const char* value;
+        unsigned long number = 0u;
+        if ((value = match_option(arg, "--filter=")) != NULL)
+        {
+            g_settings.filter = value;
+        }
+        else if (std::strcmp(arg, "--list") == 0)
+        {
+            list = true;
+        }
+        else if ((value = match_option(arg, "--format=")) != NULL && (std::strcmp(value, "json") == 0 || std::strcmp(value, "csv") == 0))
+        {
+            g_settings.csv = std::strcmp(value, "csv") == 0;
+        }
+        else if ((value = match_option(arg, "--threads=")) != NULL && parse_thread_counts(value, g_settings.thread_counts))
+        {
+        }
+        else if ((value = match_option(arg, "--duration=")) != NULL && parse_number(value, number) && number > 0u)
+        {
+            g_settings.duration_ms = static_cast< unsigned int >(number);
+        }
+        else if ((value = match_option(arg, "--min-efficiency=")) != NULL && parse_fraction(value, g_settings.min_efficiency))
+        {
+        }
+        else if ((value = match_option(arg, "--dir=")) != NULL)
+        {
+            g_settings.work_dir = value;
+        }
+        else
+        {
+            print_usage(argv[0]);
+            return std::strcmp(arg, "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    const std::size_t workload_count = sizeof(g_workloads) / sizeof(*g_workloads);
+    if (list)
+    {
+        for (std::size_t i = 0u; i < workload_count; ++i)
+            std::cout << g_workloads[i].name << '\n';
+        return 0;
+    }
+
+    if (g_settings.thread_counts.empty())
+    {
+        const unsigned int cores = (std::max)(std::thread::hardware_concurrency(), 1u);
+        for (unsigned int n = 1u; n < cores; n *= 2u)
+            g_settings.thread_counts.push_back(n);
+        g_settings.thread_counts.push_back(cores);
+    }
+
+    try
+    {
+        if (g_settings.work_dir.empty())
+            g_settings.work_dir = fs::temp_directory_path();
+        g_settings.work_dir /= fs::unique_path("boost_fs_scalability-%%%%-%%%%-%%%%");
+        fs::create_directories(g_settings.work_dir);
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Failed to create the benchmark directory: " << e.what() << std::endl;
+        return 1;
+    }
+
+    int exit_code = 0;
+    std::vector< result > results;
+    try
+    {
+        for (unsigned int i = 0u, n = g_settings.thread_counts.back(); i < n; ++i)
+            create_thread_directory(i);
+
+        for (std::size_t i = 0u; i < workload_count; ++i)
+        {
+            workload const& w = g_workloads[i];
+            if (!g_settings.filter.empty() && std::strstr(w.name, g_settings.filter.c_str()) == NULL)
+                continue;
+
+            const std::size_t first = results.size();
+            for (std::size_t j = 0u; j < g_settings.thread_counts.size(); ++j)
+            {
+                const unsigned int thread_count = g_settings.thread_counts[j];
+                std::cerr << "Running " << w.name << " with " << thread_count << " threads..." << std::endl;
+                result res = run_workload(w, thread_count);
+                if (results.size() > first && results[first].ops_per_sec_per_core > 0.0)
+                    res.efficiency = res.ops_per_sec_per_core / results[first].ops_per_sec_per_core;
+                results.push_back(res);
+            }
+
+            result const& last = results.back();
+            if (last.efficiency < g_settings.min_efficiency)
+            {
+                std::cerr << "  " << w.name << " scales poorly: efficiency " << last.efficiency << " with " << last.threads <<
+                    " threads is less than " << g_settings.min_efficiency << std::endl;
+                exit_code = 1;
+            }
+        }
+
+        print_results(results);
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        exit_code = 1;
+    }
+
+    boost::system::error_code ec;
+    fs::remove_all(g_settings.work_dir, ec);
+
+    return exit_code;
+}
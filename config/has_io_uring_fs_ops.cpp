@@ -0,0 +1,28 @@
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+#include "platform_config.hpp"
+
+#include <cstring>
+#include <sys/types.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+
+int main()
+{
+    struct io_uring_sqe sqe;
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_RENAMEAT;
+    sqe.rename_flags = 0u;
+    sqe.opcode = IORING_OP_UNLINKAT;
+    sqe.unlink_flags = AT_REMOVEDIR;
+    sqe.opcode = IORING_OP_MKDIRAT;
+    sqe.fd = AT_FDCWD;
+
+    return sqe.opcode;
+}
@@ -0,0 +1,32 @@
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+#include "platform_config.hpp"
+
+#include <cstring>
+#include <sys/types.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+
+int main()
+{
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    long fd = syscall(__NR_io_uring_setup, 16u, &params);
+
+    struct io_uring_sqe sqe;
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_STATX;
+    sqe.fd = AT_FDCWD;
+    sqe.statx_flags = AT_NO_AUTOMOUNT;
+
+    long res = syscall(__NR_io_uring_enter, static_cast< int >(fd), 1u, 1u, IORING_ENTER_GETEVENTS, static_cast< void* >(NULL), 0u);
+
+    return (params.features & IORING_FEAT_SINGLE_MMAP) != 0u && res == 0;
+}
@@ -0,0 +1,17 @@
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+#include "platform_config.hpp"
+
+#include <string.h>
+
+int main()
+{
+    const char str[] = "foo/bar/baz";
+    const void* p = memrchr(str, '/', sizeof(str) - 1u);
+    return p != str + 7;
+}
@@ -0,0 +1,16 @@
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+#include "platform_config.hpp"
+
+#include <sys/sdt.h>
+
+int main(int argc, char* argv[])
+{
+    DTRACE_PROBE(boost_filesystem, config_check);
+    DTRACE_PROBE2(boost_filesystem, config_check_args, argc, argv[0]);
+}
@@ -0,0 +1,20 @@
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+#include "platform_config.hpp"
+
+#include <windows.h>
+#include <TraceLoggingProvider.h>
+
+TRACELOGGING_DEFINE_PROVIDER(g_provider, "Boost.Filesystem.ConfigCheck", (0x5d3b8f42, 0x0c6e, 0x4b2a, 0x9e, 0x51, 0x7a, 0x1f, 0x22, 0xc4, 0x90, 0x3d));
+
+int main()
+{
+    TraceLoggingRegister(g_provider);
+    TraceLoggingWrite(g_provider, "config_check", TraceLoggingValue(L"path", "arg1"), TraceLoggingValue(1, "arg2"));
+    TraceLoggingUnregister(g_provider);
+}
@@ -14,8 +14,10 @@
 
 #include <boost/filesystem/config.hpp>
 #include <boost/filesystem/path.hpp>
+#include <boost/filesystem/path_view.hpp>
 #include <boost/filesystem/exception.hpp>
 #include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/directory_handle.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/file_status.hpp>
 #include <boost/filesystem/convenience.hpp>
@@ -0,0 +1,260 @@
+//  boost/filesystem/async_context.hpp  ------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_ASYNC_CONTEXT_HPP
+#define BOOST_FILESYSTEM_ASYNC_CONTEXT_HPP
+
+#include <boost/filesystem/config.hpp>
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES) && !defined(BOOST_NO_CXX11_HDR_TYPE_TRAITS)
+
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include <boost/system/error_code.hpp>
+
+#define BOOST_FILESYSTEM_HAS_ASYNC_CONTEXT
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+namespace detail {
+
+//! Base class for asynchronous operations
+struct async_operation
+{
+    enum operation_kind
+    {
+        status_operation,
+        symlink_status_operation,
+        copy_file_operation,
+        remove_operation,
+        rename_operation,
+        create_directory_operation,
+        directory_entries_operation
+    };
+
+    //! Next operation in the queue
+    async_operation* next;
+    //! Indicates that the operation has been performed and only the completion handler needs to be called
+    bool done;
+    const operation_kind kind;
+    path path1;
+    path path2;
+    unsigned int options;
+
+    // Operation results
+    system::error_code error;
+    file_status status;
+    bool result;
+    std::vector< directory_entry > entries;
+
+    async_operation(operation_kind k, path const& p1, path const& p2, unsigned int opts) :
+        next(NULL), done(false), kind(k), path1(p1), path2(p2), options(opts), result(false)
+    {
+    }
+
+    BOOST_DELETED_FUNCTION(async_operation(async_operation const&))
+    BOOST_DELETED_FUNCTION(async_operation& operator=(async_operation const&))
+
+public:
+    virtual ~async_operation() {}
+
+    //! Invokes the completion handler and destroys the operation
+    virtual void complete() BOOST_NOEXCEPT = 0;
+};
+
+//! Asynchronous operation that passes an error code to the completion handler
+template< typename Handler >
+class async_void_operation :
+    public async_operation
+{
+private:
+    Handler m_handler;
+
+public:
+    template< typename H >
+    async_void_operation(H&& handler, operation_kind k, path const& p1, path const& p2, unsigned int opts) :
+        async_operation(k, p1, p2, opts),
+        m_handler(std::forward< H >(handler))
+    {
+    }
+
+    void complete() BOOST_NOEXCEPT BOOST_OVERRIDE
+    {
+        // Free the operation before calling the handler, so that the handler is able to start new operations without growing memory consumption
+        Handler handler(std::move(m_handler));
+        const system::error_code ec = this->error;
+        delete this;
+        handler(ec);
+    }
+};
+
+//! Asynchronous operation that passes an error code and the result stored in the \c Member of the operation to the completion handler
+template< typename Handler, typename Result, Result async_operation::*Member >
+class async_result_operation :
+    public async_operation
+{
+private:
+    Handler m_handler;
+
+public:
+    template< typename H >
+    async_result_operation(H&& handler, operation_kind k, path const& p1, path const& p2, unsigned int opts) :
+        async_operation(k, p1, p2, opts),
+        m_handler(std::forward< H >(handler))
+    {
+    }
+
+    void complete() BOOST_NOEXCEPT BOOST_OVERRIDE
+    {
+        Handler handler(std::move(m_handler));
+        const system::error_code ec = this->error;
+        Result result(std::move(this->*Member));
+        delete this;
+        handler(ec, std::move(result));
+    }
+};
+
+class async_context_impl;
+
+} // namespace detail
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                                  async_context                                     //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! Executes filesystem operations asynchronously and invokes completion handlers
+/*!
+ * The context owns a pool of worker threads that perform the operations. On Linux, status queries, removal, renaming
+ * and directory creation are submitted to an io_uring instance, if supported by the kernel, and the worker threads
+ * are only used for invoking completion handlers and performing operations that are not supported by io_uring.
+ *
+ * Completion handlers are invoked in the worker threads of the context and must not throw. Handlers may start new
+ * operations. To resume execution in a different executor, e.g. an Asio \c io_context, the handler should post
+ * a function object to that executor. The context destructor waits for all operations, including the ones started
+ * by completion handlers, to complete.
+ */
+class async_context
+{
+private:
+    detail::async_context_impl* m_impl;
+
+public:
+    //! Creates the context with \a thread_count worker threads. Zero means the number of hardware threads.
+    BOOST_FILESYSTEM_DECL explicit async_context(unsigned int thread_count = 0u);
+    //! Waits for all pending operations to complete and destroys the context
+    BOOST_FILESYSTEM_DECL ~async_context();
+
+    BOOST_DELETED_FUNCTION(async_context(async_context const&))
+    BOOST_DELETED_FUNCTION(async_context& operator=(async_context const&))
+
+public:
+    //! Waits until all operations started so far, as well as the operations started by their completion handlers, complete
+    BOOST_FILESYSTEM_DECL void wait();
+
+    //! Queries status of \a p. The handler is called as <tt>handler(error_code, file_status)</tt>, with the results equivalent to <tt>status(p, ec)</tt>.
+    template< typename Handler >
+    void async_status(path const& p, Handler&& handler)
+    {
+        start< detail::async_result_operation< typename std::decay< Handler >::type, file_status, &detail::async_operation::status > >(
+            std::forward< Handler >(handler), detail::async_operation::status_operation, p, path(), 0u);
+    }
+
+    //! Queries status of \a p without following symlinks. The handler is called as <tt>handler(error_code, file_status)</tt>.
+    template< typename Handler >
+    void async_symlink_status(path const& p, Handler&& handler)
+    {
+        start< detail::async_result_operation< typename std::decay< Handler >::type, file_status, &detail::async_operation::status > >(
+            std::forward< Handler >(handler), detail::async_operation::symlink_status_operation, p, path(), 0u);
+    }
+
+    //! Copies file \a from to \a to. The handler is called as <tt>handler(error_code, bool)</tt>, with the result of <tt>copy_file(from, to, options, ec)</tt>.
+    template< typename Handler >
+    void async_copy_file(path const& from, path const& to, BOOST_SCOPED_ENUM_NATIVE(copy_options) options, Handler&& handler)
+    {
+        start< detail::async_result_operation< typename std::decay< Handler >::type, bool, &detail::async_operation::result > >(
+            std::forward< Handler >(handler), detail::async_operation::copy_file_operation, from, to, static_cast< unsigned int >(options));
+    }
+
+    template< typename Handler >
+    void async_copy_file(path const& from, path const& to, Handler&& handler)
+    {
+        async_copy_file(from, to, copy_options::none, std::forward< Handler >(handler));
+    }
+
+    //! Removes \a p. The handler is called as <tt>handler(error_code, bool)</tt>, with the result of <tt>remove(p, ec)</tt>.
+    template< typename Handler >
+    void async_remove(path const& p, Handler&& handler)
+    {
+        start< detail::async_result_operation< typename std::decay< Handler >::type, bool, &detail::async_operation::result > >(
+            std::forward< Handler >(handler), detail::async_operation::remove_operation, p, path(), 0u);
+    }
+
+    //! Renames \a old_p to \a new_p. The handler is called as <tt>handler(error_code)</tt>.
+    template< typename Handler >
+    void async_rename(path const& old_p, path const& new_p, Handler&& handler)
+    {
+        start< detail::async_void_operation< typename std::decay< Handler >::type > >(
+            std::forward< Handler >(handler), detail::async_operation::rename_operation, old_p, new_p, 0u);
+    }
+
+    //! Creates directory \a p. The handler is called as <tt>handler(error_code, bool)</tt>, with the result of <tt>create_directory(p, ec)</tt>.
+    template< typename Handler >
+    void async_create_directory(path const& p, Handler&& handler)
+    {
+        start< detail::async_result_operation< typename std::decay< Handler >::type, bool, &detail::async_operation::result > >(
+            std::forward< Handler >(handler), detail::async_operation::create_directory_operation, p, path(), 0u);
+    }
+
+    //! Enumerates directory \a p. The handler is called as <tt>handler(error_code, std::vector< directory_entry >)</tt>.
+    template< typename Handler >
+    void async_directory_entries(path const& p, BOOST_SCOPED_ENUM_NATIVE(directory_options) options, Handler&& handler)
+    {
+        start< detail::async_result_operation< typename std::decay< Handler >::type, std::vector< directory_entry >, &detail::async_operation::entries > >(
+            std::forward< Handler >(handler), detail::async_operation::directory_entries_operation, p, path(), static_cast< unsigned int >(options));
+    }
+
+    template< typename Handler >
+    void async_directory_entries(path const& p, Handler&& handler)
+    {
+        async_directory_entries(p, directory_options::none, std::forward< Handler >(handler));
+    }
+
+private:
+    template< typename Operation, typename Handler >
+    void start(Handler&& handler, detail::async_operation::operation_kind kind, path const& p1, path const& p2, unsigned int options)
+    {
+        submit(new Operation(std::forward< Handler >(handler), kind, p1, p2, options));
+    }
+
+    //! Starts the operation. Takes ownership of the operation object.
+    BOOST_FILESYSTEM_DECL void submit(detail::async_operation* op);
+};
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // !defined(BOOST_NO_CXX11_RVALUE_REFERENCES) && !defined(BOOST_NO_CXX11_HDR_TYPE_TRAITS)
+
+#endif // BOOST_FILESYSTEM_ASYNC_CONTEXT_HPP
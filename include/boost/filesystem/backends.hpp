@@ -0,0 +1,189 @@
+//  boost/filesystem/backends.hpp  ---------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_BACKENDS_HPP
+#define BOOST_FILESYSTEM_BACKENDS_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+//! Implementations of file data transfer in \c copy_file
+struct copy_file_backend
+{
+    enum type
+    {
+        //! The implementation selected by the library, based on the system capabilities
+        system_default,
+        //! A loop of \c read and \c write calls
+        read_write,
+        //! A loop of \c sendfile calls
+        sendfile,
+        //! A loop of \c copy_file_range calls
+        copy_file_range,
+        //! Linked read and write requests submitted to io_uring, with multiple requests in flight
+        io_uring
+    };
+};
+
+//! Implementations of file status queries
+struct status_backend
+{
+    enum type
+    {
+        //! The implementation selected by the library, based on the system capabilities
+        system_default,
+        //! \c stat, \c lstat and \c fstatat
+        stat,
+        //! \c statx
+        statx
+    };
+};
+
+//! Implementations of reading directory entries in directory iterators
+struct directory_read_backend
+{
+    enum type
+    {
+        //! The implementation selected by the library, based on the system capabilities
+        system_default,
+        //! \c readdir
+        readdir,
+        //! \c readdir_r
+        readdir_r,
+        //! \c getdents64, which reads multiple entries per call
+        getdents
+    };
+};
+
+//! Implementations of scanning file metadata in \c bulk_metadata_scan
+struct bulk_scan_backend
+{
+    enum type
+    {
+        //! The implementation selected by the library, based on the system capabilities
+        system_default,
+        //! Parallel enumeration of the directory tree, with the attributes queried for every file
+        tree_walk,
+        //! \c XFS_IOC_BULKSTAT on XFS, which reads the inodes in the order of their placement on disk
+        xfs_bulkstat
+    };
+};
+
+//! Returns the active \c copy_file data transfer implementation, or \c system_default if there are no alternative implementations
+BOOST_FILESYSTEM_DECL copy_file_backend::type get_copy_file_backend() BOOST_NOEXCEPT;
+//! Selects the \c copy_file data transfer implementation for the process. Returns \c false if \a backend is not supported.
+/*!
+ * Note that the selected implementation may still fall back to a less efficient one for files on filesystems
+ * that do not support it, or when the system does not support it at all.
+ */
+BOOST_FILESYSTEM_DECL bool set_copy_file_backend(copy_file_backend::type backend) BOOST_NOEXCEPT;
+
+//! Returns the active file status implementation, or \c system_default if there are no alternative implementations
+BOOST_FILESYSTEM_DECL status_backend::type get_status_backend() BOOST_NOEXCEPT;
+//! Selects the file status implementation for the process. Returns \c false if \a backend is not supported.
+BOOST_FILESYSTEM_DECL bool set_status_backend(status_backend::type backend) BOOST_NOEXCEPT;
+
+//! Returns the implementation that will be used by new directory iterators, or \c system_default if there are no alternative implementations
+BOOST_FILESYSTEM_DECL directory_read_backend::type get_directory_read_backend() BOOST_NOEXCEPT;
+//! Selects the implementation of reading directory entries for the process. Returns \c false if \a backend is not supported.
+/*!
+ * The implementation is selected when a directory iterator is constructed, the existing iterators are not affected.
+ */
+BOOST_FILESYSTEM_DECL bool set_directory_read_backend(directory_read_backend::type backend) BOOST_NOEXCEPT;
+
+//! Returns the active implementation of \c bulk_metadata_scan, or \c system_default if there are no alternative implementations
+BOOST_FILESYSTEM_DECL bulk_scan_backend::type get_bulk_scan_backend() BOOST_NOEXCEPT;
+
+//! Selects the implementation of \c bulk_metadata_scan for the process. Returns \c false if \a backend is not supported.
+/*!
+ * Filesystem-specific implementations fall back to \c tree_walk for other filesystems, or when the scan is not permitted.
+ */
+BOOST_FILESYSTEM_DECL bool set_bulk_scan_backend(bulk_scan_backend::type backend) BOOST_NOEXCEPT;
+
+//! Support of a filesystem capability
+struct capability_support
+{
+    enum type
+    {
+        //! Support could not be determined, e.g. because the directory is not writable
+        unknown,
+        //! The capability is not supported
+        unsupported,
+        //! The capability is supported
+        supported
+    };
+};
+
+//! Capabilities of a filesystem, as detected by \c probe_filesystem_capabilities
+struct filesystem_capabilities
+{
+    //! Creating copy-on-write clones of files (reflinks), as used by \c copy_file with \c copy_options::clone_if_possible
+    capability_support::type clone;
+    //! Copying file data within the kernel without transferring it to the user space (\c copy_file_range)
+    capability_support::type copy_file_range;
+    //! Reporting file types in directory entries, which allows directory iterators to avoid querying file status
+    capability_support::type directory_entry_type;
+    //! Allocating storage for files without writing data, as used by \c preallocate
+    capability_support::type preallocate;
+    //! Deallocating storage of file ranges, as used by \c punch_hole
+    capability_support::type punch_hole;
+
+    filesystem_capabilities() BOOST_NOEXCEPT :
+        clone(capability_support::unknown),
+        copy_file_range(capability_support::unknown),
+        directory_entry_type(capability_support::unknown),
+        preallocate(capability_support::unknown),
+        punch_hole(capability_support::unknown)
+    {
+    }
+};
+
+namespace detail {
+
+BOOST_FILESYSTEM_DECL
+filesystem_capabilities probe_filesystem_capabilities(path const& p, system::error_code* ec = NULL);
+
+//! Sets the minimum file size and the size of ranges for copying file data in multiple threads with \c copy_options::parallel_data.
+//! Zero values restore the defaults. Internal use only, intended for testing.
+BOOST_FILESYSTEM_DECL
+void set_parallel_copy_file_params(boost::uintmax_t min_size, boost::uintmax_t chunk_size) BOOST_NOEXCEPT;
+
+} // namespace detail
+
+//! Detects capabilities of the filesystem that contains the directory \a p
+/*!
+ * The capabilities are tested by performing the corresponding operations on temporary files that are created in
+ * the directory and removed immediately. If temporary files cannot be created, the capabilities
+ * that require them are reported as \c capability_support::unknown.
+ */
+inline filesystem_capabilities probe_filesystem_capabilities(path const& p)
+{
+    return detail::probe_filesystem_capabilities(p);
+}
+
+inline filesystem_capabilities probe_filesystem_capabilities(path const& p, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::probe_filesystem_capabilities(p, &ec);
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_BACKENDS_HPP
@@ -0,0 +1,89 @@
+//  boost/filesystem/canonicalizer.hpp  ------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_CANONICALIZER_HPP
+#define BOOST_FILESYSTEM_CANONICALIZER_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/path_key.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <cstddef>
+#include <map>
+#include <boost/system/error_code.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                                class canonicalizer                                 //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! Resolves canonical paths, caching resolved directories
+/*!
+ * The canonicalizer remembers the canonical paths of the directories it has resolved, including the directories
+ * that symlinks refer to. When a path with a previously resolved parent directory is canonicalized, only the elements
+ * following the directory are resolved, which makes canonicalizing many paths with common prefixes much cheaper
+ * than calling \c canonical or \c weakly_canonical for every path.
+ *
+ * The cached results are not updated when the filesystem changes. The caller should call \c clear if directories
+ * or symlinks were modified since they were resolved. Paths are cached as \c path_key objects, i.e. paths that
+ * differ only in redundant separators share the cached result.
+ *
+ * The canonicalizer is not thread-safe.
+ */
+class canonicalizer
+{
+public:
+    canonicalizer() {}
+
+    BOOST_DELETED_FUNCTION(canonicalizer(canonicalizer const&))
+    BOOST_DELETED_FUNCTION(canonicalizer& operator=(canonicalizer const&))
+
+public:
+    //! Returns the canonical path of \a p, as if by \c boost::filesystem::canonical
+    path canonical(path const& p) { return canonical_impl(p, NULL); }
+    path canonical(path const& p, path const& base) { return canonical_impl(p, &base); }
+    path canonical(path const& p, system::error_code& ec) { return canonical_impl(p, NULL, &ec); }
+    path canonical(path const& p, path const& base, system::error_code& ec) { return canonical_impl(p, &base, &ec); }
+
+    //! Returns the path of \a p with the longest existing prefix canonicalized, as if by \c boost::filesystem::weakly_canonical
+    path weakly_canonical(path const& p) { return weakly_canonical_impl(p, NULL); }
+    path weakly_canonical(path const& p, path const& base) { return weakly_canonical_impl(p, &base); }
+    path weakly_canonical(path const& p, system::error_code& ec) { return weakly_canonical_impl(p, NULL, &ec); }
+    path weakly_canonical(path const& p, path const& base, system::error_code& ec) { return weakly_canonical_impl(p, &base, &ec); }
+
+    //! Returns the number of cached directories
+    std::size_t size() const BOOST_NOEXCEPT { return m_dirs.size(); }
+
+    //! Removes all cached directories
+    void clear() BOOST_NOEXCEPT { m_dirs.clear(); }
+
+private:
+    BOOST_FILESYSTEM_DECL path canonical_impl(path const& p, path const* base, system::error_code* ec = NULL);
+    BOOST_FILESYSTEM_DECL path weakly_canonical_impl(path const& p, path const* base, system::error_code* ec = NULL);
+    bool resolve(path const& source, bool weak, unsigned int& symlinks_left, path& result, file_type& type, system::error_code& ec);
+
+private:
+    //! Canonical paths of directories, keyed by the original absolute paths
+    std::map< path_key, path > m_dirs;
+};
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_CANONICALIZER_HPP
@@ -0,0 +1,210 @@
+//  boost/filesystem/compact_directory_entry.hpp  --------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_COMPACT_DIRECTORY_ENTRY_HPP
+#define BOOST_FILESYSTEM_COMPACT_DIRECTORY_ENTRY_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/path_view.hpp>
+#include <boost/filesystem/path_arena.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/directory.hpp>
+
+#include <cstddef>
+#include <ctime>
+#include <deque>
+#include <boost/cstdint.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+class compact_directory_entry_storage;
+
+//! Attributes of a compact directory entry. Only stored for the entries that have at least one of the attributes cached.
+struct compact_directory_entry_attributes
+{
+    //! Flags indicating which of the attributes are known
+    enum flags_type
+    {
+        file_size_known = 1u,
+        last_write_time_known = 1u << 1,
+        inode_known = 1u << 2
+    };
+
+    //! Size of the file, following symlinks, or zero if not known
+    boost::uintmax_t file_size;
+    //! Inode number on POSIX systems, file index on Windows, or zero if not known
+    boost::uintmax_t inode;
+    //! Last write time of the file, following symlinks, or zero if not known
+    std::time_t last_write_time;
+    //! Combination of \c flags_type values
+    unsigned int flags;
+};
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                          class compact_directory_entry                             //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! Compact representation of a directory entry, for keeping a large number of entries in memory
+/*!
+ * The entry consists of a view of the path stored in \c compact_directory_entry_storage, the file types and permissions
+ * packed into four bytes and a pointer to the attributes, which are also stored in the storage and only if any of them
+ * are cached. This makes the entry several times smaller than \c directory_entry and avoids a memory allocation
+ * per entry. The entry refers to the storage it was created by and is invalidated when the storage is released or destroyed.
+ *
+ * The entry only holds the information that was cached in \c directory_entry when the compact entry was created and
+ * never queries the filesystem. It is convertible to \c directory_entry with the same cached information.
+ */
+class compact_directory_entry
+{
+    friend class compact_directory_entry_storage;
+
+public:
+    BOOST_CONSTEXPR compact_directory_entry() BOOST_NOEXCEPT :
+        m_path(NULL),
+        m_attrs(NULL),
+        m_path_size(0u),
+        m_symlink_type(static_cast< boost::uint8_t >(status_error)),
+        m_type(static_cast< boost::uint8_t >(status_error)),
+        m_perms(static_cast< boost::uint16_t >(perms_not_known))
+    {
+    }
+
+    //! Returns the stored path of the entry. The path is followed by a terminating null character.
+    path_view path() const BOOST_NOEXCEPT { return m_path_size > 0u ? path_view(m_path, m_path_size) : path_view(); }
+
+    //! Returns the file type following symlinks, or \c status_error if not known
+    filesystem::file_type file_type() const BOOST_NOEXCEPT { return static_cast< filesystem::file_type >(m_type); }
+    //! Returns the file type not following symlinks, or \c status_error if not known
+    filesystem::file_type symlink_file_type() const BOOST_NOEXCEPT { return static_cast< filesystem::file_type >(m_symlink_type); }
+    //! Returns the permissions of the file following symlinks, or \c perms_not_known if not known
+    perms permissions() const BOOST_NOEXCEPT { return static_cast< perms >(m_perms); }
+
+    //! Returns the cached status of the file following symlinks
+    file_status status() const BOOST_NOEXCEPT { return file_status(file_type(), permissions()); }
+    //! Returns the cached status of the file not following symlinks
+    file_status symlink_status() const BOOST_NOEXCEPT { return file_status(symlink_file_type()); }
+
+    //! Returns the cached attributes, or \c NULL if none of the attributes are known
+    compact_directory_entry_attributes const* attributes() const BOOST_NOEXCEPT { return m_attrs; }
+
+    //! Creates a \c directory_entry with the stored path, status and attributes
+    directory_entry to_directory_entry() const { return to_directory_entry_impl(NULL); }
+    //! Creates a \c directory_entry with the stored path appended to \a parent, e.g. if the entry only stores the filename
+    directory_entry to_directory_entry(filesystem::path const& parent) const { return to_directory_entry_impl(&parent); }
+
+    operator directory_entry() const { return to_directory_entry_impl(NULL); }
+
+    //! Entries are compared by their stored paths
+    friend bool operator==(compact_directory_entry const& left, compact_directory_entry const& right) BOOST_NOEXCEPT { return left.path() == right.path(); }
+    friend bool operator!=(compact_directory_entry const& left, compact_directory_entry const& right) BOOST_NOEXCEPT { return left.path() != right.path(); }
+    friend bool operator<(compact_directory_entry const& left, compact_directory_entry const& right) BOOST_NOEXCEPT { return left.path() < right.path(); }
+    friend bool operator<=(compact_directory_entry const& left, compact_directory_entry const& right) BOOST_NOEXCEPT { return left.path() <= right.path(); }
+    friend bool operator>(compact_directory_entry const& left, compact_directory_entry const& right) BOOST_NOEXCEPT { return left.path() > right.path(); }
+    friend bool operator>=(compact_directory_entry const& left, compact_directory_entry const& right) BOOST_NOEXCEPT { return left.path() >= right.path(); }
+
+private:
+    BOOST_FILESYSTEM_DECL directory_entry to_directory_entry_impl(filesystem::path const* parent) const;
+
+private:
+    const path::value_type* m_path;
+    compact_directory_entry_attributes const* m_attrs;
+    boost::uint32_t m_path_size;
+    boost::uint8_t m_symlink_type;
+    boost::uint8_t m_type;
+    boost::uint16_t m_perms;
+};
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                      class compact_directory_entry_storage                         //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! Storage of the paths and attributes of compact directory entries
+/*!
+ * The paths are stored in a \c path_arena and the attributes in blocks that are only released all at once.
+ * The storage is not thread-safe.
+ */
+class compact_directory_entry_storage
+{
+public:
+    compact_directory_entry_storage() BOOST_NOEXCEPT {}
+
+    //! Constructs the storage that allocates memory blocks for paths of the specified size, in bytes
+    explicit compact_directory_entry_storage(std::size_t block_size) BOOST_NOEXCEPT : m_paths(block_size) {}
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    compact_directory_entry_storage(compact_directory_entry_storage&& that) BOOST_NOEXCEPT :
+        m_paths(static_cast< path_arena&& >(that.m_paths))
+    {
+        m_attrs.swap(that.m_attrs);
+    }
+
+    compact_directory_entry_storage& operator=(compact_directory_entry_storage&& that) BOOST_NOEXCEPT
+    {
+        if (BOOST_LIKELY(this != &that))
+        {
+            release();
+            m_paths = static_cast< path_arena&& >(that.m_paths);
+            m_attrs.swap(that.m_attrs);
+        }
+        return *this;
+    }
+#endif
+
+    BOOST_DELETED_FUNCTION(compact_directory_entry_storage(compact_directory_entry_storage const&))
+    BOOST_DELETED_FUNCTION(compact_directory_entry_storage& operator=(compact_directory_entry_storage const&))
+
+public:
+    //! Stores the path, status and attributes cached in \a e and returns the compact entry. Throws \c std::bad_alloc on memory allocation failure.
+    compact_directory_entry store(directory_entry const& e) { return store(e, path_view(e.path())); }
+    //! Stores \a p instead of the path of \a e, e.g. its filename, along with the status and attributes cached in \a e
+    BOOST_FILESYSTEM_DECL compact_directory_entry store(directory_entry const& e, path_view const& p);
+
+    //! Releases all memory allocated by the storage, which invalidates all entries created by the storage
+    void release() BOOST_NOEXCEPT
+    {
+        m_paths.release();
+        std::deque< compact_directory_entry_attributes >().swap(m_attrs);
+    }
+
+    //! Returns the number of entries that have stored attributes
+    std::size_t attributes_count() const BOOST_NOEXCEPT { return m_attrs.size(); }
+    //! Returns the approximate size of memory allocated by the storage, in bytes
+    std::size_t allocated_size() const BOOST_NOEXCEPT { return m_paths.allocated_size() + m_attrs.size() * sizeof(compact_directory_entry_attributes); }
+
+    //! Swaps the contents of two storages
+    void swap(compact_directory_entry_storage& that) BOOST_NOEXCEPT
+    {
+        m_paths.swap(that.m_paths);
+        m_attrs.swap(that.m_attrs);
+    }
+
+    friend void swap(compact_directory_entry_storage& left, compact_directory_entry_storage& right) BOOST_NOEXCEPT { left.swap(right); }
+
+private:
+    path_arena m_paths;
+    //! Elements of a deque are not relocated when elements are added to the end, so the entries can refer to them
+    std::deque< compact_directory_entry_attributes > m_attrs;
+};
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_COMPACT_DIRECTORY_ENTRY_HPP
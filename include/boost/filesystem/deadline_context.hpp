@@ -0,0 +1,124 @@
+//  boost/filesystem/deadline_context.hpp  ---------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_DEADLINE_CONTEXT_HPP
+#define BOOST_FILESYSTEM_DEADLINE_CONTEXT_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <cstddef>
+#include <vector>
+#include <boost/system/error_code.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                                  deadline_context                                  //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! Performs filesystem operations with a deadline, protecting the calling threads from hung filesystems, such as unresponsive network mounts
+/*!
+ * The operations are performed by the worker threads of the context, while the calling thread waits for the result for at most
+ * the given timeout. If the timeout expires, the operation fails with \c errc::timed_out. The worker thread performing the operation
+ * stays blocked until the system call returns, and the operation result is discarded.
+ *
+ * While an operation that timed out is still blocked, the mount that contains its path is considered stuck, and further operations
+ * on the paths in that mount fail with \c errc::timed_out immediately, without occupying more worker threads. The mount is determined
+ * lexically, from the absolute path and the table of mounted filesystems, so symlinks to a different mount are attributed to
+ * the mount containing the symlink. On Windows, the mount is the root name of the path, e.g. the drive or the network share.
+ *
+ * The number of worker threads grows on demand up to the maximum given to the constructor, and idle threads exit after a while.
+ * Operations that could not be started by a worker thread before the timeout expires also fail with \c errc::timed_out.
+ * The destructor does not wait for blocked operations; their worker threads exit when the system calls return.
+ *
+ * All operations can be called concurrently from multiple threads. If the library is built without thread support,
+ * the operations are performed in the calling thread, without a deadline.
+ */
+class deadline_context
+{
+public:
+    struct implementation;
+
+private:
+    implementation* m_impl;
+
+public:
+    //! Creates the context that uses at most \a max_threads worker threads
+    BOOST_FILESYSTEM_DECL explicit deadline_context(unsigned int max_threads = 16u);
+    //! Destroys the context without waiting for the blocked operations
+    BOOST_FILESYSTEM_DECL ~deadline_context();
+
+    BOOST_DELETED_FUNCTION(deadline_context(deadline_context const&))
+    BOOST_DELETED_FUNCTION(deadline_context& operator=(deadline_context const&))
+
+public:
+    //! Queries status of \a p, as if by <tt>status(p)</tt>, waiting for at most \a timeout_ms milliseconds
+    file_status status(path const& p, unsigned int timeout_ms) { return status_impl(p, timeout_ms, true); }
+    file_status status(path const& p, unsigned int timeout_ms, system::error_code& ec) BOOST_NOEXCEPT { return status_impl(p, timeout_ms, true, &ec); }
+
+    //! Queries status of \a p without following symlinks, as if by <tt>symlink_status(p)</tt>, waiting for at most \a timeout_ms milliseconds
+    file_status symlink_status(path const& p, unsigned int timeout_ms) { return status_impl(p, timeout_ms, false); }
+    file_status symlink_status(path const& p, unsigned int timeout_ms, system::error_code& ec) BOOST_NOEXCEPT { return status_impl(p, timeout_ms, false, &ec); }
+
+    //! Tests whether \a p exists, as if by <tt>exists(p)</tt>, waiting for at most \a timeout_ms milliseconds
+    bool exists(path const& p, unsigned int timeout_ms) { return filesystem::exists(status_impl(p, timeout_ms, true)); }
+    bool exists(path const& p, unsigned int timeout_ms, system::error_code& ec) BOOST_NOEXCEPT { return filesystem::exists(status_impl(p, timeout_ms, true, &ec)); }
+
+    //! Queries the space on the volume containing \a p, as if by <tt>space(p)</tt>, waiting for at most \a timeout_ms milliseconds
+    space_info space(path const& p, unsigned int timeout_ms) { return space_impl(p, timeout_ms); }
+    space_info space(path const& p, unsigned int timeout_ms, system::error_code& ec) BOOST_NOEXCEPT { return space_impl(p, timeout_ms, &ec); }
+
+    //! Reads all entries of directory \a p, as if by iterating with \c directory_iterator, waiting for at most \a timeout_ms milliseconds in total
+    std::vector< directory_entry > directory_entries(path const& p, unsigned int timeout_ms, BOOST_SCOPED_ENUM_NATIVE(directory_options) opts = directory_options::none)
+    {
+        std::vector< directory_entry > entries;
+        directory_entries_impl(p, timeout_ms, static_cast< unsigned int >(opts), entries);
+        return entries;
+    }
+    std::vector< directory_entry > directory_entries(path const& p, unsigned int timeout_ms, system::error_code& ec)
+    {
+        std::vector< directory_entry > entries;
+        directory_entries_impl(p, timeout_ms, static_cast< unsigned int >(directory_options::none), entries, &ec);
+        return entries;
+    }
+    std::vector< directory_entry > directory_entries(path const& p, unsigned int timeout_ms, BOOST_SCOPED_ENUM_NATIVE(directory_options) opts, system::error_code& ec)
+    {
+        std::vector< directory_entry > entries;
+        directory_entries_impl(p, timeout_ms, static_cast< unsigned int >(opts), entries, &ec);
+        return entries;
+    }
+
+    //! Returns \c true if the operations on the mount containing \a p currently fail immediately because an earlier operation is blocked
+    BOOST_FILESYSTEM_DECL bool is_stuck(path const& p) const;
+    //! Returns the number of operations that timed out and are still blocked
+    BOOST_FILESYSTEM_DECL std::size_t blocked_operation_count() const BOOST_NOEXCEPT;
+
+private:
+    BOOST_FILESYSTEM_DECL file_status status_impl(path const& p, unsigned int timeout_ms, bool follow_symlinks, system::error_code* ec = NULL);
+    BOOST_FILESYSTEM_DECL space_info space_impl(path const& p, unsigned int timeout_ms, system::error_code* ec = NULL);
+    BOOST_FILESYSTEM_DECL void directory_entries_impl(path const& p, unsigned int timeout_ms, unsigned int opts, std::vector< directory_entry >& entries, system::error_code* ec = NULL);
+};
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_DEADLINE_CONTEXT_HPP
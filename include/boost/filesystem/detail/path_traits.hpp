@@ -49,6 +49,8 @@ namespace filesystem {
 BOOST_FILESYSTEM_DECL system::error_category const& codecvt_error_category() BOOST_NOEXCEPT;
 
 class directory_entry;
+class path_view;
+class static_path;
 
 namespace detail {
 namespace path_traits {
@@ -76,6 +78,7 @@ struct std_string_view_tag : string_class_tag {};
 struct boost_string_view_tag : string_class_tag {};
 struct range_type_tag {};
 struct directory_entry_tag {};
+struct path_view_tag {};
 
 //! The traits define a number of properties of a path source
 template< typename T >
@@ -305,6 +308,21 @@ struct path_source_traits< directory_entry >
     static BOOST_CONSTEXPR_OR_CONST bool is_native = false;
 };
 
+template< >
+struct path_source_traits< path_view >
+{
+    typedef path_view_tag tag_type;
+    typedef path_native_char_type char_type;
+    static BOOST_CONSTEXPR_OR_CONST bool is_native = false;
+};
+
+//! static_path is a path_view with the precomputed decomposition
+template< >
+struct path_source_traits< static_path > :
+    public path_source_traits< path_view >
+{
+};
+
 #undef BOOST_FILESYSTEM_DETAIL_IS_CHAR_NATIVE
 #undef BOOST_FILESYSTEM_DETAIL_IS_WCHAR_T_NATIVE
 
@@ -457,6 +475,10 @@ BOOST_FORCEINLINE void dispatch(std::vector< wchar_t > const& source, Callback c
 template< typename Callback >
 void dispatch(directory_entry const& de, Callback cb, const codecvt_type* cvt, directory_entry_tag);
 
+// Defined in path_view.hpp to avoid circular header dependencies
+template< typename Callback >
+void dispatch(path_view const& pv, Callback cb, const codecvt_type* cvt, path_view_tag);
+
 template< typename Source, typename Callback >
 BOOST_FORCEINLINE void dispatch(Source const& source, Callback cb, const codecvt_type* cvt)
 {
@@ -18,19 +18,26 @@
 
 #include <boost/filesystem/config.hpp>
 #include <boost/filesystem/path.hpp>
+#include <boost/filesystem/path_view.hpp>
 #include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/memory_allocator.hpp>
 #include <boost/filesystem/detail/path_traits.hpp>
 
 #include <cstddef>
+#include <ctime>
+#include <new>
+#include <deque>
 #include <string>
 #include <vector>
 
 #include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
 #include <boost/core/scoped_enum.hpp>
 #include <boost/detail/bitmask.hpp>
 #include <boost/system/error_code.hpp>
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 #include <boost/smart_ptr/intrusive_ref_counter.hpp>
+#include <boost/type_traits/alignment_of.hpp>
 #include <boost/iterator/iterator_facade.hpp>
 #include <boost/iterator/iterator_categories.hpp>
 
@@ -51,26 +58,64 @@ namespace filesystem {
 //  sub-namespace that also has a class named path. The workaround is to always
 //  fully qualify the name path when it refers to the class name.
 
+class directory_entry;
+class directory_iterator;
+class compact_directory_entry;
+class compact_directory_entry_storage;
+class directory_cursor;
+class directory_handle;
+
+namespace detail {
+
+struct directory_iterator_params;
+struct dir_itr_filter;
+
+//! Flags indicating which of the cached attributes of directory_entry are valid
+enum directory_entry_cached_attrs
+{
+    file_size_cached = 1u,
+    last_write_time_cached = 1u << 1,
+    hard_link_count_cached = 1u << 2,
+    inode_cached = 1u << 3,
+    device_cached = 1u << 4
+};
+
+BOOST_FILESYSTEM_DECL void directory_iterator_construct(directory_iterator& it, path const& p, unsigned int opts, directory_iterator_params* params, system::error_code* ec);
+BOOST_FILESYSTEM_DECL void directory_iterator_construct_filtered(directory_iterator& it, path const& p, unsigned int opts, directory_iterator_params* params, dir_itr_filter* filter, system::error_code* ec);
+BOOST_FILESYSTEM_DECL void directory_iterator_construct_at(directory_iterator& it, directory_handle const& dir, path const& p, unsigned int opts, system::error_code* ec);
+BOOST_FILESYSTEM_DECL void directory_iterator_increment(directory_iterator& it, system::error_code* ec);
+
+//! Returns the symlink status of the directory entry, if it is cached, without querying the filesystem
+inline file_status get_cached_symlink_status(directory_entry const& e) BOOST_NOEXCEPT;
+
+} // namespace detail
+
 class directory_entry
 {
 public:
     typedef boost::filesystem::path::value_type value_type; // enables class path ctor taking directory_entry
 
-    directory_entry() BOOST_NOEXCEPT {}
+    directory_entry() BOOST_NOEXCEPT
+    {
+        init_attrs();
+    }
 
     explicit directory_entry(boost::filesystem::path const& p) :
         m_path(p), m_status(file_status()), m_symlink_status(file_status())
     {
+        init_attrs();
     }
 
     directory_entry(boost::filesystem::path const& p, file_status st, file_status symlink_st = file_status()) :
         m_path(p), m_status(st), m_symlink_status(symlink_st)
     {
+        init_attrs();
     }
 
     directory_entry(directory_entry const& rhs) :
         m_path(rhs.m_path), m_status(rhs.m_status), m_symlink_status(rhs.m_symlink_status)
     {
+        copy_attrs(rhs);
     }
 
     directory_entry& operator=(directory_entry const& rhs)
@@ -78,6 +123,7 @@ public:
         m_path = rhs.m_path;
         m_status = rhs.m_status;
         m_symlink_status = rhs.m_symlink_status;
+        copy_attrs(rhs);
         return *this;
     }
 
@@ -91,6 +137,7 @@ public:
         m_status(static_cast< file_status&& >(rhs.m_status)),
         m_symlink_status(static_cast< file_status&& >(rhs.m_symlink_status))
     {
+        copy_attrs(rhs);
     }
 
     directory_entry& operator=(directory_entry&& rhs) BOOST_NOEXCEPT
@@ -98,6 +145,7 @@ public:
         m_path = static_cast< boost::filesystem::path&& >(rhs.m_path);
         m_status = static_cast< file_status&& >(rhs.m_status);
         m_symlink_status = static_cast< file_status&& >(rhs.m_symlink_status);
+        copy_attrs(rhs);
         return *this;
     }
 
@@ -106,6 +154,7 @@ public:
         m_path = static_cast< boost::filesystem::path&& >(p);
         m_status = static_cast< file_status&& >(st);
         m_symlink_status = static_cast< file_status&& >(symlink_st);
+        init_attrs();
     }
 #endif
 
@@ -119,12 +168,12 @@ public:
         m_status = st;
         m_symlink_status = symlink_st;
 #endif
+        init_attrs();
     }
 
     void replace_filename(boost::filesystem::path const& p, file_status st = file_status(), file_status symlink_st = file_status())
     {
-        m_path.remove_filename();
-        m_path /= p;
+        m_path.replace_filename(p);
 #if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
         m_status = static_cast< file_status&& >(st);
         m_symlink_status = static_cast< file_status&& >(symlink_st);
@@ -132,6 +181,7 @@ public:
         m_status = st;
         m_symlink_status = symlink_st;
 #endif
+        init_attrs();
     }
 
 #ifndef BOOST_FILESYSTEM_NO_DEPRECATED
@@ -151,6 +201,39 @@ public:
     file_status status(system::error_code& ec) const BOOST_NOEXCEPT { return get_status(&ec); }
     file_status symlink_status() const { return get_symlink_status(); }
     file_status symlink_status(system::error_code& ec) const BOOST_NOEXCEPT { return get_symlink_status(&ec); }
+    //  Unlike status() and symlink_status(), the following functions do not query the filesystem if the file type
+    //  is already known, e.g. from the directory iterator, even if the permissions are not.
+    filesystem::file_type file_type() const { return get_file_type(); }
+    filesystem::file_type file_type(system::error_code& ec) const BOOST_NOEXCEPT { return get_file_type(&ec); }
+    filesystem::file_type symlink_file_type() const { return get_symlink_file_type(); }
+    filesystem::file_type symlink_file_type(system::error_code& ec) const BOOST_NOEXCEPT { return get_symlink_file_type(&ec); }
+
+    //  The following attributes are obtained with a single query to the filesystem on first access and then cached.
+    //  When the entry is produced by a directory iterator, the query is performed relative to the directory being iterated.
+    //  Symlinks are followed, i.e. the attributes are those of the file the symlink refers to.
+
+    boost::uintmax_t file_size() const { return get_file_size(); }
+    boost::uintmax_t file_size(system::error_code& ec) const BOOST_NOEXCEPT { return get_file_size(&ec); }
+    std::time_t last_write_time() const { return get_last_write_time(); }
+    std::time_t last_write_time(system::error_code& ec) const BOOST_NOEXCEPT { return get_last_write_time(&ec); }
+    boost::uintmax_t hard_link_count() const { return get_hard_link_count(); }
+    boost::uintmax_t hard_link_count(system::error_code& ec) const BOOST_NOEXCEPT { return get_hard_link_count(&ec); }
+    // Inode number on POSIX systems, file index on Windows
+    boost::uintmax_t inode() const { return get_inode(); }
+    boost::uintmax_t inode(system::error_code& ec) const BOOST_NOEXCEPT { return get_inode(&ec); }
+    //! Returns the identity of the file. Unless the identity is already cached, queries the filesystem.
+    file_identity identity() const { return get_identity(); }
+    file_identity identity(system::error_code& ec) const BOOST_NOEXCEPT { return get_identity(&ec); }
+
+    //! Queries the filesystem and updates the cached file status and attributes
+    void refresh() { refresh_impl(); }
+    void refresh(system::error_code& ec) BOOST_NOEXCEPT { refresh_impl(&ec); }
+    //! Updates the cached file status and attributes with the given consistency with the server on network filesystems
+    void refresh(BOOST_SCOPED_ENUM_NATIVE(status_consistency) consistency) { refresh_impl(static_cast< unsigned int >(consistency), NULL); }
+    void refresh(BOOST_SCOPED_ENUM_NATIVE(status_consistency) consistency, system::error_code& ec) BOOST_NOEXCEPT
+    {
+        refresh_impl(static_cast< unsigned int >(consistency), &ec);
+    }
 
     bool operator==(directory_entry const& rhs) const BOOST_NOEXCEPT { return m_path == rhs.m_path; }
     bool operator!=(directory_entry const& rhs) const BOOST_NOEXCEPT { return m_path != rhs.m_path; }
@@ -160,16 +243,128 @@ public:
     bool operator>=(directory_entry const& rhs) const BOOST_NOEXCEPT { return m_path >= rhs.m_path; }
 
 private:
+    friend void detail::directory_iterator_construct(directory_iterator& it, boost::filesystem::path const& p, unsigned int opts, detail::directory_iterator_params* params, system::error_code* ec);
+    friend void detail::directory_iterator_construct_filtered(directory_iterator& it, boost::filesystem::path const& p, unsigned int opts, detail::directory_iterator_params* params, detail::dir_itr_filter* filter, system::error_code* ec);
+    friend void detail::directory_iterator_increment(directory_iterator& it, system::error_code* ec);
+    friend file_status detail::get_cached_symlink_status(directory_entry const& e) BOOST_NOEXCEPT;
+    friend class compact_directory_entry;
+    friend class compact_directory_entry_storage;
+
+private:
+    void init_attrs() BOOST_NOEXCEPT
+    {
+        m_file_size = 0u;
+        m_hard_link_count = 0u;
+        m_inode = 0u;
+        m_device = 0u;
+        m_last_write_time = 0;
+        m_cached_attrs = 0u;
+#ifndef BOOST_WINDOWS_API
+        m_basedir_fd = -1;
+#endif
+    }
+
+    void copy_attrs(directory_entry const& rhs) BOOST_NOEXCEPT
+    {
+        m_file_size = rhs.m_file_size;
+        m_hard_link_count = rhs.m_hard_link_count;
+        m_inode = rhs.m_inode;
+        m_device = rhs.m_device;
+        m_last_write_time = rhs.m_last_write_time;
+        m_cached_attrs = rhs.m_cached_attrs;
+        // The base directory descriptor is owned by the directory iterator and is not copied
+#ifndef BOOST_WINDOWS_API
+        m_basedir_fd = -1;
+#endif
+    }
+
+    //! Sets the attributes obtained by the directory iterator along with the file name
+    void set_cached_attrs(unsigned int attrs, boost::uintmax_t file_size, std::time_t last_write_time, boost::uintmax_t inode) BOOST_NOEXCEPT
+    {
+        m_file_size = file_size;
+        m_last_write_time = last_write_time;
+        m_inode = inode;
+        m_cached_attrs = attrs;
+    }
+
+    //! Sets the symlink status and the attributes queried by the directory iterator in advance
+    void set_prefetched_attrs(file_status const& symlink_st, unsigned int attrs, boost::uintmax_t file_size, std::time_t last_write_time,
+        boost::uintmax_t hard_link_count, boost::uintmax_t inode, boost::uint64_t device) BOOST_NOEXCEPT
+    {
+        m_symlink_status = symlink_st;
+        if (!filesystem::is_symlink(symlink_st))
+            m_status = symlink_st;
+        m_file_size = file_size;
+        m_last_write_time = last_write_time;
+        m_hard_link_count = hard_link_count;
+        m_inode = inode;
+        m_device = device;
+        m_cached_attrs = attrs;
+    }
+
+    filesystem::file_type get_file_type(system::error_code* ec = NULL) const
+    {
+        if (filesystem::type_present(m_status))
+        {
+            if (ec)
+                ec->clear();
+            return m_status.type();
+        }
+
+        if (filesystem::type_present(m_symlink_status) && !filesystem::is_symlink(m_symlink_status))
+        {
+            if (ec)
+                ec->clear();
+            return m_symlink_status.type();
+        }
+
+        return get_status(ec).type();
+    }
+
+    filesystem::file_type get_symlink_file_type(system::error_code* ec = NULL) const
+    {
+        if (filesystem::type_present(m_symlink_status))
+        {
+            if (ec)
+                ec->clear();
+            return m_symlink_status.type();
+        }
+
+        return get_symlink_status(ec).type();
+    }
+
     BOOST_FILESYSTEM_DECL file_status get_status(system::error_code* ec = NULL) const;
     BOOST_FILESYSTEM_DECL file_status get_symlink_status(system::error_code* ec = NULL) const;
+    BOOST_FILESYSTEM_DECL boost::uintmax_t get_file_size(system::error_code* ec = NULL) const;
+    BOOST_FILESYSTEM_DECL std::time_t get_last_write_time(system::error_code* ec = NULL) const;
+    BOOST_FILESYSTEM_DECL boost::uintmax_t get_hard_link_count(system::error_code* ec = NULL) const;
+    BOOST_FILESYSTEM_DECL boost::uintmax_t get_inode(system::error_code* ec = NULL) const;
+    BOOST_FILESYSTEM_DECL file_identity get_identity(system::error_code* ec = NULL) const;
+    BOOST_FILESYSTEM_DECL void refresh_impl(system::error_code* ec = NULL) const;
+    BOOST_FILESYSTEM_DECL void refresh_impl(unsigned int consistency, system::error_code* ec) const;
 
 private:
     boost::filesystem::path m_path;
     mutable file_status m_status;         // stat()-like
     mutable file_status m_symlink_status; // lstat()-like
+    mutable boost::uintmax_t m_file_size;
+    mutable boost::uintmax_t m_hard_link_count;
+    mutable boost::uintmax_t m_inode;
+    mutable boost::uint64_t m_device;
+    mutable std::time_t m_last_write_time;
+    mutable unsigned int m_cached_attrs;  // detail::directory_entry_cached_attrs
+#ifndef BOOST_WINDOWS_API
+    // Descriptor of the directory containing the entry, while it is being iterated, or -1
+    int m_basedir_fd;
+#endif
 };                                        // directory_entry
 
 namespace detail {
+
+inline file_status get_cached_symlink_status(directory_entry const& e) BOOST_NOEXCEPT
+{
+    return e.m_symlink_status;
+}
 namespace path_traits {
 
 // Dispatch function for integration with path class
@@ -193,7 +388,8 @@ BOOST_FORCEINLINE void dispatch(directory_entry const& de, Callback cb, const co
 //  - a conversion to 'path' using 'operator boost::filesystem::path const&()',
 //  - then a call to 'is_directory(path const& p)' which recomputes the status with 'detail::status(p)'.
 //
-//  These functions avoid a costly recomputation of the status if one calls 'is_directory(e)' instead of 'is_directory(e.status())'
+//  These functions avoid a costly recomputation of the status if one calls 'is_directory(e)' instead of 'is_directory(e.status())'.
+//  The file type predicates only need the file type, which is often known from the directory iterator without querying the filesystem.
 
 inline file_status status(directory_entry const& e)
 {
@@ -205,11 +401,11 @@ inline file_status status(directory_entry const& e, system::error_code& ec) BOOS
 }
 inline bool type_present(directory_entry const& e)
 {
-    return filesystem::type_present(e.status());
+    return filesystem::type_present(file_status(e.file_type()));
 }
 inline bool type_present(directory_entry const& e, system::error_code& ec) BOOST_NOEXCEPT
 {
-    return filesystem::type_present(e.status(ec));
+    return filesystem::type_present(file_status(e.file_type(ec)));
 }
 inline bool status_known(directory_entry const& e)
 {
@@ -221,43 +417,43 @@ inline bool status_known(directory_entry const& e, system::error_code& ec) BOOST
 }
 inline bool exists(directory_entry const& e)
 {
-    return filesystem::exists(e.status());
+    return filesystem::exists(file_status(e.file_type()));
 }
 inline bool exists(directory_entry const& e, system::error_code& ec) BOOST_NOEXCEPT
 {
-    return filesystem::exists(e.status(ec));
+    return filesystem::exists(file_status(e.file_type(ec)));
 }
 inline bool is_regular_file(directory_entry const& e)
 {
-    return filesystem::is_regular_file(e.status());
+    return filesystem::is_regular_file(file_status(e.file_type()));
 }
 inline bool is_regular_file(directory_entry const& e, system::error_code& ec) BOOST_NOEXCEPT
 {
-    return filesystem::is_regular_file(e.status(ec));
+    return filesystem::is_regular_file(file_status(e.file_type(ec)));
 }
 inline bool is_directory(directory_entry const& e)
 {
-    return filesystem::is_directory(e.status());
+    return filesystem::is_directory(file_status(e.file_type()));
 }
 inline bool is_directory(directory_entry const& e, system::error_code& ec) BOOST_NOEXCEPT
 {
-    return filesystem::is_directory(e.status(ec));
+    return filesystem::is_directory(file_status(e.file_type(ec)));
 }
 inline bool is_symlink(directory_entry const& e)
 {
-    return filesystem::is_symlink(e.symlink_status());
+    return filesystem::is_symlink(file_status(e.symlink_file_type()));
 }
 inline bool is_symlink(directory_entry const& e, system::error_code& ec) BOOST_NOEXCEPT
 {
-    return filesystem::is_symlink(e.symlink_status(ec));
+    return filesystem::is_symlink(file_status(e.symlink_file_type(ec)));
 }
 inline bool is_other(directory_entry const& e)
 {
-    return filesystem::is_other(e.status());
+    return filesystem::is_other(file_status(e.file_type()));
 }
 inline bool is_other(directory_entry const& e, system::error_code& ec) BOOST_NOEXCEPT
 {
-    return filesystem::is_other(e.status(ec));
+    return filesystem::is_other(file_status(e.file_type(ec)));
 }
 #ifndef BOOST_FILESYSTEM_NO_DEPRECATED
 BOOST_FILESYSTEM_DETAIL_DEPRECATED("Use is_regular_file() instead")
@@ -282,16 +478,172 @@ BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(directory_options, unsigned int)
     pop_on_error = 1u << 3,             // non-standard extension for recursive_directory_iterator: instead of producing an end iterator on errors,
                                         // repeatedly invoke pop() until it succeeds or the iterator becomes equal to end iterator
     _detail_no_follow = 1u << 4,        // internal use only
-    _detail_no_push = 1u << 5           // internal use only
+    _detail_no_push = 1u << 5,          // internal use only
+    sort_by_name = 1u << 6,             // non-standard extension: read the whole directory and produce the entries sorted by filename
+    sort_by_inode = 1u << 7,            // non-standard extension: read the whole directory and produce the entries sorted by inode number,
+                                        // which reduces seeking when the entries are queried on rotating and network storage
+    skip_directory_cycles = 1u << 8,    // non-standard extension for recursive_directory_iterator: don't descend into directories that are
+                                        // already being iterated at a lower depth, as identified by their device and inode numbers
+    skip_visited_directories = 1u << 9, // non-standard extension for recursive_directory_iterator: don't descend into directories that were
+                                        // already iterated, as identified by their device and inode numbers; implies skip_directory_cycles
+    breadth_first = 1u << 10,           // non-standard extension for recursive_directory_iterator: iterate subdirectories after all entries
+                                        // of the parent directory, in the order of increasing depth
+    limit_open_directories = 1u << 11,  // non-standard extension for recursive_directory_iterator: keep at most
+                                        // recursive_directory_iterator_open_directories_limit() directories open, reopen the others when needed
+    prefetch_status = 1u << 12,         // non-standard extension: read entries in batches and query their status and attributes
+                                        // asynchronously, ahead of the iteration; ignored on Windows, where the listing provides them
+    _detail_same_filesystem = 1u << 13  // internal use only
 }
 BOOST_SCOPED_ENUM_DECLARE_END(directory_options)
 
 BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(directory_options))
 
-class directory_iterator;
+class recursive_directory_iterator;
+class glob_pattern;
+class ignore_rules;
+
+//! Returns the size of the buffer used by directory iterators to read directory entries from the operating system, in bytes
+BOOST_FILESYSTEM_DECL std::size_t directory_iterator_buffer_size() BOOST_NOEXCEPT;
+
+//! Sets the size of the buffer used by directory iterators to read directory entries from the operating system
+/*!
+ * Larger buffers reduce the number of system calls needed to read large directories, which is most noticeable
+ * on network filesystems. The size is a hint, it is adjusted to the limits supported by the operating system.
+ * Zero size restores the default. The new size only affects directory iterators constructed after the call.
+ */
+BOOST_FILESYSTEM_DECL void set_directory_iterator_buffer_size(std::size_t size) BOOST_NOEXCEPT;
+
+//! Returns the maximum number of directories that are kept open by recursive directory iterators with \c directory_options::limit_open_directories
+BOOST_FILESYSTEM_DECL std::size_t recursive_directory_iterator_open_directories_limit() BOOST_NOEXCEPT;
+
+//! Sets the maximum number of directories that are kept open by recursive directory iterators with \c directory_options::limit_open_directories
+/*!
+ * When a recursive directory iterator descends deeper than the limit, the directories at the lowest depths are closed and
+ * their positions are remembered. When the iteration returns to a closed directory, it is reopened and the entries
+ * that were already iterated are skipped. Zero limit restores the default. The new limit only affects recursive
+ * directory iterators constructed after the call.
+ */
+BOOST_FILESYSTEM_DECL void set_recursive_directory_iterator_open_directories_limit(std::size_t limit) BOOST_NOEXCEPT;
+
+//! Returns the maximum number of directories pending iteration by recursive directory iterators with \c directory_options::breadth_first
+BOOST_FILESYSTEM_DECL std::size_t recursive_directory_iterator_pending_directories_limit() BOOST_NOEXCEPT;
+
+//! Sets the maximum number of directories pending iteration by recursive directory iterators with \c directory_options::breadth_first
+/*!
+ * Breadth-first iterators queue the paths of the subdirectories and open them after iterating the parent directory, so that only
+ * one directory is open at a time. When the queue is full, the subdirectories are iterated depth-first, as soon as they are
+ * found, which bounds the memory used by the queue. Zero limit restores the default. The new limit only affects recursive
+ * directory iterators constructed after the call.
+ */
+BOOST_FILESYSTEM_DECL void set_recursive_directory_iterator_pending_directories_limit(std::size_t limit) BOOST_NOEXCEPT;
+
+//! Returns the process-wide budget of file descriptors held by the library operations, or zero if the budget is not limited
+BOOST_FILESYSTEM_DECL std::size_t descriptor_budget() BOOST_NOEXCEPT;
+
+//! Sets the process-wide budget of file descriptors held by the library operations
+/*!
+ * Recursive directory iterators, parallel directory walks and the operations based on them, prefetching and batch operations,
+ * and concurrent file copying draw the descriptors they keep open, beyond the one that every iterator or operation needs to
+ * make progress, from the budget. When the budget is exhausted, the operations degrade instead of failing with \c EMFILE:
+ * recursive directory iterators close the directories at the lowest depths and reopen them when the iteration returns to them,
+ * as with \c directory_options::limit_open_directories, parallel operations use fewer threads and fewer files are copied
+ * concurrently. Zero limit, which is the default, disables the budget. The budget only affects recursive directory iterators
+ * constructed after the call.
+ */
+BOOST_FILESYSTEM_DECL void set_descriptor_budget(std::size_t limit) BOOST_NOEXCEPT;
+
+//! Returns the number of file descriptors currently drawn from the process-wide budget
+BOOST_FILESYSTEM_DECL std::size_t descriptor_budget_used() BOOST_NOEXCEPT;
 
 namespace detail {
 
+//! Provides access to directory iterator internals
+struct dir_itr_imp_access;
+
+#ifndef BOOST_WINDOWS_API
+struct dir_itr_sorted_listing;
+struct dir_itr_prefetch;
+#endif
+
+//! Filter of directory entry names, applied by directory iterators before the path of the entry is composed
+struct dir_itr_filter :
+    public boost::intrusive_ref_counter< dir_itr_filter >
+{
+    //! Filtering result flags
+    enum flags
+    {
+        //! The entry is produced by the iterator
+        produce_entry = 1u,
+        //! The entry, if it is a directory, is iterated by recursive directory iterators
+        descend_entry = 1u << 1,
+        //! The iteration of the directory ends, without producing this or any following entries
+        stop_iteration = 1u << 2
+    };
+
+    virtual ~dir_itr_filter() {}
+
+    //! Returns a combination of \c flags for the entry named \a name of \a size characters. Entries with no flags are skipped.
+    /*!
+     * \a type is the type of the entry, as reported by the directory listing, without following symlinks. It is \c status_error
+     * if the type is not known without querying the filesystem.
+     */
+    virtual unsigned int filter(const path::value_type* name, std::size_t size, file_type type) = 0;
+    //! Returns the filter for the directory referred to by the last entry that was given \c descend_entry, or \c NULL if the directory is not filtered
+    virtual boost::intrusive_ptr< dir_itr_filter > descend() const = 0;
+};
+
+//! Filter that skips the entries, along with their subtrees, for which the predicate returns \c true
+template< typename Predicate >
+class dir_itr_exclude_filter :
+    public dir_itr_filter
+{
+private:
+    Predicate m_exclude;
+
+public:
+    explicit dir_itr_exclude_filter(Predicate const& exclude) : m_exclude(exclude) {}
+
+    unsigned int filter(const path::value_type* name, std::size_t size, file_type type) BOOST_OVERRIDE
+    {
+        return m_exclude(path_view(name, size), type) ? 0u : static_cast< unsigned int >(produce_entry | descend_entry);
+    }
+
+    boost::intrusive_ptr< dir_itr_filter > descend() const BOOST_OVERRIDE
+    {
+        // The predicate is shared between all directories of the tree
+        return boost::intrusive_ptr< dir_itr_filter >(const_cast< dir_itr_exclude_filter* >(this));
+    }
+};
+
+//! Filter that passes the entry names to a callback and skips all entries
+template< typename Callback >
+class dir_itr_name_filter :
+    public dir_itr_filter
+{
+private:
+    Callback& m_callback;
+
+public:
+    explicit dir_itr_name_filter(Callback& callback) BOOST_NOEXCEPT : m_callback(callback) {}
+
+    unsigned int filter(const path::value_type* name, std::size_t size, file_type type) BOOST_OVERRIDE
+    {
+        // The underlying API may report dot and dot-dot entries
+        if (name[0] == path::dot && (size == 1u || (size == 2u && name[1] == path::dot)))
+            return 0u;
+
+        return m_callback(path_view(name, size), type) ? 0u : static_cast< unsigned int >(stop_iteration);
+    }
+
+    boost::intrusive_ptr< dir_itr_filter > descend() const BOOST_OVERRIDE
+    {
+        return boost::intrusive_ptr< dir_itr_filter >();
+    }
+};
+
+BOOST_FILESYSTEM_DECL void for_each_name(path const& p, unsigned int opts, dir_itr_filter* filter, system::error_code* ec);
+BOOST_FILESYSTEM_DECL boost::uintmax_t directory_entry_count_hint(path const& p, system::error_code* ec);
+
 struct dir_itr_imp :
     public boost::intrusive_ref_counter< dir_itr_imp >
 {
@@ -299,17 +651,43 @@ struct dir_itr_imp :
     bool close_handle;
     unsigned char extra_data_format;
     std::size_t current_offset;
+    std::size_t buffer_size;
 #endif
     directory_entry dir_entry;
     void* handle;
+#ifndef BOOST_WINDOWS_API
+    //! Directory entries read in advance, if the entries are produced sorted
+    dir_itr_sorted_listing* sorted_listing;
+    //! Directory entries read in advance, with their attributes being queried, if \c directory_options::prefetch_status is used
+    dir_itr_prefetch* prefetch;
+    //! Implementation of reading directory entries, one of \c directory_read_backend values
+    unsigned char read_backend;
+    //! Inode number of the current entry reported by the directory listing, if it is known to be the inode of the file, otherwise 0
+    boost::uintmax_t current_inode;
+#endif
+    //! Entry name filter, if any
+    boost::intrusive_ptr< dir_itr_filter > filter;
+    //! Flags given by the filter to the current entry
+    unsigned int filter_flags;
+    //! Amount of directory listing data read from the operating system, in bytes, if known for the reading implementation
+    boost::uintmax_t read_size;
 
     dir_itr_imp() BOOST_NOEXCEPT :
 #ifdef BOOST_WINDOWS_API
         close_handle(false),
         extra_data_format(0u),
         current_offset(0u),
+        buffer_size(0u),
+#endif
+        handle(NULL),
+#ifndef BOOST_WINDOWS_API
+        sorted_listing(NULL),
+        prefetch(NULL),
+        read_backend(0u),
+        current_inode(0u),
 #endif
-        handle(NULL)
+        filter_flags(dir_itr_filter::produce_entry | dir_itr_filter::descend_entry),
+        read_size(0u)
     {
     }
     BOOST_FILESYSTEM_DECL ~dir_itr_imp() BOOST_NOEXCEPT;
@@ -319,10 +697,10 @@ struct dir_itr_imp :
     BOOST_FILESYSTEM_DECL static void operator delete(void* p) BOOST_NOEXCEPT;
 };
 
-struct directory_iterator_params;
-
-BOOST_FILESYSTEM_DECL void directory_iterator_construct(directory_iterator& it, path const& p, unsigned int opts, directory_iterator_params* params, system::error_code* ec);
-BOOST_FILESYSTEM_DECL void directory_iterator_increment(directory_iterator& it, system::error_code* ec);
+BOOST_FILESYSTEM_DECL void recursive_directory_iterator_construct_filtered(recursive_directory_iterator& it, path const& dir_path, unsigned int opts, dir_itr_filter* filter, system::error_code* ec);
+BOOST_FILESYSTEM_DECL void recursive_directory_iterator_increment(recursive_directory_iterator& it, system::error_code* ec);
+BOOST_FILESYSTEM_DECL void recursive_directory_iterator_pop(recursive_directory_iterator& it, system::error_code* ec);
+BOOST_FILESYSTEM_DECL void recursive_directory_iterator_save(recursive_directory_iterator const& it, std::string& checkpoint, system::error_code* ec);
 
 } // namespace detail
 
@@ -340,9 +718,16 @@ class directory_iterator :
     >
 {
     friend class boost::iterator_core_access;
+    friend class directory_cursor;
 
     friend BOOST_FILESYSTEM_DECL void detail::directory_iterator_construct(directory_iterator& it, path const& p, unsigned int opts, detail::directory_iterator_params* params, system::error_code* ec);
     friend BOOST_FILESYSTEM_DECL void detail::directory_iterator_increment(directory_iterator& it, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL void detail::directory_iterator_construct_filtered(directory_iterator& it, path const& p, unsigned int opts, detail::directory_iterator_params* params, detail::dir_itr_filter* filter, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL void detail::recursive_directory_iterator_construct_filtered(recursive_directory_iterator& it, path const& dir_path, unsigned int opts, detail::dir_itr_filter* filter, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL void detail::recursive_directory_iterator_increment(recursive_directory_iterator& it, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL void detail::recursive_directory_iterator_pop(recursive_directory_iterator& it, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL void detail::recursive_directory_iterator_save(recursive_directory_iterator const& it, std::string& checkpoint, system::error_code* ec);
+    friend struct detail::dir_itr_imp_access;
 
 public:
     directory_iterator() BOOST_NOEXCEPT {} // creates the "end" iterator
@@ -364,6 +749,22 @@ public:
         detail::directory_iterator_construct(*this, p, static_cast< unsigned int >(opts), NULL, &ec);
     }
 
+    //! Iterates over the directory \a p, which is resolved relative to \a dir. If \a p is empty, iterates over \a dir itself.
+    directory_iterator(directory_handle const& dir, path const& p, BOOST_SCOPED_ENUM_NATIVE(directory_options) opts = directory_options::none)
+    {
+        detail::directory_iterator_construct_at(*this, dir, p, static_cast< unsigned int >(opts), NULL);
+    }
+
+    directory_iterator(directory_handle const& dir, path const& p, system::error_code& ec) BOOST_NOEXCEPT
+    {
+        detail::directory_iterator_construct_at(*this, dir, p, static_cast< unsigned int >(directory_options::none), &ec);
+    }
+
+    directory_iterator(directory_handle const& dir, path const& p, BOOST_SCOPED_ENUM_NATIVE(directory_options) opts, system::error_code& ec) BOOST_NOEXCEPT
+    {
+        detail::directory_iterator_construct_at(*this, dir, p, static_cast< unsigned int >(opts), &ec);
+    }
+
     BOOST_DEFAULTED_FUNCTION(directory_iterator(directory_iterator const& that), : m_imp(that.m_imp) {})
     BOOST_DEFAULTED_FUNCTION(directory_iterator& operator=(directory_iterator const& that), { m_imp = that.m_imp; return *this; })
 
@@ -417,6 +818,144 @@ private:
     boost::intrusive_ptr< detail::dir_itr_imp > m_imp;
 };
 
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                 directory_cursor                                     //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+//! Move-only counterpart of \c directory_iterator
+/*!
+ * The cursor iterates over a directory the same way \c directory_iterator does, but it cannot be copied. Copying
+ * a \c directory_iterator, e.g. when it is passed by value to an algorithm, atomically updates the reference counter
+ * of the shared iteration state. The cursor is the sole owner of the state, so the iteration never touches the counter.
+ */
+class directory_cursor
+{
+public:
+    //! Creates a cursor that has reached the end
+    directory_cursor() BOOST_NOEXCEPT {}
+
+    explicit directory_cursor(path const& p, BOOST_SCOPED_ENUM_NATIVE(directory_options) opts = directory_options::none) :
+        m_it(p, opts)
+    {
+    }
+
+    directory_cursor(path const& p, system::error_code& ec) BOOST_NOEXCEPT :
+        m_it(p, ec)
+    {
+    }
+
+    directory_cursor(path const& p, BOOST_SCOPED_ENUM_NATIVE(directory_options) opts, system::error_code& ec) BOOST_NOEXCEPT :
+        m_it(p, opts, ec)
+    {
+    }
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    directory_cursor(directory_cursor&& that) BOOST_NOEXCEPT :
+        m_it(static_cast< directory_iterator&& >(that.m_it))
+    {
+    }
+
+    directory_cursor& operator=(directory_cursor&& that) BOOST_NOEXCEPT
+    {
+        m_it = static_cast< directory_iterator&& >(that.m_it);
+        return *this;
+    }
+#endif // !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+
+    BOOST_DELETED_FUNCTION(directory_cursor(directory_cursor const&))
+    BOOST_DELETED_FUNCTION(directory_cursor& operator=(directory_cursor const&))
+
+public:
+    //! Returns \c true if the cursor has reached the end of the directory
+    bool done() const BOOST_NOEXCEPT { return m_it.is_end(); }
+
+    //! Returns the current directory entry
+    directory_entry const& entry() const BOOST_NOEXCEPT
+    {
+        BOOST_ASSERT_MSG(!done(), "attempt to access the entry of a finished directory cursor");
+        return m_it.m_imp->dir_entry;
+    }
+
+    //! Advances the cursor to the next directory entry
+    void next() { detail::directory_iterator_increment(m_it, NULL); }
+    void next(system::error_code& ec) BOOST_NOEXCEPT { detail::directory_iterator_increment(m_it, &ec); }
+
+    //! Releases the iteration state and returns it as a \c directory_iterator, leaving the cursor at the end
+    directory_iterator release() BOOST_NOEXCEPT
+    {
+        directory_iterator it;
+        it.m_imp.swap(m_it.m_imp);
+        return it;
+    }
+
+    void swap(directory_cursor& that) BOOST_NOEXCEPT { m_it.m_imp.swap(that.m_it.m_imp); }
+
+private:
+    directory_iterator m_it;
+};
+
+inline void swap(directory_cursor& left, directory_cursor& right) BOOST_NOEXCEPT
+{
+    left.swap(right);
+}
+
+//! Calls \a callback for the name of every entry of the directory \a p, without composing the paths of the entries
+/*!
+ * The callback is called as <tt>callback(name, type)</tt>, where \c name is a \c path_view of the entry filename, which is only valid
+ * during the call, and \c type is the entry type as reported by the directory listing, without following symlinks, or \c status_error
+ * if the type is not known without querying the filesystem. The dot and dot-dot entries are not reported. The enumeration stops when
+ * the callback returns \c false. \a opts have the same meaning as for \c directory_iterator.
+ */
+template< typename Callback >
+inline void for_each_name(path const& p, BOOST_SCOPED_ENUM_NATIVE(directory_options) opts, Callback callback)
+{
+    boost::intrusive_ptr< detail::dir_itr_filter > filter(new detail::dir_itr_name_filter< Callback >(callback));
+    detail::for_each_name(p, static_cast< unsigned int >(opts), filter.get(), NULL);
+}
+
+template< typename Callback >
+inline void for_each_name(path const& p, BOOST_SCOPED_ENUM_NATIVE(directory_options) opts, Callback callback, system::error_code& ec)
+{
+    boost::intrusive_ptr< detail::dir_itr_filter > filter(new (std::nothrow) detail::dir_itr_name_filter< Callback >(callback));
+    if (BOOST_UNLIKELY(!filter))
+    {
+        ec = system::errc::make_error_code(system::errc::not_enough_memory);
+        return;
+    }
+
+    detail::for_each_name(p, static_cast< unsigned int >(opts), filter.get(), &ec);
+}
+
+template< typename Callback >
+inline void for_each_name(path const& p, Callback callback)
+{
+    filesystem::for_each_name(p, directory_options::none, callback);
+}
+
+template< typename Callback >
+inline void for_each_name(path const& p, Callback callback, system::error_code& ec)
+{
+    filesystem::for_each_name(p, directory_options::none, callback, ec);
+}
+
+//! Returns an estimate of the number of entries in the directory \a p, excluding dot and dot-dot, or zero if no estimate is available
+/*!
+ * The estimate is derived from the size and the link count of the directory, where these are meaningful for the filesystem, and can be
+ * used to reserve storage for the entries collected from the directory. It may differ from the actual number of entries considerably,
+ * e.g. for directories from which many entries were removed.
+ */
+inline boost::uintmax_t directory_entry_count_hint(path const& p)
+{
+    return detail::directory_entry_count_hint(p, NULL);
+}
+
+inline boost::uintmax_t directory_entry_count_hint(path const& p, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::directory_entry_count_hint(p, &ec);
+}
+
 //  enable directory_iterator C++11 range-based for statement use  --------------------//
 
 // begin() and end() are only used by a range-based for statement in the context of
@@ -508,27 +1047,175 @@ BOOST_SCOPED_ENUM_DECLARE_END(symlink_option)
 BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(symlink_option))
 #endif // BOOST_FILESYSTEM_NO_DEPRECATED
 
-class recursive_directory_iterator;
+//! Events reported to the observers of recursive directory iterators
+struct recursive_directory_iterator_event
+{
+    enum type
+    {
+        //! The directory was opened and its first entry was read, the elapsed time is the time it took to open the directory
+        push,
+        //! The iteration of the directory completed or was abandoned by \c pop(), the elapsed time is the total time of iterating the directory
+        pop
+    };
+};
+
+//! Statistics of a directory iterated by a recursive directory iterator
+struct directory_iteration_stats
+{
+    //! Depth of the entries of the directory, as returned by \c recursive_directory_iterator::depth()
+    std::size_t depth;
+    //! Number of entries of the directory the iterator has moved to, including the entries that were not produced because of filtering
+    boost::uintmax_t entry_count;
+    //! Amount of directory listing data read from the operating system, in bytes, or zero if not known for the directory reading implementation
+    boost::uintmax_t bytes_read;
+    //! Time elapsed since the iterator started opening the directory, in nanoseconds
+    boost::uint64_t elapsed_ns;
+
+    directory_iteration_stats() BOOST_NOEXCEPT : depth(0u), entry_count(0u), bytes_read(0u), elapsed_ns(0u) {}
+};
+
+//! Observer of a recursive directory iterator. Called with the event, the path of the directory, the directory statistics and the user-provided context. Must not throw.
+typedef void recursive_directory_iterator_observer(recursive_directory_iterator_event::type event, path const& dir_path, directory_iteration_stats const& stats, void* context);
 
 namespace detail {
 
+//! Position of a directory on the stack of a recursive directory iterator, used with directory_options::limit_open_directories
+struct recur_dir_itr_level
+{
+    //! Number of entries produced by the directory iterator, including the current one
+    std::size_t position;
+    //! Path of the directory, if it was closed
+    path dir_path;
+    //! Entry name filter of the directory, if it was closed
+    boost::intrusive_ptr< dir_itr_filter > filter;
+
+    recur_dir_itr_level() BOOST_NOEXCEPT : position(1u) {}
+};
+
+//! Statistics of a directory on the stack of a recursive directory iterator, used when an observer is set
+struct recur_dir_itr_observed
+{
+    //! Path of the directory
+    path dir_path;
+    //! Time when the iterator started opening the directory, in nanoseconds
+    boost::uint64_t start_time;
+    //! Number of entries the iterator has moved to
+    boost::uintmax_t entry_count;
+    //! Amount of directory listing data read, in bytes, including the data read by the previously closed iterators of the directory
+    boost::uintmax_t bytes_read;
+    //! Amount of directory listing data read by the current iterator of the directory, which was already added to \c bytes_read
+    boost::uintmax_t iterator_bytes_read;
+
+    recur_dir_itr_observed() BOOST_NOEXCEPT : start_time(0u), entry_count(0u), bytes_read(0u), iterator_bytes_read(0u) {}
+};
+
+//! Directory pending iteration by a recursive directory iterator, used with directory_options::breadth_first
+struct recur_dir_itr_pending
+{
+    path dir_path;
+    //! Entry name filter of the directory
+    boost::intrusive_ptr< dir_itr_filter > filter;
+    //! Depth of the directory
+    std::size_t depth;
+};
+
 struct recur_dir_itr_imp :
     public boost::intrusive_ref_counter< recur_dir_itr_imp >
 {
     typedef directory_iterator element_type;
-    std::vector< element_type > m_stack;
+    std::vector< element_type, library_allocator< element_type > > m_stack;
+    // Positions of the directories in m_stack, used with directory_options::limit_open_directories. The first m_closed_count
+    // directory iterators in m_stack are closed and are reopened when the iteration returns to them.
+    std::vector< recur_dir_itr_level, library_allocator< recur_dir_itr_level > > m_levels;
+    std::size_t m_closed_count;
+    // Maximum number of open directories in m_stack, or zero if not limited
+    std::size_t m_max_open;
+    // Number of descriptors drawn from the process-wide budget for the open directories in m_stack other than the top one
+    std::size_t m_budget_held;
+    // Directories pending iteration, used with directory_options::breadth_first
+    std::deque< recur_dir_itr_pending > m_pending;
+    std::size_t m_max_pending;
+    // Depth of the directory at the bottom of m_stack
+    std::size_t m_base_depth;
+    // Identities of the directories in m_stack, used with directory_options::skip_directory_cycles
+    std::vector< file_identity > m_stack_ids;
+    // Hash table with linear probing of the identities of the directories on the stack or, with
+    // directory_options::skip_visited_directories, of all iterated directories. Empty slots are default-constructed.
+    std::vector< file_identity > m_dir_ids;
+    std::size_t m_dir_id_count;
     // directory_options values, declared as unsigned int for ABI compatibility
     unsigned int m_options;
+    // Observer of the iteration and its context, if set. When the observer is set, m_observed has an element for every directory in m_stack.
+    recursive_directory_iterator_observer* m_observer;
+    void* m_observer_context;
+    std::vector< recur_dir_itr_observed > m_observed;
+
+    explicit recur_dir_itr_imp(unsigned int opts) BOOST_NOEXCEPT :
+        m_closed_count(0u),
+        m_max_open(0u),
+        m_budget_held(0u),
+        m_max_pending(0u),
+        m_base_depth(0u),
+        m_dir_id_count(0u),
+        m_options(opts),
+        m_observer(NULL),
+        m_observer_context(NULL)
+    {
+    }
+
+    BOOST_FILESYSTEM_DECL ~recur_dir_itr_imp() BOOST_NOEXCEPT;
 
-    explicit recur_dir_itr_imp(unsigned int opts) BOOST_NOEXCEPT : m_options(opts) {}
+    static void* operator new(std::size_t size) { return detail::allocate_memory(size, boost::alignment_of< recur_dir_itr_imp >::value); }
+    static void* operator new(std::size_t size, std::nothrow_t const&) BOOST_NOEXCEPT
+    {
+        return detail::allocate_memory(size, boost::alignment_of< recur_dir_itr_imp >::value, std::nothrow);
+    }
+    static void operator delete(void* p, std::size_t size) BOOST_NOEXCEPT { detail::deallocate_memory(p, size, boost::alignment_of< recur_dir_itr_imp >::value); }
 };
 
 BOOST_FILESYSTEM_DECL void recursive_directory_iterator_construct(recursive_directory_iterator& it, path const& dir_path, unsigned int opts, system::error_code* ec);
+BOOST_FILESYSTEM_DECL void recursive_directory_iterator_construct_glob(recursive_directory_iterator& it, path const& dir_path, glob_pattern const& matcher, unsigned int opts, system::error_code* ec);
+BOOST_FILESYSTEM_DECL void recursive_directory_iterator_construct_ignore(recursive_directory_iterator& it, path const& dir_path, ignore_rules const& rules, unsigned int opts, system::error_code* ec);
+BOOST_FILESYSTEM_DECL void recursive_directory_iterator_construct_resume(recursive_directory_iterator& it, std::string const& checkpoint, system::error_code* ec);
 BOOST_FILESYSTEM_DECL void recursive_directory_iterator_increment(recursive_directory_iterator& it, system::error_code* ec);
 BOOST_FILESYSTEM_DECL void recursive_directory_iterator_pop(recursive_directory_iterator& it, system::error_code* ec);
+BOOST_FILESYSTEM_DECL void recursive_directory_iterator_set_observer(recursive_directory_iterator& it, recursive_directory_iterator_observer* observer, void* context);
 
 } // namespace detail
 
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                      recursive_directory_iterator_checkpoint                         //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+//! Saved position of a recursive directory iterator
+/*!
+ * The checkpoint is an opaque sequence of bytes that can be stored, e.g. in a file, and used to construct
+ * a recursive directory iterator that continues the iteration from the saved position, possibly in a different process.
+ * The checkpoint records the path of the bottom directory, the names of the current entries of the open directories,
+ * the directories pending iteration and, if needed to skip visited directories, the identities of the iterated directories.
+ */
+class recursive_directory_iterator_checkpoint
+{
+private:
+    std::string m_data;
+
+public:
+    //! Constructs an empty checkpoint, which refers to the end of iteration
+    recursive_directory_iterator_checkpoint() {}
+    //! Constructs a checkpoint from the serialized data previously returned by \c data()
+    explicit recursive_directory_iterator_checkpoint(std::string const& data) : m_data(data) {}
+
+    //! Returns the serialized checkpoint
+    std::string const& data() const BOOST_NOEXCEPT { return m_data; }
+    //! Returns \c true if the checkpoint refers to the end of iteration
+    bool empty() const BOOST_NOEXCEPT { return m_data.empty(); }
+
+    friend bool operator==(recursive_directory_iterator_checkpoint const& left, recursive_directory_iterator_checkpoint const& right) { return left.m_data == right.m_data; }
+    friend bool operator!=(recursive_directory_iterator_checkpoint const& left, recursive_directory_iterator_checkpoint const& right) { return left.m_data != right.m_data; }
+};
+
 //--------------------------------------------------------------------------------------//
 //                                                                                      //
 //                           recursive_directory_iterator                               //
@@ -545,8 +1232,12 @@ class recursive_directory_iterator :
     friend class boost::iterator_core_access;
 
     friend BOOST_FILESYSTEM_DECL void detail::recursive_directory_iterator_construct(recursive_directory_iterator& it, path const& dir_path, unsigned int opts, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL void detail::recursive_directory_iterator_construct_filtered(recursive_directory_iterator& it, path const& dir_path, unsigned int opts, detail::dir_itr_filter* filter, system::error_code* ec);
     friend BOOST_FILESYSTEM_DECL void detail::recursive_directory_iterator_increment(recursive_directory_iterator& it, system::error_code* ec);
     friend BOOST_FILESYSTEM_DECL void detail::recursive_directory_iterator_pop(recursive_directory_iterator& it, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL void detail::recursive_directory_iterator_construct_resume(recursive_directory_iterator& it, std::string const& checkpoint, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL void detail::recursive_directory_iterator_save(recursive_directory_iterator const& it, std::string& checkpoint, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL void detail::recursive_directory_iterator_set_observer(recursive_directory_iterator& it, recursive_directory_iterator_observer* observer, void* context);
 
 public:
     recursive_directory_iterator() BOOST_NOEXCEPT {} // creates the "end" iterator
@@ -571,6 +1262,71 @@ public:
         detail::recursive_directory_iterator_construct(*this, dir_path, static_cast< unsigned int >(opts), &ec);
     }
 
+    //! Constructs an iterator that only produces the entries with paths relative to \a dir_path matching \a matcher. Subdirectories that cannot contain matching entries are not iterated.
+    recursive_directory_iterator(path const& dir_path, glob_pattern const& matcher, BOOST_SCOPED_ENUM_NATIVE(directory_options) opts = directory_options::none)
+    {
+        detail::recursive_directory_iterator_construct_glob(*this, dir_path, matcher, static_cast< unsigned int >(opts), NULL);
+    }
+
+    recursive_directory_iterator(path const& dir_path, glob_pattern const& matcher, BOOST_SCOPED_ENUM_NATIVE(directory_options) opts, system::error_code& ec)
+    {
+        detail::recursive_directory_iterator_construct_glob(*this, dir_path, matcher, static_cast< unsigned int >(opts), &ec);
+    }
+
+    //! Constructs an iterator that skips the entries, along with their subtrees, excluded by \a rules. Rule files named by \a rules are loaded from every iterated directory.
+    recursive_directory_iterator(path const& dir_path, ignore_rules const& rules, BOOST_SCOPED_ENUM_NATIVE(directory_options) opts = directory_options::none)
+    {
+        detail::recursive_directory_iterator_construct_ignore(*this, dir_path, rules, static_cast< unsigned int >(opts), NULL);
+    }
+
+    recursive_directory_iterator(path const& dir_path, ignore_rules const& rules, BOOST_SCOPED_ENUM_NATIVE(directory_options) opts, system::error_code& ec)
+    {
+        detail::recursive_directory_iterator_construct_ignore(*this, dir_path, rules, static_cast< unsigned int >(opts), &ec);
+    }
+
+    //! Constructs an iterator that skips the entries, along with their subtrees, for which \a exclude returns \c true
+    /*!
+     * The predicate is called as <tt>exclude(name, type)</tt> for every entry before the entry is produced or the directory it refers to is opened,
+     * where \c name is a \c path_view of the entry filename and \c type is the entry type as reported by the directory listing, without following
+     * symlinks, or \c status_error if the type is not known without querying the filesystem. The predicate is copied and the copy is shared by
+     * the copies of the iterator.
+     */
+    template< typename Predicate >
+    recursive_directory_iterator(path const& dir_path, BOOST_SCOPED_ENUM_NATIVE(directory_options) opts, Predicate const& exclude)
+    {
+        boost::intrusive_ptr< detail::dir_itr_filter > filter(new detail::dir_itr_exclude_filter< Predicate >(exclude));
+        detail::recursive_directory_iterator_construct_filtered(*this, dir_path, static_cast< unsigned int >(opts), filter.get(), NULL);
+    }
+
+    template< typename Predicate >
+    recursive_directory_iterator(path const& dir_path, BOOST_SCOPED_ENUM_NATIVE(directory_options) opts, Predicate const& exclude, system::error_code& ec)
+    {
+        boost::intrusive_ptr< detail::dir_itr_filter > filter(new (std::nothrow) detail::dir_itr_exclude_filter< Predicate >(exclude));
+        if (BOOST_UNLIKELY(!filter))
+        {
+            ec = system::errc::make_error_code(system::errc::not_enough_memory);
+            return;
+        }
+
+        detail::recursive_directory_iterator_construct_filtered(*this, dir_path, static_cast< unsigned int >(opts), filter.get(), &ec);
+    }
+
+    //! Constructs an iterator that continues the iteration from \a cp
+    /*!
+     * The directories recorded in the checkpoint are reopened and the iterator refers to the entry that was current when the checkpoint
+     * was made. The entries are located by name, so the directories may be modified between making the checkpoint and resuming.
+     * If a recorded entry no longer exists, the iteration of its directory restarts from the beginning of the directory.
+     */
+    explicit recursive_directory_iterator(recursive_directory_iterator_checkpoint const& cp)
+    {
+        detail::recursive_directory_iterator_construct_resume(*this, cp.data(), NULL);
+    }
+
+    recursive_directory_iterator(recursive_directory_iterator_checkpoint const& cp, system::error_code& ec)
+    {
+        detail::recursive_directory_iterator_construct_resume(*this, cp.data(), &ec);
+    }
+
 #if !defined(BOOST_FILESYSTEM_NO_DEPRECATED)
     // Deprecated constructors
     BOOST_FILESYSTEM_DETAIL_DEPRECATED("Use directory_options instead of symlink_option")
@@ -611,7 +1367,7 @@ public:
     int depth() const BOOST_NOEXCEPT
     {
         BOOST_ASSERT_MSG(!is_end(), "depth() on end recursive_directory_iterator");
-        return static_cast< int >(m_imp->m_stack.size() - 1u);
+        return static_cast< int >(m_imp->m_base_depth + m_imp->m_stack.size() - 1u);
     }
 
     bool recursion_pending() const BOOST_NOEXCEPT
@@ -669,6 +1425,33 @@ public:
         return m_imp->m_stack.back()->symlink_status();
     }
 
+    //! Returns the checkpoint of the current position of the iterator. Iterators constructed with a glob pattern, ignore rules or an exclude predicate are not supported.
+    recursive_directory_iterator_checkpoint checkpoint() const
+    {
+        std::string data;
+        detail::recursive_directory_iterator_save(*this, data, NULL);
+        return recursive_directory_iterator_checkpoint(data);
+    }
+
+    recursive_directory_iterator_checkpoint checkpoint(system::error_code& ec) const
+    {
+        std::string data;
+        detail::recursive_directory_iterator_save(*this, data, &ec);
+        return recursive_directory_iterator_checkpoint(data);
+    }
+
+    //! Sets the observer that is called when directories are pushed to and popped from the iterator stack, or removes it if \a observer is \c NULL
+    /*!
+     * The directories that are already on the stack are reported as pushed immediately, and their statistics only cover the iteration after
+     * the call. Empty directories are reported as pushed and popped after they are opened. The directories that remain on the stack when
+     * the iteration ends with an error or the iterator is destroyed are not reported as popped. The observer is shared by the copies of the iterator.
+     * Has no effect on the end iterator.
+     */
+    void set_observer(recursive_directory_iterator_observer* observer, void* context = NULL)
+    {
+        detail::recursive_directory_iterator_set_observer(*this, observer, context);
+    }
+
 private:
     boost::iterator_facade<
         recursive_directory_iterator,
@@ -0,0 +1,248 @@
+//  boost/filesystem/directory_handle.hpp  ---------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_DIRECTORY_HANDLE_HPP
+#define BOOST_FILESYSTEM_DIRECTORY_HANDLE_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/detail/bitmask.hpp>
+#include <boost/core/scoped_enum.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+//! Options of resolving paths with \c directory_handle::open_beneath
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(resolve_options, unsigned int)
+{
+    none = 0u,
+    no_symlinks = 1u,         // Fail if any element of the path is a symlink, instead of following symlinks that stay beneath the base directory (RESOLVE_NO_SYMLINKS on Linux)
+    no_cross_device = 1u << 1 // Fail if resolving the path crosses a mount point (RESOLVE_NO_XDEV on Linux)
+}
+BOOST_SCOPED_ENUM_DECLARE_END(resolve_options)
+
+BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(resolve_options))
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                              class directory_handle                                //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! An open directory, relative to which other paths can be resolved
+/*!
+ * The handle owns a file descriptor (on POSIX systems) or a \c HANDLE (on Windows) of a directory. Operations on
+ * the handle accept paths that are interpreted relative to the directory, which makes them immune to the directory
+ * being renamed or replaced with a symlink while the operations are performed, and avoids resolving the full path
+ * on every operation. Absolute paths are resolved normally, without regard to the directory.
+ *
+ * On POSIX systems, the operations require *at APIs (e.g. \c openat and \c fstatat) and fail with \c errc::not_supported
+ * if they are not available. On Windows, the operations require Windows Vista or later, and relative paths must not contain
+ * dot or dot-dot elements, except for a single dot that refers to the directory itself.
+ */
+class directory_handle
+{
+public:
+#if defined(BOOST_POSIX_API)
+    typedef int native_handle_type;
+#else
+    typedef void* native_handle_type;
+#endif
+
+public:
+    //! Constructs a handle that does not refer to a directory
+    directory_handle() BOOST_NOEXCEPT : m_handle(invalid_native_handle()) {}
+
+    //! Opens the directory \a p
+    explicit directory_handle(path const& p) : m_handle(invalid_native_handle()) { open_impl(NULL, p); }
+    directory_handle(path const& p, system::error_code& ec) BOOST_NOEXCEPT : m_handle(invalid_native_handle()) { open_impl(NULL, p, &ec); }
+
+    //! Opens the directory \a p, which is resolved relative to \a base
+    directory_handle(directory_handle const& base, path const& p) : m_handle(invalid_native_handle()) { open_impl(&base, p); }
+    directory_handle(directory_handle const& base, path const& p, system::error_code& ec) BOOST_NOEXCEPT : m_handle(invalid_native_handle()) { open_impl(&base, p, &ec); }
+
+    //! Closes the directory
+    ~directory_handle() BOOST_NOEXCEPT { close(); }
+
+    BOOST_DELETED_FUNCTION(directory_handle(directory_handle const&))
+    BOOST_DELETED_FUNCTION(directory_handle& operator=(directory_handle const&))
+
+public:
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    directory_handle(directory_handle&& that) BOOST_NOEXCEPT : m_handle(that.m_handle)
+    {
+        that.m_handle = invalid_native_handle();
+    }
+
+    directory_handle& operator=(directory_handle&& that) BOOST_NOEXCEPT
+    {
+        if (this != &that)
+            assign(that.release());
+        return *this;
+    }
+#endif // !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+
+    //! Returns \c true if the handle refers to a directory
+    bool is_open() const BOOST_NOEXCEPT { return m_handle != invalid_native_handle(); }
+
+    //! Returns the native handle of the directory. The handle is still owned by \c directory_handle.
+    native_handle_type native_handle() const BOOST_NOEXCEPT { return m_handle; }
+
+    //! Closes the currently open directory, if any, and takes ownership of the native handle \a h
+    void assign(native_handle_type h) BOOST_NOEXCEPT
+    {
+        close();
+        m_handle = h;
+    }
+
+    //! Releases the ownership of the native handle and returns it
+    native_handle_type release() BOOST_NOEXCEPT
+    {
+        native_handle_type h = m_handle;
+        m_handle = invalid_native_handle();
+        return h;
+    }
+
+    //! Closes the directory
+    BOOST_FILESYSTEM_DECL void close() BOOST_NOEXCEPT;
+
+    //! Closes the currently open directory, if any, and opens the directory \a p
+    void open(path const& p) { open_impl(NULL, p); }
+    void open(path const& p, system::error_code& ec) BOOST_NOEXCEPT { open_impl(NULL, p, &ec); }
+
+    //! Closes the currently open directory, if any, and opens the directory \a p, which is resolved relative to \a base
+    void open(directory_handle const& base, path const& p) { open_impl(&base, p); }
+    void open(directory_handle const& base, path const& p, system::error_code& ec) BOOST_NOEXCEPT { open_impl(&base, p, &ec); }
+
+    //! Closes the currently open directory, if any, and opens the directory \a p, which is resolved relative to \a base without escaping it
+    /*!
+     * \a p must be relative. Neither dot-dot elements nor symlinks, including the ones in the middle of \a p, are allowed to
+     * resolve to a file outside \a base, in which case the operation fails with \c errc::cross_device_link. Absolute symlinks and
+     * magic links, such as the ones in \c /proc, are always rejected. The resolution is performed by a single \c openat2 call with
+     * \c RESOLVE_BENEATH on Linux 5.6 and later and by walking the path one element at a time otherwise, which is also immune
+     * to concurrent renames of the directories in the path. On Windows, symlinks and junctions cannot be followed and are rejected
+     * with \c errc::too_many_symbolic_link_levels.
+     */
+    void open_beneath(directory_handle const& base, path const& p, BOOST_SCOPED_ENUM_NATIVE(resolve_options) opts = resolve_options::none)
+    {
+        open_beneath_impl(base, p, static_cast< unsigned int >(opts));
+    }
+
+    void open_beneath(directory_handle const& base, path const& p, system::error_code& ec) BOOST_NOEXCEPT
+    {
+        open_beneath_impl(base, p, static_cast< unsigned int >(resolve_options::none), &ec);
+    }
+
+    void open_beneath(directory_handle const& base, path const& p, BOOST_SCOPED_ENUM_NATIVE(resolve_options) opts, system::error_code& ec) BOOST_NOEXCEPT
+    {
+        open_beneath_impl(base, p, static_cast< unsigned int >(opts), &ec);
+    }
+
+    //! Returns the status of the file \a p, resolved relative to the directory. Follows symlinks.
+    file_status status(path const& p) const { return status_impl(p, false); }
+    file_status status(path const& p, system::error_code& ec) const BOOST_NOEXCEPT { return status_impl(p, false, &ec); }
+
+    //! Returns the status of the file \a p, resolved relative to the directory. Does not follow symlinks.
+    file_status symlink_status(path const& p) const { return status_impl(p, true); }
+    file_status symlink_status(path const& p, system::error_code& ec) const BOOST_NOEXCEPT { return status_impl(p, true, &ec); }
+
+    //! Obtains the attributes of the file \a p, resolved relative to the directory, selected by \a mask
+    file_attributes query(path const& p, BOOST_SCOPED_ENUM_NATIVE(file_attribute_mask) mask) const { return query_impl(p, static_cast< unsigned int >(mask)); }
+    file_attributes query(path const& p, BOOST_SCOPED_ENUM_NATIVE(file_attribute_mask) mask, system::error_code& ec) const BOOST_NOEXCEPT { return query_impl(p, static_cast< unsigned int >(mask), &ec); }
+
+    //! Returns the identity of the directory
+    file_identity identity() const { return identity_impl(NULL); }
+    file_identity identity(system::error_code& ec) const BOOST_NOEXCEPT { return identity_impl(NULL, &ec); }
+
+    //! Returns the identity of the file \a p, resolved relative to the directory. Follows symlinks.
+    file_identity identity(path const& p) const { return identity_impl(&p); }
+    file_identity identity(path const& p, system::error_code& ec) const BOOST_NOEXCEPT { return identity_impl(&p, &ec); }
+
+    //! Returns the target of the symlink \a p, resolved relative to the directory
+    filesystem::path read_symlink(path const& p) const { return read_symlink_impl(p); }
+    filesystem::path read_symlink(path const& p, system::error_code& ec) const { return read_symlink_impl(p, &ec); }
+
+    //! Removes the file or empty directory \a p, resolved relative to the directory. Returns \c false if the file does not exist.
+    bool remove(path const& p) const { return remove_impl(p); }
+    bool remove(path const& p, system::error_code& ec) const BOOST_NOEXCEPT { return remove_impl(p, &ec); }
+
+    //! Creates the directory \a p, resolved relative to the directory. Returns \c false if \a p already exists and is a directory.
+    bool create_directory(path const& p) const { return create_directory_impl(p); }
+    bool create_directory(path const& p, system::error_code& ec) const BOOST_NOEXCEPT { return create_directory_impl(p, &ec); }
+
+    //! Renames \a old_p to \a new_p, both resolved relative to the directory
+    void rename(path const& old_p, path const& new_p) const { rename_impl(old_p, *this, new_p); }
+    void rename(path const& old_p, path const& new_p, system::error_code& ec) const BOOST_NOEXCEPT { rename_impl(old_p, *this, new_p, &ec); }
+
+    //! Renames \a old_p, resolved relative to the directory, to \a new_p, resolved relative to \a new_dir
+    void rename(path const& old_p, directory_handle const& new_dir, path const& new_p) const { rename_impl(old_p, new_dir, new_p); }
+    void rename(path const& old_p, directory_handle const& new_dir, path const& new_p, system::error_code& ec) const BOOST_NOEXCEPT { rename_impl(old_p, new_dir, new_p, &ec); }
+
+    friend void swap(directory_handle& left, directory_handle& right) BOOST_NOEXCEPT
+    {
+        native_handle_type h = left.m_handle;
+        left.m_handle = right.m_handle;
+        right.m_handle = h;
+    }
+
+private:
+    static native_handle_type invalid_native_handle() BOOST_NOEXCEPT
+    {
+#if defined(BOOST_POSIX_API)
+        return -1;
+#else
+        // INVALID_HANDLE_VALUE
+        return reinterpret_cast< native_handle_type >(~static_cast< boost::uintptr_t >(0u));
+#endif
+    }
+
+    BOOST_FILESYSTEM_DECL void open_impl(directory_handle const* base, path const& p, system::error_code* ec = NULL);
+    BOOST_FILESYSTEM_DECL void open_beneath_impl(directory_handle const& base, path const& p, unsigned int opts, system::error_code* ec = NULL);
+    BOOST_FILESYSTEM_DECL file_status status_impl(path const& p, bool symlink, system::error_code* ec = NULL) const;
+    BOOST_FILESYSTEM_DECL file_attributes query_impl(path const& p, unsigned int mask, system::error_code* ec = NULL) const;
+    BOOST_FILESYSTEM_DECL file_identity identity_impl(path const* p, system::error_code* ec = NULL) const;
+    BOOST_FILESYSTEM_DECL filesystem::path read_symlink_impl(path const& p, system::error_code* ec = NULL) const;
+    BOOST_FILESYSTEM_DECL bool remove_impl(path const& p, system::error_code* ec = NULL) const;
+    BOOST_FILESYSTEM_DECL bool create_directory_impl(path const& p, system::error_code* ec = NULL) const;
+    BOOST_FILESYSTEM_DECL void rename_impl(path const& old_p, directory_handle const& new_dir, path const& new_p, system::error_code* ec = NULL) const;
+
+private:
+    native_handle_type m_handle;
+};
+
+//! Returns \c true if the handles refer to the same directory
+inline bool equivalent(directory_handle const& dir1, directory_handle const& dir2)
+{
+    return dir1.identity() == dir2.identity();
+}
+
+inline bool equivalent(directory_handle const& dir1, directory_handle const& dir2, system::error_code& ec) BOOST_NOEXCEPT
+{
+    const file_identity id1 = dir1.identity(ec);
+    if (ec)
+        return false;
+    const file_identity id2 = dir2.identity(ec);
+    return !ec && id1 == id2;
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_DIRECTORY_HANDLE_HPP
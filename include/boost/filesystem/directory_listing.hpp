@@ -0,0 +1,217 @@
+//  boost/filesystem/directory_listing.hpp  --------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_DIRECTORY_LISTING_HPP
+#define BOOST_FILESYSTEM_DIRECTORY_LISTING_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/path_view.hpp>
+#include <boost/filesystem/file_status.hpp>
+
+#include <cstddef>
+#include <vector>
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/detail/bitmask.hpp>
+#include <boost/core/scoped_enum.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+//! Options of listing a directory
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(listing_options, unsigned int)
+{
+    none = 0u,
+    skip_permission_denied = 1u, // If the directory cannot be opened because of insufficient permissions, produce an empty listing
+    query_attributes = 1u << 1,  // Query the type, size and last write time of the entries; symlinks are not followed and have no attributes
+    sort_by_name = 1u << 2       // Sort the entries by name, compared as native strings
+}
+BOOST_SCOPED_ENUM_DECLARE_END(listing_options)
+
+BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(listing_options))
+
+//! Record of an entry of a directory listing
+struct directory_listing_record
+{
+    //! Flags of the record
+    enum flags_type
+    {
+        //! Indicates that \c size and \c last_write_time are valid
+        attributes_known = 1u
+    };
+
+    //! Size of the file, if the attributes are known and the file is a regular file, otherwise zero
+    boost::uint64_t size;
+    //! Last write time of the file, in seconds since the Unix epoch, if the attributes are known, otherwise zero
+    boost::int64_t last_write_time;
+    //! Offset of the name in the name storage of the listing, in characters
+    boost::uint32_t name_offset;
+    //! Size of the name, in characters, not including the terminating zero
+    boost::uint32_t name_size;
+    //! \c file_type of the entry, not following symlinks, or \c status_error if the type is not known
+    boost::uint32_t type;
+    //! Combination of \c flags_type values
+    boost::uint32_t flags;
+};
+
+class directory_listing;
+
+namespace detail {
+
+BOOST_FILESYSTEM_DECL void list_directory(directory_listing& listing, path const& p, unsigned int opts, system::error_code* ec);
+
+} // namespace detail
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                             class directory_listing                                //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! Names and attributes of the entries of a directory, stored contiguously
+/*!
+ * The names of all entries are stored in a single buffer, each name followed by a terminating zero, and the entries are
+ * described by an array of \c directory_listing_record, which refer to the names by offsets. No per-entry allocations are
+ * made while listing the directory, and the arrays can be processed directly. The dot and dot-dot entries are not listed.
+ * The records are in the order of the directory listing, unless \c listing_options::sort_by_name is specified.
+ */
+class directory_listing
+{
+    friend BOOST_FILESYSTEM_DECL void detail::list_directory(directory_listing& listing, path const& p, unsigned int opts, system::error_code* ec);
+
+public:
+    //! Constructs an empty listing
+    directory_listing() BOOST_NOEXCEPT {}
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    directory_listing(directory_listing const& that) : m_names(that.m_names), m_records(that.m_records) {}
+
+    directory_listing& operator=(directory_listing const& that)
+    {
+        m_names = that.m_names;
+        m_records = that.m_records;
+        return *this;
+    }
+
+    directory_listing(directory_listing&& that) BOOST_NOEXCEPT
+    {
+        swap(that);
+    }
+
+    directory_listing& operator=(directory_listing&& that) BOOST_NOEXCEPT
+    {
+        m_names.clear();
+        m_records.clear();
+        swap(that);
+        return *this;
+    }
+#endif // !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+
+    //! Replaces the contents of the listing with the entries of the directory \a p. On error, the listing is empty.
+    void list(path const& p, BOOST_SCOPED_ENUM_NATIVE(listing_options) opts = listing_options::none)
+    {
+        detail::list_directory(*this, p, static_cast< unsigned int >(opts), NULL);
+    }
+
+    void list(path const& p, system::error_code& ec)
+    {
+        detail::list_directory(*this, p, static_cast< unsigned int >(listing_options::none), &ec);
+    }
+
+    void list(path const& p, BOOST_SCOPED_ENUM_NATIVE(listing_options) opts, system::error_code& ec)
+    {
+        detail::list_directory(*this, p, static_cast< unsigned int >(opts), &ec);
+    }
+
+    //! Returns the number of entries
+    std::size_t size() const BOOST_NOEXCEPT { return m_records.size(); }
+    //! Returns \c true if there are no entries
+    bool empty() const BOOST_NOEXCEPT { return m_records.empty(); }
+
+    //! Returns the records of the entries, or \c NULL if the listing is empty
+    const directory_listing_record* records() const BOOST_NOEXCEPT { return m_records.empty() ? NULL : &m_records[0]; }
+    //! Returns the storage of the entry names, or \c NULL if the listing is empty
+    const path::value_type* names() const BOOST_NOEXCEPT { return m_names.empty() ? NULL : &m_names[0]; }
+    //! Returns the size of the storage of the entry names, in characters
+    std::size_t names_size() const BOOST_NOEXCEPT { return m_names.size(); }
+
+    //! Returns the record of the entry at the given index
+    directory_listing_record const& operator[](std::size_t index) const BOOST_NOEXCEPT
+    {
+        BOOST_ASSERT(index < m_records.size());
+        return m_records[index];
+    }
+
+    //! Returns the name of the entry at the given index
+    path_view name(std::size_t index) const BOOST_NOEXCEPT
+    {
+        directory_listing_record const& rec = (*this)[index];
+        return path_view(&m_names[rec.name_offset], rec.name_size);
+    }
+
+    //! Returns the type of the entry at the given index, not following symlinks, or \c status_error if the type is not known
+    file_type type(std::size_t index) const BOOST_NOEXCEPT { return static_cast< file_type >((*this)[index].type); }
+
+    //! Removes all entries
+    void clear() BOOST_NOEXCEPT
+    {
+        m_names.clear();
+        m_records.clear();
+    }
+
+    void swap(directory_listing& that) BOOST_NOEXCEPT
+    {
+        m_names.swap(that.m_names);
+        m_records.swap(that.m_records);
+    }
+
+    friend void swap(directory_listing& left, directory_listing& right) BOOST_NOEXCEPT
+    {
+        left.swap(right);
+    }
+
+private:
+    std::vector< path::value_type > m_names;
+    std::vector< directory_listing_record > m_records;
+};
+
+//! Lists the entries of the directory \a p. See \c directory_listing.
+inline directory_listing list_directory(path const& p, BOOST_SCOPED_ENUM_NATIVE(listing_options) opts = listing_options::none)
+{
+    directory_listing listing;
+    listing.list(p, opts);
+    return listing;
+}
+
+inline directory_listing list_directory(path const& p, system::error_code& ec)
+{
+    directory_listing listing;
+    listing.list(p, ec);
+    return listing;
+}
+
+inline directory_listing list_directory(path const& p, BOOST_SCOPED_ENUM_NATIVE(listing_options) opts, system::error_code& ec)
+{
+    directory_listing listing;
+    listing.list(p, opts, ec);
+    return listing;
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_DIRECTORY_LISTING_HPP
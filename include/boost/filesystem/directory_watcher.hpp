@@ -0,0 +1,175 @@
+//  boost/filesystem/directory_watcher.hpp  --------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_DIRECTORY_WATCHER_HPP
+#define BOOST_FILESYSTEM_DIRECTORY_WATCHER_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <cstddef>
+#include <vector>
+#include <boost/system/error_code.hpp>
+#include <boost/detail/bitmask.hpp>
+#include <boost/core/scoped_enum.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+//! Options of watching a directory for changes
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(watch_options, unsigned int)
+{
+    none = 0u,
+    recursive = 1u // Watch the whole subtree of the directory rather than only its immediate entries
+}
+BOOST_SCOPED_ENUM_DECLARE_END(watch_options)
+
+BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(watch_options))
+
+//! Kind of a change reported by \c directory_watcher
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(watch_event_kind, unsigned int)
+{
+    created = 0u,  // A file was created or moved into the watched tree
+    modified = 1u, // Contents or attributes of a file were modified
+    removed = 2u,  // A file was removed or moved out of the watched tree
+    renamed = 3u,  // A file was renamed within the watched tree; the old name is reported in the source member of the event
+    overflow = 4u  // Some changes were lost; the caller should rescan the watched tree
+}
+BOOST_SCOPED_ENUM_DECLARE_END(watch_event_kind)
+
+//! A change in the watched directory tree
+struct watch_event
+{
+    //! Kind of the change
+    BOOST_SCOPED_ENUM_NATIVE(watch_event_kind) kind;
+    //! Path of the changed file. For \c renamed events, the new path of the file. Empty for \c overflow events.
+    path target;
+    //! For \c renamed events, the old path of the file, otherwise empty
+    path source;
+
+    watch_event() BOOST_NOEXCEPT : kind(watch_event_kind::overflow) {}
+    watch_event(BOOST_SCOPED_ENUM_NATIVE(watch_event_kind) k, path const& t) : kind(k), target(t) {}
+    watch_event(BOOST_SCOPED_ENUM_NATIVE(watch_event_kind) k, path const& t, path const& s) : kind(k), target(t), source(s) {}
+};
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                              class directory_watcher                               //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! Watches a directory or a directory tree for changes
+/*!
+ * The watcher receives change notifications from the operating system: inotify on Linux and \c ReadDirectoryChangesW
+ * on Windows. On other systems, the watched tree is periodically scanned and compared with the previous scan.
+ *
+ * The changes are reported by \c read_events as events. Paths in the events are composed of the watched directory path
+ * and the path of the changed file relative to the watched directory. Events for the same file are coalesced while they
+ * are waiting to be read, e.g. multiple modifications of a file are reported as one \c modified event, and a file that
+ * was created and then removed is not reported at all. At most \c capacity events are queued; if more changes occur before
+ * the events are read, the queued events are discarded and a single \c overflow event is reported instead. The same event
+ * is reported if the operating system loses changes. Renames are reported as \c renamed events on Linux and Windows, if
+ * both the old and the new names are in the watched tree.
+ *
+ * The watcher is not thread-safe, except that \c interrupt may be called concurrently with \c read_events.
+ */
+class directory_watcher
+{
+public:
+    //! Default maximum number of queued events
+    static BOOST_CONSTEXPR_OR_CONST std::size_t default_capacity = 4096u;
+    //! Timeout value indicating that \c read_events waits until events are available
+    static BOOST_CONSTEXPR_OR_CONST unsigned int infinite_timeout = ~0u;
+
+public:
+    //! Constructs a watcher that is not watching a directory
+    directory_watcher() BOOST_NOEXCEPT : m_impl(NULL) {}
+
+    //! Starts watching directory \a p
+    explicit directory_watcher(path const& p, BOOST_SCOPED_ENUM_NATIVE(watch_options) options = watch_options::none, std::size_t capacity = default_capacity) :
+        m_impl(NULL)
+    {
+        open_impl(p, static_cast< unsigned int >(options), capacity);
+    }
+    directory_watcher(path const& p, system::error_code& ec) BOOST_NOEXCEPT :
+        m_impl(NULL)
+    {
+        open_impl(p, 0u, default_capacity, &ec);
+    }
+    directory_watcher(path const& p, BOOST_SCOPED_ENUM_NATIVE(watch_options) options, std::size_t capacity, system::error_code& ec) BOOST_NOEXCEPT :
+        m_impl(NULL)
+    {
+        open_impl(p, static_cast< unsigned int >(options), capacity, &ec);
+    }
+
+    ~directory_watcher() BOOST_NOEXCEPT { close(); }
+
+    BOOST_DELETED_FUNCTION(directory_watcher(directory_watcher const&))
+    BOOST_DELETED_FUNCTION(directory_watcher& operator=(directory_watcher const&))
+
+public:
+    //! Stops watching the current directory, if any, and starts watching directory \a p
+    void open(path const& p, BOOST_SCOPED_ENUM_NATIVE(watch_options) options = watch_options::none, std::size_t capacity = default_capacity)
+    {
+        open_impl(p, static_cast< unsigned int >(options), capacity);
+    }
+    void open(path const& p, system::error_code& ec) BOOST_NOEXCEPT
+    {
+        open_impl(p, 0u, default_capacity, &ec);
+    }
+    void open(path const& p, BOOST_SCOPED_ENUM_NATIVE(watch_options) options, std::size_t capacity, system::error_code& ec) BOOST_NOEXCEPT
+    {
+        open_impl(p, static_cast< unsigned int >(options), capacity, &ec);
+    }
+
+    //! Stops watching the directory and discards the queued events
+    BOOST_FILESYSTEM_DECL void close() BOOST_NOEXCEPT;
+
+    //! Returns \c true if the watcher is watching a directory
+    bool is_open() const BOOST_NOEXCEPT { return m_impl != NULL; }
+
+    //! Returns the watched directory path, or an empty path if the watcher is not watching a directory
+    BOOST_FILESYSTEM_DECL path const& watched_path() const BOOST_NOEXCEPT;
+
+    //! Appends the queued events to \a events, waiting up to \a timeout_ms milliseconds for changes
+    /*!
+     * Returns the number of appended events. Returns zero if the timeout expired or \c interrupt was called before
+     * any events were available.
+     */
+    std::size_t read_events(std::vector< watch_event >& events, unsigned int timeout_ms = infinite_timeout)
+    {
+        return read_events_impl(events, timeout_ms);
+    }
+    std::size_t read_events(std::vector< watch_event >& events, unsigned int timeout_ms, system::error_code& ec)
+    {
+        return read_events_impl(events, timeout_ms, &ec);
+    }
+
+    //! Makes a concurrent or the next call to \c read_events return without waiting for changes
+    BOOST_FILESYSTEM_DECL void interrupt() BOOST_NOEXCEPT;
+
+private:
+    struct implementation;
+
+    BOOST_FILESYSTEM_DECL void open_impl(path const& p, unsigned int options, std::size_t capacity, system::error_code* ec = NULL);
+    BOOST_FILESYSTEM_DECL std::size_t read_events_impl(std::vector< watch_event >& events, unsigned int timeout_ms, system::error_code* ec = NULL);
+
+private:
+    implementation* m_impl;
+};
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_DIRECTORY_WATCHER_HPP
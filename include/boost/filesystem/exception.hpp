@@ -13,12 +13,15 @@
 
 #include <boost/filesystem/config.hpp>
 #include <boost/filesystem/path.hpp>
+#include <boost/filesystem/memory_allocator.hpp>
 
+#include <cstddef>
 #include <string>
 #include <boost/system/error_code.hpp>
 #include <boost/system/system_error.hpp>
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 #include <boost/smart_ptr/intrusive_ref_counter.hpp>
+#include <boost/type_traits/alignment_of.hpp>
 
 #include <boost/filesystem/detail/header.hpp> // must be the last #include
 
@@ -80,6 +83,9 @@ private:
             m_path1(path1), m_path2(path2)
         {
         }
+
+        static void* operator new(std::size_t size) { return detail::allocate_memory(size, boost::alignment_of< impl >::value); }
+        static void operator delete(void* p, std::size_t size) BOOST_NOEXCEPT { detail::deallocate_memory(p, size, boost::alignment_of< impl >::value); }
     };
     boost::intrusive_ptr< impl > m_imp_ptr;
 };
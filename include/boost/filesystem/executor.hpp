@@ -0,0 +1,103 @@
+//  boost/filesystem/executor.hpp  ---------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_EXECUTOR_HPP
+#define BOOST_FILESYSTEM_EXECUTOR_HPP
+
+#include <boost/filesystem/config.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                                     executor                                       //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! Interface of executors that run the worker tasks of the parallel operations of the library
+/*!
+ * A parallel operation with \c N workers runs one worker in the calling thread and posts the other <tt>N - 1</tt> workers
+ * to the executor. Workers that have not been started by the executor by the time the calling thread has finished
+ * its own part of the work are run in the calling thread, so the operations complete even if the executor runs
+ * the tasks late or not at all, and an executor with fewer threads than the number of workers limits concurrency
+ * of the operations rather than blocking them. A task that is started after it was run by the calling thread returns
+ * immediately, even if the operation has already completed.
+ *
+ * Executors are typically implemented as adapters for the application's thread pools, e.g. an Asio \c thread_pool or
+ * a TBB task arena. The executor must remain valid while it is being used by the library.
+ */
+class executor
+{
+public:
+    //! Task function, called with the context pointer passed to \c post
+    typedef void task_function(void* context);
+
+public:
+    virtual ~executor() {}
+
+    //! Returns the number of tasks the executor can run concurrently. Used as the number of workers when an operation does not specify it.
+    virtual unsigned int concurrency() const BOOST_NOEXCEPT = 0;
+
+    //! Schedules <tt>fn(context)</tt> for execution. Returns \c false if the task cannot be scheduled, in which case it is run by the caller.
+    virtual bool post(task_function* fn, void* context) BOOST_NOEXCEPT = 0;
+};
+
+//! Executor with a fixed pool of worker threads
+/*!
+ * The tasks are run by the worker threads in the order they are posted. The pool can be shared by multiple operations
+ * to limit the total number of threads used by the parallel operations of the library. In single-threaded builds,
+ * no threads are started and the tasks are run by the operations in the calling thread.
+ */
+class thread_pool_executor :
+    public executor
+{
+private:
+    struct implementation;
+    implementation* m_impl;
+
+public:
+    //! Starts \a thread_count worker threads. Zero means the number of hardware threads. Throws \c std::system_error if no threads could be started.
+    BOOST_FILESYSTEM_DECL explicit thread_pool_executor(unsigned int thread_count = 0u);
+    //! Runs the pending tasks, stops the worker threads and destroys the executor
+    BOOST_FILESYSTEM_DECL ~thread_pool_executor() BOOST_OVERRIDE;
+
+    BOOST_DELETED_FUNCTION(thread_pool_executor(thread_pool_executor const&))
+    BOOST_DELETED_FUNCTION(thread_pool_executor& operator=(thread_pool_executor const&))
+
+    //! Returns the number of worker threads
+    BOOST_FILESYSTEM_DECL unsigned int concurrency() const BOOST_NOEXCEPT BOOST_OVERRIDE;
+    BOOST_FILESYSTEM_DECL bool post(task_function* fn, void* context) BOOST_NOEXCEPT BOOST_OVERRIDE;
+};
+
+//! Returns the executor used by the parallel operations of the library
+/*!
+ * Unless a different executor is set with \c set_executor, the default executor is returned. The default executor starts
+ * a new thread for every task and reports the number of hardware threads as its concurrency, which matches the behavior
+ * of the parallel operations without an executor.
+ */
+BOOST_FILESYSTEM_DECL executor* get_executor() BOOST_NOEXCEPT;
+
+//! Sets the executor used by the parallel operations of the library and returns the previous one. \c NULL restores the default executor.
+/*!
+ * The executor is used by the operations started after the call. The previous executor may still be used by the operations
+ * that are in progress.
+ */
+BOOST_FILESYSTEM_DECL executor* set_executor(executor* ex) BOOST_NOEXCEPT;
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_EXECUTOR_HPP
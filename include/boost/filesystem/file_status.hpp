@@ -17,7 +17,10 @@
 #define BOOST_FILESYSTEM_FILE_STATUS_HPP
 
 #include <boost/filesystem/config.hpp>
+#include <cstddef>
+#include <boost/cstdint.hpp>
 #include <boost/detail/bitmask.hpp>
+#include <boost/core/scoped_enum.hpp>
 
 #include <boost/filesystem/detail/header.hpp> // must be the last #include
 
@@ -236,6 +239,82 @@ inline bool is_regular(file_status f) BOOST_NOEXCEPT
 }
 #endif
 
+//! Consistency of the queried file status and attributes with the server on network filesystems, such as NFS or CephFS
+/*!
+ * The hint is only supported on Linux with \c statx, where it is passed as \c AT_STATX_FORCE_SYNC or \c AT_STATX_DONT_SYNC.
+ * It is ignored on other systems and by local filesystems, which always return up to date attributes.
+ */
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(status_consistency, unsigned int)
+{
+    system_default = 0u, // Synchronize with the server as stat does
+    force_sync = 1u,     // Always revalidate the attributes with the server, even if they are cached
+    dont_sync = 2u       // Use the cached attributes, if any, avoiding a round trip to the server at the cost of possibly stale results
+}
+BOOST_SCOPED_ENUM_DECLARE_END(status_consistency)
+
+//--------------------------------------------------------------------------------------//
+//                                    file_identity                                     //
+//--------------------------------------------------------------------------------------//
+
+//! Identity of a file, which distinguishes it from all other files that exist on the system at the same time
+/*!
+ * On POSIX systems, the identity consists of the device id and the inode number. On Windows, it consists of the volume
+ * serial number and the file id, which is 128-bit on ReFS and 64-bit on other filesystems. Identities can be compared
+ * and hashed without querying the filesystem. Note that the identity of a removed file may be reused by a new file.
+ */
+struct file_identity
+{
+    //! Device id on POSIX systems, volume serial number on Windows
+    boost::uint64_t device;
+    //! Inode number on POSIX systems, the lower 64 bits of the file id on Windows
+    boost::uint64_t id;
+    //! The upper 64 bits of the file id on Windows, zero on other systems
+    boost::uint64_t id_high;
+
+    BOOST_CONSTEXPR file_identity() BOOST_NOEXCEPT : device(0u), id(0u), id_high(0u) {}
+    BOOST_CONSTEXPR file_identity(boost::uint64_t dev, boost::uint64_t id_low, boost::uint64_t id_hi = 0u) BOOST_NOEXCEPT :
+        device(dev), id(id_low), id_high(id_hi)
+    {
+    }
+
+    friend BOOST_CONSTEXPR bool operator==(file_identity const& left, file_identity const& right) BOOST_NOEXCEPT
+    {
+        return left.id == right.id && left.device == right.device && left.id_high == right.id_high;
+    }
+    friend BOOST_CONSTEXPR bool operator!=(file_identity const& left, file_identity const& right) BOOST_NOEXCEPT
+    {
+        return !(left == right);
+    }
+    friend BOOST_CONSTEXPR bool operator<(file_identity const& left, file_identity const& right) BOOST_NOEXCEPT
+    {
+        return left.device < right.device ||
+            (left.device == right.device && (left.id_high < right.id_high || (left.id_high == right.id_high && left.id < right.id)));
+    }
+    friend BOOST_CONSTEXPR bool operator>(file_identity const& left, file_identity const& right) BOOST_NOEXCEPT
+    {
+        return right < left;
+    }
+    friend BOOST_CONSTEXPR bool operator<=(file_identity const& left, file_identity const& right) BOOST_NOEXCEPT
+    {
+        return !(right < left);
+    }
+    friend BOOST_CONSTEXPR bool operator>=(file_identity const& left, file_identity const& right) BOOST_NOEXCEPT
+    {
+        return !(left < right);
+    }
+
+    friend std::size_t hash_value(file_identity const& ident) BOOST_NOEXCEPT
+    {
+        // Inode numbers are often sequential, so mix the bits to make all of them affect the lower bits of the result
+        boost::uint64_t h = ident.id ^ (ident.device * static_cast< boost::uint64_t >(0x9e3779b97f4a7c15ull)) ^
+            (ident.id_high * static_cast< boost::uint64_t >(0xc2b2ae3d27d4eb4full));
+        h ^= h >> 33u;
+        h *= static_cast< boost::uint64_t >(0xff51afd7ed558ccdull);
+        h ^= h >> 33u;
+        return static_cast< std::size_t >(h);
+    }
+};
+
 } // namespace filesystem
 } // namespace boost
 
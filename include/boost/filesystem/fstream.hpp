@@ -18,6 +18,8 @@
 #include <cstddef>
 #include <iosfwd>
 #include <fstream>
+#include <boost/core/scoped_enum.hpp>
+#include <boost/detail/bitmask.hpp>
 
 #include <boost/filesystem/detail/header.hpp> // must be the last #include
 
@@ -53,17 +55,143 @@
 #pragma warning(disable : 4250)
 #endif
 
+// libstdc++ allows to obtain the file descriptor of a file buffer
+#if defined(__GLIBCXX__)
+#define BOOST_FILESYSTEM_HAS_STREAM_NATIVE_HANDLE
+#endif
+
+// Dinkumware standard library only installs a user-provided buffer after the file is opened,
+// other libraries only before the file is opened
+#if defined(_CPPLIB_VER) && !defined(_LIBCPP_VERSION)
+#define BOOST_FILESYSTEM_DETAIL_SETBUF_AFTER_OPEN
+#endif
+
 namespace boost {
 namespace filesystem {
 
+//! Options of opening file streams
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(stream_options, unsigned int)
+{
+    none = 0u,
+    sequential = 1u,          // The file will be read sequentially (POSIX_FADV_SEQUENTIAL)
+    random = 1u << 1,         // The file will be accessed in random order (POSIX_FADV_RANDOM)
+    will_need = 1u << 2,      // The file contents will be accessed soon and should be read ahead (POSIX_FADV_WILLNEED)
+    no_access_time = 1u << 3  // Do not update the last access time of the file on reads, if supported (O_NOATIME)
+}
+BOOST_SCOPED_ENUM_DECLARE_END(stream_options)
+
+BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(stream_options))
+
+namespace detail {
+
+#if defined(BOOST_POSIX_API)
+typedef int stream_native_handle_type;
+#else
+typedef void* stream_native_handle_type; // HANDLE
+#endif
+
+//! Returns the native handle of the file identified by the C runtime file descriptor
+BOOST_FILESYSTEM_DECL stream_native_handle_type stream_native_handle(int fd) BOOST_NOEXCEPT;
+//! Returns the invalid native handle value
+BOOST_FILESYSTEM_DECL stream_native_handle_type invalid_stream_native_handle() BOOST_NOEXCEPT;
+//! Applies \c stream_options to the file identified by the C runtime file descriptor. The options are hints, errors are ignored.
+BOOST_FILESYSTEM_DECL void apply_stream_options(int fd, unsigned int options) BOOST_NOEXCEPT;
+
+//! Returns the C runtime file descriptor used by the file buffer or -1, if not known
+template< class charT, class traits >
+class filebuf_fd_accessor :
+    public std::basic_filebuf< charT, traits >
+{
+public:
+    static int get(std::basic_filebuf< charT, traits > const* fb) BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_STREAM_NATIVE_HANDLE)
+        // The member pointer is formed through the derived class to gain access to the protected member of the base class
+        return (const_cast< std::basic_filebuf< charT, traits >* >(fb)->*(&filebuf_fd_accessor::_M_file)).fd();
+#else
+        (void)fb;
+        return -1;
+#endif
+    }
+};
+
+//! Storage of a user-provided file buffer. Must be a base class preceding the standard file buffer or stream, so that the storage outlives it.
+template< class charT >
+class stream_buffer_storage
+{
+private:
+    charT* m_buffer;
+
+    BOOST_DELETED_FUNCTION(stream_buffer_storage(stream_buffer_storage const&))
+    BOOST_DELETED_FUNCTION(stream_buffer_storage& operator=(stream_buffer_storage const&))
+
+protected:
+    stream_buffer_storage() BOOST_NOEXCEPT : m_buffer(NULL) {}
+    ~stream_buffer_storage() { delete[] m_buffer; }
+
+    //! Opens the file \a p in \a fb with a buffer of \a buffer_size characters, or the default buffer if \a buffer_size is 0
+    template< class traits >
+    bool open_with_options(std::basic_filebuf< charT, traits >* fb, path const& p, std::ios_base::openmode mode, std::size_t buffer_size, unsigned int options)
+    {
+        charT* buffer = NULL;
+        if (buffer_size > 0u)
+        {
+            buffer = new charT[buffer_size];
+#if !defined(BOOST_FILESYSTEM_DETAIL_SETBUF_AFTER_OPEN)
+            fb->pubsetbuf(buffer, static_cast< std::streamsize >(buffer_size));
+#endif
+        }
+
+        if (!fb->open(BOOST_FILESYSTEM_C_STR(p), mode))
+        {
+            delete[] buffer;
+            return false;
+        }
+
+        if (buffer)
+        {
+#if defined(BOOST_FILESYSTEM_DETAIL_SETBUF_AFTER_OPEN)
+            fb->pubsetbuf(buffer, static_cast< std::streamsize >(buffer_size));
+#endif
+            // The previous buffer is no longer used after the file buffer was closed and opened again
+            delete[] m_buffer;
+            m_buffer = buffer;
+        }
+
+        if (options != 0u)
+        {
+            const int fd = filebuf_fd_accessor< charT, traits >::get(fb);
+            if (fd >= 0)
+                apply_stream_options(fd, options);
+        }
+
+        return true;
+    }
+
+    //! Returns the native handle of the file opened in \a fb
+    template< class traits >
+    static stream_native_handle_type get_native_handle(std::basic_filebuf< charT, traits > const* fb) BOOST_NOEXCEPT
+    {
+        const int fd = filebuf_fd_accessor< charT, traits >::get(fb);
+        return fd >= 0 ? stream_native_handle(fd) : invalid_stream_native_handle();
+    }
+};
+
+} // namespace detail
+
 //--------------------------------------------------------------------------------------//
 //                                  basic_filebuf                                       //
 //--------------------------------------------------------------------------------------//
 
 template< class charT, class traits = std::char_traits< charT > >
 class basic_filebuf :
+    private detail::stream_buffer_storage< charT >,
     public std::basic_filebuf< charT, traits >
 {
+public:
+    //! Native file handle type: a file descriptor on POSIX systems, \c HANDLE on Windows
+    typedef detail::stream_native_handle_type native_handle_type;
+
 public:
     BOOST_DEFAULTED_FUNCTION(basic_filebuf(), {})
     BOOST_DELETED_FUNCTION(basic_filebuf(basic_filebuf const&))
@@ -74,6 +202,18 @@ public:
     {
         return std::basic_filebuf< charT, traits >::open(BOOST_FILESYSTEM_C_STR(p), mode) ? this : NULL;
     }
+
+    //! Opens the file with a buffer of \a buffer_size characters (0 means the default buffer) and applies \a options
+    basic_filebuf< charT, traits >* open(path const& p, std::ios_base::openmode mode, std::size_t buffer_size, BOOST_SCOPED_ENUM_NATIVE(stream_options) options = stream_options::none)
+    {
+        return this->open_with_options(static_cast< std::basic_filebuf< charT, traits >* >(this), p, mode, buffer_size, static_cast< unsigned int >(options)) ? this : NULL;
+    }
+
+    //! Returns the native handle of the opened file. Returns an invalid handle if the file is not open or the standard library does not support obtaining it.
+    native_handle_type native_handle() const BOOST_NOEXCEPT
+    {
+        return this->get_native_handle(static_cast< std::basic_filebuf< charT, traits > const* >(this));
+    }
 };
 
 //--------------------------------------------------------------------------------------//
@@ -82,8 +222,13 @@ public:
 
 template< class charT, class traits = std::char_traits< charT > >
 class basic_ifstream :
+    private detail::stream_buffer_storage< charT >,
     public std::basic_ifstream< charT, traits >
 {
+public:
+    //! Native file handle type: a file descriptor on POSIX systems, \c HANDLE on Windows
+    typedef detail::stream_native_handle_type native_handle_type;
+
 public:
     BOOST_DEFAULTED_FUNCTION(basic_ifstream(), {})
 
@@ -96,6 +241,12 @@ public:
     basic_ifstream(path const& p, std::ios_base::openmode mode) :
         std::basic_ifstream< charT, traits >(BOOST_FILESYSTEM_C_STR(p), mode) {}
 
+    //! Opens the file with a buffer of \a buffer_size characters (0 means the default buffer) and applies \a options
+    basic_ifstream(path const& p, std::ios_base::openmode mode, std::size_t buffer_size, BOOST_SCOPED_ENUM_NATIVE(stream_options) options = stream_options::none)
+    {
+        open(p, mode, buffer_size, options);
+    }
+
     BOOST_DELETED_FUNCTION(basic_ifstream(basic_ifstream const&))
     BOOST_DELETED_FUNCTION(basic_ifstream const& operator=(basic_ifstream const&))
 
@@ -109,6 +260,21 @@ public:
     {
         std::basic_ifstream< charT, traits >::open(BOOST_FILESYSTEM_C_STR(p), mode);
     }
+
+    //! Opens the file with a buffer of \a buffer_size characters (0 means the default buffer) and applies \a options
+    void open(path const& p, std::ios_base::openmode mode, std::size_t buffer_size, BOOST_SCOPED_ENUM_NATIVE(stream_options) options = stream_options::none)
+    {
+        if (this->open_with_options(this->rdbuf(), p, mode, buffer_size, static_cast< unsigned int >(options)))
+            this->clear();
+        else
+            this->setstate(std::ios_base::failbit);
+    }
+
+    //! Returns the native handle of the opened file. Returns an invalid handle if the file is not open or the standard library does not support obtaining it.
+    native_handle_type native_handle() const BOOST_NOEXCEPT
+    {
+        return this->get_native_handle(this->rdbuf());
+    }
 };
 
 //--------------------------------------------------------------------------------------//
@@ -117,8 +283,13 @@ public:
 
 template< class charT, class traits = std::char_traits< charT > >
 class basic_ofstream :
+    private detail::stream_buffer_storage< charT >,
     public std::basic_ofstream< charT, traits >
 {
+public:
+    //! Native file handle type: a file descriptor on POSIX systems, \c HANDLE on Windows
+    typedef detail::stream_native_handle_type native_handle_type;
+
 public:
     BOOST_DEFAULTED_FUNCTION(basic_ofstream(), {})
 
@@ -131,6 +302,12 @@ public:
     basic_ofstream(path const& p, std::ios_base::openmode mode) :
         std::basic_ofstream< charT, traits >(BOOST_FILESYSTEM_C_STR(p), mode) {}
 
+    //! Opens the file with a buffer of \a buffer_size characters (0 means the default buffer) and applies \a options
+    basic_ofstream(path const& p, std::ios_base::openmode mode, std::size_t buffer_size, BOOST_SCOPED_ENUM_NATIVE(stream_options) options = stream_options::none)
+    {
+        open(p, mode, buffer_size, options);
+    }
+
     BOOST_DELETED_FUNCTION(basic_ofstream(basic_ofstream const&))
     BOOST_DELETED_FUNCTION(basic_ofstream const& operator=(basic_ofstream const&))
 
@@ -144,6 +321,21 @@ public:
     {
         std::basic_ofstream< charT, traits >::open(BOOST_FILESYSTEM_C_STR(p), mode);
     }
+
+    //! Opens the file with a buffer of \a buffer_size characters (0 means the default buffer) and applies \a options
+    void open(path const& p, std::ios_base::openmode mode, std::size_t buffer_size, BOOST_SCOPED_ENUM_NATIVE(stream_options) options = stream_options::none)
+    {
+        if (this->open_with_options(this->rdbuf(), p, mode, buffer_size, static_cast< unsigned int >(options)))
+            this->clear();
+        else
+            this->setstate(std::ios_base::failbit);
+    }
+
+    //! Returns the native handle of the opened file. Returns an invalid handle if the file is not open or the standard library does not support obtaining it.
+    native_handle_type native_handle() const BOOST_NOEXCEPT
+    {
+        return this->get_native_handle(this->rdbuf());
+    }
 };
 
 //--------------------------------------------------------------------------------------//
@@ -152,8 +344,13 @@ public:
 
 template< class charT, class traits = std::char_traits< charT > >
 class basic_fstream :
+    private detail::stream_buffer_storage< charT >,
     public std::basic_fstream< charT, traits >
 {
+public:
+    //! Native file handle type: a file descriptor on POSIX systems, \c HANDLE on Windows
+    typedef detail::stream_native_handle_type native_handle_type;
+
 public:
     BOOST_DEFAULTED_FUNCTION(basic_fstream(), {})
 
@@ -166,6 +363,12 @@ public:
     basic_fstream(path const& p, std::ios_base::openmode mode) :
         std::basic_fstream< charT, traits >(BOOST_FILESYSTEM_C_STR(p), mode) {}
 
+    //! Opens the file with a buffer of \a buffer_size characters (0 means the default buffer) and applies \a options
+    basic_fstream(path const& p, std::ios_base::openmode mode, std::size_t buffer_size, BOOST_SCOPED_ENUM_NATIVE(stream_options) options = stream_options::none)
+    {
+        open(p, mode, buffer_size, options);
+    }
+
     BOOST_DELETED_FUNCTION(basic_fstream(basic_fstream const&))
     BOOST_DELETED_FUNCTION(basic_fstream const& operator=(basic_fstream const&))
 
@@ -179,6 +382,21 @@ public:
     {
         std::basic_fstream< charT, traits >::open(BOOST_FILESYSTEM_C_STR(p), mode);
     }
+
+    //! Opens the file with a buffer of \a buffer_size characters (0 means the default buffer) and applies \a options
+    void open(path const& p, std::ios_base::openmode mode, std::size_t buffer_size, BOOST_SCOPED_ENUM_NATIVE(stream_options) options = stream_options::none)
+    {
+        if (this->open_with_options(this->rdbuf(), p, mode, buffer_size, static_cast< unsigned int >(options)))
+            this->clear();
+        else
+            this->setstate(std::ios_base::failbit);
+    }
+
+    //! Returns the native handle of the opened file. Returns an invalid handle if the file is not open or the standard library does not support obtaining it.
+    native_handle_type native_handle() const BOOST_NOEXCEPT
+    {
+        return this->get_native_handle(this->rdbuf());
+    }
 };
 
 //--------------------------------------------------------------------------------------//
@@ -0,0 +1,141 @@
+//  boost/filesystem/glob.hpp  ---------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_GLOB_HPP
+#define BOOST_FILESYSTEM_GLOB_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <cstddef>
+#include <vector>
+#include <boost/system/error_code.hpp>
+#include <boost/smart_ptr/intrusive_ptr.hpp>
+#include <boost/smart_ptr/intrusive_ref_counter.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+namespace detail {
+
+//! Element of a compiled glob pattern, matching one element of a path
+struct glob_element
+{
+    enum kind_type
+    {
+        //! Matches a name equal to the text
+        literal,
+        //! Matches a name according to the wildcards in the text
+        wildcard,
+        //! Matches zero or more path elements
+        globstar,
+        //! Terminates an alternative of the pattern, the path matched so far matches the pattern
+        end
+    };
+
+    kind_type kind;
+    path::string_type text;
+
+    explicit glob_element(kind_type k) : kind(k) {}
+    glob_element(kind_type k, path::string_type const& t) : kind(k), text(t) {}
+};
+
+struct glob_pattern_impl :
+    public boost::intrusive_ref_counter< glob_pattern_impl >
+{
+    //! The pattern, as specified by user
+    path pattern;
+    //! Root path and the leading elements of the pattern that contain no wildcards, where a search for the pattern starts
+    path base;
+    //! Elements of all alternatives of the pattern, produced by brace expansion. Elements of the root path are not included.
+    std::vector< glob_element > elements;
+    //! Indices of the first elements of the alternatives
+    std::vector< std::size_t > alternatives;
+    //! Number of elements of every alternative that are included in \c base
+    std::size_t base_size;
+
+    glob_pattern_impl() : base_size(0u) {}
+};
+
+//! Compiles a glob pattern. The returned object has one reference, which is owned by the caller.
+BOOST_FILESYSTEM_DECL glob_pattern_impl* compile_glob_pattern(path const& pattern);
+BOOST_FILESYSTEM_DECL bool glob_match(glob_pattern_impl const& impl, path const& p);
+BOOST_FILESYSTEM_DECL std::vector< path > glob(path const& pattern, unsigned int opts, system::error_code* ec);
+
+} // namespace detail
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                                 class glob_pattern                                 //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! A compiled glob pattern
+/*!
+ * The pattern consists of path elements separated by directory separators. Each element is matched against one element
+ * of a path and may contain the following wildcards:
+ *
+ * \li <tt>*</tt> matches any sequence of characters, including an empty one;
+ * \li <tt>?</tt> matches any single character;
+ * \li <tt>[...]</tt> matches any single character from the set, which may contain ranges like <tt>a-z</tt>. The set is negated
+ *     if its first character is <tt>!</tt> or <tt>^</tt>.
+ *
+ * An element consisting of <tt>**</tt> matches zero or more path elements. Brace sets like <tt>{a,b,c}</tt> are expanded
+ * into alternatives, which may be nested and span across separators. Wildcards never match the leading dot of a name,
+ * so hidden files are only matched by elements that start with a dot. On POSIX systems, a backslash escapes the next
+ * character. Characters are compared as is, so matching is case-sensitive.
+ */
+class glob_pattern
+{
+public:
+    //! Constructs an empty pattern, which does not match any path
+    glob_pattern() BOOST_NOEXCEPT {}
+    //! Compiles \a pattern
+    explicit glob_pattern(path const& pattern) : m_impl(detail::compile_glob_pattern(pattern), false) {}
+
+    //! Returns \c true if the pattern is empty
+    bool empty() const BOOST_NOEXCEPT { return !m_impl; }
+
+    //! Returns the pattern, as it was specified on construction
+    path pattern() const { return m_impl ? m_impl->pattern : path(); }
+
+    //! Returns the root path and the leading elements of the pattern that contain no wildcards. \c glob() starts the search in this directory.
+    path base() const { return m_impl ? m_impl->base : path(); }
+
+    //! Returns \c true if relative path \a p matches the pattern. The root path of the pattern is not matched.
+    bool match(path const& p) const { return m_impl && detail::glob_match(*m_impl, p); }
+
+    //! Returns the compiled pattern. For internal use only.
+    detail::glob_pattern_impl const* get_impl() const BOOST_NOEXCEPT { return m_impl.get(); }
+
+private:
+    boost::intrusive_ptr< const detail::glob_pattern_impl > m_impl;
+};
+
+//! Returns the sorted list of the existing paths matching \a pattern. Returns an empty list if the base directory of the pattern does not exist.
+inline std::vector< path > glob(path const& pattern, BOOST_SCOPED_ENUM_NATIVE(directory_options) opts = directory_options::none)
+{
+    return detail::glob(pattern, static_cast< unsigned int >(opts), NULL);
+}
+
+inline std::vector< path > glob(path const& pattern, BOOST_SCOPED_ENUM_NATIVE(directory_options) opts, system::error_code& ec)
+{
+    return detail::glob(pattern, static_cast< unsigned int >(opts), &ec);
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_GLOB_HPP
@@ -0,0 +1,144 @@
+//  boost/filesystem/ignore_rules.hpp  -------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_IGNORE_RULES_HPP
+#define BOOST_FILESYSTEM_IGNORE_RULES_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/glob.hpp>
+#include <cstddef>
+#include <vector>
+#include <boost/system/error_code.hpp>
+#include <boost/smart_ptr/intrusive_ptr.hpp>
+#include <boost/smart_ptr/intrusive_ref_counter.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+namespace detail {
+
+//! Compiled rule of an ignore file
+struct ignore_rule
+{
+    enum flags
+    {
+        //! The rule re-includes the matching paths
+        negated = 1u,
+        //! The rule only matches directories
+        directory_only = 1u << 1
+    };
+
+    //! Index of the first element of the rule in \c ignore_rules_impl::elements
+    std::size_t first_element;
+    //! Combination of \c flags
+    unsigned int rule_flags;
+
+    ignore_rule(std::size_t first, unsigned int f) BOOST_NOEXCEPT : first_element(first), rule_flags(f) {}
+};
+
+struct ignore_rules_impl :
+    public boost::intrusive_ref_counter< ignore_rules_impl >
+{
+    //! Elements of all rules. Every rule is terminated with an \c end element.
+    std::vector< glob_element > elements;
+    //! Rules, in the order of addition
+    std::vector< ignore_rule > rules;
+    //! Names of the rule files that are loaded from every iterated directory
+    std::vector< path > rule_file_names;
+};
+
+BOOST_FILESYSTEM_DECL void add_ignore_rule(ignore_rules_impl& impl, path::string_type const& rule);
+BOOST_FILESYSTEM_DECL void add_ignore_file(ignore_rules_impl& impl, path const& file, system::error_code* ec);
+BOOST_FILESYSTEM_DECL bool ignore_match(ignore_rules_impl const& impl, path const& p, bool is_directory);
+
+} // namespace detail
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                                 class ignore_rules                                 //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! A compiled set of rules that exclude paths, following the syntax and semantics of \c .gitignore files
+/*!
+ * Every rule is a pattern of path elements separated by forward slashes, which may contain the same wildcards as
+ * \c glob_pattern, except for brace sets. Unlike \c glob_pattern, wildcards also match the leading dot of a name.
+ * A backslash always escapes the next character. Following \c .gitignore:
+ *
+ * \li blank rules and rules starting with <tt>#</tt> are ignored, trailing spaces are removed unless escaped;
+ * \li a rule starting with <tt>!</tt> re-includes the paths excluded by the previous rules;
+ * \li a rule ending with a slash only matches directories;
+ * \li a rule containing a slash at the beginning or in the middle is anchored to the directory the rules apply to,
+ *     other rules match a name at any depth below that directory;
+ * \li <tt>**</tt> between slashes matches zero or more elements, a trailing <tt>**</tt> element matches everything inside a directory;
+ * \li if several rules match a path, the last one wins.
+ *
+ * When used with \c recursive_directory_iterator, the rules apply to the paths relative to the iterated directory, and
+ * excluded directories are not opened. Rule files, such as \c .gitignore, are loaded from every iterated directory and apply
+ * to the paths relative to that directory, taking precedence over the rules of the parent directories.
+ */
+class ignore_rules
+{
+public:
+    //! Constructs an empty set of rules, which does not exclude any path
+    ignore_rules() BOOST_NOEXCEPT {}
+
+    //! Returns \c true if the set contains no rules and no rule file names
+    bool empty() const BOOST_NOEXCEPT { return !m_impl || (m_impl->rules.empty() && m_impl->rule_file_names.empty()); }
+
+    //! Returns the number of rules in the set, not including the rules of per-directory rule files
+    std::size_t size() const BOOST_NOEXCEPT { return m_impl ? m_impl->rules.size() : 0u; }
+
+    //! Compiles and adds \a rule to the set. Blank rules and comments are ignored.
+    void add(path const& rule) { detail::add_ignore_rule(mutable_impl(), rule.native()); }
+
+    //! Adds the rules from the lines of file \a p
+    void add_file(path const& p) { detail::add_ignore_file(mutable_impl(), p, NULL); }
+    void add_file(path const& p, system::error_code& ec) { detail::add_ignore_file(mutable_impl(), p, &ec); }
+
+    //! Adds the name of rule files, such as <tt>.gitignore</tt>, that are loaded from every iterated directory
+    void add_rule_file_name(path const& name) { mutable_impl().rule_file_names.push_back(name); }
+
+    //! Returns \c true if relative path \a p is excluded by the rules. Rule files are not loaded.
+    /*!
+     * \a is_directory indicates whether \a p refers to a directory. The parent directories of \a p are always considered directories,
+     * so a path is also excluded if any of its parent directories are excluded.
+     */
+    bool is_ignored(path const& p, bool is_directory = false) const { return m_impl && detail::ignore_match(*m_impl, p, is_directory); }
+
+    //! Returns the compiled rules. For internal use only.
+    detail::ignore_rules_impl const* get_impl() const BOOST_NOEXCEPT { return m_impl.get(); }
+
+private:
+    //! Returns the rules for modification, copying them if they are shared with other objects or directory iterators
+    detail::ignore_rules_impl& mutable_impl()
+    {
+        if (!m_impl)
+            m_impl = new detail::ignore_rules_impl();
+        else if (m_impl->use_count() > 1u)
+            m_impl = new detail::ignore_rules_impl(*m_impl);
+        return *m_impl;
+    }
+
+private:
+    boost::intrusive_ptr< detail::ignore_rules_impl > m_impl;
+};
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_IGNORE_RULES_HPP
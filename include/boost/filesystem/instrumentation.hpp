@@ -0,0 +1,132 @@
+//  boost/filesystem/instrumentation.hpp  ----------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_INSTRUMENTATION_HPP
+#define BOOST_FILESYSTEM_INSTRUMENTATION_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <cstddef>
+#include <boost/cstdint.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+//! Operations counted by the library instrumentation
+/*!
+ * The instrumentation is only collected if the library was built with \c BOOST_FILESYSTEM_ENABLE_INSTRUMENTATION defined.
+ * Otherwise, all counters are always zero.
+ */
+struct instrumented_operation
+{
+    enum type
+    {
+        //! \c stat, \c lstat and \c fstatat calls, including those emulating \c statx
+        stat,
+        //! \c statx calls
+        statx,
+        //! Opening directories for iteration
+        open_directory,
+        //! \c getdents64 calls that read directory entries in bulk
+        getdents,
+        //! \c readdir and \c readdir_r calls
+        readdir,
+        //! \c unlink, \c unlinkat and \c rmdir calls issued by \c remove and \c remove_all
+        unlink,
+        //! \c copy_file data transfers using a loop of \c read and \c write calls
+        copy_read_write,
+        //! \c copy_file data transfers using \c sendfile
+        copy_sendfile,
+        //! \c copy_file data transfers using \c copy_file_range
+        copy_file_range,
+        //! \c copy_file data transfers using unbuffered I/O
+        copy_unbuffered,
+        //! \c copy_file data transfers that preserve holes in sparse files
+        copy_sparse,
+        //! \c copy_file attempts to clone the file contents
+        copy_clone,
+        //! \c copy_file data transfers that only write the blocks that differ in the existing target file
+        copy_delta,
+        //! \c copy_data transfers using \c splice
+        copy_splice,
+        //! \c copy_file data transfers using io_uring
+        copy_io_uring,
+        //! Permanent switches to a less efficient implementation because the preferred one is not supported by the system.
+        //! These events have no latency.
+        implementation_fallback,
+        //! Temporary switches to a less efficient implementation for a single operation, e.g. when the filesystem does not
+        //! support the preferred one. These events have no latency. The duration of the operation that falls back includes
+        //! the duration of the fallback.
+        operation_fallback,
+
+        //! The number of instrumented operations
+        count
+    };
+};
+
+//! The number of buckets in the latency histograms
+BOOST_CONSTEXPR_OR_CONST std::size_t instrumentation_histogram_size = 12u;
+
+//! Returns the upper bound of latency for the histogram \a bucket, in nanoseconds
+/*!
+ * The bucket bounds are 1 us, 4 us, 16 us and so on, each bound being 4 times greater than the previous one.
+ * The last bucket has no upper bound, and the function returns the largest value of \c boost::uint64_t for it.
+ */
+inline boost::uint64_t instrumentation_histogram_bound(std::size_t bucket) BOOST_NOEXCEPT
+{
+    if (bucket + 1u >= instrumentation_histogram_size)
+        return ~static_cast< boost::uint64_t >(0u);
+    return static_cast< boost::uint64_t >(1000u) << (bucket * 2u);
+}
+
+//! Counters of an instrumented operation
+struct instrumentation_counters
+{
+    //! The number of calls
+    boost::uint64_t calls;
+    //! The total duration of calls, in nanoseconds
+    boost::uint64_t total_ns;
+    //! The number of calls with the duration falling into the bucket. The buckets are not cumulative.
+    boost::uint64_t histogram[instrumentation_histogram_size];
+};
+
+//! A snapshot of all instrumentation counters
+struct instrumentation_snapshot
+{
+    instrumentation_counters operations[instrumented_operation::count];
+
+    //! Returns the counters of operation \a op
+    instrumentation_counters const& operator[](instrumented_operation::type op) const BOOST_NOEXCEPT { return operations[op]; }
+};
+
+//! Returns \c true if the library was built with instrumentation enabled
+BOOST_FILESYSTEM_DECL bool instrumentation_enabled() BOOST_NOEXCEPT;
+
+//! Fills \a snapshot with the current values of the counters, accumulated from all threads
+/*!
+ * The counters are updated by different threads independently, so the snapshot is not atomic with respect to
+ * the operations that run concurrently.
+ */
+BOOST_FILESYSTEM_DECL void get_instrumentation_snapshot(instrumentation_snapshot& snapshot) BOOST_NOEXCEPT;
+
+//! Resets all counters to zero
+BOOST_FILESYSTEM_DECL void reset_instrumentation() BOOST_NOEXCEPT;
+
+//! Returns the name of the operation \a op, suitable for use as a metric label, or \c NULL if \a op is invalid
+BOOST_FILESYSTEM_DECL const char* get_instrumented_operation_name(unsigned int op) BOOST_NOEXCEPT;
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_INSTRUMENTATION_HPP
@@ -0,0 +1,167 @@
+//  boost/filesystem/mapped_file.hpp  --------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_MAPPED_FILE_HPP
+#define BOOST_FILESYSTEM_MAPPED_FILE_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <cstddef>
+#include <boost/detail/bitmask.hpp>
+#include <boost/core/scoped_enum.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+//! Options of mapping a file into memory
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(mapped_file_flags, unsigned int)
+{
+    none = 0u,
+    sequential = 1u,       // The contents will be accessed sequentially (MADV_SEQUENTIAL)
+    random = 1u << 1,      // The contents will be accessed in random order (MADV_RANDOM)
+    will_need = 1u << 2,   // The contents will be accessed soon and should be read ahead (MADV_WILLNEED)
+    huge_pages = 1u << 3,  // Use huge pages for the mapping, if supported (MADV_HUGEPAGE)
+    populate = 1u << 4     // Read the contents into memory when the file is mapped (MAP_POPULATE)
+}
+BOOST_SCOPED_ENUM_DECLARE_END(mapped_file_flags)
+
+BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(mapped_file_flags))
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                                 class mapped_file                                  //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! A read-only view of the contents of a file, mapped into memory
+/*!
+ * The file is mapped with \c mmap on POSIX systems and \c CreateFileMapping on Windows, and its contents are accessible
+ * as a contiguous range of characters without copying. The file is closed once mapped; the mapping remains valid until
+ * it is closed or the \c mapped_file object is destroyed. Only regular files can be mapped. Empty files, as well as files
+ * that report zero size, such as files in /proc, result in an empty mapping with a null \c data pointer.
+ *
+ * If the file is truncated by another process while mapped, accessing the removed part of the mapping may result in
+ * \c SIGBUS on POSIX systems or an access violation on Windows.
+ */
+class mapped_file
+{
+public:
+    typedef char value_type;
+    typedef const char* const_iterator;
+    typedef const char* iterator;
+    typedef std::size_t size_type;
+
+public:
+    //! Constructs an object that does not refer to a mapped file
+    mapped_file() BOOST_NOEXCEPT : m_data(NULL), m_size(0u), m_is_open(false) {}
+
+    //! Maps the file \a p
+    explicit mapped_file(path const& p, BOOST_SCOPED_ENUM_NATIVE(mapped_file_flags) flags = mapped_file_flags::none) :
+        m_data(NULL), m_size(0u), m_is_open(false)
+    {
+        open_impl(p, static_cast< unsigned int >(flags));
+    }
+    mapped_file(path const& p, system::error_code& ec) BOOST_NOEXCEPT :
+        m_data(NULL), m_size(0u), m_is_open(false)
+    {
+        open_impl(p, 0u, &ec);
+    }
+    mapped_file(path const& p, BOOST_SCOPED_ENUM_NATIVE(mapped_file_flags) flags, system::error_code& ec) BOOST_NOEXCEPT :
+        m_data(NULL), m_size(0u), m_is_open(false)
+    {
+        open_impl(p, static_cast< unsigned int >(flags), &ec);
+    }
+
+    //! Unmaps the file
+    ~mapped_file() BOOST_NOEXCEPT { close(); }
+
+    BOOST_DELETED_FUNCTION(mapped_file(mapped_file const&))
+    BOOST_DELETED_FUNCTION(mapped_file& operator=(mapped_file const&))
+
+public:
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    mapped_file(mapped_file&& that) BOOST_NOEXCEPT : m_data(that.m_data), m_size(that.m_size), m_is_open(that.m_is_open)
+    {
+        that.m_data = NULL;
+        that.m_size = 0u;
+        that.m_is_open = false;
+    }
+
+    mapped_file& operator=(mapped_file&& that) BOOST_NOEXCEPT
+    {
+        if (this != &that)
+        {
+            close();
+            swap(*this, that);
+        }
+        return *this;
+    }
+#endif // !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+
+    //! Unmaps the currently mapped file, if any, and maps the file \a p
+    void open(path const& p, BOOST_SCOPED_ENUM_NATIVE(mapped_file_flags) flags = mapped_file_flags::none) { open_impl(p, static_cast< unsigned int >(flags)); }
+    void open(path const& p, system::error_code& ec) BOOST_NOEXCEPT { open_impl(p, 0u, &ec); }
+    void open(path const& p, BOOST_SCOPED_ENUM_NATIVE(mapped_file_flags) flags, system::error_code& ec) BOOST_NOEXCEPT { open_impl(p, static_cast< unsigned int >(flags), &ec); }
+
+    //! Unmaps the file
+    BOOST_FILESYSTEM_DECL void close() BOOST_NOEXCEPT;
+
+    //! Returns \c true if a file is mapped
+    bool is_open() const BOOST_NOEXCEPT { return m_is_open; }
+
+    //! Returns a pointer to the file contents. Returns a null pointer if the mapping is empty.
+    const char* data() const BOOST_NOEXCEPT { return m_data; }
+    //! Returns the size of the mapped file contents
+    std::size_t size() const BOOST_NOEXCEPT { return m_size; }
+    //! Returns \c true if the mapping is empty
+    bool empty() const BOOST_NOEXCEPT { return m_size == 0u; }
+
+    const_iterator begin() const BOOST_NOEXCEPT { return m_data; }
+    const_iterator end() const BOOST_NOEXCEPT { return m_data + m_size; }
+
+    //! Advises the system about the expected access pattern of the mapping. Only \c sequential, \c random, \c will_need and \c huge_pages are used, other flags are ignored.
+    /*!
+     * The advice is a hint, failures to apply it are not reported.
+     */
+    void advise(BOOST_SCOPED_ENUM_NATIVE(mapped_file_flags) flags) const BOOST_NOEXCEPT { advise_impl(static_cast< unsigned int >(flags)); }
+
+    friend void swap(mapped_file& left, mapped_file& right) BOOST_NOEXCEPT
+    {
+        const char* data = left.m_data;
+        left.m_data = right.m_data;
+        right.m_data = data;
+        std::size_t size = left.m_size;
+        left.m_size = right.m_size;
+        right.m_size = size;
+        bool is_open = left.m_is_open;
+        left.m_is_open = right.m_is_open;
+        right.m_is_open = is_open;
+    }
+
+private:
+    BOOST_FILESYSTEM_DECL void open_impl(path const& p, unsigned int flags, system::error_code* ec = NULL);
+    BOOST_FILESYSTEM_DECL void advise_impl(unsigned int flags) const BOOST_NOEXCEPT;
+
+private:
+    const char* m_data;
+    std::size_t m_size;
+    bool m_is_open;
+};
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_MAPPED_FILE_HPP
@@ -0,0 +1,119 @@
+//  boost/filesystem/memory_allocator.hpp  ----------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_MEMORY_ALLOCATOR_HPP
+#define BOOST_FILESYSTEM_MEMORY_ALLOCATOR_HPP
+
+#include <boost/filesystem/config.hpp>
+
+#include <cstddef>
+#include <new>
+#include <limits>
+#include <boost/throw_exception.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+//! Allocator of the memory used internally by the library
+struct memory_allocator
+{
+    //! Allocates \a size bytes aligned to \a alignment bytes. Returns \c NULL if allocation fails. Must not throw.
+    void* (*allocate)(std::size_t size, std::size_t alignment);
+    //! Deallocates memory previously allocated by \c allocate with the same size and alignment. Must not throw.
+    void (*deallocate)(void* p, std::size_t size, std::size_t alignment);
+};
+
+/*!
+ * Sets the allocator of the memory used internally by the library: the implementations of directory iterators,
+ * the stacks of recursive directory iterators, the buffers used for copying file data with the default
+ * \c copy_buffer_allocator, the paths attached to \c filesystem_error and the blocks of \c path_arena.
+ * If \a allocator is \c NULL, the default allocator, which uses \c std::malloc, is restored.
+ *
+ * The memory is deallocated with the allocator it was allocated with, which must remain valid until all memory allocated
+ * with it is deallocated. The memory may be deallocated in a different thread than the one that allocated it. The library
+ * caches some of the memory in the threads that allocated it and deallocates the cached memory when the thread terminates
+ * or when that thread notices that the allocator has changed.
+ */
+BOOST_FILESYSTEM_DECL void set_memory_allocator(memory_allocator const* allocator) BOOST_NOEXCEPT;
+
+//! Returns the current allocator of the memory used internally by the library
+BOOST_FILESYSTEM_DECL memory_allocator const* get_memory_allocator() BOOST_NOEXCEPT;
+
+namespace detail {
+
+//! Allocates memory with the current memory allocator. Throws \c std::bad_alloc if allocation fails.
+BOOST_FILESYSTEM_DECL void* allocate_memory(std::size_t size, std::size_t alignment);
+//! Allocates memory with the current memory allocator. Returns \c NULL if allocation fails.
+BOOST_FILESYSTEM_DECL void* allocate_memory(std::size_t size, std::size_t alignment, std::nothrow_t const&) BOOST_NOEXCEPT;
+//! Deallocates memory allocated by \c allocate_memory with the same size and alignment
+BOOST_FILESYSTEM_DECL void deallocate_memory(void* p, std::size_t size, std::size_t alignment) BOOST_NOEXCEPT;
+
+//! Standard library allocator that allocates memory with the current memory allocator
+template< typename T >
+class library_allocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef T const* const_pointer;
+    typedef T& reference;
+    typedef T const& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template< typename U >
+    struct rebind
+    {
+        typedef library_allocator< U > other;
+    };
+
+public:
+    library_allocator() BOOST_NOEXCEPT {}
+    template< typename U >
+    library_allocator(library_allocator< U > const&) BOOST_NOEXCEPT {}
+
+    pointer allocate(size_type n, const void* = NULL)
+    {
+        if (BOOST_UNLIKELY(n > max_size()))
+            boost::throw_exception(std::bad_alloc());
+        return static_cast< pointer >(detail::allocate_memory(n * sizeof(T), boost::alignment_of< T >::value));
+    }
+
+    void deallocate(pointer p, size_type n) BOOST_NOEXCEPT
+    {
+        detail::deallocate_memory(p, n * sizeof(T), boost::alignment_of< T >::value);
+    }
+
+    size_type max_size() const BOOST_NOEXCEPT { return (std::numeric_limits< size_type >::max)() / sizeof(T); }
+
+#if defined(BOOST_NO_CXX11_ALLOCATOR)
+    pointer address(reference r) const BOOST_NOEXCEPT { return &r; }
+    const_pointer address(const_reference r) const BOOST_NOEXCEPT { return &r; }
+
+    void construct(pointer p, const_reference value) { new (static_cast< void* >(p)) T(value); }
+    void destroy(pointer p) BOOST_NOEXCEPT { p->~T(); }
+#endif
+
+    friend bool operator==(library_allocator const&, library_allocator const&) BOOST_NOEXCEPT { return true; }
+    friend bool operator!=(library_allocator const&, library_allocator const&) BOOST_NOEXCEPT { return false; }
+};
+
+} // namespace detail
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_MEMORY_ALLOCATOR_HPP
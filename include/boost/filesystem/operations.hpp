@@ -49,6 +49,143 @@ struct space_info
     boost::uintmax_t available; // <= free
 };
 
+//! Selects the file attributes to obtain with \c query
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(file_attribute_mask, unsigned int)
+{
+    none = 0u,
+    type = 1u,                   // File type
+    permissions = 1u << 1,       // File permissions
+    size = 1u << 2,              // File size
+    last_write_time = 1u << 3,   // Last modification time
+    last_access_time = 1u << 4,  // Last access time
+    creation_time = 1u << 5,     // Creation time
+    hard_link_count = 1u << 6,   // Number of hard links
+    inode = 1u << 7,             // Inode number on POSIX systems, file index on Windows
+    device = 1u << 8,            // Device id on POSIX systems, volume serial number on Windows
+    owner = 1u << 9,             // Owner user and group ids, POSIX systems only
+    allocated_size = 1u << 10,   // Disk space allocated for the file
+    all = (1u << 11) - 1u,
+
+    // query modifiers:
+    no_follow = 1u << 16,        // Query the symlink itself instead of the file it refers to
+    force_sync = 1u << 17,       // Revalidate the attributes with the server on network filesystems, see status_consistency
+    dont_sync = 1u << 18         // Use the locally cached attributes on network filesystems, see status_consistency
+}
+BOOST_SCOPED_ENUM_DECLARE_END(file_attribute_mask)
+
+BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(file_attribute_mask))
+
+//! File time with nanosecond resolution. The actual resolution depends on the system and the filesystem.
+struct file_time
+{
+    //! Seconds since the Unix epoch
+    std::time_t seconds;
+    //! Nanoseconds within the second, [0, 999999999]
+    boost::uint32_t nanoseconds;
+
+    BOOST_CONSTEXPR file_time() BOOST_NOEXCEPT : seconds(0), nanoseconds(0u) {}
+    BOOST_CONSTEXPR file_time(std::time_t sec, boost::uint32_t nsec = 0u) BOOST_NOEXCEPT : seconds(sec), nanoseconds(nsec) {}
+
+    friend BOOST_CONSTEXPR bool operator==(file_time const& left, file_time const& right) BOOST_NOEXCEPT
+    {
+        return left.seconds == right.seconds && left.nanoseconds == right.nanoseconds;
+    }
+    friend BOOST_CONSTEXPR bool operator!=(file_time const& left, file_time const& right) BOOST_NOEXCEPT
+    {
+        return !(left == right);
+    }
+    friend BOOST_CONSTEXPR bool operator<(file_time const& left, file_time const& right) BOOST_NOEXCEPT
+    {
+        return left.seconds < right.seconds || (left.seconds == right.seconds && left.nanoseconds < right.nanoseconds);
+    }
+    friend BOOST_CONSTEXPR bool operator>(file_time const& left, file_time const& right) BOOST_NOEXCEPT
+    {
+        return right < left;
+    }
+    friend BOOST_CONSTEXPR bool operator<=(file_time const& left, file_time const& right) BOOST_NOEXCEPT
+    {
+        return !(right < left);
+    }
+    friend BOOST_CONSTEXPR bool operator>=(file_time const& left, file_time const& right) BOOST_NOEXCEPT
+    {
+        return !(left < right);
+    }
+};
+
+//! File attributes obtained by \c query
+struct file_attributes
+{
+    //! Attributes that were obtained. May not include some of the requested attributes, if they are not supported by the system or the filesystem.
+    BOOST_SCOPED_ENUM_NATIVE(file_attribute_mask) mask;
+    //! File type and permissions
+    file_status status;
+    boost::uintmax_t size;
+    std::time_t last_write_time;
+    std::time_t last_access_time;
+    std::time_t creation_time;
+    //! Nanosecond parts of the file times, zero if not supported by the system or the filesystem
+    boost::uint32_t last_write_time_nsec;
+    boost::uint32_t last_access_time_nsec;
+    boost::uint32_t creation_time_nsec;
+    boost::uintmax_t hard_link_count;
+    boost::uintmax_t inode;
+    boost::uintmax_t device;
+    boost::uintmax_t owner_id;
+    boost::uintmax_t group_id;
+    //! Disk space allocated for the file, in bytes. May be less than \c size for sparse or compressed files.
+    boost::uintmax_t allocated_size;
+
+    file_attributes() BOOST_NOEXCEPT :
+        mask(file_attribute_mask::none),
+        size(0u),
+        last_write_time(0),
+        last_access_time(0),
+        creation_time(0),
+        last_write_time_nsec(0u),
+        last_access_time_nsec(0u),
+        creation_time_nsec(0u),
+        hard_link_count(0u),
+        inode(0u),
+        device(0u),
+        owner_id(0u),
+        group_id(0u),
+        allocated_size(0u)
+    {
+    }
+
+    //! Returns the last write time with nanosecond precision
+    file_time precise_last_write_time() const BOOST_NOEXCEPT { return file_time(last_write_time, last_write_time_nsec); }
+    //! Returns the last access time with nanosecond precision
+    file_time precise_last_access_time() const BOOST_NOEXCEPT { return file_time(last_access_time, last_access_time_nsec); }
+    //! Returns the creation time with nanosecond precision
+    file_time precise_creation_time() const BOOST_NOEXCEPT { return file_time(creation_time, creation_time_nsec); }
+};
+
+//! File attributes to apply with \c set_attributes
+struct file_attribute_set
+{
+    //! Attributes to apply. Only \c permissions, \c last_write_time, \c last_access_time and \c owner are supported, other bits are ignored.
+    BOOST_SCOPED_ENUM_NATIVE(file_attribute_mask) mask;
+    //! File permissions to set, \c add_perms and \c remove_perms are not supported
+    perms permissions;
+    file_time last_write_time;
+    file_time last_access_time;
+    //! Owner user id, or \c unchanged_id to keep the current owner
+    boost::uintmax_t owner_id;
+    //! Owner group id, or \c unchanged_id to keep the current group
+    boost::uintmax_t group_id;
+
+    BOOST_STATIC_CONSTEXPR boost::uintmax_t unchanged_id = ~static_cast< boost::uintmax_t >(0u);
+
+    file_attribute_set() BOOST_NOEXCEPT :
+        mask(file_attribute_mask::none),
+        permissions(no_perms),
+        owner_id(unchanged_id),
+        group_id(unchanged_id)
+    {
+    }
+};
+
 BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(copy_options, unsigned int)
 {
     none = 0u, // Default. For copy_file: error if the target file exists. For copy: do not recurse, follow symlinks, copy file contents.
@@ -59,6 +196,9 @@ BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(copy_options, unsigned int)
     update_existing = 1u << 2,    // Overwrite existing file if its last write time is older than the replacement file
     synchronize_data = 1u << 3,   // Flush all buffered data written to the target file to permanent storage
     synchronize = 1u << 4,        // Flush all buffered data and attributes written to the target file to permanent storage
+    clone_if_possible = 1u << 5,  // Create a copy-on-write clone of the source file, if supported by the filesystem, otherwise copy the data
+    clone_required = 1u << 6,     // Create a copy-on-write clone of the source file, fail if not supported by the filesystem
+    preserve_sparse = 1u << 7,    // Don't allocate space for holes of a sparse source file in the target file
 
     // copy options:
     recursive = 1u << 8,          // Recurse into sub-directories
@@ -67,12 +207,118 @@ BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(copy_options, unsigned int)
     directories_only = 1u << 11,  // Only copy directory structure, do not copy non-directory files
     create_symlinks = 1u << 12,   // Create symlinks instead of copying files
     create_hard_links = 1u << 13, // Create hard links instead of copying files
-    _detail_recursing = 1u << 14  // Internal use only, do not use
+    _detail_recursing = 1u << 14, // Internal use only, do not use
+
+    // copy_file options (continued):
+    parallel_data = 1u << 15,     // Copy data of large files in multiple threads, if supported
+    preallocate = 1u << 16,       // Reserve storage for the target file before copying data
+    drop_cache = 1u << 17,        // Avoid keeping the copied data in the system file cache
+    unbuffered = 1u << 18,        // Copy data bypassing the system file cache (direct I/O), if supported
+    plain_data_copy = 1u << 19,   // Copy data with a loop of read and write calls, without system-specific accelerations such as copy_file_range
+    compress_network_traffic = 1u << 20, // Request compression of the data transferred over the network, if supported (SMB 3.1.1 on Windows)
+    delta = 1u << 21,             // When overwriting an existing file, update it in place, writing only the blocks that differ from the source file
+    preserve_times = 1u << 22,    // Set the last access and modification times of the target file to those of the source file
+    preserve_owner = 1u << 23,    // Set the owner and group of the target file to those of the source file
+    preserve_xattrs = 1u << 24    // Copy extended attributes, including access control lists where they are stored as such, of the source file
 }
 BOOST_SCOPED_ENUM_DECLARE_END(copy_options)
 
 BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(copy_options))
 
+//! Options of writing file contents with \c write_file
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(write_file_options, unsigned int)
+{
+    none = 0u,                  // Default. Create the file or truncate the existing file, then write the data.
+    append = 1u,                // Append the data to the end of the file, if it exists
+    synchronize_data = 1u << 1, // Flush the written data to permanent storage
+    synchronize = 1u << 2,      // Flush the written data and attributes to permanent storage
+    atomic_replace = 1u << 3    // Write the data to a temporary file and rename it over the target file. Incompatible with append.
+}
+BOOST_SCOPED_ENUM_DECLARE_END(write_file_options)
+
+BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(write_file_options))
+
+//! Options of moving files with \c move
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(move_options, unsigned int)
+{
+    none = 0u,
+    no_replace = 1u,    // Fail if the target exists instead of replacing it (RENAME_NOREPLACE on Linux, RENAME_EXCL on macOS)
+    exchange = 1u << 1, // Atomically exchange the source and the target, which must both exist (RENAME_EXCHANGE on Linux, RENAME_SWAP on macOS). Never copies.
+    no_copy = 1u << 2   // Fail if the source and the target are on different filesystems instead of copying the source
+}
+BOOST_SCOPED_ENUM_DECLARE_END(move_options)
+
+BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(move_options))
+
+//! Options of allocating storage with \c preallocate
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(preallocate_options, unsigned int)
+{
+    none = 0u,
+    keep_size = 1u // Do not change the file size if the range extends beyond the end of the file (FALLOC_FL_KEEP_SIZE on Linux)
+}
+BOOST_SCOPED_ENUM_DECLARE_END(preallocate_options)
+
+BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(preallocate_options))
+
+//! Options of warming up the page cache with \c prefetch
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(prefetch_options, unsigned int)
+{
+    none = 0u,
+    recursive = 1u,                    // Prefetch the files in the given directories and their subdirectories
+    follow_directory_symlink = 1u << 1 // Follow symlinks to directories when prefetching recursively
+}
+BOOST_SCOPED_ENUM_DECLARE_END(prefetch_options)
+
+BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(prefetch_options))
+
+//! Description of a file to be replaced with \c atomic_commit
+struct atomic_write_entry
+{
+    path target;      //!< The file to replace
+    const void* data; //!< Pointer to the new contents of the file. Must remain valid until \c atomic_commit returns.
+    std::size_t size; //!< Size of the new contents, in bytes
+
+    atomic_write_entry() BOOST_NOEXCEPT : data(NULL), size(0u) {}
+    atomic_write_entry(path const& p, const void* d, std::size_t sz) : target(p), data(d), size(sz) {}
+    //! Refers to the contents of \a contents. The string must not be modified or destroyed until \c atomic_commit returns.
+    atomic_write_entry(path const& p, std::string const& contents) : target(p), data(contents.data()), size(contents.size()) {}
+};
+
+//! Description of a file to be copied with \c copy_files
+struct copy_file_entry
+{
+    path from; //!< The source file
+    path to;   //!< The target file
+
+    copy_file_entry() {}
+    copy_file_entry(path const& f, path const& t) : from(f), to(t) {}
+};
+
+//! Native file descriptor or handle used with \c copy_data
+#if defined(BOOST_WINDOWS_API)
+typedef void* native_file_handle;
+#else
+typedef int native_file_handle;
+#endif
+
+//! Range of data to copy with \c copy_data
+struct copy_data_range
+{
+    //! Offset value that indicates that the data is read from the current position of the source
+    BOOST_STATIC_CONSTEXPR boost::uintmax_t current_position = ~static_cast< boost::uintmax_t >(0u);
+    //! Size value that indicates that the data is copied until the end of the source
+    BOOST_STATIC_CONSTEXPR boost::uintmax_t until_end = ~static_cast< boost::uintmax_t >(0u);
+
+    //! Offset in the source file to read the data from, or \c current_position
+    boost::uintmax_t offset;
+    //! Maximum amount of data to copy, in bytes, or \c until_end
+    boost::uintmax_t size;
+
+    copy_data_range() BOOST_NOEXCEPT : offset(current_position), size(until_end) {}
+    explicit copy_data_range(boost::uintmax_t sz) BOOST_NOEXCEPT : offset(current_position), size(sz) {}
+    copy_data_range(boost::uintmax_t off, boost::uintmax_t sz) BOOST_NOEXCEPT : offset(off), size(sz) {}
+};
+
 #if !defined(BOOST_FILESYSTEM_NO_DEPRECATED)
 BOOST_SCOPED_ENUM_DECLARE_BEGIN(copy_option)
 {
@@ -83,6 +329,110 @@ BOOST_SCOPED_ENUM_DECLARE_BEGIN(copy_option)
 BOOST_SCOPED_ENUM_DECLARE_END(copy_option)
 #endif
 
+//! Allocator of the buffers used for copying file data
+struct copy_buffer_allocator
+{
+    //! Allocates a buffer of \a size bytes aligned to \a alignment bytes. Returns \c NULL if allocation fails. Must not throw.
+    void* (*allocate)(std::size_t size, std::size_t alignment);
+    //! Deallocates a buffer previously allocated by \c allocate. Must not throw.
+    void (*deallocate)(void* buf, std::size_t size, std::size_t alignment);
+};
+
+/*!
+ * Sets the allocator of the buffers used for copying file data. If \a allocator is \c NULL, the default allocator is restored.
+ * The allocator object must remain valid until all buffers allocated with it are deallocated. Buffers are reused by the
+ * thread that allocated them and are deallocated when the thread terminates or when that thread notices that the allocator has changed.
+ */
+BOOST_FILESYSTEM_DECL void set_copy_buffer_allocator(copy_buffer_allocator const* allocator) BOOST_NOEXCEPT;
+
+//! Parameters of gradual removal of large files
+struct gradual_remove_params
+{
+    //! Regular files of at least this size, in bytes, are truncated in steps when they are removed. Zero disables gradual removal.
+    boost::uintmax_t min_file_size;
+    //! Amount of file data released by every truncation step, in bytes
+    boost::uintmax_t step_size;
+    //! Pause between the truncation steps, in microseconds
+    unsigned int step_interval;
+    //! If \c true, the files are truncated one by one by a task posted to the executor returned by \c get_executor
+    bool background;
+
+    gradual_remove_params() BOOST_NOEXCEPT : min_file_size(0u), step_size(1073741824u), step_interval(10000u), background(false) {}
+};
+
+/*!
+ * Sets the parameters of gradual removal of large files by \c remove, \c remove_all and \c parallel_remove_all.
+ * A regular file that is smaller than \c min_file_size or has other hard links is removed as usual. Other regular files
+ * are unlinked, and then the unlinked file is truncated from the end in steps of \c step_size bytes with a pause between
+ * the steps, which spreads the work of releasing the file's storage over time.
+ *
+ * The file is only truncated if it is not open through any other descriptors or memory mappings, as otherwise truncation
+ * would destroy the data seen by their users. Such files, as well as files for which this cannot be verified, are only
+ * unlinked. Truncation is only supported on Linux, where the check requires a write lease on the file, which is only
+ * granted to the file owner or a process with \c CAP_LEASE capability.
+ *
+ * In the background mode, the files are queued and truncated one after another by a single task. Every queued file keeps
+ * a descriptor open, which is drawn from the descriptor budget. When the queue is full or the budget is exhausted,
+ * the file is truncated by the removing thread instead.
+ */
+BOOST_FILESYSTEM_DECL void set_gradual_remove_params(gradual_remove_params const& params) BOOST_NOEXCEPT;
+
+//! Returns the parameters of gradual removal of large files
+BOOST_FILESYSTEM_DECL gradual_remove_params get_gradual_remove_params() BOOST_NOEXCEPT;
+
+/*!
+ * Function that is called to report progress of copying the file \a from to \a to. \a bytes_copied is the amount of data copied so far
+ * and \a total_bytes is the size of the source file. \a context is the pointer that was passed to the copy operation.
+ * Returns \c false to cancel the copy operation.
+ */
+typedef bool copy_progress_callback(path const& from, path const& to, boost::uintmax_t bytes_copied, boost::uintmax_t total_bytes, void* context);
+
+//! Hash function used by \c copy_file to compute a hash of the copied data and to verify the target file
+struct copy_file_hasher
+{
+    //! Feeds \a size bytes of \a data to the hash state \a state. Must not throw.
+    void (*update)(void* state, const void* data, std::size_t size);
+    //! Returns \c true if the hashes accumulated in \a state1 and \a state2 are equal. Only called to verify the target file. Must not throw.
+    bool (*equal)(void* state1, void* state2);
+};
+
+namespace detail {
+struct sync_group_access;
+} // namespace detail
+
+/*!
+ * A group of files that are synchronized with the permanent storage at once. When many files need to be made durable,
+ * committing them as a group may be significantly faster than synchronizing every file individually.
+ */
+class sync_group
+{
+    friend struct detail::sync_group_access;
+
+private:
+    struct impl;
+    impl* m_impl;
+
+public:
+    sync_group() BOOST_NOEXCEPT : m_impl(NULL) {}
+    //! Destroys the group. Files that were added to the group but not committed are not synchronized.
+    BOOST_FILESYSTEM_DECL ~sync_group();
+
+    BOOST_DELETED_FUNCTION(sync_group(sync_group const&))
+    BOOST_DELETED_FUNCTION(sync_group& operator=(sync_group const&))
+
+    //! Adds a file to the group. Contents and attributes of the file will be synchronized with the permanent storage on commit.
+    void add(path const& p) { add_impl(p); }
+    void add(path const& p, system::error_code& ec) BOOST_NOEXCEPT { add_impl(p, &ec); }
+
+    //! Synchronizes all files added to the group with the permanent storage and clears the group
+    void commit() { commit_impl(); }
+    void commit(system::error_code& ec) BOOST_NOEXCEPT { commit_impl(&ec); }
+
+private:
+    BOOST_FILESYSTEM_DECL void add_impl(path const& p, system::error_code* ec = NULL);
+    BOOST_FILESYSTEM_DECL void commit_impl(system::error_code* ec = NULL);
+};
+
 //--------------------------------------------------------------------------------------//
 //                             implementation details                                   //
 //--------------------------------------------------------------------------------------//
@@ -96,6 +446,14 @@ file_status status(path const& p, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
 file_status symlink_status(path const& p, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
+file_status status(path const& p, unsigned int consistency, system::error_code* ec);
+BOOST_FILESYSTEM_DECL
+file_status symlink_status(path const& p, unsigned int consistency, system::error_code* ec);
+BOOST_FILESYSTEM_DECL
+void status_batch(path const* paths, std::size_t count, file_status* results, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
+void status_batch(path const* paths, std::size_t count, file_status* results, unsigned int consistency, system::error_code* ec);
+BOOST_FILESYSTEM_DECL
 bool is_empty(path const& p, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
 path initial_path(system::error_code* ec = NULL);
@@ -103,6 +461,8 @@ BOOST_FILESYSTEM_DECL
 path canonical(path const& p, path const& base, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
 void copy(path const& from, path const& to, unsigned int options, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
+void copy(path const& from, path const& to, unsigned int options, copy_progress_callback* progress, void* progress_context, system::error_code* ec = NULL);
 #if !defined(BOOST_FILESYSTEM_NO_DEPRECATED)
 BOOST_FILESYSTEM_DECL
 void copy_directory(path const& from, path const& to, system::error_code* ec = NULL);
@@ -110,11 +470,25 @@ void copy_directory(path const& from, path const& to, system::error_code* ec = N
 BOOST_FILESYSTEM_DECL
 bool copy_file(path const& from, path const& to,                     // See ticket #2925
                unsigned int options, system::error_code* ec = NULL); // see copy_options for options
+BOOST_FILESYSTEM_DECL
+bool copy_file(path const& from, path const& to, unsigned int options, sync_group* group,
+               copy_progress_callback* progress, void* progress_context, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
+bool copy_file(path const& from, path const& to, unsigned int options, copy_file_hasher const& hasher,
+               void* source_state, void* target_state, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
+std::size_t copy_files(copy_file_entry const* entries, std::size_t count, unsigned int options, system::error_code* ec = NULL);
+
+BOOST_FILESYSTEM_DECL
+boost::uintmax_t copy_data(native_file_handle from, native_file_handle to, copy_data_range const& range, system::error_code* ec = NULL);
+
 BOOST_FILESYSTEM_DECL
 void copy_symlink(path const& existing_symlink, path const& new_symlink, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
 bool create_directories(path const& p, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
+std::size_t create_directories_batch(path const* paths, std::size_t count, unsigned int thread_count, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
 bool create_directory(path const& p, const path* existing, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
 void create_directory_symlink(path const& to, path const& from, system::error_code* ec = NULL);
@@ -129,20 +503,50 @@ void current_path(path const& p, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
 bool equivalent(path const& p1, path const& p2, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
+bool equivalent(directory_entry const& e1, directory_entry const& e2, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
+bool files_equal(path const& p1, path const& p2, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
+file_identity identity(path const& p, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
 boost::uintmax_t file_size(path const& p, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
 boost::uintmax_t hard_link_count(path const& p, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
 std::time_t creation_time(path const& p, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
+file_time precise_creation_time(path const& p, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
+file_attributes query(path const& p, unsigned int mask, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
+void query_batch(path const* paths, std::size_t count, unsigned int mask, file_attributes* results);
+BOOST_FILESYSTEM_DECL
 std::time_t last_write_time(path const& p, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
+file_time precise_last_write_time(path const& p, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
 void last_write_time(path const& p, const std::time_t new_time, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
+void last_write_time(path const& p, file_time const& new_time, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
 void permissions(path const& p, perms prms, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
+void set_attributes(path const& p, file_attribute_set const& attrs, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
+void set_attributes_batch(path const* paths, file_attribute_set const* attrs, std::size_t count, system::error_code* results);
+BOOST_FILESYSTEM_DECL
+void read_file(path const& p, std::string& contents, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
+void write_file(path const& p, const void* data, std::size_t size, unsigned int options, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
+void atomic_write_file(path const& p, const void* data, std::size_t size, unsigned int options, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
+void atomic_commit(atomic_write_entry const* entries, std::size_t count, unsigned int options, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
 path read_symlink(path const& p, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
+void read_symlink_batch(path const* paths, std::size_t count, path* targets, system::error_code* results);
+BOOST_FILESYSTEM_DECL
 path relative(path const& p, path const& base, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
 bool remove(path const& p, system::error_code* ec = NULL);
@@ -151,8 +555,20 @@ boost::uintmax_t remove_all(path const& p, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
 void rename(path const& old_p, path const& new_p, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
+void move(path const& from, path const& to, unsigned int options, unsigned int thread_count, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
+void exchange(path const& a, path const& b, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
 void resize_file(path const& p, uintmax_t size, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
+void preallocate(path const& p, uintmax_t offset, uintmax_t length, unsigned int options, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
+void punch_hole(path const& p, uintmax_t offset, uintmax_t length, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
+void zero_range(path const& p, uintmax_t offset, uintmax_t length, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
+uintmax_t prefetch(path const* paths, std::size_t count, unsigned int options, uintmax_t max_bytes, unsigned int thread_count, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
 space_info space(path const& p, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
 path system_complete(path const& p, system::error_code* ec = NULL);
@@ -161,6 +577,8 @@ path temp_directory_path(system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
 path unique_path(path const& p, system::error_code* ec = NULL);
 BOOST_FILESYSTEM_DECL
+path create_unique_directory(path const& model, system::error_code* ec = NULL);
+BOOST_FILESYSTEM_DECL
 path weakly_canonical(path const& p, path const& base, system::error_code* ec = NULL);
 
 } // namespace detail
@@ -191,6 +609,50 @@ inline file_status symlink_status(path const& p, system::error_code& ec)
     return detail::symlink_status(p, &ec);
 }
 
+//! Queries the file status with the given consistency with the server on network filesystems
+inline file_status status(path const& p, BOOST_SCOPED_ENUM_NATIVE(status_consistency) consistency)
+{
+    return detail::status(p, static_cast< unsigned int >(consistency), NULL);
+}
+
+inline file_status status(path const& p, BOOST_SCOPED_ENUM_NATIVE(status_consistency) consistency, system::error_code& ec)
+{
+    return detail::status(p, static_cast< unsigned int >(consistency), &ec);
+}
+
+inline file_status symlink_status(path const& p, BOOST_SCOPED_ENUM_NATIVE(status_consistency) consistency)
+{
+    return detail::symlink_status(p, static_cast< unsigned int >(consistency), NULL);
+}
+
+inline file_status symlink_status(path const& p, BOOST_SCOPED_ENUM_NATIVE(status_consistency) consistency, system::error_code& ec)
+{
+    return detail::symlink_status(p, static_cast< unsigned int >(consistency), &ec);
+}
+
+//! Queries statuses of \a count paths starting at \a paths and stores them in \a results. Errors
+//! querying individual paths are reported as \c status_error in the respective elements of \a results.
+inline void statuses(path const* paths, std::size_t count, file_status* results)
+{
+    detail::status_batch(paths, count, results);
+}
+
+inline void statuses(path const* paths, std::size_t count, file_status* results, system::error_code& ec) BOOST_NOEXCEPT
+{
+    detail::status_batch(paths, count, results, &ec);
+}
+
+inline void statuses(path const* paths, std::size_t count, file_status* results, BOOST_SCOPED_ENUM_NATIVE(status_consistency) consistency)
+{
+    detail::status_batch(paths, count, results, static_cast< unsigned int >(consistency), NULL);
+}
+
+inline void statuses(path const* paths, std::size_t count, file_status* results, BOOST_SCOPED_ENUM_NATIVE(status_consistency) consistency,
+    system::error_code& ec) BOOST_NOEXCEPT
+{
+    detail::status_batch(paths, count, results, static_cast< unsigned int >(consistency), &ec);
+}
+
 inline bool exists(path const& p)
 {
     return exists(detail::status(p));
@@ -312,13 +774,46 @@ inline void current_path(path const& p, system::error_code& ec) BOOST_NOEXCEPT
     detail::current_path(p, &ec);
 }
 
-inline path absolute(path const& p, path const& base = current_path())
+/*!
+ * Discards the current path and the temporary directory path cached by the library.
+ *
+ * The library caches the current path, which is updated when it is changed with \c current_path. This function
+ * must be called after the current directory is changed by other means, such as \c chdir, for the change to be
+ * observed by \c current_path and the operations that use it. On Windows, the directory selected by \c temp_directory_path
+ * is cached until the environment variables it is obtained from are changed, or until this function is called. The cached
+ * directory is still checked to exist on every call.
+ */
+BOOST_FILESYSTEM_DECL void refresh_cached_paths() BOOST_NOEXCEPT;
+
+inline path absolute(path const& p)
+{
+    if (p.is_absolute())
+        return p;
+    return detail::absolute(p, current_path());
+}
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+inline path absolute(path&& p)
+{
+    if (p.is_absolute())
+        return static_cast< path&& >(p);
+    return detail::absolute(p, current_path());
+}
+#endif
+
+inline path absolute(path const& p, path const& base)
 {
     return detail::absolute(p, base);
 }
 
 inline path absolute(path const& p, system::error_code& ec)
 {
+    if (p.is_absolute())
+    {
+        ec.clear();
+        return p;
+    }
+
     path base = current_path(ec);
     if (ec)
         return path();
@@ -382,6 +877,16 @@ inline void copy(path const& from, path const& to, BOOST_SCOPED_ENUM_NATIVE(copy
     detail::copy(from, to, static_cast< unsigned int >(options), &ec);
 }
 
+inline void copy(path const& from, path const& to, BOOST_SCOPED_ENUM_NATIVE(copy_options) options, copy_progress_callback* progress, void* progress_context)
+{
+    detail::copy(from, to, static_cast< unsigned int >(options), progress, progress_context);
+}
+
+inline void copy(path const& from, path const& to, BOOST_SCOPED_ENUM_NATIVE(copy_options) options, copy_progress_callback* progress, void* progress_context, system::error_code& ec) BOOST_NOEXCEPT
+{
+    detail::copy(from, to, static_cast< unsigned int >(options), progress, progress_context, &ec);
+}
+
 #if !defined(BOOST_FILESYSTEM_NO_DEPRECATED)
 BOOST_FILESYSTEM_DETAIL_DEPRECATED("Use create_directory() instead")
 inline void copy_directory(path const& from, path const& to)
@@ -418,6 +923,96 @@ inline bool copy_file(path const& from, path const& to, // See ticket #2925
     return detail::copy_file(from, to, static_cast< unsigned int >(options), &ec);
 }
 
+inline bool copy_file(path const& from, path const& to, BOOST_SCOPED_ENUM_NATIVE(copy_options) options, sync_group& group)
+{
+    return detail::copy_file(from, to, static_cast< unsigned int >(options), &group, NULL, NULL);
+}
+
+inline bool copy_file(path const& from, path const& to, BOOST_SCOPED_ENUM_NATIVE(copy_options) options, sync_group& group, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::copy_file(from, to, static_cast< unsigned int >(options), &group, NULL, NULL, &ec);
+}
+
+inline bool copy_file(path const& from, path const& to, BOOST_SCOPED_ENUM_NATIVE(copy_options) options, copy_progress_callback* progress, void* progress_context)
+{
+    return detail::copy_file(from, to, static_cast< unsigned int >(options), NULL, progress, progress_context);
+}
+
+inline bool copy_file(path const& from, path const& to, BOOST_SCOPED_ENUM_NATIVE(copy_options) options, copy_progress_callback* progress, void* progress_context, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::copy_file(from, to, static_cast< unsigned int >(options), NULL, progress, progress_context, &ec);
+}
+
+//! Copies the file \a from to \a to and feeds the copied data to \a hasher with \a source_state
+/*!
+ * The data is hashed as it is copied through the user-space buffer, so the hash is computed without reading
+ * the source file again. This means that cloning and copying the data within the kernel are not used, and
+ * \c copy_options::preserve_sparse, \c copy_options::parallel_data and \c copy_options::unbuffered have no effect.
+ * \c copy_options::clone_required cannot be used with hashing.
+ *
+ * If \a target_state is not \c NULL, the target file is read back after the data is copied and synchronized, if requested. Its
+ * contents are fed to \a hasher with \a target_state and the two hashes are compared. If they differ, the operation fails
+ * with \c errc::io_error. If the target file was synchronized, its cached data is discarded before reading, where supported,
+ * so that the data is read back from the storage.
+ *
+ * Hashing is not supported on Windows, where the operation fails with \c errc::operation_not_supported.
+ */
+inline bool copy_file(path const& from, path const& to, BOOST_SCOPED_ENUM_NATIVE(copy_options) options, copy_file_hasher const& hasher, void* source_state, void* target_state = NULL)
+{
+    return detail::copy_file(from, to, static_cast< unsigned int >(options), hasher, source_state, target_state);
+}
+
+inline bool copy_file(path const& from, path const& to, BOOST_SCOPED_ENUM_NATIVE(copy_options) options, copy_file_hasher const& hasher, void* source_state, void* target_state, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::copy_file(from, to, static_cast< unsigned int >(options), hasher, source_state, target_state, &ec);
+}
+
+//! Copies multiple files, as if by calling \c copy_file for each entry. Returns the number of files that were copied.
+/*!
+ * The files are copied in order, stopping at the first error. With \c copy_options::skip_existing, the targets
+ * that already exist are detected in bulk before copying, and such entries are skipped without accessing the source files. With \c copy_options::synchronize or
+ * \c copy_options::synchronize_data, the copied files are synchronized with the permanent storage at once after
+ * all of them are copied, or after the copying stops because of an error.
+ */
+inline std::size_t copy_files(copy_file_entry const* entries, std::size_t count, BOOST_SCOPED_ENUM_NATIVE(copy_options) options = copy_options::none)
+{
+    return detail::copy_files(entries, count, static_cast< unsigned int >(options));
+}
+
+inline std::size_t copy_files(copy_file_entry const* entries, std::size_t count, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::copy_files(entries, count, static_cast< unsigned int >(copy_options::none), &ec);
+}
+
+inline std::size_t copy_files(copy_file_entry const* entries, std::size_t count, BOOST_SCOPED_ENUM_NATIVE(copy_options) options, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::copy_files(entries, count, static_cast< unsigned int >(options), &ec);
+}
+
+//! Copies data between open files, pipes or sockets. Returns the number of bytes copied.
+/*!
+ * The data is read from the current position of \a from, or from \c range.offset if it is not \c copy_data_range::current_position,
+ * and written at the current position of \a to, until \c range.size bytes are copied or the end of \a from is reached.
+ * The same implementations as in \c copy_file are used where the types of the handles allow: on Linux, \c copy_file_range
+ * between regular files, \c sendfile from regular files to sockets and other files, and \c splice from and to pipes, and
+ * on Windows, \c TransmitFile from files to sockets. Otherwise, and when the preferred implementation is not supported for
+ * the given handles, the data is copied with a loop of reads and writes. Setting the \c copy_file backend to
+ * \c copy_file_backend::read_write also affects \c copy_data.
+ *
+ * The handles must be open in blocking mode. If the operation fails, the data may have been partially copied, and
+ * the signature with \a ec returns the number of bytes copied before the error. If \c range.offset is specified,
+ * the current position of \a from after the operation is unspecified.
+ */
+inline boost::uintmax_t copy_data(native_file_handle from, native_file_handle to, copy_data_range const& range = copy_data_range())
+{
+    return detail::copy_data(from, to, range);
+}
+
+inline boost::uintmax_t copy_data(native_file_handle from, native_file_handle to, copy_data_range const& range, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::copy_data(from, to, range, &ec);
+}
+
 #if !defined(BOOST_FILESYSTEM_NO_DEPRECATED)
 BOOST_FILESYSTEM_DETAIL_DEPRECATED("Use copy_options instead of copy_option")
 inline bool copy_file(path const& from, path const& to, // See ticket #2925
@@ -454,6 +1049,24 @@ inline bool create_directories(path const& p, system::error_code& ec) BOOST_NOEX
     return detail::create_directories(p, &ec);
 }
 
+//! Creates the directories \a count paths starting at \a paths refer to, along with their missing parents. Parents shared
+//! between the paths are created once. Returns the number of created directories. If \a thread_count is not 1, independent
+//! subtrees may be created in parallel, 0 means to use all available hardware threads.
+inline std::size_t create_directories(path const* paths, std::size_t count, unsigned int thread_count = 1u)
+{
+    return detail::create_directories_batch(paths, count, thread_count);
+}
+
+inline std::size_t create_directories(path const* paths, std::size_t count, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::create_directories_batch(paths, count, 1u, &ec);
+}
+
+inline std::size_t create_directories(path const* paths, std::size_t count, unsigned int thread_count, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::create_directories_batch(paths, count, thread_count, &ec);
+}
+
 inline bool create_directory(path const& p)
 {
     return detail::create_directory(p, NULL);
@@ -514,6 +1127,44 @@ inline bool equivalent(path const& p1, path const& p2, system::error_code& ec) B
     return detail::equivalent(p1, p2, &ec);
 }
 
+//! Returns \c true if the directory entries refer to the same file. Uses the file identities cached in the entries, if available.
+inline bool equivalent(directory_entry const& e1, directory_entry const& e2)
+{
+    return detail::equivalent(e1, e2);
+}
+
+inline bool equivalent(directory_entry const& e1, directory_entry const& e2, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::equivalent(e1, e2, &ec);
+}
+
+//! Returns \c true if the regular files \a p1 and \a p2 have equal contents. Follows symlinks.
+/*!
+ * Files that are the same file, see \c equivalent, are equal without reading them, and files of different sizes are
+ * different. Otherwise, the contents are read and compared until the first difference. Reports an error if either
+ * of the files is not a regular file.
+ */
+inline bool files_equal(path const& p1, path const& p2)
+{
+    return detail::files_equal(p1, p2);
+}
+
+inline bool files_equal(path const& p1, path const& p2, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::files_equal(p1, p2, &ec);
+}
+
+//! Returns the identity of the file \a p. Follows symlinks.
+inline file_identity identity(path const& p)
+{
+    return detail::identity(p);
+}
+
+inline file_identity identity(path const& p, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::identity(p, &ec);
+}
+
 inline boost::uintmax_t file_size(path const& p)
 {
     return detail::file_size(p);
@@ -544,6 +1195,35 @@ inline std::time_t creation_time(path const& p, system::error_code& ec) BOOST_NO
     return detail::creation_time(p, &ec);
 }
 
+//! Returns the file creation time with the precision supported by the system and the filesystem, up to nanoseconds
+inline file_time precise_creation_time(path const& p)
+{
+    return detail::precise_creation_time(p);
+}
+
+inline file_time precise_creation_time(path const& p, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::precise_creation_time(p, &ec);
+}
+
+//! Obtains the file attributes selected by \a mask with a single query to the filesystem, if supported by the system
+inline file_attributes query(path const& p, BOOST_SCOPED_ENUM_NATIVE(file_attribute_mask) mask)
+{
+    return detail::query(p, static_cast< unsigned int >(mask));
+}
+
+inline file_attributes query(path const& p, BOOST_SCOPED_ENUM_NATIVE(file_attribute_mask) mask, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::query(p, static_cast< unsigned int >(mask), &ec);
+}
+
+//! Obtains the file attributes selected by \a mask for \a count paths starting at \a paths and stores them in \a results.
+//! Errors querying individual paths are reported as \c file_attribute_mask::none in the \c mask member of the respective elements of \a results.
+inline void query(path const* paths, std::size_t count, BOOST_SCOPED_ENUM_NATIVE(file_attribute_mask) mask, file_attributes* results) BOOST_NOEXCEPT
+{
+    detail::query_batch(paths, count, static_cast< unsigned int >(mask), results);
+}
+
 inline std::time_t last_write_time(path const& p)
 {
     return detail::last_write_time(p);
@@ -554,6 +1234,17 @@ inline std::time_t last_write_time(path const& p, system::error_code& ec) BOOST_
     return detail::last_write_time(p, &ec);
 }
 
+//! Returns the last write time with the precision supported by the system and the filesystem, up to nanoseconds
+inline file_time precise_last_write_time(path const& p)
+{
+    return detail::precise_last_write_time(p);
+}
+
+inline file_time precise_last_write_time(path const& p, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::precise_last_write_time(p, &ec);
+}
+
 inline void last_write_time(path const& p, const std::time_t new_time)
 {
     detail::last_write_time(p, new_time);
@@ -564,6 +1255,16 @@ inline void last_write_time(path const& p, const std::time_t new_time, system::e
     detail::last_write_time(p, new_time, &ec);
 }
 
+inline void last_write_time(path const& p, file_time const& new_time)
+{
+    detail::last_write_time(p, new_time);
+}
+
+inline void last_write_time(path const& p, file_time const& new_time, system::error_code& ec) BOOST_NOEXCEPT
+{
+    detail::last_write_time(p, new_time, &ec);
+}
+
 inline void permissions(path const& p, perms prms)
 {
     detail::permissions(p, prms);
@@ -574,6 +1275,133 @@ inline void permissions(path const& p, perms prms, system::error_code& ec) BOOST
     detail::permissions(p, prms, &ec);
 }
 
+//! Applies the file attributes selected by \c attrs.mask through a single file handle, if supported by the system
+inline void set_attributes(path const& p, file_attribute_set const& attrs)
+{
+    detail::set_attributes(p, attrs);
+}
+
+inline void set_attributes(path const& p, file_attribute_set const& attrs, system::error_code& ec) BOOST_NOEXCEPT
+{
+    detail::set_attributes(p, attrs, &ec);
+}
+
+//! Applies \a attrs[i] to \a paths[i] for each of the \a count paths and stores the results in \a results[i].
+//! Errors applying attributes to individual paths do not stop processing the remaining paths.
+inline void set_attributes(path const* paths, file_attribute_set const* attrs, std::size_t count, system::error_code* results) BOOST_NOEXCEPT
+{
+    detail::set_attributes_batch(paths, attrs, count, results);
+}
+
+//! Reads the contents of the file \a p into \a contents
+inline void read_file(path const& p, std::string& contents)
+{
+    detail::read_file(p, contents);
+}
+
+inline void read_file(path const& p, std::string& contents, system::error_code& ec)
+{
+    detail::read_file(p, contents, &ec);
+}
+
+//! Returns the contents of the file \a p
+inline std::string read_file(path const& p)
+{
+    std::string contents;
+    detail::read_file(p, contents);
+    return contents;
+}
+
+//! Writes \a size bytes pointed to by \a data to the file \a p
+inline void write_file(path const& p, const void* data, std::size_t size, BOOST_SCOPED_ENUM_NATIVE(write_file_options) options = write_file_options::none)
+{
+    detail::write_file(p, data, size, static_cast< unsigned int >(options));
+}
+
+inline void write_file(path const& p, const void* data, std::size_t size, system::error_code& ec)
+{
+    detail::write_file(p, data, size, static_cast< unsigned int >(write_file_options::none), &ec);
+}
+
+inline void write_file(path const& p, const void* data, std::size_t size, BOOST_SCOPED_ENUM_NATIVE(write_file_options) options, system::error_code& ec)
+{
+    detail::write_file(p, data, size, static_cast< unsigned int >(options), &ec);
+}
+
+//! Writes \a contents to the file \a p
+inline void write_file(path const& p, std::string const& contents, BOOST_SCOPED_ENUM_NATIVE(write_file_options) options = write_file_options::none)
+{
+    detail::write_file(p, contents.data(), contents.size(), static_cast< unsigned int >(options));
+}
+
+inline void write_file(path const& p, std::string const& contents, system::error_code& ec)
+{
+    detail::write_file(p, contents.data(), contents.size(), static_cast< unsigned int >(write_file_options::none), &ec);
+}
+
+inline void write_file(path const& p, std::string const& contents, BOOST_SCOPED_ENUM_NATIVE(write_file_options) options, system::error_code& ec)
+{
+    detail::write_file(p, contents.data(), contents.size(), static_cast< unsigned int >(options), &ec);
+}
+
+//! Atomically replaces the contents of the file \a p with \a size bytes pointed to by \a data
+/*!
+ * The data is written to a temporary file in the same directory as \a p, which is then renamed to \a p. By default,
+ * the file and its directory are synchronized to make the replacement durable.
+ */
+inline void atomic_write_file(path const& p, const void* data, std::size_t size, BOOST_SCOPED_ENUM_NATIVE(write_file_options) options = write_file_options::synchronize)
+{
+    detail::atomic_write_file(p, data, size, static_cast< unsigned int >(options));
+}
+
+inline void atomic_write_file(path const& p, const void* data, std::size_t size, system::error_code& ec)
+{
+    detail::atomic_write_file(p, data, size, static_cast< unsigned int >(write_file_options::synchronize), &ec);
+}
+
+inline void atomic_write_file(path const& p, const void* data, std::size_t size, BOOST_SCOPED_ENUM_NATIVE(write_file_options) options, system::error_code& ec)
+{
+    detail::atomic_write_file(p, data, size, static_cast< unsigned int >(options), &ec);
+}
+
+//! Atomically replaces the contents of the file \a p with \a contents
+inline void atomic_write_file(path const& p, std::string const& contents, BOOST_SCOPED_ENUM_NATIVE(write_file_options) options = write_file_options::synchronize)
+{
+    detail::atomic_write_file(p, contents.data(), contents.size(), static_cast< unsigned int >(options));
+}
+
+inline void atomic_write_file(path const& p, std::string const& contents, system::error_code& ec)
+{
+    detail::atomic_write_file(p, contents.data(), contents.size(), static_cast< unsigned int >(write_file_options::synchronize), &ec);
+}
+
+inline void atomic_write_file(path const& p, std::string const& contents, BOOST_SCOPED_ENUM_NATIVE(write_file_options) options, system::error_code& ec)
+{
+    detail::atomic_write_file(p, contents.data(), contents.size(), static_cast< unsigned int >(options), &ec);
+}
+
+//! Atomically replaces the contents of multiple files
+/*!
+ * The new contents of all files are written to temporary files first, then all temporary files are synchronized
+ * and renamed to their targets. With \c write_file_options::synchronize, every directory containing the target files
+ * is synchronized once after all renames. Each file is replaced atomically, but the set of files is not: if renaming one
+ * of the files fails, the files renamed before it are not restored. Temporary files that were not renamed are removed.
+ */
+inline void atomic_commit(atomic_write_entry const* entries, std::size_t count, BOOST_SCOPED_ENUM_NATIVE(write_file_options) options = write_file_options::synchronize)
+{
+    detail::atomic_commit(entries, count, static_cast< unsigned int >(options));
+}
+
+inline void atomic_commit(atomic_write_entry const* entries, std::size_t count, system::error_code& ec)
+{
+    detail::atomic_commit(entries, count, static_cast< unsigned int >(write_file_options::synchronize), &ec);
+}
+
+inline void atomic_commit(atomic_write_entry const* entries, std::size_t count, BOOST_SCOPED_ENUM_NATIVE(write_file_options) options, system::error_code& ec)
+{
+    detail::atomic_commit(entries, count, static_cast< unsigned int >(options), &ec);
+}
+
 inline path read_symlink(path const& p)
 {
     return detail::read_symlink(p);
@@ -584,6 +1412,13 @@ inline path read_symlink(path const& p, system::error_code& ec)
     return detail::read_symlink(p, &ec);
 }
 
+//! Reads the targets of \a count symlinks starting at \a paths into \a targets and stores the results in \a results.
+//! Errors reading individual symlinks do not stop processing the remaining ones, the respective targets are left empty.
+inline void read_symlinks(path const* paths, std::size_t count, path* targets, system::error_code* results) BOOST_NOEXCEPT
+{
+    detail::read_symlink_batch(paths, count, targets, results);
+}
+
 inline bool remove(path const& p)
 {
     return detail::remove(p);
@@ -614,6 +1449,46 @@ inline void rename(path const& old_p, path const& new_p, system::error_code& ec)
     detail::rename(old_p, new_p, &ec);
 }
 
+//! Moves a file or a directory tree, copying it if the target is on a different filesystem
+/*!
+ * First, \a from is renamed to \a to, with the semantics of \c rename, except that with \c move_options::no_replace
+ * the rename fails if \a to exists, and with \c move_options::exchange the two files are swapped atomically. If the
+ * rename fails because \a from and \a to are on different filesystems, \a from is copied to \a to, with
+ * \c parallel_copy for directories, creating copy-on-write clones and preserving holes of sparse files where possible,
+ * and then removed with \c parallel_remove_all. Symlinks are copied as symlinks. \a thread_count of zero means
+ * the number of hardware threads.
+ *
+ * Unlike the rename, the copy is not atomic. If copying fails, the partially copied target is removed and \a from
+ * is left intact. An existing target is replaced by the copy under the same conditions as by the rename: a directory
+ * can only replace an empty directory, and a non-directory can only replace a non-directory.
+ */
+inline void move(path const& from, path const& to, BOOST_SCOPED_ENUM_NATIVE(move_options) options = move_options::none, unsigned int thread_count = 0u)
+{
+    detail::move(from, to, static_cast< unsigned int >(options), thread_count);
+}
+
+inline void move(path const& from, path const& to, BOOST_SCOPED_ENUM_NATIVE(move_options) options, unsigned int thread_count, system::error_code& ec) BOOST_NOEXCEPT
+{
+    detail::move(from, to, static_cast< unsigned int >(options), thread_count, &ec);
+}
+
+//! Exchanges the files or directories \a a and \a b, which must both exist
+/*!
+ * The exchange is atomic where supported: with \c renameat2(RENAME_EXCHANGE) on Linux and \c renamex_np(RENAME_SWAP)
+ * on macOS. If the system or the filesystem does not support atomic exchange, the files are exchanged with three renames,
+ * through a temporary name in the directory of \a a, which is not atomic: for a short time, \a a does not exist. If one of
+ * the renames fails, the preceding renames are reverted. Use <tt>move(a, b, move_options::exchange)</tt> to fail instead.
+ */
+inline void exchange(path const& a, path const& b)
+{
+    detail::exchange(a, b);
+}
+
+inline void exchange(path const& a, path const& b, system::error_code& ec) BOOST_NOEXCEPT
+{
+    detail::exchange(a, b, &ec);
+}
+
 // name suggested by Scott McMurray
 inline void resize_file(path const& p, uintmax_t size)
 {
@@ -625,6 +1500,76 @@ inline void resize_file(path const& p, uintmax_t size, system::error_code& ec) B
     detail::resize_file(p, size, &ec);
 }
 
+//! Allocates storage for \a length bytes of the file \a p starting at \a offset, extending the file unless \c preallocate_options::keep_size
+//! is specified. Fails with \c errc::not_supported if the filesystem does not support preallocation.
+inline void preallocate(path const& p, uintmax_t offset, uintmax_t length, BOOST_SCOPED_ENUM_NATIVE(preallocate_options) options = preallocate_options::none)
+{
+    detail::preallocate(p, offset, length, static_cast< unsigned int >(options));
+}
+
+inline void preallocate(path const& p, uintmax_t offset, uintmax_t length, system::error_code& ec) BOOST_NOEXCEPT
+{
+    detail::preallocate(p, offset, length, static_cast< unsigned int >(preallocate_options::none), &ec);
+}
+
+inline void preallocate(path const& p, uintmax_t offset, uintmax_t length, BOOST_SCOPED_ENUM_NATIVE(preallocate_options) options, system::error_code& ec) BOOST_NOEXCEPT
+{
+    detail::preallocate(p, offset, length, static_cast< unsigned int >(options), &ec);
+}
+
+//! Deallocates storage of \a length bytes of the file \a p starting at \a offset. The range reads as zeros, the file size is not changed.
+//! Fails with \c errc::not_supported if the filesystem does not support deallocation.
+inline void punch_hole(path const& p, uintmax_t offset, uintmax_t length)
+{
+    detail::punch_hole(p, offset, length);
+}
+
+inline void punch_hole(path const& p, uintmax_t offset, uintmax_t length, system::error_code& ec) BOOST_NOEXCEPT
+{
+    detail::punch_hole(p, offset, length, &ec);
+}
+
+//! Makes \a length bytes of the file \a p starting at \a offset read as zeros, preferably without writing the data. The file size is not changed.
+inline void zero_range(path const& p, uintmax_t offset, uintmax_t length)
+{
+    detail::zero_range(p, offset, length);
+}
+
+inline void zero_range(path const& p, uintmax_t offset, uintmax_t length, system::error_code& ec) BOOST_NOEXCEPT
+{
+    detail::zero_range(p, offset, length, &ec);
+}
+
+//! Asks the system to read the contents of \a count files starting at \a paths into the page cache, so that later reads do not block.
+/*!
+ * Directories are ignored unless \c prefetch_options::recursive is specified. At most \a max_bytes are prefetched, the files are
+ * considered in the order they are given and found by iterating the directories. If \a thread_count is not 1, the files are
+ * prefetched concurrently by multiple threads; zero means the concurrency of the current executor.
+ *
+ * Returns the number of bytes requested to be prefetched. All files are processed even if some of them fail,
+ * the first error is reported after that.
+ */
+inline uintmax_t prefetch(path const* paths, std::size_t count, BOOST_SCOPED_ENUM_NATIVE(prefetch_options) options = prefetch_options::none)
+{
+    return detail::prefetch(paths, count, static_cast< unsigned int >(options), ~static_cast< uintmax_t >(0u), 0u);
+}
+
+inline uintmax_t prefetch(path const* paths, std::size_t count, BOOST_SCOPED_ENUM_NATIVE(prefetch_options) options, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::prefetch(paths, count, static_cast< unsigned int >(options), ~static_cast< uintmax_t >(0u), 0u, &ec);
+}
+
+inline uintmax_t prefetch(path const* paths, std::size_t count, BOOST_SCOPED_ENUM_NATIVE(prefetch_options) options, uintmax_t max_bytes, unsigned int thread_count = 0u)
+{
+    return detail::prefetch(paths, count, static_cast< unsigned int >(options), max_bytes, thread_count);
+}
+
+inline uintmax_t prefetch(path const* paths, std::size_t count, BOOST_SCOPED_ENUM_NATIVE(prefetch_options) options, uintmax_t max_bytes, unsigned int thread_count,
+    system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::prefetch(paths, count, static_cast< unsigned int >(options), max_bytes, thread_count, &ec);
+}
+
 inline path relative(path const& p, path const& base = current_path())
 {
     return detail::relative(p, base);
@@ -691,6 +1636,21 @@ inline path unique_path(path const& p, system::error_code& ec)
     return detail::unique_path(p, &ec);
 }
 
+//! Creates a new directory with a unique name generated from \a model, as in \c unique_path, and returns its path
+/*!
+ * If a file with the generated name already exists, a new name is generated and the creation is retried. On POSIX systems,
+ * the directory is created with owner-only permissions.
+ */
+inline path create_unique_directory(path const& model = "%%%%-%%%%-%%%%-%%%%")
+{
+    return detail::create_unique_directory(model);
+}
+
+inline path create_unique_directory(path const& model, system::error_code& ec)
+{
+    return detail::create_unique_directory(model, &ec);
+}
+
 inline path weakly_canonical(path const& p, path const& base = current_path())
 {
     return detail::weakly_canonical(p, base);
@@ -0,0 +1,776 @@
+//  boost/filesystem/parallel_walk.hpp  -----------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_PARALLEL_WALK_HPP
+#define BOOST_FILESYSTEM_PARALLEL_WALK_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/executor.hpp>
+
+#include <cstddef>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/detail/bitmask.hpp>
+#include <boost/core/scoped_enum.hpp>
+
+#if !defined(BOOST_NO_CXX11_HDR_EXCEPTION) && !defined(BOOST_NO_CXX11_HDR_ATOMIC)
+#include <exception>
+#include <atomic>
+#define BOOST_FILESYSTEM_HAS_PARALLEL_WALK
+#endif
+
+#if defined(BOOST_FILESYSTEM_HAS_PARALLEL_WALK) && !defined(BOOST_NO_CXX11_HDR_FUTURE) && !defined(BOOST_NO_CXX11_HDR_SYSTEM_ERROR) && \
+    !defined(BOOST_NO_CXX11_HDR_THREAD)
+#include <future>
+#include <thread>
+#include <utility> // std::move
+#include <system_error>
+#define BOOST_FILESYSTEM_HAS_REMOVE_ALL_ASYNC
+#endif
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+//! Options of computing disk usage of a directory tree
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(disk_usage_options, unsigned int)
+{
+    none = 0u,
+    skip_permission_denied = 1u,  // Skip directories that cannot be opened due to insufficient permissions instead of reporting an error
+    count_hard_links = 1u << 1    // Count every hard link to a file instead of counting each file once
+}
+BOOST_SCOPED_ENUM_DECLARE_END(disk_usage_options)
+
+BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(disk_usage_options))
+
+//! Disk usage of a directory tree, see \c disk_usage
+struct disk_usage_info
+{
+    //! Total size of files other than directories, in bytes, as reported by \c file_size for regular files
+    boost::uintmax_t apparent_size;
+    //! Total disk space allocated for all files, including directories, in bytes
+    boost::uintmax_t allocated_size;
+    //! Number of files other than directories
+    boost::uintmax_t file_count;
+    //! Number of directories, including the root of the tree
+    boost::uintmax_t directory_count;
+
+    disk_usage_info() BOOST_NOEXCEPT :
+        apparent_size(0u),
+        allocated_size(0u),
+        file_count(0u),
+        directory_count(0u)
+    {
+    }
+};
+
+//! Options of deduplicating files in a directory tree
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(deduplicate_options, unsigned int)
+{
+    none = 0u,
+    skip_permission_denied = 1u,  // Skip directories and files that cannot be read due to insufficient permissions instead of reporting an error
+    clone = 1u << 1,              // Replace duplicates with copy-on-write clones instead of hard links. Fails if the filesystem does not support cloning.
+    dry_run = 1u << 2             // Find duplicates and report them in the result without modifying the tree
+}
+BOOST_SCOPED_ENUM_DECLARE_END(deduplicate_options)
+
+BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(deduplicate_options))
+
+//! Options of computing a digest of a directory tree, see \c tree_digest
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(tree_digest_options, unsigned int)
+{
+    none = 0u,
+    skip_permission_denied = 1u,  // Leave out directories and files that cannot be read due to insufficient permissions instead of reporting an error
+    memory_map = 1u << 1,         // Read file contents by mapping the files into memory instead of reading them into a buffer
+    include_permissions = 1u << 2 // Include permissions of files and directories, other than symlinks, in the digest
+}
+BOOST_SCOPED_ENUM_DECLARE_END(tree_digest_options)
+
+BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(tree_digest_options))
+
+//! Options of synchronizing a directory tree with another, see \c synchronize_tree
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(synchronize_options, unsigned int)
+{
+    none = 0u,
+    remove_extra = 1u,            // Remove files and directories in the target tree that are not present in the source tree
+    compare_contents = 1u << 1,   // Compare contents of files of equal size instead of modification times
+    delta = 1u << 2,              // Update changed files in place, writing only the blocks that differ, see copy_options::delta
+    clone_if_possible = 1u << 3   // Clone changed files if the filesystem supports it, see copy_options::clone_if_possible
+}
+BOOST_SCOPED_ENUM_DECLARE_END(synchronize_options)
+
+BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(synchronize_options))
+
+//! Options of comparing two directory trees, see \c trees_equal
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(trees_equal_options, unsigned int)
+{
+    none = 0u,
+    compare_permissions = 1u,     // Also compare permissions of files and directories, other than symlinks
+    memory_map = 1u << 1          // Read file contents by mapping the files into memory instead of reading them into buffers
+}
+BOOST_SCOPED_ENUM_DECLARE_END(trees_equal_options)
+
+BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(trees_equal_options))
+
+//! Kind of links created by \c link_tree
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(link_tree_mode, unsigned int)
+{
+    hard_links = 0u,  // Create hard links to the files of the source tree
+    symlinks = 1u     // Create symlinks to the absolute paths of the files of the source tree
+}
+BOOST_SCOPED_ENUM_DECLARE_END(link_tree_mode)
+
+//! Result of deduplicating a directory tree, see \c deduplicate
+struct deduplicate_info
+{
+    //! Number of regular files in the tree
+    boost::uintmax_t file_count;
+    //! Number of files whose contents were read to compute hashes, i.e. not found in the hash cache
+    boost::uintmax_t hashed_count;
+    //! Number of files that were replaced with hard links or clones of identical files
+    boost::uintmax_t replaced_count;
+    //! Total size of the distinct files that were replaced, in bytes. This is the amount of data no longer stored separately.
+    boost::uintmax_t replaced_size;
+
+    deduplicate_info() BOOST_NOEXCEPT :
+        file_count(0u),
+        hashed_count(0u),
+        replaced_count(0u),
+        replaced_size(0u)
+    {
+    }
+};
+
+//! Result of computing a digest of a directory tree, see \c tree_digest
+struct tree_digest_info
+{
+    //! Digest of the tree
+    boost::uint64_t digest;
+    //! Number of files other than directories that are included in the digest
+    boost::uintmax_t file_count;
+    //! Number of directories that are included in the digest, including the root of the tree
+    boost::uintmax_t directory_count;
+    //! Number of files whose contents were read to compute hashes, i.e. not found in the hash cache
+    boost::uintmax_t hashed_count;
+
+    tree_digest_info() BOOST_NOEXCEPT :
+        digest(0u),
+        file_count(0u),
+        directory_count(0u),
+        hashed_count(0u)
+    {
+    }
+};
+
+//! Result of synchronizing a directory tree, see \c synchronize_tree
+struct synchronize_info
+{
+    //! Number of files, directories and symlinks in the source tree
+    boost::uintmax_t file_count;
+    //! Number of files and symlinks that were copied to the target tree because they were missing or changed
+    boost::uintmax_t copied_count;
+    //! Total size of the copied files, in bytes
+    boost::uintmax_t copied_size;
+    //! Number of files and directories whose permissions or modification times were updated without copying
+    boost::uintmax_t updated_count;
+    //! Number of files and directories removed from the target tree
+    boost::uintmax_t removed_count;
+
+    synchronize_info() BOOST_NOEXCEPT :
+        file_count(0u),
+        copied_count(0u),
+        copied_size(0u),
+        updated_count(0u),
+        removed_count(0u)
+    {
+    }
+};
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                          parallel_directory_walker                                   //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+namespace detail {
+
+//! Batch handler called by the walker. Returns \c false if the walk should be stopped.
+typedef bool parallel_walk_handler(void* context, std::vector< directory_entry >& batch);
+
+struct parallel_walk_params
+{
+    //! Number of threads to use, including the calling thread. Zero means the number of hardware threads.
+    unsigned int thread_count;
+    //! Maximum number of directory entries passed to the handler in one batch
+    std::size_t batch_size;
+    //! Directory iteration options, see directory_options
+    unsigned int options;
+    //! Executor to run the threads with, or \c NULL to use the current executor
+    executor* exec;
+};
+
+BOOST_FILESYSTEM_DECL
+void parallel_walk(path const& root, parallel_walk_params const& params, parallel_walk_handler* handler, void* context, system::error_code* ec);
+
+BOOST_FILESYSTEM_DECL
+void parallel_copy(path const& from, path const& to, unsigned int options, unsigned int thread_count, system::error_code* ec = NULL);
+
+BOOST_FILESYSTEM_DECL
+uintmax_t link_tree(path const& from, path const& to, unsigned int mode, unsigned int thread_count, system::error_code* ec = NULL);
+
+BOOST_FILESYSTEM_DECL
+uintmax_t parallel_remove_all(path const& p, unsigned int thread_count, system::error_code* ec = NULL);
+
+BOOST_FILESYSTEM_DECL
+disk_usage_info disk_usage(path const& p, unsigned int options, unsigned int thread_count, system::error_code* ec = NULL);
+
+BOOST_FILESYSTEM_DECL
+deduplicate_info deduplicate(path const& p, unsigned int options, path const& hash_cache, unsigned int thread_count, system::error_code* ec = NULL);
+
+BOOST_FILESYSTEM_DECL
+tree_digest_info tree_digest(path const& p, unsigned int options, path const& hash_cache, unsigned int thread_count, system::error_code* ec = NULL);
+
+BOOST_FILESYSTEM_DECL
+synchronize_info synchronize_tree(path const& from, path const& to, unsigned int options, unsigned int thread_count, system::error_code* ec = NULL);
+
+BOOST_FILESYSTEM_DECL
+bool trees_equal(path const& p1, path const& p2, unsigned int options, unsigned int thread_count, system::error_code* ec = NULL);
+
+//! Batch handler called by \c bulk_metadata_scan. Returns \c false if the scan should be stopped.
+typedef bool bulk_metadata_handler(void* context, std::vector< file_attributes >& batch);
+
+BOOST_FILESYSTEM_DECL
+uintmax_t bulk_metadata_scan(path const& mount, unsigned int thread_count, bulk_metadata_handler* handler, void* context, system::error_code* ec = NULL);
+
+//! Renames \a p to a unique hidden name in the same directory and returns the new name, or an empty path if \a p does not exist
+BOOST_FILESYSTEM_DECL
+path rename_for_removal(path const& p, system::error_code* ec = NULL);
+
+} // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                 parallel_copy                                        //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+//! Recursively copies a directory tree using multiple threads
+/*!
+ * Equivalent to <tt>copy(from, to, options | copy_options::recursive)</tt>, except that the source tree is enumerated with
+ * \c parallel_directory_walker and files are copied concurrently by the threads of the walker. The order in which files
+ * are copied is unspecified. \a thread_count of zero means the number of hardware threads.
+ */
+inline void parallel_copy(path const& from, path const& to, BOOST_SCOPED_ENUM_NATIVE(copy_options) options = copy_options::none, unsigned int thread_count = 0u)
+{
+    detail::parallel_copy(from, to, static_cast< unsigned int >(options), thread_count);
+}
+
+inline void parallel_copy(path const& from, path const& to, BOOST_SCOPED_ENUM_NATIVE(copy_options) options, unsigned int thread_count, system::error_code& ec) BOOST_NOEXCEPT
+{
+    detail::parallel_copy(from, to, static_cast< unsigned int >(options), thread_count, &ec);
+}
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                    link_tree                                         //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+//! Recreates a directory tree with links to the files of another tree using multiple threads
+/*!
+ * The directory structure of \a from is recreated in \a to, and every file other than a directory is linked into
+ * the corresponding directory of \a to, as a hard link or, with \c link_tree_mode::symlinks, a symlink to the absolute
+ * path of the file. The tree is enumerated with \c parallel_directory_walker, without following symlinks, so symlinks
+ * in the source tree are linked like other files. Where supported, each batch of files is linked relative to the open
+ * source and target directories (\c linkat and \c symlinkat), without resolving the full paths for every file.
+ *
+ * Existing directories in \a to are reused, but existing files are not replaced, and linking them is an error. If \a from
+ * is not a directory, a single link to it is created at \a to. Returns the number of created links.
+ * \a thread_count of zero means the number of hardware threads. If an error occurs, the operation is stopped
+ * and the first error is reported.
+ */
+inline uintmax_t link_tree(path const& from, path const& to, BOOST_SCOPED_ENUM_NATIVE(link_tree_mode) mode = link_tree_mode::hard_links, unsigned int thread_count = 0u)
+{
+    return detail::link_tree(from, to, static_cast< unsigned int >(mode), thread_count);
+}
+
+inline uintmax_t link_tree(path const& from, path const& to, BOOST_SCOPED_ENUM_NATIVE(link_tree_mode) mode, unsigned int thread_count, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::link_tree(from, to, static_cast< unsigned int >(mode), thread_count, &ec);
+}
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                              parallel_remove_all                                     //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+//! Recursively removes a file or a directory tree using multiple threads
+/*!
+ * Equivalent to <tt>remove_all(p)</tt>, except that the directories of the tree are distributed between \a thread_count
+ * threads as they are discovered, and each directory is removed once its entries have been removed. Returns the number of removed files.
+ * \a thread_count of zero means the number of hardware threads. If an error occurs, the removal is stopped
+ * and the first error is reported.
+ */
+inline uintmax_t parallel_remove_all(path const& p, unsigned int thread_count = 0u)
+{
+    return detail::parallel_remove_all(p, thread_count);
+}
+
+inline uintmax_t parallel_remove_all(path const& p, unsigned int thread_count, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::parallel_remove_all(p, thread_count, &ec);
+}
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                    disk_usage                                        //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+//! Computes disk usage of a file or a directory tree using multiple threads
+/*!
+ * If \a p refers to a directory, possibly through a symlink, the directory tree is enumerated with \c parallel_directory_walker,
+ * without following symlinks, and attributes of the files are queried relative to their parent directories. Otherwise the
+ * result describes the single file \a p. Files with multiple hard links are counted once, unless
+ * \c disk_usage_options::count_hard_links is specified. \a thread_count of zero means the number of hardware threads.
+ * Files that are removed during the enumeration are ignored.
+ */
+inline disk_usage_info disk_usage(path const& p, BOOST_SCOPED_ENUM_NATIVE(disk_usage_options) options = disk_usage_options::none, unsigned int thread_count = 0u)
+{
+    return detail::disk_usage(p, static_cast< unsigned int >(options), thread_count);
+}
+
+inline disk_usage_info disk_usage(path const& p, BOOST_SCOPED_ENUM_NATIVE(disk_usage_options) options, unsigned int thread_count, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::disk_usage(p, static_cast< unsigned int >(options), thread_count, &ec);
+}
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                   deduplicate                                        //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+//! Replaces identical files in a directory tree with hard links to one of them
+/*!
+ * The tree \a p is enumerated with \c parallel_directory_walker, without following symlinks. Regular non-empty files are
+ * grouped by device and size, the files in groups of more than one file are hashed, and the files with equal hashes are
+ * compared byte by byte. Each duplicate is replaced with a hard link to, or with \c deduplicate_options::clone, a clone of
+ * the identical file that has the most hard links. The replacement is atomic: the link or clone is created under a temporary
+ * name and renamed over the duplicate. Files that are already hard links to each other are not hashed separately.
+ * Groups of files are processed concurrently by \a thread_count threads, zero means the number of hardware threads.
+ *
+ * If \a hash_cache is not empty, it names a file with content hashes from the previous runs, keyed by device, inode number,
+ * size and modification time of the files. Files that have not changed since they were hashed are not read again unless
+ * they need to be compared. The cache file is created if it does not exist, and is replaced with the hashes of the current
+ * tree after the operation completes successfully. A cache file that cannot be read is ignored.
+ *
+ * Replaced files get the permissions, owner and times of the file they are linked to. The files must not be modified
+ * during the operation.
+ */
+inline deduplicate_info deduplicate(path const& p, BOOST_SCOPED_ENUM_NATIVE(deduplicate_options) options = deduplicate_options::none,
+    path const& hash_cache = path(), unsigned int thread_count = 0u)
+{
+    return detail::deduplicate(p, static_cast< unsigned int >(options), hash_cache, thread_count);
+}
+
+inline deduplicate_info deduplicate(path const& p, BOOST_SCOPED_ENUM_NATIVE(deduplicate_options) options, path const& hash_cache,
+    unsigned int thread_count, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::deduplicate(p, static_cast< unsigned int >(options), hash_cache, thread_count, &ec);
+}
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                   tree_digest                                        //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+//! Computes a Merkle hash of a directory tree using multiple threads
+/*!
+ * The tree \a p is enumerated with \c parallel_directory_walker, without following symlinks, and the contents of the regular
+ * files are hashed concurrently by \a thread_count threads, zero means the number of hardware threads. Symlinks are hashed by
+ * their targets. The digest of a directory combines the names, types and digests of its entries in the order of their names,
+ * so equal trees have equal digests regardless of the order in which the entries are listed or of the file times. If \a p
+ * refers to a regular file, possibly through a symlink, the digest is the hash of its contents.
+ *
+ * If \a hash_cache is not empty, it names a file with content hashes from the previous runs, keyed by device, inode number,
+ * size and modification time of the files. Files that have not changed since they were hashed are not read again. The cache
+ * file has the same format as the one used by \c deduplicate, so the two operations can share it. The cache file is created
+ * if it does not exist, and is replaced with the hashes of the current tree after the operation completes successfully.
+ * A cache file that cannot be read is ignored.
+ *
+ * The digest is a 64-bit non-cryptographic hash. It is suitable for detecting changes of a tree, not for protecting against
+ * deliberately crafted collisions. Names are hashed in their native encoding. Files removed during the operation are left
+ * out of the digest.
+ */
+inline tree_digest_info tree_digest(path const& p, BOOST_SCOPED_ENUM_NATIVE(tree_digest_options) options = tree_digest_options::none,
+    path const& hash_cache = path(), unsigned int thread_count = 0u)
+{
+    return detail::tree_digest(p, static_cast< unsigned int >(options), hash_cache, thread_count);
+}
+
+inline tree_digest_info tree_digest(path const& p, BOOST_SCOPED_ENUM_NATIVE(tree_digest_options) options, path const& hash_cache,
+    unsigned int thread_count, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::tree_digest(p, static_cast< unsigned int >(options), hash_cache, thread_count, &ec);
+}
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                 synchronize_tree                                     //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+//! Makes the directory tree \a to a mirror of the directory tree \a from
+/*!
+ * The tree \a from is enumerated with \c parallel_directory_walker, without following symlinks, and every directory, regular
+ * file and symlink is recreated in \a to unless the target file is already up to date. A regular file is copied if the target
+ * is missing, has a different type or size, or, unless \c synchronize_options::compare_contents is specified, a different
+ * modification time. With \c compare_contents, files of equal size are compared byte by byte instead. Copied files get
+ * the modification time of the source file, so that they compare equal on the next run. Permissions and modification times
+ * of the files that are not copied are updated if they differ. Entries of each directory are queried relative to the open
+ * source and target directories. Other file types are not synchronized.
+ *
+ * With \c synchronize_options::remove_extra, the tree \a to is enumerated after the copy and the files and directories
+ * that are not present in \a from are removed.
+ *
+ * The directories are processed concurrently by \a thread_count threads, zero means the number of hardware threads.
+ * The source tree must not be modified during the operation.
+ */
+inline synchronize_info synchronize_tree(path const& from, path const& to,
+    BOOST_SCOPED_ENUM_NATIVE(synchronize_options) options = synchronize_options::none, unsigned int thread_count = 0u)
+{
+    return detail::synchronize_tree(from, to, static_cast< unsigned int >(options), thread_count);
+}
+
+inline synchronize_info synchronize_tree(path const& from, path const& to, BOOST_SCOPED_ENUM_NATIVE(synchronize_options) options,
+    unsigned int thread_count, system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::synchronize_tree(from, to, static_cast< unsigned int >(options), thread_count, &ec);
+}
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                   trees_equal                                        //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+//! Returns \c true if the directory trees \a p1 and \a p2 have equal structure and file contents
+/*!
+ * The trees are enumerated with \c parallel_directory_walker, without following symlinks. The trees are equal if they
+ * contain files with the same relative paths and types, the regular files have equal sizes and contents and the symlinks
+ * have equal targets. With \c trees_equal_options::compare_permissions, the permissions of the files and directories must
+ * also be equal. The file times are not compared. If \a p1 and \a p2 refer to regular files, possibly through symlinks,
+ * their contents are compared like \c files_equal does.
+ *
+ * The structure of the trees is compared before reading any files. Regular files that are the same file in both trees,
+ * e.g. hard links, are not read. The contents of the other files are compared concurrently by \a thread_count threads,
+ * zero means the number of hardware threads, starting from the largest files, and the comparison stops at the first difference.
+ * The trees must not be modified during the operation.
+ */
+inline bool trees_equal(path const& p1, path const& p2, BOOST_SCOPED_ENUM_NATIVE(trees_equal_options) options = trees_equal_options::none,
+    unsigned int thread_count = 0u)
+{
+    return detail::trees_equal(p1, p2, static_cast< unsigned int >(options), thread_count);
+}
+
+inline bool trees_equal(path const& p1, path const& p2, BOOST_SCOPED_ENUM_NATIVE(trees_equal_options) options, unsigned int thread_count,
+    system::error_code& ec) BOOST_NOEXCEPT
+{
+    return detail::trees_equal(p1, p2, static_cast< unsigned int >(options), thread_count, &ec);
+}
+
+#if defined(BOOST_FILESYSTEM_HAS_REMOVE_ALL_ASYNC)
+
+namespace detail {
+
+//! Removes the renamed file or directory tree and stores the result in \a result
+inline void remove_all_renamed(std::promise< uintmax_t >& result, path const& tombstone)
+{
+    try
+    {
+        result.set_value(tombstone.empty() ? static_cast< uintmax_t >(0u) : filesystem::remove_all(tombstone));
+    }
+    catch (...)
+    {
+        result.set_exception(std::current_exception());
+    }
+}
+
+//! Background thread function of \c remove_all_async
+inline void remove_all_renamed_thread(std::promise< uintmax_t > result, path const& tombstone)
+{
+    detail::remove_all_renamed(result, tombstone);
+}
+
+inline std::future< uintmax_t > remove_all_renamed_async(path const& tombstone)
+{
+    if (!tombstone.empty())
+    {
+        // Unlike the future returned by std::async, the future of a promise does not block in its destructor,
+        // so the caller may discard the result without waiting for the removal to complete
+        std::promise< uintmax_t > result;
+        std::future< uintmax_t > future = result.get_future();
+        try
+        {
+            // The detached thread is not joined, so it is terminated if the process exits before the removal completes.
+            // In that case, the partially removed tree is left behind under the hidden name.
+            std::thread(&detail::remove_all_renamed_thread, std::move(result), tombstone).detach();
+            return future;
+        }
+        catch (std::system_error&)
+        {
+            // Failed to start a thread, fall back to removing the files synchronously
+        }
+    }
+
+    std::promise< uintmax_t > result;
+    detail::remove_all_renamed(result, tombstone);
+    return result.get_future();
+}
+
+} // namespace detail
+
+//! Removes a file or a directory tree in a background thread
+/*!
+ * Renames \a p to a unique hidden name in the same directory, which makes \a p disappear atomically, and then removes
+ * the renamed file or directory tree in a detached background thread. Returns a future that receives the result of
+ * <tt>remove_all</tt> on the renamed path, or an exception if the removal fails. The future does not block on destruction,
+ * so the result may be discarded. If \a p does not exist, the future is ready and contains zero. Errors of the rename are
+ * reported immediately. If a thread cannot be started, the removal is performed before returning.
+ *
+ * The background thread is cut off if the process exits before the removal completes, and the remainder of the tree
+ * is left behind under the hidden name, <tt>.<filename>.removing-XXXX-XXXX-XXXX-XXXX</tt>. Applications that need
+ * the removal to complete must wait for the future before exiting.
+ */
+inline std::future< uintmax_t > remove_all_async(path const& p)
+{
+    return detail::remove_all_renamed_async(detail::rename_for_removal(p));
+}
+
+inline std::future< uintmax_t > remove_all_async(path const& p, system::error_code& ec)
+{
+    path tombstone = detail::rename_for_removal(p, &ec);
+    if (ec)
+    {
+        std::promise< uintmax_t > result;
+        result.set_value(static_cast< uintmax_t >(-1));
+        return result.get_future();
+    }
+
+    return detail::remove_all_renamed_async(tombstone);
+}
+
+#endif // defined(BOOST_FILESYSTEM_HAS_REMOVE_ALL_ASYNC)
+
+#if defined(BOOST_FILESYSTEM_HAS_PARALLEL_WALK)
+
+//! Recursively enumerates a directory tree using multiple threads
+/*!
+ * The walker distributes enumeration of subdirectories across a pool of threads, with the calling thread participating
+ * in the walk. Each thread keeps a queue of pending directories and, once it runs out of work, steals directories
+ * from the queues of other threads. Directory entries are delivered to the user's handler in batches, and each batch
+ * contains entries of a single directory. The handler is called concurrently from different threads and must be
+ * thread-safe. The order in which directories are enumerated is unspecified, except that the handler returns for the batch
+ * containing a directory before any entries of that directory are delivered.
+ *
+ * The handler must be a function object compatible with signature <tt>void (std::vector< directory_entry >&)</tt>.
+ * The handler may modify the batch, for example, move the entries out of it. If the handler throws, the walk is stopped
+ * and the exception is rethrown from \c walk after all threads have finished.
+ */
+class parallel_directory_walker
+{
+public:
+    BOOST_STATIC_CONSTEXPR std::size_t default_batch_size = 256u;
+
+public:
+    parallel_directory_walker() BOOST_NOEXCEPT
+    {
+        m_params.thread_count = 0u;
+        m_params.batch_size = default_batch_size;
+        m_params.options = static_cast< unsigned int >(directory_options::none);
+        m_params.exec = NULL;
+    }
+
+    explicit parallel_directory_walker(unsigned int thread_count, BOOST_SCOPED_ENUM_NATIVE(directory_options) opts = directory_options::none) BOOST_NOEXCEPT
+    {
+        m_params.thread_count = thread_count;
+        m_params.batch_size = default_batch_size;
+        m_params.options = static_cast< unsigned int >(opts);
+        m_params.exec = NULL;
+    }
+
+    //! Returns the number of threads used for the walk. Zero means the concurrency of the executor.
+    unsigned int thread_count() const BOOST_NOEXCEPT { return m_params.thread_count; }
+    void set_thread_count(unsigned int thread_count) BOOST_NOEXCEPT { m_params.thread_count = thread_count; }
+
+    //! Returns the maximum number of entries in a batch
+    std::size_t batch_size() const BOOST_NOEXCEPT { return m_params.batch_size; }
+    void set_batch_size(std::size_t batch_size) BOOST_NOEXCEPT { m_params.batch_size = batch_size > 0u ? batch_size : static_cast< std::size_t >(1u); }
+
+    //! Returns directory iteration options
+    BOOST_SCOPED_ENUM_NATIVE(directory_options) options() const BOOST_NOEXCEPT { return static_cast< BOOST_SCOPED_ENUM_NATIVE(directory_options) >(m_params.options); }
+    void set_options(BOOST_SCOPED_ENUM_NATIVE(directory_options) opts) BOOST_NOEXCEPT { m_params.options = static_cast< unsigned int >(opts); }
+
+    //! Returns the executor used to run the threads of the walk, or \c NULL if the executor returned by \c filesystem::get_executor is used
+    filesystem::executor* get_executor() const BOOST_NOEXCEPT { return m_params.exec; }
+    void set_executor(filesystem::executor* ex) BOOST_NOEXCEPT { m_params.exec = ex; }
+
+    //! Walks the directory tree starting at \a root, not including \a root itself
+    template< typename Handler >
+    void walk(path const& root, Handler handler) const
+    {
+        walk_impl(root, handler, NULL);
+    }
+
+    //! Walks the directory tree starting at \a root, not including \a root itself
+    template< typename Handler >
+    void walk(path const& root, Handler handler, system::error_code& ec) const
+    {
+        walk_impl(root, handler, &ec);
+    }
+
+private:
+    template< typename Handler >
+    struct handler_context
+    {
+        Handler& handler;
+        std::atomic< bool > has_exception;
+        std::exception_ptr exception;
+
+        explicit handler_context(Handler& h) : handler(h), has_exception(false) {}
+
+        static bool invoke(void* context, std::vector< directory_entry >& batch)
+        {
+            handler_context* ctx = static_cast< handler_context* >(context);
+            try
+            {
+                ctx->handler(batch);
+                return true;
+            }
+            catch (...)
+            {
+                if (!ctx->has_exception.exchange(true, std::memory_order_acq_rel))
+                    ctx->exception = std::current_exception();
+            }
+            return false;
+        }
+
+        BOOST_DELETED_FUNCTION(handler_context(handler_context const&))
+        BOOST_DELETED_FUNCTION(handler_context& operator=(handler_context const&))
+    };
+
+    template< typename Handler >
+    void walk_impl(path const& root, Handler& handler, system::error_code* ec) const
+    {
+        handler_context< Handler > ctx(handler);
+        detail::parallel_walk(root, m_params, &handler_context< Handler >::invoke, &ctx, ec);
+        if (ctx.exception)
+            std::rethrow_exception(ctx.exception);
+    }
+
+private:
+    detail::parallel_walk_params m_params;
+};
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                               bulk_metadata_scan                                     //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+namespace detail {
+
+template< typename Handler >
+struct bulk_metadata_handler_context
+{
+    Handler& handler;
+    std::atomic< bool > has_exception;
+    std::exception_ptr exception;
+
+    explicit bulk_metadata_handler_context(Handler& h) : handler(h), has_exception(false) {}
+
+    static bool invoke(void* context, std::vector< file_attributes >& batch)
+    {
+        bulk_metadata_handler_context* ctx = static_cast< bulk_metadata_handler_context* >(context);
+        try
+        {
+            ctx->handler(batch);
+            return true;
+        }
+        catch (...)
+        {
+            if (!ctx->has_exception.exchange(true, std::memory_order_acq_rel))
+                ctx->exception = std::current_exception();
+        }
+        return false;
+    }
+
+    BOOST_DELETED_FUNCTION(bulk_metadata_handler_context(bulk_metadata_handler_context const&))
+    BOOST_DELETED_FUNCTION(bulk_metadata_handler_context& operator=(bulk_metadata_handler_context const&))
+};
+
+template< typename Handler >
+inline uintmax_t bulk_metadata_scan_impl(path const& mount, Handler& handler, unsigned int thread_count, system::error_code* ec)
+{
+    bulk_metadata_handler_context< Handler > ctx(handler);
+    const uintmax_t count = detail::bulk_metadata_scan(mount, thread_count, &bulk_metadata_handler_context< Handler >::invoke, &ctx, ec);
+    if (ctx.exception)
+        std::rethrow_exception(ctx.exception);
+    return count;
+}
+
+} // namespace detail
+
+//! Reports the attributes of all files of the filesystem mounted at \a mount, using the fastest interface available for the filesystem
+/*!
+ * On XFS, if \a mount is the root of the filesystem, the inodes are read with \c XFS_IOC_BULKSTAT in the order of their inode numbers,
+ * which follows their placement on disk, without resolving any paths. This requires \c CAP_SYS_ADMIN. Otherwise, the directory tree
+ * rooted at \a mount is enumerated with \c parallel_directory_walker, without following symlinks or descending into other filesystems
+ * mounted in the tree, and the attributes of the files are queried relative to their parent directories. The implementation can be
+ * selected with \c set_bulk_scan_backend.
+ *
+ * Every file is reported once, including \a mount itself, regardless of the number of its hard links. The attributes include
+ * the type, permissions, size, allocated size, times, hard link count, inode and device numbers and the owner of the files, as indicated
+ * by the \c mask member. Names of the files are not reported: the attributes can be matched with directory entries by their inode numbers.
+ *
+ * The handler must be a function object compatible with signature <tt>void (std::vector< file_attributes >&)</tt>. The handler
+ * may be called concurrently from different threads and must be thread-safe. If the handler throws, the scan is stopped and
+ * the exception is rethrown. Returns the number of reported files. \a thread_count of zero means the number of hardware threads.
+ */
+template< typename Handler >
+inline uintmax_t bulk_metadata_scan(path const& mount, Handler handler, unsigned int thread_count = 0u)
+{
+    return detail::bulk_metadata_scan_impl(mount, handler, thread_count, NULL);
+}
+
+template< typename Handler >
+inline uintmax_t bulk_metadata_scan(path const& mount, Handler handler, unsigned int thread_count, system::error_code& ec)
+{
+    return detail::bulk_metadata_scan_impl(mount, handler, thread_count, &ec);
+}
+
+#endif // defined(BOOST_FILESYSTEM_HAS_PARALLEL_WALK)
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_PARALLEL_WALK_HPP
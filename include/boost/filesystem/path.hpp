@@ -29,6 +29,9 @@
 #include <boost/type_traits/disjunction.hpp>
 #include <boost/type_traits/is_same.hpp>
 #include <boost/type_traits/remove_cv.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/detail/bitmask.hpp>
+#include <boost/core/scoped_enum.hpp>
 #include <cstddef>
 #include <iosfwd>
 #include <locale>
@@ -818,6 +821,53 @@ public:
         return *this;
     }
 
+    //  -----  join  -----
+
+    //  Returns the same result as p1 / p2 / ... / pn, but reserves storage for the result once
+
+#if !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+    template< typename... Paths >
+    static path join(path const& p1, path const& p2, Paths const&... rest)
+    {
+        const path* const parts[] = { &p1, &p2, &rest... };
+        path result;
+        BOOST_FILESYSTEM_VERSIONED_SYM(join)(result, parts, sizeof(parts) / sizeof(*parts));
+        return result;
+    }
+#else // !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+    static path join(path const& p1, path const& p2)
+    {
+        const path* const parts[] = { &p1, &p2 };
+        path result;
+        BOOST_FILESYSTEM_VERSIONED_SYM(join)(result, parts, sizeof(parts) / sizeof(*parts));
+        return result;
+    }
+
+    static path join(path const& p1, path const& p2, path const& p3)
+    {
+        const path* const parts[] = { &p1, &p2, &p3 };
+        path result;
+        BOOST_FILESYSTEM_VERSIONED_SYM(join)(result, parts, sizeof(parts) / sizeof(*parts));
+        return result;
+    }
+
+    static path join(path const& p1, path const& p2, path const& p3, path const& p4)
+    {
+        const path* const parts[] = { &p1, &p2, &p3, &p4 };
+        path result;
+        BOOST_FILESYSTEM_VERSIONED_SYM(join)(result, parts, sizeof(parts) / sizeof(*parts));
+        return result;
+    }
+
+    static path join(path const& p1, path const& p2, path const& p3, path const& p4, path const& p5)
+    {
+        const path* const parts[] = { &p1, &p2, &p3, &p4, &p5 };
+        path result;
+        BOOST_FILESYSTEM_VERSIONED_SYM(join)(result, parts, sizeof(parts) / sizeof(*parts));
+        return result;
+    }
+#endif // !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+
     //  -----  modifiers  -----
 
     void clear() BOOST_NOEXCEPT { m_pathname.clear(); }
@@ -832,11 +882,22 @@ public:
 #endif
     BOOST_FILESYSTEM_DECL path& remove_filename();
     BOOST_FILESYSTEM_DECL path& remove_trailing_separator();
+    //! Replaces the path with its normal form, same as <tt>*this = lexically_normal()</tt>
+    BOOST_FORCEINLINE path& normalize()
+    {
+        BOOST_FILESYSTEM_VERSIONED_SYM(normalize)();
+        return *this;
+    }
     BOOST_FORCEINLINE path& replace_extension(path const& new_extension = path())
     {
         BOOST_FILESYSTEM_VERSIONED_SYM(replace_extension)(new_extension);
         return *this;
     }
+    BOOST_FORCEINLINE path& replace_filename(path const& replacement)
+    {
+        BOOST_FILESYSTEM_VERSIONED_SYM(replace_filename)(replacement.m_pathname.data(), replacement.m_pathname.data() + replacement.m_pathname.size());
+        return *this;
+    }
     void swap(path& rhs) BOOST_NOEXCEPT { m_pathname.swap(rhs.m_pathname); }
 
     //  -----  observers  -----
@@ -874,21 +935,37 @@ public:
     std::string string() const
     {
         std::string tmp;
-        if (!m_pathname.empty())
-            detail::path_traits::convert(m_pathname.data(), m_pathname.data() + m_pathname.size(), tmp);
+        string_into(tmp);
         return tmp;
     }
     std::string string(codecvt_type const& cvt) const
     {
         std::string tmp;
-        if (!m_pathname.empty())
-            detail::path_traits::convert(m_pathname.data(), m_pathname.data() + m_pathname.size(), tmp, &cvt);
+        string_into(tmp, cvt);
         return tmp;
     }
 
     //  string_type is std::wstring, so there is no conversion
     std::wstring const& wstring() const { return m_pathname; }
     std::wstring const& wstring(codecvt_type const&) const { return m_pathname; }
+
+    //! Replaces the contents of \a target with the path converted to \c std::string. The capacity of \a target is reused.
+    void string_into(std::string& target) const
+    {
+        target.clear();
+        if (!m_pathname.empty())
+            detail::path_traits::convert(m_pathname.data(), m_pathname.data() + m_pathname.size(), target);
+    }
+    void string_into(std::string& target, codecvt_type const& cvt) const
+    {
+        target.clear();
+        if (!m_pathname.empty())
+            detail::path_traits::convert(m_pathname.data(), m_pathname.data() + m_pathname.size(), target, &cvt);
+    }
+
+    //! Replaces the contents of \a target with the path as \c std::wstring. The capacity of \a target is reused.
+    void wstring_into(std::wstring& target) const { target.assign(m_pathname); }
+    void wstring_into(std::wstring& target, codecvt_type const&) const { target.assign(m_pathname); }
 #else // BOOST_POSIX_API
     //  string_type is std::string, so there is no conversion
     std::string const& string() const { return m_pathname; }
@@ -897,17 +974,33 @@ public:
     std::wstring wstring() const
     {
         std::wstring tmp;
-        if (!m_pathname.empty())
-            detail::path_traits::convert(m_pathname.data(), m_pathname.data() + m_pathname.size(), tmp);
+        wstring_into(tmp);
         return tmp;
     }
     std::wstring wstring(codecvt_type const& cvt) const
     {
         std::wstring tmp;
-        if (!m_pathname.empty())
-            detail::path_traits::convert(m_pathname.data(), m_pathname.data() + m_pathname.size(), tmp, &cvt);
+        wstring_into(tmp, cvt);
         return tmp;
     }
+
+    //! Replaces the contents of \a target with the path as \c std::string. The capacity of \a target is reused.
+    void string_into(std::string& target) const { target.assign(m_pathname); }
+    void string_into(std::string& target, codecvt_type const&) const { target.assign(m_pathname); }
+
+    //! Replaces the contents of \a target with the path converted to \c std::wstring. The capacity of \a target is reused.
+    void wstring_into(std::wstring& target) const
+    {
+        target.clear();
+        if (!m_pathname.empty())
+            detail::path_traits::convert(m_pathname.data(), m_pathname.data() + m_pathname.size(), target);
+    }
+    void wstring_into(std::wstring& target, codecvt_type const& cvt) const
+    {
+        target.clear();
+        if (!m_pathname.empty())
+            detail::path_traits::convert(m_pathname.data(), m_pathname.data() + m_pathname.size(), target, &cvt);
+    }
 #endif
 
     //  -----  generic format observers  -----
@@ -1020,7 +1113,6 @@ public:
 
 #if !defined(BOOST_FILESYSTEM_NO_DEPRECATED)
     //  recently deprecated functions supplied by default
-    path& normalize();
     BOOST_FILESYSTEM_DETAIL_DEPRECATED("Use path::remove_filename() instead")
     path& remove_leaf() { return remove_filename(); }
     BOOST_FILESYSTEM_DETAIL_DEPRECATED("Use path::filename() instead")
@@ -1084,6 +1176,8 @@ private:
 
     BOOST_FILESYSTEM_DECL path lexically_normal_v3() const;
     BOOST_FILESYSTEM_DECL path lexically_normal_v4() const;
+    BOOST_FILESYSTEM_DECL void normalize_v3();
+    BOOST_FILESYSTEM_DECL void normalize_v4();
 
     BOOST_FILESYSTEM_DECL int compare_v3(path const& p) const;
     BOOST_FILESYSTEM_DECL int compare_v4(path const& p) const;
@@ -1091,6 +1185,12 @@ private:
     BOOST_FILESYSTEM_DECL void append_v3(const value_type* b, const value_type* e);
     BOOST_FILESYSTEM_DECL void append_v4(const value_type* b, const value_type* e);
 
+    BOOST_FILESYSTEM_DECL void replace_filename_v3(const value_type* b, const value_type* e);
+    BOOST_FILESYSTEM_DECL void replace_filename_v4(const value_type* b, const value_type* e);
+
+    BOOST_FILESYSTEM_DECL static void join_v3(path& result, const path* const* parts, std::size_t count);
+    BOOST_FILESYSTEM_DECL static void join_v4(path& result, const path* const* parts, std::size_t count);
+
     //  Returns: If separator is to be appended, m_pathname.size() before append. Otherwise 0.
     //  Note: An append is never performed if size()==0, so a returned 0 is unambiguous.
     BOOST_FILESYSTEM_DECL string_type::size_type append_separator_if_needed();
@@ -1122,6 +1222,8 @@ BOOST_FILESYSTEM_DECL int lex_compare_v3(path::iterator first1, path::iterator l
 BOOST_FILESYSTEM_DECL int lex_compare_v4(path::iterator first1, path::iterator last1, path::iterator first2, path::iterator last2);
 BOOST_FILESYSTEM_DECL path const& dot_path();
 BOOST_FILESYSTEM_DECL path const& dot_dot_path();
+//! Computes the hash of the path of \a size characters, which is equal for paths that differ only in the kind of directory separators
+BOOST_FILESYSTEM_DECL std::size_t hash_path(const path::value_type* str, std::size_t size) BOOST_NOEXCEPT;
 } // namespace detail
 
 #ifndef BOOST_FILESYSTEM_NO_DEPRECATED
@@ -1264,21 +1366,14 @@ BOOST_FORCEINLINE bool operator>=(path const& lhs, path const& rhs)
     return !(lhs < rhs);
 }
 
-// Note: Declared as a template to delay binding to Boost.ContainerHash functions and make the dependency optional
+// Note: Declared as a template to prevent implicit conversions of the argument to path
 template< typename T >
 inline typename boost::enable_if_c<
     boost::is_same< T, path >::value,
     std::size_t
 >::type hash_value(T const& p) BOOST_NOEXCEPT
 {
-#ifdef BOOST_WINDOWS_API
-    std::size_t seed = 0u;
-    for (typename T::value_type const* it = p.c_str(); *it; ++it)
-        hash_combine(seed, *it == L'/' ? L'\\' : *it);
-    return seed;
-#else // BOOST_POSIX_API
-    return hash_range(p.native().begin(), p.native().end());
-#endif
+    return detail::hash_path(p.c_str(), p.size());
 }
 
 inline void swap(path& lhs, path& rhs) BOOST_NOEXCEPT
@@ -1338,6 +1433,33 @@ BOOST_FILESYSTEM_DECL bool portable_directory_name(std::string const& name);
 BOOST_FILESYSTEM_DECL bool portable_file_name(std::string const& name);
 BOOST_FILESYSTEM_DECL bool native(std::string const& name);
 
+//! Naming rules that can be checked by \c check_name and \c check_names
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(name_rules, unsigned int)
+{
+    none = 0u,
+    native = 1u,                      // As checked by native()
+    portable_posix = 1u << 1,         // As checked by portable_posix_name()
+    windows = 1u << 2,                // As checked by windows_name()
+    portable = 1u << 3,               // As checked by portable_name()
+    portable_directory = 1u << 4,     // As checked by portable_directory_name()
+    portable_file = 1u << 5,          // As checked by portable_file_name()
+    no_windows_device_name = 1u << 6  // The name, without the extension, is not a reserved Windows device name, such as "CON", "NUL" or "COM1"
+}
+BOOST_SCOPED_ENUM_DECLARE_END(name_rules)
+
+BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(name_rules))
+
+//! Returns \c true if the name of \a size characters pointed to by \a name satisfies all of the \a rules. Does not allocate memory.
+BOOST_FILESYSTEM_DECL bool check_name(const char* name, std::size_t size, BOOST_SCOPED_ENUM_NATIVE(name_rules) rules) BOOST_NOEXCEPT;
+
+/*!
+ * Checks \a count names, where <tt>names[i]</tt> points to the name of <tt>sizes[i]</tt> characters, against all of the \a rules.
+ * Bit <tt>i % 64</tt> of <tt>failures[i / 64]</tt> is set if the name \c i does not satisfy the rules, and cleared otherwise;
+ * \a failures must point to <tt>(count + 63) / 64</tt> elements. Returns the number of names that do not satisfy the rules.
+ * Does not allocate memory.
+ */
+BOOST_FILESYSTEM_DECL std::size_t check_names(const char* const* names, const std::size_t* sizes, std::size_t count, BOOST_SCOPED_ENUM_NATIVE(name_rules) rules, boost::uint64_t* failures) BOOST_NOEXCEPT;
+
 namespace detail {
 
 //  For POSIX, is_directory_separator() and is_element_separator() are identical since
@@ -1428,18 +1550,6 @@ inline bool path::filename_is_dot_dot() const
     // to deal with "c:.." edge case on Windows when ':' acts as a separator
 }
 
-#if !defined(BOOST_FILESYSTEM_NO_DEPRECATED)
-
-BOOST_FILESYSTEM_DETAIL_DEPRECATED("Use path::lexically_normal() instead")
-inline path& path::normalize()
-{
-    path tmp(lexically_normal());
-    m_pathname.swap(tmp.m_pathname);
-    return *this;
-}
-
-#endif // !defined(BOOST_FILESYSTEM_NO_DEPRECATED)
-
 //--------------------------------------------------------------------------------------//
 //                     class path member template specializations                       //
 //--------------------------------------------------------------------------------------//
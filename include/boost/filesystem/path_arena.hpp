@@ -0,0 +1,161 @@
+//  boost/filesystem/path_arena.hpp  ---------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_PATH_ARENA_HPP
+#define BOOST_FILESYSTEM_PATH_ARENA_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path_view.hpp>
+#include <cstddef>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                                class path_arena                                    //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! Monotonic storage for path strings
+/*!
+ * The arena copies path strings into large memory blocks and returns views to the stored copies.
+ * Memory is only released all at once, when \c release is called or the arena is destroyed, which
+ * invalidates all views returned by the arena. This allows to store a large number of paths, such as
+ * a listing of a large directory, without allocating memory for each path individually.
+ *
+ * The arena is not thread-safe.
+ */
+class path_arena
+{
+public:
+    typedef path_view::value_type value_type;
+    typedef std::size_t size_type;
+
+    //! Default size of memory blocks allocated by the arena, in bytes
+    BOOST_STATIC_CONSTEXPR size_type default_block_size = 65536u;
+
+public:
+    path_arena() BOOST_NOEXCEPT :
+        m_block(NULL),
+        m_pos(0u),
+        m_capacity(0u),
+        m_block_size(default_block_size),
+        m_allocated_size(0u)
+    {
+    }
+
+    //! Constructs the arena that allocates memory blocks of the specified size, in bytes
+    explicit path_arena(size_type block_size) BOOST_NOEXCEPT :
+        m_block(NULL),
+        m_pos(0u),
+        m_capacity(0u),
+        m_block_size(block_size),
+        m_allocated_size(0u)
+    {
+    }
+
+    ~path_arena() BOOST_NOEXCEPT { release(); }
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    path_arena(path_arena&& that) BOOST_NOEXCEPT :
+        m_block(that.m_block),
+        m_pos(that.m_pos),
+        m_capacity(that.m_capacity),
+        m_block_size(that.m_block_size),
+        m_allocated_size(that.m_allocated_size)
+    {
+        that.m_block = NULL;
+        that.m_pos = 0u;
+        that.m_capacity = 0u;
+        that.m_allocated_size = 0u;
+    }
+
+    path_arena& operator=(path_arena&& that) BOOST_NOEXCEPT
+    {
+        if (BOOST_LIKELY(this != &that))
+        {
+            release();
+            m_block = that.m_block;
+            m_pos = that.m_pos;
+            m_capacity = that.m_capacity;
+            m_block_size = that.m_block_size;
+            m_allocated_size = that.m_allocated_size;
+            that.m_block = NULL;
+            that.m_pos = 0u;
+            that.m_capacity = 0u;
+            that.m_allocated_size = 0u;
+        }
+        return *this;
+    }
+#endif
+
+    BOOST_DELETED_FUNCTION(path_arena(path_arena const&))
+    BOOST_DELETED_FUNCTION(path_arena& operator=(path_arena const&))
+
+public:
+    //! Copies the path into the arena and returns a view to the null-terminated copy. Throws \c std::bad_alloc on memory allocation failure.
+    BOOST_FILESYSTEM_DECL path_view store(path_view const& p);
+
+    //! Releases all memory allocated by the arena
+    BOOST_FILESYSTEM_DECL void release() BOOST_NOEXCEPT;
+
+    //! Returns the total size of memory blocks allocated by the arena, in bytes
+    size_type allocated_size() const BOOST_NOEXCEPT { return m_allocated_size; }
+
+    //! Returns the size of memory blocks allocated by the arena, in bytes
+    size_type block_size() const BOOST_NOEXCEPT { return m_block_size; }
+
+    //! Swaps the contents of two arenas
+    void swap(path_arena& that) BOOST_NOEXCEPT
+    {
+        block* b = m_block;
+        m_block = that.m_block;
+        that.m_block = b;
+        size_type n = m_pos;
+        m_pos = that.m_pos;
+        that.m_pos = n;
+        n = m_capacity;
+        m_capacity = that.m_capacity;
+        that.m_capacity = n;
+        n = m_block_size;
+        m_block_size = that.m_block_size;
+        that.m_block_size = n;
+        n = m_allocated_size;
+        m_allocated_size = that.m_allocated_size;
+        that.m_allocated_size = n;
+    }
+
+    friend void swap(path_arena& left, path_arena& right) BOOST_NOEXCEPT { left.swap(right); }
+
+private:
+    struct block;
+
+    //! The current block, which is the head of the list of allocated blocks
+    block* m_block;
+    //! Number of characters used in the current block
+    size_type m_pos;
+    //! Capacity of the current block, in characters
+    size_type m_capacity;
+    //! Size of allocated memory blocks, in bytes
+    size_type m_block_size;
+    //! Total size of allocated memory blocks, in bytes
+    size_type m_allocated_size;
+};
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_PATH_ARENA_HPP
@@ -0,0 +1,101 @@
+//  boost/filesystem/path_key.hpp  -----------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_PATH_KEY_HPP
+#define BOOST_FILESYSTEM_PATH_KEY_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/path_view.hpp>
+#include <cstddef>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                                  class path_key                                    //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! A key for ordered and unordered containers of paths
+/*!
+ * The key stores the elements of the path, as produced by Boost.Filesystem v4 \c path iteration,
+ * separated by null characters, and the hash of the path. Keys compare the same way as the paths
+ * they were constructed from, but the comparison is a single string comparison. Keys of equal paths
+ * have equal hashes, which are computed on construction.
+ *
+ * Redundant separators and the format of the root directory are not preserved in the key.
+ */
+class path_key
+{
+public:
+    typedef path::value_type value_type;
+    typedef path::string_type string_type;
+
+public:
+    path_key() BOOST_NOEXCEPT : m_hash(0u) {}
+    explicit path_key(path_view const& p) : m_hash(0u) { init(p); }
+
+    //! Returns the hash of the key
+    std::size_t hash() const BOOST_NOEXCEPT { return m_hash; }
+
+    //! Returns \c true if the key was constructed from an empty path
+    bool empty() const BOOST_NOEXCEPT { return m_key.empty(); }
+
+    //! Composes the path from the elements stored in the key
+    BOOST_FILESYSTEM_DECL path to_path() const;
+
+    //! Compares the keys, with the same result as comparing the original paths
+    int compare(path_key const& that) const BOOST_NOEXCEPT
+    {
+        const std::size_t size = m_key.size() < that.m_key.size() ? m_key.size() : that.m_key.size();
+        int res = string_type::traits_type::compare(m_key.data(), that.m_key.data(), size);
+        if (res == 0)
+            return m_key.size() < that.m_key.size() ? -1 : static_cast< int >(m_key.size() > that.m_key.size());
+        return res;
+    }
+
+    friend bool operator==(path_key const& left, path_key const& right) BOOST_NOEXCEPT { return left.m_hash == right.m_hash && left.m_key == right.m_key; }
+    friend bool operator!=(path_key const& left, path_key const& right) BOOST_NOEXCEPT { return !(left == right); }
+    friend bool operator<(path_key const& left, path_key const& right) BOOST_NOEXCEPT { return left.compare(right) < 0; }
+    friend bool operator<=(path_key const& left, path_key const& right) BOOST_NOEXCEPT { return left.compare(right) <= 0; }
+    friend bool operator>(path_key const& left, path_key const& right) BOOST_NOEXCEPT { return left.compare(right) > 0; }
+    friend bool operator>=(path_key const& left, path_key const& right) BOOST_NOEXCEPT { return left.compare(right) >= 0; }
+
+    friend std::size_t hash_value(path_key const& key) BOOST_NOEXCEPT { return key.m_hash; }
+
+    friend void swap(path_key& left, path_key& right) BOOST_NOEXCEPT
+    {
+        left.m_key.swap(right.m_key);
+        std::size_t hash = left.m_hash;
+        left.m_hash = right.m_hash;
+        right.m_hash = hash;
+    }
+
+private:
+    BOOST_FILESYSTEM_DECL void init(path_view const& p);
+
+private:
+    //! Path elements, separated by null characters
+    string_type m_key;
+    //! Hash of m_key
+    std::size_t m_hash;
+};
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_PATH_KEY_HPP
@@ -0,0 +1,416 @@
+//  boost/filesystem/path_map.hpp  -----------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_PATH_MAP_HPP
+#define BOOST_FILESYSTEM_PATH_MAP_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/path_view.hpp>
+#include <boost/filesystem/path_arena.hpp>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/assert.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/is_const.hpp>
+#include <boost/core/enable_if.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+template< typename T >
+class path_map;
+
+namespace detail {
+
+//! Node of the path trie. Each node represents a path element of the path composed of the elements of its parent nodes.
+struct path_trie_node
+{
+    //! Parent node, or \c NULL if the element is the first element of the path
+    path_trie_node* parent;
+    //! First child node
+    path_trie_node* first_child;
+    //! Next and previous nodes with the same parent
+    path_trie_node* next_sibling;
+    path_trie_node* prev_sibling;
+    //! Next node in the hash table bucket, or in the list of free nodes
+    path_trie_node* next;
+    //! Element string, stored in the trie
+    const path::value_type* element;
+    //! Hash of the path, up to and including this element
+    std::size_t hash;
+    //! Element size
+    boost::uint32_t element_size;
+    //! Number of elements in the path, up to and including this element
+    boost::uint32_t depth;
+    //! Indicates whether the node holds a value
+    bool has_value;
+};
+
+//! Untyped part of \c path_map, which maintains the trie. The storage for values is allocated after each node.
+class path_trie
+{
+public:
+    //! Constructs the trie, which allocates nodes of \a node_size bytes
+    BOOST_FILESYSTEM_DECL explicit path_trie(std::size_t node_size) BOOST_NOEXCEPT;
+    //! Releases memory. The values must have been destroyed.
+    ~path_trie() BOOST_NOEXCEPT { clear(); }
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    BOOST_FILESYSTEM_DECL path_trie(path_trie&& that) BOOST_NOEXCEPT;
+#endif
+
+    BOOST_DELETED_FUNCTION(path_trie(path_trie const&))
+    BOOST_DELETED_FUNCTION(path_trie& operator=(path_trie const&))
+
+public:
+    //! Returns the node of the path, or \c NULL if there is none. The node may not hold a value.
+    BOOST_FILESYSTEM_DECL path_trie_node* find(path_view const& p) const BOOST_NOEXCEPT;
+    //! Returns the node of the path, inserting the missing nodes. Returns \c NULL if \a p is empty. Throws \c std::bad_alloc on memory allocation failure.
+    BOOST_FILESYSTEM_DECL path_trie_node* insert(path_view const& p);
+    //! Returns the deepest node holding a value whose path is a prefix of \a p, in terms of path elements, or \c NULL if there is none
+    BOOST_FILESYSTEM_DECL path_trie_node* longest_prefix(path_view const& p) const BOOST_NOEXCEPT;
+
+    //! Removes the node and its ancestors that hold no values and have no children. The value of \a node must have been destroyed.
+    BOOST_FILESYSTEM_DECL void prune(path_trie_node* node) BOOST_NOEXCEPT;
+    //! Removes the node with all its descendants. The values of the removed nodes must have been destroyed.
+    BOOST_FILESYSTEM_DECL void remove_subtree(path_trie_node* node) BOOST_NOEXCEPT;
+    //! Releases all nodes. The values must have been destroyed.
+    BOOST_FILESYSTEM_DECL void clear() BOOST_NOEXCEPT;
+
+    //! Returns the first node holding a value in the trie, in pre-order, or \c NULL if there is none
+    path_trie_node* first() const BOOST_NOEXCEPT { return m_first_root ? first_in_subtree(m_first_root, NULL) : NULL; }
+    //! Returns \a node if it holds a value, or the next node holding a value in pre-order within the subtree of \a root, or \c NULL if there is none
+    BOOST_FILESYSTEM_DECL static path_trie_node* first_in_subtree(path_trie_node* node, const path_trie_node* root) BOOST_NOEXCEPT;
+    //! Returns the next node holding a value after \a node in pre-order within the subtree of \a root, or \c NULL if there is none
+    BOOST_FILESYSTEM_DECL static path_trie_node* next(path_trie_node* node, const path_trie_node* root) BOOST_NOEXCEPT;
+    //! Composes the path from the elements of the node and its parents
+    BOOST_FILESYSTEM_DECL static path to_path(const path_trie_node* node);
+
+    //! Returns the amount of memory allocated by the trie, in bytes
+    BOOST_FILESYSTEM_DECL std::size_t allocated_size() const BOOST_NOEXCEPT;
+
+    BOOST_FILESYSTEM_DECL void swap(path_trie& that) BOOST_NOEXCEPT;
+
+private:
+    path_trie_node* find_child(const path_trie_node* parent, path_view const& element, std::size_t hash) const BOOST_NOEXCEPT;
+    path_trie_node* insert_child(path_trie_node* parent, path_view const& element, std::size_t hash);
+    void unlink(path_trie_node* node) BOOST_NOEXCEPT;
+    void rehash(std::size_t bucket_count);
+
+private:
+    //! Size of a node with the value storage, in bytes
+    std::size_t m_node_size;
+    //! Storage for element strings
+    path_arena m_strings;
+    //! Blocks of allocated nodes
+    std::vector< void* > m_node_blocks;
+    //! Number of used nodes in the last block
+    std::size_t m_node_block_pos;
+    //! Number of nodes in the trie
+    std::size_t m_node_count;
+    //! List of removed nodes available for reuse
+    path_trie_node* m_free_nodes;
+    //! First node without a parent
+    path_trie_node* m_first_root;
+    //! Hash table buckets, the number of buckets is a power of 2
+    std::vector< path_trie_node* > m_buckets;
+};
+
+//! Node of \c path_map with the value storage
+template< typename T >
+struct path_map_node
+{
+    path_trie_node base;
+    typename boost::aligned_storage< sizeof(T), boost::alignment_of< T >::value >::type storage;
+
+    static T* value(path_trie_node* node) BOOST_NOEXCEPT
+    {
+        return static_cast< T* >(static_cast< void* >(&reinterpret_cast< path_map_node* >(node)->storage));
+    }
+};
+
+//! Iterator over the values of \c path_map
+template< typename T, typename Value >
+class path_map_iterator :
+    public boost::iterator_facade<
+        path_map_iterator< T, Value >,
+        Value,
+        boost::forward_traversal_tag
+    >
+{
+    friend class boost::iterator_core_access;
+    friend class boost::filesystem::path_map< T >;
+    template< typename, typename >
+    friend class path_map_iterator;
+
+public:
+    path_map_iterator() BOOST_NOEXCEPT : m_node(NULL), m_root(NULL) {}
+
+    //! Conversion from non-const iterator to const iterator
+    template< typename U >
+    path_map_iterator(path_map_iterator< T, U > const& that, typename boost::enable_if_c< boost::is_const< Value >::value && !boost::is_const< U >::value, int >::type = 0) BOOST_NOEXCEPT :
+        m_node(that.m_node),
+        m_root(that.m_root)
+    {
+    }
+
+    //! Returns the path of the value
+    path key() const { return path_trie::to_path(m_node); }
+
+    //! Returns the number of elements in the path of the value
+    std::size_t depth() const BOOST_NOEXCEPT { return m_node->depth; }
+
+private:
+    path_map_iterator(path_trie_node* node, const path_trie_node* root) BOOST_NOEXCEPT : m_node(node), m_root(root) {}
+
+    Value& dereference() const BOOST_NOEXCEPT { return *path_map_node< T >::value(m_node); }
+
+    template< typename U >
+    bool equal(path_map_iterator< T, U > const& that) const BOOST_NOEXCEPT { return m_node == that.m_node; }
+
+    void increment() BOOST_NOEXCEPT { m_node = path_trie::next(m_node, m_root); }
+
+private:
+    //! Current node, \c NULL for the end iterator
+    path_trie_node* m_node;
+    //! Root of the iterated subtree, \c NULL if iterating over the whole map
+    const path_trie_node* m_root;
+};
+
+} // namespace detail
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                                  class path_map                                    //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! An associative container of paths, organized as a trie of path elements
+/*!
+ * The map stores every distinct path element once per parent path, and lookup, insertion and removal take time
+ * proportional to the number of elements in the path, regardless of the number of paths in the map. In addition
+ * to exact lookup, the map finds the longest stored prefix of a path, e.g. the mount point or the rule that applies
+ * to the path, and iterates over the values of all paths in a subtree. Paths are split into elements with
+ * Boost.Filesystem v4 semantics, like in \c path_pool, so paths that compare equal are mapped to the same value.
+ *
+ * Nodes and element strings are allocated in large blocks. Memory of removed nodes is reused by the map, and
+ * all memory is only released when the map is cleared or destroyed. Iteration is performed in pre-order, where
+ * every path is visited before the paths it is a prefix of, but the order of sibling paths is unspecified.
+ * Insertion does not invalidate iterators and references to values, removal only invalidates the iterators
+ * and references to the removed values.
+ *
+ * The map is not thread-safe. Values with alignment greater than that of the fundamental types are not supported.
+ */
+template< typename T >
+class path_map
+{
+public:
+    typedef T mapped_type;
+    typedef T value_type;
+    typedef T& reference;
+    typedef T const& const_reference;
+    typedef std::size_t size_type;
+    typedef detail::path_map_iterator< T, T > iterator;
+    typedef detail::path_map_iterator< T, const T > const_iterator;
+
+public:
+    path_map() BOOST_NOEXCEPT : m_trie(sizeof(detail::path_map_node< T >)), m_size(0u) {}
+    ~path_map() BOOST_NOEXCEPT { destroy_values(); }
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    path_map(path_map&& that) BOOST_NOEXCEPT :
+        m_trie(static_cast< detail::path_trie&& >(that.m_trie)),
+        m_size(that.m_size)
+    {
+        that.m_size = 0u;
+    }
+
+    path_map& operator=(path_map&& that) BOOST_NOEXCEPT
+    {
+        if (BOOST_LIKELY(this != &that))
+        {
+            clear();
+            swap(that);
+        }
+        return *this;
+    }
+#endif
+
+    BOOST_DELETED_FUNCTION(path_map(path_map const&))
+    BOOST_DELETED_FUNCTION(path_map& operator=(path_map const&))
+
+public:
+    iterator begin() BOOST_NOEXCEPT { return iterator(m_trie.first(), NULL); }
+    iterator end() BOOST_NOEXCEPT { return iterator(); }
+    const_iterator begin() const BOOST_NOEXCEPT { return const_iterator(m_trie.first(), NULL); }
+    const_iterator end() const BOOST_NOEXCEPT { return const_iterator(); }
+
+    //! Returns \c true if the map contains no values
+    bool empty() const BOOST_NOEXCEPT { return m_size == 0u; }
+    //! Returns the number of values in the map
+    size_type size() const BOOST_NOEXCEPT { return m_size; }
+
+    //! Returns the amount of memory allocated by the map, in bytes
+    std::size_t allocated_size() const BOOST_NOEXCEPT { return m_trie.allocated_size(); }
+
+    //! Inserts \a value for the path \a p, unless the path is already in the map
+    /*!
+     * Returns the iterator to the value of \a p and \c true if the value was inserted. Empty paths cannot be inserted,
+     * in which case the end iterator and \c false are returned.
+     */
+    std::pair< iterator, bool > insert(path_view const& p, T const& value)
+    {
+        detail::path_trie_node* node = m_trie.insert(p);
+        if (BOOST_UNLIKELY(node == NULL))
+            return std::pair< iterator, bool >(end(), false);
+        if (node->has_value)
+            return std::pair< iterator, bool >(iterator(node, NULL), false);
+
+        construct(node, value);
+        return std::pair< iterator, bool >(iterator(node, NULL), true);
+    }
+
+    //! Returns the value for the path \a p, inserting a default-constructed value if the path is not in the map. \a p must not be empty.
+    T& operator[](path_view const& p)
+    {
+        detail::path_trie_node* node = m_trie.insert(p);
+        BOOST_ASSERT_MSG(node != NULL, "boost::filesystem::path_map: empty path cannot be inserted");
+        if (!node->has_value)
+            construct(node, T());
+        return *detail::path_map_node< T >::value(node);
+    }
+
+    //! Returns the iterator to the value of the path \a p, or the end iterator if the path is not in the map
+    iterator find(path_view const& p) BOOST_NOEXCEPT { return iterator(find_node(p), NULL); }
+    const_iterator find(path_view const& p) const BOOST_NOEXCEPT { return const_iterator(find_node(p), NULL); }
+
+    //! Returns \c 1 if the path \a p is in the map and \c 0 otherwise
+    size_type count(path_view const& p) const BOOST_NOEXCEPT { return find_node(p) != NULL; }
+
+    //! Returns the iterator to the value of the longest path in the map that is a prefix of \a p, or the end iterator if there is none
+    /*!
+     * The prefix is determined in terms of path elements, so "/usr/lib" is a prefix of "/usr/lib/x" and "/usr/lib", but not of "/usr/library".
+     */
+    iterator longest_prefix(path_view const& p) BOOST_NOEXCEPT { return iterator(m_trie.longest_prefix(p), NULL); }
+    const_iterator longest_prefix(path_view const& p) const BOOST_NOEXCEPT { return const_iterator(m_trie.longest_prefix(p), NULL); }
+
+    //! Returns the range of values of the path \a p and all paths \a p is a prefix of. The path \a p itself is not required to be in the map.
+    std::pair< iterator, iterator > subtree(path_view const& p) BOOST_NOEXCEPT
+    {
+        detail::path_trie_node* root = m_trie.find(p);
+        return std::pair< iterator, iterator >(iterator(root ? detail::path_trie::first_in_subtree(root, root) : NULL, root), iterator());
+    }
+    std::pair< const_iterator, const_iterator > subtree(path_view const& p) const BOOST_NOEXCEPT
+    {
+        detail::path_trie_node* root = m_trie.find(p);
+        return std::pair< const_iterator, const_iterator >(const_iterator(root ? detail::path_trie::first_in_subtree(root, root) : NULL, root), const_iterator());
+    }
+
+    //! Removes the value of the path \a p. Returns the number of removed values.
+    size_type erase(path_view const& p) BOOST_NOEXCEPT
+    {
+        detail::path_trie_node* node = find_node(p);
+        if (!node)
+            return 0u;
+
+        destroy(node);
+        m_trie.prune(node);
+        return 1u;
+    }
+
+    //! Removes the values of the path \a p and all paths \a p is a prefix of. Returns the number of removed values.
+    size_type erase_subtree(path_view const& p) BOOST_NOEXCEPT
+    {
+        detail::path_trie_node* root = m_trie.find(p);
+        if (!root)
+            return 0u;
+
+        const size_type size = m_size;
+        for (detail::path_trie_node* node = detail::path_trie::first_in_subtree(root, root); node != NULL; node = detail::path_trie::next(node, root))
+            destroy(node);
+        m_trie.remove_subtree(root);
+        return size - m_size;
+    }
+
+    //! Removes all values and releases memory
+    void clear() BOOST_NOEXCEPT
+    {
+        destroy_values();
+        m_trie.clear();
+    }
+
+    void swap(path_map& that) BOOST_NOEXCEPT
+    {
+        m_trie.swap(that.m_trie);
+        const size_type size = m_size;
+        m_size = that.m_size;
+        that.m_size = size;
+    }
+
+    friend void swap(path_map& left, path_map& right) BOOST_NOEXCEPT { left.swap(right); }
+
+private:
+    detail::path_trie_node* find_node(path_view const& p) const BOOST_NOEXCEPT
+    {
+        detail::path_trie_node* node = m_trie.find(p);
+        return node && node->has_value ? node : NULL;
+    }
+
+    void construct(detail::path_trie_node* node, T const& value)
+    {
+        try
+        {
+            new (detail::path_map_node< T >::value(node)) T(value);
+        }
+        catch (...)
+        {
+            // Remove the nodes that were inserted for the value
+            m_trie.prune(node);
+            throw;
+        }
+
+        node->has_value = true;
+        ++m_size;
+    }
+
+    void destroy(detail::path_trie_node* node) BOOST_NOEXCEPT
+    {
+        detail::path_map_node< T >::value(node)->~T();
+        node->has_value = false;
+        --m_size;
+    }
+
+    void destroy_values() BOOST_NOEXCEPT
+    {
+        for (detail::path_trie_node* node = m_trie.first(); node != NULL; node = detail::path_trie::next(node, NULL))
+            destroy(node);
+    }
+
+private:
+    detail::path_trie m_trie;
+    //! Number of values in the map
+    size_type m_size;
+};
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_PATH_MAP_HPP
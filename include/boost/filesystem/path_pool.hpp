@@ -0,0 +1,161 @@
+//  boost/filesystem/path_pool.hpp  ----------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_PATH_POOL_HPP
+#define BOOST_FILESYSTEM_PATH_POOL_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/path_view.hpp>
+#include <boost/filesystem/path_arena.hpp>
+#include <cstddef>
+#include <boost/cstdint.hpp>
+#include <vector>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+class path_pool;
+
+namespace detail {
+
+//! Node of the interned path tree. Each node represents a path element and refers to the node of its parent path.
+struct path_pool_node
+{
+    //! Parent path node, or \c NULL if the element is the first element of the path
+    const path_pool_node* parent;
+    //! Next node in the hash table bucket
+    path_pool_node* next;
+    //! Element string, stored in the pool
+    const path::value_type* element;
+    //! Hash of the path, up to and including this element
+    std::size_t hash;
+    //! Element size
+    boost::uint32_t element_size;
+    //! Number of elements in the path, up to and including this element
+    boost::uint32_t depth;
+};
+
+} // namespace detail
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                               class interned_path                                  //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! A handle of a path stored in a \c path_pool
+/*!
+ * Interned paths obtained from the same pool compare equal if and only if the paths they were interned from
+ * compare equal, and the comparison is performed in constant time. The hash of the path is computed on
+ * interning and cached. Comparing interned paths obtained from different pools is not meaningful.
+ */
+class interned_path
+{
+    friend class path_pool;
+
+public:
+    BOOST_CONSTEXPR interned_path() BOOST_NOEXCEPT : m_node(NULL) {}
+
+    //! Returns \c true if the path is empty
+    bool empty() const BOOST_NOEXCEPT { return m_node == NULL; }
+
+    //! Returns the cached hash of the path
+    std::size_t hash() const BOOST_NOEXCEPT { return m_node ? m_node->hash : 0u; }
+
+    //! Returns the number of path elements
+    std::size_t depth() const BOOST_NOEXCEPT { return m_node ? m_node->depth : 0u; }
+
+    //! Returns the path without the last element
+    interned_path parent_path() const BOOST_NOEXCEPT { return interned_path(m_node ? m_node->parent : NULL); }
+
+    //! Returns the last path element. The root directory is presented in the generic format.
+    path_view element() const BOOST_NOEXCEPT { return m_node ? path_view(m_node->element, m_node->element_size) : path_view(); }
+
+    //! Composes the path from its elements
+    BOOST_FILESYSTEM_DECL path to_path() const;
+
+    friend bool operator==(interned_path const& left, interned_path const& right) BOOST_NOEXCEPT { return left.m_node == right.m_node; }
+    friend bool operator!=(interned_path const& left, interned_path const& right) BOOST_NOEXCEPT { return left.m_node != right.m_node; }
+    friend std::size_t hash_value(interned_path const& p) BOOST_NOEXCEPT { return p.hash(); }
+
+private:
+    explicit interned_path(const detail::path_pool_node* node) BOOST_NOEXCEPT : m_node(node) {}
+
+private:
+    const detail::path_pool_node* m_node;
+};
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                                 class path_pool                                    //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! Storage of interned paths
+/*!
+ * The pool stores every distinct path element once per parent path, so paths with common prefixes share storage
+ * for the prefixes. Paths are split into elements with Boost.Filesystem v4 semantics, and paths that compare equal
+ * are interned to the same \c interned_path. Interned paths remain valid until the pool is cleared or destroyed.
+ *
+ * The pool is not thread-safe.
+ */
+class path_pool
+{
+public:
+    BOOST_FILESYSTEM_DECL path_pool();
+    BOOST_FILESYSTEM_DECL ~path_pool();
+
+    BOOST_DELETED_FUNCTION(path_pool(path_pool const&))
+    BOOST_DELETED_FUNCTION(path_pool& operator=(path_pool const&))
+
+public:
+    //! Interns the path. Throws \c std::bad_alloc on memory allocation failure.
+    BOOST_FILESYSTEM_DECL interned_path intern(path_view const& p);
+
+    //! Looks up the path without interning it. Returns an empty interned path if \a p is not in the pool.
+    BOOST_FILESYSTEM_DECL interned_path find(path_view const& p) const BOOST_NOEXCEPT;
+
+    //! Returns the number of path elements stored in the pool
+    std::size_t node_count() const BOOST_NOEXCEPT { return m_node_count; }
+
+    //! Returns the amount of memory allocated by the pool, in bytes
+    BOOST_FILESYSTEM_DECL std::size_t allocated_size() const BOOST_NOEXCEPT;
+
+    //! Removes all paths from the pool and releases memory. Invalidates all interned paths obtained from the pool.
+    BOOST_FILESYSTEM_DECL void clear() BOOST_NOEXCEPT;
+
+private:
+    const detail::path_pool_node* find_node(const detail::path_pool_node* parent, path_view const& element, std::size_t hash) const BOOST_NOEXCEPT;
+    const detail::path_pool_node* insert_node(const detail::path_pool_node* parent, path_view const& element, std::size_t hash);
+    void rehash(std::size_t bucket_count);
+
+private:
+    //! Storage for element strings
+    path_arena m_strings;
+    //! Blocks of allocated nodes
+    std::vector< detail::path_pool_node* > m_node_blocks;
+    //! Number of used nodes in the last block
+    std::size_t m_node_block_pos;
+    //! Total number of nodes
+    std::size_t m_node_count;
+    //! Hash table buckets, the number of buckets is a power of 2
+    std::vector< detail::path_pool_node* > m_buckets;
+};
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_PATH_POOL_HPP
@@ -0,0 +1,228 @@
+//  boost/filesystem/path_view.hpp  ----------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_PATH_VIEW_HPP
+#define BOOST_FILESYSTEM_PATH_VIEW_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/detail/path_traits.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/iterator/iterator_categories.hpp>
+#include <boost/core/enable_if.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <cstddef>
+#include <string>
+#if !defined(BOOST_NO_CXX17_HDR_STRING_VIEW)
+#include <string_view>
+#endif
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                                class path_view                                     //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! A non-owning reference to a path in the native format
+/*!
+ * The view refers to a sequence of native path characters, which is not necessarily null-terminated,
+ * and provides path decomposition and element iteration without allocating memory. The decomposition
+ * follows the semantics of Boost.Filesystem v4 \c path, regardless of \c BOOST_FILESYSTEM_VERSION.
+ * The referenced characters must stay valid and unmodified for the duration of use of the view.
+ *
+ * \c path_view is a path source, which means \c path can be constructed from, assigned and appended
+ * with it, and it can be passed to operations that accept paths.
+ */
+class path_view
+{
+public:
+    typedef path::value_type value_type;
+    typedef path::string_type string_type;
+    typedef std::size_t size_type;
+
+    class iterator;
+    typedef iterator const_iterator;
+
+public:
+    BOOST_CONSTEXPR path_view() BOOST_NOEXCEPT : m_data(NULL), m_size(0u) {}
+    path_view(const value_type* s) BOOST_NOEXCEPT : m_data(s), m_size(string_type::traits_type::length(s)) {}
+    BOOST_CONSTEXPR path_view(const value_type* s, size_type size) BOOST_NOEXCEPT : m_data(s), m_size(size) {}
+    path_view(path const& p) BOOST_NOEXCEPT : m_data(p.c_str()), m_size(p.size()) {}
+    path_view(string_type const& s) BOOST_NOEXCEPT : m_data(s.c_str()), m_size(s.size()) {}
+#if !defined(BOOST_NO_CXX17_HDR_STRING_VIEW)
+    BOOST_CONSTEXPR path_view(std::basic_string_view< value_type > s) BOOST_NOEXCEPT : m_data(s.data()), m_size(s.size()) {}
+#endif
+
+    //  -----  observers  -----
+
+    BOOST_CONSTEXPR const value_type* data() const BOOST_NOEXCEPT { return m_data; }
+    BOOST_CONSTEXPR size_type size() const BOOST_NOEXCEPT { return m_size; }
+    BOOST_CONSTEXPR bool empty() const BOOST_NOEXCEPT { return m_size == 0u; }
+
+    //! Returns a copy of the referenced characters
+    string_type native() const { return m_size > 0u ? string_type(m_data, m_size) : string_type(); }
+
+    //  -----  compare  -----
+
+    //! Compares the views element-wise, same as \c path::compare
+    BOOST_FILESYSTEM_DECL int compare(path_view const& p) const BOOST_NOEXCEPT;
+
+    //  -----  decomposition  -----
+
+    BOOST_FILESYSTEM_DECL path_view root_name() const BOOST_NOEXCEPT;
+    BOOST_FILESYSTEM_DECL path_view root_directory() const BOOST_NOEXCEPT;
+    BOOST_FILESYSTEM_DECL path_view root_path() const BOOST_NOEXCEPT;
+    BOOST_FILESYSTEM_DECL path_view relative_path() const BOOST_NOEXCEPT;
+    BOOST_FILESYSTEM_DECL path_view parent_path() const BOOST_NOEXCEPT;
+    BOOST_FILESYSTEM_DECL path_view filename() const BOOST_NOEXCEPT;
+    BOOST_FILESYSTEM_DECL path_view stem() const BOOST_NOEXCEPT;
+    BOOST_FILESYSTEM_DECL path_view extension() const BOOST_NOEXCEPT;
+
+    //  -----  query  -----
+
+    bool has_root_name() const BOOST_NOEXCEPT { return !root_name().empty(); }
+    bool has_root_directory() const BOOST_NOEXCEPT { return !root_directory().empty(); }
+    bool has_root_path() const BOOST_NOEXCEPT { return !root_path().empty(); }
+    bool has_relative_path() const BOOST_NOEXCEPT { return !relative_path().empty(); }
+    bool has_parent_path() const BOOST_NOEXCEPT { return !parent_path().empty(); }
+    bool has_filename() const BOOST_NOEXCEPT { return !filename().empty(); }
+    bool has_stem() const BOOST_NOEXCEPT { return !stem().empty(); }
+    bool has_extension() const BOOST_NOEXCEPT { return !extension().empty(); }
+    bool is_relative() const BOOST_NOEXCEPT { return !is_absolute(); }
+    bool is_absolute() const BOOST_NOEXCEPT
+    {
+        // Windows CE has no root name (aka drive letters)
+#if defined(BOOST_WINDOWS_API) && !defined(UNDER_CE)
+        return has_root_name() && has_root_directory();
+#else
+        return has_root_directory();
+#endif
+    }
+
+    bool filename_is_dot() const BOOST_NOEXCEPT
+    {
+        path_view name(filename());
+        return name.m_size == 1u && name.m_data[0] == path::dot;
+    }
+
+    bool filename_is_dot_dot() const BOOST_NOEXCEPT
+    {
+        path_view name(filename());
+        return name.m_size == 2u && name.m_data[0] == path::dot && name.m_data[1] == path::dot;
+    }
+
+    //  -----  iterators  -----
+
+    BOOST_FILESYSTEM_DECL iterator begin() const BOOST_NOEXCEPT;
+    iterator end() const BOOST_NOEXCEPT;
+
+    //  -----  comparison  -----
+
+    friend bool operator==(path_view const& lhs, path_view const& rhs) BOOST_NOEXCEPT { return lhs.compare(rhs) == 0; }
+    friend bool operator!=(path_view const& lhs, path_view const& rhs) BOOST_NOEXCEPT { return lhs.compare(rhs) != 0; }
+    friend bool operator<(path_view const& lhs, path_view const& rhs) BOOST_NOEXCEPT { return lhs.compare(rhs) < 0; }
+    friend bool operator<=(path_view const& lhs, path_view const& rhs) BOOST_NOEXCEPT { return lhs.compare(rhs) <= 0; }
+    friend bool operator>(path_view const& lhs, path_view const& rhs) BOOST_NOEXCEPT { return lhs.compare(rhs) > 0; }
+    friend bool operator>=(path_view const& lhs, path_view const& rhs) BOOST_NOEXCEPT { return lhs.compare(rhs) >= 0; }
+
+    // Comparison with path is declared as templates to avoid ambiguity with path comparison operators for other argument types
+#define BOOST_FILESYSTEM_DETAIL_PATH_VIEW_COMPARISON(op)\
+    template< typename Path >\
+    friend typename boost::enable_if_c< boost::is_same< Path, path >::value, bool >::type\
+    operator op(path_view const& lhs, Path const& rhs) BOOST_NOEXCEPT { return lhs.compare(path_view(rhs)) op 0; }\
+    template< typename Path >\
+    friend typename boost::enable_if_c< boost::is_same< Path, path >::value, bool >::type\
+    operator op(Path const& lhs, path_view const& rhs) BOOST_NOEXCEPT { return path_view(lhs).compare(rhs) op 0; }
+
+    BOOST_FILESYSTEM_DETAIL_PATH_VIEW_COMPARISON(==)
+    BOOST_FILESYSTEM_DETAIL_PATH_VIEW_COMPARISON(!=)
+    BOOST_FILESYSTEM_DETAIL_PATH_VIEW_COMPARISON(<)
+    BOOST_FILESYSTEM_DETAIL_PATH_VIEW_COMPARISON(<=)
+    BOOST_FILESYSTEM_DETAIL_PATH_VIEW_COMPARISON(>)
+    BOOST_FILESYSTEM_DETAIL_PATH_VIEW_COMPARISON(>=)
+
+#undef BOOST_FILESYSTEM_DETAIL_PATH_VIEW_COMPARISON
+
+private:
+    const value_type* m_data;
+    size_type m_size;
+};
+
+//------------------------------------------------------------------------------------//
+//                             class path_view::iterator                              //
+//------------------------------------------------------------------------------------//
+
+//! Iterator over path elements, which are presented as views. The root directory is presented in the generic format.
+class path_view::iterator :
+    public boost::iterator_facade<
+        path_view::iterator,
+        const path_view,
+        boost::bidirectional_traversal_tag
+    >
+{
+public:
+    iterator() BOOST_NOEXCEPT : m_pos(0u) {}
+
+private:
+    friend class boost::iterator_core_access;
+    friend class boost::filesystem::path_view;
+
+    path_view const& dereference() const BOOST_NOEXCEPT { return m_element; }
+
+    bool equal(iterator const& rhs) const BOOST_NOEXCEPT
+    {
+        return m_path.m_data == rhs.m_path.m_data && m_pos == rhs.m_pos;
+    }
+
+    BOOST_FILESYSTEM_DECL void increment() BOOST_NOEXCEPT;
+    BOOST_FILESYSTEM_DECL void decrement() BOOST_NOEXCEPT;
+
+private:
+    // current element
+    path_view m_element;
+    // path being iterated over
+    path_view m_path;
+    // position of m_element in m_path, m_path.size() for the end iterator
+    size_type m_pos;
+};
+
+inline path_view::iterator path_view::end() const BOOST_NOEXCEPT
+{
+    iterator itr;
+    itr.m_path = *this;
+    itr.m_pos = m_size;
+    return itr;
+}
+
+namespace detail {
+namespace path_traits {
+
+// Dispatch function for integration with path class
+template< typename Callback >
+BOOST_FORCEINLINE void dispatch(path_view const& pv, Callback cb, const codecvt_type* cvt, path_view_tag)
+{
+    cb(pv.data(), pv.data() + pv.size(), cvt);
+}
+
+} // namespace path_traits
+} // namespace detail
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_PATH_VIEW_HPP
@@ -0,0 +1,351 @@
+//  boost/filesystem/static_path.hpp  --------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_STATIC_PATH_HPP
+#define BOOST_FILESYSTEM_STATIC_PATH_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/path_view.hpp>
+
+#include <cstddef>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+#include <boost/type_traits/conjunction.hpp>
+#include <boost/type_traits/disjunction.hpp>
+#include <boost/type_traits/negation.hpp>
+#include <boost/core/enable_if.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+class static_path;
+
+namespace detail {
+
+//! Appends \a begin..end to the path \a lhs with the v4 semantics, using the precomputed root name of \a lhs
+BOOST_FILESYSTEM_DECL path static_path_append_v4(static_path const& lhs, const path::value_type* begin, const path::value_type* end);
+
+BOOST_CONSTEXPR inline bool is_static_path_separator(path::value_type c) BOOST_NOEXCEPT
+{
+    return c == path::separator
+#ifdef BOOST_WINDOWS_API
+        || c == path::preferred_separator
+#endif
+        ;
+}
+
+} // namespace detail
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                                 class static_path                                  //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! A view of a constant path, decomposed on construction
+/*!
+ * The positions of the root name, root directory, relative path, filename and extension are computed when the object
+ * is constructed, which is done at compile time in C++14 and later if the object is \c constexpr. The decomposition
+ * follows the semantics of Boost.Filesystem v4 \c path, same as \c path_view. Decomposition members that are not
+ * precomputed are inherited from \c path_view.
+ *
+ * Appending a path to a \c static_path creates a \c path without parsing the constant prefix again. \c static_path
+ * is a path source, and converting it to \c path copies the characters without analyzing them. The referenced
+ * characters are not copied by \c static_path and must stay valid while it is used, which is the case for string literals.
+ */
+class static_path :
+    public path_view
+{
+public:
+    BOOST_CONSTEXPR static_path() BOOST_NOEXCEPT :
+        m_root_name_size(0u),
+        m_root_directory_pos(0u),
+        m_relative_path_pos(0u),
+        m_filename_pos(0u),
+        m_extension_pos(0u)
+    {
+    }
+
+    //! Constructs a path from a string literal
+    template< std::size_t N >
+    BOOST_CXX14_CONSTEXPR static_path(const value_type (&s)[N]) BOOST_NOEXCEPT :
+        path_view(s, N - 1u),
+        m_root_name_size(0u),
+        m_root_directory_pos(0u),
+        m_relative_path_pos(0u),
+        m_filename_pos(0u),
+        m_extension_pos(0u)
+    {
+        decompose();
+    }
+
+    //! Constructs a path from \a size characters starting at \a s
+    BOOST_CXX14_CONSTEXPR static_path(const value_type* s, size_type size) BOOST_NOEXCEPT :
+        path_view(s, size),
+        m_root_name_size(0u),
+        m_root_directory_pos(0u),
+        m_relative_path_pos(0u),
+        m_filename_pos(0u),
+        m_extension_pos(0u)
+    {
+        decompose();
+    }
+
+    //  -----  decomposition  -----
+
+    BOOST_CONSTEXPR path_view root_name() const BOOST_NOEXCEPT { return path_view(data(), m_root_name_size); }
+    BOOST_CONSTEXPR path_view root_directory() const BOOST_NOEXCEPT
+    {
+        return path_view(data() + m_root_directory_pos, m_root_directory_pos < size() ? static_cast< size_type >(1u) : static_cast< size_type >(0u));
+    }
+    BOOST_CONSTEXPR path_view root_path() const BOOST_NOEXCEPT
+    {
+        return path_view(data(), m_root_directory_pos < size() ? m_root_directory_pos + 1u : m_root_name_size);
+    }
+    BOOST_CONSTEXPR path_view relative_path() const BOOST_NOEXCEPT { return path_view(data() + m_relative_path_pos, size() - m_relative_path_pos); }
+    BOOST_CONSTEXPR path_view filename() const BOOST_NOEXCEPT { return path_view(data() + m_filename_pos, size() - m_filename_pos); }
+    BOOST_CONSTEXPR path_view stem() const BOOST_NOEXCEPT { return path_view(data() + m_filename_pos, m_extension_pos - m_filename_pos); }
+    BOOST_CONSTEXPR path_view extension() const BOOST_NOEXCEPT { return path_view(data() + m_extension_pos, size() - m_extension_pos); }
+
+    //  -----  query  -----
+
+    BOOST_CONSTEXPR bool has_root_name() const BOOST_NOEXCEPT { return m_root_name_size > 0u; }
+    BOOST_CONSTEXPR bool has_root_directory() const BOOST_NOEXCEPT { return m_root_directory_pos < size(); }
+    BOOST_CONSTEXPR bool has_root_path() const BOOST_NOEXCEPT { return has_root_name() || has_root_directory(); }
+    BOOST_CONSTEXPR bool has_relative_path() const BOOST_NOEXCEPT { return m_relative_path_pos < size(); }
+    BOOST_CONSTEXPR bool has_filename() const BOOST_NOEXCEPT { return m_filename_pos < size(); }
+    BOOST_CONSTEXPR bool has_stem() const BOOST_NOEXCEPT { return m_extension_pos > m_filename_pos; }
+    BOOST_CONSTEXPR bool has_extension() const BOOST_NOEXCEPT { return m_extension_pos < size(); }
+    BOOST_CONSTEXPR bool is_relative() const BOOST_NOEXCEPT { return !is_absolute(); }
+    BOOST_CONSTEXPR bool is_absolute() const BOOST_NOEXCEPT
+    {
+        // Windows CE has no root name (aka drive letters)
+#if defined(BOOST_WINDOWS_API) && !defined(UNDER_CE)
+        return has_root_name() && has_root_directory();
+#else
+        return has_root_directory();
+#endif
+    }
+
+    //! Returns the size of the root name. Used by the implementation of appending.
+    BOOST_CONSTEXPR size_type root_name_size() const BOOST_NOEXCEPT { return m_root_name_size; }
+
+    //  -----  appending  -----
+
+    friend path operator/(static_path const& lhs, path const& rhs)
+    {
+        return lhs.append(rhs.c_str(), rhs.c_str() + rhs.size());
+    }
+
+    template< typename Source >
+    friend typename boost::enable_if_c<
+        boost::conjunction<
+            boost::negation< boost::is_same< typename boost::remove_cv< Source >::type, path > >,
+            boost::disjunction<
+                detail::path_traits::is_path_source< typename boost::remove_cv< Source >::type >,
+                detail::path_traits::is_convertible_to_path_source< typename boost::remove_cv< Source >::type >
+            >
+        >::value,
+        path
+    >::type operator/(static_path const& lhs, Source const& rhs)
+    {
+        path p(rhs);
+        return lhs.append(p.c_str(), p.c_str() + p.size());
+    }
+
+private:
+    path append(const value_type* begin, const value_type* end) const
+    {
+#if BOOST_FILESYSTEM_VERSION == 3
+        // v3 appending does not analyze the prefix
+        path result(data(), data() + size());
+        if (begin != end)
+        {
+            if (!detail::is_directory_separator(*begin) && size() > 0u &&
+#ifdef BOOST_WINDOWS_API
+                data()[size() - 1u] != L':' &&
+#endif
+                !detail::is_directory_separator(data()[size() - 1u]))
+            {
+                result += path::preferred_separator;
+            }
+            result.concat(begin, end);
+        }
+        return result;
+#else
+        return detail::static_path_append_v4(*this, begin, end);
+#endif
+    }
+
+    //! Computes the positions of the path elements
+    BOOST_CXX14_CONSTEXPR void decompose() BOOST_NOEXCEPT
+    {
+        const value_type* const p = data();
+        const size_type n = size();
+
+        m_root_directory_pos = find_root_directory_start(p, n, m_root_name_size);
+
+        // The relative path starts past the root name, the root directory and any duplicate separators
+        size_type pos = m_root_name_size;
+        if (m_root_directory_pos < n)
+        {
+            pos = m_root_directory_pos + 1u;
+            while (pos < n && detail::is_static_path_separator(p[pos]))
+                ++pos;
+        }
+        m_relative_path_pos = pos;
+
+        // The filename starts past the last separator that follows the root name
+        pos = n;
+        while (pos > m_root_name_size && !detail::is_static_path_separator(p[pos - 1u]))
+            --pos;
+        m_filename_pos = pos;
+
+        // A dot at the start of the filename does not start an extension, and "." and ".." have no extension
+        m_extension_pos = n;
+        const size_type filename_size = n - m_filename_pos;
+        if (filename_size > 0u && !(p[m_filename_pos] == path::dot && (filename_size == 1u || (filename_size == 2u && p[m_filename_pos + 1u] == path::dot))))
+        {
+            for (pos = n - 1u; pos > m_filename_pos; --pos)
+            {
+                if (p[pos] == path::dot)
+                {
+                    m_extension_pos = pos;
+                    break;
+                }
+            }
+        }
+    }
+
+    //! Returns the position of the root directory or \a size if there is none, and sets \a root_name_size. Same as in path.cpp.
+    static BOOST_CXX14_CONSTEXPR size_type find_root_directory_start(const value_type* p, size_type size, size_type& root_name_size) BOOST_NOEXCEPT
+    {
+        root_name_size = 0u;
+        if (size == 0u)
+            return 0u;
+
+        bool parsing_root_name = false;
+        size_type pos = 0u;
+
+        if (detail::is_static_path_separator(p[0]))
+        {
+            if (size >= 2u && detail::is_static_path_separator(p[1]))
+            {
+                if (size == 2u)
+                {
+                    // The whole path is just a pair of separators
+                    root_name_size = 2u;
+                    return 2u;
+                }
+#ifdef BOOST_WINDOWS_API
+                // cases "\\?\" and "\\.\"
+                else if (size >= 4u && (p[2] == L'?' || p[2] == path::dot) && detail::is_static_path_separator(p[3]))
+                {
+                    parsing_root_name = true;
+                    pos += 4u;
+                }
+#endif
+                else if (detail::is_static_path_separator(p[2]))
+                {
+                    // Three separators are interpreted as a root directory followed by redundant separators
+                    return 0u;
+                }
+                else
+                {
+                    // case "//net {/}"
+                    pos += 2u;
+                    while (pos < size && !detail::is_static_path_separator(p[pos]))
+                        ++pos;
+                    root_name_size = pos;
+                    return pos;
+                }
+            }
+#ifdef BOOST_WINDOWS_API
+            // case "\??\" (NT path prefix)
+            else if (size >= 4u && p[1] == L'?' && p[2] == L'?' && detail::is_static_path_separator(p[3]))
+            {
+                parsing_root_name = true;
+                pos += 4u;
+            }
+#endif
+            else
+            {
+                return 0u;
+            }
+        }
+
+#ifdef BOOST_WINDOWS_API
+        // case "c:" or "prn:"
+        if ((size - pos) >= 2u && ((p[pos] >= L'a' && p[pos] <= L'z') || (p[pos] >= L'A' && p[pos] <= L'Z')))
+        {
+            size_type i = pos + 1u;
+            for (; i < size; ++i)
+            {
+                const value_type c = p[i];
+                if (!((c >= L'a' && c <= L'z') || (c >= L'A' && c <= L'Z') || (c >= L'0' && c <= L'9') || c == L'$'))
+                    break;
+            }
+
+            if (i < size && p[i] == L':')
+            {
+                pos = i + 1u;
+                root_name_size = pos;
+                parsing_root_name = false;
+
+                if (pos < size && detail::is_static_path_separator(p[pos]))
+                    return pos;
+            }
+        }
+#endif
+
+        if (!parsing_root_name)
+            return size;
+
+        while (pos < size && !detail::is_static_path_separator(p[pos]))
+            ++pos;
+        root_name_size = pos;
+
+        return pos;
+    }
+
+private:
+    size_type m_root_name_size;
+    //! Position of the root directory, or size() if there is none
+    size_type m_root_directory_pos;
+    size_type m_relative_path_pos;
+    size_type m_filename_pos;
+    //! Position of the dot that starts the extension, or size() if there is none
+    size_type m_extension_pos;
+};
+
+#if !defined(BOOST_NO_CXX11_USER_DEFINED_LITERALS)
+
+namespace literals {
+
+//! Constructs a \c static_path from a string literal of native characters, e.g. <tt>"/etc/app"_path</tt> on POSIX systems
+BOOST_CXX14_CONSTEXPR inline static_path operator"" _path(const path::value_type* s, std::size_t size) BOOST_NOEXCEPT
+{
+    return static_path(s, size);
+}
+
+} // namespace literals
+
+#endif // !defined(BOOST_NO_CXX11_USER_DEFINED_LITERALS)
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_STATIC_PATH_HPP
@@ -0,0 +1,97 @@
+//  boost/filesystem/status_cache.hpp  -------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_STATUS_CACHE_HPP
+#define BOOST_FILESYSTEM_STATUS_CACHE_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <cstddef>
+#include <boost/system/error_code.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                                class status_cache                                  //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! A cache of file statuses
+/*!
+ * The cache memoizes the results of \c status and \c symlink_status for paths, which is useful when the same
+ * paths are queried repeatedly, and the caller can tolerate results that are out of date by a bounded amount
+ * of time. Cached results expire after the time-to-live specified on construction, and can also be invalidated
+ * explicitly, e.g. when the caller modifies the file or is notified of a modification.
+ *
+ * Paths are compared as Boost.Filesystem v4 paths, i.e. paths that differ only in redundant separators share the
+ * cached status. Failures to query the status, other than the file not existing, are not cached.
+ *
+ * The cache is thread-safe, unless the library is built without thread support. Entries are split between a
+ * number of shards, each protected by its own lock, to reduce contention between threads.
+ */
+class status_cache
+{
+public:
+    //! Time-to-live value indicating that cached statuses never expire
+    static BOOST_CONSTEXPR_OR_CONST unsigned int infinite_ttl = ~0u;
+
+public:
+    //! Constructs an empty cache. Cached statuses expire after \a ttl_ms milliseconds.
+    BOOST_FILESYSTEM_DECL explicit status_cache(unsigned int ttl_ms = infinite_ttl);
+    BOOST_FILESYSTEM_DECL ~status_cache();
+
+    BOOST_DELETED_FUNCTION(status_cache(status_cache const&))
+    BOOST_DELETED_FUNCTION(status_cache& operator=(status_cache const&))
+
+public:
+    //! Returns the time-to-live of cached statuses, in milliseconds
+    unsigned int ttl() const BOOST_NOEXCEPT { return m_ttl_ms; }
+
+    //! Returns the status of \a p, as if by \c boost::filesystem::status. Follows symlinks.
+    file_status status(path const& p) { return status_impl(p, false); }
+    file_status status(path const& p, system::error_code& ec) BOOST_NOEXCEPT { return status_impl(p, false, &ec); }
+
+    //! Returns the status of \a p, as if by \c boost::filesystem::symlink_status. Does not follow symlinks.
+    file_status symlink_status(path const& p) { return status_impl(p, true); }
+    file_status symlink_status(path const& p, system::error_code& ec) BOOST_NOEXCEPT { return status_impl(p, true, &ec); }
+
+    //! Removes the cached statuses of \a p
+    BOOST_FILESYSTEM_DECL void invalidate(path const& p);
+
+    //! Removes all cached statuses
+    BOOST_FILESYSTEM_DECL void clear() BOOST_NOEXCEPT;
+
+    //! Returns the number of paths in the cache, including those with expired statuses
+    BOOST_FILESYSTEM_DECL std::size_t size() const BOOST_NOEXCEPT;
+
+private:
+    struct shard;
+
+    BOOST_FILESYSTEM_DECL file_status status_impl(path const& p, bool symlink, system::error_code* ec = NULL);
+
+private:
+    //! Cache shards
+    shard* m_shards;
+    //! Time-to-live of cached statuses, in milliseconds
+    unsigned int m_ttl_ms;
+};
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_STATUS_CACHE_HPP
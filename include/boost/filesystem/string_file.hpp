@@ -14,7 +14,7 @@
 
 #if !defined(BOOST_FILESYSTEM_DEPRECATED) && !defined(BOOST_FILESYSTEM_ALLOW_DEPRECATED)
 #include <boost/config/header_deprecated.hpp>
-BOOST_HEADER_DEPRECATED("your own implementation")
+BOOST_HEADER_DEPRECATED("read_file and write_file from <boost/filesystem/operations.hpp>")
 #endif
 
 #if !defined(BOOST_FILESYSTEM_NO_DEPRECATED)
@@ -34,7 +34,7 @@ BOOST_HEADER_DEPRECATED("your own implementation")
 namespace boost {
 namespace filesystem {
 
-BOOST_FILESYSTEM_DETAIL_DEPRECATED("Use file IO streams instead")
+BOOST_FILESYSTEM_DETAIL_DEPRECATED("Use boost::filesystem::write_file instead")
 inline void save_string_file(path const& p, std::string const& str)
 {
     filesystem::ofstream file;
@@ -46,7 +46,7 @@ inline void save_string_file(path const& p, std::string const& str)
     file.write(str.c_str(), static_cast< std::streamsize >(sz));
 }
 
-BOOST_FILESYSTEM_DETAIL_DEPRECATED("Use file IO streams instead")
+BOOST_FILESYSTEM_DETAIL_DEPRECATED("Use boost::filesystem::read_file instead")
 inline void load_string_file(path const& p, std::string& str)
 {
     filesystem::ifstream file;
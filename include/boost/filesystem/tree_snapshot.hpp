@@ -0,0 +1,269 @@
+//  boost/filesystem/tree_snapshot.hpp  ------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_TREE_SNAPSHOT_HPP
+#define BOOST_FILESYSTEM_TREE_SNAPSHOT_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/path_view.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/mapped_file.hpp>
+#include <cstddef>
+#include <vector>
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/detail/bitmask.hpp>
+#include <boost/core/scoped_enum.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+//! Options of building a tree snapshot
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(snapshot_options, unsigned int)
+{
+    none = 0u,
+    skip_permission_denied = 1u,      // Skip directories that cannot be opened due to insufficient permissions instead of reporting an error
+    skip_unchanged_files = 1u << 1    // When updating, reuse the recorded attributes of files in directories that were not modified, without querying the files
+}
+BOOST_SCOPED_ENUM_DECLARE_END(snapshot_options)
+
+BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(snapshot_options))
+
+namespace detail {
+
+//! Snapshot record, as stored in the snapshot image
+struct tree_snapshot_record
+{
+    boost::uint64_t size;
+    //! Last write time, in nanoseconds since the Unix epoch
+    boost::int64_t last_write_time_ns;
+    boost::uint64_t inode;
+    boost::uint64_t device;
+    //! Offset of the relative path in the string table, in bytes
+    boost::uint32_t path_offset;
+    //! Size of the relative path, in characters
+    boost::uint32_t path_size;
+    boost::uint32_t type;
+    boost::uint32_t reserved;
+};
+
+} // namespace detail
+
+//! A file recorded in a tree snapshot. The object refers to the snapshot and must not be used after the snapshot is modified or destroyed.
+class tree_snapshot_entry
+{
+private:
+    const detail::tree_snapshot_record* m_record;
+    const path::value_type* m_strings;
+
+public:
+    tree_snapshot_entry(const detail::tree_snapshot_record* rec, const path::value_type* strings) BOOST_NOEXCEPT :
+        m_record(rec),
+        m_strings(strings)
+    {
+    }
+
+    //! Path of the file, relative to the root of the tree. The root directory itself has an empty path.
+    path_view relative_path() const BOOST_NOEXCEPT { return path_view(m_strings + m_record->path_offset / sizeof(path::value_type), m_record->path_size); }
+    //! Type of the file. Symlinks are not followed.
+    file_type type() const BOOST_NOEXCEPT { return static_cast< file_type >(m_record->type); }
+    //! Size of the file, or zero for files other than regular files
+    boost::uintmax_t size() const BOOST_NOEXCEPT { return static_cast< boost::uintmax_t >(m_record->size); }
+    //! Last write time of the file
+    file_time last_write_time() const BOOST_NOEXCEPT
+    {
+        boost::int64_t sec = m_record->last_write_time_ns / 1000000000;
+        boost::int64_t nsec = m_record->last_write_time_ns % 1000000000;
+        if (nsec < 0)
+        {
+            --sec;
+            nsec += 1000000000;
+        }
+        return file_time(static_cast< std::time_t >(sec), static_cast< boost::uint32_t >(nsec));
+    }
+    //! Last write time of the file, in nanoseconds since the Unix epoch
+    boost::int64_t last_write_time_ns() const BOOST_NOEXCEPT { return m_record->last_write_time_ns; }
+    //! Inode number on POSIX systems, file index on Windows. Zero if not supported by the system.
+    boost::uintmax_t inode() const BOOST_NOEXCEPT { return static_cast< boost::uintmax_t >(m_record->inode); }
+    //! Device id on POSIX systems, volume serial number on Windows. Zero if not supported by the system.
+    boost::uintmax_t device() const BOOST_NOEXCEPT { return static_cast< boost::uintmax_t >(m_record->device); }
+};
+
+//! Kind of a change between two tree snapshots
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(tree_change_kind, unsigned int)
+{
+    added = 0u,    // The file is only present in the new snapshot
+    removed = 1u,  // The file is only present in the old snapshot
+    modified = 2u  // The file is present in both snapshots, but its attributes differ
+}
+BOOST_SCOPED_ENUM_DECLARE_END(tree_change_kind)
+
+//! A change between two tree snapshots
+struct tree_change
+{
+    BOOST_SCOPED_ENUM_NATIVE(tree_change_kind) kind;
+    //! Type of the file in the new snapshot, or in the old snapshot for removed files
+    file_type type;
+    //! Path of the file, relative to the root of the tree
+    path relative_path;
+
+    tree_change() BOOST_NOEXCEPT : kind(tree_change_kind::added), type(status_error) {}
+    tree_change(BOOST_SCOPED_ENUM_NATIVE(tree_change_kind) k, file_type t, path_view p) : kind(k), type(t), relative_path(p) {}
+};
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                                class tree_snapshot                                 //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! A record of paths and attributes of all files in a directory tree
+/*!
+ * The snapshot records the relative path, type, size, last write time, inode and device of every file in the tree,
+ * including the root directory. Symlinks are recorded, but not followed. The records are stored in a single compact
+ * image, sorted by the relative path in the native format, which can be saved to a file and loaded back by mapping
+ * the file into memory, without parsing. The image is stored in the native byte order of the system.
+ *
+ * A snapshot can be updated incrementally. When a directory has the same inode and last write time as recorded in
+ * the previous snapshot, its list of entries is known to be unchanged and the directory is not read. Attributes of
+ * the files in such directories are still queried, unless \c snapshot_options::skip_unchanged_files is specified, in
+ * which case modifications of such files that keep the list of directory entries intact are not detected.
+ */
+class tree_snapshot
+{
+public:
+    //! Index value indicating that the file was not found
+    static BOOST_CONSTEXPR_OR_CONST std::size_t npos = ~static_cast< std::size_t >(0u);
+
+public:
+    //! Constructs an empty snapshot
+    tree_snapshot() BOOST_NOEXCEPT : m_data(NULL), m_count(0u) {}
+
+    BOOST_DELETED_FUNCTION(tree_snapshot(tree_snapshot const&))
+    BOOST_DELETED_FUNCTION(tree_snapshot& operator=(tree_snapshot const&))
+
+public:
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    tree_snapshot(tree_snapshot&& that) BOOST_NOEXCEPT : m_data(NULL), m_count(0u)
+    {
+        swap(*this, that);
+    }
+
+    tree_snapshot& operator=(tree_snapshot&& that) BOOST_NOEXCEPT
+    {
+        if (this != &that)
+        {
+            clear();
+            swap(*this, that);
+        }
+        return *this;
+    }
+#endif // !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+
+    //! Records the directory tree at \a root, replacing the current contents of the snapshot
+    void build(path const& root, BOOST_SCOPED_ENUM_NATIVE(snapshot_options) options = snapshot_options::none)
+    {
+        build_impl(root, static_cast< unsigned int >(options), false);
+    }
+    void build(path const& root, BOOST_SCOPED_ENUM_NATIVE(snapshot_options) options, system::error_code& ec)
+    {
+        build_impl(root, static_cast< unsigned int >(options), false, &ec);
+    }
+
+    //! Records the directory tree at \a root, reusing the current contents of the snapshot for the directories that were not modified
+    void update(path const& root, BOOST_SCOPED_ENUM_NATIVE(snapshot_options) options = snapshot_options::none)
+    {
+        build_impl(root, static_cast< unsigned int >(options), true);
+    }
+    void update(path const& root, BOOST_SCOPED_ENUM_NATIVE(snapshot_options) options, system::error_code& ec)
+    {
+        build_impl(root, static_cast< unsigned int >(options), true, &ec);
+    }
+
+    //! Writes the snapshot image to file \a p, atomically replacing the file
+    void save(path const& p) const { save_impl(p); }
+    void save(path const& p, system::error_code& ec) const { save_impl(p, &ec); }
+
+    //! Maps the snapshot image saved in file \a p into memory, replacing the current contents of the snapshot
+    void load(path const& p) { load_impl(p); }
+    void load(path const& p, system::error_code& ec) { load_impl(p, &ec); }
+
+    //! Removes all entries from the snapshot
+    BOOST_FILESYSTEM_DECL void clear() BOOST_NOEXCEPT;
+
+    //! Returns the number of recorded files
+    std::size_t size() const BOOST_NOEXCEPT { return m_count; }
+    //! Returns \c true if the snapshot is empty
+    bool empty() const BOOST_NOEXCEPT { return m_count == 0u; }
+
+    //! Returns the recorded file with index \a index. The entries are sorted by their relative paths.
+    tree_snapshot_entry operator[](std::size_t index) const BOOST_NOEXCEPT
+    {
+        BOOST_ASSERT(index < m_count);
+        return tree_snapshot_entry(records() + index, strings());
+    }
+
+    //! Returns the index of the file with relative path \a p, or \c npos if the file is not recorded
+    BOOST_FILESYSTEM_DECL std::size_t find(path_view const& p) const BOOST_NOEXCEPT;
+
+    //! Returns the time when the snapshot building started, in nanoseconds since the Unix epoch
+    BOOST_FILESYSTEM_DECL boost::int64_t creation_time_ns() const BOOST_NOEXCEPT;
+
+    //! Returns the snapshot image
+    const void* data() const BOOST_NOEXCEPT { return m_data; }
+    //! Returns the size of the snapshot image, in bytes
+    BOOST_FILESYSTEM_DECL std::size_t data_size() const BOOST_NOEXCEPT;
+
+    friend void swap(tree_snapshot& left, tree_snapshot& right) BOOST_NOEXCEPT
+    {
+        const char* data = left.m_data;
+        left.m_data = right.m_data;
+        right.m_data = data;
+        std::size_t count = left.m_count;
+        left.m_count = right.m_count;
+        right.m_count = count;
+        left.m_buffer.swap(right.m_buffer);
+        swap(left.m_mapping, right.m_mapping);
+    }
+
+private:
+    BOOST_FILESYSTEM_DECL const detail::tree_snapshot_record* records() const BOOST_NOEXCEPT;
+    BOOST_FILESYSTEM_DECL const path::value_type* strings() const BOOST_NOEXCEPT;
+
+    BOOST_FILESYSTEM_DECL void build_impl(path const& root, unsigned int options, bool incremental, system::error_code* ec = NULL);
+    BOOST_FILESYSTEM_DECL void save_impl(path const& p, system::error_code* ec = NULL) const;
+    BOOST_FILESYSTEM_DECL void load_impl(path const& p, system::error_code* ec = NULL);
+
+private:
+    //! Pointer to the snapshot image, either in \c m_buffer or in \c m_mapping
+    const char* m_data;
+    //! Number of records
+    std::size_t m_count;
+    //! Snapshot image built in memory
+    std::vector< boost::uint64_t > m_buffer;
+    //! Snapshot image loaded from a file
+    mapped_file m_mapping;
+};
+
+//! Returns the changes between snapshots \a from and \a to, sorted by the relative paths of the changed files
+BOOST_FILESYSTEM_DECL std::vector< tree_change > diff(tree_snapshot const& from, tree_snapshot const& to);
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_TREE_SNAPSHOT_HPP
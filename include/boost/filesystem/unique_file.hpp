@@ -0,0 +1,207 @@
+//  boost/filesystem/unique_file.hpp  --------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_UNIQUE_FILE_HPP
+#define BOOST_FILESYSTEM_UNIQUE_FILE_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/detail/bitmask.hpp>
+#include <boost/core/scoped_enum.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+//! Options of creating unique files
+BOOST_SCOPED_ENUM_UT_DECLARE_BEGIN(unique_file_flags, unsigned int)
+{
+    none = 0u,
+    anonymous = 1u,            // Create a file without a name in the directory of the model (O_TMPFILE), if supported; implies remove_on_close
+    remove_on_close = 1u << 1  // Remove the file when it is closed, unless it was given a name with unique_file::link
+}
+BOOST_SCOPED_ENUM_DECLARE_END(unique_file_flags)
+
+BOOST_BITMASK(BOOST_SCOPED_ENUM_NATIVE(unique_file_flags))
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                                 class unique_file                                  //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! A newly created file with a unique name, open for reading and writing
+/*!
+ * The file name is generated from a model, as in \c unique_path, and the file is created and opened in a single
+ * operation that fails if the file already exists (\c O_CREAT|O_EXCL on POSIX systems and \c CREATE_NEW on Windows).
+ * If a file with the generated name exists, a new name is generated and the creation is retried. This way, there is
+ * no window between checking for the file existence and creating it. On POSIX systems, the file is created with
+ * owner read and write permissions.
+ *
+ * With \c unique_file_flags::anonymous, on Linux the file is created with \c O_TMPFILE in the parent directory of the model,
+ * which does not need a unique name at all. The file is not visible in the directory and is removed when closed, unless it
+ * is given a name with \c link. If anonymous files are not supported by the system or the filesystem, a named file is
+ * created and removed on close instead.
+ */
+class unique_file
+{
+public:
+#if defined(BOOST_POSIX_API)
+    typedef int native_handle_type;
+#else
+    typedef void* native_handle_type;
+#endif
+
+public:
+    //! Constructs an object that does not refer to a file
+    unique_file() BOOST_NOEXCEPT : m_handle(invalid_native_handle()), m_remove_on_close(false) {}
+
+    //! Creates a file with a unique name generated from \a model
+    explicit unique_file(filesystem::path const& model, BOOST_SCOPED_ENUM_NATIVE(unique_file_flags) flags = unique_file_flags::none) :
+        m_handle(invalid_native_handle()), m_remove_on_close(false)
+    {
+        create_impl(model, static_cast< unsigned int >(flags));
+    }
+    unique_file(filesystem::path const& model, system::error_code& ec) :
+        m_handle(invalid_native_handle()), m_remove_on_close(false)
+    {
+        create_impl(model, 0u, &ec);
+    }
+    unique_file(filesystem::path const& model, BOOST_SCOPED_ENUM_NATIVE(unique_file_flags) flags, system::error_code& ec) :
+        m_handle(invalid_native_handle()), m_remove_on_close(false)
+    {
+        create_impl(model, static_cast< unsigned int >(flags), &ec);
+    }
+
+    //! Closes the file and removes it, if requested on creation
+    ~unique_file() BOOST_NOEXCEPT { close(); }
+
+    BOOST_DELETED_FUNCTION(unique_file(unique_file const&))
+    BOOST_DELETED_FUNCTION(unique_file& operator=(unique_file const&))
+
+public:
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    unique_file(unique_file&& that) BOOST_NOEXCEPT : m_handle(invalid_native_handle()), m_remove_on_close(false)
+    {
+        swap(*this, that);
+    }
+
+    unique_file& operator=(unique_file&& that) BOOST_NOEXCEPT
+    {
+        if (this != &that)
+        {
+            close();
+            swap(*this, that);
+        }
+        return *this;
+    }
+#endif // !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+
+    //! Closes the currently open file, if any, and creates a file with a unique name generated from \a model
+    void create(filesystem::path const& model, BOOST_SCOPED_ENUM_NATIVE(unique_file_flags) flags = unique_file_flags::none) { create_impl(model, static_cast< unsigned int >(flags)); }
+    void create(filesystem::path const& model, system::error_code& ec) { create_impl(model, 0u, &ec); }
+    void create(filesystem::path const& model, BOOST_SCOPED_ENUM_NATIVE(unique_file_flags) flags, system::error_code& ec) { create_impl(model, static_cast< unsigned int >(flags), &ec); }
+
+    //! Returns \c true if the object refers to an open file
+    bool is_open() const BOOST_NOEXCEPT { return m_handle != invalid_native_handle(); }
+
+    //! Returns the native handle of the file. The handle is still owned by \c unique_file.
+    native_handle_type native_handle() const BOOST_NOEXCEPT { return m_handle; }
+
+    //! Returns the path of the file. Returns an empty path if the file is anonymous.
+    filesystem::path const& path() const BOOST_NOEXCEPT { return m_path; }
+
+    //! Returns \c true if the file is open and has no name
+    bool is_anonymous() const BOOST_NOEXCEPT { return is_open() && m_path.empty(); }
+
+    //! Returns \c true if the file will be removed when closed
+    bool is_removed_on_close() const BOOST_NOEXCEPT { return m_remove_on_close; }
+
+    //! Gives the file the name \a p. Fails if \a p already exists.
+    /*!
+     * If the file already has a name, the previous name is removed. Once linked, the file is no longer removed on close.
+     */
+    void link(filesystem::path const& p) { link_impl(p); }
+    void link(filesystem::path const& p, system::error_code& ec) { link_impl(p, &ec); }
+
+    //! Releases the ownership of the native handle and returns it. The file will not be removed.
+    native_handle_type release() BOOST_NOEXCEPT
+    {
+        native_handle_type h = m_handle;
+        m_handle = invalid_native_handle();
+        m_path.clear();
+        m_remove_on_close = false;
+        return h;
+    }
+
+    //! Closes the file and removes it, if requested on creation. Errors of removing the file are ignored.
+    BOOST_FILESYSTEM_DECL void close() BOOST_NOEXCEPT;
+
+    friend void swap(unique_file& left, unique_file& right) BOOST_NOEXCEPT
+    {
+        native_handle_type h = left.m_handle;
+        left.m_handle = right.m_handle;
+        right.m_handle = h;
+        left.m_path.swap(right.m_path);
+        bool remove_on_close = left.m_remove_on_close;
+        left.m_remove_on_close = right.m_remove_on_close;
+        right.m_remove_on_close = remove_on_close;
+    }
+
+private:
+    static native_handle_type invalid_native_handle() BOOST_NOEXCEPT
+    {
+#if defined(BOOST_POSIX_API)
+        return -1;
+#else
+        // INVALID_HANDLE_VALUE
+        return reinterpret_cast< native_handle_type >(~static_cast< boost::uintptr_t >(0u));
+#endif
+    }
+
+    BOOST_FILESYSTEM_DECL void create_impl(filesystem::path const& model, unsigned int flags, system::error_code* ec = NULL);
+    BOOST_FILESYSTEM_DECL void link_impl(filesystem::path const& p, system::error_code* ec = NULL);
+
+private:
+    native_handle_type m_handle;
+    filesystem::path m_path;
+    bool m_remove_on_close;
+};
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+
+//! Creates a file with a unique name generated from \a model. See \c unique_file.
+inline unique_file create_unique_file(path const& model, BOOST_SCOPED_ENUM_NATIVE(unique_file_flags) flags = unique_file_flags::none)
+{
+    return unique_file(model, flags);
+}
+
+inline unique_file create_unique_file(path const& model, system::error_code& ec)
+{
+    return unique_file(model, ec);
+}
+
+inline unique_file create_unique_file(path const& model, BOOST_SCOPED_ENUM_NATIVE(unique_file_flags) flags, system::error_code& ec)
+{
+    return unique_file(model, flags, ec);
+}
+
+#endif // !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_UNIQUE_FILE_HPP
@@ -0,0 +1,165 @@
+//  boost/filesystem/volume_handle.hpp  ------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_VOLUME_HANDLE_HPP
+#define BOOST_FILESYSTEM_VOLUME_HANDLE_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                                class volume_handle                                 //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! An open file on a volume, for repeatedly querying the space on the volume
+/*!
+ * The handle keeps the file \a p open, and \c space queries the volume through the open file, without resolving \a p
+ * again. On POSIX systems, this is done with \c fstatvfs (or \c fstatfs). On Windows, the directory for
+ * \c GetDiskFreeSpaceExW is determined once, when the handle is opened, and the directory is kept open.
+ *
+ * Optionally, the results of \c space can be cached for a given maximum staleness. While the cached result is fresh
+ * enough, it is returned without querying the system. Concurrent calls of \c space that need to refresh the result
+ * are coalesced into a single query. Failures to query the space are not cached.
+ *
+ * \c space can be called concurrently from multiple threads. Other operations must not be called concurrently
+ * with any operations on the same handle.
+ */
+class volume_handle
+{
+public:
+#if defined(BOOST_POSIX_API)
+    typedef int native_handle_type;
+#else
+    typedef void* native_handle_type;
+#endif
+
+public:
+    //! Constructs a handle that does not refer to a volume
+    volume_handle() BOOST_NOEXCEPT : m_handle(invalid_native_handle()), m_state(NULL), m_max_staleness_ms(0u) {}
+
+    //! Opens the file \a p. If \a max_staleness_ms is not zero, the results of \c space are cached for that many milliseconds.
+    explicit volume_handle(path const& p, unsigned int max_staleness_ms = 0u) :
+        m_handle(invalid_native_handle()), m_state(NULL), m_max_staleness_ms(0u)
+    {
+        open_impl(p, max_staleness_ms);
+    }
+    volume_handle(path const& p, system::error_code& ec) BOOST_NOEXCEPT :
+        m_handle(invalid_native_handle()), m_state(NULL), m_max_staleness_ms(0u)
+    {
+        open_impl(p, 0u, &ec);
+    }
+    volume_handle(path const& p, unsigned int max_staleness_ms, system::error_code& ec) BOOST_NOEXCEPT :
+        m_handle(invalid_native_handle()), m_state(NULL), m_max_staleness_ms(0u)
+    {
+        open_impl(p, max_staleness_ms, &ec);
+    }
+
+    //! Closes the file
+    ~volume_handle() BOOST_NOEXCEPT { close(); }
+
+    BOOST_DELETED_FUNCTION(volume_handle(volume_handle const&))
+    BOOST_DELETED_FUNCTION(volume_handle& operator=(volume_handle const&))
+
+public:
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    volume_handle(volume_handle&& that) BOOST_NOEXCEPT :
+        m_handle(invalid_native_handle()), m_state(NULL), m_max_staleness_ms(0u)
+    {
+        swap(*this, that);
+    }
+
+    volume_handle& operator=(volume_handle&& that) BOOST_NOEXCEPT
+    {
+        if (this != &that)
+        {
+            close();
+            swap(*this, that);
+        }
+        return *this;
+    }
+#endif // !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+
+    //! Returns \c true if the handle refers to a volume
+    bool is_open() const BOOST_NOEXCEPT { return m_handle != invalid_native_handle(); }
+
+    //! Returns the native handle of the open file. The handle is still owned by \c volume_handle.
+    native_handle_type native_handle() const BOOST_NOEXCEPT { return m_handle; }
+
+    //! Returns the maximum staleness of the cached results of \c space, in milliseconds, or zero if the results are not cached
+    unsigned int max_staleness() const BOOST_NOEXCEPT { return m_max_staleness_ms; }
+
+    //! Closes the file
+    BOOST_FILESYSTEM_DECL void close() BOOST_NOEXCEPT;
+
+    //! Closes the currently open file, if any, and opens the file \a p
+    void open(path const& p, unsigned int max_staleness_ms = 0u) { open_impl(p, max_staleness_ms); }
+    void open(path const& p, system::error_code& ec) BOOST_NOEXCEPT { open_impl(p, 0u, &ec); }
+    void open(path const& p, unsigned int max_staleness_ms, system::error_code& ec) BOOST_NOEXCEPT { open_impl(p, max_staleness_ms, &ec); }
+
+    //! Returns the space on the volume, as if by \c boost::filesystem::space, or the cached result, if it is fresh enough
+    space_info space() const { return space_impl(); }
+    space_info space(system::error_code& ec) const BOOST_NOEXCEPT { return space_impl(&ec); }
+
+    //! Discards the cached result of \c space, if any, so that the next call queries the system
+    BOOST_FILESYSTEM_DECL void invalidate() const BOOST_NOEXCEPT;
+
+    friend void swap(volume_handle& left, volume_handle& right) BOOST_NOEXCEPT
+    {
+        native_handle_type h = left.m_handle;
+        left.m_handle = right.m_handle;
+        right.m_handle = h;
+        state* s = left.m_state;
+        left.m_state = right.m_state;
+        right.m_state = s;
+        unsigned int max_staleness_ms = left.m_max_staleness_ms;
+        left.m_max_staleness_ms = right.m_max_staleness_ms;
+        right.m_max_staleness_ms = max_staleness_ms;
+    }
+
+private:
+    struct state;
+
+    static native_handle_type invalid_native_handle() BOOST_NOEXCEPT
+    {
+#if defined(BOOST_POSIX_API)
+        return -1;
+#else
+        // INVALID_HANDLE_VALUE
+        return reinterpret_cast< native_handle_type >(~static_cast< boost::uintptr_t >(0u));
+#endif
+    }
+
+    BOOST_FILESYSTEM_DECL void open_impl(path const& p, unsigned int max_staleness_ms, system::error_code* ec = NULL);
+    BOOST_FILESYSTEM_DECL space_info space_impl(system::error_code* ec = NULL) const;
+
+private:
+    native_handle_type m_handle;
+    //! Cached result of \c space and, on Windows, the directory for \c GetDiskFreeSpaceExW
+    state* m_state;
+    unsigned int m_max_staleness_ms;
+};
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_VOLUME_HANDLE_HPP
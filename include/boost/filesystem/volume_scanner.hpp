@@ -0,0 +1,180 @@
+//  boost/filesystem/volume_scanner.hpp  -----------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_VOLUME_SCANNER_HPP
+#define BOOST_FILESYSTEM_VOLUME_SCANNER_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <cstddef>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+//! A file on a volume, reported by \c volume_scanner
+struct volume_record
+{
+    //! Identity of the file, as returned by \c identity
+    file_identity id;
+    //! Identity of the directory containing the file
+    file_identity parent_id;
+    //! Name of the file in the parent directory
+    path name;
+    //! Type of the file: \c directory_file, \c reparse_file for files with reparse points, or \c regular_file
+    file_type type;
+    //! Native attributes of the file, \c FILE_ATTRIBUTE_* flags on Windows
+    boost::uint32_t attributes;
+    //! For records returned by \c volume_scanner::read_changes, the reasons of the change, \c USN_REASON_* flags on Windows. Zero for records returned by \c volume_scanner::scan.
+    boost::uint32_t reason;
+    //! Update sequence number of the last change of the file
+    boost::uint64_t usn;
+
+    volume_record() BOOST_NOEXCEPT : type(status_error), attributes(0u), reason(0u), usn(0u) {}
+};
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                               class volume_scanner                                 //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+//! Enumerates all files on a volume from the volume metadata and tracks the changes of the files
+/*!
+ * On Windows, the scanner opens the NTFS or ReFS volume containing the given path and enumerates the Master File Table
+ * with \c FSCTL_ENUM_USN_DATA, which is much faster than traversing the directory tree. Changes made after the scanner
+ * was opened are read from the USN change journal with \c FSCTL_READ_USN_JOURNAL. Opening a volume requires administrative
+ * privileges. On other systems, opening a scanner fails with an error indicating that the operation is not supported.
+ *
+ * The records contain the identities of the file and its parent directory and the name of the file, but not its full path.
+ * The scanner indexes the records returned by \c scan and \c read_changes, and \c full_path reconstructs the path
+ * of an indexed file from the names of its parent directories, once the parent directories have been scanned. The index
+ * is updated according to the changes read from the journal, so that the reconstructed paths reflect renames and removed
+ * files are no longer found.
+ *
+ * The scanner is not thread-safe.
+ */
+class volume_scanner
+{
+public:
+    //! Constructs a scanner that does not refer to a volume
+    volume_scanner() BOOST_NOEXCEPT : m_impl(NULL) {}
+
+    //! Opens the volume containing the file \a p
+    explicit volume_scanner(path const& p) :
+        m_impl(NULL)
+    {
+        open_impl(p);
+    }
+    volume_scanner(path const& p, system::error_code& ec) BOOST_NOEXCEPT :
+        m_impl(NULL)
+    {
+        open_impl(p, &ec);
+    }
+
+    //! Closes the volume
+    ~volume_scanner() BOOST_NOEXCEPT { close(); }
+
+    BOOST_DELETED_FUNCTION(volume_scanner(volume_scanner const&))
+    BOOST_DELETED_FUNCTION(volume_scanner& operator=(volume_scanner const&))
+
+public:
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    volume_scanner(volume_scanner&& that) BOOST_NOEXCEPT :
+        m_impl(that.m_impl)
+    {
+        that.m_impl = NULL;
+    }
+
+    volume_scanner& operator=(volume_scanner&& that) BOOST_NOEXCEPT
+    {
+        if (this != &that)
+        {
+            close();
+            m_impl = that.m_impl;
+            that.m_impl = NULL;
+        }
+        return *this;
+    }
+#endif // !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+
+    //! Returns \c true if the scanner refers to a volume
+    bool is_open() const BOOST_NOEXCEPT { return m_impl != NULL; }
+
+    //! Closes the volume and discards the index of the scanned files
+    BOOST_FILESYSTEM_DECL void close() BOOST_NOEXCEPT;
+
+    //! Closes the currently open volume, if any, and opens the volume containing the file \a p
+    void open(path const& p) { open_impl(p); }
+    void open(path const& p, system::error_code& ec) BOOST_NOEXCEPT { open_impl(p, &ec); }
+
+    //! Returns the root directory of the open volume, or an empty path if the scanner is not open
+    BOOST_FILESYSTEM_DECL path const& volume_path() const BOOST_NOEXCEPT;
+
+    //! Returns the update sequence number from which \c read_changes will read the next changes
+    BOOST_FILESYSTEM_DECL boost::uint64_t next_usn() const BOOST_NOEXCEPT;
+
+    //! Appends the next batch of the files on the volume to \a records
+    /*!
+     * Returns the number of appended records, or zero if all files on the volume have been enumerated. The files are enumerated
+     * in the order of their identities, which is unrelated to the directory structure. Changes made after the scanner was opened
+     * are not reflected in the records and are reported by \c read_changes instead.
+     */
+    std::size_t scan(std::vector< volume_record >& records) { return scan_impl(records); }
+    std::size_t scan(std::vector< volume_record >& records, system::error_code& ec) { return scan_impl(records, &ec); }
+
+    //! Appends the next batch of the changes recorded in the change journal to \a records, without waiting for changes
+    /*!
+     * Returns the number of appended records, or zero if there are no new changes. The first call returns the changes made
+     * after the scanner was opened. If the journal has been truncated or recreated since the changes were last read, the error
+     * is reported, in which case the volume should be scanned again.
+     */
+    std::size_t read_changes(std::vector< volume_record >& records) { return read_changes_impl(records); }
+    std::size_t read_changes(std::vector< volume_record >& records, system::error_code& ec) { return read_changes_impl(records, &ec); }
+
+    //! Returns the full path of the indexed file \a id
+    /*!
+     * The path is composed of \c volume_path and the names of the file and its parent directories. Fails if the file or
+     * one of its parent directories has not been indexed yet.
+     */
+    path full_path(file_identity const& id) const { return full_path_impl(id); }
+    path full_path(file_identity const& id, system::error_code& ec) const { return full_path_impl(id, &ec); }
+
+    friend void swap(volume_scanner& left, volume_scanner& right) BOOST_NOEXCEPT
+    {
+        implementation* impl = left.m_impl;
+        left.m_impl = right.m_impl;
+        right.m_impl = impl;
+    }
+
+private:
+    struct implementation;
+
+    BOOST_FILESYSTEM_DECL void open_impl(path const& p, system::error_code* ec = NULL);
+    BOOST_FILESYSTEM_DECL std::size_t scan_impl(std::vector< volume_record >& records, system::error_code* ec = NULL);
+    BOOST_FILESYSTEM_DECL std::size_t read_changes_impl(std::vector< volume_record >& records, system::error_code* ec = NULL);
+    BOOST_FILESYSTEM_DECL path full_path_impl(file_identity const& id, system::error_code* ec = NULL) const;
+
+private:
+    implementation* m_impl;
+};
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_VOLUME_SCANNER_HPP
@@ -0,0 +1,709 @@
+//  async_context.cpp  -----------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/async_context.hpp>
+
+#if defined(BOOST_FILESYSTEM_HAS_ASYNC_CONTEXT)
+
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <cstddef>
+#include <new> // std::bad_alloc
+#include <vector>
+#include <boost/system/error_code.hpp>
+
+#include "thread_tools.hpp"
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+#include "io_uring_tools.hpp"
+
+#if defined(BOOST_FILESYSTEM_USE_IO_URING) && defined(BOOST_FILESYSTEM_HAS_IO_URING_FS_OPS) && defined(BOOST_FILESYSTEM_HAS_THREADS)
+#define BOOST_FILESYSTEM_USE_ASYNC_IO_URING
+#endif
+
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+namespace {
+
+//! Performs the operation synchronously
+void execute_operation(async_operation* op) BOOST_NOEXCEPT
+{
+    try
+    {
+        switch (op->kind)
+        {
+        case async_operation::status_operation:
+            op->status = detail::status(op->path1, &op->error);
+            break;
+
+        case async_operation::symlink_status_operation:
+            op->status = detail::symlink_status(op->path1, &op->error);
+            break;
+
+        case async_operation::copy_file_operation:
+            op->result = detail::copy_file(op->path1, op->path2, op->options, &op->error);
+            break;
+
+        case async_operation::remove_operation:
+            op->result = detail::remove(op->path1, &op->error);
+            break;
+
+        case async_operation::rename_operation:
+            detail::rename(op->path1, op->path2, &op->error);
+            break;
+
+        case async_operation::create_directory_operation:
+            op->result = detail::create_directory(op->path1, NULL, &op->error);
+            break;
+
+        case async_operation::directory_entries_operation:
+            {
+                directory_iterator it(op->path1, static_cast< BOOST_SCOPED_ENUM_NATIVE(directory_options) >(op->options), op->error);
+                while (!op->error && it != directory_iterator())
+                {
+                    op->entries.push_back(*it);
+                    it.increment(op->error);
+                }
+
+                if (op->error)
+                    op->entries.clear();
+            }
+            break;
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        op->error = make_error_code(system::errc::not_enough_memory);
+        op->entries.clear();
+    }
+}
+
+} // namespace
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+#if defined(BOOST_FILESYSTEM_USE_ASYNC_IO_URING)
+
+namespace {
+
+//! Maximum number of io_uring requests in flight
+BOOST_CONSTEXPR_OR_CONST unsigned int async_io_uring_queue_depth = 256u;
+//! The value of user_data of the request that stops the completion thread
+BOOST_CONSTEXPR_OR_CONST boost::uint64_t async_io_uring_stop_marker = ~static_cast< boost::uint64_t >(0u);
+
+//! IORING_REGISTER_PROBE results, as defined in linux/io_uring.h since Linux 5.6
+struct io_uring_probe_op_info
+{
+    boost::uint8_t op;
+    boost::uint8_t resv;
+    boost::uint16_t flags;
+    boost::uint32_t resv2;
+};
+
+struct io_uring_probe_info
+{
+    boost::uint8_t last_op;
+    boost::uint8_t ops_len;
+    boost::uint16_t resv;
+    boost::uint32_t resv2[3];
+    io_uring_probe_op_info ops[256];
+};
+
+BOOST_CONSTEXPR_OR_CONST unsigned int io_uring_register_probe = 8u;         // IORING_REGISTER_PROBE
+BOOST_CONSTEXPR_OR_CONST boost::uint16_t io_uring_op_supported = 1u << 0;  // IO_URING_OP_SUPPORTED
+
+} // namespace
+
+//! Performs operations using io_uring
+class async_io_uring_backend
+{
+private:
+    //! Request slot
+    struct slot
+    {
+        async_operation* op;
+        struct ::statx stx;
+    };
+
+private:
+    async_context_impl& m_context;
+    io_uring_instance m_ring;
+    bool m_statx_supported;
+    bool m_fs_ops_supported;
+
+    //! Protects the submission queue and the slots
+    std::mutex m_mutex;
+    std::vector< slot > m_slots;
+    std::vector< unsigned int > m_free_slots;
+    //! Number of entries in the submission queue that were not yet consumed by the kernel
+    unsigned int m_unsubmitted;
+    //! Indicates that io_uring failed and no more operations can be submitted
+    bool m_failed;
+    //! Indicates that the completion thread has terminated because of an io_uring failure
+    bool m_completion_failed;
+
+    std::thread m_completion_thread;
+
+public:
+    explicit async_io_uring_backend(async_context_impl& context) :
+        m_context(context),
+        m_statx_supported(false),
+        m_fs_ops_supported(false),
+        m_unsubmitted(0u),
+        m_failed(false),
+        m_completion_failed(false)
+    {
+    }
+
+    ~async_io_uring_backend()
+    {
+        if (m_completion_thread.joinable())
+        {
+            {
+                std::lock_guard< std::mutex > lock(m_mutex);
+                if (!m_completion_failed)
+                {
+                    struct io_uring_sqe* sqe = m_ring.get_sqe(m_ring.sq_tail());
+                    std::memset(sqe, 0, sizeof(*sqe));
+                    sqe->opcode = IORING_OP_NOP;
+                    sqe->user_data = async_io_uring_stop_marker;
+                    m_ring.set_sq_tail(m_ring.sq_tail() + 1u);
+                    ++m_unsubmitted;
+                    flush();
+                }
+            }
+
+            m_completion_thread.join();
+        }
+    }
+
+    BOOST_DELETED_FUNCTION(async_io_uring_backend(async_io_uring_backend const&))
+    BOOST_DELETED_FUNCTION(async_io_uring_backend& operator=(async_io_uring_backend const&))
+
+    //! Initializes io_uring. Returns \c false if io_uring is not supported.
+    bool init()
+    {
+        // Reserve one entry for the stop request
+        if (m_ring.init(async_io_uring_queue_depth + 1u) != 0)
+            return false;
+
+        io_uring_probe_info probe;
+        std::memset(&probe, 0, sizeof(probe));
+        if (::syscall(__NR_io_uring_register, m_ring.fd(), io_uring_register_probe, &probe, 256u) < 0)
+            return false;
+
+        m_statx_supported = is_op_supported(probe, IORING_OP_STATX);
+        m_fs_ops_supported = is_op_supported(probe, IORING_OP_UNLINKAT) && is_op_supported(probe, IORING_OP_RENAMEAT) &&
+            is_op_supported(probe, IORING_OP_MKDIRAT);
+        if (!m_statx_supported && !m_fs_ops_supported)
+            return false;
+
+        m_slots.resize(async_io_uring_queue_depth);
+        m_free_slots.resize(async_io_uring_queue_depth);
+        for (unsigned int i = 0u; i < async_io_uring_queue_depth; ++i)
+            m_free_slots[i] = async_io_uring_queue_depth - i - 1u;
+
+        m_completion_thread = std::thread(&async_io_uring_backend::run, this);
+        return true;
+    }
+
+    //! Submits the operation to io_uring. Returns \c false if the operation cannot be performed with io_uring.
+    bool submit(async_operation* op) BOOST_NOEXCEPT
+    {
+        switch (op->kind)
+        {
+        case async_operation::status_operation:
+        case async_operation::symlink_status_operation:
+            if (!m_statx_supported)
+                return false;
+            break;
+
+        case async_operation::remove_operation:
+        case async_operation::rename_operation:
+        case async_operation::create_directory_operation:
+            if (!m_fs_ops_supported)
+                return false;
+            break;
+
+        default:
+            return false;
+        }
+
+        std::lock_guard< std::mutex > lock(m_mutex);
+        if (m_failed || m_free_slots.empty())
+            return false;
+
+        const unsigned int index = m_free_slots.back();
+        m_free_slots.pop_back();
+        m_slots[index].op = op;
+        prepare_request(index, 0u);
+        if (BOOST_UNLIKELY(!flush()))
+        {
+            release_slot(index);
+            return false;
+        }
+
+        return true;
+    }
+
+private:
+    static bool is_op_supported(io_uring_probe_info const& probe, unsigned int op) BOOST_NOEXCEPT
+    {
+        return op <= probe.last_op && op < probe.ops_len && (probe.ops[op].flags & io_uring_op_supported) != 0u;
+    }
+
+    //! Fills a submission queue entry for the operation in the slot. Must be called with the mutex locked.
+    void prepare_request(unsigned int index, unsigned int flags) BOOST_NOEXCEPT
+    {
+        slot& s = m_slots[index];
+        async_operation* const op = s.op;
+
+        const unsigned int tail = m_ring.sq_tail();
+        struct io_uring_sqe* sqe = m_ring.get_sqe(tail);
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->fd = AT_FDCWD;
+        sqe->addr = reinterpret_cast< boost::uint64_t >(op->path1.c_str());
+        sqe->user_data = index;
+
+        switch (op->kind)
+        {
+        case async_operation::status_operation:
+        case async_operation::symlink_status_operation:
+            sqe->opcode = IORING_OP_STATX;
+            sqe->len = STATX_TYPE | STATX_MODE;
+            sqe->off = reinterpret_cast< boost::uint64_t >(&s.stx);
+            sqe->statx_flags = AT_NO_AUTOMOUNT | (op->kind == async_operation::symlink_status_operation ? AT_SYMLINK_NOFOLLOW : 0);
+            break;
+
+        case async_operation::remove_operation:
+            sqe->opcode = IORING_OP_UNLINKAT;
+            sqe->unlink_flags = flags;
+            break;
+
+        case async_operation::rename_operation:
+            sqe->opcode = IORING_OP_RENAMEAT;
+            sqe->len = static_cast< boost::uint32_t >(AT_FDCWD);
+            sqe->off = reinterpret_cast< boost::uint64_t >(op->path2.c_str());
+            break;
+
+        default: // async_operation::create_directory_operation
+            sqe->opcode = IORING_OP_MKDIRAT;
+            sqe->len = S_IRWXU | S_IRWXG | S_IRWXO;
+            break;
+        }
+
+        m_ring.set_sq_tail(tail + 1u);
+        ++m_unsubmitted;
+    }
+
+    //! Passes the pending submission queue entries to the kernel. Must be called with the mutex locked. Returns \c false if
+    //! io_uring has failed, in which case the entries not consumed by the kernel are discarded.
+    bool flush() BOOST_NOEXCEPT
+    {
+        while (m_unsubmitted > 0u)
+        {
+            const int res = m_ring.enter(m_unsubmitted, 0u);
+            if (BOOST_LIKELY(res >= 0))
+            {
+                m_unsubmitted -= static_cast< unsigned int >(res);
+                continue;
+            }
+
+            // The number of requests in flight is limited by the number of slots, so the completion queue cannot overflow.
+            // These errors indicate temporary resource shortage.
+            const int err = errno;
+            if (err == EINTR || err == EAGAIN || err == EBUSY || err == ENOMEM)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            // The kernel only reads the submission queue in io_uring_enter, so the entries can be taken back
+            m_ring.set_sq_tail(m_ring.sq_tail() - m_unsubmitted);
+            m_unsubmitted = 0u;
+            m_failed = true;
+            return false;
+        }
+
+        return true;
+    }
+
+    //! Frees the slot and returns its operation. Must be called with the mutex locked.
+    async_operation* release_slot(unsigned int index) BOOST_NOEXCEPT
+    {
+        async_operation* op = m_slots[index].op;
+        m_slots[index].op = NULL;
+        m_free_slots.push_back(index);
+        return op;
+    }
+
+    //! Processes the request completion. Returns \c true if the operation is complete and \c false if it needs to be performed synchronously.
+    bool process_result(unsigned int index, int res)
+    {
+        async_operation* const op = m_slots[index].op;
+        const int err = -res;
+
+        // The kernel may reject arguments it does not support, let the synchronous implementation handle such cases
+        if (res < 0 && (err == EINVAL || err == EOPNOTSUPP || err == ENOSYS))
+            return false;
+
+        switch (op->kind)
+        {
+        case async_operation::status_operation:
+        case async_operation::symlink_status_operation:
+            op->status = make_statx_status(res, m_slots[index].stx);
+            if (res < 0)
+                op->error.assign(err, system::system_category());
+            else if (BOOST_UNLIKELY(op->status.type() == status_error))
+                op->error.assign(ENOTSUP, system::system_category());
+            break;
+
+        case async_operation::remove_operation:
+            if (res < 0)
+            {
+                if (err == ENOENT || err == ENOTDIR)
+                    break;
+
+                // The file is a directory, retry removing it as such
+                if (err == EISDIR)
+                {
+                    std::lock_guard< std::mutex > lock(m_mutex);
+                    prepare_request(index, AT_REMOVEDIR);
+                    // If io_uring has failed, remove the directory synchronously
+                    return flush();
+                }
+
+                op->error.assign(err, system::system_category());
+                break;
+            }
+
+            op->result = true;
+            break;
+
+        case async_operation::rename_operation:
+            if (res < 0)
+                op->error.assign(err, system::system_category());
+            break;
+
+        default: // async_operation::create_directory_operation
+            if (res < 0)
+            {
+                // The synchronous implementation checks whether the existing file is a directory
+                if (err == EEXIST)
+                    return false;
+
+                op->error.assign(err, system::system_category());
+                break;
+            }
+
+            op->result = true;
+            break;
+        }
+
+        op->done = true;
+        return true;
+    }
+
+    //! Completion thread function
+    void run() BOOST_NOEXCEPT;
+};
+
+#endif // defined(BOOST_FILESYSTEM_USE_ASYNC_IO_URING)
+
+//! Implementation of the asynchronous context
+class async_context_impl
+{
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_work_cond;
+    std::condition_variable m_idle_cond;
+    async_operation* m_queue_head;
+    async_operation* m_queue_tail;
+    //! Number of started operations whose completion handlers have not returned yet
+    std::size_t m_pending;
+    bool m_stop;
+    std::vector< std::thread > m_threads;
+
+#if defined(BOOST_FILESYSTEM_USE_ASYNC_IO_URING)
+    async_io_uring_backend* m_io_uring;
+#endif
+
+public:
+    explicit async_context_impl(unsigned int thread_count) :
+        m_queue_head(NULL),
+        m_queue_tail(NULL),
+        m_pending(0u),
+        m_stop(false)
+#if defined(BOOST_FILESYSTEM_USE_ASYNC_IO_URING)
+        , m_io_uring(NULL)
+#endif
+    {
+        // The context owns its threads, so they are not limited by the current executor
+        thread_count = get_thread_count(thread_count, &get_default_executor());
+        m_threads.reserve(thread_count);
+        try
+        {
+            for (unsigned int i = 0u; i < thread_count; ++i)
+                m_threads.push_back(std::thread(&async_context_impl::run, this));
+        }
+        catch (...)
+        {
+            // Proceed with the threads we managed to start
+            if (m_threads.empty())
+                throw;
+        }
+
+#if defined(BOOST_FILESYSTEM_USE_ASYNC_IO_URING)
+        try
+        {
+            async_io_uring_backend* backend = new async_io_uring_backend(*this);
+            if (backend->init())
+                m_io_uring = backend;
+            else
+                delete backend;
+        }
+        catch (...)
+        {
+            // Use the thread pool for all operations
+        }
+#endif
+    }
+
+    ~async_context_impl()
+    {
+        wait();
+
+#if defined(BOOST_FILESYSTEM_USE_ASYNC_IO_URING)
+        delete m_io_uring;
+#endif
+
+        {
+            std::lock_guard< std::mutex > lock(m_mutex);
+            m_stop = true;
+        }
+        m_work_cond.notify_all();
+
+        for (std::size_t i = 0u, n = m_threads.size(); i < n; ++i)
+            m_threads[i].join();
+    }
+
+    BOOST_DELETED_FUNCTION(async_context_impl(async_context_impl const&))
+    BOOST_DELETED_FUNCTION(async_context_impl& operator=(async_context_impl const&))
+
+    //! Starts the operation
+    void submit(async_operation* op) BOOST_NOEXCEPT
+    {
+        {
+            std::lock_guard< std::mutex > lock(m_mutex);
+            ++m_pending;
+        }
+
+#if defined(BOOST_FILESYSTEM_USE_ASYNC_IO_URING)
+        if (m_io_uring && m_io_uring->submit(op))
+            return;
+#endif
+
+        post(op);
+    }
+
+    //! Queues the operation for execution or invoking the completion handler in a worker thread
+    void post(async_operation* op) BOOST_NOEXCEPT
+    {
+        op->next = NULL;
+        {
+            std::lock_guard< std::mutex > lock(m_mutex);
+            if (m_queue_tail)
+                m_queue_tail->next = op;
+            else
+                m_queue_head = op;
+            m_queue_tail = op;
+        }
+        m_work_cond.notify_one();
+    }
+
+    //! Waits until there are no pending operations
+    void wait()
+    {
+        std::unique_lock< std::mutex > lock(m_mutex);
+        while (m_pending > 0u)
+            m_idle_cond.wait(lock);
+    }
+
+private:
+    //! Worker thread function
+    void run() BOOST_NOEXCEPT
+    {
+        std::unique_lock< std::mutex > lock(m_mutex);
+        while (true)
+        {
+            while (!m_queue_head && !m_stop)
+                m_work_cond.wait(lock);
+
+            async_operation* op = m_queue_head;
+            if (!op)
+                break;
+
+            m_queue_head = op->next;
+            if (!m_queue_head)
+                m_queue_tail = NULL;
+
+            lock.unlock();
+
+            if (!op->done)
+                execute_operation(op);
+            op->complete();
+
+            lock.lock();
+            if (--m_pending == 0u)
+                m_idle_cond.notify_all();
+        }
+    }
+};
+
+#if defined(BOOST_FILESYSTEM_USE_ASYNC_IO_URING)
+
+void async_io_uring_backend::run() BOOST_NOEXCEPT
+{
+    while (true)
+    {
+        const int res = m_ring.enter(0u, 1u);
+        if (BOOST_UNLIKELY(res < 0))
+        {
+            const int err = errno;
+            if (err != EINTR && err != EAGAIN && err != EBUSY)
+            {
+                // The completions of the requests in flight will not be received. Perform the operations synchronously
+                // in the worker threads, so that their completion handlers are called, and stop accepting new operations.
+                std::lock_guard< std::mutex > lock(m_mutex);
+                m_failed = true;
+                m_completion_failed = true;
+                for (unsigned int i = 0u; i < async_io_uring_queue_depth; ++i)
+                {
+                    if (m_slots[i].op)
+                        m_context.post(release_slot(i));
+                }
+
+                return;
+            }
+        }
+
+        unsigned int head = m_ring.cq_head();
+        const unsigned int tail = m_ring.cq_tail();
+        for (; head != tail; ++head)
+        {
+            struct io_uring_cqe const& cqe = m_ring.get_cqe(head);
+            if (cqe.user_data == async_io_uring_stop_marker)
+            {
+                m_ring.set_cq_head(head + 1u);
+                return;
+            }
+
+            const unsigned int index = static_cast< unsigned int >(cqe.user_data);
+            async_operation* op;
+            {
+                // Synchronize with the thread that submitted the request
+                std::lock_guard< std::mutex > lock(m_mutex);
+                op = m_slots[index].op;
+            }
+            const int cqe_res = cqe.res;
+            // The request may be resubmitted using the same slot, so the completion entry must be consumed first
+            m_ring.set_cq_head(head + 1u);
+
+            bool completed;
+            try
+            {
+                completed = process_result(index, cqe_res);
+            }
+            catch (...)
+            {
+                completed = false;
+            }
+
+            if (completed && !op->done)
+                continue; // the request was resubmitted
+
+            {
+                std::lock_guard< std::mutex > lock(m_mutex);
+                release_slot(index);
+            }
+
+            // Invoke the completion handler or perform the operation synchronously in a worker thread
+            m_context.post(op);
+        }
+    }
+}
+
+#endif // defined(BOOST_FILESYSTEM_USE_ASYNC_IO_URING)
+
+#else // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+//! Implementation of the asynchronous context that performs operations synchronously
+class async_context_impl
+{
+public:
+    explicit async_context_impl(unsigned int) BOOST_NOEXCEPT {}
+
+    void submit(async_operation* op) BOOST_NOEXCEPT
+    {
+        execute_operation(op);
+        op->complete();
+    }
+
+    void wait() BOOST_NOEXCEPT {}
+};
+
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+} // namespace detail
+
+BOOST_FILESYSTEM_DECL async_context::async_context(unsigned int thread_count) :
+    m_impl(new detail::async_context_impl(thread_count))
+{
+}
+
+BOOST_FILESYSTEM_DECL async_context::~async_context()
+{
+    delete m_impl;
+}
+
+BOOST_FILESYSTEM_DECL void async_context::wait()
+{
+    m_impl->wait();
+}
+
+BOOST_FILESYSTEM_DECL void async_context::submit(detail::async_operation* op)
+{
+    m_impl->submit(op);
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // defined(BOOST_FILESYSTEM_HAS_ASYNC_CONTEXT)
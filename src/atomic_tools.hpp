@@ -36,6 +36,41 @@ BOOST_FORCEINLINE void atomic_store_relaxed(T& a, T val)
     atomic_ns::atomic_ref< T >(a).store(val, atomic_ns::memory_order_relaxed);
 }
 
+//! Atomically adds \a val to the value and returns the previous value
+template< typename T >
+BOOST_FORCEINLINE T atomic_fetch_add_relaxed(T& a, T val)
+{
+    return atomic_ns::atomic_ref< T >(a).fetch_add(val, atomic_ns::memory_order_relaxed);
+}
+
+//! Atomically subtracts \a val from the value and returns the previous value
+template< typename T >
+BOOST_FORCEINLINE T atomic_fetch_sub_relaxed(T& a, T val)
+{
+    return atomic_ns::atomic_ref< T >(a).fetch_sub(val, atomic_ns::memory_order_relaxed);
+}
+
+//! Atomically loads the value with acquire semantics
+template< typename T >
+BOOST_FORCEINLINE T atomic_load_acquire(T& a)
+{
+    return atomic_ns::atomic_ref< T >(a).load(atomic_ns::memory_order_acquire);
+}
+
+//! Atomically stores the value with release semantics
+template< typename T >
+BOOST_FORCEINLINE void atomic_store_release(T& a, T val)
+{
+    atomic_ns::atomic_ref< T >(a).store(val, atomic_ns::memory_order_release);
+}
+
+//! Atomically replaces the value with \a val and returns the previous value, with acquire and release semantics
+template< typename T >
+BOOST_FORCEINLINE T atomic_exchange_acq_rel(T& a, T val)
+{
+    return atomic_ns::atomic_ref< T >(a).exchange(val, atomic_ns::memory_order_acq_rel);
+}
+
 } // namespace detail
 } // namespace filesystem
 } // namespace boost
@@ -60,6 +95,47 @@ BOOST_FORCEINLINE void atomic_store_relaxed(T& a, T val)
     a = val;
 }
 
+//! Atomically adds \a val to the value and returns the previous value
+template< typename T >
+BOOST_FORCEINLINE T atomic_fetch_add_relaxed(T& a, T val)
+{
+    T old = a;
+    a += val;
+    return old;
+}
+
+//! Atomically subtracts \a val from the value and returns the previous value
+template< typename T >
+BOOST_FORCEINLINE T atomic_fetch_sub_relaxed(T& a, T val)
+{
+    T old = a;
+    a -= val;
+    return old;
+}
+
+//! Atomically loads the value with acquire semantics
+template< typename T >
+BOOST_FORCEINLINE T atomic_load_acquire(T const& a)
+{
+    return a;
+}
+
+//! Atomically stores the value with release semantics
+template< typename T >
+BOOST_FORCEINLINE void atomic_store_release(T& a, T val)
+{
+    a = val;
+}
+
+//! Atomically replaces the value with \a val and returns the previous value, with acquire and release semantics
+template< typename T >
+BOOST_FORCEINLINE T atomic_exchange_acq_rel(T& a, T val)
+{
+    T old = a;
+    a = val;
+    return old;
+}
+
 } // namespace detail
 } // namespace filesystem
 } // namespace boost
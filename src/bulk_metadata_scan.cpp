@@ -0,0 +1,537 @@
+//  bulk_metadata_scan.cpp  ------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory_handle.hpp>
+#include <boost/filesystem/parallel_walk.hpp>
+#include <boost/filesystem/backends.hpp>
+
+#include <cstddef>
+#include <new> // std::bad_alloc
+#include <set>
+#include <utility> // std::pair
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/system/error_code.hpp>
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+#include <mutex>
+#endif
+
+#if defined(linux) || defined(__linux) || defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <sys/vfs.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "posix_tools.hpp"
+#include "atomic_tools.hpp"
+#define BOOST_FILESYSTEM_HAS_XFS_BULKSTAT
+#endif
+
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+namespace {
+
+//! Common state of a bulk metadata scan
+struct bulk_scan_state
+{
+    path const& mount;
+    const unsigned int thread_count;
+    bulk_metadata_handler* const handler;
+    void* const handler_context;
+    //! Number of reported files
+    uintmax_t count;
+    system::error_code error;
+    path error_path;
+
+    bulk_scan_state(path const& m, unsigned int threads, bulk_metadata_handler* h, void* ctx) :
+        mount(m),
+        thread_count(threads),
+        handler(h),
+        handler_context(ctx),
+        count(0u)
+    {
+    }
+
+    BOOST_DELETED_FUNCTION(bulk_scan_state(bulk_scan_state const&))
+    BOOST_DELETED_FUNCTION(bulk_scan_state& operator=(bulk_scan_state const&))
+};
+
+//! Common state of the tree walk, shared between the threads of the walk
+class tree_scan_context
+{
+private:
+    //! File attributes reported by the scan
+    static BOOST_CONSTEXPR_OR_CONST unsigned int query_mask = static_cast< unsigned int >(file_attribute_mask::all) |
+        static_cast< unsigned int >(file_attribute_mask::no_follow);
+
+private:
+    bulk_scan_state& m_state;
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+    std::mutex m_mutex;
+#endif
+    //! Device and inode numbers of the already reported files with multiple hard links
+    std::set< std::pair< uintmax_t, uintmax_t > > m_linked_files;
+
+public:
+    explicit tree_scan_context(bulk_scan_state& state) BOOST_NOEXCEPT : m_state(state) {}
+
+    BOOST_DELETED_FUNCTION(tree_scan_context(tree_scan_context const&))
+    BOOST_DELETED_FUNCTION(tree_scan_context& operator=(tree_scan_context const&))
+
+public:
+    //! Reports the root of the tree. Returns \c false if the scan should be stopped. Must be called before the walk.
+    bool add_root(file_attributes& attrs)
+    {
+        std::vector< file_attributes > batch(1u, attrs);
+        ++m_state.count;
+        return m_state.handler(m_state.handler_context, batch);
+    }
+
+    //! Walker batch handler
+    static bool on_batch(void* context, std::vector< directory_entry >& batch)
+    {
+        return static_cast< tree_scan_context* >(context)->add_batch(batch);
+    }
+
+private:
+    bool add_batch(std::vector< directory_entry >& batch) BOOST_NOEXCEPT
+    {
+        system::error_code ec;
+        path const* failed = NULL;
+        std::vector< file_attributes > attrs_batch;
+        try
+        {
+            attrs_batch.reserve(batch.size());
+
+            // All entries of the batch belong to the same directory, query them relative to it to avoid resolving the whole path for every file
+#if defined(BOOST_POSIX_API) && !defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+            directory_handle dir;
+#else
+            directory_handle dir(batch.front().path().parent_path(), ec);
+#endif
+            for (std::size_t i = 0u, n = batch.size(); i < n; ++i)
+            {
+                path const& p = batch[i].path();
+                file_attributes attrs = dir.is_open() ? dir.query(p.filename(), static_cast< BOOST_SCOPED_ENUM_NATIVE(file_attribute_mask) >(query_mask), ec) :
+                    detail::query(p, query_mask, &ec);
+                if (BOOST_UNLIKELY(!!ec))
+                {
+                    // The file may have been removed since the directory was read
+                    if (ec == system::errc::no_such_file_or_directory)
+                        continue;
+
+                    failed = &p;
+                    goto fail;
+                }
+
+                attrs_batch.push_back(attrs);
+            }
+
+            if (!merge(attrs_batch))
+                return true;
+        }
+        catch (std::bad_alloc&)
+        {
+            ec = make_error_code(system::errc::not_enough_memory);
+            failed = &batch.front().path();
+            goto fail;
+        }
+
+        return m_state.handler(m_state.handler_context, attrs_batch);
+
+    fail:
+        set_error(ec, *failed);
+        return false;
+    }
+
+    //! Removes the already reported files with multiple hard links from \a batch and counts the remaining files. Returns \c false if the batch is empty.
+    bool merge(std::vector< file_attributes >& batch)
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        std::size_t n = 0u;
+        for (std::size_t i = 0u, size = batch.size(); i < size; ++i)
+        {
+            file_attributes const& attrs = batch[i];
+            const unsigned int mask = static_cast< unsigned int >(attrs.mask);
+            if (attrs.hard_link_count > 1u && attrs.status.type() != directory_file &&
+                (mask & static_cast< unsigned int >(file_attribute_mask::inode)) != 0u &&
+                (mask & static_cast< unsigned int >(file_attribute_mask::device)) != 0u &&
+                !m_linked_files.insert(std::pair< uintmax_t, uintmax_t >(attrs.device, attrs.inode)).second)
+            {
+                continue;
+            }
+
+            if (n != i)
+                batch[n] = attrs;
+            ++n;
+        }
+
+        batch.resize(n);
+        m_state.count += n;
+        return n > 0u;
+    }
+
+    void set_error(system::error_code const& err, path const& p) BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        if (!m_state.error)
+        {
+            m_state.error = err;
+            try
+            {
+                m_state.error_path = p;
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+};
+
+//! Scans the metadata by enumerating the directory tree
+void bulk_scan_tree_walk(bulk_scan_state& state)
+{
+    tree_scan_context ctx(state);
+
+    // Follow the symlink to the root directory, like directory_iterator does
+    file_attributes root_attrs = detail::query(state.mount, static_cast< unsigned int >(file_attribute_mask::all), &state.error);
+    if (BOOST_UNLIKELY(!!state.error))
+    {
+        state.error_path = state.mount;
+        return;
+    }
+
+    if (!ctx.add_root(root_attrs) || root_attrs.status.type() != directory_file)
+        return;
+
+    parallel_walk_params params;
+    params.thread_count = state.thread_count;
+    params.batch_size = parallel_directory_walker::default_batch_size;
+    params.options = static_cast< unsigned int >(directory_options::_detail_same_filesystem);
+    params.exec = NULL;
+
+    system::error_code ec;
+    detail::parallel_walk(state.mount, params, &tree_scan_context::on_batch, &ctx, &ec);
+    if (BOOST_UNLIKELY(!!ec) && !state.error)
+    {
+        state.error = ec;
+        state.error_path = state.mount;
+    }
+}
+
+#if defined(BOOST_FILESYSTEM_HAS_XFS_BULKSTAT)
+
+//! XFS_SUPER_MAGIC definition from linux/magic.h
+BOOST_CONSTEXPR_OR_CONST unsigned long xfs_super_magic = 0x58465342ul;
+
+//! Number of inodes requested with one XFS_IOC_BULKSTAT call
+BOOST_CONSTEXPR_OR_CONST unsigned int xfs_bulkstat_batch_size = 1024u;
+
+//! struct xfs_bulk_ireq definition from xfs/xfs_fs.h. Supported since Linux 5.4.
+struct xfs_bulk_ireq
+{
+    boost::uint64_t ino;
+    boost::uint32_t flags;
+    boost::uint32_t icount;
+    boost::uint32_t ocount;
+    boost::uint32_t agno;
+    boost::uint64_t reserved[5];
+};
+
+//! struct xfs_bulkstat definition from xfs/xfs_fs.h
+struct xfs_bulkstat
+{
+    boost::uint64_t bs_ino;
+    boost::uint64_t bs_size;
+    boost::uint64_t bs_blocks;
+    boost::uint64_t bs_xflags;
+    boost::int64_t bs_atime;
+    boost::int64_t bs_mtime;
+    boost::int64_t bs_ctime;
+    boost::int64_t bs_btime;
+    boost::uint32_t bs_gen;
+    boost::uint32_t bs_uid;
+    boost::uint32_t bs_gid;
+    boost::uint32_t bs_projectid;
+    boost::uint32_t bs_atime_nsec;
+    boost::uint32_t bs_mtime_nsec;
+    boost::uint32_t bs_ctime_nsec;
+    boost::uint32_t bs_btime_nsec;
+    boost::uint32_t bs_blksize;
+    boost::uint32_t bs_rdev;
+    boost::uint32_t bs_cowextsize_blks;
+    boost::uint32_t bs_extsize_blks;
+    boost::uint32_t bs_nlink;
+    boost::uint32_t bs_extents;
+    boost::uint32_t bs_aextents;
+    boost::uint16_t bs_version;
+    boost::uint16_t bs_forkoff;
+    boost::uint16_t bs_sick;
+    boost::uint16_t bs_checked;
+    boost::uint16_t bs_mode;
+    boost::uint16_t bs_pad2;
+    boost::uint64_t bs_pad[7];
+};
+
+BOOST_STATIC_ASSERT_MSG(sizeof(xfs_bulk_ireq) == 64u, "xfs_bulk_ireq must match the kernel definition");
+BOOST_STATIC_ASSERT_MSG(sizeof(xfs_bulkstat) == 192u, "xfs_bulkstat must match the kernel definition");
+
+//! XFS_IOC_BULKSTAT definition from xfs/xfs_fs.h, the argument is struct xfs_bulkstat_req, which starts with struct xfs_bulk_ireq
+#define BOOST_FILESYSTEM_XFS_IOC_BULKSTAT _IOR('X', 127, boost::filesystem::detail::xfs_bulk_ireq)
+
+//! Scans the metadata of the filesystem. Returns \c false if the filesystem is not XFS, \a state.mount is not its root
+//! or bulkstat is not permitted, in which case no files have been reported.
+bool bulk_scan_xfs(bulk_scan_state& state)
+{
+    fd_wrapper fd(::open(state.mount.c_str(), O_RDONLY | O_DIRECTORY | O_NOCTTY | O_CLOEXEC));
+    if (fd.fd < 0)
+        return false;
+
+    struct ::statfs sfs;
+    if (::fstatfs(fd.fd, &sfs) < 0 || static_cast< unsigned long >(sfs.f_type) != xfs_super_magic)
+        return false;
+
+    // Bulkstat reports all inodes of the filesystem, which only matches the tree if the tree is the whole filesystem
+    struct ::stat st, parent_st;
+    if (::fstat(fd.fd, &st) < 0 || ::fstatat(fd.fd, "..", &parent_st, 0) < 0)
+        return false;
+    if (parent_st.st_dev == st.st_dev && parent_st.st_ino != st.st_ino)
+        return false;
+
+    std::vector< unsigned char > buffer(sizeof(xfs_bulk_ireq) + xfs_bulkstat_batch_size * sizeof(xfs_bulkstat));
+    std::vector< file_attributes > batch;
+    batch.reserve(xfs_bulkstat_batch_size);
+
+    const unsigned int mask = static_cast< unsigned int >(file_attribute_mask::type) | static_cast< unsigned int >(file_attribute_mask::permissions) |
+        static_cast< unsigned int >(file_attribute_mask::size) | static_cast< unsigned int >(file_attribute_mask::last_write_time) |
+        static_cast< unsigned int >(file_attribute_mask::last_access_time) | static_cast< unsigned int >(file_attribute_mask::hard_link_count) |
+        static_cast< unsigned int >(file_attribute_mask::inode) | static_cast< unsigned int >(file_attribute_mask::device) |
+        static_cast< unsigned int >(file_attribute_mask::owner) | static_cast< unsigned int >(file_attribute_mask::allocated_size);
+
+    xfs_bulk_ireq request;
+    std::memset(&request, 0, sizeof(request));
+    while (true)
+    {
+        request.icount = xfs_bulkstat_batch_size;
+        request.ocount = 0u;
+        std::memcpy(&buffer[0], &request, sizeof(request));
+
+        if (::ioctl(fd.fd, BOOST_FILESYSTEM_XFS_IOC_BULKSTAT, &buffer[0]) < 0)
+        {
+            const int err = errno;
+            if (err == EINTR)
+                continue;
+
+            // EPERM if the process lacks CAP_SYS_ADMIN, ENOTTY or EINVAL if the kernel does not support bulkstat version 5
+            if (state.count == 0u && (err == EPERM || err == EACCES || err == ENOTTY || err == EINVAL || err == EOPNOTSUPP || err == ENOSYS))
+                return false;
+
+            state.error = system::error_code(err, system::system_category());
+            state.error_path = state.mount;
+            return true;
+        }
+
+        std::memcpy(&request, &buffer[0], sizeof(request));
+        if (request.ocount == 0u)
+            break;
+
+        batch.clear();
+        const unsigned char* records = &buffer[sizeof(xfs_bulk_ireq)];
+        for (boost::uint32_t i = 0u; i < request.ocount; ++i)
+        {
+            xfs_bulkstat bs;
+            std::memcpy(&bs, records + i * sizeof(xfs_bulkstat), sizeof(bs));
+
+            // Files that are open but no longer linked to any directory are not part of the tree
+            if (bs.bs_nlink == 0u)
+                continue;
+
+            file_attributes attrs;
+            attrs.mask = static_cast< BOOST_SCOPED_ENUM_NATIVE(file_attribute_mask) >(mask);
+            attrs.status = make_file_status(static_cast< mode_t >(bs.bs_mode));
+            attrs.size = static_cast< uintmax_t >(bs.bs_size);
+            attrs.allocated_size = static_cast< uintmax_t >(bs.bs_blocks) * bs.bs_blksize;
+            attrs.last_write_time = static_cast< std::time_t >(bs.bs_mtime);
+            attrs.last_write_time_nsec = bs.bs_mtime_nsec;
+            attrs.last_access_time = static_cast< std::time_t >(bs.bs_atime);
+            attrs.last_access_time_nsec = bs.bs_atime_nsec;
+            if (bs.bs_btime != 0)
+            {
+                attrs.mask |= file_attribute_mask::creation_time;
+                attrs.creation_time = static_cast< std::time_t >(bs.bs_btime);
+                attrs.creation_time_nsec = bs.bs_btime_nsec;
+            }
+            attrs.hard_link_count = bs.bs_nlink;
+            attrs.inode = static_cast< uintmax_t >(bs.bs_ino);
+            attrs.device = static_cast< uintmax_t >(st.st_dev);
+            attrs.owner_id = bs.bs_uid;
+            attrs.group_id = bs.bs_gid;
+            batch.push_back(attrs);
+        }
+
+        if (!batch.empty())
+        {
+            state.count += batch.size();
+            if (!state.handler(state.handler_context, batch))
+                break;
+        }
+    }
+
+    return true;
+}
+
+//! Filesystem-specific scan implementation. Returns \c false if the implementation is not applicable, in which case the tree is walked instead.
+typedef bool bulk_scan_t(bulk_scan_state& state);
+
+//! Filesystem-specific scan implementation that never applies
+bool bulk_scan_none(bulk_scan_state&)
+{
+    return false;
+}
+
+bool bulk_scan_select_impl(bulk_scan_state& state);
+
+//! Pointer to the filesystem-specific scan implementation. Initialized to the implementation selector, which is replaced on the first call.
+bulk_scan_t* bulk_scan_fs_specific = &bulk_scan_select_impl;
+
+//! Selects the filesystem-specific scan implementation based on the kernel version
+bulk_scan_t* init_bulk_scan_impl() BOOST_NOEXCEPT
+{
+    bulk_scan_t* impl = &bulk_scan_none;
+
+    // XFS_IOC_BULKSTAT with struct xfs_bulk_ireq appeared in Linux 5.4
+    unsigned int major_ver = 0u, minor_ver = 0u, patch_ver = 0u;
+    if (get_linux_kernel_version(major_ver, minor_ver, patch_ver) && (major_ver > 5u || (major_ver == 5u && minor_ver >= 4u)))
+        impl = &bulk_scan_xfs;
+
+    filesystem::detail::atomic_store_relaxed(bulk_scan_fs_specific, impl);
+    return impl;
+}
+
+//! Selects the filesystem-specific scan implementation on the first call and forwards the call to it
+bool bulk_scan_select_impl(bulk_scan_state& state)
+{
+    return init_bulk_scan_impl()(state);
+}
+
+#endif // defined(BOOST_FILESYSTEM_HAS_XFS_BULKSTAT)
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL
+uintmax_t bulk_metadata_scan(path const& mount, unsigned int thread_count, bulk_metadata_handler* handler, void* context, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    bulk_scan_state state(mount, thread_count, handler, context);
+    try
+    {
+#if defined(BOOST_FILESYSTEM_HAS_XFS_BULKSTAT)
+        bulk_scan_t* impl = filesystem::detail::atomic_load_relaxed(bulk_scan_fs_specific);
+        if (!impl(state))
+#endif
+        {
+            bulk_scan_tree_walk(state);
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return state.count;
+    }
+
+    if (BOOST_UNLIKELY(!!state.error))
+    {
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::bulk_metadata_scan", state.error_path, state.error));
+        *ec = state.error;
+    }
+
+    return state.count;
+}
+
+} // namespace detail
+
+BOOST_FILESYSTEM_DECL
+bulk_scan_backend::type get_bulk_scan_backend() BOOST_NOEXCEPT
+{
+#if defined(BOOST_FILESYSTEM_HAS_XFS_BULKSTAT)
+    detail::bulk_scan_t* impl = filesystem::detail::atomic_load_relaxed(detail::bulk_scan_fs_specific);
+    if (impl == &detail::bulk_scan_select_impl)
+        impl = detail::init_bulk_scan_impl();
+    if (impl == &detail::bulk_scan_xfs)
+        return bulk_scan_backend::xfs_bulkstat;
+    return bulk_scan_backend::tree_walk;
+#else
+    // The tree walk is the only implementation
+    return bulk_scan_backend::system_default;
+#endif
+}
+
+BOOST_FILESYSTEM_DECL
+bool set_bulk_scan_backend(bulk_scan_backend::type backend) BOOST_NOEXCEPT
+{
+#if defined(BOOST_FILESYSTEM_HAS_XFS_BULKSTAT)
+    detail::bulk_scan_t* impl = NULL;
+    switch (backend)
+    {
+    case bulk_scan_backend::system_default:
+        impl = &detail::bulk_scan_select_impl;
+        break;
+    case bulk_scan_backend::tree_walk:
+        impl = &detail::bulk_scan_none;
+        break;
+    case bulk_scan_backend::xfs_bulkstat:
+        impl = &detail::bulk_scan_xfs;
+        break;
+    default:
+        return false;
+    }
+
+    filesystem::detail::atomic_store_relaxed(detail::bulk_scan_fs_specific, impl);
+    return true;
+#else
+    return backend == bulk_scan_backend::system_default || backend == bulk_scan_backend::tree_walk;
+#endif
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
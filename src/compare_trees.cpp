@@ -0,0 +1,621 @@
+//  compare_trees.cpp  -----------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory_handle.hpp>
+#include <boost/filesystem/mapped_file.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/parallel_walk.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <new> // std::bad_alloc
+#include <vector>
+#include <algorithm>
+#include <boost/system/error_code.hpp>
+
+#include "thread_tools.hpp"
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+#include <mutex>
+#include <atomic>
+#endif
+
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+namespace {
+
+//! Size of the buffers for reading file contents, unless the files are memory-mapped
+BOOST_CONSTEXPR_OR_CONST std::size_t compare_read_buffer_size = 1024u * 1024u;
+
+//! File attributes needed to compare files and to detect files that are the same file
+BOOST_CONSTEXPR_OR_CONST unsigned int compare_query_mask = static_cast< unsigned int >(file_attribute_mask::type) |
+    static_cast< unsigned int >(file_attribute_mask::size) | static_cast< unsigned int >(file_attribute_mask::inode) |
+    static_cast< unsigned int >(file_attribute_mask::device);
+
+//! Returns \c true if the attributes identify the same file
+inline bool same_file(file_attributes const& attrs1, file_attributes const& attrs2) BOOST_NOEXCEPT
+{
+    const unsigned int identity_mask = static_cast< unsigned int >(file_attribute_mask::inode) | static_cast< unsigned int >(file_attribute_mask::device);
+    return (static_cast< unsigned int >(attrs1.mask) & identity_mask) == identity_mask && (static_cast< unsigned int >(attrs2.mask) & identity_mask) == identity_mask &&
+        attrs1.device == attrs2.device && attrs1.inode == attrs2.inode;
+}
+
+//! Opens a file for reading the contents to compare
+bool open_for_compare(path const& p, filesystem::ifstream& file, system::error_code& ec)
+{
+    // Read directly into the comparison buffers
+    file.rdbuf()->pubsetbuf(NULL, 0);
+    file.open(p, std::ios_base::in | std::ios_base::binary);
+    if (BOOST_UNLIKELY(!file))
+    {
+        // Obtain the reason of the failure
+        detail::symlink_status(p, &ec);
+        if (!ec)
+            ec = make_error_code(system::errc::io_error);
+        return false;
+    }
+
+    return true;
+}
+
+//! Reads up to \a size bytes from \a file. Returns the number of bytes read.
+std::size_t read_for_compare(filesystem::ifstream& file, char* buf, std::size_t size, system::error_code& ec)
+{
+    file.read(buf, static_cast< std::streamsize >(size));
+    if (BOOST_UNLIKELY(file.bad()))
+    {
+        ec = make_error_code(system::errc::io_error);
+        return 0u;
+    }
+
+    return static_cast< std::size_t >(file.gcount());
+}
+
+//! Compares the contents of two regular files. Returns \c true if the contents are equal.
+bool compare_contents(path const& p1, path const& p2, bool memory_map, std::vector< char >& buffer, system::error_code& ec)
+{
+    if (memory_map)
+    {
+        mapped_file file1(p1, mapped_file_flags::sequential, ec);
+        if (BOOST_UNLIKELY(!!ec))
+            return false;
+        mapped_file file2(p2, mapped_file_flags::sequential, ec);
+        if (BOOST_UNLIKELY(!!ec))
+            return false;
+
+        return file1.size() == file2.size() && std::memcmp(file1.data(), file2.data(), file1.size()) == 0;
+    }
+
+    filesystem::ifstream file1, file2;
+    if (!open_for_compare(p1, file1, ec) || !open_for_compare(p2, file2, ec))
+        return false;
+
+    buffer.resize(compare_read_buffer_size * 2u);
+    char* const buf1 = &buffer[0];
+    char* const buf2 = buf1 + compare_read_buffer_size;
+    while (true)
+    {
+        // The file sizes are equal, unless the files are modified during comparison, so the files end at the same read
+        const std::size_t size1 = read_for_compare(file1, buf1, compare_read_buffer_size, ec);
+        if (BOOST_UNLIKELY(!!ec))
+            return false;
+        const std::size_t size2 = read_for_compare(file2, buf2, compare_read_buffer_size, ec);
+        if (BOOST_UNLIKELY(!!ec))
+            return false;
+
+        if (size1 != size2 || std::memcmp(buf1, buf2, size1) != 0)
+            return false;
+        if (size1 < compare_read_buffer_size)
+            return true;
+    }
+}
+
+//! Compares the targets of two symlinks
+bool compare_symlinks(path const& p1, path const& p2, system::error_code& ec)
+{
+    const path target1 = detail::read_symlink(p1, &ec);
+    if (BOOST_UNLIKELY(!!ec))
+        return false;
+    const path target2 = detail::read_symlink(p2, &ec);
+    if (BOOST_UNLIKELY(!!ec))
+        return false;
+
+    return target1.native() == target2.native();
+}
+
+//! A file found in one of the trees
+struct compare_entry
+{
+    //! Path of the file, relative to the root of the tree
+    path::string_type relative_path;
+    file_attributes attrs;
+
+    bool operator< (compare_entry const& that) const { return relative_path < that.relative_path; }
+};
+
+//! A pair of files whose contents need to be compared
+struct compare_job
+{
+    path path1;
+    path path2;
+    file_type type;
+    uintmax_t size;
+};
+
+//! Orders the jobs so that the largest files are compared first, which balances the work between threads
+struct compare_job_order
+{
+    bool operator() (compare_job const& left, compare_job const& right) const BOOST_NOEXCEPT
+    {
+        return left.size > right.size;
+    }
+};
+
+//! Common state of comparing two directory trees
+class trees_equal_context
+{
+private:
+    const unsigned int m_options;
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+    std::mutex m_mutex;
+    std::atomic< std::size_t > m_next_job;
+    std::atomic< bool > m_different;
+#else
+    std::size_t m_next_job;
+    bool m_different;
+#endif
+    //! Entries of the two trees
+    std::vector< compare_entry > m_entries[2];
+    std::vector< compare_job > m_jobs;
+    system::error_code m_error;
+    path m_error_path;
+
+public:
+    explicit trees_equal_context(unsigned int options) BOOST_NOEXCEPT :
+        m_options(options),
+        m_next_job(0u),
+        m_different(false)
+    {
+    }
+
+    BOOST_DELETED_FUNCTION(trees_equal_context(trees_equal_context const&))
+    BOOST_DELETED_FUNCTION(trees_equal_context& operator=(trees_equal_context const&))
+
+public:
+    system::error_code const& error() const BOOST_NOEXCEPT { return m_error; }
+    path const& error_path() const BOOST_NOEXCEPT { return m_error_path; }
+
+    bool is_different() const BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        return m_different.load(std::memory_order_relaxed);
+#else
+        return m_different;
+#endif
+    }
+
+    unsigned int query_options() const BOOST_NOEXCEPT
+    {
+        unsigned int mask = compare_query_mask;
+        if ((m_options & static_cast< unsigned int >(trees_equal_options::compare_permissions)) != 0u)
+            mask |= static_cast< unsigned int >(file_attribute_mask::permissions);
+        return mask;
+    }
+
+    //! Returns \c true if the attributes of the files in the two trees are equal, not considering their contents
+    bool attributes_equal(file_attributes const& attrs1, file_attributes const& attrs2) const BOOST_NOEXCEPT
+    {
+        const file_type type = attrs1.status.type();
+        if (type != attrs2.status.type())
+            return false;
+        if (type == regular_file && attrs1.size != attrs2.size)
+            return false;
+        if (type != symlink_file && (m_options & static_cast< unsigned int >(trees_equal_options::compare_permissions)) != 0u &&
+            attrs1.status.permissions() != attrs2.status.permissions())
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    //! Adds a pair of files to compare, unless they are the same file
+    void add_job(path const& p1, path const& p2, file_attributes const& attrs1, file_attributes const& attrs2)
+    {
+        const file_type type = attrs1.status.type();
+        if ((type != regular_file && type != symlink_file) || same_file(attrs1, attrs2) || (type == regular_file && attrs1.size == 0u))
+            return;
+
+        m_jobs.push_back(compare_job());
+        compare_job& job = m_jobs.back();
+        job.path1 = p1;
+        job.path2 = p2;
+        job.type = type;
+        job.size = attrs1.size;
+    }
+
+    //! Walks the tree \a root, which is one of the compared trees
+    bool walk(path const& root, unsigned int tree, executor* exec, unsigned int thread_count, system::error_code& ec)
+    {
+        walk_context ctx = { this, tree, 0u };
+        // The walker composes the paths of the entries by appending their names to the root path, so obtain the prefix
+        // of the paths the same way. This accounts for trailing separators in the root path.
+        ctx.prefix_size = (root / path("x")).native().size() - 1u;
+
+        parallel_walk_params params;
+        params.thread_count = thread_count;
+        params.batch_size = parallel_directory_walker::default_batch_size;
+        params.options = static_cast< unsigned int >(directory_options::none);
+        params.exec = exec;
+
+        detail::parallel_walk(root, params, &trees_equal_context::on_batch, &ctx, &ec);
+        return !ec && !has_error();
+    }
+
+    //! Compares the entries of the two trees and creates the jobs to compare the contents of the files. Returns \c false if the trees are different.
+    bool match(path const& root1, path const& root2)
+    {
+        std::vector< compare_entry >& entries1 = m_entries[0];
+        std::vector< compare_entry >& entries2 = m_entries[1];
+        if (entries1.size() != entries2.size())
+            return false;
+
+        std::sort(entries1.begin(), entries1.end());
+        std::sort(entries2.begin(), entries2.end());
+
+        for (std::size_t i = 0u, n = entries1.size(); i < n; ++i)
+        {
+            compare_entry const& entry1 = entries1[i];
+            compare_entry const& entry2 = entries2[i];
+            if (entry1.relative_path != entry2.relative_path || !attributes_equal(entry1.attrs, entry2.attrs))
+                return false;
+        }
+
+        for (std::size_t i = 0u, n = entries1.size(); i < n; ++i)
+        {
+            compare_entry const& entry = entries1[i];
+            const path relative(entry.relative_path);
+            add_job(root1 / relative, root2 / relative, entry.attrs, entries2[i].attrs);
+        }
+
+        // The entries are no longer needed
+        std::vector< compare_entry >().swap(entries1);
+        std::vector< compare_entry >().swap(entries2);
+
+        std::sort(m_jobs.begin(), m_jobs.end(), compare_job_order());
+        return true;
+    }
+
+    //! Returns the number of pairs of files whose contents need to be compared
+    std::size_t job_count() const BOOST_NOEXCEPT { return m_jobs.size(); }
+
+    //! Thread function, compares files until there are no more files, a difference is found or an error occurs
+    void operator() (unsigned int) BOOST_NOEXCEPT
+    {
+        const bool memory_map = (m_options & static_cast< unsigned int >(trees_equal_options::memory_map)) != 0u;
+        std::vector< char > buffer;
+        while (true)
+        {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+            const std::size_t index = m_next_job.fetch_add(1u, std::memory_order_relaxed);
+#else
+            const std::size_t index = m_next_job++;
+#endif
+            if (index >= m_jobs.size() || is_different() || has_error())
+                break;
+
+            compare_job const& job = m_jobs[index];
+            system::error_code ec;
+            bool equal;
+            try
+            {
+                equal = job.type == regular_file ? compare_contents(job.path1, job.path2, memory_map, buffer, ec) : compare_symlinks(job.path1, job.path2, ec);
+            }
+            catch (std::bad_alloc&)
+            {
+                ec = make_error_code(system::errc::not_enough_memory);
+                equal = false;
+            }
+
+            if (BOOST_UNLIKELY(!!ec))
+            {
+                set_error(ec, job.path1);
+                break;
+            }
+
+            if (!equal)
+            {
+                set_different();
+                break;
+            }
+        }
+    }
+
+private:
+    //! Context of walking one of the trees
+    struct walk_context
+    {
+        trees_equal_context* ctx;
+        unsigned int tree;
+        std::size_t prefix_size;
+    };
+
+    //! Walker batch handler
+    static bool on_batch(void* context, std::vector< directory_entry >& batch)
+    {
+        walk_context const& walk = *static_cast< walk_context* >(context);
+        return walk.ctx->add_batch(walk, batch);
+    }
+
+    bool add_batch(walk_context const& walk, std::vector< directory_entry >& batch) BOOST_NOEXCEPT
+    {
+        system::error_code ec;
+        path const* failed = NULL;
+        std::vector< compare_entry > entries;
+        try
+        {
+            // All entries of the batch belong to the same directory, query them relative to it to avoid resolving the whole path for every file
+#if defined(BOOST_POSIX_API) && !defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+            directory_handle dir;
+#else
+            directory_handle dir(batch.front().path().parent_path(), ec);
+#endif
+            const unsigned int mask = query_options() | static_cast< unsigned int >(file_attribute_mask::no_follow);
+            entries.reserve(batch.size());
+            for (std::size_t i = 0u, n = batch.size(); i < n; ++i)
+            {
+                path const& p = batch[i].path();
+                entries.push_back(compare_entry());
+                compare_entry& entry = entries.back();
+
+                path::string_type const& str = p.native();
+                std::size_t pos = walk.prefix_size;
+                while (pos < str.size() && detail::is_directory_separator(str[pos]))
+                    ++pos;
+                entry.relative_path.assign(str, pos, path::string_type::npos);
+
+                const file_type type = detail::get_cached_symlink_status(batch[i]).type();
+                if (type != regular_file && type != status_error && (mask & static_cast< unsigned int >(file_attribute_mask::permissions)) == 0u)
+                {
+                    // Only the type of the file is needed
+                    entry.attrs.status.type(type);
+                }
+                else
+                {
+                    entry.attrs = dir.is_open() ? dir.query(p.filename(), static_cast< BOOST_SCOPED_ENUM_NATIVE(file_attribute_mask) >(mask), ec) :
+                        detail::query(p, mask, &ec);
+                    if (BOOST_UNLIKELY(!!ec))
+                    {
+                        failed = &p;
+                        goto fail;
+                    }
+                }
+            }
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+            std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+            m_entries[walk.tree].insert(m_entries[walk.tree].end(), entries.begin(), entries.end());
+        }
+        catch (std::bad_alloc&)
+        {
+            ec = make_error_code(system::errc::not_enough_memory);
+            failed = &batch.front().path();
+            goto fail;
+        }
+
+        return true;
+
+    fail:
+        set_error(ec, *failed);
+        return false;
+    }
+
+    bool has_error() BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        return !!m_error;
+    }
+
+    void set_different() BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        m_different.store(true, std::memory_order_relaxed);
+#else
+        m_different = true;
+#endif
+    }
+
+    void set_error(system::error_code const& err, path const& p) BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        if (!m_error)
+        {
+            m_error = err;
+            try
+            {
+                m_error_path = p;
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+};
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL
+bool files_equal(path const& p1, path const& p2, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    system::error_code local_ec;
+    try
+    {
+        const file_attributes attrs1 = detail::query(p1, compare_query_mask, &local_ec);
+        if (BOOST_UNLIKELY(!!local_ec))
+            goto fail;
+
+        {
+            const file_attributes attrs2 = detail::query(p2, compare_query_mask, &local_ec);
+            if (BOOST_UNLIKELY(!!local_ec))
+                goto fail;
+
+            if (attrs1.status.type() != regular_file || attrs2.status.type() != regular_file)
+            {
+                local_ec = make_error_code(system::errc::invalid_argument);
+                goto fail;
+            }
+
+            if (same_file(attrs1, attrs2))
+                return true;
+            if (attrs1.size != attrs2.size)
+                return false;
+            if (attrs1.size == 0u)
+                return true;
+
+            std::vector< char > buffer;
+            const bool equal = compare_contents(p1, p2, false, buffer, local_ec);
+            if (BOOST_UNLIKELY(!!local_ec))
+                goto fail;
+
+            return equal;
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return false;
+    }
+
+fail:
+    if (!ec)
+        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::files_equal", p1, p2, local_ec));
+
+    *ec = local_ec;
+    return false;
+}
+
+BOOST_FILESYSTEM_DECL
+bool trees_equal(path const& p1, path const& p2, unsigned int options, unsigned int thread_count, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    system::error_code local_ec;
+    path const* err_path = &p1;
+    try
+    {
+        trees_equal_context ctx(options);
+
+        // Follow symlinks to the roots of the trees, like directory_iterator does
+        const file_attributes root_attrs1 = detail::query(p1, ctx.query_options(), &local_ec);
+        if (BOOST_UNLIKELY(!!local_ec))
+            goto fail;
+
+        {
+            const file_attributes root_attrs2 = detail::query(p2, ctx.query_options(), &local_ec);
+            if (BOOST_UNLIKELY(!!local_ec))
+            {
+                err_path = &p2;
+                goto fail;
+            }
+
+            if (same_file(root_attrs1, root_attrs2))
+                return true;
+            if (!ctx.attributes_equal(root_attrs1, root_attrs2))
+                return false;
+
+            if (root_attrs1.status.type() == directory_file)
+            {
+                if (ctx.walk(p1, 0u, NULL, thread_count, local_ec))
+                {
+                    err_path = &p2;
+                    ctx.walk(p2, 1u, NULL, thread_count, local_ec);
+                }
+
+                if (BOOST_UNLIKELY(!!local_ec))
+                    goto fail;
+
+                if (BOOST_LIKELY(!ctx.error()) && !ctx.match(p1, p2))
+                    return false;
+            }
+            else
+            {
+                ctx.add_job(p1, p2, root_attrs1, root_attrs2);
+            }
+
+            if (BOOST_LIKELY(!ctx.error()) && ctx.job_count() > 0u)
+            {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+                run_in_threads(static_cast< unsigned int >((std::min)(static_cast< std::size_t >(get_thread_count(thread_count)), ctx.job_count())), ctx);
+#else
+                ctx(0u);
+#endif
+            }
+
+            if (BOOST_UNLIKELY(!!ctx.error()))
+            {
+                if (!ec)
+                    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::trees_equal", ctx.error_path(), ctx.error()));
+                *ec = ctx.error();
+                return false;
+            }
+
+            return !ctx.is_different();
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return false;
+    }
+
+fail:
+    if (!ec)
+        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::trees_equal", *err_path, local_ec));
+
+    *ec = local_ec;
+    return false;
+}
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
@@ -0,0 +1,112 @@
+//  content_hash.hpp  ------------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_SRC_CONTENT_HASH_HPP_
+#define BOOST_FILESYSTEM_SRC_CONTENT_HASH_HPP_
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+//! Streaming 64-bit hash of file contents. The hash is not cryptographic, deduplicate compares files with equal hashes byte by byte.
+//! Updating the hash with consecutive chunks whose sizes are multiples of 8 gives the same result as updating it with the whole contents at once.
+class content_hash
+{
+private:
+    uint64_t m_state;
+
+public:
+    content_hash() BOOST_NOEXCEPT : m_state(static_cast< uint64_t >(0x243F6A8885A308D3ull)) {}
+
+    void update(const unsigned char* data, std::size_t size) BOOST_NOEXCEPT
+    {
+        const unsigned char* const end = data + (size & ~static_cast< std::size_t >(7u));
+        for (; data != end; data += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, data, sizeof(word));
+            mix(word);
+        }
+
+        size &= 7u;
+        if (size > 0u)
+        {
+            uint64_t word = 0u;
+            std::memcpy(&word, data, size);
+            mix(word);
+        }
+    }
+
+    uint64_t finish(uint64_t size) const BOOST_NOEXCEPT
+    {
+        // splitmix64 finalizer
+        uint64_t h = m_state ^ size;
+        h = (h ^ (h >> 30)) * static_cast< uint64_t >(0xBF58476D1CE4E5B9ull);
+        h = (h ^ (h >> 27)) * static_cast< uint64_t >(0x94D049BB133111EBull);
+        return h ^ (h >> 31);
+    }
+
+private:
+    void mix(uint64_t word) BOOST_NOEXCEPT
+    {
+        m_state ^= word * static_cast< uint64_t >(0x9E3779B97F4A7C15ull);
+        m_state = ((m_state << 31) | (m_state >> 33)) * static_cast< uint64_t >(0xBF58476D1CE4E5B9ull);
+    }
+};
+
+//! Identity and version of a file, which is used as the key of the hash cache
+struct file_version
+{
+    uint64_t device;
+    uint64_t inode;
+    uint64_t size;
+    int64_t mtime;
+    uint64_t mtime_nsec;
+
+    bool operator< (file_version const& that) const BOOST_NOEXCEPT
+    {
+        if (device != that.device)
+            return device < that.device;
+        if (inode != that.inode)
+            return inode < that.inode;
+        if (size != that.size)
+            return size < that.size;
+        if (mtime != that.mtime)
+            return mtime < that.mtime;
+        return mtime_nsec < that.mtime_nsec;
+    }
+};
+
+typedef std::map< file_version, uint64_t > hash_cache_map;
+
+//! Loads the hash cache. A missing or malformed cache file results in an empty cache.
+void load_hash_cache(path const& p, hash_cache_map& cache);
+
+//! Saves the hash cache to a temporary file and atomically replaces the cache file with it
+void save_hash_cache(path const& p, hash_cache_map const& cache, system::error_code* ec);
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_SRC_CONTENT_HASH_HPP_
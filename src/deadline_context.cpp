@@ -0,0 +1,609 @@
+//  deadline_context.cpp  --------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/deadline_context.hpp>
+
+#include <cstddef>
+#include <new> // std::bad_alloc
+#include <vector>
+#include <boost/system/error_code.hpp>
+
+#include "thread_tools.hpp"
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+#include <map>
+#include <deque>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#if defined(BOOST_POSIX_API)
+#if defined(linux) || defined(__linux) || defined(__linux__)
+#include <cstdio>
+#include <mntent.h>
+#define BOOST_FILESYSTEM_HAS_GETMNTENT
+#elif defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__) || defined(__DragonFly__) || (defined(__APPLE__) && defined(__MACH__))
+#include <sys/param.h>
+#include <sys/mount.h>
+#define BOOST_FILESYSTEM_HAS_GETMNTINFO
+#endif
+#endif // defined(BOOST_POSIX_API)
+
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+namespace {
+
+//! Operation performed by a deadline context
+struct deadline_operation
+{
+    enum operation_kind
+    {
+        status_operation,
+        symlink_status_operation,
+        space_operation,
+        directory_entries_operation
+    };
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+    enum operation_state
+    {
+        queued,
+        running,
+        completed
+    };
+
+    operation_state state;
+    //! Indicates that the caller stopped waiting for the operation, and the worker thread must destroy it
+    bool abandoned;
+    //! Indicates that the operation is counted as blocked in the mount \c mount
+    bool blocked;
+    //! The mount containing \c p
+    path mount;
+#endif
+
+    const operation_kind kind;
+    path p;
+    unsigned int options;
+
+    // Operation results
+    system::error_code error;
+    file_status status;
+    space_info space;
+    std::vector< directory_entry > entries;
+
+    deadline_operation(operation_kind k, path const& target, unsigned int opts) :
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        state(queued),
+        abandoned(false),
+        blocked(false),
+#endif
+        kind(k),
+        p(target),
+        options(opts)
+    {
+        space.capacity = space.free = space.available = static_cast< boost::uintmax_t >(-1);
+    }
+
+    //! Performs the operation in the current thread
+    void execute() BOOST_NOEXCEPT
+    {
+        try
+        {
+            switch (kind)
+            {
+            case status_operation:
+                status = detail::status(p, &error);
+                break;
+
+            case symlink_status_operation:
+                status = detail::symlink_status(p, &error);
+                break;
+
+            case space_operation:
+                space = detail::space(p, &error);
+                break;
+
+            case directory_entries_operation:
+                {
+                    directory_iterator it(p, static_cast< BOOST_SCOPED_ENUM_NATIVE(directory_options) >(options), error);
+                    while (!error && it != directory_iterator())
+                    {
+                        entries.push_back(*it);
+                        it.increment(error);
+                    }
+
+                    if (error)
+                        entries.clear();
+                }
+                break;
+            }
+        }
+        catch (std::bad_alloc&)
+        {
+            error = make_error_code(system::errc::not_enough_memory);
+            entries.clear();
+        }
+    }
+
+    BOOST_DELETED_FUNCTION(deadline_operation(deadline_operation const&))
+    BOOST_DELETED_FUNCTION(deadline_operation& operator=(deadline_operation const&))
+};
+
+//! Operation that is owned by the caller until it is abandoned to a worker thread
+struct deadline_operation_holder
+{
+    deadline_operation* op;
+
+    explicit deadline_operation_holder(deadline_operation* o) BOOST_NOEXCEPT : op(o) {}
+    ~deadline_operation_holder() BOOST_NOEXCEPT { delete op; }
+
+    BOOST_DELETED_FUNCTION(deadline_operation_holder(deadline_operation_holder const&))
+    BOOST_DELETED_FUNCTION(deadline_operation_holder& operator=(deadline_operation_holder const&))
+};
+
+} // namespace
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+namespace {
+
+//! Time after which an idle worker thread exits
+BOOST_CONSTEXPR_OR_CONST unsigned int deadline_worker_idle_timeout_ms = 10000u;
+//! Time after which the table of mounted filesystems is read again
+BOOST_CONSTEXPR_OR_CONST unsigned int deadline_mount_table_refresh_ms = 1000u;
+
+//! Returns \c true if \a p is \a mount or a path within \a mount
+inline bool is_within_mount(path::string_type const& p, path::string_type const& mount) BOOST_NOEXCEPT
+{
+    if (p.size() < mount.size() || p.compare(0u, mount.size(), mount) != 0)
+        return false;
+
+    return p.size() == mount.size() || detail::is_directory_separator(p[mount.size()]) ||
+        (!mount.empty() && detail::is_directory_separator(mount[mount.size() - 1u]));
+}
+
+} // namespace
+
+struct deadline_context::implementation
+{
+    typedef std::chrono::steady_clock clock;
+
+    mutable std::mutex mutex;
+    //! Notified when an operation is queued or the context is destroyed
+    std::condition_variable work_cond;
+    //! Notified when an operation completes
+    std::condition_variable completion_cond;
+    std::deque< deadline_operation* > queue;
+    //! Number of blocked operations for every stuck mount
+    std::map< path, std::size_t > stuck_mounts;
+    std::size_t blocked_count;
+
+    const unsigned int max_threads;
+    unsigned int thread_count;
+    unsigned int idle_thread_count;
+    //! References from the context and the worker threads
+    unsigned int ref_count;
+    bool stopping;
+
+    //! Protects the table of mounted filesystems
+    std::mutex mounts_mutex;
+    std::vector< path::string_type > mount_points;
+    clock::time_point mount_points_updated;
+    bool mount_points_valid;
+
+    explicit implementation(unsigned int threads) :
+        blocked_count(0u),
+        max_threads(threads > 0u ? threads : 1u),
+        thread_count(0u),
+        idle_thread_count(0u),
+        ref_count(1u),
+        stopping(false),
+        mount_points_valid(false)
+    {
+    }
+
+    ~implementation()
+    {
+        for (std::deque< deadline_operation* >::iterator it = queue.begin(), end = queue.end(); it != end; ++it)
+            delete *it;
+    }
+
+    BOOST_DELETED_FUNCTION(implementation(implementation const&))
+    BOOST_DELETED_FUNCTION(implementation& operator=(implementation const&))
+
+    //! Returns the mount containing the path \a p
+    path get_mount(path const& p)
+    {
+        system::error_code ec;
+        path abs_p(filesystem::absolute(p, ec));
+        if (BOOST_UNLIKELY(!!ec))
+            abs_p = p;
+        abs_p = abs_p.lexically_normal();
+#if defined(BOOST_WINDOWS_API)
+        // Drives and network shares are identified by the root name
+        return abs_p.root_name();
+#else
+        std::lock_guard< std::mutex > lock(mounts_mutex);
+        update_mount_points();
+
+        path::string_type const& str = abs_p.native();
+        std::size_t best = 0u;
+        const path::string_type* best_mount = NULL;
+        for (std::vector< path::string_type >::const_iterator it = mount_points.begin(), end = mount_points.end(); it != end; ++it)
+        {
+            if (it->size() >= best && is_within_mount(str, *it))
+            {
+                best = it->size();
+                best_mount = &*it;
+            }
+        }
+
+        if (best_mount == NULL)
+            return abs_p.root_path();
+
+        return path(*best_mount);
+#endif
+    }
+
+    //! Reads the table of mounted filesystems, if the cached one is outdated. Must be called with \c mounts_mutex locked.
+    void update_mount_points()
+    {
+        const clock::time_point now = clock::now();
+        if (mount_points_valid && (now - mount_points_updated) < std::chrono::milliseconds(deadline_mount_table_refresh_ms))
+            return;
+
+        mount_points.clear();
+
+#if defined(BOOST_FILESYSTEM_HAS_GETMNTENT)
+        // Unlike statfs and similar calls, reading the mount table does not access the mounted filesystems
+        std::FILE* file = ::setmntent("/proc/self/mounts", "r");
+        if (file != NULL)
+        {
+            struct ::mntent entry;
+            char buf[4096];
+            while (::getmntent_r(file, &entry, buf, sizeof(buf)) != NULL)
+            {
+                if (entry.mnt_dir != NULL && entry.mnt_dir[0] == '/')
+                    mount_points.push_back(entry.mnt_dir);
+            }
+
+            ::endmntent(file);
+        }
+#elif defined(BOOST_FILESYSTEM_HAS_GETMNTINFO)
+        // MNT_NOWAIT returns the cached information without querying the filesystems
+        struct ::statfs* mounts = NULL;
+        const int count = ::getmntinfo(&mounts, MNT_NOWAIT);
+        for (int i = 0; i < count; ++i)
+            mount_points.push_back(mounts[i].f_mntonname);
+#endif
+
+        mount_points_updated = now;
+        mount_points_valid = true;
+    }
+
+    //! Releases a reference to the implementation, destroying it if it was the last one. Must be called with \c mutex locked, which is unlocked.
+    void release(std::unique_lock< std::mutex >& lock) BOOST_NOEXCEPT
+    {
+        const bool last = --ref_count == 0u;
+        lock.unlock();
+        if (last)
+            delete this;
+    }
+
+    //! Starts a new worker thread if there are not enough idle threads for the queued operations. Must be called with \c mutex locked.
+    void start_worker() BOOST_NOEXCEPT
+    {
+        if (idle_thread_count >= queue.size() || thread_count >= max_threads)
+        {
+            work_cond.notify_one();
+            return;
+        }
+
+        ++thread_count;
+        ++ref_count;
+        try
+        {
+            std::thread(&implementation::worker, this).detach();
+        }
+        catch (...)
+        {
+            // Let the running threads, if any, handle the operation
+            --thread_count;
+            --ref_count;
+            work_cond.notify_one();
+        }
+    }
+
+    //! Worker thread function
+    void worker() BOOST_NOEXCEPT
+    {
+        std::unique_lock< std::mutex > lock(mutex);
+        while (true)
+        {
+            if (queue.empty())
+            {
+                if (stopping)
+                    break;
+
+                ++idle_thread_count;
+                const bool woken = work_cond.wait_for(lock, std::chrono::milliseconds(deadline_worker_idle_timeout_ms), [this]() { return !queue.empty() || stopping; });
+                --idle_thread_count;
+                if (!woken)
+                    break;
+
+                continue;
+            }
+
+            deadline_operation* const op = queue.front();
+            queue.pop_front();
+            if (op->abandoned)
+            {
+                // The caller timed out before the operation could be started
+                delete op;
+                continue;
+            }
+
+            op->state = deadline_operation::running;
+            lock.unlock();
+
+            op->execute();
+
+            lock.lock();
+            op->state = deadline_operation::completed;
+            if (op->blocked)
+            {
+                std::map< path, std::size_t >::iterator it = stuck_mounts.find(op->mount);
+                if (it != stuck_mounts.end() && --it->second == 0u)
+                    stuck_mounts.erase(it);
+                --blocked_count;
+            }
+
+            if (op->abandoned)
+                delete op;
+            else
+                completion_cond.notify_all();
+        }
+
+        --thread_count;
+        release(lock);
+    }
+
+    /*!
+     * Performs the operation in a worker thread and waits for at most \a timeout_ms milliseconds. Returns \c true if the operation completed.
+     * Otherwise, if the operation was started, its ownership is passed to the worker thread.
+     */
+    bool run(deadline_operation_holder& holder, unsigned int timeout_ms)
+    {
+        const clock::time_point deadline = clock::now() + std::chrono::milliseconds(timeout_ms);
+        deadline_operation* const op = holder.op;
+        op->mount = get_mount(op->p);
+
+        std::unique_lock< std::mutex > lock(mutex);
+        if (stuck_mounts.find(op->mount) != stuck_mounts.end())
+            return false;
+
+        queue.push_back(op);
+        start_worker();
+
+        if (completion_cond.wait_until(lock, deadline, [op]() { return op->state == deadline_operation::completed; }))
+            return true;
+
+        op->abandoned = true;
+        holder.op = NULL;
+        if (op->state == deadline_operation::running)
+        {
+            // The operation is blocked, isolate the mount until it completes
+            op->blocked = true;
+            ++stuck_mounts[op->mount];
+            ++blocked_count;
+        }
+
+        return false;
+    }
+};
+
+BOOST_FILESYSTEM_DECL deadline_context::deadline_context(unsigned int max_threads) :
+    m_impl(new implementation(max_threads))
+{
+}
+
+BOOST_FILESYSTEM_DECL deadline_context::~deadline_context()
+{
+    std::unique_lock< std::mutex > lock(m_impl->mutex);
+    m_impl->stopping = true;
+    m_impl->work_cond.notify_all();
+    m_impl->release(lock);
+}
+
+BOOST_FILESYSTEM_DECL bool deadline_context::is_stuck(path const& p) const
+{
+    const path mount(m_impl->get_mount(p));
+    std::lock_guard< std::mutex > lock(m_impl->mutex);
+    return m_impl->stuck_mounts.find(mount) != m_impl->stuck_mounts.end();
+}
+
+BOOST_FILESYSTEM_DECL std::size_t deadline_context::blocked_operation_count() const BOOST_NOEXCEPT
+{
+    std::lock_guard< std::mutex > lock(m_impl->mutex);
+    return m_impl->blocked_count;
+}
+
+#else // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+struct deadline_context::implementation
+{
+    //! Performs the operation in the calling thread. Returns \c true if the operation completed.
+    static bool run(deadline_operation_holder& holder, unsigned int)
+    {
+        holder.op->execute();
+        return true;
+    }
+};
+
+BOOST_FILESYSTEM_DECL deadline_context::deadline_context(unsigned int) :
+    m_impl(NULL)
+{
+}
+
+BOOST_FILESYSTEM_DECL deadline_context::~deadline_context()
+{
+}
+
+BOOST_FILESYSTEM_DECL bool deadline_context::is_stuck(path const&) const
+{
+    return false;
+}
+
+BOOST_FILESYSTEM_DECL std::size_t deadline_context::blocked_operation_count() const BOOST_NOEXCEPT
+{
+    return 0u;
+}
+
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+namespace {
+
+//! Reports the error of the operation
+void report_error(system::error_code const& error, path const& p, system::error_code* ec, const char* message)
+{
+    if (!ec)
+        BOOST_FILESYSTEM_THROW(filesystem_error(message, p, error));
+    *ec = error;
+}
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL file_status deadline_context::status_impl(path const& p, unsigned int timeout_ms, bool follow_symlinks, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    const char* const message = follow_symlinks ? "boost::filesystem::deadline_context::status" : "boost::filesystem::deadline_context::symlink_status";
+    system::error_code result_ec;
+    file_status result(status_error);
+    try
+    {
+        deadline_operation_holder holder(new deadline_operation(follow_symlinks ? deadline_operation::status_operation : deadline_operation::symlink_status_operation, p, 0u));
+        if (m_impl->run(holder, timeout_ms))
+        {
+            deadline_operation* const op = holder.op;
+            result_ec = op->error;
+            result = op->status;
+        }
+        else
+        {
+            result_ec = make_error_code(system::errc::timed_out);
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        result_ec = make_error_code(system::errc::not_enough_memory);
+    }
+
+    // Like status, report not found errors in the error code but do not throw them
+    if (BOOST_UNLIKELY(!!result_ec) && (ec || result.type() != file_not_found))
+        report_error(result_ec, p, ec, message);
+
+    return result;
+}
+
+BOOST_FILESYSTEM_DECL space_info deadline_context::space_impl(path const& p, unsigned int timeout_ms, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    system::error_code result_ec;
+    space_info result;
+    result.capacity = result.free = result.available = static_cast< boost::uintmax_t >(-1);
+    try
+    {
+        deadline_operation_holder holder(new deadline_operation(deadline_operation::space_operation, p, 0u));
+        if (m_impl->run(holder, timeout_ms))
+        {
+            deadline_operation* const op = holder.op;
+            result_ec = op->error;
+            result = op->space;
+        }
+        else
+        {
+            result_ec = make_error_code(system::errc::timed_out);
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        result_ec = make_error_code(system::errc::not_enough_memory);
+    }
+
+    if (BOOST_UNLIKELY(!!result_ec))
+        report_error(result_ec, p, ec, "boost::filesystem::deadline_context::space");
+
+    return result;
+}
+
+BOOST_FILESYSTEM_DECL void deadline_context::directory_entries_impl(path const& p, unsigned int timeout_ms, unsigned int opts, std::vector< directory_entry >& entries, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    system::error_code result_ec;
+    try
+    {
+        deadline_operation_holder holder(new deadline_operation(deadline_operation::directory_entries_operation, p, opts));
+        if (m_impl->run(holder, timeout_ms))
+        {
+            deadline_operation* const op = holder.op;
+            result_ec = op->error;
+            entries.swap(op->entries);
+        }
+        else
+        {
+            result_ec = make_error_code(system::errc::timed_out);
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        result_ec = make_error_code(system::errc::not_enough_memory);
+    }
+
+    if (BOOST_UNLIKELY(!!result_ec))
+        report_error(result_ec, p, ec, "boost::filesystem::deadline_context::directory_entries");
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
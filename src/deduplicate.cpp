@@ -0,0 +1,649 @@
+//  deduplicate.cpp  -------------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory_handle.hpp>
+#include <boost/filesystem/mapped_file.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/parallel_walk.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <ctime>
+#include <new> // std::bad_alloc
+#include <map>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#include "thread_tools.hpp"
+#include "content_hash.hpp"
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+#include <mutex>
+#include <atomic>
+#endif
+
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+namespace {
+
+//! Signature of the hash cache file, followed by a marker to detect files written on a system with different byte order
+const char hash_cache_signature[8] = { 'B', 'F', 'S', 'D', 'H', 'C', '0', '1' };
+BOOST_CONSTEXPR_OR_CONST uint64_t hash_cache_byte_order_marker = static_cast< uint64_t >(0x0102030405060708ull);
+
+//! Number of 64-bit words in a hash cache record
+BOOST_CONSTEXPR_OR_CONST std::size_t hash_cache_record_size = 6u;
+
+} // namespace
+
+void load_hash_cache(path const& p, hash_cache_map& cache)
+{
+    filesystem::ifstream file(p, std::ios_base::in | std::ios_base::binary);
+    if (!file)
+        return;
+
+    char signature[sizeof(hash_cache_signature)];
+    uint64_t marker = 0u;
+    if (!file.read(signature, sizeof(signature)) || std::memcmp(signature, hash_cache_signature, sizeof(signature)) != 0 ||
+        !file.read(reinterpret_cast< char* >(&marker), sizeof(marker)) || marker != hash_cache_byte_order_marker)
+    {
+        return;
+    }
+
+    uint64_t record[hash_cache_record_size];
+    while (file.read(reinterpret_cast< char* >(record), sizeof(record)))
+    {
+        file_version version;
+        version.device = record[0];
+        version.inode = record[1];
+        version.size = record[2];
+        version.mtime = static_cast< int64_t >(record[3]);
+        version.mtime_nsec = record[4];
+        cache[version] = record[5];
+    }
+}
+
+void save_hash_cache(path const& p, hash_cache_map const& cache, system::error_code* ec)
+{
+    std::string data;
+    data.reserve(sizeof(hash_cache_signature) + sizeof(hash_cache_byte_order_marker) + cache.size() * hash_cache_record_size * sizeof(uint64_t));
+    data.append(hash_cache_signature, sizeof(hash_cache_signature));
+    data.append(reinterpret_cast< const char* >(&hash_cache_byte_order_marker), sizeof(hash_cache_byte_order_marker));
+    for (hash_cache_map::const_iterator it = cache.begin(), end = cache.end(); it != end; ++it)
+    {
+        const uint64_t record[hash_cache_record_size] =
+        {
+            it->first.device, it->first.inode, it->first.size, static_cast< uint64_t >(it->first.mtime), it->first.mtime_nsec, it->second
+        };
+        data.append(reinterpret_cast< const char* >(record), sizeof(record));
+    }
+
+    detail::atomic_write_file(p, data.data(), data.size(), static_cast< unsigned int >(write_file_options::atomic_replace), ec);
+}
+
+namespace {
+
+//! A regular file found in the tree
+struct dedup_file
+{
+    path file_path;
+    file_version version;
+    uintmax_t hard_link_count;
+};
+
+//! Orders files so that files on the same device and of the same size are adjacent, and hard links to the same file are adjacent
+struct dedup_file_order
+{
+    bool operator() (dedup_file const& left, dedup_file const& right) const BOOST_NOEXCEPT
+    {
+        if (left.version.device != right.version.device)
+            return left.version.device < right.version.device;
+        if (left.version.size != right.version.size)
+            return left.version.size < right.version.size;
+        return left.version.inode < right.version.inode;
+    }
+};
+
+//! A distinct file of a group of candidate duplicates, which may have multiple hard links in the group
+struct dedup_candidate
+{
+    //! Index of the first hard link in the list of files
+    std::size_t first;
+    //! Number of hard links in the list of files
+    std::size_t count;
+    uint64_t hash;
+
+    bool operator< (dedup_candidate const& that) const BOOST_NOEXCEPT { return hash < that.hash; }
+};
+
+//! Returns \c true if the error indicates that a file should be skipped
+inline bool is_skippable_error(system::error_code const& ec, unsigned int options) BOOST_NOEXCEPT
+{
+    // Files removed after the tree was enumerated are skipped
+    if (ec == system::errc::no_such_file_or_directory)
+        return true;
+
+    return ec == system::errc::permission_denied && (options & static_cast< unsigned int >(deduplicate_options::skip_permission_denied)) != 0u;
+}
+
+//! Common state of deduplication
+class deduplicate_context
+{
+private:
+    //! File attributes needed to group the files and to look up their hashes
+    static BOOST_CONSTEXPR_OR_CONST unsigned int query_mask = static_cast< unsigned int >(file_attribute_mask::type) |
+        static_cast< unsigned int >(file_attribute_mask::size) | static_cast< unsigned int >(file_attribute_mask::last_write_time) |
+        static_cast< unsigned int >(file_attribute_mask::hard_link_count) | static_cast< unsigned int >(file_attribute_mask::inode) |
+        static_cast< unsigned int >(file_attribute_mask::device) | static_cast< unsigned int >(file_attribute_mask::no_follow);
+
+    //! A group of files on the same device and of the same size
+    struct group
+    {
+        std::size_t begin;
+        std::size_t end;
+    };
+
+private:
+    const unsigned int m_options;
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+    std::mutex m_mutex;
+    std::atomic< std::size_t > m_next_group;
+#else
+    std::size_t m_next_group;
+#endif
+    std::vector< dedup_file > m_files;
+    std::vector< group > m_groups;
+    //! Hashes loaded from the cache file
+    hash_cache_map m_old_hashes;
+    //! Hashes of the files of the current tree
+    hash_cache_map m_new_hashes;
+    deduplicate_info m_info;
+    system::error_code m_error;
+    path m_error_path;
+
+public:
+    explicit deduplicate_context(unsigned int options) BOOST_NOEXCEPT :
+        m_options(options),
+        m_next_group(0u)
+    {
+    }
+
+    BOOST_DELETED_FUNCTION(deduplicate_context(deduplicate_context const&))
+    BOOST_DELETED_FUNCTION(deduplicate_context& operator=(deduplicate_context const&))
+
+public:
+    deduplicate_info const& info() const BOOST_NOEXCEPT { return m_info; }
+    system::error_code const& error() const BOOST_NOEXCEPT { return m_error; }
+    path const& error_path() const BOOST_NOEXCEPT { return m_error_path; }
+
+    hash_cache_map& old_hashes() BOOST_NOEXCEPT { return m_old_hashes; }
+    hash_cache_map const& new_hashes() const BOOST_NOEXCEPT { return m_new_hashes; }
+
+    //! Walker batch handler
+    static bool on_batch(void* context, std::vector< directory_entry >& batch)
+    {
+        return static_cast< deduplicate_context* >(context)->add_batch(batch);
+    }
+
+    //! Groups the files found by the walk. Returns the number of groups that need to be processed.
+    std::size_t make_groups()
+    {
+        m_info.file_count = m_files.size();
+        std::sort(m_files.begin(), m_files.end(), dedup_file_order());
+
+        for (std::size_t i = 0u, n = m_files.size(); i < n;)
+        {
+            file_version const& version = m_files[i].version;
+            std::size_t j = i + 1u;
+            bool has_distinct_files = false;
+            for (; j < n && m_files[j].version.device == version.device && m_files[j].version.size == version.size; ++j)
+                has_distinct_files |= m_files[j].version.inode != m_files[j - 1u].version.inode;
+
+            if (has_distinct_files)
+            {
+                group g = { i, j };
+                m_groups.push_back(g);
+            }
+
+            i = j;
+        }
+
+        return m_groups.size();
+    }
+
+    //! Thread function, processes groups of files until there are no more groups or an error occurs
+    void operator() (unsigned int) BOOST_NOEXCEPT
+    {
+        std::vector< dedup_candidate > candidates;
+        while (true)
+        {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+            const std::size_t index = m_next_group.fetch_add(1u, std::memory_order_relaxed);
+#else
+            const std::size_t index = m_next_group++;
+#endif
+            if (index >= m_groups.size() || has_error())
+                break;
+
+            if (!process_group(m_groups[index], candidates))
+                break;
+        }
+    }
+
+private:
+    bool add_batch(std::vector< directory_entry >& batch) BOOST_NOEXCEPT
+    {
+        system::error_code ec;
+        path const* failed = NULL;
+        std::vector< dedup_file > files;
+        try
+        {
+            // All entries of the batch belong to the same directory, query them relative to it to avoid resolving the whole path for every file
+#if defined(BOOST_POSIX_API) && !defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+            directory_handle dir;
+#else
+            directory_handle dir(batch.front().path().parent_path(), ec);
+#endif
+            files.reserve(batch.size());
+            for (std::size_t i = 0u, n = batch.size(); i < n; ++i)
+            {
+                // Don't query the entries that are known not to be regular files
+                const file_type type = detail::get_cached_symlink_status(batch[i]).type();
+                if (type != status_unknown && type != regular_file)
+                    continue;
+
+                path const& p = batch[i].path();
+                file_attributes attrs = dir.is_open() ? dir.query(p.filename(), static_cast< BOOST_SCOPED_ENUM_NATIVE(file_attribute_mask) >(query_mask), ec) :
+                    detail::query(p, query_mask, &ec);
+                if (BOOST_UNLIKELY(!!ec))
+                {
+                    if (is_skippable_error(ec, m_options))
+                        continue;
+
+                    failed = &p;
+                    goto fail;
+                }
+
+                // Empty files are not deduplicated, and files without a device and an inode number cannot be identified
+                const unsigned int required_mask = static_cast< unsigned int >(file_attribute_mask::inode) | static_cast< unsigned int >(file_attribute_mask::device);
+                if (attrs.status.type() != regular_file || attrs.size == 0u || (static_cast< unsigned int >(attrs.mask) & required_mask) != required_mask)
+                    continue;
+
+                files.push_back(dedup_file());
+                dedup_file& file = files.back();
+                file.file_path = p;
+                file.version.device = attrs.device;
+                file.version.inode = attrs.inode;
+                file.version.size = attrs.size;
+                file.version.mtime = static_cast< int64_t >(attrs.last_write_time);
+                file.version.mtime_nsec = attrs.last_write_time_nsec;
+                file.hard_link_count = attrs.hard_link_count;
+            }
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+            std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+            m_files.insert(m_files.end(), files.begin(), files.end());
+        }
+        catch (std::bad_alloc&)
+        {
+            ec = make_error_code(system::errc::not_enough_memory);
+            failed = &batch.front().path();
+            goto fail;
+        }
+
+        return true;
+
+    fail:
+        set_error(ec, *failed);
+        return false;
+    }
+
+    bool has_error() BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        return !!m_error;
+    }
+
+    //! Hashes the distinct files of the group and replaces the duplicates. Returns \c false if an error occurred.
+    bool process_group(group const& g, std::vector< dedup_candidate >& candidates) BOOST_NOEXCEPT
+    {
+        system::error_code ec;
+        path const* failed = NULL;
+        deduplicate_info info;
+        try
+        {
+            candidates.clear();
+            for (std::size_t i = g.begin; i < g.end;)
+            {
+                dedup_candidate candidate;
+                candidate.first = i;
+                for (++i; i < g.end && m_files[i].version.inode == m_files[candidate.first].version.inode; ++i)
+                {
+                }
+                candidate.count = i - candidate.first;
+
+                if (!get_hash(m_files[candidate.first], candidate.hash, info, ec))
+                {
+                    if (is_skippable_error(ec, m_options))
+                        continue;
+
+                    failed = &m_files[candidate.first].file_path;
+                    goto fail;
+                }
+
+                candidates.push_back(candidate);
+            }
+
+            std::sort(candidates.begin(), candidates.end());
+
+            for (std::size_t i = 0u, n = candidates.size(); i < n;)
+            {
+                std::size_t j = i + 1u;
+                for (; j < n && candidates[j].hash == candidates[i].hash; ++j)
+                {
+                }
+
+                if ((j - i) > 1u && !replace_duplicates(candidates, i, j, info, ec, failed))
+                    goto fail;
+
+                i = j;
+            }
+        }
+        catch (std::bad_alloc&)
+        {
+            ec = make_error_code(system::errc::not_enough_memory);
+            failed = &m_files[g.begin].file_path;
+            goto fail;
+        }
+
+        merge(info);
+        return true;
+
+    fail:
+        merge(info);
+        set_error(ec, *failed);
+        return false;
+    }
+
+    //! Obtains the hash of the file, from the cache or by reading the file
+    bool get_hash(dedup_file const& file, uint64_t& hash, deduplicate_info& info, system::error_code& ec)
+    {
+        {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+            std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+            hash_cache_map::const_iterator it = m_old_hashes.find(file.version);
+            if (it != m_old_hashes.end())
+            {
+                hash = it->second;
+                m_new_hashes[file.version] = hash;
+                return true;
+            }
+        }
+
+        mapped_file contents(file.file_path, mapped_file_flags::sequential, ec);
+        if (BOOST_UNLIKELY(!!ec))
+            return false;
+
+        content_hash h;
+        h.update(reinterpret_cast< const unsigned char* >(contents.data()), contents.size());
+        hash = h.finish(contents.size());
+        ++info.hashed_count;
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        m_new_hashes[file.version] = hash;
+        return true;
+    }
+
+    //! Compares the candidates with equal hashes in range [begin, end) and replaces the identical files with links or clones
+    bool replace_duplicates(std::vector< dedup_candidate > const& candidates, std::size_t begin, std::size_t end,
+        deduplicate_info& info, system::error_code& ec, path const*& failed)
+    {
+        // Keep the file with the most hard links so that the least number of links needs to be replaced
+        std::size_t keeper = begin;
+        for (std::size_t i = begin + 1u; i < end; ++i)
+        {
+            if (m_files[candidates[i].first].hard_link_count > m_files[candidates[keeper].first].hard_link_count)
+                keeper = i;
+        }
+
+        path const* keeper_path = &m_files[candidates[keeper].first].file_path;
+        mapped_file keeper_contents(*keeper_path, mapped_file_flags::sequential, ec);
+        if (BOOST_UNLIKELY(!!ec))
+        {
+            if (is_skippable_error(ec, m_options))
+            {
+                ec.clear();
+                return true;
+            }
+
+            failed = keeper_path;
+            return false;
+        }
+
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            if (i == keeper)
+                continue;
+
+            dedup_candidate const& candidate = candidates[i];
+            path const& candidate_path = m_files[candidate.first].file_path;
+            {
+                mapped_file contents(candidate_path, mapped_file_flags::sequential, ec);
+                if (BOOST_UNLIKELY(!!ec))
+                {
+                    if (is_skippable_error(ec, m_options))
+                    {
+                        ec.clear();
+                        continue;
+                    }
+
+                    failed = &candidate_path;
+                    return false;
+                }
+
+                if (contents.size() != keeper_contents.size() || std::memcmp(contents.data(), keeper_contents.data(), contents.size()) != 0)
+                    continue;
+            }
+
+            info.replaced_size += m_files[candidate.first].version.size;
+            for (std::size_t k = candidate.first, n = candidate.first + candidate.count; k < n; ++k)
+            {
+                path const& duplicate = m_files[k].file_path;
+                if ((m_options & static_cast< unsigned int >(deduplicate_options::dry_run)) == 0u)
+                {
+                    if (!replace_file(*keeper_path, duplicate, ec))
+                    {
+                        if (ec == system::errc::too_many_links)
+                        {
+                            // The kept file cannot have more hard links, keep this file for the following duplicates instead
+                            ec.clear();
+                            info.replaced_size -= m_files[candidate.first].version.size;
+                            keeper_path = &duplicate;
+                            break;
+                        }
+
+                        if (is_skippable_error(ec, m_options))
+                        {
+                            ec.clear();
+                            continue;
+                        }
+
+                        failed = &duplicate;
+                        return false;
+                    }
+                }
+
+                ++info.replaced_count;
+            }
+        }
+
+        return true;
+    }
+
+    //! Atomically replaces \a duplicate with a hard link to or a clone of \a original
+    bool replace_file(path const& original, path const& duplicate, system::error_code& ec)
+    {
+        path temp = duplicate.parent_path();
+        temp /= detail::unique_path(".dedup-%%%%-%%%%-%%%%-%%%%", &ec);
+        if (BOOST_UNLIKELY(!!ec))
+            return false;
+
+        if ((m_options & static_cast< unsigned int >(deduplicate_options::clone)) != 0u)
+            detail::copy_file(original, temp, static_cast< unsigned int >(copy_options::clone_required), &ec);
+        else
+            detail::create_hard_link(original, temp, &ec);
+        if (BOOST_UNLIKELY(!!ec))
+            return false;
+
+        detail::rename(temp, duplicate, &ec);
+        if (BOOST_UNLIKELY(!!ec))
+        {
+            system::error_code remove_ec;
+            detail::remove(temp, &remove_ec);
+            return false;
+        }
+
+        return true;
+    }
+
+    //! Adds the results of a group to the totals
+    void merge(deduplicate_info const& info) BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        m_info.hashed_count += info.hashed_count;
+        m_info.replaced_count += info.replaced_count;
+        m_info.replaced_size += info.replaced_size;
+    }
+
+    void set_error(system::error_code const& err, path const& p) BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        if (!m_error)
+        {
+            m_error = err;
+            try
+            {
+                m_error_path = p;
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+};
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL
+deduplicate_info deduplicate(path const& p, unsigned int options, path const& hash_cache, unsigned int thread_count, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    system::error_code local_ec;
+    path const* err_path = &p;
+    try
+    {
+        deduplicate_context ctx(options);
+        if (!hash_cache.empty())
+            load_hash_cache(hash_cache, ctx.old_hashes());
+
+        parallel_walk_params params;
+        params.thread_count = thread_count;
+        params.batch_size = parallel_directory_walker::default_batch_size;
+        params.options = static_cast< unsigned int >(directory_options::none);
+        params.exec = NULL;
+        if ((options & static_cast< unsigned int >(deduplicate_options::skip_permission_denied)) != 0u)
+            params.options |= static_cast< unsigned int >(directory_options::skip_permission_denied);
+
+        detail::parallel_walk(p, params, &deduplicate_context::on_batch, &ctx, &local_ec);
+        if (BOOST_UNLIKELY(!!local_ec))
+            goto fail;
+
+        if (BOOST_LIKELY(!ctx.error()) && ctx.make_groups() > 0u)
+        {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+            run_in_threads(get_thread_count(thread_count), ctx);
+#else
+            ctx(0u);
+#endif
+        }
+
+        if (BOOST_UNLIKELY(!!ctx.error()))
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::deduplicate", ctx.error_path(), ctx.error()));
+            *ec = ctx.error();
+            return ctx.info();
+        }
+
+        if (!hash_cache.empty())
+        {
+            save_hash_cache(hash_cache, ctx.new_hashes(), &local_ec);
+            if (BOOST_UNLIKELY(!!local_ec))
+            {
+                err_path = &hash_cache;
+                goto fail;
+            }
+        }
+
+        return ctx.info();
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return deduplicate_info();
+    }
+
+fail:
+    if (!ec)
+        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::deduplicate", *err_path, local_ec));
+
+    *ec = local_ec;
+    return deduplicate_info();
+}
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
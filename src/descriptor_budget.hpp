@@ -0,0 +1,120 @@
+//  descriptor_budget.hpp  --------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_SRC_DESCRIPTOR_BUDGET_HPP_
+#define BOOST_FILESYSTEM_SRC_DESCRIPTOR_BUDGET_HPP_
+
+#include <boost/filesystem/config.hpp>
+#include <cstddef>
+#include "atomic_tools.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+//! Maximum number of descriptors that can be drawn from the process-wide budget, or zero if not limited
+extern std::size_t g_descriptor_budget_limit;
+//! Number of descriptors currently drawn from the process-wide budget
+extern std::size_t g_descriptor_budget_used;
+
+//! Number of descriptors every additional worker thread of a parallel operation draws from the budget: a directory and a file, or a source and a target file
+BOOST_CONSTEXPR_OR_CONST std::size_t descriptors_per_thread = 2u;
+
+//! Returns \c true if the process-wide descriptor budget is limited
+inline bool is_descriptor_budget_limited() BOOST_NOEXCEPT
+{
+    return filesystem::detail::atomic_load_relaxed(g_descriptor_budget_limit) != 0u;
+}
+
+//! Attempts to draw \a count descriptors from the process-wide budget. Returns \c false and draws nothing if the budget is exhausted.
+/*!
+ * The descriptors are always accounted, even if the budget is not limited, so that they can be released after the budget is changed.
+ * The callers should only draw descriptors if \c is_descriptor_budget_limited returns \c true.
+ */
+inline bool try_acquire_descriptors(std::size_t count) BOOST_NOEXCEPT
+{
+    const std::size_t limit = filesystem::detail::atomic_load_relaxed(g_descriptor_budget_limit);
+    const std::size_t used = filesystem::detail::atomic_fetch_add_relaxed(g_descriptor_budget_used, count);
+    if (limit == 0u || (used < limit && count <= limit - used))
+        return true;
+
+    filesystem::detail::atomic_fetch_sub_relaxed(g_descriptor_budget_used, count);
+    return false;
+}
+
+//! Returns \a count descriptors to the process-wide budget
+inline void release_descriptors(std::size_t count) BOOST_NOEXCEPT
+{
+    filesystem::detail::atomic_fetch_sub_relaxed(g_descriptor_budget_used, count);
+}
+
+//! Descriptors drawn from the process-wide budget, which are returned to the budget on destruction
+class descriptor_reservation
+{
+private:
+    std::size_t m_count;
+
+public:
+    descriptor_reservation() BOOST_NOEXCEPT : m_count(0u) {}
+    ~descriptor_reservation() BOOST_NOEXCEPT { release(); }
+
+    BOOST_DELETED_FUNCTION(descriptor_reservation(descriptor_reservation const&))
+    BOOST_DELETED_FUNCTION(descriptor_reservation& operator=(descriptor_reservation const&))
+
+public:
+    //! Attempts to draw \a count more descriptors from the budget
+    bool try_acquire(std::size_t count) BOOST_NOEXCEPT
+    {
+        if (!try_acquire_descriptors(count))
+            return false;
+        m_count += count;
+        return true;
+    }
+
+    //! Returns all drawn descriptors to the budget
+    void release() BOOST_NOEXCEPT
+    {
+        if (m_count > 0u)
+        {
+            release_descriptors(m_count);
+            m_count = 0u;
+        }
+    }
+
+    //! Returns the number of drawn descriptors
+    std::size_t count() const BOOST_NOEXCEPT { return m_count; }
+};
+
+//! Draws descriptors for the additional worker threads of a parallel operation from the budget. Returns the number of threads to use, at least one.
+/*!
+ * The first thread does not draw from the budget, which guarantees progress of the operation regardless of the budget.
+ */
+inline unsigned int reserve_thread_descriptors(descriptor_reservation& reservation, unsigned int thread_count) BOOST_NOEXCEPT
+{
+    if (thread_count <= 1u || !is_descriptor_budget_limited())
+        return thread_count;
+
+    unsigned int n = 1u;
+    while (n < thread_count && reservation.try_acquire(descriptors_per_thread))
+        ++n;
+
+    return n;
+}
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_SRC_DESCRIPTOR_BUDGET_HPP_
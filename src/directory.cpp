@@ -16,11 +16,16 @@
 #include <boost/throw_exception.hpp>
 #include <boost/filesystem/config.hpp>
 #include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/directory_listing.hpp>
+#include <boost/filesystem/compact_directory_entry.hpp>
 #include <boost/filesystem/exception.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/backends.hpp>
+#include <boost/filesystem/memory_allocator.hpp>
 
 #include <cstddef>
+#include <ctime>
 #include <cerrno>
 #include <cstring>
 #include <cstdlib> // std::malloc, std::free
@@ -28,9 +33,18 @@
 #include <limits>
 #include <string>
 #include <utility> // std::move
+#include <vector>
+#include <algorithm>
+#if !defined(BOOST_NO_CXX11_HDR_CHRONO)
+#include <chrono>
+#endif
 #include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
 #include <boost/system/error_code.hpp>
 #include <boost/smart_ptr/intrusive_ptr.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
 
 #ifdef BOOST_POSIX_API
 
@@ -50,6 +64,34 @@
 #define BOOST_FILESYSTEM_USE_READDIR_R
 #endif
 
+#if (defined(linux) || defined(__linux) || defined(__linux__)) && !defined(BOOST_FILESYSTEM_DISABLE_GETDENTS)
+#include <sys/syscall.h>
+#if defined(__NR_getdents64)
+#define BOOST_FILESYSTEM_USE_GETDENTS
+#endif
+#endif
+
+#if defined(linux) || defined(__linux) || defined(__linux__)
+#include <sys/vfs.h>
+#if defined(__has_include)
+#if __has_include(<linux/magic.h>)
+#include <linux/magic.h>
+#endif
+#endif
+#ifndef TMPFS_MAGIC
+#define TMPFS_MAGIC 0x01021994
+#endif
+#ifndef BTRFS_SUPER_MAGIC
+#define BTRFS_SUPER_MAGIC 0x9123683E
+#endif
+#define BOOST_FILESYSTEM_HAS_STATFS_F_TYPE
+#endif
+
+#if defined(BOOST_FILESYSTEM_USE_READDIR_R) || defined(BOOST_FILESYSTEM_USE_GETDENTS)
+// A runtime selection of the readdir implementation is required
+#define BOOST_FILESYSTEM_USE_READDIR_IMPL_PTR
+#endif
+
 // At least Mac OS X 10.6 and older doesn't support O_CLOEXEC
 #ifndef O_CLOEXEC
 #define O_CLOEXEC 0
@@ -57,6 +99,11 @@
 #endif
 
 #include "posix_tools.hpp"
+#include "io_uring_tools.hpp"
+
+#if defined(BOOST_FILESYSTEM_USE_IO_URING)
+#include <sys/sysmacros.h>
+#endif
 
 #else // BOOST_WINDOWS_API
 
@@ -69,7 +116,10 @@
 #endif // BOOST_WINDOWS_API
 
 #include "atomic_tools.hpp"
+#include "descriptor_budget.hpp"
 #include "error_handling.hpp"
+#include "instrumentation.hpp"
+#include "tracing.hpp"
 #include "private_config.hpp"
 
 #include <boost/filesystem/detail/header.hpp> // must be the last #include
@@ -110,6 +160,13 @@ file_status directory_entry::get_status(system::error_code* ec) const
             if (ec)
                 ec->clear();
         }
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+        else if (m_basedir_fd >= 0)
+        {
+            // The entry path may be relative to the directory being iterated rather than the current directory
+            refresh_impl(ec);
+        }
+#endif
         else
         {
             m_status = detail::status(m_path, ec);
@@ -127,13 +184,123 @@ BOOST_FILESYSTEM_DECL
 file_status directory_entry::get_symlink_status(system::error_code* ec) const
 {
     if (!status_known(m_symlink_status))
-        m_symlink_status = detail::symlink_status(m_path, ec);
+    {
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+        if (m_basedir_fd >= 0)
+            refresh_impl(ec);
+        else
+#endif
+            m_symlink_status = detail::symlink_status(m_path, ec);
+    }
     else if (ec)
+    {
         ec->clear();
+    }
 
     return m_symlink_status;
 }
 
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                             compact_directory_entry                                  //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+BOOST_FILESYSTEM_DECL
+directory_entry compact_directory_entry::to_directory_entry_impl(filesystem::path const* parent) const
+{
+    directory_entry e;
+    if (parent)
+        e.m_path = *parent;
+    if (m_path_size > 0u)
+    {
+        if (parent)
+            e.m_path /= filesystem::path(m_path, m_path + m_path_size);
+        else
+            e.m_path.assign(m_path, m_path + m_path_size);
+    }
+
+    if (m_type != static_cast< boost::uint8_t >(status_error))
+        e.m_status = status();
+    if (m_symlink_type != static_cast< boost::uint8_t >(status_error))
+        e.m_symlink_status = symlink_status();
+
+    if (m_attrs)
+    {
+        unsigned int cached_attrs = 0u;
+        if ((m_attrs->flags & compact_directory_entry_attributes::file_size_known) != 0u)
+            cached_attrs |= detail::file_size_cached;
+        if ((m_attrs->flags & compact_directory_entry_attributes::last_write_time_known) != 0u)
+            cached_attrs |= detail::last_write_time_cached;
+        if ((m_attrs->flags & compact_directory_entry_attributes::inode_known) != 0u)
+            cached_attrs |= detail::inode_cached;
+        e.set_cached_attrs(cached_attrs, m_attrs->file_size, m_attrs->last_write_time, m_attrs->inode);
+    }
+
+    return e;
+}
+
+BOOST_FILESYSTEM_DECL
+compact_directory_entry compact_directory_entry_storage::store(directory_entry const& e, path_view const& p)
+{
+    if (BOOST_UNLIKELY(p.size() > static_cast< std::size_t >((std::numeric_limits< boost::uint32_t >::max)())))
+    {
+        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::compact_directory_entry_storage::store", e.m_path,
+            system::error_code(system::errc::filename_too_long, system::generic_category())));
+    }
+
+    compact_directory_entry entry;
+
+    // Same as directory_entry::file_type(), if the symlink status is known and the file is not a symlink, the status is the same
+    file_status st = e.m_status;
+    if (!type_present(st) && type_present(e.m_symlink_status) && !is_symlink(e.m_symlink_status))
+        st = e.m_symlink_status;
+    entry.m_type = static_cast< boost::uint8_t >(st.type());
+    entry.m_perms = static_cast< boost::uint16_t >(st.permissions());
+    entry.m_symlink_type = static_cast< boost::uint8_t >(e.m_symlink_status.type());
+
+    const unsigned int cached_attrs = e.m_cached_attrs & (detail::file_size_cached | detail::last_write_time_cached | detail::inode_cached);
+    if (cached_attrs != 0u)
+    {
+        compact_directory_entry_attributes attrs = {};
+        if ((cached_attrs & detail::file_size_cached) != 0u)
+        {
+            attrs.file_size = e.m_file_size;
+            attrs.flags |= compact_directory_entry_attributes::file_size_known;
+        }
+        if ((cached_attrs & detail::last_write_time_cached) != 0u)
+        {
+            attrs.last_write_time = e.m_last_write_time;
+            attrs.flags |= compact_directory_entry_attributes::last_write_time_known;
+        }
+        if ((cached_attrs & detail::inode_cached) != 0u)
+        {
+            attrs.inode = e.m_inode;
+            attrs.flags |= compact_directory_entry_attributes::inode_known;
+        }
+
+        m_attrs.push_back(attrs);
+    }
+
+    try
+    {
+        const path_view stored = m_paths.store(p);
+        entry.m_path = stored.data();
+        entry.m_path_size = static_cast< boost::uint32_t >(stored.size());
+    }
+    catch (...)
+    {
+        if (cached_attrs != 0u)
+            m_attrs.pop_back();
+        throw;
+    }
+
+    if (cached_attrs != 0u)
+        entry.m_attrs = &m_attrs.back();
+
+    return entry;
+}
+
 //--------------------------------------------------------------------------------------//
 //                                                                                      //
 //                               directory_iterator                                     //
@@ -144,29 +311,256 @@ namespace detail {
 
 BOOST_CONSTEXPR_OR_CONST std::size_t dir_itr_imp_extra_data_alignment = 16u;
 
+namespace {
+
+//! Header that precedes every dir_itr_imp
+struct dir_itr_imp_header
+{
+    //! Size of the allocated block, including the header
+    std::size_t size;
+    //! Memory allocator that was current when the block was allocated
+    memory_allocator const* allocator;
+};
+
+//! Size of the header that precedes every dir_itr_imp. Keeps dir_itr_imp aligned.
+BOOST_CONSTEXPR_OR_CONST std::size_t dir_itr_imp_header_size = dir_itr_imp_extra_data_alignment;
+
+BOOST_STATIC_ASSERT_MSG(sizeof(dir_itr_imp_header) <= dir_itr_imp_header_size, "dir_itr_imp header must fit in the space before dir_itr_imp");
+
+//! Frees a block allocated for a dir_itr_imp, given a pointer to its header
+inline void free_dir_itr_imp_block(void* block) BOOST_NOEXCEPT
+{
+    detail::deallocate_memory(block, static_cast< dir_itr_imp_header* >(block)->size, dir_itr_imp_extra_data_alignment);
+}
+
+#if defined(BOOST_FILESYSTEM_SINGLE_THREADED) || !defined(BOOST_NO_CXX11_THREAD_LOCAL)
+
+#define BOOST_FILESYSTEM_HAS_CACHED_DIR_ITR_IMPS
+
+/*!
+ * Blocks of the destroyed dir_itr_imp objects that are reused by the directory iterators created in the current thread.
+ *
+ * Every directory iterator allocates its implementation along with the buffer for reading directory entries, which is tens
+ * of kilobytes large (the getdents buffer on Linux, the NtQueryDirectoryFile buffer on Windows). Recursive directory iterators
+ * create and destroy a directory iterator for every subdirectory, so reusing the blocks saves a large allocation per directory.
+ * Keeping a few blocks is enough to cover the typical sequence of pops and pushes when the recursive iterator moves between
+ * sibling directories.
+ */
+struct cached_dir_itr_imps
+{
+    static BOOST_CONSTEXPR_OR_CONST unsigned int capacity = 4u;
+
+    //! Headers of the cached blocks
+    void* blocks[capacity];
+    unsigned int count;
+    //! Indicates that the cache has been destroyed, e.g. on thread termination, and must not be used
+    bool destroyed;
+
+    cached_dir_itr_imps() BOOST_NOEXCEPT : count(0u), destroyed(false) {}
+
+    ~cached_dir_itr_imps() BOOST_NOEXCEPT
+    {
+        for (unsigned int i = 0u; i < count; ++i)
+            free_dir_itr_imp_block(blocks[i]);
+        count = 0u;
+        destroyed = true;
+    }
+
+    //! Returns a cached block of \a size bytes, or \c NULL if there is none. Frees the blocks allocated with a memory allocator other than \a allocator.
+    void* take(std::size_t size, memory_allocator const* allocator) BOOST_NOEXCEPT
+    {
+        for (unsigned int i = count; i > 0u;)
+        {
+            --i;
+            dir_itr_imp_header const* header = static_cast< dir_itr_imp_header* >(blocks[i]);
+            if (BOOST_UNLIKELY(header->allocator != allocator))
+            {
+                free_dir_itr_imp_block(blocks[i]);
+                blocks[i] = blocks[--count];
+                continue;
+            }
+
+            if (header->size == size)
+            {
+                void* block = blocks[i];
+                blocks[i] = blocks[--count];
+                return block;
+            }
+        }
+
+        return NULL;
+    }
+
+    //! Puts a block into the cache. Returns \c false if the cache is full.
+    bool put(void* block) BOOST_NOEXCEPT
+    {
+        if (destroyed || count >= capacity)
+            return false;
+
+        blocks[count++] = block;
+        return true;
+    }
+
+    BOOST_DELETED_FUNCTION(cached_dir_itr_imps(cached_dir_itr_imps const&))
+    BOOST_DELETED_FUNCTION(cached_dir_itr_imps& operator=(cached_dir_itr_imps const&))
+};
+
+#if defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+cached_dir_itr_imps g_cached_dir_itr_imps;
+#else
+thread_local cached_dir_itr_imps g_cached_dir_itr_imps;
+#endif
+
+#endif // defined(BOOST_FILESYSTEM_SINGLE_THREADED) || !defined(BOOST_NO_CXX11_THREAD_LOCAL)
+
+//! Releases the block of a dir_itr_imp, given a pointer to the object
+inline void release_dir_itr_imp_block(void* p) BOOST_NOEXCEPT
+{
+    if (BOOST_LIKELY(p != NULL))
+    {
+        void* block = static_cast< unsigned char* >(p) - dir_itr_imp_header_size;
+#if defined(BOOST_FILESYSTEM_HAS_CACHED_DIR_ITR_IMPS)
+        if (g_cached_dir_itr_imps.put(block))
+            return;
+#endif
+        free_dir_itr_imp_block(block);
+    }
+}
+
+} // namespace
+
 BOOST_FILESYSTEM_DECL void* dir_itr_imp::operator new(std::size_t class_size, std::size_t extra_size) BOOST_NOEXCEPT
 {
     if (extra_size > 0)
         class_size = (class_size + dir_itr_imp_extra_data_alignment - 1u) & ~(dir_itr_imp_extra_data_alignment - 1u);
-    std::size_t total_size = class_size + extra_size;
+    std::size_t total_size = dir_itr_imp_header_size + class_size + extra_size;
+
+    memory_allocator const* const allocator = get_memory_allocator();
+    unsigned char* block;
+#if defined(BOOST_FILESYSTEM_HAS_CACHED_DIR_ITR_IMPS)
+    block = static_cast< unsigned char* >(g_cached_dir_itr_imps.take(total_size, allocator));
+    if (block)
+    {
+        // The extra data of a reused block is not cleared, dir_itr_create initializes the parts it relies on
+        std::memset(block + dir_itr_imp_header_size, 0, class_size);
+        return block + dir_itr_imp_header_size;
+    }
+#endif
 
     // Return NULL on OOM
-    void* p = std::malloc(total_size);
-    if (BOOST_LIKELY(p != NULL))
-        std::memset(p, 0, total_size);
-    return p;
+    block = static_cast< unsigned char* >(detail::allocate_memory(total_size, dir_itr_imp_extra_data_alignment, std::nothrow));
+    if (BOOST_UNLIKELY(block == NULL))
+        return NULL;
+
+    std::memset(block, 0, total_size);
+    dir_itr_imp_header* header = reinterpret_cast< dir_itr_imp_header* >(block);
+    header->size = total_size;
+    header->allocator = allocator;
+    return block + dir_itr_imp_header_size;
 }
 
-BOOST_FILESYSTEM_DECL void dir_itr_imp::operator delete(void* p, std::size_t extra_size) BOOST_NOEXCEPT
+BOOST_FILESYSTEM_DECL void dir_itr_imp::operator delete(void* p, std::size_t) BOOST_NOEXCEPT
 {
-    std::free(p);
+    release_dir_itr_imp_block(p);
 }
 
 BOOST_FILESYSTEM_DECL void dir_itr_imp::operator delete(void* p) BOOST_NOEXCEPT
 {
-    std::free(p);
+    release_dir_itr_imp_block(p);
 }
 
+#ifdef BOOST_POSIX_API
+
+//! Directory entries read in advance and sorted, used with directory_options::sort_by_name and sort_by_inode
+struct dir_itr_sorted_listing
+{
+    //! Copies of the directory entry records, up to and including the terminating zero of the name, each aligned for struct dirent
+    std::vector< unsigned char > records;
+    //! Offsets of the records, in the iteration order
+    std::vector< std::size_t > offsets;
+    //! Index of the next entry in offsets
+    std::size_t pos;
+
+    dir_itr_sorted_listing() : pos(0u) {}
+};
+
+//! Attributes of a directory entry queried in advance, used with directory_options::prefetch_status
+struct dir_itr_prefetched_attrs
+{
+    //! Status of the entry, not following symlinks, or \c status_error if the attributes could not be queried
+    file_status symlink_status;
+    //! Combination of \c directory_entry_cached_attrs flags
+    unsigned int attrs;
+    //! Indicates that the query has completed
+    bool ready;
+    boost::uintmax_t file_size;
+    boost::uintmax_t hard_link_count;
+    boost::uintmax_t inode;
+    boost::uint64_t device;
+    std::time_t last_write_time;
+
+    dir_itr_prefetched_attrs() BOOST_NOEXCEPT :
+        attrs(0u),
+        ready(false),
+        file_size(0u),
+        hard_link_count(0u),
+        inode(0u),
+        device(0u),
+        last_write_time(0)
+    {
+    }
+};
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+
+//! Directory entries read in advance in batches, with their attributes queried ahead of the iteration, used with directory_options::prefetch_status
+struct dir_itr_prefetch
+{
+    //! Copies of the directory entry records of the current batch, in the same format as in dir_itr_sorted_listing
+    std::vector< unsigned char > records;
+    //! Offsets of the records, in the iteration order
+    std::vector< std::size_t > offsets;
+    //! Attributes of the entries of the current batch, in the same order as offsets
+    std::vector< dir_itr_prefetched_attrs > attrs;
+    //! Index of the next entry in offsets
+    std::size_t pos;
+    //! Indicates that the directory stream has no more entries
+    bool eof;
+#if defined(BOOST_FILESYSTEM_USE_IO_URING)
+    //! Indicates that the attributes are queried asynchronously with io_uring
+    bool use_ring;
+    //! Indicates that at least one query through io_uring has succeeded
+    bool any_succeeded;
+    //! Number of queries that were not completed yet
+    unsigned int in_flight;
+    //! Number of queries that were not submitted to the kernel yet
+    unsigned int unsubmitted;
+    //! Results of statx requests, in the same order as offsets
+    std::vector< struct ::statx > statx_buffers;
+    io_uring_instance ring;
+#endif
+
+    dir_itr_prefetch() BOOST_NOEXCEPT :
+        pos(0u),
+        eof(false)
+#if defined(BOOST_FILESYSTEM_USE_IO_URING)
+        ,
+        use_ring(false),
+        any_succeeded(false),
+        in_flight(0u),
+        unsubmitted(0u)
+#endif
+    {
+    }
+};
+
+#endif // defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+
+#endif // BOOST_POSIX_API
+
+std::size_t g_descriptor_budget_limit = 0u;
+std::size_t g_descriptor_budget_used = 0u;
+
 namespace {
 
 inline void* get_dir_itr_imp_extra_data(dir_itr_imp* imp) BOOST_NOEXCEPT
@@ -175,10 +569,68 @@ inline void* get_dir_itr_imp_extra_data(dir_itr_imp* imp) BOOST_NOEXCEPT
     return reinterpret_cast< unsigned char* >(imp) + extra_data_offset;
 }
 
+#if defined(BOOST_WINDOWS_API)
+/*!
+ * \brief Default and minimum size of the buffer for GetFileInformationByHandleEx-based or NtQueryDirectoryFile-based directory iterator.
+ *
+ * Must be large enough to accommodate at least one FILE_DIRECTORY_INFORMATION or *_DIR_INFO struct and one filename.
+ * NTFS, VFAT, exFAT and ReFS support filenames up to 255 UTF-16/UCS-2 characters. (For ReFS, there is no information
+ * on the on-disk format, and it is possible that it supports longer filenames, up to 32768 UTF-16/UCS-2 characters.)
+ */
+BOOST_CONSTEXPR_OR_CONST std::size_t default_dir_itr_buffer_size = 65536u;
+BOOST_CONSTEXPR_OR_CONST std::size_t min_dir_itr_buffer_size = default_dir_itr_buffer_size;
+#else
+//! Default size of the buffer for getdents64-based directory iterator
+BOOST_CONSTEXPR_OR_CONST std::size_t default_dir_itr_buffer_size = 32768u;
+//! Minimum size of the buffer, must be large enough to accommodate at least one directory entry
+BOOST_CONSTEXPR_OR_CONST std::size_t min_dir_itr_buffer_size = 4096u;
+#endif
+//! Maximum size of the buffer used by directory iterators
+BOOST_CONSTEXPR_OR_CONST std::size_t max_dir_itr_buffer_size = 4194304u;
+
+//! Size of the buffer used by directory iterators
+std::size_t g_dir_itr_buffer_size = default_dir_itr_buffer_size;
+
+//! Default maximum number of open directories of recursive directory iterators with directory_options::limit_open_directories
+BOOST_CONSTEXPR_OR_CONST std::size_t default_rdi_open_directories_limit = 16u;
+//! Maximum number of open directories of recursive directory iterators with directory_options::limit_open_directories
+std::size_t g_rdi_open_directories_limit = default_rdi_open_directories_limit;
+//! Default maximum number of pending directories of recursive directory iterators with directory_options::breadth_first
+BOOST_CONSTEXPR_OR_CONST std::size_t default_rdi_pending_directories_limit = 65536u;
+//! Maximum number of pending directories of recursive directory iterators with directory_options::breadth_first
+std::size_t g_rdi_pending_directories_limit = default_rdi_pending_directories_limit;
+
+#if defined(BOOST_WINDOWS_API)
+//! Maximum size of the buffer supported by the OS. Up to Windows 8.1, NtQueryDirectoryFile and GetFileInformationByHandleEx
+//! fail with ERROR_INVALID_PARAMETER when trying to retrieve the filenames from a network share with a buffer larger than 64k.
+std::size_t g_max_dir_itr_buffer_size = default_dir_itr_buffer_size;
+#endif
+
 #ifdef BOOST_POSIX_API
 
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+int dir_itr_prefetch_drain(dir_itr_prefetch& pf) BOOST_NOEXCEPT;
+#endif
+
 inline system::error_code dir_itr_close(dir_itr_imp& imp) BOOST_NOEXCEPT
 {
+    if (imp.sorted_listing != NULL)
+    {
+        delete imp.sorted_listing;
+        imp.sorted_listing = NULL;
+    }
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    if (imp.prefetch != NULL)
+    {
+        // The queries in flight refer to the directory descriptor and write to the buffers, they must complete first.
+        // If they cannot be completed, leak the buffers rather than let the kernel write to freed memory.
+        if (BOOST_LIKELY(dir_itr_prefetch_drain(*imp.prefetch) == 0))
+            delete imp.prefetch;
+        imp.prefetch = NULL;
+    }
+#endif
+
     if (imp.handle != NULL)
     {
         DIR* h = static_cast< DIR* >(imp.handle);
@@ -237,127 +689,744 @@ inline std::size_t path_max()
 #endif // BOOST_FILESYSTEM_USE_READDIR_R
 
 // *result set to NULL on end of directory
-#if !defined(BOOST_FILESYSTEM_USE_READDIR_R)
+#if !defined(BOOST_FILESYSTEM_USE_READDIR_IMPL_PTR)
 inline
 #endif
 int readdir_impl(dir_itr_imp& imp, struct dirent** result)
 {
     errno = 0;
 
+    instrumentation_timer timer;
     struct dirent* p = ::readdir(static_cast< DIR* >(imp.handle));
+    timer.record(instrumented_operation::readdir);
     *result = p;
     if (!p)
         return errno;
     return 0;
 }
 
-#if !defined(BOOST_FILESYSTEM_USE_READDIR_R)
+#if !defined(BOOST_FILESYSTEM_USE_READDIR_IMPL_PTR)
 
 inline int invoke_readdir(dir_itr_imp& imp, struct dirent** result)
 {
     return readdir_impl(imp, result);
 }
 
-#else // !defined(BOOST_FILESYSTEM_USE_READDIR_R)
+#else // !defined(BOOST_FILESYSTEM_USE_READDIR_IMPL_PTR)
+
+int readdir_select_impl(dir_itr_imp& imp, struct dirent** result);
+
+typedef int readdir_impl_t(dir_itr_imp& imp, struct dirent** result);
+
+//! Pointer to the actual implementation of readdir
+readdir_impl_t* readdir_impl_ptr = &readdir_select_impl;
+
+#if defined(BOOST_FILESYSTEM_USE_READDIR_R)
 
 int readdir_r_impl(dir_itr_imp& imp, struct dirent** result)
 {
-    return ::readdir_r
+    instrumentation_timer timer;
+    int err = ::readdir_r
     (
         static_cast< DIR* >(imp.handle),
         static_cast< struct dirent* >(get_dir_itr_imp_extra_data(&imp)),
         result
     );
+    timer.record(instrumented_operation::readdir);
+    return err;
 }
 
-int readdir_select_impl(dir_itr_imp& imp, struct dirent** result);
+#endif // defined(BOOST_FILESYSTEM_USE_READDIR_R)
 
-typedef int readdir_impl_t(dir_itr_imp& imp, struct dirent** result);
+#if defined(BOOST_FILESYSTEM_USE_GETDENTS)
 
-//! Pointer to the actual implementation of the copy_file_data implementation
-readdir_impl_t* readdir_impl_ptr = &readdir_select_impl;
+//! Layout of the directory entry records filled by the getdents64 syscall
+struct linux_dirent64
+{
+    boost::uint64_t d_ino;
+    boost::int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
 
-void init_readdir_impl()
+//! Directory iterator state for the getdents64-based implementation, placed in dir_itr_imp extra data
+struct getdents_state
 {
-    readdir_impl_t* impl = &readdir_impl;
-    if (::sysconf(_SC_THREAD_SAFE_FUNCTIONS) >= 0)
-        impl = &readdir_r_impl;
+    //! Offset of the next entry in the buffer
+    std::size_t pos;
+    //! Size of the valid data in the buffer
+    std::size_t size;
+    //! Size of the buffer
+    std::size_t capacity;
+    //! Buffer for the directory entries, of capacity bytes
+    unsigned char buffer[1];
+};
 
-    filesystem::detail::atomic_store_relaxed(readdir_impl_ptr, impl);
+//! Returns true if struct dirent layout is compatible with the records returned by getdents64
+inline bool is_dirent_compatible_with_getdents() BOOST_NOEXCEPT
+{
+    return offsetof(struct dirent, d_reclen) == offsetof(linux_dirent64, d_reclen) &&
+        offsetof(struct dirent, d_type) == offsetof(linux_dirent64, d_type) &&
+        offsetof(struct dirent, d_name) == offsetof(linux_dirent64, d_name);
 }
 
-struct readdir_initializer
+//! Reads directory entries in bulk using getdents64 and returns them one by one from the internal buffer
+int getdents_impl(dir_itr_imp& imp, struct dirent** result)
 {
-    readdir_initializer()
+    getdents_state* state = static_cast< getdents_state* >(get_dir_itr_imp_extra_data(&imp));
+    if (state->pos >= state->size)
     {
-        init_readdir_impl();
+        const int fd = ::dirfd(static_cast< DIR* >(imp.handle));
+        long res;
+        while (true)
+        {
+            instrumentation_timer timer;
+            res = ::syscall(__NR_getdents64, fd, state->buffer, state->capacity);
+            timer.record(instrumented_operation::getdents);
+            if (BOOST_UNLIKELY(res < 0))
+            {
+                const int err = errno;
+                if (err == EINTR)
+                    continue;
+
+                if (err == ENOSYS && state->size == 0u)
+                {
+                    // getdents64 is not available (e.g. blocked by seccomp), fall back to readdir for this iterator.
+                    // This is only possible if no entries have been read from this directory yet. The process-wide
+                    // selection is left intact, as it is shared with other iterators and may have been set by the user.
+                    record_instrumented_event(instrumented_operation::implementation_fallback);
+                    BOOST_FILESYSTEM_TRACE1(getdents__downgrade, err);
+                    imp.read_backend = static_cast< unsigned char >(directory_read_backend::readdir);
+                    return readdir_impl(imp, result);
+                }
+
+                return err;
+            }
+
+            break;
+        }
+
+        if (res == 0)
+        {
+            *result = NULL;
+            return 0;
+        }
+
+        state->pos = 0u;
+        state->size = static_cast< std::size_t >(res);
+        imp.read_size += static_cast< boost::uintmax_t >(res);
     }
-};
 
-BOOST_FILESYSTEM_INIT_PRIORITY(BOOST_FILESYSTEM_FUNC_PTR_INIT_PRIORITY) BOOST_ATTRIBUTE_UNUSED BOOST_FILESYSTEM_ATTRIBUTE_RETAIN
-const readdir_initializer readdir_init;
+    struct dirent* p = reinterpret_cast< struct dirent* >(state->buffer + state->pos);
+    state->pos += p->d_reclen;
+    *result = p;
+    return 0;
+}
+
+//! Returns \c false if the getdents64 syscall is not available, e.g. because it is blocked by seccomp
+inline bool is_getdents_available() BOOST_NOEXCEPT
+{
+    // The syscall fails with EBADF on an invalid descriptor if it is available
+    const int prev_errno = errno;
+    const bool available = ::syscall(__NR_getdents64, -1, NULL, 0) >= 0 || errno != ENOSYS;
+    errno = prev_errno;
+    return available;
+}
+
+#endif // defined(BOOST_FILESYSTEM_USE_GETDENTS)
+
+//! Selects the readdir implementation based on the system capabilities
+readdir_impl_t* init_readdir_impl()
+{
+    readdir_impl_t* impl = &readdir_impl;
+#if defined(BOOST_FILESYSTEM_USE_GETDENTS)
+    if (is_dirent_compatible_with_getdents() && is_getdents_available())
+        impl = &getdents_impl;
+#endif
+#if defined(BOOST_FILESYSTEM_USE_READDIR_R)
+    if (::sysconf(_SC_THREAD_SAFE_FUNCTIONS) >= 0)
+        impl = &readdir_r_impl;
+#endif
+
+    filesystem::detail::atomic_store_relaxed(readdir_impl_ptr, impl);
+    return impl;
+}
 
 int readdir_select_impl(dir_itr_imp& imp, struct dirent** result)
 {
-    init_readdir_impl();
-    return filesystem::detail::atomic_load_relaxed(readdir_impl_ptr)(imp, result);
+    return init_readdir_impl()(imp, result);
+}
+
+//! Returns the backend identifier of the readdir implementation
+inline unsigned char get_readdir_backend(readdir_impl_t* impl) BOOST_NOEXCEPT
+{
+#if defined(BOOST_FILESYSTEM_USE_GETDENTS)
+    if (impl == &getdents_impl)
+        return static_cast< unsigned char >(directory_read_backend::getdents);
+#endif
+#if defined(BOOST_FILESYSTEM_USE_READDIR_R)
+    if (impl == &readdir_r_impl)
+        return static_cast< unsigned char >(directory_read_backend::readdir_r);
+#endif
+    return static_cast< unsigned char >(directory_read_backend::readdir);
 }
 
+//! Invokes the readdir implementation selected when the iterator was created. The iterator extra data depends on the implementation.
 inline int invoke_readdir(dir_itr_imp& imp, struct dirent** result)
 {
-    return filesystem::detail::atomic_load_relaxed(readdir_impl_ptr)(imp, result);
+    switch (imp.read_backend)
+    {
+#if defined(BOOST_FILESYSTEM_USE_GETDENTS)
+    case directory_read_backend::getdents:
+        return getdents_impl(imp, result);
+#endif
+#if defined(BOOST_FILESYSTEM_USE_READDIR_R)
+    case directory_read_backend::readdir_r:
+        return readdir_r_impl(imp, result);
+#endif
+    default:
+        return readdir_impl(imp, result);
+    }
 }
 
-#endif // !defined(BOOST_FILESYSTEM_USE_READDIR_R)
+#endif // !defined(BOOST_FILESYSTEM_USE_READDIR_IMPL_PTR)
 
-error_code dir_itr_increment(dir_itr_imp& imp, fs::path& filename, fs::file_status& sf, fs::file_status& symlink_sf)
+//! Orders directory entry records by name
+struct dirent_name_less
 {
-    dirent* result = NULL;
-    int err = invoke_readdir(imp, &result);
-    if (BOOST_UNLIKELY(err != 0))
-        return error_code(err, system_category());
-    if (result == NULL)
-        return dir_itr_close(imp);
+    const unsigned char* records;
 
-    filename = result->d_name;
+    explicit dirent_name_less(const unsigned char* recs) BOOST_NOEXCEPT : records(recs) {}
 
-#ifdef BOOST_FILESYSTEM_STATUS_CACHE
-    if (result->d_type == DT_UNKNOWN) // filesystem does not supply d_type value
+    bool operator()(std::size_t left, std::size_t right) const BOOST_NOEXCEPT
     {
-        sf = symlink_sf = fs::file_status(fs::status_error);
+        return std::strcmp(reinterpret_cast< const struct dirent* >(records + left)->d_name, reinterpret_cast< const struct dirent* >(records + right)->d_name) < 0;
     }
-    else // filesystem supplies d_type value
+};
+
+//! Orders directory entry records by inode number, then by name
+struct dirent_inode_less
+{
+    const unsigned char* records;
+
+    explicit dirent_inode_less(const unsigned char* recs) BOOST_NOEXCEPT : records(recs) {}
+
+    bool operator()(std::size_t left, std::size_t right) const BOOST_NOEXCEPT
     {
-        if (result->d_type == DT_DIR)
-            sf = symlink_sf = fs::file_status(fs::directory_file);
-        else if (result->d_type == DT_REG)
-            sf = symlink_sf = fs::file_status(fs::regular_file);
-        else if (result->d_type == DT_LNK)
-        {
-            sf = fs::file_status(fs::status_error);
-            symlink_sf = fs::file_status(fs::symlink_file);
-        }
-        else
-            sf = symlink_sf = fs::file_status(fs::status_error);
+        const struct dirent* l = reinterpret_cast< const struct dirent* >(records + left);
+        const struct dirent* r = reinterpret_cast< const struct dirent* >(records + right);
+        return l->d_ino < r->d_ino || (l->d_ino == r->d_ino && std::strcmp(l->d_name, r->d_name) < 0);
     }
-#else
-    sf = symlink_sf = fs::file_status(fs::status_error);
-#endif
+};
+
+//! Estimates the number of entries of the directory from its attributes. \a fs_type is the filesystem type, as reported by statfs, or 0.
+boost::uintmax_t estimate_directory_entry_count(struct ::stat const& st, unsigned long fs_type) BOOST_NOEXCEPT
+{
+    const boost::uintmax_t size = st.st_size > 0 ? static_cast< boost::uintmax_t >(st.st_size) : 0u;
+    boost::uintmax_t estimate;
+    switch (fs_type)
+    {
+#if defined(BOOST_FILESYSTEM_HAS_STATFS_F_TYPE)
+    case TMPFS_MAGIC:
+        // tmpfs accounts 20 bytes per entry, including dot and dot-dot
+        estimate = size / 20u;
+        estimate = estimate > 2u ? estimate - 2u : 0u;
+        break;
+
+    case BTRFS_SUPER_MAGIC:
+        // btrfs reports twice the total length of the entry names
+        estimate = size / 24u;
+        break;
+#endif
+
+    default:
+        // Block-based filesystems report the size of the directory blocks. Assume a typical record size for a short name,
+        // which overestimates the directories from which many entries were removed, as the blocks are not reclaimed.
+        estimate = size / 32u;
+        break;
+    }
+
+    // On traditional filesystems, every subdirectory adds a link to the directory
+    if (st.st_nlink > 2u && static_cast< boost::uintmax_t >(st.st_nlink - 2u) > estimate)
+        estimate = static_cast< boost::uintmax_t >(st.st_nlink - 2u);
+
+    return estimate;
+}
+
+//! Returns the filesystem type of the open file, as reported by statfs, or 0 if unknown
+inline unsigned long get_filesystem_type(int fd) BOOST_NOEXCEPT
+{
+#if defined(BOOST_FILESYSTEM_HAS_STATFS_F_TYPE)
+    struct statfs sfs;
+    if (::fstatfs(fd, &sfs) == 0)
+        return static_cast< unsigned long >(sfs.f_type);
+#endif
+    return 0u;
+}
+
+//! Returns the estimated number of entries of the directory being iterated, limited to a reasonable amount of storage to reserve
+std::size_t dir_itr_estimate_entry_count(dir_itr_imp& imp) BOOST_NOEXCEPT
+{
+    BOOST_CONSTEXPR_OR_CONST std::size_t max_reserved_entries = 1048576u;
+
+    const int fd = ::dirfd(static_cast< DIR* >(imp.handle));
+    struct ::stat st;
+    if (::fstat(fd, &st) != 0)
+        return 0u;
+
+    const boost::uintmax_t estimate = estimate_directory_entry_count(st, get_filesystem_type(fd));
+    return estimate < max_reserved_entries ? static_cast< std::size_t >(estimate) : max_reserved_entries;
+}
+
+//! Copies the directory entry record into the common buffer, so that no allocations per entry are needed
+void dir_itr_copy_record(std::vector< unsigned char >& records, std::vector< std::size_t >& offsets, const struct dirent* ent)
+{
+    BOOST_CONSTEXPR_OR_CONST std::size_t record_alignment = boost::alignment_of< struct dirent >::value;
+
+    const std::size_t copy_size = offsetof(struct dirent, d_name) + std::strlen(ent->d_name) + 1u;
+    const std::size_t offset = records.size();
+    records.resize(offset + ((copy_size + record_alignment - 1u) & ~(record_alignment - 1u)));
+    std::memcpy(&records[offset], ent, copy_size);
+    offsets.push_back(offset);
+}
+
+//! Reads all entries of the directory into a sorted listing, from which the entries will be produced
+error_code dir_itr_read_sorted(dir_itr_imp& imp, unsigned int opts)
+{
+    BOOST_CONSTEXPR_OR_CONST std::size_t record_alignment = boost::alignment_of< struct dirent >::value;
+
+    try
+    {
+        imp.sorted_listing = new dir_itr_sorted_listing();
+        dir_itr_sorted_listing& listing = *imp.sorted_listing;
+
+        // Reserve the storage for the estimated number of entries to avoid repeated reallocations while reading large directories
+        const std::size_t estimate = dir_itr_estimate_entry_count(imp);
+        listing.offsets.reserve(estimate);
+        listing.records.reserve(estimate * ((offsetof(struct dirent, d_name) + 16u + record_alignment - 1u) & ~(record_alignment - 1u)));
+        while (true)
+        {
+            dirent* result = NULL;
+            int err = invoke_readdir(imp, &result);
+            if (BOOST_UNLIKELY(err != 0))
+                return error_code(err, system_category());
+            if (result == NULL)
+                break;
+
+            dir_itr_copy_record(listing.records, listing.offsets, result);
+        }
+
+        if (!listing.offsets.empty())
+        {
+            if ((opts & static_cast< unsigned int >(directory_options::sort_by_inode)) != 0u)
+                std::sort(listing.offsets.begin(), listing.offsets.end(), dirent_inode_less(&listing.records[0]));
+            else
+                std::sort(listing.offsets.begin(), listing.offsets.end(), dirent_name_less(&listing.records[0]));
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        return make_error_code(system::errc::not_enough_memory);
+    }
+
+    return error_code();
+}
+
+//! Stores the attributes of a directory entry returned by lstat
+void set_prefetched_attrs(dir_itr_prefetched_attrs& attrs, struct ::stat const& st) BOOST_NOEXCEPT
+{
+    attrs.symlink_status = make_file_status(st.st_mode);
+    // The attributes of a symlink are not those reported by directory_entry, which follows symlinks
+    if (attrs.symlink_status.type() == symlink_file)
+        return;
+
+    attrs.file_size = st.st_size;
+    attrs.last_write_time = st.st_mtime;
+    attrs.hard_link_count = st.st_nlink;
+    attrs.inode = st.st_ino;
+    attrs.device = static_cast< boost::uint64_t >(st.st_dev);
+    attrs.attrs = file_size_cached | last_write_time_cached | hard_link_count_cached | inode_cached | device_cached;
+}
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+
+//! Number of directory entries read in one batch, whose attributes are queried ahead of the iteration
+BOOST_CONSTEXPR_OR_CONST std::size_t dir_itr_prefetch_batch_size = 64u;
+
+//! Returns \c true if the name is dot or dot-dot
+inline bool is_dot_or_dot_dot(const char* name) BOOST_NOEXCEPT
+{
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+#if defined(BOOST_FILESYSTEM_USE_IO_URING)
+
+//! Indicates whether io_uring with IORING_OP_STATX is supported by the kernel, for directory_options::prefetch_status
+bool g_dir_itr_prefetch_io_uring_supported = true;
+
+//! Stores the attributes of a directory entry returned by statx
+void set_prefetched_attrs(dir_itr_prefetched_attrs& attrs, int res, struct ::statx const& stx) BOOST_NOEXCEPT
+{
+    attrs.ready = true;
+    if (res < 0 || (stx.stx_mask & (STATX_TYPE | STATX_MODE)) != (STATX_TYPE | STATX_MODE))
+        return; // the attributes will be queried when requested, reporting the error, if any
+
+    attrs.symlink_status = make_file_status(stx.stx_mode);
+    // The attributes of a symlink are not those reported by directory_entry, which follows symlinks
+    if (attrs.symlink_status.type() == symlink_file)
+        return;
+
+    if ((stx.stx_mask & STATX_SIZE) != 0u)
+    {
+        attrs.file_size = stx.stx_size;
+        attrs.attrs |= file_size_cached;
+    }
+    if ((stx.stx_mask & STATX_MTIME) != 0u)
+    {
+        attrs.last_write_time = stx.stx_mtime.tv_sec;
+        attrs.attrs |= last_write_time_cached;
+    }
+    if ((stx.stx_mask & STATX_NLINK) != 0u)
+    {
+        attrs.hard_link_count = stx.stx_nlink;
+        attrs.attrs |= hard_link_count_cached;
+    }
+    if ((stx.stx_mask & STATX_INO) != 0u)
+    {
+        attrs.inode = stx.stx_ino;
+        attrs.attrs |= inode_cached;
+    }
+    attrs.device = static_cast< boost::uint64_t >(makedev(stx.stx_dev_major, stx.stx_dev_minor));
+    attrs.attrs |= device_cached;
+}
+
+//! Submits the pending queries, waits for at least one completion and processes the completions. Returns 0 on success or the error code.
+int dir_itr_prefetch_reap(dir_itr_prefetch& pf) BOOST_NOEXCEPT
+{
+    const int res = pf.ring.enter(pf.unsubmitted, 1u);
+    if (BOOST_UNLIKELY(res < 0))
+    {
+        const int err = errno;
+        // EBUSY means the completion queue is full, the completions will be reaped below
+        if (err != EINTR && err != EAGAIN && err != EBUSY)
+            return err;
+    }
+    else
+    {
+        pf.unsubmitted -= static_cast< unsigned int >(res);
+    }
+
+    unsigned int head = pf.ring.cq_head();
+    const unsigned int cq_tail = pf.ring.cq_tail();
+    for (; head != cq_tail; ++head)
+    {
+        struct io_uring_cqe const& cqe = pf.ring.get_cqe(head);
+        const std::size_t index = static_cast< std::size_t >(cqe.user_data);
+        if (BOOST_UNLIKELY(cqe.res == -EINVAL && !pf.any_succeeded))
+        {
+            // The kernel supports io_uring but not IORING_OP_STATX (Linux 5.1 - 5.5). Query the following batches synchronously.
+            filesystem::detail::atomic_store_relaxed(g_dir_itr_prefetch_io_uring_supported, false);
+            pf.use_ring = false;
+        }
+        else if (cqe.res >= 0)
+        {
+            pf.any_succeeded = true;
+        }
+
+        set_prefetched_attrs(pf.attrs[index], cqe.res, pf.statx_buffers[index]);
+        --pf.in_flight;
+    }
+    pf.ring.set_cq_head(head);
+
+    return 0;
+}
+
+#endif // defined(BOOST_FILESYSTEM_USE_IO_URING)
+
+//! Waits for completion of all queries in flight. Returns 0 on success or the error code, if the queries could not be completed.
+int dir_itr_prefetch_drain(dir_itr_prefetch& pf) BOOST_NOEXCEPT
+{
+#if defined(BOOST_FILESYSTEM_USE_IO_URING)
+    while (pf.in_flight > 0u)
+    {
+        const int err = dir_itr_prefetch_reap(pf);
+        if (BOOST_UNLIKELY(err != 0))
+            return err;
+    }
+#endif
+
+    return 0;
+}
+
+//! Queries the attributes of the directory entry synchronously
+void dir_itr_prefetch_stat(dir_itr_prefetched_attrs& attrs, int dir_fd, const char* name) BOOST_NOEXCEPT
+{
+    attrs.ready = true;
+
+    struct ::stat st;
+    if (::fstatat(dir_fd, name, &st, AT_SYMLINK_NOFOLLOW) == 0)
+        set_prefetched_attrs(attrs, st);
+    // Otherwise, the attributes will be queried when requested, reporting the error, if any
+}
+
+//! Starts querying the attributes of the entries of the current batch
+void dir_itr_prefetch_start(dir_itr_prefetch& pf, int dir_fd) BOOST_NOEXCEPT
+{
+    const std::size_t count = pf.offsets.size();
+#if defined(BOOST_FILESYSTEM_USE_IO_URING)
+    if (pf.use_ring)
+    {
+        unsigned int tail = pf.ring.sq_tail();
+        for (std::size_t i = 0u; i < count; ++i)
+        {
+            const struct dirent* ent = reinterpret_cast< const struct dirent* >(&pf.records[pf.offsets[i]]);
+            if (is_dot_or_dot_dot(ent->d_name))
+            {
+                pf.attrs[i].ready = true;
+                continue;
+            }
+
+            struct io_uring_sqe* sqe = pf.ring.get_sqe(tail++);
+            std::memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = IORING_OP_STATX;
+            sqe->fd = dir_fd;
+            sqe->addr = reinterpret_cast< boost::uint64_t >(ent->d_name);
+            sqe->len = STATX_TYPE | STATX_MODE | STATX_INO | STATX_NLINK | STATX_SIZE | STATX_MTIME;
+            sqe->off = reinterpret_cast< boost::uint64_t >(&pf.statx_buffers[i]);
+            sqe->statx_flags = AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT;
+            sqe->user_data = i;
+
+            ++pf.in_flight;
+            ++pf.unsubmitted;
+        }
+        pf.ring.set_sq_tail(tail);
+
+        // Submit the queries without waiting, the completions are processed when the entries are produced
+        if (pf.unsubmitted > 0u)
+        {
+            const int res = pf.ring.enter(pf.unsubmitted, 0u);
+            if (res > 0)
+                pf.unsubmitted -= static_cast< unsigned int >(res);
+        }
+
+        return;
+    }
+#endif // defined(BOOST_FILESYSTEM_USE_IO_URING)
+
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+        const struct dirent* ent = reinterpret_cast< const struct dirent* >(&pf.records[pf.offsets[i]]);
+        if (is_dot_or_dot_dot(ent->d_name))
+            pf.attrs[i].ready = true;
+        else
+            dir_itr_prefetch_stat(pf.attrs[i], dir_fd, ent->d_name);
+    }
+}
+
+//! Reads the next batch of directory entries and starts querying their attributes
+int dir_itr_read_prefetch_batch(dir_itr_imp& imp)
+{
+    dir_itr_prefetch& pf = *imp.prefetch;
+
+    // The buffers of the previous batch may still be used by the queries of the entries that were skipped
+    int err = dir_itr_prefetch_drain(pf);
+    if (BOOST_UNLIKELY(err != 0))
+        return err;
+
+    pf.records.clear();
+    pf.offsets.clear();
+    pf.attrs.clear();
+    pf.pos = 0u;
+
+    try
+    {
+        while (pf.offsets.size() < dir_itr_prefetch_batch_size)
+        {
+            dirent* result = NULL;
+            err = invoke_readdir(imp, &result);
+            if (BOOST_UNLIKELY(err != 0))
+                return err;
+            if (result == NULL)
+            {
+                pf.eof = true;
+                break;
+            }
+
+            dir_itr_copy_record(pf.records, pf.offsets, result);
+        }
+
+        pf.attrs.resize(pf.offsets.size());
+    }
+    catch (std::bad_alloc&)
+    {
+        return ENOMEM;
+    }
+
+    dir_itr_prefetch_start(pf, ::dirfd(static_cast< DIR* >(imp.handle)));
+    return 0;
+}
+
+//! Initializes reading directory entries in batches and querying their attributes in advance
+error_code dir_itr_init_prefetch(dir_itr_imp& imp)
+{
+    dir_itr_prefetch* pf = new (std::nothrow) dir_itr_prefetch();
+    if (BOOST_UNLIKELY(pf == NULL))
+        return make_error_code(system::errc::not_enough_memory);
+    imp.prefetch = pf;
+
+#if defined(BOOST_FILESYSTEM_USE_IO_URING)
+    if (filesystem::detail::atomic_load_relaxed(g_dir_itr_prefetch_io_uring_supported))
+    {
+        const int err = pf->ring.init(static_cast< unsigned int >(dir_itr_prefetch_batch_size));
+        if (BOOST_LIKELY(err == 0))
+        {
+            try
+            {
+                pf->statx_buffers.resize(dir_itr_prefetch_batch_size);
+                pf->use_ring = true;
+            }
+            catch (std::bad_alloc&)
+            {
+                return make_error_code(system::errc::not_enough_memory);
+            }
+        }
+        else if (err == ENOSYS || err == EPERM || err == EACCES || err == EINVAL)
+        {
+            // io_uring may be disabled by the kernel configuration, sysctl or seccomp filters
+            filesystem::detail::atomic_store_relaxed(g_dir_itr_prefetch_io_uring_supported, false);
+        }
+        // Otherwise, e.g. if the limit of open files is reached, query the attributes synchronously
+    }
+#endif // defined(BOOST_FILESYSTEM_USE_IO_URING)
+
+    return error_code();
+}
+
+//! Returns the attributes queried in advance for the current directory entry, or \c NULL if they are not available
+const dir_itr_prefetched_attrs* dir_itr_current_prefetched(dir_itr_imp& imp) BOOST_NOEXCEPT
+{
+    dir_itr_prefetch* pf = imp.prefetch;
+    if (pf == NULL || pf->pos == 0u)
+        return NULL;
+
+    dir_itr_prefetched_attrs const& attrs = pf->attrs[pf->pos - 1u];
+#if defined(BOOST_FILESYSTEM_USE_IO_URING)
+    while (!attrs.ready)
+    {
+        if (BOOST_UNLIKELY(dir_itr_prefetch_reap(*pf) != 0))
+            return NULL;
+    }
+#endif
+
+    return status_known(attrs.symlink_status) ? &attrs : NULL;
+}
+
+#endif // defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+
+//! Returns the next directory entry, either from the sorted listing or from the directory stream
+inline int dir_itr_read(dir_itr_imp& imp, struct dirent** result)
+{
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    dir_itr_prefetch* pf = imp.prefetch;
+    if (pf != NULL)
+    {
+        *result = NULL;
+        if (pf->pos >= pf->offsets.size())
+        {
+            if (pf->eof)
+                return 0;
+
+            const int err = dir_itr_read_prefetch_batch(imp);
+            if (BOOST_UNLIKELY(err != 0))
+                return err;
+            if (pf->offsets.empty())
+                return 0;
+        }
+
+        *result = reinterpret_cast< struct dirent* >(&pf->records[pf->offsets[pf->pos++]]);
+        return 0;
+    }
+#endif
+
+    dir_itr_sorted_listing* listing = imp.sorted_listing;
+    if (listing == NULL)
+        return invoke_readdir(imp, result);
+
+    *result = NULL;
+    if (listing->pos < listing->offsets.size())
+        *result = reinterpret_cast< struct dirent* >(&listing->records[listing->offsets[listing->pos++]]);
+    return 0;
+}
+
+error_code dir_itr_increment(dir_itr_imp& imp, fs::path& filename, fs::file_status& sf, fs::file_status& symlink_sf)
+{
+    dirent* result = NULL;
+    fs::file_type type;
+    while (true)
+    {
+        int err = dir_itr_read(imp, &result);
+        if (BOOST_UNLIKELY(err != 0))
+            return error_code(err, system_category());
+        if (result == NULL)
+            return dir_itr_close(imp);
+
+        type = fs::status_error;
+#ifdef BOOST_FILESYSTEM_STATUS_CACHE
+        // DT_UNKNOWN means the filesystem does not supply d_type value
+        if (result->d_type == DT_DIR)
+            type = fs::directory_file;
+        else if (result->d_type == DT_REG)
+            type = fs::regular_file;
+        else if (result->d_type == DT_LNK)
+            type = fs::symlink_file;
+#endif
+
+        // Match the raw entry name against the filter, if any, so that no path is composed for the skipped entries
+        if (!imp.filter)
+            break;
+
+        imp.filter_flags = imp.filter->filter(result->d_name, std::strlen(result->d_name), type);
+        if (imp.filter_flags != 0u)
+        {
+            if (BOOST_UNLIKELY((imp.filter_flags & dir_itr_filter::stop_iteration) != 0u))
+                return dir_itr_close(imp);
+            break;
+        }
+    }
+
+    filename = result->d_name;
+
+    // For symlinks, d_ino is the inode of the symlink rather than its target, and for directories it may be the inode of
+    // the mount point rather than of the root of the mounted filesystem. For regular files, it is the same as st_ino.
+    imp.current_inode = type == fs::regular_file ? static_cast< boost::uintmax_t >(result->d_ino) : static_cast< boost::uintmax_t >(0u);
+
+    symlink_sf = fs::file_status(type);
+    sf = fs::file_status(type != fs::symlink_file ? type : fs::status_error);
     return error_code();
 }
 
 error_code dir_itr_create(boost::intrusive_ptr< detail::dir_itr_imp >& imp, fs::path const& dir, unsigned int opts, directory_iterator_params* params, fs::path& first_filename, fs::file_status&, fs::file_status&)
 {
     std::size_t extra_size = 0u;
-#if defined(BOOST_FILESYSTEM_USE_READDIR_R)
+#if defined(BOOST_FILESYSTEM_USE_GETDENTS)
+    std::size_t buffer_size = 0u;
+#endif
+#if defined(BOOST_FILESYSTEM_USE_READDIR_IMPL_PTR)
+    readdir_impl_t* rdimpl;
     {
-        readdir_impl_t* rdimpl = filesystem::detail::atomic_load_relaxed(readdir_impl_ptr);
+        rdimpl = filesystem::detail::atomic_load_relaxed(readdir_impl_ptr);
         if (BOOST_UNLIKELY(rdimpl == &readdir_select_impl))
+            rdimpl = init_readdir_impl();
+
+#if defined(BOOST_FILESYSTEM_USE_GETDENTS)
+        if (rdimpl == &getdents_impl)
         {
-            init_readdir_impl();
-            rdimpl = filesystem::detail::atomic_load_relaxed(readdir_impl_ptr);
+            buffer_size = filesystem::detail::atomic_load_relaxed(g_dir_itr_buffer_size);
+            extra_size = offsetof(getdents_state, buffer) + buffer_size;
         }
-
+#endif
+#if defined(BOOST_FILESYSTEM_USE_READDIR_R)
         if (rdimpl == &readdir_r_impl)
         {
             // According to readdir description, there's no reliable way to predict the length of the d_name string.
@@ -367,23 +1436,40 @@ error_code dir_itr_create(boost::intrusive_ptr< detail::dir_itr_imp >& imp, fs::
             // in favor of readdir.
             extra_size = (sizeof(dirent) - sizeof(dirent().d_name)) + path_max() + 1u; // + 1 for "\0"
         }
-    }
 #endif // defined(BOOST_FILESYSTEM_USE_READDIR_R)
+    }
+#endif // defined(BOOST_FILESYSTEM_USE_READDIR_IMPL_PTR)
 
     boost::intrusive_ptr< detail::dir_itr_imp > pimpl(new (extra_size) detail::dir_itr_imp());
     if (BOOST_UNLIKELY(!pimpl))
         return make_error_code(system::errc::not_enough_memory);
 
+#if defined(BOOST_FILESYSTEM_USE_READDIR_IMPL_PTR)
+    pimpl->read_backend = get_readdir_backend(rdimpl);
+#endif
+
+#if defined(BOOST_FILESYSTEM_USE_GETDENTS)
+    if (buffer_size > 0u)
+    {
+        getdents_state* state = static_cast< getdents_state* >(get_dir_itr_imp_extra_data(pimpl.get()));
+        state->pos = 0u;
+        state->size = 0u;
+        state->capacity = buffer_size;
+    }
+#endif
+
 #if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW)
     int flags = O_DIRECTORY | O_RDONLY | O_NONBLOCK | O_CLOEXEC;
     if ((opts & static_cast< unsigned int >(directory_options::_detail_no_follow)) != 0u)
         flags |= O_NOFOLLOW;
 
+    instrumentation_timer timer;
 #if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
-    int fd = ::openat(params ? params->basedir_fd : AT_FDCWD, dir.c_str(), flags);
+    int fd = ::openat(params ? params->basedir_fd : AT_FDCWD, (params && params->open_path) ? params->open_path : dir.c_str(), flags);
 #else
     int fd = ::open(dir.c_str(), flags);
 #endif
+    timer.record(instrumented_operation::open_directory);
     if (BOOST_UNLIKELY(fd < 0))
     {
         const int err = errno;
@@ -408,7 +1494,9 @@ error_code dir_itr_create(boost::intrusive_ptr< detail::dir_itr_imp >& imp, fs::
         return error_code(err, system_category());
     }
 #else // defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW)
+    instrumentation_timer timer;
     pimpl->handle = ::opendir(dir.c_str());
+    timer.record(instrumented_operation::open_directory);
     if (BOOST_UNLIKELY(!pimpl->handle))
     {
         const int err = errno;
@@ -416,6 +1504,21 @@ error_code dir_itr_create(boost::intrusive_ptr< detail::dir_itr_imp >& imp, fs::
     }
 #endif // defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW)
 
+    if ((opts & static_cast< unsigned int >(directory_options::sort_by_name | directory_options::sort_by_inode)) != 0u)
+    {
+        error_code ec = dir_itr_read_sorted(*pimpl, opts);
+        if (BOOST_UNLIKELY(!!ec))
+            return ec;
+    }
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    else if ((opts & static_cast< unsigned int >(directory_options::prefetch_status)) != 0u)
+    {
+        error_code ec = dir_itr_init_prefetch(*pimpl);
+        if (BOOST_UNLIKELY(!!ec))
+            return ec;
+    }
+#endif
+
     // Force initial readdir call by the caller. This will initialize the actual first filename and statuses.
     first_filename.assign(".");
 
@@ -473,12 +1576,6 @@ inline void set_file_statuses(DWORD attrs, const ULONG* reparse_point_tag, fs::p
 
 #if !defined(UNDER_CE)
 
-//! FILE_ID_128 definition from Windows SDK
-struct file_id_128
-{
-    BYTE Identifier[16];
-};
-
 //! FILE_DIRECTORY_INFORMATION definition from Windows DDK. Used by NtQueryDirectoryFile, supported since Windows NT 4.0 (probably).
 struct file_directory_information
 {
@@ -557,39 +1654,165 @@ enum extra_data_format
     file_directory_information_format,
     file_id_both_dir_info_format,
     file_full_dir_info_format,
-    file_id_extd_dir_info_format
+    file_id_extd_dir_info_format,
+    //! WIN32_FIND_DATAW filled by FindFirstFileExW/FindNextFileW, used if the filesystem does not support the handle-based queries
+    find_data_format
 };
 
+//! FindExInfoBasic value, which may not be defined in older SDKs. Supported since Windows 7.
+BOOST_CONSTEXPR_OR_CONST FINDEX_INFO_LEVELS find_ex_info_basic = static_cast< FINDEX_INFO_LEVELS >(1);
+//! FIND_FIRST_EX_LARGE_FETCH value, which may not be defined in older SDKs. Supported since Windows 7.
+BOOST_CONSTEXPR_OR_CONST DWORD find_first_ex_large_fetch = 2u;
+
 //! Indicates extra data format that should be used by directory iterator by default
 extra_data_format g_extra_data_format = file_directory_information_format;
 
-/*!
- * \brief Extra buffer size for GetFileInformationByHandleEx-based or NtQueryDirectoryFile-based directory iterator.
- *
- * Must be large enough to accommodate at least one FILE_DIRECTORY_INFORMATION or *_DIR_INFO struct and one filename.
- * NTFS, VFAT, exFAT and ReFS support filenames up to 255 UTF-16/UCS-2 characters. (For ReFS, there is no information
- * on the on-disk format, and it is possible that it supports longer filenames, up to 32768 UTF-16/UCS-2 characters.)
- * The buffer cannot be larger than 64k, because up to Windows 8.1, NtQueryDirectoryFile and GetFileInformationByHandleEx
- * fail with ERROR_INVALID_PARAMETER when trying to retrieve the filenames from a network share.
- */
-BOOST_CONSTEXPR_OR_CONST std::size_t dir_itr_extra_size = 65536u;
-
-inline system::error_code dir_itr_close(dir_itr_imp& imp) BOOST_NOEXCEPT
+//! Obtains file size and last write time from the directory information. Returns directory_entry_cached_attrs flags.
+template< typename Info >
+inline unsigned int get_dir_info_attrs(const Info* data, boost::uintmax_t& file_size, std::time_t& last_write_time) BOOST_NOEXCEPT
 {
-    imp.extra_data_format = 0u;
-    imp.current_offset = 0u;
+    // For reparse points the information describes the reparse point itself, while directory_entry
+    // attributes must describe the target file. Leave the attributes to be queried by directory_entry.
+    if ((data->FileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0u)
+        return 0u;
 
-    if (imp.handle != NULL)
-    {
-        if (BOOST_LIKELY(imp.close_handle))
-            ::CloseHandle(imp.handle);
-        imp.handle = NULL;
-    }
+    file_size = static_cast< boost::uintmax_t >(data->EndOfFile.QuadPart);
 
-    return error_code();
+    FILETIME ft;
+    ft.dwLowDateTime = data->LastWriteTime.LowPart;
+    ft.dwHighDateTime = static_cast< DWORD >(data->LastWriteTime.HighPart);
+    last_write_time = to_time_t(ft);
+
+    return file_size_cached | last_write_time_cached;
 }
 
-error_code dir_itr_increment(dir_itr_imp& imp, fs::path& filename, fs::file_status& sf, fs::file_status& symlink_sf)
+//! Obtains file size and last write time from the data returned by FindFirstFileExW. Returns directory_entry_cached_attrs flags.
+inline unsigned int get_find_data_attrs(const WIN32_FIND_DATAW* data, boost::uintmax_t& file_size, std::time_t& last_write_time) BOOST_NOEXCEPT
+{
+    if ((data->dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0u)
+        return 0u;
+
+    file_size = (static_cast< boost::uintmax_t >(data->nFileSizeHigh) << 32u) | data->nFileSizeLow;
+    last_write_time = to_time_t(data->ftLastWriteTime);
+
+    return file_size_cached | last_write_time_cached;
+}
+
+//! Obtains attributes of the current directory entry from the directory information. Returns directory_entry_cached_attrs flags.
+unsigned int get_current_entry_attrs(dir_itr_imp& imp, boost::uintmax_t& file_size, std::time_t& last_write_time, boost::uintmax_t& inode) BOOST_NOEXCEPT
+{
+    const void* current_data = static_cast< const unsigned char* >(get_dir_itr_imp_extra_data(&imp)) + imp.current_offset;
+    switch (imp.extra_data_format)
+    {
+    case file_id_extd_dir_info_format:
+        {
+            const file_id_extd_dir_info* data = static_cast< const file_id_extd_dir_info* >(current_data);
+            unsigned int attrs = get_dir_info_attrs(data, file_size, last_write_time);
+            if (attrs != 0u)
+            {
+                // 128-bit file ids are only used by ReFS. On other filesystems, the upper 64 bits are zero
+                // and the lower 64 bits are equal to the file index returned by GetFileInformationByHandle.
+                boost::uint64_t id_low, id_high;
+                std::memcpy(&id_low, data->FileId.Identifier, sizeof(id_low));
+                std::memcpy(&id_high, data->FileId.Identifier + sizeof(id_low), sizeof(id_high));
+                if (id_high == 0u)
+                {
+                    inode = id_low;
+                    attrs |= inode_cached;
+                }
+            }
+            return attrs;
+        }
+
+    case file_full_dir_info_format:
+        return get_dir_info_attrs(static_cast< const file_full_dir_info* >(current_data), file_size, last_write_time);
+
+    case find_data_format:
+        return get_find_data_attrs(static_cast< const WIN32_FIND_DATAW* >(current_data), file_size, last_write_time);
+
+    case file_id_both_dir_info_format:
+        {
+            const file_id_both_dir_info* data = static_cast< const file_id_both_dir_info* >(current_data);
+            unsigned int attrs = get_dir_info_attrs(data, file_size, last_write_time);
+            if (attrs != 0u)
+            {
+                inode = static_cast< boost::uintmax_t >(data->FileId.QuadPart);
+                attrs |= inode_cached;
+            }
+            return attrs;
+        }
+
+    default:
+        return get_dir_info_attrs(static_cast< const file_directory_information* >(current_data), file_size, last_write_time);
+    }
+}
+
+inline system::error_code dir_itr_close(dir_itr_imp& imp) BOOST_NOEXCEPT
+{
+    if (imp.handle != NULL)
+    {
+        if (BOOST_LIKELY(imp.close_handle))
+        {
+            if (imp.extra_data_format == find_data_format)
+                ::FindClose(imp.handle);
+            else
+                ::CloseHandle(imp.handle);
+        }
+        imp.handle = NULL;
+    }
+
+    imp.extra_data_format = 0u;
+    imp.current_offset = 0u;
+
+    return error_code();
+}
+
+//! Starts iterating directory \a dir with FindFirstFileExW. Used when the filesystem does not support the handle-based directory queries.
+/*!
+ * This is the case for some filesystem filter drivers and older SMB servers. To reduce the number of round trips to the server,
+ * the larger fetch size is requested, and generation of short names, which the iterator does not use, is disabled.
+ */
+error_code dir_itr_find_first(dir_itr_imp& imp, fs::path const& dir, fs::path& first_filename, fs::file_status& sf, fs::file_status& symlink_sf)
+{
+    fs::path dirpath(dir);
+    dirpath.make_preferred();
+    dirpath /= L"*";
+
+    WIN32_FIND_DATAW* data = static_cast< WIN32_FIND_DATAW* >(get_dir_itr_imp_extra_data(&imp));
+    HANDLE h = ::FindFirstFileExW(dirpath.c_str(), find_ex_info_basic, data, FindExSearchNameMatch, NULL, find_first_ex_large_fetch);
+    if (BOOST_UNLIKELY(h == INVALID_HANDLE_VALUE))
+    {
+        DWORD error = ::GetLastError();
+        if (error == ERROR_INVALID_PARAMETER)
+        {
+            // FindExInfoBasic and FIND_FIRST_EX_LARGE_FETCH are not supported before Windows 7
+            h = ::FindFirstFileExW(dirpath.c_str(), FindExInfoStandard, data, FindExSearchNameMatch, NULL, 0u);
+            if (h == INVALID_HANDLE_VALUE)
+                error = ::GetLastError();
+        }
+
+        if (h == INVALID_HANDLE_VALUE)
+        {
+            // An empty root directory has no "." or ".." entries, which is reported as ERROR_FILE_NOT_FOUND
+            if (error == ERROR_FILE_NOT_FOUND || error == ERROR_NO_MORE_FILES)
+                return error_code();
+
+            return error_code(error, system_category());
+        }
+    }
+
+    imp.handle = h;
+    imp.close_handle = true;
+    imp.extra_data_format = find_data_format;
+    imp.current_offset = 0u;
+
+    first_filename = data->cFileName;
+    set_file_statuses(data->dwFileAttributes, data->dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT ? &data->dwReserved0 : NULL, first_filename, sf, symlink_sf);
+
+    return error_code();
+}
+
+error_code dir_itr_increment(dir_itr_imp& imp, fs::path& filename, fs::file_status& sf, fs::file_status& symlink_sf)
 {
     void* extra_data = get_dir_itr_imp_extra_data(&imp);
     const void* current_data = static_cast< const unsigned char* >(extra_data) + imp.current_offset;
@@ -600,7 +1823,7 @@ error_code dir_itr_increment(dir_itr_imp& imp, fs::path& filename, fs::file_stat
             const file_id_extd_dir_info* data = static_cast< const file_id_extd_dir_info* >(current_data);
             if (data->NextEntryOffset == 0u)
             {
-                if (!filesystem::detail::atomic_load_relaxed(get_file_information_by_handle_ex_api)(imp.handle, file_id_extd_directory_info_class, extra_data, dir_itr_extra_size))
+                if (!filesystem::detail::atomic_load_relaxed(get_file_information_by_handle_ex_api)(imp.handle, file_id_extd_directory_info_class, extra_data, static_cast< DWORD >(imp.buffer_size)))
                 {
                     DWORD error = ::GetLastError();
 
@@ -630,7 +1853,7 @@ error_code dir_itr_increment(dir_itr_imp& imp, fs::path& filename, fs::file_stat
             const file_full_dir_info* data = static_cast< const file_full_dir_info* >(current_data);
             if (data->NextEntryOffset == 0u)
             {
-                if (!filesystem::detail::atomic_load_relaxed(get_file_information_by_handle_ex_api)(imp.handle, file_full_directory_info_class, extra_data, dir_itr_extra_size))
+                if (!filesystem::detail::atomic_load_relaxed(get_file_information_by_handle_ex_api)(imp.handle, file_full_directory_info_class, extra_data, static_cast< DWORD >(imp.buffer_size)))
                 {
                     DWORD error = ::GetLastError();
 
@@ -660,7 +1883,7 @@ error_code dir_itr_increment(dir_itr_imp& imp, fs::path& filename, fs::file_stat
             const file_id_both_dir_info* data = static_cast< const file_id_both_dir_info* >(current_data);
             if (data->NextEntryOffset == 0u)
             {
-                if (!filesystem::detail::atomic_load_relaxed(get_file_information_by_handle_ex_api)(imp.handle, file_id_both_directory_info_class, extra_data, dir_itr_extra_size))
+                if (!filesystem::detail::atomic_load_relaxed(get_file_information_by_handle_ex_api)(imp.handle, file_id_both_directory_info_class, extra_data, static_cast< DWORD >(imp.buffer_size)))
                 {
                     DWORD error = ::GetLastError();
 
@@ -685,6 +1908,25 @@ error_code dir_itr_increment(dir_itr_imp& imp, fs::path& filename, fs::file_stat
         }
         break;
 
+    case find_data_format:
+        {
+            WIN32_FIND_DATAW* data = static_cast< WIN32_FIND_DATAW* >(extra_data);
+            if (!::FindNextFileW(imp.handle, data))
+            {
+                DWORD error = ::GetLastError();
+
+                dir_itr_close(imp);
+                if (error == ERROR_NO_MORE_FILES)
+                    goto done;
+
+                return error_code(error, system_category());
+            }
+
+            filename = data->cFileName;
+            set_file_statuses(data->dwFileAttributes, data->dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT ? &data->dwReserved0 : NULL, filename, sf, symlink_sf);
+        }
+        break;
+
     default:
         {
             const file_directory_information* data = static_cast< const file_directory_information* >(current_data);
@@ -699,7 +1941,7 @@ error_code dir_itr_increment(dir_itr_imp& imp, fs::path& filename, fs::file_stat
                     NULL, // ApcContext
                     &iosb,
                     extra_data,
-                    dir_itr_extra_size,
+                    static_cast< ULONG >(imp.buffer_size),
                     file_directory_information_class,
                     FALSE, // ReturnSingleEntry
                     NULL, // FileName
@@ -716,6 +1958,7 @@ error_code dir_itr_increment(dir_itr_imp& imp, fs::path& filename, fs::file_stat
                 }
 
                 imp.current_offset = 0u;
+                imp.read_size += static_cast< boost::uintmax_t >(iosb.Information);
                 data = static_cast< const file_directory_information* >(extra_data);
             }
             else
@@ -736,20 +1979,29 @@ done:
 
 error_code dir_itr_create(boost::intrusive_ptr< detail::dir_itr_imp >& imp, fs::path const& dir, unsigned int opts, directory_iterator_params* params, fs::path& first_filename, fs::file_status& sf, fs::file_status& symlink_sf)
 {
-    boost::intrusive_ptr< detail::dir_itr_imp > pimpl(new (dir_itr_extra_size) detail::dir_itr_imp());
+    const std::size_t buffer_size = filesystem::detail::atomic_load_relaxed(g_dir_itr_buffer_size);
+    boost::intrusive_ptr< detail::dir_itr_imp > pimpl(new (buffer_size) detail::dir_itr_imp());
     if (BOOST_UNLIKELY(!pimpl))
         return make_error_code(system::errc::not_enough_memory);
 
+    pimpl->buffer_size = buffer_size;
+
     GetFileInformationByHandleEx_t* get_file_information_by_handle_ex = filesystem::detail::atomic_load_relaxed(get_file_information_by_handle_ex_api);
 
     handle_wrapper h;
     HANDLE iterator_handle;
     bool close_handle = true;
+    // FindFirstFileExW can only be used as a fallback if the iterator opens the directory by path
+    bool find_by_path = true;
     if (params != NULL && params->use_handle != INVALID_HANDLE_VALUE)
     {
+        find_by_path = false;
         // Operate on externally provided handle, which must be a directory handle
         iterator_handle = params->use_handle;
         close_handle = params->close_handle;
+        // If the iterator owns the handle, make sure it is closed on errors
+        if (close_handle)
+            h.handle = iterator_handle;
     }
     else
     {
@@ -801,7 +2053,7 @@ error_code dir_itr_create(boost::intrusive_ptr< detail::dir_itr_imp >& imp, fs::
 
             if ((opts & static_cast< unsigned int >(directory_options::_detail_no_follow)) != 0u)
             {
-                if ((info.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0u && is_reparse_point_a_symlink_ioctl(h.handle))
+                if ((info.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0u && is_reparse_point_a_symlink_ioctl(iterator_handle))
                     return make_error_code(system::errc::too_many_symbolic_link_levels);
             }
         }
@@ -812,7 +2064,7 @@ error_code dir_itr_create(boost::intrusive_ptr< detail::dir_itr_imp >& imp, fs::
     {
     case file_id_extd_dir_info_format:
         {
-            if (!get_file_information_by_handle_ex(iterator_handle, file_id_extd_directory_restart_info_class, extra_data, dir_itr_extra_size))
+            if (!get_file_information_by_handle_ex(iterator_handle, file_id_extd_directory_restart_info_class, extra_data, static_cast< DWORD >(buffer_size)))
             {
                 DWORD error = ::GetLastError();
 
@@ -846,7 +2098,7 @@ error_code dir_itr_create(boost::intrusive_ptr< detail::dir_itr_imp >& imp, fs::
     case file_full_dir_info_format:
     fallback_to_file_full_dir_info_format:
         {
-            if (!get_file_information_by_handle_ex(iterator_handle, file_full_directory_restart_info_class, extra_data, dir_itr_extra_size))
+            if (!get_file_information_by_handle_ex(iterator_handle, file_full_directory_restart_info_class, extra_data, static_cast< DWORD >(buffer_size)))
             {
                 DWORD error = ::GetLastError();
 
@@ -875,13 +2127,18 @@ error_code dir_itr_create(boost::intrusive_ptr< detail::dir_itr_imp >& imp, fs::
     case file_id_both_dir_info_format:
     fallback_to_file_id_both_dir_info:
         {
-            if (!get_file_information_by_handle_ex(iterator_handle, file_id_both_directory_restart_info_class, extra_data, dir_itr_extra_size))
+            if (!get_file_information_by_handle_ex(iterator_handle, file_id_both_directory_restart_info_class, extra_data, static_cast< DWORD >(buffer_size)))
             {
                 DWORD error = ::GetLastError();
 
                 if (error == ERROR_NO_MORE_FILES || error == ERROR_FILE_NOT_FOUND)
                     goto done;
 
+                // Some filter drivers and SMB servers don't support any of the handle-based queries. Don't downgrade
+                // g_extra_data_format as this is specific to the filesystem of the directory.
+                if ((error == ERROR_NOT_SUPPORTED || error == ERROR_INVALID_PARAMETER) && find_by_path)
+                    goto fallback_to_find_data;
+
                 return error_code(error, system_category());
             }
 
@@ -898,7 +2155,11 @@ error_code dir_itr_create(boost::intrusive_ptr< detail::dir_itr_imp >& imp, fs::
         {
             NtQueryDirectoryFile_t* nt_query_directory_file = filesystem::detail::atomic_load_relaxed(boost::filesystem::detail::nt_query_directory_file_api);
             if (BOOST_UNLIKELY(!nt_query_directory_file))
+            {
+                if (find_by_path)
+                    goto fallback_to_find_data;
                 return error_code(ERROR_NOT_SUPPORTED, system_category());
+            }
 
             io_status_block iosb;
             boost::winapi::NTSTATUS_ status = nt_query_directory_file
@@ -909,7 +2170,7 @@ error_code dir_itr_create(boost::intrusive_ptr< detail::dir_itr_imp >& imp, fs::
                 NULL, // ApcContext
                 &iosb,
                 extra_data,
-                dir_itr_extra_size,
+                static_cast< ULONG >(buffer_size),
                 file_directory_information_class,
                 FALSE, // ReturnSingleEntry
                 NULL, // FileName
@@ -925,10 +2186,14 @@ error_code dir_itr_create(boost::intrusive_ptr< detail::dir_itr_imp >& imp, fs::
                 if (status == STATUS_NO_MORE_FILES || status == STATUS_NO_SUCH_FILE)
                     goto done;
 
+                if ((status == STATUS_INVALID_INFO_CLASS || status == STATUS_NOT_IMPLEMENTED || status == STATUS_NOT_SUPPORTED || status == STATUS_INVALID_PARAMETER) && find_by_path)
+                    goto fallback_to_find_data;
+
                 return error_code(translate_ntstatus(status), system_category());
             }
 
             pimpl->extra_data_format = file_directory_information_format;
+            pimpl->read_size = static_cast< boost::uintmax_t >(iosb.Information);
 
             const file_directory_information* data = static_cast< const file_directory_information* >(extra_data);
             first_filename.assign(data->FileName, data->FileName + data->FileNameLength / sizeof(WCHAR));
@@ -946,6 +2211,15 @@ error_code dir_itr_create(boost::intrusive_ptr< detail::dir_itr_imp >& imp, fs::
 done:
     imp.swap(pimpl);
     return error_code();
+
+fallback_to_find_data:
+    {
+        // The directory handle is no longer needed, it will be closed by h
+        error_code ec = dir_itr_find_first(*pimpl, dir, first_filename, sf, symlink_sf);
+        if (BOOST_UNLIKELY(!!ec))
+            return ec;
+    }
+    goto done;
 }
 
 #else // !defined(UNDER_CE)
@@ -1030,7 +2304,7 @@ BOOST_CONSTEXPR_OR_CONST err_t not_found_error_code = ERROR_PATH_NOT_FOUND;
 #if defined(BOOST_WINDOWS_API) && !defined(UNDER_CE)
 
 //! Initializes directory iterator implementation
-void init_directory_iterator_impl() BOOST_NOEXCEPT
+void init_directory_iterator_impl(unsigned int major_ver) BOOST_NOEXCEPT
 {
     if (filesystem::detail::atomic_load_relaxed(get_file_information_by_handle_ex_api) != NULL)
     {
@@ -1038,148 +2312,1310 @@ void init_directory_iterator_impl() BOOST_NOEXCEPT
         // to create the directory iterator the first time.
         filesystem::detail::atomic_store_relaxed(g_extra_data_format, file_id_extd_dir_info_format);
     }
+
+    if (major_ver >= 10u)
+        filesystem::detail::atomic_store_relaxed(g_max_dir_itr_buffer_size, max_dir_itr_buffer_size);
 }
 
 #endif // defined(BOOST_WINDOWS_API) && !defined(UNDER_CE)
 
-BOOST_FILESYSTEM_DECL
-dir_itr_imp::~dir_itr_imp() BOOST_NOEXCEPT
+namespace {
+
+#if defined(BOOST_POSIX_API)
+
+//! Returns \c true if \a name is not "." or ".."
+inline bool is_not_dot_name(const char* name) BOOST_NOEXCEPT
 {
-    dir_itr_close(*this);
+    return !(name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')));
 }
 
-BOOST_FILESYSTEM_DECL
-void directory_iterator_construct(directory_iterator& it, path const& p, unsigned int opts, directory_iterator_params* params, system::error_code* ec)
+//! Checks if the directory stream has any entries other than dot entries. Returns 0 on success or the error code.
+int is_empty_directory_readdir(DIR* dir, bool& empty) BOOST_NOEXCEPT
 {
-    if (BOOST_UNLIKELY(p.empty()))
+    while (true)
     {
-        emit_error(not_found_error_code, p, ec, "boost::filesystem::directory_iterator::construct");
-        return;
+        errno = 0;
+        instrumentation_timer timer;
+        struct dirent* ent = ::readdir(dir);
+        timer.record(instrumented_operation::readdir);
+        if (!ent)
+        {
+            empty = true;
+            return errno;
+        }
+
+        if (is_not_dot_name(ent->d_name))
+        {
+            empty = false;
+            return 0;
+        }
     }
+}
+
+#else // defined(BOOST_POSIX_API)
+
+#if !defined(UNDER_CE)
+
+//! FILE_NAMES_INFORMATION definition from Windows DDK. The smallest information class returned by NtQueryDirectoryFile.
+struct file_names_information
+{
+    ULONG NextEntryOffset;
+    ULONG FileIndex;
+    ULONG FileNameLength;
+    WCHAR FileName[1];
+};
+
+//! Returns \c true if \a name is not "." or ".."
+inline bool is_not_dot_name(const WCHAR* name, ULONG name_size) BOOST_NOEXCEPT
+{
+    return !(name[0] == L'.' && (name_size == sizeof(WCHAR) || (name[1] == L'.' && name_size == 2u * sizeof(WCHAR))));
+}
+
+#endif // !defined(UNDER_CE)
+
+#endif // defined(BOOST_POSIX_API)
 
+} // namespace
+
+//! Returns \c true if the directory \a p is empty. Unlike a directory iterator, reads the directory with a small buffer and does not construct paths or directory entries.
+bool is_empty_directory(path const& p, system::error_code* ec)
+{
     if (ec)
         ec->clear();
 
-    try
+#if defined(BOOST_POSIX_API)
+
+    bool empty = true;
+    int err = 0;
+
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW)
+    instrumentation_timer timer;
+    const int fd = ::open(p.c_str(), O_DIRECTORY | O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    timer.record(instrumented_operation::open_directory);
+    if (BOOST_UNLIKELY(fd < 0))
     {
-        boost::intrusive_ptr< detail::dir_itr_imp > imp;
-        path filename;
-        file_status file_stat, symlink_file_stat;
-        system::error_code result = dir_itr_create(imp, p, opts, params, filename, file_stat, symlink_file_stat);
+        err = errno;
+        goto fail;
+    }
 
-        while (true)
+#if defined(BOOST_FILESYSTEM_USE_GETDENTS)
+    {
+        readdir_impl_t* rdimpl = filesystem::detail::atomic_load_relaxed(readdir_impl_ptr);
+        if (BOOST_UNLIKELY(rdimpl == &readdir_select_impl))
+            rdimpl = init_readdir_impl();
+
+        if (rdimpl == &getdents_impl)
         {
-            if (result)
+            // Most directories have the dot entries returned first, so a small buffer is usually enough to find a non-dot entry
+            union
             {
-                if (result != make_error_condition(system::errc::permission_denied) ||
-                    (opts & static_cast< unsigned int >(directory_options::skip_permission_denied)) == 0u)
+                unsigned char buffer[1024];
+                boost::uint64_t alignment;
+            }
+            storage;
+
+            while (true)
+            {
+                instrumentation_timer getdents_timer;
+                const long res = ::syscall(__NR_getdents64, fd, storage.buffer, sizeof(storage.buffer));
+                getdents_timer.record(instrumented_operation::getdents);
+                if (BOOST_UNLIKELY(res < 0))
                 {
-                    if (!ec)
-                        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::directory_iterator::construct", p, result));
-                    *ec = result;
+                    err = errno;
+                    if (err == EINTR)
+                        continue;
+
+                    // Let the readdir-based implementation below deal with ENOSYS
+                    if (err == ENOSYS)
+                    {
+                        err = 0;
+                        goto use_readdir;
+                    }
+
+                    close_fd(fd);
+                    goto fail;
                 }
 
-                return;
+                if (res == 0)
+                    break;
+
+                for (long pos = 0; pos < res;)
+                {
+                    const linux_dirent64* ent = reinterpret_cast< const linux_dirent64* >(storage.buffer + pos);
+                    if (is_not_dot_name(ent->d_name))
+                    {
+                        empty = false;
+                        goto done_getdents;
+                    }
+
+                    pos += ent->d_reclen;
+                }
             }
 
-            if (imp->handle == NULL) // eof, make end
-                return;
+        done_getdents:
+            close_fd(fd);
+            return empty;
+        }
+    }
 
-            // Not eof
-            const path::string_type::value_type* filename_str = filename.c_str();
-            if (!(filename_str[0] == path::dot // dot or dot-dot
-                && (filename_str[1] == static_cast< path::string_type::value_type >('\0') ||
-                    (filename_str[1] == path::dot && filename_str[2] == static_cast< path::string_type::value_type >('\0')))))
-            {
-                imp->dir_entry.assign(p / filename, file_stat, symlink_file_stat);
-                it.m_imp.swap(imp);
-                return;
-            }
+use_readdir:
+#endif // defined(BOOST_FILESYSTEM_USE_GETDENTS)
 
-            // If dot or dot-dot name produced by the underlying API, skip it until the first actual file
-            result = dir_itr_increment(*imp, filename, file_stat, symlink_file_stat);
+    {
+        DIR* dir = ::fdopendir(fd);
+        if (BOOST_UNLIKELY(!dir))
+        {
+            err = errno;
+            close_fd(fd);
+            goto fail;
         }
+
+        err = is_empty_directory_readdir(dir, empty);
+        ::closedir(dir);
     }
-    catch (std::bad_alloc&)
+
+#else // defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW)
+
     {
-        if (!ec)
-            throw;
+        instrumentation_timer timer;
+        DIR* dir = ::opendir(p.c_str());
+        timer.record(instrumented_operation::open_directory);
+        if (BOOST_UNLIKELY(!dir))
+        {
+            err = errno;
+            goto fail;
+        }
 
-        *ec = make_error_code(system::errc::not_enough_memory);
-        it.m_imp.reset();
+        err = is_empty_directory_readdir(dir, empty);
+        ::closedir(dir);
     }
-}
 
-BOOST_FILESYSTEM_DECL
-void directory_iterator_increment(directory_iterator& it, system::error_code* ec)
-{
-    BOOST_ASSERT_MSG(!it.is_end(), "attempt to increment end iterator");
+#endif // defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW)
 
-    if (ec)
-        ec->clear();
+    if (BOOST_LIKELY(err == 0))
+        return empty;
 
-    try
+fail:
+    emit_error(err, p, ec, "boost::filesystem::is_empty");
+    return false;
+
+#else // defined(BOOST_POSIX_API)
+
+#if !defined(UNDER_CE)
+    NtQueryDirectoryFile_t* nt_query_directory_file = filesystem::detail::atomic_load_relaxed(boost::filesystem::detail::nt_query_directory_file_api);
+    if (BOOST_LIKELY(nt_query_directory_file != NULL))
     {
-        path filename;
-        file_status file_stat, symlink_file_stat;
-        system::error_code increment_ec;
+        handle_wrapper h(create_file_handle(p, FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS));
+        if (BOOST_UNLIKELY(h.handle == INVALID_HANDLE_VALUE))
+        {
+            emit_error(::GetLastError(), p, ec, "boost::filesystem::is_empty");
+            return false;
+        }
 
-        while (true)
+        // Most directories have the dot entries returned first, so a small buffer is usually enough to find a non-dot entry
+        union
         {
-            increment_ec = dir_itr_increment(*it.m_imp, filename, file_stat, symlink_file_stat);
+            unsigned char buffer[1024];
+            ULONGLONG alignment;
+        }
+        storage;
 
-            if (BOOST_UNLIKELY(!!increment_ec)) // happens if filesystem is corrupt, such as on a damaged optical disc
+        for (BOOLEAN restart_scan = TRUE;; restart_scan = FALSE)
+        {
+            io_status_block iosb;
+            boost::winapi::NTSTATUS_ status = nt_query_directory_file
+            (
+                h.handle,
+                NULL, // Event
+                NULL, // ApcRoutine
+                NULL, // ApcContext
+                &iosb,
+                storage.buffer,
+                static_cast< ULONG >(sizeof(storage.buffer)),
+                file_names_information_class,
+                FALSE, // ReturnSingleEntry
+                NULL, // FileName
+                restart_scan
+            );
+
+            if (!NT_SUCCESS(status))
             {
-                boost::intrusive_ptr< detail::dir_itr_imp > imp;
-                imp.swap(it.m_imp);
-                path error_path(imp->dir_entry.path().parent_path()); // fix ticket #5900
-                if (!ec)
-                    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::directory_iterator::operator++", error_path, increment_ec));
+                // An empty root directory has no "." or ".." entries, which results in STATUS_NO_SUCH_FILE
+                if (status == STATUS_NO_MORE_FILES || status == STATUS_NO_SUCH_FILE)
+                    return true;
 
-                *ec = increment_ec;
-                return;
-            }
+                // The filesystem may not support the information class, fall back to the directory iterator
+                if (status == STATUS_INVALID_INFO_CLASS || status == STATUS_INVALID_PARAMETER || status == STATUS_NOT_IMPLEMENTED)
+                    break;
 
-            if (it.m_imp->handle == NULL) // eof, make end
-            {
-                it.m_imp.reset();
-                return;
+                emit_error(translate_ntstatus(status), p, ec, "boost::filesystem::is_empty");
+                return false;
             }
 
-            const path::string_type::value_type* filename_str = filename.c_str();
-            if (!(filename_str[0] == path::dot // !(dot or dot-dot)
-                  && (filename_str[1] == static_cast< path::string_type::value_type >('\0') ||
-                      (filename_str[1] == path::dot && filename_str[2] == static_cast< path::string_type::value_type >('\0')))))
+            const unsigned char* pos = storage.buffer;
+            while (true)
             {
-                it.m_imp->dir_entry.replace_filename(filename, file_stat, symlink_file_stat);
-                return;
+                const file_names_information* data = reinterpret_cast< const file_names_information* >(pos);
+                if (is_not_dot_name(data->FileName, data->FileNameLength))
+                    return false;
+
+                if (data->NextEntryOffset == 0u)
+                    break;
+
+                pos += data->NextEntryOffset;
             }
         }
     }
-    catch (std::bad_alloc&)
-    {
-        if (!ec)
-            throw;
+#endif // !defined(UNDER_CE)
 
-        it.m_imp.reset();
-        *ec = make_error_code(system::errc::not_enough_memory);
-    }
+    fs::directory_iterator itr;
+    detail::directory_iterator_construct(itr, p, static_cast< unsigned int >(directory_options::none), NULL, ec);
+    return itr == fs::directory_iterator();
+
+#endif // defined(BOOST_POSIX_API)
 }
 
+} // namespace detail
+
+BOOST_FILESYSTEM_DECL
+std::size_t directory_iterator_buffer_size() BOOST_NOEXCEPT
+{
+    return filesystem::detail::atomic_load_relaxed(detail::g_dir_itr_buffer_size);
+}
+
+BOOST_FILESYSTEM_DECL
+void set_directory_iterator_buffer_size(std::size_t size) BOOST_NOEXCEPT
+{
+    if (size == 0u)
+    {
+        size = detail::default_dir_itr_buffer_size;
+    }
+    else
+    {
+#if defined(BOOST_WINDOWS_API)
+        const std::size_t max_size = filesystem::detail::atomic_load_relaxed(detail::g_max_dir_itr_buffer_size);
+#else
+        const std::size_t max_size = detail::max_dir_itr_buffer_size;
+#endif
+        if (size < detail::min_dir_itr_buffer_size)
+            size = detail::min_dir_itr_buffer_size;
+        else if (size > max_size)
+            size = max_size;
+        // Keep the buffer size a multiple of the extra data alignment
+        size = (size + detail::dir_itr_imp_extra_data_alignment - 1u) & ~(detail::dir_itr_imp_extra_data_alignment - 1u);
+    }
+
+    filesystem::detail::atomic_store_relaxed(detail::g_dir_itr_buffer_size, size);
+}
+
+BOOST_FILESYSTEM_DECL
+std::size_t recursive_directory_iterator_open_directories_limit() BOOST_NOEXCEPT
+{
+    return filesystem::detail::atomic_load_relaxed(detail::g_rdi_open_directories_limit);
+}
+
+BOOST_FILESYSTEM_DECL
+void set_recursive_directory_iterator_open_directories_limit(std::size_t limit) BOOST_NOEXCEPT
+{
+    if (limit == 0u)
+        limit = detail::default_rdi_open_directories_limit;
+
+    filesystem::detail::atomic_store_relaxed(detail::g_rdi_open_directories_limit, limit);
+}
+
+BOOST_FILESYSTEM_DECL
+std::size_t recursive_directory_iterator_pending_directories_limit() BOOST_NOEXCEPT
+{
+    return filesystem::detail::atomic_load_relaxed(detail::g_rdi_pending_directories_limit);
+}
+
+BOOST_FILESYSTEM_DECL
+void set_recursive_directory_iterator_pending_directories_limit(std::size_t limit) BOOST_NOEXCEPT
+{
+    if (limit == 0u)
+        limit = detail::default_rdi_pending_directories_limit;
+
+    filesystem::detail::atomic_store_relaxed(detail::g_rdi_pending_directories_limit, limit);
+}
+
+BOOST_FILESYSTEM_DECL
+std::size_t descriptor_budget() BOOST_NOEXCEPT
+{
+    return filesystem::detail::atomic_load_relaxed(detail::g_descriptor_budget_limit);
+}
+
+BOOST_FILESYSTEM_DECL
+void set_descriptor_budget(std::size_t limit) BOOST_NOEXCEPT
+{
+    filesystem::detail::atomic_store_relaxed(detail::g_descriptor_budget_limit, limit);
+}
+
+BOOST_FILESYSTEM_DECL
+std::size_t descriptor_budget_used() BOOST_NOEXCEPT
+{
+    return filesystem::detail::atomic_load_relaxed(detail::g_descriptor_budget_used);
+}
+
+BOOST_FILESYSTEM_DECL
+directory_read_backend::type get_directory_read_backend() BOOST_NOEXCEPT
+{
+#if defined(BOOST_FILESYSTEM_USE_READDIR_IMPL_PTR)
+    detail::readdir_impl_t* impl = filesystem::detail::atomic_load_relaxed(detail::readdir_impl_ptr);
+    if (impl == &detail::readdir_select_impl)
+        impl = detail::init_readdir_impl();
+    return static_cast< directory_read_backend::type >(detail::get_readdir_backend(impl));
+#elif defined(BOOST_POSIX_API)
+    return directory_read_backend::readdir;
+#else
+    return directory_read_backend::system_default;
+#endif
+}
+
+BOOST_FILESYSTEM_DECL
+bool set_directory_read_backend(directory_read_backend::type backend) BOOST_NOEXCEPT
+{
+#if defined(BOOST_FILESYSTEM_USE_READDIR_IMPL_PTR)
+    detail::readdir_impl_t* impl = NULL;
+    switch (backend)
+    {
+    case directory_read_backend::system_default:
+        impl = &detail::readdir_select_impl;
+        break;
+    case directory_read_backend::readdir:
+        impl = &detail::readdir_impl;
+        break;
+#if defined(BOOST_FILESYSTEM_USE_READDIR_R)
+    case directory_read_backend::readdir_r:
+        impl = &detail::readdir_r_impl;
+        break;
+#endif
+#if defined(BOOST_FILESYSTEM_USE_GETDENTS)
+    case directory_read_backend::getdents:
+        if (!detail::is_dirent_compatible_with_getdents())
+            return false;
+        impl = &detail::getdents_impl;
+        break;
+#endif
+    default:
+        return false;
+    }
+
+    filesystem::detail::atomic_store_relaxed(detail::readdir_impl_ptr, impl);
+    return true;
+#elif defined(BOOST_POSIX_API)
+    return backend == directory_read_backend::system_default || backend == directory_read_backend::readdir;
+#else
+    return backend == directory_read_backend::system_default;
+#endif
+}
+
+namespace detail {
+
+BOOST_FILESYSTEM_DECL
+dir_itr_imp::~dir_itr_imp() BOOST_NOEXCEPT
+{
+    dir_itr_close(*this);
+}
+
+namespace {
+
+//! Applies the entry name filter to the current entry of the directory iterator. Returns \c true if the entry is accepted.
+inline bool dir_itr_accept_entry(dir_itr_imp& imp, path const& filename, file_status const& symlink_sf)
+{
+#if defined(BOOST_WINDOWS_API)
+    if (imp.filter)
+    {
+        imp.filter_flags = imp.filter->filter(filename.c_str(), filename.native().size(), symlink_sf.type());
+        if (BOOST_UNLIKELY((imp.filter_flags & dir_itr_filter::stop_iteration) != 0u))
+        {
+            dir_itr_close(imp);
+            return false;
+        }
+        return imp.filter_flags != 0u;
+    }
+#endif
+    // On POSIX systems, the filter is applied by dir_itr_increment to the raw entry names
+    return true;
+}
+
+} // namespace
+
+//! Constructs a directory iterator that only produces the entries accepted by \a filter, if not \c NULL
+BOOST_FILESYSTEM_DECL
+void directory_iterator_construct_filtered(directory_iterator& it, path const& p, unsigned int opts, directory_iterator_params* params, dir_itr_filter* filter, system::error_code* ec)
+{
+    BOOST_FILESYSTEM_TRACE2(directory_iterator_construct__entry, p.c_str(), opts);
+    BOOST_FILESYSTEM_TRACE_SCOPE(directory_iterator_construct);
+
+    if (BOOST_UNLIKELY(p.empty()))
+    {
+        emit_error(not_found_error_code, p, ec, "boost::filesystem::directory_iterator::construct");
+        return;
+    }
+
+    if (ec)
+        ec->clear();
+
+    try
+    {
+        boost::intrusive_ptr< detail::dir_itr_imp > imp;
+        path filename;
+        file_status file_stat, symlink_file_stat;
+        system::error_code result = dir_itr_create(imp, p, opts, params, filename, file_stat, symlink_file_stat);
+        if (!result)
+            imp->filter = filter;
+
+        while (true)
+        {
+            if (result)
+            {
+                if (result != make_error_condition(system::errc::permission_denied) ||
+                    (opts & static_cast< unsigned int >(directory_options::skip_permission_denied)) == 0u)
+                {
+                    if (!ec)
+                        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::directory_iterator::construct", p, result));
+                    *ec = result;
+                }
+
+                return;
+            }
+
+            if (imp->handle == NULL) // eof, make end
+                return;
+
+            // Not eof
+            const path::string_type::value_type* filename_str = filename.c_str();
+            if (!(filename_str[0] == path::dot // dot or dot-dot
+                && (filename_str[1] == static_cast< path::string_type::value_type >('\0') ||
+                    (filename_str[1] == path::dot && filename_str[2] == static_cast< path::string_type::value_type >('\0')))) &&
+                dir_itr_accept_entry(*imp, filename, symlink_file_stat))
+            {
+                imp->dir_entry.assign(p / filename, file_stat, symlink_file_stat);
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                // Allow the entry to query its attributes relative to the directory being iterated
+                imp->dir_entry.m_basedir_fd = ::dirfd(static_cast< DIR* >(imp->handle));
+                if (const dir_itr_prefetched_attrs* prefetched = dir_itr_current_prefetched(*imp))
+                {
+                    imp->dir_entry.set_prefetched_attrs(prefetched->symlink_status, prefetched->attrs, prefetched->file_size, prefetched->last_write_time,
+                        prefetched->hard_link_count, prefetched->inode, prefetched->device);
+                }
+                else if (imp->current_inode != 0u)
+                {
+                    imp->dir_entry.set_cached_attrs(inode_cached, 0u, 0, imp->current_inode);
+                }
+#elif defined(BOOST_POSIX_API)
+                if (imp->current_inode != 0u)
+                    imp->dir_entry.set_cached_attrs(inode_cached, 0u, 0, imp->current_inode);
+#elif defined(BOOST_WINDOWS_API) && !defined(UNDER_CE)
+                {
+                    boost::uintmax_t file_size = 0u, inode = 0u;
+                    std::time_t last_write_time = 0;
+                    const unsigned int attrs = get_current_entry_attrs(*imp, file_size, last_write_time, inode);
+                    imp->dir_entry.set_cached_attrs(attrs, file_size, last_write_time, inode);
+                }
+#endif
+                it.m_imp.swap(imp);
+                return;
+            }
+
+#if defined(BOOST_WINDOWS_API)
+            if (BOOST_UNLIKELY(imp->handle == NULL)) // the filter stopped the iteration, make end
+                return;
+#endif
+
+            // If dot or dot-dot name produced by the underlying API, skip it until the first actual file
+            result = dir_itr_increment(*imp, filename, file_stat, symlink_file_stat);
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        it.m_imp.reset();
+    }
+}
+
+BOOST_FILESYSTEM_DECL
+void directory_iterator_construct(directory_iterator& it, path const& p, unsigned int opts, directory_iterator_params* params, system::error_code* ec)
+{
+    directory_iterator_construct_filtered(it, p, opts, params, NULL, ec);
+}
+
+BOOST_FILESYSTEM_DECL
+boost::uintmax_t directory_entry_count_hint(path const& p, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_POSIX_API)
+
+    struct ::stat st;
+    if (BOOST_UNLIKELY(::stat(p.c_str(), &st) != 0))
+    {
+        const int err = errno;
+        emit_error(err, p, ec, "boost::filesystem::directory_entry_count_hint");
+        return 0u;
+    }
+
+    if (BOOST_UNLIKELY(!S_ISDIR(st.st_mode)))
+    {
+        emit_error(ENOTDIR, p, ec, "boost::filesystem::directory_entry_count_hint");
+        return 0u;
+    }
+
+    unsigned long fs_type = 0u;
+#if defined(BOOST_FILESYSTEM_HAS_STATFS_F_TYPE)
+    struct statfs sfs;
+    if (::statfs(p.c_str(), &sfs) == 0)
+        fs_type = static_cast< unsigned long >(sfs.f_type);
+#endif
+
+    return estimate_directory_entry_count(st, fs_type);
+
+#else // defined(BOOST_POSIX_API)
+
+    handle_wrapper h(create_file_handle(p, FILE_READ_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS));
+    if (BOOST_UNLIKELY(h.handle == INVALID_HANDLE_VALUE))
+    {
+        const DWORD err = ::GetLastError();
+        emit_error(err, p, ec, "boost::filesystem::directory_entry_count_hint");
+        return 0u;
+    }
+
+    GetFileInformationByHandleEx_t* get_file_information_by_handle_ex = filesystem::detail::atomic_load_relaxed(get_file_information_by_handle_ex_api);
+    if (BOOST_UNLIKELY(get_file_information_by_handle_ex == NULL))
+        return 0u; // no estimate is available
+
+    file_standard_info info;
+    if (BOOST_UNLIKELY(!get_file_information_by_handle_ex(h.handle, file_standard_info_class, &info, sizeof(info))))
+    {
+        const DWORD err = ::GetLastError();
+        emit_error(err, p, ec, "boost::filesystem::directory_entry_count_hint");
+        return 0u;
+    }
+
+    if (BOOST_UNLIKELY(!info.Directory))
+    {
+        emit_error(ERROR_DIRECTORY, p, ec, "boost::filesystem::directory_entry_count_hint");
+        return 0u;
+    }
+
+    // NTFS reports the size of the directory index, which is empty for small directories with the index stored in the MFT record.
+    // Assume a typical size of an index record with a short name.
+    return info.EndOfFile.QuadPart > 0 ? static_cast< boost::uintmax_t >(info.EndOfFile.QuadPart) / 96u : 0u;
+
+#endif // defined(BOOST_POSIX_API)
+}
+
+BOOST_FILESYSTEM_DECL
+void for_each_name(path const& p, unsigned int opts, dir_itr_filter* filter, system::error_code* ec)
+{
+    // The filter passes every name to the callback and skips the entry, so the iterator reads the whole directory on construction
+    // and becomes the end iterator, or stops early if the callback requests so
+    directory_iterator it;
+    directory_iterator_construct_filtered(it, p, opts, NULL, filter, ec);
+    BOOST_ASSERT(it == directory_iterator());
+}
+
+namespace {
+
+//! Orders directory listing records by name
+struct directory_listing_name_less
+{
+    const path::value_type* names;
+
+    explicit directory_listing_name_less(const path::value_type* n) BOOST_NOEXCEPT : names(n) {}
+
+    bool operator()(directory_listing_record const& left, directory_listing_record const& right) const BOOST_NOEXCEPT
+    {
+        const boost::uint32_t size = left.name_size < right.name_size ? left.name_size : right.name_size;
+        const int res = path::string_type::traits_type::compare(names + left.name_offset, names + right.name_offset, size);
+        return res < 0 || (res == 0 && left.name_size < right.name_size);
+    }
+};
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL
+void list_directory(directory_listing& listing, path const& p, unsigned int opts, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    listing.clear();
+
+    const bool query_attributes = (opts & static_cast< unsigned int >(listing_options::query_attributes)) != 0u;
+    unsigned int dir_opts = 0u;
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    // Query the attributes of the entries ahead of reading them from the listing
+    if (query_attributes)
+        dir_opts |= static_cast< unsigned int >(directory_options::prefetch_status);
+#endif
+
+    system::error_code result;
+    try
+    {
+        boost::intrusive_ptr< detail::dir_itr_imp > imp;
+        path filename;
+        file_status file_stat, symlink_file_stat;
+        result = dir_itr_create(imp, p, dir_opts, NULL, filename, file_stat, symlink_file_stat);
+        if (BOOST_UNLIKELY(!!result))
+        {
+            if (result == make_error_condition(system::errc::permission_denied) &&
+                (opts & static_cast< unsigned int >(listing_options::skip_permission_denied)) != 0u)
+            {
+                return;
+            }
+
+            goto fail;
+        }
+
+#if defined(BOOST_POSIX_API)
+        if (imp->handle != NULL)
+        {
+            const std::size_t estimate = dir_itr_estimate_entry_count(*imp);
+            listing.m_records.reserve(estimate);
+            listing.m_names.reserve(estimate * 16u);
+        }
+#endif
+
+        while (imp->handle != NULL)
+        {
+            const path::string_type::value_type* filename_str = filename.c_str();
+            if (!(filename_str[0] == path::dot // dot or dot-dot
+                && (filename_str[1] == static_cast< path::string_type::value_type >('\0') ||
+                    (filename_str[1] == path::dot && filename_str[2] == static_cast< path::string_type::value_type >('\0')))))
+            {
+                const std::size_t name_size = filename.native().size();
+                const std::size_t name_offset = listing.m_names.size();
+                if (BOOST_UNLIKELY(name_offset + name_size + 1u > static_cast< std::size_t >(~static_cast< boost::uint32_t >(0u))))
+                {
+                    result = make_error_code(system::errc::value_too_large);
+                    goto fail;
+                }
+
+                // Store the name with the terminating zero
+                listing.m_names.insert(listing.m_names.end(), filename_str, filename_str + name_size + 1u);
+
+                directory_listing_record rec = {};
+                rec.name_offset = static_cast< boost::uint32_t >(name_offset);
+                rec.name_size = static_cast< boost::uint32_t >(name_size);
+                rec.type = static_cast< boost::uint32_t >(symlink_file_stat.type());
+
+                if (query_attributes)
+                {
+#if defined(BOOST_POSIX_API)
+                    const dir_itr_prefetched_attrs* attrs = NULL;
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                    attrs = dir_itr_current_prefetched(*imp);
+#endif
+                    dir_itr_prefetched_attrs queried_attrs;
+                    if (attrs == NULL)
+                    {
+                        // The attributes could not be queried in advance, retry now
+                        struct ::stat st;
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                        const int res = ::fstatat(::dirfd(static_cast< DIR* >(imp->handle)), filename_str, &st, AT_SYMLINK_NOFOLLOW);
+#else
+                        const int res = ::lstat((p / filename).c_str(), &st);
+#endif
+                        if (res == 0)
+                        {
+                            set_prefetched_attrs(queried_attrs, st);
+                            attrs = &queried_attrs;
+                        }
+                    }
+
+                    if (attrs != NULL)
+                    {
+                        rec.type = static_cast< boost::uint32_t >(attrs->symlink_status.type());
+                        if ((attrs->attrs & last_write_time_cached) != 0u)
+                        {
+                            if (attrs->symlink_status.type() == regular_file)
+                                rec.size = attrs->file_size;
+                            rec.last_write_time = attrs->last_write_time;
+                            rec.flags = directory_listing_record::attributes_known;
+                        }
+                    }
+#elif !defined(UNDER_CE)
+                    boost::uintmax_t file_size = 0u, inode = 0u;
+                    std::time_t last_write_time = 0;
+                    const unsigned int attrs = get_current_entry_attrs(*imp, file_size, last_write_time, inode);
+                    if ((attrs & last_write_time_cached) != 0u && symlink_file_stat.type() != symlink_file)
+                    {
+                        if (symlink_file_stat.type() == regular_file)
+                            rec.size = file_size;
+                        rec.last_write_time = last_write_time;
+                        rec.flags = directory_listing_record::attributes_known;
+                    }
+#endif
+                }
+
+                listing.m_records.push_back(rec);
+            }
+
+            result = dir_itr_increment(*imp, filename, file_stat, symlink_file_stat);
+            if (BOOST_UNLIKELY(!!result))
+                goto fail;
+        }
+
+        if ((opts & static_cast< unsigned int >(listing_options::sort_by_name)) != 0u && !listing.m_records.empty())
+            std::sort(listing.m_records.begin(), listing.m_records.end(), directory_listing_name_less(&listing.m_names[0]));
+    }
+    catch (std::bad_alloc&)
+    {
+        listing.clear();
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+    }
+
+    return;
+
+fail:
+    listing.clear();
+    if (!ec)
+        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::list_directory", p, result));
+    *ec = result;
+}
+
+BOOST_FILESYSTEM_DECL
+void directory_iterator_increment(directory_iterator& it, system::error_code* ec)
+{
+    BOOST_FILESYSTEM_TRACE(directory_iterator_increment__entry);
+    BOOST_FILESYSTEM_TRACE_SCOPE(directory_iterator_increment);
+
+    BOOST_ASSERT_MSG(!it.is_end(), "attempt to increment end iterator");
+
+    if (ec)
+        ec->clear();
+
+    try
+    {
+        path filename;
+        file_status file_stat, symlink_file_stat;
+        system::error_code increment_ec;
+
+        while (true)
+        {
+            increment_ec = dir_itr_increment(*it.m_imp, filename, file_stat, symlink_file_stat);
+
+            if (BOOST_UNLIKELY(!!increment_ec)) // happens if filesystem is corrupt, such as on a damaged optical disc
+            {
+                boost::intrusive_ptr< detail::dir_itr_imp > imp;
+                imp.swap(it.m_imp);
+                if (!ec)
+                {
+                    path error_path(imp->dir_entry.path().parent_path()); // fix ticket #5900
+                    imp.reset();
+                    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::directory_iterator::operator++", error_path, increment_ec));
+                }
+
+                *ec = increment_ec;
+                return;
+            }
+
+            if (it.m_imp->handle == NULL) // eof, make end
+            {
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                // The directory is closed, other iterators sharing the entry must not use its descriptor
+                it.m_imp->dir_entry.m_basedir_fd = -1;
+#endif
+                it.m_imp.reset();
+                return;
+            }
+
+            const path::string_type::value_type* filename_str = filename.c_str();
+            if (!(filename_str[0] == path::dot // !(dot or dot-dot)
+                  && (filename_str[1] == static_cast< path::string_type::value_type >('\0') ||
+                      (filename_str[1] == path::dot && filename_str[2] == static_cast< path::string_type::value_type >('\0')))) &&
+                dir_itr_accept_entry(*it.m_imp, filename, symlink_file_stat))
+            {
+                it.m_imp->dir_entry.replace_filename(filename, file_stat, symlink_file_stat);
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                it.m_imp->dir_entry.m_basedir_fd = ::dirfd(static_cast< DIR* >(it.m_imp->handle));
+                if (const dir_itr_prefetched_attrs* prefetched = dir_itr_current_prefetched(*it.m_imp))
+                {
+                    it.m_imp->dir_entry.set_prefetched_attrs(prefetched->symlink_status, prefetched->attrs, prefetched->file_size, prefetched->last_write_time,
+                        prefetched->hard_link_count, prefetched->inode, prefetched->device);
+                }
+                else if (it.m_imp->current_inode != 0u)
+                {
+                    it.m_imp->dir_entry.set_cached_attrs(inode_cached, 0u, 0, it.m_imp->current_inode);
+                }
+#elif defined(BOOST_POSIX_API)
+                if (it.m_imp->current_inode != 0u)
+                    it.m_imp->dir_entry.set_cached_attrs(inode_cached, 0u, 0, it.m_imp->current_inode);
+#elif defined(BOOST_WINDOWS_API) && !defined(UNDER_CE)
+                {
+                    boost::uintmax_t file_size = 0u, inode = 0u;
+                    std::time_t last_write_time = 0;
+                    const unsigned int attrs = get_current_entry_attrs(*it.m_imp, file_size, last_write_time, inode);
+                    it.m_imp->dir_entry.set_cached_attrs(attrs, file_size, last_write_time, inode);
+                }
+#endif
+                return;
+            }
+
+#if defined(BOOST_WINDOWS_API)
+            if (BOOST_UNLIKELY(it.m_imp->handle == NULL)) // the filter stopped the iteration, make end
+            {
+                it.m_imp.reset();
+                return;
+            }
+#endif
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        it.m_imp.reset();
+        *ec = make_error_code(system::errc::not_enough_memory);
+    }
+}
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                           recursive_directory_iterator                               //
+//                                                                                      //
 //--------------------------------------------------------------------------------------//
-//                                                                                      //
-//                           recursive_directory_iterator                               //
-//                                                                                      //
-//--------------------------------------------------------------------------------------//
+
+//! Provides access to directory iterator internals
+struct dir_itr_imp_access
+{
+    //! Returns the amount of directory listing data read by the iterator, or zero for the end iterator
+    static boost::uintmax_t get_read_size(directory_iterator const& it) BOOST_NOEXCEPT
+    {
+        return it.m_imp ? it.m_imp->read_size : static_cast< boost::uintmax_t >(0u);
+    }
+};
+
+namespace {
+
+//! Returns the current time of a monotonic clock, in nanoseconds
+inline boost::uint64_t get_current_time_ns() BOOST_NOEXCEPT
+{
+#if !defined(BOOST_NO_CXX11_HDR_CHRONO)
+    return static_cast< boost::uint64_t >(std::chrono::duration_cast< std::chrono::nanoseconds >(std::chrono::steady_clock::now().time_since_epoch()).count());
+#else
+    return static_cast< boost::uint64_t >(std::time(NULL)) * 1000000000u;
+#endif
+}
+
+//! Updates the amount of directory listing data read for the directory observed at \a index of the stack
+inline void update_observed_read_size(detail::recur_dir_itr_imp* imp, std::size_t index) BOOST_NOEXCEPT
+{
+    detail::recur_dir_itr_observed& observed = imp->m_observed[index];
+    const boost::uintmax_t read_size = dir_itr_imp_access::get_read_size(imp->m_stack[index]);
+    // The iterator that reached the end is released, but the last read at the end of the directory does not return any data
+    if (read_size > observed.iterator_bytes_read)
+    {
+        observed.bytes_read += read_size - observed.iterator_bytes_read;
+        observed.iterator_bytes_read = read_size;
+    }
+}
+
+//! Reports the event for the observed directory to the observer
+void report_observed_directory(detail::recur_dir_itr_imp* imp, recursive_directory_iterator_event::type event, detail::recur_dir_itr_observed const& observed, std::size_t depth, boost::uint64_t now) BOOST_NOEXCEPT
+{
+    directory_iteration_stats stats;
+    stats.depth = depth;
+    stats.entry_count = observed.entry_count;
+    stats.bytes_read = observed.bytes_read;
+    stats.elapsed_ns = now > observed.start_time ? now - observed.start_time : static_cast< boost::uint64_t >(0u);
+    imp->m_observer(event, observed.dir_path, stats, imp->m_observer_context);
+}
+
+//! Records the directory that was pushed to the top of the stack and reports it to the observer. \a start_time is the time when opening the directory started.
+void observe_pushed_directory(detail::recur_dir_itr_imp* imp, boost::uint64_t start_time) BOOST_NOEXCEPT
+{
+    try
+    {
+        detail::recur_dir_itr_observed observed;
+        observed.dir_path = imp->m_stack.back()->path().parent_path();
+        imp->m_observed.push_back(observed);
+    }
+    catch (std::bad_alloc&)
+    {
+        // Stop observing rather than reporting inconsistent statistics
+        imp->m_observer = NULL;
+        imp->m_observer_context = NULL;
+        imp->m_observed.clear();
+        return;
+    }
+
+    detail::recur_dir_itr_observed& observed = imp->m_observed.back();
+    observed.start_time = start_time;
+    observed.entry_count = 1u;
+    update_observed_read_size(imp, imp->m_stack.size() - 1u);
+    report_observed_directory(imp, recursive_directory_iterator_event::push, observed, imp->m_base_depth + imp->m_stack.size() - 1u, get_current_time_ns());
+}
+
+//! Reports the directory that was opened but had no entries, and so was not pushed to the stack, as pushed and popped
+void observe_empty_directory(detail::recur_dir_itr_imp* imp, path const& dir_path, std::size_t depth, boost::uint64_t start_time) BOOST_NOEXCEPT
+{
+    try
+    {
+        detail::recur_dir_itr_observed observed;
+        observed.dir_path = dir_path;
+        observed.start_time = start_time;
+        const boost::uint64_t now = get_current_time_ns();
+        report_observed_directory(imp, recursive_directory_iterator_event::push, observed, depth, now);
+        report_observed_directory(imp, recursive_directory_iterator_event::pop, observed, depth, now);
+    }
+    catch (std::bad_alloc&)
+    {
+    }
+}
+
+//! Returns \c true if the options require to track identities of the iterated directories
+inline bool tracks_directory_ids(unsigned int opts) BOOST_NOEXCEPT
+{
+    return (opts & static_cast< unsigned int >(directory_options::skip_directory_cycles | directory_options::skip_visited_directories)) != 0u;
+}
+
+//! Returns the position of \a id in the hash table of directory identities or of the empty slot where it would be inserted. The table must not be empty.
+std::size_t find_directory_id(std::vector< file_identity > const& table, file_identity const& id) BOOST_NOEXCEPT
+{
+    const std::size_t mask = table.size() - 1u;
+    std::size_t pos = hash_value(id) & mask;
+    while (table[pos] != id && table[pos] != file_identity())
+        pos = (pos + 1u) & mask;
+    return pos;
+}
+
+//! Returns \c true if the directory identity was recorded by the iterator
+inline bool has_directory_id(detail::recur_dir_itr_imp const* imp, file_identity const& id) BOOST_NOEXCEPT
+{
+    return imp->m_dir_id_count > 0u && imp->m_dir_ids[find_directory_id(imp->m_dir_ids, id)] == id;
+}
+
+//! Records the identity of the directory that was pushed to the stack. On exceptions, the recorded identities are not modified.
+void record_directory_id(detail::recur_dir_itr_imp* imp, file_identity const& id)
+{
+    // Keep the load factor of the hash table at most 1/2, so that the probe sequences are short
+    if ((imp->m_dir_id_count + 1u) * 2u > imp->m_dir_ids.size())
+    {
+        std::vector< file_identity > table(imp->m_dir_ids.empty() ? static_cast< std::size_t >(16u) : imp->m_dir_ids.size() * 2u); // may throw
+        for (std::vector< file_identity >::const_iterator it = imp->m_dir_ids.begin(), end = imp->m_dir_ids.end(); it != end; ++it)
+        {
+            if (*it != file_identity())
+                table[find_directory_id(table, *it)] = *it;
+        }
+        imp->m_dir_ids.swap(table);
+    }
+
+    // Breadth-first iterators don't keep the parent directories on the stack, so they have to remember all iterated directories to detect cycles
+    if ((imp->m_options & static_cast< unsigned int >(directory_options::skip_visited_directories | directory_options::breadth_first)) == 0u)
+        imp->m_stack_ids.push_back(id); // may throw
+
+    // A default-constructed identity means the identity is not known, don't store it to the table as it marks empty slots
+    if (id != file_identity())
+    {
+        file_identity& slot = imp->m_dir_ids[find_directory_id(imp->m_dir_ids, id)];
+        if (slot != id)
+        {
+            slot = id;
+            ++imp->m_dir_id_count;
+        }
+    }
+}
+
+//! Removes the directory identity from the hash table
+void erase_directory_id(detail::recur_dir_itr_imp* imp, file_identity const& id) BOOST_NOEXCEPT
+{
+    if (id == file_identity() || imp->m_dir_id_count == 0u)
+        return;
+
+    std::vector< file_identity >& table = imp->m_dir_ids;
+    const std::size_t mask = table.size() - 1u;
+    std::size_t pos = find_directory_id(table, id);
+    if (table[pos] != id)
+        return;
+
+    // Move the following elements of the probe sequence to the freed slot, if their home slots precede it, so that they remain reachable
+    for (std::size_t next = (pos + 1u) & mask; table[next] != file_identity(); next = (next + 1u) & mask)
+    {
+        const std::size_t home = hash_value(table[next]) & mask;
+        if (((next - home) & mask) >= ((next - pos) & mask))
+        {
+            table[pos] = table[next];
+            pos = next;
+        }
+    }
+
+    table[pos] = file_identity();
+    --imp->m_dir_id_count;
+}
+
+//! Returns the maximum number of open directories for a new recursive directory iterator, or zero if not limited
+inline std::size_t get_rdi_max_open(unsigned int opts) BOOST_NOEXCEPT
+{
+    if ((opts & static_cast< unsigned int >(directory_options::limit_open_directories)) != 0u)
+        return filesystem::detail::atomic_load_relaxed(detail::g_rdi_open_directories_limit);
+
+    // While the descriptor budget is limited, the positions of the directories are tracked so that the directories can be closed when the budget is exhausted
+    if (detail::is_descriptor_budget_limited())
+        return (std::numeric_limits< std::size_t >::max)();
+
+    return 0u;
+}
+
+//! Returns the number of descriptors the iterator needs to draw from the process-wide budget for its open directories
+inline std::size_t recursive_directory_iterator_budget_required(detail::recur_dir_itr_imp const* imp) BOOST_NOEXCEPT
+{
+    // The top directory does not draw from the budget, which guarantees progress of the iteration regardless of the budget
+    const std::size_t open_count = imp->m_stack.size() > imp->m_closed_count ? imp->m_stack.size() - imp->m_closed_count : 0u;
+    return open_count > 1u ? open_count - 1u : 0u;
+}
+
+//! Returns the descriptors drawn from the process-wide budget in excess of the open directories of the iterator
+inline void recursive_directory_iterator_release_budget(detail::recur_dir_itr_imp* imp) BOOST_NOEXCEPT
+{
+    const std::size_t required = recursive_directory_iterator_budget_required(imp);
+    if (imp->m_budget_held > required)
+    {
+        detail::release_descriptors(imp->m_budget_held - required);
+        imp->m_budget_held = required;
+    }
+}
+
+//! Pops the stack top iterator
+inline void recursive_directory_iterator_pop_stack(detail::recur_dir_itr_imp* imp) BOOST_NOEXCEPT
+{
+    if (BOOST_UNLIKELY(imp->m_observer != NULL))
+    {
+        const std::size_t index = imp->m_stack.size() - 1u;
+        update_observed_read_size(imp, index);
+        report_observed_directory(imp, recursive_directory_iterator_event::pop, imp->m_observed[index], imp->m_base_depth + index, get_current_time_ns());
+        imp->m_observed.pop_back();
+    }
+
+    imp->m_stack.pop_back();
+    if (imp->m_max_open > 0u)
+    {
+        imp->m_levels.pop_back();
+        if (imp->m_budget_held > 0u)
+            recursive_directory_iterator_release_budget(imp);
+    }
+    if (!imp->m_stack_ids.empty())
+    {
+        erase_directory_id(imp, imp->m_stack_ids.back());
+        imp->m_stack_ids.pop_back();
+    }
+}
+
+//! Opens a subdirectory of the iterated tree by its path. If \a check_symlink is \c true and directory symlinks are not followed, the directory is skipped if it is a symlink.
+void recursive_directory_iterator_open(detail::recur_dir_itr_imp* imp, directory_iterator& dir_it, path const& dir_path, dir_itr_filter* filter, bool check_symlink, system::error_code& ec)
+{
+    unsigned int opts = imp->m_options & ~static_cast< unsigned int >(directory_options::_detail_no_push);
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW)
+    // Make sure the directory wasn't replaced with a symlink since we queried its status
+    check_symlink = check_symlink && (imp->m_options & static_cast< unsigned int >(directory_options::follow_directory_symlink)) == 0u;
+    if (check_symlink)
+        opts |= static_cast< unsigned int >(directory_options::_detail_no_follow);
+#endif
+
+    detail::directory_iterator_construct_filtered(dir_it, dir_path, opts, NULL, filter, &ec);
+
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW)
+    if (BOOST_UNLIKELY(!!ec) && check_symlink && ec == system::error_code(ELOOP, system::system_category()))
+    {
+        // The directory was replaced with a symlink, which we must not follow
+        ec.clear();
+    }
+#endif
+}
+
+//! Closes the directories at the lowest depths of the stack, while the number of open directories exceeds \a max_open
+void recursive_directory_iterator_close_levels(detail::recur_dir_itr_imp* imp, std::size_t max_open) BOOST_NOEXCEPT
+{
+    try
+    {
+        while ((imp->m_stack.size() - imp->m_closed_count) > max_open)
+        {
+            const std::size_t index = imp->m_closed_count;
+            // The current entry of the directory is the parent of the directory above it in the stack
+            path dir_path(imp->m_stack[index]->path().parent_path()); // may throw
+            imp->m_levels[index].dir_path.swap(dir_path);
+            imp->m_stack[index] = directory_iterator();
+            ++imp->m_closed_count;
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        // Keep the directories open, the limit will be enforced on the next push
+    }
+}
+
+//! Enforces the limit of open directories after a directory was pushed to the stack. Must only be called if the limit is set.
+/*!
+ * If the process-wide descriptor budget is limited, the open directories other than the top one draw descriptors from the budget.
+ * If the budget is exhausted, the directories at the lowest depths are closed instead, as with \c directory_options::limit_open_directories,
+ * and are reopened when the iteration returns to them.
+ */
+void recursive_directory_iterator_limit_open(detail::recur_dir_itr_imp* imp) BOOST_NOEXCEPT
+{
+    std::size_t max_open = imp->m_max_open;
+    if (imp->m_budget_held > 0u || detail::is_descriptor_budget_limited())
+    {
+        const std::size_t required = recursive_directory_iterator_budget_required(imp);
+        while (imp->m_budget_held < required && detail::try_acquire_descriptors(1u))
+            ++imp->m_budget_held;
+
+        if (imp->m_budget_held < max_open - 1u)
+            max_open = imp->m_budget_held + 1u;
+    }
+
+    recursive_directory_iterator_close_levels(imp, max_open);
+}
+
+//! Increments the stack top iterator. If the directory was closed to limit the number of open directories, reopens it first.
+void recursive_directory_iterator_increment_top(detail::recur_dir_itr_imp* imp, system::error_code& ec)
+{
+    directory_iterator& dir_it = imp->m_stack.back();
+    if (imp->m_max_open > 0u)
+    {
+        detail::recur_dir_itr_level& level = imp->m_levels.back();
+        if (imp->m_closed_count == imp->m_stack.size())
+        {
+            --imp->m_closed_count;
+            path dir_path;
+            dir_path.swap(level.dir_path);
+
+            recursive_directory_iterator_open(imp, dir_it, dir_path, level.filter.get(), imp->m_base_depth + imp->m_stack.size() > 1u, ec);
+
+            // Skip the entries that were already iterated, up to the current one
+            for (std::size_t i = 1u; !ec && i < level.position && dir_it != directory_iterator(); ++i)
+                detail::directory_iterator_increment(dir_it, &ec);
+
+            // The reopened iterator reads the directory listing from the beginning
+            if (imp->m_observer)
+                imp->m_observed.back().iterator_bytes_read = 0u;
+
+            // If the directory was modified while it was closed and has fewer entries now, consider all its entries iterated
+            if (ec || dir_it == directory_iterator())
+                return;
+        }
+
+        ++level.position;
+    }
+
+    detail::directory_iterator_increment(dir_it, &ec);
+
+    if (BOOST_UNLIKELY(imp->m_observer != NULL) && !ec && dir_it != directory_iterator())
+    {
+        ++imp->m_observed.back().entry_count;
+        update_observed_read_size(imp, imp->m_stack.size() - 1u);
+    }
+}
+
+//! Opens the directories pending iteration until one of them is not empty and pushes it to the stack, which must be empty. Returns \c true if a directory was pushed.
+/*!
+ * If opening a directory fails, the error is reported in \a ec. If \c directory_options::pop_on_error is specified, the iterator
+ * continues with the next pending directory, otherwise it returns \c false.
+ */
+bool recursive_directory_iterator_push_pending(detail::recur_dir_itr_imp* imp, system::error_code& ec) BOOST_NOEXCEPT
+{
+    ec.clear();
+    try
+    {
+        while (!imp->m_pending.empty())
+        {
+            detail::recur_dir_itr_pending pending;
+            {
+                detail::recur_dir_itr_pending& front = imp->m_pending.front();
+                pending.dir_path.swap(front.dir_path);
+                pending.filter.swap(front.filter);
+                pending.depth = front.depth;
+                imp->m_pending.pop_front();
+            }
+
+            directory_iterator next;
+            system::error_code open_ec;
+            const boost::uint64_t start_time = imp->m_observer ? get_current_time_ns() : static_cast< boost::uint64_t >(0u);
+            recursive_directory_iterator_open(imp, next, pending.dir_path, pending.filter.get(), true, open_ec);
+            if (BOOST_UNLIKELY(!!open_ec))
+            {
+                if (!ec)
+                    ec = open_ec;
+                if ((imp->m_options & static_cast< unsigned int >(directory_options::pop_on_error)) == 0u)
+                    return false;
+                continue;
+            }
+
+            if (next == directory_iterator())
+            {
+                if (imp->m_observer)
+                    observe_empty_directory(imp, pending.dir_path, pending.depth, start_time);
+                continue;
+            }
+
+            if (imp->m_max_open > 0u)
+            {
+                detail::recur_dir_itr_level level;
+                level.filter.swap(pending.filter);
+                imp->m_levels.push_back(level); // may throw
+            }
+
+            try
+            {
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+                imp->m_stack.push_back(std::move(next)); // may throw
+#else
+                imp->m_stack.push_back(next); // may throw
+#endif
+            }
+            catch (...)
+            {
+                if (imp->m_max_open > 0u)
+                    imp->m_levels.pop_back();
+                throw;
+            }
+
+            imp->m_base_depth = pending.depth;
+            if (imp->m_observer)
+                observe_pushed_directory(imp, start_time);
+            return true;
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            ec = make_error_code(system::errc::not_enough_memory);
+    }
+
+    return false;
+}
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL
+recur_dir_itr_imp::~recur_dir_itr_imp() BOOST_NOEXCEPT
+{
+    if (m_budget_held > 0u)
+        detail::release_descriptors(m_budget_held);
+}
 
 BOOST_FILESYSTEM_DECL
 void recursive_directory_iterator_construct(recursive_directory_iterator& it, path const& dir_path, unsigned int opts, system::error_code* ec)
+{
+    recursive_directory_iterator_construct_filtered(it, dir_path, opts, NULL, ec);
+}
+
+BOOST_FILESYSTEM_DECL
+void recursive_directory_iterator_construct_filtered(recursive_directory_iterator& it, path const& dir_path, unsigned int opts, dir_itr_filter* filter, system::error_code* ec)
 {
     if (ec)
         ec->clear();
 
     directory_iterator dir_it;
-    detail::directory_iterator_construct(dir_it, dir_path, opts, NULL, ec);
+    detail::directory_iterator_construct_filtered(dir_it, dir_path, opts, NULL, filter, ec);
     if ((ec && *ec) || dir_it == directory_iterator())
         return;
 
@@ -1198,14 +3634,32 @@ void recursive_directory_iterator_construct(recursive_directory_iterator& it, pa
         }
     }
 
-    try
-    {
+    try
+    {
+        imp->m_max_open = get_rdi_max_open(opts);
+        if (imp->m_max_open > 0u)
+        {
+            detail::recur_dir_itr_level level;
+            level.filter = filter;
+            imp->m_levels.push_back(level);
+        }
+
+        if ((opts & static_cast< unsigned int >(directory_options::breadth_first)) != 0u)
+            imp->m_max_pending = filesystem::detail::atomic_load_relaxed(detail::g_rdi_pending_directories_limit);
+
 #if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
         imp->m_stack.push_back(std::move(dir_it));
 #else
         imp->m_stack.push_back(dir_it);
 #endif
 
+        if (tracks_directory_ids(opts))
+        {
+            // If the identity of the directory cannot be obtained, it is not used to detect cycles
+            system::error_code id_ec;
+            record_directory_id(imp.get(), detail::identity(dir_path, &id_ec));
+        }
+
         it.m_imp.swap(imp);
     }
     catch (std::bad_alloc&)
@@ -1218,23 +3672,34 @@ void recursive_directory_iterator_construct(recursive_directory_iterator& it, pa
 
         throw;
     }
+
+    // Skip the first entry if the filter only accepted it for descending into it
+    if ((it.m_imp->m_stack.back().m_imp->filter_flags & dir_itr_filter::produce_entry) == 0u)
+        recursive_directory_iterator_increment(it, ec);
 }
 
 namespace {
 
 void recursive_directory_iterator_pop_on_error(detail::recur_dir_itr_imp* imp)
 {
-    imp->m_stack.pop_back();
+    recursive_directory_iterator_pop_stack(imp);
 
     while (!imp->m_stack.empty())
     {
         directory_iterator& dir_it = imp->m_stack.back();
         system::error_code increment_ec;
-        detail::directory_iterator_increment(dir_it, &increment_ec);
+        recursive_directory_iterator_increment_top(imp, increment_ec);
         if (!increment_ec && dir_it != directory_iterator())
             break;
 
-        imp->m_stack.pop_back();
+        recursive_directory_iterator_pop_stack(imp);
+    }
+
+    if (imp->m_stack.empty() && !imp->m_pending.empty())
+    {
+        // Errors of opening the pending directories are not reported, as with pop() failures
+        system::error_code pending_ec;
+        recursive_directory_iterator_push_pending(imp, pending_ec);
     }
 }
 
@@ -1249,19 +3714,32 @@ void recursive_directory_iterator_pop(recursive_directory_iterator& it, system::
     if (ec)
         ec->clear();
 
-    imp->m_stack.pop_back();
+    recursive_directory_iterator_pop_stack(imp);
 
     while (true)
     {
         if (imp->m_stack.empty())
         {
-            it.m_imp.reset(); // done, so make end iterator
+            system::error_code pending_ec;
+            const bool pushed = !imp->m_pending.empty() && recursive_directory_iterator_push_pending(imp, pending_ec);
+            if (!pushed)
+                it.m_imp.reset(); // done, so make end iterator
+
+            if (BOOST_UNLIKELY(!!pending_ec))
+            {
+                if (!ec)
+                    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::recursive_directory_iterator::pop", pending_ec));
+
+                *ec = pending_ec;
+                return;
+            }
+
             break;
         }
 
         directory_iterator& dir_it = imp->m_stack.back();
         system::error_code increment_ec;
-        detail::directory_iterator_increment(dir_it, &increment_ec);
+        recursive_directory_iterator_increment_top(imp, increment_ec);
         if (BOOST_UNLIKELY(!!increment_ec))
         {
             if ((imp->m_options & static_cast< unsigned int >(directory_options::pop_on_error)) == 0u)
@@ -1287,8 +3765,11 @@ void recursive_directory_iterator_pop(recursive_directory_iterator& it, system::
         if (dir_it != directory_iterator())
             break;
 
-        imp->m_stack.pop_back();
+        recursive_directory_iterator_pop_stack(imp);
     }
+
+    if (it.m_imp && (imp->m_stack.back().m_imp->filter_flags & dir_itr_filter::produce_entry) == 0u)
+        recursive_directory_iterator_increment(it, ec);
 }
 
 namespace {
@@ -1301,7 +3782,8 @@ enum push_directory_result
 };
 
 // Returns: true if push occurs, otherwise false. Always returns false on error.
-inline push_directory_result recursive_directory_iterator_push_directory(detail::recur_dir_itr_imp* imp, system::error_code& ec) BOOST_NOEXCEPT
+//! Pushes the directory referred to by the current entry of the stack top iterator to the stack, if needed. \a parent_imp is the stack top iterator implementation.
+inline push_directory_result recursive_directory_iterator_push_directory(detail::recur_dir_itr_imp* imp, detail::dir_itr_imp* parent_imp, system::error_code& ec) BOOST_NOEXCEPT
 {
     push_directory_result result = directory_not_pushed;
     try
@@ -1315,6 +3797,11 @@ inline push_directory_result recursive_directory_iterator_push_directory(detail:
             return result;
         }
 
+        // Don't descend into directories if the filter indicated that they cannot contain accepted entries
+        if ((parent_imp->filter_flags & dir_itr_filter::descend_entry) == 0u)
+            return result;
+
+        // Only the file types are needed, which are usually known from the directory iterator without querying the filesystem
         file_status symlink_stat;
 
         // If we are not recursing into symlinks, we are going to have to know if the
@@ -1322,7 +3809,7 @@ inline push_directory_result recursive_directory_iterator_push_directory(detail:
         if ((imp->m_options & static_cast< unsigned int >(directory_options::follow_directory_symlink)) == 0u ||
             (imp->m_options & static_cast< unsigned int >(directory_options::skip_dangling_symlinks)) != 0u)
         {
-            symlink_stat = imp->m_stack.back()->symlink_status(ec);
+            symlink_stat = file_status(imp->m_stack.back()->symlink_file_type(ec));
             if (ec)
                 return result;
         }
@@ -1337,7 +3824,7 @@ inline push_directory_result recursive_directory_iterator_push_directory(detail:
 
         if ((imp->m_options & static_cast< unsigned int >(directory_options::follow_directory_symlink)) != 0u || !fs::is_symlink(symlink_stat))
         {
-            file_status stat = imp->m_stack.back()->status(ec);
+            file_status stat(imp->m_stack.back()->file_type(ec));
             if (BOOST_UNLIKELY(!!ec))
             {
                 if (ec == make_error_condition(system::errc::no_such_file_or_directory) && fs::is_symlink(symlink_stat) &&
@@ -1353,7 +3840,7 @@ inline push_directory_result recursive_directory_iterator_push_directory(detail:
             if (!fs::is_directory(stat))
                 return result;
 
-            if (BOOST_UNLIKELY((imp->m_stack.size() - 1u) >= static_cast< std::size_t >((std::numeric_limits< int >::max)())))
+            if (BOOST_UNLIKELY((imp->m_base_depth + imp->m_stack.size() - 1u) >= static_cast< std::size_t >((std::numeric_limits< int >::max)())))
             {
                 // We cannot let depth to overflow
                 ec = make_error_code(system::errc::value_too_large);
@@ -1363,7 +3850,79 @@ inline push_directory_result recursive_directory_iterator_push_directory(detail:
                 return result;
             }
 
-            directory_iterator next(imp->m_stack.back()->path(), static_cast< BOOST_SCOPED_ENUM_NATIVE(directory_options) >(imp->m_options), ec);
+            // Don't descend into the directories that are already on the stack or were already iterated. This prevents
+            // infinite recursion on directory symlink cycles without relying on ELOOP or the depth limit.
+            file_identity dir_id;
+            const bool track_dir_ids = tracks_directory_ids(imp->m_options);
+            if (track_dir_ids)
+            {
+                dir_id = imp->m_stack.back()->identity(ec);
+                if (BOOST_UNLIKELY(!!ec))
+                    return result;
+
+                if (has_directory_id(imp, dir_id))
+                    return result;
+            }
+
+            boost::intrusive_ptr< dir_itr_filter > filter;
+            if (parent_imp->filter)
+                filter = parent_imp->filter->descend();
+
+            if ((imp->m_options & static_cast< unsigned int >(directory_options::breadth_first)) != 0u && imp->m_pending.size() < imp->m_max_pending)
+            {
+                // Queue the directory, it will be opened after iterating the directories at the current depth. If the queue is full,
+                // descend into the directory immediately, which bounds the memory used by the queue.
+                detail::recur_dir_itr_pending pending;
+                pending.dir_path = imp->m_stack.back()->path();
+                pending.filter.swap(filter);
+                pending.depth = imp->m_base_depth + imp->m_stack.size();
+                imp->m_pending.push_back(pending); // may throw
+
+                if (track_dir_ids)
+                {
+                    try
+                    {
+                        record_directory_id(imp, dir_id);
+                    }
+                    catch (...)
+                    {
+                        imp->m_pending.pop_back();
+                        throw;
+                    }
+                }
+
+                return result;
+            }
+
+            const boost::uint64_t start_time = imp->m_observer ? get_current_time_ns() : static_cast< boost::uint64_t >(0u);
+            directory_iterator next;
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+            {
+                // Open the subdirectory relative to the parent directory to avoid resolving the whole path again. If we're not following
+                // directory symlinks, also make sure the subdirectory wasn't replaced with a symlink since we queried its status.
+                const bool follow_symlinks = (imp->m_options & static_cast< unsigned int >(directory_options::follow_directory_symlink)) != 0u;
+                std::string filename = imp->m_stack.back()->path().filename().native();
+
+                directory_iterator_params params;
+                params.basedir_fd = ::dirfd(static_cast< DIR* >(parent_imp->handle));
+                params.open_path = filename.c_str();
+                params.iterator_fd = -1;
+
+                unsigned int opts = imp->m_options;
+                if (!follow_symlinks)
+                    opts |= static_cast< unsigned int >(directory_options::_detail_no_follow);
+
+                detail::directory_iterator_construct_filtered(next, imp->m_stack.back()->path(), opts, &params, filter.get(), &ec);
+                if (BOOST_UNLIKELY(!!ec) && !follow_symlinks && ec == system::error_code(ELOOP, system::system_category()))
+                {
+                    // The directory was replaced with a symlink, which we must not follow
+                    ec.clear();
+                    return result;
+                }
+            }
+#else
+            detail::directory_iterator_construct_filtered(next, imp->m_stack.back()->path(), imp->m_options, NULL, filter.get(), &ec);
+#endif
             if (!ec && next != directory_iterator())
             {
 #if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
@@ -1371,8 +3930,47 @@ inline push_directory_result recursive_directory_iterator_push_directory(detail:
 #else
                 imp->m_stack.push_back(next); // may throw
 #endif
+                if (imp->m_max_open > 0u)
+                {
+                    detail::recur_dir_itr_level level;
+                    level.filter = filter;
+                    try
+                    {
+                        imp->m_levels.push_back(level);
+                    }
+                    catch (...)
+                    {
+                        imp->m_stack.pop_back();
+                        throw;
+                    }
+                }
+
+                if (track_dir_ids)
+                {
+                    try
+                    {
+                        record_directory_id(imp, dir_id);
+                    }
+                    catch (...)
+                    {
+                        imp->m_stack.pop_back();
+                        if (imp->m_max_open > 0u)
+                            imp->m_levels.pop_back();
+                        throw;
+                    }
+                }
+
+                if (imp->m_max_open > 0u)
+                    recursive_directory_iterator_limit_open(imp);
+
+                if (imp->m_observer)
+                    observe_pushed_directory(imp, start_time);
+
                 return directory_pushed;
             }
+
+            if (imp->m_observer && !ec)
+                observe_empty_directory(imp, imp->m_stack.back()->path(), imp->m_base_depth + imp->m_stack.size(), start_time);
         }
     }
     catch (std::bad_alloc&)
@@ -1396,10 +3994,11 @@ void recursive_directory_iterator_increment(recursive_directory_iterator& it, sy
 
     system::error_code local_ec;
 
+next_entry:
     //  if various conditions are met, push a directory_iterator into the iterator stack
-    push_directory_result push_result = recursive_directory_iterator_push_directory(imp, local_ec);
+    push_directory_result push_result = recursive_directory_iterator_push_directory(imp, imp->m_stack.back().m_imp.get(), local_ec);
     if (push_result == directory_pushed)
-        return;
+        goto check_entry;
 
     // report errors if any
     if (BOOST_UNLIKELY(!!local_ec))
@@ -1416,7 +4015,7 @@ void recursive_directory_iterator_increment(recursive_directory_iterator& it, sy
             {
                 system::error_code increment_ec;
                 directory_iterator& dir_it = imp->m_stack.back();
-                detail::directory_iterator_increment(dir_it, &increment_ec);
+                recursive_directory_iterator_increment_top(imp, increment_ec);
                 if (!increment_ec && dir_it != directory_iterator())
                     goto on_error_return;
             }
@@ -1442,20 +4041,499 @@ void recursive_directory_iterator_increment(recursive_directory_iterator& it, sy
     {
         if (imp->m_stack.empty())
         {
-            it.m_imp.reset(); // done, so make end iterator
+            // Continue with the directories pending iteration, if any
+            const bool pushed = !imp->m_pending.empty() && recursive_directory_iterator_push_pending(imp, local_ec);
+            if (!pushed)
+                it.m_imp.reset(); // done, so make end iterator
+
+            if (BOOST_UNLIKELY(!!local_ec))
+                goto on_error_return;
+
             break;
         }
 
         directory_iterator& dir_it = imp->m_stack.back();
-        detail::directory_iterator_increment(dir_it, &local_ec);
+        recursive_directory_iterator_increment_top(imp, local_ec);
         if (BOOST_UNLIKELY(!!local_ec))
             goto on_error;
 
         if (dir_it != directory_iterator())
             break;
 
-        imp->m_stack.pop_back();
+        recursive_directory_iterator_pop_stack(imp);
+    }
+
+check_entry:
+    // Skip the entries that the filter only accepted for descending into them
+    if (it.m_imp && (imp->m_stack.back().m_imp->filter_flags & dir_itr_filter::produce_entry) == 0u)
+        goto next_entry;
+}
+
+BOOST_FILESYSTEM_DECL
+void recursive_directory_iterator_set_observer(recursive_directory_iterator& it, recursive_directory_iterator_observer* observer, void* context)
+{
+    if (it.is_end())
+        return;
+
+    detail::recur_dir_itr_imp* const imp = it.m_imp.get();
+    if (!observer)
+    {
+        imp->m_observer = NULL;
+        imp->m_observer_context = NULL;
+        imp->m_observed.clear();
+        return;
+    }
+
+    if (imp->m_observer)
+    {
+        imp->m_observer = observer;
+        imp->m_observer_context = context;
+        return;
+    }
+
+    // Start observing the directories that are already on the stack
+    std::vector< detail::recur_dir_itr_observed > observed(imp->m_stack.size()); // may throw
+    const boost::uint64_t now = get_current_time_ns();
+    for (std::size_t i = 0u, n = imp->m_stack.size(); i < n; ++i)
+    {
+        // The directories that were closed to limit the number of open directories have their paths saved
+        if (i < imp->m_closed_count)
+            observed[i].dir_path = imp->m_levels[i].dir_path;
+        else
+            observed[i].dir_path = imp->m_stack[i]->path().parent_path();
+        observed[i].start_time = now;
+        observed[i].iterator_bytes_read = dir_itr_imp_access::get_read_size(imp->m_stack[i]);
+    }
+    imp->m_observed.swap(observed);
+    imp->m_observer = observer;
+    imp->m_observer_context = context;
+
+    for (std::size_t i = 0u, n = imp->m_stack.size(); i < n; ++i)
+        report_observed_directory(imp, recursive_directory_iterator_event::push, imp->m_observed[i], imp->m_base_depth + i, now);
+}
+
+namespace {
+
+//! Signature of the serialized recursive directory iterator checkpoints
+BOOST_CONSTEXPR_OR_CONST char checkpoint_signature[] = "BFSRDIC";
+//! Version of the checkpoint format
+BOOST_CONSTEXPR_OR_CONST boost::uintmax_t checkpoint_version = 1u;
+
+//! Appends an unsigned integer to the checkpoint, 7 bits per byte, starting from the least significant bits
+void append_checkpoint_uint(std::string& checkpoint, boost::uintmax_t value)
+{
+    while (value >= 0x80u)
+    {
+        checkpoint.push_back(static_cast< char >((value & 0x7Fu) | 0x80u));
+        value >>= 7u;
+    }
+
+    checkpoint.push_back(static_cast< char >(value));
+}
+
+//! Appends a path to the checkpoint, as the number of code units followed by the code units of the native path
+void append_checkpoint_path(std::string& checkpoint, path const& p)
+{
+    typedef boost::make_unsigned< path::value_type >::type code_unit_type;
+    path::string_type const& str = p.native();
+    append_checkpoint_uint(checkpoint, str.size());
+    for (path::string_type::const_iterator it = str.begin(), end = str.end(); it != end; ++it)
+        append_checkpoint_uint(checkpoint, static_cast< code_unit_type >(*it));
+}
+
+//! Parser of the serialized checkpoints
+class checkpoint_reader
+{
+private:
+    const unsigned char* m_pos;
+    const unsigned char* const m_end;
+
+public:
+    explicit checkpoint_reader(std::string const& checkpoint) BOOST_NOEXCEPT :
+        m_pos(reinterpret_cast< const unsigned char* >(checkpoint.data())),
+        m_end(reinterpret_cast< const unsigned char* >(checkpoint.data()) + checkpoint.size())
+    {
+    }
+
+    //! Returns the number of unread bytes
+    std::size_t remaining() const BOOST_NOEXCEPT { return static_cast< std::size_t >(m_end - m_pos); }
+
+    bool read_signature() BOOST_NOEXCEPT
+    {
+        const std::size_t size = sizeof(checkpoint_signature) - 1u;
+        if (remaining() < size || std::memcmp(m_pos, checkpoint_signature, size) != 0)
+            return false;
+        m_pos += size;
+        return true;
+    }
+
+    bool read_uint(boost::uintmax_t& value) BOOST_NOEXCEPT
+    {
+        value = 0u;
+        for (unsigned int shift = 0u; m_pos != m_end && shift < static_cast< unsigned int >(std::numeric_limits< boost::uintmax_t >::digits); shift += 7u)
+        {
+            const unsigned int byte = *m_pos++;
+            value |= static_cast< boost::uintmax_t >(byte & 0x7Fu) << shift;
+            if ((byte & 0x80u) == 0u)
+                return true;
+        }
+
+        return false;
+    }
+
+    //! Reads an integer that is used as the number of elements that follow, each taking at least one byte
+    bool read_count(std::size_t& count) BOOST_NOEXCEPT
+    {
+        boost::uintmax_t value;
+        if (!read_uint(value) || value > remaining())
+            return false;
+        count = static_cast< std::size_t >(value);
+        return true;
+    }
+
+    bool read_path(path& p)
+    {
+        typedef boost::make_unsigned< path::value_type >::type code_unit_type;
+        std::size_t size;
+        if (!read_count(size))
+            return false;
+
+        path::string_type str;
+        str.reserve(size);
+        for (std::size_t i = 0u; i < size; ++i)
+        {
+            boost::uintmax_t value;
+            if (!read_uint(value) || value > static_cast< boost::uintmax_t >((std::numeric_limits< code_unit_type >::max)()))
+                return false;
+            str.push_back(static_cast< path::value_type >(static_cast< code_unit_type >(value)));
+        }
+
+        p = str;
+        return true;
+    }
+};
+
+//! Returns \c true if the options require to save the identities of all iterated directories in checkpoints, rather than only those on the stack
+inline bool checkpoint_saves_directory_ids(unsigned int opts) BOOST_NOEXCEPT
+{
+    return tracks_directory_ids(opts) &&
+        (opts & static_cast< unsigned int >(directory_options::skip_visited_directories | directory_options::breadth_first)) != 0u;
+}
+
+//! Returns the path of the directory at the given depth of the stack, relative to the bottom of the stack
+path checkpoint_directory_path(detail::recur_dir_itr_imp const* imp, std::size_t index)
+{
+    directory_iterator const& dir_it = imp->m_stack[index];
+    if (dir_it != directory_iterator())
+        return dir_it->path().parent_path();
+
+    // The directory was closed to limit the number of open directories
+    return imp->m_levels[index].dir_path;
+}
+
+//! Returns the filename of the current entry of the directory at the given depth of the stack, relative to the bottom of the stack
+path checkpoint_entry_name(detail::recur_dir_itr_imp const* imp, std::size_t index)
+{
+    directory_iterator const& dir_it = imp->m_stack[index];
+    if (dir_it != directory_iterator())
+        return dir_it->path().filename();
+
+    // The current entry of a closed directory is the directory above it in the stack
+    if (index + 1u < imp->m_stack.size())
+        return checkpoint_directory_path(imp, index + 1u).filename();
+
+    return path();
+}
+
+//! Opens the directory of a resumed iterator and positions the iterator on the entry with the given name. If the entry is not found, positions on the first entry. Returns \c true if the entry was found.
+bool resume_directory(detail::recur_dir_itr_imp* imp, directory_iterator& dir_it, path const& dir_path, path const& name, bool nested, std::size_t& position, system::error_code& ec)
+{
+    recursive_directory_iterator_open(imp, dir_it, dir_path, NULL, nested, ec);
+    position = 1u;
+    while (!ec && dir_it != directory_iterator())
+    {
+        if (dir_it->path().filename().native() == name.native())
+            return true;
+
+        detail::directory_iterator_increment(dir_it, &ec);
+        ++position;
+    }
+
+    if (ec)
+        return false;
+
+    // The entry was removed, restart the directory
+    recursive_directory_iterator_open(imp, dir_it, dir_path, NULL, nested, ec);
+    position = 1u;
+    return false;
+}
+
+//! Returns \c true if the error indicates that the directory no longer exists
+inline bool is_directory_missing(system::error_code const& ec) BOOST_NOEXCEPT
+{
+    return ec == make_error_condition(system::errc::no_such_file_or_directory) || ec == make_error_condition(system::errc::not_a_directory);
+}
+
+/*!
+ * Recreates the state of a recursive directory iterator from a checkpoint. On success, \a result is the iterator implementation, or \c NULL
+ * if the iteration is complete. \a advance is set to \c true if the iterator must be incremented without descending into the current entry.
+ */
+system::error_code resume_recursive_directory_iterator(std::string const& checkpoint, boost::intrusive_ptr< detail::recur_dir_itr_imp >& result, bool& advance, path& err_path)
+{
+    checkpoint_reader reader(checkpoint);
+    boost::uintmax_t version = 0u, options = 0u, base_depth = 0u;
+    std::size_t level_count = 0u, pending_count = 0u, id_count = 0u;
+    path dir_path;
+    std::vector< path > names;
+    std::deque< detail::recur_dir_itr_pending > pending;
+    std::vector< file_identity > ids;
+
+    bool valid = reader.read_signature() && reader.read_uint(version) && version == checkpoint_version &&
+        reader.read_uint(options) && options <= static_cast< boost::uintmax_t >((std::numeric_limits< unsigned int >::max)()) &&
+        reader.read_uint(base_depth) && base_depth < static_cast< boost::uintmax_t >((std::numeric_limits< int >::max)()) &&
+        reader.read_count(level_count) && level_count > 0u && reader.read_path(dir_path) && !dir_path.empty();
+
+    if (valid)
+    {
+        names.resize(level_count);
+        for (std::size_t i = 0u; valid && i < level_count; ++i)
+            valid = reader.read_path(names[i]);
+    }
+
+    valid = valid && reader.read_count(pending_count);
+    for (std::size_t i = 0u; valid && i < pending_count; ++i)
+    {
+        detail::recur_dir_itr_pending dir;
+        boost::uintmax_t depth = 0u;
+        valid = reader.read_path(dir.dir_path) && reader.read_uint(depth) && depth < static_cast< boost::uintmax_t >((std::numeric_limits< int >::max)());
+        if (valid)
+        {
+            dir.depth = static_cast< std::size_t >(depth);
+            pending.push_back(dir);
+        }
+    }
+
+    valid = valid && reader.read_count(id_count);
+    for (std::size_t i = 0u; valid && i < id_count; ++i)
+    {
+        file_identity id;
+        valid = reader.read_uint(id.device) && reader.read_uint(id.id) && reader.read_uint(id.id_high);
+        if (valid)
+            ids.push_back(id);
+    }
+
+    if (!valid || reader.remaining() != 0u)
+        return make_error_code(system::errc::invalid_argument);
+
+    const unsigned int opts = static_cast< unsigned int >(options) & ~static_cast< unsigned int >(directory_options::_detail_no_follow);
+    boost::intrusive_ptr< detail::recur_dir_itr_imp > imp(new detail::recur_dir_itr_imp(opts));
+    imp->m_max_open = get_rdi_max_open(opts);
+    if ((opts & static_cast< unsigned int >(directory_options::breadth_first)) != 0u)
+        imp->m_max_pending = filesystem::detail::atomic_load_relaxed(detail::g_rdi_pending_directories_limit);
+    imp->m_base_depth = static_cast< std::size_t >(base_depth);
+    imp->m_pending.swap(pending);
+
+    if (checkpoint_saves_directory_ids(opts))
+    {
+        for (std::size_t i = 0u; i < ids.size(); ++i)
+            record_directory_id(imp.get(), ids[i]);
+    }
+
+    const bool records_stack_ids = tracks_directory_ids(opts) && !checkpoint_saves_directory_ids(opts);
+    bool found = true;
+    for (std::size_t i = 0u; i < level_count; ++i)
+    {
+        const bool nested = imp->m_base_depth + i > 0u;
+        directory_iterator dir_it;
+        std::size_t position = 1u;
+        system::error_code ec;
+        found = resume_directory(imp.get(), dir_it, dir_path, names[i], nested, position, ec);
+        if (BOOST_UNLIKELY(!!ec))
+        {
+            if (i > 0u && is_directory_missing(ec))
+            {
+                // The directory was removed, continue with the next entry of the parent directory
+                advance = true;
+                break;
+            }
+
+            err_path = dir_path;
+            return ec;
+        }
+
+        if (dir_it == directory_iterator())
+        {
+            // The directory was emptied, continue with the next entry of the parent directory
+            advance = i > 0u;
+            break;
+        }
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+        imp->m_stack.push_back(std::move(dir_it));
+#else
+        imp->m_stack.push_back(dir_it);
+#endif
+
+        if (imp->m_max_open > 0u)
+        {
+            detail::recur_dir_itr_level level;
+            level.position = position;
+            imp->m_levels.push_back(level);
+        }
+
+        if (records_stack_ids)
+        {
+            // If the identity of the directory cannot be obtained, it is not used to detect cycles
+            system::error_code id_ec;
+            record_directory_id(imp.get(), detail::identity(dir_path, &id_ec));
+        }
+
+        if (imp->m_max_open > 0u)
+            recursive_directory_iterator_limit_open(imp.get());
+
+        if (!found)
+            break;
+
+        if (i + 1u < level_count)
+            dir_path /= names[i];
+    }
+
+    // The saved state of the current entry does not apply if the iterator is positioned on a different entry
+    if (!found || advance || imp->m_stack.size() < level_count)
+        imp->m_options &= ~static_cast< unsigned int >(directory_options::_detail_no_push);
+
+    if (advance)
+    {
+        imp->m_options |= static_cast< unsigned int >(directory_options::_detail_no_push);
+    }
+    else if (imp->m_stack.empty())
+    {
+        system::error_code ec;
+        if (!recursive_directory_iterator_push_pending(imp.get(), ec))
+            imp.reset();
+        if (BOOST_UNLIKELY(!!ec))
+            return ec;
+    }
+
+    result.swap(imp);
+    return system::error_code();
+}
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL
+void recursive_directory_iterator_save(recursive_directory_iterator const& it, std::string& checkpoint, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    checkpoint.clear();
+    if (it.is_end())
+        return;
+
+    detail::recur_dir_itr_imp const* const imp = it.m_imp.get();
+
+    // Entry name filters cannot be serialized
+    bool supported = true;
+    for (std::size_t i = 0u, n = imp->m_stack.size(); supported && i < n; ++i)
+        supported = !imp->m_stack[i].m_imp || !imp->m_stack[i].m_imp->filter;
+    for (std::size_t i = 0u, n = imp->m_levels.size(); supported && i < n; ++i)
+        supported = !imp->m_levels[i].filter;
+    for (std::size_t i = 0u, n = imp->m_pending.size(); supported && i < n; ++i)
+        supported = !imp->m_pending[i].filter;
+
+    if (BOOST_UNLIKELY(!supported))
+    {
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, ec, "boost::filesystem::recursive_directory_iterator::checkpoint");
+        return;
+    }
+
+    try
+    {
+        checkpoint.append(checkpoint_signature, sizeof(checkpoint_signature) - 1u);
+        append_checkpoint_uint(checkpoint, checkpoint_version);
+        append_checkpoint_uint(checkpoint, imp->m_options);
+        append_checkpoint_uint(checkpoint, imp->m_base_depth);
+        append_checkpoint_uint(checkpoint, imp->m_stack.size());
+        append_checkpoint_path(checkpoint, checkpoint_directory_path(imp, 0u));
+        for (std::size_t i = 0u, n = imp->m_stack.size(); i < n; ++i)
+            append_checkpoint_path(checkpoint, checkpoint_entry_name(imp, i));
+
+        append_checkpoint_uint(checkpoint, imp->m_pending.size());
+        for (std::deque< detail::recur_dir_itr_pending >::const_iterator pit = imp->m_pending.begin(), pend = imp->m_pending.end(); pit != pend; ++pit)
+        {
+            append_checkpoint_path(checkpoint, pit->dir_path);
+            append_checkpoint_uint(checkpoint, pit->depth);
+        }
+
+        // Identities of the directories on the stack are obtained again when the iterator is resumed
+        if (checkpoint_saves_directory_ids(imp->m_options))
+        {
+            append_checkpoint_uint(checkpoint, imp->m_dir_id_count);
+            for (std::vector< file_identity >::const_iterator iit = imp->m_dir_ids.begin(), iend = imp->m_dir_ids.end(); iit != iend; ++iit)
+            {
+                if (*iit != file_identity())
+                {
+                    append_checkpoint_uint(checkpoint, iit->device);
+                    append_checkpoint_uint(checkpoint, iit->id);
+                    append_checkpoint_uint(checkpoint, iit->id_high);
+                }
+            }
+        }
+        else
+        {
+            append_checkpoint_uint(checkpoint, 0u);
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        checkpoint.clear();
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+    }
+}
+
+BOOST_FILESYSTEM_DECL
+void recursive_directory_iterator_construct_resume(recursive_directory_iterator& it, std::string const& checkpoint, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    it.m_imp.reset();
+    if (checkpoint.empty())
+        return;
+
+    boost::intrusive_ptr< detail::recur_dir_itr_imp > imp;
+    bool advance = false;
+    path err_path;
+    system::error_code err;
+    try
+    {
+        err = resume_recursive_directory_iterator(checkpoint, imp, advance, err_path);
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return;
+    }
+
+    if (BOOST_UNLIKELY(!!err))
+    {
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::recursive_directory_iterator::construct", err_path, err));
+
+        *ec = err;
+        return;
     }
+
+    it.m_imp.swap(imp);
+    if (advance)
+        recursive_directory_iterator_increment(it, ec);
 }
 
 } // namespace detail
@@ -0,0 +1,1111 @@
+//  directory_watcher.cpp  -------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/directory_watcher.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <map>
+#include <new> // std::bad_alloc
+#include <vector>
+#include <limits>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#if !defined(BOOST_NO_CXX11_HDR_CHRONO)
+#include <chrono>
+#endif
+
+#if defined(BOOST_POSIX_API)
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#if defined(linux) || defined(__linux) || defined(__linux__)
+#include <sys/inotify.h>
+#define BOOST_FILESYSTEM_USE_INOTIFY
+#elif defined(BOOST_FILESYSTEM_HAS_STAT_ST_MTIM)
+#define BOOST_FILESYSTEM_STAT_ST_MTIMENSEC st_mtim.tv_nsec
+#elif defined(BOOST_FILESYSTEM_HAS_STAT_ST_MTIMESPEC)
+#define BOOST_FILESYSTEM_STAT_ST_MTIMENSEC st_mtimespec.tv_nsec
+#elif defined(BOOST_FILESYSTEM_HAS_STAT_ST_MTIMENSEC)
+#define BOOST_FILESYSTEM_STAT_ST_MTIMENSEC st_mtimensec
+#endif
+
+#include "posix_tools.hpp"
+
+#else // BOOST_WINDOWS_API
+
+#include <windows.h>
+
+#include "windows_tools.hpp"
+
+#endif // BOOST_WINDOWS_API
+
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+namespace {
+
+//! Returns the current time of a monotonic clock, in milliseconds
+inline boost::uint64_t get_current_time_ms() BOOST_NOEXCEPT
+{
+#if !defined(BOOST_NO_CXX11_HDR_CHRONO)
+    return static_cast< boost::uint64_t >(std::chrono::duration_cast< std::chrono::milliseconds >(std::chrono::steady_clock::now().time_since_epoch()).count());
+#else
+    return static_cast< boost::uint64_t >(std::time(NULL)) * 1000u;
+#endif
+}
+
+//! Bounded queue of events that coalesces events for the same file
+class event_queue
+{
+private:
+    struct entry
+    {
+        watch_event event;
+        bool erased;
+
+        explicit entry(watch_event const& ev) : event(ev), erased(false) {}
+    };
+
+    typedef std::map< path::string_type, std::size_t > index_map;
+
+private:
+    //! Queued events, including the ones erased as a result of coalescing
+    std::vector< entry > m_entries;
+    //! Index of the last event for a given file in \c m_entries, which further events for the file can be coalesced with
+    index_map m_last;
+    //! Maximum number of queued events
+    std::size_t m_capacity;
+    //! Number of queued events that are not erased
+    std::size_t m_size;
+    //! Indicates that the queue overflowed and holds a single overflow event
+    bool m_overflow;
+
+public:
+    explicit event_queue(std::size_t capacity) :
+        m_capacity(capacity > 0u ? capacity : 1u),
+        m_size(0u),
+        m_overflow(false)
+    {
+    }
+
+    bool empty() const BOOST_NOEXCEPT { return m_size == 0u; }
+
+    //! Queues a creation, modification or removal event for \a target
+    void push(BOOST_SCOPED_ENUM_NATIVE(watch_event_kind) kind, path const& target)
+    {
+        if (m_overflow)
+            return;
+
+        index_map::iterator it = m_last.find(target.native());
+        if (it != m_last.end())
+        {
+            entry& e = m_entries[it->second];
+            switch (kind)
+            {
+            case watch_event_kind::created:
+                if (e.event.kind == watch_event_kind::created)
+                    return;
+                if (e.event.kind == watch_event_kind::removed)
+                {
+                    // The file was replaced
+                    e.event.kind = watch_event_kind::modified;
+                    return;
+                }
+                break;
+
+            case watch_event_kind::modified:
+                if (e.event.kind == watch_event_kind::created || e.event.kind == watch_event_kind::modified)
+                    return;
+                break;
+
+            case watch_event_kind::removed:
+                if (e.event.kind == watch_event_kind::created)
+                {
+                    // The file was created and removed, there is nothing to report
+                    e.erased = true;
+                    --m_size;
+                    m_last.erase(it);
+                    return;
+                }
+                if (e.event.kind == watch_event_kind::modified || e.event.kind == watch_event_kind::removed)
+                {
+                    e.event.kind = watch_event_kind::removed;
+                    return;
+                }
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        if (!reserve())
+            return;
+
+        m_entries.push_back(entry(watch_event(kind, target)));
+        m_last[target.native()] = m_entries.size() - 1u;
+        ++m_size;
+    }
+
+    //! Queues a rename event
+    void push_rename(path const& target, path const& source)
+    {
+        if (m_overflow)
+            return;
+
+        index_map::iterator it = m_last.find(source.native());
+        if (it != m_last.end() && m_entries[it->second].event.kind == watch_event_kind::created)
+        {
+            // The file was created and then renamed, report it as created with the new name
+            m_entries[it->second].erased = true;
+            --m_size;
+            m_last.erase(it);
+            push(watch_event_kind::created, target);
+            return;
+        }
+
+        if (!reserve())
+            return;
+
+        // Don't coalesce events before and after renaming to preserve their order
+        m_last.erase(source.native());
+        m_last.erase(target.native());
+
+        m_entries.push_back(entry(watch_event(watch_event_kind::renamed, target, source)));
+        ++m_size;
+    }
+
+    //! Discards the queued events and queues an overflow event
+    void push_overflow()
+    {
+        if (m_overflow)
+            return;
+
+        m_entries.clear();
+        m_last.clear();
+        m_entries.push_back(entry(watch_event()));
+        m_size = 1u;
+        m_overflow = true;
+    }
+
+    //! Moves the queued events to \a events
+    std::size_t pop_all(std::vector< watch_event >& events)
+    {
+        events.reserve(events.size() + m_size);
+        for (std::size_t i = 0u, n = m_entries.size(); i < n; ++i)
+        {
+            if (!m_entries[i].erased)
+                events.push_back(m_entries[i].event);
+        }
+
+        const std::size_t count = m_size;
+        clear();
+        return count;
+    }
+
+    void clear() BOOST_NOEXCEPT
+    {
+        m_entries.clear();
+        m_last.clear();
+        m_size = 0u;
+        m_overflow = false;
+    }
+
+private:
+    //! Makes room for a new event. Returns \c false if the queue overflowed.
+    bool reserve()
+    {
+        if (m_size >= m_capacity)
+        {
+            push_overflow();
+            return false;
+        }
+
+        // Drop the erased entries, if there are too many of them
+        if (m_entries.size() >= m_capacity * 2u)
+            compact();
+
+        return true;
+    }
+
+    void compact()
+    {
+        std::size_t pos = 0u;
+        for (std::size_t i = 0u, n = m_entries.size(); i < n; ++i)
+        {
+            if (!m_entries[i].erased)
+            {
+                if (pos != i)
+                    m_entries[pos] = m_entries[i];
+                ++pos;
+            }
+        }
+        m_entries.resize(pos, entry(watch_event()));
+
+        m_last.clear();
+        for (std::size_t i = 0u; i < pos; ++i)
+        {
+            if (m_entries[i].event.kind != watch_event_kind::renamed)
+                m_last[m_entries[i].event.target.native()] = i;
+        }
+    }
+};
+
+#if defined(BOOST_POSIX_API)
+
+//! A pipe used to wake up the thread waiting for changes
+struct interrupt_pipe
+{
+    int read_fd;
+    int write_fd;
+
+    interrupt_pipe() BOOST_NOEXCEPT : read_fd(-1), write_fd(-1) {}
+    ~interrupt_pipe() BOOST_NOEXCEPT
+    {
+        if (read_fd >= 0)
+            detail::close_fd(read_fd);
+        if (write_fd >= 0)
+            detail::close_fd(write_fd);
+    }
+
+    BOOST_DELETED_FUNCTION(interrupt_pipe(interrupt_pipe const&))
+    BOOST_DELETED_FUNCTION(interrupt_pipe& operator=(interrupt_pipe const&))
+
+public:
+    //! Creates the pipe. Returns zero or an error code.
+    int init() BOOST_NOEXCEPT
+    {
+        int fds[2];
+        if (BOOST_UNLIKELY(::pipe(fds) < 0))
+            return errno;
+
+        read_fd = fds[0];
+        write_fd = fds[1];
+
+        for (unsigned int i = 0u; i < 2u; ++i)
+        {
+            int flags = ::fcntl(fds[i], F_GETFL);
+            if (BOOST_UNLIKELY(flags < 0 || ::fcntl(fds[i], F_SETFL, flags | O_NONBLOCK) < 0))
+                return errno;
+#if defined(FD_CLOEXEC)
+            if (BOOST_UNLIKELY(::fcntl(fds[i], F_SETFD, FD_CLOEXEC) < 0))
+                return errno;
+#endif
+        }
+
+        return 0;
+    }
+
+    void signal() BOOST_NOEXCEPT
+    {
+        const char c = 0;
+        while (true)
+        {
+            // If the pipe is full, the waiting thread will be woken up anyway
+            ssize_t res = ::write(write_fd, &c, 1u);
+            if (res >= 0 || errno != EINTR)
+                break;
+        }
+    }
+
+    void drain() BOOST_NOEXCEPT
+    {
+        char buf[64];
+        while (true)
+        {
+            ssize_t res = ::read(read_fd, buf, sizeof(buf));
+            if (res <= 0 && (res == 0 || errno != EINTR))
+                break;
+        }
+    }
+};
+
+//! Waits for \a fd to become readable or for \a intr to be signalled. Returns zero or an error code.
+int wait_for_input(int fd, interrupt_pipe& intr, unsigned int timeout_ms, bool& ready, bool& interrupted) BOOST_NOEXCEPT
+{
+    struct ::pollfd fds[2];
+    nfds_t count = 0u;
+    if (fd >= 0)
+    {
+        fds[count].fd = fd;
+        fds[count].events = POLLIN;
+        fds[count].revents = 0;
+        ++count;
+    }
+    fds[count].fd = intr.read_fd;
+    fds[count].events = POLLIN;
+    fds[count].revents = 0;
+    ++count;
+
+    const int timeout = timeout_ms == directory_watcher::infinite_timeout ? -1 :
+        static_cast< int >(timeout_ms < static_cast< unsigned int >((std::numeric_limits< int >::max)()) ? timeout_ms : static_cast< unsigned int >((std::numeric_limits< int >::max)()));
+    const int res = ::poll(fds, count, timeout);
+    if (res < 0)
+    {
+        const int err = errno;
+        return err == EINTR ? 0 : err;
+    }
+
+    if (res > 0)
+    {
+        if (fd >= 0 && fds[0].revents != 0)
+            ready = true;
+        if (fds[count - 1u].revents != 0)
+        {
+            intr.drain();
+            interrupted = true;
+        }
+    }
+
+    return 0;
+}
+
+#endif // defined(BOOST_POSIX_API)
+
+} // unnamed namespace
+
+#if defined(BOOST_FILESYSTEM_USE_INOTIFY)
+
+//! Directory watcher implementation based on inotify
+struct directory_watcher::implementation
+{
+    //! Rename source waiting for its destination
+    struct pending_move
+    {
+        boost::uint32_t cookie;
+        bool is_directory;
+        path source;
+
+        pending_move(boost::uint32_t c, bool is_dir, path const& src) : cookie(c), is_directory(is_dir), source(src) {}
+    };
+
+    typedef std::map< int, path > watch_map;
+
+    path root;
+    unsigned int options;
+    event_queue queue;
+    interrupt_pipe intr;
+    detail::fd_wrapper inotify_fd;
+    //! Watched directories, relative to the root
+    watch_map watches;
+    //! Rename sources for which destinations have not been received yet
+    std::vector< pending_move > moves;
+    //! Buffer for reading inotify events
+    union
+    {
+        struct ::inotify_event event;
+        char data[16384];
+    }
+    buffer;
+
+    implementation(path const& p, unsigned int opts, std::size_t capacity) :
+        root(p),
+        options(opts),
+        queue(capacity)
+    {
+    }
+
+    bool is_recursive() const BOOST_NOEXCEPT { return (options & static_cast< unsigned int >(watch_options::recursive)) != 0u; }
+
+    path full_path(path const& rel) const { return rel.empty() ? root : root / rel; }
+
+    //! Initializes the watcher. Returns zero or an error code.
+    int init()
+    {
+        int err = intr.init();
+        if (BOOST_UNLIKELY(err != 0))
+            return err;
+
+        inotify_fd.fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (BOOST_UNLIKELY(inotify_fd.fd < 0))
+            return errno;
+
+        if (is_recursive())
+            return add_tree(path(), false);
+
+        return add_watch(path());
+    }
+
+    //! Adds a watch for a directory. Returns zero or an error code.
+    int add_watch(path const& rel)
+    {
+        boost::uint32_t mask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+#if defined(IN_EXCL_UNLINK)
+        mask |= IN_EXCL_UNLINK;
+#endif
+        if (!rel.empty())
+            mask |= IN_DONT_FOLLOW;
+
+        const int wd = ::inotify_add_watch(inotify_fd.fd, full_path(rel).c_str(), mask);
+        if (BOOST_UNLIKELY(wd < 0))
+            return errno;
+
+        watches[wd] = rel;
+        return 0;
+    }
+
+    //! Adds watches for a directory tree. If \a report is \c true, reports all files in the tree as created. Returns zero or an error code.
+    int add_tree(path const& rel, bool report)
+    {
+        int err = add_watch(rel);
+        if (err != 0)
+        {
+            // The subdirectory may have been removed or be inaccessible
+            if (!rel.empty() && (err == ENOENT || err == ENOTDIR || err == EACCES))
+                err = 0;
+            return err;
+        }
+
+        system::error_code ec;
+        for (directory_iterator it(full_path(rel), directory_options::skip_permission_denied, ec), end; !ec && it != end; it.increment(ec))
+        {
+            path child(rel);
+            child /= it->path().filename();
+            if (report)
+                queue.push(watch_event_kind::created, full_path(child));
+
+            system::error_code status_ec;
+            if (filesystem::is_directory(it->symlink_status(status_ec)))
+            {
+                err = add_tree(child, report);
+                if (BOOST_UNLIKELY(err != 0))
+                    return err;
+            }
+        }
+
+        return 0;
+    }
+
+    //! Adds watches for a directory tree that appeared in the watched tree after it was open
+    void add_new_tree(path const& rel)
+    {
+        if (BOOST_UNLIKELY(add_tree(rel, true) != 0))
+        {
+            // Changes in the new directory cannot be watched, e.g. due to the limit of watches
+            queue.push_overflow();
+        }
+    }
+
+    //! Checks if \a p is equal to or is a descendant of \a dir
+    static bool is_in_subtree(path::string_type const& p, path::string_type const& dir) BOOST_NOEXCEPT
+    {
+        return p.size() >= dir.size() && p.compare(0u, dir.size(), dir) == 0 &&
+            (p.size() == dir.size() || detail::is_directory_separator(p[dir.size()]));
+    }
+
+    //! Removes watches for a directory tree that left the watched tree
+    void remove_tree(path const& rel)
+    {
+        for (watch_map::iterator it = watches.begin(), end = watches.end(); it != end;)
+        {
+            if (is_in_subtree(it->second.native(), rel.native()))
+            {
+                ::inotify_rm_watch(inotify_fd.fd, it->first);
+                watches.erase(it++);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    //! Updates paths of watches for a directory tree that was renamed within the watched tree
+    void rename_tree(path const& from, path const& to)
+    {
+        for (watch_map::iterator it = watches.begin(), end = watches.end(); it != end; ++it)
+        {
+            path::string_type const& p = it->second.native();
+            if (is_in_subtree(p, from.native()))
+                it->second = path(to.native() + p.substr(from.native().size()));
+        }
+    }
+
+    //! Waits for changes and queues events. Returns zero or an error code.
+    int poll_changes(unsigned int timeout_ms, bool& interrupted)
+    {
+        bool ready = false;
+        int err = wait_for_input(inotify_fd.fd, intr, timeout_ms, ready, interrupted);
+        if (err != 0 || !ready)
+            return err;
+
+        while (true)
+        {
+            const ssize_t size = ::read(inotify_fd.fd, buffer.data, sizeof(buffer.data));
+            if (size < 0)
+            {
+                err = errno;
+                if (err == EINTR)
+                    continue;
+                if (err == EAGAIN || err == EWOULDBLOCK)
+                    break;
+                return err;
+            }
+
+            if (size == 0)
+                break;
+
+            for (const char* p = buffer.data, *e = buffer.data + size; p < e;)
+            {
+                struct ::inotify_event ev;
+                std::memcpy(&ev, p, sizeof(ev));
+                on_event(ev, p + sizeof(ev));
+                p += sizeof(ev) + ev.len;
+            }
+        }
+
+        // The sources of renames that have no destinations were moved out of the watched tree
+        for (std::size_t i = 0u, n = moves.size(); i < n; ++i)
+        {
+            pending_move const& m = moves[i];
+            queue.push(watch_event_kind::removed, full_path(m.source));
+            if (m.is_directory && is_recursive())
+                remove_tree(m.source);
+        }
+        moves.clear();
+
+        return 0;
+    }
+
+    void on_event(struct ::inotify_event const& ev, const char* name)
+    {
+        if ((ev.mask & IN_Q_OVERFLOW) != 0u)
+        {
+            queue.push_overflow();
+            return;
+        }
+
+        watch_map::iterator it = watches.find(ev.wd);
+        if (it == watches.end())
+            return;
+
+        if ((ev.mask & IN_IGNORED) != 0u)
+        {
+            watches.erase(it);
+            return;
+        }
+
+        const bool is_dir = (ev.mask & IN_ISDIR) != 0u;
+        if (ev.len == 0u || name[0] == '\0')
+        {
+            // The event is about the watched directory itself. Only changes of the root are reported here,
+            // changes of other directories are reported by their parents.
+            if (it->second.empty())
+            {
+                if ((ev.mask & (IN_DELETE_SELF | IN_MOVE_SELF)) != 0u)
+                    queue.push(watch_event_kind::removed, root);
+                else if ((ev.mask & IN_ATTRIB) != 0u)
+                    queue.push(watch_event_kind::modified, root);
+            }
+            return;
+        }
+
+        path rel(it->second);
+        rel /= name;
+
+        if ((ev.mask & IN_CREATE) != 0u)
+        {
+            queue.push(watch_event_kind::created, full_path(rel));
+            if (is_dir && is_recursive())
+                add_new_tree(rel);
+        }
+        else if ((ev.mask & IN_DELETE) != 0u)
+        {
+            queue.push(watch_event_kind::removed, full_path(rel));
+        }
+        else if ((ev.mask & IN_MOVED_FROM) != 0u)
+        {
+            moves.push_back(pending_move(ev.cookie, is_dir, rel));
+        }
+        else if ((ev.mask & IN_MOVED_TO) != 0u)
+        {
+            for (std::vector< pending_move >::iterator m = moves.begin(), end = moves.end(); m != end; ++m)
+            {
+                if (m->cookie == ev.cookie)
+                {
+                    queue.push_rename(full_path(rel), full_path(m->source));
+                    if (is_dir && is_recursive())
+                        rename_tree(m->source, rel);
+                    moves.erase(m);
+                    return;
+                }
+            }
+
+            // The file was moved from outside the watched tree
+            queue.push(watch_event_kind::created, full_path(rel));
+            if (is_dir && is_recursive())
+                add_new_tree(rel);
+        }
+        else if ((ev.mask & (IN_MODIFY | IN_ATTRIB)) != 0u)
+        {
+            queue.push(watch_event_kind::modified, full_path(rel));
+        }
+    }
+
+    void interrupt() BOOST_NOEXCEPT
+    {
+        intr.signal();
+    }
+};
+
+#elif defined(BOOST_POSIX_API)
+
+//! Directory watcher implementation that periodically scans the watched tree
+struct directory_watcher::implementation
+{
+    //! Interval between scans, in milliseconds
+    static BOOST_CONSTEXPR_OR_CONST unsigned int scan_interval_ms = 500u;
+
+    //! Properties of a file that are compared between scans to detect modifications
+    struct file_info
+    {
+        mode_t mode;
+        ino_t ino;
+        off_t size;
+        std::time_t mtime;
+        long mtime_nsec;
+    };
+
+    typedef std::map< path::string_type, file_info > snapshot;
+
+    path root;
+    unsigned int options;
+    event_queue queue;
+    interrupt_pipe intr;
+    //! Results of the last scan, relative to the root
+    snapshot files;
+
+    implementation(path const& p, unsigned int opts, std::size_t capacity) :
+        root(p),
+        options(opts),
+        queue(capacity)
+    {
+    }
+
+    bool is_recursive() const BOOST_NOEXCEPT { return (options & static_cast< unsigned int >(watch_options::recursive)) != 0u; }
+
+    path full_path(path::string_type const& rel) const { return rel.empty() ? root : root / rel; }
+
+    //! Initializes the watcher. Returns zero or an error code.
+    int init()
+    {
+        int err = intr.init();
+        if (BOOST_UNLIKELY(err != 0))
+            return err;
+
+        struct ::stat st;
+        if (BOOST_UNLIKELY(::stat(root.c_str(), &st) < 0))
+            return errno;
+        if (BOOST_UNLIKELY(!S_ISDIR(st.st_mode)))
+            return ENOTDIR;
+
+        scan(path(), files);
+        return 0;
+    }
+
+    //! Adds the files in the directory \a rel to \a snap
+    void scan(path const& rel, snapshot& snap)
+    {
+        system::error_code ec;
+        for (directory_iterator it(full_path(rel.native()), directory_options::skip_permission_denied, ec), end; !ec && it != end; it.increment(ec))
+        {
+            path child(rel);
+            child /= it->path().filename();
+
+            struct ::stat st;
+            if (::lstat(it->path().c_str(), &st) < 0)
+                continue;
+
+            file_info info;
+            info.mode = st.st_mode;
+            info.ino = st.st_ino;
+            info.size = st.st_size;
+            info.mtime = st.st_mtime;
+#if defined(BOOST_FILESYSTEM_STAT_ST_MTIMENSEC)
+            info.mtime_nsec = static_cast< long >(st.BOOST_FILESYSTEM_STAT_ST_MTIMENSEC);
+#else
+            info.mtime_nsec = 0;
+#endif
+            snap[child.native()] = info;
+
+            if (S_ISDIR(st.st_mode) && is_recursive())
+                scan(child, snap);
+        }
+    }
+
+    static bool is_modified(file_info const& left, file_info const& right) BOOST_NOEXCEPT
+    {
+        return left.mode != right.mode || left.ino != right.ino || left.size != right.size || left.mtime != right.mtime || left.mtime_nsec != right.mtime_nsec;
+    }
+
+    //! Waits for the next scan and queues events. Returns zero or an error code.
+    int poll_changes(unsigned int timeout_ms, bool& interrupted)
+    {
+        if (timeout_ms > 0u)
+        {
+            bool ready = false;
+            int err = wait_for_input(-1, intr, timeout_ms < scan_interval_ms ? timeout_ms : scan_interval_ms, ready, interrupted);
+            if (err != 0)
+                return err;
+        }
+
+        snapshot new_files;
+        scan(path(), new_files);
+
+        snapshot::const_iterator old_it = files.begin(), old_end = files.end();
+        snapshot::const_iterator new_it = new_files.begin(), new_end = new_files.end();
+        while (old_it != old_end || new_it != new_end)
+        {
+            if (new_it == new_end || (old_it != old_end && old_it->first < new_it->first))
+            {
+                queue.push(watch_event_kind::removed, full_path(old_it->first));
+                ++old_it;
+            }
+            else if (old_it == old_end || new_it->first < old_it->first)
+            {
+                queue.push(watch_event_kind::created, full_path(new_it->first));
+                ++new_it;
+            }
+            else
+            {
+                if (is_modified(old_it->second, new_it->second))
+                    queue.push(watch_event_kind::modified, full_path(new_it->first));
+                ++old_it;
+                ++new_it;
+            }
+        }
+
+        files.swap(new_files);
+        return 0;
+    }
+
+    void interrupt() BOOST_NOEXCEPT
+    {
+        intr.signal();
+    }
+};
+
+#else // defined(BOOST_POSIX_API)
+
+//! Directory watcher implementation based on ReadDirectoryChangesW
+struct directory_watcher::implementation
+{
+    path root;
+    unsigned int options;
+    event_queue queue;
+    detail::handle_wrapper dir;
+    detail::handle_wrapper io_event;
+    detail::handle_wrapper interrupt_event;
+    OVERLAPPED overlapped;
+    //! Indicates that a ReadDirectoryChangesW request is in progress
+    bool pending;
+    //! Indicates that \c rename_source contains the old name of a renamed file, for which the new name was not received yet
+    bool has_rename_source;
+    path rename_source;
+    //! Buffer for reading notifications, must be DWORD-aligned
+    DWORD buffer[16384];
+
+    implementation(path const& p, unsigned int opts, std::size_t capacity) :
+        root(p),
+        options(opts),
+        queue(capacity),
+        pending(false),
+        has_rename_source(false)
+    {
+        std::memset(&overlapped, 0, sizeof(overlapped));
+    }
+
+    ~implementation() BOOST_NOEXCEPT
+    {
+        if (pending)
+        {
+            // Closing the handle cancels the request. Wait for it to complete before releasing the buffer.
+            ::CloseHandle(dir.handle);
+            dir.handle = INVALID_HANDLE_VALUE;
+            ::WaitForSingleObject(io_event.handle, INFINITE);
+        }
+    }
+
+    //! Initializes the watcher. Returns zero or an error code.
+    DWORD init()
+    {
+        io_event.handle = ::CreateEventW(NULL, TRUE, FALSE, NULL);
+        if (BOOST_UNLIKELY(io_event.handle == NULL))
+        {
+            io_event.handle = INVALID_HANDLE_VALUE;
+            return ::GetLastError();
+        }
+
+        interrupt_event.handle = ::CreateEventW(NULL, FALSE, FALSE, NULL);
+        if (BOOST_UNLIKELY(interrupt_event.handle == NULL))
+        {
+            interrupt_event.handle = INVALID_HANDLE_VALUE;
+            return ::GetLastError();
+        }
+
+        dir.handle = detail::create_file_handle(
+            root,
+            FILE_LIST_DIRECTORY,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL,
+            OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED);
+        if (BOOST_UNLIKELY(dir.handle == INVALID_HANDLE_VALUE))
+            return ::GetLastError();
+
+        return start_read();
+    }
+
+    //! Starts reading notifications. Returns zero or an error code.
+    DWORD start_read()
+    {
+        std::memset(&overlapped, 0, sizeof(overlapped));
+        overlapped.hEvent = io_event.handle;
+
+        const DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_ATTRIBUTES | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+        const BOOL recursive = (options & static_cast< unsigned int >(watch_options::recursive)) != 0u;
+        if (BOOST_UNLIKELY(!::ReadDirectoryChangesW(dir.handle, buffer, sizeof(buffer), recursive, filter, NULL, &overlapped, NULL)))
+            return ::GetLastError();
+
+        pending = true;
+        return 0u;
+    }
+
+    //! Waits for changes and queues events. Returns zero or an error code.
+    DWORD poll_changes(unsigned int timeout_ms, bool& interrupted)
+    {
+        HANDLE handles[2] = { io_event.handle, interrupt_event.handle };
+        const DWORD res = ::WaitForMultipleObjects(2u, handles, FALSE, timeout_ms == directory_watcher::infinite_timeout ? INFINITE : static_cast< DWORD >(timeout_ms));
+        switch (res)
+        {
+        case WAIT_OBJECT_0:
+            {
+                pending = false;
+                DWORD size = 0u;
+                if (!::GetOverlappedResult(dir.handle, &overlapped, &size, FALSE))
+                {
+                    const DWORD err = ::GetLastError();
+                    if (err != ERROR_NOTIFY_ENUM_DIR)
+                        return err;
+                    size = 0u;
+                }
+
+                // Zero size means the notifications did not fit in the buffer
+                if (size == 0u)
+                    queue.push_overflow();
+                else
+                    on_notifications(size);
+
+                return start_read();
+            }
+
+        case WAIT_OBJECT_0 + 1u:
+            interrupted = true;
+            return 0u;
+
+        case WAIT_TIMEOUT:
+            return 0u;
+
+        default:
+            return ::GetLastError();
+        }
+    }
+
+    void on_notifications(DWORD size)
+    {
+        const unsigned char* p = reinterpret_cast< const unsigned char* >(buffer);
+        const unsigned char* const end = p + size;
+        while (p < end)
+        {
+            const FILE_NOTIFY_INFORMATION* info = reinterpret_cast< const FILE_NOTIFY_INFORMATION* >(p);
+            const path target(root / path(info->FileName, info->FileName + info->FileNameLength / sizeof(WCHAR)));
+            switch (info->Action)
+            {
+            case FILE_ACTION_ADDED:
+                queue.push(watch_event_kind::created, target);
+                break;
+
+            case FILE_ACTION_REMOVED:
+                queue.push(watch_event_kind::removed, target);
+                break;
+
+            case FILE_ACTION_MODIFIED:
+                queue.push(watch_event_kind::modified, target);
+                break;
+
+            case FILE_ACTION_RENAMED_OLD_NAME:
+                rename_source = target;
+                has_rename_source = true;
+                break;
+
+            case FILE_ACTION_RENAMED_NEW_NAME:
+                if (has_rename_source)
+                    queue.push_rename(target, rename_source);
+                else
+                    queue.push(watch_event_kind::created, target);
+                has_rename_source = false;
+                break;
+
+            default:
+                break;
+            }
+
+            if (info->NextEntryOffset == 0u)
+                break;
+            p += info->NextEntryOffset;
+        }
+    }
+
+    void interrupt() BOOST_NOEXCEPT
+    {
+        ::SetEvent(interrupt_event.handle);
+    }
+};
+
+#endif // defined(BOOST_FILESYSTEM_USE_INOTIFY)
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                       class directory_watcher implementation                         //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+#if defined(BOOST_NO_CXX17_INLINE_VARIABLES)
+BOOST_CONSTEXPR_OR_CONST std::size_t directory_watcher::default_capacity;
+BOOST_CONSTEXPR_OR_CONST unsigned int directory_watcher::infinite_timeout;
+#endif
+
+BOOST_FILESYSTEM_DECL void directory_watcher::close() BOOST_NOEXCEPT
+{
+    delete m_impl;
+    m_impl = NULL;
+}
+
+BOOST_FILESYSTEM_DECL path const& directory_watcher::watched_path() const BOOST_NOEXCEPT
+{
+    static const path empty_path;
+    return m_impl ? m_impl->root : empty_path;
+}
+
+BOOST_FILESYSTEM_DECL void directory_watcher::open_impl(path const& p, unsigned int options, std::size_t capacity, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    close();
+
+    implementation* impl = new (std::nothrow) implementation(p, options, capacity);
+    if (BOOST_UNLIKELY(!impl))
+    {
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(std::bad_alloc());
+        *ec = system::errc::make_error_code(system::errc::not_enough_memory);
+        return;
+    }
+
+    err_t err;
+    try
+    {
+        err = impl->init();
+    }
+    catch (std::bad_alloc&)
+    {
+        delete impl;
+        if (!ec)
+            throw;
+        *ec = system::errc::make_error_code(system::errc::not_enough_memory);
+        return;
+    }
+
+    if (BOOST_UNLIKELY(err != 0))
+    {
+        delete impl;
+        emit_error(err, p, ec, "boost::filesystem::directory_watcher::open");
+        return;
+    }
+
+    m_impl = impl;
+}
+
+BOOST_FILESYSTEM_DECL std::size_t directory_watcher::read_events_impl(std::vector< watch_event >& events, unsigned int timeout_ms, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    if (BOOST_UNLIKELY(!m_impl))
+    {
+#if defined(BOOST_POSIX_API)
+        emit_error(EBADF, ec, "boost::filesystem::directory_watcher::read_events");
+#else
+        emit_error(ERROR_INVALID_HANDLE, ec, "boost::filesystem::directory_watcher::read_events");
+#endif
+        return 0u;
+    }
+
+    const bool infinite = timeout_ms == infinite_timeout;
+    const boost::uint64_t start_time = infinite ? 0u : get_current_time_ms();
+
+    // If there are events queued already, only collect the changes that are immediately available
+    unsigned int wait_ms = m_impl->queue.empty() ? timeout_ms : 0u;
+    while (true)
+    {
+        bool interrupted = false;
+        const err_t err = m_impl->poll_changes(wait_ms, interrupted);
+        if (BOOST_UNLIKELY(err != 0))
+        {
+            emit_error(err, m_impl->root, ec, "boost::filesystem::directory_watcher::read_events");
+            return 0u;
+        }
+
+        if (interrupted || !m_impl->queue.empty() || wait_ms == 0u)
+            break;
+
+        if (!infinite)
+        {
+            const boost::uint64_t elapsed = get_current_time_ms() - start_time;
+            if (elapsed >= timeout_ms)
+                break;
+            wait_ms = timeout_ms - static_cast< unsigned int >(elapsed);
+        }
+    }
+
+    return m_impl->queue.pop_all(events);
+}
+
+BOOST_FILESYSTEM_DECL void directory_watcher::interrupt() BOOST_NOEXCEPT
+{
+    if (m_impl)
+        m_impl->interrupt();
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
@@ -88,9 +88,15 @@ typedef boost::winapi::DWORD_ err_t;
 #if !defined(STATUS_ACCESS_DENIED)
 #define STATUS_ACCESS_DENIED ((boost::winapi::NTSTATUS_)0xC0000022l)
 #endif
+#if !defined(STATUS_BUFFER_TOO_SMALL)
+#define STATUS_BUFFER_TOO_SMALL ((boost::winapi::NTSTATUS_)0xC0000023l)
+#endif
 #if !defined(STATUS_OBJECT_NAME_NOT_FOUND)
 #define STATUS_OBJECT_NAME_NOT_FOUND ((boost::winapi::NTSTATUS_)0xC0000034l)
 #endif
+#if !defined(STATUS_OBJECT_NAME_COLLISION)
+#define STATUS_OBJECT_NAME_COLLISION ((boost::winapi::NTSTATUS_)0xC0000035l)
+#endif
 #if !defined(STATUS_OBJECT_PATH_NOT_FOUND)
 #define STATUS_OBJECT_PATH_NOT_FOUND ((boost::winapi::NTSTATUS_)0xC000003Al)
 #endif
@@ -126,6 +132,8 @@ inline boost::winapi::DWORD_ translate_ntstatus(boost::winapi::NTSTATUS_ status)
         return boost::winapi::ERROR_OUTOFMEMORY_;
     case static_cast< boost::winapi::ULONG_ >(STATUS_BUFFER_OVERFLOW):
         return boost::winapi::ERROR_BUFFER_OVERFLOW_;
+    case static_cast< boost::winapi::ULONG_ >(STATUS_BUFFER_TOO_SMALL):
+        return boost::winapi::ERROR_INSUFFICIENT_BUFFER_;
     case static_cast< boost::winapi::ULONG_ >(STATUS_INVALID_HANDLE):
         return boost::winapi::ERROR_INVALID_HANDLE_;
     case static_cast< boost::winapi::ULONG_ >(STATUS_INVALID_PARAMETER):
@@ -139,6 +147,8 @@ inline boost::winapi::DWORD_ translate_ntstatus(boost::winapi::NTSTATUS_ status)
     case static_cast< boost::winapi::ULONG_ >(STATUS_OBJECT_NAME_NOT_FOUND):
     case static_cast< boost::winapi::ULONG_ >(STATUS_OBJECT_PATH_NOT_FOUND):
         return boost::winapi::ERROR_FILE_NOT_FOUND_;
+    case static_cast< boost::winapi::ULONG_ >(STATUS_OBJECT_NAME_COLLISION):
+        return boost::winapi::ERROR_ALREADY_EXISTS_;
     case static_cast< boost::winapi::ULONG_ >(STATUS_ACCESS_DENIED):
         return boost::winapi::ERROR_ACCESS_DENIED_;
     case static_cast< boost::winapi::ULONG_ >(STATUS_BAD_NETWORK_PATH):
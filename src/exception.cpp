@@ -27,32 +27,21 @@ namespace filesystem {
 BOOST_FILESYSTEM_DECL filesystem_error::filesystem_error(const char* what_arg, system::error_code ec) :
     system::system_error(ec, what_arg)
 {
-    try
-    {
-        m_imp_ptr.reset(new impl());
-    }
-    catch (...)
-    {
-        m_imp_ptr.reset();
-    }
+    // Without paths the error description is the same as the base class provides, no need to allocate the implementation
 }
 
 BOOST_FILESYSTEM_DECL filesystem_error::filesystem_error(std::string const& what_arg, system::error_code ec) :
     system::system_error(ec, what_arg)
 {
-    try
-    {
-        m_imp_ptr.reset(new impl());
-    }
-    catch (...)
-    {
-        m_imp_ptr.reset();
-    }
+    // Without paths the error description is the same as the base class provides, no need to allocate the implementation
 }
 
 BOOST_FILESYSTEM_DECL filesystem_error::filesystem_error(const char* what_arg, path const& path1_arg, system::error_code ec) :
     system::system_error(ec, what_arg)
 {
+    if (path1_arg.empty())
+        return;
+
     try
     {
         m_imp_ptr.reset(new impl(path1_arg));
@@ -66,6 +55,9 @@ BOOST_FILESYSTEM_DECL filesystem_error::filesystem_error(const char* what_arg, p
 BOOST_FILESYSTEM_DECL filesystem_error::filesystem_error(std::string const& what_arg, path const& path1_arg, system::error_code ec) :
     system::system_error(ec, what_arg)
 {
+    if (path1_arg.empty())
+        return;
+
     try
     {
         m_imp_ptr.reset(new impl(path1_arg));
@@ -79,6 +71,9 @@ BOOST_FILESYSTEM_DECL filesystem_error::filesystem_error(std::string const& what
 BOOST_FILESYSTEM_DECL filesystem_error::filesystem_error(const char* what_arg, path const& path1_arg, path const& path2_arg, system::error_code ec) :
     system::system_error(ec, what_arg)
 {
+    if (path1_arg.empty() && path2_arg.empty())
+        return;
+
     try
     {
         m_imp_ptr.reset(new impl(path1_arg, path2_arg));
@@ -92,6 +87,9 @@ BOOST_FILESYSTEM_DECL filesystem_error::filesystem_error(const char* what_arg, p
 BOOST_FILESYSTEM_DECL filesystem_error::filesystem_error(std::string const& what_arg, path const& path1_arg, path const& path2_arg, system::error_code ec) :
     system::system_error(ec, what_arg)
 {
+    if (path1_arg.empty() && path2_arg.empty())
+        return;
+
     try
     {
         m_imp_ptr.reset(new impl(path1_arg, path2_arg));
@@ -0,0 +1,371 @@
+//  executor.cpp  ----------------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/executor.hpp>
+
+#include <cstddef>
+
+#include "thread_tools.hpp"
+#include "atomic_tools.hpp"
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <utility>
+#endif
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+namespace detail {
+
+namespace {
+
+//! The default executor, which starts a new thread for every task
+class thread_executor :
+    public executor
+{
+public:
+    unsigned int concurrency() const BOOST_NOEXCEPT BOOST_OVERRIDE
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        unsigned int n = std::thread::hardware_concurrency();
+        return n > 0u ? n : 1u;
+#else
+        return 1u;
+#endif
+    }
+
+    bool post(task_function* fn, void* context) BOOST_NOEXCEPT BOOST_OVERRIDE
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        try
+        {
+            std::thread(fn, context).detach();
+            return true;
+        }
+        catch (...)
+        {
+        }
+#else
+        (void)fn;
+        (void)context;
+#endif
+        return false;
+    }
+};
+
+//! The executor set by the user, or \c NULL if the default executor is used
+executor* g_executor = NULL;
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+class task_group;
+
+//! A worker of a parallel operation posted to an executor
+struct task_slot
+{
+    task_group* group;
+    unsigned int index;
+    //! Indicates that the worker has been started, either by the executor or by the calling thread
+    std::atomic< bool > claimed;
+
+    task_slot() BOOST_NOEXCEPT : group(NULL), index(0u), claimed(false) {}
+};
+
+/*!
+ * Shared state of the workers of a parallel operation posted to an executor.
+ *
+ * The state is reference counted, as the executor may start the posted tasks after the operation has completed.
+ * The workers that were started by the executor are waited for by the calling thread.
+ */
+class task_group
+{
+private:
+    std::atomic< unsigned int > m_ref_count;
+    void (*const m_fn)(void*, unsigned int);
+    void* const m_context;
+    const unsigned int m_count;
+    std::unique_ptr< task_slot[] > m_slots;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    //! Number of workers started by the executor that have completed
+    unsigned int m_completed;
+
+public:
+    task_group(unsigned int count, void (*fn)(void*, unsigned int), void* context) :
+        m_ref_count(1u),
+        m_fn(fn),
+        m_context(context),
+        m_count(count),
+        m_slots(new task_slot[count]),
+        m_completed(0u)
+    {
+        for (unsigned int i = 0u; i < count; ++i)
+        {
+            m_slots[i].group = this;
+            m_slots[i].index = i;
+        }
+    }
+
+    BOOST_DELETED_FUNCTION(task_group(task_group const&))
+    BOOST_DELETED_FUNCTION(task_group& operator=(task_group const&))
+
+    //! Posts the workers, except the first one, to the executor
+    void post(executor& ex) BOOST_NOEXCEPT
+    {
+        for (unsigned int i = 1u; i < m_count; ++i)
+        {
+            m_ref_count.fetch_add(1u, std::memory_order_relaxed);
+            if (!ex.post(&task_group::run_posted, &m_slots[i]))
+                release();
+        }
+    }
+
+    //! Runs the first worker and the workers not started by the executor and waits for the workers started by the executor
+    void run_and_wait() BOOST_NOEXCEPT
+    {
+        m_slots[0].claimed.store(true, std::memory_order_relaxed);
+        m_fn(m_context, 0u);
+
+        unsigned int started = 0u;
+        for (unsigned int i = 1u; i < m_count; ++i)
+        {
+            if (!m_slots[i].claimed.exchange(true, std::memory_order_acq_rel))
+                m_fn(m_context, i);
+            else
+                ++started;
+        }
+
+        std::unique_lock< std::mutex > lock(m_mutex);
+        while (m_completed < started)
+            m_cond.wait(lock);
+    }
+
+    void release() BOOST_NOEXCEPT
+    {
+        if (m_ref_count.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+            delete this;
+    }
+
+private:
+    //! Task function posted to the executor
+    static void run_posted(void* context)
+    {
+        task_slot* slot = static_cast< task_slot* >(context);
+        task_group* group = slot->group;
+        if (!slot->claimed.exchange(true, std::memory_order_acq_rel))
+        {
+            group->m_fn(group->m_context, slot->index);
+
+            std::lock_guard< std::mutex > lock(group->m_mutex);
+            ++group->m_completed;
+            group->m_cond.notify_all();
+        }
+
+        group->release();
+    }
+};
+
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+} // namespace
+
+executor& get_default_executor() BOOST_NOEXCEPT
+{
+    static thread_executor ex;
+    return ex;
+}
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+void run_tasks(executor& ex, unsigned int count, void (*fn)(void*, unsigned int), void* context) BOOST_NOEXCEPT
+{
+    if (count > 1u)
+    {
+        task_group* group = NULL;
+        try
+        {
+            group = new task_group(count, fn, context);
+        }
+        catch (...)
+        {
+        }
+
+        if (BOOST_LIKELY(group != NULL))
+        {
+            group->post(ex);
+            group->run_and_wait();
+            group->release();
+            return;
+        }
+    }
+
+    // Run the workers sequentially, they must tolerate being run after the other workers have completed
+    for (unsigned int i = 0u; i < count; ++i)
+        fn(context, i);
+}
+
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+} // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                               thread_pool_executor                                   //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+struct thread_pool_executor::implementation
+{
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque< std::pair< task_function*, void* > > tasks;
+    std::vector< std::thread > threads;
+    bool stopping;
+
+    implementation() : stopping(false) {}
+
+    //! Worker thread function
+    void run() BOOST_NOEXCEPT
+    {
+        std::unique_lock< std::mutex > lock(mutex);
+        while (true)
+        {
+            if (!tasks.empty())
+            {
+                std::pair< task_function*, void* > task = tasks.front();
+                tasks.pop_front();
+                lock.unlock();
+                task.first(task.second);
+                lock.lock();
+                continue;
+            }
+
+            if (stopping)
+                break;
+
+            cond.wait(lock);
+        }
+    }
+};
+
+BOOST_FILESYSTEM_DECL thread_pool_executor::thread_pool_executor(unsigned int thread_count) :
+    m_impl(new implementation())
+{
+    thread_count = detail::get_thread_count(thread_count, &detail::get_default_executor());
+    try
+    {
+        m_impl->threads.reserve(thread_count);
+        for (unsigned int i = 0u; i < thread_count; ++i)
+            m_impl->threads.push_back(std::thread(&implementation::run, m_impl));
+    }
+    catch (...)
+    {
+        // Proceed with the threads that we managed to start
+        if (m_impl->threads.empty())
+        {
+            delete m_impl;
+            throw;
+        }
+    }
+}
+
+BOOST_FILESYSTEM_DECL thread_pool_executor::~thread_pool_executor()
+{
+    {
+        std::lock_guard< std::mutex > lock(m_impl->mutex);
+        m_impl->stopping = true;
+        m_impl->cond.notify_all();
+    }
+
+    for (std::size_t i = 0u, n = m_impl->threads.size(); i < n; ++i)
+        m_impl->threads[i].join();
+
+    delete m_impl;
+}
+
+BOOST_FILESYSTEM_DECL unsigned int thread_pool_executor::concurrency() const BOOST_NOEXCEPT
+{
+    return static_cast< unsigned int >(m_impl->threads.size());
+}
+
+BOOST_FILESYSTEM_DECL bool thread_pool_executor::post(task_function* fn, void* context) BOOST_NOEXCEPT
+{
+    try
+    {
+        std::lock_guard< std::mutex > lock(m_impl->mutex);
+        m_impl->tasks.push_back(std::pair< task_function*, void* >(fn, context));
+        m_impl->cond.notify_one();
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+#else // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+struct thread_pool_executor::implementation
+{
+};
+
+BOOST_FILESYSTEM_DECL thread_pool_executor::thread_pool_executor(unsigned int) :
+    m_impl(NULL)
+{
+}
+
+BOOST_FILESYSTEM_DECL thread_pool_executor::~thread_pool_executor()
+{
+}
+
+BOOST_FILESYSTEM_DECL unsigned int thread_pool_executor::concurrency() const BOOST_NOEXCEPT
+{
+    return 1u;
+}
+
+BOOST_FILESYSTEM_DECL bool thread_pool_executor::post(task_function*, void*) BOOST_NOEXCEPT
+{
+    return false;
+}
+
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+BOOST_FILESYSTEM_DECL executor* get_executor() BOOST_NOEXCEPT
+{
+    executor* ex = detail::atomic_load_acquire(detail::g_executor);
+    return ex ? ex : &detail::get_default_executor();
+}
+
+BOOST_FILESYSTEM_DECL executor* set_executor(executor* ex) BOOST_NOEXCEPT
+{
+    executor* prev = detail::atomic_exchange_acq_rel(detail::g_executor, ex);
+    return prev ? prev : &detail::get_default_executor();
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
@@ -0,0 +1,97 @@
+//  fstream.cpp  -----------------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#if defined(BOOST_POSIX_API)
+
+#include <sys/types.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#else // BOOST_WINDOWS_API
+
+#include <io.h>
+#include <windows.h>
+
+#endif // BOOST_WINDOWS_API
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+BOOST_FILESYSTEM_DECL stream_native_handle_type stream_native_handle(int fd) BOOST_NOEXCEPT
+{
+#if defined(BOOST_POSIX_API)
+    return fd;
+#else
+    return reinterpret_cast< stream_native_handle_type >(::_get_osfhandle(fd));
+#endif
+}
+
+BOOST_FILESYSTEM_DECL stream_native_handle_type invalid_stream_native_handle() BOOST_NOEXCEPT
+{
+#if defined(BOOST_POSIX_API)
+    return -1;
+#else
+    return INVALID_HANDLE_VALUE;
+#endif
+}
+
+BOOST_FILESYSTEM_DECL void apply_stream_options(int fd, unsigned int options) BOOST_NOEXCEPT
+{
+#if defined(BOOST_POSIX_API)
+
+#if defined(POSIX_FADV_SEQUENTIAL) && defined(POSIX_FADV_RANDOM) && defined(POSIX_FADV_WILLNEED) && !defined(__APPLE__)
+    if ((options & static_cast< unsigned int >(stream_options::sequential)) != 0u)
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    else if ((options & static_cast< unsigned int >(stream_options::random)) != 0u)
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_RANDOM);
+
+    if ((options & static_cast< unsigned int >(stream_options::will_need)) != 0u)
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+#elif defined(F_RDAHEAD)
+    // Mac OS and FreeBSD only allow to enable or disable read-ahead
+    if ((options & static_cast< unsigned int >(stream_options::random)) != 0u)
+        ::fcntl(fd, F_RDAHEAD, 0);
+    else if ((options & static_cast< unsigned int >(stream_options::sequential | stream_options::will_need)) != 0u)
+        ::fcntl(fd, F_RDAHEAD, 1);
+#endif
+
+#if defined(O_NOATIME)
+    if ((options & static_cast< unsigned int >(stream_options::no_access_time)) != 0u)
+    {
+        // Changing O_NOATIME fails with EPERM if the process does not own the file, in which case the flag is not applied
+        const int flags = ::fcntl(fd, F_GETFL);
+        if (flags >= 0)
+            ::fcntl(fd, F_SETFL, flags | O_NOATIME);
+    }
+#endif
+
+#else // defined(BOOST_POSIX_API)
+
+    // Windows only supports access pattern hints when the file is opened, which is performed by the standard library
+    (void)fd;
+    (void)options;
+
+#endif // defined(BOOST_POSIX_API)
+}
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
@@ -0,0 +1,590 @@
+//  glob.cpp  --------------------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/glob.hpp>
+
+#include <cstddef>
+#include <new> // std::bad_alloc
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <boost/system/error_code.hpp>
+#include <boost/smart_ptr/intrusive_ptr.hpp>
+
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+namespace {
+
+typedef path::value_type char_type;
+typedef path::string_type string_type;
+//! Set of states of the pattern matcher. Each state is an index of the pattern element that is to be matched next.
+typedef std::vector< std::size_t > glob_states;
+
+BOOST_CONSTEXPR_OR_CONST char_type star = static_cast< char_type >('*');
+BOOST_CONSTEXPR_OR_CONST char_type question_mark = static_cast< char_type >('?');
+BOOST_CONSTEXPR_OR_CONST char_type open_bracket = static_cast< char_type >('[');
+BOOST_CONSTEXPR_OR_CONST char_type close_bracket = static_cast< char_type >(']');
+BOOST_CONSTEXPR_OR_CONST char_type open_brace = static_cast< char_type >('{');
+BOOST_CONSTEXPR_OR_CONST char_type close_brace = static_cast< char_type >('}');
+BOOST_CONSTEXPR_OR_CONST char_type comma = static_cast< char_type >(',');
+BOOST_CONSTEXPR_OR_CONST char_type exclamation_mark = static_cast< char_type >('!');
+BOOST_CONSTEXPR_OR_CONST char_type caret = static_cast< char_type >('^');
+BOOST_CONSTEXPR_OR_CONST char_type dash = static_cast< char_type >('-');
+BOOST_CONSTEXPR_OR_CONST char_type backslash = static_cast< char_type >('\\');
+
+//! Returns \c true if \a c is a directory separator in patterns
+inline bool is_separator(char_type c) BOOST_NOEXCEPT
+{
+#if defined(BOOST_WINDOWS_API)
+    return c == static_cast< char_type >('/') || c == backslash;
+#else
+    return c == static_cast< char_type >('/');
+#endif
+}
+
+//! Returns \c true if \a c escapes the next character in patterns. Backslash is a directory separator on Windows, so escaping is only supported on POSIX systems.
+inline bool is_escape(char_type c) BOOST_NOEXCEPT
+{
+#if defined(BOOST_WINDOWS_API)
+    return false;
+#else
+    return c == backslash;
+#endif
+}
+
+//! Expands the brace sets in \a pattern and appends the resulting alternatives to \a alternatives
+void expand_braces(string_type const& pattern, std::vector< string_type >& alternatives)
+{
+    const std::size_t size = pattern.size();
+    std::vector< std::size_t > commas;
+    for (std::size_t open = 0u; open < size; ++open)
+    {
+        const char_type c = pattern[open];
+        if (is_escape(c))
+        {
+            ++open;
+            continue;
+        }
+
+        if (c != open_brace)
+            continue;
+
+        // Find the matching closing brace and the commas that separate the alternatives of this brace set
+        commas.clear();
+        std::size_t close = open + 1u;
+        for (unsigned int depth = 0u; close < size; ++close)
+        {
+            const char_type d = pattern[close];
+            if (is_escape(d))
+                ++close;
+            else if (d == open_brace)
+                ++depth;
+            else if (d == close_brace)
+            {
+                if (depth == 0u)
+                    break;
+                --depth;
+            }
+            else if (d == comma && depth == 0u)
+                commas.push_back(close);
+        }
+
+        // Unbalanced braces and braces without commas are treated literally
+        if (close >= size || commas.empty())
+            continue;
+
+        commas.push_back(close);
+        std::size_t start = open + 1u;
+        for (std::size_t i = 0u, n = commas.size(); i < n; ++i)
+        {
+            string_type alternative(pattern, 0u, open);
+            alternative.append(pattern, start, commas[i] - start);
+            alternative.append(pattern, close + 1u, string_type::npos);
+            expand_braces(alternative, alternatives);
+            start = commas[i] + 1u;
+        }
+
+        return;
+    }
+
+    alternatives.push_back(pattern);
+}
+
+//! Returns \c true if \a c is a wildcard character
+inline bool is_wildcard(char_type c) BOOST_NOEXCEPT
+{
+    return c == star || c == question_mark || c == open_bracket;
+}
+
+//! Appends the element \a text of a pattern alternative to \a elements, unless it can be omitted
+void add_element(string_type const& text, std::vector< detail::glob_element >& elements)
+{
+    if (text.empty() || (text.size() == 1u && text[0] == path::dot))
+        return;
+
+    if (text.size() == 2u && text[0] == star && text[1] == star)
+    {
+        // Consecutive globstars are equivalent to one
+        if (elements.empty() || elements.back().kind != detail::glob_element::globstar)
+            elements.push_back(detail::glob_element(detail::glob_element::globstar));
+        return;
+    }
+
+    string_type literal;
+    for (std::size_t i = 0u, n = text.size(); i < n; ++i)
+    {
+        char_type c = text[i];
+        if (is_escape(c) && (i + 1u) < n)
+            c = text[++i];
+        else if (is_wildcard(c))
+        {
+            elements.push_back(detail::glob_element(detail::glob_element::wildcard, text));
+            return;
+        }
+
+        literal.push_back(c);
+    }
+
+    elements.push_back(detail::glob_element(detail::glob_element::literal, literal));
+}
+
+//! Matches the bracket expression starting at \a p against \a c. Returns the pointer past the expression or \c NULL if the expression is not terminated.
+const char_type* match_bracket(const char_type* p, const char_type* pend, char_type c, bool& matched) BOOST_NOEXCEPT
+{
+    ++p; // skip the opening bracket
+    bool negated = false;
+    if (p < pend && (*p == exclamation_mark || *p == caret))
+    {
+        negated = true;
+        ++p;
+    }
+
+    matched = false;
+    bool first = true;
+    while (p < pend)
+    {
+        char_type low = *p;
+        if (low == close_bracket && !first)
+        {
+            matched = matched != negated;
+            return p + 1;
+        }
+
+        first = false;
+        if (is_escape(low) && (p + 1) < pend)
+            low = *++p;
+        ++p;
+
+        char_type high = low;
+        if ((p + 1) < pend && *p == dash && p[1] != close_bracket)
+        {
+            high = p[1];
+            p += 2;
+            if (is_escape(high) && p < pend)
+                high = *p++;
+        }
+
+        if (low <= c && c <= high)
+            matched = true;
+    }
+
+    return NULL;
+}
+
+//! Matches name \a name against wildcard element \a pattern
+bool match_wildcard(string_type const& pattern, const char_type* name, std::size_t size) BOOST_NOEXCEPT
+{
+    const char_type* p = pattern.c_str();
+    const char_type* const pend = p + pattern.size();
+    const char_type* s = name;
+    const char_type* const send = name + size;
+
+    // Wildcards do not match the leading dot
+    if (s < send && *s == path::dot && *p != path::dot && !(is_escape(*p) && p[1] == path::dot))
+        return false;
+
+    // Position of the last star in the pattern and in the name, where to resume matching on mismatch
+    const char_type* star_p = NULL;
+    const char_type* star_s = NULL;
+    while (s < send)
+    {
+        if (p < pend)
+        {
+            char_type c = *p;
+            if (c == star)
+            {
+                while (p < pend && *p == star)
+                    ++p;
+                if (p == pend)
+                    return true;
+                star_p = p;
+                star_s = s;
+                continue;
+            }
+
+            if (c == question_mark)
+            {
+                ++p;
+                ++s;
+                continue;
+            }
+
+            if (c == open_bracket)
+            {
+                bool matched = false;
+                const char_type* end = match_bracket(p, pend, *s, matched);
+                if (end)
+                {
+                    if (matched)
+                    {
+                        p = end;
+                        ++s;
+                        continue;
+                    }
+
+                    goto mismatch;
+                }
+
+                // Unterminated bracket expressions are treated literally
+            }
+
+            if (is_escape(c) && (p + 1) < pend)
+                c = *++p;
+
+            if (c == *s)
+            {
+                ++p;
+                ++s;
+                continue;
+            }
+        }
+
+    mismatch:
+        if (!star_p)
+            return false;
+
+        p = star_p;
+        s = ++star_s;
+    }
+
+    while (p < pend && *p == star)
+        ++p;
+
+    return p == pend;
+}
+
+//! Adds \a state and the states reachable from it without matching a path element to \a states
+void add_state(detail::glob_pattern_impl const& impl, glob_states& states, std::size_t state)
+{
+    while (std::find(states.begin(), states.end(), state) == states.end())
+    {
+        states.push_back(state);
+        if (impl.elements[state].kind != detail::glob_element::globstar)
+            break;
+
+        // Globstar matches zero elements
+        ++state;
+    }
+}
+
+//! Fills \a states with the initial states of the matcher, skipping the first \a skip elements of every alternative
+void make_initial_states(detail::glob_pattern_impl const& impl, std::size_t skip, glob_states& states)
+{
+    states.clear();
+    for (std::size_t i = 0u, n = impl.alternatives.size(); i < n; ++i)
+        add_state(impl, states, impl.alternatives[i] + skip);
+}
+
+//! Matches path element \a name, fills \a to with the resulting states and returns a combination of \c dir_itr_filter::flags
+unsigned int match_element(detail::glob_pattern_impl const& impl, glob_states const& from, const char_type* name, std::size_t size, glob_states& to)
+{
+    to.clear();
+    const bool hidden = size > 0u && name[0] == path::dot;
+    for (std::size_t i = 0u, n = from.size(); i < n; ++i)
+    {
+        const std::size_t state = from[i];
+        detail::glob_element const& elem = impl.elements[state];
+        switch (elem.kind)
+        {
+        case detail::glob_element::literal:
+            if (elem.text.size() == size && string_type::traits_type::compare(elem.text.c_str(), name, size) == 0)
+                add_state(impl, to, state + 1u);
+            break;
+
+        case detail::glob_element::wildcard:
+            if (match_wildcard(elem.text, name, size))
+                add_state(impl, to, state + 1u);
+            break;
+
+        case detail::glob_element::globstar:
+            if (!hidden)
+                add_state(impl, to, state);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    unsigned int flags = 0u;
+    for (std::size_t i = 0u, n = to.size(); i < n; ++i)
+    {
+        if (impl.elements[to[i]].kind == detail::glob_element::end)
+            flags |= detail::dir_itr_filter::produce_entry;
+        else
+            flags |= detail::dir_itr_filter::descend_entry;
+    }
+
+    return flags;
+}
+
+//! Directory iterator filter that matches relative paths of the entries against a glob pattern
+class glob_dir_filter :
+    public detail::dir_itr_filter
+{
+private:
+    boost::intrusive_ptr< const detail::glob_pattern_impl > m_impl;
+    //! Matcher states for the entries of the directory
+    glob_states m_states;
+    //! Matcher states after matching the last filtered entry
+    glob_states m_entry_states;
+
+public:
+    glob_dir_filter(detail::glob_pattern_impl const* impl, glob_states const& states) :
+        m_impl(impl),
+        m_states(states)
+    {
+    }
+
+    unsigned int filter(const path::value_type* name, std::size_t size, file_type) BOOST_OVERRIDE
+    {
+        return match_element(*m_impl, m_states, name, size, m_entry_states);
+    }
+
+    boost::intrusive_ptr< detail::dir_itr_filter > descend() const BOOST_OVERRIDE
+    {
+        return boost::intrusive_ptr< detail::dir_itr_filter >(new glob_dir_filter(m_impl.get(), m_entry_states));
+    }
+};
+
+} // namespace
+
+namespace detail {
+
+BOOST_FILESYSTEM_DECL
+glob_pattern_impl* compile_glob_pattern(path const& pattern)
+{
+    boost::intrusive_ptr< glob_pattern_impl > impl(new glob_pattern_impl());
+    impl->pattern = pattern;
+
+    // The search starts in the directory denoted by the leading elements of the pattern that contain no wildcards and brace sets
+    string_type const& str = pattern.native();
+    std::size_t prefix_size = 0u;
+    for (std::size_t n = str.size(); prefix_size < n; ++prefix_size)
+    {
+        const char_type c = str[prefix_size];
+        if (is_wildcard(c) || c == open_brace || is_escape(c))
+            break;
+    }
+
+    while (prefix_size > 0u && !is_separator(str[prefix_size - 1u]))
+        --prefix_size;
+
+    const path prefix(str.substr(0u, prefix_size));
+    impl->base = prefix.root_path();
+    const path relative_prefix = prefix.relative_path();
+    for (path::iterator it = relative_prefix.begin(), end = relative_prefix.end(); it != end; ++it)
+    {
+        string_type const& elem = it->native();
+        if (elem.empty() || (elem.size() == 1u && elem[0] == path::dot))
+            continue;
+
+        impl->base /= *it;
+        ++impl->base_size;
+    }
+
+    std::vector< string_type > alternatives;
+    expand_braces(str, alternatives);
+
+    for (std::size_t i = 0u, n = alternatives.size(); i < n; ++i)
+    {
+        string_type const& alternative = alternatives[i];
+        impl->alternatives.push_back(impl->elements.size());
+
+        std::size_t pos = path(alternative).root_path().native().size();
+        while (pos < alternative.size())
+        {
+            std::size_t end = pos;
+            while (end < alternative.size() && !is_separator(alternative[end]))
+                ++end;
+            add_element(alternative.substr(pos, end - pos), impl->elements);
+            pos = end + 1u;
+        }
+
+        impl->elements.push_back(detail::glob_element(detail::glob_element::end));
+    }
+
+    return impl.detach();
+}
+
+BOOST_FILESYSTEM_DECL
+bool glob_match(glob_pattern_impl const& impl, path const& p)
+{
+    const path relative = p.relative_path();
+    if (relative.empty())
+        return false;
+
+    glob_states states, next_states;
+    make_initial_states(impl, 0u, states);
+
+    unsigned int flags = 0u;
+    for (path::iterator it = relative.begin(), end = relative.end(); it != end; ++it)
+    {
+        string_type const& elem = it->native();
+        if (elem.empty() || (elem.size() == 1u && elem[0] == path::dot))
+            continue;
+
+        flags = match_element(impl, states, elem.c_str(), elem.size(), next_states);
+        if (flags == 0u)
+            return false;
+
+        states.swap(next_states);
+    }
+
+    return (flags & dir_itr_filter::produce_entry) != 0u;
+}
+
+BOOST_FILESYSTEM_DECL
+void recursive_directory_iterator_construct_glob(recursive_directory_iterator& it, path const& dir_path, glob_pattern const& matcher, unsigned int opts, system::error_code* ec)
+{
+    glob_pattern_impl const* impl = matcher.get_impl();
+    if (!impl)
+    {
+        // Empty pattern matches nothing
+        if (ec)
+            ec->clear();
+        return;
+    }
+
+    boost::intrusive_ptr< dir_itr_filter > filter;
+    try
+    {
+        glob_states states;
+        make_initial_states(*impl, 0u, states);
+        filter = new glob_dir_filter(impl, states);
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return;
+    }
+
+    recursive_directory_iterator_construct_filtered(it, dir_path, opts, filter.get(), ec);
+}
+
+BOOST_FILESYSTEM_DECL
+std::vector< path > glob(path const& pattern, unsigned int opts, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    std::vector< path > result;
+    system::error_code local_ec;
+    const glob_pattern matcher(pattern);
+    glob_pattern_impl const* impl = matcher.get_impl();
+
+    bool is_literal = impl->alternatives.size() == 1u;
+    for (std::size_t i = 0u, n = impl->elements.size(); i < n && is_literal; ++i)
+        is_literal = impl->elements[i].kind == glob_element::literal || impl->elements[i].kind == glob_element::end;
+
+    if (is_literal)
+    {
+        // No wildcards, the pattern only matches the path itself
+        path literal_path(pattern.root_path());
+        for (std::size_t i = 0u, n = impl->elements.size() - 1u; i < n; ++i)
+            literal_path /= impl->elements[i].text;
+
+        file_status st = detail::symlink_status(literal_path, &local_ec);
+        if (filesystem::exists(st))
+            result.push_back(literal_path);
+        return result;
+    }
+
+    glob_states states;
+    make_initial_states(*impl, impl->base_size, states);
+    boost::intrusive_ptr< dir_itr_filter > filter(new glob_dir_filter(impl, states));
+
+    const bool relative_base = impl->base.empty();
+    const path start = relative_base ? path(".") : impl->base;
+
+    recursive_directory_iterator it;
+    recursive_directory_iterator_construct_filtered(it, start, opts, filter.get(), &local_ec);
+    if (BOOST_UNLIKELY(!!local_ec))
+    {
+        // Missing base directory means no matches
+        if (local_ec == make_error_condition(system::errc::no_such_file_or_directory) || local_ec == make_error_condition(system::errc::not_a_directory))
+            return result;
+
+        goto fail;
+    }
+
+    while (it != recursive_directory_iterator())
+    {
+        if (relative_base)
+        {
+            // Strip the leading "./" that was added to the paths by the iterator
+            string_type const& str = it->path().native();
+            result.push_back(path(str.substr(2u)));
+        }
+        else
+        {
+            result.push_back(it->path());
+        }
+
+        it.increment(local_ec);
+        if (BOOST_UNLIKELY(!!local_ec))
+            goto fail;
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+
+fail:
+    if (!ec)
+        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::glob", pattern, local_ec));
+
+    *ec = local_ec;
+    result.clear();
+    return result;
+}
+
+} // namespace detail
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
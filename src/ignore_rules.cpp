@@ -0,0 +1,654 @@
+//  ignore_rules.cpp  ------------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/glob.hpp>
+#include <boost/filesystem/ignore_rules.hpp>
+#include <boost/filesystem/mapped_file.hpp>
+
+#include <cstddef>
+#include <new> // std::bad_alloc
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <boost/system/error_code.hpp>
+#include <boost/smart_ptr/intrusive_ptr.hpp>
+
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+namespace {
+
+typedef path::value_type char_type;
+typedef path::string_type string_type;
+//! Set of states of the rule matcher. Each state is an index of the rule element that is to be matched next.
+typedef std::vector< std::size_t > ignore_states;
+
+BOOST_CONSTEXPR_OR_CONST char_type slash = static_cast< char_type >('/');
+BOOST_CONSTEXPR_OR_CONST char_type backslash = static_cast< char_type >('\\');
+BOOST_CONSTEXPR_OR_CONST char_type space_char = static_cast< char_type >(' ');
+BOOST_CONSTEXPR_OR_CONST char_type hash_sign = static_cast< char_type >('#');
+BOOST_CONSTEXPR_OR_CONST char_type star = static_cast< char_type >('*');
+BOOST_CONSTEXPR_OR_CONST char_type question_mark = static_cast< char_type >('?');
+BOOST_CONSTEXPR_OR_CONST char_type open_bracket = static_cast< char_type >('[');
+BOOST_CONSTEXPR_OR_CONST char_type close_bracket = static_cast< char_type >(']');
+BOOST_CONSTEXPR_OR_CONST char_type exclamation_mark = static_cast< char_type >('!');
+BOOST_CONSTEXPR_OR_CONST char_type caret = static_cast< char_type >('^');
+BOOST_CONSTEXPR_OR_CONST char_type dash = static_cast< char_type >('-');
+
+//! Returns \c true if \a c is a wildcard character
+inline bool is_wildcard(char_type c) BOOST_NOEXCEPT
+{
+    return c == star || c == question_mark || c == open_bracket;
+}
+
+//! Returns \c true if \a name is a dot or dot-dot entry
+inline bool is_dot_or_dot_dot(const char_type* name, std::size_t size) BOOST_NOEXCEPT
+{
+    return name[0] == path::dot && (size == 1u || (size == 2u && name[1] == path::dot));
+}
+
+//! Appends the element \a text of a rule to \a elements
+void add_element(string_type const& text, std::vector< detail::glob_element >& elements)
+{
+    if (text.size() == 2u && text[0] == star && text[1] == star)
+    {
+        // Consecutive globstars are equivalent to one
+        if (elements.empty() || elements.back().kind != detail::glob_element::globstar)
+            elements.push_back(detail::glob_element(detail::glob_element::globstar));
+        return;
+    }
+
+    string_type literal;
+    for (std::size_t i = 0u, n = text.size(); i < n; ++i)
+    {
+        char_type c = text[i];
+        if (c == backslash && (i + 1u) < n)
+            c = text[++i];
+        else if (is_wildcard(c))
+        {
+            elements.push_back(detail::glob_element(detail::glob_element::wildcard, text));
+            return;
+        }
+
+        literal.push_back(c);
+    }
+
+    elements.push_back(detail::glob_element(detail::glob_element::literal, literal));
+}
+
+//! Matches the bracket expression starting at \a p against \a c. Returns the pointer past the expression or \c NULL if the expression is not terminated.
+const char_type* match_bracket(const char_type* p, const char_type* pend, char_type c, bool& matched) BOOST_NOEXCEPT
+{
+    ++p; // skip the opening bracket
+    bool negated = false;
+    if (p < pend && (*p == exclamation_mark || *p == caret))
+    {
+        negated = true;
+        ++p;
+    }
+
+    matched = false;
+    bool first = true;
+    while (p < pend)
+    {
+        char_type low = *p;
+        if (low == close_bracket && !first)
+        {
+            matched = matched != negated;
+            return p + 1;
+        }
+
+        first = false;
+        if (low == backslash && (p + 1) < pend)
+            low = *++p;
+        ++p;
+
+        char_type high = low;
+        if ((p + 1) < pend && *p == dash && p[1] != close_bracket)
+        {
+            high = p[1];
+            p += 2;
+            if (high == backslash && p < pend)
+                high = *p++;
+        }
+
+        if (low <= c && c <= high)
+            matched = true;
+    }
+
+    return NULL;
+}
+
+//! Matches name \a name against wildcard element \a pattern. Unlike glob patterns, wildcards match the leading dot.
+bool match_wildcard(string_type const& pattern, const char_type* name, std::size_t size) BOOST_NOEXCEPT
+{
+    const char_type* p = pattern.c_str();
+    const char_type* const pend = p + pattern.size();
+    const char_type* s = name;
+    const char_type* const send = name + size;
+
+    // Position of the last star in the pattern and in the name, where to resume matching on mismatch
+    const char_type* star_p = NULL;
+    const char_type* star_s = NULL;
+    while (s < send)
+    {
+        if (p < pend)
+        {
+            char_type c = *p;
+            if (c == star)
+            {
+                while (p < pend && *p == star)
+                    ++p;
+                if (p == pend)
+                    return true;
+                star_p = p;
+                star_s = s;
+                continue;
+            }
+
+            if (c == question_mark)
+            {
+                ++p;
+                ++s;
+                continue;
+            }
+
+            if (c == open_bracket)
+            {
+                bool matched = false;
+                const char_type* end = match_bracket(p, pend, *s, matched);
+                if (end)
+                {
+                    if (matched)
+                    {
+                        p = end;
+                        ++s;
+                        continue;
+                    }
+
+                    goto mismatch;
+                }
+
+                // Unterminated bracket expressions are treated literally
+            }
+
+            if (c == backslash && (p + 1) < pend)
+                c = *++p;
+
+            if (c == *s)
+            {
+                ++p;
+                ++s;
+                continue;
+            }
+        }
+
+    mismatch:
+        if (!star_p)
+            return false;
+
+        p = star_p;
+        s = ++star_s;
+    }
+
+    while (p < pend && *p == star)
+        ++p;
+
+    return p == pend;
+}
+
+//! Adds \a state and the states reachable from it without matching a path element to \a states
+void add_state(detail::ignore_rules_impl const& impl, ignore_states& states, std::size_t state)
+{
+    while (std::find(states.begin(), states.end(), state) == states.end())
+    {
+        states.push_back(state);
+        if (impl.elements[state].kind != detail::glob_element::globstar)
+            break;
+
+        // Globstar matches zero elements
+        ++state;
+    }
+}
+
+//! Fills \a states with the initial states of the matcher
+void make_initial_states(detail::ignore_rules_impl const& impl, ignore_states& states)
+{
+    states.clear();
+    for (std::size_t i = 0u, n = impl.rules.size(); i < n; ++i)
+        add_state(impl, states, impl.rules[i].first_element);
+}
+
+//! Returns the rule that is terminated by the end element \a state
+inline detail::ignore_rule const& rule_of_state(detail::ignore_rules_impl const& impl, std::size_t state) BOOST_NOEXCEPT
+{
+    std::size_t low = 0u, high = impl.rules.size();
+    while ((high - low) > 1u)
+    {
+        const std::size_t mid = low + (high - low) / 2u;
+        if (impl.rules[mid].first_element <= state)
+            low = mid;
+        else
+            high = mid;
+    }
+
+    return impl.rules[low];
+}
+
+//! Result of matching a path element against one set of rules
+enum match_result
+{
+    //! No rule matched the element
+    no_match,
+    //! The last matching rule excludes the element
+    match_excluded,
+    //! The last matching rule re-includes the element
+    match_included
+};
+
+//! Matches path element \a name and fills \a to with the resulting states. \a is_directory is called if the type of the element is needed to select the rule.
+template< typename IsDirectory >
+match_result match_element(detail::ignore_rules_impl const& impl, ignore_states const& from, const char_type* name, std::size_t size, IsDirectory& is_directory, ignore_states& to)
+{
+    to.clear();
+    for (std::size_t i = 0u, n = from.size(); i < n; ++i)
+    {
+        const std::size_t state = from[i];
+        detail::glob_element const& elem = impl.elements[state];
+        switch (elem.kind)
+        {
+        case detail::glob_element::literal:
+            if (elem.text.size() == size && string_type::traits_type::compare(elem.text.c_str(), name, size) == 0)
+                add_state(impl, to, state + 1u);
+            break;
+
+        case detail::glob_element::wildcard:
+            if (match_wildcard(elem.text, name, size))
+                add_state(impl, to, state + 1u);
+            break;
+
+        case detail::glob_element::globstar:
+            add_state(impl, to, state);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    // The last matching rule wins
+    detail::ignore_rule const* matched_rule = NULL;
+    for (std::size_t i = 0u, n = to.size(); i < n; ++i)
+    {
+        const std::size_t state = to[i];
+        if (impl.elements[state].kind != detail::glob_element::end)
+            continue;
+
+        detail::ignore_rule const& rule = rule_of_state(impl, state);
+        if (matched_rule && matched_rule->first_element > rule.first_element)
+            continue;
+        if ((rule.rule_flags & detail::ignore_rule::directory_only) != 0u && !is_directory())
+            continue;
+
+        matched_rule = &rule;
+    }
+
+    if (!matched_rule)
+        return no_match;
+
+    return (matched_rule->rule_flags & detail::ignore_rule::negated) != 0u ? match_included : match_excluded;
+}
+
+//! Type check for elements with a known type
+struct known_type
+{
+    bool value;
+
+    explicit known_type(bool v) BOOST_NOEXCEPT : value(v) {}
+    bool operator()() const BOOST_NOEXCEPT { return value; }
+};
+
+//! Type check for directory entries, which queries the filesystem if the type was not reported by the directory listing
+struct entry_type
+{
+    path const& dir;
+    const char_type* name;
+    std::size_t size;
+    file_type type;
+
+    entry_type(path const& d, const char_type* n, std::size_t s, file_type t) BOOST_NOEXCEPT : dir(d), name(n), size(s), type(t) {}
+
+    bool operator()()
+    {
+        if (type == status_error)
+        {
+            system::error_code ec;
+            type = detail::symlink_status(dir / string_type(name, size), &ec).type();
+        }
+
+        return type == directory_file;
+    }
+};
+
+//! Parses the contents of a rule file and adds the rules to \a impl
+void add_rules_from_text(detail::ignore_rules_impl& impl, const char* text, std::size_t size)
+{
+    const char* const end = text + size;
+    while (text < end)
+    {
+        const char* eol = std::find(text, end, '\n');
+        const char* line_end = eol;
+        if (line_end > text && line_end[-1] == '\r')
+            --line_end;
+
+        if (line_end > text)
+        {
+            const path rule(text, line_end);
+            detail::add_ignore_rule(impl, rule.native());
+        }
+
+        text = eol < end ? eol + 1 : end;
+    }
+}
+
+//! Rules of one rule file, or the rules specified by user, with the matcher states for a directory
+struct ignore_level
+{
+    boost::intrusive_ptr< const detail::ignore_rules_impl > rules;
+    ignore_states states;
+};
+
+//! Directory iterator filter that skips the entries excluded by ignore rules
+class ignore_dir_filter :
+    public detail::dir_itr_filter
+{
+private:
+    //! The rules specified by user, which also list the names of per-directory rule files
+    boost::intrusive_ptr< const detail::ignore_rules_impl > m_root;
+    //! The iterated directory
+    path m_dir;
+    //! Rules that apply to the directory, in the order of increasing precedence
+    std::vector< ignore_level > m_levels;
+    //! Matcher states after matching the last entry that may be descended into
+    std::vector< ignore_states > m_entry_states;
+    //! Name of the last entry that may be descended into
+    string_type m_entry_name;
+
+public:
+    ignore_dir_filter(detail::ignore_rules_impl const* root, path const& dir) :
+        m_root(root),
+        m_dir(dir)
+    {
+    }
+
+    //! Initializes the filter for the directory at the root of iteration
+    void init()
+    {
+        if (!m_root->rules.empty())
+        {
+            ignore_level level;
+            level.rules = m_root;
+            make_initial_states(*m_root, level.states);
+            m_levels.push_back(level);
+        }
+
+        load_rule_files();
+    }
+
+    unsigned int filter(const path::value_type* name, std::size_t size, file_type type) BOOST_OVERRIDE
+    {
+        if (is_dot_or_dot_dot(name, size))
+            return 0u;
+
+        entry_type is_directory(m_dir, name, size, type);
+        const std::size_t level_count = m_levels.size();
+        m_entry_states.resize(level_count);
+
+        // Rules of the deeper directories take precedence
+        match_result result = no_match;
+        for (std::size_t i = level_count; i > 0u;)
+        {
+            --i;
+            ignore_level const& level = m_levels[i];
+            if (result == no_match)
+            {
+                result = match_element(*level.rules, level.states, name, size, is_directory, m_entry_states[i]);
+                if (result == match_excluded)
+                    return 0u;
+            }
+            else
+            {
+                // The element is re-included by a deeper rule file, only the states are needed for the subtree
+                known_type no_directory(false);
+                match_element(*level.rules, level.states, name, size, no_directory, m_entry_states[i]);
+            }
+        }
+
+        if (type != directory_file && type != symlink_file && type != status_error)
+            return static_cast< unsigned int >(produce_entry);
+
+        m_entry_name.assign(name, size);
+        return static_cast< unsigned int >(produce_entry | descend_entry);
+    }
+
+    boost::intrusive_ptr< detail::dir_itr_filter > descend() const BOOST_OVERRIDE
+    {
+        boost::intrusive_ptr< ignore_dir_filter > filter(new ignore_dir_filter(m_root.get(), m_dir / m_entry_name));
+        for (std::size_t i = 0u, n = m_levels.size(); i < n; ++i)
+        {
+            // Rule sets that cannot match anything in the subtree are dropped
+            if (m_entry_states[i].empty())
+                continue;
+
+            filter->m_levels.push_back(ignore_level());
+            ignore_level& level = filter->m_levels.back();
+            level.rules = m_levels[i].rules;
+            level.states = m_entry_states[i];
+        }
+
+        filter->load_rule_files();
+        return filter;
+    }
+
+private:
+    //! Loads the rule files from the iterated directory. Missing and unreadable rule files are ignored.
+    void load_rule_files()
+    {
+        for (std::size_t i = 0u, n = m_root->rule_file_names.size(); i < n; ++i)
+        {
+            system::error_code ec;
+            mapped_file file(m_dir / m_root->rule_file_names[i], ec);
+            if (ec || file.empty())
+                continue;
+
+            boost::intrusive_ptr< detail::ignore_rules_impl > rules(new detail::ignore_rules_impl());
+            add_rules_from_text(*rules, file.data(), file.size());
+            if (rules->rules.empty())
+                continue;
+
+            ignore_level level;
+            level.rules = rules;
+            make_initial_states(*rules, level.states);
+            m_levels.push_back(level);
+        }
+    }
+};
+
+} // namespace
+
+namespace detail {
+
+BOOST_FILESYSTEM_DECL
+void add_ignore_rule(ignore_rules_impl& impl, path::string_type const& rule)
+{
+    std::size_t begin = 0u, end = rule.size();
+
+    // Trailing spaces are removed, unless escaped
+    while (end > 0u && rule[end - 1u] == space_char && !(end > 1u && rule[end - 2u] == backslash))
+        --end;
+
+    if (begin == end || rule[begin] == hash_sign)
+        return;
+
+    unsigned int flags = 0u;
+    if (rule[begin] == exclamation_mark)
+    {
+        flags |= ignore_rule::negated;
+        ++begin;
+    }
+
+    if (begin < end && rule[end - 1u] == slash)
+    {
+        flags |= ignore_rule::directory_only;
+        while (begin < end && rule[end - 1u] == slash)
+            --end;
+    }
+
+    if (begin == end)
+        return;
+
+    // Rules with a slash at the beginning or in the middle are anchored to the directory of the rules
+    const bool anchored = std::find(rule.begin() + begin, rule.begin() + end, slash) != rule.begin() + end;
+
+    const std::size_t first_element = impl.elements.size();
+    try
+    {
+        if (!anchored)
+            impl.elements.push_back(glob_element(glob_element::globstar));
+
+        std::size_t pos = begin;
+        while (pos < end)
+        {
+            std::size_t elem_end = pos;
+            while (elem_end < end && rule[elem_end] != slash)
+                ++elem_end;
+            if (elem_end > pos)
+                add_element(rule.substr(pos, elem_end - pos), impl.elements);
+            pos = elem_end + 1u;
+        }
+
+        // Trailing globstar only matches the contents of the directory, but not the directory itself
+        if (anchored && impl.elements.back().kind == glob_element::globstar && impl.elements.size() > first_element + 1u)
+        {
+            impl.elements.back() = glob_element(glob_element::wildcard, string_type(1u, star));
+            impl.elements.push_back(glob_element(glob_element::globstar));
+        }
+
+        impl.elements.push_back(glob_element(glob_element::end));
+        impl.rules.push_back(ignore_rule(first_element, flags));
+    }
+    catch (...)
+    {
+        impl.elements.resize(first_element, glob_element(glob_element::end));
+        throw;
+    }
+}
+
+BOOST_FILESYSTEM_DECL
+void add_ignore_file(ignore_rules_impl& impl, path const& file, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    system::error_code local_ec;
+    mapped_file contents(file, local_ec);
+    if (BOOST_UNLIKELY(!!local_ec))
+    {
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::ignore_rules::add_file", file, local_ec));
+
+        *ec = local_ec;
+        return;
+    }
+
+    add_rules_from_text(impl, contents.data(), contents.size());
+}
+
+BOOST_FILESYSTEM_DECL
+bool ignore_match(ignore_rules_impl const& impl, path const& p, bool is_directory)
+{
+    const path relative = p.relative_path();
+    if (relative.empty() || impl.rules.empty())
+        return false;
+
+    ignore_states states, next_states;
+    make_initial_states(impl, states);
+
+    for (path::iterator it = relative.begin(), end = relative.end(); it != end; ++it)
+    {
+        string_type const& elem = it->native();
+        if (elem.empty() || (elem.size() == 1u && elem[0] == path::dot))
+            continue;
+
+        // Parent directories of the path are directories
+        bool last = true;
+        path::iterator next = it;
+        for (++next; next != end && last; ++next)
+            last = next->empty() || (next->native().size() == 1u && next->native()[0] == path::dot);
+
+        known_type elem_is_directory(!last || is_directory);
+        const match_result result = match_element(impl, states, elem.c_str(), elem.size(), elem_is_directory, next_states);
+        if (result == match_excluded)
+            return true;
+
+        states.swap(next_states);
+    }
+
+    return false;
+}
+
+BOOST_FILESYSTEM_DECL
+void recursive_directory_iterator_construct_ignore(recursive_directory_iterator& it, path const& dir_path, ignore_rules const& rules, unsigned int opts, system::error_code* ec)
+{
+    ignore_rules_impl const* impl = rules.get_impl();
+    if (!impl)
+    {
+        // No rules exclude nothing
+        recursive_directory_iterator_construct(it, dir_path, opts, ec);
+        return;
+    }
+
+    boost::intrusive_ptr< ignore_dir_filter > filter;
+    try
+    {
+        filter = new ignore_dir_filter(impl, dir_path);
+        filter->init();
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return;
+    }
+
+    recursive_directory_iterator_construct_filtered(it, dir_path, opts, filter.get(), ec);
+}
+
+} // namespace detail
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
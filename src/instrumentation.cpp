@@ -0,0 +1,222 @@
+//  instrumentation.cpp  ---------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/instrumentation.hpp>
+#include <cstddef>
+#include <cstring>
+#include <boost/cstdint.hpp>
+
+#if defined(BOOST_FILESYSTEM_ENABLE_INSTRUMENTATION)
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_POSIX_API)
+#include <time.h>
+#else
+#include <boost/winapi/basic_types.hpp>
+#include <boost/winapi/timers.hpp>
+#endif
+
+#include "instrumentation.hpp"
+#include "atomic_tools.hpp"
+
+#endif // defined(BOOST_FILESYSTEM_ENABLE_INSTRUMENTATION)
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+namespace {
+
+const char* const g_operation_names[instrumented_operation::count] =
+{
+    "stat",
+    "statx",
+    "open_directory",
+    "getdents",
+    "readdir",
+    "unlink",
+    "copy_read_write",
+    "copy_sendfile",
+    "copy_file_range",
+    "copy_unbuffered",
+    "copy_sparse",
+    "copy_clone",
+    "copy_delta",
+    "copy_splice",
+    "copy_io_uring",
+    "implementation_fallback",
+    "operation_fallback"
+};
+
+#if defined(BOOST_FILESYSTEM_ENABLE_INSTRUMENTATION)
+
+//! Number of counter sets. Threads are distributed between the sets to reduce contention on the counters.
+BOOST_CONSTEXPR_OR_CONST unsigned int stripe_count = 16u;
+
+//! A set of counters. Aligned to avoid false sharing between the threads using different sets.
+struct BOOST_ALIGNMENT(64) counter_stripe
+{
+    instrumentation_counters operations[instrumented_operation::count];
+};
+
+counter_stripe g_stripes[stripe_count];
+
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED) && !defined(BOOST_NO_CXX11_THREAD_LOCAL)
+
+//! Index of the counter set that will be assigned to the next thread
+unsigned int g_next_stripe = 0u;
+//! Index of the counter set used by the current thread, plus one, or zero if not assigned yet
+thread_local unsigned int g_thread_stripe = 0u;
+
+inline counter_stripe& get_thread_stripe() BOOST_NOEXCEPT
+{
+    unsigned int stripe = g_thread_stripe;
+    if (BOOST_UNLIKELY(stripe == 0u))
+    {
+        stripe = detail::atomic_fetch_add_relaxed(g_next_stripe, 1u) % stripe_count + 1u;
+        g_thread_stripe = stripe;
+    }
+
+    return g_stripes[stripe - 1u];
+}
+
+#else // !defined(BOOST_FILESYSTEM_SINGLE_THREADED) && !defined(BOOST_NO_CXX11_THREAD_LOCAL)
+
+inline counter_stripe& get_thread_stripe() BOOST_NOEXCEPT
+{
+    return g_stripes[0];
+}
+
+#endif // !defined(BOOST_FILESYSTEM_SINGLE_THREADED) && !defined(BOOST_NO_CXX11_THREAD_LOCAL)
+
+#if defined(BOOST_WINDOWS_API)
+
+//! Returns the frequency of the performance counter
+boost::uint64_t get_performance_frequency() BOOST_NOEXCEPT
+{
+    boost::winapi::LARGE_INTEGER_ freq;
+    if (!boost::winapi::QueryPerformanceFrequency(&freq) || freq.QuadPart <= 0)
+        return 1u;
+    return static_cast< boost::uint64_t >(freq.QuadPart);
+}
+
+#endif // defined(BOOST_WINDOWS_API)
+
+#endif // defined(BOOST_FILESYSTEM_ENABLE_INSTRUMENTATION)
+
+} // unnamed namespace
+
+#if defined(BOOST_FILESYSTEM_ENABLE_INSTRUMENTATION)
+
+namespace detail {
+
+boost::uint64_t get_instrumentation_time() BOOST_NOEXCEPT
+{
+#if defined(BOOST_POSIX_API)
+    struct ::timespec ts;
+    if (BOOST_UNLIKELY(::clock_gettime(CLOCK_MONOTONIC, &ts) != 0))
+        return 0u;
+    return static_cast< boost::uint64_t >(ts.tv_sec) * 1000000000u + static_cast< boost::uint64_t >(ts.tv_nsec);
+#else
+    static const boost::uint64_t freq = get_performance_frequency();
+    boost::winapi::LARGE_INTEGER_ counter;
+    if (BOOST_UNLIKELY(!boost::winapi::QueryPerformanceCounter(&counter)))
+        return 0u;
+    const boost::uint64_t ticks = static_cast< boost::uint64_t >(counter.QuadPart);
+    return ticks / freq * 1000000000u + ticks % freq * 1000000000u / freq;
+#endif
+}
+
+void record_instrumented_call(instrumented_operation::type op, boost::uint64_t duration_ns) BOOST_NOEXCEPT
+{
+    instrumentation_counters& counters = get_thread_stripe().operations[op];
+    atomic_fetch_add_relaxed(counters.calls, static_cast< boost::uint64_t >(1u));
+    atomic_fetch_add_relaxed(counters.total_ns, duration_ns);
+
+    std::size_t bucket = 0u;
+    while (bucket + 1u < instrumentation_histogram_size && duration_ns >= instrumentation_histogram_bound(bucket))
+        ++bucket;
+    atomic_fetch_add_relaxed(counters.histogram[bucket], static_cast< boost::uint64_t >(1u));
+}
+
+void record_instrumented_event(instrumented_operation::type op) BOOST_NOEXCEPT
+{
+    atomic_fetch_add_relaxed(get_thread_stripe().operations[op].calls, static_cast< boost::uint64_t >(1u));
+}
+
+} // namespace detail
+
+#endif // defined(BOOST_FILESYSTEM_ENABLE_INSTRUMENTATION)
+
+BOOST_FILESYSTEM_DECL bool instrumentation_enabled() BOOST_NOEXCEPT
+{
+#if defined(BOOST_FILESYSTEM_ENABLE_INSTRUMENTATION)
+    return true;
+#else
+    return false;
+#endif
+}
+
+BOOST_FILESYSTEM_DECL void get_instrumentation_snapshot(instrumentation_snapshot& snapshot) BOOST_NOEXCEPT
+{
+    std::memset(&snapshot, 0, sizeof(snapshot));
+
+#if defined(BOOST_FILESYSTEM_ENABLE_INSTRUMENTATION)
+    for (unsigned int i = 0u; i < stripe_count; ++i)
+    {
+        counter_stripe& stripe = g_stripes[i];
+        for (unsigned int j = 0u; j < instrumented_operation::count; ++j)
+        {
+            instrumentation_counters& from = stripe.operations[j];
+            instrumentation_counters& to = snapshot.operations[j];
+            to.calls += detail::atomic_load_relaxed(from.calls);
+            to.total_ns += detail::atomic_load_relaxed(from.total_ns);
+            for (std::size_t k = 0u; k < instrumentation_histogram_size; ++k)
+                to.histogram[k] += detail::atomic_load_relaxed(from.histogram[k]);
+        }
+    }
+#endif
+}
+
+BOOST_FILESYSTEM_DECL void reset_instrumentation() BOOST_NOEXCEPT
+{
+#if defined(BOOST_FILESYSTEM_ENABLE_INSTRUMENTATION)
+    for (unsigned int i = 0u; i < stripe_count; ++i)
+    {
+        counter_stripe& stripe = g_stripes[i];
+        for (unsigned int j = 0u; j < instrumented_operation::count; ++j)
+        {
+            instrumentation_counters& counters = stripe.operations[j];
+            detail::atomic_store_relaxed(counters.calls, static_cast< boost::uint64_t >(0u));
+            detail::atomic_store_relaxed(counters.total_ns, static_cast< boost::uint64_t >(0u));
+            for (std::size_t k = 0u; k < instrumentation_histogram_size; ++k)
+                detail::atomic_store_relaxed(counters.histogram[k], static_cast< boost::uint64_t >(0u));
+        }
+    }
+#endif
+}
+
+BOOST_FILESYSTEM_DECL const char* get_instrumented_operation_name(unsigned int op) BOOST_NOEXCEPT
+{
+    if (op >= instrumented_operation::count)
+        return NULL;
+    return g_operation_names[op];
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
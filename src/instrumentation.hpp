@@ -0,0 +1,96 @@
+//  instrumentation.hpp  ---------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_SRC_INSTRUMENTATION_HPP_
+#define BOOST_FILESYSTEM_SRC_INSTRUMENTATION_HPP_
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/instrumentation.hpp>
+#include <boost/cstdint.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+#if defined(BOOST_FILESYSTEM_ENABLE_INSTRUMENTATION)
+
+//! Returns the current time of a monotonic clock, in nanoseconds
+boost::uint64_t get_instrumentation_time() BOOST_NOEXCEPT;
+
+//! Records a call of operation \a op that took \a duration_ns nanoseconds
+void record_instrumented_call(instrumented_operation::type op, boost::uint64_t duration_ns) BOOST_NOEXCEPT;
+
+//! Records an event \a op, which has no duration
+void record_instrumented_event(instrumented_operation::type op) BOOST_NOEXCEPT;
+
+//! Measures the duration of an instrumented call
+class instrumentation_timer
+{
+private:
+    boost::uint64_t m_start;
+
+public:
+    //! Starts the measurement
+    instrumentation_timer() BOOST_NOEXCEPT : m_start(get_instrumentation_time()) {}
+
+    //! Restarts the measurement
+    void restart() BOOST_NOEXCEPT { m_start = get_instrumentation_time(); }
+
+    //! Records a call of operation \a op that started when the measurement started
+    void record(instrumented_operation::type op) const BOOST_NOEXCEPT
+    {
+        record_instrumented_call(op, get_instrumentation_time() - m_start);
+    }
+};
+
+//! Measures the duration of the enclosing scope and records it as a call of an instrumented operation
+class instrumentation_scope
+{
+private:
+    instrumentation_timer m_timer;
+    instrumented_operation::type m_op;
+
+public:
+    explicit instrumentation_scope(instrumented_operation::type op) BOOST_NOEXCEPT : m_op(op) {}
+    ~instrumentation_scope() BOOST_NOEXCEPT { m_timer.record(m_op); }
+
+    BOOST_DELETED_FUNCTION(instrumentation_scope(instrumentation_scope const&))
+    BOOST_DELETED_FUNCTION(instrumentation_scope& operator=(instrumentation_scope const&))
+};
+
+#else // defined(BOOST_FILESYSTEM_ENABLE_INSTRUMENTATION)
+
+inline void record_instrumented_event(instrumented_operation::type) BOOST_NOEXCEPT {}
+
+class instrumentation_timer
+{
+public:
+    void restart() BOOST_NOEXCEPT {}
+    void record(instrumented_operation::type) const BOOST_NOEXCEPT {}
+};
+
+class instrumentation_scope
+{
+public:
+    explicit instrumentation_scope(instrumented_operation::type) BOOST_NOEXCEPT {}
+};
+
+#endif // defined(BOOST_FILESYSTEM_ENABLE_INSTRUMENTATION)
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_SRC_INSTRUMENTATION_HPP_
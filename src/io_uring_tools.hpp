@@ -0,0 +1,216 @@
+//  io_uring_tools.hpp  ----------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_SRC_IO_URING_TOOLS_HPP_
+#define BOOST_FILESYSTEM_SRC_IO_URING_TOOLS_HPP_
+
+#include "platform_config.hpp"
+#include <boost/filesystem/config.hpp>
+
+#if defined(BOOST_POSIX_API) && (defined(linux) || defined(__linux) || defined(__linux__))
+#if defined(BOOST_FILESYSTEM_HAS_IO_URING_STATX) && !defined(BOOST_FILESYSTEM_DISABLE_IO_URING) && \
+    !defined(BOOST_FILESYSTEM_DISABLE_STATX) && (defined(BOOST_FILESYSTEM_HAS_STATX) || defined(BOOST_FILESYSTEM_HAS_STATX_SYSCALL))
+#include <cstddef>
+#include <cerrno>
+#include <cstring>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <fcntl.h>
+#if !defined(BOOST_FILESYSTEM_HAS_STATX) && defined(BOOST_FILESYSTEM_HAS_STATX_SYSCALL)
+#include <linux/stat.h>
+#endif
+#include <linux/io_uring.h>
+#include <boost/cstdint.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include "atomic_ref.hpp"
+#include "posix_tools.hpp"
+#define BOOST_FILESYSTEM_USE_IO_URING
+#endif
+#endif // defined(BOOST_POSIX_API) && (defined(linux) || defined(__linux) || defined(__linux__))
+
+#if defined(BOOST_FILESYSTEM_USE_IO_URING)
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+//! A minimal io_uring instance, mapped into the process address space
+class io_uring_instance
+{
+private:
+    int m_fd;
+    void* m_sq_ring;
+    std::size_t m_sq_ring_size;
+    void* m_cq_ring;
+    std::size_t m_cq_ring_size;
+    struct io_uring_sqe* m_sqes;
+    std::size_t m_sqes_size;
+
+    unsigned int* m_sq_tail;
+    unsigned int m_sq_mask;
+    unsigned int* m_sq_array;
+    unsigned int* m_cq_head;
+    unsigned int* m_cq_tail;
+    unsigned int m_cq_mask;
+    struct io_uring_cqe* m_cqes;
+
+public:
+    io_uring_instance() BOOST_NOEXCEPT :
+        m_fd(-1),
+        m_sq_ring(MAP_FAILED),
+        m_sq_ring_size(0u),
+        m_cq_ring(MAP_FAILED),
+        m_cq_ring_size(0u),
+        m_sqes(static_cast< struct io_uring_sqe* >(MAP_FAILED)),
+        m_sqes_size(0u),
+        m_sq_tail(NULL),
+        m_sq_mask(0u),
+        m_sq_array(NULL),
+        m_cq_head(NULL),
+        m_cq_tail(NULL),
+        m_cq_mask(0u),
+        m_cqes(NULL)
+    {
+    }
+
+    ~io_uring_instance() BOOST_NOEXCEPT
+    {
+        if (m_sqes != MAP_FAILED)
+            ::munmap(m_sqes, m_sqes_size);
+        if (m_cq_ring != MAP_FAILED && m_cq_ring != m_sq_ring)
+            ::munmap(m_cq_ring, m_cq_ring_size);
+        if (m_sq_ring != MAP_FAILED)
+            ::munmap(m_sq_ring, m_sq_ring_size);
+        if (m_fd >= 0)
+            close_fd(m_fd);
+    }
+
+    BOOST_DELETED_FUNCTION(io_uring_instance(io_uring_instance const&))
+    BOOST_DELETED_FUNCTION(io_uring_instance& operator=(io_uring_instance const&))
+
+    //! Creates the io_uring instance. Returns 0 on success or the error code otherwise.
+    int init(unsigned int entries) BOOST_NOEXCEPT
+    {
+        struct io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        const long fd = ::syscall(__NR_io_uring_setup, entries, &params);
+        if (fd < 0)
+            return errno;
+
+        m_fd = static_cast< int >(fd);
+
+        // Require the kernel to support single mmap for both rings (Linux 5.4+). IORING_OP_STATX is only supported since Linux 5.6 anyway.
+        if ((params.features & IORING_FEAT_SINGLE_MMAP) == 0u)
+            return ENOSYS;
+
+        m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+        m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        if (m_cq_ring_size > m_sq_ring_size)
+            m_sq_ring_size = m_cq_ring_size;
+        m_cq_ring_size = m_sq_ring_size;
+
+        m_sq_ring = ::mmap(NULL, m_sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+        if (m_sq_ring == MAP_FAILED)
+            return errno;
+        m_cq_ring = m_sq_ring;
+
+        m_sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+        void* sqes = ::mmap(NULL, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED)
+            return errno;
+        m_sqes = static_cast< struct io_uring_sqe* >(sqes);
+
+        unsigned char* sq_ring = static_cast< unsigned char* >(m_sq_ring);
+        m_sq_tail = reinterpret_cast< unsigned int* >(sq_ring + params.sq_off.tail);
+        m_sq_mask = *reinterpret_cast< const unsigned int* >(sq_ring + params.sq_off.ring_mask);
+        m_sq_array = reinterpret_cast< unsigned int* >(sq_ring + params.sq_off.array);
+
+        unsigned char* cq_ring = static_cast< unsigned char* >(m_cq_ring);
+        m_cq_head = reinterpret_cast< unsigned int* >(cq_ring + params.cq_off.head);
+        m_cq_tail = reinterpret_cast< unsigned int* >(cq_ring + params.cq_off.tail);
+        m_cq_mask = *reinterpret_cast< const unsigned int* >(cq_ring + params.cq_off.ring_mask);
+        m_cqes = reinterpret_cast< struct io_uring_cqe* >(cq_ring + params.cq_off.cqes);
+
+        return 0;
+    }
+
+    //! Returns the io_uring file descriptor
+    int fd() const BOOST_NOEXCEPT { return m_fd; }
+
+    //! Registers the buffers for fixed read and write requests. Returns 0 on success or the error code otherwise.
+    int register_buffers(struct iovec const* buffers, unsigned int count) const BOOST_NOEXCEPT
+    {
+        if (::syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_BUFFERS, buffers, count) < 0)
+            return errno;
+        return 0;
+    }
+
+    //! Returns the current submission queue tail. Only this thread modifies the tail.
+    unsigned int sq_tail() const BOOST_NOEXCEPT { return *m_sq_tail; }
+
+    //! Returns the submission queue entry for the given tail position
+    struct io_uring_sqe* get_sqe(unsigned int tail) const BOOST_NOEXCEPT
+    {
+        const unsigned int index = tail & m_sq_mask;
+        m_sq_array[index] = index;
+        return m_sqes + index;
+    }
+
+    //! Publishes the submission queue entries up to the given tail to the kernel
+    void set_sq_tail(unsigned int tail) const BOOST_NOEXCEPT
+    {
+        atomic_ns::atomic_ref< unsigned int >(*m_sq_tail).store(tail, atomic_ns::memory_order_release);
+    }
+
+    //! Submits entries and waits for at least \a min_complete completions. Returns the number of submitted entries or -1 with errno set.
+    int enter(unsigned int to_submit, unsigned int min_complete) const BOOST_NOEXCEPT
+    {
+        return static_cast< int >(::syscall(__NR_io_uring_enter, m_fd, to_submit, min_complete, min_complete > 0u ? IORING_ENTER_GETEVENTS : 0u, static_cast< void* >(NULL), 0u));
+    }
+
+    unsigned int cq_head() const BOOST_NOEXCEPT { return *m_cq_head; }
+    unsigned int cq_tail() const BOOST_NOEXCEPT { return atomic_ns::atomic_ref< unsigned int >(*m_cq_tail).load(atomic_ns::memory_order_acquire); }
+    struct io_uring_cqe const& get_cqe(unsigned int head) const BOOST_NOEXCEPT { return m_cqes[head & m_cq_mask]; }
+    void set_cq_head(unsigned int head) const BOOST_NOEXCEPT { atomic_ns::atomic_ref< unsigned int >(*m_cq_head).store(head, atomic_ns::memory_order_release); }
+};
+
+//! Converts the result of statx to file status, consistent with status()
+inline file_status make_statx_status(int res, struct ::statx const& stx) BOOST_NOEXCEPT
+{
+    if (res < 0)
+    {
+        const int err = -res;
+        if (err == ENOENT || err == ENOTDIR)
+            return file_status(file_not_found, no_perms);
+        return file_status(status_error);
+    }
+
+    if (BOOST_UNLIKELY((stx.stx_mask & (STATX_TYPE | STATX_MODE)) != (STATX_TYPE | STATX_MODE)))
+        return file_status(status_error);
+
+    return make_file_status(stx.stx_mode);
+}
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // defined(BOOST_FILESYSTEM_USE_IO_URING)
+
+#endif // BOOST_FILESYSTEM_SRC_IO_URING_TOOLS_HPP_
@@ -0,0 +1,283 @@
+//  mapped_file.cpp  -------------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/mapped_file.hpp>
+
+#include <cstddef>
+#include <cerrno>
+#include <limits>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#if defined(BOOST_POSIX_API)
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+// At least Mac OS X 10.6 and older doesn't support O_CLOEXEC
+#ifndef O_CLOEXEC
+#define O_CLOEXEC 0
+#define BOOST_FILESYSTEM_NO_O_CLOEXEC
+#endif
+
+#include "posix_tools.hpp"
+
+#else // BOOST_WINDOWS_API
+
+#include <boost/winapi/dll.hpp> // get_proc_address, GetModuleHandleW
+#include <windows.h>
+
+#endif // BOOST_WINDOWS_API
+
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+namespace {
+
+#if defined(BOOST_WINDOWS_API)
+
+//! WIN32_MEMORY_RANGE_ENTRY definition from Windows SDK
+struct win32_memory_range_entry
+{
+    PVOID VirtualAddress;
+    SIZE_T NumberOfBytes;
+};
+
+//! PrefetchVirtualMemory signature. Available since Windows 8.
+typedef BOOL (WINAPI PrefetchVirtualMemory_t)(
+    /*__in*/ HANDLE hProcess,
+    /*__in*/ ULONG_PTR NumberOfEntries,
+    /*__in*/ win32_memory_range_entry* VirtualAddresses,
+    /*__in*/ ULONG Flags);
+
+//! Closes the handle on destruction
+struct mapped_file_handle_wrapper
+{
+    HANDLE handle;
+
+    explicit mapped_file_handle_wrapper(HANDLE h) BOOST_NOEXCEPT : handle(h) {}
+    ~mapped_file_handle_wrapper() BOOST_NOEXCEPT
+    {
+        if (handle != NULL && handle != INVALID_HANDLE_VALUE)
+            ::CloseHandle(handle);
+    }
+
+    BOOST_DELETED_FUNCTION(mapped_file_handle_wrapper(mapped_file_handle_wrapper const&))
+    BOOST_DELETED_FUNCTION(mapped_file_handle_wrapper& operator=(mapped_file_handle_wrapper const&))
+};
+
+#endif // defined(BOOST_WINDOWS_API)
+
+//! Applies access advice to a mapped region
+void advise_region(const char* data, std::size_t size, unsigned int flags) BOOST_NOEXCEPT
+{
+    if (data == NULL || size == 0u)
+        return;
+
+#if defined(BOOST_POSIX_API)
+
+    void* const addr = const_cast< char* >(data);
+
+#if defined(POSIX_MADV_SEQUENTIAL) && defined(POSIX_MADV_RANDOM) && defined(POSIX_MADV_WILLNEED)
+    if ((flags & static_cast< unsigned int >(mapped_file_flags::sequential)) != 0u)
+        ::posix_madvise(addr, size, POSIX_MADV_SEQUENTIAL);
+    else if ((flags & static_cast< unsigned int >(mapped_file_flags::random)) != 0u)
+        ::posix_madvise(addr, size, POSIX_MADV_RANDOM);
+
+    if ((flags & static_cast< unsigned int >(mapped_file_flags::will_need)) != 0u)
+        ::posix_madvise(addr, size, POSIX_MADV_WILLNEED);
+#endif
+
+#if defined(MADV_HUGEPAGE)
+    if ((flags & static_cast< unsigned int >(mapped_file_flags::huge_pages)) != 0u)
+        ::madvise(addr, size, MADV_HUGEPAGE);
+#endif
+
+#else // defined(BOOST_POSIX_API)
+
+    // Windows does not support access pattern hints or huge pages for file mappings. Prefetching is supported since Windows 8.
+    if ((flags & static_cast< unsigned int >(mapped_file_flags::will_need)) != 0u)
+    {
+        HMODULE h = ::GetModuleHandleW(L"kernel32.dll");
+        if (BOOST_LIKELY(h != NULL))
+        {
+            PrefetchVirtualMemory_t* prefetch_virtual_memory = (PrefetchVirtualMemory_t*)boost::winapi::get_proc_address(h, "PrefetchVirtualMemory");
+            if (prefetch_virtual_memory != NULL)
+            {
+                win32_memory_range_entry range;
+                range.VirtualAddress = const_cast< char* >(data);
+                range.NumberOfBytes = size;
+                prefetch_virtual_memory(::GetCurrentProcess(), 1u, &range, 0u);
+            }
+        }
+    }
+
+#endif // defined(BOOST_POSIX_API)
+}
+
+} // unnamed namespace
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                           class mapped_file implementation                           //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+BOOST_FILESYSTEM_DECL void mapped_file::close() BOOST_NOEXCEPT
+{
+    if (m_data != NULL)
+    {
+#if defined(BOOST_POSIX_API)
+        ::munmap(const_cast< char* >(m_data), m_size);
+#else
+        ::UnmapViewOfFile(m_data);
+#endif
+    }
+
+    m_data = NULL;
+    m_size = 0u;
+    m_is_open = false;
+}
+
+BOOST_FILESYSTEM_DECL void mapped_file::open_impl(path const& p, unsigned int flags, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    close();
+
+#if defined(BOOST_POSIX_API)
+
+    detail::fd_wrapper fd(::open(p.c_str(), O_RDONLY | O_NOCTTY | O_CLOEXEC));
+    if (BOOST_UNLIKELY(fd.fd < 0))
+    {
+    fail_errno:
+        emit_error(errno, p, ec, "boost::filesystem::mapped_file::open");
+        return;
+    }
+
+#if defined(BOOST_FILESYSTEM_NO_O_CLOEXEC) && defined(FD_CLOEXEC)
+    if (BOOST_UNLIKELY(::fcntl(fd.fd, F_SETFD, FD_CLOEXEC) < 0))
+        goto fail_errno;
+#endif
+
+    struct ::stat st;
+    if (BOOST_UNLIKELY(::fstat(fd.fd, &st) < 0))
+        goto fail_errno;
+
+    if (BOOST_UNLIKELY(!S_ISREG(st.st_mode)))
+    {
+        emit_error(ENODEV, p, ec, "boost::filesystem::mapped_file::open");
+        return;
+    }
+
+    if (BOOST_UNLIKELY(static_cast< boost::uintmax_t >(st.st_size) > static_cast< boost::uintmax_t >((std::numeric_limits< std::size_t >::max)())))
+    {
+        emit_error(EFBIG, p, ec, "boost::filesystem::mapped_file::open");
+        return;
+    }
+
+    const std::size_t size = static_cast< std::size_t >(st.st_size);
+    if (size > 0u)
+    {
+        int map_flags = MAP_SHARED;
+        if ((flags & static_cast< unsigned int >(mapped_file_flags::populate)) != 0u)
+        {
+#if defined(MAP_POPULATE)
+            map_flags |= MAP_POPULATE;
+#else
+            // Request the contents to be read ahead instead
+            flags |= static_cast< unsigned int >(mapped_file_flags::will_need);
+#endif
+        }
+        void* addr = ::mmap(NULL, size, PROT_READ, map_flags, fd.fd, 0);
+        if (BOOST_UNLIKELY(addr == MAP_FAILED))
+            goto fail_errno;
+
+        m_data = static_cast< const char* >(addr);
+        m_size = size;
+    }
+
+#else // defined(BOOST_POSIX_API)
+
+    mapped_file_handle_wrapper file(::CreateFileW(
+        p.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | ((flags & static_cast< unsigned int >(mapped_file_flags::sequential)) != 0u ? FILE_FLAG_SEQUENTIAL_SCAN : 0u),
+        NULL));
+
+    if (BOOST_UNLIKELY(file.handle == INVALID_HANDLE_VALUE))
+    {
+    fail_last_error:
+        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::mapped_file::open");
+        return;
+    }
+
+    LARGE_INTEGER file_size;
+    if (BOOST_UNLIKELY(!::GetFileSizeEx(file.handle, &file_size)))
+        goto fail_last_error;
+
+    if (BOOST_UNLIKELY(static_cast< boost::uint64_t >(file_size.QuadPart) > static_cast< boost::uint64_t >((std::numeric_limits< std::size_t >::max)())))
+    {
+        emit_error(ERROR_FILE_TOO_LARGE, p, ec, "boost::filesystem::mapped_file::open");
+        return;
+    }
+
+    const std::size_t size = static_cast< std::size_t >(file_size.QuadPart);
+    if (size > 0u)
+    {
+        mapped_file_handle_wrapper mapping(::CreateFileMappingW(file.handle, NULL, PAGE_READONLY, 0u, 0u, NULL));
+        if (BOOST_UNLIKELY(mapping.handle == NULL))
+            goto fail_last_error;
+
+        void* addr = ::MapViewOfFile(mapping.handle, FILE_MAP_READ, 0u, 0u, size);
+        if (BOOST_UNLIKELY(addr == NULL))
+            goto fail_last_error;
+
+        m_data = static_cast< const char* >(addr);
+        m_size = size;
+
+        // Windows does not support populating the mapping on creation, prefetch the contents instead
+        if ((flags & static_cast< unsigned int >(mapped_file_flags::populate)) != 0u)
+            flags |= static_cast< unsigned int >(mapped_file_flags::will_need);
+    }
+
+#endif // defined(BOOST_POSIX_API)
+
+    m_is_open = true;
+
+    advise_region(m_data, m_size, flags);
+}
+
+BOOST_FILESYSTEM_DECL void mapped_file::advise_impl(unsigned int flags) const BOOST_NOEXCEPT
+{
+    advise_region(m_data, m_size, flags);
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
@@ -0,0 +1,138 @@
+//  memory_allocator.cpp  --------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/memory_allocator.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <boost/throw_exception.hpp>
+
+#if defined(BOOST_WINDOWS_API)
+#include <malloc.h> // _aligned_malloc, _aligned_free
+#endif
+
+#include "atomic_tools.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+namespace {
+
+//! Alignment that is guaranteed by \c std::malloc
+BOOST_CONSTEXPR_OR_CONST std::size_t malloc_alignment = 2u * sizeof(void*);
+
+void* default_allocate(std::size_t size, std::size_t alignment)
+{
+    if (alignment <= malloc_alignment)
+        return std::malloc(size);
+
+#if defined(BOOST_POSIX_API)
+    void* p = NULL;
+    if (BOOST_UNLIKELY(::posix_memalign(&p, alignment, size) != 0))
+        return NULL;
+    return p;
+#else
+    return ::_aligned_malloc(size, alignment);
+#endif
+}
+
+void default_deallocate(void* p, std::size_t, std::size_t alignment)
+{
+#if defined(BOOST_WINDOWS_API)
+    if (alignment > malloc_alignment)
+    {
+        ::_aligned_free(p);
+        return;
+    }
+#else
+    (void)alignment;
+#endif
+    std::free(p);
+}
+
+//! Returns the offset of the pointer to the allocator that follows every block allocated by \c allocate_memory
+inline std::size_t get_allocator_offset(std::size_t size) BOOST_NOEXCEPT
+{
+    return (size + (sizeof(memory_allocator const*) - 1u)) & ~(sizeof(memory_allocator const*) - 1u);
+}
+
+} // namespace
+
+const memory_allocator default_memory_allocator = { &default_allocate, &default_deallocate };
+
+//! Current allocator of the memory used internally by the library
+memory_allocator const* g_memory_allocator = &default_memory_allocator;
+
+BOOST_FILESYSTEM_DECL
+void* allocate_memory(std::size_t size, std::size_t alignment, std::nothrow_t const&) BOOST_NOEXCEPT
+{
+    // The block is followed by the pointer to the allocator, so that the block is deallocated with the same allocator
+    // even if the current allocator changes. Storing the pointer after the block does not affect its alignment.
+    const std::size_t offset = get_allocator_offset(size);
+    if (BOOST_UNLIKELY(offset < size || offset + sizeof(memory_allocator const*) < offset))
+        return NULL;
+
+    memory_allocator const* allocator = filesystem::detail::atomic_load_acquire(g_memory_allocator);
+    void* p = allocator->allocate(offset + sizeof(memory_allocator const*), alignment);
+    if (BOOST_LIKELY(p != NULL))
+        std::memcpy(static_cast< unsigned char* >(p) + offset, &allocator, sizeof(allocator));
+
+    return p;
+}
+
+BOOST_FILESYSTEM_DECL
+void* allocate_memory(std::size_t size, std::size_t alignment)
+{
+    void* p = detail::allocate_memory(size, alignment, std::nothrow);
+    if (BOOST_UNLIKELY(p == NULL))
+        boost::throw_exception(std::bad_alloc());
+    return p;
+}
+
+BOOST_FILESYSTEM_DECL
+void deallocate_memory(void* p, std::size_t size, std::size_t alignment) BOOST_NOEXCEPT
+{
+    if (BOOST_LIKELY(p != NULL))
+    {
+        const std::size_t offset = get_allocator_offset(size);
+        memory_allocator const* allocator;
+        std::memcpy(&allocator, static_cast< unsigned char* >(p) + offset, sizeof(allocator));
+        allocator->deallocate(p, offset + sizeof(memory_allocator const*), alignment);
+    }
+}
+
+} // namespace detail
+
+BOOST_FILESYSTEM_DECL
+void set_memory_allocator(memory_allocator const* allocator) BOOST_NOEXCEPT
+{
+    if (!allocator)
+        allocator = &detail::default_memory_allocator;
+    filesystem::detail::atomic_store_release(detail::g_memory_allocator, allocator);
+}
+
+BOOST_FILESYSTEM_DECL
+memory_allocator const* get_memory_allocator() BOOST_NOEXCEPT
+{
+    return filesystem::detail::atomic_load_acquire(detail::g_memory_allocator);
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
@@ -19,6 +19,13 @@
 #include <boost/filesystem/file_status.hpp>
 #include <boost/filesystem/exception.hpp>
 #include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/directory_handle.hpp>
+#include <boost/filesystem/unique_file.hpp>
+#include <boost/filesystem/volume_handle.hpp>
+#include <boost/filesystem/canonicalizer.hpp>
+#include <boost/filesystem/backends.hpp>
+#include <boost/filesystem/memory_allocator.hpp>
+#include <boost/filesystem/parallel_walk.hpp>
 #include <boost/system/error_code.hpp>
 #include <boost/smart_ptr/scoped_ptr.hpp>
 #include <boost/smart_ptr/scoped_array.hpp>
@@ -26,13 +33,17 @@
 #include <boost/core/bit.hpp>
 #include <boost/cstdint.hpp>
 #include <boost/assert.hpp>
+#include <algorithm>
 #include <new> // std::bad_alloc, std::nothrow
 #include <limits>
 #include <string>
+#include <utility>
+#include <vector>
 #include <cstddef>
 #include <cstdlib> // for malloc, free
 #include <cstring>
 #include <cerrno>
+#include <ctime>
 #include <stdio.h> // for rename
 
 // Default to POSIX under Emscripten
@@ -45,6 +56,7 @@
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <dirent.h>
 
 #if defined(BOOST_FILESYSTEM_USE_WASI)
 // WASI does not have statfs or statvfs.
@@ -54,6 +66,7 @@
     !defined(__VXWORKS__)
 #include <sys/statvfs.h>
 #define BOOST_STATVFS statvfs
+#define BOOST_FSTATVFS fstatvfs
 #define BOOST_STATVFS_F_FRSIZE vfs.f_frsize
 #else
 #ifdef __OpenBSD__
@@ -65,6 +78,7 @@
 #include <sys/mount.h>
 #endif
 #define BOOST_STATVFS statfs
+#define BOOST_FSTATVFS fstatfs
 #define BOOST_STATVFS_F_FRSIZE static_cast< uintmax_t >(vfs.f_bsize)
 #endif // BOOST_STATVFS definition
 
@@ -78,9 +92,9 @@
 #if defined(linux) || defined(__linux) || defined(__linux__)
 
 #include <sys/vfs.h>
-#include <sys/utsname.h>
 #include <sys/syscall.h>
 #include <sys/sysmacros.h>
+#include <sys/ioctl.h>
 #if !defined(BOOST_FILESYSTEM_DISABLE_SENDFILE)
 #include <sys/sendfile.h>
 #define BOOST_FILESYSTEM_USE_SENDFILE
@@ -88,6 +102,40 @@
 #if !defined(BOOST_FILESYSTEM_DISABLE_COPY_FILE_RANGE) && defined(__NR_copy_file_range)
 #define BOOST_FILESYSTEM_USE_COPY_FILE_RANGE
 #endif // !defined(BOOST_FILESYSTEM_DISABLE_COPY_FILE_RANGE) && defined(__NR_copy_file_range)
+// splice is only used by copy_data along with the other kernel data transfer methods
+#if !defined(BOOST_FILESYSTEM_DISABLE_SPLICE) && defined(SPLICE_F_MOVE) && (defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE))
+#define BOOST_FILESYSTEM_USE_SPLICE
+#endif
+#if defined(__NR_syncfs)
+// syncfs is available since Linux 2.6.39
+#define BOOST_FILESYSTEM_HAS_SYNCFS
+#endif
+#if defined(__NR_openat2)
+// openat2 is available since Linux 5.6
+#define BOOST_FILESYSTEM_HAS_OPENAT2
+#if !defined(RESOLVE_NO_XDEV)
+#define RESOLVE_NO_XDEV 0x01
+#endif
+#if !defined(RESOLVE_NO_MAGICLINKS)
+#define RESOLVE_NO_MAGICLINKS 0x02
+#endif
+#if !defined(RESOLVE_NO_SYMLINKS)
+#define RESOLVE_NO_SYMLINKS 0x04
+#endif
+#if !defined(RESOLVE_BENEATH)
+#define RESOLVE_BENEATH 0x08
+#endif
+#endif
+#if defined(__NR_renameat2)
+// renameat2 is available since Linux 3.15
+#define BOOST_FILESYSTEM_HAS_RENAMEAT2
+#if !defined(RENAME_NOREPLACE)
+#define RENAME_NOREPLACE (1u << 0)
+#endif
+#if !defined(RENAME_EXCHANGE)
+#define RENAME_EXCHANGE (1u << 1)
+#endif
+#endif
 #if !defined(BOOST_FILESYSTEM_DISABLE_STATX) && (defined(BOOST_FILESYSTEM_HAS_STATX) || defined(BOOST_FILESYSTEM_HAS_STATX_SYSCALL))
 #if !defined(BOOST_FILESYSTEM_HAS_STATX) && defined(BOOST_FILESYSTEM_HAS_STATX_SYSCALL)
 #include <linux/stat.h>
@@ -116,12 +164,78 @@
 #define DEBUGFS_MAGIC 0x64626720
 #endif
 
+#if defined(_GNU_SOURCE)
+// fallocate is a Linux-specific API that is only declared if _GNU_SOURCE is defined
+#define BOOST_FILESYSTEM_HAS_FALLOCATE
+#ifndef FALLOC_FL_KEEP_SIZE
+#define FALLOC_FL_KEEP_SIZE 0x01
+#endif
+#ifndef FALLOC_FL_PUNCH_HOLE
+#define FALLOC_FL_PUNCH_HOLE 0x02
+#endif
+#ifndef FALLOC_FL_ZERO_RANGE
+#define FALLOC_FL_ZERO_RANGE 0x10
+#endif
+// sync_file_range is available since Linux 2.6.17
+#define BOOST_FILESYSTEM_HAS_SYNC_FILE_RANGE
+#endif
+
+// FICLONE is defined in linux/fs.h, which conflicts with sys/mount.h in some glibc versions. Available since Linux 4.5.
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+#define BOOST_FILESYSTEM_HAS_FICLONE
+
+#if !defined(BOOST_FILESYSTEM_DISABLE_XATTR) && defined(__has_include)
+#if __has_include(<sys/xattr.h>)
+#include <sys/xattr.h>
+#define BOOST_FILESYSTEM_HAS_XATTR
+#endif
+#endif
+
 #endif // defined(linux) || defined(__linux) || defined(__linux__)
 
+#if defined(__APPLE__) && defined(__MACH__) && !defined(BOOST_FILESYSTEM_DISABLE_XATTR)
+// Extended attribute functions on macOS take additional position and options arguments
+#include <sys/xattr.h>
+#define BOOST_FILESYSTEM_HAS_XATTR
+#define BOOST_FILESYSTEM_HAS_DARWIN_XATTR
+#endif
+
+#if defined(__APPLE__) && defined(__MACH__) && defined(__ENVIRONMENT_MAC_OS_X_VERSION_MIN_REQUIRED__) && \
+    __ENVIRONMENT_MAC_OS_X_VERSION_MIN_REQUIRED__ >= 101300 && defined(__has_include)
+#if __has_include(<sys/clonefile.h>)
+// fclonefileat is available since macOS 10.13
+#include <sys/clonefile.h>
+#define BOOST_FILESYSTEM_HAS_FCLONEFILEAT
+#endif
+#endif
+
+#if defined(__APPLE__) && defined(__MACH__) && defined(__ENVIRONMENT_MAC_OS_X_VERSION_MIN_REQUIRED__) && \
+    __ENVIRONMENT_MAC_OS_X_VERSION_MIN_REQUIRED__ >= 101200 && defined(RENAME_SWAP) && defined(RENAME_EXCL)
+// renamex_np is available since macOS 10.12
+#define BOOST_FILESYSTEM_HAS_RENAMEX_NP
+#endif
+
+#if defined(SEEK_DATA) && defined(SEEK_HOLE) && !defined(BOOST_FILESYSTEM_USE_WASI)
+#define BOOST_FILESYSTEM_HAS_SEEK_DATA
+#endif
+
 #if defined(POSIX_FADV_SEQUENTIAL) && (!defined(__ANDROID__) || __ANDROID_API__ >= 21)
 #define BOOST_FILESYSTEM_HAS_POSIX_FADVISE
 #endif
 
+#if defined(_POSIX_ADVISORY_INFO) && (_POSIX_ADVISORY_INFO + 0) > 0 && !defined(BOOST_FILESYSTEM_USE_WASI) && (!defined(__ANDROID__) || __ANDROID_API__ >= 21)
+#define BOOST_FILESYSTEM_HAS_POSIX_FALLOCATE
+#endif
+
+#if !defined(BOOST_FILESYSTEM_USE_WASI) && \
+    ((defined(_POSIX_VERSION) && _POSIX_VERSION >= 200809l) || defined(__GLIBC__) || (defined(__APPLE__) && defined(__MACH__)) || \
+    defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__))
+// realpath accepts a null buffer pointer and allocates the result since POSIX.1-2008
+#define BOOST_FILESYSTEM_HAS_REALPATH_ALLOC
+#endif
+
 #if defined(BOOST_FILESYSTEM_HAS_STAT_ST_MTIM)
 #define BOOST_FILESYSTEM_STAT_ST_MTIMENSEC st_mtim.tv_nsec
 #elif defined(BOOST_FILESYSTEM_HAS_STAT_ST_MTIMESPEC)
@@ -142,12 +256,19 @@
 #endif
 
 #include "posix_tools.hpp"
+#include "io_uring_tools.hpp"
+
+// io_uring is used by copy_file as one of the kernel data transfer methods, which share the per-device method cache
+#if defined(BOOST_FILESYSTEM_USE_IO_URING) && (defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE))
+#define BOOST_FILESYSTEM_USE_IO_URING_COPY
+#endif
 
 #else // BOOST_WINDOWS_API
 
 #include <boost/winapi/dll.hpp> // get_proc_address, GetModuleHandleW
 #include <cwchar>
 #include <io.h>
+#include <malloc.h> // _aligned_malloc, _aligned_free
 #include <windows.h>
 #include <winnt.h>
 #if defined(__BORLANDC__) || defined(__MWERKS__)
@@ -164,8 +285,23 @@ using std::time_t;
 #endif // BOOST_WINDOWS_API
 
 #include "atomic_tools.hpp"
+#include "descriptor_budget.hpp"
 #include "error_handling.hpp"
+#include "instrumentation.hpp"
+#include "tracing.hpp"
 #include "private_config.hpp"
+#include "thread_tools.hpp"
+#include "walk_scheduler.hpp"
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+#include <atomic>
+#include <memory> // std::shared_ptr
+#include <mutex>
+#endif
+
+#if !defined(BOOST_NO_CXX11_HDR_CHRONO)
+#include <chrono>
+#endif
 
 #include <boost/filesystem/detail/header.hpp> // must be the last #include
 
@@ -197,6 +333,44 @@ using boost::system::system_category;
 #define FSCTL_GET_REPARSE_POINT 0x900a8
 #endif
 
+#ifndef FSCTL_SET_SPARSE
+#define FSCTL_SET_SPARSE 0x900c4
+#endif
+
+#ifndef FSCTL_SET_ZERO_DATA
+#define FSCTL_SET_ZERO_DATA 0x980c8
+#endif
+
+#ifndef FSCTL_QUERY_ALLOCATED_RANGES
+#define FSCTL_QUERY_ALLOCATED_RANGES 0x940cf
+#endif
+
+#ifndef FSCTL_GET_INTEGRITY_INFORMATION
+#define FSCTL_GET_INTEGRITY_INFORMATION 0x9027c
+#endif
+
+#ifndef FSCTL_DUPLICATE_EXTENTS_TO_FILE
+#define FSCTL_DUPLICATE_EXTENTS_TO_FILE 0x98344
+#endif
+
+#ifndef FILE_SUPPORTS_BLOCK_REFCOUNTING
+#define FILE_SUPPORTS_BLOCK_REFCOUNTING 0x08000000
+#endif
+
+#ifndef ERROR_BLOCK_TOO_MANY_REFERENCES
+#define ERROR_BLOCK_TOO_MANY_REFERENCES 347
+#endif
+
+// Available since Windows Vista
+#ifndef COPY_FILE_NO_BUFFERING
+#define COPY_FILE_NO_BUFFERING 0x00001000
+#endif
+
+// Available since Windows 10 1903, with CopyFile2 only
+#ifndef COPY_FILE_REQUEST_COMPRESSED_TRAFFIC
+#define COPY_FILE_REQUEST_COMPRESSED_TRAFFIC 0x10000000
+#endif
+
 #ifndef SYMLINK_FLAG_RELATIVE
 #define SYMLINK_FLAG_RELATIVE 1
 #endif
@@ -239,14 +413,15 @@ namespace boost {
 namespace filesystem {
 namespace detail {
 
-#if defined(linux) || defined(__linux) || defined(__linux__)
-//! Initializes fill_random implementation pointer. Implemented in unique_path.cpp.
-void init_fill_random_impl(unsigned int major_ver, unsigned int minor_ver, unsigned int patch_ver);
-#endif // defined(linux) || defined(__linux) || defined(__linux__)
+//! Queries statuses of the targets of copy entries. Implemented in status_batch.cpp.
+void copy_file_targets_status(copy_file_entry const* entries, std::size_t count, file_status* results);
+
+//! Returns \c true if the directory is empty. Implemented in directory.cpp.
+bool is_empty_directory(path const& p, error_code* ec);
 
 #if defined(BOOST_WINDOWS_API) && !defined(UNDER_CE)
 //! Initializes directory iterator implementation. Implemented in directory.cpp.
-void init_directory_iterator_impl() BOOST_NOEXCEPT;
+void init_directory_iterator_impl(unsigned int major_ver) BOOST_NOEXCEPT;
 #endif // defined(BOOST_WINDOWS_API) && !defined(UNDER_CE)
 
 //--------------------------------------------------------------------------------------//
@@ -288,61 +463,187 @@ BOOST_CONSTEXPR_OR_CONST unsigned int symloop_max =
 
 //  general helpers  -----------------------------------------------------------------//
 
-bool is_empty_directory(path const& p, error_code* ec)
+bool not_found_error(int errval) BOOST_NOEXCEPT; // forward declaration
+
+//  gradual removal  -----------------------------------------------------------------//
+
+//! Minimum size of regular files that are truncated in steps before they are removed, or zero if gradual removal is disabled
+uintmax_t g_gradual_remove_min_file_size = 0u;
+//! Amount of data released by every truncation step
+uintmax_t g_gradual_remove_step_size = gradual_remove_params().step_size;
+//! Pause between the truncation steps, in microseconds
+unsigned int g_gradual_remove_step_interval = gradual_remove_params().step_interval;
+//! Indicates that the files are truncated by a task posted to the executor
+bool g_gradual_remove_background = false;
+
+//  copy buffers  --------------------------------------------------------------------//
+
+//! Alignment of the buffers used for copying file data. Page alignment makes the buffers usable for direct I/O.
+BOOST_CONSTEXPR_OR_CONST std::size_t copy_buffer_alignment = 4096u;
+
+//! Default allocation function for copy buffers, which uses the current memory allocator
+void* default_copy_buffer_allocate(std::size_t size, std::size_t alignment)
 {
-    fs::directory_iterator itr;
-    detail::directory_iterator_construct(itr, p, static_cast< unsigned int >(directory_options::none), NULL, ec);
-    return itr == fs::directory_iterator();
+    return detail::allocate_memory(size, alignment, std::nothrow);
 }
 
-bool not_found_error(int errval) BOOST_NOEXCEPT; // forward declaration
+//! Default deallocation function for copy buffers
+void default_copy_buffer_deallocate(void* buf, std::size_t size, std::size_t alignment)
+{
+    detail::deallocate_memory(buf, size, alignment);
+}
 
-#ifdef BOOST_POSIX_API
+const copy_buffer_allocator default_copy_buffer_allocator = { &default_copy_buffer_allocate, &default_copy_buffer_deallocate };
 
-//--------------------------------------------------------------------------------------//
-//                                                                                      //
-//                            POSIX-specific helpers                                    //
-//                                                                                      //
-//--------------------------------------------------------------------------------------//
+//! Current allocator of copy buffers
+copy_buffer_allocator const* g_copy_buffer_allocator = &default_copy_buffer_allocator;
 
-struct fd_wrapper
+//! Buffer for copying file data
+class copy_buffer
 {
-    int fd;
+private:
+    char* m_data;
+    std::size_t m_size;
+    copy_buffer_allocator const* m_allocator;
+    //! Memory allocator that was current when the buffer was allocated, which is used by the default copy buffer allocator
+    memory_allocator const* m_memory_allocator;
 
-    fd_wrapper() BOOST_NOEXCEPT : fd(-1) {}
-    explicit fd_wrapper(int fd) BOOST_NOEXCEPT : fd(fd) {}
-    ~fd_wrapper() BOOST_NOEXCEPT
+public:
+    copy_buffer() BOOST_NOEXCEPT :
+        m_data(NULL),
+        m_size(0u),
+        m_allocator(NULL),
+        m_memory_allocator(NULL)
     {
-        if (fd >= 0)
-            close_fd(fd);
     }
-    BOOST_DELETED_FUNCTION(fd_wrapper(fd_wrapper const&))
-    BOOST_DELETED_FUNCTION(fd_wrapper& operator=(fd_wrapper const&))
+
+    ~copy_buffer() BOOST_NOEXCEPT
+    {
+        clear();
+    }
+
+    BOOST_DELETED_FUNCTION(copy_buffer(copy_buffer const&))
+    BOOST_DELETED_FUNCTION(copy_buffer& operator=(copy_buffer const&))
+
+    char* data() const BOOST_NOEXCEPT { return m_data; }
+    std::size_t size() const BOOST_NOEXCEPT { return m_size; }
+
+    //! Makes sure the buffer is at least \a size bytes large and is allocated with the current allocator. Returns \c false if allocation fails.
+    bool reserve(std::size_t size) BOOST_NOEXCEPT
+    {
+        copy_buffer_allocator const* allocator = filesystem::detail::atomic_load_acquire(g_copy_buffer_allocator);
+        memory_allocator const* mem_allocator = get_memory_allocator();
+        if (m_size >= size && m_allocator == allocator && m_memory_allocator == mem_allocator)
+            return true;
+
+        clear();
+
+        m_data = static_cast< char* >(allocator->allocate(size, copy_buffer_alignment));
+        if (BOOST_UNLIKELY(!m_data))
+            return false;
+
+        m_size = size;
+        m_allocator = allocator;
+        m_memory_allocator = mem_allocator;
+        return true;
+    }
+
+    void clear() BOOST_NOEXCEPT
+    {
+        if (m_data)
+        {
+            m_allocator->deallocate(m_data, m_size, copy_buffer_alignment);
+            m_data = NULL;
+            m_size = 0u;
+            m_allocator = NULL;
+            m_memory_allocator = NULL;
+        }
+    }
 };
 
-inline bool not_found_error(int errval) BOOST_NOEXCEPT
+#if defined(BOOST_FILESYSTEM_SINGLE_THREADED) || !defined(BOOST_NO_CXX11_THREAD_LOCAL)
+
+#define BOOST_FILESYSTEM_HAS_CACHED_COPY_BUFFER
+
+//! Copy buffer that is reused by copy operations in the current thread
+struct cached_copy_buffer
 {
-    return errval == ENOENT || errval == ENOTDIR;
-}
+    copy_buffer buffer;
+    bool in_use;
 
-#if defined(BOOST_FILESYSTEM_HAS_STATX)
+    cached_copy_buffer() BOOST_NOEXCEPT : in_use(false) {}
+};
 
-//! A wrapper for statx libc function. Disable MSAN since at least on clang 10 it doesn't
-//! know which fields of struct statx are initialized by the syscall and misdetects errors.
-BOOST_FILESYSTEM_NO_SANITIZE_MEMORY
-BOOST_FORCEINLINE int invoke_statx(int dirfd, const char* path, int flags, unsigned int mask, struct ::statx* stx)
+#if defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+cached_copy_buffer g_cached_copy_buffer;
+#else
+thread_local cached_copy_buffer g_cached_copy_buffer;
+#endif
+
+#endif // defined(BOOST_FILESYSTEM_SINGLE_THREADED) || !defined(BOOST_NO_CXX11_THREAD_LOCAL)
+
+//! Scoped reference to a copy buffer. Uses the buffer cached in the current thread, unless it is already in use.
+class scoped_copy_buffer
+{
+private:
+    copy_buffer m_local;
+    copy_buffer* m_buffer;
+
+public:
+    scoped_copy_buffer() BOOST_NOEXCEPT :
+        m_buffer(&m_local)
+    {
+#if defined(BOOST_FILESYSTEM_HAS_CACHED_COPY_BUFFER)
+        cached_copy_buffer& cached = g_cached_copy_buffer;
+        if (!cached.in_use)
+        {
+            cached.in_use = true;
+            m_buffer = &cached.buffer;
+        }
+#endif
+    }
+
+    ~scoped_copy_buffer() BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_CACHED_COPY_BUFFER)
+        if (m_buffer != &m_local)
+            g_cached_copy_buffer.in_use = false;
+#endif
+    }
+
+    BOOST_DELETED_FUNCTION(scoped_copy_buffer(scoped_copy_buffer const&))
+    BOOST_DELETED_FUNCTION(scoped_copy_buffer& operator=(scoped_copy_buffer const&))
+
+    char* data() const BOOST_NOEXCEPT { return m_buffer->data(); }
+    std::size_t size() const BOOST_NOEXCEPT { return m_buffer->size(); }
+
+    //! Makes sure the buffer is at least \a size bytes large. Returns \c false if allocation fails.
+    bool reserve(std::size_t size) BOOST_NOEXCEPT { return m_buffer->reserve(size); }
+};
+
+#ifdef BOOST_POSIX_API
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                            POSIX-specific helpers                                    //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+inline bool not_found_error(int errval) BOOST_NOEXCEPT
 {
-    return ::statx(dirfd, path, flags, mask, stx);
+    return errval == ENOENT || errval == ENOTDIR;
 }
 
-#elif defined(BOOST_FILESYSTEM_HAS_STATX_SYSCALL)
+#if defined(BOOST_FILESYSTEM_USE_STATX)
 
 //! statx emulation through fstatat
 int statx_fstatat(int dirfd, const char* path, int flags, unsigned int mask, struct ::statx* stx)
 {
     struct ::stat st;
     flags &= AT_EMPTY_PATH | AT_NO_AUTOMOUNT | AT_SYMLINK_NOFOLLOW;
+    instrumentation_timer timer;
     int res = ::fstatat(dirfd, path, &st, flags);
+    timer.record(instrumented_operation::stat);
     if (BOOST_LIKELY(res == 0))
     {
         std::memset(stx, 0, sizeof(*stx));
@@ -372,25 +673,44 @@ int statx_fstatat(int dirfd, const char* path, int flags, unsigned int mask, str
 
 typedef int statx_t(int dirfd, const char* path, int flags, unsigned int mask, struct ::statx* stx);
 
-//! Pointer to the actual implementation of the statx implementation
-statx_t* statx_ptr = &statx_fstatat;
+#if defined(BOOST_FILESYSTEM_HAS_STATX)
 
-inline int invoke_statx(int dirfd, const char* path, int flags, unsigned int mask, struct ::statx* stx) BOOST_NOEXCEPT
+//! A wrapper for statx libc function. Disable MSAN since at least on clang 10 it doesn't
+//! know which fields of struct statx are initialized by the syscall and misdetects errors.
+BOOST_FILESYSTEM_NO_SANITIZE_MEMORY
+int statx_libc(int dirfd, const char* path, int flags, unsigned int mask, struct ::statx* stx)
 {
-    return filesystem::detail::atomic_load_relaxed(statx_ptr)(dirfd, path, flags, mask, stx);
+    instrumentation_timer timer;
+    int res = ::statx(dirfd, path, flags, mask, stx);
+    timer.record(instrumented_operation::statx);
+    return res;
 }
 
+//! Pointer to the actual implementation of the statx implementation
+statx_t* statx_ptr = &statx_libc;
+
+#else // defined(BOOST_FILESYSTEM_HAS_STATX)
+
+int statx_select_impl(int dirfd, const char* path, int flags, unsigned int mask, struct ::statx* stx);
+
+//! Pointer to the actual implementation of the statx implementation. Initialized to the implementation selector, which is replaced on the first call.
+statx_t* statx_ptr = &statx_select_impl;
+
 //! A wrapper for the statx syscall. Disable MSAN since at least on clang 10 it doesn't
 //! know which fields of struct statx are initialized by the syscall and misdetects errors.
 BOOST_FILESYSTEM_NO_SANITIZE_MEMORY
 int statx_syscall(int dirfd, const char* path, int flags, unsigned int mask, struct ::statx* stx)
 {
+    instrumentation_timer timer;
     int res = ::syscall(__NR_statx, dirfd, path, flags, mask, stx);
+    timer.record(instrumented_operation::statx);
     if (res < 0)
     {
         const int err = errno;
         if (BOOST_UNLIKELY(err == ENOSYS))
         {
+            record_instrumented_event(instrumented_operation::implementation_fallback);
+            BOOST_FILESYSTEM_TRACE1(statx__downgrade, err);
             filesystem::detail::atomic_store_relaxed(statx_ptr, &statx_fstatat);
             return statx_fstatat(dirfd, path, flags, mask, stx);
         }
@@ -399,23 +719,33 @@ int statx_syscall(int dirfd, const char* path, int flags, unsigned int mask, str
     return res;
 }
 
-#endif // defined(BOOST_FILESYSTEM_HAS_STATX)
-
-#if defined(linux) || defined(__linux) || defined(__linux__)
-
-//! Initializes statx implementation pointer
-inline void init_statx_impl(unsigned int major_ver, unsigned int minor_ver, unsigned int patch_ver)
+//! Selects the statx implementation based on the kernel version
+statx_t* init_statx_impl() BOOST_NOEXCEPT
 {
-#if !defined(BOOST_FILESYSTEM_HAS_STATX) && defined(BOOST_FILESYSTEM_HAS_STATX_SYSCALL)
     statx_t* stx = &statx_fstatat;
-    if (major_ver > 4u || (major_ver == 4u && minor_ver >= 11u))
+    // statx was added in Linux 4.11
+    unsigned int major_ver = 0u, minor_ver = 0u, patch_ver = 0u;
+    if (get_linux_kernel_version(major_ver, minor_ver, patch_ver) && (major_ver > 4u || (major_ver == 4u && minor_ver >= 11u)))
         stx = &statx_syscall;
 
     filesystem::detail::atomic_store_relaxed(statx_ptr, stx);
-#endif // !defined(BOOST_FILESYSTEM_HAS_STATX) && defined(BOOST_FILESYSTEM_HAS_STATX_SYSCALL)
+    return stx;
 }
 
-#endif // defined(linux) || defined(__linux) || defined(__linux__)
+//! Selects the statx implementation on the first call and forwards the call to it
+int statx_select_impl(int dirfd, const char* path, int flags, unsigned int mask, struct ::statx* stx)
+{
+    return init_statx_impl()(dirfd, path, flags, mask, stx);
+}
+
+#endif // defined(BOOST_FILESYSTEM_HAS_STATX)
+
+inline int invoke_statx(int dirfd, const char* path, int flags, unsigned int mask, struct ::statx* stx) BOOST_NOEXCEPT
+{
+    return filesystem::detail::atomic_load_relaxed(statx_ptr)(dirfd, path, flags, mask, stx);
+}
+
+#endif // defined(BOOST_FILESYSTEM_USE_STATX)
 
 #if defined(BOOST_FILESYSTEM_USE_STATX)
 
@@ -443,6 +773,18 @@ inline std::size_t get_blksize(struct ::statx const& st) BOOST_NOEXCEPT
     return st.stx_blksize;
 }
 
+//! Returns the device containing the file from \c statx structure
+inline dev_t get_dev(struct ::statx const& st) BOOST_NOEXCEPT
+{
+    return makedev(st.stx_dev_major, st.stx_dev_minor);
+}
+
+//! Returns \c true if the file described by \c statx structure may contain holes
+inline bool is_sparse(struct ::statx const& st) BOOST_NOEXCEPT
+{
+    return (st.stx_mask & STATX_BLOCKS) != 0u && st.stx_blocks * 512u < st.stx_size;
+}
+
 #else // defined(BOOST_FILESYSTEM_USE_STATX)
 
 //! Returns \c true if the two \c stat structures refer to the same file
@@ -465,6 +807,12 @@ inline uintmax_t get_size(struct ::stat const& st) BOOST_NOEXCEPT
     return st.st_size;
 }
 
+//! Returns the device containing the file from \c stat structure
+inline dev_t get_dev(struct ::stat const& st) BOOST_NOEXCEPT
+{
+    return st.st_dev;
+}
+
 //! Returns optimal block size from \c stat structure
 inline std::size_t get_blksize(struct ::stat const& st) BOOST_NOEXCEPT
 {
@@ -475,6 +823,16 @@ inline std::size_t get_blksize(struct ::stat const& st) BOOST_NOEXCEPT
 #endif
 }
 
+//! Returns \c true if the file described by \c stat structure may contain holes
+inline bool is_sparse(struct ::stat const& st) BOOST_NOEXCEPT
+{
+#if !defined(BOOST_FILESYSTEM_USE_WASI)
+    return static_cast< uintmax_t >(st.st_blocks) * 512u < static_cast< uintmax_t >(st.st_size);
+#else
+    return false;
+#endif
+}
+
 #endif // defined(BOOST_FILESYSTEM_USE_STATX)
 
 //! status() implementation
@@ -485,17 +843,24 @@ file_status status_impl
 #if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) || defined(BOOST_FILESYSTEM_USE_STATX)
     , int basedir_fd = AT_FDCWD
 #endif
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    , int sync_flags = 0
+#endif
 )
 {
 #if defined(BOOST_FILESYSTEM_USE_STATX)
     struct ::statx path_stat;
-    int err = invoke_statx(basedir_fd, p.c_str(), AT_NO_AUTOMOUNT, STATX_TYPE | STATX_MODE, &path_stat);
+    int err = invoke_statx(basedir_fd, p.c_str(), AT_NO_AUTOMOUNT | sync_flags, STATX_TYPE | STATX_MODE, &path_stat);
 #elif defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
     struct ::stat path_stat;
+    instrumentation_timer timer;
     int err = ::fstatat(basedir_fd, p.c_str(), &path_stat, AT_NO_AUTOMOUNT);
+    timer.record(instrumented_operation::stat);
 #else
     struct ::stat path_stat;
+    instrumentation_timer timer;
     int err = ::stat(p.c_str(), &path_stat);
+    timer.record(instrumented_operation::stat);
 #endif
 
     if (err != 0)
@@ -546,17 +911,24 @@ file_status symlink_status_impl
 #if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) || defined(BOOST_FILESYSTEM_USE_STATX)
     , int basedir_fd = AT_FDCWD
 #endif
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    , int sync_flags = 0
+#endif
 )
 {
 #if defined(BOOST_FILESYSTEM_USE_STATX)
     struct ::statx path_stat;
-    int err = invoke_statx(basedir_fd, p.c_str(), AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, STATX_TYPE | STATX_MODE, &path_stat);
+    int err = invoke_statx(basedir_fd, p.c_str(), AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT | sync_flags, STATX_TYPE | STATX_MODE, &path_stat);
 #elif defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
     struct ::stat path_stat;
+    instrumentation_timer timer;
     int err = ::fstatat(basedir_fd, p.c_str(), &path_stat, AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT);
+    timer.record(instrumented_operation::stat);
 #else
     struct ::stat path_stat;
+    instrumentation_timer timer;
     int err = ::lstat(p.c_str(), &path_stat);
+    timer.record(instrumented_operation::stat);
 #endif
 
     if (err != 0)
@@ -601,6 +973,42 @@ file_status symlink_status_impl
     return fs::file_status(fs::type_unknown);
 }
 
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+typedef struct ::statx entry_stat_t;
+#else
+typedef struct ::stat entry_stat_t;
+#endif
+
+//! Queries the file status and attributes for directory_entry. Returns 0 on success or the error code otherwise.
+//! \a sync_flags are the \c statx flags selecting the consistency of the attributes and are ignored if \c statx is not used.
+inline int entry_stat(int basedir_fd, const char* p, bool follow_symlinks, int sync_flags, entry_stat_t& st) BOOST_NOEXCEPT
+{
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    int res = invoke_statx(basedir_fd, p, (follow_symlinks ? 0 : AT_SYMLINK_NOFOLLOW) | AT_NO_AUTOMOUNT | sync_flags, STATX_TYPE | STATX_MODE | STATX_SIZE | STATX_MTIME | STATX_NLINK | STATX_INO, &st);
+#elif defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    (void)sync_flags;
+    instrumentation_timer timer;
+    int res = ::fstatat(basedir_fd, p, &st, (follow_symlinks ? 0 : AT_SYMLINK_NOFOLLOW) | AT_NO_AUTOMOUNT);
+    timer.record(instrumented_operation::stat);
+#else
+    (void)basedir_fd;
+    (void)sync_flags;
+    instrumentation_timer timer;
+    int res = follow_symlinks ? ::stat(p, &st) : ::lstat(p, &st);
+    timer.record(instrumented_operation::stat);
+#endif
+
+    if (BOOST_UNLIKELY(res != 0))
+        return errno;
+
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    if (BOOST_UNLIKELY((st.stx_mask & (STATX_TYPE | STATX_MODE)) != (STATX_TYPE | STATX_MODE)))
+        return BOOST_ERROR_NOT_SUPPORTED;
+#endif
+
+    return 0;
+}
+
 //! Flushes buffered data and attributes written to the file to permanent storage
 inline int full_sync(int fd)
 {
@@ -656,35 +1064,196 @@ inline int data_sync(int fd)
 #endif
 }
 
-// Min and max buffer sizes are selected to minimize the overhead from system calls.
-// The values are picked based on coreutils cp(1) benchmarking data described here:
-// https://github.com/coreutils/coreutils/blob/d1b0257077c0b0f0ee25087efd46270345d1dd1f/src/ioblksize.h#L23-L72
-BOOST_CONSTEXPR_OR_CONST uint_least32_t min_read_write_buf_size = 8u * 1024u;
-BOOST_CONSTEXPR_OR_CONST uint_least32_t max_read_write_buf_size = 256u * 1024u;
-
-//! copy_file read/write loop implementation
-int copy_file_data_read_write_impl(int infile, int outfile, char* buf, std::size_t buf_size)
+/*!
+ * Allocates storage for \a size bytes of the file starting at \a offset. If \a keep_size is \c true, the file size is not changed.
+ * Returns \c ENOTSUP if the filesystem does not support preallocation.
+ */
+inline int preallocate_file(int fd, uintmax_t offset, uintmax_t size, bool keep_size)
 {
-#if defined(BOOST_FILESYSTEM_HAS_POSIX_FADVISE)
-    ::posix_fadvise(infile, 0, 0, POSIX_FADV_SEQUENTIAL);
+#if defined(BOOST_FILESYSTEM_HAS_FALLOCATE)
+    while (true)
+    {
+        // Unlike posix_fallocate, fallocate does not emulate preallocation by writing zeros if the filesystem does not support it
+        if (BOOST_LIKELY(::fallocate(fd, keep_size ? FALLOC_FL_KEEP_SIZE : 0, static_cast< off_t >(offset), static_cast< off_t >(size)) == 0))
+            return 0;
+
+        const int err = errno;
+        if (err == EINTR)
+            continue;
+
+        if (err == EOPNOTSUPP || err == ENOTSUP || err == ENOSYS)
+            return ENOTSUP;
+
+        return err;
+    }
+#elif defined(BOOST_FILESYSTEM_HAS_POSIX_FALLOCATE)
+    // posix_fallocate always extends the file
+    if (keep_size)
+        return ENOTSUP;
+
+    while (true)
+    {
+        // Note: posix_fallocate returns the error code instead of setting errno
+        const int err = ::posix_fallocate(fd, static_cast< off_t >(offset), static_cast< off_t >(size));
+        if (err == EINTR)
+            continue;
+
+        // EINVAL is returned by some systems (e.g. FreeBSD on ZFS) if the filesystem does not support preallocation
+        if (err == EOPNOTSUPP || err == ENOTSUP || err == ENOSYS || err == EINVAL)
+            return ENOTSUP;
+
+        return err;
+    }
+#else
+    (void)fd;
+    (void)offset;
+    (void)size;
+    (void)keep_size;
+    return ENOTSUP;
 #endif
+}
 
-    // Don't use file size to limit the amount of data to copy since some filesystems, like procfs or sysfs,
-    // provide files with generated content and indicate that their size is zero or 4096. Just copy as much data
-    // as we can read from the input file.
+/*!
+ * Deallocates storage of \a size bytes of the file starting at \a offset. The range reads as zeros afterwards, the file size is not changed.
+ * Returns \c ENOTSUP if the filesystem does not support deallocation.
+ */
+inline int punch_hole_file(int fd, uintmax_t offset, uintmax_t size)
+{
+#if defined(BOOST_FILESYSTEM_HAS_FALLOCATE)
     while (true)
     {
-        ssize_t sz_read = ::read(infile, buf, buf_size);
-        if (sz_read == 0)
-            break;
-        if (BOOST_UNLIKELY(sz_read < 0))
+        if (BOOST_LIKELY(::fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, static_cast< off_t >(offset), static_cast< off_t >(size)) == 0))
+            return 0;
+
+        const int err = errno;
+        if (err == EINTR)
+            continue;
+
+        if (err == EOPNOTSUPP || err == ENOTSUP || err == ENOSYS)
+            return ENOTSUP;
+
+        return err;
+    }
+#else
+    (void)fd;
+    (void)offset;
+    (void)size;
+    return ENOTSUP;
+#endif
+}
+
+//! Writes zeros to \a size bytes of the file starting at \a offset, not beyond the end of the file. Returns 0 on success, otherwise an error code.
+int write_zeros(int fd, uintmax_t offset, uintmax_t size)
+{
+    struct ::stat st;
+    if (BOOST_UNLIKELY(::fstat(fd, &st) != 0))
+        return errno;
+
+    const uintmax_t file_size = static_cast< uintmax_t >(st.st_size);
+    if (offset >= file_size)
+        return 0;
+    if (size > file_size - offset)
+        size = file_size - offset;
+
+    char zeros[4096] = {};
+    while (size > 0u)
+    {
+        const std::size_t chunk_size = size < sizeof(zeros) ? static_cast< std::size_t >(size) : sizeof(zeros);
+        const ssize_t written = ::pwrite(fd, zeros, chunk_size, static_cast< off_t >(offset));
+        if (BOOST_UNLIKELY(written < 0))
         {
-            int err = errno;
+            const int err = errno;
             if (err == EINTR)
                 continue;
             return err;
         }
 
+        offset += static_cast< uintmax_t >(written);
+        size -= static_cast< uintmax_t >(written);
+    }
+
+    return 0;
+}
+
+//! Makes \a size bytes of the file starting at \a offset read as zeros, keeping the storage allocated. The file size is not changed.
+int zero_range_file(int fd, uintmax_t offset, uintmax_t size)
+{
+#if defined(BOOST_FILESYSTEM_HAS_FALLOCATE)
+    while (true)
+    {
+        // Converts the range to unwritten extents without writing data
+        if (BOOST_LIKELY(::fallocate(fd, FALLOC_FL_ZERO_RANGE | FALLOC_FL_KEEP_SIZE, static_cast< off_t >(offset), static_cast< off_t >(size)) == 0))
+            return 0;
+
+        const int err = errno;
+        if (err == EINTR)
+            continue;
+
+        if (err != EOPNOTSUPP && err != ENOTSUP && err != ENOSYS)
+            return err;
+
+        break;
+    }
+#endif
+
+    // Some filesystems (e.g. tmpfs) support deallocating but not zeroing ranges. The storage is allocated again after deallocation.
+    int err = punch_hole_file(fd, offset, size);
+    if (err == 0)
+    {
+        err = preallocate_file(fd, offset, size, true);
+        return err == ENOTSUP ? 0 : err;
+    }
+
+    if (err != ENOTSUP)
+        return err;
+
+    return write_zeros(fd, offset, size);
+}
+
+// Min and max buffer sizes are selected to minimize the overhead from system calls.
+// The values are picked based on coreutils cp(1) benchmarking data described here:
+// https://github.com/coreutils/coreutils/blob/d1b0257077c0b0f0ee25087efd46270345d1dd1f/src/ioblksize.h#L23-L72
+BOOST_CONSTEXPR_OR_CONST uint_least32_t min_read_write_buf_size = 8u * 1024u;
+BOOST_CONSTEXPR_OR_CONST uint_least32_t max_read_write_buf_size = 256u * 1024u;
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_FADVISE)
+//! Amount of copied data after which the cached pages of the copied files are dropped, if requested
+BOOST_CONSTEXPR_OR_CONST off_t drop_cache_window_size = 8 * 1024 * 1024;
+#endif
+
+//! copy_file read/write loop implementation. If \a hasher is not \c NULL, the copied data is fed to it with \a hasher_state.
+int copy_file_data_read_write_impl(int infile, int outfile, char* buf, std::size_t buf_size, bool drop_cache, copy_file_hasher const* hasher, void* hasher_state)
+{
+    instrumentation_scope instrumentation(instrumented_operation::copy_read_write);
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_FADVISE)
+    ::posix_fadvise(infile, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    // Offsets up to which the cached pages of the source and target files have been dropped
+    off_t pos = 0, in_dropped = 0, out_dropped = 0;
+#else
+    (void)drop_cache;
+#endif
+
+    // Don't use file size to limit the amount of data to copy since some filesystems, like procfs or sysfs,
+    // provide files with generated content and indicate that their size is zero or 4096. Just copy as much data
+    // as we can read from the input file.
+    while (true)
+    {
+        ssize_t sz_read = ::read(infile, buf, buf_size);
+        if (sz_read == 0)
+            break;
+        if (BOOST_UNLIKELY(sz_read < 0))
+        {
+            int err = errno;
+            if (err == EINTR)
+                continue;
+            return err;
+        }
+
+        if (hasher)
+            hasher->update(hasher_state, buf, static_cast< std::size_t >(sz_read));
+
         // Allow for partial writes - see Advanced Unix Programming (2nd Ed.),
         // Marc Rochkind, Addison-Wesley, 2004, page 94
         for (ssize_t sz_wrote = 0; sz_wrote < sz_read;)
@@ -700,3888 +1269,13981 @@ int copy_file_data_read_write_impl(int infile, int outfile, char* buf, std::size
 
             sz_wrote += sz;
         }
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_FADVISE)
+        if (drop_cache)
+        {
+            pos += sz_read;
+            if ((pos - in_dropped) >= drop_cache_window_size)
+            {
+                ::posix_fadvise(infile, in_dropped, pos - in_dropped, POSIX_FADV_DONTNEED);
+                // Dirty pages of the target file cannot be dropped until they are written back. On Linux, POSIX_FADV_DONTNEED
+                // initiates writeback of the dirty pages, so the pages written in the previous window are likely clean by now.
+                if (in_dropped > out_dropped)
+                    ::posix_fadvise(outfile, out_dropped, in_dropped - out_dropped, POSIX_FADV_DONTNEED);
+                ::posix_fadvise(outfile, in_dropped, pos - in_dropped, POSIX_FADV_DONTNEED);
+                out_dropped = in_dropped;
+                in_dropped = pos;
+            }
+        }
+#endif
+    }
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_FADVISE)
+    if (drop_cache)
+    {
+        ::posix_fadvise(infile, in_dropped, 0, POSIX_FADV_DONTNEED);
+        ::posix_fadvise(outfile, out_dropped, 0, POSIX_FADV_DONTNEED);
     }
+#endif
 
     return 0;
 }
 
 //! copy_file implementation that uses read/write loop (fallback using a stack buffer)
-int copy_file_data_read_write_stack_buf(int infile, int outfile)
+int copy_file_data_read_write_stack_buf(int infile, int outfile, bool drop_cache, copy_file_hasher const* hasher, void* hasher_state)
 {
     char stack_buf[min_read_write_buf_size];
-    return copy_file_data_read_write_impl(infile, outfile, stack_buf, sizeof(stack_buf));
+    return copy_file_data_read_write_impl(infile, outfile, stack_buf, sizeof(stack_buf), drop_cache, hasher, hasher_state);
 }
 
-//! copy_file implementation that uses read/write loop
-int copy_file_data_read_write(int infile, int outfile, uintmax_t size, std::size_t blksize)
+//! Returns the buffer size to use for a read/write loop to copy the given amount of data
+inline std::size_t get_read_write_buf_size(uintmax_t size, std::size_t blksize) BOOST_NOEXCEPT
+{
+    uintmax_t buf_sz = size;
+    // Prefer the buffer to be larger than the file size so that we don't have
+    // to perform an extra read if the file fits in the buffer exactly.
+    buf_sz += (buf_sz < ~static_cast< uintmax_t >(0u));
+    if (buf_sz < blksize)
+        buf_sz = blksize;
+    if (buf_sz < min_read_write_buf_size)
+        buf_sz = min_read_write_buf_size;
+    if (buf_sz > max_read_write_buf_size)
+        buf_sz = max_read_write_buf_size;
+    return static_cast< std::size_t >(boost::core::bit_ceil(static_cast< uint_least32_t >(buf_sz)));
+}
+
+//! copy_file implementation that uses read/write loop, optionally drops the cached pages of the copied files and hashes the copied data
+int copy_file_data_read_write(int infile, int outfile, uintmax_t size, std::size_t blksize, bool drop_cache, copy_file_hasher const* hasher, void* hasher_state)
 {
     {
-        uintmax_t buf_sz = size;
-        // Prefer the buffer to be larger than the file size so that we don't have
-        // to perform an extra read if the file fits in the buffer exactly.
-        buf_sz += (buf_sz < ~static_cast< uintmax_t >(0u));
-        if (buf_sz < blksize)
-            buf_sz = blksize;
-        if (buf_sz < min_read_write_buf_size)
-            buf_sz = min_read_write_buf_size;
-        if (buf_sz > max_read_write_buf_size)
-            buf_sz = max_read_write_buf_size;
-        const std::size_t buf_size = static_cast< std::size_t >(boost::core::bit_ceil(static_cast< uint_least32_t >(buf_sz)));
-        boost::scoped_array< char > buf(new (std::nothrow) char[buf_size]);
-        if (BOOST_LIKELY(!!buf.get()))
-            return copy_file_data_read_write_impl(infile, outfile, buf.get(), buf_size);
+        scoped_copy_buffer buf;
+        if (BOOST_LIKELY(buf.reserve(get_read_write_buf_size(size, blksize))))
+            return copy_file_data_read_write_impl(infile, outfile, buf.data(), buf.size(), drop_cache, hasher, hasher_state);
     }
 
-    return copy_file_data_read_write_stack_buf(infile, outfile);
+    return copy_file_data_read_write_stack_buf(infile, outfile, drop_cache, hasher, hasher_state);
 }
 
-typedef int copy_file_data_t(int infile, int outfile, uintmax_t size, std::size_t blksize);
-
-//! Pointer to the actual implementation of the copy_file_data implementation
-copy_file_data_t* copy_file_data = &copy_file_data_read_write;
-
-#if defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
-
-//! copy_file_data wrapper that tests if a read/write loop must be used for a given filesystem
-template< typename CopyFileData >
-int check_fs_type(int infile, int outfile, uintmax_t size, std::size_t blksize);
+//! copy_file implementation that uses read/write loop and optionally drops the cached pages of the copied files
+int copy_file_data_read_write(int infile, int outfile, uintmax_t size, std::size_t blksize, bool drop_cache)
+{
+    return copy_file_data_read_write(infile, outfile, size, blksize, drop_cache, NULL, NULL);
+}
 
-#endif // defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+//! copy_file implementation that uses read/write loop
+int copy_file_data_read_write(int infile, int outfile, uintmax_t size, std::size_t blksize)
+{
+    return copy_file_data_read_write(infile, outfile, size, blksize, false);
+}
 
-#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
+//! Maximum size of a file that is copied with \c copy_file_data_small
+BOOST_CONSTEXPR_OR_CONST uint_least32_t max_small_file_size = 64u * 1024u;
 
-struct copy_file_data_sendfile
+//! copy_file implementation for small files. Copies the file with a single read and write, if possible, without detecting the filesystem type or advising the kernel on the access pattern.
+int copy_file_data_small(int infile, int outfile, uintmax_t size)
 {
-    //! copy_file implementation that uses sendfile loop. Requires sendfile to support file descriptors.
-    static int impl(int infile, int outfile, uintmax_t size, std::size_t blksize)
-    {
-        // sendfile will not send more than this amount of data in one call
-        BOOST_CONSTEXPR_OR_CONST std::size_t max_batch_size = 0x7ffff000u;
-        uintmax_t offset = 0u;
-        while (offset < size)
-        {
-            uintmax_t size_left = size - offset;
-            std::size_t size_to_copy = max_batch_size;
-            if (size_left < static_cast< uintmax_t >(max_batch_size))
-                size_to_copy = static_cast< std::size_t >(size_left);
-            ssize_t sz = ::sendfile(outfile, infile, NULL, size_to_copy);
-            if (BOOST_UNLIKELY(sz < 0))
-            {
-                int err = errno;
-                if (err == EINTR)
-                    continue;
+    scoped_copy_buffer buf;
+    if (BOOST_UNLIKELY(!buf.reserve(get_read_write_buf_size(size, 0u))))
+        return copy_file_data_read_write_stack_buf(infile, outfile, false, NULL, NULL);
 
-                if (offset == 0u)
-                {
-                    // sendfile may fail with EINVAL if the underlying filesystem does not support it
-                    if (err == EINVAL)
-                    {
-                    fallback_to_read_write:
-                        return copy_file_data_read_write(infile, outfile, size, blksize);
-                    }
+    instrumentation_scope instrumentation(instrumented_operation::copy_read_write);
 
-                    if (err == ENOSYS)
-                    {
-                        filesystem::detail::atomic_store_relaxed(copy_file_data, &copy_file_data_read_write);
-                        goto fallback_to_read_write;
-                    }
-                }
+    ssize_t sz_read;
+    while (true)
+    {
+        sz_read = ::read(infile, buf.data(), buf.size());
+        if (BOOST_LIKELY(sz_read >= 0))
+            break;
 
-                return err;
-            }
+        int err = errno;
+        if (err != EINTR)
+            return err;
+    }
 
-            offset += sz;
+    for (ssize_t sz_wrote = 0; sz_wrote < sz_read;)
+    {
+        ssize_t sz = ::write(outfile, buf.data() + sz_wrote, static_cast< std::size_t >(sz_read - sz_wrote));
+        if (BOOST_UNLIKELY(sz < 0))
+        {
+            int err = errno;
+            if (err == EINTR)
+                continue;
+            return err;
         }
 
-        return 0;
+        sz_wrote += sz;
     }
-};
 
-#endif // defined(BOOST_FILESYSTEM_USE_SENDFILE)
+    // Like the other copy_file implementations, the file size limits the amount of data to copy. If the read returned less data,
+    // the file may have been truncated or have generated content, which may be returned by multiple reads. Copy the rest of
+    // the data, until the end of file is reached.
+    if (static_cast< uintmax_t >(sz_read) < size && sz_read > 0)
+        return copy_file_data_read_write_impl(infile, outfile, buf.data(), buf.size(), false, NULL, NULL);
 
-#if defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+    return 0;
+}
 
-struct copy_file_data_copy_file_range
+//! copy_file_data implementation that uses read/write loop regardless of the source and target devices
+int copy_file_data_plain(int infile, int outfile, uintmax_t size, std::size_t blksize, dev_t, dev_t)
 {
-    //! copy_file implementation that uses copy_file_range loop. Requires copy_file_range to support cross-filesystem copying.
-    static int impl(int infile, int outfile, uintmax_t size, std::size_t blksize)
+    return copy_file_data_read_write(infile, outfile, size, blksize, false);
+}
+
+/*!
+ * Reads the file \a p and feeds its contents to \a hasher with \a hasher_state. If \a drop_cache is \c true, the cached pages
+ * of the file are discarded before reading, so that the data is read from the storage. Returns 0 on success or an error code.
+ */
+int hash_file_data(path const& p, uintmax_t size, std::size_t blksize, bool drop_cache, copy_file_hasher const& hasher, void* hasher_state)
+{
+    fd_wrapper file;
+    while (true)
     {
-        // Although copy_file_range does not document any particular upper limit of one transfer, still use some upper bound to guarantee
-        // that size_t is not overflown in case if off_t is larger and the file size does not fit in size_t.
-        BOOST_CONSTEXPR_OR_CONST std::size_t max_batch_size = 0x7ffff000u;
-        uintmax_t offset = 0u;
-        while (offset < size)
+        file.fd = ::open(p.c_str(), O_RDONLY | O_CLOEXEC);
+        if (BOOST_UNLIKELY(file.fd < 0))
         {
-            uintmax_t size_left = size - offset;
-            std::size_t size_to_copy = max_batch_size;
-            if (size_left < static_cast< uintmax_t >(max_batch_size))
-                size_to_copy = static_cast< std::size_t >(size_left);
-            // Note: Use syscall directly to avoid depending on libc version. copy_file_range is added in glibc 2.27.
-            // uClibc-ng does not have copy_file_range as of the time of this writing (the latest uClibc-ng release is 1.0.33).
-            loff_t sz = ::syscall(__NR_copy_file_range, infile, (loff_t*)NULL, outfile, (loff_t*)NULL, size_to_copy, (unsigned int)0u);
-            if (BOOST_UNLIKELY(sz < 0))
-            {
-                int err = errno;
-                if (err == EINTR)
-                    continue;
-
-                if (offset == 0u)
-                {
-                    // copy_file_range may fail with EINVAL if the underlying filesystem does not support it.
-                    // In some RHEL/CentOS 7.7-7.8 kernel versions, copy_file_range on NFSv4 is also known to return EOPNOTSUPP
-                    // if the remote server does not support COPY, despite that it is not a documented error code.
-                    // See https://patchwork.kernel.org/project/linux-nfs/patch/20190411183418.4510-1-olga.kornievskaia@gmail.com/
-                    // and https://bugzilla.redhat.com/show_bug.cgi?id=1783554.
-                    if (err == EINVAL || err == EOPNOTSUPP)
-                    {
-#if !defined(BOOST_FILESYSTEM_USE_SENDFILE)
-                    fallback_to_read_write:
-#endif
-                        return copy_file_data_read_write(infile, outfile, size, blksize);
-                    }
+            const int err = errno;
+            if (err == EINTR)
+                continue;
+            return err;
+        }
 
-                    if (err == EXDEV)
-                    {
-#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
-                    fallback_to_sendfile:
-                        return copy_file_data_sendfile::impl(infile, outfile, size, blksize);
-#else
-                        goto fallback_to_read_write;
-#endif
-                    }
+        break;
+    }
 
-                    if (err == ENOSYS)
-                    {
-#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
-                        filesystem::detail::atomic_store_relaxed(copy_file_data, &check_fs_type< copy_file_data_sendfile >);
-                        goto fallback_to_sendfile;
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_FADVISE)
+    if (drop_cache)
+        ::posix_fadvise(file.fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::posix_fadvise(file.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
 #else
-                        filesystem::detail::atomic_store_relaxed(copy_file_data, &copy_file_data_read_write);
-                        goto fallback_to_read_write;
+    (void)drop_cache;
 #endif
-                    }
-                }
-
-                return err;
-            }
-
-            offset += sz;
-        }
 
-        return 0;
+    scoped_copy_buffer buf;
+    char stack_buf[min_read_write_buf_size];
+    char* data = stack_buf;
+    std::size_t buf_size = sizeof(stack_buf);
+    if (BOOST_LIKELY(buf.reserve(get_read_write_buf_size(size, blksize))))
+    {
+        data = buf.data();
+        buf_size = buf.size();
     }
-};
-
-#endif // defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
-
-#if defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
 
-//! copy_file_data wrapper that tests if a read/write loop must be used for a given filesystem
-template< typename CopyFileData >
-int check_fs_type(int infile, int outfile, uintmax_t size, std::size_t blksize)
-{
+    while (true)
     {
-        // Some filesystems have regular files with generated content. Such files have arbitrary size, including zero,
-        // but have actual content. Linux system calls sendfile or copy_file_range will not copy contents of such files,
-        // so we must use a read/write loop to handle them.
-        // https://lore.kernel.org/linux-fsdevel/20210212044405.4120619-1-drinkcat@chromium.org/T/
-        struct statfs sfs;
-        while (true)
-        {
-            int err = ::fstatfs(infile, &sfs);
-            if (BOOST_UNLIKELY(err < 0))
-            {
-                err = errno;
-                if (err == EINTR)
-                    continue;
-
-                goto fallback_to_read_write;
-            }
-
+        const ssize_t sz_read = ::read(file.fd, data, buf_size);
+        if (sz_read == 0)
             break;
-        }
-
-        if (BOOST_UNLIKELY(sfs.f_type == PROC_SUPER_MAGIC ||
-            sfs.f_type == SYSFS_MAGIC ||
-            sfs.f_type == TRACEFS_MAGIC ||
-            sfs.f_type == DEBUGFS_MAGIC))
+        if (BOOST_UNLIKELY(sz_read < 0))
         {
-        fallback_to_read_write:
-            return copy_file_data_read_write(infile, outfile, size, blksize);
+            const int err = errno;
+            if (err == EINTR)
+                continue;
+            return err;
         }
+
+        hasher.update(hasher_state, data, static_cast< std::size_t >(sz_read));
     }
 
-    return CopyFileData::impl(infile, outfile, size, blksize);
+    return 0;
 }
 
-#endif // defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+#if defined(O_DIRECT) && !defined(BOOST_FILESYSTEM_USE_WASI)
 
-#if defined(linux) || defined(__linux) || defined(__linux__)
+//! Size of the buffer used for copying file data with direct I/O
+BOOST_CONSTEXPR_OR_CONST std::size_t direct_io_buf_size = 1024u * 1024u;
 
-//! Initializes copy_file_data implementation pointer
-inline void init_copy_file_data_impl(unsigned int major_ver, unsigned int minor_ver, unsigned int patch_ver)
+//! Sets or clears O_DIRECT flag on the file descriptor. Returns 0 on success or an error code.
+inline int set_direct_io(int fd, bool enable)
 {
-#if defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
-    copy_file_data_t* cfd = &copy_file_data_read_write;
+    int flags = ::fcntl(fd, F_GETFL);
+    if (BOOST_UNLIKELY(flags < 0))
+        return errno;
 
-#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
-    // sendfile started accepting file descriptors as the target in Linux 2.6.33
-    if (major_ver > 2u || (major_ver == 2u && (minor_ver > 6u || (minor_ver == 6u && patch_ver >= 33u))))
-        cfd = &check_fs_type< copy_file_data_sendfile >;
-#endif
+    const int new_flags = enable ? (flags | O_DIRECT) : (flags & ~O_DIRECT);
+    if (new_flags != flags && BOOST_UNLIKELY(::fcntl(fd, F_SETFL, new_flags) < 0))
+        return errno;
 
-#if defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
-    // Although copy_file_range appeared in Linux 4.5, it did not support cross-filesystem copying until 5.3.
-    // copy_file_data_copy_file_range will fallback to copy_file_data_sendfile if copy_file_range returns EXDEV.
-    if (major_ver > 4u || (major_ver == 4u && minor_ver >= 5u))
-        cfd = &check_fs_type< copy_file_data_copy_file_range >;
-#endif
+    return 0;
+}
 
-    filesystem::detail::atomic_store_relaxed(copy_file_data, cfd);
-#endif // defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
-}
+/*!
+ * copy_file implementation that uses read/write loop with direct I/O, bypassing the page cache. Both files must be positioned
+ * at the beginning. Returns \c ENOTSUP if the filesystem does not support direct I/O, in which case no data has been copied.
+ */
+int copy_file_data_direct(int infile, int outfile, uintmax_t size, std::size_t blksize)
+{
+    instrumentation_scope instrumentation(instrumented_operation::copy_unbuffered);
 
-#endif // defined(linux) || defined(__linux) || defined(__linux__)
+    // Direct I/O requires the buffer address, file offset and transfer size be aligned to the logical block size of the device.
+    // The buffer alignment (the page size) is larger than the block size of all practical devices. The buffer size is larger than
+    // the regular buffer size since every I/O operation goes directly to the device, so larger operations are more efficient.
+    (void)blksize;
+    std::size_t buf_size = direct_io_buf_size;
+    if (size < buf_size)
+        buf_size = static_cast< std::size_t >((size + copy_buffer_alignment) & ~static_cast< uintmax_t >(copy_buffer_alignment - 1u));
 
-#if defined(linux) || defined(__linux) || defined(__linux__)
+    scoped_copy_buffer buf;
+    if (BOOST_UNLIKELY(!buf.reserve(buf_size)))
+        return ENOTSUP;
 
-struct syscall_initializer
-{
-    syscall_initializer()
+    // EINVAL is returned by filesystems that don't support direct I/O, e.g. tmpfs
+    int err = set_direct_io(infile, true);
+    if (err == 0)
     {
-        struct ::utsname system_info;
-        if (BOOST_UNLIKELY(::uname(&system_info) < 0))
-            return;
+        err = set_direct_io(outfile, true);
+        if (BOOST_UNLIKELY(err != 0))
+            set_direct_io(infile, false);
+    }
 
-        unsigned int major_ver = 0u, minor_ver = 0u, patch_ver = 0u;
-        int count = std::sscanf(system_info.release, "%u.%u.%u", &major_ver, &minor_ver, &patch_ver);
-        if (BOOST_UNLIKELY(count < 3))
-            return;
+    if (BOOST_UNLIKELY(err != 0))
+        return ENOTSUP;
+
+    bool direct = true;
+    while (true)
+    {
+        ssize_t sz_read = ::read(infile, buf.data(), buf_size);
+        if (sz_read == 0)
+            break;
+        if (BOOST_UNLIKELY(sz_read < 0))
+        {
+            err = errno;
+            if (err == EINTR)
+                continue;
+            return err;
+        }
+
+        // The tail of the file is not a multiple of the block size and cannot be written with direct I/O. Also, after
+        // a short read or write, file offsets are no longer aligned. Continue copying without direct I/O in these cases.
+        if (direct && (static_cast< std::size_t >(sz_read) & (copy_buffer_alignment - 1u)) != 0u)
+        {
+            direct = false;
+            set_direct_io(infile, false);
+            err = set_direct_io(outfile, false);
+            if (BOOST_UNLIKELY(err != 0))
+                return err;
+        }
+
+        for (ssize_t sz_wrote = 0; sz_wrote < sz_read;)
+        {
+            ssize_t sz = ::write(outfile, buf.data() + sz_wrote, static_cast< std::size_t >(sz_read - sz_wrote));
+            if (BOOST_UNLIKELY(sz < 0))
+            {
+                err = errno;
+                if (err == EINTR)
+                    continue;
+                return err;
+            }
 
-        init_statx_impl(major_ver, minor_ver, patch_ver);
-        init_copy_file_data_impl(major_ver, minor_ver, patch_ver);
-        init_fill_random_impl(major_ver, minor_ver, patch_ver);
+            sz_wrote += sz;
+            if (direct && sz_wrote < sz_read)
+            {
+                direct = false;
+                set_direct_io(infile, false);
+                err = set_direct_io(outfile, false);
+                if (BOOST_UNLIKELY(err != 0))
+                    return err;
+            }
+        }
     }
-};
 
-BOOST_FILESYSTEM_INIT_PRIORITY(BOOST_FILESYSTEM_FUNC_PTR_INIT_PRIORITY) BOOST_ATTRIBUTE_UNUSED BOOST_FILESYSTEM_ATTRIBUTE_RETAIN
-const syscall_initializer syscall_init;
+    if (direct)
+    {
+        set_direct_io(infile, false);
+        set_direct_io(outfile, false);
+    }
 
-#endif // defined(linux) || defined(__linux) || defined(__linux__)
+    return 0;
+}
 
-//! remove() implementation
-inline bool remove_impl
-(
-    path const& p,
-    fs::file_type type,
-    error_code* ec
-#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
-    , int basedir_fd = AT_FDCWD
-#endif
-)
+#elif defined(F_NOCACHE)
+
+/*!
+ * copy_file implementation that uses read/write loop, bypassing the file cache. Returns \c ENOTSUP if the file cache
+ * cannot be disabled, in which case no data has been copied.
+ */
+int copy_file_data_direct(int infile, int outfile, uintmax_t size, std::size_t blksize)
 {
-    if (type == fs::file_not_found)
-        return false;
+    instrumentation_scope instrumentation(instrumented_operation::copy_unbuffered);
+
+    // Unlike O_DIRECT, F_NOCACHE does not impose alignment requirements on the I/O operations
+    if (BOOST_UNLIKELY(::fcntl(infile, F_NOCACHE, 1) < 0 || ::fcntl(outfile, F_NOCACHE, 1) < 0))
+        return ENOTSUP;
+
+    return copy_file_data_read_write(infile, outfile, size, blksize, false);
+}
 
-    int res;
-#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
-    res = ::unlinkat(basedir_fd, p.c_str(), type == fs::directory_file ? AT_REMOVEDIR : 0);
-#else
-    if (type == fs::directory_file)
-        res = ::rmdir(p.c_str());
-    else
-        res = ::unlink(p.c_str());
 #endif
 
-    if (res != 0)
+
+//! Copies a range of data at the given offset from one file to the same offset in another file using pread/pwrite
+int copy_file_data_range_pread_pwrite(int infile, int outfile, off_t offset, uintmax_t size, char* buf, std::size_t buf_size)
+{
+    while (size > 0u)
     {
-        int err = errno;
-        if (BOOST_UNLIKELY(!not_found_error(err)))
-            emit_error(err, p, ec, "boost::filesystem::remove");
+        const std::size_t size_to_read = size < buf_size ? static_cast< std::size_t >(size) : buf_size;
+        ssize_t sz_read = ::pread(infile, buf, size_to_read, offset);
+        if (sz_read == 0)
+            break; // the file was truncated concurrently
+        if (BOOST_UNLIKELY(sz_read < 0))
+        {
+            int err = errno;
+            if (err == EINTR)
+                continue;
+            return err;
+        }
 
-        return false;
+        for (ssize_t sz_wrote = 0; sz_wrote < sz_read;)
+        {
+            ssize_t sz = ::pwrite(outfile, buf + sz_wrote, static_cast< std::size_t >(sz_read - sz_wrote), offset + sz_wrote);
+            if (BOOST_UNLIKELY(sz < 0))
+            {
+                int err = errno;
+                if (err == EINTR)
+                    continue;
+                return err;
+            }
+
+            sz_wrote += sz;
+        }
+
+        offset += sz_read;
+        size -= static_cast< uintmax_t >(sz_read);
     }
 
-    return true;
+    return 0;
 }
 
-//! remove() implementation
-inline bool remove_impl(path const& p, error_code* ec)
+//! Reads up to \a size bytes at the given offset, until the buffer is filled or the end of the file is reached
+int pread_full(int fd, char* buf, std::size_t size, off_t offset, std::size_t& sz_read)
 {
-    // Since POSIX remove() is specified to work with either files or directories, in a
-    // perfect world it could just be called. But some important real-world operating
-    // systems (Windows, Mac OS, for example) don't implement the POSIX spec. So
-    // we have to distinguish between files and directories and call corresponding APIs
-    // to remove them.
-
-    error_code local_ec;
-    fs::file_type type = fs::detail::symlink_status_impl(p, &local_ec).type();
-    if (BOOST_UNLIKELY(type == fs::status_error))
+    sz_read = 0u;
+    while (sz_read < size)
     {
-        if (!ec)
-            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove", p, local_ec));
+        ssize_t sz = ::pread(fd, buf + sz_read, size - sz_read, offset + static_cast< off_t >(sz_read));
+        if (sz == 0)
+            break;
+        if (BOOST_UNLIKELY(sz < 0))
+        {
+            int err = errno;
+            if (err == EINTR)
+                continue;
+            return err;
+        }
 
-        *ec = local_ec;
-        return false;
+        sz_read += static_cast< std::size_t >(sz);
     }
 
-    return fs::detail::remove_impl(p, type, ec);
+    return 0;
 }
 
-//! remove_all() implementation
-uintmax_t remove_all_impl
-(
-    path const& p,
-    error_code* ec
-#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
-    , int basedir_fd = AT_FDCWD
-#endif
-)
+//! Writes \a size bytes at the given offset
+int pwrite_full(int fd, const char* buf, std::size_t size, off_t offset)
 {
-#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
-    fs::detail::directory_iterator_params params;
-    params.basedir_fd = basedir_fd;
-    params.iterator_fd = -1;
-#endif
-
-    error_code dit_create_ec;
-    for (unsigned int attempt = 0u; attempt < remove_all_directory_replaced_retry_count; ++attempt)
+    for (std::size_t sz_wrote = 0u; sz_wrote < size;)
     {
-        fs::file_type type;
+        ssize_t sz = ::pwrite(fd, buf + sz_wrote, size - sz_wrote, offset + static_cast< off_t >(sz_wrote));
+        if (BOOST_UNLIKELY(sz < 0))
         {
-            error_code local_ec;
-            type = fs::detail::symlink_status_impl
-            (
-                p,
-                &local_ec
-#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
-                , basedir_fd
-#endif
-            ).type();
+            int err = errno;
+            if (err == EINTR)
+                continue;
+            return err;
+        }
 
-            if (type == fs::file_not_found)
-                return 0u;
+        sz_wrote += static_cast< std::size_t >(sz);
+    }
 
-            if (BOOST_UNLIKELY(type == fs::status_error))
-            {
-                if (!ec)
-                    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove_all", p, local_ec));
+    return 0;
+}
 
-                *ec = local_ec;
-                return static_cast< uintmax_t >(-1);
-            }
-        }
+/*!
+ * copy_file implementation that updates the existing target file in place. The source file is read in chunks, each chunk is compared
+ * with the data at the same offset in the target file in blocks of \a blksize bytes, and only the runs of differing blocks are written
+ * to the target file. The target file is then truncated to the size of the copied data, if it was larger.
+ */
+int copy_file_data_delta(int infile, int outfile, uintmax_t size, uintmax_t to_size, std::size_t blksize)
+{
+    instrumentation_scope instrumentation(instrumented_operation::copy_delta);
 
-        uintmax_t count = 0u;
-        if (type == fs::directory_file) // but not a directory symlink
+    // Compare at least in 4 KiB blocks, which is the typical page size. Smaller blocks would not reduce the amount of data written to storage.
+    std::size_t block_size = blksize;
+    if (block_size < 4096u)
+        block_size = 4096u;
+
+    scoped_copy_buffer heap_buf;
+    char stack_buf[min_read_write_buf_size * 2u];
+    char* buf = stack_buf;
+    std::size_t chunk_size = min_read_write_buf_size;
+    {
+        const std::size_t buf_size = get_read_write_buf_size(size, block_size);
+        if (BOOST_LIKELY(heap_buf.reserve(buf_size * 2u)))
         {
-            fs::directory_iterator itr;
-            fs::detail::directory_iterator_construct
-            (
-                itr,
-                p,
-                static_cast< unsigned int >(directory_options::_detail_no_follow),
-#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
-                &params,
-#else
-                NULL,
-#endif
-                &dit_create_ec
-            );
+            buf = heap_buf.data();
+            chunk_size = buf_size;
+        }
+    }
+    if (block_size > chunk_size)
+        block_size = chunk_size;
 
-            if (BOOST_UNLIKELY(!!dit_create_ec))
-            {
-                if (dit_create_ec == error_code(ENOTDIR, system_category()))
-                    continue;
+    char* const from_buf = buf;
+    char* const to_buf = buf + chunk_size;
 
-#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW)
-                // If open(2) with O_NOFOLLOW fails with ELOOP, this means that either the path contains a loop
-                // of symbolic links, or the last element of the path is a symbolic link. Given that lstat(2) above
-                // did not fail, most likely it is the latter case. I.e. between the lstat above and this open call
-                // the filesystem was modified so that the path no longer refers to a directory file (as opposed to a symlink).
-                if (dit_create_ec == error_code(ELOOP, system_category()))
-                    continue;
-#endif // defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW)
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_FADVISE)
+    ::posix_fadvise(infile, 0, 0, POSIX_FADV_SEQUENTIAL);
+    ::posix_fadvise(outfile, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
 
-                if (!ec)
-                    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove_all", p, dit_create_ec));
+    // As with the read/write loop, copy as much data as we can read from the input file, regardless of the file size
+    off_t pos = 0;
+    while (true)
+    {
+        std::size_t from_read = 0u;
+        int err = pread_full(infile, from_buf, chunk_size, pos, from_read);
+        if (BOOST_UNLIKELY(err != 0))
+            return err;
+        if (from_read == 0u)
+            break;
 
-                *ec = dit_create_ec;
-                return static_cast< uintmax_t >(-1);
-            }
+        std::size_t to_read = 0u;
+        if (static_cast< uintmax_t >(pos) < to_size)
+        {
+            err = pread_full(outfile, to_buf, from_read, pos, to_read);
+            if (BOOST_UNLIKELY(err != 0))
+                return err;
+        }
 
-            const fs::directory_iterator end_dit;
-            while (itr != end_dit)
+        // Find runs of blocks that differ and write each run with a single call
+        std::size_t run_start = from_read;
+        for (std::size_t block_pos = 0u; block_pos < from_read; block_pos += block_size)
+        {
+            const std::size_t n = (from_read - block_pos) < block_size ? (from_read - block_pos) : block_size;
+            const bool differs = (block_pos + n) > to_read || std::memcmp(from_buf + block_pos, to_buf + block_pos, n) != 0;
+            if (differs)
             {
-                count += fs::detail::remove_all_impl
-                (
-#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
-                    itr->path().filename(),
-#else
-                    itr->path(),
-#endif
-                    ec
-#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
-                    , params.iterator_fd
-#endif
-                );
-                if (ec && *ec)
-                    return static_cast< uintmax_t >(-1);
-
-                fs::detail::directory_iterator_increment(itr, ec);
-                if (ec && *ec)
-                    return static_cast< uintmax_t >(-1);
+                if (run_start == from_read)
+                    run_start = block_pos;
+            }
+            else if (run_start != from_read)
+            {
+                err = pwrite_full(outfile, from_buf + run_start, block_pos - run_start, pos + static_cast< off_t >(run_start));
+                if (BOOST_UNLIKELY(err != 0))
+                    return err;
+                run_start = from_read;
             }
         }
 
-        count += fs::detail::remove_impl
-        (
-            p,
-            type,
-            ec
-#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
-            , basedir_fd
-#endif
-        );
-        if (ec && *ec)
-            return static_cast< uintmax_t >(-1);
+        if (run_start != from_read)
+        {
+            err = pwrite_full(outfile, from_buf + run_start, from_read - run_start, pos + static_cast< off_t >(run_start));
+            if (BOOST_UNLIKELY(err != 0))
+                return err;
+        }
 
-        return count;
+        pos += static_cast< off_t >(from_read);
+        if (from_read < chunk_size)
+            break;
     }
 
-    if (!ec)
-        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove_all: path cannot be opened as a directory", p, dit_create_ec));
+    // If the target file was smaller, it has been extended by the writes
+    if (to_size > static_cast< uintmax_t >(pos) && BOOST_UNLIKELY(::ftruncate(outfile, pos) != 0))
+        return errno;
 
-    *ec = dit_create_ec;
-    return static_cast< uintmax_t >(-1);
+    return 0;
 }
 
-#else // defined(BOOST_POSIX_API)
-
-//--------------------------------------------------------------------------------------//
-//                                                                                      //
-//                            Windows-specific helpers                                  //
-//                                                                                      //
-//--------------------------------------------------------------------------------------//
-
-//! FILE_BASIC_INFO definition from Windows SDK
-struct file_basic_info
-{
-    LARGE_INTEGER CreationTime;
-    LARGE_INTEGER LastAccessTime;
-    LARGE_INTEGER LastWriteTime;
-    LARGE_INTEGER ChangeTime;
-    DWORD FileAttributes;
-};
 
-//! FILE_DISPOSITION_INFO definition from Windows SDK
-struct file_disposition_info
-{
-    BOOLEAN DeleteFile;
-};
+#if defined(BOOST_FILESYSTEM_HAS_SEEK_DATA)
 
-//! FILE_DISPOSITION_INFO_EX definition from Windows SDK
-struct file_disposition_info_ex
+/*!
+ * copy_file implementation that preserves holes in sparse files. Data regions of the source file are found with lseek(SEEK_DATA/SEEK_HOLE)
+ * and copied to the same offsets in the target file, which must be empty. The target file is then extended to the size of the source file.
+ * Returns \c ENOTSUP if the filesystem does not support SEEK_DATA, in which case no data has been copied.
+ */
+int copy_file_data_sparse(int infile, int outfile, uintmax_t size, std::size_t blksize)
 {
-    DWORD Flags;
-};
+    instrumentation_scope instrumentation(instrumented_operation::copy_sparse);
 
-#ifndef FILE_DISPOSITION_FLAG_DELETE
-#define FILE_DISPOSITION_FLAG_DELETE 0x00000001
-#endif
-// Available since Windows 10 1709
-#ifndef FILE_DISPOSITION_FLAG_POSIX_SEMANTICS
-#define FILE_DISPOSITION_FLAG_POSIX_SEMANTICS 0x00000002
-#endif
-// Available since Windows 10 1809
-#ifndef FILE_DISPOSITION_FLAG_IGNORE_READONLY_ATTRIBUTE
-#define FILE_DISPOSITION_FLAG_IGNORE_READONLY_ATTRIBUTE 0x00000010
-#endif
+    scoped_copy_buffer heap_buf;
+    char stack_buf[min_read_write_buf_size];
+    char* buf = stack_buf;
+    std::size_t actual_buf_size = sizeof(stack_buf);
+    if (BOOST_LIKELY(heap_buf.reserve(get_read_write_buf_size(size, blksize))))
+    {
+        buf = heap_buf.data();
+        actual_buf_size = heap_buf.size();
+    }
 
-//  REPARSE_DATA_BUFFER related definitions are found in ntifs.h, which is part of the
-//  Windows Device Driver Kit. Since that's inconvenient, the definitions are provided
-//  here. See http://msdn.microsoft.com/en-us/library/ms791514.aspx
-struct reparse_data_buffer
-{
-    ULONG ReparseTag;
-    USHORT ReparseDataLength;
-    USHORT Reserved;
-    union
+    const off_t end_pos = static_cast< off_t >(size);
+    off_t pos = 0;
+    while (pos < end_pos)
     {
-        /*
-         * In SymbolicLink and MountPoint reparse points, there are two names.
-         * SubstituteName is the effective replacement path for the reparse point.
-         * This is what should be used for path traversal.
-         * PrintName is intended for presentation to the user and may omit some
-         * elements of the path or be absent entirely.
-         *
-         * Examples of substitute and print names:
-         * mklink /D ldrive c:\
-         * SubstituteName: "\??\c:\"
-         * PrintName: "c:\"
-         *
-         * mklink /J ldrive c:\
-         * SubstituteName: "\??\C:\"
-         * PrintName: "c:\"
-         *
-         * junction ldrive c:\
-         * SubstituteName: "\??\C:\"
-         * PrintName: ""
-         *
-         * box.com mounted cloud storage
-         * SubstituteName: "\??\Volume{<UUID>}\"
-         * PrintName: ""
-         */
-        struct
-        {
-            USHORT SubstituteNameOffset;
-            USHORT SubstituteNameLength;
-            USHORT PrintNameOffset;
-            USHORT PrintNameLength;
-            ULONG Flags;
-            WCHAR PathBuffer[1];
-        } SymbolicLinkReparseBuffer;
-        struct
-        {
-            USHORT SubstituteNameOffset;
-            USHORT SubstituteNameLength;
-            USHORT PrintNameOffset;
-            USHORT PrintNameLength;
-            WCHAR PathBuffer[1];
-        } MountPointReparseBuffer;
-        struct
+        off_t data_pos = ::lseek(infile, pos, SEEK_DATA);
+        if (data_pos < 0)
         {
-            UCHAR DataBuffer[1];
-        } GenericReparseBuffer;
-    };
-};
+            int err = errno;
+            // ENXIO means there is no more data past pos
+            if (err == ENXIO)
+                break;
+            // Some filesystems don't support SEEK_DATA and return EINVAL
+            if (pos == 0 && (err == EINVAL || err == ENOTSUP || err == EOPNOTSUPP))
+                return ENOTSUP;
+            return err;
+        }
 
-// Our convenience type for allocating REPARSE_DATA_BUFFER along with sufficient space after it
-union reparse_data_buffer_with_storage
-{
-    reparse_data_buffer rdb;
-    unsigned char storage[MAXIMUM_REPARSE_DATA_BUFFER_SIZE];
-};
+        if (data_pos >= end_pos)
+            break;
 
-//  Windows kernel32.dll functions that may or may not be present
-//  must be accessed through pointers
+        off_t hole_pos = ::lseek(infile, data_pos, SEEK_HOLE);
+        if (BOOST_UNLIKELY(hole_pos < 0))
+            return errno;
 
-typedef BOOL (WINAPI CreateHardLinkW_t)(
-    /*__in*/ LPCWSTR lpFileName,
-    /*__in*/ LPCWSTR lpExistingFileName,
-    /*__reserved*/ LPSECURITY_ATTRIBUTES lpSecurityAttributes);
+        if (hole_pos > end_pos)
+            hole_pos = end_pos;
 
-CreateHardLinkW_t* create_hard_link_api = NULL;
+        int err = copy_file_data_range_pread_pwrite(infile, outfile, data_pos, static_cast< uintmax_t >(hole_pos - data_pos), buf, actual_buf_size);
+        if (BOOST_UNLIKELY(err != 0))
+            return err;
 
-typedef BOOLEAN (WINAPI CreateSymbolicLinkW_t)(
-    /*__in*/ LPCWSTR lpSymlinkFileName,
-    /*__in*/ LPCWSTR lpTargetFileName,
-    /*__in*/ DWORD dwFlags);
+        pos = hole_pos;
+    }
 
-CreateSymbolicLinkW_t* create_symbolic_link_api = NULL;
+    // Extend the target file to the size of the source file, leaving a hole at the end, if needed
+    if (BOOST_UNLIKELY(::ftruncate(outfile, end_pos) != 0))
+        return errno;
 
-//! SetFileInformationByHandle signature. Available since Windows Vista.
-typedef BOOL (WINAPI SetFileInformationByHandle_t)(
-    /*_In_*/ HANDLE hFile,
-    /*_In_*/ file_info_by_handle_class FileInformationClass, // the actual type is FILE_INFO_BY_HANDLE_CLASS enum
-    /*_In_reads_bytes_(dwBufferSize)*/ LPVOID lpFileInformation,
-    /*_In_*/ DWORD dwBufferSize);
+    return 0;
+}
 
-SetFileInformationByHandle_t* set_file_information_by_handle_api = NULL;
+#endif // defined(BOOST_FILESYSTEM_HAS_SEEK_DATA)
 
-} // unnamed namespace
+typedef int copy_file_data_t(int infile, int outfile, uintmax_t size, std::size_t blksize, dev_t from_dev, dev_t to_dev);
 
-GetFileInformationByHandleEx_t* get_file_information_by_handle_ex_api = NULL;
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
 
-#if !defined(UNDER_CE)
-NtCreateFile_t* nt_create_file_api = NULL;
-NtQueryDirectoryFile_t* nt_query_directory_file_api = NULL;
-#endif // !defined(UNDER_CE)
+int copy_file_data_select_impl(int infile, int outfile, uintmax_t size, std::size_t blksize, dev_t from_dev, dev_t to_dev);
 
-namespace {
+//! Pointer to the actual implementation of the copy_file_data implementation. Initialized to the implementation selector, which is replaced on the first call.
+copy_file_data_t* copy_file_data = &copy_file_data_select_impl;
 
-//! remove() implementation type
-enum remove_impl_type
+//! copy_file_data wrapper that selects the data copying method for the given source and target devices
+template< typename CopyFileData >
+int check_fs_type(int infile, int outfile, uintmax_t size, std::size_t blksize, dev_t from_dev, dev_t to_dev);
+
+//! Methods of copying file data. Larger values denote more preferred methods.
+enum copy_method
 {
-    remove_nt5,                            //!< Use Windows XP API
-    remove_disp,                           //!< Use FILE_DISPOSITION_INFO (Windows Vista and later)
-    remove_disp_ex_flag_posix_semantics,   //!< Use FILE_DISPOSITION_INFO_EX with FILE_DISPOSITION_FLAG_POSIX_SEMANTICS
-    remove_disp_ex_flag_ignore_readonly    //!< Use FILE_DISPOSITION_INFO_EX with FILE_DISPOSITION_FLAG_POSIX_SEMANTICS | FILE_DISPOSITION_FLAG_IGNORE_READONLY_ATTRIBUTE
+    copy_method_unknown = 0u,
+    copy_method_read_write,
+    copy_method_sendfile,
+    copy_method_copy_file_range,
+    copy_method_io_uring
 };
 
-remove_impl_type g_remove_impl_type = remove_nt5;
-
-//! Initializes WinAPI function pointers
-BOOST_FILESYSTEM_INIT_FUNC init_winapi_func_ptrs()
-{
-    boost::winapi::HMODULE_ h = boost::winapi::GetModuleHandleW(L"kernel32.dll");
-    if (BOOST_LIKELY(!!h))
-    {
-        GetFileInformationByHandleEx_t* get_file_information_by_handle_ex = (GetFileInformationByHandleEx_t*)boost::winapi::get_proc_address(h, "GetFileInformationByHandleEx");
-        filesystem::detail::atomic_store_relaxed(get_file_information_by_handle_ex_api, get_file_information_by_handle_ex);
-        SetFileInformationByHandle_t* set_file_information_by_handle = (SetFileInformationByHandle_t*)boost::winapi::get_proc_address(h, "SetFileInformationByHandle");
-        filesystem::detail::atomic_store_relaxed(set_file_information_by_handle_api, set_file_information_by_handle);
-        filesystem::detail::atomic_store_relaxed(create_hard_link_api, (CreateHardLinkW_t*)boost::winapi::get_proc_address(h, "CreateHardLinkW"));
-        filesystem::detail::atomic_store_relaxed(create_symbolic_link_api, (CreateSymbolicLinkW_t*)boost::winapi::get_proc_address(h, "CreateSymbolicLinkW"));
+#else // defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
 
-        if (get_file_information_by_handle_ex && set_file_information_by_handle)
-        {
-            // Enable the most advanced implementation based on GetFileInformationByHandleEx/SetFileInformationByHandle.
-            // If certain flags are not supported by the OS, the remove() implementation will downgrade accordingly.
-            filesystem::detail::atomic_store_relaxed(g_remove_impl_type, remove_disp_ex_flag_ignore_readonly);
-        }
-    }
+//! Pointer to the actual implementation of the copy_file_data implementation
+copy_file_data_t* copy_file_data = &copy_file_data_plain;
 
-#if !defined(UNDER_CE)
-    h = boost::winapi::GetModuleHandleW(L"ntdll.dll");
-    if (BOOST_LIKELY(!!h))
-    {
-        filesystem::detail::atomic_store_relaxed(nt_create_file_api, (NtCreateFile_t*)boost::winapi::get_proc_address(h, "NtCreateFile"));
-        filesystem::detail::atomic_store_relaxed(nt_query_directory_file_api, (NtQueryDirectoryFile_t*)boost::winapi::get_proc_address(h, "NtQueryDirectoryFile"));
-    }
+#endif // defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
 
-    init_directory_iterator_impl();
-#endif // !defined(UNDER_CE)
+//! Indicates that the copy_file_data implementation was selected by the user, in which case it is also used for small files
+bool copy_file_backend_overridden = false;
 
-    return BOOST_FILESYSTEM_INITRETSUCCESS_V;
-}
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
 
-#if defined(_MSC_VER)
+struct copy_file_data_sendfile
+{
+    static BOOST_CONSTEXPR_OR_CONST copy_method method = copy_method_sendfile;
 
-#if _MSC_VER >= 1400
+    //! copy_file implementation that uses sendfile loop. Requires sendfile to support file descriptors.
+    //! On return, \a used_method indicates the method that was used to copy the data.
+    static int impl(int infile, int outfile, uintmax_t size, std::size_t blksize, copy_method& used_method)
+    {
+        used_method = copy_method_sendfile;
+        instrumentation_scope instrumentation(instrumented_operation::copy_sendfile);
 
-#pragma section(".CRT$XCL", long, read)
-__declspec(allocate(".CRT$XCL")) BOOST_ATTRIBUTE_UNUSED BOOST_FILESYSTEM_ATTRIBUTE_RETAIN
-extern const init_func_ptr_t p_init_winapi_func_ptrs = &init_winapi_func_ptrs;
+        // sendfile will not send more than this amount of data in one call
+        BOOST_CONSTEXPR_OR_CONST std::size_t max_batch_size = 0x7ffff000u;
+        uintmax_t offset = 0u;
+        while (offset < size)
+        {
+            uintmax_t size_left = size - offset;
+            std::size_t size_to_copy = max_batch_size;
+            if (size_left < static_cast< uintmax_t >(max_batch_size))
+                size_to_copy = static_cast< std::size_t >(size_left);
+            ssize_t sz = ::sendfile(outfile, infile, NULL, size_to_copy);
+            if (BOOST_UNLIKELY(sz < 0))
+            {
+                int err = errno;
+                if (err == EINTR)
+                    continue;
 
-#else // _MSC_VER >= 1400
+                if (offset == 0u)
+                {
+                    // sendfile may fail with EINVAL if the underlying filesystem does not support it
+                    if (err == EINVAL)
+                    {
+                        record_instrumented_event(instrumented_operation::operation_fallback);
+                        BOOST_FILESYSTEM_TRACE1(copy_file_data__fallback, err);
+                    fallback_to_read_write:
+                        used_method = copy_method_read_write;
+                        return copy_file_data_read_write(infile, outfile, size, blksize);
+                    }
 
-#if (_MSC_VER >= 1300) // 1300 == VC++ 7.0
-#pragma data_seg(push, old_seg)
-#endif
-#pragma data_seg(".CRT$XCL")
-BOOST_ATTRIBUTE_UNUSED BOOST_FILESYSTEM_ATTRIBUTE_RETAIN
-extern const init_func_ptr_t p_init_winapi_func_ptrs = &init_winapi_func_ptrs;
-#pragma data_seg()
-#if (_MSC_VER >= 1300) // 1300 == VC++ 7.0
-#pragma data_seg(pop, old_seg)
-#endif
+                    if (err == ENOSYS)
+                    {
+                        record_instrumented_event(instrumented_operation::implementation_fallback);
+                        BOOST_FILESYSTEM_TRACE1(copy_file_data__downgrade, err);
+                        filesystem::detail::atomic_store_relaxed(copy_file_data, &copy_file_data_plain);
+                        goto fallback_to_read_write;
+                    }
+                }
 
-#endif // _MSC_VER >= 1400
+                return err;
+            }
 
-#if defined(BOOST_FILESYSTEM_NO_ATTRIBUTE_RETAIN)
-//! Makes sure the global initializer pointers are referenced and not removed by linker
-struct globals_retainer
-{
-    const init_func_ptr_t* volatile m_p_init_winapi_func_ptrs;
+            offset += sz;
+        }
 
-    globals_retainer() { m_p_init_winapi_func_ptrs = &p_init_winapi_func_ptrs; }
+        return 0;
+    }
 };
-BOOST_ATTRIBUTE_UNUSED
-const globals_retainer g_globals_retainer;
-#endif // defined(BOOST_FILESYSTEM_NO_ATTRIBUTE_RETAIN)
 
-#else // defined(_MSC_VER)
+#endif // defined(BOOST_FILESYSTEM_USE_SENDFILE)
 
-//! Invokes WinAPI function pointers initialization
-struct winapi_func_ptrs_initializer
-{
-    winapi_func_ptrs_initializer() { init_winapi_func_ptrs(); }
-};
+#if defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
 
-BOOST_FILESYSTEM_INIT_PRIORITY(BOOST_FILESYSTEM_FUNC_PTR_INIT_PRIORITY) BOOST_ATTRIBUTE_UNUSED BOOST_FILESYSTEM_ATTRIBUTE_RETAIN
-const winapi_func_ptrs_initializer winapi_func_ptrs_init;
+struct copy_file_data_copy_file_range
+{
+    static BOOST_CONSTEXPR_OR_CONST copy_method method = copy_method_copy_file_range;
 
-#endif // defined(_MSC_VER)
+    //! copy_file implementation that uses copy_file_range loop. Requires copy_file_range to support cross-filesystem copying.
+    //! On return, \a used_method indicates the method that was used to copy the data.
+    static int impl(int infile, int outfile, uintmax_t size, std::size_t blksize, copy_method& used_method)
+    {
+        used_method = copy_method_copy_file_range;
+        instrumentation_scope instrumentation(instrumented_operation::copy_file_range);
 
+        // Although copy_file_range does not document any particular upper limit of one transfer, still use some upper bound to guarantee
+        // that size_t is not overflown in case if off_t is larger and the file size does not fit in size_t.
+        BOOST_CONSTEXPR_OR_CONST std::size_t max_batch_size = 0x7ffff000u;
+        uintmax_t offset = 0u;
+        while (offset < size)
+        {
+            uintmax_t size_left = size - offset;
+            std::size_t size_to_copy = max_batch_size;
+            if (size_left < static_cast< uintmax_t >(max_batch_size))
+                size_to_copy = static_cast< std::size_t >(size_left);
+            // Note: Use syscall directly to avoid depending on libc version. copy_file_range is added in glibc 2.27.
+            // uClibc-ng does not have copy_file_range as of the time of this writing (the latest uClibc-ng release is 1.0.33).
+            loff_t sz = ::syscall(__NR_copy_file_range, infile, (loff_t*)NULL, outfile, (loff_t*)NULL, size_to_copy, (unsigned int)0u);
+            if (BOOST_UNLIKELY(sz < 0))
+            {
+                int err = errno;
+                if (err == EINTR)
+                    continue;
 
-// Windows CE has no environment variables
-#if !defined(UNDER_CE)
-inline std::wstring wgetenv(const wchar_t* name)
-{
-    // use a separate buffer since C++03 basic_string is not required to be contiguous
-    const DWORD size = ::GetEnvironmentVariableW(name, NULL, 0);
-    if (size > 0)
-    {
-        boost::scoped_array< wchar_t > buf(new wchar_t[size]);
-        if (BOOST_LIKELY(::GetEnvironmentVariableW(name, buf.get(), size) > 0))
-            return std::wstring(buf.get());
+                if (offset == 0u)
+                {
+                    // copy_file_range may fail with EINVAL if the underlying filesystem does not support it.
+                    // In some RHEL/CentOS 7.7-7.8 kernel versions, copy_file_range on NFSv4 is also known to return EOPNOTSUPP
+                    // if the remote server does not support COPY, despite that it is not a documented error code.
+                    // See https://patchwork.kernel.org/project/linux-nfs/patch/20190411183418.4510-1-olga.kornievskaia@gmail.com/
+                    // and https://bugzilla.redhat.com/show_bug.cgi?id=1783554.
+                    if (err == EINVAL || err == EOPNOTSUPP)
+                    {
+                        record_instrumented_event(instrumented_operation::operation_fallback);
+                        BOOST_FILESYSTEM_TRACE1(copy_file_data__fallback, err);
+#if !defined(BOOST_FILESYSTEM_USE_SENDFILE)
+                    fallback_to_read_write:
+#endif
+                        used_method = copy_method_read_write;
+                        return copy_file_data_read_write(infile, outfile, size, blksize);
+                    }
+
+                    if (err == EXDEV)
+                    {
+                        record_instrumented_event(instrumented_operation::operation_fallback);
+                        BOOST_FILESYSTEM_TRACE1(copy_file_data__fallback, err);
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
+                    fallback_to_sendfile:
+                        return copy_file_data_sendfile::impl(infile, outfile, size, blksize, used_method);
+#else
+                        goto fallback_to_read_write;
+#endif
+                    }
+
+                    if (err == ENOSYS)
+                    {
+                        record_instrumented_event(instrumented_operation::implementation_fallback);
+                        BOOST_FILESYSTEM_TRACE1(copy_file_data__downgrade, err);
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
+                        filesystem::detail::atomic_store_relaxed(copy_file_data, &check_fs_type< copy_file_data_sendfile >);
+                        goto fallback_to_sendfile;
+#else
+                        filesystem::detail::atomic_store_relaxed(copy_file_data, &copy_file_data_plain);
+                        goto fallback_to_read_write;
+#endif
+                    }
+                }
+
+                return err;
+            }
+
+            offset += sz;
+        }
+
+        return 0;
     }
+};
 
-    return std::wstring();
-}
-#endif // !defined(UNDER_CE)
+#endif // defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
 
-inline bool not_found_error(int errval) BOOST_NOEXCEPT
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+
+//! Number of entries in the copy method cache. Must be a power of two.
+BOOST_CONSTEXPR_OR_CONST std::size_t copy_method_cache_size = 64u;
+
+/*!
+ * Cache of the data copying methods that were found to work for pairs of source and target devices.
+ *
+ * Each entry contains the source device number in the upper 32 bits, the target device number in the following
+ * 29 bits and the copy method in the lower 3 bits. Entries are read and written atomically, so that no locking
+ * is required. Colliding device pairs simply replace each other, which only results in the method being
+ * detected again.
+ */
+uint64_t copy_method_cache[copy_method_cache_size] = {};
+
+//! Returns the key for the copy method cache for the given source and target devices, or 0 if the pair cannot be cached
+inline uint64_t make_copy_method_cache_key(dev_t from_dev, dev_t to_dev) BOOST_NOEXCEPT
 {
-    return errval == ERROR_FILE_NOT_FOUND || errval == ERROR_PATH_NOT_FOUND || errval == ERROR_INVALID_NAME // "tools/jam/src/:sys:stat.h", "//foo"
-        || errval == ERROR_INVALID_DRIVE                                                                    // USB card reader with no card inserted
-        || errval == ERROR_NOT_READY                                                                        // CD/DVD drive with no disc inserted
-        || errval == ERROR_INVALID_PARAMETER                                                                // ":sys:stat.h"
-        || errval == ERROR_BAD_PATHNAME                                                                     // "//no-host" on Win64
-        || errval == ERROR_BAD_NETPATH                                                                      // "//no-host" on Win32
-        || errval == ERROR_BAD_NET_NAME;                                                                    // "//no-host/no-share" on Win10 x64
+    // Linux kernel device numbers are limited to 12 bits for major and 20 bits for minor numbers
+    const uint64_t from_major = major(from_dev), from_minor = minor(from_dev);
+    const uint64_t to_major = major(to_dev), to_minor = minor(to_dev);
+    if (BOOST_UNLIKELY(from_major > 0xFFFu || from_minor > 0xFFFFFu || to_major > 0x1FFu || to_minor > 0xFFFFFu))
+        return 0u;
+
+    return (((from_major << 20u) | from_minor) << 32u) | (((to_major << 20u) | to_minor) << 3u);
 }
 
-// these constants come from inspecting some Microsoft sample code
-inline std::time_t to_time_t(FILETIME const& ft) BOOST_NOEXCEPT
+//! Returns the index of the copy method cache entry for the key
+inline std::size_t get_copy_method_cache_index(uint64_t key) BOOST_NOEXCEPT
 {
-    uint64_t t = (static_cast< uint64_t >(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
-    t -= 116444736000000000ull;
-    t /= 10000000u;
-    return static_cast< std::time_t >(t);
+    return static_cast< std::size_t >((key * static_cast< uint64_t >(0x9E3779B97F4A7C15ull)) >> 58u) & (copy_method_cache_size - 1u);
 }
 
-inline void to_FILETIME(std::time_t t, FILETIME& ft) BOOST_NOEXCEPT
+//! Returns the cached copy method for the key or \c copy_method_unknown
+inline copy_method lookup_copy_method(uint64_t key) BOOST_NOEXCEPT
 {
-    uint64_t temp = t;
-    temp *= 10000000u;
-    temp += 116444736000000000ull;
-    ft.dwLowDateTime = static_cast< DWORD >(temp);
-    ft.dwHighDateTime = static_cast< DWORD >(temp >> 32);
+    const uint64_t entry = filesystem::detail::atomic_load_relaxed(copy_method_cache[get_copy_method_cache_index(key)]);
+    if ((entry & ~static_cast< uint64_t >(7u)) != key)
+        return copy_method_unknown;
+
+    return static_cast< copy_method >(entry & 7u);
 }
 
-} // unnamed namespace
+//! Saves the copy method for the key in the cache
+inline void store_copy_method(uint64_t key, copy_method method) BOOST_NOEXCEPT
+{
+    filesystem::detail::atomic_store_relaxed(copy_method_cache[get_copy_method_cache_index(key)], key | static_cast< uint64_t >(method));
+}
 
-#if !defined(UNDER_CE)
+//! Discards all copy method cache entries
+void clear_copy_method_cache() BOOST_NOEXCEPT
+{
+    for (std::size_t i = 0u; i < copy_method_cache_size; ++i)
+        filesystem::detail::atomic_store_relaxed(copy_method_cache[i], static_cast< uint64_t >(0u));
+}
 
-//! The flag indicates whether OBJ_DONT_REPARSE flag is not supported by the kernel
-static bool g_no_obj_dont_reparse = false;
+//! Returns \c true if the files on the filesystem have generated content, which cannot be copied by \c sendfile or \c copy_file_range
+inline bool has_generated_content(struct statfs const& sfs) BOOST_NOEXCEPT
+{
+    return sfs.f_type == PROC_SUPER_MAGIC ||
+        sfs.f_type == SYSFS_MAGIC ||
+        sfs.f_type == TRACEFS_MAGIC ||
+        sfs.f_type == DEBUGFS_MAGIC;
+}
 
-//! Creates a file handle for a file relative to a previously opened base directory. The file path must be relative and in preferred format.
-boost::winapi::NTSTATUS_ nt_create_file_handle_at(HANDLE& out, HANDLE basedir_handle, boost::filesystem::path const& p, ULONG FileAttributes, ACCESS_MASK DesiredAccess, ULONG ShareMode, ULONG CreateDisposition, ULONG CreateOptions)
+#if defined(BOOST_FILESYSTEM_USE_IO_URING_COPY)
+
+//! Maximum number of file data chunks in flight in the io_uring copy engine
+BOOST_CONSTEXPR_OR_CONST unsigned int io_uring_copy_queue_depth = 32u;
+//! Size of a file data chunk, which is transferred by a pair of linked read and write requests
+BOOST_CONSTEXPR_OR_CONST unsigned int io_uring_copy_chunk_size = 128u * 1024u;
+//! Maximum number of files copied concurrently by the io_uring copy engine. Limits the number of open file descriptors.
+BOOST_CONSTEXPR_OR_CONST std::size_t io_uring_copy_max_files = 64u;
+
+/*!
+ * Copies data of multiple files concurrently using io_uring.
+ *
+ * The data of every file is split into chunks, and every chunk is transferred by a read request linked with a write request
+ * that uses the same buffer, so that only one submission is needed per chunk. Chunks of any files are kept in flight up to
+ * the queue depth, the files are served in the order they were added. The buffers are registered with io_uring, if possible,
+ * to avoid mapping them on every request. All requests are submitted and completed by the thread that calls the engine.
+ *
+ * If io_uring cannot read or write a file, e.g. because the filesystem does not support it, the data is copied with a read/write
+ * loop instead, and the fallback is remembered for the pair of source and target devices in the copy method cache.
+ */
+class io_uring_copy_engine
 {
-    NtCreateFile_t* nt_create_file = filesystem::detail::atomic_load_relaxed(nt_create_file_api);
-    if (BOOST_UNLIKELY(!nt_create_file))
-        return STATUS_NOT_IMPLEMENTED;
+private:
+    //! A file being copied
+    struct file_job
+    {
+        int infile;
+        int outfile;
+        uintmax_t size;
+        //! Offset of the next chunk to submit
+        uintmax_t next_offset;
+        std::size_t blksize;
+        //! Key of the copy method cache, or 0 if the method should not be cached
+        uint64_t cache_key;
+        //! Index of the file, which is reported on errors
+        std::size_t index;
+        //! Number of chunks in flight
+        unsigned int chunks_in_flight;
+        int err;
+        //! Indicates that the job owns the file descriptors and must close them when done
+        bool owns_files;
+        //! Indicates that the file descriptors were drawn from the process-wide descriptor budget
+        bool budgeted;
+        //! Indicates that the end of the source file was reached before the expected size
+        bool eof;
+        //! Indicates that some data was written to the target file
+        bool transferred;
+        instrumentation_timer timer;
+    };
 
-    unicode_string obj_name = {};
-    obj_name.Buffer = const_cast< wchar_t* >(p.c_str());
-    obj_name.Length = obj_name.MaximumLength = static_cast< USHORT >(p.size() * sizeof(wchar_t));
+    //! A chunk of file data in flight
+    struct chunk
+    {
+        std::size_t job;
+        uintmax_t offset;
+        unsigned int size;
+        //! Number of bytes read into the buffer
+        unsigned int filled;
+        //! Number of bytes written to the target file
+        unsigned int written;
+        //! Number of requests of this chunk that are not completed yet
+        unsigned int pending_requests;
+        //! Indicates that the end of the source file was reached within the chunk
+        bool eof;
+    };
 
-    object_attributes obj_attrs = {};
-    obj_attrs.Length = sizeof(obj_attrs);
-    obj_attrs.RootDirectory = basedir_handle;
-    obj_attrs.ObjectName = &obj_name;
+    io_uring_instance m_ring;
+    void* m_buffers;
+    std::size_t m_buffers_size;
+    bool m_fixed_buffers;
+    unsigned int m_queue_depth;
+    unsigned int m_unsubmitted;
+    std::vector< chunk > m_chunks;
+    std::vector< unsigned int > m_free_chunks;
+    std::vector< file_job > m_jobs;
+    std::vector< std::size_t > m_free_jobs;
+    //! FIFO of the jobs that have chunks left to submit, \c io_uring_copy_max_files elements
+    std::vector< std::size_t > m_pending_jobs;
+    std::size_t m_pending_jobs_head, m_pending_jobs_count;
+
+    std::size_t m_next_index;
+    std::size_t m_failed_count;
+    std::size_t m_failed_index;
+    int m_err;
+    bool m_fell_back;
+
+public:
+    io_uring_copy_engine() BOOST_NOEXCEPT :
+        m_buffers(MAP_FAILED),
+        m_buffers_size(0u),
+        m_fixed_buffers(false),
+        m_queue_depth(0u),
+        m_unsubmitted(0u),
+        m_pending_jobs_head(0u),
+        m_pending_jobs_count(0u),
+        m_next_index(0u),
+        m_failed_count(0u),
+        m_failed_index(0u),
+        m_err(0),
+        m_fell_back(false)
+    {
+    }
+
+    ~io_uring_copy_engine() BOOST_NOEXCEPT
+    {
+        // The kernel may still be accessing the buffers, wait for the requests in flight to complete
+        cancel();
+        drain();
+
+        if (m_buffers != MAP_FAILED)
+            ::munmap(m_buffers, m_buffers_size);
+    }
+
+    //! Initializes the engine with up to \a queue_depth chunks in flight. Returns 0 on success or the error code otherwise.
+    int init(unsigned int queue_depth) BOOST_NOEXCEPT
+    {
+        // Every chunk requires at most two submission queue entries
+        int err = m_ring.init(queue_depth * 2u);
+        if (BOOST_UNLIKELY(err != 0))
+        {
+            // io_uring may be disabled by the kernel configuration, sysctl or seccomp filters
+            if (err == EPERM || err == EACCES || err == EINVAL)
+                err = ENOSYS;
+            return err;
+        }
 
-    obj_attrs.Attributes = OBJ_CASE_INSENSITIVE;
-    if ((CreateOptions & FILE_OPEN_REPARSE_POINT) != 0u && !filesystem::detail::atomic_load_relaxed(g_no_obj_dont_reparse))
-        obj_attrs.Attributes |= OBJ_DONT_REPARSE;
+        m_buffers_size = static_cast< std::size_t >(queue_depth) * io_uring_copy_chunk_size;
+        m_buffers = ::mmap(NULL, m_buffers_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (BOOST_UNLIKELY(m_buffers == MAP_FAILED))
+            return errno;
 
-    io_status_block iosb;
-    boost::winapi::NTSTATUS_ status = nt_create_file
-    (
-        &out,
-        DesiredAccess,
-        &obj_attrs,
-        &iosb,
-        NULL, // AllocationSize
-        FileAttributes,
-        ShareMode,
-        CreateDisposition,
-        CreateOptions,
-        NULL, // EaBuffer
-        0u // EaLength
-    );
+        try
+        {
+            m_chunks.resize(queue_depth);
+            m_free_chunks.resize(queue_depth);
+            m_jobs.resize(io_uring_copy_max_files);
+            m_free_jobs.resize(io_uring_copy_max_files);
+            m_pending_jobs.resize(io_uring_copy_max_files);
+
+            // Registering the buffers may fail because of the limit of locked memory, in which case the buffers are mapped on every request
+            std::vector< struct iovec > iovecs(queue_depth);
+            for (unsigned int i = 0u; i < queue_depth; ++i)
+            {
+                iovecs[i].iov_base = get_buffer(i);
+                iovecs[i].iov_len = io_uring_copy_chunk_size;
+            }
+            m_fixed_buffers = m_ring.register_buffers(&iovecs[0], queue_depth) == 0;
+        }
+        catch (std::bad_alloc&)
+        {
+            return ENOMEM;
+        }
 
-    if (BOOST_UNLIKELY(status == STATUS_INVALID_PARAMETER && (obj_attrs.Attributes & OBJ_DONT_REPARSE) != 0u))
-    {
-        // OBJ_DONT_REPARSE is supported since Windows 10, retry without it
-        filesystem::detail::atomic_store_relaxed(g_no_obj_dont_reparse, true);
-        obj_attrs.Attributes &= ~static_cast< ULONG >(OBJ_DONT_REPARSE);
+        for (unsigned int i = 0u; i < queue_depth; ++i)
+            m_free_chunks[i] = queue_depth - i - 1u;
+        for (std::size_t i = 0u; i < io_uring_copy_max_files; ++i)
+            m_free_jobs[i] = io_uring_copy_max_files - i - 1u;
 
-        status = nt_create_file
-        (
-            &out,
-            DesiredAccess,
-            &obj_attrs,
-            &iosb,
-            NULL, // AllocationSize
-            FileAttributes,
-            ShareMode,
-            CreateDisposition,
-            CreateOptions,
-            NULL, // EaBuffer
-            0u // EaLength
-        );
+        m_queue_depth = queue_depth;
+        return 0;
     }
 
-    return status;
-}
+    //! Sets the index of the file that will be added next
+    void set_next_index(std::size_t index) BOOST_NOEXCEPT { m_next_index = index; }
 
-#endif // !defined(UNDER_CE)
+    /*!
+     * Starts copying \a size bytes from \a infile to \a outfile. If \a owns_files is \c true, the engine takes ownership of
+     * the file descriptors and closes them when the copying completes. Errors are reported by \c get_error. If the maximum number
+     * of files are being copied already, waits for one of them to complete.
+     */
+    void add(int infile, int outfile, uintmax_t size, std::size_t blksize, dev_t from_dev, dev_t to_dev, bool owns_files) BOOST_NOEXCEPT
+    {
+        // The files other than the first one in flight draw their descriptors from the process-wide budget.
+        // If the budget is exhausted, wait for one of the files to complete instead.
+        bool budgeted = false;
+        while (true)
+        {
+            if (!m_free_jobs.empty())
+            {
+                if (!owns_files || m_free_jobs.size() == m_jobs.size() || !is_descriptor_budget_limited())
+                    break;
+                if (try_acquire_descriptors(2u))
+                {
+                    budgeted = true;
+                    break;
+                }
+            }
 
-bool is_reparse_point_a_symlink_ioctl(HANDLE h)
-{
-    boost::scoped_ptr< reparse_data_buffer_with_storage > buf(new reparse_data_buffer_with_storage);
+            step();
+        }
 
-    // Query the reparse data
-    DWORD dwRetLen = 0u;
-    BOOL result = ::DeviceIoControl(h, FSCTL_GET_REPARSE_POINT, NULL, 0, buf.get(), sizeof(*buf), &dwRetLen, NULL);
-    if (BOOST_UNLIKELY(!result))
-        return false;
+        const std::size_t job_index = m_free_jobs.back();
+        m_free_jobs.pop_back();
+
+        file_job& job = m_jobs[job_index];
+        job.infile = infile;
+        job.outfile = outfile;
+        job.size = size;
+        job.next_offset = 0u;
+        job.blksize = blksize;
+        job.cache_key = owns_files && size > 0u ? make_copy_method_cache_key(from_dev, to_dev) : static_cast< uint64_t >(0u);
+        job.index = m_next_index;
+        job.chunks_in_flight = 0u;
+        job.err = 0;
+        job.owns_files = owns_files;
+        job.budgeted = budgeted;
+        job.eof = false;
+        job.transferred = false;
+        job.timer.restart();
+
+        // When not owning the files, the engine is used by copy_file_data_io_uring, which is called by check_fs_type
+        // that has already selected the method
+        copy_method method = copy_method_unknown;
+        if (owns_files)
+        {
+            if (job.cache_key != 0u)
+                method = lookup_copy_method(job.cache_key);
 
-    return is_reparse_point_tag_a_symlink(buf->rdb.ReparseTag);
-}
+            if (method == copy_method_unknown)
+            {
+                // Like in check_fs_type, files with generated content must be copied with a read/write loop
+                struct statfs sfs;
+                int err;
+                while ((err = ::fstatfs(infile, &sfs)) < 0 && errno == EINTR) {}
+                if (err == 0 && has_generated_content(sfs))
+                    method = copy_method_read_write;
+            }
+        }
 
-namespace {
+        if (method != copy_method_unknown && method != copy_method_io_uring)
+        {
+            job.err = copy_file_data_read_write(infile, outfile, size, blksize);
+            finish_job(job_index);
+            return;
+        }
 
-inline bool is_reparse_point_a_symlink(path const& p)
-{
-    handle_wrapper h(create_file_handle(
-        p,
-        FILE_READ_ATTRIBUTES,
-        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
-        NULL,
-        OPEN_EXISTING,
-        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OPEN_REPARSE_POINT));
-    if (BOOST_UNLIKELY(h.handle == INVALID_HANDLE_VALUE))
-        return false;
+        if (size == 0u)
+        {
+            finish_job(job_index);
+            return;
+        }
 
-    GetFileInformationByHandleEx_t* get_file_information_by_handle_ex = filesystem::detail::atomic_load_relaxed(get_file_information_by_handle_ex_api);
-    if (BOOST_LIKELY(get_file_information_by_handle_ex != NULL))
-    {
-        file_attribute_tag_info info;
-        BOOL result = get_file_information_by_handle_ex(h.handle, file_attribute_tag_info_class, &info, sizeof(info));
-        if (BOOST_UNLIKELY(!result))
-            return false;
+        m_pending_jobs[(m_pending_jobs_head + m_pending_jobs_count) % io_uring_copy_max_files] = job_index;
+        ++m_pending_jobs_count;
 
-        if ((info.FileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) == 0u)
-            return false;
+        // Start the transfer right away to overlap it with opening the next files
+        submit_chunks();
+        if (m_unsubmitted > 0u)
+            submit(0u);
+        reap();
+    }
 
-        return is_reparse_point_tag_a_symlink(info.ReparseTag);
+    //! Waits for all files to be copied
+    void drain() BOOST_NOEXCEPT
+    {
+        while (m_free_jobs.size() < m_jobs.size())
+            step();
     }
 
-    return is_reparse_point_a_symlink_ioctl(h.handle);
-}
+    //! Stops submitting new chunks and fails the files that were not submitted completely
+    void cancel() BOOST_NOEXCEPT
+    {
+        while (m_pending_jobs_count > 0u)
+        {
+            const std::size_t job_index = m_pending_jobs[m_pending_jobs_head];
+            m_pending_jobs_head = (m_pending_jobs_head + 1u) % io_uring_copy_max_files;
+            --m_pending_jobs_count;
+
+            file_job& job = m_jobs[job_index];
+            job.next_offset = job.size;
+            if (job.err == 0)
+                job.err = ECANCELED;
+            if (job.chunks_in_flight == 0u)
+                finish_job(job_index);
+        }
+    }
 
-inline std::size_t get_full_path_name(path const& src, std::size_t len, wchar_t* buf, wchar_t** p)
-{
-    return static_cast< std::size_t >(::GetFullPathNameW(src.c_str(), static_cast< DWORD >(len), buf, p));
-}
+    //! Returns the first error that occurred, or 0
+    int get_error() const BOOST_NOEXCEPT { return m_err; }
+    //! Returns the index of the file that failed with the error returned by \c get_error
+    std::size_t get_failed_index() const BOOST_NOEXCEPT { return m_failed_index; }
+    //! Returns the number of files that failed to copy
+    std::size_t get_failed_count() const BOOST_NOEXCEPT { return m_failed_count; }
+    //! Returns \c true if any files were copied with a read/write loop instead of io_uring
+    bool fell_back() const BOOST_NOEXCEPT { return m_fell_back; }
 
-inline fs::file_status process_status_failure(DWORD errval, path const& p, error_code* ec)
-{
-    if (ec)                                    // always report errval, even though some
-        ec->assign(errval, system_category()); // errval values are not status_errors
+    BOOST_DELETED_FUNCTION(io_uring_copy_engine(io_uring_copy_engine const&))
+    BOOST_DELETED_FUNCTION(io_uring_copy_engine& operator=(io_uring_copy_engine const&))
 
-    if (not_found_error(errval))
+private:
+    void* get_buffer(unsigned int chunk_index) const BOOST_NOEXCEPT
     {
-        return fs::file_status(fs::file_not_found, fs::no_perms);
+        return static_cast< unsigned char* >(m_buffers) + static_cast< std::size_t >(chunk_index) * io_uring_copy_chunk_size;
     }
-    else if (errval == ERROR_SHARING_VIOLATION)
+
+    //! Submits new requests and processes the completed ones, waiting for at least one completion
+    void step() BOOST_NOEXCEPT
     {
-        return fs::file_status(fs::type_unknown);
+        submit_chunks();
+        submit(1u);
+        reap();
     }
 
-    if (!ec)
-        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::status", p, error_code(errval, system_category())));
+    //! Prepares the requests to transfer the new chunks of the pending jobs
+    void submit_chunks() BOOST_NOEXCEPT
+    {
+        while (m_pending_jobs_count > 0u && !m_free_chunks.empty())
+        {
+            const std::size_t job_index = m_pending_jobs[m_pending_jobs_head];
+            file_job& job = m_jobs[job_index];
+
+            const unsigned int chunk_index = m_free_chunks.back();
+            m_free_chunks.pop_back();
+
+            chunk& ch = m_chunks[chunk_index];
+            ch.job = job_index;
+            ch.offset = job.next_offset;
+            const uintmax_t size_left = job.size - job.next_offset;
+            ch.size = size_left < io_uring_copy_chunk_size ? static_cast< unsigned int >(size_left) : io_uring_copy_chunk_size;
+            ch.filled = 0u;
+            ch.written = 0u;
+            ch.pending_requests = 0u;
+            ch.eof = false;
+
+            job.next_offset += ch.size;
+            ++job.chunks_in_flight;
+            if (job.next_offset >= job.size)
+            {
+                m_pending_jobs_head = (m_pending_jobs_head + 1u) % io_uring_copy_max_files;
+                --m_pending_jobs_count;
+            }
 
-    return fs::file_status(fs::status_error);
-}
-
-inline fs::file_status process_status_failure(path const& p, error_code* ec)
-{
-    return process_status_failure(::GetLastError(), p, ec);
-}
+            prepare_requests(chunk_index);
+        }
+    }
 
-//! (symlink_)status() by handle implementation
-fs::file_status status_by_handle(HANDLE h, path const& p, error_code* ec)
-{
-    fs::file_type ftype;
-    DWORD attrs;
-    GetFileInformationByHandleEx_t* get_file_information_by_handle_ex = filesystem::detail::atomic_load_relaxed(get_file_information_by_handle_ex_api);
-    if (BOOST_LIKELY(get_file_information_by_handle_ex != NULL))
+    //! Prepares the requests to transfer the rest of the chunk
+    void prepare_requests(unsigned int chunk_index) BOOST_NOEXCEPT
     {
-        file_attribute_tag_info info;
-        BOOL res = get_file_information_by_handle_ex(h, file_attribute_tag_info_class, &info, sizeof(info));
-        if (BOOST_UNLIKELY(!res))
-        {
-            // On FAT/exFAT filesystems requesting FILE_ATTRIBUTE_TAG_INFO returns ERROR_INVALID_PARAMETER.
-            // Presumably, this is because these filesystems don't support reparse points, so ReparseTag
-            // cannot be returned. Also check ERROR_NOT_SUPPORTED for good measure. Fall back to the legacy
-            // code path in this case.
-            DWORD err = ::GetLastError();
-            if (err == ERROR_INVALID_PARAMETER || err == ERROR_NOT_SUPPORTED)
-                goto use_get_file_information_by_handle;
+        chunk& ch = m_chunks[chunk_index];
+        file_job const& job = m_jobs[ch.job];
+        unsigned char* const buffer = static_cast< unsigned char* >(get_buffer(chunk_index));
+        unsigned int tail = m_ring.sq_tail();
 
-            return process_status_failure(err, p, ec);
+        if (ch.filled == ch.written)
+        {
+            // Read the rest of the chunk and write it once the read completes. If the read returns less data than requested,
+            // the kernel cancels the linked write, and the remaining data is written by a separate request.
+            struct io_uring_sqe* sqe = m_ring.get_sqe(tail++);
+            std::memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = m_fixed_buffers ? IORING_OP_READ_FIXED : IORING_OP_READ;
+            sqe->flags = IOSQE_IO_LINK;
+            sqe->fd = job.infile;
+            sqe->addr = reinterpret_cast< boost::uint64_t >(buffer + ch.filled);
+            sqe->len = ch.size - ch.filled;
+            sqe->off = ch.offset + ch.filled;
+            sqe->buf_index = static_cast< boost::uint16_t >(chunk_index);
+            sqe->user_data = static_cast< boost::uint64_t >(chunk_index) << 1u;
+            ++ch.pending_requests;
+            ++m_unsubmitted;
         }
 
-        attrs = info.FileAttributes;
+        struct io_uring_sqe* sqe = m_ring.get_sqe(tail++);
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = m_fixed_buffers ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        sqe->fd = job.outfile;
+        sqe->addr = reinterpret_cast< boost::uint64_t >(buffer + ch.written);
+        sqe->len = (ch.filled == ch.written ? ch.size : ch.filled) - ch.written;
+        sqe->off = ch.offset + ch.written;
+        sqe->buf_index = static_cast< boost::uint16_t >(chunk_index);
+        sqe->user_data = (static_cast< boost::uint64_t >(chunk_index) << 1u) | 1u;
+        ++ch.pending_requests;
+        ++m_unsubmitted;
 
-        if (attrs & FILE_ATTRIBUTE_REPARSE_POINT)
-        {
-            ftype = is_reparse_point_tag_a_symlink(info.ReparseTag) ? fs::symlink_file : fs::reparse_file;
-            goto done;
-        }
+        m_ring.set_sq_tail(tail);
     }
-    else
-    {
-    use_get_file_information_by_handle:
-        BY_HANDLE_FILE_INFORMATION info;
-        BOOL res = ::GetFileInformationByHandle(h, &info);
-        if (BOOST_UNLIKELY(!res))
-            return process_status_failure(p, ec);
-
-        attrs = info.dwFileAttributes;
 
-        if (attrs & FILE_ATTRIBUTE_REPARSE_POINT)
+    //! Submits the prepared requests and waits for at least \a min_complete completions
+    void submit(unsigned int min_complete) BOOST_NOEXCEPT
+    {
+        while (true)
         {
-            ftype = is_reparse_point_a_symlink_ioctl(h) ? fs::symlink_file : fs::reparse_file;
-            goto done;
-        }
-    }
+            const int res = m_ring.enter(m_unsubmitted, min_complete);
+            if (BOOST_LIKELY(res >= 0))
+            {
+                m_unsubmitted -= static_cast< unsigned int >(res);
+                return;
+            }
 
-    ftype = (attrs & FILE_ATTRIBUTE_DIRECTORY) ? fs::directory_file : fs::regular_file;
+            const int err = errno;
+            if (err == EINTR)
+                continue;
 
-done:
-    return fs::file_status(ftype, make_permissions(p, attrs));
-}
+            // EBUSY means the completion queue is full. The completions will be reaped and the submission retried.
+            if (err == EAGAIN || err == EBUSY)
+                return;
 
-//! symlink_status() implementation
-fs::file_status symlink_status_impl(path const& p, error_code* ec)
-{
-    handle_wrapper h(create_file_handle(
-        p.c_str(),
-        FILE_READ_ATTRIBUTES, // dwDesiredAccess; attributes only
-        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
-        NULL, // lpSecurityAttributes
-        OPEN_EXISTING,
-        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OPEN_REPARSE_POINT));
+            // io_uring is unusable, fail the jobs of the requests that were not submitted
+            abort_unsubmitted(err);
+            return;
+        }
+    }
 
-    if (h.handle == INVALID_HANDLE_VALUE)
+    //! Discards the requests that could not be submitted and fails the jobs they belong to
+    void abort_unsubmitted(int err) BOOST_NOEXCEPT
     {
-        // For some system files and folders like "System Volume Information" CreateFileW fails
-        // with ERROR_ACCESS_DENIED. GetFileAttributesW succeeds for such files, so try that.
-        // Though this will only help if the file is not a reparse point (symlink or not).
-        DWORD err = ::GetLastError();
-        if (err == ERROR_ACCESS_DENIED)
+        unsigned int tail = m_ring.sq_tail();
+        for (; m_unsubmitted > 0u; --m_unsubmitted)
         {
-            DWORD attrs = ::GetFileAttributesW(p.c_str());
-            if (attrs != INVALID_FILE_ATTRIBUTES)
-            {
-                if ((attrs & FILE_ATTRIBUTE_REPARSE_POINT) == 0u)
-                    return fs::file_status((attrs & FILE_ATTRIBUTE_DIRECTORY) ? fs::directory_file : fs::regular_file, make_permissions(p, attrs));
-            }
-            else
-            {
-                err = ::GetLastError();
-            }
+            struct io_uring_sqe const* sqe = m_ring.get_sqe(--tail);
+            const unsigned int chunk_index = static_cast< unsigned int >(sqe->user_data >> 1u);
+            chunk& ch = m_chunks[chunk_index];
+            file_job& job = m_jobs[ch.job];
+            if (job.err == 0)
+                job.err = err;
+            if (--ch.pending_requests == 0u)
+                complete_chunk(chunk_index);
         }
-
-        return process_status_failure(err, p, ec);
+        m_ring.set_sq_tail(tail);
     }
 
-    return detail::status_by_handle(h.handle, p, ec);
-}
-
-//! status() implementation
-fs::file_status status_impl(path const& p, error_code* ec)
-{
-    // We should first test if the file is a symlink or a reparse point. Resolving some reparse
-    // points by opening the file may fail, and status() should return file_status(reparse_file) in this case.
-    // Which is what symlink_status() returns.
-    fs::file_status st(detail::symlink_status_impl(p, ec));
-    if (st.type() == symlink_file)
+    //! Processes the completed requests
+    void reap() BOOST_NOEXCEPT
     {
-        // Resolve the symlink
-        handle_wrapper h(create_file_handle(
-            p.c_str(),
-            FILE_READ_ATTRIBUTES, // dwDesiredAccess; attributes only
-            FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
-            NULL, // lpSecurityAttributes
-            OPEN_EXISTING,
-            FILE_FLAG_BACKUP_SEMANTICS));
+        unsigned int head = m_ring.cq_head();
+        for (unsigned int cq_tail = m_ring.cq_tail(); head != cq_tail; cq_tail = m_ring.cq_tail())
+        {
+            for (; head != cq_tail; ++head)
+            {
+                struct io_uring_cqe const& cqe = m_ring.get_cqe(head);
+                const unsigned int chunk_index = static_cast< unsigned int >(cqe.user_data >> 1u);
+                const bool is_write = (cqe.user_data & 1u) != 0u;
+                chunk& ch = m_chunks[chunk_index];
+                file_job& job = m_jobs[ch.job];
 
-        if (h.handle == INVALID_HANDLE_VALUE)
-            return process_status_failure(p, ec);
+                if (cqe.res >= 0)
+                {
+                    if (!is_write)
+                    {
+                        ch.filled += static_cast< unsigned int >(cqe.res);
+                        if (cqe.res == 0)
+                        {
+                            ch.eof = true;
+                            job.eof = true;
+                        }
+                    }
+                    else
+                    {
+                        ch.written += static_cast< unsigned int >(cqe.res);
+                        job.transferred = true;
+                    }
+                }
+                else if (cqe.res != -ECANCELED && cqe.res != -EINTR && cqe.res != -EAGAIN)
+                {
+                    // The linked write is cancelled if the read fails or is short. It will be retried if needed.
+                    if (job.err == 0)
+                        job.err = -cqe.res;
+                }
 
-        st = detail::status_by_handle(h.handle, p, ec);
-    }
+                if (--ch.pending_requests == 0u)
+                    complete_chunk(chunk_index);
+            }
 
-    return st;
-}
+            m_ring.set_cq_head(head);
+        }
+    }
 
-//! remove() implementation for Windows XP and older
-bool remove_nt5_impl(path const& p, DWORD attrs, error_code* ec)
-{
-    const bool is_directory = (attrs & FILE_ATTRIBUTE_DIRECTORY) != 0;
-    const bool is_read_only = (attrs & FILE_ATTRIBUTE_READONLY) != 0;
-    if (is_read_only)
+    //! Processes the chunk with no requests in flight
+    void complete_chunk(unsigned int chunk_index) BOOST_NOEXCEPT
     {
-        // RemoveDirectoryW and DeleteFileW do not allow to remove a read-only file, so we have to drop the attribute
-        DWORD new_attrs = attrs & ~FILE_ATTRIBUTE_READONLY;
-        BOOL res = ::SetFileAttributesW(p.c_str(), new_attrs);
-        if (BOOST_UNLIKELY(!res))
+        chunk& ch = m_chunks[chunk_index];
+        const std::size_t job_index = ch.job;
+        file_job& job = m_jobs[job_index];
+        if (job.err == 0 && ch.written < ch.size && !(ch.eof && ch.written == ch.filled))
         {
-            DWORD err = ::GetLastError();
-            if (!not_found_error(err))
-                emit_error(err, p, ec, "boost::filesystem::remove");
+            // The chunk was transferred partially, continue with the rest of it
+            ch.eof = false;
+            prepare_requests(chunk_index);
+            return;
+        }
 
-            return false;
+        m_free_chunks.push_back(chunk_index);
+        --job.chunks_in_flight;
+
+        if ((job.err != 0 || job.eof) && job.next_offset < job.size)
+        {
+            // Don't submit more chunks after an error or past the end of the source file
+            remove_pending_job(job_index);
+            job.next_offset = job.size;
         }
-    }
 
-    BOOL res;
-    if (!is_directory)
-    {
-        // DeleteFileW works for file symlinks by removing the symlink, not the target.
-        res = ::DeleteFileW(p.c_str());
+        if (job.chunks_in_flight == 0u && job.next_offset >= job.size)
+            finish_job(job_index);
     }
-    else
+
+    //! Removes the job from the queue of jobs that have chunks left to submit
+    void remove_pending_job(std::size_t job_index) BOOST_NOEXCEPT
     {
-        // RemoveDirectoryW works for symlinks and junctions by removing the symlink, not the target,
-        // even if the target directory is not empty.
-        // Note that unlike opening the directory with FILE_FLAG_DELETE_ON_CLOSE flag, RemoveDirectoryW
-        // will fail if the directory is not empty.
-        res = ::RemoveDirectoryW(p.c_str());
+        std::size_t pos = 0u;
+        while (m_pending_jobs[(m_pending_jobs_head + pos) % io_uring_copy_max_files] != job_index)
+            ++pos;
+        for (; pos + 1u < m_pending_jobs_count; ++pos)
+        {
+            m_pending_jobs[(m_pending_jobs_head + pos) % io_uring_copy_max_files] =
+                m_pending_jobs[(m_pending_jobs_head + pos + 1u) % io_uring_copy_max_files];
+        }
+        --m_pending_jobs_count;
     }
 
-    if (BOOST_UNLIKELY(!res))
+    //! Completes the job with no chunks in flight
+    void finish_job(std::size_t job_index) BOOST_NOEXCEPT
     {
-        DWORD err = ::GetLastError();
-        if (!not_found_error(err))
+        file_job& job = m_jobs[job_index];
+        if ((job.err == EINVAL || job.err == EOPNOTSUPP) && !job.transferred)
         {
-            if (is_read_only)
+            // The file does not support io_uring requests, or the kernel does not support linked requests (Linux 5.1 - 5.2)
+            record_instrumented_event(instrumented_operation::operation_fallback);
+            BOOST_FILESYSTEM_TRACE1(copy_file_data__fallback, job.err);
+            m_fell_back = true;
+            job.err = copy_file_data_read_write(job.infile, job.outfile, job.size, job.blksize);
+            if (job.cache_key != 0u && job.err == 0)
+                store_copy_method(job.cache_key, copy_method_read_write);
+        }
+        else if (job.cache_key != 0u && job.err == 0 && job.transferred && lookup_copy_method(job.cache_key) != copy_method_io_uring)
+        {
+            store_copy_method(job.cache_key, copy_method_io_uring);
+        }
+
+        if (job.owns_files)
+        {
+            close_fd(job.infile);
+
+            // Check for errors on closing the target file, which may indicate a failure of a prior write
+            if (BOOST_UNLIKELY(close_fd(job.outfile) < 0))
             {
-                // Try to restore the read-only attribute
-                ::SetFileAttributesW(p.c_str(), attrs);
+                const int err = errno;
+                if (err != EINTR && err != EINPROGRESS && job.err == 0)
+                    job.err = err;
             }
-
-            emit_error(err, p, ec, "boost::filesystem::remove");
         }
 
-        return false;
-    }
+        if (job.budgeted)
+        {
+            release_descriptors(2u);
+            job.budgeted = false;
+        }
 
-    return true;
-}
+        job.timer.record(instrumented_operation::copy_io_uring);
 
-//! remove() by handle implementation for Windows Vista and newer
-DWORD remove_nt6_by_handle(HANDLE handle, remove_impl_type impl)
-{
-    GetFileInformationByHandleEx_t* get_file_information_by_handle_ex = filesystem::detail::atomic_load_relaxed(get_file_information_by_handle_ex_api);
-    SetFileInformationByHandle_t* set_file_information_by_handle = filesystem::detail::atomic_load_relaxed(set_file_information_by_handle_api);
-    DWORD err = 0u;
-    switch (impl)
-    {
-    case remove_disp_ex_flag_ignore_readonly:
+        if (BOOST_UNLIKELY(job.err != 0))
         {
-            file_disposition_info_ex info;
-            info.Flags = FILE_DISPOSITION_FLAG_DELETE | FILE_DISPOSITION_FLAG_POSIX_SEMANTICS | FILE_DISPOSITION_FLAG_IGNORE_READONLY_ATTRIBUTE;
-            BOOL res = set_file_information_by_handle(handle, file_disposition_info_ex_class, &info, sizeof(info));
-            if (BOOST_LIKELY(!!res))
-                break;
-
-            err = ::GetLastError();
-            if (BOOST_UNLIKELY(err == ERROR_INVALID_PARAMETER || err == ERROR_INVALID_FUNCTION || err == ERROR_NOT_SUPPORTED))
+            ++m_failed_count;
+            if (m_err == 0 || job.index < m_failed_index)
             {
-                // Downgrade to the older implementation
-                impl = remove_disp_ex_flag_posix_semantics;
-                filesystem::detail::atomic_store_relaxed(g_remove_impl_type, impl);
-            }
-            else
-            {
-                break;
+                m_err = job.err;
+                m_failed_index = job.index;
             }
         }
-        BOOST_FALLTHROUGH;
 
-    case remove_disp_ex_flag_posix_semantics:
+        m_free_jobs.push_back(job_index);
+    }
+};
+
+//! copy_file_data implementation that uses io_uring
+struct copy_file_data_io_uring
+{
+    static BOOST_CONSTEXPR_OR_CONST copy_method method = copy_method_io_uring;
+
+    //! copy_file implementation that transfers the file data with linked io_uring requests.
+    //! On return, \a used_method indicates the method that was used to copy the data.
+    static int impl(int infile, int outfile, uintmax_t size, std::size_t blksize, copy_method& used_method)
+    {
+        used_method = copy_method_io_uring;
+        if (size == 0u)
+            return 0;
+
+        // Don't allocate more buffers than needed for the file
+        const uintmax_t chunk_count = (size + (io_uring_copy_chunk_size - 1u)) / io_uring_copy_chunk_size;
+        io_uring_copy_engine engine;
+        int err = engine.init(chunk_count < io_uring_copy_queue_depth ? static_cast< unsigned int >(chunk_count) : io_uring_copy_queue_depth);
+        if (BOOST_UNLIKELY(err != 0))
         {
-            file_disposition_info_ex info;
-            info.Flags = FILE_DISPOSITION_FLAG_DELETE | FILE_DISPOSITION_FLAG_POSIX_SEMANTICS;
-            BOOL res = set_file_information_by_handle(handle, file_disposition_info_ex_class, &info, sizeof(info));
-            if (BOOST_LIKELY(!!res))
+            if (err == ENOSYS)
             {
-                err = 0u;
-                break;
+                // Let the library select the best supported implementation for the following copies
+                record_instrumented_event(instrumented_operation::implementation_fallback);
+                BOOST_FILESYSTEM_TRACE1(copy_file_data__downgrade, err);
+                filesystem::detail::atomic_store_relaxed(copy_file_data, &copy_file_data_select_impl);
             }
 
-            err = ::GetLastError();
-            if (err == ERROR_ACCESS_DENIED)
-            {
-                // Check if the file is read-only and reset the attribute
-                file_basic_info basic_info;
-                res = get_file_information_by_handle_ex(handle, file_basic_info_class, &basic_info, sizeof(basic_info));
-                if (BOOST_UNLIKELY(!res || (basic_info.FileAttributes & FILE_ATTRIBUTE_READONLY) == 0))
-                    break; // return ERROR_ACCESS_DENIED
+            // The failure is not related to the filesystems, so don't cache the method
+            used_method = copy_method_unknown;
+            return copy_file_data_read_write(infile, outfile, size, blksize);
+        }
 
-                basic_info.FileAttributes &= ~FILE_ATTRIBUTE_READONLY;
+        engine.add(infile, outfile, size, blksize, 0u, 0u, false);
+        engine.drain();
+        if (engine.fell_back())
+            used_method = copy_method_read_write;
 
-                res = set_file_information_by_handle(handle, file_basic_info_class, &basic_info, sizeof(basic_info));
-                if (BOOST_UNLIKELY(!res))
-                {
-                    err = ::GetLastError();
-                    break;
-                }
+        return engine.get_error();
+    }
+};
 
-                // Try to set the flag again
-                res = set_file_information_by_handle(handle, file_disposition_info_ex_class, &info, sizeof(info));
-                if (BOOST_LIKELY(!!res))
-                {
-                    err = 0u;
-                    break;
-                }
+#endif // defined(BOOST_FILESYSTEM_USE_IO_URING_COPY)
 
-                err = ::GetLastError();
+//! copy_file_data wrapper that selects the data copying method for the given source and target devices
+template< typename CopyFileData >
+int check_fs_type(int infile, int outfile, uintmax_t size, std::size_t blksize, dev_t from_dev, dev_t to_dev)
+{
+    // Files in procfs, tracefs and debugfs report zero size, always detect the filesystem type for such files.
+    // This protects against device numbers of unmounted filesystems being reused for special filesystems.
+    const uint64_t key = size > 0u ? make_copy_method_cache_key(from_dev, to_dev) : static_cast< uint64_t >(0u);
 
-                // Try to restore the read-only flag
-                basic_info.FileAttributes |= FILE_ATTRIBUTE_READONLY;
-                set_file_information_by_handle(handle, file_basic_info_class, &basic_info, sizeof(basic_info));
+    copy_method method = copy_method_unknown;
+    if (key != 0u)
+        method = lookup_copy_method(key);
 
-                break;
-            }
-            else if (BOOST_UNLIKELY(err == ERROR_INVALID_PARAMETER || err == ERROR_INVALID_FUNCTION || err == ERROR_NOT_SUPPORTED))
-            {
-                // Downgrade to the older implementation
-                impl = remove_disp;
-                filesystem::detail::atomic_store_relaxed(g_remove_impl_type, impl);
-            }
-            else
+    if (method == copy_method_unknown)
+    {
+        // Some filesystems have regular files with generated content. Such files have arbitrary size, including zero,
+        // but have actual content. Linux system calls sendfile or copy_file_range will not copy contents of such files,
+        // so we must use a read/write loop to handle them.
+        // https://lore.kernel.org/linux-fsdevel/20210212044405.4120619-1-drinkcat@chromium.org/T/
+        method = CopyFileData::method;
+
+        struct statfs sfs;
+        while (true)
+        {
+            int err = ::fstatfs(infile, &sfs);
+            if (BOOST_UNLIKELY(err < 0))
             {
-                break;
+                err = errno;
+                if (err == EINTR)
+                    continue;
+
+                // Don't cache the method since the filesystem type is not known
+                return copy_file_data_read_write(infile, outfile, size, blksize);
             }
+
+            break;
         }
-        BOOST_FALLTHROUGH;
 
+        if (BOOST_UNLIKELY(has_generated_content(sfs)))
+            method = copy_method_read_write;
+    }
+    else if (method > CopyFileData::method)
+    {
+        // The cached method was detected while a more preferred implementation was selected
+        method = CopyFileData::method;
+    }
+
+    copy_method used_method = method;
+    int err;
+    switch (method)
+    {
+#if defined(BOOST_FILESYSTEM_USE_IO_URING_COPY)
+    case copy_method_io_uring:
+        err = copy_file_data_io_uring::impl(infile, outfile, size, blksize, used_method);
+        break;
+#endif
+#if defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+    case copy_method_copy_file_range:
+        err = copy_file_data_copy_file_range::impl(infile, outfile, size, blksize, used_method);
+        break;
+#endif
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
+    case copy_method_sendfile:
+        err = copy_file_data_sendfile::impl(infile, outfile, size, blksize, used_method);
+        break;
+#endif
     default:
-        {
-            file_disposition_info info;
-            info.DeleteFile = true;
-            BOOL res = set_file_information_by_handle(handle, file_disposition_info_class, &info, sizeof(info));
-            if (BOOST_LIKELY(!!res))
-            {
-                err = 0u;
-                break;
-            }
+        err = copy_file_data_read_write(infile, outfile, size, blksize);
+        break;
+    }
 
-            err = ::GetLastError();
-            if (err == ERROR_ACCESS_DENIED)
-            {
-                // Check if the file is read-only and reset the attribute
-                file_basic_info basic_info;
-                res = get_file_information_by_handle_ex(handle, file_basic_info_class, &basic_info, sizeof(basic_info));
-                if (BOOST_UNLIKELY(!res || (basic_info.FileAttributes & FILE_ATTRIBUTE_READONLY) == 0))
-                    break; // return ERROR_ACCESS_DENIED
+    // Remember the method that worked, including any fallbacks, so that the next copy between the same devices uses it right away
+    if (key != 0u && err == 0 && lookup_copy_method(key) != used_method)
+        store_copy_method(key, used_method);
 
-                basic_info.FileAttributes &= ~FILE_ATTRIBUTE_READONLY;
+    return err;
+}
 
-                res = set_file_information_by_handle(handle, file_basic_info_class, &basic_info, sizeof(basic_info));
-                if (BOOST_UNLIKELY(!res))
-                {
-                    err = ::GetLastError();
-                    break;
-                }
+#endif // defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
 
-                // Try to set the flag again
-                res = set_file_information_by_handle(handle, file_disposition_info_class, &info, sizeof(info));
-                if (BOOST_LIKELY(!!res))
-                {
-                    err = 0u;
-                    break;
-                }
+//! Returns the amount of data to transfer in the next call of a \c copy_data loop
+inline std::size_t get_copy_data_batch_size(uintmax_t size, uintmax_t copied, std::size_t max_size) BOOST_NOEXCEPT
+{
+    const uintmax_t size_left = size - copied;
+    return size_left < static_cast< uintmax_t >(max_size) ? static_cast< std::size_t >(size_left) : max_size;
+}
 
-                err = ::GetLastError();
+/*!
+ * copy_data implementation that uses read/write loop. If \a offset is not \c NULL, the data is read at the offset, which is updated
+ * as the data is read. \a copied is incremented by the amount of data written to \a outfile.
+ */
+int copy_data_read_write(int infile, int outfile, uintmax_t* offset, uintmax_t size, uintmax_t& copied)
+{
+    instrumentation_scope instrumentation(instrumented_operation::copy_read_write);
 
-                // Try to restore the read-only flag
-                basic_info.FileAttributes |= FILE_ATTRIBUTE_READONLY;
-                set_file_information_by_handle(handle, file_basic_info_class, &basic_info, sizeof(basic_info));
-            }
+    char stack_buf[min_read_write_buf_size];
+    char* buf = stack_buf;
+    std::size_t buf_size = sizeof(stack_buf);
+    scoped_copy_buffer heap_buf;
+    if (BOOST_LIKELY(heap_buf.reserve(get_read_write_buf_size(size - copied, 0u))))
+    {
+        buf = heap_buf.data();
+        buf_size = heap_buf.size();
+    }
 
+    while (copied < size)
+    {
+        const std::size_t size_to_read = get_copy_data_batch_size(size, copied, buf_size);
+        ssize_t sz_read = offset ? ::pread(infile, buf, size_to_read, static_cast< off_t >(*offset)) : ::read(infile, buf, size_to_read);
+        if (sz_read == 0)
             break;
+        if (BOOST_UNLIKELY(sz_read < 0))
+        {
+            int err = errno;
+            if (err == EINTR)
+                continue;
+            return err;
+        }
+
+        if (offset)
+            *offset += static_cast< uintmax_t >(sz_read);
+
+        for (ssize_t sz_wrote = 0; sz_wrote < sz_read;)
+        {
+            ssize_t sz = ::write(outfile, buf + sz_wrote, static_cast< std::size_t >(sz_read - sz_wrote));
+            if (BOOST_UNLIKELY(sz < 0))
+            {
+                int err = errno;
+                if (err == EINTR)
+                    continue;
+                return err;
+            }
+
+            sz_wrote += sz;
+            copied += static_cast< uintmax_t >(sz);
         }
     }
 
-    return err;
+    return 0;
 }
 
-//! remove() implementation for Windows Vista and newer
-inline bool remove_nt6_impl(path const& p, remove_impl_type impl, error_code* ec)
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE) || defined(BOOST_FILESYSTEM_USE_SPLICE)
+
+//! Kernel data transfer calls will not transfer more than this amount of data in one call
+BOOST_CONSTEXPR_OR_CONST std::size_t max_copy_data_batch_size = 0x7ffff000u;
+
+#endif
+
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
+
+//! copy_data implementation that uses sendfile loop. Returns \c ENOTSUP if sendfile is not supported for the files and no data was copied.
+int copy_data_sendfile(int infile, int outfile, uintmax_t* offset, uintmax_t size, uintmax_t& copied)
 {
-    handle_wrapper h(create_file_handle(
-        p,
-        DELETE | FILE_READ_ATTRIBUTES | FILE_WRITE_ATTRIBUTES,
-        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
-        NULL,
-        OPEN_EXISTING,
-        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OPEN_REPARSE_POINT));
-    DWORD err = 0u;
-    if (BOOST_UNLIKELY(h.handle == INVALID_HANDLE_VALUE))
+    instrumentation_scope instrumentation(instrumented_operation::copy_sendfile);
+
+    off_t pos = offset ? static_cast< off_t >(*offset) : static_cast< off_t >(0);
+    const uintmax_t initial_copied = copied;
+    while (copied < size)
     {
-        err = ::GetLastError();
+        ssize_t sz = ::sendfile(outfile, infile, offset ? &pos : static_cast< off_t* >(NULL), get_copy_data_batch_size(size, copied, max_copy_data_batch_size));
+        if (BOOST_UNLIKELY(sz < 0))
+        {
+            int err = errno;
+            if (err == EINTR)
+                continue;
 
-    return_error:
-        if (!not_found_error(err))
-            emit_error(err, p, ec, "boost::filesystem::remove");
+            // sendfile may fail with EINVAL if the underlying filesystem or the target file type does not support it
+            if (copied == initial_copied && (err == EINVAL || err == ENOSYS))
+                err = ENOTSUP;
 
-        return false;
-    }
+            return err;
+        }
 
-    err = fs::detail::remove_nt6_by_handle(h.handle, impl);
-    if (BOOST_UNLIKELY(err != 0u))
-        goto return_error;
+        if (sz == 0)
+            break;
 
-    return true;
+        copied += static_cast< uintmax_t >(sz);
+        if (offset)
+            *offset = static_cast< uintmax_t >(pos);
+    }
+
+    return 0;
 }
 
-//! remove() implementation
-inline bool remove_impl(path const& p, error_code* ec)
+#endif // defined(BOOST_FILESYSTEM_USE_SENDFILE)
+
+#if defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+
+//! copy_data implementation that uses copy_file_range loop. Returns \c ENOTSUP if copy_file_range is not supported for the files and no data was copied.
+int copy_data_copy_file_range(int infile, int outfile, uintmax_t* offset, uintmax_t size, uintmax_t& copied)
 {
-    remove_impl_type impl = fs::detail::atomic_load_relaxed(g_remove_impl_type);
-    if (BOOST_LIKELY(impl != remove_nt5))
-    {
-        return fs::detail::remove_nt6_impl(p, impl, ec);
-    }
-    else
+    instrumentation_scope instrumentation(instrumented_operation::copy_file_range);
+
+    loff_t pos = offset ? static_cast< loff_t >(*offset) : static_cast< loff_t >(0);
+    const uintmax_t initial_copied = copied;
+    while (copied < size)
     {
-        const DWORD attrs = ::GetFileAttributesW(p.c_str());
-        if (BOOST_UNLIKELY(attrs == INVALID_FILE_ATTRIBUTES))
+        loff_t sz = ::syscall(__NR_copy_file_range, infile, offset ? &pos : static_cast< loff_t* >(NULL), outfile, static_cast< loff_t* >(NULL),
+            get_copy_data_batch_size(size, copied, max_copy_data_batch_size), (unsigned int)0u);
+        if (BOOST_UNLIKELY(sz < 0))
         {
-            DWORD err = ::GetLastError();
-            if (!not_found_error(err))
-                emit_error(err, p, ec, "boost::filesystem::remove");
+            int err = errno;
+            if (err == EINTR)
+                continue;
 
-            return false;
+            // See copy_file_data_copy_file_range for the list of errors indicating that copy_file_range is not supported
+            if (copied == initial_copied && (err == EINVAL || err == EOPNOTSUPP || err == EXDEV || err == ENOSYS))
+                err = ENOTSUP;
+
+            return err;
         }
 
-        return fs::detail::remove_nt5_impl(p, attrs, ec);
+        if (sz == 0)
+            break;
+
+        copied += static_cast< uintmax_t >(sz);
+        if (offset)
+            *offset = static_cast< uintmax_t >(pos);
     }
+
+    return 0;
 }
 
-#if !defined(UNDER_CE)
+#endif // defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
 
-//! remove_all() by handle implementation for Windows Vista and newer
-uintmax_t remove_all_nt6_by_handle(HANDLE h, path const& p, error_code* ec)
-{
-    error_code local_ec;
-    fs::file_status st(fs::detail::status_by_handle(h, p, &local_ec));
-    if (BOOST_UNLIKELY(st.type() == fs::status_error))
-    {
-        if (!ec)
-            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove_all", p, local_ec));
+#if defined(BOOST_FILESYSTEM_USE_SPLICE)
 
-        *ec = local_ec;
-        return static_cast< uintmax_t >(-1);
-    }
+//! copy_data implementation that uses splice loop. One of the files must be a pipe. Returns \c ENOTSUP if splice is not supported for the files and no data was copied.
+int copy_data_splice(int infile, int outfile, uintmax_t* offset, uintmax_t size, uintmax_t& copied)
+{
+    instrumentation_scope instrumentation(instrumented_operation::copy_splice);
 
-    uintmax_t count = 0u;
-    if (st.type() == fs::directory_file)
+    loff_t pos = offset ? static_cast< loff_t >(*offset) : static_cast< loff_t >(0);
+    const uintmax_t initial_copied = copied;
+    while (copied < size)
     {
-        local_ec.clear();
-
-        fs::directory_iterator itr;
-        directory_iterator_params params;
-        params.use_handle = h;
-        params.close_handle = false; // the caller will close the handle
-        fs::detail::directory_iterator_construct(itr, p, static_cast< unsigned int >(directory_options::_detail_no_follow), &params, &local_ec);
-        if (BOOST_UNLIKELY(!!local_ec))
+        ssize_t sz = ::splice(infile, offset ? &pos : static_cast< loff_t* >(NULL), outfile, static_cast< loff_t* >(NULL),
+            get_copy_data_batch_size(size, copied, max_copy_data_batch_size), SPLICE_F_MOVE);
+        if (BOOST_UNLIKELY(sz < 0))
         {
-            if (!ec)
-                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove_all", p, local_ec));
+            int err = errno;
+            if (err == EINTR)
+                continue;
 
-            *ec = local_ec;
-            return static_cast< uintmax_t >(-1);
+            // splice fails with EINVAL if the file on the other side of the pipe does not support it
+            if (copied == initial_copied && (err == EINVAL || err == ENOSYS))
+                err = ENOTSUP;
+
+            return err;
         }
 
-        NtCreateFile_t* nt_create_file = filesystem::detail::atomic_load_relaxed(nt_create_file_api);
-        const fs::directory_iterator end_dit;
-        while (itr != end_dit)
+        if (sz == 0)
+            break;
+
+        copied += static_cast< uintmax_t >(sz);
+        if (offset)
+            *offset = static_cast< uintmax_t >(pos);
+    }
+
+    return 0;
+}
+
+#endif // defined(BOOST_FILESYSTEM_USE_SPLICE)
+
+/*!
+ * copy_data implementation that selects the data copying method based on the types of the files. If \a offset is not \c NULL,
+ * the data is read at the offset. \a copied is incremented by the amount of data copied.
+ */
+int copy_data_impl(int infile, int outfile, uintmax_t* offset, uintmax_t size, uintmax_t& copied)
+{
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE) || defined(BOOST_FILESYSTEM_USE_SPLICE)
+    // Use the read/write loop if it was selected as the copy_file backend or if the system does not support the other methods
+    if (filesystem::detail::atomic_load_relaxed(copy_file_data) != &copy_file_data_plain)
+    {
+        struct ::stat from_stat, to_stat;
+        if (BOOST_LIKELY(::fstat(infile, &from_stat) == 0 && ::fstat(outfile, &to_stat) == 0))
         {
-            fs::path nested_path(itr->path());
-            handle_wrapper hh;
-            if (BOOST_LIKELY(nt_create_file != NULL))
+            int err = ENOTSUP;
+#if defined(BOOST_FILESYSTEM_USE_SPLICE)
+            if (S_ISFIFO(from_stat.st_mode) || S_ISFIFO(to_stat.st_mode))
             {
-                // Note: WinAPI methods like CreateFileW implicitly request SYNCHRONIZE access but NtCreateFile doesn't.
-                // Without SYNCHRONIZE access querying file attributes via GetFileInformationByHandleEx fails with ERROR_ACCESS_DENIED.
-                boost::winapi::NTSTATUS_ status = nt_create_file_handle_at
-                (
-                    hh.handle,
-                    h,
-                    nested_path.filename(),
-                    0u, // FileAttributes
-                    FILE_LIST_DIRECTORY | DELETE | FILE_READ_ATTRIBUTES | FILE_WRITE_ATTRIBUTES | SYNCHRONIZE,
-                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
-                    FILE_OPEN,
-                    FILE_OPEN_FOR_BACKUP_INTENT | FILE_OPEN_REPARSE_POINT
-                );
-
-                if (!NT_SUCCESS(status))
+                err = copy_data_splice(infile, outfile, offset, size, copied);
+            }
+            else
+#endif
+            if (S_ISREG(from_stat.st_mode))
+            {
+                // See check_fs_type for why files with generated content must be copied with read/write loop
+                struct statfs sfs;
+                while (true)
                 {
-                    if (status == STATUS_NO_SUCH_FILE ||
-                        status == STATUS_OBJECT_NAME_NOT_FOUND ||
-                        status == STATUS_OBJECT_PATH_NOT_FOUND ||
-                        status == STATUS_BAD_NETWORK_PATH ||
-                        status == STATUS_BAD_NETWORK_NAME)
+                    if (BOOST_LIKELY(::fstatfs(infile, &sfs) == 0))
                     {
-                        goto next_entry;
+                        if (BOOST_UNLIKELY(has_generated_content(sfs)))
+                            goto read_write;
+                        break;
                     }
 
-                    DWORD err = translate_ntstatus(status);
-                    emit_error(err, nested_path, ec, "boost::filesystem::remove_all");
-                    return static_cast< uintmax_t >(-1);
+                    if (errno != EINTR)
+                        goto read_write;
                 }
-            }
-            else
-            {
-                hh.handle = create_file_handle(
-                    nested_path,
-                    FILE_LIST_DIRECTORY | DELETE | FILE_READ_ATTRIBUTES | FILE_WRITE_ATTRIBUTES | SYNCHRONIZE,
-                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
-                    NULL,
-                    OPEN_EXISTING,
-                    FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OPEN_REPARSE_POINT);
-
-                if (BOOST_UNLIKELY(hh.handle == INVALID_HANDLE_VALUE))
-                {
-                    DWORD err = ::GetLastError();
-                    if (not_found_error(err))
-                        goto next_entry;
 
-                    emit_error(err, nested_path, ec, "boost::filesystem::remove_all");
-                    return static_cast< uintmax_t >(-1);
-                }
+#if defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+                if (S_ISREG(to_stat.st_mode))
+                    err = copy_data_copy_file_range(infile, outfile, offset, size, copied);
+#endif
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
+                if (err == ENOTSUP)
+                    err = copy_data_sendfile(infile, outfile, offset, size, copied);
+#endif
             }
 
-            count += fs::detail::remove_all_nt6_by_handle(hh.handle, nested_path, ec);
-            if (ec && *ec)
-                return static_cast< uintmax_t >(-1);
+            if (err != ENOTSUP)
+                return err;
 
-        next_entry:
-            fs::detail::directory_iterator_increment(itr, ec);
-            if (ec && *ec)
-                return static_cast< uintmax_t >(-1);
+            record_instrumented_event(instrumented_operation::operation_fallback);
+            BOOST_FILESYSTEM_TRACE1(copy_file_data__fallback, err);
         }
     }
 
-    DWORD err = fs::detail::remove_nt6_by_handle(h, fs::detail::atomic_load_relaxed(g_remove_impl_type));
-    if (BOOST_UNLIKELY(err != 0u))
-    {
-        emit_error(err, p, ec, "boost::filesystem::remove_all");
-        return static_cast< uintmax_t >(-1);
-    }
-
-    ++count;
-    return count;
+read_write:
+#endif // defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE) || defined(BOOST_FILESYSTEM_USE_SPLICE)
+    return copy_data_read_write(infile, outfile, offset, size, copied);
 }
 
-#endif // !defined(UNDER_CE)
-
-//! remove_all() implementation for Windows XP and older
-uintmax_t remove_all_nt5_impl(path const& p, error_code* ec)
+//! Copies a range of data at the given offset from one file to the same offset in another file
+int copy_file_data_range(int infile, int outfile, off_t offset, uintmax_t size, scoped_copy_buffer& buf)
 {
-    error_code dit_create_ec;
-    for (unsigned int attempt = 0u; attempt < remove_all_directory_replaced_retry_count; ++attempt)
-    {
-        const DWORD attrs = ::GetFileAttributesW(p.c_str());
-        if (BOOST_UNLIKELY(attrs == INVALID_FILE_ATTRIBUTES))
+#if defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+    bool use_read_write = false;
+    while (size > 0u)
+    {
+        loff_t in_offset = offset, out_offset = offset;
+        const std::size_t size_to_copy = size < (1u << 30u) ? static_cast< std::size_t >(size) : static_cast< std::size_t >(1u << 30u);
+        loff_t sz = ::syscall(__NR_copy_file_range, infile, &in_offset, outfile, &out_offset, size_to_copy, (unsigned int)0u);
+        if (sz == 0)
+            return 0; // the file was truncated concurrently
+        if (BOOST_UNLIKELY(sz < 0))
         {
-            DWORD err = ::GetLastError();
-            if (not_found_error(err))
-                return 0u;
+            const int err = errno;
+            if (err == EINTR)
+                continue;
 
-            emit_error(err, p, ec, "boost::filesystem::remove_all");
-            return static_cast< uintmax_t >(-1);
+            // See copy_file_data_copy_file_range for the list of errors indicating that copy_file_range is not supported
+            if (err == EXDEV || err == EINVAL || err == ENOSYS || err == EOPNOTSUPP || err == ENOTSUP || err == EPERM)
+            {
+                use_read_write = true;
+                break;
+            }
+
+            return err;
         }
 
-        // Recurse into directories, but not into junctions or directory symlinks
-        const bool recurse = (attrs & FILE_ATTRIBUTE_DIRECTORY) != 0 && (attrs & FILE_ATTRIBUTE_REPARSE_POINT) == 0;
-        uintmax_t count = 0u;
-        if (recurse)
-        {
-            fs::directory_iterator itr;
-            fs::detail::directory_iterator_construct(itr, p, static_cast< unsigned int >(directory_options::_detail_no_follow), NULL, &dit_create_ec);
-            if (BOOST_UNLIKELY(!!dit_create_ec))
-            {
-                if (dit_create_ec == make_error_condition(system::errc::not_a_directory) ||
-                    dit_create_ec == make_error_condition(system::errc::too_many_symbolic_link_levels))
-                {
-                    continue;
-                }
+        offset += sz;
+        size -= static_cast< uintmax_t >(sz);
+    }
 
-                if (!ec)
-                    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove_all", p, dit_create_ec));
+    if (!use_read_write)
+        return 0;
+#endif // defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
 
-                *ec = dit_create_ec;
-                return static_cast< uintmax_t >(-1);
-            }
+    if (BOOST_UNLIKELY(!buf.reserve(max_read_write_buf_size)))
+        return ENOMEM;
 
-            const fs::directory_iterator end_dit;
-            while (itr != end_dit)
-            {
-                count += fs::detail::remove_all_nt5_impl(itr->path(), ec);
-                if (ec && *ec)
-                    return static_cast< uintmax_t >(-1);
+    return copy_file_data_range_pread_pwrite(infile, outfile, offset, size, buf.data(), buf.size());
+}
 
-                fs::detail::directory_iterator_increment(itr, ec);
-                if (ec && *ec)
-                    return static_cast< uintmax_t >(-1);
-            }
-        }
+//! Amount of copied data after which the progress callback is called
+BOOST_CONSTEXPR_OR_CONST uintmax_t copy_progress_chunk_size = 16u * 1024u * 1024u;
 
-        bool removed = fs::detail::remove_nt5_impl(p, attrs, ec);
-        if (ec && *ec)
-            return static_cast< uintmax_t >(-1);
+/*!
+ * copy_file implementation that copies data in chunks and reports progress after every chunk. Returns \c ECANCELED
+ * if the progress callback requests to cancel the operation.
+ */
+int copy_file_data_progress(int infile, int outfile, uintmax_t size, path const& from, path const& to, copy_progress_callback* progress, void* progress_context)
+{
+    scoped_copy_buffer buf;
+    uintmax_t pos = 0u;
+    while (pos < size)
+    {
+        const uintmax_t chunk_size = (size - pos) < copy_progress_chunk_size ? (size - pos) : copy_progress_chunk_size;
+        const int err = copy_file_data_range(infile, outfile, static_cast< off_t >(pos), chunk_size, buf);
+        if (BOOST_UNLIKELY(err != 0))
+            return err;
 
-        count += removed;
-        return count;
+        pos += chunk_size;
+        if (!progress(from, to, pos, size, progress_context))
+            return ECANCELED;
     }
 
-    if (!ec)
-        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove_all: path cannot be opened as a directory", p, dit_create_ec));
+    // Keep the file offset consistent with other implementations, which advance the file offset
+    if (BOOST_UNLIKELY(::lseek(outfile, static_cast< off_t >(pos), SEEK_SET) < 0))
+        return errno;
 
-    *ec = dit_create_ec;
-    return static_cast< uintmax_t >(-1);
+    return 0;
 }
 
-//! remove_all() implementation
-inline uintmax_t remove_all_impl(path const& p, error_code* ec)
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+//! Default minimum size of a file to copy its data in multiple threads
+BOOST_CONSTEXPR_OR_CONST uintmax_t default_parallel_copy_file_min_size = 256u * 1024u * 1024u;
+//! Default size of a range of file data copied by a thread at once
+BOOST_CONSTEXPR_OR_CONST uintmax_t default_parallel_copy_file_chunk_size = 64u * 1024u * 1024u;
+
+//! Minimum size of a file to copy its data in multiple threads
+uintmax_t g_parallel_copy_file_min_size = default_parallel_copy_file_min_size;
+//! Size of a range of file data copied by a thread at once
+uintmax_t g_parallel_copy_file_chunk_size = default_parallel_copy_file_chunk_size;
+
+//! Function object that copies ranges of file data in multiple threads
+class parallel_file_data_copier
 {
-#if !defined(UNDER_CE)
-    remove_impl_type impl = fs::detail::atomic_load_relaxed(g_remove_impl_type);
-    if (BOOST_LIKELY(impl != remove_nt5))
+private:
+    const int m_infile;
+    const int m_outfile;
+    const uintmax_t m_size;
+    const uintmax_t m_chunk_size;
+    std::atomic< uintmax_t > m_next;
+    std::atomic< int > m_error;
+
+public:
+    parallel_file_data_copier(int infile, int outfile, uintmax_t size, uintmax_t chunk_size) BOOST_NOEXCEPT :
+        m_infile(infile),
+        m_outfile(outfile),
+        m_size(size),
+        m_chunk_size(chunk_size),
+        m_next(0u),
+        m_error(0)
     {
-        handle_wrapper h(create_file_handle(
-            p,
-            FILE_LIST_DIRECTORY | DELETE | FILE_READ_ATTRIBUTES | FILE_WRITE_ATTRIBUTES | SYNCHRONIZE,
-            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
-            NULL,
-            OPEN_EXISTING,
-            FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OPEN_REPARSE_POINT));
+    }
 
-        if (BOOST_UNLIKELY(h.handle == INVALID_HANDLE_VALUE))
+    BOOST_DELETED_FUNCTION(parallel_file_data_copier(parallel_file_data_copier const&))
+    BOOST_DELETED_FUNCTION(parallel_file_data_copier& operator=(parallel_file_data_copier const&))
+
+    int error() const BOOST_NOEXCEPT { return m_error.load(std::memory_order_relaxed); }
+
+    void operator()(unsigned int) BOOST_NOEXCEPT
+    {
+        scoped_copy_buffer buf;
+        while (m_error.load(std::memory_order_relaxed) == 0)
         {
-            DWORD err = ::GetLastError();
-            if (not_found_error(err))
-                return 0u;
+            const uintmax_t pos = m_next.fetch_add(m_chunk_size, std::memory_order_relaxed);
+            if (pos >= m_size)
+                break;
 
-            emit_error(err, p, ec, "boost::filesystem::remove_all");
-            return static_cast< uintmax_t >(-1);
+            const uintmax_t size = (m_size - pos) < m_chunk_size ? (m_size - pos) : m_chunk_size;
+            const int err = copy_file_data_range(m_infile, m_outfile, static_cast< off_t >(pos), size, buf);
+            if (BOOST_UNLIKELY(err != 0))
+            {
+                int expected = 0;
+                m_error.compare_exchange_strong(expected, err, std::memory_order_relaxed, std::memory_order_relaxed);
+                break;
+            }
         }
+    }
+};
 
-        return fs::detail::remove_all_nt6_by_handle(h.handle, p, ec);
+/*!
+ * copy_file implementation that splits the file into ranges and copies them concurrently in multiple threads, using
+ * explicit file offsets. The target file must be empty. Returns \c ENOTSUP if the file is too small to benefit
+ * from multiple threads, in which case no data has been copied.
+ */
+int copy_file_data_parallel(int infile, int outfile, uintmax_t size)
+{
+    if (size < filesystem::detail::atomic_load_relaxed(g_parallel_copy_file_min_size))
+        return ENOTSUP;
+
+    const uintmax_t chunk_size = filesystem::detail::atomic_load_relaxed(g_parallel_copy_file_chunk_size);
+    const uintmax_t chunk_count = (size + chunk_size - 1u) / chunk_size;
+    unsigned int thread_count = get_thread_count(0u);
+    if (static_cast< uintmax_t >(thread_count) > chunk_count)
+        thread_count = static_cast< unsigned int >(chunk_count);
+    if (thread_count <= 1u)
+        return ENOTSUP;
+
+    // Reserve space for the whole file upfront so that threads writing at different offsets don't fragment the file
+    int err = preallocate_file(outfile, 0u, size, false);
+    if (BOOST_UNLIKELY(err != 0 && err != ENOTSUP))
+        return err;
+
+    parallel_file_data_copier copier(infile, outfile, size, chunk_size);
+    run_in_threads(thread_count, copier);
+    err = copier.error();
+    if (BOOST_UNLIKELY(err != 0))
+        return err;
+
+    // If the source file was truncated concurrently, the target file may be larger than the copied data.
+    // Keep the original source size, which is consistent with other implementations that would fill the missing data with zeros.
+    if (BOOST_UNLIKELY(::ftruncate(outfile, static_cast< off_t >(size)) != 0))
+        return errno;
+
+    return 0;
+}
+
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+//! Clones contents of the source file into the target file. Returns 0 on success or an error code.
+inline int clone_file_data(int infile, int outfile)
+{
+#if defined(BOOST_FILESYSTEM_HAS_FICLONE)
+    instrumentation_scope instrumentation(instrumented_operation::copy_clone);
+    while (true)
+    {
+        if (BOOST_LIKELY(::ioctl(outfile, FICLONE, infile) == 0))
+            return 0;
+
+        const int err = errno;
+        if (err == EINTR)
+            continue;
+
+        return err;
     }
-#endif // !defined(UNDER_CE)
+#else
+    return ENOTSUP;
+#endif
+}
 
-    return fs::detail::remove_all_nt5_impl(p, ec);
+//! Returns \c true if the error code returned by a file cloning function indicates that the filesystem does not support cloning
+inline bool is_clone_not_supported_error(int err) BOOST_NOEXCEPT
+{
+    // ioctl returns ENOTTY if the filesystem does not implement FICLONE, EINVAL if the source file is not a regular file
+    // or its size is not aligned to the filesystem block size, and EXDEV if the files are on different filesystems.
+    return err == ENOTSUP || err == EOPNOTSUPP || err == ENOTTY || err == EINVAL || err == EXDEV || err == ENOSYS;
 }
 
-inline BOOL resize_file_impl(const wchar_t* p, uintmax_t size)
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+
+//! Selects the copy_file_data implementation based on the kernel version
+copy_file_data_t* init_copy_file_data_impl() BOOST_NOEXCEPT
 {
-    handle_wrapper h(CreateFileW(p, GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL));
-    LARGE_INTEGER sz;
-    sz.QuadPart = size;
-    return h.handle != INVALID_HANDLE_VALUE && ::SetFilePointerEx(h.handle, sz, 0, FILE_BEGIN) && ::SetEndOfFile(h.handle);
+    copy_file_data_t* cfd = &copy_file_data_plain;
+
+    unsigned int major_ver = 0u, minor_ver = 0u, patch_ver = 0u;
+    if (get_linux_kernel_version(major_ver, minor_ver, patch_ver))
+    {
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
+        // sendfile started accepting file descriptors as the target in Linux 2.6.33
+        if (major_ver > 2u || (major_ver == 2u && (minor_ver > 6u || (minor_ver == 6u && patch_ver >= 33u))))
+            cfd = &check_fs_type< copy_file_data_sendfile >;
+#endif
+
+#if defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+        // Although copy_file_range appeared in Linux 4.5, it did not support cross-filesystem copying until 5.3.
+        // copy_file_data_copy_file_range will fallback to copy_file_data_sendfile if copy_file_range returns EXDEV.
+        if (major_ver > 4u || (major_ver == 4u && minor_ver >= 5u))
+            cfd = &check_fs_type< copy_file_data_copy_file_range >;
+#endif
+    }
+
+    filesystem::detail::atomic_store_relaxed(copy_file_data, cfd);
+    return cfd;
 }
 
-//! Converts NT path to a Win32 path
-inline path convert_nt_path_to_win32_path(const wchar_t* nt_path, std::size_t size)
+//! Selects the copy_file_data implementation on the first call and forwards the call to it
+int copy_file_data_select_impl(int infile, int outfile, uintmax_t size, std::size_t blksize, dev_t from_dev, dev_t to_dev)
 {
-    // https://googleprojectzero.blogspot.com/2016/02/the-definitive-guide-on-win32-to-nt.html
-    // https://stackoverflow.com/questions/23041983/path-prefixes-and
-    //
-    // NT paths can be used to identify practically any named objects, devices, files, local and remote shares, etc.
-    // The path starts with a leading backslash and consists of one or more path elements separated with backslashes.
-    // The set of characters allowed in NT path elements is significantly larger than that of Win32 paths - basically,
-    // any character except the backslash is allowed. Path elements are case-insensitive.
-    //
-    // NT paths that start with the "\??\" prefix are used to indicate the current user's session namespace. The prefix
-    // indicates to the NT object manager to lookup the object relative to "\Sessions\0\DosDevices\[Logon Authentication ID]".
-    //
-    // There is also a special "\Global??\" prefix that refers to the system logon. User's session directory shadows
-    // the system logon directory, so that when the referenced object is not found in the user's namespace,
-    // system logon is looked up instead.
-    //
-    // There is a symlink "Global" in the user's session namespace that refers to the global namespace, so "\??\Global"
-    // effectively resolves to "\Global??". This allows Win32 applications to directly refer to the system objects,
-    // even if shadowed by the current user's logon object.
-    //
-    // NT paths can be used to reference not only local filesystems, but also devices and remote shares identifiable via
-    // UNC paths. For this, there is a special "UNC" device (which is a symlink to "\Device\Mup") in the system logon
-    // namespace, so "\??\UNC\host\share" (or "\??\Global\UNC\host\share", or "\Global??\UNC\host\share") is equivalent
-    // to "\\host\share".
-    //
-    // NT paths are not universally accepted by Win32 applications and APIs. For example, Far supports paths starting
-    // with "\??\" and "\??\Global\" but not with "\Global??\". As of Win10 21H1, File Explorer, cmd.exe and PowerShell
-    // don't support any of these. Given this, and that NT paths have a different set of allowed characters from Win32 paths,
-    // we should normally avoid exposing NT paths to users that expect Win32 paths.
-    //
-    // In Boost.Filesystem we only deal with NT paths that come from reparse points, such as symlinks and mount points,
-    // including directory junctions. It was observed that reparse points created by junction.exe and mklink use the "\??\"
-    // prefix for directory junctions and absolute symlink and unqualified relative path for relative symlinks.
-    // Absolute paths are using drive letters for mounted drives (e.g. "\??\C:\directory"), although it is possible
-    // to create a junction to an directory using a different way of identifying the filesystem (e.g.
-    // "\??\Volume{00000000-0000-0000-0000-000000000000}\directory").
-    // mklink does not support creating junctions pointing to a UNC path. junction.exe does create a junction that
-    // uses a seemingly invalid syntax like "\??\\\host\share", i.e. it basically does not expect an UNC path. It is not known
-    // if reparse points that refer to a UNC path are considered valid.
-    // There are reparse points created as mount points for local and remote filsystems (for example, a cloud storage mounted
-    // in the local filesystem). Such mount points have the form of "\??\Volume{00000000-0000-0000-0000-000000000000}\",
-    // "\??\Harddisk0Partition1\" or "\??\HarddiskVolume1\".
-    // Reparse points that refer directly to a global namespace (through "\??\Global\" or "\Global??\" prefixes) or
-    // devices (e.g. "\Device\HarddiskVolume1") have not been observed so far.
+    return init_copy_file_data_impl()(infile, outfile, size, blksize, from_dev, to_dev);
+}
 
-    path win32_path;
-    std::size_t pos = 0u;
-    bool global_namespace = false;
+#endif // defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
 
-    // Check for the "\??\" prefix
-    if (size >= 4u &&
-        nt_path[0] == path::preferred_separator &&
-        nt_path[1] == questionmark &&
-        nt_path[2] == questionmark &&
-        nt_path[3] == path::preferred_separator)
+//! Truncation of an unlinked file in steps
+struct gradual_truncation
+{
+    int fd;
+    uintmax_t size;
+    uintmax_t step_size;
+    unsigned int step_interval;
+    //! Indicates that the descriptor is drawn from the descriptor budget
+    bool budgeted;
+    //! Next file in the background truncation queue
+    gradual_truncation* next;
+};
+
+//! Truncates the file in steps from the end, pausing between the steps, and closes the file
+void truncate_gradually(gradual_truncation const& trunc) BOOST_NOEXCEPT
+{
+    uintmax_t size = trunc.size;
+    while (size > 0u)
     {
-        pos = 4u;
+        const uintmax_t new_size = size > trunc.step_size ? size - trunc.step_size : 0u;
+        if (::ftruncate(trunc.fd, static_cast< off_t >(new_size)) != 0)
+        {
+            if (errno == EINTR)
+                continue;
 
-        // Check "Global"
-        if ((size - pos) >= 6u &&
-            (nt_path[pos] == L'G' || nt_path[pos] == L'g') &&
-            (nt_path[pos + 1] == L'l' || nt_path[pos + 1] == L'L') &&
-            (nt_path[pos + 2] == L'o' || nt_path[pos + 2] == L'O') &&
-            (nt_path[pos + 3] == L'b' || nt_path[pos + 3] == L'B') &&
-            (nt_path[pos + 4] == L'a' || nt_path[pos + 4] == L'A') &&
-            (nt_path[pos + 5] == L'l' || nt_path[pos + 5] == L'L'))
+            // The data will be released when the file is closed
+            break;
+        }
+
+        size = new_size;
+        if (size > 0u && trunc.step_interval > 0u)
         {
-            if ((size - pos) == 6u)
+            struct timespec ts;
+            ts.tv_sec = static_cast< std::time_t >(trunc.step_interval / 1000000u);
+            ts.tv_nsec = static_cast< long >((trunc.step_interval % 1000000u) * 1000u);
+            while (::nanosleep(&ts, &ts) != 0 && errno == EINTR)
             {
-                pos += 6u;
-                global_namespace = true;
-            }
-            else if (detail::is_directory_separator(nt_path[pos + 6u]))
-            {
-                pos += 7u;
-                global_namespace = true;
             }
         }
     }
-    // Check for the "\Global??\" prefix
-    else if (size >= 10u &&
-        nt_path[0] == path::preferred_separator &&
-        (nt_path[1] == L'G' || nt_path[1] == L'g') &&
-        (nt_path[2] == L'l' || nt_path[2] == L'L') &&
-        (nt_path[3] == L'o' || nt_path[3] == L'O') &&
-        (nt_path[4] == L'b' || nt_path[4] == L'B') &&
-        (nt_path[5] == L'a' || nt_path[5] == L'A') &&
-        (nt_path[6] == L'l' || nt_path[6] == L'L') &&
-        nt_path[7] == questionmark &&
-        nt_path[8] == questionmark &&
-        nt_path[9] == path::preferred_separator)
-    {
-        pos = 10u;
-        global_namespace = true;
-    }
 
-    if (pos > 0u)
+    close_fd(trunc.fd);
+}
+
+//! Returns \c true if the file open as \a fd has no other open descriptors or memory mappings
+bool is_file_exclusively_open(int fd) BOOST_NOEXCEPT
+{
+#if defined(F_SETLEASE)
+    // A write lease can only be taken when there are no other open descriptors or mappings of the file, in this or other
+    // processes. The lease is released right away, as the file is already unlinked and cannot be opened by name.
+    if (::fcntl(fd, F_SETLEASE, F_WRLCK) != 0)
+        return false;
+
+    ::fcntl(fd, F_SETLEASE, F_UNLCK);
+    return true;
+#else
+    // There is no way to tell
+    (void)fd;
+    return false;
+#endif
+}
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+//! Maximum number of unlinked files waiting for background truncation. Further files are truncated by the removing thread.
+BOOST_CONSTEXPR_OR_CONST std::size_t gradual_truncation_queue_capacity = 64u;
+
+//! Queue of unlinked files that are truncated one by one by a single task posted to the executor
+struct gradual_truncation_queue
+{
+    std::mutex mutex;
+    gradual_truncation* head;
+    gradual_truncation* tail;
+    std::size_t size;
+    //! Indicates that the task processing the queue is posted to the executor
+    bool running;
+
+    gradual_truncation_queue() BOOST_NOEXCEPT : head(NULL), tail(NULL), size(0u), running(false) {}
+};
+
+//! Returns the background truncation queue or \c NULL if it could not be allocated
+gradual_truncation_queue* get_gradual_truncation_queue() BOOST_NOEXCEPT
+{
+    // The queue is never destroyed, as the task processing it may still be running when the static objects are destroyed
+    static gradual_truncation_queue* const queue = new (std::nothrow) gradual_truncation_queue();
+    return queue;
+}
+
+//! Executor task that truncates the queued files until the queue is empty
+void gradual_truncation_task(void* context) BOOST_NOEXCEPT
+{
+    gradual_truncation_queue& queue = *static_cast< gradual_truncation_queue* >(context);
+    while (true)
     {
-        if ((size - pos) >= 2u &&
-        (
-            // Check if the following is a drive letter
-            (
-                detail::is_letter(nt_path[pos]) && nt_path[pos + 1u] == colon &&
-                ((size - pos) == 2u || detail::is_directory_separator(nt_path[pos + 2u]))
-            ) ||
-            // Check for an "incorrect" syntax for UNC path junction points
-            (
-                detail::is_directory_separator(nt_path[pos]) && detail::is_directory_separator(nt_path[pos + 1u]) &&
-                ((size - pos) == 2u || !detail::is_directory_separator(nt_path[pos + 2u]))
-            )
-        ))
+        gradual_truncation* trunc;
         {
-            // Strip the NT path prefix
-            goto done;
+            std::lock_guard< std::mutex > lock(queue.mutex);
+            trunc = queue.head;
+            if (!trunc)
+            {
+                queue.running = false;
+                return;
+            }
+
+            queue.head = trunc->next;
+            if (!queue.head)
+                queue.tail = NULL;
+            --queue.size;
         }
 
-        static const wchar_t win32_path_prefix[4u] = { path::preferred_separator, path::preferred_separator, questionmark, path::preferred_separator };
+        truncate_gradually(*trunc);
+        if (trunc->budgeted)
+            release_descriptors(1u);
+        delete trunc;
+    }
+}
 
-        // Check for a UNC path
-        if ((size - pos) >= 4u &&
-            (nt_path[pos] == L'U' || nt_path[pos] == L'u') &&
-            (nt_path[pos + 1] == L'N' || nt_path[pos + 1] == L'n') &&
-            (nt_path[pos + 2] == L'C' || nt_path[pos + 2] == L'c') &&
-            nt_path[pos + 3] == path::preferred_separator)
+//! Queues the file for background truncation. Returns \c false if the file was not queued and should be truncated by the caller.
+bool post_gradual_truncation(gradual_truncation const& trunc) BOOST_NOEXCEPT
+{
+    gradual_truncation_queue* queue = get_gradual_truncation_queue();
+    if (BOOST_UNLIKELY(!queue))
+        return false;
+
+    // The descriptor of the queued file stays open until the truncation completes
+    const bool budgeted = is_descriptor_budget_limited();
+    if (budgeted && !try_acquire_descriptors(1u))
+        return false;
+
+    gradual_truncation* context = new (std::nothrow) gradual_truncation(trunc);
+    if (BOOST_LIKELY(context != NULL))
+    {
+        context->budgeted = budgeted;
+        context->next = NULL;
+
+        bool queued = false, post_task = false;
         {
-            win32_path.assign(win32_path_prefix, win32_path_prefix + 2);
-            pos += 4u;
-            goto done;
+            std::lock_guard< std::mutex > lock(queue->mutex);
+            if (queue->size < gradual_truncation_queue_capacity)
+            {
+                if (queue->tail)
+                    queue->tail->next = context;
+                else
+                    queue->head = context;
+                queue->tail = context;
+                ++queue->size;
+                queued = true;
+
+                post_task = !queue->running;
+                queue->running = true;
+            }
         }
 
-        // This is some other NT path, possibly a volume mount point. Replace the NT prefix with a Win32 filesystem prefix "\\?\".
-        win32_path.assign(win32_path_prefix, win32_path_prefix + 4);
-        if (global_namespace)
+        if (queued)
         {
-            static const wchar_t win32_path_global_prefix[7u] = { L'G', L'l', L'o', L'b', L'a', L'l', path::preferred_separator };
-            win32_path.concat(win32_path_global_prefix, win32_path_global_prefix + 7);
+            // If the task cannot be posted, process the queue in this thread
+            if (post_task && !filesystem::get_executor()->post(&gradual_truncation_task, queue))
+                gradual_truncation_task(queue);
+            return true;
         }
+
+        delete context;
     }
 
-done:
-    win32_path.concat(nt_path + pos, nt_path + size);
-    return win32_path;
+    if (budgeted)
+        release_descriptors(1u);
+    return false;
 }
 
-#endif // defined(BOOST_POSIX_API)
-
-} // unnamed namespace
-} // namespace detail
-
-//--------------------------------------------------------------------------------------//
-//                                                                                      //
-//                operations functions declared in operations.hpp                       //
-//                                                                                      //
-//--------------------------------------------------------------------------------------//
-
-namespace detail {
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS)
 
-BOOST_FILESYSTEM_DECL bool possible_large_file_size_support()
+//! Removes the regular file \a p, truncating it in steps first, if gradual removal is enabled and the file is large enough
+/*!
+ * Returns 0 if the file was removed, an error code if removing the file failed, or -1 if the file was not removed
+ * and should be removed as usual. The file is unlinked before it is truncated, so that its name disappears right away.
+ * Files with more than one link or other open descriptors are not truncated, as their data remains accessible through
+ * the other links and descriptors.
+ */
+int remove_file_gradually
+(
+    path const& p
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    , int basedir_fd
+#endif
+)
 {
-#ifdef BOOST_POSIX_API
-    typedef struct stat struct_stat;
-    return sizeof(struct_stat().st_size) > 4;
+    const uintmax_t min_file_size = filesystem::detail::atomic_load_relaxed(g_gradual_remove_min_file_size);
+    if (BOOST_LIKELY(min_file_size == 0u))
+        return -1;
+
+    struct ::stat st;
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    if (::fstatat(basedir_fd, p.c_str(), &st, AT_SYMLINK_NOFOLLOW) != 0)
 #else
-    return true;
+    if (::lstat(p.c_str(), &st) != 0)
 #endif
-}
+        return -1;
 
-BOOST_FILESYSTEM_DECL
-path absolute(path const& p, path const& base, system::error_code* ec)
-{
-    if (ec)
-        ec->clear();
+    if (!S_ISREG(st.st_mode) || st.st_nlink != 1 || static_cast< uintmax_t >(st.st_size) < min_file_size)
+        return -1;
 
-    if (p.is_absolute())
-        return p;
+    const int fd = ::
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+        openat(basedir_fd,
+#else
+        open(
+#endif
+        p.c_str(), O_WRONLY | O_NOFOLLOW | O_CLOEXEC | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0)
+        return -1;
 
-    //  recursively calling absolute is sub-optimal, but is sure and simple
-    path abs_base = base;
-    if (!base.is_absolute())
+    // Make sure the file was not replaced since it was inspected
+    struct ::stat fd_st;
+    if (::fstat(fd, &fd_st) != 0 || fd_st.st_dev != st.st_dev || fd_st.st_ino != st.st_ino || !S_ISREG(fd_st.st_mode))
     {
-        if (ec)
-        {
-            abs_base = absolute(base, *ec);
-            if (*ec)
-                return path();
-        }
-        else
-        {
-            abs_base = absolute(base);
-        }
+        close_fd(fd);
+        return -1;
     }
 
-    if (p.empty())
-        return abs_base;
-
-    path res;
-    if (p.has_root_name())
-        res = p.root_name();
-    else
-        res = abs_base.root_name();
-
-    if (p.has_root_directory())
+    int res;
+    instrumentation_timer timer;
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    res = ::unlinkat(basedir_fd, p.c_str(), 0);
+#else
+    res = ::unlink(p.c_str());
+#endif
+    timer.record(instrumented_operation::unlink);
+    if (res != 0)
     {
-        res.concat(p.root_directory());
+        const int err = errno;
+        close_fd(fd);
+        return err;
     }
-    else
+
+    // Do not truncate the file if it was linked elsewhere after it was inspected. Also, truncation would destroy the data
+    // that is still accessible to the users of the other open descriptors and memory mappings of the file, which would
+    // receive SIGBUS when accessing the mapped data. In these cases, the storage is released when the file is last closed.
+    if (::fstat(fd, &fd_st) != 0 || fd_st.st_nlink != 0 || !is_file_exclusively_open(fd))
     {
-        res.concat(abs_base.root_directory());
-        res /= abs_base.relative_path();
+        close_fd(fd);
+        return 0;
     }
 
-    path p_relative_path(p.relative_path());
-    if (!p_relative_path.empty())
-        res /= p_relative_path;
+    gradual_truncation trunc;
+    trunc.fd = fd;
+    trunc.size = static_cast< uintmax_t >(fd_st.st_size);
+    trunc.step_size = filesystem::detail::atomic_load_relaxed(g_gradual_remove_step_size);
+    trunc.step_interval = filesystem::detail::atomic_load_relaxed(g_gradual_remove_step_interval);
 
-    return res;
+    trunc.budgeted = false;
+    trunc.next = NULL;
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+    if (filesystem::detail::atomic_load_relaxed(g_gradual_remove_background) && post_gradual_truncation(trunc))
+        return 0;
+#endif
+
+    truncate_gradually(trunc);
+    return 0;
 }
 
-BOOST_FILESYSTEM_DECL
-path canonical(path const& p, path const& base, system::error_code* ec)
+//! remove() implementation
+inline bool remove_impl
+(
+    path const& p,
+    fs::file_type type,
+    error_code* ec
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    , int basedir_fd = AT_FDCWD
+#endif
+)
 {
-    if (ec)
-        ec->clear();
+    if (type == fs::file_not_found)
+        return false;
 
-    path source(p);
-    if (!p.is_absolute())
+    if (type == fs::regular_file)
     {
-        source = detail::absolute(p, base, ec);
-        if (ec && *ec)
+        int err = remove_file_gradually
+        (
+            p
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+            , basedir_fd
+#endif
+        );
+        if (err >= 0)
         {
-        return_empty_path:
-            return path();
+            if (BOOST_LIKELY(err == 0))
+                return true;
+            if (BOOST_UNLIKELY(!not_found_error(err)))
+                emit_error(err, p, ec, "boost::filesystem::remove");
+            return false;
         }
     }
 
-    system::error_code local_ec;
-    file_status st(detail::status_impl(source, &local_ec));
+    int res;
+    instrumentation_timer timer;
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    res = ::unlinkat(basedir_fd, p.c_str(), type == fs::directory_file ? AT_REMOVEDIR : 0);
+#else
+    if (type == fs::directory_file)
+        res = ::rmdir(p.c_str());
+    else
+        res = ::unlink(p.c_str());
+#endif
+    timer.record(instrumented_operation::unlink);
 
-    if (st.type() == fs::file_not_found)
+    if (res != 0)
     {
-        local_ec = system::errc::make_error_code(system::errc::no_such_file_or_directory);
-        goto fail_local_ec;
+        int err = errno;
+        if (BOOST_UNLIKELY(!not_found_error(err)))
+            emit_error(err, p, ec, "boost::filesystem::remove");
+
+        return false;
     }
-    else if (local_ec)
+
+    return true;
+}
+
+//! remove() implementation
+inline bool remove_impl
+(
+    path const& p,
+    error_code* ec
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    , int basedir_fd = AT_FDCWD
+#endif
+)
+{
+    // Since POSIX remove() is specified to work with either files or directories, in a
+    // perfect world it could just be called. But some important real-world operating
+    // systems (Windows, Mac OS, for example) don't implement the POSIX spec. So
+    // we have to distinguish between files and directories and call corresponding APIs
+    // to remove them.
+
+    error_code local_ec;
+    fs::file_type type = fs::detail::symlink_status_impl
+    (
+        p,
+        &local_ec
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+        , basedir_fd
+#endif
+    ).type();
+    if (BOOST_UNLIKELY(type == fs::status_error))
     {
-    fail_local_ec:
         if (!ec)
-            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::canonical", source, local_ec));
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove", p, local_ec));
 
         *ec = local_ec;
-        goto return_empty_path;
+        return false;
     }
 
-    path root(source.root_path());
-    path const& dot_p = dot_path();
-    path const& dot_dot_p = dot_dot_path();
-    unsigned int symlinks_allowed = symloop_max;
-    path result;
-    while (true)
+    return fs::detail::remove_impl
+    (
+        p,
+        type,
+        ec
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+        , basedir_fd
+#endif
+    );
+}
+
+//! remove_all() implementation
+/*!
+ * If \a type_hint is not \c status_error, it is the file type of \a p, as reported by the directory iterator. The file is
+ * then removed without querying its type first, and the type is only queried if the hint turns out to be wrong.
+ */
+uintmax_t remove_all_impl
+(
+    path const& p,
+    error_code* ec,
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    int basedir_fd = AT_FDCWD,
+#endif
+    fs::file_type type_hint = fs::status_error
+)
+{
+    if (type_hint != fs::status_error && type_hint != fs::directory_file)
     {
-        for (path::iterator itr(source.begin()), end(source.end()); itr != end; ++itr)
+        // Most files in a tree are not directories, so try to remove the file right away
+        if (type_hint == fs::regular_file)
         {
-            if (*itr == dot_p)
-                continue;
-            if (*itr == dot_dot_p)
+            const int err = remove_file_gradually
+            (
+                p
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW)
+                , basedir_fd
+#else
+                , AT_FDCWD
+#endif
+#endif
+            );
+            if (err >= 0)
             {
-                if (result != root)
-                    result.remove_filename();
-                continue;
+                if (BOOST_LIKELY(err == 0))
+                    return 1u;
+                if (not_found_error(err))
+                    return 0u;
+                emit_error(err, p, ec, "boost::filesystem::remove_all");
+                return static_cast< uintmax_t >(-1);
             }
+        }
 
-            if (itr->size() == 1u && detail::is_directory_separator(itr->native()[0]))
+        int res;
+        instrumentation_timer timer;
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+        res = ::unlinkat(basedir_fd, p.c_str(), 0);
+#else
+        res = ::unlink(p.c_str());
+#endif
+        timer.record(instrumented_operation::unlink);
+        if (BOOST_LIKELY(res == 0))
+            return 1u;
+
+        const int err = errno;
+        if (not_found_error(err))
+            return 0u;
+
+        // unlink(2) fails with EISDIR on Linux and EPERM on other systems if the file is a directory. This means the file
+        // was replaced with a directory since it was enumerated. EPERM may also indicate a genuine permission error,
+        // so query the file type and proceed as if there was no hint.
+        if (BOOST_UNLIKELY(err != EISDIR && err != EPERM))
+        {
+            emit_error(err, p, ec, "boost::filesystem::remove_all");
+            return static_cast< uintmax_t >(-1);
+        }
+
+        type_hint = fs::status_error;
+    }
+
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    fs::detail::directory_iterator_params params;
+    params.basedir_fd = basedir_fd;
+    params.open_path = NULL;
+    params.iterator_fd = -1;
+#endif
+
+    error_code dit_create_ec;
+    for (unsigned int attempt = 0u; attempt < remove_all_directory_replaced_retry_count; ++attempt)
+    {
+        // Opening the directory below will fail if it is not a directory, so the hint can be trusted on the first attempt
+        fs::file_type type = attempt == 0u ? type_hint : fs::status_error;
+        if (type == fs::status_error)
+        {
+            error_code local_ec;
+            type = fs::detail::symlink_status_impl
+            (
+                p,
+                &local_ec
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                , basedir_fd
+#endif
+            ).type();
+
+            if (type == fs::file_not_found)
+                return 0u;
+
+            if (BOOST_UNLIKELY(type == fs::status_error))
             {
-                // Convert generic separator returned by the iterator for the root directory to
-                // the preferred separator. This is important on Windows, as in some cases,
-                // like paths for network shares and cloud storage mount points GetFileAttributesW
-                // will return "file not found" if the path contains forward slashes.
-                result += path::preferred_separator;
-                // We don't need to check for a symlink after adding a separator.
-                continue;
+                if (!ec)
+                    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove_all", p, local_ec));
+
+                *ec = local_ec;
+                return static_cast< uintmax_t >(-1);
+            }
+        }
+
+        uintmax_t count = 0u;
+        if (type == fs::directory_file) // but not a directory symlink
+        {
+            fs::directory_iterator itr;
+            fs::detail::directory_iterator_construct
+            (
+                itr,
+                p,
+                static_cast< unsigned int >(directory_options::_detail_no_follow),
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                &params,
+#else
+                NULL,
+#endif
+                &dit_create_ec
+            );
+
+            if (BOOST_UNLIKELY(!!dit_create_ec))
+            {
+                // The directory may have been removed or replaced with a different file since its type was obtained
+                if (dit_create_ec == error_code(ENOTDIR, system_category()) || dit_create_ec == error_code(ENOENT, system_category()))
+                    continue;
+
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW)
+                // If open(2) with O_NOFOLLOW fails with ELOOP, this means that either the path contains a loop
+                // of symbolic links, or the last element of the path is a symbolic link. Given that lstat(2) above
+                // did not fail, most likely it is the latter case. I.e. between the lstat above and this open call
+                // the filesystem was modified so that the path no longer refers to a directory file (as opposed to a symlink).
+                if (dit_create_ec == error_code(ELOOP, system_category()))
+                    continue;
+#endif // defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW)
+
+                if (!ec)
+                    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove_all", p, dit_create_ec));
+
+                *ec = dit_create_ec;
+                return static_cast< uintmax_t >(-1);
+            }
+
+            const fs::directory_iterator end_dit;
+            while (itr != end_dit)
+            {
+                // Use the file type reported by the directory iterator, if known, to avoid querying it per file
+                count += fs::detail::remove_all_impl
+                (
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                    itr->path().filename(),
+#else
+                    itr->path(),
+#endif
+                    ec,
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                    params.iterator_fd,
+#endif
+                    fs::detail::get_cached_symlink_status(*itr).type()
+                );
+                if (ec && *ec)
+                    return static_cast< uintmax_t >(-1);
+
+                fs::detail::directory_iterator_increment(itr, ec);
+                if (ec && *ec)
+                    return static_cast< uintmax_t >(-1);
             }
+        }
+
+        count += fs::detail::remove_impl
+        (
+            p,
+            type,
+            ec
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+            , basedir_fd
+#endif
+        );
+        if (ec && *ec)
+            return static_cast< uintmax_t >(-1);
+
+        return count;
+    }
+
+    if (!ec)
+        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove_all: path cannot be opened as a directory", p, dit_create_ec));
+
+    *ec = dit_create_ec;
+    return static_cast< uintmax_t >(-1);
+}
+
+#else // defined(BOOST_POSIX_API)
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                            Windows-specific helpers                                  //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+//! FILE_BASIC_INFO definition from Windows SDK
+struct file_basic_info
+{
+    LARGE_INTEGER CreationTime;
+    LARGE_INTEGER LastAccessTime;
+    LARGE_INTEGER LastWriteTime;
+    LARGE_INTEGER ChangeTime;
+    DWORD FileAttributes;
+};
+
+//! FILE_DISPOSITION_INFO definition from Windows SDK
+struct file_disposition_info
+{
+    BOOLEAN DeleteFile;
+};
+
+//! FILE_DISPOSITION_INFO_EX definition from Windows SDK
+struct file_disposition_info_ex
+{
+    DWORD Flags;
+};
+
+//! FILE_RENAME_INFO definition from Windows SDK
+struct file_rename_info
+{
+    union
+    {
+        BOOLEAN ReplaceIfExists;
+        DWORD Flags;
+    };
+    HANDLE RootDirectory;
+    DWORD FileNameLength;
+    WCHAR FileName[1];
+};
+
+//! FSCTL_GET_INTEGRITY_INFORMATION_BUFFER definition from Windows SDK
+struct fsctl_get_integrity_information_buffer
+{
+    WORD ChecksumAlgorithm;
+    WORD Reserved;
+    DWORD Flags;
+    DWORD ChecksumChunkSizeInBytes;
+    DWORD ClusterSizeInBytes;
+};
+
+//! FILE_ALLOCATED_RANGE_BUFFER definition from Windows SDK
+struct file_allocated_range_buffer
+{
+    LARGE_INTEGER FileOffset;
+    LARGE_INTEGER Length;
+};
+
+//! DUPLICATE_EXTENTS_DATA definition from Windows SDK
+struct duplicate_extents_data
+{
+    HANDLE FileHandle;
+    LARGE_INTEGER SourceFileOffset;
+    LARGE_INTEGER TargetFileOffset;
+    LARGE_INTEGER ByteCount;
+};
+
+#ifndef FILE_DISPOSITION_FLAG_DELETE
+#define FILE_DISPOSITION_FLAG_DELETE 0x00000001
+#endif
+// Available since Windows 10 1709
+#ifndef FILE_DISPOSITION_FLAG_POSIX_SEMANTICS
+#define FILE_DISPOSITION_FLAG_POSIX_SEMANTICS 0x00000002
+#endif
+// Available since Windows 10 1809
+#ifndef FILE_DISPOSITION_FLAG_IGNORE_READONLY_ATTRIBUTE
+#define FILE_DISPOSITION_FLAG_IGNORE_READONLY_ATTRIBUTE 0x00000010
+#endif
+
+//  REPARSE_DATA_BUFFER related definitions are found in ntifs.h, which is part of the
+//  Windows Device Driver Kit. Since that's inconvenient, the definitions are provided
+//  here. See http://msdn.microsoft.com/en-us/library/ms791514.aspx
+struct reparse_data_buffer
+{
+    ULONG ReparseTag;
+    USHORT ReparseDataLength;
+    USHORT Reserved;
+    union
+    {
+        /*
+         * In SymbolicLink and MountPoint reparse points, there are two names.
+         * SubstituteName is the effective replacement path for the reparse point.
+         * This is what should be used for path traversal.
+         * PrintName is intended for presentation to the user and may omit some
+         * elements of the path or be absent entirely.
+         *
+         * Examples of substitute and print names:
+         * mklink /D ldrive c:\
+         * SubstituteName: "\??\c:\"
+         * PrintName: "c:\"
+         *
+         * mklink /J ldrive c:\
+         * SubstituteName: "\??\C:\"
+         * PrintName: "c:\"
+         *
+         * junction ldrive c:\
+         * SubstituteName: "\??\C:\"
+         * PrintName: ""
+         *
+         * box.com mounted cloud storage
+         * SubstituteName: "\??\Volume{<UUID>}\"
+         * PrintName: ""
+         */
+        struct
+        {
+            USHORT SubstituteNameOffset;
+            USHORT SubstituteNameLength;
+            USHORT PrintNameOffset;
+            USHORT PrintNameLength;
+            ULONG Flags;
+            WCHAR PathBuffer[1];
+        } SymbolicLinkReparseBuffer;
+        struct
+        {
+            USHORT SubstituteNameOffset;
+            USHORT SubstituteNameLength;
+            USHORT PrintNameOffset;
+            USHORT PrintNameLength;
+            WCHAR PathBuffer[1];
+        } MountPointReparseBuffer;
+        struct
+        {
+            UCHAR DataBuffer[1];
+        } GenericReparseBuffer;
+    };
+};
+
+// Our convenience type for allocating REPARSE_DATA_BUFFER along with sufficient space after it
+union reparse_data_buffer_with_storage
+{
+    reparse_data_buffer rdb;
+    unsigned char storage[MAXIMUM_REPARSE_DATA_BUFFER_SIZE];
+};
+
+//  Windows kernel32.dll functions that may or may not be present
+//  must be accessed through pointers
+
+typedef BOOL (WINAPI CreateHardLinkW_t)(
+    /*__in*/ LPCWSTR lpFileName,
+    /*__in*/ LPCWSTR lpExistingFileName,
+    /*__reserved*/ LPSECURITY_ATTRIBUTES lpSecurityAttributes);
+
+CreateHardLinkW_t* create_hard_link_api = NULL;
+
+typedef BOOLEAN (WINAPI CreateSymbolicLinkW_t)(
+    /*__in*/ LPCWSTR lpSymlinkFileName,
+    /*__in*/ LPCWSTR lpTargetFileName,
+    /*__in*/ DWORD dwFlags);
+
+CreateSymbolicLinkW_t* create_symbolic_link_api = NULL;
+
+//! SetFileInformationByHandle signature. Available since Windows Vista.
+typedef BOOL (WINAPI SetFileInformationByHandle_t)(
+    /*_In_*/ HANDLE hFile,
+    /*_In_*/ file_info_by_handle_class FileInformationClass, // the actual type is FILE_INFO_BY_HANDLE_CLASS enum
+    /*_In_reads_bytes_(dwBufferSize)*/ LPVOID lpFileInformation,
+    /*_In_*/ DWORD dwBufferSize);
+
+SetFileInformationByHandle_t* set_file_information_by_handle_api = NULL;
+
+//! COPYFILE2_MESSAGE_TYPE values from Windows SDK
+enum copyfile2_message_type
+{
+    copyfile2_callback_none = 0,
+    copyfile2_callback_chunk_started = 1,
+    copyfile2_callback_chunk_finished = 2,
+    copyfile2_callback_stream_started = 3,
+    copyfile2_callback_stream_finished = 4,
+    copyfile2_callback_poll_continue = 5,
+    copyfile2_callback_error = 6
+};
+
+//! COPYFILE2_MESSAGE_ACTION values from Windows SDK
+enum copyfile2_message_action
+{
+    copyfile2_progress_continue = 0,
+    copyfile2_progress_cancel = 1
+};
+
+//! COPYFILE2_MESSAGE definition from Windows SDK, only with the members used by Boost.Filesystem
+struct copyfile2_message
+{
+    copyfile2_message_type Type;
+    DWORD dwPadding;
+    union
+    {
+        struct
+        {
+            DWORD dwStreamNumber;
+            DWORD dwFlags;
+            HANDLE hSourceFile;
+            HANDLE hDestinationFile;
+            ULARGE_INTEGER uliChunkNumber;
+            ULARGE_INTEGER uliChunkSize;
+            ULARGE_INTEGER uliStreamSize;
+            ULARGE_INTEGER uliStreamBytesTransferred;
+            ULARGE_INTEGER uliTotalFileSize;
+            ULARGE_INTEGER uliTotalBytesTransferred;
+        }
+        ChunkFinished;
+
+        struct
+        {
+            DWORD dwStreamNumber;
+            DWORD dwReserved;
+            HANDLE hSourceFile;
+            HANDLE hDestinationFile;
+            ULARGE_INTEGER uliStreamSize;
+            ULARGE_INTEGER uliStreamBytesTransferred;
+            ULARGE_INTEGER uliTotalFileSize;
+            ULARGE_INTEGER uliTotalBytesTransferred;
+        }
+        StreamFinished;
+    }
+    Info;
+};
+
+//! PCOPYFILE2_PROGRESS_ROUTINE signature
+typedef copyfile2_message_action (CALLBACK copyfile2_progress_routine_t)(const copyfile2_message* pMessage, PVOID pvCallbackContext);
+
+//! COPYFILE2_EXTENDED_PARAMETERS definition from Windows SDK
+struct copyfile2_extended_parameters
+{
+    DWORD dwSize;
+    DWORD dwCopyFlags;
+    BOOL* pfCancel;
+    copyfile2_progress_routine_t* pProgressRoutine;
+    PVOID pvCallbackContext;
+};
+
+//! CopyFile2 signature. Available since Windows 8.
+typedef HRESULT (WINAPI CopyFile2_t)(
+    /*_In_*/ PCWSTR pwszExistingFileName,
+    /*_In_*/ PCWSTR pwszNewFileName,
+    /*_In_opt_*/ copyfile2_extended_parameters* pExtendedParameters);
+
+CopyFile2_t* copy_file2_api = NULL;
+
+#if !defined(UNDER_CE)
+
+//! FILE_STAT_INFORMATION definition from Windows SDK
+struct file_stat_information
+{
+    LARGE_INTEGER FileId;
+    LARGE_INTEGER CreationTime;
+    LARGE_INTEGER LastAccessTime;
+    LARGE_INTEGER LastWriteTime;
+    LARGE_INTEGER ChangeTime;
+    LARGE_INTEGER AllocationSize;
+    LARGE_INTEGER EndOfFile;
+    ULONG FileAttributes;
+    ULONG ReparseTag;
+    ULONG NumberOfLinks;
+    ACCESS_MASK EffectiveAccess;
+};
+
+//! NtQueryInformationByName signature. Available since Windows 10 1703, FileStatInformation is supported since Windows 10 1709.
+typedef boost::winapi::NTSTATUS_ (NTAPI NtQueryInformationByName_t)(
+    /*in*/ object_attributes* ObjectAttributes,
+    /*out*/ io_status_block* IoStatusBlock,
+    /*out*/ PVOID FileInformation,
+    /*in*/ ULONG Length,
+    /*in*/ file_information_class FileInformationClass);
+
+NtQueryInformationByName_t* nt_query_information_by_name_api = NULL;
+
+//! RtlDosPathNameToNtPathName_U_WithStatus signature. Available since Windows XP SP2 (probably).
+typedef boost::winapi::NTSTATUS_ (NTAPI RtlDosPathNameToNtPathName_U_WithStatus_t)(
+    /*in*/ PCWSTR DosFileName,
+    /*out*/ unicode_string* NtFileName,
+    /*out, optional*/ PWSTR* FilePart,
+    /*out, optional*/ PVOID RelativeName);
+
+RtlDosPathNameToNtPathName_U_WithStatus_t* rtl_dos_path_name_to_nt_path_name_api = NULL;
+
+//! RtlFreeUnicodeString signature. Available since Windows 2000.
+typedef VOID (NTAPI RtlFreeUnicodeString_t)(/*in, out*/ unicode_string* UnicodeString);
+
+RtlFreeUnicodeString_t* rtl_free_unicode_string_api = NULL;
+
+//! NtQuerySecurityObject signature. Available since Windows 2000.
+typedef boost::winapi::NTSTATUS_ (NTAPI NtQuerySecurityObject_t)(
+    /*in*/ HANDLE Handle,
+    /*in*/ SECURITY_INFORMATION SecurityInformation,
+    /*out*/ PSECURITY_DESCRIPTOR SecurityDescriptor,
+    /*in*/ ULONG Length,
+    /*out*/ PULONG LengthNeeded);
+
+NtQuerySecurityObject_t* nt_query_security_object_api = NULL;
+
+//! NtSetSecurityObject signature. Available since Windows 2000.
+typedef boost::winapi::NTSTATUS_ (NTAPI NtSetSecurityObject_t)(
+    /*in*/ HANDLE Handle,
+    /*in*/ SECURITY_INFORMATION SecurityInformation,
+    /*in*/ PSECURITY_DESCRIPTOR SecurityDescriptor);
+
+NtSetSecurityObject_t* nt_set_security_object_api = NULL;
+
+#endif // !defined(UNDER_CE)
+
+} // unnamed namespace
+
+GetFileInformationByHandleEx_t* get_file_information_by_handle_ex_api = NULL;
+
+#if !defined(UNDER_CE)
+NtCreateFile_t* nt_create_file_api = NULL;
+NtQueryDirectoryFile_t* nt_query_directory_file_api = NULL;
+#endif // !defined(UNDER_CE)
+
+namespace {
+
+//! remove() implementation type
+enum remove_impl_type
+{
+    remove_nt5,                            //!< Use Windows XP API
+    remove_disp,                           //!< Use FILE_DISPOSITION_INFO (Windows Vista and later)
+    remove_disp_ex_flag_posix_semantics,   //!< Use FILE_DISPOSITION_INFO_EX with FILE_DISPOSITION_FLAG_POSIX_SEMANTICS
+    remove_disp_ex_flag_ignore_readonly    //!< Use FILE_DISPOSITION_INFO_EX with FILE_DISPOSITION_FLAG_POSIX_SEMANTICS | FILE_DISPOSITION_FLAG_IGNORE_READONLY_ATTRIBUTE
+};
+
+remove_impl_type g_remove_impl_type = remove_nt5;
+
+//! Initializes WinAPI function pointers
+BOOST_FILESYSTEM_INIT_FUNC init_winapi_func_ptrs()
+{
+    boost::winapi::HMODULE_ h = boost::winapi::GetModuleHandleW(L"kernel32.dll");
+    if (BOOST_LIKELY(!!h))
+    {
+        GetFileInformationByHandleEx_t* get_file_information_by_handle_ex = (GetFileInformationByHandleEx_t*)boost::winapi::get_proc_address(h, "GetFileInformationByHandleEx");
+        filesystem::detail::atomic_store_relaxed(get_file_information_by_handle_ex_api, get_file_information_by_handle_ex);
+        SetFileInformationByHandle_t* set_file_information_by_handle = (SetFileInformationByHandle_t*)boost::winapi::get_proc_address(h, "SetFileInformationByHandle");
+        filesystem::detail::atomic_store_relaxed(set_file_information_by_handle_api, set_file_information_by_handle);
+        filesystem::detail::atomic_store_relaxed(create_hard_link_api, (CreateHardLinkW_t*)boost::winapi::get_proc_address(h, "CreateHardLinkW"));
+        filesystem::detail::atomic_store_relaxed(create_symbolic_link_api, (CreateSymbolicLinkW_t*)boost::winapi::get_proc_address(h, "CreateSymbolicLinkW"));
+        filesystem::detail::atomic_store_relaxed(copy_file2_api, (CopyFile2_t*)boost::winapi::get_proc_address(h, "CopyFile2"));
+
+        if (get_file_information_by_handle_ex && set_file_information_by_handle)
+        {
+            // Enable the most advanced implementation based on GetFileInformationByHandleEx/SetFileInformationByHandle.
+            // If certain flags are not supported by the OS, the remove() implementation will downgrade accordingly.
+            filesystem::detail::atomic_store_relaxed(g_remove_impl_type, remove_disp_ex_flag_ignore_readonly);
+        }
+    }
+
+#if !defined(UNDER_CE)
+    unsigned int major_ver = 0u;
+    h = boost::winapi::GetModuleHandleW(L"ntdll.dll");
+    if (BOOST_LIKELY(!!h))
+    {
+        filesystem::detail::atomic_store_relaxed(nt_create_file_api, (NtCreateFile_t*)boost::winapi::get_proc_address(h, "NtCreateFile"));
+        filesystem::detail::atomic_store_relaxed(nt_query_directory_file_api, (NtQueryDirectoryFile_t*)boost::winapi::get_proc_address(h, "NtQueryDirectoryFile"));
+
+        NtQuerySecurityObject_t* nt_query_security_object = (NtQuerySecurityObject_t*)boost::winapi::get_proc_address(h, "NtQuerySecurityObject");
+        NtSetSecurityObject_t* nt_set_security_object = (NtSetSecurityObject_t*)boost::winapi::get_proc_address(h, "NtSetSecurityObject");
+        if (nt_query_security_object && nt_set_security_object)
+        {
+            filesystem::detail::atomic_store_relaxed(nt_query_security_object_api, nt_query_security_object);
+            filesystem::detail::atomic_store_relaxed(nt_set_security_object_api, nt_set_security_object);
+        }
+
+        RtlDosPathNameToNtPathName_U_WithStatus_t* rtl_dos_path_name_to_nt_path_name = (RtlDosPathNameToNtPathName_U_WithStatus_t*)boost::winapi::get_proc_address(h, "RtlDosPathNameToNtPathName_U_WithStatus");
+        RtlFreeUnicodeString_t* rtl_free_unicode_string = (RtlFreeUnicodeString_t*)boost::winapi::get_proc_address(h, "RtlFreeUnicodeString");
+        if (rtl_dos_path_name_to_nt_path_name && rtl_free_unicode_string)
+        {
+            filesystem::detail::atomic_store_relaxed(rtl_dos_path_name_to_nt_path_name_api, rtl_dos_path_name_to_nt_path_name);
+            filesystem::detail::atomic_store_relaxed(rtl_free_unicode_string_api, rtl_free_unicode_string);
+            filesystem::detail::atomic_store_relaxed(nt_query_information_by_name_api, (NtQueryInformationByName_t*)boost::winapi::get_proc_address(h, "NtQueryInformationByName"));
+        }
+
+        // Unlike GetVersionExW, RtlGetVersion reports the actual OS version regardless of the application manifest
+        RtlGetVersion_t* rtl_get_version = (RtlGetVersion_t*)boost::winapi::get_proc_address(h, "RtlGetVersion");
+        if (rtl_get_version)
+        {
+            OSVERSIONINFOW version_info = {};
+            version_info.dwOSVersionInfoSize = sizeof(version_info);
+            if (NT_SUCCESS(rtl_get_version(&version_info)))
+                major_ver = version_info.dwMajorVersion;
+        }
+    }
+
+    init_directory_iterator_impl(major_ver);
+#endif // !defined(UNDER_CE)
+
+    return BOOST_FILESYSTEM_INITRETSUCCESS_V;
+}
+
+#if defined(_MSC_VER)
+
+#if _MSC_VER >= 1400
+
+#pragma section(".CRT$XCL", long, read)
+__declspec(allocate(".CRT$XCL")) BOOST_ATTRIBUTE_UNUSED BOOST_FILESYSTEM_ATTRIBUTE_RETAIN
+extern const init_func_ptr_t p_init_winapi_func_ptrs = &init_winapi_func_ptrs;
+
+#else // _MSC_VER >= 1400
+
+#if (_MSC_VER >= 1300) // 1300 == VC++ 7.0
+#pragma data_seg(push, old_seg)
+#endif
+#pragma data_seg(".CRT$XCL")
+BOOST_ATTRIBUTE_UNUSED BOOST_FILESYSTEM_ATTRIBUTE_RETAIN
+extern const init_func_ptr_t p_init_winapi_func_ptrs = &init_winapi_func_ptrs;
+#pragma data_seg()
+#if (_MSC_VER >= 1300) // 1300 == VC++ 7.0
+#pragma data_seg(pop, old_seg)
+#endif
+
+#endif // _MSC_VER >= 1400
+
+#if defined(BOOST_FILESYSTEM_NO_ATTRIBUTE_RETAIN)
+//! Makes sure the global initializer pointers are referenced and not removed by linker
+struct globals_retainer
+{
+    const init_func_ptr_t* volatile m_p_init_winapi_func_ptrs;
+
+    globals_retainer() { m_p_init_winapi_func_ptrs = &p_init_winapi_func_ptrs; }
+};
+BOOST_ATTRIBUTE_UNUSED
+const globals_retainer g_globals_retainer;
+#endif // defined(BOOST_FILESYSTEM_NO_ATTRIBUTE_RETAIN)
+
+#else // defined(_MSC_VER)
+
+//! Invokes WinAPI function pointers initialization
+struct winapi_func_ptrs_initializer
+{
+    winapi_func_ptrs_initializer() { init_winapi_func_ptrs(); }
+};
+
+BOOST_FILESYSTEM_INIT_PRIORITY(BOOST_FILESYSTEM_FUNC_PTR_INIT_PRIORITY) BOOST_ATTRIBUTE_UNUSED BOOST_FILESYSTEM_ATTRIBUTE_RETAIN
+const winapi_func_ptrs_initializer winapi_func_ptrs_init;
+
+#endif // defined(_MSC_VER)
+
+
+// Windows CE has no environment variables
+#if !defined(UNDER_CE)
+inline std::wstring wgetenv(const wchar_t* name)
+{
+    // use a separate buffer since C++03 basic_string is not required to be contiguous
+    const DWORD size = ::GetEnvironmentVariableW(name, NULL, 0);
+    if (size > 0)
+    {
+        boost::scoped_array< wchar_t > buf(new wchar_t[size]);
+        if (BOOST_LIKELY(::GetEnvironmentVariableW(name, buf.get(), size) > 0))
+            return std::wstring(buf.get());
+    }
+
+    return std::wstring();
+}
+#endif // !defined(UNDER_CE)
+
+inline bool not_found_error(int errval) BOOST_NOEXCEPT
+{
+    return errval == ERROR_FILE_NOT_FOUND || errval == ERROR_PATH_NOT_FOUND || errval == ERROR_INVALID_NAME // "tools/jam/src/:sys:stat.h", "//foo"
+        || errval == ERROR_INVALID_DRIVE                                                                    // USB card reader with no card inserted
+        || errval == ERROR_NOT_READY                                                                        // CD/DVD drive with no disc inserted
+        || errval == ERROR_INVALID_PARAMETER                                                                // ":sys:stat.h"
+        || errval == ERROR_BAD_PATHNAME                                                                     // "//no-host" on Win64
+        || errval == ERROR_BAD_NETPATH                                                                      // "//no-host" on Win32
+        || errval == ERROR_BAD_NET_NAME;                                                                    // "//no-host/no-share" on Win10 x64
+}
+
+inline void to_FILETIME(std::time_t t, FILETIME& ft) BOOST_NOEXCEPT
+{
+    uint64_t temp = t;
+    temp *= 10000000u;
+    temp += 116444736000000000ull;
+    ft.dwLowDateTime = static_cast< DWORD >(temp);
+    ft.dwHighDateTime = static_cast< DWORD >(temp >> 32);
+}
+
+inline void to_FILETIME(file_time const& t, FILETIME& ft) BOOST_NOEXCEPT
+{
+    uint64_t temp = t.seconds;
+    temp *= 10000000u;
+    temp += t.nanoseconds / 100u;
+    temp += 116444736000000000ull;
+    ft.dwLowDateTime = static_cast< DWORD >(temp);
+    ft.dwHighDateTime = static_cast< DWORD >(temp >> 32);
+}
+
+} // unnamed namespace
+
+#if !defined(UNDER_CE)
+
+//! The flag indicates whether OBJ_DONT_REPARSE flag is not supported by the kernel
+static bool g_no_obj_dont_reparse = false;
+
+//! Creates a file handle for a file relative to a previously opened base directory. The file path must be relative and in preferred format.
+boost::winapi::NTSTATUS_ nt_create_file_handle_at(HANDLE& out, HANDLE basedir_handle, boost::filesystem::path const& p, ULONG FileAttributes, ACCESS_MASK DesiredAccess, ULONG ShareMode, ULONG CreateDisposition, ULONG CreateOptions)
+{
+    NtCreateFile_t* nt_create_file = filesystem::detail::atomic_load_relaxed(nt_create_file_api);
+    if (BOOST_UNLIKELY(!nt_create_file))
+        return STATUS_NOT_IMPLEMENTED;
+
+    unicode_string obj_name = {};
+    obj_name.Buffer = const_cast< wchar_t* >(p.c_str());
+    obj_name.Length = obj_name.MaximumLength = static_cast< USHORT >(p.size() * sizeof(wchar_t));
+
+    object_attributes obj_attrs = {};
+    obj_attrs.Length = sizeof(obj_attrs);
+    obj_attrs.RootDirectory = basedir_handle;
+    obj_attrs.ObjectName = &obj_name;
+
+    obj_attrs.Attributes = OBJ_CASE_INSENSITIVE;
+    if ((CreateOptions & FILE_OPEN_REPARSE_POINT) != 0u && !filesystem::detail::atomic_load_relaxed(g_no_obj_dont_reparse))
+        obj_attrs.Attributes |= OBJ_DONT_REPARSE;
+
+    io_status_block iosb;
+    boost::winapi::NTSTATUS_ status = nt_create_file
+    (
+        &out,
+        DesiredAccess,
+        &obj_attrs,
+        &iosb,
+        NULL, // AllocationSize
+        FileAttributes,
+        ShareMode,
+        CreateDisposition,
+        CreateOptions,
+        NULL, // EaBuffer
+        0u // EaLength
+    );
+
+    if (BOOST_UNLIKELY(status == STATUS_INVALID_PARAMETER && (obj_attrs.Attributes & OBJ_DONT_REPARSE) != 0u))
+    {
+        // OBJ_DONT_REPARSE is supported since Windows 10, retry without it
+        filesystem::detail::atomic_store_relaxed(g_no_obj_dont_reparse, true);
+        obj_attrs.Attributes &= ~static_cast< ULONG >(OBJ_DONT_REPARSE);
+
+        status = nt_create_file
+        (
+            &out,
+            DesiredAccess,
+            &obj_attrs,
+            &iosb,
+            NULL, // AllocationSize
+            FileAttributes,
+            ShareMode,
+            CreateDisposition,
+            CreateOptions,
+            NULL, // EaBuffer
+            0u // EaLength
+        );
+    }
+
+    return status;
+}
+
+#endif // !defined(UNDER_CE)
+
+bool is_reparse_point_a_symlink_ioctl(HANDLE h)
+{
+    boost::scoped_ptr< reparse_data_buffer_with_storage > buf(new reparse_data_buffer_with_storage);
+
+    // Query the reparse data
+    DWORD dwRetLen = 0u;
+    BOOL result = ::DeviceIoControl(h, FSCTL_GET_REPARSE_POINT, NULL, 0, buf.get(), sizeof(*buf), &dwRetLen, NULL);
+    if (BOOST_UNLIKELY(!result))
+        return false;
+
+    return is_reparse_point_tag_a_symlink(buf->rdb.ReparseTag);
+}
+
+namespace {
+
+inline bool is_reparse_point_a_symlink(path const& p)
+{
+    handle_wrapper h(create_file_handle(
+        p,
+        FILE_READ_ATTRIBUTES,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OPEN_REPARSE_POINT));
+    if (BOOST_UNLIKELY(h.handle == INVALID_HANDLE_VALUE))
+        return false;
+
+    GetFileInformationByHandleEx_t* get_file_information_by_handle_ex = filesystem::detail::atomic_load_relaxed(get_file_information_by_handle_ex_api);
+    if (BOOST_LIKELY(get_file_information_by_handle_ex != NULL))
+    {
+        file_attribute_tag_info info;
+        BOOL result = get_file_information_by_handle_ex(h.handle, file_attribute_tag_info_class, &info, sizeof(info));
+        if (BOOST_UNLIKELY(!result))
+            return false;
+
+        if ((info.FileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) == 0u)
+            return false;
+
+        return is_reparse_point_tag_a_symlink(info.ReparseTag);
+    }
+
+    return is_reparse_point_a_symlink_ioctl(h.handle);
+}
+
+inline std::size_t get_full_path_name(path const& src, std::size_t len, wchar_t* buf, wchar_t** p)
+{
+    return static_cast< std::size_t >(::GetFullPathNameW(src.c_str(), static_cast< DWORD >(len), buf, p));
+}
+
+inline fs::file_status process_status_failure(DWORD errval, path const& p, error_code* ec)
+{
+    if (ec)                                    // always report errval, even though some
+        ec->assign(errval, system_category()); // errval values are not status_errors
+
+    if (not_found_error(errval))
+    {
+        return fs::file_status(fs::file_not_found, fs::no_perms);
+    }
+    else if (errval == ERROR_SHARING_VIOLATION)
+    {
+        return fs::file_status(fs::type_unknown);
+    }
+
+    if (!ec)
+        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::status", p, error_code(errval, system_category())));
+
+    return fs::file_status(fs::status_error);
+}
+
+inline fs::file_status process_status_failure(path const& p, error_code* ec)
+{
+    return process_status_failure(::GetLastError(), p, ec);
+}
+
+//! (symlink_)status() by handle implementation
+fs::file_status status_by_handle(HANDLE h, path const& p, error_code* ec)
+{
+    fs::file_type ftype;
+    DWORD attrs;
+    GetFileInformationByHandleEx_t* get_file_information_by_handle_ex = filesystem::detail::atomic_load_relaxed(get_file_information_by_handle_ex_api);
+    if (BOOST_LIKELY(get_file_information_by_handle_ex != NULL))
+    {
+        file_attribute_tag_info info;
+        BOOL res = get_file_information_by_handle_ex(h, file_attribute_tag_info_class, &info, sizeof(info));
+        if (BOOST_UNLIKELY(!res))
+        {
+            // On FAT/exFAT filesystems requesting FILE_ATTRIBUTE_TAG_INFO returns ERROR_INVALID_PARAMETER.
+            // Presumably, this is because these filesystems don't support reparse points, so ReparseTag
+            // cannot be returned. Also check ERROR_NOT_SUPPORTED for good measure. Fall back to the legacy
+            // code path in this case.
+            DWORD err = ::GetLastError();
+            if (err == ERROR_INVALID_PARAMETER || err == ERROR_NOT_SUPPORTED)
+                goto use_get_file_information_by_handle;
+
+            return process_status_failure(err, p, ec);
+        }
+
+        attrs = info.FileAttributes;
+
+        if (attrs & FILE_ATTRIBUTE_REPARSE_POINT)
+        {
+            ftype = is_reparse_point_tag_a_symlink(info.ReparseTag) ? fs::symlink_file : fs::reparse_file;
+            goto done;
+        }
+    }
+    else
+    {
+    use_get_file_information_by_handle:
+        BY_HANDLE_FILE_INFORMATION info;
+        BOOL res = ::GetFileInformationByHandle(h, &info);
+        if (BOOST_UNLIKELY(!res))
+            return process_status_failure(p, ec);
+
+        attrs = info.dwFileAttributes;
+
+        if (attrs & FILE_ATTRIBUTE_REPARSE_POINT)
+        {
+            ftype = is_reparse_point_a_symlink_ioctl(h) ? fs::symlink_file : fs::reparse_file;
+            goto done;
+        }
+    }
+
+    ftype = (attrs & FILE_ATTRIBUTE_DIRECTORY) ? fs::directory_file : fs::regular_file;
+
+done:
+    return fs::file_status(ftype, make_permissions(p, attrs));
+}
+
+#if !defined(UNDER_CE)
+
+//! Result of symlink_status_by_name and symlink_status_by_attributes
+enum status_by_name_result
+{
+    status_by_name_success,   //!< File status obtained
+    status_by_name_failure,   //!< The file does not exist, error reported
+    status_by_name_fallback   //!< The query is not supported for the file, use the handle-based implementation
+};
+
+//! Size of the buffer for NT paths built by make_nt_path, in characters
+BOOST_CONSTEXPR_OR_CONST std::size_t nt_path_buffer_size = 1024u;
+
+//! Checks if the final element of a path may be a DOS device name, such as "NUL" or "COM1", which is converted specially
+inline bool may_be_dos_device_name(const wchar_t* name, std::size_t size)
+{
+    if (size < 3u)
+        return false;
+
+    wchar_t prefix[3];
+    for (std::size_t i = 0u; i < 3u; ++i)
+    {
+        wchar_t c = name[i];
+        if (c >= L'a' && c <= L'z')
+            c -= L'a' - L'A';
+        prefix[i] = c;
+    }
+
+    // This may also match regular names like "config", which is fine; such paths are just converted by the system
+    return (prefix[0] == L'C' && prefix[1] == L'O' && (prefix[2] == L'N' || prefix[2] == L'M')) ||
+        (prefix[0] == L'P' && prefix[1] == L'R' && prefix[2] == L'N') ||
+        (prefix[0] == L'A' && prefix[1] == L'U' && prefix[2] == L'X') ||
+        (prefix[0] == L'N' && prefix[1] == L'U' && prefix[2] == L'L') ||
+        (prefix[0] == L'L' && prefix[1] == L'P' && prefix[2] == L'T');
+}
+
+/*!
+ * \brief Converts a Win32 path to an NT path in the provided buffer, if the conversion does not require normalization
+ *
+ * RtlDosPathNameToNtPathName_U_WithStatus allocates the NT path on the heap and normalizes the path on every call. For paths
+ * with the "\\?\" prefix and for absolute paths that are already normalized, the conversion amounts to adding a prefix, so
+ * it is done here. Returns \c false if the path has to be converted by the system, e.g. if it is relative, contains "." or ".."
+ * elements, forward slashes, repeated separators, elements with trailing dots or spaces, or may refer to a DOS device.
+ */
+bool make_nt_path(path const& p, wchar_t* buf, std::size_t buf_size, unicode_string& nt_path)
+{
+    const wchar_t* str = p.c_str();
+    const std::size_t size = p.native().size();
+
+    const wchar_t* prefix;
+    std::size_t prefix_size, pos;
+    if (size >= 4u && str[0] == L'\\' && str[1] == L'\\' && str[2] == L'?' && str[3] == L'\\')
+    {
+        // The path is passed to the system as is, only the prefix is replaced
+        prefix = L"\\??\\";
+        prefix_size = 4u;
+        str += 4u;
+        pos = size - 4u;
+        goto copy_path;
+    }
+    else if (size >= 3u && ((str[0] >= L'a' && str[0] <= L'z') || (str[0] >= L'A' && str[0] <= L'Z')) && str[1] == L':' && str[2] == L'\\')
+    {
+        // "C:\dir" -> "\??\C:\dir"
+        prefix = L"\\??\\";
+        prefix_size = 4u;
+        pos = 3u;
+    }
+    else if (size >= 3u && str[0] == L'\\' && str[1] == L'\\' && str[2] != L'?' && str[2] != L'.' && str[2] != L'\\')
+    {
+        // "\\server\share" -> "\??\UNC\server\share"
+        prefix = L"\\??\\UNC";
+        prefix_size = 7u;
+        ++str;
+        pos = 1u;
+    }
+    else
+    {
+        return false;
+    }
+
+    {
+        const std::size_t path_size = size - static_cast< std::size_t >(str - p.c_str());
+        std::size_t element_pos = pos;
+        for (; pos <= path_size; ++pos)
+        {
+            const wchar_t c = pos < path_size ? str[pos] : L'\\';
+            if (c == L'/')
+                return false;
+
+            if (c == L'\\')
+            {
+                const std::size_t element_size = pos - element_pos;
+                if (element_size == 0u || str[pos - 1u] == L'.' || str[pos - 1u] == L' ')
+                    return false;
+                element_pos = pos + 1u;
+            }
+        }
+
+        // Only the final element is checked for DOS device names by the system
+        std::size_t last_pos = path_size;
+        while (last_pos > 0u && str[last_pos - 1u] != L'\\')
+            --last_pos;
+        if (may_be_dos_device_name(str + last_pos, path_size - last_pos))
+            return false;
+
+        pos = path_size;
+    }
+
+copy_path:
+    // Note: pos is the size of the path after the prefix
+    if (BOOST_UNLIKELY(prefix_size + pos > buf_size))
+        return false;
+
+    std::memcpy(buf, prefix, prefix_size * sizeof(wchar_t));
+    std::memcpy(buf + prefix_size, str, pos * sizeof(wchar_t));
+    nt_path.Buffer = buf;
+    nt_path.Length = nt_path.MaximumLength = static_cast< USHORT >((prefix_size + pos) * sizeof(wchar_t));
+    return true;
+}
+
+//! Obtains \c FILE_STAT_INFORMATION of a file without opening a handle. Reparse points are not followed.
+boost::winapi::NTSTATUS_ query_stat_information_by_name(path const& p, file_stat_information& info)
+{
+    NtQueryInformationByName_t* nt_query_information_by_name = filesystem::detail::atomic_load_relaxed(nt_query_information_by_name_api);
+    if (!nt_query_information_by_name)
+        return STATUS_NOT_IMPLEMENTED;
+
+    wchar_t nt_path_buf[nt_path_buffer_size];
+    unicode_string nt_path = {};
+    boost::winapi::NTSTATUS_ status;
+    const bool nt_path_allocated = !make_nt_path(p, nt_path_buf, nt_path_buffer_size, nt_path);
+    if (nt_path_allocated)
+    {
+        status = filesystem::detail::atomic_load_relaxed(rtl_dos_path_name_to_nt_path_name_api)(p.c_str(), &nt_path, NULL, NULL);
+        if (BOOST_UNLIKELY(!NT_SUCCESS(status)))
+            return status;
+    }
+
+    object_attributes obj_attrs;
+    obj_attrs.Length = sizeof(obj_attrs);
+    obj_attrs.RootDirectory = NULL;
+    obj_attrs.ObjectName = &nt_path;
+    obj_attrs.Attributes = OBJ_CASE_INSENSITIVE;
+    obj_attrs.SecurityDescriptor = NULL;
+    obj_attrs.SecurityQualityOfService = NULL;
+
+    io_status_block iosb;
+    status = nt_query_information_by_name(&obj_attrs, &iosb, &info, sizeof(info), file_stat_information_class);
+
+    if (nt_path_allocated)
+        filesystem::detail::atomic_load_relaxed(rtl_free_unicode_string_api)(&nt_path);
+
+    if (status == STATUS_NOT_IMPLEMENTED || status == STATUS_INVALID_INFO_CLASS)
+    {
+        // The OS does not support the query, don't try it again
+        filesystem::detail::atomic_store_relaxed(nt_query_information_by_name_api, static_cast< NtQueryInformationByName_t* >(NULL));
+    }
+
+    return status;
+}
+
+//! Returns \c true if the status returned by \c query_stat_information_by_name indicates that the file does not exist
+inline bool is_not_found_ntstatus(boost::winapi::NTSTATUS_ status) BOOST_NOEXCEPT
+{
+    switch (static_cast< boost::winapi::ULONG_ >(status))
+    {
+    case static_cast< boost::winapi::ULONG_ >(STATUS_NO_SUCH_FILE):
+    case static_cast< boost::winapi::ULONG_ >(STATUS_OBJECT_NAME_NOT_FOUND):
+    case static_cast< boost::winapi::ULONG_ >(STATUS_OBJECT_PATH_NOT_FOUND):
+    case static_cast< boost::winapi::ULONG_ >(STATUS_BAD_NETWORK_PATH):
+    case static_cast< boost::winapi::ULONG_ >(STATUS_BAD_NETWORK_NAME):
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+/*!
+ * \brief symlink_status() implementation based on NtQueryInformationByName(FileStatInformation)
+ *
+ * Unlike the handle-based implementation, the query does not require opening a handle to the file, which is
+ * an expensive operation on Windows, especially with file system filter drivers installed. Symlinks and other
+ * reparse points are not followed.
+ */
+status_by_name_result symlink_status_by_name(path const& p, fs::file_status& st, error_code* ec)
+{
+    file_stat_information info;
+    const boost::winapi::NTSTATUS_ status = query_stat_information_by_name(p, info);
+    if (BOOST_LIKELY(NT_SUCCESS(status)))
+    {
+        fs::file_type ftype;
+        if (info.FileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)
+            ftype = is_reparse_point_tag_a_symlink(info.ReparseTag) ? fs::symlink_file : fs::reparse_file;
+        else
+            ftype = (info.FileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? fs::directory_file : fs::regular_file;
+
+        st = fs::file_status(ftype, make_permissions(p, info.FileAttributes));
+        return status_by_name_success;
+    }
+
+    if (is_not_found_ntstatus(status))
+    {
+        st = process_status_failure(translate_ntstatus(status), p, ec);
+        return status_by_name_failure;
+    }
+
+    // The query may not be supported by the OS or the filesystem, or fail for other reasons (e.g. access denied) that
+    // the handle-based implementation is prepared to deal with.
+    return status_by_name_fallback;
+}
+
+//! FindExInfoBasic value, which may not be defined in older SDKs. Supported since Windows 7.
+BOOST_CONSTEXPR_OR_CONST FINDEX_INFO_LEVELS find_ex_info_basic = static_cast< FINDEX_INFO_LEVELS >(1);
+
+/*!
+ * \brief symlink_status() implementation based on GetFileAttributesExW
+ *
+ * Used when NtQueryInformationByName is not available. As the query by name, it does not require opening a handle
+ * to the file. For reparse points, the reparse point tag is obtained with FindFirstFileExW.
+ */
+status_by_name_result symlink_status_by_attributes(path const& p, fs::file_status& st, error_code* ec)
+{
+    WIN32_FILE_ATTRIBUTE_DATA fad;
+    if (BOOST_UNLIKELY(!::GetFileAttributesExW(p.c_str(), ::GetFileExInfoStandard, &fad)))
+    {
+        const DWORD err = ::GetLastError();
+        if (not_found_error(err))
+        {
+            st = process_status_failure(err, p, ec);
+            return status_by_name_failure;
+        }
+
+        // The query may fail for some files (e.g. with ERROR_SHARING_VIOLATION for pagefile.sys) that
+        // the handle-based implementation is prepared to deal with.
+        return status_by_name_fallback;
+    }
+
+    fs::file_type ftype;
+    if (fad.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)
+    {
+        // FindFirstFileExW interprets wildcard characters in the path, which includes the "\\?\" prefix,
+        // and does not work for root directories. Leave these cases to the handle-based implementation.
+        if (p.native().find_first_of(L"*?") != path::string_type::npos || !p.has_filename())
+            return status_by_name_fallback;
+
+        WIN32_FIND_DATAW data;
+        HANDLE h = ::FindFirstFileExW(p.c_str(), find_ex_info_basic, &data, FindExSearchNameMatch, NULL, 0u);
+        if (h == INVALID_HANDLE_VALUE)
+            return status_by_name_fallback;
+        ::FindClose(h);
+
+        // The file could have been replaced after GetFileAttributesExW
+        if (BOOST_UNLIKELY((data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) == 0u))
+            return status_by_name_fallback;
+
+        // dwReserved0 contains the reparse point tag if the file is a reparse point
+        fad.dwFileAttributes = data.dwFileAttributes;
+        ftype = is_reparse_point_tag_a_symlink(data.dwReserved0) ? fs::symlink_file : fs::reparse_file;
+    }
+    else
+    {
+        ftype = (fad.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? fs::directory_file : fs::regular_file;
+    }
+
+    st = fs::file_status(ftype, make_permissions(p, fad.dwFileAttributes));
+    return status_by_name_success;
+}
+
+#endif // !defined(UNDER_CE)
+
+//! symlink_status() implementation
+fs::file_status symlink_status_impl(path const& p, error_code* ec)
+{
+#if !defined(UNDER_CE)
+    {
+        fs::file_status st;
+        if (symlink_status_by_name(p, st, ec) != status_by_name_fallback)
+            return st;
+        if (symlink_status_by_attributes(p, st, ec) != status_by_name_fallback)
+            return st;
+    }
+#endif // !defined(UNDER_CE)
+
+    handle_wrapper h(create_file_handle(
+        p.c_str(),
+        FILE_READ_ATTRIBUTES, // dwDesiredAccess; attributes only
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL, // lpSecurityAttributes
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OPEN_REPARSE_POINT));
+
+    if (h.handle == INVALID_HANDLE_VALUE)
+    {
+        // For some system files and folders like "System Volume Information" CreateFileW fails
+        // with ERROR_ACCESS_DENIED. GetFileAttributesW succeeds for such files, so try that.
+        // Though this will only help if the file is not a reparse point (symlink or not).
+        DWORD err = ::GetLastError();
+        if (err == ERROR_ACCESS_DENIED)
+        {
+            DWORD attrs = ::GetFileAttributesW(p.c_str());
+            if (attrs != INVALID_FILE_ATTRIBUTES)
+            {
+                if ((attrs & FILE_ATTRIBUTE_REPARSE_POINT) == 0u)
+                    return fs::file_status((attrs & FILE_ATTRIBUTE_DIRECTORY) ? fs::directory_file : fs::regular_file, make_permissions(p, attrs));
+            }
+            else
+            {
+                err = ::GetLastError();
+            }
+        }
+
+        return process_status_failure(err, p, ec);
+    }
+
+    return detail::status_by_handle(h.handle, p, ec);
+}
+
+//! status() implementation
+fs::file_status status_impl(path const& p, error_code* ec)
+{
+    // We should first test if the file is a symlink or a reparse point. Resolving some reparse
+    // points by opening the file may fail, and status() should return file_status(reparse_file) in this case.
+    // Which is what symlink_status() returns.
+    fs::file_status st(detail::symlink_status_impl(p, ec));
+    if (st.type() == symlink_file)
+    {
+        // Resolve the symlink
+        handle_wrapper h(create_file_handle(
+            p.c_str(),
+            FILE_READ_ATTRIBUTES, // dwDesiredAccess; attributes only
+            FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
+            NULL, // lpSecurityAttributes
+            OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS));
+
+        if (h.handle == INVALID_HANDLE_VALUE)
+            return process_status_failure(p, ec);
+
+        st = detail::status_by_handle(h.handle, p, ec);
+    }
+
+    return st;
+}
+
+//! remove() implementation for Windows XP and older
+bool remove_nt5_impl(path const& p, DWORD attrs, error_code* ec)
+{
+    const bool is_directory = (attrs & FILE_ATTRIBUTE_DIRECTORY) != 0;
+    const bool is_read_only = (attrs & FILE_ATTRIBUTE_READONLY) != 0;
+    if (is_read_only)
+    {
+        // RemoveDirectoryW and DeleteFileW do not allow to remove a read-only file, so we have to drop the attribute
+        DWORD new_attrs = attrs & ~FILE_ATTRIBUTE_READONLY;
+        BOOL res = ::SetFileAttributesW(p.c_str(), new_attrs);
+        if (BOOST_UNLIKELY(!res))
+        {
+            DWORD err = ::GetLastError();
+            if (!not_found_error(err))
+                emit_error(err, p, ec, "boost::filesystem::remove");
+
+            return false;
+        }
+    }
+
+    BOOL res;
+    if (!is_directory)
+    {
+        // DeleteFileW works for file symlinks by removing the symlink, not the target.
+        res = ::DeleteFileW(p.c_str());
+    }
+    else
+    {
+        // RemoveDirectoryW works for symlinks and junctions by removing the symlink, not the target,
+        // even if the target directory is not empty.
+        // Note that unlike opening the directory with FILE_FLAG_DELETE_ON_CLOSE flag, RemoveDirectoryW
+        // will fail if the directory is not empty.
+        res = ::RemoveDirectoryW(p.c_str());
+    }
+
+    if (BOOST_UNLIKELY(!res))
+    {
+        DWORD err = ::GetLastError();
+        if (!not_found_error(err))
+        {
+            if (is_read_only)
+            {
+                // Try to restore the read-only attribute
+                ::SetFileAttributesW(p.c_str(), attrs);
+            }
+
+            emit_error(err, p, ec, "boost::filesystem::remove");
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+//! remove() by handle implementation for Windows Vista and newer
+DWORD remove_nt6_by_handle(HANDLE handle, remove_impl_type impl)
+{
+    GetFileInformationByHandleEx_t* get_file_information_by_handle_ex = filesystem::detail::atomic_load_relaxed(get_file_information_by_handle_ex_api);
+    SetFileInformationByHandle_t* set_file_information_by_handle = filesystem::detail::atomic_load_relaxed(set_file_information_by_handle_api);
+    DWORD err = 0u;
+    switch (impl)
+    {
+    case remove_disp_ex_flag_ignore_readonly:
+        {
+            file_disposition_info_ex info;
+            info.Flags = FILE_DISPOSITION_FLAG_DELETE | FILE_DISPOSITION_FLAG_POSIX_SEMANTICS | FILE_DISPOSITION_FLAG_IGNORE_READONLY_ATTRIBUTE;
+            BOOL res = set_file_information_by_handle(handle, file_disposition_info_ex_class, &info, sizeof(info));
+            if (BOOST_LIKELY(!!res))
+                break;
+
+            err = ::GetLastError();
+            if (BOOST_UNLIKELY(err == ERROR_INVALID_PARAMETER || err == ERROR_INVALID_FUNCTION || err == ERROR_NOT_SUPPORTED))
+            {
+                // Downgrade to the older implementation
+                impl = remove_disp_ex_flag_posix_semantics;
+                filesystem::detail::atomic_store_relaxed(g_remove_impl_type, impl);
+            }
+            else
+            {
+                break;
+            }
+        }
+        BOOST_FALLTHROUGH;
+
+    case remove_disp_ex_flag_posix_semantics:
+        {
+            file_disposition_info_ex info;
+            info.Flags = FILE_DISPOSITION_FLAG_DELETE | FILE_DISPOSITION_FLAG_POSIX_SEMANTICS;
+            BOOL res = set_file_information_by_handle(handle, file_disposition_info_ex_class, &info, sizeof(info));
+            if (BOOST_LIKELY(!!res))
+            {
+                err = 0u;
+                break;
+            }
+
+            err = ::GetLastError();
+            if (err == ERROR_ACCESS_DENIED)
+            {
+                // Check if the file is read-only and reset the attribute
+                file_basic_info basic_info;
+                res = get_file_information_by_handle_ex(handle, file_basic_info_class, &basic_info, sizeof(basic_info));
+                if (BOOST_UNLIKELY(!res || (basic_info.FileAttributes & FILE_ATTRIBUTE_READONLY) == 0))
+                    break; // return ERROR_ACCESS_DENIED
+
+                basic_info.FileAttributes &= ~FILE_ATTRIBUTE_READONLY;
+
+                res = set_file_information_by_handle(handle, file_basic_info_class, &basic_info, sizeof(basic_info));
+                if (BOOST_UNLIKELY(!res))
+                {
+                    err = ::GetLastError();
+                    break;
+                }
+
+                // Try to set the flag again
+                res = set_file_information_by_handle(handle, file_disposition_info_ex_class, &info, sizeof(info));
+                if (BOOST_LIKELY(!!res))
+                {
+                    err = 0u;
+                    break;
+                }
+
+                err = ::GetLastError();
+
+                // Try to restore the read-only flag
+                basic_info.FileAttributes |= FILE_ATTRIBUTE_READONLY;
+                set_file_information_by_handle(handle, file_basic_info_class, &basic_info, sizeof(basic_info));
+
+                break;
+            }
+            else if (BOOST_UNLIKELY(err == ERROR_INVALID_PARAMETER || err == ERROR_INVALID_FUNCTION || err == ERROR_NOT_SUPPORTED))
+            {
+                // Downgrade to the older implementation
+                impl = remove_disp;
+                filesystem::detail::atomic_store_relaxed(g_remove_impl_type, impl);
+            }
+            else
+            {
+                break;
+            }
+        }
+        BOOST_FALLTHROUGH;
+
+    default:
+        {
+            file_disposition_info info;
+            info.DeleteFile = true;
+            BOOL res = set_file_information_by_handle(handle, file_disposition_info_class, &info, sizeof(info));
+            if (BOOST_LIKELY(!!res))
+            {
+                err = 0u;
+                break;
+            }
+
+            err = ::GetLastError();
+            if (err == ERROR_ACCESS_DENIED)
+            {
+                // Check if the file is read-only and reset the attribute
+                file_basic_info basic_info;
+                res = get_file_information_by_handle_ex(handle, file_basic_info_class, &basic_info, sizeof(basic_info));
+                if (BOOST_UNLIKELY(!res || (basic_info.FileAttributes & FILE_ATTRIBUTE_READONLY) == 0))
+                    break; // return ERROR_ACCESS_DENIED
+
+                basic_info.FileAttributes &= ~FILE_ATTRIBUTE_READONLY;
+
+                res = set_file_information_by_handle(handle, file_basic_info_class, &basic_info, sizeof(basic_info));
+                if (BOOST_UNLIKELY(!res))
+                {
+                    err = ::GetLastError();
+                    break;
+                }
+
+                // Try to set the flag again
+                res = set_file_information_by_handle(handle, file_disposition_info_class, &info, sizeof(info));
+                if (BOOST_LIKELY(!!res))
+                {
+                    err = 0u;
+                    break;
+                }
+
+                err = ::GetLastError();
+
+                // Try to restore the read-only flag
+                basic_info.FileAttributes |= FILE_ATTRIBUTE_READONLY;
+                set_file_information_by_handle(handle, file_basic_info_class, &basic_info, sizeof(basic_info));
+            }
+
+            break;
+        }
+    }
+
+    return err;
+}
+
+//! remove() implementation for Windows Vista and newer
+inline bool remove_nt6_impl(path const& p, remove_impl_type impl, error_code* ec)
+{
+    handle_wrapper h(create_file_handle(
+        p,
+        DELETE | FILE_READ_ATTRIBUTES | FILE_WRITE_ATTRIBUTES,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OPEN_REPARSE_POINT));
+    DWORD err = 0u;
+    if (BOOST_UNLIKELY(h.handle == INVALID_HANDLE_VALUE))
+    {
+        err = ::GetLastError();
+
+    return_error:
+        if (!not_found_error(err))
+            emit_error(err, p, ec, "boost::filesystem::remove");
+
+        return false;
+    }
+
+    err = fs::detail::remove_nt6_by_handle(h.handle, impl);
+    if (BOOST_UNLIKELY(err != 0u))
+        goto return_error;
+
+    return true;
+}
+
+//! remove() implementation
+inline bool remove_impl(path const& p, error_code* ec)
+{
+    remove_impl_type impl = fs::detail::atomic_load_relaxed(g_remove_impl_type);
+    if (BOOST_LIKELY(impl != remove_nt5))
+    {
+        return fs::detail::remove_nt6_impl(p, impl, ec);
+    }
+    else
+    {
+        const DWORD attrs = ::GetFileAttributesW(p.c_str());
+        if (BOOST_UNLIKELY(attrs == INVALID_FILE_ATTRIBUTES))
+        {
+            DWORD err = ::GetLastError();
+            if (!not_found_error(err))
+                emit_error(err, p, ec, "boost::filesystem::remove");
+
+            return false;
+        }
+
+        return fs::detail::remove_nt5_impl(p, attrs, ec);
+    }
+}
+
+#if !defined(UNDER_CE)
+
+//! remove_all() by handle implementation for Windows Vista and newer
+/*!
+ * If \a type_hint is not \c status_error, it is the file type of \a p, as reported by the directory iterator, and the file
+ * type is not queried through the handle.
+ */
+uintmax_t remove_all_nt6_by_handle(HANDLE h, path const& p, error_code* ec, fs::file_type type_hint = fs::status_error)
+{
+    error_code local_ec;
+    fs::file_type type = type_hint;
+    if (type == fs::status_error)
+    {
+        type = fs::detail::status_by_handle(h, p, &local_ec).type();
+        if (BOOST_UNLIKELY(type == fs::status_error))
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove_all", p, local_ec));
+
+            *ec = local_ec;
+            return static_cast< uintmax_t >(-1);
+        }
+    }
+
+    uintmax_t count = 0u;
+    if (type == fs::directory_file)
+    {
+        local_ec.clear();
+
+        fs::directory_iterator itr;
+        directory_iterator_params params;
+        params.use_handle = h;
+        params.close_handle = false; // the caller will close the handle
+        fs::detail::directory_iterator_construct(itr, p, static_cast< unsigned int >(directory_options::_detail_no_follow), &params, &local_ec);
+        if (BOOST_UNLIKELY(!!local_ec))
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove_all", p, local_ec));
+
+            *ec = local_ec;
+            return static_cast< uintmax_t >(-1);
+        }
+
+        NtCreateFile_t* nt_create_file = filesystem::detail::atomic_load_relaxed(nt_create_file_api);
+        const fs::directory_iterator end_dit;
+        while (itr != end_dit)
+        {
+            fs::path nested_path(itr->path());
+            handle_wrapper hh;
+            if (BOOST_LIKELY(nt_create_file != NULL))
+            {
+                // Note: WinAPI methods like CreateFileW implicitly request SYNCHRONIZE access but NtCreateFile doesn't.
+                // Without SYNCHRONIZE access querying file attributes via GetFileInformationByHandleEx fails with ERROR_ACCESS_DENIED.
+                boost::winapi::NTSTATUS_ status = nt_create_file_handle_at
+                (
+                    hh.handle,
+                    h,
+                    nested_path.filename(),
+                    0u, // FileAttributes
+                    FILE_LIST_DIRECTORY | DELETE | FILE_READ_ATTRIBUTES | FILE_WRITE_ATTRIBUTES | SYNCHRONIZE,
+                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                    FILE_OPEN,
+                    FILE_OPEN_FOR_BACKUP_INTENT | FILE_OPEN_REPARSE_POINT
+                );
+
+                if (!NT_SUCCESS(status))
+                {
+                    if (status == STATUS_NO_SUCH_FILE ||
+                        status == STATUS_OBJECT_NAME_NOT_FOUND ||
+                        status == STATUS_OBJECT_PATH_NOT_FOUND ||
+                        status == STATUS_BAD_NETWORK_PATH ||
+                        status == STATUS_BAD_NETWORK_NAME)
+                    {
+                        goto next_entry;
+                    }
+
+                    DWORD err = translate_ntstatus(status);
+                    emit_error(err, nested_path, ec, "boost::filesystem::remove_all");
+                    return static_cast< uintmax_t >(-1);
+                }
+            }
+            else
+            {
+                hh.handle = create_file_handle(
+                    nested_path,
+                    FILE_LIST_DIRECTORY | DELETE | FILE_READ_ATTRIBUTES | FILE_WRITE_ATTRIBUTES | SYNCHRONIZE,
+                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                    NULL,
+                    OPEN_EXISTING,
+                    FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OPEN_REPARSE_POINT);
+
+                if (BOOST_UNLIKELY(hh.handle == INVALID_HANDLE_VALUE))
+                {
+                    DWORD err = ::GetLastError();
+                    if (not_found_error(err))
+                        goto next_entry;
+
+                    emit_error(err, nested_path, ec, "boost::filesystem::remove_all");
+                    return static_cast< uintmax_t >(-1);
+                }
+            }
+
+            // Use the file type reported by the directory iterator, if known, to avoid querying it per file
+            count += fs::detail::remove_all_nt6_by_handle(hh.handle, nested_path, ec, fs::detail::get_cached_symlink_status(*itr).type());
+            if (ec && *ec)
+                return static_cast< uintmax_t >(-1);
+
+        next_entry:
+            fs::detail::directory_iterator_increment(itr, ec);
+            if (ec && *ec)
+                return static_cast< uintmax_t >(-1);
+        }
+    }
+
+    DWORD err = fs::detail::remove_nt6_by_handle(h, fs::detail::atomic_load_relaxed(g_remove_impl_type));
+    if (BOOST_UNLIKELY(err != 0u))
+    {
+        // The file may have been replaced with a non-empty directory since it was enumerated. Query the actual file type and start over.
+        if (err == ERROR_DIR_NOT_EMPTY && type_hint != fs::status_error && type_hint != fs::directory_file)
+            return fs::detail::remove_all_nt6_by_handle(h, p, ec);
+
+        emit_error(err, p, ec, "boost::filesystem::remove_all");
+        return static_cast< uintmax_t >(-1);
+    }
+
+    ++count;
+    return count;
+}
+
+#endif // !defined(UNDER_CE)
+
+//! remove_all() implementation for Windows XP and older
+uintmax_t remove_all_nt5_impl(path const& p, error_code* ec)
+{
+    error_code dit_create_ec;
+    for (unsigned int attempt = 0u; attempt < remove_all_directory_replaced_retry_count; ++attempt)
+    {
+        const DWORD attrs = ::GetFileAttributesW(p.c_str());
+        if (BOOST_UNLIKELY(attrs == INVALID_FILE_ATTRIBUTES))
+        {
+            DWORD err = ::GetLastError();
+            if (not_found_error(err))
+                return 0u;
+
+            emit_error(err, p, ec, "boost::filesystem::remove_all");
+            return static_cast< uintmax_t >(-1);
+        }
+
+        // Recurse into directories, but not into junctions or directory symlinks
+        const bool recurse = (attrs & FILE_ATTRIBUTE_DIRECTORY) != 0 && (attrs & FILE_ATTRIBUTE_REPARSE_POINT) == 0;
+        uintmax_t count = 0u;
+        if (recurse)
+        {
+            fs::directory_iterator itr;
+            fs::detail::directory_iterator_construct(itr, p, static_cast< unsigned int >(directory_options::_detail_no_follow), NULL, &dit_create_ec);
+            if (BOOST_UNLIKELY(!!dit_create_ec))
+            {
+                if (dit_create_ec == make_error_condition(system::errc::not_a_directory) ||
+                    dit_create_ec == make_error_condition(system::errc::too_many_symbolic_link_levels))
+                {
+                    continue;
+                }
+
+                if (!ec)
+                    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove_all", p, dit_create_ec));
+
+                *ec = dit_create_ec;
+                return static_cast< uintmax_t >(-1);
+            }
+
+            const fs::directory_iterator end_dit;
+            while (itr != end_dit)
+            {
+                count += fs::detail::remove_all_nt5_impl(itr->path(), ec);
+                if (ec && *ec)
+                    return static_cast< uintmax_t >(-1);
+
+                fs::detail::directory_iterator_increment(itr, ec);
+                if (ec && *ec)
+                    return static_cast< uintmax_t >(-1);
+            }
+        }
+
+        bool removed = fs::detail::remove_nt5_impl(p, attrs, ec);
+        if (ec && *ec)
+            return static_cast< uintmax_t >(-1);
+
+        count += removed;
+        return count;
+    }
+
+    if (!ec)
+        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove_all: path cannot be opened as a directory", p, dit_create_ec));
+
+    *ec = dit_create_ec;
+    return static_cast< uintmax_t >(-1);
+}
+
+//! remove_all() implementation
+inline uintmax_t remove_all_impl(path const& p, error_code* ec)
+{
+#if !defined(UNDER_CE)
+    remove_impl_type impl = fs::detail::atomic_load_relaxed(g_remove_impl_type);
+    if (BOOST_LIKELY(impl != remove_nt5))
+    {
+        handle_wrapper h(create_file_handle(
+            p,
+            FILE_LIST_DIRECTORY | DELETE | FILE_READ_ATTRIBUTES | FILE_WRITE_ATTRIBUTES | SYNCHRONIZE,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL,
+            OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OPEN_REPARSE_POINT));
+
+        if (BOOST_UNLIKELY(h.handle == INVALID_HANDLE_VALUE))
+        {
+            DWORD err = ::GetLastError();
+            if (not_found_error(err))
+                return 0u;
+
+            emit_error(err, p, ec, "boost::filesystem::remove_all");
+            return static_cast< uintmax_t >(-1);
+        }
+
+        return fs::detail::remove_all_nt6_by_handle(h.handle, p, ec);
+    }
+#endif // !defined(UNDER_CE)
+
+    return fs::detail::remove_all_nt5_impl(p, ec);
+}
+
+inline BOOL resize_file_impl(const wchar_t* p, uintmax_t size)
+{
+    handle_wrapper h(CreateFileW(p, GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL));
+    LARGE_INTEGER sz;
+    sz.QuadPart = size;
+    return h.handle != INVALID_HANDLE_VALUE && ::SetFilePointerEx(h.handle, sz, 0, FILE_BEGIN) && ::SetEndOfFile(h.handle);
+}
+
+//! FILE_ALLOCATION_INFO definition from Windows SDK
+struct file_allocation_info
+{
+    LARGE_INTEGER AllocationSize;
+};
+
+//! FILE_ZERO_DATA_INFORMATION definition from Windows SDK
+struct file_zero_data_information
+{
+    LARGE_INTEGER FileOffset;
+    LARGE_INTEGER BeyondFinalZero;
+};
+
+/*!
+ * Allocates storage for \a size bytes of the file starting at \a offset. If \a keep_size is \c true, the file size is not changed.
+ * Returns 0 on success, otherwise an error code.
+ *
+ * NTFS releases the storage allocated beyond the end of the file when the file is closed, so with \a keep_size the range
+ * must not extend beyond the end of the file. Within the end of the file, storage of non-sparse files is always allocated.
+ */
+DWORD preallocate_file(HANDLE h, uintmax_t offset, uintmax_t size, bool keep_size)
+{
+    GetFileInformationByHandleEx_t* get_file_information_by_handle_ex = filesystem::detail::atomic_load_relaxed(get_file_information_by_handle_ex_api);
+    SetFileInformationByHandle_t* set_file_information_by_handle = filesystem::detail::atomic_load_relaxed(set_file_information_by_handle_api);
+    if (BOOST_UNLIKELY(!get_file_information_by_handle_ex || !set_file_information_by_handle))
+        return ERROR_NOT_SUPPORTED;
+
+    file_standard_info info;
+    if (BOOST_UNLIKELY(!get_file_information_by_handle_ex(h, file_standard_info_class, &info, sizeof(info))))
+        return ::GetLastError();
+
+    const LONGLONG end = static_cast< LONGLONG >(offset + size);
+    if (end <= info.EndOfFile.QuadPart)
+        return 0u;
+
+    if (keep_size)
+        return ERROR_NOT_SUPPORTED;
+
+    if (end > info.AllocationSize.QuadPart)
+    {
+        file_allocation_info alloc_info;
+        alloc_info.AllocationSize.QuadPart = end;
+        if (BOOST_UNLIKELY(!set_file_information_by_handle(h, file_allocation_info_class, &alloc_info, sizeof(alloc_info))))
+            return ::GetLastError();
+    }
+
+    LARGE_INTEGER sz;
+    sz.QuadPart = end;
+    if (BOOST_UNLIKELY(!::SetFilePointerEx(h, sz, NULL, FILE_BEGIN) || !::SetEndOfFile(h)))
+        return ::GetLastError();
+
+    return 0u;
+}
+
+//! Zeros \a size bytes of the file starting at \a offset. For sparse files, the storage of the range is deallocated.
+DWORD zero_file_data(HANDLE h, uintmax_t offset, uintmax_t size)
+{
+    file_zero_data_information info;
+    info.FileOffset.QuadPart = static_cast< LONGLONG >(offset);
+    info.BeyondFinalZero.QuadPart = static_cast< LONGLONG >(offset + size);
+    DWORD bytes_returned = 0u;
+    if (BOOST_UNLIKELY(!::DeviceIoControl(h, FSCTL_SET_ZERO_DATA, &info, sizeof(info), NULL, 0u, &bytes_returned, NULL)))
+    {
+        const DWORD err = ::GetLastError();
+        return err == ERROR_INVALID_FUNCTION ? static_cast< DWORD >(ERROR_NOT_SUPPORTED) : err;
+    }
+
+    return 0u;
+}
+
+//! Deallocates storage of \a size bytes of the file starting at \a offset, making the file sparse
+DWORD punch_hole_file(HANDLE h, uintmax_t offset, uintmax_t size)
+{
+    BY_HANDLE_FILE_INFORMATION info;
+    if (BOOST_UNLIKELY(!::GetFileInformationByHandle(h, &info)))
+        return ::GetLastError();
+
+    if ((info.dwFileAttributes & FILE_ATTRIBUTE_SPARSE_FILE) == 0u)
+    {
+        // Only the volumes supporting sparse files can deallocate ranges of files
+        DWORD bytes_returned = 0u;
+        if (BOOST_UNLIKELY(!::DeviceIoControl(h, FSCTL_SET_SPARSE, NULL, 0u, NULL, 0u, &bytes_returned, NULL)))
+        {
+            const DWORD err = ::GetLastError();
+            return err == ERROR_INVALID_FUNCTION ? static_cast< DWORD >(ERROR_NOT_SUPPORTED) : err;
+        }
+    }
+
+    return zero_file_data(h, offset, size);
+}
+
+//! Returns \c true if the error code returned by copy_file_by_handle indicates that the filesystem does not support block cloning
+inline bool is_clone_not_supported_error(DWORD err) BOOST_NOEXCEPT
+{
+    // FSCTL_GET_INTEGRITY_INFORMATION fails with ERROR_INVALID_FUNCTION on filesystems other than ReFS.
+    // FSCTL_DUPLICATE_EXTENTS_TO_FILE fails with ERROR_NOT_SAME_DEVICE if the files are on different volumes.
+    return err == ERROR_INVALID_FUNCTION || err == ERROR_NOT_SUPPORTED || err == ERROR_INVALID_PARAMETER ||
+        err == ERROR_NOT_SAME_DEVICE || err == ERROR_BLOCK_TOO_MANY_REFERENCES;
+}
+
+//! Clones all clusters of the source file into the target file, which must be at least as large as the source file
+DWORD clone_file_clusters(HANDLE from, HANDLE to, ULONGLONG size, ULONGLONG cluster_size)
+{
+    // Cloned ranges must be cluster-aligned, the last one is allowed to extend past the end of the file.
+    // Each request must be less than 4 GiB.
+    const ULONGLONG clone_size = (size + cluster_size - 1u) & ~(cluster_size - 1u);
+    const ULONGLONG max_chunk_size = 1ull << 30u;
+    for (ULONGLONG offset = 0u; offset < clone_size;)
+    {
+        duplicate_extents_data extents;
+        extents.FileHandle = from;
+        extents.SourceFileOffset.QuadPart = static_cast< LONGLONG >(offset);
+        extents.TargetFileOffset.QuadPart = static_cast< LONGLONG >(offset);
+        const ULONGLONG chunk_size = (clone_size - offset) < max_chunk_size ? (clone_size - offset) : max_chunk_size;
+        extents.ByteCount.QuadPart = static_cast< LONGLONG >(chunk_size);
+
+        DWORD bytes_returned = 0u;
+        if (!::DeviceIoControl(to, FSCTL_DUPLICATE_EXTENTS_TO_FILE, &extents, sizeof(extents), NULL, 0u, &bytes_returned, NULL))
+            return ::GetLastError();
+
+        offset += chunk_size;
+    }
+
+    return 0u;
+}
+
+//! Copies data of the given range of the source file to the same offset in the target file
+DWORD copy_file_range_read_write(HANDLE from, HANDLE to, LONGLONG offset, LONGLONG size, char* buf, DWORD buf_size)
+{
+    LARGE_INTEGER pos;
+    pos.QuadPart = offset;
+    if (!::SetFilePointerEx(from, pos, NULL, FILE_BEGIN) || !::SetFilePointerEx(to, pos, NULL, FILE_BEGIN))
+        return ::GetLastError();
+
+    while (size > 0)
+    {
+        const DWORD size_to_read = size < static_cast< LONGLONG >(buf_size) ? static_cast< DWORD >(size) : buf_size;
+        DWORD size_read = 0u;
+        if (!::ReadFile(from, buf, size_to_read, &size_read, NULL))
+            return ::GetLastError();
+        if (size_read == 0u)
+            break; // the file was truncated concurrently
+
+        DWORD size_written = 0u;
+        if (!::WriteFile(to, buf, size_read, &size_written, NULL))
+            return ::GetLastError();
+
+        size -= size_read;
+    }
+
+    return 0u;
+}
+
+//! Copies allocated ranges of the sparse source file to the target file, which must be sparse and at least as large as the source file
+DWORD copy_file_allocated_ranges(HANDLE from, HANDLE to, LONGLONG size)
+{
+    BOOST_CONSTEXPR_OR_CONST DWORD buf_size = 256u * 1024u;
+    scoped_copy_buffer buf;
+    if (BOOST_UNLIKELY(!buf.reserve(buf_size)))
+        return ERROR_NOT_ENOUGH_MEMORY;
+
+    file_allocated_range_buffer query;
+    query.FileOffset.QuadPart = 0;
+    query.Length.QuadPart = size;
+
+    file_allocated_range_buffer ranges[64];
+    while (query.Length.QuadPart > 0)
+    {
+        DWORD bytes_returned = 0u;
+        const BOOL complete = ::DeviceIoControl(from, FSCTL_QUERY_ALLOCATED_RANGES, &query, sizeof(query), ranges, sizeof(ranges), &bytes_returned, NULL);
+        if (!complete)
+        {
+            const DWORD err = ::GetLastError();
+            if (err != ERROR_MORE_DATA)
+                return err;
+        }
+
+        const std::size_t count = bytes_returned / sizeof(*ranges);
+        if (count == 0u)
+            break;
+
+        for (std::size_t i = 0u; i < count; ++i)
+        {
+            DWORD err = copy_file_range_read_write(from, to, ranges[i].FileOffset.QuadPart, ranges[i].Length.QuadPart, buf.data(), buf_size);
+            if (BOOST_UNLIKELY(err != 0u))
+                return err;
+        }
+
+        if (complete)
+            break;
+
+        const LONGLONG query_end = query.FileOffset.QuadPart + query.Length.QuadPart;
+        query.FileOffset.QuadPart = ranges[count - 1u].FileOffset.QuadPart + ranges[count - 1u].Length.QuadPart;
+        query.Length.QuadPart = query_end - query.FileOffset.QuadPart;
+    }
+
+    return 0u;
+}
+
+//! File copying modes of copy_file_by_handle
+enum copy_file_by_handle_mode
+{
+    //! Clone the file clusters with FSCTL_DUPLICATE_EXTENTS_TO_FILE, which is supported by ReFS since Windows Server 2016
+    copy_file_by_handle_clone,
+    //! Copy only allocated ranges of a sparse file. Non-sparse files are not copied and ERROR_NOT_SUPPORTED is returned.
+    copy_file_by_handle_sparse
+};
+
+/*!
+ * Creates a copy of the file in one of the modes that are not supported by CopyFileExW. Returns 0 on success or an error code.
+ * On failure, the target file is removed, if created.
+ */
+DWORD copy_file_by_handle(path const& from, path const& to, copy_file_by_handle_mode mode, bool fail_if_exists, bool synchronize, copy_progress_callback* progress, void* progress_context)
+{
+    // Create handle_wrappers here so that CloseHandle calls don't clobber error code returned by GetLastError
+    handle_wrapper hw_from, hw_to;
+
+    hw_from.handle = create_file_handle(from.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN);
+    if (BOOST_UNLIKELY(hw_from.handle == INVALID_HANDLE_VALUE))
+        return ::GetLastError();
+
+    BY_HANDLE_FILE_INFORMATION from_info;
+    if (BOOST_UNLIKELY(!::GetFileInformationByHandle(hw_from.handle, &from_info)))
+        return ::GetLastError();
+
+    DWORD bytes_returned = 0u;
+    ULONGLONG cluster_size = 0u;
+    if (mode == copy_file_by_handle_clone)
+    {
+        fsctl_get_integrity_information_buffer integrity_info = {};
+        if (!::DeviceIoControl(hw_from.handle, FSCTL_GET_INTEGRITY_INFORMATION, NULL, 0u, &integrity_info, sizeof(integrity_info), &bytes_returned, NULL))
+            return ::GetLastError();
+
+        // Cluster size is always a power of two
+        cluster_size = integrity_info.ClusterSizeInBytes;
+        if (BOOST_UNLIKELY(cluster_size == 0u || (cluster_size & (cluster_size - 1u)) != 0u))
+            return ERROR_NOT_SUPPORTED;
+    }
+    else if ((from_info.dwFileAttributes & FILE_ATTRIBUTE_SPARSE_FILE) == 0u)
+    {
+        return ERROR_NOT_SUPPORTED;
+    }
+
+    // Create the file exclusively first, so that only the file created by this call is deleted on failure
+    bool created = true;
+    hw_to.handle = create_file_handle(to.c_str(), GENERIC_READ | GENERIC_WRITE, 0u, NULL, CREATE_NEW, FILE_ATTRIBUTE_NORMAL);
+    if (hw_to.handle == INVALID_HANDLE_VALUE && !fail_if_exists)
+    {
+        const DWORD create_err = ::GetLastError();
+        if (create_err != ERROR_FILE_EXISTS && create_err != ERROR_ALREADY_EXISTS)
+            return create_err;
+
+        created = false;
+        hw_to.handle = create_file_handle(to.c_str(), GENERIC_READ | GENERIC_WRITE, 0u, NULL, TRUNCATE_EXISTING, FILE_ATTRIBUTE_NORMAL);
+    }
+
+    if (BOOST_UNLIKELY(hw_to.handle == INVALID_HANDLE_VALUE))
+        return ::GetLastError();
+
+    DWORD err = 0u;
+    LARGE_INTEGER size;
+    size.QuadPart = (static_cast< LONGLONG >(from_info.nFileSizeHigh) << 32) | static_cast< LONGLONG >(from_info.nFileSizeLow);
+
+    if ((from_info.dwFileAttributes & FILE_ATTRIBUTE_SPARSE_FILE) != 0u)
+    {
+        if (!::DeviceIoControl(hw_to.handle, FSCTL_SET_SPARSE, NULL, 0u, NULL, 0u, &bytes_returned, NULL))
+            goto fail_last_error;
+    }
+
+    // The target file must be large enough to contain the copied data. For sparse files, this creates a hole spanning the whole file.
+    if (!::SetFilePointerEx(hw_to.handle, size, NULL, FILE_BEGIN) || !::SetEndOfFile(hw_to.handle))
+        goto fail_last_error;
+
+    if (mode == copy_file_by_handle_clone)
+        err = clone_file_clusters(hw_from.handle, hw_to.handle, static_cast< ULONGLONG >(size.QuadPart), cluster_size);
+    else
+        err = copy_file_allocated_ranges(hw_from.handle, hw_to.handle, size.QuadPart);
+
+    if (BOOST_UNLIKELY(err != 0u))
+        goto fail;
+
+    if (progress && !progress(from, to, static_cast< uintmax_t >(size.QuadPart), static_cast< uintmax_t >(size.QuadPart), progress_context))
+    {
+        // Same error as CopyFileExW returns when the operation is cancelled by the progress routine
+        err = ERROR_REQUEST_ABORTED;
+        goto fail;
+    }
+
+    // Match CopyFileExW behavior, which preserves the last write time and file attributes
+    if (!::SetFileTime(hw_to.handle, NULL, NULL, &from_info.ftLastWriteTime))
+        goto fail_last_error;
+
+    if (synchronize && !::FlushFileBuffers(hw_to.handle))
+        goto fail_last_error;
+
+    ::CloseHandle(hw_to.handle);
+    hw_to.handle = INVALID_HANDLE_VALUE;
+
+    if (!::SetFileAttributesW(to.c_str(), from_info.dwFileAttributes & (FILE_ATTRIBUTE_READONLY | FILE_ATTRIBUTE_HIDDEN | FILE_ATTRIBUTE_SYSTEM | FILE_ATTRIBUTE_ARCHIVE | FILE_ATTRIBUTE_NOT_CONTENT_INDEXED)))
+    {
+        err = ::GetLastError();
+        goto fail;
+    }
+
+    return 0u;
+
+fail_last_error:
+    err = ::GetLastError();
+
+fail:
+    if (hw_to.handle != INVALID_HANDLE_VALUE)
+    {
+        ::CloseHandle(hw_to.handle);
+        hw_to.handle = INVALID_HANDLE_VALUE;
+    }
+    if (created)
+        ::DeleteFileW(to.c_str());
+    return err;
+}
+
+//! Reads up to \a size bytes at the given offset, until the buffer is filled or the end of the file is reached
+DWORD read_file_at(HANDLE h, char* buf, DWORD size, ULONGLONG offset, DWORD& sz_read)
+{
+    sz_read = 0u;
+    while (sz_read < size)
+    {
+        OVERLAPPED ov = {};
+        const ULONGLONG pos = offset + sz_read;
+        ov.Offset = static_cast< DWORD >(pos);
+        ov.OffsetHigh = static_cast< DWORD >(pos >> 32);
+        DWORD sz = 0u;
+        if (!::ReadFile(h, buf + sz_read, size - sz_read, &sz, &ov))
+        {
+            DWORD err = ::GetLastError();
+            if (err == ERROR_HANDLE_EOF)
+                break;
+            return err;
+        }
+
+        if (sz == 0u)
+            break;
+
+        sz_read += sz;
+    }
+
+    return 0u;
+}
+
+//! Writes \a size bytes at the given offset
+DWORD write_file_at(HANDLE h, const char* buf, DWORD size, ULONGLONG offset)
+{
+    for (DWORD sz_wrote = 0u; sz_wrote < size;)
+    {
+        OVERLAPPED ov = {};
+        const ULONGLONG pos = offset + sz_wrote;
+        ov.Offset = static_cast< DWORD >(pos);
+        ov.OffsetHigh = static_cast< DWORD >(pos >> 32);
+        DWORD sz = 0u;
+        if (!::WriteFile(h, buf + sz_wrote, size - sz_wrote, &sz, &ov))
+            return ::GetLastError();
+
+        sz_wrote += sz;
+    }
+
+    return 0u;
+}
+
+//! TransmitFile signature, with the socket and buffer types replaced to avoid including WinSock headers
+typedef BOOL WINAPI TransmitFile_t(UINT_PTR hSocket, HANDLE hFile, DWORD nNumberOfBytesToWrite, DWORD nNumberOfBytesPerSend, LPOVERLAPPED lpOverlapped, void* lpTransmitBuffers, DWORD dwReserved);
+
+//! Pointer to TransmitFile from mswsock.dll, loaded on the first use
+TransmitFile_t* transmit_file_api = NULL;
+//! Indicates that loading of TransmitFile was attempted
+bool transmit_file_api_loaded = false;
+
+//! Returns the pointer to TransmitFile or \c NULL if it is not available
+TransmitFile_t* get_transmit_file_api() BOOST_NOEXCEPT
+{
+    if (BOOST_LIKELY(filesystem::detail::atomic_load_acquire(transmit_file_api_loaded)))
+        return filesystem::detail::atomic_load_relaxed(transmit_file_api);
+
+    // mswsock.dll is normally loaded by the application already, if it uses sockets. The library is never unloaded.
+    // Concurrent calls may load the library multiple times, which only increments its reference counter.
+    TransmitFile_t* api = NULL;
+    HMODULE h = ::LoadLibraryW(L"mswsock.dll");
+    if (BOOST_LIKELY(h != NULL))
+        api = (TransmitFile_t*)boost::winapi::get_proc_address(h, "TransmitFile");
+
+    filesystem::detail::atomic_store_relaxed(transmit_file_api, api);
+    filesystem::detail::atomic_store_release(transmit_file_api_loaded, true);
+    return api;
+}
+
+//! Windows error code returned by TransmitFile if the target handle is not a socket, WSAENOTSOCK
+BOOST_CONSTEXPR_OR_CONST DWORD error_not_socket = 10038u;
+
+/*!
+ * copy_data implementation that selects the data copying method based on the types of the handles. If \a offset is not \c NULL,
+ * the data is read at the offset. \a copied is incremented by the amount of data copied.
+ */
+DWORD copy_data_impl(HANDLE infile, HANDLE outfile, uintmax_t* offset, uintmax_t size, uintmax_t& copied)
+{
+    if (offset)
+    {
+        LARGE_INTEGER pos;
+        pos.QuadPart = static_cast< LONGLONG >(*offset);
+        if (BOOST_UNLIKELY(!::SetFilePointerEx(infile, pos, NULL, FILE_BEGIN)))
+            return ::GetLastError();
+    }
+
+    // Sockets are reported as pipes
+    if (::GetFileType(infile) == FILE_TYPE_DISK && ::GetFileType(outfile) == FILE_TYPE_PIPE)
+    {
+        TransmitFile_t* transmit_file = get_transmit_file_api();
+        LARGE_INTEGER file_size, pos, zero;
+        zero.QuadPart = 0;
+        if (transmit_file && ::GetFileSizeEx(infile, &file_size) && ::SetFilePointerEx(infile, zero, &pos, FILE_CURRENT))
+        {
+            uintmax_t size_left = pos.QuadPart < file_size.QuadPart ? static_cast< uintmax_t >(file_size.QuadPart - pos.QuadPart) : 0u;
+            if (size_left > size - copied)
+                size_left = size - copied;
+
+            const uintmax_t initial_copied = copied;
+            while (size_left > 0u)
+            {
+                // TransmitFile does not send more than 2147483646 bytes in one call
+                const DWORD size_to_send = size_left < 0x7ffff000u ? static_cast< DWORD >(size_left) : static_cast< DWORD >(0x7ffff000u);
+                if (!transmit_file(reinterpret_cast< UINT_PTR >(outfile), infile, size_to_send, 0u, NULL, NULL, 0u))
+                {
+                    DWORD err = ::GetLastError();
+                    if (copied == initial_copied && err == error_not_socket)
+                        goto read_write;
+                    return err;
+                }
+
+                copied += size_to_send;
+                size_left -= size_to_send;
+
+                // Position the file after the sent data for the next call
+                pos.QuadPart += size_to_send;
+                if (BOOST_UNLIKELY(!::SetFilePointerEx(infile, pos, NULL, FILE_BEGIN)))
+                    return ::GetLastError();
+            }
+
+            return 0u;
+        }
+    }
+
+read_write:
+    {
+        instrumentation_scope instrumentation(instrumented_operation::copy_read_write);
+
+        char stack_buf[8u * 1024u];
+        char* buf = stack_buf;
+        DWORD buf_size = sizeof(stack_buf);
+        scoped_copy_buffer heap_buf;
+        if (BOOST_LIKELY(heap_buf.reserve(256u * 1024u)))
+        {
+            buf = heap_buf.data();
+            buf_size = static_cast< DWORD >(heap_buf.size());
+        }
+
+        while (copied < size)
+        {
+            const DWORD size_to_read = (size - copied) < buf_size ? static_cast< DWORD >(size - copied) : buf_size;
+            DWORD sz_read = 0u;
+            if (!::ReadFile(infile, buf, size_to_read, &sz_read, NULL))
+            {
+                DWORD err = ::GetLastError();
+                // Reading from a pipe whose write end is closed indicates the end of data
+                if (err == ERROR_HANDLE_EOF || err == ERROR_BROKEN_PIPE)
+                    break;
+                return err;
+            }
+
+            if (sz_read == 0u)
+                break;
+
+            for (DWORD sz_wrote = 0u; sz_wrote < sz_read;)
+            {
+                DWORD sz = 0u;
+                if (!::WriteFile(outfile, buf + sz_wrote, sz_read - sz_wrote, &sz, NULL))
+                    return ::GetLastError();
+
+                sz_wrote += sz;
+                copied += sz;
+            }
+        }
+    }
+
+    return 0u;
+}
+
+/*!
+ * Updates the existing target file in place, so that it matches the source file. The data of the files is compared in blocks, and only
+ * the runs of differing blocks are written to the target file. Returns 0 on success or an error code. Returns \c ERROR_FILE_NOT_FOUND
+ * if the target file does not exist. On failure, the target file may be partially updated.
+ */
+DWORD copy_file_delta_by_handle(path const& from, path const& to, bool synchronize, copy_progress_callback* progress, void* progress_context)
+{
+    // 4 KiB is the typical cluster size. Smaller blocks would not reduce the amount of data written to storage.
+    BOOST_CONSTEXPR_OR_CONST DWORD block_size = 4096u;
+    BOOST_CONSTEXPR_OR_CONST DWORD chunk_size = 256u * 1024u;
+
+    // Create handle_wrappers here so that CloseHandle calls don't clobber error code returned by GetLastError
+    handle_wrapper hw_from, hw_to;
+
+    hw_from.handle = create_file_handle(from.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN);
+    if (BOOST_UNLIKELY(hw_from.handle == INVALID_HANDLE_VALUE))
+        return ::GetLastError();
+
+    BY_HANDLE_FILE_INFORMATION from_info;
+    if (BOOST_UNLIKELY(!::GetFileInformationByHandle(hw_from.handle, &from_info)))
+        return ::GetLastError();
+
+    hw_to.handle = create_file_handle(to.c_str(), GENERIC_READ | GENERIC_WRITE, 0u, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN);
+    if (hw_to.handle == INVALID_HANDLE_VALUE)
+        return ::GetLastError();
+
+    BY_HANDLE_FILE_INFORMATION to_info;
+    if (BOOST_UNLIKELY(!::GetFileInformationByHandle(hw_to.handle, &to_info)))
+        return ::GetLastError();
+
+    const ULONGLONG from_size = (static_cast< ULONGLONG >(from_info.nFileSizeHigh) << 32) | static_cast< ULONGLONG >(from_info.nFileSizeLow);
+    const ULONGLONG to_size = (static_cast< ULONGLONG >(to_info.nFileSizeHigh) << 32) | static_cast< ULONGLONG >(to_info.nFileSizeLow);
+
+    scoped_copy_buffer buf;
+    if (BOOST_UNLIKELY(!buf.reserve(chunk_size * 2u)))
+        return ERROR_NOT_ENOUGH_MEMORY;
+
+    char* const from_buf = buf.data();
+    char* const to_buf = buf.data() + chunk_size;
+
+    ULONGLONG pos = 0u;
+    while (pos < from_size)
+    {
+        DWORD from_read = 0u;
+        DWORD err = read_file_at(hw_from.handle, from_buf, chunk_size, pos, from_read);
+        if (BOOST_UNLIKELY(err != 0u))
+            return err;
+        if (from_read == 0u)
+            break;
+
+        DWORD to_read = 0u;
+        if (pos < to_size)
+        {
+            err = read_file_at(hw_to.handle, to_buf, from_read, pos, to_read);
+            if (BOOST_UNLIKELY(err != 0u))
+                return err;
+        }
+
+        // Find runs of blocks that differ and write each run with a single call
+        DWORD run_start = from_read;
+        for (DWORD block_pos = 0u; block_pos < from_read; block_pos += block_size)
+        {
+            const DWORD n = (from_read - block_pos) < block_size ? (from_read - block_pos) : block_size;
+            const bool differs = (block_pos + n) > to_read || std::memcmp(from_buf + block_pos, to_buf + block_pos, n) != 0;
+            if (differs)
+            {
+                if (run_start == from_read)
+                    run_start = block_pos;
+            }
+            else if (run_start != from_read)
+            {
+                err = write_file_at(hw_to.handle, from_buf + run_start, block_pos - run_start, pos + run_start);
+                if (BOOST_UNLIKELY(err != 0u))
+                    return err;
+                run_start = from_read;
+            }
+        }
+
+        if (run_start != from_read)
+        {
+            err = write_file_at(hw_to.handle, from_buf + run_start, from_read - run_start, pos + run_start);
+            if (BOOST_UNLIKELY(err != 0u))
+                return err;
+        }
+
+        pos += from_read;
+    }
+
+    if (to_size > pos)
+    {
+        LARGE_INTEGER end_pos;
+        end_pos.QuadPart = static_cast< LONGLONG >(pos);
+        if (!::SetFilePointerEx(hw_to.handle, end_pos, NULL, FILE_BEGIN) || !::SetEndOfFile(hw_to.handle))
+            return ::GetLastError();
+    }
+
+    if (progress && !progress(from, to, static_cast< uintmax_t >(pos), static_cast< uintmax_t >(pos), progress_context))
+        return ERROR_REQUEST_ABORTED;
+
+    // Match CopyFileExW behavior, which preserves the last write time and file attributes
+    if (!::SetFileTime(hw_to.handle, NULL, NULL, &from_info.ftLastWriteTime))
+        return ::GetLastError();
+
+    if (synchronize && !::FlushFileBuffers(hw_to.handle))
+        return ::GetLastError();
+
+    ::CloseHandle(hw_to.handle);
+    hw_to.handle = INVALID_HANDLE_VALUE;
+
+    if (!::SetFileAttributesW(to.c_str(), from_info.dwFileAttributes & (FILE_ATTRIBUTE_READONLY | FILE_ATTRIBUTE_HIDDEN | FILE_ATTRIBUTE_SYSTEM | FILE_ATTRIBUTE_ARCHIVE | FILE_ATTRIBUTE_NOT_CONTENT_INDEXED)))
+        return ::GetLastError();
+
+    return 0u;
+}
+
+//! Converts NT path to a Win32 path
+inline path convert_nt_path_to_win32_path(const wchar_t* nt_path, std::size_t size)
+{
+    // https://googleprojectzero.blogspot.com/2016/02/the-definitive-guide-on-win32-to-nt.html
+    // https://stackoverflow.com/questions/23041983/path-prefixes-and
+    //
+    // NT paths can be used to identify practically any named objects, devices, files, local and remote shares, etc.
+    // The path starts with a leading backslash and consists of one or more path elements separated with backslashes.
+    // The set of characters allowed in NT path elements is significantly larger than that of Win32 paths - basically,
+    // any character except the backslash is allowed. Path elements are case-insensitive.
+    //
+    // NT paths that start with the "\??\" prefix are used to indicate the current user's session namespace. The prefix
+    // indicates to the NT object manager to lookup the object relative to "\Sessions\0\DosDevices\[Logon Authentication ID]".
+    //
+    // There is also a special "\Global??\" prefix that refers to the system logon. User's session directory shadows
+    // the system logon directory, so that when the referenced object is not found in the user's namespace,
+    // system logon is looked up instead.
+    //
+    // There is a symlink "Global" in the user's session namespace that refers to the global namespace, so "\??\Global"
+    // effectively resolves to "\Global??". This allows Win32 applications to directly refer to the system objects,
+    // even if shadowed by the current user's logon object.
+    //
+    // NT paths can be used to reference not only local filesystems, but also devices and remote shares identifiable via
+    // UNC paths. For this, there is a special "UNC" device (which is a symlink to "\Device\Mup") in the system logon
+    // namespace, so "\??\UNC\host\share" (or "\??\Global\UNC\host\share", or "\Global??\UNC\host\share") is equivalent
+    // to "\\host\share".
+    //
+    // NT paths are not universally accepted by Win32 applications and APIs. For example, Far supports paths starting
+    // with "\??\" and "\??\Global\" but not with "\Global??\". As of Win10 21H1, File Explorer, cmd.exe and PowerShell
+    // don't support any of these. Given this, and that NT paths have a different set of allowed characters from Win32 paths,
+    // we should normally avoid exposing NT paths to users that expect Win32 paths.
+    //
+    // In Boost.Filesystem we only deal with NT paths that come from reparse points, such as symlinks and mount points,
+    // including directory junctions. It was observed that reparse points created by junction.exe and mklink use the "\??\"
+    // prefix for directory junctions and absolute symlink and unqualified relative path for relative symlinks.
+    // Absolute paths are using drive letters for mounted drives (e.g. "\??\C:\directory"), although it is possible
+    // to create a junction to an directory using a different way of identifying the filesystem (e.g.
+    // "\??\Volume{00000000-0000-0000-0000-000000000000}\directory").
+    // mklink does not support creating junctions pointing to a UNC path. junction.exe does create a junction that
+    // uses a seemingly invalid syntax like "\??\\\host\share", i.e. it basically does not expect an UNC path. It is not known
+    // if reparse points that refer to a UNC path are considered valid.
+    // There are reparse points created as mount points for local and remote filsystems (for example, a cloud storage mounted
+    // in the local filesystem). Such mount points have the form of "\??\Volume{00000000-0000-0000-0000-000000000000}\",
+    // "\??\Harddisk0Partition1\" or "\??\HarddiskVolume1\".
+    // Reparse points that refer directly to a global namespace (through "\??\Global\" or "\Global??\" prefixes) or
+    // devices (e.g. "\Device\HarddiskVolume1") have not been observed so far.
+
+    path win32_path;
+    std::size_t pos = 0u;
+    bool global_namespace = false;
+
+    // Check for the "\??\" prefix
+    if (size >= 4u &&
+        nt_path[0] == path::preferred_separator &&
+        nt_path[1] == questionmark &&
+        nt_path[2] == questionmark &&
+        nt_path[3] == path::preferred_separator)
+    {
+        pos = 4u;
+
+        // Check "Global"
+        if ((size - pos) >= 6u &&
+            (nt_path[pos] == L'G' || nt_path[pos] == L'g') &&
+            (nt_path[pos + 1] == L'l' || nt_path[pos + 1] == L'L') &&
+            (nt_path[pos + 2] == L'o' || nt_path[pos + 2] == L'O') &&
+            (nt_path[pos + 3] == L'b' || nt_path[pos + 3] == L'B') &&
+            (nt_path[pos + 4] == L'a' || nt_path[pos + 4] == L'A') &&
+            (nt_path[pos + 5] == L'l' || nt_path[pos + 5] == L'L'))
+        {
+            if ((size - pos) == 6u)
+            {
+                pos += 6u;
+                global_namespace = true;
+            }
+            else if (detail::is_directory_separator(nt_path[pos + 6u]))
+            {
+                pos += 7u;
+                global_namespace = true;
+            }
+        }
+    }
+    // Check for the "\Global??\" prefix
+    else if (size >= 10u &&
+        nt_path[0] == path::preferred_separator &&
+        (nt_path[1] == L'G' || nt_path[1] == L'g') &&
+        (nt_path[2] == L'l' || nt_path[2] == L'L') &&
+        (nt_path[3] == L'o' || nt_path[3] == L'O') &&
+        (nt_path[4] == L'b' || nt_path[4] == L'B') &&
+        (nt_path[5] == L'a' || nt_path[5] == L'A') &&
+        (nt_path[6] == L'l' || nt_path[6] == L'L') &&
+        nt_path[7] == questionmark &&
+        nt_path[8] == questionmark &&
+        nt_path[9] == path::preferred_separator)
+    {
+        pos = 10u;
+        global_namespace = true;
+    }
+
+    if (pos > 0u)
+    {
+        if ((size - pos) >= 2u &&
+        (
+            // Check if the following is a drive letter
+            (
+                detail::is_letter(nt_path[pos]) && nt_path[pos + 1u] == colon &&
+                ((size - pos) == 2u || detail::is_directory_separator(nt_path[pos + 2u]))
+            ) ||
+            // Check for an "incorrect" syntax for UNC path junction points
+            (
+                detail::is_directory_separator(nt_path[pos]) && detail::is_directory_separator(nt_path[pos + 1u]) &&
+                ((size - pos) == 2u || !detail::is_directory_separator(nt_path[pos + 2u]))
+            )
+        ))
+        {
+            // Strip the NT path prefix
+            goto done;
+        }
+
+        static const wchar_t win32_path_prefix[4u] = { path::preferred_separator, path::preferred_separator, questionmark, path::preferred_separator };
+
+        // Check for a UNC path
+        if ((size - pos) >= 4u &&
+            (nt_path[pos] == L'U' || nt_path[pos] == L'u') &&
+            (nt_path[pos + 1] == L'N' || nt_path[pos + 1] == L'n') &&
+            (nt_path[pos + 2] == L'C' || nt_path[pos + 2] == L'c') &&
+            nt_path[pos + 3] == path::preferred_separator)
+        {
+            win32_path.assign(win32_path_prefix, win32_path_prefix + 2);
+            pos += 4u;
+            goto done;
+        }
+
+        // This is some other NT path, possibly a volume mount point. Replace the NT prefix with a Win32 filesystem prefix "\\?\".
+        win32_path.assign(win32_path_prefix, win32_path_prefix + 4);
+        if (global_namespace)
+        {
+            static const wchar_t win32_path_global_prefix[7u] = { L'G', L'l', L'o', L'b', L'a', L'l', path::preferred_separator };
+            win32_path.concat(win32_path_global_prefix, win32_path_global_prefix + 7);
+        }
+    }
+
+done:
+    win32_path.concat(nt_path + pos, nt_path + size);
+    return win32_path;
+}
+
+#endif // defined(BOOST_POSIX_API)
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+//! Directory that is being removed by the parallel remove_all() implementation
+struct removal_directory
+{
+    //! Parent directory, or \c NULL for the root directory
+    std::shared_ptr< removal_directory > parent;
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    //! Name of the directory in the parent directory, or the path of the root directory
+    path name;
+    //! Descriptor of the directory, kept open until the directory is removed, so that its subdirectories can be opened and removed relative to it
+    fd_wrapper dir;
+#else
+    //! Path of the directory
+    path name;
+#endif
+    //! One for the enumeration of the directory, plus the number of its subdirectories that have not been removed yet
+    std::atomic< std::size_t > pending;
+
+    removal_directory(std::shared_ptr< removal_directory > const& par, path const& n) :
+        parent(par),
+        name(n),
+        pending(1u)
+    {
+    }
+
+    BOOST_DELETED_FUNCTION(removal_directory(removal_directory const&))
+    BOOST_DELETED_FUNCTION(removal_directory& operator=(removal_directory const&))
+};
+
+//! Returns the full path of a directory that is being removed
+path make_removal_path(removal_directory const& dir)
+{
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    if (dir.parent)
+        return make_removal_path(*dir.parent) / dir.name;
+#endif
+    return dir.name;
+}
+
+/*!
+ * Worker of the walk scheduler that removes a directory tree. Every worker call removes the non-directory entries
+ * of one directory and schedules its subdirectories. A directory is removed by the thread that completes the last of
+ * its pending work, i.e. either its own enumeration or the removal of its last subdirectory. The root directory is not
+ * removed by the workers.
+ */
+class removal_worker
+{
+public:
+    typedef std::atomic< uintmax_t > context_type;
+    typedef std::shared_ptr< removal_directory > task_type;
+
+private:
+    std::atomic< uintmax_t >& m_count;
+
+public:
+    explicit removal_worker(std::atomic< uintmax_t >& count) BOOST_NOEXCEPT :
+        m_count(count)
+    {
+    }
+
+    BOOST_DELETED_FUNCTION(removal_worker(removal_worker const&))
+    BOOST_DELETED_FUNCTION(removal_worker& operator=(removal_worker const&))
+
+    template< typename Scheduler >
+    bool operator()(task_type& dir, Scheduler& scheduler, error_code& err, path& err_path)
+    {
+        uintmax_t count = 0u;
+        bool result;
+        try
+        {
+            result = remove_entries(dir, scheduler, count, err, err_path) && release(dir, count, err, err_path);
+        }
+        catch (std::bad_alloc&)
+        {
+            err = error_code(ENOMEM, system_category());
+            result = false;
+        }
+
+        m_count.fetch_add(count, std::memory_order_relaxed);
+        return result;
+    }
+
+private:
+    //! Removes the non-directory entries of the directory and schedules its subdirectories
+    template< typename Scheduler >
+    static bool remove_entries(task_type const& dir, Scheduler& scheduler, uintmax_t& count, error_code& err, path& err_path)
+    {
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+        const int basedir_fd = dir->parent ? dir->parent->dir.fd : AT_FDCWD;
+        dir->dir.fd = ::openat(basedir_fd, dir->name.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        if (BOOST_UNLIKELY(dir->dir.fd < 0))
+        {
+            // The directory was replaced or removed since it was enumerated, or it cannot be opened. Let the sequential
+            // implementation deal with it, including error reporting.
+            return remove_fallback(dir, count, err, err_path);
+        }
+
+        fs::detail::directory_iterator_params params;
+        params.basedir_fd = dir->dir.fd;
+        params.open_path = ".";
+        params.iterator_fd = -1;
+#endif
+
+        fs::directory_iterator itr;
+        fs::detail::directory_iterator_construct
+        (
+            itr,
+            dir->name,
+            static_cast< unsigned int >(directory_options::_detail_no_follow),
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+            &params,
+#else
+            NULL,
+#endif
+            &err
+        );
+
+#if !(defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS))
+        if (BOOST_UNLIKELY(!!err))
+        {
+            err.clear();
+            return remove_fallback(dir, count, err, err_path);
+        }
+#endif
+
+        const fs::directory_iterator end_dit;
+        while (true)
+        {
+            if (BOOST_UNLIKELY(!!err))
+            {
+                err_path = make_removal_path(*dir);
+                return false;
+            }
+
+            if (itr == end_dit)
+                break;
+
+            if (BOOST_UNLIKELY(scheduler.is_stopped()))
+                return false;
+
+            directory_entry const& entry = *itr;
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+            const path name = entry.path().filename();
+#else
+            path const& name = entry.path();
+#endif
+            fs::file_type type = fs::detail::get_cached_symlink_status(entry).type();
+            if (type == fs::status_error)
+            {
+                error_code local_ec;
+                type = fs::detail::symlink_status_impl
+                (
+                    name,
+                    &local_ec
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                    , params.iterator_fd
+#endif
+                ).type();
+            }
+
+            if (type == fs::directory_file)
+            {
+                task_type subdir(std::make_shared< removal_directory >(dir, name));
+                dir->pending.fetch_add(1u, std::memory_order_relaxed);
+                scheduler.schedule(subdir);
+            }
+            else
+            {
+                // Also handles the case when the file has been replaced with a directory since it was enumerated
+                const uintmax_t n = fs::detail::remove_all_impl
+                (
+                    name,
+                    &err
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                    , params.iterator_fd
+#endif
+#if defined(BOOST_POSIX_API)
+                    , type
+#endif
+                );
+                if (BOOST_UNLIKELY(!!err))
+                {
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                    err_path = make_removal_path(*dir) / name;
+#else
+                    err_path = name;
+#endif
+                    return false;
+                }
+
+                count += n;
+            }
+
+            fs::detail::directory_iterator_increment(itr, &err);
+        }
+
+        return true;
+    }
+
+    //! Marks a piece of pending work of the directory as complete and removes the directories that have no pending work left
+    static bool release(task_type dir, uintmax_t& count, error_code& err, path& err_path)
+    {
+        while (dir->pending.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+        {
+            // The root directory is removed by the caller, along with any entries that may have been created during the removal
+            if (!dir->parent)
+                break;
+
+            error_code local_ec;
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+            if (dir->dir.fd >= 0)
+            {
+                close_fd(dir->dir.fd);
+                dir->dir.fd = -1;
+            }
+
+            if (fs::detail::remove_impl(dir->name, fs::directory_file, &local_ec, dir->parent->dir.fd))
+#elif defined(BOOST_POSIX_API)
+            if (fs::detail::remove_impl(dir->name, fs::directory_file, &local_ec))
+#else
+            if (fs::detail::remove_impl(dir->name, &local_ec))
+#endif
+            {
+                ++count;
+            }
+            else if (BOOST_UNLIKELY(!!local_ec))
+            {
+                // New entries may have been created in the directory while it was being removed
+                if (!remove_fallback(dir, count, err, err_path))
+                    return false;
+            }
+
+            task_type parent(dir->parent);
+            dir.swap(parent);
+        }
+
+        return true;
+    }
+
+    //! Removes the directory using the sequential implementation
+    static bool remove_fallback(task_type const& dir, uintmax_t& count, error_code& err, path& err_path)
+    {
+        const uintmax_t n = fs::detail::remove_all_impl
+        (
+            dir->name,
+            &err
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+            , dir->parent ? dir->parent->dir.fd : AT_FDCWD
+#endif
+        );
+        if (BOOST_UNLIKELY(!!err))
+        {
+            err_path = make_removal_path(*dir);
+            return false;
+        }
+
+        count += n;
+        return true;
+    }
+};
+
+/*!
+ * remove_all() implementation that removes the directory tree in multiple threads. The directories of the tree are
+ * distributed between the threads by the walk scheduler, and every directory is removed after its entries.
+ */
+uintmax_t parallel_remove_all_impl(path const& p, unsigned int thread_count, error_code* ec)
+{
+    fs::file_type type;
+    {
+        error_code local_ec;
+        type = fs::detail::symlink_status_impl(p, &local_ec).type();
+        if (type == fs::file_not_found)
+            return 0u;
+
+        if (BOOST_UNLIKELY(type == fs::status_error))
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove_all", p, local_ec));
+
+            *ec = local_ec;
+            return static_cast< uintmax_t >(-1);
+        }
+    }
+
+    if (type != fs::directory_file) // including directory symlinks
+        return fs::detail::remove_all_impl(p, ec);
+
+    std::atomic< uintmax_t > count(0u);
+    {
+        parallel_walk_scheduler< removal_worker > sched(count, thread_count);
+        sched.add_root(std::make_shared< removal_directory >(std::shared_ptr< removal_directory >(), p));
+        run_in_threads(thread_count, sched);
+
+        if (BOOST_UNLIKELY(!!sched.error()))
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove_all", sched.error_path(), sched.error()));
+
+            *ec = sched.error();
+            return static_cast< uintmax_t >(-1);
+        }
+    }
+
+    // Remove the directory itself, along with any entries that may have been created while the threads were running
+    const uintmax_t n = fs::detail::remove_all_impl(p, ec);
+    if (ec && *ec)
+        return static_cast< uintmax_t >(-1);
+
+    return count.load(std::memory_order_relaxed) + n;
+}
+
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+} // unnamed namespace
+} // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                operations functions declared in operations.hpp                       //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+namespace detail {
+
+BOOST_FILESYSTEM_DECL bool possible_large_file_size_support()
+{
+#ifdef BOOST_POSIX_API
+    typedef struct stat struct_stat;
+    return sizeof(struct_stat().st_size) > 4;
+#else
+    return true;
+#endif
+}
+
+BOOST_FILESYSTEM_DECL
+path absolute(path const& p, path const& base, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    if (p.is_absolute())
+        return p;
+
+    //  recursively calling absolute is sub-optimal, but is sure and simple
+    path abs_base = base;
+    if (!base.is_absolute())
+    {
+        if (ec)
+        {
+            abs_base = absolute(base, *ec);
+            if (*ec)
+                return path();
+        }
+        else
+        {
+            abs_base = absolute(base);
+        }
+    }
+
+    if (p.empty())
+        return abs_base;
+
+    path res;
+    if (p.has_root_name())
+        res = p.root_name();
+    else
+        res = abs_base.root_name();
+
+    if (p.has_root_directory())
+    {
+        res.concat(p.root_directory());
+    }
+    else
+    {
+        res.concat(abs_base.root_directory());
+        res /= abs_base.relative_path();
+    }
+
+    path p_relative_path(p.relative_path());
+    if (!p_relative_path.empty())
+        res /= p_relative_path;
+
+    return res;
+}
+
+BOOST_FILESYSTEM_DECL
+path canonical(path const& p, path const& base, system::error_code* ec)
+{
+    BOOST_FILESYSTEM_TRACE1(canonical__entry, p.c_str());
+    BOOST_FILESYSTEM_TRACE_SCOPE(canonical);
+
+    if (ec)
+        ec->clear();
+
+    path source(p);
+    if (!p.is_absolute())
+    {
+        source = detail::absolute(p, base, ec);
+        if (ec && *ec)
+        {
+        return_empty_path:
+            return path();
+        }
+    }
+
+#if defined(BOOST_FILESYSTEM_HAS_REALPATH_ALLOC)
+    // Avoid resolving the path element by element if the OS can do it for us. Leave the implementation-defined
+    // root names (i.e. "//net") and error reporting to the generic implementation below.
+    if (!source.has_root_name())
+    {
+        char* const real_path = ::realpath(source.c_str(), NULL);
+        if (BOOST_LIKELY(real_path != NULL))
+        {
+            path result(real_path);
+            std::free(real_path);
+
+            // Preserve the trailing separator, as the generic implementation does
+            if (source.has_relative_path() && detail::is_directory_separator(source.native()[source.native().size() - 1u]) &&
+                result.has_relative_path())
+            {
+                result += path::preferred_separator;
+            }
+
+            return result;
+        }
+    }
+#endif // defined(BOOST_FILESYSTEM_HAS_REALPATH_ALLOC)
+
+    system::error_code local_ec;
+    file_status st(detail::status_impl(source, &local_ec));
+
+    if (st.type() == fs::file_not_found)
+    {
+        local_ec = system::errc::make_error_code(system::errc::no_such_file_or_directory);
+        goto fail_local_ec;
+    }
+    else if (local_ec)
+    {
+    fail_local_ec:
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::canonical", source, local_ec));
+
+        *ec = local_ec;
+        goto return_empty_path;
+    }
+
+    path root(source.root_path());
+    path const& dot_p = dot_path();
+    path const& dot_dot_p = dot_dot_path();
+    unsigned int symlinks_allowed = symloop_max;
+    path result;
+    while (true)
+    {
+        for (path::iterator itr(source.begin()), end(source.end()); itr != end; ++itr)
+        {
+            if (*itr == dot_p)
+                continue;
+            if (*itr == dot_dot_p)
+            {
+                if (result != root)
+                    result.remove_filename();
+                continue;
+            }
+
+            if (itr->size() == 1u && detail::is_directory_separator(itr->native()[0]))
+            {
+                // Convert generic separator returned by the iterator for the root directory to
+                // the preferred separator. This is important on Windows, as in some cases,
+                // like paths for network shares and cloud storage mount points GetFileAttributesW
+                // will return "file not found" if the path contains forward slashes.
+                result += path::preferred_separator;
+                // We don't need to check for a symlink after adding a separator.
+                continue;
+            }
+
+            result /= *itr;
+
+            // If we don't have an absolute path yet then don't check symlink status.
+            // This avoids checking "C:" which is "the current directory on drive C"
+            // and hence not what we want to check/resolve here.
+            if (!result.is_absolute())
+                continue;
+
+            st = detail::symlink_status_impl(result, ec);
+            if (ec && *ec)
+                goto return_empty_path;
+
+            if (is_symlink(st))
+            {
+                if (symlinks_allowed == 0)
+                {
+                    local_ec = system::errc::make_error_code(system::errc::too_many_symbolic_link_levels);
+                    goto fail_local_ec;
+                }
+
+                --symlinks_allowed;
+
+                path link(detail::read_symlink(result, ec));
+                if (ec && *ec)
+                    goto return_empty_path;
+                result.remove_filename();
+
+                if (link.is_absolute())
+                {
+                    for (++itr; itr != end; ++itr)
+                    {
+                        if (*itr != dot_p)
+                            link /= *itr;
+                    }
+                    source = link;
+                    root = source.root_path();
+                }
+                else // link is relative
+                {
+                    link.remove_trailing_separator();
+                    if (link == dot_p)
+                        continue;
+
+                    path new_source(result);
+                    new_source /= link;
+                    for (++itr; itr != end; ++itr)
+                    {
+                        if (*itr != dot_p)
+                            new_source /= *itr;
+                    }
+                    source = new_source;
+                }
+
+                // symlink causes scan to be restarted
+                goto restart_scan;
+            }
+        }
+
+        break;
+
+    restart_scan:
+        result.clear();
+    }
+
+    BOOST_ASSERT_MSG(result.is_absolute(), "canonical() implementation error; please report");
+    return result;
+}
+
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) && defined(O_DIRECTORY)
+
+namespace {
+
+//! Copies the contents of a directory recursively, relative to open directories. Defined below.
+void copy_directory_contents_at
+(
+    path const& from,
+    path const& to,
+    int from_basedir_fd,
+    const char* from_name,
+    int to_basedir_fd,
+    const char* to_name,
+    unsigned int options,
+    copy_progress_callback* progress,
+    void* progress_context,
+    error_code* ec
+);
+
+} // namespace
+
+#endif // defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) && defined(O_DIRECTORY)
+
+BOOST_FILESYSTEM_DECL
+void copy(path const& from, path const& to, unsigned int options, system::error_code* ec)
+{
+    detail::copy(from, to, options, NULL, NULL, ec);
+}
+
+BOOST_FILESYSTEM_DECL
+void copy(path const& from, path const& to, unsigned int options, copy_progress_callback* progress, void* progress_context, system::error_code* ec)
+{
+    BOOST_ASSERT((((options & static_cast< unsigned int >(copy_options::overwrite_existing)) != 0u) +
+        ((options & static_cast< unsigned int >(copy_options::skip_existing)) != 0u) +
+        ((options & static_cast< unsigned int >(copy_options::update_existing)) != 0u)) <= 1);
+
+    BOOST_ASSERT((((options & static_cast< unsigned int >(copy_options::copy_symlinks)) != 0u) +
+        ((options & static_cast< unsigned int >(copy_options::skip_symlinks)) != 0u)) <= 1);
+
+    BOOST_ASSERT((((options & static_cast< unsigned int >(copy_options::directories_only)) != 0u) +
+        ((options & static_cast< unsigned int >(copy_options::create_symlinks)) != 0u) +
+        ((options & static_cast< unsigned int >(copy_options::create_hard_links)) != 0u)) <= 1);
+
+    if (ec)
+        ec->clear();
+
+    file_status from_stat;
+    if ((options & (static_cast< unsigned int >(copy_options::copy_symlinks) |
+        static_cast< unsigned int >(copy_options::skip_symlinks) |
+        static_cast< unsigned int >(copy_options::create_symlinks))) != 0u)
+    {
+        from_stat = detail::symlink_status_impl(from, ec);
+    }
+    else
+    {
+        from_stat = detail::status_impl(from, ec);
+    }
+
+    if (ec && *ec)
+        return;
+
+    if (!exists(from_stat))
+    {
+        emit_error(BOOST_ERROR_FILE_NOT_FOUND, from, to, ec, "boost::filesystem::copy");
+        return;
+    }
+
+    if (is_symlink(from_stat))
+    {
+        if ((options & static_cast< unsigned int >(copy_options::skip_symlinks)) != 0u)
+            return;
+
+        if ((options & static_cast< unsigned int >(copy_options::copy_symlinks)) == 0u)
+            goto fail;
+
+        detail::copy_symlink(from, to, ec);
+    }
+    else if (is_regular_file(from_stat))
+    {
+        if ((options & static_cast< unsigned int >(copy_options::directories_only)) != 0u)
+            return;
+
+        if ((options & static_cast< unsigned int >(copy_options::create_symlinks)) != 0u)
+        {
+            const path* pfrom = &from;
+            path relative_from;
+            if (!from.is_absolute())
+            {
+                // Try to generate a relative path from the target location to the original file
+                path cur_dir = detail::current_path(ec);
+                if (ec && *ec)
+                    return;
+                path abs_from = detail::absolute(from.parent_path(), cur_dir, ec);
+                if (ec && *ec)
+                    return;
+                path abs_to = to.parent_path();
+                if (!abs_to.is_absolute())
+                {
+                    abs_to = detail::absolute(abs_to, cur_dir, ec);
+                    if (ec && *ec)
+                        return;
+                }
+                relative_from = detail::relative(abs_from, abs_to, ec);
+                if (ec && *ec)
+                    return;
+                if (relative_from != dot_path())
+                    relative_from /= from.filename();
+                else
+                    relative_from = from.filename();
+                pfrom = &relative_from;
+            }
+            detail::create_symlink(*pfrom, to, ec);
+            return;
+        }
+
+        if ((options & static_cast< unsigned int >(copy_options::create_hard_links)) != 0u)
+        {
+            detail::create_hard_link(from, to, ec);
+            return;
+        }
+
+        error_code local_ec;
+        file_status to_stat;
+        if ((options & (static_cast< unsigned int >(copy_options::skip_symlinks) |
+            static_cast< unsigned int >(copy_options::create_symlinks))) != 0u)
+        {
+            to_stat = detail::symlink_status_impl(to, &local_ec);
+        }
+        else
+        {
+            to_stat = detail::status_impl(to, &local_ec);
+        }
+
+        // Note: local_ec may be set by (symlink_)status() even in some non-fatal situations, e.g. when the file does not exist.
+        //       OTOH, when it returns status_error, then a real error have happened and it must have set local_ec.
+        if (to_stat.type() == fs::status_error)
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::copy", from, to, local_ec));
+            *ec = local_ec;
+            return;
+        }
+
+        if (is_directory(to_stat))
+            detail::copy_file(from, to / from.filename(), options, NULL, progress, progress_context, ec);
+        else
+            detail::copy_file(from, to, options, NULL, progress, progress_context, ec);
+    }
+    else if (is_directory(from_stat))
+    {
+        error_code local_ec;
+        if ((options & static_cast< unsigned int >(copy_options::create_symlinks)) != 0u)
+        {
+            local_ec = make_error_code(system::errc::is_a_directory);
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::copy", from, to, local_ec));
+            *ec = local_ec;
+            return;
+        }
+
+        file_status to_stat;
+        if ((options & (static_cast< unsigned int >(copy_options::skip_symlinks) |
+            static_cast< unsigned int >(copy_options::create_symlinks))) != 0u)
+        {
+            to_stat = detail::symlink_status_impl(to, &local_ec);
+        }
+        else
+        {
+            to_stat = detail::status_impl(to, &local_ec);
+        }
+
+        // Note: ec may be set by (symlink_)status() even in some non-fatal situations, e.g. when the file does not exist.
+        //       OTOH, when it returns status_error, then a real error have happened and it must have set local_ec.
+        if (to_stat.type() == fs::status_error)
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::copy", from, to, local_ec));
+            *ec = local_ec;
+            return;
+        }
+
+        if (!exists(to_stat))
+        {
+            detail::create_directory(to, &from, ec);
+            if (ec && *ec)
+                return;
+        }
+
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) && defined(O_DIRECTORY)
+        if ((options & static_cast< unsigned int >(copy_options::recursive)) != 0u)
+        {
+            copy_directory_contents_at(from, to, AT_FDCWD, from.c_str(), AT_FDCWD, to.c_str(), options, progress, progress_context, ec);
+            return;
+        }
+#endif // defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) && defined(O_DIRECTORY)
+
+        if ((options & static_cast< unsigned int >(copy_options::recursive)) != 0u || options == 0u)
+        {
+            fs::directory_iterator itr;
+            detail::directory_iterator_construct(itr, from, static_cast< unsigned int >(directory_options::none), NULL, ec);
+            if (ec && *ec)
+                return;
+
+            const fs::directory_iterator end_dit;
+            while (itr != end_dit)
+            {
+                path const& p = itr->path();
+                // Set _detail_recursing flag so that we don't recurse more than for one level deeper into the directory if options are copy_options::none
+                detail::copy(p, to / p.filename(), options | static_cast< unsigned int >(copy_options::_detail_recursing), progress, progress_context, ec);
+                if (ec && *ec)
+                    return;
+
+                detail::directory_iterator_increment(itr, ec);
+                if (ec && *ec)
+                    return;
+            }
+        }
+    }
+    else
+    {
+    fail:
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, from, to, ec, "boost::filesystem::copy");
+    }
+}
+
+//! Provides access to sync_group internals
+struct sync_group_access
+{
+#if defined(BOOST_POSIX_API)
+    //! Adds an open file to the group. Returns 0 on success or an error code.
+    static int add(sync_group& group, int fd, path const& p);
+#else
+    //! Adds a file to the group. Returns 0 on success or an error code.
+    static DWORD add(sync_group& group, path const& p);
+#endif
+};
+
+#if defined(BOOST_WINDOWS_API)
+namespace {
+
+//! Copies the owner and group of the source file to the target file. Returns 0 on success or an error code.
+DWORD copy_file_owner(HANDLE from_handle, HANDLE to_handle)
+{
+#if !defined(UNDER_CE)
+    NtQuerySecurityObject_t* nt_query_security_object = filesystem::detail::atomic_load_relaxed(nt_query_security_object_api);
+    NtSetSecurityObject_t* nt_set_security_object = filesystem::detail::atomic_load_relaxed(nt_set_security_object_api);
+    if (BOOST_UNLIKELY(!nt_query_security_object || !nt_set_security_object))
+        return ERROR_NOT_SUPPORTED;
+
+    const SECURITY_INFORMATION info = OWNER_SECURITY_INFORMATION | GROUP_SECURITY_INFORMATION;
+    std::vector< unsigned char > descriptor;
+    try
+    {
+        // The descriptor only contains the owner and group SIDs, so it is small
+        ULONG size = 256u;
+        while (true)
+        {
+            descriptor.resize(size);
+            boost::winapi::NTSTATUS_ status = nt_query_security_object(from_handle, info, &descriptor[0], static_cast< ULONG >(descriptor.size()), &size);
+            if (NT_SUCCESS(status))
+                break;
+
+            if (status != STATUS_BUFFER_TOO_SMALL || size <= descriptor.size())
+                return translate_ntstatus(status);
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        return ERROR_OUTOFMEMORY;
+    }
+
+    // Note: Setting an owner other than the current user requires SeRestorePrivilege, the error is reported otherwise
+    boost::winapi::NTSTATUS_ status = nt_set_security_object(to_handle, info, &descriptor[0]);
+    if (BOOST_UNLIKELY(!NT_SUCCESS(status)))
+        return translate_ntstatus(status);
+
+    return 0u;
+#else // !defined(UNDER_CE)
+    (void)from_handle;
+    (void)to_handle;
+    return ERROR_NOT_SUPPORTED;
+#endif // !defined(UNDER_CE)
+}
+
+/*!
+ * Applies the metadata requested by \a options to the copied file. Returns 0 on success or an error code.
+ *
+ * Note: The system copy functions already copy the alternate data streams and extended attributes, which are the equivalent
+ *       of extended attributes on Windows, and the last write time, so only the last access time and the owner need to be set.
+ */
+DWORD copy_file_metadata(path const& from, path const& to, unsigned int options)
+{
+    if ((options & (static_cast< unsigned int >(copy_options::preserve_times) | static_cast< unsigned int >(copy_options::preserve_owner))) == 0u)
+        return 0u;
+
+    DWORD from_access = 0u, to_access = 0u;
+    if ((options & static_cast< unsigned int >(copy_options::preserve_times)) != 0u)
+    {
+        from_access |= FILE_READ_ATTRIBUTES;
+        to_access |= FILE_WRITE_ATTRIBUTES;
+    }
+    if ((options & static_cast< unsigned int >(copy_options::preserve_owner)) != 0u)
+    {
+        from_access |= READ_CONTROL;
+        to_access |= WRITE_OWNER;
+    }
+
+    handle_wrapper hw_from, hw_to;
+    hw_from.handle = create_file_handle(from.c_str(), from_access, FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS);
+    if (BOOST_UNLIKELY(hw_from.handle == INVALID_HANDLE_VALUE))
+        return ::GetLastError();
+
+    hw_to.handle = create_file_handle(to.c_str(), to_access, FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS);
+    if (BOOST_UNLIKELY(hw_to.handle == INVALID_HANDLE_VALUE))
+        return ::GetLastError();
+
+    if ((options & static_cast< unsigned int >(copy_options::preserve_owner)) != 0u)
+    {
+        DWORD err = copy_file_owner(hw_from.handle, hw_to.handle);
+        if (BOOST_UNLIKELY(err != 0u))
+            return err;
+    }
+
+    if ((options & static_cast< unsigned int >(copy_options::preserve_times)) != 0u)
+    {
+        FILETIME last_access_time, last_write_time;
+        if (BOOST_UNLIKELY(!::GetFileTime(hw_from.handle, NULL, &last_access_time, &last_write_time)))
+            return ::GetLastError();
+
+        if (BOOST_UNLIKELY(!::SetFileTime(hw_to.handle, NULL, &last_access_time, &last_write_time)))
+            return ::GetLastError();
+    }
+
+    return 0u;
+}
+
+//! Applies the requested metadata to the copied file and adds it to the sync group, if one is used. Returns \c true on success.
+inline bool finish_copied_file(sync_group* group, path const& from, path const& to, unsigned int options, error_code* ec)
+{
+    DWORD err = copy_file_metadata(from, to, options);
+    if (BOOST_UNLIKELY(err != 0u))
+    {
+        emit_error(err, from, to, ec, "boost::filesystem::copy_file");
+        return false;
+    }
+
+    if (group)
+    {
+        err = sync_group_access::add(*group, to);
+        if (BOOST_UNLIKELY(err != 0u))
+        {
+            emit_error(err, from, to, ec, "boost::filesystem::copy_file");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+#endif // defined(BOOST_WINDOWS_API)
+
+namespace {
+
+#if defined(BOOST_POSIX_API)
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+//! Locations of the source and target files relative to open directories, used by copy_file_impl instead of the full paths
+struct copy_file_at_params
+{
+    //! File descriptor of the directory of the source file
+    int from_dirfd;
+    //! Name of the source file, relative to \c from_dirfd
+    const char* from_name;
+    //! File descriptor of the directory of the target file
+    int to_dirfd;
+    //! Name of the target file, relative to \c to_dirfd
+    const char* to_name;
+};
+#endif // defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+
+//! Opens a file relative to a directory. If *at APIs are not supported, \a dirfd is ignored.
+inline int open_at(int dirfd, const char* name, int flags, mode_t mode = 0)
+{
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    return ::openat(dirfd, name, flags, mode);
+#else
+    (void)dirfd;
+    return ::open(name, flags, mode);
+#endif
+}
+
+//! Removes a file relative to a directory. If *at APIs are not supported, \a dirfd is ignored.
+inline int unlink_at(int dirfd, const char* name)
+{
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    return ::unlinkat(dirfd, name, 0);
+#else
+    (void)dirfd;
+    return ::unlink(name);
+#endif
+}
+
+#if defined(BOOST_FILESYSTEM_HAS_XATTR)
+
+//! Lists the names of the extended attributes of the open file, as a sequence of null-terminated strings
+inline ssize_t list_xattrs(int fd, char* names, std::size_t size) BOOST_NOEXCEPT
+{
+#if defined(BOOST_FILESYSTEM_HAS_DARWIN_XATTR)
+    return ::flistxattr(fd, names, size, 0);
+#else
+    return ::flistxattr(fd, names, size);
+#endif
+}
+
+//! Reads the value of the extended attribute of the open file
+inline ssize_t get_xattr(int fd, const char* name, void* value, std::size_t size) BOOST_NOEXCEPT
+{
+#if defined(BOOST_FILESYSTEM_HAS_DARWIN_XATTR)
+    return ::fgetxattr(fd, name, value, size, 0u, 0);
+#else
+    return ::fgetxattr(fd, name, value, size);
+#endif
+}
+
+//! Sets the value of the extended attribute of the open file
+inline int set_xattr(int fd, const char* name, const void* value, std::size_t size) BOOST_NOEXCEPT
+{
+#if defined(BOOST_FILESYSTEM_HAS_DARWIN_XATTR)
+    return ::fsetxattr(fd, name, value, size, 0u, 0);
+#else
+    return ::fsetxattr(fd, name, value, size, 0);
+#endif
+}
+
+/*!
+ * Copies the extended attributes of \a infile to \a outfile, which includes POSIX ACLs on Linux. The attributes that the process
+ * is not permitted to set, e.g. in the \c trusted and \c security namespaces without privileges, are skipped. Returns 0 on success
+ * or an error code.
+ */
+int copy_file_xattrs(int infile, int outfile)
+{
+    std::vector< char > names, value;
+    try
+    {
+        // The list of attributes may change between the calls, retry until the buffer is large enough
+        ssize_t names_size;
+        while (true)
+        {
+            names_size = list_xattrs(infile, NULL, 0u);
+            if (names_size < 0)
+            {
+                const int err = errno;
+                // The source filesystem does not support extended attributes, so there is nothing to copy
+                if (err == ENOTSUP || err == EOPNOTSUPP)
+                    return 0;
+                return err;
+            }
+
+            if (names_size == 0)
+                return 0;
+
+            names.resize(static_cast< std::size_t >(names_size));
+            names_size = list_xattrs(infile, &names[0], names.size());
+            if (BOOST_LIKELY(names_size >= 0))
+                break;
+
+            const int err = errno;
+            if (err != ERANGE)
+                return err;
+        }
+
+        for (std::size_t pos = 0u; pos < static_cast< std::size_t >(names_size);)
+        {
+            const char* const name = &names[pos];
+            pos += std::strlen(name) + 1u;
+
+            ssize_t value_size;
+            while (true)
+            {
+                value_size = get_xattr(infile, name, NULL, 0u);
+                if (value_size > 0)
+                {
+                    value.resize(static_cast< std::size_t >(value_size));
+                    value_size = get_xattr(infile, name, &value[0], value.size());
+                }
+
+                if (BOOST_LIKELY(value_size >= 0))
+                    break;
+
+                const int err = errno;
+                // The attribute was removed after listing
+#if defined(BOOST_FILESYSTEM_HAS_DARWIN_XATTR)
+                if (err == ENOATTR)
+#else
+                if (err == ENODATA)
+#endif
+                    goto next_attribute;
+                if (err != ERANGE)
+                    return err;
+            }
+
+            if (BOOST_UNLIKELY(set_xattr(outfile, name, value_size > 0 ? &value[0] : NULL, static_cast< std::size_t >(value_size)) != 0))
+            {
+                const int err = errno;
+                if (err != EPERM && err != EACCES)
+                    return err;
+            }
+
+        next_attribute:;
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        return ENOMEM;
+    }
+
+    return 0;
+}
+
+#endif // defined(BOOST_FILESYSTEM_HAS_XATTR)
+
+#endif // defined(BOOST_POSIX_API)
+
+#if !defined(BOOST_FILESYSTEM_USE_IO_URING_COPY)
+//! Copies data of multiple files concurrently. Only defined if io_uring is supported.
+class io_uring_copy_engine;
+#endif
+
+//! copy_file implementation. If \a hasher is not \c NULL, the copied data is hashed and, if \a target_state is not \c NULL, the target file is verified.
+//! If \a data_engine is not \c NULL, the file data may be copied by the engine after the function returns.
+//! If \a at_params is not \c NULL, the files are opened relative to the given directories, and \a from and \a to are only used for error reporting
+//! and progress notification.
+bool copy_file_impl
+(
+    path const& from,
+    path const& to,
+    unsigned int options,
+    sync_group* group,
+    copy_progress_callback* progress,
+    void* progress_context,
+    copy_file_hasher const* hasher,
+    void* source_state,
+    void* target_state,
+    io_uring_copy_engine* data_engine,
+    error_code* ec
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    , copy_file_at_params const* at_params = NULL
+#endif
+)
+{
+    BOOST_FILESYSTEM_TRACE3(copy_file__entry, from.c_str(), to.c_str(), options);
+    BOOST_FILESYSTEM_TRACE_SCOPE(copy_file);
+
+    BOOST_ASSERT((((options & static_cast< unsigned int >(copy_options::overwrite_existing)) != 0u) +
+        ((options & static_cast< unsigned int >(copy_options::skip_existing)) != 0u) +
+        ((options & static_cast< unsigned int >(copy_options::update_existing)) != 0u)) <= 1);
+
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_POSIX_API)
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    const int from_dirfd = at_params ? at_params->from_dirfd : AT_FDCWD;
+    const char* const from_name = at_params ? at_params->from_name : from.c_str();
+    const int to_dirfd = at_params ? at_params->to_dirfd : AT_FDCWD;
+    const char* const to_name = at_params ? at_params->to_name : to.c_str();
+#else
+    const int from_dirfd = -1, to_dirfd = -1;
+    const char* const from_name = from.c_str();
+    const char* const to_name = to.c_str();
+#endif
+
+    int err = 0;
+
+    // Note: Declare fd_wrappers here so that errno is not clobbered by close() that may be called in fd_wrapper destructors
+    fd_wrapper infile, outfile;
+    unsigned int clone_options = options & (static_cast< unsigned int >(copy_options::clone_if_possible) | static_cast< unsigned int >(copy_options::clone_required));
+    bool cloned = false;
+    // Indicates that the target file was created by this call
+    bool created = false;
+
+    if (hasher)
+    {
+        // Cloned data does not pass through the user-space buffer, so it cannot be hashed
+        if (BOOST_UNLIKELY((clone_options & static_cast< unsigned int >(copy_options::clone_required)) != 0u))
+        {
+            emit_error(EINVAL, from, to, ec, "boost::filesystem::copy_file");
+            return false;
+        }
+
+        clone_options = 0u;
+    }
+
+    // Delta copying only applies when an existing target file is replaced
+    const bool delta = (options & static_cast< unsigned int >(copy_options::delta)) != 0u &&
+        (options & (static_cast< unsigned int >(copy_options::overwrite_existing) | static_cast< unsigned int >(copy_options::update_existing))) != 0u;
+    if (BOOST_UNLIKELY(delta && hasher != NULL))
+    {
+        // The unchanged data is not written, so the target file cannot be verified against the copied data
+        emit_error(EINVAL, from, to, ec, "boost::filesystem::copy_file");
+        return false;
+    }
+
+#if !defined(BOOST_FILESYSTEM_HAS_XATTR)
+    if (BOOST_UNLIKELY((options & static_cast< unsigned int >(copy_options::preserve_xattrs)) != 0u))
+    {
+        emit_error(ENOTSUP, from, to, ec, "boost::filesystem::copy_file");
+        return false;
+    }
+#endif
+
+    while (true)
+    {
+        infile.fd = open_at(from_dirfd, from_name, O_RDONLY | O_CLOEXEC);
+        if (BOOST_UNLIKELY(infile.fd < 0))
+        {
+            err = errno;
+            if (err == EINTR)
+                continue;
+
+        fail:
+            emit_error(err, from, to, ec, "boost::filesystem::copy_file");
+            return false;
+        }
+
+        break;
+    }
+
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    unsigned int statx_data_mask = STATX_TYPE | STATX_MODE | STATX_INO | STATX_SIZE;
+    if ((options & static_cast< unsigned int >(copy_options::update_existing)) != 0u)
+        statx_data_mask |= STATX_MTIME;
+    if ((options & static_cast< unsigned int >(copy_options::preserve_times)) != 0u)
+        statx_data_mask |= STATX_ATIME | STATX_MTIME;
+    if ((options & static_cast< unsigned int >(copy_options::preserve_owner)) != 0u)
+        statx_data_mask |= STATX_UID | STATX_GID;
+
+    // The number of allocated blocks is only used as a hint, don't require it
+    unsigned int statx_query_mask = statx_data_mask;
+    if ((options & static_cast< unsigned int >(copy_options::preserve_sparse)) != 0u)
+        statx_query_mask |= STATX_BLOCKS;
+
+    struct ::statx from_stat;
+    if (BOOST_UNLIKELY(invoke_statx(infile.fd, "", AT_EMPTY_PATH | AT_NO_AUTOMOUNT, statx_query_mask, &from_stat) < 0))
+    {
+    fail_errno:
+        err = errno;
+        goto fail;
+    }
+
+    if (BOOST_UNLIKELY((from_stat.stx_mask & statx_data_mask) != statx_data_mask))
+    {
+        err = ENOSYS;
+        goto fail;
+    }
+#else
+    struct ::stat from_stat;
+    if (BOOST_UNLIKELY(::fstat(infile.fd, &from_stat) != 0))
+    {
+    fail_errno:
+        err = errno;
+        goto fail;
+    }
+#endif
+
+    const mode_t from_mode = get_mode(from_stat);
+    if (BOOST_UNLIKELY(!S_ISREG(from_mode)))
+    {
+        err = ENOSYS;
+        goto fail;
+    }
+
+    mode_t to_mode = from_mode;
+#if !defined(BOOST_FILESYSTEM_USE_WASI)
+    // Enable writing for the newly created files. Having write permission set is important e.g. for NFS,
+    // which checks the file permission on the server, even if the client's file descriptor supports writing.
+    to_mode |= S_IWUSR;
+#endif
+    // The existing target file is read to compare its data with the source file in delta mode
+    int oflag = (delta ? O_RDWR : O_WRONLY) | O_CLOEXEC;
+
+    if ((options & static_cast< unsigned int >(copy_options::update_existing)) != 0u || delta)
+    {
+        // Try opening the existing file without truncation to test the modification time or compare the data later
+        while (true)
+        {
+            outfile.fd = open_at(to_dirfd, to_name, oflag, to_mode);
+            if (outfile.fd < 0)
+            {
+                err = errno;
+                if (err == EINTR)
+                    continue;
+
+                if (err == ENOENT)
+                    goto create_outfile;
+
+                goto fail;
+            }
+
+            break;
+        }
+    }
+    else
+    {
+    create_outfile:
+        oflag |= O_CREAT | O_TRUNC;
+        if (((options & static_cast< unsigned int >(copy_options::overwrite_existing)) == 0u ||
+             (options & static_cast< unsigned int >(copy_options::skip_existing)) != 0u) &&
+            (options & static_cast< unsigned int >(copy_options::update_existing)) == 0u)
+        {
+            oflag |= O_EXCL;
+        }
+
+#if defined(BOOST_FILESYSTEM_HAS_FCLONEFILEAT)
+        if (clone_options != 0u)
+        {
+            // fclonefileat creates the target file, so it can only be used if the file does not exist
+            if (::fclonefileat(infile.fd, to_dirfd, to_name, 0) == 0)
+            {
+                cloned = true;
+            }
+            else
+            {
+                err = errno;
+                if (err == EEXIST)
+                {
+                    if ((options & static_cast< unsigned int >(copy_options::skip_existing)) != 0u)
+                        return false;
+                    // Let the code below report the error if overwriting is not allowed
+                }
+                else if (!is_clone_not_supported_error(err))
+                {
+                    goto fail;
+                }
+            }
+        }
+#endif // defined(BOOST_FILESYSTEM_HAS_FCLONEFILEAT)
+
+        int open_flags = oflag;
+        bool probe_existing = false;
+        if (cloned)
+        {
+            open_flags = O_WRONLY | O_CLOEXEC;
+        }
+        else if ((clone_options & static_cast< unsigned int >(copy_options::clone_required)) != 0u)
+        {
+            // Don't destroy the existing target file contents if cloning fails. Create the file exclusively first,
+            // so that it is known whether the file has to be removed if cloning fails.
+            open_flags = (open_flags & ~O_TRUNC) | O_EXCL;
+            probe_existing = (oflag & O_EXCL) == 0;
+        }
+
+        while (true)
+        {
+            outfile.fd = open_at(to_dirfd, to_name, open_flags, to_mode);
+            if (outfile.fd < 0)
+            {
+                err = errno;
+                if (err == EINTR)
+                    continue;
+
+                if (probe_existing)
+                {
+                    if (err == EEXIST)
+                    {
+                        // Overwriting is allowed, open the existing file
+                        open_flags &= ~(O_CREAT | O_EXCL);
+                        continue;
+                    }
+
+                    if (err == ENOENT && (open_flags & O_CREAT) == 0)
+                    {
+                        // The existing file was removed concurrently
+                        open_flags |= O_CREAT | O_EXCL;
+                        continue;
+                    }
+                }
+
+                if (err == EEXIST && (options & static_cast< unsigned int >(copy_options::skip_existing)) != 0u)
+                    return false;
+
+                goto fail;
+            }
+
+            created = (open_flags & O_EXCL) != 0;
+            break;
+        }
+    }
+
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    statx_data_mask = STATX_TYPE | STATX_MODE | STATX_INO;
+    if ((oflag & O_TRUNC) == 0)
+    {
+        // O_TRUNC is not set if copy_options::update_existing or copy_options::delta is set and an existing file was opened.
+        if ((options & static_cast< unsigned int >(copy_options::update_existing)) != 0u)
+            statx_data_mask |= STATX_MTIME;
+        if (delta)
+            statx_data_mask |= STATX_SIZE;
+    }
+
+    struct ::statx to_stat;
+    if (BOOST_UNLIKELY(invoke_statx(outfile.fd, "", AT_EMPTY_PATH | AT_NO_AUTOMOUNT, statx_data_mask, &to_stat) < 0))
+        goto fail_errno;
+
+    if (BOOST_UNLIKELY((to_stat.stx_mask & statx_data_mask) != statx_data_mask))
+    {
+        err = ENOSYS;
+        goto fail;
+    }
+#else
+    struct ::stat to_stat;
+    if (BOOST_UNLIKELY(::fstat(outfile.fd, &to_stat) != 0))
+        goto fail_errno;
+#endif
+
+    to_mode = get_mode(to_stat);
+    if (BOOST_UNLIKELY(!S_ISREG(to_mode)))
+    {
+        err = ENOSYS;
+        goto fail;
+    }
+
+    if (BOOST_UNLIKELY(detail::equivalent_stat(from_stat, to_stat)))
+    {
+        err = EEXIST;
+        goto fail;
+    }
+
+    // O_TRUNC is not set if copy_options::update_existing or copy_options::delta is set and an existing file was opened
+    const bool delta_existing = delta && (oflag & O_TRUNC) == 0;
+    if ((oflag & O_TRUNC) == 0)
+    {
+        if ((options & static_cast< unsigned int >(copy_options::update_existing)) != 0u)
+        {
+            // We need to check the last write times.
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+            if (from_stat.stx_mtime.tv_sec < to_stat.stx_mtime.tv_sec || (from_stat.stx_mtime.tv_sec == to_stat.stx_mtime.tv_sec && from_stat.stx_mtime.tv_nsec <= to_stat.stx_mtime.tv_nsec))
+                return false;
+#elif defined(BOOST_FILESYSTEM_STAT_ST_MTIMENSEC)
+            // Modify time is available with nanosecond precision.
+            if (from_stat.st_mtime < to_stat.st_mtime || (from_stat.st_mtime == to_stat.st_mtime && from_stat.BOOST_FILESYSTEM_STAT_ST_MTIMENSEC <= to_stat.BOOST_FILESYSTEM_STAT_ST_MTIMENSEC))
+                return false;
+#else
+            if (from_stat.st_mtime <= to_stat.st_mtime)
+                return false;
+#endif
+        }
+
+        // In delta mode, the existing data is compared with the source file instead
+        if (!delta_existing && (clone_options & static_cast< unsigned int >(copy_options::clone_required)) == 0u && BOOST_UNLIKELY(::ftruncate(outfile.fd, 0) != 0))
+            goto fail_errno;
+    }
+
+    if (!cloned && clone_options != 0u)
+    {
+        err = clone_file_data(infile.fd, outfile.fd);
+        if (BOOST_LIKELY(err == 0))
+        {
+            cloned = true;
+
+            // The target file was not truncated if cloning is required or in delta mode, and it may be larger than the source
+            if (((clone_options & static_cast< unsigned int >(copy_options::clone_required)) != 0u || delta_existing) &&
+                BOOST_UNLIKELY(::ftruncate(outfile.fd, static_cast< off_t >(get_size(from_stat))) != 0))
+            {
+                goto fail_errno;
+            }
+        }
+        else if ((clone_options & static_cast< unsigned int >(copy_options::clone_required)) != 0u)
+        {
+            if (is_clone_not_supported_error(err))
+                err = ENOTSUP;
+
+            // Remove the target file if we created it
+            if (created)
+                unlink_at(to_dirfd, to_name);
+
+            goto fail;
+        }
+    }
+
+    bool progress_reported = false;
+    // Indicates that the data will be copied by data_engine after the target file is prepared
+    bool deferred = false;
+    if (!cloned)
+    {
+        err = ENOTSUP;
+        if (delta_existing)
+            err = copy_file_data_delta(infile.fd, outfile.fd, get_size(from_stat), get_size(to_stat), get_blksize(to_stat));
+
+#if defined(BOOST_FILESYSTEM_HAS_SEEK_DATA)
+        if (err == ENOTSUP && !hasher && (options & static_cast< unsigned int >(copy_options::preserve_sparse)) != 0u && is_sparse(from_stat))
+            err = copy_file_data_sparse(infile.fd, outfile.fd, get_size(from_stat), get_blksize(to_stat));
+#endif
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        if (err == ENOTSUP && !hasher && (options & static_cast< unsigned int >(copy_options::parallel_data)) != 0u)
+            err = copy_file_data_parallel(infile.fd, outfile.fd, get_size(from_stat));
+#endif
+
+        if (err == ENOTSUP)
+        {
+            const uintmax_t size = get_size(from_stat);
+            bool extended = false;
+            if ((options & static_cast< unsigned int >(copy_options::preallocate)) != 0u && size > 0u)
+            {
+                // Prefer not to change the file size, so that the target file size reflects the amount of data actually copied
+                err = preallocate_file(outfile.fd, 0u, size, true);
+                if (err == ENOTSUP)
+                {
+                    err = preallocate_file(outfile.fd, 0u, size, false);
+                    extended = err == 0;
+                }
+
+                // Only report the errors indicating that there is not enough space for the copy, any other errors
+                // mean that the space cannot be preallocated, in which case we still try to copy the data.
+                if (BOOST_UNLIKELY(err == ENOSPC || err == EDQUOT))
+                    goto fail;
+            }
+
+            // Note: Use block size of the target file since it is most important for writing performance.
+            err = ENOTSUP;
+#if (defined(O_DIRECT) && !defined(BOOST_FILESYSTEM_USE_WASI)) || defined(F_NOCACHE)
+            if (!hasher && (options & static_cast< unsigned int >(copy_options::unbuffered)) != 0u)
+                err = copy_file_data_direct(infile.fd, outfile.fd, size, get_blksize(to_stat));
+#endif
+
+            if (err == ENOTSUP)
+            {
+                const bool drop_cache = (options & (static_cast< unsigned int >(copy_options::drop_cache) | static_cast< unsigned int >(copy_options::unbuffered))) != 0u;
+                if (hasher)
+                {
+                    // Only the read/write loop passes the data through the user-space buffer, where it can be hashed
+                    err = copy_file_data_read_write(infile.fd, outfile.fd, size, get_blksize(to_stat), drop_cache, hasher, source_state);
+                }
+                // If unbuffered I/O is not supported, at least avoid retaining the copied data in the cache
+                else if (drop_cache)
+                {
+                    err = copy_file_data_read_write(infile.fd, outfile.fd, size, get_blksize(to_stat), true);
+                }
+                else if (progress && size > 0u)
+                {
+                    err = copy_file_data_progress(infile.fd, outfile.fd, size, from, to, progress, progress_context);
+                    progress_reported = true;
+                }
+                else if ((options & static_cast< unsigned int >(copy_options::plain_data_copy)) != 0u)
+                {
+                    err = copy_file_data_read_write(infile.fd, outfile.fd, size, get_blksize(to_stat), false);
+                }
+#if defined(BOOST_FILESYSTEM_USE_IO_URING_COPY)
+                else if (data_engine && size > 0u && !extended && !target_state && (options & static_cast< unsigned int >(copy_options::preserve_times)) == 0u &&
+                    (group || (options & (static_cast< unsigned int >(copy_options::synchronize_data) | static_cast< unsigned int >(copy_options::synchronize))) == 0u))
+                {
+                    // The target file must not be truncated, synchronized or have its times updated after the data is copied
+                    deferred = true;
+                    err = 0;
+                }
+#endif
+                else if (size > 0u && size <= max_small_file_size && !filesystem::detail::atomic_load_relaxed(filesystem::detail::copy_file_backend_overridden))
+                {
+                    // Selecting a copying method for small files costs more system calls than copying the data
+                    err = copy_file_data_small(infile.fd, outfile.fd, size);
+                }
+                else
+                {
+                    err = filesystem::detail::atomic_load_relaxed(filesystem::detail::copy_file_data)(infile.fd, outfile.fd, size, get_blksize(to_stat), get_dev(from_stat), get_dev(to_stat));
+                }
+            }
+
+            if (BOOST_LIKELY(err == 0) && extended)
+            {
+                // The amount of copied data may be different from the source file size, e.g. for files with generated contents.
+                // Truncate the target file to the end of the copied data.
+                const off_t copied_size = ::lseek(outfile.fd, 0, SEEK_CUR);
+                if (BOOST_UNLIKELY(copied_size < 0 || ::ftruncate(outfile.fd, copied_size) != 0))
+                    goto fail_errno;
+            }
+        }
+
+        if (BOOST_UNLIKELY(err != 0))
+            goto fail_copy; // err already contains the error code
+    }
+
+    // Report completion if the data was copied by an implementation that does not report progress
+    if (progress && !progress_reported && !progress(from, to, get_size(from_stat), get_size(from_stat), progress_context))
+    {
+        err = ECANCELED;
+
+    fail_copy:
+        // Remove the target file if we created it and the operation was cancelled
+        if (err == ECANCELED && (oflag & O_EXCL) != 0)
+            unlink_at(to_dirfd, to_name);
+
+        goto fail;
+    }
+
+    // Apply the metadata through the open file descriptor, so that it is not applied to a different file if the target path is replaced concurrently
+    bool restore_mode = to_mode != from_mode;
+#if !defined(BOOST_FILESYSTEM_USE_WASI)
+    if ((options & static_cast< unsigned int >(copy_options::preserve_owner)) != 0u)
+    {
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+        const uid_t from_uid = from_stat.stx_uid;
+        const gid_t from_gid = from_stat.stx_gid;
+#else
+        const uid_t from_uid = from_stat.st_uid;
+        const gid_t from_gid = from_stat.st_gid;
+#endif
+        if (BOOST_UNLIKELY(::fchown(outfile.fd, from_uid, from_gid) != 0))
+            goto fail_errno;
+
+        // Changing the owner may clear the set-user-ID and set-group-ID bits, restore them below
+        if ((from_mode & (S_ISUID | S_ISGID)) != 0u)
+            restore_mode = true;
+    }
+#endif // !defined(BOOST_FILESYSTEM_USE_WASI)
+
+#if defined(BOOST_FILESYSTEM_HAS_XATTR)
+    if ((options & static_cast< unsigned int >(copy_options::preserve_xattrs)) != 0u)
+    {
+        // Note: On Linux, this also copies POSIX ACLs, which may update the mode bits of the target file
+        err = copy_file_xattrs(infile.fd, outfile.fd);
+        if (BOOST_UNLIKELY(err != 0))
+            goto fail;
+
+        restore_mode = true;
+    }
+#endif
+
+#if !defined(BOOST_FILESYSTEM_USE_WASI)
+    // If we created a new file with an explicitly added S_IWUSR permission,
+    // we may need to update its mode bits to match the source file.
+    if (restore_mode)
+    {
+        if (BOOST_UNLIKELY(::fchmod(outfile.fd, from_mode) != 0))
+            goto fail_errno;
+    }
+#else
+    (void)restore_mode;
+#endif
+
+    // The times are set last, since writing the data or other metadata updates them
+    if ((options & static_cast< unsigned int >(copy_options::preserve_times)) != 0u)
+    {
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+        struct timespec times[2];
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+        times[0].tv_sec = from_stat.stx_atime.tv_sec;
+        times[0].tv_nsec = from_stat.stx_atime.tv_nsec;
+        times[1].tv_sec = from_stat.stx_mtime.tv_sec;
+        times[1].tv_nsec = from_stat.stx_mtime.tv_nsec;
+#else
+        times[0].tv_sec = from_stat.st_atime;
+        times[1].tv_sec = from_stat.st_mtime;
+#if defined(BOOST_FILESYSTEM_HAS_STAT_ST_MTIM)
+        times[0].tv_nsec = from_stat.st_atim.tv_nsec;
+        times[1].tv_nsec = from_stat.st_mtim.tv_nsec;
+#elif defined(BOOST_FILESYSTEM_HAS_STAT_ST_MTIMESPEC)
+        times[0].tv_nsec = from_stat.st_atimespec.tv_nsec;
+        times[1].tv_nsec = from_stat.st_mtimespec.tv_nsec;
+#elif defined(BOOST_FILESYSTEM_HAS_STAT_ST_MTIMENSEC)
+        times[0].tv_nsec = from_stat.st_atimensec;
+        times[1].tv_nsec = from_stat.st_mtimensec;
+#else
+        times[0].tv_nsec = 0;
+        times[1].tv_nsec = 0;
+#endif
+#endif // defined(BOOST_FILESYSTEM_USE_STATX)
+
+        if (BOOST_UNLIKELY(::futimens(outfile.fd, times) != 0))
+            goto fail_errno;
+#else // defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+        // Without futimens, the times can only be set by path and with the precision of seconds
+        ::utimbuf buf;
+        buf.actime = from_stat.st_atime;
+        buf.modtime = from_stat.st_mtime;
+        if (BOOST_UNLIKELY(::utime(to_name, &buf) != 0))
+            goto fail_errno;
+#endif // defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    }
+
+    if (group)
+    {
+        // The file will be synchronized when the group is committed
+        err = sync_group_access::add(*group, outfile.fd, to);
+        if (BOOST_UNLIKELY(err != 0))
+            goto fail;
+    }
+    else if ((options & (static_cast< unsigned int >(copy_options::synchronize_data) | static_cast< unsigned int >(copy_options::synchronize))) != 0u)
+    {
+        if ((options & static_cast< unsigned int >(copy_options::synchronize)) != 0u)
+            err = full_sync(outfile.fd);
+        else
+            err = data_sync(outfile.fd);
+
+        if (BOOST_UNLIKELY(err != 0))
+            goto fail;
+    }
+
+#if defined(BOOST_FILESYSTEM_USE_IO_URING_COPY)
+    if (deferred)
+    {
+        // The engine closes the files after copying the data and reports the errors
+        data_engine->add(infile.fd, outfile.fd, get_size(from_stat), get_blksize(to_stat), get_dev(from_stat), get_dev(to_stat), true);
+        infile.fd = -1;
+        outfile.fd = -1;
+        return true;
+    }
+#else
+    (void)deferred;
+    (void)data_engine;
+#endif
+
+    if (target_state)
+    {
+        // If the data was synchronized, discard the cached pages so that the data is read back from the storage
+        const bool synchronized = !group && (options & (static_cast< unsigned int >(copy_options::synchronize_data) | static_cast< unsigned int >(copy_options::synchronize))) != 0u;
+        err = hash_file_data(to, get_size(from_stat), get_blksize(to_stat), synchronized, *hasher, target_state);
+        if (BOOST_UNLIKELY(err != 0))
+            goto fail;
+
+        if (BOOST_UNLIKELY(!hasher->equal(source_state, target_state)))
+        {
+            err = EIO;
+            goto fail;
+        }
+    }
+
+    // We have to explicitly close the output file descriptor in order to handle a possible error returned from it. The error may indicate
+    // a failure of a prior write operation.
+    err = close_fd(outfile.fd);
+    outfile.fd = -1;
+    if (BOOST_UNLIKELY(err < 0))
+    {
+        err = errno;
+        // EINPROGRESS is an allowed error code in future POSIX revisions, according to https://www.austingroupbugs.net/view.php?id=529#c1200.
+        if (err != EINTR && err != EINPROGRESS)
+            goto fail;
+    }
+
+    return true;
+
+#else // defined(BOOST_POSIX_API)
+
+    if (BOOST_UNLIKELY(hasher != NULL))
+    {
+        // CopyFileExW does not expose the copied data
+        emit_error(ERROR_NOT_SUPPORTED, from, to, ec, "boost::filesystem::copy_file");
+        return false;
+    }
+    (void)source_state;
+    (void)target_state;
+    (void)data_engine;
+
+    DWORD copy_flags = 0u;
+    if ((options & static_cast< unsigned int >(copy_options::overwrite_existing)) == 0u ||
+        (options & static_cast< unsigned int >(copy_options::skip_existing)) != 0u)
+    {
+        copy_flags |= COPY_FILE_FAIL_IF_EXISTS;
+    }
+
+    // Unbuffered I/O avoids polluting the system file cache with the copied data.
+    // Note: CopyFileExW already sets the target file size before copying the data, so copy_options::preallocate need not be handled.
+    if ((options & (static_cast< unsigned int >(copy_options::drop_cache) | static_cast< unsigned int >(copy_options::unbuffered))) != 0u)
+        copy_flags |= COPY_FILE_NO_BUFFERING;
+
+    if ((options & static_cast< unsigned int >(copy_options::update_existing)) != 0u)
+    {
+        // Create handle_wrappers here so that CloseHandle calls don't clobber error code returned by GetLastError
+        handle_wrapper hw_from, hw_to;
+
+        hw_from.handle = create_file_handle(from.c_str(), FILE_READ_ATTRIBUTES, FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS);
+
+        FILETIME lwt_from;
+        if (hw_from.handle == INVALID_HANDLE_VALUE)
+        {
+        fail_last_error:
+            DWORD err = ::GetLastError();
+            emit_error(err, from, to, ec, "boost::filesystem::copy_file");
+            return false;
+        }
+
+        if (!::GetFileTime(hw_from.handle, NULL, NULL, &lwt_from))
+            goto fail_last_error;
+
+        hw_to.handle = create_file_handle(to.c_str(), FILE_READ_ATTRIBUTES, FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS);
+
+        if (hw_to.handle != INVALID_HANDLE_VALUE)
+        {
+            FILETIME lwt_to;
+            if (!::GetFileTime(hw_to.handle, NULL, NULL, &lwt_to))
+                goto fail_last_error;
+
+            ULONGLONG tfrom = (static_cast< ULONGLONG >(lwt_from.dwHighDateTime) << 32) | static_cast< ULONGLONG >(lwt_from.dwLowDateTime);
+            ULONGLONG tto = (static_cast< ULONGLONG >(lwt_to.dwHighDateTime) << 32) | static_cast< ULONGLONG >(lwt_to.dwLowDateTime);
+            if (tfrom <= tto)
+                return false;
+        }
+
+        copy_flags &= ~static_cast< DWORD >(COPY_FILE_FAIL_IF_EXISTS);
+    }
+
+    struct callback_context
+    {
+        path const* from;
+        path const* to;
+        copy_progress_callback* progress;
+        void* progress_context;
+        bool flush;
+        DWORD flush_error;
+    };
+
+    struct local
+    {
+        //! Callback that is called to report progress of \c CopyFileExW
+        static DWORD WINAPI on_copy_file_progress(
+            LARGE_INTEGER total_file_size,
+            LARGE_INTEGER total_bytes_transferred,
+            LARGE_INTEGER stream_size,
+            LARGE_INTEGER stream_bytes_transferred,
+            DWORD stream_number,
+            DWORD callback_reason,
+            HANDLE from_handle,
+            HANDLE to_handle,
+            LPVOID ctx)
+        {
+            callback_context* context = static_cast< callback_context* >(ctx);
+
+            // For each stream, CopyFileExW will open a separate pair of file handles, so we need to flush each stream separately.
+            if (context->flush && stream_bytes_transferred.QuadPart == stream_size.QuadPart)
+            {
+                BOOL res = ::FlushFileBuffers(to_handle);
+                if (BOOST_UNLIKELY(!res))
+                {
+                    if (BOOST_LIKELY(context->flush_error == 0u))
+                        context->flush_error = ::GetLastError();
+                }
+            }
+
+            if (context->progress && callback_reason == CALLBACK_CHUNK_FINISHED &&
+                !context->progress(*context->from, *context->to, static_cast< uintmax_t >(total_bytes_transferred.QuadPart), static_cast< uintmax_t >(total_file_size.QuadPart), context->progress_context))
+            {
+                // CopyFileExW will fail with ERROR_REQUEST_ABORTED and remove the target file
+                return PROGRESS_CANCEL;
+            }
+
+            return PROGRESS_CONTINUE;
+        }
+
+        //! Callback that is called to report progress of \c CopyFile2
+        static copyfile2_message_action CALLBACK on_copy_file2_progress(const copyfile2_message* message, PVOID ctx)
+        {
+            callback_context* context = static_cast< callback_context* >(ctx);
+
+            if (message->Type == copyfile2_callback_stream_finished)
+            {
+                // As with CopyFileExW, each stream is written through a separate file handle
+                if (context->flush)
+                {
+                    BOOL res = ::FlushFileBuffers(message->Info.StreamFinished.hDestinationFile);
+                    if (BOOST_UNLIKELY(!res))
+                    {
+                        if (BOOST_LIKELY(context->flush_error == 0u))
+                            context->flush_error = ::GetLastError();
+                    }
+                }
+            }
+            else if (message->Type == copyfile2_callback_chunk_finished && context->progress &&
+                !context->progress(*context->from, *context->to, static_cast< uintmax_t >(message->Info.ChunkFinished.uliTotalBytesTransferred.QuadPart),
+                    static_cast< uintmax_t >(message->Info.ChunkFinished.uliTotalFileSize.QuadPart), context->progress_context))
+            {
+                // CopyFile2 will fail with ERROR_REQUEST_ABORTED and remove the target file
+                return copyfile2_progress_cancel;
+            }
+
+            return copyfile2_progress_continue;
+        }
+    };
+
+    callback_context cb_context = {};
+    cb_context.from = &from;
+    cb_context.to = &to;
+    cb_context.progress = progress;
+    cb_context.progress_context = progress_context;
+    // If a sync_group is used, the file will be synchronized when the group is committed
+    cb_context.flush = !group && (options & (static_cast< unsigned int >(copy_options::synchronize_data) | static_cast< unsigned int >(copy_options::synchronize))) != 0u;
+
+    LPPROGRESS_ROUTINE cb = NULL;
+    LPVOID cb_ctx = NULL;
+    if (cb_context.flush || progress)
+    {
+        cb = &local::on_copy_file_progress;
+        cb_ctx = &cb_context;
+    }
+
+    if ((options & static_cast< unsigned int >(copy_options::delta)) != 0u &&
+        (options & (static_cast< unsigned int >(copy_options::overwrite_existing) | static_cast< unsigned int >(copy_options::update_existing))) != 0u)
+    {
+        DWORD delta_err = copy_file_delta_by_handle(from, to, cb_context.flush, progress, progress_context);
+        if (BOOST_LIKELY(delta_err == 0u))
+            return finish_copied_file(group, from, to, options, ec);
+
+        // If the target file does not exist, copy the whole file below
+        if (delta_err != ERROR_FILE_NOT_FOUND)
+        {
+            emit_error(delta_err, from, to, ec, "boost::filesystem::copy_file");
+            return false;
+        }
+    }
+
+    if ((options & (static_cast< unsigned int >(copy_options::clone_if_possible) | static_cast< unsigned int >(copy_options::clone_required))) != 0u)
+    {
+        DWORD clone_err = copy_file_by_handle(from, to, copy_file_by_handle_clone, (copy_flags & COPY_FILE_FAIL_IF_EXISTS) != 0u, cb_context.flush, progress, progress_context);
+        if (BOOST_LIKELY(clone_err == 0u))
+            return finish_copied_file(group, from, to, options, ec);
+
+        if ((clone_err == ERROR_FILE_EXISTS || clone_err == ERROR_ALREADY_EXISTS) && (options & static_cast< unsigned int >(copy_options::skip_existing)) != 0u)
+            return false;
+
+        if ((options & static_cast< unsigned int >(copy_options::clone_required)) != 0u || clone_err == ERROR_REQUEST_ABORTED)
+        {
+            if (is_clone_not_supported_error(clone_err))
+                clone_err = ERROR_NOT_SUPPORTED;
+            emit_error(clone_err, from, to, ec, "boost::filesystem::copy_file");
+            return false;
+        }
+    }
+
+    if ((options & static_cast< unsigned int >(copy_options::preserve_sparse)) != 0u)
+    {
+        DWORD sparse_err = copy_file_by_handle(from, to, copy_file_by_handle_sparse, (copy_flags & COPY_FILE_FAIL_IF_EXISTS) != 0u, cb_context.flush, progress, progress_context);
+        if (BOOST_LIKELY(sparse_err == 0u))
+            return finish_copied_file(group, from, to, options, ec);
+
+        if ((sparse_err == ERROR_FILE_EXISTS || sparse_err == ERROR_ALREADY_EXISTS) && (options & static_cast< unsigned int >(copy_options::skip_existing)) != 0u)
+            return false;
+
+        // ERROR_NOT_SUPPORTED is returned for non-sparse files, which are copied by CopyFileExW
+        if (sparse_err != ERROR_NOT_SUPPORTED)
+        {
+            emit_error(sparse_err, from, to, ec, "boost::filesystem::copy_file");
+            return false;
+        }
+    }
+
+    DWORD err = 0u;
+    CopyFile2_t* copy_file2 = filesystem::detail::atomic_load_relaxed(copy_file2_api);
+    if (copy_file2)
+    {
+        // CopyFile2 supports more copy flags than CopyFileExW. Copy offload (ODX) and SMB server-side copy are used by the system
+        // when both files are on volumes or shares that support it.
+        copyfile2_extended_parameters params = {};
+        params.dwSize = sizeof(params);
+        params.dwCopyFlags = copy_flags;
+        if ((options & static_cast< unsigned int >(copy_options::compress_network_traffic)) != 0u)
+            params.dwCopyFlags |= COPY_FILE_REQUEST_COMPRESSED_TRAFFIC;
+        if (cb_ctx)
+        {
+            params.pProgressRoutine = &local::on_copy_file2_progress;
+            params.pvCallbackContext = cb_ctx;
+        }
+
+        HRESULT hr = copy_file2(from.c_str(), to.c_str(), &params);
+        if (hr == E_INVALIDARG && (params.dwCopyFlags & COPY_FILE_REQUEST_COMPRESSED_TRAFFIC) != 0u)
+        {
+            // Compressed traffic is not supported by older Windows versions, the compression is only a hint
+            params.dwCopyFlags &= ~static_cast< DWORD >(COPY_FILE_REQUEST_COMPRESSED_TRAFFIC);
+            hr = copy_file2(from.c_str(), to.c_str(), &params);
+        }
+
+        if (BOOST_UNLIKELY(FAILED(hr)))
+            err = HRESULT_FACILITY(hr) == FACILITY_WIN32 ? static_cast< DWORD >(HRESULT_CODE(hr)) : static_cast< DWORD >(hr);
+    }
+    else
+    {
+        BOOL cancelled = FALSE;
+        BOOL res = ::CopyFileExW(from.c_str(), to.c_str(), cb, cb_ctx, &cancelled, copy_flags);
+        if (BOOST_UNLIKELY(!res))
+            err = ::GetLastError();
+    }
+
+    if (BOOST_UNLIKELY(err != 0u))
+    {
+        if ((err == ERROR_FILE_EXISTS || err == ERROR_ALREADY_EXISTS) && (options & static_cast< unsigned int >(copy_options::skip_existing)) != 0u)
+            return false;
+
+    copy_failed:
+        emit_error(err, from, to, ec, "boost::filesystem::copy_file");
+        return false;
+    }
+
+    if (BOOST_UNLIKELY(cb_context.flush_error != 0u))
+    {
+        err = cb_context.flush_error;
+        goto copy_failed;
+    }
+
+    return finish_copied_file(group, from, to, options, ec);
+
+#endif // defined(BOOST_POSIX_API)
+}
+
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) && defined(O_DIRECTORY)
+
+//! Copies a symlink relative to open directories. Returns 0 on success, otherwise an error code.
+int copy_symlink_at(int from_dirfd, const char* from_name, int to_dirfd, const char* to_name)
+{
+    char small_buf[small_path_size];
+    boost::scoped_array< char > heap_buf;
+    char* buf = small_buf;
+    std::size_t buf_size = sizeof(small_buf);
+    while (true)
+    {
+        const ssize_t result = ::readlinkat(from_dirfd, from_name, buf, buf_size);
+        if (BOOST_UNLIKELY(result < 0))
+            return errno;
+
+        if (BOOST_LIKELY(static_cast< std::size_t >(result) < buf_size))
+        {
+            buf[result] = '\0';
+            break;
+        }
+
+        buf_size *= 2u;
+        if (BOOST_UNLIKELY(buf_size > absolute_path_max))
+            return ENAMETOOLONG;
+
+        heap_buf.reset(new char[buf_size]);
+        buf = heap_buf.get();
+    }
+
+    if (BOOST_UNLIKELY(::symlinkat(buf, to_dirfd, to_name) != 0))
+        return errno;
+
+    return 0;
+}
+
+/*!
+ * Copies the contents of the directory \a from_name, relative to \a from_basedir_fd, to the existing directory \a to_name,
+ * relative to \a to_basedir_fd, recursively. Both directories are kept open while their contents are copied, and every entry
+ * is accessed by its name relative to them, so that the full paths are not resolved for every file. \a from and \a to are
+ * the full paths of the directories, which are only used for error reporting and progress notification.
+ */
+void copy_directory_contents_at
+(
+    path const& from,
+    path const& to,
+    int from_basedir_fd,
+    const char* from_name,
+    int to_basedir_fd,
+    const char* to_name,
+    unsigned int options,
+    copy_progress_callback* progress,
+    void* progress_context,
+    error_code* ec
+)
+{
+    fd_wrapper to_dir;
+    while (true)
+    {
+        to_dir.fd = ::openat(to_basedir_fd, to_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (BOOST_UNLIKELY(to_dir.fd < 0))
+        {
+            const int err = errno;
+            if (err == EINTR)
+                continue;
+
+            emit_error(err, from, to, ec, "boost::filesystem::copy");
+            return;
+        }
+
+        break;
+    }
+
+    // Symlinks are followed, unless they are copied or skipped, same as in copy()
+    const bool follow_symlinks = (options & (static_cast< unsigned int >(copy_options::copy_symlinks) |
+        static_cast< unsigned int >(copy_options::skip_symlinks))) == 0u;
+
+    fs::detail::directory_iterator_params params;
+    params.basedir_fd = from_basedir_fd;
+    params.open_path = from_name;
+    params.iterator_fd = -1;
+
+    fs::directory_iterator itr;
+    fs::detail::directory_iterator_construct
+    (
+        itr,
+        from,
+        follow_symlinks ? static_cast< unsigned int >(directory_options::none) : static_cast< unsigned int >(directory_options::_detail_no_follow),
+        &params,
+        ec
+    );
+    if (ec && *ec)
+        return;
+
+    const fs::directory_iterator end_dit;
+    while (itr != end_dit)
+    {
+        directory_entry const& entry = *itr;
+        const path name(entry.path().filename());
+        const path to_path(to / name);
+
+        error_code local_ec;
+        const file_status from_stat = follow_symlinks ? entry.status(local_ec) : entry.symlink_status(local_ec);
+        if (BOOST_UNLIKELY(from_stat.type() == fs::status_error))
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::copy", entry.path(), to_path, local_ec));
+            *ec = local_ec;
+            return;
+        }
+
+        if (BOOST_UNLIKELY(!exists(from_stat)))
+        {
+            emit_error(BOOST_ERROR_FILE_NOT_FOUND, entry.path(), to_path, ec, "boost::filesystem::copy");
+            return;
+        }
+
+        int err = 0;
+        if (is_symlink(from_stat))
+        {
+            if ((options & static_cast< unsigned int >(copy_options::copy_symlinks)) != 0u)
+                err = copy_symlink_at(params.iterator_fd, name.c_str(), to_dir.fd, name.c_str());
+            else if ((options & static_cast< unsigned int >(copy_options::skip_symlinks)) == 0u)
+                err = BOOST_ERROR_NOT_SUPPORTED;
+        }
+        else if (is_regular_file(from_stat))
+        {
+            if ((options & static_cast< unsigned int >(copy_options::directories_only)) != 0u)
+            {
+                // Nothing to copy
+            }
+            else if ((options & static_cast< unsigned int >(copy_options::create_hard_links)) != 0u)
+            {
+                if (BOOST_UNLIKELY(::linkat(params.iterator_fd, name.c_str(), to_dir.fd, name.c_str(), 0) != 0))
+                    err = errno;
+            }
+            else
+            {
+                const file_status to_stat = (options & static_cast< unsigned int >(copy_options::skip_symlinks)) != 0u ?
+                    detail::symlink_status_impl(name, &local_ec, to_dir.fd) : detail::status_impl(name, &local_ec, to_dir.fd);
+                if (BOOST_UNLIKELY(to_stat.type() == fs::status_error))
+                {
+                    if (!ec)
+                        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::copy", entry.path(), to_path, local_ec));
+                    *ec = local_ec;
+                    return;
+                }
+
+                // Same as copy(), if the target is a directory, copy the file into it
+                path target_name(name), target_path(to_path);
+                if (is_directory(to_stat))
+                {
+                    target_name /= name;
+                    target_path /= name;
+                }
+
+                copy_file_at_params at_params = { params.iterator_fd, name.c_str(), to_dir.fd, target_name.c_str() };
+                copy_file_impl(entry.path(), target_path, options, NULL, progress, progress_context, NULL, NULL, NULL, NULL, ec, &at_params);
+                if (ec && *ec)
+                    return;
+            }
+        }
+        else if (is_directory(from_stat))
+        {
+            // Create the directory writable by the owner, so that the contents can be copied even if the source directory is not
+            // writable, and restore the permissions afterwards
+            const mode_t mode = static_cast< mode_t >(from_stat.permissions());
+            bool created = true;
+            if (::mkdirat(to_dir.fd, name.c_str(), mode | S_IRWXU) != 0)
+            {
+                err = errno;
+                if (BOOST_LIKELY(err == EEXIST))
+                    err = 0;
+                created = false;
+            }
+
+            if (err == 0)
+            {
+                copy_directory_contents_at(entry.path(), to_path, params.iterator_fd, name.c_str(), to_dir.fd, name.c_str(), options, progress, progress_context, ec);
+                if (ec && *ec)
+                    return;
+
+                if (created && (mode & S_IRWXU) != S_IRWXU && BOOST_UNLIKELY(::fchmodat(to_dir.fd, name.c_str(), mode, 0) != 0))
+                    err = errno;
+            }
+        }
+        else
+        {
+            err = BOOST_ERROR_NOT_SUPPORTED;
+        }
+
+        if (BOOST_UNLIKELY(err != 0))
+        {
+            emit_error(err, entry.path(), to_path, ec, "boost::filesystem::copy");
+            return;
+        }
+
+        fs::detail::directory_iterator_increment(itr, ec);
+        if (ec && *ec)
+            return;
+    }
+}
+
+#endif // defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) && defined(O_DIRECTORY)
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL
+bool copy_file(path const& from, path const& to, unsigned int options, error_code* ec)
+{
+    return copy_file_impl(from, to, options, NULL, NULL, NULL, NULL, NULL, NULL, NULL, ec);
+}
+
+BOOST_FILESYSTEM_DECL
+bool copy_file(path const& from, path const& to, unsigned int options, sync_group* group, copy_progress_callback* progress, void* progress_context, error_code* ec)
+{
+    return copy_file_impl(from, to, options, group, progress, progress_context, NULL, NULL, NULL, NULL, ec);
+}
+
+BOOST_FILESYSTEM_DECL
+bool copy_file(path const& from, path const& to, unsigned int options, copy_file_hasher const& hasher, void* source_state, void* target_state, error_code* ec)
+{
+    return copy_file_impl(from, to, options, NULL, NULL, NULL, &hasher, source_state, target_state, NULL, ec);
+}
+
+BOOST_FILESYSTEM_DECL
+std::size_t copy_files(copy_file_entry const* entries, std::size_t count, unsigned int options, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    // Check the targets in batches to limit the amount of memory required for the results
+    BOOST_CONSTEXPR_OR_CONST std::size_t batch_size = 256u;
+
+    const bool check_targets = (options & (static_cast< unsigned int >(copy_options::skip_existing) |
+        static_cast< unsigned int >(copy_options::overwrite_existing) | static_cast< unsigned int >(copy_options::update_existing))) ==
+        static_cast< unsigned int >(copy_options::skip_existing);
+    const bool synchronize = (options & (static_cast< unsigned int >(copy_options::synchronize_data) | static_cast< unsigned int >(copy_options::synchronize))) != 0u;
+
+    std::size_t copied_count = 0u;
+    error_code local_ec;
+    std::size_t failed_index = 0u;
+    sync_group group;
+
+    io_uring_copy_engine* data_engine = NULL;
+#if defined(BOOST_FILESYSTEM_USE_IO_URING_COPY)
+    // If io_uring is selected for copying data, overlap the data transfers of multiple files
+    io_uring_copy_engine engine;
+    if (count > 1u && filesystem::detail::atomic_load_relaxed(filesystem::detail::copy_file_data) == &check_fs_type< copy_file_data_io_uring > &&
+        engine.init(io_uring_copy_queue_depth) == 0)
+    {
+        data_engine = &engine;
+    }
+#endif
+
+    try
+    {
+        for (std::size_t pos = 0u; pos < count && !local_ec; pos += batch_size)
+        {
+            const std::size_t n = (count - pos) < batch_size ? (count - pos) : batch_size;
+
+            file_status target_statuses[batch_size];
+            if (check_targets)
+                copy_file_targets_status(entries + pos, n, target_statuses);
+
+            for (std::size_t i = 0u; i < n; ++i)
+            {
+                // copy_file would skip the existing target anyways, but only after opening the source file
+                if (check_targets && filesystem::exists(target_statuses[i]))
+                    continue;
+
+                copy_file_entry const& entry = entries[pos + i];
+#if defined(BOOST_FILESYSTEM_USE_IO_URING_COPY)
+                if (data_engine)
+                {
+                    // Stop at the first error of the data transfers in progress
+                    if (BOOST_UNLIKELY(data_engine->get_error() != 0))
+                        break;
+                    data_engine->set_next_index(pos + i);
+                }
+#endif
+                if (copy_file_impl(entry.from, entry.to, options, synchronize ? &group : static_cast< sync_group* >(NULL), NULL, NULL, NULL, NULL, NULL, data_engine, &local_ec))
+                    ++copied_count;
+
+                if (BOOST_UNLIKELY(!!local_ec))
+                {
+                    failed_index = pos + i;
+                    break;
+                }
+            }
+
+#if defined(BOOST_FILESYSTEM_USE_IO_URING_COPY)
+            if (data_engine && BOOST_UNLIKELY(data_engine->get_error() != 0))
+                break;
+#endif
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+#if defined(BOOST_FILESYSTEM_USE_IO_URING_COPY)
+        if (data_engine)
+        {
+            data_engine->cancel();
+            data_engine->drain();
+            copied_count -= data_engine->get_failed_count();
+        }
+#endif
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return copied_count;
+    }
+
+#if defined(BOOST_FILESYSTEM_USE_IO_URING_COPY)
+    if (data_engine)
+    {
+        // The files whose data transfers failed were counted as copied when the transfers started
+        data_engine->drain();
+        copied_count -= data_engine->get_failed_count();
+        if (BOOST_UNLIKELY(data_engine->get_error() != 0) && (!local_ec || data_engine->get_failed_index() < failed_index))
+        {
+            local_ec.assign(data_engine->get_error(), system::system_category());
+            failed_index = data_engine->get_failed_index();
+        }
+    }
+#endif
+
+    if (synchronize)
+    {
+        // Make the files that were copied durable, even if copying stopped because of an error
+        error_code commit_ec;
+        group.commit(commit_ec);
+        if (BOOST_UNLIKELY(!!commit_ec) && !local_ec)
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::copy_files", commit_ec));
+            *ec = commit_ec;
+            return copied_count;
+        }
+    }
+
+    if (BOOST_UNLIKELY(!!local_ec))
+    {
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::copy_files", entries[failed_index].from, entries[failed_index].to, local_ec));
+        *ec = local_ec;
+    }
+
+    return copied_count;
+}
+
+BOOST_FILESYSTEM_DECL
+uintmax_t copy_data(native_file_handle from, native_file_handle to, copy_data_range const& range, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    uintmax_t offset = range.offset;
+    uintmax_t copied = 0u;
+    const err_t err = copy_data_impl(from, to, range.offset != copy_data_range::current_position ? &offset : static_cast< uintmax_t* >(NULL), range.size, copied);
+    if (BOOST_UNLIKELY(err != 0))
+        emit_error(err, ec, "boost::filesystem::copy_data");
+
+    return copied;
+}
+
+BOOST_FILESYSTEM_DECL
+void copy_symlink(path const& existing_symlink, path const& new_symlink, system::error_code* ec)
+{
+    path p(read_symlink(existing_symlink, ec));
+    if (ec && *ec)
+        return;
+    create_symlink(p, new_symlink, ec);
+}
+
+#if defined(BOOST_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) && defined(O_DIRECTORY)
+
+namespace {
+
+//! Result of create_directories_at
+enum create_directories_at_result
+{
+    create_directories_created,  //!< The directory was created
+    create_directories_existed,  //!< The directory already existed
+    create_directories_error,    //!< An error occurred
+    create_directories_fallback  //!< The generic implementation should be used
+};
+
+/*!
+ * \brief create_directories() implementation based on *at APIs
+ *
+ * Optimistically creates the leaf directory first, as in most cases only it is missing. If that fails because
+ * some of the parent directories do not exist, walks back to the deepest existing parent and creates the missing
+ * directories relative to its file descriptor, without resolving the full path for every directory.
+ *
+ * Unusual cases, such as paths with dot or dot-dot elements and failures other than missing parent directories,
+ * are left to the generic implementation, which provides accurate error reporting.
+ *
+ * On errors, if \a failed_path is not \c NULL, it receives the path of the directory that could not be created.
+ */
+create_directories_at_result create_directories_at(path const& p, path* failed_path, error_code& ec)
+{
+    const mode_t mode = S_IRWXU | S_IRWXG | S_IRWXO;
+    if (::mkdir(p.c_str(), mode) == 0)
+        return create_directories_created;
+
+    int err = errno;
+    if (err != ENOENT)
+        return create_directories_fallback;
+
+    // Names of the missing directories, in reverse order
+    std::vector< path > missing;
+    path parent(p);
+    path const& dot_p = dot_path();
+    path const& dot_dot_p = dot_dot_path();
+    while (true)
+    {
+        path fname(parent.filename());
+        if (fname == dot_p || fname == dot_dot_p)
+            return create_directories_fallback;
+        if (!fname.empty())
+            missing.push_back(fname);
+
+        parent = parent.parent_path();
+        if (!parent.has_relative_path())
+            break;
+
+        if (::mkdir(parent.c_str(), mode) == 0)
+            break;
+
+        err = errno;
+        if (err == EEXIST)
+            break;
+        if (err != ENOENT)
+            return create_directories_fallback;
+    }
+
+    if (missing.empty())
+        return create_directories_fallback;
+
+    fd_wrapper dir;
+    int dir_fd = AT_FDCWD;
+    if (!parent.empty())
+    {
+        dir.fd = ::open(parent.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (BOOST_UNLIKELY(dir.fd < 0))
+            return create_directories_fallback;
+        dir_fd = dir.fd;
+    }
+
+    std::size_t i = missing.size() - 1u;
+    while (true)
+    {
+        const char* name = missing[i].c_str();
+        if (BOOST_UNLIKELY(::mkdirat(dir_fd, name, mode) != 0))
+        {
+            err = errno;
+            if (err != EEXIST)
+                break;
+
+            // The directory may have been created concurrently
+            if (i == 0u)
+            {
+                struct ::stat st;
+                if (::fstatat(dir_fd, name, &st, 0) == 0 && S_ISDIR(st.st_mode))
+                    return create_directories_existed;
+
+                break;
+            }
+        }
+
+        if (i == 0u)
+            return create_directories_created;
+
+        const int fd = ::openat(dir_fd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (BOOST_UNLIKELY(fd < 0))
+        {
+            err = errno;
+            break;
+        }
+
+        if (dir.fd >= 0)
+            close_fd(dir.fd);
+        dir.fd = dir_fd = fd;
+        --i;
+    }
+
+    if (failed_path)
+    {
+        *failed_path = parent;
+        for (std::size_t j = missing.size(); j > i; --j)
+            *failed_path /= missing[j - 1u];
+    }
+    ec.assign(err, system::system_category());
+    return create_directories_error;
+}
+
+} // unnamed namespace
+
+#endif // defined(BOOST_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) && defined(O_DIRECTORY)
+
+BOOST_FILESYSTEM_DECL
+bool create_directories(path const& p, system::error_code* ec)
+{
+    if (p.empty())
+    {
+        if (!ec)
+        {
+            BOOST_FILESYSTEM_THROW(filesystem_error(
+                "boost::filesystem::create_directories", p,
+                system::errc::make_error_code(system::errc::invalid_argument)));
+        }
+        ec->assign(system::errc::invalid_argument, system::generic_category());
+        return false;
+    }
+
+    if (ec)
+        ec->clear();
+
+    error_code local_ec;
+
+#if defined(BOOST_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) && defined(O_DIRECTORY)
+    {
+        path failed_path;
+        // The failed path is only needed for the exception
+        switch (create_directories_at(p, ec ? static_cast< path* >(NULL) : &failed_path, local_ec))
+        {
+        case create_directories_created:
+            return true;
+
+        case create_directories_existed:
+            return false;
+
+        case create_directories_error:
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::create_directories", p, failed_path, local_ec));
+            *ec = local_ec;
+            return false;
+
+        default:
+            break;
+        }
+    }
+#endif // defined(BOOST_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) && defined(O_DIRECTORY)
+
+    path::const_iterator e(p.end()), it(e);
+    path parent(p);
+    path const& dot_p = dot_path();
+    path const& dot_dot_p = dot_dot_path();
+
+    // Find the initial part of the path that exists
+    for (path fname = parent.filename(); parent.has_relative_path(); fname = parent.filename())
+    {
+        if (!fname.empty() && fname != dot_p && fname != dot_dot_p)
+        {
+            file_status existing_status = detail::status_impl(parent, &local_ec);
+
+            if (existing_status.type() == directory_file)
+            {
+                break;
+            }
+            else if (BOOST_UNLIKELY(existing_status.type() == status_error))
+            {
+                if (!ec)
+                    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::create_directories", p, parent, local_ec));
+                *ec = local_ec;
+                return false;
+            }
+        }
+
+        --it;
+        parent.remove_filename();
+    }
+
+    // Create missing directories
+    bool created = false;
+    for (; it != e; ++it)
+    {
+        path const& fname = *it;
+        parent /= fname;
+        if (!fname.empty() && fname != dot_p && fname != dot_dot_p)
+        {
+            created = detail::create_directory(parent, NULL, &local_ec);
+            if (BOOST_UNLIKELY(!!local_ec))
+            {
+                if (!ec)
+                    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::create_directories", p, parent, local_ec));
+                *ec = local_ec;
+                return false;
+            }
+        }
+    }
+
+    return created;
+}
+
+namespace {
+
+//! Creates directories for a sequence of sorted paths, reusing the directories created or opened for the previous paths
+/*!
+ * The creator keeps the chain of directories leading to the last created directory. For every path, the leading elements
+ * shared with the previous path are skipped, and the remaining directories are created top-down. On POSIX systems with
+ * *at APIs, the directories are created relative to the held file descriptors of their parents, so that neither the prefix
+ * chain is queried again nor the full paths are resolved by the system for every directory.
+ */
+class directories_batch_creator
+{
+private:
+    //! Directory on the path to the last created directory
+    struct level
+    {
+        path name;
+#if defined(BOOST_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) && defined(O_DIRECTORY)
+        //! File descriptor of the directory, -1 if not opened yet
+        int fd;
+
+        explicit level(path const& n) : name(n), fd(-1) {}
+#else
+        //! Full path to the directory
+        path full_path;
+
+        explicit level(path const& n) : name(n) {}
+#endif
+    };
+
+private:
+    //! Root path of the directories on the stack
+    path m_root;
+#if defined(BOOST_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) && defined(O_DIRECTORY)
+    //! File descriptor of the root directory, \c AT_FDCWD for relative paths or -1 if not opened yet
+    int m_root_fd;
+#endif
+    //! Directories leading to the last created directory
+    std::vector< level > m_levels;
+    //! Elements of the path being created
+    std::vector< path > m_elements;
+    //! Number of created directories
+    std::size_t m_created;
+
+public:
+    directories_batch_creator() BOOST_NOEXCEPT :
+#if defined(BOOST_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) && defined(O_DIRECTORY)
+        m_root_fd(-1),
+#endif
+        m_created(0u)
+    {
+    }
+
+    ~directories_batch_creator() BOOST_NOEXCEPT
+    {
+        truncate(0u);
+        close_root();
+    }
+
+    BOOST_DELETED_FUNCTION(directories_batch_creator(directories_batch_creator const&))
+    BOOST_DELETED_FUNCTION(directories_batch_creator& operator=(directories_batch_creator const&))
+
+    //! Returns the number of directories created so far
+    std::size_t created() const BOOST_NOEXCEPT { return m_created; }
+
+    //! Creates directory \a p and its missing parents. On error, \a failed_path receives the directory that could not be created.
+    error_code create(path const& p, path& failed_path)
+    {
+        error_code ec;
+        path const& dot_p = dot_path();
+        path const& dot_dot_p = dot_dot_path();
+
+        m_elements.clear();
+        const path relative = p.relative_path();
+        for (path::const_iterator it = relative.begin(), end = relative.end(); it != end; ++it)
+        {
+            path const& elem = *it;
+            if (elem.empty() || elem == dot_p)
+                continue;
+
+            if (BOOST_UNLIKELY(elem == dot_dot_p))
+            {
+                // Dot-dot elements may refer outside of the directories on the stack, leave such paths to the generic implementation
+                if (detail::create_directories(p, &ec))
+                    ++m_created;
+                if (BOOST_UNLIKELY(!!ec))
+                    failed_path = p;
+                return ec;
+            }
+
+            m_elements.push_back(elem);
+        }
+
+        const path root = p.root_path();
+        if (root != m_root)
+        {
+            truncate(0u);
+            close_root();
+            m_root = root;
+        }
+
+        // Skip the directories that were created or opened for the previous paths
+        std::size_t common = 0u;
+        for (std::size_t n = m_elements.size() < m_levels.size() ? m_elements.size() : m_levels.size(); common < n; ++common)
+        {
+            if (m_levels[common].name != m_elements[common])
+                break;
+        }
+
+        truncate(common);
+
+        for (std::size_t i = common, n = m_elements.size(); i < n; ++i)
+        {
+            ec = create_level(i, i + 1u == n);
+            if (BOOST_UNLIKELY(!!ec))
+            {
+                failed_path = m_root;
+                for (std::size_t j = 0u; j <= i; ++j)
+                    failed_path /= m_elements[j];
+                truncate(i);
+                break;
+            }
+        }
+
+        return ec;
+    }
+
+private:
+#if defined(BOOST_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) && defined(O_DIRECTORY)
+
+    //! Creates the directory \a m_elements[index] in the directory on the top of the stack and pushes it to the stack
+    error_code create_level(std::size_t index, bool is_leaf)
+    {
+        int err = 0;
+        const int parent_fd = open_parent(index, err);
+        if (BOOST_UNLIKELY(parent_fd == -1))
+            return error_code(err, system::system_category());
+
+        path const& name = m_elements[index];
+        const mode_t mode = S_IRWXU | S_IRWXG | S_IRWXO;
+        if (::mkdirat(parent_fd, name.c_str(), mode) == 0)
+        {
+            ++m_created;
+        }
+        else
+        {
+            err = errno;
+            if (err != EEXIST)
+                return error_code(err, system::system_category());
+
+            // Existing intermediate directories are verified when they are opened to create their children
+            if (is_leaf)
+            {
+                struct ::stat st;
+                if (::fstatat(parent_fd, name.c_str(), &st, 0) != 0 || !S_ISDIR(st.st_mode))
+                    return error_code(EEXIST, system::system_category());
+            }
+        }
+
+        m_levels.push_back(level(name));
+        return error_code();
+    }
+
+    //! Returns the file descriptor of the parent directory of the directory at \a index, opening it if needed. Returns -1 on error.
+    int open_parent(std::size_t index, int& err)
+    {
+        if (index == 0u)
+        {
+            if (m_root_fd == -1)
+            {
+                if (m_root.empty())
+                {
+                    m_root_fd = AT_FDCWD;
+                }
+                else
+                {
+                    m_root_fd = ::open(m_root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+                    if (BOOST_UNLIKELY(m_root_fd < 0))
+                    {
+                        err = errno;
+                        m_root_fd = -1;
+                    }
+                }
+            }
+
+            return m_root_fd;
+        }
+
+        level& parent = m_levels[index - 1u];
+        if (parent.fd == -1)
+        {
+            const int grandparent_fd = open_parent(index - 1u, err);
+            if (BOOST_UNLIKELY(grandparent_fd == -1))
+                return -1;
+
+            parent.fd = ::openat(grandparent_fd, parent.name.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (BOOST_UNLIKELY(parent.fd < 0))
+            {
+                err = errno;
+                parent.fd = -1;
+            }
+        }
+
+        return parent.fd;
+    }
+
+    //! Pops the directories from the stack, leaving \a size directories
+    void truncate(std::size_t size) BOOST_NOEXCEPT
+    {
+        while (m_levels.size() > size)
+        {
+            if (m_levels.back().fd != -1)
+                close_fd(m_levels.back().fd);
+            m_levels.pop_back();
+        }
+    }
+
+    //! Closes the root directory
+    void close_root() BOOST_NOEXCEPT
+    {
+        if (m_root_fd >= 0)
+            close_fd(m_root_fd);
+        m_root_fd = -1;
+    }
+
+#else // defined(BOOST_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) && defined(O_DIRECTORY)
+
+    //! Creates the directory \a m_elements[index] in the directory on the top of the stack and pushes it to the stack
+    error_code create_level(std::size_t index, bool)
+    {
+        level lvl(m_elements[index]);
+        lvl.full_path = index > 0u ? m_levels[index - 1u].full_path : m_root;
+        lvl.full_path /= lvl.name;
+
+        error_code ec;
+        if (detail::create_directory(lvl.full_path, NULL, &ec))
+            ++m_created;
+        if (BOOST_UNLIKELY(!!ec))
+            return ec;
+
+        m_levels.push_back(lvl);
+        return ec;
+    }
+
+    //! Pops the directories from the stack, leaving \a size directories
+    void truncate(std::size_t size) BOOST_NOEXCEPT
+    {
+        while (m_levels.size() > size)
+            m_levels.pop_back();
+    }
+
+    //! Closes the root directory
+    void close_root() BOOST_NOEXCEPT
+    {
+    }
+
+#endif // defined(BOOST_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) && defined(O_DIRECTORY)
+};
+
+//! Orders pointers to paths by the pointed paths
+struct path_ptr_less
+{
+    bool operator()(path const* left, path const* right) const { return *left < *right; }
+};
+
+//! Compares the paths pointed to by two pointers for equality
+struct path_ptr_equal
+{
+    bool operator()(path const* left, path const* right) const { return *left == *right; }
+};
+
+//! Finds the element at \a index of the relative part of \a p, skipping empty and dot elements. Returns \c false if there is no such element.
+bool get_relative_element(path const& p, std::size_t index, path& elem)
+{
+    path const& dot_p = dot_path();
+    const path relative = p.relative_path();
+    for (path::const_iterator it = relative.begin(), end = relative.end(); it != end; ++it)
+    {
+        if (it->empty() || *it == dot_p)
+            continue;
+
+        if (index == 0u)
+        {
+            elem = *it;
+            return true;
+        }
+
+        --index;
+    }
+
+    return false;
+}
+
+//! Returns the number of leading directories of the relative parts of \a left and \a right that are equal
+std::size_t common_relative_elements(path const& left, path const& right)
+{
+    std::size_t count = 0u;
+    path left_elem, right_elem;
+    while (get_relative_element(left, count, left_elem) && get_relative_element(right, count, right_elem) && left_elem == right_elem)
+        ++count;
+
+    return count;
+}
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+//! Minimum number of directories to create per thread
+BOOST_CONSTEXPR_OR_CONST std::size_t create_directories_batch_min_paths_per_thread = 256u;
+
+//! Function object that creates the directories of independent subtrees in multiple threads
+class parallel_directories_creator
+{
+private:
+    path const* const* const m_paths;
+    //! Indices of the first paths of the subtrees, followed by the number of paths
+    std::vector< std::size_t > const& m_groups;
+    std::atomic< std::size_t > m_next_group;
+    std::atomic< std::size_t > m_created;
+    std::atomic< bool > m_failed;
+    std::mutex m_error_mutex;
+    error_code m_error;
+    path m_failed_path;
+
+public:
+    parallel_directories_creator(path const* const* paths, std::vector< std::size_t > const& groups) BOOST_NOEXCEPT :
+        m_paths(paths),
+        m_groups(groups),
+        m_next_group(0u),
+        m_created(0u),
+        m_failed(false)
+    {
+    }
+
+    BOOST_DELETED_FUNCTION(parallel_directories_creator(parallel_directories_creator const&))
+    BOOST_DELETED_FUNCTION(parallel_directories_creator& operator=(parallel_directories_creator const&))
+
+    std::size_t created() const BOOST_NOEXCEPT { return m_created.load(std::memory_order_relaxed); }
+    error_code const& error() const BOOST_NOEXCEPT { return m_error; }
+    path const& failed_path() const BOOST_NOEXCEPT { return m_failed_path; }
+
+    void operator()(unsigned int) BOOST_NOEXCEPT
+    {
+        directories_batch_creator creator;
+        path failed_path;
+        error_code ec;
+        try
+        {
+            while (!m_failed.load(std::memory_order_relaxed))
+            {
+                const std::size_t group = m_next_group.fetch_add(1u, std::memory_order_relaxed);
+                if (group + 1u >= m_groups.size())
+                    break;
+
+                for (std::size_t i = m_groups[group], n = m_groups[group + 1u]; i < n && !ec; ++i)
+                    ec = creator.create(*m_paths[i], failed_path);
+
+                if (BOOST_UNLIKELY(!!ec))
+                    break;
+            }
+        }
+        catch (std::bad_alloc&)
+        {
+            ec = make_error_code(system::errc::not_enough_memory);
+            failed_path.clear();
+        }
+
+        m_created.fetch_add(creator.created(), std::memory_order_relaxed);
+
+        if (BOOST_UNLIKELY(!!ec))
+        {
+            std::lock_guard< std::mutex > lock(m_error_mutex);
+            if (!m_error)
+            {
+                m_error = ec;
+                m_failed_path.swap(failed_path);
+            }
+            m_failed.store(true, std::memory_order_relaxed);
+        }
+    }
+};
+
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+} // unnamed namespace
+
+BOOST_FILESYSTEM_DECL
+std::size_t create_directories_batch(path const* paths, std::size_t count, unsigned int thread_count, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    error_code local_ec;
+    path failed_path;
+    std::size_t created = 0u;
+    try
+    {
+        std::vector< path const* > sorted;
+        sorted.reserve(count);
+        for (std::size_t i = 0u; i < count; ++i)
+        {
+            if (BOOST_UNLIKELY(paths[i].empty()))
+            {
+                local_ec = system::errc::make_error_code(system::errc::invalid_argument);
+                goto fail;
+            }
+
+            sorted.push_back(paths + i);
+        }
+
+        // Parents are ordered before their subdirectories, and subdirectories of the same parent are adjacent
+        std::sort(sorted.begin(), sorted.end(), path_ptr_less());
+        sorted.erase(std::unique(sorted.begin(), sorted.end(), path_ptr_equal()), sorted.end());
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        if (thread_count != 1u && sorted.size() >= create_directories_batch_min_paths_per_thread * 2u && sorted.front()->root_path() == sorted.back()->root_path())
+        {
+            // The common parent of the sorted paths is the common parent of the first and the last path
+            path const& first = *sorted.front();
+            const std::size_t common_count = common_relative_elements(first, *sorted.back());
+            path common = first.root_path();
+            path elem;
+            for (std::size_t i = 0u; i < common_count && get_relative_element(first, i, elem); ++i)
+                common /= elem;
+
+            // Split the paths into the subtrees of the common parent
+            std::vector< std::size_t > groups;
+            path prev_elem;
+            for (std::size_t i = 0u, n = sorted.size(); i < n; ++i)
+            {
+                if (!get_relative_element(*sorted[i], common_count, elem))
+                    elem.clear();
+                if (groups.empty() || elem != prev_elem)
+                {
+                    groups.push_back(i);
+                    prev_elem.swap(elem);
+                }
+            }
+            groups.push_back(sorted.size());
+
+            const std::size_t group_count = groups.size() - 1u;
+            if (group_count > 1u)
+            {
+                thread_count = get_thread_count(thread_count);
+                if (static_cast< std::size_t >(thread_count) > group_count)
+                    thread_count = static_cast< unsigned int >(group_count);
+                if (static_cast< std::size_t >(thread_count) > sorted.size() / create_directories_batch_min_paths_per_thread)
+                    thread_count = static_cast< unsigned int >(sorted.size() / create_directories_batch_min_paths_per_thread);
+
+                if (thread_count > 1u)
+                {
+                    // Create the common parent first, so that the threads don't race creating it
+                    if (common.has_relative_path())
+                    {
+                        directories_batch_creator creator;
+                        local_ec = creator.create(common, failed_path);
+                        created = creator.created();
+                        if (BOOST_UNLIKELY(!!local_ec))
+                            goto fail;
+                    }
+
+                    parallel_directories_creator parallel_creator(&sorted[0], groups);
+                    run_in_threads(thread_count, parallel_creator);
+                    created += parallel_creator.created();
+                    if (BOOST_UNLIKELY(!!parallel_creator.error()))
+                    {
+                        local_ec = parallel_creator.error();
+                        failed_path = parallel_creator.failed_path();
+                        goto fail;
+                    }
+
+                    return created;
+                }
+            }
+        }
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+        directories_batch_creator creator;
+        for (std::size_t i = 0u, n = sorted.size(); i < n; ++i)
+        {
+            local_ec = creator.create(*sorted[i], failed_path);
+            if (BOOST_UNLIKELY(!!local_ec))
+                break;
+        }
+
+        created += creator.created();
+        if (BOOST_UNLIKELY(!!local_ec))
+            goto fail;
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return created;
+    }
+
+    return created;
+
+fail:
+    if (!ec)
+        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::create_directories", failed_path, local_ec));
+
+    *ec = local_ec;
+    return created;
+}
+
+BOOST_FILESYSTEM_DECL
+bool create_directory(path const& p, const path* existing, error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_POSIX_API)
+
+    mode_t mode = S_IRWXU | S_IRWXG | S_IRWXO;
+    if (existing)
+    {
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+        struct ::statx existing_stat;
+        if (BOOST_UNLIKELY(invoke_statx(AT_FDCWD, existing->c_str(), AT_NO_AUTOMOUNT, STATX_TYPE | STATX_MODE, &existing_stat) < 0))
+        {
+            emit_error(errno, p, *existing, ec, "boost::filesystem::create_directory");
+            return false;
+        }
+
+        if (BOOST_UNLIKELY((existing_stat.stx_mask & (STATX_TYPE | STATX_MODE)) != (STATX_TYPE | STATX_MODE)))
+        {
+            emit_error(BOOST_ERROR_NOT_SUPPORTED, p, *existing, ec, "boost::filesystem::create_directory");
+            return false;
+        }
+#else
+        struct ::stat existing_stat;
+        if (::stat(existing->c_str(), &existing_stat) < 0)
+        {
+            emit_error(errno, p, *existing, ec, "boost::filesystem::create_directory");
+            return false;
+        }
+#endif
+
+        const mode_t existing_mode = get_mode(existing_stat);
+        if (!S_ISDIR(existing_mode))
+        {
+            emit_error(ENOTDIR, p, *existing, ec, "boost::filesystem::create_directory");
+            return false;
+        }
+
+        mode = existing_mode;
+    }
+
+    if (::mkdir(p.c_str(), mode) == 0)
+        return true;
+
+#else // defined(BOOST_POSIX_API)
+
+    BOOL res;
+    if (existing)
+        res = ::CreateDirectoryExW(existing->c_str(), p.c_str(), NULL);
+    else
+        res = ::CreateDirectoryW(p.c_str(), NULL);
+
+    if (res)
+        return true;
+
+#endif // defined(BOOST_POSIX_API)
+
+    //  attempt to create directory failed
+    err_t errval = BOOST_ERRNO; // save reason for failure
+    error_code dummy;
+
+    if (is_directory(p, dummy))
+        return false;
+
+    //  attempt to create directory failed && it doesn't already exist
+    emit_error(errval, p, ec, "boost::filesystem::create_directory");
+    return false;
+}
+
+// Deprecated, to be removed in a future release
+BOOST_FILESYSTEM_DECL
+void copy_directory(path const& from, path const& to, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_POSIX_API)
+
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    int err;
+    struct ::statx from_stat;
+    if (BOOST_UNLIKELY(invoke_statx(AT_FDCWD, from.c_str(), AT_NO_AUTOMOUNT, STATX_TYPE | STATX_MODE, &from_stat) < 0))
+    {
+    fail_errno:
+        err = errno;
+    fail:
+        emit_error(err, from, to, ec, "boost::filesystem::copy_directory");
+        return;
+    }
+
+    if (BOOST_UNLIKELY((from_stat.stx_mask & (STATX_TYPE | STATX_MODE)) != (STATX_TYPE | STATX_MODE)))
+    {
+        err = BOOST_ERROR_NOT_SUPPORTED;
+        goto fail;
+    }
+#else
+    struct ::stat from_stat;
+    if (BOOST_UNLIKELY(::stat(from.c_str(), &from_stat) < 0))
+    {
+    fail_errno:
+        emit_error(errno, from, to, ec, "boost::filesystem::copy_directory");
+        return;
+    }
+#endif
+
+    if (BOOST_UNLIKELY(::mkdir(to.c_str(), get_mode(from_stat)) < 0))
+        goto fail_errno;
+
+#else // defined(BOOST_POSIX_API)
+
+    if (BOOST_UNLIKELY(!::CreateDirectoryExW(from.c_str(), to.c_str(), 0)))
+        emit_error(BOOST_ERRNO, from, to, ec, "boost::filesystem::copy_directory");
+
+#endif // defined(BOOST_POSIX_API)
+}
+
+BOOST_FILESYSTEM_DECL
+void create_directory_symlink(path const& to, path const& from, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_POSIX_API)
+    int err = ::symlink(to.c_str(), from.c_str());
+    if (BOOST_UNLIKELY(err < 0))
+    {
+        err = errno;
+        emit_error(err, to, from, ec, "boost::filesystem::create_directory_symlink");
+    }
+#else
+    // see if actually supported by Windows runtime dll
+    if (!create_symbolic_link_api)
+    {
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, to, from, ec, "boost::filesystem::create_directory_symlink");
+        return;
+    }
+
+    if (!create_symbolic_link_api(from.c_str(), to.c_str(), SYMBOLIC_LINK_FLAG_DIRECTORY | SYMBOLIC_LINK_FLAG_ALLOW_UNPRIVILEGED_CREATE))
+    {
+        emit_error(BOOST_ERRNO, to, from, ec, "boost::filesystem::create_directory_symlink");
+    }
+#endif
+}
+
+BOOST_FILESYSTEM_DECL
+void create_hard_link(path const& to, path const& from, error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_POSIX_API)
+    int err = ::link(to.c_str(), from.c_str());
+    if (BOOST_UNLIKELY(err < 0))
+    {
+        err = errno;
+        emit_error(err, to, from, ec, "boost::filesystem::create_hard_link");
+    }
+#else
+    // see if actually supported by Windows runtime dll
+    CreateHardLinkW_t* chl_api = filesystem::detail::atomic_load_relaxed(create_hard_link_api);
+    if (BOOST_UNLIKELY(!chl_api))
+    {
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, to, from, ec, "boost::filesystem::create_hard_link");
+        return;
+    }
+
+    if (BOOST_UNLIKELY(!chl_api(from.c_str(), to.c_str(), NULL)))
+    {
+        emit_error(BOOST_ERRNO, to, from, ec, "boost::filesystem::create_hard_link");
+    }
+#endif
+}
+
+BOOST_FILESYSTEM_DECL
+void create_symlink(path const& to, path const& from, error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_POSIX_API)
+    int err = ::symlink(to.c_str(), from.c_str());
+    if (BOOST_UNLIKELY(err < 0))
+    {
+        err = errno;
+        emit_error(err, to, from, ec, "boost::filesystem::create_symlink");
+    }
+#else
+    // see if actually supported by Windows runtime dll
+    CreateSymbolicLinkW_t* csl_api = filesystem::detail::atomic_load_relaxed(create_symbolic_link_api);
+    if (BOOST_UNLIKELY(!csl_api))
+    {
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, to, from, ec, "boost::filesystem::create_symlink");
+        return;
+    }
+
+    if (BOOST_UNLIKELY(!csl_api(from.c_str(), to.c_str(), SYMBOLIC_LINK_FLAG_ALLOW_UNPRIVILEGED_CREATE)))
+    {
+        emit_error(BOOST_ERRNO, to, from, ec, "boost::filesystem::create_symlink");
+    }
+#endif
+}
+
+namespace {
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS) || defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+
+#define BOOST_FILESYSTEM_USE_PATH_CACHE
+
+/*!
+ * Process-wide cache of a path, such as the current path.
+ *
+ * The cached path may be associated with a key, which identifies the inputs the path was obtained from. Every invalidation
+ * of the cache increments the generation number, which allows to discard the paths that were obtained concurrently
+ * with the invalidation.
+ */
+class cached_path
+{
+private:
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+    std::mutex m_mutex;
+#endif
+    path m_path;
+    path::string_type m_key;
+    unsigned int m_generation;
+    bool m_valid;
+
+public:
+    cached_path() : m_generation(0u), m_valid(false) {}
+
+    BOOST_DELETED_FUNCTION(cached_path(cached_path const&))
+    BOOST_DELETED_FUNCTION(cached_path& operator=(cached_path const&))
+
+    //! Copies the cached path to \a p, if it was cached with key \a key. Otherwise returns \c false and the generation number to pass to \c set.
+    bool get(path& p, unsigned int& generation, const path::value_type* key = NULL, std::size_t key_size = 0u)
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        if (m_valid && m_key.size() == key_size && m_key.compare(0u, key_size, key, key_size) == 0)
+        {
+            p = m_path;
+            return true;
+        }
+
+        generation = m_generation;
+        return false;
+    }
+
+    //! Caches path \a p with key \a key, unless the cache was invalidated after the path was obtained
+    void set(path const& p, unsigned int generation, const path::value_type* key = NULL, std::size_t key_size = 0u)
+    {
+        try
+        {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+            std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+            if (generation == m_generation)
+            {
+                m_valid = false;
+                m_path = p;
+                m_key.assign(key, key_size);
+                m_valid = true;
+            }
+        }
+        catch (...)
+        {
+            // The path will be obtained again next time
+        }
+    }
+
+    void invalidate() BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        m_valid = false;
+        ++m_generation;
+    }
+};
+
+cached_path& get_current_path_cache()
+{
+    static cached_path cache;
+    return cache;
+}
+
+#if defined(BOOST_WINDOWS_API) && !defined(UNDER_CE)
+cached_path& get_temp_directory_path_cache()
+{
+    static cached_path cache;
+    return cache;
+}
+#endif
+
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS) || defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+
+//! Obtains the current path from the operating system
+path current_path_impl(error_code* ec)
+{
+#if defined(UNDER_CE) || defined(BOOST_FILESYSTEM_USE_WASI)
+    // Windows CE has no current directory, so everything's relative to the root of the directory tree.
+    // WASI also does not support current path.
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, ec, "boost::filesystem::current_path");
+    return path();
+#elif defined(BOOST_POSIX_API)
+    struct local
+    {
+        static bool getcwd_error(error_code* ec)
+        {
+            const int err = errno;
+            return error((err != ERANGE
+#if defined(__MSL__) && (defined(macintosh) || defined(__APPLE__) || defined(__APPLE_CC__))
+                          // bug in some versions of the Metrowerks C lib on the Mac: wrong errno set
+                          && err != 0
+#endif
+                          ) ? err : 0,
+                         ec, "boost::filesystem::current_path");
+        }
+    };
+
+    path cur;
+    char small_buf[small_path_size];
+    const char* p = ::getcwd(small_buf, sizeof(small_buf));
+    if (BOOST_LIKELY(!!p))
+    {
+        cur = p;
+        if (ec)
+            ec->clear();
+    }
+    else if (BOOST_LIKELY(!local::getcwd_error(ec)))
+    {
+        for (std::size_t path_max = sizeof(small_buf) * 2u;; path_max *= 2u) // loop 'til buffer large enough
+        {
+            if (BOOST_UNLIKELY(path_max > absolute_path_max))
+            {
+                emit_error(ENAMETOOLONG, ec, "boost::filesystem::current_path");
+                break;
+            }
+
+            boost::scoped_array< char > buf(new char[path_max]);
+            p = ::getcwd(buf.get(), path_max);
+            if (BOOST_LIKELY(!!p))
+            {
+                cur = buf.get();
+                if (ec)
+                    ec->clear();
+                break;
+            }
+            else if (BOOST_UNLIKELY(local::getcwd_error(ec)))
+            {
+                break;
+            }
+        }
+    }
+
+    return cur;
+#else
+    DWORD sz;
+    if ((sz = ::GetCurrentDirectoryW(0, NULL)) == 0)
+        sz = 1;
+    boost::scoped_array< path::value_type > buf(new path::value_type[sz]);
+    if (error(::GetCurrentDirectoryW(sz, buf.get()) == 0 ? BOOST_ERRNO : 0, ec, "boost::filesystem::current_path"))
+        return path();
+    return path(buf.get());
+#endif
+}
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL
+path current_path(error_code* ec)
+{
+#if defined(BOOST_FILESYSTEM_USE_PATH_CACHE)
+    cached_path& cache = get_current_path_cache();
+    path cur;
+    unsigned int generation = 0u;
+    if (cache.get(cur, generation))
+    {
+        if (ec)
+            ec->clear();
+        return cur;
+    }
+
+    cur = current_path_impl(ec);
+    if (!cur.empty())
+        cache.set(cur, generation);
+
+    return cur;
+#else
+    return current_path_impl(ec);
+#endif
+}
+
+BOOST_FILESYSTEM_DECL
+void current_path(path const& p, system::error_code* ec)
+{
+#if defined(UNDER_CE) || defined(BOOST_FILESYSTEM_USE_WASI)
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::current_path");
+#else
+    const bool failed = !BOOST_SET_CURRENT_DIRECTORY(p.c_str());
+    const int err = failed ? BOOST_ERRNO : 0;
+#if defined(BOOST_FILESYSTEM_USE_PATH_CACHE)
+    // Invalidate the cache even on failure, in case the current directory has changed regardless
+    get_current_path_cache().invalidate();
+#endif
+    error(err, p, ec, "boost::filesystem::current_path");
+#endif
+}
+
+namespace {
+
+#if defined(BOOST_POSIX_API)
+
+//! Obtains the identity of the file \a p, resolved relative to \a basedir_fd. Follows symlinks. Returns 0 on success or the error code otherwise.
+int get_file_identity(int basedir_fd, const char* p, file_identity& id) BOOST_NOEXCEPT
+{
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    struct ::statx st;
+    if (BOOST_UNLIKELY(invoke_statx(basedir_fd, p, AT_NO_AUTOMOUNT, STATX_INO, &st) < 0))
+        return errno;
+
+    if (BOOST_UNLIKELY((st.stx_mask & STATX_INO) != STATX_INO))
+        return BOOST_ERROR_NOT_SUPPORTED;
+
+    id = file_identity(static_cast< boost::uint64_t >(get_dev(st)), static_cast< boost::uint64_t >(st.stx_ino));
+#else
+    struct ::stat st;
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    if (BOOST_UNLIKELY(::fstatat(basedir_fd, p, &st, AT_NO_AUTOMOUNT) < 0))
+#else
+    (void)basedir_fd;
+    if (BOOST_UNLIKELY(::stat(p, &st) < 0))
+#endif
+        return errno;
+
+    id = file_identity(static_cast< boost::uint64_t >(st.st_dev), static_cast< boost::uint64_t >(st.st_ino));
+#endif
+
+    return 0;
+}
+
+//! Obtains the identity of the open file \a fd. Returns 0 on success or the error code otherwise.
+int get_fd_identity(int fd, file_identity& id) BOOST_NOEXCEPT
+{
+    struct ::stat st;
+    if (BOOST_UNLIKELY(::fstat(fd, &st) < 0))
+        return errno;
+
+    id = file_identity(static_cast< boost::uint64_t >(st.st_dev), static_cast< boost::uint64_t >(st.st_ino));
+    return 0;
+}
+
+#else // defined(BOOST_POSIX_API)
+
+//! Obtains the identity of the open file \a h. Returns 0 on success or the error code otherwise.
+DWORD get_handle_identity(HANDLE h, file_identity& id) BOOST_NOEXCEPT
+{
+    // FileIdInfo is supported since Windows 8 and provides 128-bit file ids, which are used by ReFS
+    GetFileInformationByHandleEx_t* get_file_information_by_handle_ex = filesystem::detail::atomic_load_relaxed(get_file_information_by_handle_ex_api);
+    if (BOOST_LIKELY(get_file_information_by_handle_ex != NULL))
+    {
+        file_id_info info;
+        if (BOOST_LIKELY(get_file_information_by_handle_ex(h, file_id_info_class, &info, sizeof(info))))
+        {
+            boost::uint64_t id_low, id_high;
+            std::memcpy(&id_low, info.FileId, sizeof(id_low));
+            std::memcpy(&id_high, info.FileId + sizeof(id_low), sizeof(id_high));
+            id = file_identity(info.VolumeSerialNumber, id_low, id_high);
+            return 0u;
+        }
+    }
+
+    BY_HANDLE_FILE_INFORMATION info;
+    if (BOOST_UNLIKELY(!::GetFileInformationByHandle(h, &info)))
+        return ::GetLastError();
+
+    id = file_identity(info.dwVolumeSerialNumber, (static_cast< boost::uint64_t >(info.nFileIndexHigh) << 32u) | info.nFileIndexLow);
+    return 0u;
+}
+
+#endif // defined(BOOST_POSIX_API)
+
+} // unnamed namespace
+
+BOOST_FILESYSTEM_DECL
+file_identity identity(path const& p, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    file_identity id;
+
+#if defined(BOOST_POSIX_API)
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) || defined(BOOST_FILESYSTEM_USE_STATX)
+    const int err = get_file_identity(AT_FDCWD, p.c_str(), id);
+#else
+    const int err = get_file_identity(-1, p.c_str(), id);
+#endif
+
+#else // defined(BOOST_POSIX_API)
+
+    handle_wrapper h(create_file_handle(
+        p.c_str(),
+        FILE_READ_ATTRIBUTES,
+        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS));
+
+    const DWORD err = h.handle != INVALID_HANDLE_VALUE ? get_handle_identity(h.handle, id) : ::GetLastError();
+
+#endif // defined(BOOST_POSIX_API)
+
+    if (BOOST_UNLIKELY(err != 0))
+    {
+        emit_error(err, p, ec, "boost::filesystem::identity");
+        return file_identity();
+    }
+
+    return id;
+}
+
+BOOST_FILESYSTEM_DECL
+bool equivalent(directory_entry const& e1, directory_entry const& e2, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    // e2 is done first, so any error reported is for e1
+    error_code ec2;
+    const file_identity id2 = e2.identity(ec2);
+    error_code ec1;
+    const file_identity id1 = e1.identity(ec1);
+
+    if (BOOST_UNLIKELY(!!ec1 || !!ec2))
+    {
+        // if one is invalid and the other isn't then they aren't equivalent,
+        // but if both are invalid then it is an error
+        if (!!ec1 && !!ec2)
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::equivalent", e1.path(), e2.path(), ec1));
+
+            *ec = ec1;
+        }
+
+        return false;
+    }
+
+    return id1 == id2;
+}
+
+BOOST_FILESYSTEM_DECL
+bool equivalent(path const& p1, path const& p2, system::error_code* ec)
+{
+#if defined(BOOST_POSIX_API)
+
+    // p2 is done first, so any error reported is for p1
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    struct ::statx s2;
+    int e2 = invoke_statx(AT_FDCWD, p2.c_str(), AT_NO_AUTOMOUNT, STATX_INO, &s2);
+    if (BOOST_LIKELY(e2 == 0))
+    {
+        if (BOOST_UNLIKELY((s2.stx_mask & STATX_INO) != STATX_INO))
+        {
+        fail_unsupported:
+            emit_error(BOOST_ERROR_NOT_SUPPORTED, p1, p2, ec, "boost::filesystem::equivalent");
+            return false;
+        }
+    }
+
+    struct ::statx s1;
+    int e1 = invoke_statx(AT_FDCWD, p1.c_str(), AT_NO_AUTOMOUNT, STATX_INO, &s1);
+    if (BOOST_LIKELY(e1 == 0))
+    {
+        if (BOOST_UNLIKELY((s1.stx_mask & STATX_INO) != STATX_INO))
+            goto fail_unsupported;
+    }
+#else
+    struct ::stat s2;
+    int e2 = ::stat(p2.c_str(), &s2);
+    struct ::stat s1;
+    int e1 = ::stat(p1.c_str(), &s1);
+#endif
+
+    if (BOOST_UNLIKELY(e1 != 0 || e2 != 0))
+    {
+        // if one is invalid and the other isn't then they aren't equivalent,
+        // but if both are invalid then it is an error
+        if (e1 != 0 && e2 != 0)
+            emit_error(errno, p1, p2, ec, "boost::filesystem::equivalent");
+        return false;
+    }
+
+    return equivalent_stat(s1, s2);
+
+#else // Windows
+
+    // Thanks to Jeremy Maitin-Shepard for much help and for permission to
+    // base the equivalent() implementation on portions of his
+    // file-equivalence-win32.cpp experimental code.
+
+    // Note well: Physical location on external media is part of the
+    // equivalence criteria. If there are no open handles, physical location
+    // can change due to defragmentation or other relocations. Thus handles
+    // must be held open until location information for both paths has
+    // been retrieved.
+
+    // p2 is done first, so any error reported is for p1
+    handle_wrapper h2(create_file_handle(
+        p2.c_str(),
+        FILE_READ_ATTRIBUTES,
+        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS));
+
+    handle_wrapper h1(create_file_handle(
+        p1.c_str(),
+        FILE_READ_ATTRIBUTES,
+        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS));
+
+    if (BOOST_UNLIKELY(h1.handle == INVALID_HANDLE_VALUE || h2.handle == INVALID_HANDLE_VALUE))
+    {
+        // if one is invalid and the other isn't, then they aren't equivalent,
+        // but if both are invalid then it is an error
+        if (h1.handle == INVALID_HANDLE_VALUE && h2.handle == INVALID_HANDLE_VALUE)
+            error(BOOST_ERRNO, p1, p2, ec, "boost::filesystem::equivalent");
+        return false;
+    }
+
+    // at this point, both handles are known to be valid
+
+    BY_HANDLE_FILE_INFORMATION info1, info2;
+
+    if (error(!::GetFileInformationByHandle(h1.handle, &info1) ? BOOST_ERRNO : 0, p1, p2, ec, "boost::filesystem::equivalent"))
+        return false;
+
+    if (error(!::GetFileInformationByHandle(h2.handle, &info2) ? BOOST_ERRNO : 0, p1, p2, ec, "boost::filesystem::equivalent"))
+        return false;
+
+    // In theory, volume serial numbers are sufficient to distinguish between
+    // devices, but in practice VSN's are sometimes duplicated, so last write
+    // time and file size are also checked.
+    return info1.dwVolumeSerialNumber == info2.dwVolumeSerialNumber &&
+        info1.nFileIndexHigh == info2.nFileIndexHigh &&
+        info1.nFileIndexLow == info2.nFileIndexLow &&
+        info1.nFileSizeHigh == info2.nFileSizeHigh &&
+        info1.nFileSizeLow == info2.nFileSizeLow &&
+        info1.ftLastWriteTime.dwLowDateTime == info2.ftLastWriteTime.dwLowDateTime &&
+        info1.ftLastWriteTime.dwHighDateTime == info2.ftLastWriteTime.dwHighDateTime;
+
+#endif
+}
+
+BOOST_FILESYSTEM_DECL
+uintmax_t file_size(path const& p, error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_POSIX_API)
+
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    struct ::statx path_stat;
+    if (BOOST_UNLIKELY(invoke_statx(AT_FDCWD, p.c_str(), AT_NO_AUTOMOUNT, STATX_TYPE | STATX_SIZE, &path_stat) < 0))
+    {
+        emit_error(errno, p, ec, "boost::filesystem::file_size");
+        return static_cast< uintmax_t >(-1);
+    }
+
+    if (BOOST_UNLIKELY((path_stat.stx_mask & (STATX_TYPE | STATX_SIZE)) != (STATX_TYPE | STATX_SIZE) || !S_ISREG(path_stat.stx_mode)))
+    {
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::file_size");
+        return static_cast< uintmax_t >(-1);
+    }
+#else
+    struct ::stat path_stat;
+    if (BOOST_UNLIKELY(::stat(p.c_str(), &path_stat) < 0))
+    {
+        emit_error(errno, p, ec, "boost::filesystem::file_size");
+        return static_cast< uintmax_t >(-1);
+    }
+
+    if (BOOST_UNLIKELY(!S_ISREG(path_stat.st_mode)))
+    {
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::file_size");
+        return static_cast< uintmax_t >(-1);
+    }
+#endif
+
+    return get_size(path_stat);
+
+#else // defined(BOOST_POSIX_API)
+
+    // assume uintmax_t is 64-bits on all Windows compilers
+
+    WIN32_FILE_ATTRIBUTE_DATA fad;
+
+    if (BOOST_UNLIKELY(!::GetFileAttributesExW(p.c_str(), ::GetFileExInfoStandard, &fad)))
+    {
+        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::file_size");
+        return static_cast< uintmax_t >(-1);
+    }
+
+    if (BOOST_UNLIKELY((fad.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0))
+    {
+        emit_error(ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::file_size");
+        return static_cast< uintmax_t >(-1);
+    }
+
+    return (static_cast< uintmax_t >(fad.nFileSizeHigh)
+            << (sizeof(fad.nFileSizeLow) * 8u)) |
+        fad.nFileSizeLow;
+
+#endif // defined(BOOST_POSIX_API)
+}
+
+BOOST_FILESYSTEM_DECL
+uintmax_t hard_link_count(path const& p, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_POSIX_API)
+
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    struct ::statx path_stat;
+    if (BOOST_UNLIKELY(invoke_statx(AT_FDCWD, p.c_str(), AT_NO_AUTOMOUNT, STATX_NLINK, &path_stat) < 0))
+    {
+        emit_error(errno, p, ec, "boost::filesystem::hard_link_count");
+        return static_cast< uintmax_t >(-1);
+    }
+
+    if (BOOST_UNLIKELY((path_stat.stx_mask & STATX_NLINK) != STATX_NLINK))
+    {
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::hard_link_count");
+        return static_cast< uintmax_t >(-1);
+    }
+
+    return static_cast< uintmax_t >(path_stat.stx_nlink);
+#else
+    struct ::stat path_stat;
+    if (BOOST_UNLIKELY(::stat(p.c_str(), &path_stat) < 0))
+    {
+        emit_error(errno, p, ec, "boost::filesystem::hard_link_count");
+        return static_cast< uintmax_t >(-1);
+    }
+
+    return static_cast< uintmax_t >(path_stat.st_nlink);
+#endif
+
+#else // defined(BOOST_POSIX_API)
+
+    handle_wrapper h(create_file_handle(
+        p.c_str(),
+        FILE_READ_ATTRIBUTES,
+        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS));
+
+    if (BOOST_UNLIKELY(h.handle == INVALID_HANDLE_VALUE))
+    {
+    fail_errno:
+        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::hard_link_count");
+        return static_cast< uintmax_t >(-1);
+    }
+
+    // Link count info is only available through GetFileInformationByHandle
+    BY_HANDLE_FILE_INFORMATION info;
+    if (BOOST_UNLIKELY(!::GetFileInformationByHandle(h.handle, &info)))
+        goto fail_errno;
+
+    return static_cast< uintmax_t >(info.nNumberOfLinks);
+
+#endif // defined(BOOST_POSIX_API)
+}
+
+BOOST_FILESYSTEM_DECL
+path initial_path(error_code* ec)
+{
+    static path init_path;
+    if (init_path.empty())
+        init_path = current_path(ec);
+    else if (ec)
+        ec->clear();
+    return init_path;
+}
+
+BOOST_FILESYSTEM_DECL
+bool is_empty(path const& p, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_POSIX_API)
+
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    struct ::statx path_stat;
+    if (BOOST_UNLIKELY(invoke_statx(AT_FDCWD, p.c_str(), AT_NO_AUTOMOUNT, STATX_TYPE | STATX_SIZE, &path_stat) < 0))
+    {
+        emit_error(errno, p, ec, "boost::filesystem::is_empty");
+        return false;
+    }
+
+    if (BOOST_UNLIKELY((path_stat.stx_mask & STATX_TYPE) != STATX_TYPE))
+    {
+    fail_unsupported:
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::is_empty");
+        return false;
+    }
+
+    if (S_ISDIR(get_mode(path_stat)))
+        return is_empty_directory(p, ec);
+
+    if (BOOST_UNLIKELY((path_stat.stx_mask & STATX_SIZE) != STATX_SIZE))
+        goto fail_unsupported;
+
+    return get_size(path_stat) == 0u;
+#else
+    struct ::stat path_stat;
+    if (BOOST_UNLIKELY(::stat(p.c_str(), &path_stat) < 0))
+    {
+        emit_error(errno, p, ec, "boost::filesystem::is_empty");
+        return false;
+    }
+
+    return S_ISDIR(get_mode(path_stat)) ? is_empty_directory(p, ec) : get_size(path_stat) == 0u;
+#endif
+
+#else // defined(BOOST_POSIX_API)
+
+    WIN32_FILE_ATTRIBUTE_DATA fad;
+    if (BOOST_UNLIKELY(!::GetFileAttributesExW(p.c_str(), ::GetFileExInfoStandard, &fad)))
+    {
+        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::is_empty");
+        return false;
+    }
+
+    return (fad.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? is_empty_directory(p, ec) : (!fad.nFileSizeHigh && !fad.nFileSizeLow);
+
+#endif // defined(BOOST_POSIX_API)
+}
+
+BOOST_FILESYSTEM_DECL
+file_time precise_creation_time(path const& p, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_POSIX_API)
+
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    struct ::statx stx;
+    if (BOOST_UNLIKELY(invoke_statx(AT_FDCWD, p.c_str(), AT_NO_AUTOMOUNT, STATX_BTIME, &stx) < 0))
+    {
+        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::creation_time");
+        return file_time((std::numeric_limits< std::time_t >::min)());
+    }
+    if (BOOST_UNLIKELY((stx.stx_mask & STATX_BTIME) != STATX_BTIME))
+    {
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::creation_time");
+        return file_time((std::numeric_limits< std::time_t >::min)());
+    }
+    return file_time(stx.stx_btime.tv_sec, stx.stx_btime.tv_nsec);
+#elif defined(BOOST_FILESYSTEM_STAT_ST_BIRTHTIME) && defined(BOOST_FILESYSTEM_STAT_ST_BIRTHTIMENSEC)
+    struct ::stat st;
+    if (BOOST_UNLIKELY(::stat(p.c_str(), &st) < 0))
+    {
+        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::creation_time");
+        return file_time((std::numeric_limits< std::time_t >::min)());
+    }
+    return file_time(st.BOOST_FILESYSTEM_STAT_ST_BIRTHTIME, static_cast< boost::uint32_t >(st.BOOST_FILESYSTEM_STAT_ST_BIRTHTIMENSEC));
+#else
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::creation_time");
+    return file_time((std::numeric_limits< std::time_t >::min)());
+#endif
+
+#else // defined(BOOST_POSIX_API)
+
+    handle_wrapper hw(create_file_handle(
+        p.c_str(),
+        FILE_READ_ATTRIBUTES,
+        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS));
+
+    if (BOOST_UNLIKELY(hw.handle == INVALID_HANDLE_VALUE))
+    {
+    fail:
+        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::creation_time");
+        return file_time((std::numeric_limits< std::time_t >::min)());
+    }
+
+    FILETIME ct;
+
+    if (BOOST_UNLIKELY(!::GetFileTime(hw.handle, &ct, NULL, NULL)))
+        goto fail;
+
+    return to_file_time(ct);
+
+#endif // defined(BOOST_POSIX_API)
+}
+
+BOOST_FILESYSTEM_DECL
+std::time_t creation_time(path const& p, system::error_code* ec)
+{
+    return precise_creation_time(p, ec).seconds;
+}
+
+namespace {
+
+#if defined(BOOST_POSIX_API)
+
+//! query() implementation
+file_attributes query_impl
+(
+    path const& p,
+    unsigned int mask,
+    error_code* ec
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) || defined(BOOST_FILESYSTEM_USE_STATX)
+    , int basedir_fd = AT_FDCWD
+#endif
+)
+{
+    file_attributes attrs;
+    unsigned int result_mask = 0u;
+    const unsigned int modifiers = mask & ~static_cast< unsigned int >(file_attribute_mask::all);
+    const bool follow_symlinks = (modifiers & static_cast< unsigned int >(file_attribute_mask::no_follow)) == 0u;
+    mask &= static_cast< unsigned int >(file_attribute_mask::all);
+
+    fs::file_type ftype = fs::status_error;
+    perms prms = fs::perms_not_known;
+
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    unsigned int stx_mask = 0u;
+    if ((mask & static_cast< unsigned int >(file_attribute_mask::type)) != 0u)
+        stx_mask |= STATX_TYPE;
+    if ((mask & static_cast< unsigned int >(file_attribute_mask::permissions)) != 0u)
+        stx_mask |= STATX_MODE;
+    if ((mask & static_cast< unsigned int >(file_attribute_mask::size)) != 0u)
+        stx_mask |= STATX_SIZE;
+    if ((mask & static_cast< unsigned int >(file_attribute_mask::last_write_time)) != 0u)
+        stx_mask |= STATX_MTIME;
+    if ((mask & static_cast< unsigned int >(file_attribute_mask::last_access_time)) != 0u)
+        stx_mask |= STATX_ATIME;
+    if ((mask & static_cast< unsigned int >(file_attribute_mask::creation_time)) != 0u)
+        stx_mask |= STATX_BTIME;
+    if ((mask & static_cast< unsigned int >(file_attribute_mask::hard_link_count)) != 0u)
+        stx_mask |= STATX_NLINK;
+    if ((mask & static_cast< unsigned int >(file_attribute_mask::inode)) != 0u)
+        stx_mask |= STATX_INO;
+    if ((mask & static_cast< unsigned int >(file_attribute_mask::owner)) != 0u)
+        stx_mask |= STATX_UID | STATX_GID;
+    if ((mask & static_cast< unsigned int >(file_attribute_mask::allocated_size)) != 0u)
+        stx_mask |= STATX_BLOCKS;
+
+    int sync_flags = 0;
+    if ((modifiers & static_cast< unsigned int >(file_attribute_mask::force_sync)) != 0u)
+        sync_flags = AT_STATX_FORCE_SYNC;
+    else if ((modifiers & static_cast< unsigned int >(file_attribute_mask::dont_sync)) != 0u)
+        sync_flags = AT_STATX_DONT_SYNC;
+
+    struct ::statx stx;
+    if (BOOST_UNLIKELY(invoke_statx(basedir_fd, p.c_str(), (follow_symlinks ? 0 : AT_SYMLINK_NOFOLLOW) | AT_NO_AUTOMOUNT | sync_flags, stx_mask, &stx) < 0))
+    {
+        emit_error(errno, p, ec, "boost::filesystem::query");
+        return attrs;
+    }
+
+    // Only report the attributes that were both requested and returned
+    stx_mask &= stx.stx_mask;
+    if ((stx_mask & STATX_TYPE) != 0u)
+    {
+        ftype = detail::make_file_status(stx.stx_mode).type();
+        result_mask |= static_cast< unsigned int >(file_attribute_mask::type);
+    }
+    if ((stx_mask & STATX_MODE) != 0u)
+    {
+        prms = static_cast< perms >(stx.stx_mode) & fs::perms_mask;
+        result_mask |= static_cast< unsigned int >(file_attribute_mask::permissions);
+    }
+    if ((stx_mask & STATX_SIZE) != 0u)
+    {
+        attrs.size = stx.stx_size;
+        result_mask |= static_cast< unsigned int >(file_attribute_mask::size);
+    }
+    if ((stx_mask & STATX_MTIME) != 0u)
+    {
+        attrs.last_write_time = stx.stx_mtime.tv_sec;
+        attrs.last_write_time_nsec = stx.stx_mtime.tv_nsec;
+        result_mask |= static_cast< unsigned int >(file_attribute_mask::last_write_time);
+    }
+    if ((stx_mask & STATX_ATIME) != 0u)
+    {
+        attrs.last_access_time = stx.stx_atime.tv_sec;
+        attrs.last_access_time_nsec = stx.stx_atime.tv_nsec;
+        result_mask |= static_cast< unsigned int >(file_attribute_mask::last_access_time);
+    }
+    if ((stx_mask & STATX_BTIME) != 0u)
+    {
+        attrs.creation_time = stx.stx_btime.tv_sec;
+        attrs.creation_time_nsec = stx.stx_btime.tv_nsec;
+        result_mask |= static_cast< unsigned int >(file_attribute_mask::creation_time);
+    }
+    if ((stx_mask & STATX_NLINK) != 0u)
+    {
+        attrs.hard_link_count = stx.stx_nlink;
+        result_mask |= static_cast< unsigned int >(file_attribute_mask::hard_link_count);
+    }
+    if ((stx_mask & STATX_INO) != 0u)
+    {
+        attrs.inode = stx.stx_ino;
+        result_mask |= static_cast< unsigned int >(file_attribute_mask::inode);
+    }
+    if ((stx_mask & (STATX_UID | STATX_GID)) == (STATX_UID | STATX_GID))
+    {
+        attrs.owner_id = stx.stx_uid;
+        attrs.group_id = stx.stx_gid;
+        result_mask |= static_cast< unsigned int >(file_attribute_mask::owner);
+    }
+    if ((stx_mask & STATX_BLOCKS) != 0u)
+    {
+        // stx_blocks is always in 512-byte units, regardless of the filesystem block size
+        attrs.allocated_size = static_cast< uintmax_t >(stx.stx_blocks) * 512u;
+        result_mask |= static_cast< unsigned int >(file_attribute_mask::allocated_size);
+    }
+    if ((mask & static_cast< unsigned int >(file_attribute_mask::device)) != 0u)
+    {
+        // Device id is always returned by statx
+        attrs.device = static_cast< uintmax_t >(makedev(stx.stx_dev_major, stx.stx_dev_minor));
+        result_mask |= static_cast< unsigned int >(file_attribute_mask::device);
+    }
+#else // defined(BOOST_FILESYSTEM_USE_STATX)
+    struct ::stat st;
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    if (BOOST_UNLIKELY(::fstatat(basedir_fd, p.c_str(), &st, (follow_symlinks ? 0 : AT_SYMLINK_NOFOLLOW) | AT_NO_AUTOMOUNT) < 0))
+#else
+    if (BOOST_UNLIKELY((follow_symlinks ? ::stat(p.c_str(), &st) : ::lstat(p.c_str(), &st)) < 0))
+#endif
+    {
+        emit_error(errno, p, ec, "boost::filesystem::query");
+        return attrs;
+    }
+
+    ftype = detail::make_file_status(st.st_mode).type();
+    prms = static_cast< perms >(st.st_mode) & fs::perms_mask;
+    attrs.size = st.st_size;
+    attrs.last_write_time = st.st_mtime;
+    attrs.last_access_time = st.st_atime;
+#if defined(BOOST_FILESYSTEM_HAS_STAT_ST_MTIM)
+    attrs.last_write_time_nsec = static_cast< boost::uint32_t >(st.st_mtim.tv_nsec);
+    attrs.last_access_time_nsec = static_cast< boost::uint32_t >(st.st_atim.tv_nsec);
+#elif defined(BOOST_FILESYSTEM_HAS_STAT_ST_MTIMESPEC)
+    attrs.last_write_time_nsec = static_cast< boost::uint32_t >(st.st_mtimespec.tv_nsec);
+    attrs.last_access_time_nsec = static_cast< boost::uint32_t >(st.st_atimespec.tv_nsec);
+#elif defined(BOOST_FILESYSTEM_HAS_STAT_ST_MTIMENSEC)
+    attrs.last_write_time_nsec = static_cast< boost::uint32_t >(st.st_mtimensec);
+    attrs.last_access_time_nsec = static_cast< boost::uint32_t >(st.st_atimensec);
+#endif
+    attrs.hard_link_count = st.st_nlink;
+    attrs.inode = st.st_ino;
+    attrs.device = st.st_dev;
+    attrs.owner_id = st.st_uid;
+    attrs.group_id = st.st_gid;
+    result_mask = mask & ~static_cast< unsigned int >(file_attribute_mask::creation_time);
+#if !defined(BOOST_FILESYSTEM_USE_WASI)
+    attrs.allocated_size = static_cast< uintmax_t >(st.st_blocks) * 512u;
+#else
+    result_mask &= ~static_cast< unsigned int >(file_attribute_mask::allocated_size);
+#endif
+#if defined(BOOST_FILESYSTEM_STAT_ST_BIRTHTIME) && defined(BOOST_FILESYSTEM_STAT_ST_BIRTHTIMENSEC)
+    attrs.creation_time = st.BOOST_FILESYSTEM_STAT_ST_BIRTHTIME;
+    attrs.creation_time_nsec = static_cast< boost::uint32_t >(st.BOOST_FILESYSTEM_STAT_ST_BIRTHTIMENSEC);
+    result_mask |= mask & static_cast< unsigned int >(file_attribute_mask::creation_time);
+#endif
+#endif // defined(BOOST_FILESYSTEM_USE_STATX)
+
+    if ((result_mask & static_cast< unsigned int >(file_attribute_mask::type)) == 0u)
+        ftype = fs::status_error;
+    if ((result_mask & static_cast< unsigned int >(file_attribute_mask::permissions)) == 0u)
+        prms = fs::perms_not_known;
+    attrs.status = fs::file_status(ftype, prms);
+
+    attrs.mask = static_cast< BOOST_SCOPED_ENUM_NATIVE(file_attribute_mask) >(result_mask);
+    return attrs;
+}
+
+#else // defined(BOOST_POSIX_API)
+
+/*!
+ * query() implementation based on NtQueryInformationByName(FileStatInformation), which does not require opening a handle
+ * to the file. The query does not follow reparse points and does not provide the volume serial number, so the handle-based
+ * implementation is used for symlinks, unless \c file_attribute_mask::no_follow is specified, and when the device is requested.
+ */
+status_by_name_result query_by_name(path const& p, unsigned int mask, file_attributes& attrs, error_code* ec)
+{
+    const bool follow_symlinks = (mask & static_cast< unsigned int >(file_attribute_mask::no_follow)) == 0u;
+    mask &= static_cast< unsigned int >(file_attribute_mask::all);
+    if ((mask & static_cast< unsigned int >(file_attribute_mask::device)) != 0u)
+        return status_by_name_fallback;
+
+    file_stat_information info;
+    const boost::winapi::NTSTATUS_ status = query_stat_information_by_name(p, info);
+    if (BOOST_UNLIKELY(!NT_SUCCESS(status)))
+    {
+        if (is_not_found_ntstatus(status))
+        {
+            emit_error(translate_ntstatus(status), p, ec, "boost::filesystem::query");
+            return status_by_name_failure;
+        }
+
+        return status_by_name_fallback;
+    }
+
+    if ((info.FileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0u && follow_symlinks)
+        return status_by_name_fallback;
+
+    fs::file_type ftype = fs::status_error;
+    if ((mask & static_cast< unsigned int >(file_attribute_mask::type)) != 0u)
+    {
+        if ((info.FileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0u)
+            ftype = is_reparse_point_tag_a_symlink(info.ReparseTag) ? fs::symlink_file : fs::reparse_file;
+        else
+            ftype = (info.FileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0u ? fs::directory_file : fs::regular_file;
+    }
+    perms prms = fs::perms_not_known;
+    if ((mask & static_cast< unsigned int >(file_attribute_mask::permissions)) != 0u)
+        prms = make_permissions(p, info.FileAttributes);
+    attrs.status = fs::file_status(ftype, prms);
+
+    attrs.size = static_cast< uintmax_t >(info.EndOfFile.QuadPart);
+    file_time t = to_file_time(info.LastWriteTime);
+    attrs.last_write_time = t.seconds;
+    attrs.last_write_time_nsec = t.nanoseconds;
+    t = to_file_time(info.LastAccessTime);
+    attrs.last_access_time = t.seconds;
+    attrs.last_access_time_nsec = t.nanoseconds;
+    t = to_file_time(info.CreationTime);
+    attrs.creation_time = t.seconds;
+    attrs.creation_time_nsec = t.nanoseconds;
+    attrs.hard_link_count = info.NumberOfLinks;
+    attrs.inode = static_cast< uintmax_t >(info.FileId.QuadPart);
+    attrs.allocated_size = static_cast< uintmax_t >(info.AllocationSize.QuadPart);
+    // File ownership is not represented by numeric ids on Windows
+    attrs.mask = static_cast< BOOST_SCOPED_ENUM_NATIVE(file_attribute_mask) >(mask & ~static_cast< unsigned int >(file_attribute_mask::owner));
+    return status_by_name_success;
+}
+
+//! query() implementation for an open file handle
+file_attributes query_by_handle(HANDLE h, path const& p, unsigned int mask, error_code* ec)
+{
+    file_attributes attrs;
+    unsigned int result_mask = 0u;
+    mask &= static_cast< unsigned int >(file_attribute_mask::all);
+
+    // All attributes are available through a single GetFileInformationByHandle call
+    BY_HANDLE_FILE_INFORMATION info;
+    if (BOOST_UNLIKELY(!::GetFileInformationByHandle(h, &info)))
+    {
+        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::query");
+        return attrs;
+    }
+
+    fs::file_type ftype = fs::status_error;
+    if ((mask & static_cast< unsigned int >(file_attribute_mask::type)) != 0u)
+    {
+        if ((info.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0u)
+            ftype = is_reparse_point_a_symlink_ioctl(h) ? fs::symlink_file : fs::reparse_file;
+        else
+            ftype = (info.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0u ? fs::directory_file : fs::regular_file;
+    }
+    perms prms = fs::perms_not_known;
+    if ((mask & static_cast< unsigned int >(file_attribute_mask::permissions)) != 0u)
+        prms = make_permissions(p, info.dwFileAttributes);
+    attrs.status = fs::file_status(ftype, prms);
+
+    attrs.size = (static_cast< uintmax_t >(info.nFileSizeHigh) << 32u) | info.nFileSizeLow;
+    file_time t = to_file_time(info.ftLastWriteTime);
+    attrs.last_write_time = t.seconds;
+    attrs.last_write_time_nsec = t.nanoseconds;
+    t = to_file_time(info.ftLastAccessTime);
+    attrs.last_access_time = t.seconds;
+    attrs.last_access_time_nsec = t.nanoseconds;
+    t = to_file_time(info.ftCreationTime);
+    attrs.creation_time = t.seconds;
+    attrs.creation_time_nsec = t.nanoseconds;
+    attrs.hard_link_count = info.nNumberOfLinks;
+    attrs.inode = (static_cast< uintmax_t >(info.nFileIndexHigh) << 32u) | info.nFileIndexLow;
+    attrs.device = info.dwVolumeSerialNumber;
+    // File ownership is not represented by numeric ids on Windows
+    result_mask = mask & ~static_cast< unsigned int >(file_attribute_mask::owner | file_attribute_mask::allocated_size);
+
+    if ((mask & static_cast< unsigned int >(file_attribute_mask::allocated_size)) != 0u)
+    {
+        // Allocation size is only available through GetFileInformationByHandleEx, which is not supported before Windows Vista
+        GetFileInformationByHandleEx_t* get_file_information_by_handle_ex = filesystem::detail::atomic_load_relaxed(get_file_information_by_handle_ex_api);
+        file_standard_info std_info;
+        if (BOOST_LIKELY(get_file_information_by_handle_ex != NULL) &&
+            get_file_information_by_handle_ex(h, file_standard_info_class, &std_info, sizeof(std_info)))
+        {
+            attrs.allocated_size = static_cast< uintmax_t >(std_info.AllocationSize.QuadPart);
+            result_mask |= static_cast< unsigned int >(file_attribute_mask::allocated_size);
+        }
+    }
+
+    attrs.mask = static_cast< BOOST_SCOPED_ENUM_NATIVE(file_attribute_mask) >(result_mask);
+    return attrs;
+}
+
+#endif // defined(BOOST_POSIX_API)
+
+} // unnamed namespace
+
+BOOST_FILESYSTEM_DECL
+file_attributes query(path const& p, unsigned int mask, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_POSIX_API)
+
+    return query_impl(p, mask, ec);
+
+#else // defined(BOOST_POSIX_API)
+
+    // Most attributes can be obtained without opening a handle, which is expensive on Windows
+    {
+        file_attributes attrs;
+        const status_by_name_result res = query_by_name(p, mask, attrs, ec);
+        if (res == status_by_name_success)
+            return attrs;
+        if (res == status_by_name_failure)
+            return file_attributes();
+    }
+
+    const bool follow_symlinks = (mask & static_cast< unsigned int >(file_attribute_mask::no_follow)) == 0u;
+    handle_wrapper h(create_file_handle(
+        p.c_str(),
+        FILE_READ_ATTRIBUTES,
+        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | (follow_symlinks ? 0u : FILE_FLAG_OPEN_REPARSE_POINT)));
+
+    if (BOOST_UNLIKELY(h.handle == INVALID_HANDLE_VALUE))
+    {
+        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::query");
+        return file_attributes();
+    }
+
+    return query_by_handle(h.handle, p, mask, ec);
+
+#endif // defined(BOOST_POSIX_API)
+}
+
+BOOST_FILESYSTEM_DECL
+file_time precise_last_write_time(path const& p, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_POSIX_API)
+
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    struct ::statx stx;
+    if (BOOST_UNLIKELY(invoke_statx(AT_FDCWD, p.c_str(), AT_NO_AUTOMOUNT, STATX_MTIME, &stx) < 0))
+    {
+        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::last_write_time");
+        return file_time((std::numeric_limits< std::time_t >::min)());
+    }
+    if (BOOST_UNLIKELY((stx.stx_mask & STATX_MTIME) != STATX_MTIME))
+    {
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::last_write_time");
+        return file_time((std::numeric_limits< std::time_t >::min)());
+    }
+    return file_time(stx.stx_mtime.tv_sec, stx.stx_mtime.tv_nsec);
+#else
+    struct ::stat st;
+    if (BOOST_UNLIKELY(::stat(p.c_str(), &st) < 0))
+    {
+        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::last_write_time");
+        return file_time((std::numeric_limits< std::time_t >::min)());
+    }
+#if defined(BOOST_FILESYSTEM_STAT_ST_MTIMENSEC)
+    return file_time(st.st_mtime, static_cast< boost::uint32_t >(st.BOOST_FILESYSTEM_STAT_ST_MTIMENSEC));
+#else
+    return file_time(st.st_mtime);
+#endif
+#endif
+
+#else // defined(BOOST_POSIX_API)
+
+    handle_wrapper hw(create_file_handle(
+        p.c_str(),
+        FILE_READ_ATTRIBUTES,
+        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS));
+
+    if (BOOST_UNLIKELY(hw.handle == INVALID_HANDLE_VALUE))
+    {
+    fail:
+        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::last_write_time");
+        return file_time((std::numeric_limits< std::time_t >::min)());
+    }
+
+    FILETIME lwt;
+
+    if (BOOST_UNLIKELY(!::GetFileTime(hw.handle, NULL, NULL, &lwt)))
+        goto fail;
+
+    return to_file_time(lwt);
+
+#endif // defined(BOOST_POSIX_API)
+}
+
+BOOST_FILESYSTEM_DECL
+std::time_t last_write_time(path const& p, system::error_code* ec)
+{
+    return precise_last_write_time(p, ec).seconds;
+}
+
+BOOST_FILESYSTEM_DECL
+void last_write_time(path const& p, file_time const& new_time, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_POSIX_API)
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+
+    struct timespec times[2] = {};
+
+    // Keep the last access time unchanged
+    times[0].tv_nsec = UTIME_OMIT;
+
+    times[1].tv_sec = new_time.seconds;
+    times[1].tv_nsec = new_time.nanoseconds;
+
+    if (BOOST_UNLIKELY(::utimensat(AT_FDCWD, p.c_str(), times, 0) != 0))
+    {
+        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::last_write_time");
+        return;
+    }
+
+#else // defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+
+    struct ::stat st;
+    if (BOOST_UNLIKELY(::stat(p.c_str(), &st) < 0))
+    {
+        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::last_write_time");
+        return;
+    }
+
+    ::utimbuf buf;
+    buf.actime = st.st_atime; // utime() updates access time too :-(
+    buf.modtime = new_time.seconds;
+    if (BOOST_UNLIKELY(::utime(p.c_str(), &buf) < 0))
+        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::last_write_time");
+
+#endif // defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+
+#else // defined(BOOST_POSIX_API)
+
+    handle_wrapper hw(create_file_handle(
+        p.c_str(),
+        FILE_WRITE_ATTRIBUTES,
+        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS));
+
+    if (BOOST_UNLIKELY(hw.handle == INVALID_HANDLE_VALUE))
+    {
+    fail:
+        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::last_write_time");
+        return;
+    }
+
+    FILETIME lwt;
+    to_FILETIME(new_time, lwt);
+
+    if (BOOST_UNLIKELY(!::SetFileTime(hw.handle, NULL, NULL, &lwt)))
+        goto fail;
+
+#endif // defined(BOOST_POSIX_API)
+}
+
+BOOST_FILESYSTEM_DECL
+void last_write_time(path const& p, const std::time_t new_time, system::error_code* ec)
+{
+    last_write_time(p, file_time(new_time), ec);
+}
+
+#ifdef BOOST_POSIX_API
+const perms active_bits(all_all | set_uid_on_exe | set_gid_on_exe | sticky_bit);
+inline mode_t mode_cast(perms prms)
+{
+    return prms & active_bits;
+}
+#endif
+
+BOOST_FILESYSTEM_DECL
+void permissions(path const& p, perms prms, system::error_code* ec)
+{
+    BOOST_ASSERT_MSG(!((prms & add_perms) && (prms & remove_perms)), "add_perms and remove_perms are mutually exclusive");
+
+    if ((prms & add_perms) && (prms & remove_perms)) // precondition failed
+        return;
+
+#if defined(BOOST_FILESYSTEM_USE_WASI)
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::permissions");
+#elif defined(BOOST_POSIX_API)
+    error_code local_ec;
+    file_status current_status((prms & symlink_perms) ? detail::symlink_status_impl(p, &local_ec) : detail::status_impl(p, &local_ec));
+    if (local_ec)
+    {
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::permissions", p, local_ec));
+
+        *ec = local_ec;
+        return;
+    }
+
+    if (prms & add_perms)
+        prms |= current_status.permissions();
+    else if (prms & remove_perms)
+        prms = current_status.permissions() & ~prms;
+
+    // OS X <10.10, iOS <8.0 and some other platforms don't support fchmodat().
+    // Solaris (SunPro and gcc) only support fchmodat() on Solaris 11 and higher,
+    // and a runtime check is too much trouble.
+    // Linux does not support permissions on symbolic links and has no plans to
+    // support them in the future.  The chmod() code is thus more practical,
+    // rather than always hitting ENOTSUP when sending in AT_SYMLINK_NO_FOLLOW.
+    //  - See the 3rd paragraph of
+    // "Symbolic link ownership, permissions, and timestamps" at:
+    //   "http://man7.org/linux/man-pages/man7/symlink.7.html"
+    //  - See the fchmodat() Linux man page:
+    //   "http://man7.org/linux/man-pages/man2/fchmodat.2.html"
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) && \
+    !(defined(__SUNPRO_CC) || defined(__sun) || defined(sun)) && \
+    !(defined(linux) || defined(__linux) || defined(__linux__)) && \
+    !(defined(__MAC_OS_X_VERSION_MIN_REQUIRED) && __MAC_OS_X_VERSION_MIN_REQUIRED < 101000) && \
+    !(defined(__IPHONE_OS_VERSION_MIN_REQUIRED) && __IPHONE_OS_VERSION_MIN_REQUIRED < 80000) && \
+    !(defined(__rtems__)) && \
+    !(defined(__QNX__) && (_NTO_VERSION <= 700))
+    if (::fchmodat(AT_FDCWD, p.c_str(), mode_cast(prms), !(prms & symlink_perms) ? 0 : AT_SYMLINK_NOFOLLOW))
+#else // fallback if fchmodat() not supported
+    if (::chmod(p.c_str(), mode_cast(prms)))
+#endif
+    {
+        const int err = errno;
+        if (!ec)
+        {
+            BOOST_FILESYSTEM_THROW(filesystem_error(
+                "boost::filesystem::permissions", p, error_code(err, system::generic_category())));
+        }
+
+        ec->assign(err, system::generic_category());
+    }
+
+#else // Windows
+
+    // if not going to alter FILE_ATTRIBUTE_READONLY, just return
+    if (!(!((prms & (add_perms | remove_perms))) || (prms & (owner_write | group_write | others_write))))
+        return;
+
+    DWORD attr = ::GetFileAttributesW(p.c_str());
+
+    if (error(attr == 0 ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::permissions"))
+        return;
+
+    if (prms & add_perms)
+        attr &= ~FILE_ATTRIBUTE_READONLY;
+    else if (prms & remove_perms)
+        attr |= FILE_ATTRIBUTE_READONLY;
+    else if (prms & (owner_write | group_write | others_write))
+        attr &= ~FILE_ATTRIBUTE_READONLY;
+    else
+        attr |= FILE_ATTRIBUTE_READONLY;
+
+    error(::SetFileAttributesW(p.c_str(), attr) == 0 ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::permissions");
+#endif
+}
+
+namespace {
+
+//! Applies the file attributes selected by \a attrs to \a p, returns the error code
+err_t set_attributes_impl(path const& p, file_attribute_set const& attrs) BOOST_NOEXCEPT
+{
+    const unsigned int mask = static_cast< unsigned int >(attrs.mask);
+    const bool set_perms = (mask & static_cast< unsigned int >(file_attribute_mask::permissions)) != 0u;
+    const bool set_mtime = (mask & static_cast< unsigned int >(file_attribute_mask::last_write_time)) != 0u;
+    const bool set_atime = (mask & static_cast< unsigned int >(file_attribute_mask::last_access_time)) != 0u;
+    const bool set_owner = (mask & static_cast< unsigned int >(file_attribute_mask::owner)) != 0u;
+
+    if (!set_perms && !set_mtime && !set_atime && !set_owner)
+        return 0;
+
+#if defined(BOOST_FILESYSTEM_USE_WASI)
+
+    if (set_perms || set_owner)
+        return BOOST_ERROR_NOT_SUPPORTED;
+
+#endif
+
+#if defined(BOOST_POSIX_API)
+
+    // Open the file once and apply all attributes through the descriptor. O_NONBLOCK prevents blocking on FIFOs.
+    int flags = O_RDONLY | O_NONBLOCK | O_NOCTTY;
+#if defined(O_CLOEXEC)
+    flags |= O_CLOEXEC;
+#endif
+    fd_wrapper file(::open(p.c_str(), flags));
+    if (BOOST_UNLIKELY(file.fd < 0))
+    {
+        const int err = errno;
+        // The file may not be readable by the current user (e.g. if its permissions were already set), or
+        // it may be a special file that cannot be opened. Fall back to the path-based functions in this case.
+        if (err != EACCES && err != EPERM && err != ENXIO && err != EOPNOTSUPP && err != EWOULDBLOCK)
+            return err;
+    }
+
+    // The owner is changed first as the change may reset set-user-ID and set-group-ID permission bits.
+    // The times are changed last as changing owner or permissions may update them on some filesystems.
+    if (set_owner)
+    {
+        const uid_t uid = attrs.owner_id != file_attribute_set::unchanged_id ? static_cast< uid_t >(attrs.owner_id) : static_cast< uid_t >(-1);
+        const gid_t gid = attrs.group_id != file_attribute_set::unchanged_id ? static_cast< gid_t >(attrs.group_id) : static_cast< gid_t >(-1);
+        if (BOOST_UNLIKELY((file.fd >= 0 ? ::fchown(file.fd, uid, gid) : ::chown(p.c_str(), uid, gid)) != 0))
+            return errno;
+    }
+
+    if (set_perms)
+    {
+        const mode_t mode = mode_cast(attrs.permissions);
+        if (BOOST_UNLIKELY((file.fd >= 0 ? ::fchmod(file.fd, mode) : ::chmod(p.c_str(), mode)) != 0))
+            return errno;
+    }
+
+    if (set_mtime || set_atime)
+    {
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+        struct timespec times[2] = {};
+        if (set_atime)
+        {
+            times[0].tv_sec = attrs.last_access_time.seconds;
+            times[0].tv_nsec = attrs.last_access_time.nanoseconds;
+        }
+        else
+        {
+            times[0].tv_nsec = UTIME_OMIT;
+        }
+
+        if (set_mtime)
+        {
+            times[1].tv_sec = attrs.last_write_time.seconds;
+            times[1].tv_nsec = attrs.last_write_time.nanoseconds;
+        }
+        else
+        {
+            times[1].tv_nsec = UTIME_OMIT;
+        }
+
+        if (BOOST_UNLIKELY((file.fd >= 0 ? ::futimens(file.fd, times) : ::utimensat(AT_FDCWD, p.c_str(), times, 0)) != 0))
+            return errno;
+#else // defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+        ::utimbuf buf;
+        if (!set_atime || !set_mtime)
+        {
+            struct ::stat st;
+            if (BOOST_UNLIKELY((file.fd >= 0 ? ::fstat(file.fd, &st) : ::stat(p.c_str(), &st)) != 0))
+                return errno;
+
+            buf.actime = st.st_atime;
+            buf.modtime = st.st_mtime;
+        }
+
+        if (set_atime)
+            buf.actime = attrs.last_access_time.seconds;
+        if (set_mtime)
+            buf.modtime = attrs.last_write_time.seconds;
+
+        if (BOOST_UNLIKELY(::utime(p.c_str(), &buf) != 0))
+            return errno;
+#endif // defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    }
+
+    return 0;
+
+#else // defined(BOOST_POSIX_API)
+
+    // File ownership is not represented by numeric ids on Windows
+    if (set_owner)
+        return ERROR_NOT_SUPPORTED;
+
+    handle_wrapper h(create_file_handle(
+        p.c_str(),
+        FILE_READ_ATTRIBUTES | FILE_WRITE_ATTRIBUTES,
+        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS));
+
+    if (BOOST_UNLIKELY(h.handle == INVALID_HANDLE_VALUE))
+        return ::GetLastError();
+
+    if (set_mtime || set_atime)
+    {
+        FILETIME lwt, lat;
+        if (set_mtime)
+            to_FILETIME(attrs.last_write_time, lwt);
+        if (set_atime)
+            to_FILETIME(attrs.last_access_time, lat);
+
+        if (BOOST_UNLIKELY(!::SetFileTime(h.handle, NULL, set_atime ? &lat : NULL, set_mtime ? &lwt : NULL)))
+            return ::GetLastError();
+    }
+
+    if (set_perms)
+    {
+        BY_HANDLE_FILE_INFORMATION info;
+        if (BOOST_UNLIKELY(!::GetFileInformationByHandle(h.handle, &info)))
+            return ::GetLastError();
+
+        // Permissions are represented by FILE_ATTRIBUTE_READONLY
+        DWORD attr = info.dwFileAttributes;
+        if ((attrs.permissions & (owner_write | group_write | others_write)) != 0)
+            attr &= ~static_cast< DWORD >(FILE_ATTRIBUTE_READONLY);
+        else
+            attr |= FILE_ATTRIBUTE_READONLY;
+
+        if (attr != info.dwFileAttributes)
+        {
+            SetFileInformationByHandle_t* set_file_information_by_handle = filesystem::detail::atomic_load_relaxed(set_file_information_by_handle_api);
+            if (BOOST_LIKELY(set_file_information_by_handle != NULL))
+            {
+                // Zero times are left unchanged by the call, zero attributes are also ignored
+                file_basic_info basic_info = {};
+                basic_info.FileAttributes = attr != 0u ? attr : static_cast< DWORD >(FILE_ATTRIBUTE_NORMAL);
+                if (BOOST_UNLIKELY(!set_file_information_by_handle(h.handle, file_basic_info_class, &basic_info, sizeof(basic_info))))
+                    return ::GetLastError();
+            }
+            else if (BOOST_UNLIKELY(!::SetFileAttributesW(p.c_str(), attr)))
+            {
+                return ::GetLastError();
+            }
+        }
+    }
+
+    return 0;
+
+#endif // defined(BOOST_POSIX_API)
+}
+
+} // unnamed namespace
+
+BOOST_FILESYSTEM_DECL
+void set_attributes(path const& p, file_attribute_set const& attrs, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    const err_t err = set_attributes_impl(p, attrs);
+    if (BOOST_UNLIKELY(err != 0))
+        emit_error(err, p, ec, "boost::filesystem::set_attributes");
+}
+
+BOOST_FILESYSTEM_DECL
+void set_attributes_batch(path const* paths, file_attribute_set const* attrs, std::size_t count, system::error_code* results)
+{
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+        const err_t err = set_attributes_impl(paths[i], attrs[i]);
+        if (BOOST_LIKELY(err == 0))
+            results[i].clear();
+        else
+            results[i].assign(err, system::system_category());
+    }
+}
+
+namespace {
+
+//! Size of the first chunk to read from files that do not report their size, such as files in procfs
+BOOST_CONSTEXPR_OR_CONST std::size_t read_file_min_chunk_size = 4096u;
+//! Maximum number of bytes to read or write in one call. Some systems fail reads and writes of more than INT_MAX bytes.
+BOOST_CONSTEXPR_OR_CONST std::size_t file_io_max_chunk_size = 1u << 30;
+//! Maximum number of attempts to create a uniquely named temporary file
+BOOST_CONSTEXPR_OR_CONST unsigned int max_temp_file_attempts = 16u;
+
+//! Generates a name of a temporary file in the same directory as \a p
+err_t make_temp_file_name(path const& p, path& temp)
+{
+    error_code ec;
+    path unique = detail::unique_path(path("%%%%%%%%%%%%%%%%"), &ec);
+    if (BOOST_UNLIKELY(!!ec))
+        return static_cast< err_t >(ec.value());
+
+    path name(".");
+    name += p.filename();
+    name += ".";
+    name += unique;
+    name += ".tmp";
+
+    temp = p.parent_path();
+    temp /= name;
+    return 0;
+}
+
+//! Reads the contents of \a p into \a contents, returns the error code
+err_t read_file_impl(path const& p, std::string& contents)
+{
+    contents.clear();
+
+#if defined(BOOST_POSIX_API)
+
+    fd_wrapper file(::open(p.c_str(), O_RDONLY | O_NOCTTY | O_CLOEXEC));
+    if (BOOST_UNLIKELY(file.fd < 0))
+        return errno;
+
+    struct ::stat st;
+    if (BOOST_UNLIKELY(::fstat(file.fd, &st) != 0))
+        return errno;
+
+    if (BOOST_UNLIKELY(S_ISDIR(st.st_mode)))
+        return EISDIR;
+
+    const bool size_known = S_ISREG(st.st_mode) && st.st_size > 0;
+    if (size_known && BOOST_UNLIKELY(static_cast< boost::uintmax_t >(st.st_size) > static_cast< boost::uintmax_t >(contents.max_size())))
+        return EFBIG;
+
+    const std::size_t expected_size = size_known ? static_cast< std::size_t >(st.st_size) : static_cast< std::size_t >(0u);
+
+#else // defined(BOOST_POSIX_API)
+
+    handle_wrapper file(create_file_handle(
+        p.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN));
+
+    if (BOOST_UNLIKELY(file.handle == INVALID_HANDLE_VALUE))
+        return ::GetLastError();
+
+    LARGE_INTEGER file_size;
+    const bool size_known = ::GetFileType(file.handle) == FILE_TYPE_DISK && ::GetFileSizeEx(file.handle, &file_size) && file_size.QuadPart > 0;
+    if (size_known && BOOST_UNLIKELY(static_cast< boost::uint64_t >(file_size.QuadPart) > static_cast< boost::uint64_t >(contents.max_size())))
+        return ERROR_FILE_TOO_LARGE;
+
+    const std::size_t expected_size = size_known ? static_cast< std::size_t >(file_size.QuadPart) : static_cast< std::size_t >(0u);
+
+#endif // defined(BOOST_POSIX_API)
+
+    // Files with generated content, like the ones in procfs or sysfs, may report zero or an arbitrary size. For such files,
+    // keep reading until EOF. For regular files, the size is obtained from the opened file, and the file is read until
+    // either the reported size is reached or EOF, whichever happens first.
+    std::size_t size = size_known ? expected_size : read_file_min_chunk_size;
+    std::size_t pos = 0u;
+    contents.resize(size);
+    while (true)
+    {
+        if (pos == size)
+        {
+            if (size_known)
+                break;
+
+            if (BOOST_UNLIKELY(size > contents.max_size() / 2u))
+            {
+                contents.clear();
+#if defined(BOOST_POSIX_API)
+                return EFBIG;
+#else
+                return ERROR_FILE_TOO_LARGE;
+#endif
+            }
+
+            size *= 2u;
+            contents.resize(size);
+        }
+
+        std::size_t chunk_size = size - pos;
+        if (chunk_size > file_io_max_chunk_size)
+            chunk_size = file_io_max_chunk_size;
+
+#if defined(BOOST_POSIX_API)
+        const ssize_t sz_read = ::read(file.fd, &contents[pos], chunk_size);
+        if (BOOST_UNLIKELY(sz_read < 0))
+        {
+            const int err = errno;
+            if (err == EINTR)
+                continue;
+
+            contents.clear();
+            return err;
+        }
+#else
+        DWORD sz_read = 0u;
+        if (BOOST_UNLIKELY(!::ReadFile(file.handle, &contents[pos], static_cast< DWORD >(chunk_size), &sz_read, NULL)))
+        {
+            const DWORD err = ::GetLastError();
+            // Reading from a pipe whose write end was closed indicates EOF
+            if (err == ERROR_BROKEN_PIPE)
+                break;
+
+            contents.clear();
+            return err;
+        }
+#endif
+
+        if (sz_read == 0)
+            break;
+
+        pos += static_cast< std::size_t >(sz_read);
+    }
+
+    contents.resize(pos);
+    return 0;
+}
+
+#if defined(BOOST_POSIX_API)
+
+//! Writes \a size bytes from \a data to the file, returns the error code
+int write_all(int fd, const char* data, std::size_t size)
+{
+    for (std::size_t pos = 0u; pos < size;)
+    {
+        std::size_t chunk_size = size - pos;
+        if (chunk_size > file_io_max_chunk_size)
+            chunk_size = file_io_max_chunk_size;
+
+        const ssize_t sz = ::write(fd, data + pos, chunk_size);
+        if (BOOST_UNLIKELY(sz < 0))
+        {
+            const int err = errno;
+            if (err == EINTR)
+                continue;
+
+            return err;
+        }
+
+        pos += static_cast< std::size_t >(sz);
+    }
+
+    return 0;
+}
+
+//! Creates a uniquely named temporary file in the directory of \a p that will replace \a p. The permissions of \a p, if it exists, are applied to the file.
+int create_replacement_file(path const& p, path& temp, fd_wrapper& file)
+{
+    const mode_t default_mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
+    bool preserve_mode = false;
+    mode_t mode = 0;
+
+    struct ::stat st;
+    if (::stat(p.c_str(), &st) == 0)
+    {
+        if (S_ISREG(st.st_mode))
+        {
+            preserve_mode = true;
+            mode = st.st_mode & static_cast< mode_t >(active_bits);
+        }
+    }
+    else
+    {
+        const int err = errno;
+        if (err != ENOENT)
+            return err;
+    }
+
+    for (unsigned int attempt = 0u;; ++attempt)
+    {
+        int err = make_temp_file_name(p, temp);
+        if (BOOST_UNLIKELY(err != 0))
+            return err;
+
+        file.fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_NOCTTY | O_CLOEXEC, default_mode);
+        if (BOOST_LIKELY(file.fd >= 0))
+            break;
+
+        err = errno;
+        if (err != EEXIST || attempt >= max_temp_file_attempts)
+            return err;
+    }
+
+    if (preserve_mode && BOOST_UNLIKELY(::fchmod(file.fd, mode) != 0))
+    {
+        const int err = errno;
+        close_fd(file.fd);
+        file.fd = -1;
+        ::unlink(temp.c_str());
+        return err;
+    }
+
+    return 0;
+}
+
+//! Synchronizes the directory to make renames of its entries durable. Not all filesystems support synchronizing directories, so errors are ignored.
+void sync_directory(path const& dir)
+{
+    fd_wrapper file(::open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_CLOEXEC));
+    if (file.fd >= 0)
+        full_sync(file.fd);
+}
+
+#else // defined(BOOST_POSIX_API)
+
+//! Writes \a size bytes from \a data to the file, returns the error code
+DWORD write_all(HANDLE h, const char* data, std::size_t size)
+{
+    for (std::size_t pos = 0u; pos < size;)
+    {
+        std::size_t chunk_size = size - pos;
+        if (chunk_size > file_io_max_chunk_size)
+            chunk_size = file_io_max_chunk_size;
+
+        DWORD sz = 0u;
+        if (BOOST_UNLIKELY(!::WriteFile(h, data + pos, static_cast< DWORD >(chunk_size), &sz, NULL)))
+            return ::GetLastError();
+
+        pos += sz;
+    }
+
+    return 0u;
+}
+
+//! Creates a uniquely named temporary file in the directory of \a p that will replace \a p
+DWORD create_replacement_file(path const& p, path& temp, handle_wrapper& file)
+{
+    for (unsigned int attempt = 0u;; ++attempt)
+    {
+        DWORD err = make_temp_file_name(p, temp);
+        if (BOOST_UNLIKELY(err != 0u))
+            return err;
+
+        file.handle = create_file_handle(temp, GENERIC_WRITE, 0u, NULL, CREATE_NEW, FILE_ATTRIBUTE_NORMAL);
+        if (BOOST_LIKELY(file.handle != INVALID_HANDLE_VALUE))
+            return 0u;
+
+        err = ::GetLastError();
+        if ((err != ERROR_FILE_EXISTS && err != ERROR_ALREADY_EXISTS) || attempt >= max_temp_file_attempts)
+            return err;
+    }
+}
+
+#endif // defined(BOOST_POSIX_API)
+
+//! Writes \a size bytes from \a data to the file \a p, returns the error code
+err_t write_file_impl(path const& p, const void* data, std::size_t size, unsigned int options)
+{
+    const bool append = (options & static_cast< unsigned int >(write_file_options::append)) != 0u;
+    const bool atomic_replace = (options & static_cast< unsigned int >(write_file_options::atomic_replace)) != 0u;
+    const bool sync_all = (options & static_cast< unsigned int >(write_file_options::synchronize)) != 0u;
+    const bool sync_data = (options & static_cast< unsigned int >(write_file_options::synchronize_data)) != 0u;
+
+    path temp;
+
+#if defined(BOOST_POSIX_API)
+
+    if (BOOST_UNLIKELY(append && atomic_replace))
+        return EINVAL;
+
+    fd_wrapper file;
+    int err;
+    if (atomic_replace)
+    {
+        err = create_replacement_file(p, temp, file);
+        if (BOOST_UNLIKELY(err != 0))
+            return err;
+    }
+    else
+    {
+        file.fd = ::open(p.c_str(), O_WRONLY | O_CREAT | O_NOCTTY | O_CLOEXEC | (append ? O_APPEND : O_TRUNC), S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+        if (BOOST_UNLIKELY(file.fd < 0))
+            return errno;
+    }
+
+    err = write_all(file.fd, static_cast< const char* >(data), size);
+
+    if (err == 0 && (sync_all || sync_data))
+        err = sync_all ? full_sync(file.fd) : data_sync(file.fd);
+
+    // Some filesystems, e.g. NFS, report write errors on close
+    const int close_res = close_fd(file.fd);
+    file.fd = -1;
+    if (err == 0 && BOOST_UNLIKELY(close_res != 0))
+        err = errno;
+
+    if (atomic_replace)
+    {
+        if (err == 0 && BOOST_UNLIKELY(::rename(temp.c_str(), p.c_str()) != 0))
+            err = errno;
+
+        if (BOOST_UNLIKELY(err != 0))
+            ::unlink(temp.c_str());
+        else if (sync_all)
+            sync_directory(p.parent_path());
+    }
+
+    return err;
+
+#else // defined(BOOST_POSIX_API)
+
+    if (BOOST_UNLIKELY(append && atomic_replace))
+        return ERROR_INVALID_PARAMETER;
+
+    handle_wrapper file;
+    DWORD err;
+    if (atomic_replace)
+    {
+        err = create_replacement_file(p, temp, file);
+        if (BOOST_UNLIKELY(err != 0u))
+            return err;
+    }
+    else
+    {
+        file.handle = create_file_handle(p, append ? FILE_APPEND_DATA : GENERIC_WRITE, FILE_SHARE_READ, NULL, append ? OPEN_ALWAYS : CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL);
+        if (BOOST_UNLIKELY(file.handle == INVALID_HANDLE_VALUE))
+            return ::GetLastError();
+    }
+
+    err = write_all(file.handle, static_cast< const char* >(data), size);
+
+    if (err == 0u && (sync_all || sync_data) && BOOST_UNLIKELY(!::FlushFileBuffers(file.handle)))
+        err = ::GetLastError();
+
+    ::CloseHandle(file.handle);
+    file.handle = INVALID_HANDLE_VALUE;
+
+    if (atomic_replace)
+    {
+        if (err == 0u && BOOST_UNLIKELY(!::MoveFileExW(temp.c_str(), p.c_str(), MOVEFILE_REPLACE_EXISTING | ((sync_all || sync_data) ? MOVEFILE_WRITE_THROUGH : 0u))))
+            err = ::GetLastError();
+
+        if (BOOST_UNLIKELY(err != 0u))
+            ::DeleteFileW(temp.c_str());
+    }
+
+    return err;
+
+#endif // defined(BOOST_POSIX_API)
+}
+
+//! Atomically replaces the contents of multiple files. Returns the error code and the index of the entry that caused the error.
+err_t atomic_commit_impl(atomic_write_entry const* entries, std::size_t count, unsigned int options, std::size_t& failed_index)
+{
+    const bool sync_all = (options & static_cast< unsigned int >(write_file_options::synchronize)) != 0u;
+    const bool sync_data = (options & static_cast< unsigned int >(write_file_options::synchronize_data)) != 0u;
+
+    failed_index = 0u;
+
+#if defined(BOOST_POSIX_API)
+    if (BOOST_UNLIKELY((options & static_cast< unsigned int >(write_file_options::append)) != 0u))
+        return EINVAL;
+#else
+    if (BOOST_UNLIKELY((options & static_cast< unsigned int >(write_file_options::append)) != 0u))
+        return ERROR_INVALID_PARAMETER;
+#endif
+
+    std::vector< path > temps(count);
+    // Number of temporary files created so far and the number of those already renamed to the target files
+    std::size_t created = 0u, renamed = 0u;
+    err_t err = 0;
+
+    // Write the new contents to temporary files. The files are synchronized after all writes are issued, so that
+    // the system is able to write back the data of multiple files at once.
+#if defined(BOOST_POSIX_API)
+    std::vector< int > files(count, -1);
+    for (; created < count; ++created)
+    {
+        fd_wrapper file;
+        err = create_replacement_file(entries[created].target, temps[created], file);
+        if (BOOST_UNLIKELY(err != 0))
+        {
+            failed_index = created;
+            goto done;
+        }
+
+        files[created] = file.fd;
+        file.fd = -1;
+
+        err = write_all(files[created], static_cast< const char* >(entries[created].data), entries[created].size);
+        if (BOOST_UNLIKELY(err != 0))
+        {
+            failed_index = created;
+            ++created;
+            goto done;
+        }
+    }
+
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+        if (sync_all || sync_data)
+        {
+            err = sync_all ? full_sync(files[i]) : data_sync(files[i]);
+            if (BOOST_UNLIKELY(err != 0))
+            {
+                failed_index = i;
+                goto done;
+            }
+        }
+
+        // Some filesystems, e.g. NFS, report write errors on close
+        const int close_res = close_fd(files[i]);
+        files[i] = -1;
+        if (BOOST_UNLIKELY(close_res != 0))
+        {
+            err = errno;
+            failed_index = i;
+            goto done;
+        }
+    }
+
+    for (; renamed < count; ++renamed)
+    {
+        if (BOOST_UNLIKELY(::rename(temps[renamed].c_str(), entries[renamed].target.c_str()) != 0))
+        {
+            err = errno;
+            failed_index = renamed;
+            goto done;
+        }
+    }
+
+    if (sync_all)
+    {
+        // Synchronize every affected directory once
+        std::vector< path > dirs;
+        dirs.reserve(count);
+        for (std::size_t i = 0u; i < count; ++i)
+            dirs.push_back(entries[i].target.parent_path());
+        std::sort(dirs.begin(), dirs.end());
+        dirs.erase(std::unique(dirs.begin(), dirs.end()), dirs.end());
+        for (std::size_t i = 0u, n = dirs.size(); i < n; ++i)
+            sync_directory(dirs[i]);
+    }
+
+done:
+    if (BOOST_UNLIKELY(err != 0))
+    {
+        for (std::size_t i = 0u; i < created; ++i)
+        {
+            if (files[i] >= 0)
+                close_fd(files[i]);
+        }
+        for (std::size_t i = renamed; i < created; ++i)
+            ::unlink(temps[i].c_str());
+    }
+
+#else // defined(BOOST_POSIX_API)
+    std::vector< HANDLE > files(count, INVALID_HANDLE_VALUE);
+    for (; created < count; ++created)
+    {
+        handle_wrapper file;
+        err = create_replacement_file(entries[created].target, temps[created], file);
+        if (BOOST_UNLIKELY(err != 0u))
+        {
+            failed_index = created;
+            goto done;
+        }
+
+        files[created] = file.handle;
+        file.handle = INVALID_HANDLE_VALUE;
+
+        err = write_all(files[created], static_cast< const char* >(entries[created].data), entries[created].size);
+        if (BOOST_UNLIKELY(err != 0u))
+        {
+            failed_index = created;
+            ++created;
+            goto done;
+        }
+    }
+
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+        if ((sync_all || sync_data) && BOOST_UNLIKELY(!::FlushFileBuffers(files[i])))
+        {
+            err = ::GetLastError();
+            failed_index = i;
+            goto done;
+        }
+
+        ::CloseHandle(files[i]);
+        files[i] = INVALID_HANDLE_VALUE;
+    }
+
+    for (; renamed < count; ++renamed)
+    {
+        if (BOOST_UNLIKELY(!::MoveFileExW(temps[renamed].c_str(), entries[renamed].target.c_str(), MOVEFILE_REPLACE_EXISTING | ((sync_all || sync_data) ? MOVEFILE_WRITE_THROUGH : 0u))))
+        {
+            err = ::GetLastError();
+            failed_index = renamed;
+            goto done;
+        }
+    }
+
+done:
+    if (BOOST_UNLIKELY(err != 0u))
+    {
+        for (std::size_t i = 0u; i < created; ++i)
+        {
+            if (files[i] != INVALID_HANDLE_VALUE)
+                ::CloseHandle(files[i]);
+        }
+        for (std::size_t i = renamed; i < created; ++i)
+            ::DeleteFileW(temps[i].c_str());
+    }
+
+#endif // defined(BOOST_POSIX_API)
+
+    return err;
+}
+
+} // unnamed namespace
+
+BOOST_FILESYSTEM_DECL
+void read_file(path const& p, std::string& contents, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    err_t err;
+    try
+    {
+        err = read_file_impl(p, contents);
+    }
+    catch (std::bad_alloc&)
+    {
+        contents.clear();
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return;
+    }
+
+    if (BOOST_UNLIKELY(err != 0))
+        emit_error(err, p, ec, "boost::filesystem::read_file");
+}
+
+BOOST_FILESYSTEM_DECL
+void write_file(path const& p, const void* data, std::size_t size, unsigned int options, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    const err_t err = write_file_impl(p, data, size, options);
+    if (BOOST_UNLIKELY(err != 0))
+        emit_error(err, p, ec, "boost::filesystem::write_file");
+}
+
+BOOST_FILESYSTEM_DECL
+void atomic_write_file(path const& p, const void* data, std::size_t size, unsigned int options, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    const err_t err = write_file_impl(p, data, size, options | static_cast< unsigned int >(write_file_options::atomic_replace));
+    if (BOOST_UNLIKELY(err != 0))
+        emit_error(err, p, ec, "boost::filesystem::atomic_write_file");
+}
+
+BOOST_FILESYSTEM_DECL
+void atomic_commit(atomic_write_entry const* entries, std::size_t count, unsigned int options, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    if (count == 0u)
+        return;
+
+    std::size_t failed_index = 0u;
+    const err_t err = atomic_commit_impl(entries, count, options, failed_index);
+    if (BOOST_UNLIKELY(err != 0))
+        emit_error(err, entries[failed_index].target, ec, "boost::filesystem::atomic_commit");
+}
+
+namespace {
+
+//! Buffers for reading symlinks, which can be reused to read multiple symlinks
+struct read_symlink_buffer
+{
+#if defined(BOOST_POSIX_API)
+    //! Buffer for symlink targets that do not fit in the buffer on the stack
+    boost::scoped_array< char > heap_buf;
+    std::size_t heap_buf_size;
+
+    read_symlink_buffer() BOOST_NOEXCEPT : heap_buf_size(0u) {}
+#else
+    boost::scoped_ptr< reparse_data_buffer_with_storage > reparse_buf;
+#endif
+};
+
+#if defined(BOOST_POSIX_API)
+
+//! Reads the target of the symlink \a p, relative to \a basedir_fd, into \a target. Returns 0 on success, otherwise an error code.
+err_t read_symlink_impl(path const& p, path& target, read_symlink_buffer& buf
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    , int basedir_fd = AT_FDCWD
+#endif
+)
+{
+    const char* const path_str = p.c_str();
+    char small_buf[small_path_size];
+    char* b = small_buf;
+    std::size_t size = sizeof(small_buf);
+    while (true) // loop 'til buffer large enough
+    {
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+        const ssize_t result = ::readlinkat(basedir_fd, path_str, b, size);
+#else
+        const ssize_t result = ::readlink(path_str, b, size);
+#endif
+        if (BOOST_UNLIKELY(result < 0))
+            return errno;
+
+        if (BOOST_LIKELY(static_cast< std::size_t >(result) < size))
+        {
+            target.assign(b, b + result);
+            return 0;
+        }
+
+        // Start from the size of the buffer that was allocated before, if it is larger
+        size = (std::max)(size * 2u, buf.heap_buf_size);
+        if (BOOST_UNLIKELY(size > absolute_path_max))
+            return ENAMETOOLONG;
+
+        if (size > buf.heap_buf_size)
+        {
+            buf.heap_buf.reset(new char[size]);
+            buf.heap_buf_size = size;
+        }
+        b = buf.heap_buf.get();
+    }
+}
+
+#else // defined(BOOST_POSIX_API)
+
+//! Reads the target of the symlink or mount point open as \a h into \a target. Returns 0 on success, otherwise an error code.
+err_t read_symlink_impl(HANDLE h, path& target, read_symlink_buffer& buf)
+{
+    if (!buf.reparse_buf)
+        buf.reparse_buf.reset(new reparse_data_buffer_with_storage);
+
+    reparse_data_buffer_with_storage* const rbuf = buf.reparse_buf.get();
+    DWORD sz = 0u;
+    if (BOOST_UNLIKELY(!::DeviceIoControl(h, FSCTL_GET_REPARSE_POINT, NULL, 0, rbuf, sizeof(*rbuf), &sz, NULL)))
+        return ::GetLastError();
+
+    const wchar_t* buffer;
+    std::size_t offset, len;
+    switch (rbuf->rdb.ReparseTag)
+    {
+    case IO_REPARSE_TAG_MOUNT_POINT:
+        buffer = rbuf->rdb.MountPointReparseBuffer.PathBuffer;
+        offset = rbuf->rdb.MountPointReparseBuffer.SubstituteNameOffset;
+        len = rbuf->rdb.MountPointReparseBuffer.SubstituteNameLength;
+        break;
+
+    case IO_REPARSE_TAG_SYMLINK:
+        buffer = rbuf->rdb.SymbolicLinkReparseBuffer.PathBuffer;
+        offset = rbuf->rdb.SymbolicLinkReparseBuffer.SubstituteNameOffset;
+        len = rbuf->rdb.SymbolicLinkReparseBuffer.SubstituteNameLength;
+        // Note: iff info.rdb.SymbolicLinkReparseBuffer.Flags & SYMLINK_FLAG_RELATIVE
+        //       -> resulting path is relative to the source
+        break;
+
+    default:
+        // Unknown ReparseTag
+        return BOOST_ERROR_NOT_SUPPORTED;
+    }
+
+    target = convert_nt_path_to_win32_path(buffer + offset / sizeof(wchar_t), len / sizeof(wchar_t));
+    return 0u;
+}
+
+//! Reads the target of the symlink or mount point \a p into \a target. Returns 0 on success, otherwise an error code.
+err_t read_symlink_impl(path const& p, path& target, read_symlink_buffer& buf)
+{
+    handle_wrapper h(create_file_handle(
+        p.c_str(),
+        FILE_READ_ATTRIBUTES,
+        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OPEN_REPARSE_POINT));
+
+    if (BOOST_UNLIKELY(h.handle == INVALID_HANDLE_VALUE))
+        return ::GetLastError();
+
+    return read_symlink_impl(h.handle, target, buf);
+}
+
+#endif // defined(BOOST_POSIX_API)
+
+//! Reads the targets of the symlinks in a batch, one by one, reusing the buffers
+inline void read_symlink_range(path const* paths, std::size_t count, path* targets, system::error_code* results, read_symlink_buffer& buf) BOOST_NOEXCEPT
+{
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+        err_t err;
+        try
+        {
+            err = read_symlink_impl(paths[i], targets[i], buf);
+        }
+        catch (std::bad_alloc&)
+        {
+            results[i] = make_error_code(system::errc::not_enough_memory);
+            targets[i].clear();
+            continue;
+        }
+
+        if (BOOST_LIKELY(err == 0))
+        {
+            results[i].clear();
+        }
+        else
+        {
+            results[i].assign(err, system::system_category());
+            targets[i].clear();
+        }
+    }
+}
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+//! Minimum number of symlinks to read per thread
+BOOST_CONSTEXPR_OR_CONST std::size_t read_symlink_batch_min_paths_per_thread = 256u;
+//! Number of symlinks a thread claims at once
+BOOST_CONSTEXPR_OR_CONST std::size_t read_symlink_batch_chunk_size = 64u;
+
+//! Function object that reads symlinks of a batch in multiple threads
+class parallel_symlink_reader
+{
+private:
+    path const* const m_paths;
+    const std::size_t m_count;
+    path* const m_targets;
+    system::error_code* const m_results;
+    std::atomic< std::size_t > m_next;
+
+public:
+    parallel_symlink_reader(path const* paths, std::size_t count, path* targets, system::error_code* results) BOOST_NOEXCEPT :
+        m_paths(paths),
+        m_count(count),
+        m_targets(targets),
+        m_results(results),
+        m_next(0u)
+    {
+    }
+
+    BOOST_DELETED_FUNCTION(parallel_symlink_reader(parallel_symlink_reader const&))
+    BOOST_DELETED_FUNCTION(parallel_symlink_reader& operator=(parallel_symlink_reader const&))
+
+    void operator()(unsigned int) BOOST_NOEXCEPT
+    {
+        read_symlink_buffer buf;
+        while (true)
+        {
+            const std::size_t pos = m_next.fetch_add(read_symlink_batch_chunk_size, std::memory_order_relaxed);
+            if (pos >= m_count)
+                break;
+
+            const std::size_t n = (m_count - pos) < read_symlink_batch_chunk_size ? (m_count - pos) : read_symlink_batch_chunk_size;
+            read_symlink_range(m_paths + pos, n, m_targets + pos, m_results + pos, buf);
+        }
+    }
+};
+
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+} // unnamed namespace
+
+BOOST_FILESYSTEM_DECL
+path read_symlink(path const& p, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    path symlink_path;
+    read_symlink_buffer buf;
+    const err_t err = read_symlink_impl(p, symlink_path, buf);
+    if (BOOST_UNLIKELY(err != 0))
+    {
+        emit_error(err, p, ec, "boost::filesystem::read_symlink");
+        symlink_path.clear();
+    }
+
+    return symlink_path;
+}
+
+BOOST_FILESYSTEM_DECL
+void read_symlink_batch(path const* paths, std::size_t count, path* targets, system::error_code* results)
+{
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+    if (count >= read_symlink_batch_min_paths_per_thread * 2u)
+    {
+        unsigned int thread_count = get_thread_count(0u);
+        if (static_cast< std::size_t >(thread_count) > count / read_symlink_batch_min_paths_per_thread)
+            thread_count = static_cast< unsigned int >(count / read_symlink_batch_min_paths_per_thread);
+
+        if (thread_count > 1u)
+        {
+            parallel_symlink_reader reader(paths, count, targets, results);
+            run_in_threads(thread_count, reader);
+            return;
+        }
+    }
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+    read_symlink_buffer buf;
+    read_symlink_range(paths, count, targets, results, buf);
+}
+
+BOOST_FILESYSTEM_DECL
+path relative(path const& p, path const& base, error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    error_code local_ec;
+    path cur_path;
+    if (!p.is_absolute() || !base.is_absolute())
+    {
+        cur_path = detail::current_path(&local_ec);
+        if (BOOST_UNLIKELY(!!local_ec))
+        {
+        fail_local_ec:
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::relative", p, base, local_ec));
+
+            *ec = local_ec;
+            return path();
+        }
+    }
+
+    path wc_base(detail::weakly_canonical(base, cur_path, &local_ec));
+    if (BOOST_UNLIKELY(!!local_ec))
+        goto fail_local_ec;
+    path wc_p(detail::weakly_canonical(p, cur_path, &local_ec));
+    if (BOOST_UNLIKELY(!!local_ec))
+        goto fail_local_ec;
+    return wc_p.lexically_relative(wc_base);
+}
+
+BOOST_FILESYSTEM_DECL
+bool remove(path const& p, error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    return detail::remove_impl(p, ec);
+}
+
+BOOST_FILESYSTEM_DECL
+uintmax_t remove_all(path const& p, error_code* ec)
+{
+    BOOST_FILESYSTEM_TRACE1(remove_all__entry, p.c_str());
+    BOOST_FILESYSTEM_TRACE_SCOPE(remove_all);
+
+    if (ec)
+        ec->clear();
+
+    return detail::remove_all_impl(p, ec);
+}
+
+BOOST_FILESYSTEM_DECL
+uintmax_t parallel_remove_all(path const& p, unsigned int thread_count, error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+    thread_count = get_thread_count(thread_count);
+    if (thread_count > 1u)
+        return detail::parallel_remove_all_impl(p, thread_count, ec);
+#endif
+
+    return detail::remove_all_impl(p, ec);
+}
+
+BOOST_FILESYSTEM_DECL
+void rename(path const& old_p, path const& new_p, error_code* ec)
+{
+    error(!BOOST_MOVE_FILE(old_p.c_str(), new_p.c_str()) ? BOOST_ERRNO : 0, old_p, new_p, ec, "boost::filesystem::rename");
+}
+
+namespace {
+
+//! Renames \a from to \a to according to \a options, see move_options. Returns the error code of the rename.
+err_t move_rename(path const& from, path const& to, unsigned int options)
+{
+    const bool invalid_options = (options & static_cast< unsigned int >(move_options::no_replace)) != 0u &&
+        (options & static_cast< unsigned int >(move_options::exchange)) != 0u;
+
+#if defined(BOOST_POSIX_API)
+    if (BOOST_UNLIKELY(invalid_options))
+        return EINVAL;
+
+    if ((options & (static_cast< unsigned int >(move_options::no_replace) | static_cast< unsigned int >(move_options::exchange))) == 0u)
+        return ::rename(from.c_str(), to.c_str()) == 0 ? 0 : errno;
+
+#if defined(BOOST_FILESYSTEM_HAS_RENAMEAT2)
+    const unsigned int flags = (options & static_cast< unsigned int >(move_options::exchange)) != 0u ? RENAME_EXCHANGE : RENAME_NOREPLACE;
+    if (::syscall(__NR_renameat2, AT_FDCWD, from.c_str(), AT_FDCWD, to.c_str(), flags) == 0)
+        return 0;
+
+    return errno;
+#elif defined(BOOST_FILESYSTEM_HAS_RENAMEX_NP)
+    const unsigned int flags = (options & static_cast< unsigned int >(move_options::exchange)) != 0u ? RENAME_SWAP : RENAME_EXCL;
+    if (::renamex_np(from.c_str(), to.c_str(), flags) == 0)
+        return 0;
+
+    return errno;
+#else
+    return BOOST_ERROR_NOT_SUPPORTED;
+#endif
+
+#else // defined(BOOST_POSIX_API)
+
+    if (BOOST_UNLIKELY(invalid_options))
+        return ERROR_INVALID_PARAMETER;
+
+    if ((options & static_cast< unsigned int >(move_options::exchange)) != 0u)
+        return BOOST_ERROR_NOT_SUPPORTED;
+
+    // Unlike rename, don't let MoveFileExW copy files between volumes, so that the copy is done the same way for files and directories
+    const DWORD flags = (options & static_cast< unsigned int >(move_options::no_replace)) != 0u ? 0u : static_cast< DWORD >(MOVEFILE_REPLACE_EXISTING);
+    return ::MoveFileExW(from.c_str(), to.c_str(), flags) ? 0u : ::GetLastError();
+
+#endif // defined(BOOST_POSIX_API)
+}
+
+//! Moves \a from to \a to on a different filesystem by copying and then removing \a from
+void move_by_copy(path const& from, path const& to, unsigned int options, unsigned int thread_count, error_code* ec)
+{
+    error_code local_ec;
+    const file_status from_stat = detail::symlink_status(from, &local_ec);
+    if (BOOST_UNLIKELY(!!local_ec))
+    {
+    fail:
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::move", from, to, local_ec));
+
+        *ec = local_ec;
+        return;
+    }
+
+    const bool is_dir = filesystem::is_directory(from_stat);
+    const file_status to_stat = detail::symlink_status(to, &local_ec);
+    if (to_stat.type() != file_not_found)
+    {
+        if (BOOST_UNLIKELY(!!local_ec))
+            goto fail;
+
+        // Check the same conditions as rename does before removing the target
+        if ((options & static_cast< unsigned int >(move_options::no_replace)) != 0u)
+        {
+            local_ec = make_error_code(system::errc::file_exists);
+            goto fail;
+        }
+
+        if (is_dir)
+        {
+            if (!filesystem::is_directory(to_stat))
+            {
+                local_ec = make_error_code(system::errc::not_a_directory);
+                goto fail;
+            }
+
+            const bool is_empty = is_empty_directory(to, &local_ec);
+            if (BOOST_UNLIKELY(!!local_ec))
+                goto fail;
+            if (!is_empty)
+            {
+                local_ec = make_error_code(system::errc::directory_not_empty);
+                goto fail;
+            }
+        }
+        else if (filesystem::is_directory(to_stat))
+        {
+            local_ec = make_error_code(system::errc::is_a_directory);
+            goto fail;
+        }
+    }
+
+    // Copy to a temporary name next to the target and replace the target only when the copy is complete,
+    // so that the existing target is not lost if the copy fails
+    path temp;
+    {
+        path temp_name(".");
+        temp_name += to.filename();
+        temp_name += ".move-%%%%-%%%%-%%%%-%%%%";
+        temp = to.parent_path();
+        temp /= detail::unique_path(temp_name, &local_ec);
+        if (BOOST_UNLIKELY(!!local_ec))
+            goto fail;
+    }
+
+    {
+        const unsigned int copy_opts = static_cast< unsigned int >(copy_options::copy_symlinks) |
+            static_cast< unsigned int >(copy_options::clone_if_possible) | static_cast< unsigned int >(copy_options::preserve_sparse);
+        if (is_dir)
+            detail::parallel_copy(from, temp, copy_opts, thread_count, &local_ec);
+        else
+            detail::copy(from, temp, copy_opts, &local_ec);
+
+        if (BOOST_UNLIKELY(!!local_ec))
+        {
+            // Don't leave a partial copy behind, the source and the target are still intact
+            error_code remove_ec;
+            detail::parallel_remove_all(temp, thread_count, &remove_ec);
+            goto fail;
+        }
+
+#if defined(BOOST_WINDOWS_API)
+        // MoveFileExW does not replace directories. The target is known to be empty, so nothing is lost by removing it.
+        if (is_dir && to_stat.type() != file_not_found)
+        {
+            detail::remove(to, &local_ec);
+            if (BOOST_UNLIKELY(!!local_ec))
+            {
+                error_code remove_ec;
+                detail::parallel_remove_all(temp, thread_count, &remove_ec);
+                goto fail;
+            }
+        }
+#endif
+
+        const err_t err = move_rename(temp, to, options & static_cast< unsigned int >(move_options::no_replace));
+        if (BOOST_UNLIKELY(err != 0))
+        {
+            error_code remove_ec;
+            detail::parallel_remove_all(temp, thread_count, &remove_ec);
+            emit_error(err, from, to, ec, "boost::filesystem::move");
+            return;
+        }
+    }
+
+    detail::parallel_remove_all(from, thread_count, &local_ec);
+    if (BOOST_UNLIKELY(!!local_ec))
+        goto fail;
+}
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL
+void move(path const& from, path const& to, unsigned int options, unsigned int thread_count, error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    const err_t err = move_rename(from, to, options);
+    if (BOOST_LIKELY(err == 0))
+        return;
+
+#if defined(BOOST_POSIX_API)
+    const bool cross_device = err == EXDEV;
+#else
+    const bool cross_device = err == ERROR_NOT_SAME_DEVICE;
+#endif
+    if (!cross_device || (options & (static_cast< unsigned int >(move_options::exchange) | static_cast< unsigned int >(move_options::no_copy))) != 0u)
+    {
+        emit_error(err, from, to, ec, "boost::filesystem::move");
+        return;
+    }
+
+    move_by_copy(from, to, options, thread_count, ec);
+}
+
+BOOST_FILESYSTEM_DECL
+void exchange(path const& a, path const& b, error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    err_t err = move_rename(a, b, static_cast< unsigned int >(move_options::exchange));
+    if (BOOST_LIKELY(err == 0))
+        return;
+
+    // Fall back to renaming through a temporary name if the system or the filesystem can't exchange files atomically
+#if defined(BOOST_POSIX_API)
+    const bool not_supported = err == ENOSYS || err == EINVAL || err == ENOTSUP || err == EOPNOTSUPP;
+#else
+    const bool not_supported = err == ERROR_NOT_SUPPORTED || err == ERROR_INVALID_PARAMETER;
+#endif
+    if (!not_supported)
+    {
+    fail:
+        emit_error(err, a, b, ec, "boost::filesystem::exchange");
+        return;
+    }
+
+    path temp;
+    {
+        error_code local_ec;
+        path temp_name(".");
+        temp_name += a.filename();
+        temp_name += ".exchange-%%%%-%%%%-%%%%-%%%%";
+        temp = a.parent_path();
+        temp /= detail::unique_path(temp_name, &local_ec);
+        if (BOOST_UNLIKELY(!!local_ec))
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::exchange", a, b, local_ec));
+
+            *ec = local_ec;
+            return;
+        }
+    }
+
+    err = move_rename(a, temp, 0u);
+    if (BOOST_UNLIKELY(err != 0))
+        goto fail;
+
+    err = move_rename(b, a, 0u);
+    if (BOOST_UNLIKELY(err != 0))
+    {
+        move_rename(temp, a, 0u);
+        goto fail;
+    }
+
+    err = move_rename(temp, b, 0u);
+    if (BOOST_UNLIKELY(err != 0))
+    {
+        move_rename(a, b, 0u);
+        move_rename(temp, a, 0u);
+        goto fail;
+    }
+}
+
+BOOST_FILESYSTEM_DECL
+void resize_file(path const& p, uintmax_t size, system::error_code* ec)
+{
+#if defined(BOOST_POSIX_API)
+    if (BOOST_UNLIKELY(size > static_cast< uintmax_t >((std::numeric_limits< off_t >::max)())))
+    {
+        emit_error(system::errc::file_too_large, p, ec, "boost::filesystem::resize_file");
+        return;
+    }
+#endif
+    error(!BOOST_RESIZE_FILE(p.c_str(), size) ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::resize_file");
+}
+
+namespace {
+
+//! Operation on a range of the file storage
+enum file_range_operation
+{
+    file_range_preallocate,
+    file_range_preallocate_keep_size,
+    file_range_punch_hole,
+    file_range_zero
+};
+
+//! Performs \a op on \a length bytes of the file \a p starting at \a offset
+void change_file_range(path const& p, uintmax_t offset, uintmax_t length, file_range_operation op, system::error_code* ec, const char* message)
+{
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_POSIX_API)
+    const uintmax_t max_offset = static_cast< uintmax_t >((std::numeric_limits< off_t >::max)());
+#else
+    const uintmax_t max_offset = static_cast< uintmax_t >((std::numeric_limits< LONGLONG >::max)());
+#endif
+    if (BOOST_UNLIKELY(length > max_offset || offset > max_offset - length))
+    {
+        emit_error(system::errc::file_too_large, p, ec, message);
+        return;
+    }
+
+#if defined(BOOST_POSIX_API)
+
+    fd_wrapper fd(::open(p.c_str(), O_WRONLY | O_CLOEXEC));
+    if (BOOST_UNLIKELY(fd.fd < 0))
+    {
+        emit_error(errno, p, ec, message);
+        return;
+    }
+
+    if (length == 0u)
+        return;
+
+    int err;
+    switch (op)
+    {
+    case file_range_preallocate:
+    case file_range_preallocate_keep_size:
+        err = preallocate_file(fd.fd, offset, length, op == file_range_preallocate_keep_size);
+        break;
+    case file_range_punch_hole:
+        err = punch_hole_file(fd.fd, offset, length);
+        break;
+    default:
+        err = zero_range_file(fd.fd, offset, length);
+        break;
+    }
+
+#else // defined(BOOST_POSIX_API)
+
+    handle_wrapper h(create_file_handle(p, GENERIC_WRITE | FILE_READ_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL));
+    if (BOOST_UNLIKELY(h.handle == INVALID_HANDLE_VALUE))
+    {
+        emit_error(::GetLastError(), p, ec, message);
+        return;
+    }
+
+    if (length == 0u)
+        return;
+
+    DWORD err;
+    switch (op)
+    {
+    case file_range_preallocate:
+    case file_range_preallocate_keep_size:
+        err = preallocate_file(h.handle, offset, length, op == file_range_preallocate_keep_size);
+        break;
+    case file_range_punch_hole:
+        err = punch_hole_file(h.handle, offset, length);
+        break;
+    default:
+        err = zero_file_data(h.handle, offset, length);
+        break;
+    }
+
+#endif // defined(BOOST_POSIX_API)
+
+    if (BOOST_UNLIKELY(err != 0))
+        emit_error(err, p, ec, message);
+}
+
+} // unnamed namespace
+
+BOOST_FILESYSTEM_DECL
+void preallocate(path const& p, uintmax_t offset, uintmax_t length, unsigned int options, system::error_code* ec)
+{
+    const file_range_operation op = (options & static_cast< unsigned int >(preallocate_options::keep_size)) != 0u ? file_range_preallocate_keep_size : file_range_preallocate;
+    change_file_range(p, offset, length, op, ec, "boost::filesystem::preallocate");
+}
+
+BOOST_FILESYSTEM_DECL
+void punch_hole(path const& p, uintmax_t offset, uintmax_t length, system::error_code* ec)
+{
+    change_file_range(p, offset, length, file_range_punch_hole, ec, "boost::filesystem::punch_hole");
+}
+
+BOOST_FILESYSTEM_DECL
+void zero_range(path const& p, uintmax_t offset, uintmax_t length, system::error_code* ec)
+{
+    change_file_range(p, offset, length, file_range_zero, ec, "boost::filesystem::zero_range");
+}
+
+namespace {
+
+#if defined(BOOST_POSIX_API) && !defined(BOOST_FILESYSTEM_USE_WASI)
+
+//! Fills \a info from the filesystem statistics returned by statvfs
+inline void set_space_info(struct BOOST_STATVFS const& vfs, space_info& info) BOOST_NOEXCEPT
+{
+    info.capacity = static_cast< uintmax_t >(vfs.f_blocks) * BOOST_STATVFS_F_FRSIZE;
+    info.free = static_cast< uintmax_t >(vfs.f_bfree) * BOOST_STATVFS_F_FRSIZE;
+    info.available = static_cast< uintmax_t >(vfs.f_bavail) * BOOST_STATVFS_F_FRSIZE;
+}
+
+#elif defined(BOOST_WINDOWS_API)
+
+//! Returns the directory to pass to GetDiskFreeSpaceExW to obtain the space on the volume of \a p
+bool get_disk_free_space_directory(path const& p, path::string_type& str, const char* func_name, error_code* ec)
+{
+    // GetDiskFreeSpaceExW requires a directory path, which is unlike statvfs, which accepts any file.
+    // To work around this, test if the path refers to a directory and use the parent directory if not.
+    error_code local_ec;
+    file_status status = detail::status_impl(p, &local_ec);
+    if (status.type() == fs::status_error || status.type() == fs::file_not_found)
+    {
+    fail_local_ec:
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error(func_name, p, local_ec));
+        *ec = local_ec;
+        return false;
+    }
+
+    path dir_path = p;
+    if (!is_directory(status))
+    {
+        path cur_path = detail::current_path(ec);
+        if (ec && *ec)
+            return false;
+
+        status = detail::symlink_status_impl(p, &local_ec);
+        if (status.type() == fs::status_error)
+            goto fail_local_ec;
+        if (is_symlink(status))
+        {
+            // We need to resolve the symlink so that we report the space for the symlink target
+            dir_path = detail::canonical(p, cur_path, ec);
+            if (ec && *ec)
+                return false;
+        }
+
+        dir_path = dir_path.parent_path();
+        if (dir_path.empty())
+        {
+            // The original path was just a filename, which is a relative path wrt. current directory
+            dir_path = cur_path;
+        }
+    }
+
+    // For UNC names, the path must also include a trailing slash.
+    str = dir_path.native();
+    if (str.size() >= 2u && detail::is_directory_separator(str[0]) && detail::is_directory_separator(str[1]) && !detail::is_directory_separator(*(str.end() - 1)))
+        str.push_back(path::preferred_separator);
+
+    return true;
+}
+
+//! Obtains the space on the volume of the directory \a dir, returns the error code
+DWORD get_disk_free_space(const wchar_t* dir, space_info& info) BOOST_NOEXCEPT
+{
+    ULARGE_INTEGER avail, total, free;
+    if (BOOST_UNLIKELY(!::GetDiskFreeSpaceExW(dir, &avail, &total, &free)))
+        return ::GetLastError();
+
+    info.capacity = static_cast< uintmax_t >(total.QuadPart);
+    info.free = static_cast< uintmax_t >(free.QuadPart);
+    info.available = static_cast< uintmax_t >(avail.QuadPart);
+    return 0u;
+}
+
+#endif
+
+} // unnamed namespace
+
+BOOST_FILESYSTEM_DECL
+space_info space(path const& p, error_code* ec)
+{
+    space_info info;
+    // Initialize members to -1, as required by C++20 [fs.op.space]/1 in case of error
+    info.capacity = static_cast< uintmax_t >(-1);
+    info.free = static_cast< uintmax_t >(-1);
+    info.available = static_cast< uintmax_t >(-1);
+
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_FILESYSTEM_USE_WASI)
+
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::space");
+
+#elif defined(BOOST_POSIX_API)
+
+    struct BOOST_STATVFS vfs;
+    if (!error(::BOOST_STATVFS(p.c_str(), &vfs) ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::space"))
+        set_space_info(vfs, info);
+
+#else
+
+    path::string_type str;
+    if (!get_disk_free_space_directory(p, str, "boost::filesystem::space", ec))
+        return info;
+
+    space_info res;
+    DWORD err = get_disk_free_space(str.c_str(), res);
+    if (BOOST_UNLIKELY(err != 0u))
+        emit_error(err, p, ec, "boost::filesystem::space");
+    else
+        info = res;
+
+#endif
+
+    return info;
+}
+
+BOOST_FILESYSTEM_DECL
+file_status status(path const& p, error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    return detail::status_impl(p, ec);
+}
+
+BOOST_FILESYSTEM_DECL
+file_status symlink_status(path const& p, error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    return detail::symlink_status_impl(p, ec);
+}
+
+BOOST_FILESYSTEM_DECL
+file_status status(path const& p, unsigned int consistency, error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    return detail::status_impl(p, ec, AT_FDCWD, detail::get_statx_sync_flags(consistency));
+#else
+    // The consistency can only be selected with statx
+    (void)consistency;
+    return detail::status_impl(p, ec);
+#endif
+}
+
+BOOST_FILESYSTEM_DECL
+file_status symlink_status(path const& p, unsigned int consistency, error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    return detail::symlink_status_impl(p, ec, AT_FDCWD, detail::get_statx_sync_flags(consistency));
+#else
+    (void)consistency;
+    return detail::symlink_status_impl(p, ec);
+#endif
+}
+
+// contributed by Jeff Flinn
+BOOST_FILESYSTEM_DECL
+path temp_directory_path(system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+#ifdef BOOST_POSIX_API
+    const char* val = NULL;
+
+    (val = std::getenv("TMPDIR")) ||
+        (val = std::getenv("TMP")) ||
+        (val = std::getenv("TEMP")) ||
+        (val = std::getenv("TEMPDIR"));
 
-            result /= *itr;
+#ifdef __ANDROID__
+    const char* default_tmp = "/data/local/tmp";
+#else
+    const char* default_tmp = "/tmp";
+#endif
+    if (val == NULL)
+        val = default_tmp;
 
-            // If we don't have an absolute path yet then don't check symlink status.
-            // This avoids checking "C:" which is "the current directory on drive C"
-            // and hence not what we want to check/resolve here.
-            if (!result.is_absolute())
-                continue;
+    path p(val);
 
-            st = detail::symlink_status_impl(result, ec);
-            if (ec && *ec)
-                goto return_empty_path;
+    if (BOOST_UNLIKELY(p.empty()))
+    {
+    fail_not_dir:
+        error(ENOTDIR, p, ec, "boost::filesystem::temp_directory_path");
+        return p;
+    }
 
-            if (is_symlink(st))
-            {
-                if (symlinks_allowed == 0)
-                {
-                    local_ec = system::errc::make_error_code(system::errc::too_many_symbolic_link_levels);
-                    goto fail_local_ec;
-                }
+    file_status status = detail::status_impl(p, ec);
+    if (BOOST_UNLIKELY(ec && *ec))
+        return path();
+    if (BOOST_UNLIKELY(!is_directory(status)))
+        goto fail_not_dir;
 
-                --symlinks_allowed;
+    return p;
 
-                path link(detail::read_symlink(result, ec));
-                if (ec && *ec)
-                    goto return_empty_path;
-                result.remove_filename();
+#else // Windows
+#if !defined(UNDER_CE)
 
-                if (link.is_absolute())
-                {
-                    for (++itr; itr != end; ++itr)
-                    {
-                        if (*itr != dot_p)
-                            link /= *itr;
-                    }
-                    source = link;
-                    root = source.root_path();
-                }
-                else // link is relative
-                {
-                    link.remove_trailing_separator();
-                    if (link == dot_p)
-                        continue;
+    const wchar_t* tmp_env = L"TMP";
+    const wchar_t* temp_env = L"TEMP";
+    const wchar_t* localappdata_env = L"LOCALAPPDATA";
+    const wchar_t* userprofile_env = L"USERPROFILE";
+    const wchar_t* env_list[] = { tmp_env, temp_env, localappdata_env, userprofile_env };
+    BOOST_CONSTEXPR_OR_CONST unsigned int env_count = sizeof(env_list) / sizeof(*env_list);
+    std::wstring env_values[env_count];
+    for (unsigned int i = 0; i < env_count; ++i)
+        env_values[i] = wgetenv(env_list[i]);
 
-                    path new_source(result);
-                    new_source /= link;
-                    for (++itr; itr != end; ++itr)
-                    {
-                        if (*itr != dot_p)
-                            new_source /= *itr;
-                    }
-                    source = new_source;
-                }
+    path p;
+#if defined(BOOST_FILESYSTEM_USE_PATH_CACHE)
+    // The cached path is keyed on the environment variable values, so that changes of the environment take effect
+    std::wstring key;
+    for (unsigned int i = 0; i < env_count; ++i)
+    {
+        key.append(env_values[i]);
+        key.push_back(L'\0');
+    }
 
-                // symlink causes scan to be restarted
-                goto restart_scan;
-            }
+    // The cached path is still checked to be a directory, since it may have been removed since it was cached.
+    // Only the search through the candidate directories is saved.
+    cached_path& cache = get_temp_directory_path_cache();
+    unsigned int generation = 0u;
+    if (cache.get(p, generation, key.c_str(), key.size()))
+    {
+        error_code lcl_ec;
+        if (is_directory(p, lcl_ec) && !lcl_ec)
+            return p;
+        p.clear();
+    }
+#endif
+
+    for (unsigned int i = 0; i < env_count; ++i)
+    {
+        std::wstring const& env = env_values[i];
+        if (!env.empty())
+        {
+            p = env;
+            if (i >= 2)
+                p /= L"Temp";
+            error_code lcl_ec;
+            if (exists(p, lcl_ec) && !lcl_ec && is_directory(p, lcl_ec) && !lcl_ec)
+                break;
+            p.clear();
         }
+    }
 
-        break;
+    if (p.empty())
+    {
+        // use a separate buffer since in C++03 a string is not required to be contiguous
+        const UINT size = ::GetWindowsDirectoryW(NULL, 0);
+        if (BOOST_UNLIKELY(size == 0))
+        {
+        getwindir_error:
+            int errval = ::GetLastError();
+            error(errval, ec, "boost::filesystem::temp_directory_path");
+            return path();
+        }
 
-    restart_scan:
-        result.clear();
-    }
+        boost::scoped_array< wchar_t > buf(new wchar_t[size]);
+        if (BOOST_UNLIKELY(::GetWindowsDirectoryW(buf.get(), size) == 0))
+            goto getwindir_error;
 
-    BOOST_ASSERT_MSG(result.is_absolute(), "canonical() implementation error; please report");
-    return result;
-}
+        p = buf.get(); // do not depend on initial buf size, see ticket #10388
+        p /= L"Temp";
+    }
 
-BOOST_FILESYSTEM_DECL
-void copy(path const& from, path const& to, unsigned int options, system::error_code* ec)
-{
-    BOOST_ASSERT((((options & static_cast< unsigned int >(copy_options::overwrite_existing)) != 0u) +
-        ((options & static_cast< unsigned int >(copy_options::skip_existing)) != 0u) +
-        ((options & static_cast< unsigned int >(copy_options::update_existing)) != 0u)) <= 1);
+#if defined(BOOST_FILESYSTEM_USE_PATH_CACHE)
+    cache.set(p, generation, key.c_str(), key.size());
+#endif
 
-    BOOST_ASSERT((((options & static_cast< unsigned int >(copy_options::copy_symlinks)) != 0u) +
-        ((options & static_cast< unsigned int >(copy_options::skip_symlinks)) != 0u)) <= 1);
+    return p;
 
-    BOOST_ASSERT((((options & static_cast< unsigned int >(copy_options::directories_only)) != 0u) +
-        ((options & static_cast< unsigned int >(copy_options::create_symlinks)) != 0u) +
-        ((options & static_cast< unsigned int >(copy_options::create_hard_links)) != 0u)) <= 1);
+#else // Windows CE
 
-    if (ec)
-        ec->clear();
+    // Windows CE has no environment variables, so the same code as used for
+    // regular Windows, above, doesn't work.
 
-    file_status from_stat;
-    if ((options & (static_cast< unsigned int >(copy_options::copy_symlinks) |
-        static_cast< unsigned int >(copy_options::skip_symlinks) |
-        static_cast< unsigned int >(copy_options::create_symlinks))) != 0u)
+    DWORD size = ::GetTempPathW(0, NULL);
+    if (size == 0u)
     {
-        from_stat = detail::symlink_status_impl(from, ec);
+    fail:
+        int errval = ::GetLastError();
+        error(errval, ec, "boost::filesystem::temp_directory_path");
+        return path();
     }
-    else
+
+    boost::scoped_array< wchar_t > buf(new wchar_t[size]);
+    if (::GetTempPathW(size, buf.get()) == 0)
+        goto fail;
+
+    path p(buf.get());
+    p.remove_trailing_separator();
+
+    file_status status = detail::status_impl(p, ec);
+    if (ec && *ec)
+        return path();
+    if (!is_directory(status))
     {
-        from_stat = detail::status_impl(from, ec);
+        error(ERROR_PATH_NOT_FOUND, p, ec, "boost::filesystem::temp_directory_path");
+        return path();
     }
 
-    if (ec && *ec)
-        return;
+    return p;
 
-    if (!exists(from_stat))
+#endif // !defined(UNDER_CE)
+#endif
+}
+
+BOOST_FILESYSTEM_DECL
+path system_complete(path const& p, system::error_code* ec)
+{
+#ifdef BOOST_POSIX_API
+
+    return (p.empty() || p.is_absolute()) ? p : current_path() / p;
+
+#else
+    if (p.empty())
     {
-        emit_error(BOOST_ERROR_FILE_NOT_FOUND, from, to, ec, "boost::filesystem::copy");
-        return;
+        if (ec)
+            ec->clear();
+        return p;
     }
 
-    if (is_symlink(from_stat))
-    {
-        if ((options & static_cast< unsigned int >(copy_options::skip_symlinks)) != 0u)
-            return;
+    BOOST_CONSTEXPR_OR_CONST std::size_t buf_size = 128u;
+    wchar_t buf[buf_size];
+    wchar_t* pfn;
+    std::size_t len = get_full_path_name(p, buf_size, buf, &pfn);
 
-        if ((options & static_cast< unsigned int >(copy_options::copy_symlinks)) == 0u)
-            goto fail;
+    if (error(len == 0 ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::system_complete"))
+        return path();
 
-        detail::copy_symlink(from, to, ec);
-    }
-    else if (is_regular_file(from_stat))
-    {
-        if ((options & static_cast< unsigned int >(copy_options::directories_only)) != 0u)
-            return;
+    if (len < buf_size) // len does not include null termination character
+        return path(&buf[0]);
 
-        if ((options & static_cast< unsigned int >(copy_options::create_symlinks)) != 0u)
-        {
-            const path* pfrom = &from;
-            path relative_from;
-            if (!from.is_absolute())
-            {
-                // Try to generate a relative path from the target location to the original file
-                path cur_dir = detail::current_path(ec);
-                if (ec && *ec)
-                    return;
-                path abs_from = detail::absolute(from.parent_path(), cur_dir, ec);
-                if (ec && *ec)
-                    return;
-                path abs_to = to.parent_path();
-                if (!abs_to.is_absolute())
-                {
-                    abs_to = detail::absolute(abs_to, cur_dir, ec);
-                    if (ec && *ec)
-                        return;
-                }
-                relative_from = detail::relative(abs_from, abs_to, ec);
-                if (ec && *ec)
-                    return;
-                if (relative_from != dot_path())
-                    relative_from /= from.filename();
-                else
-                    relative_from = from.filename();
-                pfrom = &relative_from;
-            }
-            detail::create_symlink(*pfrom, to, ec);
-            return;
-        }
+    boost::scoped_array< wchar_t > big_buf(new wchar_t[len]);
 
-        if ((options & static_cast< unsigned int >(copy_options::create_hard_links)) != 0u)
-        {
-            detail::create_hard_link(from, to, ec);
-            return;
-        }
+    return error(get_full_path_name(p, len, big_buf.get(), &pfn) == 0 ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::system_complete") ? path() : path(big_buf.get());
+#endif
+}
 
-        error_code local_ec;
-        file_status to_stat;
-        if ((options & (static_cast< unsigned int >(copy_options::skip_symlinks) |
-            static_cast< unsigned int >(copy_options::create_symlinks))) != 0u)
-        {
-            to_stat = detail::symlink_status_impl(to, &local_ec);
-        }
-        else
-        {
-            to_stat = detail::status_impl(to, &local_ec);
-        }
+BOOST_FILESYSTEM_DECL
+path weakly_canonical(path const& p, path const& base, system::error_code* ec)
+{
+    system::error_code local_ec;
+    const path::iterator p_end(p.end());
 
-        // Note: local_ec may be set by (symlink_)status() even in some non-fatal situations, e.g. when the file does not exist.
-        //       OTOH, when it returns status_error, then a real error have happened and it must have set local_ec.
-        if (to_stat.type() == fs::status_error)
+#if defined(BOOST_POSIX_API)
+
+    path::iterator itr(p_end);
+    path head(p);
+    for (; !head.empty(); --itr)
+    {
+        file_status head_status(detail::status_impl(head, &local_ec));
+        if (BOOST_UNLIKELY(head_status.type() == fs::status_error))
         {
             if (!ec)
-                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::copy", from, to, local_ec));
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::weakly_canonical", head, local_ec));
+
             *ec = local_ec;
-            return;
+            return path();
         }
 
-        if (is_directory(to_stat))
-            detail::copy_file(from, to / from.filename(), options, ec);
-        else
-            detail::copy_file(from, to, options, ec);
+        if (head_status.type() != fs::file_not_found)
+            break;
+
+        head.remove_filename();
     }
-    else if (is_directory(from_stat))
+
+    if (head.empty())
+        return p.lexically_normal();
+
+    path const& dot_p = dot_path();
+    path const& dot_dot_p = dot_dot_path();
+
+#else
+
+    // On Windows, filesystem APIs such as GetFileAttributesW and CreateFileW perform lexical path normalization
+    // internally. As a result, a path like "c:\a\.." can be reported as present even if "c:\a" is not. This would
+    // break canonical, as symlink_status that it calls internally would report an error that the file at the
+    // intermediate path does not exist. To avoid this, scan the initial path in the forward direction.
+    // Also, operate on paths with preferred separators. This can be important on Windows since GetFileAttributesW
+    // or CreateFileW, which is called in status() may return "file not found" for paths to network shares and
+    // mounted cloud storages that have forward slashes as separators.
+    // Also, avoid querying status of the root name such as \\?\c: as CreateFileW returns ERROR_INVALID_FUNCTION for
+    // such path. Querying the status of a root name such as c: is also not right as this path refers to the current
+    // directory on drive C:, which is not what we want to test for existence anyway.
+    path::iterator itr(p.begin());
+    path head;
+    if (p.has_root_name())
     {
-        error_code local_ec;
-        if ((options & static_cast< unsigned int >(copy_options::create_symlinks)) != 0u)
-        {
-            local_ec = make_error_code(system::errc::is_a_directory);
-            if (!ec)
-                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::copy", from, to, local_ec));
-            *ec = local_ec;
-            return;
-        }
+        BOOST_ASSERT(itr != p_end);
+        head = *itr;
+        ++itr;
+    }
 
-        file_status to_stat;
-        if ((options & (static_cast< unsigned int >(copy_options::skip_symlinks) |
-            static_cast< unsigned int >(copy_options::create_symlinks))) != 0u)
-        {
-            to_stat = detail::symlink_status_impl(to, &local_ec);
-        }
-        else
-        {
-            to_stat = detail::status_impl(to, &local_ec);
-        }
+    if (p.has_root_directory())
+    {
+        BOOST_ASSERT(itr != p_end);
+        // Convert generic separator returned by the iterator for the root directory to
+        // the preferred separator.
+        head += path::preferred_separator;
+        ++itr;
+    }
 
-        // Note: ec may be set by (symlink_)status() even in some non-fatal situations, e.g. when the file does not exist.
-        //       OTOH, when it returns status_error, then a real error have happened and it must have set local_ec.
-        if (to_stat.type() == fs::status_error)
+    if (!head.empty())
+    {
+        file_status head_status(detail::status_impl(head, &local_ec));
+        if (BOOST_UNLIKELY(head_status.type() == fs::status_error))
         {
             if (!ec)
-                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::copy", from, to, local_ec));
-            *ec = local_ec;
-            return;
-        }
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::weakly_canonical", head, local_ec));
 
-        if (!exists(to_stat))
-        {
-            detail::create_directory(to, &from, ec);
-            if (ec && *ec)
-                return;
+            *ec = local_ec;
+            return path();
         }
 
-        if ((options & static_cast< unsigned int >(copy_options::recursive)) != 0u || options == 0u)
+        if (head_status.type() == fs::file_not_found)
         {
-            fs::directory_iterator itr;
-            detail::directory_iterator_construct(itr, from, static_cast< unsigned int >(directory_options::none), NULL, ec);
-            if (ec && *ec)
-                return;
-
-            const fs::directory_iterator end_dit;
-            while (itr != end_dit)
-            {
-                path const& p = itr->path();
-                // Set _detail_recursing flag so that we don't recurse more than for one level deeper into the directory if options are copy_options::none
-                detail::copy(p, to / p.filename(), options | static_cast< unsigned int >(copy_options::_detail_recursing), ec);
-                if (ec && *ec)
-                    return;
-
-                detail::directory_iterator_increment(itr, ec);
-                if (ec && *ec)
-                    return;
-            }
+            // If the root path does not exist then no path element exists
+            return p.lexically_normal();
         }
     }
-    else
-    {
-    fail:
-        emit_error(BOOST_ERROR_NOT_SUPPORTED, from, to, ec, "boost::filesystem::copy");
-    }
-}
 
-BOOST_FILESYSTEM_DECL
-bool copy_file(path const& from, path const& to, unsigned int options, error_code* ec)
-{
-    BOOST_ASSERT((((options & static_cast< unsigned int >(copy_options::overwrite_existing)) != 0u) +
-        ((options & static_cast< unsigned int >(copy_options::skip_existing)) != 0u) +
-        ((options & static_cast< unsigned int >(copy_options::update_existing)) != 0u)) <= 1);
+    path const& dot_p = dot_path();
+    path const& dot_dot_p = dot_dot_path();
+    for (; itr != p_end; ++itr)
+    {
+        path const& p_elem = *itr;
 
-    if (ec)
-        ec->clear();
+        // Avoid querying status of paths containing dot and dot-dot elements, as this will break
+        // if the root name starts with "\\?\".
+        if (p_elem == dot_p)
+            continue;
 
-#if defined(BOOST_POSIX_API)
+        if (p_elem == dot_dot_p)
+        {
+            if (head.has_relative_path())
+                head.remove_filename();
 
-    int err = 0;
+            continue;
+        }
 
-    // Note: Declare fd_wrappers here so that errno is not clobbered by close() that may be called in fd_wrapper destructors
-    fd_wrapper infile, outfile;
+        head /= p_elem;
 
-    while (true)
-    {
-        infile.fd = ::open(from.c_str(), O_RDONLY | O_CLOEXEC);
-        if (BOOST_UNLIKELY(infile.fd < 0))
+        file_status head_status(detail::status_impl(head, &local_ec));
+        if (BOOST_UNLIKELY(head_status.type() == fs::status_error))
         {
-            err = errno;
-            if (err == EINTR)
-                continue;
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::weakly_canonical", head, local_ec));
 
-        fail:
-            emit_error(err, from, to, ec, "boost::filesystem::copy_file");
-            return false;
+            *ec = local_ec;
+            return path();
         }
 
-        break;
+        if (head_status.type() == fs::file_not_found)
+        {
+            head.remove_filename();
+            break;
+        }
     }
 
-#if defined(BOOST_FILESYSTEM_USE_STATX)
-    unsigned int statx_data_mask = STATX_TYPE | STATX_MODE | STATX_INO | STATX_SIZE;
-    if ((options & static_cast< unsigned int >(copy_options::update_existing)) != 0u)
-        statx_data_mask |= STATX_MTIME;
+    if (head.empty())
+        return p.lexically_normal();
 
-    struct ::statx from_stat;
-    if (BOOST_UNLIKELY(invoke_statx(infile.fd, "", AT_EMPTY_PATH | AT_NO_AUTOMOUNT, statx_data_mask, &from_stat) < 0))
-    {
-    fail_errno:
-        err = errno;
-        goto fail;
-    }
+#endif
 
-    if (BOOST_UNLIKELY((from_stat.stx_mask & statx_data_mask) != statx_data_mask))
+    path tail;
+    bool tail_has_dots = false;
+    for (; itr != p_end; ++itr)
     {
-        err = ENOSYS;
-        goto fail;
+        path const& tail_elem = *itr;
+        tail /= tail_elem;
+        // for a later optimization, track if any dot or dot-dot elements are present
+        if (!tail_has_dots && (tail_elem == dot_p || tail_elem == dot_dot_p))
+            tail_has_dots = true;
     }
-#else
-    struct ::stat from_stat;
-    if (BOOST_UNLIKELY(::fstat(infile.fd, &from_stat) != 0))
+
+    head = detail::canonical(head, base, &local_ec);
+    if (BOOST_UNLIKELY(!!local_ec))
     {
-    fail_errno:
-        err = errno;
-        goto fail;
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::weakly_canonical", head, local_ec));
+
+        *ec = local_ec;
+        return path();
     }
-#endif
 
-    const mode_t from_mode = get_mode(from_stat);
-    if (BOOST_UNLIKELY(!S_ISREG(from_mode)))
+    if (BOOST_LIKELY(!tail.empty()))
     {
-        err = ENOSYS;
-        goto fail;
-    }
+        head /= tail;
 
-    mode_t to_mode = from_mode;
-#if !defined(BOOST_FILESYSTEM_USE_WASI)
-    // Enable writing for the newly created files. Having write permission set is important e.g. for NFS,
-    // which checks the file permission on the server, even if the client's file descriptor supports writing.
-    to_mode |= S_IWUSR;
-#endif
-    int oflag = O_WRONLY | O_CLOEXEC;
+        // optimization: only normalize if tail had dot or dot-dot element
+        if (tail_has_dots)
+            return head.lexically_normal();
+    }
 
-    if ((options & static_cast< unsigned int >(copy_options::update_existing)) != 0u)
-    {
-        // Try opening the existing file without truncation to test the modification time later
-        while (true)
-        {
-            outfile.fd = ::open(to.c_str(), oflag, to_mode);
-            if (outfile.fd < 0)
-            {
-                err = errno;
-                if (err == EINTR)
-                    continue;
+    return head;
+}
 
-                if (err == ENOENT)
-                    goto create_outfile;
+} // namespace detail
 
-                goto fail;
-            }
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                           class canonicalizer implementation                         //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
 
+/*!
+ * \brief Resolves the canonical path of \a source, which must be absolute
+ *
+ * Returns \c true if the path was fully resolved. If \a weak is \c true and an element of the path does not exist,
+ * returns \c false with the unresolved elements lexically appended to \a result and \a type set to \c file_not_found.
+ * Otherwise, returns \c false and sets \a ec on errors.
+ */
+bool canonicalizer::resolve(path const& source, bool weak, unsigned int& symlinks_left, path& result, file_type& type, system::error_code& ec)
+{
+    // Find the longest parent directory that was already resolved
+    path lexical(source.parent_path());
+    std::size_t unresolved_count = 1u;
+    std::map< path_key, path >::const_iterator cached(m_dirs.end());
+    while (lexical.has_relative_path())
+    {
+        cached = m_dirs.find(path_key(lexical));
+        if (cached != m_dirs.end())
             break;
-        }
+
+        lexical = lexical.parent_path();
+        ++unresolved_count;
+    }
+
+    path::iterator itr(source.begin());
+    const path::iterator end(source.end());
+    if (cached != m_dirs.end())
+    {
+        std::size_t resolved_count = static_cast< std::size_t >(std::distance(itr, end)) - unresolved_count;
+        for (; resolved_count > 0u; --resolved_count)
+            ++itr;
+        result = cached->second;
     }
     else
     {
-    create_outfile:
-        oflag |= O_CREAT | O_TRUNC;
-        if (((options & static_cast< unsigned int >(copy_options::overwrite_existing)) == 0u ||
-             (options & static_cast< unsigned int >(copy_options::skip_existing)) != 0u) &&
-            (options & static_cast< unsigned int >(copy_options::update_existing)) == 0u)
+        result.clear();
+        if (source.has_root_name())
         {
-            oflag |= O_EXCL;
+            result = *itr;
+            ++itr;
         }
 
-        while (true)
+        if (source.has_root_directory())
         {
-            outfile.fd = ::open(to.c_str(), oflag, to_mode);
-            if (outfile.fd < 0)
+            // Convert generic separator returned by the iterator for the root directory to
+            // the preferred separator, see the comment in canonical().
+            result += path::preferred_separator;
+            ++itr;
+        }
+
+        lexical = result;
+    }
+
+    type = fs::directory_file;
+
+    path const& dot_p = detail::dot_path();
+    path const& dot_dot_p = detail::dot_dot_path();
+    system::error_code local_ec;
+    for (; itr != end; ++itr)
+    {
+        path const& elem = *itr;
+        if (type != fs::directory_file)
+            goto not_found;
+
+        if (elem.empty())
+        {
+            // Preserve the trailing separator, as canonical() does
+            if (result.has_relative_path())
+                result += path::preferred_separator;
+        }
+        else if (elem == dot_p)
+        {
+        }
+        else if (elem == dot_dot_p)
+        {
+            if (result.has_relative_path())
+                result = result.parent_path();
+        }
+        else
+        {
+            path candidate(result);
+            candidate /= elem;
+            file_status st(detail::symlink_status_impl(candidate, &local_ec));
+            if (BOOST_UNLIKELY(st.type() == fs::status_error))
             {
-                err = errno;
-                if (err == EINTR)
-                    continue;
+                ec = local_ec;
+                return false;
+            }
 
-                if (err == EEXIST && (options & static_cast< unsigned int >(copy_options::skip_existing)) != 0u)
+            if (st.type() == fs::file_not_found)
+                goto not_found;
+
+            if (st.type() == fs::symlink_file)
+            {
+                if (symlinks_left == 0u)
+                {
+                    ec = system::errc::make_error_code(system::errc::too_many_symbolic_link_levels);
                     return false;
+                }
 
-                goto fail;
+                --symlinks_left;
+
+                path target(detail::read_symlink(candidate, &ec));
+                if (ec)
+                    return false;
+
+                if (!target.is_absolute())
+                {
+                    candidate = result;
+                    candidate /= target;
+                    target.swap(candidate);
+                }
+
+                if (!resolve(target, false, symlinks_left, candidate, type, local_ec))
+                {
+                    if (weak && local_ec == system::errc::no_such_file_or_directory)
+                    {
+                        type = fs::directory_file;
+                        goto not_found;
+                    }
+
+                    ec = local_ec;
+                    return false;
+                }
+            }
+            else
+            {
+                type = st.type();
             }
 
-            break;
+            result.swap(candidate);
         }
-    }
 
-#if defined(BOOST_FILESYSTEM_USE_STATX)
-    statx_data_mask = STATX_TYPE | STATX_MODE | STATX_INO;
-    if ((oflag & O_TRUNC) == 0)
-    {
-        // O_TRUNC is not set if copy_options::update_existing is set and an existing file was opened.
-        statx_data_mask |= STATX_MTIME;
+        lexical /= elem;
+
+        if (type == fs::directory_file)
+        {
+            path::iterator next(itr);
+            ++next;
+            if (next != end)
+                m_dirs[path_key(lexical)] = result;
+        }
     }
 
-    struct ::statx to_stat;
-    if (BOOST_UNLIKELY(invoke_statx(outfile.fd, "", AT_EMPTY_PATH | AT_NO_AUTOMOUNT, statx_data_mask, &to_stat) < 0))
-        goto fail_errno;
+    return true;
 
-    if (BOOST_UNLIKELY((to_stat.stx_mask & statx_data_mask) != statx_data_mask))
+not_found:
+    if (!weak)
     {
-        err = ENOSYS;
-        goto fail;
+        ec = system::errc::make_error_code(system::errc::no_such_file_or_directory);
+        return false;
     }
-#else
-    struct ::stat to_stat;
-    if (BOOST_UNLIKELY(::fstat(outfile.fd, &to_stat) != 0))
-        goto fail_errno;
-#endif
 
-    to_mode = get_mode(to_stat);
-    if (BOOST_UNLIKELY(!S_ISREG(to_mode)))
     {
-        err = ENOSYS;
-        goto fail;
-    }
+        path tail;
+        bool tail_has_dots = false;
+        for (; itr != end; ++itr)
+        {
+            path const& tail_elem = *itr;
+            tail /= tail_elem;
+            if (!tail_has_dots && (tail_elem == dot_p || tail_elem == dot_dot_p))
+                tail_has_dots = true;
+        }
 
-    if (BOOST_UNLIKELY(detail::equivalent_stat(from_stat, to_stat)))
-    {
-        err = EEXIST;
-        goto fail;
+        result /= tail;
+        if (tail_has_dots)
+            result = result.lexically_normal();
     }
 
-    if ((oflag & O_TRUNC) == 0)
-    {
-        // O_TRUNC is not set if copy_options::update_existing is set and an existing file was opened.
-        // We need to check the last write times.
-#if defined(BOOST_FILESYSTEM_USE_STATX)
-        if (from_stat.stx_mtime.tv_sec < to_stat.stx_mtime.tv_sec || (from_stat.stx_mtime.tv_sec == to_stat.stx_mtime.tv_sec && from_stat.stx_mtime.tv_nsec <= to_stat.stx_mtime.tv_nsec))
-            return false;
-#elif defined(BOOST_FILESYSTEM_STAT_ST_MTIMENSEC)
-        // Modify time is available with nanosecond precision.
-        if (from_stat.st_mtime < to_stat.st_mtime || (from_stat.st_mtime == to_stat.st_mtime && from_stat.BOOST_FILESYSTEM_STAT_ST_MTIMENSEC <= to_stat.BOOST_FILESYSTEM_STAT_ST_MTIMENSEC))
-            return false;
-#else
-        if (from_stat.st_mtime <= to_stat.st_mtime)
-            return false;
-#endif
+    type = fs::file_not_found;
+    return false;
+}
 
-        if (BOOST_UNLIKELY(::ftruncate(outfile.fd, 0) != 0))
-            goto fail_errno;
-    }
+BOOST_FILESYSTEM_DECL path canonicalizer::canonical_impl(path const& p, path const* base, system::error_code* ec)
+{
+    BOOST_FILESYSTEM_TRACE1(canonical__entry, p.c_str());
+    BOOST_FILESYSTEM_TRACE_SCOPE(canonical);
 
-    // Note: Use block size of the target file since it is most important for writing performance.
-    err = filesystem::detail::atomic_load_relaxed(filesystem::detail::copy_file_data)(infile.fd, outfile.fd, get_size(from_stat), get_blksize(to_stat));
-    if (BOOST_UNLIKELY(err != 0))
-        goto fail; // err already contains the error code
+    if (ec)
+        ec->clear();
 
-#if !defined(BOOST_FILESYSTEM_USE_WASI)
-    // If we created a new file with an explicitly added S_IWUSR permission,
-    // we may need to update its mode bits to match the source file.
-    if (to_mode != from_mode)
+    path source(p);
+    if (!p.is_absolute())
     {
-        if (BOOST_UNLIKELY(::fchmod(outfile.fd, from_mode) != 0))
-            goto fail_errno;
+        source = base ? detail::absolute(p, *base, ec) : detail::absolute(p, detail::current_path(ec), ec);
+        if (ec && *ec)
+            return path();
     }
-#endif
 
-    if ((options & (static_cast< unsigned int >(copy_options::synchronize_data) | static_cast< unsigned int >(copy_options::synchronize))) != 0u)
+    unsigned int symlinks_left = detail::symloop_max;
+    path result;
+    file_type type;
+    system::error_code local_ec;
+    if (BOOST_UNLIKELY(!resolve(source, false, symlinks_left, result, type, local_ec)))
     {
-        if ((options & static_cast< unsigned int >(copy_options::synchronize)) != 0u)
-            err = full_sync(outfile.fd);
-        else
-            err = data_sync(outfile.fd);
-
-        if (BOOST_UNLIKELY(err != 0))
-            goto fail;
-    }
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::canonical", source, local_ec));
 
-    // We have to explicitly close the output file descriptor in order to handle a possible error returned from it. The error may indicate
-    // a failure of a prior write operation.
-    err = close_fd(outfile.fd);
-    outfile.fd = -1;
-    if (BOOST_UNLIKELY(err < 0))
-    {
-        err = errno;
-        // EINPROGRESS is an allowed error code in future POSIX revisions, according to https://www.austingroupbugs.net/view.php?id=529#c1200.
-        if (err != EINTR && err != EINPROGRESS)
-            goto fail;
+        *ec = local_ec;
+        return path();
     }
 
-    return true;
+    return result;
+}
 
-#else // defined(BOOST_POSIX_API)
+BOOST_FILESYSTEM_DECL path canonicalizer::weakly_canonical_impl(path const& p, path const* base, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
 
-    DWORD copy_flags = 0u;
-    if ((options & static_cast< unsigned int >(copy_options::overwrite_existing)) == 0u ||
-        (options & static_cast< unsigned int >(copy_options::skip_existing)) != 0u)
+    path source(p);
+    if (!p.is_absolute())
     {
-        copy_flags |= COPY_FILE_FAIL_IF_EXISTS;
+        source = base ? detail::absolute(p, *base, ec) : detail::absolute(p, detail::current_path(ec), ec);
+        if (ec && *ec)
+            return path();
     }
 
-    if ((options & static_cast< unsigned int >(copy_options::update_existing)) != 0u)
+    unsigned int symlinks_left = detail::symloop_max;
+    path result;
+    file_type type;
+    system::error_code local_ec;
+    if (!resolve(source, true, symlinks_left, result, type, local_ec) && BOOST_UNLIKELY(!!local_ec))
     {
-        // Create handle_wrappers here so that CloseHandle calls don't clobber error code returned by GetLastError
-        handle_wrapper hw_from, hw_to;
-
-        hw_from.handle = create_file_handle(from.c_str(), FILE_READ_ATTRIBUTES, FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS);
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::weakly_canonical", source, local_ec));
 
-        FILETIME lwt_from;
-        if (hw_from.handle == INVALID_HANDLE_VALUE)
-        {
-        fail_last_error:
-            DWORD err = ::GetLastError();
-            emit_error(err, from, to, ec, "boost::filesystem::copy_file");
-            return false;
-        }
+        *ec = local_ec;
+        return path();
+    }
 
-        if (!::GetFileTime(hw_from.handle, NULL, NULL, &lwt_from))
-            goto fail_last_error;
+    return result;
+}
 
-        hw_to.handle = create_file_handle(to.c_str(), FILE_READ_ATTRIBUTES, FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS);
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                          class directory_handle implementation                       //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
 
-        if (hw_to.handle != INVALID_HANDLE_VALUE)
-        {
-            FILETIME lwt_to;
-            if (!::GetFileTime(hw_to.handle, NULL, NULL, &lwt_to))
-                goto fail_last_error;
+#if defined(BOOST_WINDOWS_API) && !defined(UNDER_CE)
 
-            ULONGLONG tfrom = (static_cast< ULONGLONG >(lwt_from.dwHighDateTime) << 32) | static_cast< ULONGLONG >(lwt_from.dwLowDateTime);
-            ULONGLONG tto = (static_cast< ULONGLONG >(lwt_to.dwHighDateTime) << 32) | static_cast< ULONGLONG >(lwt_to.dwLowDateTime);
-            if (tfrom <= tto)
-                return false;
-        }
+namespace detail {
+namespace {
 
-        copy_flags &= ~static_cast< DWORD >(COPY_FILE_FAIL_IF_EXISTS);
+//! Opens a file relative to a directory handle. The path must be relative. Returns 0 on success or the error code otherwise.
+DWORD open_file_at(handle_wrapper& h, HANDLE basedir_handle, path const& p, ACCESS_MASK access, ULONG create_disposition, ULONG create_options)
+{
+    // NtCreateFile does not interpret dot elements, and an empty name refers to the base directory itself
+    path rel_path;
+    if (p.native().size() != 1u || p.native()[0] != path::dot)
+    {
+        rel_path = p;
+        rel_path.make_preferred();
     }
 
-    struct callback_context
-    {
-        DWORD flush_error;
-    };
+    HANDLE handle = INVALID_HANDLE_VALUE;
+    boost::winapi::NTSTATUS_ status = nt_create_file_handle_at
+    (
+        handle,
+        basedir_handle,
+        rel_path,
+        0u, // FileAttributes
+        access | SYNCHRONIZE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        create_disposition,
+        create_options | FILE_OPEN_FOR_BACKUP_INTENT
+    );
 
-    struct local
-    {
-        //! Callback that is called to report progress of \c CopyFileExW
-        static DWORD WINAPI on_copy_file_progress(
-            LARGE_INTEGER total_file_size,
-            LARGE_INTEGER total_bytes_transferred,
-            LARGE_INTEGER stream_size,
-            LARGE_INTEGER stream_bytes_transferred,
-            DWORD stream_number,
-            DWORD callback_reason,
-            HANDLE from_handle,
-            HANDLE to_handle,
-            LPVOID ctx)
-        {
-            // For each stream, CopyFileExW will open a separate pair of file handles, so we need to flush each stream separately.
-            if (stream_bytes_transferred.QuadPart == stream_size.QuadPart)
-            {
-                BOOL res = ::FlushFileBuffers(to_handle);
-                if (BOOST_UNLIKELY(!res))
-                {
-                    callback_context* context = static_cast< callback_context* >(ctx);
-                    if (BOOST_LIKELY(context->flush_error == 0u))
-                        context->flush_error = ::GetLastError();
-                }
-            }
+    if (BOOST_UNLIKELY(!NT_SUCCESS(status)))
+        return translate_ntstatus(status);
 
-            return PROGRESS_CONTINUE;
-        }
-    };
+    h.handle = handle;
+    return 0u;
+}
 
-    callback_context cb_context = {};
-    LPPROGRESS_ROUTINE cb = NULL;
-    LPVOID cb_ctx = NULL;
+} // unnamed namespace
+} // namespace detail
 
-    if ((options & (static_cast< unsigned int >(copy_options::synchronize_data) | static_cast< unsigned int >(copy_options::synchronize))) != 0u)
-    {
-        cb = &local::on_copy_file_progress;
-        cb_ctx = &cb_context;
-    }
+#endif // defined(BOOST_WINDOWS_API) && !defined(UNDER_CE)
 
-    BOOL cancelled = FALSE;
-    BOOL res = ::CopyFileExW(from.c_str(), to.c_str(), cb, cb_ctx, &cancelled, copy_flags);
-    DWORD err;
-    if (BOOST_UNLIKELY(!res))
-    {
-        err = ::GetLastError();
-        if ((err == ERROR_FILE_EXISTS || err == ERROR_ALREADY_EXISTS) && (options & static_cast< unsigned int >(copy_options::skip_existing)) != 0u)
-            return false;
+namespace detail {
+namespace {
+
+#if defined(BOOST_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+
+#if defined(BOOST_FILESYSTEM_HAS_OPENAT2)
+
+//! struct open_how definition from linux/openat2.h, which may not be available in older kernel headers
+struct open_how_t
+{
+    boost::uint64_t flags;
+    boost::uint64_t mode;
+    boost::uint64_t resolve;
+};
+
+//! Indicates that openat2 is not supported by the kernel or blocked by a seccomp filter
+bool openat2_unsupported = false;
 
-    copy_failed:
-        emit_error(err, from, to, ec, "boost::filesystem::copy_file");
-        return false;
-    }
+#endif // defined(BOOST_FILESYSTEM_HAS_OPENAT2)
 
-    if (BOOST_UNLIKELY(cb_context.flush_error != 0u))
+//! Maximum number of symlinks followed while walking a path in open_dir_beneath_walk, same as the Linux limit
+BOOST_CONSTEXPR_OR_CONST unsigned int max_beneath_symlinks = 40u;
+
+//! Flags for opening directories in open_dir_beneath
+BOOST_CONSTEXPR_OR_CONST int open_beneath_flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+
+//! Stack of open directories on the path being resolved by open_dir_beneath_walk
+class fd_stack
+{
+private:
+    std::vector< int > m_fds;
+
+public:
+    fd_stack() BOOST_NOEXCEPT {}
+    ~fd_stack() BOOST_NOEXCEPT
     {
-        err = cb_context.flush_error;
-        goto copy_failed;
+        while (!m_fds.empty())
+            pop();
     }
 
-    return true;
+    BOOST_DELETED_FUNCTION(fd_stack(fd_stack const&))
+    BOOST_DELETED_FUNCTION(fd_stack& operator=(fd_stack const&))
 
-#endif // defined(BOOST_POSIX_API)
-}
+    bool empty() const BOOST_NOEXCEPT { return m_fds.empty(); }
+    int top() const BOOST_NOEXCEPT { return m_fds.back(); }
+    //! Pushes \a fd to the stack. Closes \a fd if the stack cannot be extended.
+    void push(int fd)
+    {
+        try
+        {
+            m_fds.push_back(fd);
+        }
+        catch (...)
+        {
+            close_fd(fd);
+            throw;
+        }
+    }
+    void pop() BOOST_NOEXCEPT
+    {
+        close_fd(m_fds.back());
+        m_fds.pop_back();
+    }
+    //! Removes the top directory from the stack and returns it. The caller takes ownership of the file descriptor.
+    int release_top() BOOST_NOEXCEPT
+    {
+        const int fd = m_fds.back();
+        m_fds.pop_back();
+        return fd;
+    }
+};
 
-BOOST_FILESYSTEM_DECL
-void copy_symlink(path const& existing_symlink, path const& new_symlink, system::error_code* ec)
+//! Pushes the elements of \a p onto \a pending in reverse order, so that the first element is on the top
+void push_pending_elements(std::vector< path >& pending, path const& p)
 {
-    path p(read_symlink(existing_symlink, ec));
-    if (ec && *ec)
-        return;
-    create_symlink(p, new_symlink, ec);
+    const std::size_t pos = pending.size();
+    for (path::const_iterator it = p.begin(), end = p.end(); it != end; ++it)
+        pending.push_back(*it);
+    std::reverse(pending.begin() + pos, pending.end());
 }
 
-BOOST_FILESYSTEM_DECL
-bool create_directories(path const& p, system::error_code* ec)
+/*!
+ * \brief Opens directory \a p relative to \a basedir_fd by walking its elements
+ *
+ * Every element is opened with \c O_NOFOLLOW relative to the previous one, and the directories passed on the way are
+ * kept open, so that dot-dot elements return to the directories that were actually traversed rather than being resolved
+ * by the kernel. Symlinks are read and their targets are resolved the same way.
+ */
+int open_dir_beneath_walk(int basedir_fd, path const& p, unsigned int opts, int& result_fd)
 {
-    if (p.empty())
+    dev_t basedir_dev = 0;
+    if ((opts & static_cast< unsigned int >(resolve_options::no_cross_device)) != 0u)
     {
-        if (!ec)
-        {
-            BOOST_FILESYSTEM_THROW(filesystem_error(
-                "boost::filesystem::create_directories", p,
-                system::errc::make_error_code(system::errc::invalid_argument)));
-        }
-        ec->assign(system::errc::invalid_argument, system::generic_category());
-        return false;
+        struct ::stat st;
+        if (BOOST_UNLIKELY(::fstat(basedir_fd, &st) != 0))
+            return errno;
+        basedir_dev = st.st_dev;
     }
 
-    if (ec)
-        ec->clear();
+    std::vector< path > pending;
+    push_pending_elements(pending, p);
 
-    path::const_iterator e(p.end()), it(e);
-    path parent(p);
     path const& dot_p = dot_path();
     path const& dot_dot_p = dot_dot_path();
-    error_code local_ec;
-
-    // Find the initial part of the path that exists
-    for (path fname = parent.filename(); parent.has_relative_path(); fname = parent.filename())
+    fd_stack dirs;
+    read_symlink_buffer symlink_buf;
+    unsigned int symlink_count = 0u;
+    while (!pending.empty())
     {
-        if (!fname.empty() && fname != dot_p && fname != dot_dot_p)
+        path elem;
+        elem.swap(pending.back());
+        pending.pop_back();
+
+        if (elem.empty() || elem == dot_p)
+            continue;
+
+        if (elem == dot_dot_p)
         {
-            file_status existing_status = detail::status_impl(parent, &local_ec);
+            if (dirs.empty())
+                return EXDEV;
+            dirs.pop();
+            continue;
+        }
 
-            if (existing_status.type() == directory_file)
-            {
-                break;
-            }
-            else if (BOOST_UNLIKELY(existing_status.type() == status_error))
+        const int parent_fd = dirs.empty() ? basedir_fd : dirs.top();
+        const int fd = ::openat(parent_fd, elem.c_str(), open_beneath_flags | O_NOFOLLOW);
+        if (fd >= 0)
+        {
+            dirs.push(fd);
+
+            if ((opts & static_cast< unsigned int >(resolve_options::no_cross_device)) != 0u)
             {
-                if (!ec)
-                    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::create_directories", p, parent, local_ec));
-                *ec = local_ec;
-                return false;
+                struct ::stat st;
+                if (BOOST_UNLIKELY(::fstat(fd, &st) != 0))
+                    return errno;
+                if (st.st_dev != basedir_dev)
+                    return EXDEV;
             }
+
+            continue;
         }
 
-        --it;
-        parent.remove_filename();
+        int err = errno;
+        // Opening a symlink with O_NOFOLLOW fails with ELOOP on Linux, EMLINK on FreeBSD and ENOTDIR when combined with O_DIRECTORY on some systems
+        if (err != ELOOP && err != EMLINK && err != ENOTDIR)
+            return err;
+
+        struct ::stat st;
+        if (::fstatat(parent_fd, elem.c_str(), &st, AT_SYMLINK_NOFOLLOW) != 0 || !S_ISLNK(st.st_mode))
+            return err;
+
+        if ((opts & static_cast< unsigned int >(resolve_options::no_symlinks)) != 0u || ++symlink_count > max_beneath_symlinks)
+            return ELOOP;
+
+        path target;
+        err = read_symlink_impl(elem, target, symlink_buf, parent_fd);
+        if (BOOST_UNLIKELY(err != 0))
+            return err;
+
+        // Absolute symlinks always refer outside the base directory, as in RESOLVE_BENEATH
+        if (target.has_root_directory())
+            return EXDEV;
+
+        push_pending_elements(pending, target);
     }
 
-    // Create missing directories
-    bool created = false;
-    for (; it != e; ++it)
+    if (dirs.empty())
     {
-        path const& fname = *it;
-        parent /= fname;
-        if (!fname.empty() && fname != dot_p && fname != dot_dot_p)
-        {
-            created = detail::create_directory(parent, NULL, &local_ec);
-            if (BOOST_UNLIKELY(!!local_ec))
-            {
-                if (!ec)
-                    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::create_directories", p, parent, local_ec));
-                *ec = local_ec;
-                return false;
-            }
-        }
+        // The path refers to the base directory itself
+        const int fd = ::openat(basedir_fd, ".", open_beneath_flags);
+        if (BOOST_UNLIKELY(fd < 0))
+            return errno;
+        dirs.push(fd);
     }
 
-    return created;
+    result_fd = dirs.release_top();
+    return 0;
 }
 
-BOOST_FILESYSTEM_DECL
-bool create_directory(path const& p, const path* existing, error_code* ec)
+//! Opens directory \a p relative to \a basedir_fd, without escaping it. Returns 0 on success, otherwise an error code.
+int open_dir_beneath(int basedir_fd, path const& p, unsigned int opts, int& result_fd)
 {
-    if (ec)
-        ec->clear();
-
-#if defined(BOOST_POSIX_API)
+    if (p.has_root_directory())
+        return EXDEV;
 
-    mode_t mode = S_IRWXU | S_IRWXG | S_IRWXO;
-    if (existing)
+#if defined(BOOST_FILESYSTEM_HAS_OPENAT2)
+    if (!filesystem::detail::atomic_load_relaxed(openat2_unsupported))
     {
-#if defined(BOOST_FILESYSTEM_USE_STATX)
-        struct ::statx existing_stat;
-        if (BOOST_UNLIKELY(invoke_statx(AT_FDCWD, existing->c_str(), AT_NO_AUTOMOUNT, STATX_TYPE | STATX_MODE, &existing_stat) < 0))
+        open_how_t how;
+        how.flags = static_cast< boost::uint64_t >(open_beneath_flags);
+        how.mode = 0u;
+        how.resolve = RESOLVE_BENEATH | RESOLVE_NO_MAGICLINKS;
+        if ((opts & static_cast< unsigned int >(resolve_options::no_symlinks)) != 0u)
+            how.resolve |= RESOLVE_NO_SYMLINKS;
+        if ((opts & static_cast< unsigned int >(resolve_options::no_cross_device)) != 0u)
+            how.resolve |= RESOLVE_NO_XDEV;
+
+        const long fd = ::syscall(__NR_openat2, basedir_fd, p.c_str(), &how, sizeof(how));
+        if (fd >= 0)
         {
-            emit_error(errno, p, *existing, ec, "boost::filesystem::create_directory");
-            return false;
+            result_fd = static_cast< int >(fd);
+            return 0;
         }
 
-        if (BOOST_UNLIKELY((existing_stat.stx_mask & (STATX_TYPE | STATX_MODE)) != (STATX_TYPE | STATX_MODE)))
+        const int err = errno;
+        if (err == ENOSYS || err == EPERM)
         {
-            emit_error(BOOST_ERROR_NOT_SUPPORTED, p, *existing, ec, "boost::filesystem::create_directory");
-            return false;
+            // EPERM is returned when the syscall is blocked by a seccomp filter
+            filesystem::detail::atomic_store_relaxed(openat2_unsupported, true);
         }
-#else
-        struct ::stat existing_stat;
-        if (::stat(existing->c_str(), &existing_stat) < 0)
+        else if (err != EAGAIN && err != EINVAL && err != E2BIG)
         {
-            emit_error(errno, p, *existing, ec, "boost::filesystem::create_directory");
-            return false;
+            // EAGAIN means that a concurrent rename was detected while resolving a dot-dot element, which the walk is immune to.
+            // EINVAL and E2BIG may be returned if the kernel does not support some of the resolve flags.
+            return err;
         }
-#endif
+    }
+#endif // defined(BOOST_FILESYSTEM_HAS_OPENAT2)
 
-        const mode_t existing_mode = get_mode(existing_stat);
-        if (!S_ISDIR(existing_mode))
+    return open_dir_beneath_walk(basedir_fd, p, opts, result_fd);
+}
+
+#elif defined(BOOST_WINDOWS_API) && !defined(UNDER_CE)
+
+//! Stack of open directories on the path being resolved by open_dir_beneath
+class handle_stack
+{
+private:
+    std::vector< HANDLE > m_handles;
+
+public:
+    handle_stack() BOOST_NOEXCEPT {}
+    ~handle_stack() BOOST_NOEXCEPT
+    {
+        while (!m_handles.empty())
+            pop();
+    }
+
+    BOOST_DELETED_FUNCTION(handle_stack(handle_stack const&))
+    BOOST_DELETED_FUNCTION(handle_stack& operator=(handle_stack const&))
+
+    bool empty() const BOOST_NOEXCEPT { return m_handles.empty(); }
+    HANDLE top() const BOOST_NOEXCEPT { return m_handles.back(); }
+    //! Pushes the handle owned by \a h to the stack and takes the ownership of the handle
+    void push(handle_wrapper& h)
+    {
+        m_handles.push_back(h.handle);
+        h.handle = INVALID_HANDLE_VALUE;
+    }
+    void pop() BOOST_NOEXCEPT
+    {
+        ::CloseHandle(m_handles.back());
+        m_handles.pop_back();
+    }
+    //! Removes the top directory from the stack and returns it. The caller takes ownership of the handle.
+    HANDLE release_top() BOOST_NOEXCEPT
+    {
+        HANDLE h = m_handles.back();
+        m_handles.pop_back();
+        return h;
+    }
+};
+
+/*!
+ * \brief Opens directory \a p relative to \a basedir_handle, without escaping it
+ *
+ * The path is resolved one element at a time relative to the previously opened directory, and the directories passed on the way
+ * are kept open, so that dot-dot elements return to the directories that were actually traversed. Symlinks and junctions are
+ * opened as reparse points and rejected, since their targets cannot be safely resolved relative to a handle.
+ */
+error_code open_dir_beneath(HANDLE basedir_handle, path const& p, unsigned int opts, HANDLE& result_handle)
+{
+    if (p.has_root_path())
+        return error_code(ERROR_NOT_SAME_DEVICE, system_category());
+
+    DWORD basedir_volume = 0u;
+    if ((opts & static_cast< unsigned int >(resolve_options::no_cross_device)) != 0u)
+    {
+        BY_HANDLE_FILE_INFORMATION info;
+        if (BOOST_UNLIKELY(!::GetFileInformationByHandle(basedir_handle, &info)))
+            return error_code(::GetLastError(), system_category());
+        basedir_volume = info.dwVolumeSerialNumber;
+    }
+
+    path const& dot_p = dot_path();
+    path const& dot_dot_p = dot_dot_path();
+    handle_stack dirs;
+    for (path::const_iterator it = p.begin(), end = p.end(); it != end; ++it)
+    {
+        path const& elem = *it;
+        if (elem.empty() || elem == dot_p)
+            continue;
+
+        if (elem == dot_dot_p)
         {
-            emit_error(ENOTDIR, p, *existing, ec, "boost::filesystem::create_directory");
-            return false;
+            if (dirs.empty())
+                return error_code(ERROR_NOT_SAME_DEVICE, system_category());
+            dirs.pop();
+            continue;
         }
 
-        mode = existing_mode;
-    }
+        handle_wrapper h;
+        DWORD err = open_file_at(h, dirs.empty() ? basedir_handle : dirs.top(), elem, FILE_LIST_DIRECTORY | FILE_TRAVERSE | FILE_READ_ATTRIBUTES,
+            FILE_OPEN, FILE_DIRECTORY_FILE | FILE_OPEN_REPARSE_POINT);
+        if (BOOST_UNLIKELY(err != 0u))
+            return error_code(err, system_category());
 
-    if (::mkdir(p.c_str(), mode) == 0)
-        return true;
+        BY_HANDLE_FILE_INFORMATION info;
+        if (BOOST_UNLIKELY(!::GetFileInformationByHandle(h.handle, &info)))
+            return error_code(::GetLastError(), system_category());
 
-#else // defined(BOOST_POSIX_API)
+        if ((info.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0u && is_reparse_point_a_symlink_ioctl(h.handle))
+            return make_error_code(system::errc::too_many_symbolic_link_levels);
 
-    BOOL res;
-    if (existing)
-        res = ::CreateDirectoryExW(existing->c_str(), p.c_str(), NULL);
-    else
-        res = ::CreateDirectoryW(p.c_str(), NULL);
+        if ((opts & static_cast< unsigned int >(resolve_options::no_cross_device)) != 0u && info.dwVolumeSerialNumber != basedir_volume)
+            return error_code(ERROR_NOT_SAME_DEVICE, system_category());
 
-    if (res)
-        return true;
+        dirs.push(h);
+    }
 
-#endif // defined(BOOST_POSIX_API)
+    if (dirs.empty())
+    {
+        // The path refers to the base directory itself
+        handle_wrapper h;
+        DWORD err = open_file_at(h, basedir_handle, dot_p, FILE_LIST_DIRECTORY | FILE_TRAVERSE | FILE_READ_ATTRIBUTES, FILE_OPEN, FILE_DIRECTORY_FILE);
+        if (BOOST_UNLIKELY(err != 0u))
+            return error_code(err, system_category());
+        dirs.push(h);
+    }
 
-    //  attempt to create directory failed
-    err_t errval = BOOST_ERRNO; // save reason for failure
-    error_code dummy;
+    result_handle = dirs.release_top();
+    return error_code();
+}
 
-    if (is_directory(p, dummy))
-        return false;
+#endif
 
-    //  attempt to create directory failed && it doesn't already exist
-    emit_error(errval, p, ec, "boost::filesystem::create_directory");
-    return false;
+} // unnamed namespace
+} // namespace detail
+
+BOOST_FILESYSTEM_DECL
+void directory_handle::close() BOOST_NOEXCEPT
+{
+    if (m_handle != invalid_native_handle())
+    {
+#if defined(BOOST_POSIX_API)
+        detail::close_fd(m_handle);
+#else
+        ::CloseHandle(m_handle);
+#endif
+        m_handle = invalid_native_handle();
+    }
 }
 
-// Deprecated, to be removed in a future release
 BOOST_FILESYSTEM_DECL
-void copy_directory(path const& from, path const& to, system::error_code* ec)
+void directory_handle::open_impl(directory_handle const* base, path const& p, system::error_code* ec)
 {
     if (ec)
         ec->clear();
 
 #if defined(BOOST_POSIX_API)
 
-#if defined(BOOST_FILESYSTEM_USE_STATX)
-    int err;
-    struct ::statx from_stat;
-    if (BOOST_UNLIKELY(invoke_statx(AT_FDCWD, from.c_str(), AT_NO_AUTOMOUNT, STATX_TYPE | STATX_MODE, &from_stat) < 0))
+    int flags = O_RDONLY | O_CLOEXEC;
+#if defined(O_DIRECTORY)
+    flags |= O_DIRECTORY;
+#endif
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    detail::fd_wrapper fd(::openat(base ? base->m_handle : AT_FDCWD, p.c_str(), flags));
+#else
+    if (BOOST_UNLIKELY(base != NULL && !p.has_root_directory()))
     {
-    fail_errno:
-        err = errno;
-    fail:
-        emit_error(err, from, to, ec, "boost::filesystem::copy_directory");
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::directory_handle::open");
         return;
     }
 
-    if (BOOST_UNLIKELY((from_stat.stx_mask & (STATX_TYPE | STATX_MODE)) != (STATX_TYPE | STATX_MODE)))
+    detail::fd_wrapper fd(::open(p.c_str(), flags));
+#endif
+    if (BOOST_UNLIKELY(fd.fd < 0))
     {
-        err = BOOST_ERROR_NOT_SUPPORTED;
-        goto fail;
+        emit_error(errno, p, ec, "boost::filesystem::directory_handle::open");
+        return;
+    }
+
+#if defined(BOOST_FILESYSTEM_NO_O_CLOEXEC) && defined(FD_CLOEXEC)
+    if (BOOST_UNLIKELY(::fcntl(fd.fd, F_SETFD, FD_CLOEXEC) < 0))
+    {
+        emit_error(errno, p, ec, "boost::filesystem::directory_handle::open");
+        return;
+    }
+#endif
+
+#if !defined(O_DIRECTORY)
+    struct ::stat st;
+    if (BOOST_UNLIKELY(::fstat(fd.fd, &st) < 0))
+    {
+        emit_error(errno, p, ec, "boost::filesystem::directory_handle::open");
+        return;
+    }
+
+    if (BOOST_UNLIKELY(!S_ISDIR(st.st_mode)))
+    {
+        emit_error(ENOTDIR, p, ec, "boost::filesystem::directory_handle::open");
+        return;
+    }
+#endif
+
+    assign(fd.fd);
+    fd.fd = -1;
+
+#else // defined(BOOST_POSIX_API)
+
+    detail::handle_wrapper h;
+    if (base == NULL || p.has_root_path())
+    {
+        h.handle = detail::create_file_handle(
+            p,
+            FILE_LIST_DIRECTORY | FILE_TRAVERSE | FILE_READ_ATTRIBUTES,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL, // lpSecurityAttributes
+            OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS);
+
+        if (BOOST_UNLIKELY(h.handle == INVALID_HANDLE_VALUE))
+        {
+            emit_error(::GetLastError(), p, ec, "boost::filesystem::directory_handle::open");
+            return;
+        }
+
+        // FILE_FLAG_BACKUP_SEMANTICS allows to open regular files as well
+        BY_HANDLE_FILE_INFORMATION info;
+        if (BOOST_UNLIKELY(!::GetFileInformationByHandle(h.handle, &info)))
+        {
+            emit_error(::GetLastError(), p, ec, "boost::filesystem::directory_handle::open");
+            return;
+        }
+
+        if (BOOST_UNLIKELY((info.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0u))
+        {
+            emit_error(ERROR_DIRECTORY, p, ec, "boost::filesystem::directory_handle::open");
+            return;
+        }
     }
-#else
-    struct ::stat from_stat;
-    if (BOOST_UNLIKELY(::stat(from.c_str(), &from_stat) < 0))
+    else
     {
-    fail_errno:
-        emit_error(errno, from, to, ec, "boost::filesystem::copy_directory");
+#if !defined(UNDER_CE)
+        DWORD err = detail::open_file_at(h, base->m_handle, p, FILE_LIST_DIRECTORY | FILE_TRAVERSE | FILE_READ_ATTRIBUTES, FILE_OPEN, FILE_DIRECTORY_FILE);
+        if (BOOST_UNLIKELY(err != 0u))
+        {
+            emit_error(err, p, ec, "boost::filesystem::directory_handle::open");
+            return;
+        }
+#else
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::directory_handle::open");
         return;
-    }
 #endif
+    }
 
-    if (BOOST_UNLIKELY(::mkdir(to.c_str(), get_mode(from_stat)) < 0))
-        goto fail_errno;
-
-#else // defined(BOOST_POSIX_API)
-
-    if (BOOST_UNLIKELY(!::CreateDirectoryExW(from.c_str(), to.c_str(), 0)))
-        emit_error(BOOST_ERRNO, from, to, ec, "boost::filesystem::copy_directory");
+    assign(h.handle);
+    h.handle = INVALID_HANDLE_VALUE;
 
 #endif // defined(BOOST_POSIX_API)
 }
 
 BOOST_FILESYSTEM_DECL
-void create_directory_symlink(path const& to, path const& from, system::error_code* ec)
+void directory_handle::open_beneath_impl(directory_handle const& base, path const& p, unsigned int opts, system::error_code* ec)
 {
     if (ec)
         ec->clear();
 
 #if defined(BOOST_POSIX_API)
-    int err = ::symlink(to.c_str(), from.c_str());
-    if (BOOST_UNLIKELY(err < 0))
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    int fd = -1;
+    const int err = detail::open_dir_beneath(base.m_handle, p, opts, fd);
+    if (BOOST_UNLIKELY(err != 0))
     {
-        err = errno;
-        emit_error(err, to, from, ec, "boost::filesystem::create_directory_symlink");
+        emit_error(err, p, ec, "boost::filesystem::directory_handle::open_beneath");
+        return;
     }
-#else
-    // see if actually supported by Windows runtime dll
-    if (!create_symbolic_link_api)
+
+#if defined(BOOST_FILESYSTEM_NO_O_CLOEXEC) && defined(FD_CLOEXEC)
+    if (BOOST_UNLIKELY(::fcntl(fd, F_SETFD, FD_CLOEXEC) < 0))
     {
-        emit_error(BOOST_ERROR_NOT_SUPPORTED, to, from, ec, "boost::filesystem::create_directory_symlink");
+        const int fcntl_err = errno;
+        detail::close_fd(fd);
+        emit_error(fcntl_err, p, ec, "boost::filesystem::directory_handle::open_beneath");
         return;
     }
+#endif
 
-    if (!create_symbolic_link_api(from.c_str(), to.c_str(), SYMBOLIC_LINK_FLAG_DIRECTORY | SYMBOLIC_LINK_FLAG_ALLOW_UNPRIVILEGED_CREATE))
+    assign(fd);
+#else
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::directory_handle::open_beneath");
+#endif
+
+#else // defined(BOOST_POSIX_API)
+
+#if !defined(UNDER_CE)
+    HANDLE h = INVALID_HANDLE_VALUE;
+    const error_code err = detail::open_dir_beneath(base.m_handle, p, opts, h);
+    if (BOOST_UNLIKELY(!!err))
     {
-        emit_error(BOOST_ERRNO, to, from, ec, "boost::filesystem::create_directory_symlink");
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::directory_handle::open_beneath", p, err));
+        *ec = err;
+        return;
     }
+
+    assign(h);
+#else
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::directory_handle::open_beneath");
 #endif
+
+#endif // defined(BOOST_POSIX_API)
 }
 
 BOOST_FILESYSTEM_DECL
-void create_hard_link(path const& to, path const& from, error_code* ec)
+file_status directory_handle::status_impl(path const& p, bool symlink, system::error_code* ec) const
 {
     if (ec)
         ec->clear();
 
 #if defined(BOOST_POSIX_API)
-    int err = ::link(to.c_str(), from.c_str());
-    if (BOOST_UNLIKELY(err < 0))
-    {
-        err = errno;
-        emit_error(err, to, from, ec, "boost::filesystem::create_hard_link");
-    }
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    return symlink ? detail::symlink_status_impl(p, ec, m_handle) : detail::status_impl(p, ec, m_handle);
 #else
-    // see if actually supported by Windows runtime dll
-    CreateHardLinkW_t* chl_api = filesystem::detail::atomic_load_relaxed(create_hard_link_api);
-    if (BOOST_UNLIKELY(!chl_api))
-    {
-        emit_error(BOOST_ERROR_NOT_SUPPORTED, to, from, ec, "boost::filesystem::create_hard_link");
-        return;
-    }
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, symlink ? "boost::filesystem::directory_handle::symlink_status" : "boost::filesystem::directory_handle::status");
+    return file_status(status_error);
+#endif
 
-    if (BOOST_UNLIKELY(!chl_api(from.c_str(), to.c_str(), NULL)))
+#else // defined(BOOST_POSIX_API)
+
+    if (p.has_root_path())
+        return symlink ? detail::symlink_status_impl(p, ec) : detail::status_impl(p, ec);
+
+#if !defined(UNDER_CE)
+    detail::handle_wrapper h;
+    DWORD err = detail::open_file_at(h, m_handle, p, FILE_READ_ATTRIBUTES, FILE_OPEN, FILE_OPEN_REPARSE_POINT);
+    if (BOOST_UNLIKELY(err != 0u))
+        return detail::process_status_failure(err, p, ec);
+
+    file_status st = detail::status_by_handle(h.handle, p, ec);
+    if (!symlink && st.type() == symlink_file)
     {
-        emit_error(BOOST_ERRNO, to, from, ec, "boost::filesystem::create_hard_link");
+        // Resolve the symlink
+        detail::handle_wrapper target_h;
+        err = detail::open_file_at(target_h, m_handle, p, FILE_READ_ATTRIBUTES, FILE_OPEN, 0u);
+        if (BOOST_UNLIKELY(err != 0u))
+            return detail::process_status_failure(err, p, ec);
+
+        st = detail::status_by_handle(target_h.handle, p, ec);
     }
+
+    return st;
+#else
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, symlink ? "boost::filesystem::directory_handle::symlink_status" : "boost::filesystem::directory_handle::status");
+    return file_status(status_error);
 #endif
+
+#endif // defined(BOOST_POSIX_API)
 }
 
 BOOST_FILESYSTEM_DECL
-void create_symlink(path const& to, path const& from, error_code* ec)
+file_attributes directory_handle::query_impl(path const& p, unsigned int mask, system::error_code* ec) const
 {
     if (ec)
         ec->clear();
 
 #if defined(BOOST_POSIX_API)
-    int err = ::symlink(to.c_str(), from.c_str());
-    if (BOOST_UNLIKELY(err < 0))
-    {
-        err = errno;
-        emit_error(err, to, from, ec, "boost::filesystem::create_symlink");
-    }
-#else
-    // see if actually supported by Windows runtime dll
-    CreateSymbolicLinkW_t* csl_api = filesystem::detail::atomic_load_relaxed(create_symbolic_link_api);
-    if (BOOST_UNLIKELY(!csl_api))
-    {
-        emit_error(BOOST_ERROR_NOT_SUPPORTED, to, from, ec, "boost::filesystem::create_symlink");
-        return;
-    }
 
-    if (BOOST_UNLIKELY(!csl_api(from.c_str(), to.c_str(), SYMBOLIC_LINK_FLAG_ALLOW_UNPRIVILEGED_CREATE)))
-    {
-        emit_error(BOOST_ERRNO, to, from, ec, "boost::filesystem::create_symlink");
-    }
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    return detail::query_impl(p, mask, ec, m_handle);
+#else
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::directory_handle::query");
+    return file_attributes();
 #endif
-}
 
-BOOST_FILESYSTEM_DECL
-path current_path(error_code* ec)
-{
-#if defined(UNDER_CE) || defined(BOOST_FILESYSTEM_USE_WASI)
-    // Windows CE has no current directory, so everything's relative to the root of the directory tree.
-    // WASI also does not support current path.
-    emit_error(BOOST_ERROR_NOT_SUPPORTED, ec, "boost::filesystem::current_path");
-    return path();
-#elif defined(BOOST_POSIX_API)
-    struct local
-    {
-        static bool getcwd_error(error_code* ec)
-        {
-            const int err = errno;
-            return error((err != ERANGE
-#if defined(__MSL__) && (defined(macintosh) || defined(__APPLE__) || defined(__APPLE_CC__))
-                          // bug in some versions of the Metrowerks C lib on the Mac: wrong errno set
-                          && err != 0
-#endif
-                          ) ? err : 0,
-                         ec, "boost::filesystem::current_path");
-        }
-    };
+#else // defined(BOOST_POSIX_API)
 
-    path cur;
-    char small_buf[small_path_size];
-    const char* p = ::getcwd(small_buf, sizeof(small_buf));
-    if (BOOST_LIKELY(!!p))
-    {
-        cur = p;
-        if (ec)
-            ec->clear();
-    }
-    else if (BOOST_LIKELY(!local::getcwd_error(ec)))
-    {
-        for (std::size_t path_max = sizeof(small_buf) * 2u;; path_max *= 2u) // loop 'til buffer large enough
-        {
-            if (BOOST_UNLIKELY(path_max > absolute_path_max))
-            {
-                emit_error(ENAMETOOLONG, ec, "boost::filesystem::current_path");
-                break;
-            }
+    if (p.has_root_path())
+        return detail::query(p, mask, ec);
 
-            boost::scoped_array< char > buf(new char[path_max]);
-            p = ::getcwd(buf.get(), path_max);
-            if (BOOST_LIKELY(!!p))
-            {
-                cur = buf.get();
-                if (ec)
-                    ec->clear();
-                break;
-            }
-            else if (BOOST_UNLIKELY(local::getcwd_error(ec)))
-            {
-                break;
-            }
-        }
+#if !defined(UNDER_CE)
+    const bool follow_symlinks = (mask & static_cast< unsigned int >(file_attribute_mask::no_follow)) == 0u;
+    detail::handle_wrapper h;
+    DWORD err = detail::open_file_at(h, m_handle, p, FILE_READ_ATTRIBUTES, FILE_OPEN, follow_symlinks ? 0u : FILE_OPEN_REPARSE_POINT);
+    if (BOOST_UNLIKELY(err != 0u))
+    {
+        emit_error(err, p, ec, "boost::filesystem::directory_handle::query");
+        return file_attributes();
     }
 
-    return cur;
+    return detail::query_by_handle(h.handle, p, mask, ec);
 #else
-    DWORD sz;
-    if ((sz = ::GetCurrentDirectoryW(0, NULL)) == 0)
-        sz = 1;
-    boost::scoped_array< path::value_type > buf(new path::value_type[sz]);
-    error(::GetCurrentDirectoryW(sz, buf.get()) == 0 ? BOOST_ERRNO : 0, ec, "boost::filesystem::current_path");
-    return path(buf.get());
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::directory_handle::query");
+    return file_attributes();
 #endif
-}
 
-BOOST_FILESYSTEM_DECL
-void current_path(path const& p, system::error_code* ec)
-{
-#if defined(UNDER_CE) || defined(BOOST_FILESYSTEM_USE_WASI)
-    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::current_path");
-#else
-    error(!BOOST_SET_CURRENT_DIRECTORY(p.c_str()) ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::current_path");
-#endif
+#endif // defined(BOOST_POSIX_API)
 }
 
 BOOST_FILESYSTEM_DECL
-bool equivalent(path const& p1, path const& p2, system::error_code* ec)
+bool directory_handle::remove_impl(path const& p, system::error_code* ec) const
 {
-#if defined(BOOST_POSIX_API)
+    if (ec)
+        ec->clear();
 
-    // p2 is done first, so any error reported is for p1
-#if defined(BOOST_FILESYSTEM_USE_STATX)
-    struct ::statx s2;
-    int e2 = invoke_statx(AT_FDCWD, p2.c_str(), AT_NO_AUTOMOUNT, STATX_INO, &s2);
-    if (BOOST_LIKELY(e2 == 0))
-    {
-        if (BOOST_UNLIKELY((s2.stx_mask & STATX_INO) != STATX_INO))
-        {
-        fail_unsupported:
-            emit_error(BOOST_ERROR_NOT_SUPPORTED, p1, p2, ec, "boost::filesystem::equivalent");
-            return false;
-        }
-    }
+#if defined(BOOST_POSIX_API)
 
-    struct ::statx s1;
-    int e1 = invoke_statx(AT_FDCWD, p1.c_str(), AT_NO_AUTOMOUNT, STATX_INO, &s1);
-    if (BOOST_LIKELY(e1 == 0))
-    {
-        if (BOOST_UNLIKELY((s1.stx_mask & STATX_INO) != STATX_INO))
-            goto fail_unsupported;
-    }
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    return detail::remove_impl(p, ec, m_handle);
 #else
-    struct ::stat s2;
-    int e2 = ::stat(p2.c_str(), &s2);
-    struct ::stat s1;
-    int e1 = ::stat(p1.c_str(), &s1);
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::directory_handle::remove");
+    return false;
 #endif
 
-    if (BOOST_UNLIKELY(e1 != 0 || e2 != 0))
+#else // defined(BOOST_POSIX_API)
+
+    if (p.has_root_path())
+        return detail::remove_impl(p, ec);
+
+#if !defined(UNDER_CE)
+    const detail::remove_impl_type impl = detail::atomic_load_relaxed(detail::g_remove_impl_type);
+    if (BOOST_UNLIKELY(impl == detail::remove_nt5))
     {
-        // if one is invalid and the other isn't then they aren't equivalent,
-        // but if both are invalid then it is an error
-        if (e1 != 0 && e2 != 0)
-            emit_error(errno, p1, p2, ec, "boost::filesystem::equivalent");
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::directory_handle::remove");
         return false;
     }
 
-    return equivalent_stat(s1, s2);
-
-#else // Windows
-
-    // Thanks to Jeremy Maitin-Shepard for much help and for permission to
-    // base the equivalent() implementation on portions of his
-    // file-equivalence-win32.cpp experimental code.
-
-    // Note well: Physical location on external media is part of the
-    // equivalence criteria. If there are no open handles, physical location
-    // can change due to defragmentation or other relocations. Thus handles
-    // must be held open until location information for both paths has
-    // been retrieved.
-
-    // p2 is done first, so any error reported is for p1
-    handle_wrapper h2(create_file_handle(
-        p2.c_str(),
-        FILE_READ_ATTRIBUTES,
-        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
-        NULL,
-        OPEN_EXISTING,
-        FILE_FLAG_BACKUP_SEMANTICS));
-
-    handle_wrapper h1(create_file_handle(
-        p1.c_str(),
-        FILE_READ_ATTRIBUTES,
-        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
-        NULL,
-        OPEN_EXISTING,
-        FILE_FLAG_BACKUP_SEMANTICS));
+    detail::handle_wrapper h;
+    DWORD err = detail::open_file_at(h, m_handle, p, DELETE | FILE_READ_ATTRIBUTES | FILE_WRITE_ATTRIBUTES, FILE_OPEN, FILE_OPEN_REPARSE_POINT);
+    if (BOOST_LIKELY(err == 0u))
+        err = detail::remove_nt6_by_handle(h.handle, impl);
+
+    if (BOOST_UNLIKELY(err != 0u))
+    {
+        if (!detail::not_found_error(err))
+            emit_error(err, p, ec, "boost::filesystem::directory_handle::remove");
 
-    if (BOOST_UNLIKELY(h1.handle == INVALID_HANDLE_VALUE || h2.handle == INVALID_HANDLE_VALUE))
-    {
-        // if one is invalid and the other isn't, then they aren't equivalent,
-        // but if both are invalid then it is an error
-        if (h1.handle == INVALID_HANDLE_VALUE && h2.handle == INVALID_HANDLE_VALUE)
-            error(BOOST_ERRNO, p1, p2, ec, "boost::filesystem::equivalent");
         return false;
     }
 
-    // at this point, both handles are known to be valid
+    return true;
+#else
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::directory_handle::remove");
+    return false;
+#endif
 
-    BY_HANDLE_FILE_INFORMATION info1, info2;
+#endif // defined(BOOST_POSIX_API)
+}
 
-    if (error(!::GetFileInformationByHandle(h1.handle, &info1) ? BOOST_ERRNO : 0, p1, p2, ec, "boost::filesystem::equivalent"))
-        return false;
+BOOST_FILESYSTEM_DECL
+bool directory_handle::create_directory_impl(path const& p, system::error_code* ec) const
+{
+    if (ec)
+        ec->clear();
 
-    if (error(!::GetFileInformationByHandle(h2.handle, &info2) ? BOOST_ERRNO : 0, p1, p2, ec, "boost::filesystem::equivalent"))
+#if defined(BOOST_POSIX_API)
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    if (::mkdirat(m_handle, p.c_str(), S_IRWXU | S_IRWXG | S_IRWXO) == 0)
+        return true;
+
+    const int err = errno;
+    error_code dummy;
+    if (detail::status_impl(p, &dummy, m_handle).type() == directory_file)
         return false;
 
-    // In theory, volume serial numbers are sufficient to distinguish between
-    // devices, but in practice VSN's are sometimes duplicated, so last write
-    // time and file size are also checked.
-    return info1.dwVolumeSerialNumber == info2.dwVolumeSerialNumber &&
-        info1.nFileIndexHigh == info2.nFileIndexHigh &&
-        info1.nFileIndexLow == info2.nFileIndexLow &&
-        info1.nFileSizeHigh == info2.nFileSizeHigh &&
-        info1.nFileSizeLow == info2.nFileSizeLow &&
-        info1.ftLastWriteTime.dwLowDateTime == info2.ftLastWriteTime.dwLowDateTime &&
-        info1.ftLastWriteTime.dwHighDateTime == info2.ftLastWriteTime.dwHighDateTime;
+    emit_error(err, p, ec, "boost::filesystem::directory_handle::create_directory");
+#else
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::directory_handle::create_directory");
+#endif
+    return false;
+
+#else // defined(BOOST_POSIX_API)
+
+    if (p.has_root_path())
+        return detail::create_directory(p, NULL, ec);
+
+#if !defined(UNDER_CE)
+    detail::handle_wrapper h;
+    const DWORD err = detail::open_file_at(h, m_handle, p, FILE_LIST_DIRECTORY, FILE_CREATE, FILE_DIRECTORY_FILE);
+    if (BOOST_LIKELY(err == 0u))
+        return true;
+
+    error_code dummy;
+    if (status_impl(p, false, &dummy).type() == directory_file)
+        return false;
 
+    emit_error(err, p, ec, "boost::filesystem::directory_handle::create_directory");
+#else
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::directory_handle::create_directory");
 #endif
+    return false;
+
+#endif // defined(BOOST_POSIX_API)
 }
 
 BOOST_FILESYSTEM_DECL
-uintmax_t file_size(path const& p, error_code* ec)
+void directory_handle::rename_impl(path const& old_p, directory_handle const& new_dir, path const& new_p, system::error_code* ec) const
 {
+#if defined(BOOST_POSIX_API)
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    error(::renameat(m_handle, old_p.c_str(), new_dir.m_handle, new_p.c_str()) != 0 ? errno : 0, old_p, new_p, ec, "boost::filesystem::directory_handle::rename");
+#else
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, old_p, new_p, ec, "boost::filesystem::directory_handle::rename");
+#endif
+
+#else // defined(BOOST_POSIX_API)
+
     if (ec)
         ec->clear();
 
-#if defined(BOOST_POSIX_API)
-
-#if defined(BOOST_FILESYSTEM_USE_STATX)
-    struct ::statx path_stat;
-    if (BOOST_UNLIKELY(invoke_statx(AT_FDCWD, p.c_str(), AT_NO_AUTOMOUNT, STATX_TYPE | STATX_SIZE, &path_stat) < 0))
+#if !defined(UNDER_CE)
+    SetFileInformationByHandle_t* set_file_information_by_handle = detail::atomic_load_relaxed(detail::set_file_information_by_handle_api);
+    if (BOOST_UNLIKELY(!set_file_information_by_handle))
     {
-        emit_error(errno, p, ec, "boost::filesystem::file_size");
-        return static_cast< uintmax_t >(-1);
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, old_p, new_p, ec, "boost::filesystem::directory_handle::rename");
+        return;
     }
 
-    if (BOOST_UNLIKELY((path_stat.stx_mask & (STATX_TYPE | STATX_SIZE)) != (STATX_TYPE | STATX_SIZE) || !S_ISREG(path_stat.stx_mode)))
+    detail::handle_wrapper h;
+    DWORD err;
+    if (old_p.has_root_path())
     {
-        emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::file_size");
-        return static_cast< uintmax_t >(-1);
+        h.handle = detail::create_file_handle(
+            old_p,
+            DELETE | SYNCHRONIZE,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL, // lpSecurityAttributes
+            OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OPEN_REPARSE_POINT);
+        err = h.handle != INVALID_HANDLE_VALUE ? 0u : ::GetLastError();
     }
-#else
-    struct ::stat path_stat;
-    if (BOOST_UNLIKELY(::stat(p.c_str(), &path_stat) < 0))
+    else
     {
-        emit_error(errno, p, ec, "boost::filesystem::file_size");
-        return static_cast< uintmax_t >(-1);
+        err = detail::open_file_at(h, m_handle, old_p, DELETE, FILE_OPEN, FILE_OPEN_REPARSE_POINT);
     }
 
-    if (BOOST_UNLIKELY(!S_ISREG(path_stat.st_mode)))
+    if (BOOST_UNLIKELY(err != 0u))
     {
-        emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::file_size");
-        return static_cast< uintmax_t >(-1);
+        emit_error(err, old_p, new_p, ec, "boost::filesystem::directory_handle::rename");
+        return;
     }
-#endif
-
-    return get_size(path_stat);
 
-#else // defined(BOOST_POSIX_API)
-
-    // assume uintmax_t is 64-bits on all Windows compilers
-
-    WIN32_FILE_ATTRIBUTE_DATA fad;
-
-    if (BOOST_UNLIKELY(!::GetFileAttributesExW(p.c_str(), ::GetFileExInfoStandard, &fad)))
+    // The target name is either relative to the target directory or, if there is no target directory, a full path
+    path target(new_p);
+    const bool is_absolute_target = target.has_root_path();
+    if (is_absolute_target)
     {
-        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::file_size");
-        return static_cast< uintmax_t >(-1);
+        target = detail::absolute(target, path(), ec);
+        if (ec && *ec)
+            return;
     }
+    target.make_preferred();
 
-    if (BOOST_UNLIKELY((fad.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0))
-    {
-        emit_error(ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::file_size");
-        return static_cast< uintmax_t >(-1);
-    }
+    const std::size_t name_size = target.native().size() * sizeof(wchar_t);
+    std::vector< unsigned char > buf(offsetof(detail::file_rename_info, FileName) + name_size + sizeof(wchar_t));
+    detail::file_rename_info* info = reinterpret_cast< detail::file_rename_info* >(&buf[0]);
+    info->Flags = 0u;
+    info->ReplaceIfExists = true;
+    info->RootDirectory = is_absolute_target ? NULL : new_dir.m_handle;
+    info->FileNameLength = static_cast< DWORD >(name_size);
+    std::memcpy(info->FileName, target.c_str(), name_size + sizeof(wchar_t));
 
-    return (static_cast< uintmax_t >(fad.nFileSizeHigh)
-            << (sizeof(fad.nFileSizeLow) * 8u)) |
-        fad.nFileSizeLow;
+    if (BOOST_UNLIKELY(!set_file_information_by_handle(h.handle, detail::file_rename_info_class, info, static_cast< DWORD >(buf.size()))))
+        emit_error(::GetLastError(), old_p, new_p, ec, "boost::filesystem::directory_handle::rename");
+#else
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, old_p, new_p, ec, "boost::filesystem::directory_handle::rename");
+#endif
 
 #endif // defined(BOOST_POSIX_API)
 }
 
 BOOST_FILESYSTEM_DECL
-uintmax_t hard_link_count(path const& p, system::error_code* ec)
+file_identity directory_handle::identity_impl(path const* p, system::error_code* ec) const
 {
     if (ec)
         ec->clear();
 
+    file_identity id;
+
 #if defined(BOOST_POSIX_API)
 
-#if defined(BOOST_FILESYSTEM_USE_STATX)
-    struct ::statx path_stat;
-    if (BOOST_UNLIKELY(invoke_statx(AT_FDCWD, p.c_str(), AT_NO_AUTOMOUNT, STATX_NLINK, &path_stat) < 0))
+    int err;
+    if (p == NULL)
     {
-        emit_error(errno, p, ec, "boost::filesystem::hard_link_count");
-        return static_cast< uintmax_t >(-1);
+        err = detail::get_fd_identity(m_handle, id);
     }
-
-    if (BOOST_UNLIKELY((path_stat.stx_mask & STATX_NLINK) != STATX_NLINK))
+    else
     {
-        emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::hard_link_count");
-        return static_cast< uintmax_t >(-1);
-    }
-
-    return static_cast< uintmax_t >(path_stat.stx_nlink);
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) || defined(BOOST_FILESYSTEM_USE_STATX)
+        err = detail::get_file_identity(m_handle, p->c_str(), id);
 #else
-    struct ::stat path_stat;
-    if (BOOST_UNLIKELY(::stat(p.c_str(), &path_stat) < 0))
-    {
-        emit_error(errno, p, ec, "boost::filesystem::hard_link_count");
-        return static_cast< uintmax_t >(-1);
-    }
-
-    return static_cast< uintmax_t >(path_stat.st_nlink);
+        if (BOOST_UNLIKELY(!p->has_root_directory()))
+            err = BOOST_ERROR_NOT_SUPPORTED;
+        else
+            err = detail::get_file_identity(-1, p->c_str(), id);
 #endif
+    }
 
 #else // defined(BOOST_POSIX_API)
 
-    handle_wrapper h(create_file_handle(
-        p.c_str(),
-        FILE_READ_ATTRIBUTES,
-        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
-        NULL,
-        OPEN_EXISTING,
-        FILE_FLAG_BACKUP_SEMANTICS));
-
-    if (BOOST_UNLIKELY(h.handle == INVALID_HANDLE_VALUE))
+    DWORD err;
+    if (p == NULL)
     {
-    fail_errno:
-        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::hard_link_count");
-        return static_cast< uintmax_t >(-1);
+        err = detail::get_handle_identity(m_handle, id);
     }
+    else
+    {
+        detail::handle_wrapper h;
+        if (p->has_root_path())
+        {
+            h.handle = detail::create_file_handle(
+                *p,
+                FILE_READ_ATTRIBUTES,
+                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                NULL, // lpSecurityAttributes
+                OPEN_EXISTING,
+                FILE_FLAG_BACKUP_SEMANTICS);
+            err = h.handle != INVALID_HANDLE_VALUE ? 0u : ::GetLastError();
+        }
+        else
+        {
+#if !defined(UNDER_CE)
+            err = detail::open_file_at(h, m_handle, *p, FILE_READ_ATTRIBUTES, FILE_OPEN, 0u);
+#else
+            err = BOOST_ERROR_NOT_SUPPORTED;
+#endif
+        }
 
-    // Link count info is only available through GetFileInformationByHandle
-    BY_HANDLE_FILE_INFORMATION info;
-    if (BOOST_UNLIKELY(!::GetFileInformationByHandle(h.handle, &info)))
-        goto fail_errno;
-
-    return static_cast< uintmax_t >(info.nNumberOfLinks);
+        if (BOOST_LIKELY(err == 0u))
+            err = detail::get_handle_identity(h.handle, id);
+    }
 
 #endif // defined(BOOST_POSIX_API)
-}
 
-BOOST_FILESYSTEM_DECL
-path initial_path(error_code* ec)
-{
-    static path init_path;
-    if (init_path.empty())
-        init_path = current_path(ec);
-    else if (ec)
-        ec->clear();
-    return init_path;
+    if (BOOST_UNLIKELY(err != 0))
+    {
+        if (p != NULL)
+            emit_error(err, *p, ec, "boost::filesystem::directory_handle::identity");
+        else
+            emit_error(err, ec, "boost::filesystem::directory_handle::identity");
+        return file_identity();
+    }
+
+    return id;
 }
 
 BOOST_FILESYSTEM_DECL
-bool is_empty(path const& p, system::error_code* ec)
+path directory_handle::read_symlink_impl(path const& p, system::error_code* ec) const
 {
     if (ec)
         ec->clear();
 
+    path target;
+    detail::read_symlink_buffer buf;
+
 #if defined(BOOST_POSIX_API)
 
-#if defined(BOOST_FILESYSTEM_USE_STATX)
-    struct ::statx path_stat;
-    if (BOOST_UNLIKELY(invoke_statx(AT_FDCWD, p.c_str(), AT_NO_AUTOMOUNT, STATX_TYPE | STATX_SIZE, &path_stat) < 0))
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    err_t err = detail::read_symlink_impl(p, target, buf, m_handle);
+#else
+    err_t err;
+    if (BOOST_UNLIKELY(!p.has_root_directory()))
+        err = BOOST_ERROR_NOT_SUPPORTED;
+    else
+        err = detail::read_symlink_impl(p, target, buf);
+#endif
+
+#else // defined(BOOST_POSIX_API)
+
+    err_t err;
+    if (p.has_root_path())
     {
-        emit_error(errno, p, ec, "boost::filesystem::is_empty");
-        return false;
+        err = detail::read_symlink_impl(p, target, buf);
+    }
+    else
+    {
+#if !defined(UNDER_CE)
+        detail::handle_wrapper h;
+        err = detail::open_file_at(h, m_handle, p, FILE_READ_ATTRIBUTES, FILE_OPEN, FILE_OPEN_REPARSE_POINT);
+        if (BOOST_LIKELY(err == 0u))
+            err = detail::read_symlink_impl(h.handle, target, buf);
+#else
+        err = BOOST_ERROR_NOT_SUPPORTED;
+#endif
     }
 
-    if (BOOST_UNLIKELY((path_stat.stx_mask & STATX_TYPE) != STATX_TYPE))
+#endif // defined(BOOST_POSIX_API)
+
+    if (BOOST_UNLIKELY(err != 0))
     {
-    fail_unsupported:
-        emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::is_empty");
-        return false;
+        emit_error(err, p, ec, "boost::filesystem::directory_handle::read_symlink");
+        target.clear();
     }
 
-    if (S_ISDIR(get_mode(path_stat)))
-        return is_empty_directory(p, ec);
+    return target;
+}
 
-    if (BOOST_UNLIKELY((path_stat.stx_mask & STATX_SIZE) != STATX_SIZE))
-        goto fail_unsupported;
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                           class volume_handle implementation                         //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
 
-    return get_size(path_stat) == 0u;
+namespace detail {
+namespace {
+
+//! Returns the current time of a monotonic clock, in milliseconds
+inline boost::uint64_t get_current_time_ms() BOOST_NOEXCEPT
+{
+#if !defined(BOOST_NO_CXX11_HDR_CHRONO)
+    return static_cast< boost::uint64_t >(std::chrono::duration_cast< std::chrono::milliseconds >(std::chrono::steady_clock::now().time_since_epoch()).count());
 #else
-    struct ::stat path_stat;
-    if (BOOST_UNLIKELY(::stat(p.c_str(), &path_stat) < 0))
-    {
-        emit_error(errno, p, ec, "boost::filesystem::is_empty");
-        return false;
-    }
+    return static_cast< boost::uint64_t >(std::time(NULL)) * 1000u;
+#endif
+}
+
+#if defined(BOOST_POSIX_API) && !defined(BOOST_FILESYSTEM_USE_WASI)
+
+//! Obtains the space on the volume of the open file \a fd, returns the error code
+inline int get_volume_space(int fd, space_info& info) BOOST_NOEXCEPT
+{
+    struct BOOST_STATVFS vfs;
+    if (BOOST_UNLIKELY(::BOOST_FSTATVFS(fd, &vfs) < 0))
+        return errno;
+
+    set_space_info(vfs, info);
+    return 0;
+}
 
-    return S_ISDIR(get_mode(path_stat)) ? is_empty_directory(p, ec) : get_size(path_stat) == 0u;
 #endif
 
-#else // defined(BOOST_POSIX_API)
+} // unnamed namespace
+} // namespace detail
 
-    WIN32_FILE_ATTRIBUTE_DATA fad;
-    if (BOOST_UNLIKELY(!::GetFileAttributesExW(p.c_str(), ::GetFileExInfoStandard, &fad)))
+struct volume_handle::state
+{
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+    //! Serializes refreshing the cached result, which coalesces concurrent queries
+    std::mutex mutex;
+#endif
+    //! Cached result of space()
+    space_info info;
+    //! Time when the cached result was obtained
+    boost::uint64_t timestamp;
+    //! Indicates that the cached result is valid
+    bool valid;
+#if defined(BOOST_WINDOWS_API)
+    //! Directory to pass to GetDiskFreeSpaceExW
+    std::wstring dir;
+#endif
+
+    state() BOOST_NOEXCEPT : timestamp(0u), valid(false) {}
+};
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+#define BOOST_FILESYSTEM_VOLUME_HANDLE_LOCK(s) std::lock_guard< std::mutex > lock((s).mutex)
+#else
+#define BOOST_FILESYSTEM_VOLUME_HANDLE_LOCK(s) (void)0
+#endif
+
+BOOST_FILESYSTEM_DECL
+void volume_handle::close() BOOST_NOEXCEPT
+{
+    if (m_handle != invalid_native_handle())
     {
-        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::is_empty");
-        return false;
+#if defined(BOOST_POSIX_API)
+        detail::close_fd(m_handle);
+#else
+        ::CloseHandle(m_handle);
+#endif
+        m_handle = invalid_native_handle();
     }
 
-    return (fad.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? is_empty_directory(p, ec) : (!fad.nFileSizeHigh && !fad.nFileSizeLow);
-
-#endif // defined(BOOST_POSIX_API)
+    delete m_state;
+    m_state = NULL;
+    m_max_staleness_ms = 0u;
 }
 
 BOOST_FILESYSTEM_DECL
-std::time_t creation_time(path const& p, system::error_code* ec)
+void volume_handle::open_impl(path const& p, unsigned int max_staleness_ms, system::error_code* ec)
 {
     if (ec)
         ec->clear();
 
+    close();
+
+#if defined(BOOST_FILESYSTEM_USE_WASI)
+
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::volume_handle::open");
+
+#else // defined(BOOST_FILESYSTEM_USE_WASI)
+
 #if defined(BOOST_POSIX_API)
 
-#if defined(BOOST_FILESYSTEM_USE_STATX)
-    struct ::statx stx;
-    if (BOOST_UNLIKELY(invoke_statx(AT_FDCWD, p.c_str(), AT_NO_AUTOMOUNT, STATX_BTIME, &stx) < 0))
-    {
-        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::creation_time");
-        return (std::numeric_limits< std::time_t >::min)();
-    }
-    if (BOOST_UNLIKELY((stx.stx_mask & STATX_BTIME) != STATX_BTIME))
+    // The file is only opened to query the filesystem, so don't block on FIFOs and don't acquire a controlling terminal
+    detail::fd_wrapper fd(::open(p.c_str(), O_RDONLY | O_NONBLOCK | O_NOCTTY | O_CLOEXEC));
+#if defined(O_PATH)
+    // Files without read permission can still be opened for fstatfs with O_PATH (since Linux 3.12)
+    if (fd.fd < 0 && errno == EACCES)
+        fd.fd = ::open(p.c_str(), O_PATH | O_CLOEXEC);
+#endif
+    if (BOOST_UNLIKELY(fd.fd < 0))
     {
-        emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::creation_time");
-        return (std::numeric_limits< std::time_t >::min)();
+        emit_error(errno, p, ec, "boost::filesystem::volume_handle::open");
+        return;
     }
-    return stx.stx_btime.tv_sec;
-#elif defined(BOOST_FILESYSTEM_STAT_ST_BIRTHTIME) && defined(BOOST_FILESYSTEM_STAT_ST_BIRTHTIMENSEC)
-    struct ::stat st;
-    if (BOOST_UNLIKELY(::stat(p.c_str(), &st) < 0))
+
+#if defined(BOOST_FILESYSTEM_NO_O_CLOEXEC) && defined(FD_CLOEXEC)
+    if (BOOST_UNLIKELY(::fcntl(fd.fd, F_SETFD, FD_CLOEXEC) < 0))
     {
-        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::creation_time");
-        return (std::numeric_limits< std::time_t >::min)();
+        emit_error(errno, p, ec, "boost::filesystem::volume_handle::open");
+        return;
     }
-    return st.BOOST_FILESYSTEM_STAT_ST_BIRTHTIME;
-#else
-    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::creation_time");
-    return (std::numeric_limits< std::time_t >::min)();
 #endif
 
 #else // defined(BOOST_POSIX_API)
 
-    handle_wrapper hw(create_file_handle(
-        p.c_str(),
+    std::wstring dir;
+    try
+    {
+        if (!detail::get_disk_free_space_directory(p, dir, "boost::filesystem::volume_handle::open", ec))
+            return;
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return;
+    }
+
+    // Keep the directory open, so that it cannot be removed while the handle is open
+    detail::handle_wrapper h(detail::create_file_handle(
+        dir.c_str(),
         FILE_READ_ATTRIBUTES,
-        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
-        NULL,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL, // lpSecurityAttributes
         OPEN_EXISTING,
         FILE_FLAG_BACKUP_SEMANTICS));
 
-    if (BOOST_UNLIKELY(hw.handle == INVALID_HANDLE_VALUE))
+    if (BOOST_UNLIKELY(h.handle == INVALID_HANDLE_VALUE))
     {
-    fail:
-        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::creation_time");
-        return (std::numeric_limits< std::time_t >::min)();
+        emit_error(::GetLastError(), p, ec, "boost::filesystem::volume_handle::open");
+        return;
     }
 
-    FILETIME ct;
+#endif // defined(BOOST_POSIX_API)
 
-    if (BOOST_UNLIKELY(!::GetFileTime(hw.handle, &ct, NULL, NULL)))
-        goto fail;
+    state* st = new (std::nothrow) state();
+    if (BOOST_UNLIKELY(!st))
+    {
+        if (!ec)
+            throw std::bad_alloc();
 
-    return to_time_t(ct);
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return;
+    }
 
-#endif // defined(BOOST_POSIX_API)
+#if defined(BOOST_POSIX_API)
+    m_handle = fd.fd;
+    fd.fd = -1;
+#else
+    st->dir.swap(dir);
+    m_handle = h.handle;
+    h.handle = INVALID_HANDLE_VALUE;
+#endif
+
+    m_state = st;
+    m_max_staleness_ms = max_staleness_ms;
+
+#endif // defined(BOOST_FILESYSTEM_USE_WASI)
 }
 
 BOOST_FILESYSTEM_DECL
-std::time_t last_write_time(path const& p, system::error_code* ec)
+space_info volume_handle::space_impl(system::error_code* ec) const
 {
     if (ec)
         ec->clear();
 
-#if defined(BOOST_POSIX_API)
+    space_info info;
+    // Initialize members to -1, as in boost::filesystem::space
+    info.capacity = static_cast< uintmax_t >(-1);
+    info.free = static_cast< uintmax_t >(-1);
+    info.available = static_cast< uintmax_t >(-1);
 
-#if defined(BOOST_FILESYSTEM_USE_STATX)
-    struct ::statx stx;
-    if (BOOST_UNLIKELY(invoke_statx(AT_FDCWD, p.c_str(), AT_NO_AUTOMOUNT, STATX_MTIME, &stx) < 0))
+    if (BOOST_UNLIKELY(!is_open()))
     {
-        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::last_write_time");
-        return (std::numeric_limits< std::time_t >::min)();
+#if defined(BOOST_POSIX_API)
+        emit_error(EBADF, ec, "boost::filesystem::volume_handle::space");
+#else
+        emit_error(ERROR_INVALID_HANDLE, ec, "boost::filesystem::volume_handle::space");
+#endif
+        return info;
     }
-    if (BOOST_UNLIKELY((stx.stx_mask & STATX_MTIME) != STATX_MTIME))
+
+#if !defined(BOOST_FILESYSTEM_USE_WASI)
+
+    state& st = *m_state;
+    if (m_max_staleness_ms == 0u)
     {
-        emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::last_write_time");
-        return (std::numeric_limits< std::time_t >::min)();
+#if defined(BOOST_POSIX_API)
+        const int err = detail::get_volume_space(m_handle, info);
+#else
+        const DWORD err = detail::get_disk_free_space(st.dir.c_str(), info);
+#endif
+        if (BOOST_UNLIKELY(err != 0))
+            emit_error(err, ec, "boost::filesystem::volume_handle::space");
+        return info;
     }
-    return stx.stx_mtime.tv_sec;
+
+    // Threads that find the cached result stale wait for the thread that is already refreshing it, and then use its result
+    BOOST_FILESYSTEM_VOLUME_HANDLE_LOCK(st);
+    if (st.valid && (detail::get_current_time_ms() - st.timestamp) < m_max_staleness_ms)
+        return st.info;
+
+#if defined(BOOST_POSIX_API)
+    const int err = detail::get_volume_space(m_handle, st.info);
 #else
-    struct ::stat st;
-    if (BOOST_UNLIKELY(::stat(p.c_str(), &st) < 0))
+    const DWORD err = detail::get_disk_free_space(st.dir.c_str(), st.info);
+#endif
+    if (BOOST_UNLIKELY(err != 0))
     {
-        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::last_write_time");
-        return (std::numeric_limits< std::time_t >::min)();
+        st.valid = false;
+        emit_error(err, ec, "boost::filesystem::volume_handle::space");
+        return info;
     }
-    return st.st_mtime;
-#endif
 
-#else // defined(BOOST_POSIX_API)
+    st.timestamp = detail::get_current_time_ms();
+    st.valid = true;
+    info = st.info;
 
-    handle_wrapper hw(create_file_handle(
-        p.c_str(),
-        FILE_READ_ATTRIBUTES,
-        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
-        NULL,
-        OPEN_EXISTING,
-        FILE_FLAG_BACKUP_SEMANTICS));
+#endif // !defined(BOOST_FILESYSTEM_USE_WASI)
 
-    if (BOOST_UNLIKELY(hw.handle == INVALID_HANDLE_VALUE))
+    return info;
+}
+
+BOOST_FILESYSTEM_DECL
+void volume_handle::invalidate() const BOOST_NOEXCEPT
+{
+    if (m_state)
     {
-    fail:
-        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::last_write_time");
-        return (std::numeric_limits< std::time_t >::min)();
+        BOOST_FILESYSTEM_VOLUME_HANDLE_LOCK(*m_state);
+        m_state->valid = false;
     }
+}
 
-    FILETIME lwt;
+#undef BOOST_FILESYSTEM_VOLUME_HANDLE_LOCK
 
-    if (BOOST_UNLIKELY(!::GetFileTime(hw.handle, NULL, NULL, &lwt)))
-        goto fail;
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                            class unique_file implementation                          //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
 
-    return to_time_t(lwt);
+#if defined(BOOST_POSIX_API) && defined(O_TMPFILE) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+#define BOOST_FILESYSTEM_HAS_O_TMPFILE
+#endif
 
-#endif // defined(BOOST_POSIX_API)
+namespace detail {
+namespace {
+
+//! Maximum number of attempts to create a file or directory with a name generated from a model. Models with few placeholders may collide often.
+BOOST_CONSTEXPR_OR_CONST unsigned int max_unique_name_attempts = 128u;
+
+//! Returns \c true if the model contains placeholders, which means a different name can be generated on a collision
+inline bool has_unique_name_placeholders(path const& model)
+{
+    return model.native().find(static_cast< path::value_type >('%')) != path::string_type::npos;
 }
 
+} // unnamed namespace
+
 BOOST_FILESYSTEM_DECL
-void last_write_time(path const& p, const std::time_t new_time, system::error_code* ec)
+path create_unique_directory(path const& model, system::error_code* ec)
 {
     if (ec)
         ec->clear();
 
+    const bool can_retry = has_unique_name_placeholders(model);
+    for (unsigned int attempt = 0u;; ++attempt)
+    {
+        path p(detail::unique_path(model, ec));
+        if (ec && *ec)
+            return path();
+
 #if defined(BOOST_POSIX_API)
+        if (BOOST_LIKELY(::mkdir(p.c_str(), S_IRWXU) == 0))
+            return p;
 
-#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+        const int err = errno;
+        if (err != EEXIST || !can_retry || attempt >= max_unique_name_attempts)
+#else
+        if (BOOST_LIKELY(::CreateDirectoryW(p.c_str(), NULL)))
+            return p;
 
-    struct timespec times[2] = {};
+        const DWORD err = ::GetLastError();
+        if ((err != ERROR_ALREADY_EXISTS && err != ERROR_FILE_EXISTS) || !can_retry || attempt >= max_unique_name_attempts)
+#endif
+        {
+            emit_error(err, p, ec, "boost::filesystem::create_unique_directory");
+            return path();
+        }
+    }
+}
 
-    // Keep the last access time unchanged
-    times[0].tv_nsec = UTIME_OMIT;
+} // namespace detail
 
-    times[1].tv_sec = new_time;
+BOOST_FILESYSTEM_DECL
+void unique_file::close() BOOST_NOEXCEPT
+{
+    if (m_handle != invalid_native_handle())
+    {
+#if defined(BOOST_POSIX_API)
+        // Remove the file before closing so that the name cannot be reused by someone else in between
+        if (m_remove_on_close && !m_path.empty())
+            ::unlink(m_path.c_str());
+        detail::close_fd(m_handle);
+#else
+        ::CloseHandle(m_handle);
+        if (m_remove_on_close && !m_path.empty())
+            ::DeleteFileW(m_path.c_str());
+#endif
+        m_handle = invalid_native_handle();
+    }
 
-    if (BOOST_UNLIKELY(::utimensat(AT_FDCWD, p.c_str(), times, 0) != 0))
+    m_path.clear();
+    m_remove_on_close = false;
+}
+
+BOOST_FILESYSTEM_DECL
+void unique_file::create_impl(filesystem::path const& model, unsigned int flags, system::error_code* ec)
+{
+    close();
+
+    if (ec)
+        ec->clear();
+
+    const bool anonymous = (flags & static_cast< unsigned int >(unique_file_flags::anonymous)) != 0u;
+    const bool remove_on_close = anonymous || (flags & static_cast< unsigned int >(unique_file_flags::remove_on_close)) != 0u;
+
+#if defined(BOOST_FILESYSTEM_HAS_O_TMPFILE)
+    if (anonymous)
     {
-        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::last_write_time");
-        return;
+        const filesystem::path dir(model.parent_path());
+        const int fd = ::open(dir.empty() ? "." : dir.c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC, S_IRUSR | S_IWUSR);
+        if (BOOST_LIKELY(fd >= 0))
+        {
+            m_handle = fd;
+            m_remove_on_close = true;
+            return;
+        }
+
+        // Older kernels and some filesystems do not support O_TMPFILE, fall back to a named file
+        const int err = errno;
+        if (err != EOPNOTSUPP && err != EISDIR && err != EINVAL)
+        {
+            emit_error(err, model, ec, "boost::filesystem::unique_file::create");
+            return;
+        }
     }
+#endif // defined(BOOST_FILESYSTEM_HAS_O_TMPFILE)
 
-#else // defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    const bool can_retry = detail::has_unique_name_placeholders(model);
+    filesystem::path p;
+    for (unsigned int attempt = 0u;; ++attempt)
+    {
+        p = detail::unique_path(model, ec);
+        if (ec && *ec)
+            return;
 
-    struct ::stat st;
-    if (BOOST_UNLIKELY(::stat(p.c_str(), &st) < 0))
+#if defined(BOOST_POSIX_API)
+        const int fd = ::open(p.c_str(), O_RDWR | O_CREAT | O_EXCL | O_NOCTTY | O_CLOEXEC, S_IRUSR | S_IWUSR);
+        if (BOOST_LIKELY(fd >= 0))
+        {
+            m_handle = fd;
+            break;
+        }
+
+        const int err = errno;
+        if (err != EEXIST || !can_retry || attempt >= detail::max_unique_name_attempts)
+#else
+        const HANDLE h = detail::create_file_handle(
+            p,
+            GENERIC_READ | GENERIC_WRITE,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL, // lpSecurityAttributes
+            CREATE_NEW,
+            remove_on_close ? FILE_ATTRIBUTE_TEMPORARY : FILE_ATTRIBUTE_NORMAL);
+        if (BOOST_LIKELY(h != INVALID_HANDLE_VALUE))
+        {
+            m_handle = h;
+            break;
+        }
+
+        const DWORD err = ::GetLastError();
+        if ((err != ERROR_FILE_EXISTS && err != ERROR_ALREADY_EXISTS) || !can_retry || attempt >= detail::max_unique_name_attempts)
+#endif
+        {
+            emit_error(err, p, ec, "boost::filesystem::unique_file::create");
+            return;
+        }
+    }
+
+    m_path.swap(p);
+    m_remove_on_close = remove_on_close;
+}
+
+BOOST_FILESYSTEM_DECL
+void unique_file::link_impl(filesystem::path const& p, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    if (BOOST_UNLIKELY(!is_open()))
     {
-        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::last_write_time");
+#if defined(BOOST_POSIX_API)
+        emit_error(EBADF, p, ec, "boost::filesystem::unique_file::link");
+#else
+        emit_error(ERROR_INVALID_HANDLE, p, ec, "boost::filesystem::unique_file::link");
+#endif
         return;
     }
 
-    ::utimbuf buf;
-    buf.actime = st.st_atime; // utime() updates access time too :-(
-    buf.modtime = new_time;
-    if (BOOST_UNLIKELY(::utime(p.c_str(), &buf) < 0))
-        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::last_write_time");
+    // Copy the path before linking, so that the object state can be updated without failure after the link is created
+    filesystem::path new_path(p);
 
-#endif // defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+#if defined(BOOST_POSIX_API)
 
-#else // defined(BOOST_POSIX_API)
+    if (m_path.empty())
+    {
+#if defined(BOOST_FILESYSTEM_HAS_O_TMPFILE)
+        // Linking an O_TMPFILE file with AT_EMPTY_PATH requires CAP_DAC_READ_SEARCH, so use procfs first, as recommended by open(2)
+        char proc_path[32];
+        std::sprintf(proc_path, "/proc/self/fd/%d", m_handle);
+        int res = ::linkat(AT_FDCWD, proc_path, AT_FDCWD, p.c_str(), AT_SYMLINK_FOLLOW);
+#if defined(AT_EMPTY_PATH)
+        if (res < 0 && errno == ENOENT)
+            res = ::linkat(m_handle, "", AT_FDCWD, p.c_str(), AT_EMPTY_PATH);
+#endif
+        if (BOOST_UNLIKELY(res < 0))
+        {
+            emit_error(errno, p, ec, "boost::filesystem::unique_file::link");
+            return;
+        }
+#else
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::unique_file::link");
+        return;
+#endif
+    }
+    else
+    {
+        if (BOOST_UNLIKELY(::link(m_path.c_str(), p.c_str()) < 0))
+        {
+            emit_error(errno, m_path, p, ec, "boost::filesystem::unique_file::link");
+            return;
+        }
 
-    handle_wrapper hw(create_file_handle(
-        p.c_str(),
-        FILE_WRITE_ATTRIBUTES,
-        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
-        NULL,
-        OPEN_EXISTING,
-        FILE_FLAG_BACKUP_SEMANTICS));
+        ::unlink(m_path.c_str());
+    }
 
-    if (BOOST_UNLIKELY(hw.handle == INVALID_HANDLE_VALUE))
+#else // defined(BOOST_POSIX_API)
+
+    detail::CreateHardLinkW_t* chl_api = filesystem::detail::atomic_load_relaxed(detail::create_hard_link_api);
+    if (BOOST_UNLIKELY(!chl_api))
     {
-    fail:
-        emit_error(BOOST_ERRNO, p, ec, "boost::filesystem::last_write_time");
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, m_path, p, ec, "boost::filesystem::unique_file::link");
         return;
     }
 
-    FILETIME lwt;
-    to_FILETIME(new_time, lwt);
+    if (BOOST_UNLIKELY(!chl_api(p.c_str(), m_path.c_str(), NULL)))
+    {
+        emit_error(::GetLastError(), m_path, p, ec, "boost::filesystem::unique_file::link");
+        return;
+    }
 
-    if (BOOST_UNLIKELY(!::SetFileTime(hw.handle, NULL, NULL, &lwt)))
-        goto fail;
+    ::DeleteFileW(m_path.c_str());
 
 #endif // defined(BOOST_POSIX_API)
-}
 
-#ifdef BOOST_POSIX_API
-const perms active_bits(all_all | set_uid_on_exe | set_gid_on_exe | sticky_bit);
-inline mode_t mode_cast(perms prms)
-{
-    return prms & active_bits;
+    m_path.swap(new_path);
+    m_remove_on_close = false;
 }
-#endif
+
+namespace detail {
 
 BOOST_FILESYSTEM_DECL
-void permissions(path const& p, perms prms, system::error_code* ec)
+void directory_iterator_construct_at(directory_iterator& it, directory_handle const& dir, path const& p, unsigned int opts, system::error_code* ec)
 {
-    BOOST_ASSERT_MSG(!((prms & add_perms) && (prms & remove_perms)), "add_perms and remove_perms are mutually exclusive");
+#if defined(BOOST_POSIX_API)
 
-    if ((prms & add_perms) && (prms & remove_perms)) // precondition failed
-        return;
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW)
+    directory_iterator_params params;
+    params.basedir_fd = dir.native_handle();
+    params.open_path = NULL;
+    params.iterator_fd = -1;
+    directory_iterator_construct(it, p, opts, &params, ec);
+#else
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::directory_iterator::construct");
+#endif
 
-#if defined(BOOST_FILESYSTEM_USE_WASI)
-    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::permissions");
-#elif defined(BOOST_POSIX_API)
-    error_code local_ec;
-    file_status current_status((prms & symlink_perms) ? detail::symlink_status_impl(p, &local_ec) : detail::status_impl(p, &local_ec));
-    if (local_ec)
+#else // defined(BOOST_POSIX_API)
+
+    if (p.has_root_path())
     {
-        if (!ec)
-            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::permissions", p, local_ec));
+        directory_iterator_construct(it, p, opts, NULL, ec);
+        return;
+    }
 
-        *ec = local_ec;
+#if !defined(UNDER_CE)
+    if (BOOST_UNLIKELY(p.empty()))
+    {
+        emit_error(ERROR_PATH_NOT_FOUND, p, ec, "boost::filesystem::directory_iterator::construct");
         return;
     }
 
-    if (prms & add_perms)
-        prms |= current_status.permissions();
-    else if (prms & remove_perms)
-        prms = current_status.permissions() & ~prms;
+    ULONG create_options = FILE_DIRECTORY_FILE;
+    if ((opts & static_cast< unsigned int >(directory_options::_detail_no_follow)) != 0u)
+        create_options |= FILE_OPEN_REPARSE_POINT;
 
-    // OS X <10.10, iOS <8.0 and some other platforms don't support fchmodat().
-    // Solaris (SunPro and gcc) only support fchmodat() on Solaris 11 and higher,
-    // and a runtime check is too much trouble.
-    // Linux does not support permissions on symbolic links and has no plans to
-    // support them in the future.  The chmod() code is thus more practical,
-    // rather than always hitting ENOTSUP when sending in AT_SYMLINK_NO_FOLLOW.
-    //  - See the 3rd paragraph of
-    // "Symbolic link ownership, permissions, and timestamps" at:
-    //   "http://man7.org/linux/man-pages/man7/symlink.7.html"
-    //  - See the fchmodat() Linux man page:
-    //   "http://man7.org/linux/man-pages/man2/fchmodat.2.html"
-#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) && \
-    !(defined(__SUNPRO_CC) || defined(__sun) || defined(sun)) && \
-    !(defined(linux) || defined(__linux) || defined(__linux__)) && \
-    !(defined(__MAC_OS_X_VERSION_MIN_REQUIRED) && __MAC_OS_X_VERSION_MIN_REQUIRED < 101000) && \
-    !(defined(__IPHONE_OS_VERSION_MIN_REQUIRED) && __IPHONE_OS_VERSION_MIN_REQUIRED < 80000) && \
-    !(defined(__rtems__)) && \
-    !(defined(__QNX__) && (_NTO_VERSION <= 700))
-    if (::fchmodat(AT_FDCWD, p.c_str(), mode_cast(prms), !(prms & symlink_perms) ? 0 : AT_SYMLINK_NOFOLLOW))
-#else // fallback if fchmodat() not supported
-    if (::chmod(p.c_str(), mode_cast(prms)))
-#endif
+    handle_wrapper h;
+    const DWORD err = open_file_at(h, dir.native_handle(), p, FILE_LIST_DIRECTORY, FILE_OPEN, create_options);
+    if (BOOST_UNLIKELY(err != 0u))
     {
-        const int err = errno;
-        if (!ec)
+        if (err == ERROR_ACCESS_DENIED && (opts & static_cast< unsigned int >(directory_options::skip_permission_denied)) != 0u)
         {
-            BOOST_FILESYSTEM_THROW(filesystem_error(
-                "boost::filesystem::permissions", p, error_code(err, system::generic_category())));
+            if (ec)
+                ec->clear();
+            return;
         }
 
-        ec->assign(err, system::generic_category());
+        emit_error(err, p, ec, "boost::filesystem::directory_iterator::construct");
+        return;
     }
 
-#else // Windows
-
-    // if not going to alter FILE_ATTRIBUTE_READONLY, just return
-    if (!(!((prms & (add_perms | remove_perms))) || (prms & (owner_write | group_write | others_write))))
-        return;
+    directory_iterator_params params;
+    params.use_handle = h.handle;
+    params.close_handle = true;
+    h.handle = INVALID_HANDLE_VALUE;
+    directory_iterator_construct(it, p, opts, &params, ec);
+#else
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::directory_iterator::construct");
+#endif
 
-    DWORD attr = ::GetFileAttributesW(p.c_str());
+#endif // defined(BOOST_POSIX_API)
+}
 
-    if (error(attr == 0 ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::permissions"))
-        return;
+} // namespace detail
 
-    if (prms & add_perms)
-        attr &= ~FILE_ATTRIBUTE_READONLY;
-    else if (prms & remove_perms)
-        attr |= FILE_ATTRIBUTE_READONLY;
-    else if (prms & (owner_write | group_write | others_write))
-        attr &= ~FILE_ATTRIBUTE_READONLY;
-    else
-        attr |= FILE_ATTRIBUTE_READONLY;
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                        directory_entry cached attributes                             //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
 
-    error(::SetFileAttributesW(p.c_str(), attr) == 0 ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::permissions");
-#endif
+BOOST_FILESYSTEM_DECL
+void directory_entry::refresh_impl(system::error_code* ec) const
+{
+    refresh_impl(static_cast< unsigned int >(status_consistency::system_default), ec);
 }
 
 BOOST_FILESYSTEM_DECL
-path read_symlink(path const& p, system::error_code* ec)
+void directory_entry::refresh_impl(unsigned int consistency, system::error_code* ec) const
 {
     if (ec)
         ec->clear();
 
-    path symlink_path;
+    m_status = file_status();
+    m_symlink_status = file_status();
+    m_cached_attrs = 0u;
 
-#ifdef BOOST_POSIX_API
-    const char* const path_str = p.c_str();
-    char small_buf[small_path_size];
-    ssize_t result = ::readlink(path_str, small_buf, sizeof(small_buf));
-    if (BOOST_UNLIKELY(result < 0))
-    {
-    fail:
-        const int err = errno;
-        if (!ec)
-            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::read_symlink", p, error_code(err, system_category())));
+#if defined(BOOST_POSIX_API)
 
-        ec->assign(err, system_category());
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) || defined(BOOST_FILESYSTEM_USE_STATX)
+    int basedir_fd = AT_FDCWD;
+#else
+    int basedir_fd = -1;
+#endif
+    const char* p = m_path.c_str();
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    if (m_basedir_fd >= 0)
+    {
+        // The entry is owned by a directory iterator, and its path is the path of the iterated directory followed by the filename.
+        // Query the file relative to the open directory to avoid resolving the whole path again.
+        path::string_type const& native = m_path.native();
+        const path::string_type::size_type pos = native.rfind(path::separator);
+        if (pos != path::string_type::npos)
+        {
+            basedir_fd = m_basedir_fd;
+            p += pos + 1u;
+        }
     }
-    else if (BOOST_LIKELY(static_cast< std::size_t >(result) < sizeof(small_buf)))
+#endif
+
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    const int sync_flags = detail::get_statx_sync_flags(consistency);
+#else
+    const int sync_flags = 0;
+    (void)consistency;
+#endif
+
+    detail::entry_stat_t st;
+    int err = detail::entry_stat(basedir_fd, p, false, sync_flags, st);
+    if (BOOST_UNLIKELY(err != 0))
     {
-        symlink_path.assign(small_buf, small_buf + result);
+        if (!detail::not_found_error(err))
+            goto fail;
+
+        m_symlink_status = m_status = file_status(file_not_found, no_perms);
+        return;
     }
-    else
+
+    m_symlink_status = detail::make_file_status(detail::get_mode(st));
+    if (m_symlink_status.type() == symlink_file)
     {
-        for (std::size_t path_max = sizeof(small_buf) * 2u;; path_max *= 2u) // loop 'til buffer large enough
+        err = detail::entry_stat(basedir_fd, p, true, sync_flags, st);
+        if (BOOST_UNLIKELY(err != 0))
         {
-            if (BOOST_UNLIKELY(path_max > absolute_path_max))
+            if (detail::not_found_error(err))
             {
-                if (!ec)
-                    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::read_symlink", p, error_code(ENAMETOOLONG, system_category())));
-
-                ec->assign(ENAMETOOLONG, system_category());
-                break;
+                // Dangling symlink
+                m_status = file_status(file_not_found, no_perms);
+                return;
             }
 
-            boost::scoped_array< char > buf(new char[path_max]);
-            result = ::readlink(path_str, buf.get(), path_max);
-            if (BOOST_UNLIKELY(result < 0))
-            {
-                goto fail;
-            }
-            else if (BOOST_LIKELY(static_cast< std::size_t >(result) < path_max))
-            {
-                symlink_path.assign(buf.get(), buf.get() + result);
-                break;
-            }
+            goto fail;
         }
+
+        m_status = detail::make_file_status(detail::get_mode(st));
+    }
+    else
+    {
+        m_status = m_symlink_status;
     }
 
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    if ((st.stx_mask & STATX_SIZE) != 0u)
+    {
+        m_file_size = st.stx_size;
+        m_cached_attrs |= detail::file_size_cached;
+    }
+    if ((st.stx_mask & STATX_MTIME) != 0u)
+    {
+        m_last_write_time = st.stx_mtime.tv_sec;
+        m_cached_attrs |= detail::last_write_time_cached;
+    }
+    if ((st.stx_mask & STATX_NLINK) != 0u)
+    {
+        m_hard_link_count = st.stx_nlink;
+        m_cached_attrs |= detail::hard_link_count_cached;
+    }
+    if ((st.stx_mask & STATX_INO) != 0u)
+    {
+        m_inode = st.stx_ino;
+        m_cached_attrs |= detail::inode_cached;
+    }
+    // The device is always reported by statx
+    m_device = static_cast< boost::uint64_t >(detail::get_dev(st));
+    m_cached_attrs |= detail::device_cached;
 #else
+    m_file_size = st.st_size;
+    m_last_write_time = st.st_mtime;
+    m_hard_link_count = st.st_nlink;
+    m_inode = st.st_ino;
+    m_device = static_cast< boost::uint64_t >(st.st_dev);
+    m_cached_attrs = detail::file_size_cached | detail::last_write_time_cached | detail::hard_link_count_cached | detail::inode_cached | detail::device_cached;
+#endif
+    return;
 
-    handle_wrapper h(create_file_handle(
-        p.c_str(),
+fail:
+    emit_error(err, m_path, ec, "boost::filesystem::directory_entry::refresh");
+
+#else // defined(BOOST_POSIX_API)
+
+    (void)consistency;
+    error_code local_ec;
+    m_symlink_status = detail::symlink_status_impl(m_path, &local_ec);
+    if (BOOST_LIKELY(!local_ec))
+    {
+        if (m_symlink_status.type() == symlink_file)
+            m_status = detail::status_impl(m_path, &local_ec);
+        else
+            m_status = m_symlink_status;
+    }
+
+    if (BOOST_UNLIKELY(!!local_ec))
+    {
+        if (m_status.type() == file_not_found || m_symlink_status.type() == file_not_found)
+        {
+            m_status = file_status(file_not_found, no_perms);
+            if (m_symlink_status.type() != symlink_file)
+                m_symlink_status = m_status;
+            return;
+        }
+
+        m_status = file_status();
+        m_symlink_status = file_status();
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::directory_entry::refresh", m_path, local_ec));
+
+        *ec = local_ec;
+        return;
+    }
+
+    detail::handle_wrapper h(detail::create_file_handle(
+        m_path.c_str(),
         FILE_READ_ATTRIBUTES,
         FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
         NULL,
         OPEN_EXISTING,
-        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OPEN_REPARSE_POINT));
+        FILE_FLAG_BACKUP_SEMANTICS));
 
-    DWORD error;
-    if (BOOST_UNLIKELY(h.handle == INVALID_HANDLE_VALUE))
+    // If the attributes cannot be obtained, leave them not cached. The accessors will report the error.
+    BY_HANDLE_FILE_INFORMATION info;
+    if (h.handle != INVALID_HANDLE_VALUE && ::GetFileInformationByHandle(h.handle, &info))
     {
-        error = ::GetLastError();
-
-    return_error:
-        emit_error(error, p, ec, "boost::filesystem::read_symlink");
-        return symlink_path;
+        m_file_size = (static_cast< boost::uintmax_t >(info.nFileSizeHigh) << 32u) | info.nFileSizeLow;
+        m_last_write_time = detail::to_time_t(info.ftLastWriteTime);
+        m_hard_link_count = info.nNumberOfLinks;
+        m_inode = (static_cast< boost::uintmax_t >(info.nFileIndexHigh) << 32u) | info.nFileIndexLow;
+        m_device = info.dwVolumeSerialNumber;
+        m_cached_attrs = detail::file_size_cached | detail::last_write_time_cached | detail::hard_link_count_cached | detail::inode_cached | detail::device_cached;
     }
 
-    boost::scoped_ptr< reparse_data_buffer_with_storage > buf(new reparse_data_buffer_with_storage);
-    DWORD sz = 0u;
-    if (BOOST_UNLIKELY(!::DeviceIoControl(h.handle, FSCTL_GET_REPARSE_POINT, NULL, 0, buf.get(), sizeof(*buf), &sz, NULL)))
-    {
-        error = ::GetLastError();
-        goto return_error;
-    }
+#endif // defined(BOOST_POSIX_API)
+}
 
-    const wchar_t* buffer;
-    std::size_t offset, len;
-    switch (buf->rdb.ReparseTag)
+BOOST_FILESYSTEM_DECL
+boost::uintmax_t directory_entry::get_file_size(system::error_code* ec) const
+{
+    if ((m_cached_attrs & detail::file_size_cached) == 0u)
     {
-    case IO_REPARSE_TAG_MOUNT_POINT:
-        buffer = buf->rdb.MountPointReparseBuffer.PathBuffer;
-        offset = buf->rdb.MountPointReparseBuffer.SubstituteNameOffset;
-        len = buf->rdb.MountPointReparseBuffer.SubstituteNameLength;
-        break;
-
-    case IO_REPARSE_TAG_SYMLINK:
-        buffer = buf->rdb.SymbolicLinkReparseBuffer.PathBuffer;
-        offset = buf->rdb.SymbolicLinkReparseBuffer.SubstituteNameOffset;
-        len = buf->rdb.SymbolicLinkReparseBuffer.SubstituteNameLength;
-        // Note: iff info.rdb.SymbolicLinkReparseBuffer.Flags & SYMLINK_FLAG_RELATIVE
-        //       -> resulting path is relative to the source
-        break;
+        refresh_impl(ec);
+        if (BOOST_UNLIKELY(ec && !!*ec))
+            return static_cast< boost::uintmax_t >(-1);
 
-    default:
-        emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "Unknown ReparseTag in boost::filesystem::read_symlink");
-        return symlink_path;
+        // The file may have been removed, let file_size report the error
+        if (BOOST_UNLIKELY((m_cached_attrs & detail::file_size_cached) == 0u))
+            return detail::file_size(m_path, ec);
     }
 
-    symlink_path = convert_nt_path_to_win32_path(buffer + offset / sizeof(wchar_t), len / sizeof(wchar_t));
+#if defined(BOOST_POSIX_API)
+    if (BOOST_UNLIKELY(m_status.type() != regular_file))
+#else
+    if (BOOST_UNLIKELY(m_status.type() == directory_file))
 #endif
+    {
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, m_path, ec, "boost::filesystem::directory_entry::file_size");
+        return static_cast< boost::uintmax_t >(-1);
+    }
 
-    return symlink_path;
+    if (ec)
+        ec->clear();
+
+    return m_file_size;
 }
 
 BOOST_FILESYSTEM_DECL
-path relative(path const& p, path const& base, error_code* ec)
+std::time_t directory_entry::get_last_write_time(system::error_code* ec) const
 {
+    if ((m_cached_attrs & detail::last_write_time_cached) == 0u)
+    {
+        refresh_impl(ec);
+        if (BOOST_UNLIKELY(ec && !!*ec))
+            return (std::numeric_limits< std::time_t >::min)();
+
+        if (BOOST_UNLIKELY((m_cached_attrs & detail::last_write_time_cached) == 0u))
+            return detail::last_write_time(m_path, ec);
+    }
+
     if (ec)
         ec->clear();
 
-    error_code local_ec;
-    path cur_path;
-    if (!p.is_absolute() || !base.is_absolute())
+    return m_last_write_time;
+}
+
+BOOST_FILESYSTEM_DECL
+boost::uintmax_t directory_entry::get_hard_link_count(system::error_code* ec) const
+{
+    if ((m_cached_attrs & detail::hard_link_count_cached) == 0u)
     {
-        cur_path = detail::current_path(&local_ec);
-        if (BOOST_UNLIKELY(!!local_ec))
-        {
-        fail_local_ec:
-            if (!ec)
-                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::relative", p, base, local_ec));
+        refresh_impl(ec);
+        if (BOOST_UNLIKELY(ec && !!*ec))
+            return static_cast< boost::uintmax_t >(-1);
 
-            *ec = local_ec;
-            return path();
-        }
+        if (BOOST_UNLIKELY((m_cached_attrs & detail::hard_link_count_cached) == 0u))
+            return detail::hard_link_count(m_path, ec);
     }
 
-    path wc_base(detail::weakly_canonical(base, cur_path, &local_ec));
-    if (BOOST_UNLIKELY(!!local_ec))
-        goto fail_local_ec;
-    path wc_p(detail::weakly_canonical(p, cur_path, &local_ec));
-    if (BOOST_UNLIKELY(!!local_ec))
-        goto fail_local_ec;
-    return wc_p.lexically_relative(wc_base);
+    if (ec)
+        ec->clear();
+
+    return m_hard_link_count;
 }
 
 BOOST_FILESYSTEM_DECL
-bool remove(path const& p, error_code* ec)
+boost::uintmax_t directory_entry::get_inode(system::error_code* ec) const
 {
+    if ((m_cached_attrs & detail::inode_cached) == 0u)
+    {
+        refresh_impl(ec);
+        if (BOOST_UNLIKELY(ec && !!*ec))
+            return static_cast< boost::uintmax_t >(-1);
+
+        if (BOOST_UNLIKELY((m_cached_attrs & detail::inode_cached) == 0u))
+        {
+            emit_error(filesystem::exists(m_status) ? BOOST_ERROR_NOT_SUPPORTED : BOOST_ERROR_FILE_NOT_FOUND, m_path, ec, "boost::filesystem::directory_entry::inode");
+            return static_cast< boost::uintmax_t >(-1);
+        }
+    }
+
     if (ec)
         ec->clear();
 
-    return detail::remove_impl(p, ec);
+    return m_inode;
 }
 
 BOOST_FILESYSTEM_DECL
-uintmax_t remove_all(path const& p, error_code* ec)
+file_identity directory_entry::get_identity(system::error_code* ec) const
 {
+    const unsigned int identity_attrs = detail::inode_cached | detail::device_cached;
+    if ((m_cached_attrs & identity_attrs) != identity_attrs)
+    {
+        refresh_impl(ec);
+        if (BOOST_UNLIKELY(ec && !!*ec))
+            return file_identity();
+
+        // The file may have been removed or the filesystem may not report inode numbers, let identity report the error
+        if (BOOST_UNLIKELY((m_cached_attrs & identity_attrs) != identity_attrs))
+            return detail::identity(m_path, ec);
+    }
+
     if (ec)
         ec->clear();
 
-    return detail::remove_all_impl(p, ec);
+    return file_identity(m_device, static_cast< boost::uint64_t >(m_inode));
 }
 
-BOOST_FILESYSTEM_DECL
-void rename(path const& old_p, path const& new_p, error_code* ec)
-{
-    error(!BOOST_MOVE_FILE(old_p.c_str(), new_p.c_str()) ? BOOST_ERRNO : 0, old_p, new_p, ec, "boost::filesystem::rename");
-}
+//  sync_group  ----------------------------------------------------------------------//
 
-BOOST_FILESYSTEM_DECL
-void resize_file(path const& p, uintmax_t size, system::error_code* ec)
+struct sync_group::impl
 {
-#if defined(BOOST_POSIX_API)
-    if (BOOST_UNLIKELY(size > static_cast< uintmax_t >((std::numeric_limits< off_t >::max)())))
+#if defined(BOOST_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_SYNCFS)
+    //! Opened files residing on distinct filesystems, with the filesystem device numbers. The files are used to synchronize filesystems.
+    std::vector< std::pair< dev_t, int > > filesystems;
+#endif
+    //! Paths of the files to synchronize individually
+    std::vector< path > paths;
+
+#if defined(BOOST_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_SYNCFS)
+    ~impl()
     {
-        emit_error(system::errc::file_too_large, p, ec, "boost::filesystem::resize_file");
-        return;
+        clear();
     }
 #endif
-    error(!BOOST_RESIZE_FILE(p.c_str(), size) ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::resize_file");
-}
 
-BOOST_FILESYSTEM_DECL
-space_info space(path const& p, error_code* ec)
-{
-    space_info info;
-    // Initialize members to -1, as required by C++20 [fs.op.space]/1 in case of error
-    info.capacity = static_cast< uintmax_t >(-1);
-    info.free = static_cast< uintmax_t >(-1);
-    info.available = static_cast< uintmax_t >(-1);
+    void clear() BOOST_NOEXCEPT
+    {
+#if defined(BOOST_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_SYNCFS)
+        for (std::size_t i = 0u, n = filesystems.size(); i < n; ++i)
+            detail::close_fd(filesystems[i].second);
+        filesystems.clear();
+#endif
+        paths.clear();
+    }
+};
 
-    if (ec)
-        ec->clear();
+namespace detail {
 
-#if defined(BOOST_FILESYSTEM_USE_WASI)
+#if defined(BOOST_POSIX_API)
 
-    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::space");
+#if defined(BOOST_FILESYSTEM_HAS_SYNCFS)
 
-#elif defined(BOOST_POSIX_API)
+namespace {
 
-    struct BOOST_STATVFS vfs;
-    if (!error(::BOOST_STATVFS(p.c_str(), &vfs) ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::space"))
+//! Indicates whether syncfs reports writeback errors of the files: 0 - not yet known, 1 - no, 2 - yes
+unsigned int g_syncfs_reports_errors = 0u;
+
+//! Returns \c true if syncfs reports errors of writing file data, which is the case since Linux 5.8
+bool syncfs_reports_errors() BOOST_NOEXCEPT
+{
+    unsigned int reports = filesystem::detail::atomic_load_relaxed(g_syncfs_reports_errors);
+    if (BOOST_UNLIKELY(reports == 0u))
     {
-        info.capacity = static_cast< uintmax_t >(vfs.f_blocks) * BOOST_STATVFS_F_FRSIZE;
-        info.free = static_cast< uintmax_t >(vfs.f_bfree) * BOOST_STATVFS_F_FRSIZE;
-        info.available = static_cast< uintmax_t >(vfs.f_bavail) * BOOST_STATVFS_F_FRSIZE;
+        unsigned int major_ver = 0u, minor_ver = 0u, patch_ver = 0u;
+        reports = get_linux_kernel_version(major_ver, minor_ver, patch_ver) && (major_ver > 5u || (major_ver == 5u && minor_ver >= 8u)) ? 2u : 1u;
+        filesystem::detail::atomic_store_relaxed(g_syncfs_reports_errors, reports);
     }
 
-#else
+    return reports == 2u;
+}
 
-    // GetDiskFreeSpaceExW requires a directory path, which is unlike statvfs, which accepts any file.
-    // To work around this, test if the path refers to a directory and use the parent directory if not.
-    error_code local_ec;
-    file_status status = detail::status_impl(p, &local_ec);
-    if (status.type() == fs::status_error || status.type() == fs::file_not_found)
-    {
-    fail_local_ec:
-        if (!ec)
-            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::space", p, local_ec));
-        *ec = local_ec;
-        return info;
-    }
+} // namespace
 
-    path dir_path = p;
-    if (!is_directory(status))
+#endif // defined(BOOST_FILESYSTEM_HAS_SYNCFS)
+
+int sync_group_access::add(sync_group& group, int fd, path const& p)
+{
+    try
     {
-        path cur_path = detail::current_path(ec);
-        if (ec && *ec)
-            return info;
+        if (!group.m_impl)
+            group.m_impl = new sync_group::impl();
 
-        status = detail::symlink_status_impl(p, &local_ec);
-        if (status.type() == fs::status_error)
-            goto fail_local_ec;
-        if (is_symlink(status))
+#if defined(BOOST_FILESYSTEM_HAS_SYNC_FILE_RANGE)
+        // Initiate writeback of the file data now, so that less data remains to be written by the time the group is committed
+        ::sync_file_range(fd, 0, 0, SYNC_FILE_RANGE_WRITE);
+#endif
+
+#if defined(BOOST_FILESYSTEM_HAS_SYNCFS)
+        // Before Linux 5.8 syncfs does not report writeback errors, so the files have to be synchronized individually
+        if (!syncfs_reports_errors())
         {
-            // We need to resolve the symlink so that we report the space for the symlink target
-            dir_path = detail::canonical(p, cur_path, ec);
-            if (ec && *ec)
-                return info;
+            group.m_impl->paths.push_back(p);
+            return 0;
         }
 
-        dir_path = dir_path.parent_path();
-        if (dir_path.empty())
+        struct ::stat st;
+        if (BOOST_UNLIKELY(::fstat(fd, &st) != 0))
+            return errno;
+
+        std::vector< std::pair< dev_t, int > >& filesystems = group.m_impl->filesystems;
+        for (std::size_t i = 0u, n = filesystems.size(); i < n; ++i)
         {
-            // The original path was just a filename, which is a relative path wrt. current directory
-            dir_path = cur_path;
+            if (filesystems[i].first == st.st_dev)
+                return 0;
         }
-    }
 
-    // For UNC names, the path must also include a trailing slash.
-    path::string_type str = dir_path.native();
-    if (str.size() >= 2u && detail::is_directory_separator(str[0]) && detail::is_directory_separator(str[1]) && !detail::is_directory_separator(*(str.end() - 1)))
-        str.push_back(path::preferred_separator);
+        filesystems.reserve(filesystems.size() + 1u);
+        const int new_fd = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+        if (BOOST_UNLIKELY(new_fd < 0))
+            return errno;
 
-    ULARGE_INTEGER avail, total, free;
-    if (!error(::GetDiskFreeSpaceExW(str.c_str(), &avail, &total, &free) == 0, p, ec, "boost::filesystem::space"))
+        filesystems.push_back(std::pair< dev_t, int >(st.st_dev, new_fd));
+#else
+#if !defined(BOOST_FILESYSTEM_HAS_SYNC_FILE_RANGE)
+        (void)fd;
+#endif
+        group.m_impl->paths.push_back(p);
+#endif
+    }
+    catch (std::bad_alloc&)
     {
-        info.capacity = static_cast< uintmax_t >(total.QuadPart);
-        info.free = static_cast< uintmax_t >(free.QuadPart);
-        info.available = static_cast< uintmax_t >(avail.QuadPart);
+        return ENOMEM;
     }
 
-#endif
-
-    return info;
+    return 0;
 }
 
-BOOST_FILESYSTEM_DECL
-file_status status(path const& p, error_code* ec)
+#else // defined(BOOST_POSIX_API)
+
+DWORD sync_group_access::add(sync_group& group, path const& p)
 {
-    if (ec)
-        ec->clear();
+    try
+    {
+        if (!group.m_impl)
+            group.m_impl = new sync_group::impl();
 
-    return detail::status_impl(p, ec);
+        group.m_impl->paths.push_back(p);
+    }
+    catch (std::bad_alloc&)
+    {
+        return ERROR_NOT_ENOUGH_MEMORY;
+    }
+
+    return 0u;
 }
 
+#endif // defined(BOOST_POSIX_API)
+
+} // namespace detail
+
 BOOST_FILESYSTEM_DECL
-file_status symlink_status(path const& p, error_code* ec)
+sync_group::~sync_group()
 {
-    if (ec)
-        ec->clear();
-
-    return detail::symlink_status_impl(p, ec);
+    delete m_impl;
 }
 
-// contributed by Jeff Flinn
 BOOST_FILESYSTEM_DECL
-path temp_directory_path(system::error_code* ec)
+void sync_group::add_impl(path const& p, system::error_code* ec)
 {
     if (ec)
         ec->clear();
 
-#ifdef BOOST_POSIX_API
-    const char* val = NULL;
-
-    (val = std::getenv("TMPDIR")) ||
-        (val = std::getenv("TMP")) ||
-        (val = std::getenv("TEMP")) ||
-        (val = std::getenv("TEMPDIR"));
+#if defined(BOOST_POSIX_API)
+    int err;
+    while (true)
+    {
+        detail::fd_wrapper file(::open(p.c_str(), O_RDONLY | O_CLOEXEC));
+        if (BOOST_UNLIKELY(file.fd < 0))
+        {
+            err = errno;
+            if (err == EINTR)
+                continue;
+        }
+        else
+        {
+            err = detail::sync_group_access::add(*this, file.fd, p);
+        }
 
-#ifdef __ANDROID__
-    const char* default_tmp = "/data/local/tmp";
+        break;
+    }
 #else
-    const char* default_tmp = "/tmp";
-#endif
-    path p((val != NULL) ? val : default_tmp);
-
-    if (BOOST_UNLIKELY(p.empty()))
+    DWORD err = 0u;
     {
-    fail_not_dir:
-        error(ENOTDIR, p, ec, "boost::filesystem::temp_directory_path");
-        return p;
+        // Check that the file exists and is accessible
+        detail::handle_wrapper h(detail::create_file_handle(p, FILE_READ_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL));
+        if (BOOST_UNLIKELY(h.handle == INVALID_HANDLE_VALUE))
+            err = ::GetLastError();
     }
 
-    file_status status = detail::status_impl(p, ec);
-    if (BOOST_UNLIKELY(ec && *ec))
-        return path();
-    if (BOOST_UNLIKELY(!is_directory(status)))
-        goto fail_not_dir;
+    if (BOOST_LIKELY(err == 0u))
+        err = detail::sync_group_access::add(*this, p);
+#endif
 
-    return p;
+    if (BOOST_UNLIKELY(err != 0))
+        emit_error(err, p, ec, "boost::filesystem::sync_group::add");
+}
 
-#else // Windows
-#if !defined(UNDER_CE)
+BOOST_FILESYSTEM_DECL
+void sync_group::commit_impl(system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
 
-    const wchar_t* tmp_env = L"TMP";
-    const wchar_t* temp_env = L"TEMP";
-    const wchar_t* localappdata_env = L"LOCALAPPDATA";
-    const wchar_t* userprofile_env = L"USERPROFILE";
-    const wchar_t* env_list[] = { tmp_env, temp_env, localappdata_env, userprofile_env };
+    if (!m_impl)
+        return;
 
-    path p;
-    for (unsigned int i = 0; i < sizeof(env_list) / sizeof(*env_list); ++i)
+#if defined(BOOST_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_SYNCFS)
+    // syncfs flushes all modified data and metadata of the filesystem, including the directory entries of the added files.
+    // Files are only added to filesystems on Linux 5.8 and later, where syncfs also reports errors of writing data
+    // to the files as part of the background writeback. On older kernels the files are synchronized individually below.
     {
-        std::wstring env = wgetenv(env_list[i]);
-        if (!env.empty())
+        int err = 0;
+        std::vector< std::pair< dev_t, int > >& filesystems = m_impl->filesystems;
+        for (std::size_t i = 0u, n = filesystems.size(); i < n; ++i)
         {
-            p = env;
-            if (i >= 2)
-                p /= L"Temp";
-            error_code lcl_ec;
-            if (exists(p, lcl_ec) && !lcl_ec && is_directory(p, lcl_ec) && !lcl_ec)
-                break;
-            p.clear();
+            if (BOOST_UNLIKELY(::syscall(__NR_syncfs, filesystems[i].second) != 0))
+            {
+                if (err == 0)
+                    err = errno;
+            }
         }
-    }
 
-    if (p.empty())
-    {
-        // use a separate buffer since in C++03 a string is not required to be contiguous
-        const UINT size = ::GetWindowsDirectoryW(NULL, 0);
-        if (BOOST_UNLIKELY(size == 0))
+        if (BOOST_UNLIKELY(err != 0))
         {
-        getwindir_error:
-            int errval = ::GetLastError();
-            error(errval, ec, "boost::filesystem::temp_directory_path");
-            return path();
+            m_impl->clear();
+            emit_error(err, ec, "boost::filesystem::sync_group::commit");
+            return;
         }
-
-        boost::scoped_array< wchar_t > buf(new wchar_t[size]);
-        if (BOOST_UNLIKELY(::GetWindowsDirectoryW(buf.get(), size) == 0))
-            goto getwindir_error;
-
-        p = buf.get(); // do not depend on initial buf size, see ticket #10388
-        p /= L"Temp";
     }
+#endif
 
-    return p;
-
-#else // Windows CE
+    std::vector< path >& paths = m_impl->paths;
+#if defined(BOOST_POSIX_API)
+    int err = 0;
+#else
+    DWORD err = 0u;
+#endif
+    std::size_t failed_index = 0u;
+    for (std::size_t i = 0u, n = paths.size(); i < n && err == 0; ++i)
+    {
+#if defined(BOOST_POSIX_API)
+        while (true)
+        {
+            detail::fd_wrapper file(::open(paths[i].c_str(), O_RDONLY | O_CLOEXEC));
+            if (BOOST_UNLIKELY(file.fd < 0))
+            {
+                err = errno;
+                if (err == EINTR)
+                {
+                    err = 0;
+                    continue;
+                }
+            }
+            else
+            {
+                err = detail::full_sync(file.fd);
+            }
 
-    // Windows CE has no environment variables, so the same code as used for
-    // regular Windows, above, doesn't work.
+            break;
+        }
+#else
+        detail::handle_wrapper h(detail::create_file_handle(paths[i], GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL));
+        if (BOOST_UNLIKELY(h.handle == INVALID_HANDLE_VALUE || !::FlushFileBuffers(h.handle)))
+            err = ::GetLastError();
+#endif
+        failed_index = i;
+    }
 
-    DWORD size = ::GetTempPathW(0, NULL);
-    if (size == 0u)
+    if (BOOST_UNLIKELY(err != 0))
     {
-    fail:
-        int errval = ::GetLastError();
-        error(errval, ec, "boost::filesystem::temp_directory_path");
-        return path();
+        if (!ec)
+        {
+            const path failed_path = paths[failed_index];
+            m_impl->clear();
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::sync_group::commit", failed_path, error_code(err, system_category())));
+        }
+
+        m_impl->clear();
+        ec->assign(err, system_category());
+        return;
     }
 
-    boost::scoped_array< wchar_t > buf(new wchar_t[size]);
-    if (::GetTempPathW(size, buf.get()) == 0)
-        goto fail;
+    m_impl->clear();
+}
 
-    path p(buf.get());
-    p.remove_trailing_separator();
+namespace detail {
 
-    file_status status = detail::status_impl(p, ec);
-    if (ec && *ec)
-        return path();
-    if (!is_directory(status))
-    {
-        error(ERROR_PATH_NOT_FOUND, p, ec, "boost::filesystem::temp_directory_path");
-        return path();
-    }
+namespace {
 
-    return p;
+#if defined(BOOST_POSIX_API)
 
-#endif // !defined(UNDER_CE)
+//! Creates a temporary file in the directory \a dir that is not visible in the directory. Returns -1 on failure.
+int create_probe_file(path const& dir)
+{
+#if defined(O_TMPFILE)
+    int fd = ::open(dir.c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd >= 0)
+        return fd;
 #endif
+
+    system::error_code ec;
+    const path name(dir / detail::unique_path("boost-fs-probe-%%%%-%%%%-%%%%-%%%%", &ec));
+    if (BOOST_UNLIKELY(!!ec))
+        return -1;
+
+    int fd2 = ::open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd2 >= 0)
+        ::unlink(name.c_str());
+
+    return fd2;
 }
 
-BOOST_FILESYSTEM_DECL
-path system_complete(path const& p, system::error_code* ec)
+//! Tests whether the files in the directory \a dir support cloning and in-kernel data copying
+void probe_file_capabilities(path const& dir, filesystem_capabilities& caps)
 {
-#ifdef BOOST_POSIX_API
+    const int infile = create_probe_file(dir);
+    if (infile < 0)
+        return;
 
-    return (p.empty() || p.is_absolute()) ? p : current_path() / p;
+    const int outfile = create_probe_file(dir);
+    if (outfile >= 0)
+    {
+        const char data = 'x';
+        ssize_t sz;
+        while ((sz = ::write(infile, &data, 1u)) < 0 && errno == EINTR) {}
+
+        if (sz == 1)
+        {
+#if defined(BOOST_FILESYSTEM_HAS_FICLONE)
+            int err = clone_file_data(infile, outfile);
+            if (err == 0)
+                caps.clone = capability_support::supported;
+            else if (is_clone_not_supported_error(err))
+                caps.clone = capability_support::unsupported;
+#endif
+
+#if defined(__NR_copy_file_range)
+            loff_t in_off = 0, out_off = 0;
+            loff_t res;
+            while ((res = ::syscall(__NR_copy_file_range, infile, &in_off, outfile, &out_off, static_cast< std::size_t >(1u), (unsigned int)0u)) < 0 &&
+                errno == EINTR)
+            {
+            }
 
+            if (res == 1)
+                caps.copy_file_range = capability_support::supported;
+            else if (res == 0 || errno == EINVAL || errno == EOPNOTSUPP || errno == EXDEV || errno == ENOSYS)
+                caps.copy_file_range = capability_support::unsupported;
 #else
-    if (p.empty())
-    {
-        if (ec)
-            ec->clear();
-        return p;
+            caps.copy_file_range = capability_support::unsupported;
+#endif
+        }
+
+        close_fd(outfile);
     }
 
-    BOOST_CONSTEXPR_OR_CONST std::size_t buf_size = 128u;
-    wchar_t buf[buf_size];
-    wchar_t* pfn;
-    std::size_t len = get_full_path_name(p, buf_size, buf, &pfn);
+    int err = preallocate_file(infile, 0u, 4096u, true);
+    if (err == 0)
+        caps.preallocate = capability_support::supported;
+    else if (err == ENOTSUP)
+        caps.preallocate = capability_support::unsupported;
 
-    if (error(len == 0 ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::system_complete"))
-        return path();
+    err = punch_hole_file(infile, 0u, 1u);
+    if (err == 0)
+        caps.punch_hole = capability_support::supported;
+    else if (err == ENOTSUP)
+        caps.punch_hole = capability_support::unsupported;
 
-    if (len < buf_size) // len does not include null termination character
-        return path(&buf[0]);
+    close_fd(infile);
+}
 
-    boost::scoped_array< wchar_t > big_buf(new wchar_t[len]);
+#endif // defined(BOOST_POSIX_API)
 
-    return error(get_full_path_name(p, len, big_buf.get(), &pfn) == 0 ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::system_complete") ? path() : path(big_buf.get());
-#endif
-}
+} // unnamed namespace
 
 BOOST_FILESYSTEM_DECL
-path weakly_canonical(path const& p, path const& base, system::error_code* ec)
+filesystem_capabilities probe_filesystem_capabilities(path const& p, system::error_code* ec)
 {
-    system::error_code local_ec;
-    const path::iterator p_end(p.end());
+    if (ec)
+        ec->clear();
+
+    filesystem_capabilities caps;
 
 #if defined(BOOST_POSIX_API)
 
-    path::iterator itr(p_end);
-    path head(p);
-    for (; !head.empty(); --itr)
+    DIR* dir = ::opendir(p.c_str());
+    if (BOOST_UNLIKELY(!dir))
     {
-        file_status head_status(detail::status_impl(head, &local_ec));
-        if (BOOST_UNLIKELY(head_status.type() == fs::status_error))
-        {
-            if (!ec)
-                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::weakly_canonical", head, local_ec));
-
-            *ec = local_ec;
-            return path();
-        }
+        emit_error(errno, p, ec, "boost::filesystem::probe_filesystem_capabilities");
+        return caps;
+    }
 
-        if (head_status.type() != fs::file_not_found)
+#if defined(DT_UNKNOWN)
+    // The directory always contains at least the dot and dot-dot entries. Some filesystems (e.g. XFS without ftype)
+    // report DT_UNKNOWN for all entries, others only for some entries (e.g. some FUSE filesystems), so check them all.
+    while (struct dirent* entry = ::readdir(dir))
+    {
+        if (entry->d_type == DT_UNKNOWN)
+        {
+            caps.directory_entry_type = capability_support::unsupported;
             break;
+        }
 
-        head.remove_filename();
+        caps.directory_entry_type = capability_support::supported;
     }
+#else
+    caps.directory_entry_type = capability_support::unsupported;
+#endif
 
-    if (head.empty())
-        return p.lexically_normal();
+    ::closedir(dir);
 
-    path const& dot_p = dot_path();
-    path const& dot_dot_p = dot_dot_path();
+    probe_file_capabilities(p, caps);
 
-#else
+#else // defined(BOOST_POSIX_API)
 
-    // On Windows, filesystem APIs such as GetFileAttributesW and CreateFileW perform lexical path normalization
-    // internally. As a result, a path like "c:\a\.." can be reported as present even if "c:\a" is not. This would
-    // break canonical, as symlink_status that it calls internally would report an error that the file at the
-    // intermediate path does not exist. To avoid this, scan the initial path in the forward direction.
-    // Also, operate on paths with preferred separators. This can be important on Windows since GetFileAttributesW
-    // or CreateFileW, which is called in status() may return "file not found" for paths to network shares and
-    // mounted cloud storages that have forward slashes as separators.
-    // Also, avoid querying status of the root name such as \\?\c: as CreateFileW returns ERROR_INVALID_FUNCTION for
-    // such path. Querying the status of a root name such as c: is also not right as this path refers to the current
-    // directory on drive C:, which is not what we want to test for existence anyway.
-    path::iterator itr(p.begin());
-    path head;
-    if (p.has_root_name())
-    {
-        BOOST_ASSERT(itr != p_end);
-        head = *itr;
-        ++itr;
-    }
+    // FindFirstFileW and NtQueryDirectoryFile always report file attributes
+    caps.directory_entry_type = capability_support::supported;
+    caps.copy_file_range = capability_support::unsupported;
 
-    if (p.has_root_directory())
+    std::wstring volume_path;
+    volume_path.resize(MAX_PATH + 1u);
+    if (BOOST_UNLIKELY(!::GetVolumePathNameW(p.c_str(), &volume_path[0], static_cast< DWORD >(volume_path.size()))))
     {
-        BOOST_ASSERT(itr != p_end);
-        // Convert generic separator returned by the iterator for the root directory to
-        // the preferred separator.
-        head += path::preferred_separator;
-        ++itr;
+        emit_error(::GetLastError(), p, ec, "boost::filesystem::probe_filesystem_capabilities");
+        return caps;
     }
 
-    if (!head.empty())
+    DWORD fs_flags = 0u;
+    if (::GetVolumeInformationW(volume_path.c_str(), NULL, 0u, NULL, NULL, &fs_flags, NULL, 0u))
     {
-        file_status head_status(detail::status_impl(head, &local_ec));
-        if (BOOST_UNLIKELY(head_status.type() == fs::status_error))
-        {
-            if (!ec)
-                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::weakly_canonical", head, local_ec));
-
-            *ec = local_ec;
-            return path();
-        }
-
-        if (head_status.type() == fs::file_not_found)
-        {
-            // If the root path does not exist then no path element exists
-            return p.lexically_normal();
-        }
+        // FSCTL_DUPLICATE_EXTENTS_TO_FILE, which is used for cloning, is supported on volumes with block reference counting (ReFS)
+        caps.clone = (fs_flags & FILE_SUPPORTS_BLOCK_REFCOUNTING) != 0u ? capability_support::supported : capability_support::unsupported;
+        // Deallocating file ranges requires sparse files. Storage can be allocated with FileAllocationInfo on all filesystems.
+        caps.punch_hole = (fs_flags & FILE_SUPPORTS_SPARSE_FILES) != 0u ? capability_support::supported : capability_support::unsupported;
+        caps.preallocate = capability_support::supported;
     }
 
-    path const& dot_p = dot_path();
-    path const& dot_dot_p = dot_dot_path();
-    for (; itr != p_end; ++itr)
-    {
-        path const& p_elem = *itr;
-
-        // Avoid querying status of paths containing dot and dot-dot elements, as this will break
-        // if the root name starts with "\\?\".
-        if (p_elem == dot_p)
-            continue;
-
-        if (p_elem == dot_dot_p)
-        {
-            if (head.has_relative_path())
-                head.remove_filename();
+#endif // defined(BOOST_POSIX_API)
 
-            continue;
-        }
+    return caps;
+}
 
-        head /= p_elem;
+BOOST_FILESYSTEM_DECL
+void set_parallel_copy_file_params(uintmax_t min_size, uintmax_t chunk_size) BOOST_NOEXCEPT
+{
+#if defined(BOOST_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_THREADS)
+    filesystem::detail::atomic_store_relaxed(g_parallel_copy_file_min_size, min_size > 0u ? min_size : default_parallel_copy_file_min_size);
+    filesystem::detail::atomic_store_relaxed(g_parallel_copy_file_chunk_size, chunk_size > 0u ? chunk_size : default_parallel_copy_file_chunk_size);
+#else
+    (void)min_size;
+    (void)chunk_size;
+#endif
+}
 
-        file_status head_status(detail::status_impl(head, &local_ec));
-        if (BOOST_UNLIKELY(head_status.type() == fs::status_error))
-        {
-            if (!ec)
-                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::weakly_canonical", head, local_ec));
+} // namespace detail
 
-            *ec = local_ec;
-            return path();
-        }
+BOOST_FILESYSTEM_DECL
+copy_file_backend::type get_copy_file_backend() BOOST_NOEXCEPT
+{
+#if defined(BOOST_POSIX_API)
+    detail::copy_file_data_t* cfd = filesystem::detail::atomic_load_relaxed(detail::copy_file_data);
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+    if (cfd == &detail::copy_file_data_select_impl)
+        cfd = detail::init_copy_file_data_impl();
+#endif
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
+    if (cfd == &detail::check_fs_type< detail::copy_file_data_sendfile >)
+        return copy_file_backend::sendfile;
+#endif
+#if defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+    if (cfd == &detail::check_fs_type< detail::copy_file_data_copy_file_range >)
+        return copy_file_backend::copy_file_range;
+#endif
+#if defined(BOOST_FILESYSTEM_USE_IO_URING_COPY)
+    if (cfd == &detail::check_fs_type< detail::copy_file_data_io_uring >)
+        return copy_file_backend::io_uring;
+#endif
+    (void)cfd;
+    return copy_file_backend::read_write;
+#else // defined(BOOST_POSIX_API)
+    // copy_file uses CopyFileExW, which does not have alternative implementations
+    return copy_file_backend::system_default;
+#endif // defined(BOOST_POSIX_API)
+}
 
-        if (head_status.type() == fs::file_not_found)
-        {
-            head.remove_filename();
-            break;
-        }
+BOOST_FILESYSTEM_DECL
+bool set_copy_file_backend(copy_file_backend::type backend) BOOST_NOEXCEPT
+{
+#if defined(BOOST_POSIX_API)
+    detail::copy_file_data_t* cfd = NULL;
+    switch (backend)
+    {
+    case copy_file_backend::system_default:
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+        cfd = &detail::copy_file_data_select_impl;
+#else
+        cfd = &detail::copy_file_data_plain;
+#endif
+        break;
+    case copy_file_backend::read_write:
+        cfd = &detail::copy_file_data_plain;
+        break;
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
+    case copy_file_backend::sendfile:
+        cfd = &detail::check_fs_type< detail::copy_file_data_sendfile >;
+        break;
+#endif
+#if defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+    case copy_file_backend::copy_file_range:
+        cfd = &detail::check_fs_type< detail::copy_file_data_copy_file_range >;
+        break;
+#endif
+#if defined(BOOST_FILESYSTEM_USE_IO_URING_COPY)
+    case copy_file_backend::io_uring:
+        cfd = &detail::check_fs_type< detail::copy_file_data_io_uring >;
+        break;
+#endif
+    default:
+        return false;
     }
 
-    if (head.empty())
-        return p.lexically_normal();
+    filesystem::detail::atomic_store_relaxed(detail::copy_file_data, cfd);
+    filesystem::detail::atomic_store_relaxed(detail::copy_file_backend_overridden, backend != copy_file_backend::system_default);
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+    // The cached methods may have been limited by the previously selected implementation
+    detail::clear_copy_method_cache();
+#endif
+    return true;
+#else // defined(BOOST_POSIX_API)
+    return backend == copy_file_backend::system_default;
+#endif // defined(BOOST_POSIX_API)
+}
 
+BOOST_FILESYSTEM_DECL
+status_backend::type get_status_backend() BOOST_NOEXCEPT
+{
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    detail::statx_t* stx = filesystem::detail::atomic_load_relaxed(detail::statx_ptr);
+#if !defined(BOOST_FILESYSTEM_HAS_STATX)
+    if (stx == &detail::statx_select_impl)
+        stx = detail::init_statx_impl();
+#endif
+    if (stx == &detail::statx_fstatat)
+        return status_backend::stat;
+    return status_backend::statx;
+#elif defined(BOOST_POSIX_API)
+    return status_backend::stat;
+#else
+    return status_backend::system_default;
 #endif
+}
 
-    path tail;
-    bool tail_has_dots = false;
-    for (; itr != p_end; ++itr)
+BOOST_FILESYSTEM_DECL
+bool set_status_backend(status_backend::type backend) BOOST_NOEXCEPT
+{
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    detail::statx_t* stx = NULL;
+    switch (backend)
     {
-        path const& tail_elem = *itr;
-        tail /= tail_elem;
-        // for a later optimization, track if any dot or dot-dot elements are present
-        if (!tail_has_dots && (tail_elem == dot_p || tail_elem == dot_dot_p))
-            tail_has_dots = true;
+    case status_backend::system_default:
+#if defined(BOOST_FILESYSTEM_HAS_STATX)
+        stx = &detail::statx_libc;
+#else
+        stx = &detail::statx_select_impl;
+#endif
+        break;
+    case status_backend::stat:
+        stx = &detail::statx_fstatat;
+        break;
+    case status_backend::statx:
+#if defined(BOOST_FILESYSTEM_HAS_STATX)
+        stx = &detail::statx_libc;
+#else
+        stx = &detail::statx_syscall;
+#endif
+        break;
+    default:
+        return false;
     }
 
-    head = detail::canonical(head, base, &local_ec);
-    if (BOOST_UNLIKELY(!!local_ec))
-    {
-        if (!ec)
-            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::weakly_canonical", head, local_ec));
+    filesystem::detail::atomic_store_relaxed(detail::statx_ptr, stx);
+    return true;
+#elif defined(BOOST_POSIX_API)
+    return backend == status_backend::system_default || backend == status_backend::stat;
+#else
+    return backend == status_backend::system_default;
+#endif
+}
 
-        *ec = local_ec;
-        return path();
-    }
+BOOST_FILESYSTEM_DECL
+void set_copy_buffer_allocator(copy_buffer_allocator const* allocator) BOOST_NOEXCEPT
+{
+    if (!allocator)
+        allocator = &detail::default_copy_buffer_allocator;
+    filesystem::detail::atomic_store_release(detail::g_copy_buffer_allocator, allocator);
+}
 
-    if (BOOST_LIKELY(!tail.empty()))
-    {
-        head /= tail;
+BOOST_FILESYSTEM_DECL
+void set_gradual_remove_params(gradual_remove_params const& params) BOOST_NOEXCEPT
+{
+    filesystem::detail::atomic_store_relaxed(detail::g_gradual_remove_step_size, params.step_size > 0u ? params.step_size : gradual_remove_params().step_size);
+    filesystem::detail::atomic_store_relaxed(detail::g_gradual_remove_step_interval, params.step_interval);
+    filesystem::detail::atomic_store_relaxed(detail::g_gradual_remove_background, params.background);
+    filesystem::detail::atomic_store_relaxed(detail::g_gradual_remove_min_file_size, params.min_file_size);
+}
 
-        // optimization: only normalize if tail had dot or dot-dot element
-        if (tail_has_dots)
-            return head.lexically_normal();
-    }
+BOOST_FILESYSTEM_DECL
+gradual_remove_params get_gradual_remove_params() BOOST_NOEXCEPT
+{
+    gradual_remove_params params;
+    params.min_file_size = filesystem::detail::atomic_load_relaxed(detail::g_gradual_remove_min_file_size);
+    params.step_size = filesystem::detail::atomic_load_relaxed(detail::g_gradual_remove_step_size);
+    params.step_interval = filesystem::detail::atomic_load_relaxed(detail::g_gradual_remove_step_interval);
+    params.background = filesystem::detail::atomic_load_relaxed(detail::g_gradual_remove_background);
+    return params;
+}
 
-    return head;
+BOOST_FILESYSTEM_DECL
+void refresh_cached_paths() BOOST_NOEXCEPT
+{
+#if defined(BOOST_FILESYSTEM_USE_PATH_CACHE)
+    detail::get_current_path_cache().invalidate();
+#if defined(BOOST_WINDOWS_API) && !defined(UNDER_CE)
+    detail::get_temp_directory_path_cache().invalidate();
+#endif
+#endif
 }
 
-} // namespace detail
 } // namespace filesystem
 } // namespace boost
 
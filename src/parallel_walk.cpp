@@ -0,0 +1,945 @@
+//  parallel_walk.cpp  -----------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory_handle.hpp>
+#include <boost/filesystem/parallel_walk.hpp>
+
+#include <cstddef>
+#include <new> // std::bad_alloc
+#include <set>
+#include <utility> // std::pair
+#include <vector>
+#include <boost/system/error_code.hpp>
+
+#include "thread_tools.hpp"
+#include "walk_scheduler.hpp"
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+#include <mutex>
+#endif
+
+#if defined(BOOST_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+namespace {
+
+//! Common state of the walk, shared between all threads
+struct walk_context
+{
+    parallel_walk_params const& params;
+    parallel_walk_handler* handler;
+    void* handler_context;
+    //! Device of the root directory, if the walk must not descend into directories on other filesystems
+    boost::uint64_t root_device;
+
+    walk_context(parallel_walk_params const& p, parallel_walk_handler* h, void* ctx) :
+        params(p),
+        handler(h),
+        handler_context(ctx),
+        root_device(0u)
+    {
+    }
+
+    BOOST_DELETED_FUNCTION(walk_context(walk_context const&))
+    BOOST_DELETED_FUNCTION(walk_context& operator=(walk_context const&))
+};
+
+//! Returns \c true if the iteration should descend into the directory entry
+inline bool is_directory_to_descend(walk_context const& ctx, directory_entry const& entry, unsigned int options)
+{
+    system::error_code ec;
+    file_status symlink_stat = entry.symlink_status(ec);
+    if (ec)
+        return false;
+
+    bool descend = filesystem::is_directory(symlink_stat);
+    if (!descend && filesystem::is_symlink(symlink_stat) && (options & static_cast< unsigned int >(directory_options::follow_directory_symlink)) != 0u)
+        descend = filesystem::is_directory(entry.status(ec)) && !ec;
+
+    // Mount points are on the devices of the mounted filesystems
+    if (descend && (options & static_cast< unsigned int >(directory_options::_detail_same_filesystem)) != 0u)
+        descend = entry.identity(ec).device == ctx.root_device && !ec;
+
+    return descend;
+}
+
+//! Schedules the subdirectories found in the batch that has been delivered to the handler
+template< typename Scheduler >
+inline void schedule_subdirectories(Scheduler& scheduler, std::vector< path >& subdirs)
+{
+    for (std::size_t i = 0u, n = subdirs.size(); i < n; ++i)
+        scheduler.schedule(subdirs[i]);
+    subdirs.clear();
+}
+
+//! Enumerates a single directory, delivers its entries to the handler and schedules subdirectories for enumeration.
+//! Subdirectories are scheduled after the batch containing them has been processed by the handler, so that the handler
+//! always sees a directory before its entries. Returns \c false if the walk should be stopped, in which case \a err may
+//! contain the error.
+template< typename Scheduler >
+bool walk_directory(walk_context& ctx, path const& dir, std::vector< directory_entry >& batch, Scheduler& scheduler, system::error_code& err, path& err_path)
+{
+    const unsigned int options = ctx.params.options;
+    const std::size_t batch_size = ctx.params.batch_size;
+
+    try
+    {
+        std::vector< path > subdirs;
+        directory_iterator it(dir, static_cast< BOOST_SCOPED_ENUM_NATIVE(directory_options) >(options & ~static_cast< unsigned int >(directory_options::_detail_same_filesystem)), err);
+        directory_iterator end;
+        while (true)
+        {
+            if (BOOST_UNLIKELY(!!err))
+            {
+                if (err == make_error_condition(system::errc::permission_denied) &&
+                    (options & static_cast< unsigned int >(directory_options::skip_permission_denied)) != 0u)
+                {
+                    err.clear();
+                    break;
+                }
+
+                err_path = dir;
+                return false;
+            }
+
+            if (it == end)
+                break;
+
+            directory_entry const& entry = *it;
+            if (is_directory_to_descend(ctx, entry, options))
+                subdirs.push_back(entry.path());
+
+            batch.push_back(entry);
+            if (batch.size() >= batch_size)
+            {
+                const bool proceed = ctx.handler(ctx.handler_context, batch);
+                batch.clear();
+                if (!proceed || scheduler.is_stopped())
+                    return false;
+                schedule_subdirectories(scheduler, subdirs);
+            }
+
+            it.increment(err);
+        }
+
+        if (!batch.empty())
+        {
+            const bool proceed = ctx.handler(ctx.handler_context, batch);
+            batch.clear();
+            if (!proceed)
+                return false;
+            schedule_subdirectories(scheduler, subdirs);
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        err = make_error_code(system::errc::not_enough_memory);
+        err_path = dir;
+        batch.clear();
+        return false;
+    }
+
+    return true;
+}
+
+//! Worker of the walk schedulers that delivers directory entries to the walk handler
+class walk_worker
+{
+public:
+    typedef walk_context context_type;
+    typedef path task_type;
+
+private:
+    walk_context& m_context;
+    std::vector< directory_entry > m_batch;
+
+public:
+    explicit walk_worker(walk_context& ctx) BOOST_NOEXCEPT :
+        m_context(ctx)
+    {
+        try
+        {
+            m_batch.reserve(ctx.params.batch_size);
+        }
+        catch (std::bad_alloc&)
+        {
+            // The batch will grow as needed
+        }
+    }
+
+    BOOST_DELETED_FUNCTION(walk_worker(walk_worker const&))
+    BOOST_DELETED_FUNCTION(walk_worker& operator=(walk_worker const&))
+
+    template< typename Scheduler >
+    bool operator()(path const& dir, Scheduler& scheduler, system::error_code& err, path& err_path)
+    {
+        return walk_directory(m_context, dir, m_batch, scheduler, err, err_path);
+    }
+};
+
+void sequential_walk(walk_context& ctx, path const& root, system::error_code& err, path& err_path)
+{
+    sequential_walk_scheduler< path > sched;
+    walk_worker worker(ctx);
+    path dir(root);
+    do
+    {
+        if (!worker(dir, sched, err, err_path))
+            break;
+    }
+    while (sched.take(dir));
+}
+
+//! Common state of the parallel copy
+class parallel_copy_context
+{
+private:
+    path const& m_from;
+    path const& m_to;
+    //! Options for copying individual entries
+    const unsigned int m_options;
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+    std::mutex m_error_mutex;
+#endif
+    system::error_code m_error;
+    path m_error_path1;
+    path m_error_path2;
+
+public:
+    parallel_copy_context(path const& from, path const& to, unsigned int options) BOOST_NOEXCEPT :
+        m_from(from),
+        m_to(to),
+        // Set _detail_recursing flag so that copy() creates directories without recursing into them, the walker does that
+        m_options((options & ~static_cast< unsigned int >(copy_options::recursive)) | static_cast< unsigned int >(copy_options::_detail_recursing))
+    {
+    }
+
+    BOOST_DELETED_FUNCTION(parallel_copy_context(parallel_copy_context const&))
+    BOOST_DELETED_FUNCTION(parallel_copy_context& operator=(parallel_copy_context const&))
+
+    system::error_code const& error() const BOOST_NOEXCEPT { return m_error; }
+    path const& error_path1() const BOOST_NOEXCEPT { return m_error_path1; }
+    path const& error_path2() const BOOST_NOEXCEPT { return m_error_path2; }
+
+    //! Walker batch handler
+    static bool on_batch(void* context, std::vector< directory_entry >& batch)
+    {
+        return static_cast< parallel_copy_context* >(context)->copy_batch(batch);
+    }
+
+private:
+    //! Returns the target path for the given source path within the source tree
+    path make_target(path const& p) const
+    {
+        // The walker constructs paths by appending file names to the root, so the source root is always a prefix
+        path::string_type const& str = p.native();
+        std::size_t pos = m_from.native().size();
+        while (pos < str.size() && detail::is_directory_separator(str[pos]))
+            ++pos;
+
+        return m_to / path(str.c_str() + pos);
+    }
+
+    bool copy_batch(std::vector< directory_entry >& batch) BOOST_NOEXCEPT
+    {
+        system::error_code ec;
+        path source, target;
+        try
+        {
+            // The walker delivers the entries of a directory after the directory itself, so the target directory exists
+            for (std::size_t i = 0u, n = batch.size(); i < n; ++i)
+            {
+                source = batch[i].path();
+                target = make_target(source);
+                detail::copy(source, target, m_options, &ec);
+                if (BOOST_UNLIKELY(!!ec))
+                    goto fail;
+            }
+        }
+        catch (std::bad_alloc&)
+        {
+            ec = make_error_code(system::errc::not_enough_memory);
+            goto fail;
+        }
+        catch (...)
+        {
+            ec = make_error_code(system::errc::io_error);
+            goto fail;
+        }
+
+        return true;
+
+    fail:
+        set_error(ec, source, target);
+        return false;
+    }
+
+    void set_error(system::error_code const& err, path const& p1, path const& p2) BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_error_mutex);
+#endif
+        if (!m_error)
+        {
+            m_error = err;
+            try
+            {
+                m_error_path1 = p1;
+                m_error_path2 = p2;
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+};
+
+//! Common state of linking a directory tree
+class link_tree_context
+{
+private:
+    path const& m_from;
+    path const& m_to;
+    const bool m_symlinks;
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+    std::mutex m_mutex;
+#endif
+    uintmax_t m_count;
+    system::error_code m_error;
+    path m_error_path1;
+    path m_error_path2;
+
+public:
+    link_tree_context(path const& from, path const& to, bool symlinks) BOOST_NOEXCEPT :
+        m_from(from),
+        m_to(to),
+        m_symlinks(symlinks),
+        m_count(0u)
+    {
+    }
+
+    BOOST_DELETED_FUNCTION(link_tree_context(link_tree_context const&))
+    BOOST_DELETED_FUNCTION(link_tree_context& operator=(link_tree_context const&))
+
+    uintmax_t count() const BOOST_NOEXCEPT { return m_count; }
+    system::error_code const& error() const BOOST_NOEXCEPT { return m_error; }
+    path const& error_path1() const BOOST_NOEXCEPT { return m_error_path1; }
+    path const& error_path2() const BOOST_NOEXCEPT { return m_error_path2; }
+
+    //! Walker batch handler
+    static bool on_batch(void* context, std::vector< directory_entry >& batch)
+    {
+        return static_cast< link_tree_context* >(context)->link_batch(batch);
+    }
+
+private:
+    //! Returns the target path for the given source path within the source tree
+    path make_target(path const& p) const
+    {
+        // The walker constructs paths by appending file names to the root, so the source root is always a prefix
+        path::string_type const& str = p.native();
+        std::size_t pos = m_from.native().size();
+        while (pos < str.size() && detail::is_directory_separator(str[pos]))
+            ++pos;
+
+        return m_to / path(str.c_str() + pos);
+    }
+
+    bool link_batch(std::vector< directory_entry >& batch) BOOST_NOEXCEPT
+    {
+        system::error_code ec;
+        path source, target;
+        uintmax_t count = 0u;
+        try
+        {
+#if defined(BOOST_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+            // All entries of the batch belong to the same directory, link them relative to the source and target directories
+            // to avoid resolving the whole paths for every file. The walker delivers the entries of a directory after
+            // the directory itself, so the target directory exists.
+            source = batch.front().path().parent_path();
+            target = make_target(source);
+            directory_handle source_dir(source, ec);
+            if (BOOST_UNLIKELY(!!ec))
+                goto fail;
+            directory_handle target_dir(target, ec);
+            if (BOOST_UNLIKELY(!!ec))
+                goto fail;
+#endif
+
+            for (std::size_t i = 0u, n = batch.size(); i < n; ++i)
+            {
+                directory_entry const& entry = batch[i];
+                source = entry.path();
+                file_status st = entry.symlink_status(ec);
+                if (BOOST_UNLIKELY(!!ec))
+                {
+                    target.clear();
+                    goto fail;
+                }
+
+                if (filesystem::is_directory(st))
+                {
+                    // Create empty directories as well, the walker descends into the directory and links its files later
+                    target = make_target(source);
+                    detail::create_directory(target, &source, &ec);
+                    if (BOOST_UNLIKELY(!!ec))
+                        goto fail;
+                    continue;
+                }
+
+#if defined(BOOST_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                // The walker appends the file name to the path of the directory
+                path::string_type const& str = source.native();
+                std::size_t name_pos = str.size();
+                while (name_pos > 0u && !detail::is_directory_separator(str[name_pos - 1u]))
+                    --name_pos;
+                path::value_type const* name = str.c_str() + name_pos;
+                int res;
+                if (m_symlinks)
+                    res = ::symlinkat(source.c_str(), target_dir.native_handle(), name);
+                else
+                    res = ::linkat(source_dir.native_handle(), name, target_dir.native_handle(), name, 0);
+
+                if (BOOST_UNLIKELY(res != 0))
+                {
+                    ec.assign(errno, system::system_category());
+                    target = make_target(source);
+                    goto fail;
+                }
+#else
+                target = make_target(source);
+                if (m_symlinks)
+                    detail::create_symlink(source, target, &ec);
+                else
+                    detail::create_hard_link(source, target, &ec);
+                if (BOOST_UNLIKELY(!!ec))
+                    goto fail;
+#endif
+                ++count;
+            }
+        }
+        catch (std::bad_alloc&)
+        {
+            ec = make_error_code(system::errc::not_enough_memory);
+            goto fail;
+        }
+
+        add_count(count);
+        return true;
+
+    fail:
+        add_count(count);
+        set_error(ec, source, target);
+        return false;
+    }
+
+    void add_count(uintmax_t count) BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        m_count += count;
+    }
+
+    void set_error(system::error_code const& err, path const& p1, path const& p2) BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        if (!m_error)
+        {
+            m_error = err;
+            try
+            {
+                m_error_path1 = p1;
+                m_error_path2 = p2;
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+};
+
+//! Common state of the disk usage computation
+class disk_usage_context
+{
+private:
+    //! File attributes needed to compute disk usage
+    static BOOST_CONSTEXPR_OR_CONST unsigned int query_mask = static_cast< unsigned int >(file_attribute_mask::type) |
+        static_cast< unsigned int >(file_attribute_mask::size) | static_cast< unsigned int >(file_attribute_mask::allocated_size) |
+        static_cast< unsigned int >(file_attribute_mask::hard_link_count) | static_cast< unsigned int >(file_attribute_mask::inode) |
+        static_cast< unsigned int >(file_attribute_mask::device) | static_cast< unsigned int >(file_attribute_mask::no_follow);
+
+    //! A file with multiple hard links
+    struct linked_file
+    {
+        std::pair< uintmax_t, uintmax_t > id;
+        uintmax_t apparent_size;
+        uintmax_t allocated_size;
+    };
+
+private:
+    const bool m_count_hard_links;
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+    std::mutex m_mutex;
+#endif
+    disk_usage_info m_info;
+    //! Device and inode numbers of the already counted files with multiple hard links
+    std::set< std::pair< uintmax_t, uintmax_t > > m_linked_files;
+    system::error_code m_error;
+    path m_error_path;
+
+public:
+    explicit disk_usage_context(unsigned int options) BOOST_NOEXCEPT :
+        m_count_hard_links((options & static_cast< unsigned int >(disk_usage_options::count_hard_links)) != 0u)
+    {
+    }
+
+    BOOST_DELETED_FUNCTION(disk_usage_context(disk_usage_context const&))
+    BOOST_DELETED_FUNCTION(disk_usage_context& operator=(disk_usage_context const&))
+
+public:
+    disk_usage_info const& info() const BOOST_NOEXCEPT { return m_info; }
+    system::error_code const& error() const BOOST_NOEXCEPT { return m_error; }
+    path const& error_path() const BOOST_NOEXCEPT { return m_error_path; }
+
+    //! Accounts the root of the tree. Must be called before the walk.
+    void add_root(file_attributes const& attrs)
+    {
+        disk_usage_info info;
+        std::vector< linked_file > linked;
+        add(attrs, info, linked);
+        merge(info, linked);
+    }
+
+    //! Walker batch handler
+    static bool on_batch(void* context, std::vector< directory_entry >& batch)
+    {
+        return static_cast< disk_usage_context* >(context)->add_batch(batch);
+    }
+
+private:
+    bool add_batch(std::vector< directory_entry >& batch) BOOST_NOEXCEPT
+    {
+        system::error_code ec;
+        path const* failed = NULL;
+        disk_usage_info info;
+        std::vector< linked_file > linked;
+        try
+        {
+            // All entries of the batch belong to the same directory, query them relative to it to avoid resolving the whole path for every file
+#if defined(BOOST_POSIX_API) && !defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+            directory_handle dir;
+#else
+            directory_handle dir(batch.front().path().parent_path(), ec);
+#endif
+            for (std::size_t i = 0u, n = batch.size(); i < n; ++i)
+            {
+                path const& p = batch[i].path();
+                file_attributes attrs = dir.is_open() ? dir.query(p.filename(), static_cast< BOOST_SCOPED_ENUM_NATIVE(file_attribute_mask) >(query_mask), ec) :
+                    detail::query(p, query_mask, &ec);
+                if (BOOST_UNLIKELY(!!ec))
+                {
+                    // The file may have been removed since the directory was read
+                    if (ec == system::errc::no_such_file_or_directory)
+                        continue;
+
+                    failed = &p;
+                    goto fail;
+                }
+
+                add(attrs, info, linked);
+            }
+
+            merge(info, linked);
+        }
+        catch (std::bad_alloc&)
+        {
+            ec = make_error_code(system::errc::not_enough_memory);
+            failed = &batch.front().path();
+            goto fail;
+        }
+
+        return true;
+
+    fail:
+        set_error(ec, *failed);
+        return false;
+    }
+
+    //! Accounts a single file in \a info, deferring the files with multiple hard links to \a linked
+    void add(file_attributes const& attrs, disk_usage_info& info, std::vector< linked_file >& linked) const
+    {
+        const unsigned int mask = static_cast< unsigned int >(attrs.mask);
+        const uintmax_t allocated_size = (mask & static_cast< unsigned int >(file_attribute_mask::allocated_size)) != 0u ? attrs.allocated_size : static_cast< uintmax_t >(0u);
+        if (attrs.status.type() == directory_file)
+        {
+            ++info.directory_count;
+            info.allocated_size += allocated_size;
+            return;
+        }
+
+        const uintmax_t apparent_size = (mask & static_cast< unsigned int >(file_attribute_mask::size)) != 0u ? attrs.size : static_cast< uintmax_t >(0u);
+        if (!m_count_hard_links && attrs.hard_link_count > 1u &&
+            (mask & static_cast< unsigned int >(file_attribute_mask::inode)) != 0u &&
+            (mask & static_cast< unsigned int >(file_attribute_mask::device)) != 0u)
+        {
+            linked_file file;
+            file.id = std::pair< uintmax_t, uintmax_t >(attrs.device, attrs.inode);
+            file.apparent_size = apparent_size;
+            file.allocated_size = allocated_size;
+            linked.push_back(file);
+            return;
+        }
+
+        ++info.file_count;
+        info.apparent_size += apparent_size;
+        info.allocated_size += allocated_size;
+    }
+
+    //! Adds the results of a batch to the totals
+    void merge(disk_usage_info const& info, std::vector< linked_file > const& linked)
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        m_info.apparent_size += info.apparent_size;
+        m_info.allocated_size += info.allocated_size;
+        m_info.file_count += info.file_count;
+        m_info.directory_count += info.directory_count;
+
+        for (std::size_t i = 0u, n = linked.size(); i < n; ++i)
+        {
+            linked_file const& file = linked[i];
+            if (m_linked_files.insert(file.id).second)
+            {
+                ++m_info.file_count;
+                m_info.apparent_size += file.apparent_size;
+                m_info.allocated_size += file.allocated_size;
+            }
+        }
+    }
+
+    void set_error(system::error_code const& err, path const& p) BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        if (!m_error)
+        {
+            m_error = err;
+            try
+            {
+                m_error_path = p;
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+};
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL
+void parallel_walk(path const& root, parallel_walk_params const& params, parallel_walk_handler* handler, void* context, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    walk_context ctx(params, handler, context);
+    system::error_code err;
+    path err_path;
+
+    if ((params.options & static_cast< unsigned int >(directory_options::_detail_same_filesystem)) != 0u)
+    {
+        ctx.root_device = detail::identity(root, &err).device;
+        if (BOOST_UNLIKELY(!!err))
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::parallel_directory_walker::walk", root, err));
+            *ec = err;
+            return;
+        }
+    }
+
+    try
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        executor* ex = params.exec ? params.exec : filesystem::get_executor();
+        const unsigned int thread_count = get_thread_count(params.thread_count, ex);
+        if (thread_count > 1u)
+        {
+            parallel_walk_scheduler< walk_worker > sched(ctx, thread_count);
+            sched.add_root(root);
+            run_in_threads(thread_count, sched, ex);
+            err = sched.error();
+            err_path = sched.error_path();
+        }
+        else
+#endif
+        {
+            sequential_walk(ctx, root, err, err_path);
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return;
+    }
+
+    if (BOOST_UNLIKELY(!!err))
+    {
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::parallel_directory_walker::walk", err_path, err));
+        *ec = err;
+    }
+}
+
+BOOST_FILESYSTEM_DECL
+void parallel_copy(path const& from, path const& to, unsigned int options, unsigned int thread_count, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    system::error_code local_ec;
+    file_status from_stat = detail::status(from, &local_ec);
+    if (!filesystem::is_directory(from_stat))
+    {
+        // Non-directories are copied as usual, this also reports errors for non-existing files
+        detail::copy(from, to, options, ec);
+        return;
+    }
+
+    // Create the target directory
+    detail::copy(from, to, (options & ~static_cast< unsigned int >(copy_options::recursive)) | static_cast< unsigned int >(copy_options::_detail_recursing), ec);
+    if (ec && *ec)
+        return;
+
+    parallel_walk_params params;
+    params.thread_count = thread_count;
+    params.batch_size = parallel_directory_walker::default_batch_size;
+    params.options = static_cast< unsigned int >(directory_options::none);
+    params.exec = NULL;
+    // Symlinks to directories are copied as directories, unless symlinks are copied or skipped
+    if ((options & (static_cast< unsigned int >(copy_options::copy_symlinks) | static_cast< unsigned int >(copy_options::skip_symlinks) |
+        static_cast< unsigned int >(copy_options::create_symlinks))) == 0u)
+    {
+        params.options |= static_cast< unsigned int >(directory_options::follow_directory_symlink);
+    }
+
+    parallel_copy_context ctx(from, to, options);
+    detail::parallel_walk(from, params, &parallel_copy_context::on_batch, &ctx, ec);
+    if (ec && *ec)
+        return;
+
+    if (BOOST_UNLIKELY(!!ctx.error()))
+    {
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::parallel_copy", ctx.error_path1(), ctx.error_path2(), ctx.error()));
+        *ec = ctx.error();
+    }
+}
+
+BOOST_FILESYSTEM_DECL
+uintmax_t link_tree(path const& from, path const& to, unsigned int mode, unsigned int thread_count, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    const bool symlinks = mode == static_cast< unsigned int >(link_tree_mode::symlinks);
+
+    // Symlinks are created with absolute targets, so that they don't depend on the location of the target tree
+    system::error_code local_ec;
+    path source(from);
+    if (symlinks)
+    {
+        source = detail::absolute(from, path(), &local_ec);
+        if (BOOST_UNLIKELY(!!local_ec))
+        {
+        fail:
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::link_tree", from, to, local_ec));
+
+            *ec = local_ec;
+            return 0u;
+        }
+    }
+
+    file_status from_stat = detail::status(source, &local_ec);
+    if (!filesystem::is_directory(from_stat))
+    {
+        // Non-directories are linked as a single file, this also reports errors for non-existing files
+        if (symlinks)
+            detail::create_symlink(source, to, &local_ec);
+        else
+            detail::create_hard_link(source, to, &local_ec);
+        if (BOOST_UNLIKELY(!!local_ec))
+            goto fail;
+
+        return 1u;
+    }
+
+    detail::create_directory(to, &source, &local_ec);
+    if (BOOST_UNLIKELY(!!local_ec))
+        goto fail;
+
+    parallel_walk_params params;
+    params.thread_count = thread_count;
+    params.batch_size = parallel_directory_walker::default_batch_size;
+    params.options = static_cast< unsigned int >(directory_options::none);
+    params.exec = NULL;
+
+    link_tree_context ctx(source, to, symlinks);
+    detail::parallel_walk(source, params, &link_tree_context::on_batch, &ctx, ec);
+    if (ec && *ec)
+        return ctx.count();
+
+    if (BOOST_UNLIKELY(!!ctx.error()))
+    {
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::link_tree", ctx.error_path1(), ctx.error_path2(), ctx.error()));
+        *ec = ctx.error();
+    }
+
+    return ctx.count();
+}
+
+BOOST_FILESYSTEM_DECL
+disk_usage_info disk_usage(path const& p, unsigned int options, unsigned int thread_count, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    // Follow the symlink to the root directory, like directory_iterator does
+    system::error_code local_ec;
+    file_attributes root_attrs = detail::query(p, static_cast< unsigned int >(file_attribute_mask::type), &local_ec);
+    if (BOOST_UNLIKELY(!!local_ec))
+    {
+    fail:
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::disk_usage", p, local_ec));
+
+        *ec = local_ec;
+        return disk_usage_info();
+    }
+
+    const bool is_dir = root_attrs.status.type() == directory_file;
+    unsigned int root_mask = static_cast< unsigned int >(file_attribute_mask::type) | static_cast< unsigned int >(file_attribute_mask::size) |
+        static_cast< unsigned int >(file_attribute_mask::allocated_size);
+    if (!is_dir)
+        root_mask |= static_cast< unsigned int >(file_attribute_mask::no_follow);
+    root_attrs = detail::query(p, root_mask, &local_ec);
+    if (BOOST_UNLIKELY(!!local_ec))
+        goto fail;
+
+    disk_usage_context ctx(options);
+    ctx.add_root(root_attrs);
+    if (!is_dir)
+        return ctx.info();
+
+    parallel_walk_params params;
+    params.thread_count = thread_count;
+    params.batch_size = parallel_directory_walker::default_batch_size;
+    params.options = static_cast< unsigned int >(directory_options::none);
+    params.exec = NULL;
+    if ((options & static_cast< unsigned int >(disk_usage_options::skip_permission_denied)) != 0u)
+        params.options |= static_cast< unsigned int >(directory_options::skip_permission_denied);
+
+    detail::parallel_walk(p, params, &disk_usage_context::on_batch, &ctx, ec);
+    if (ec && *ec)
+        return disk_usage_info();
+
+    if (BOOST_UNLIKELY(!!ctx.error()))
+    {
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::disk_usage", ctx.error_path(), ctx.error()));
+        *ec = ctx.error();
+        return disk_usage_info();
+    }
+
+    return ctx.info();
+}
+
+BOOST_FILESYSTEM_DECL
+path rename_for_removal(path const& p, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    path const filename = p.filename();
+    if (BOOST_UNLIKELY(filename.empty() || filename.filename_is_dot() || filename.filename_is_dot_dot()))
+    {
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove_all_async", p, system::errc::make_error_code(system::errc::invalid_argument)));
+
+        *ec = system::errc::make_error_code(system::errc::invalid_argument);
+        return path();
+    }
+
+    // The tombstone is a hidden sibling of the original file, so that renaming it doesn't move data between filesystems
+    path tombstone_name(".");
+    tombstone_name += filename;
+    tombstone_name += ".removing-%%%%-%%%%-%%%%-%%%%";
+    path tombstone = p.parent_path();
+    tombstone /= detail::unique_path(tombstone_name, ec);
+    if (ec && *ec)
+        return path();
+
+    system::error_code local_ec;
+    detail::rename(p, tombstone, &local_ec);
+    if (BOOST_UNLIKELY(!!local_ec))
+    {
+        // Nothing to remove
+        if (local_ec == system::errc::no_such_file_or_directory)
+            return path();
+
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::remove_all_async", p, tombstone, local_ec));
+
+        *ec = local_ec;
+        return path();
+    }
+
+    return tombstone;
+}
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
@@ -12,10 +12,17 @@
 
 #include <boost/filesystem/config.hpp>
 #include <boost/filesystem/path.hpp>
+#include <boost/filesystem/path_view.hpp>
+#include <boost/filesystem/static_path.hpp>
+#include <boost/filesystem/path_arena.hpp>
+#include <boost/filesystem/path_key.hpp>
+#include <boost/filesystem/memory_allocator.hpp>
 #include <boost/filesystem/detail/path_traits.hpp> // codecvt_error_category()
+#include <boost/cstdint.hpp>
 #include <boost/scoped_array.hpp>
 #include <boost/system/error_category.hpp> // for BOOST_SYSTEM_HAS_CONSTEXPR
 #include <boost/assert.hpp>
+#include <boost/type_traits/alignment_of.hpp>
 #include <algorithm>
 #include <iterator>
 #include <utility>
@@ -23,6 +30,7 @@
 #include <cstddef>
 #include <cstring>
 #include <cstdlib> // std::atexit
+#include <new>
 
 #ifdef BOOST_WINDOWS_API
 #include "windows_file_codecvt.hpp"
@@ -66,7 +74,6 @@ using boost::filesystem::path_detail::substring;
 
 const wchar_t dot_path_literal[] = L".";
 const wchar_t dot_dot_path_literal[] = L"..";
-const wchar_t separators[] = L"/\\";
 using boost::filesystem::detail::colon;
 using boost::filesystem::detail::questionmark;
 
@@ -104,11 +111,36 @@ inline size_type find_separator(const wchar_t* p, size_type size) BOOST_NOEXCEPT
     return pos;
 }
 
+//! Returns position of the last directory separator in the \a size initial characters of \a p, or \a size if not found
+inline size_type rfind_separator(const wchar_t* p, size_type size) BOOST_NOEXCEPT
+{
+    size_type pos = size;
+    while (pos > 0u)
+    {
+        --pos;
+        if (boost::filesystem::detail::is_directory_separator(p[pos]))
+            return pos;
+    }
+    return size;
+}
+
+//! Returns position of the last dot in the \a size initial characters of \a p, or \a size if not found
+inline size_type rfind_dot(const wchar_t* p, size_type size) BOOST_NOEXCEPT
+{
+    size_type pos = size;
+    while (pos > 0u)
+    {
+        --pos;
+        if (p[pos] == L'.')
+            return pos;
+    }
+    return size;
+}
+
 #else // BOOST_WINDOWS_API
 
 const char dot_path_literal[] = ".";
 const char dot_dot_path_literal[] = "..";
-const char separators[] = "/";
 
 //! Returns position of the first directory separator in the \a size initial characters of \a p, or \a size if not found
 inline size_type find_separator(const char* p, size_type size) BOOST_NOEXCEPT
@@ -120,27 +152,122 @@ inline size_type find_separator(const char* p, size_type size) BOOST_NOEXCEPT
     return pos;
 }
 
+//! Returns position of the last occurrence of \a c in the \a size initial characters of \a p, or \a size if not found
+inline size_type rfind_char(const char* p, size_type size, char c) BOOST_NOEXCEPT
+{
+#if defined(BOOST_FILESYSTEM_HAS_MEMRCHR)
+    // memrchr is typically vectorized in the C library, with the implementation selected at run time based on CPU features
+    const char* found = static_cast< const char* >(memrchr(p, c, size));
+    if (found)
+        return found - p;
+#else
+    size_type pos = size;
+    while (pos > 0u)
+    {
+        --pos;
+        if (p[pos] == c)
+            return pos;
+    }
+#endif
+    return size;
+}
+
+//! Returns position of the last directory separator in the \a size initial characters of \a p, or \a size if not found
+inline size_type rfind_separator(const char* p, size_type size) BOOST_NOEXCEPT
+{
+    return rfind_char(p, size, '/');
+}
+
+//! Returns position of the last dot in the \a size initial characters of \a p, or \a size if not found
+inline size_type rfind_dot(const char* p, size_type size) BOOST_NOEXCEPT
+{
+    return rfind_char(p, size, '.');
+}
+
 #endif // BOOST_WINDOWS_API
 
 // pos is position of the separator
-bool is_root_separator(string_type const& str, size_type root_dir_pos, size_type pos);
+bool is_root_separator(const value_type* str, size_type root_dir_pos, size_type pos);
 
 // Returns: Size of the filename element that ends at end_pos (which is past-the-end position). 0 if no filename found.
-size_type find_filename_size(string_type const& str, size_type root_name_size, size_type end_pos);
+size_type find_filename_size(const value_type* str, size_type root_name_size, size_type end_pos);
 
 // Returns: starting position of root directory or size if not found. Sets root_name_size to length
 // of the root name if the characters before the returned position (if any) are considered a root name.
 size_type find_root_directory_start(const value_type* path, size_type size, size_type& root_name_size);
 
-// Finds position and size of the first element of the path
-void first_element(string_type const& src, size_type& element_pos, size_type& element_size, size_type size);
+// Finds position and size of the first element of the path. Returns true if the element is the root directory.
+bool first_element(const value_type* src, size_type size, size_type& element_pos, size_type& element_size);
 
-// Finds position and size of the first element of the path
-inline void first_element(string_type const& src, size_type& element_pos, size_type& element_size)
+//! Returns true if the path element is a dot
+inline bool is_dot_element(fs::path_view const& elem)
 {
-    first_element(src, element_pos, element_size, src.size());
+    return elem.size() == 1u && elem.data()[0] == path::dot;
 }
 
+//! Returns true if the path element is a dot dot
+inline bool is_dot_dot_element(fs::path_view const& elem)
+{
+    return elem.size() == 2u && elem.data()[0] == path::dot && elem.data()[1] == path::dot;
+}
+
+//! Path decomposition algorithms, shared between path and path_view
+namespace path_algorithms {
+
+size_type find_root_name_size(const value_type* p, size_type size);
+size_type find_root_path_size(const value_type* p, size_type size);
+substring find_root_directory(const value_type* p, size_type size);
+substring find_relative_path(const value_type* p, size_type size);
+size_type find_parent_path_size(const value_type* p, size_type size);
+size_type find_filename_v4_size(const value_type* p, size_type size);
+size_type find_extension_v4_size(const value_type* p, size_type size);
+
+/*!
+ * Writes the v4 normal form of the path to \a normal, which must have room for \a size characters and
+ * may point to the same storage as \a p. Returns the size of the normal form.
+ */
+size_type lexically_normal_v4(const value_type* p, size_type size, value_type* normal);
+
+//! Kinds of path elements produced by iteration
+enum element_kind
+{
+    //! The element is the substring of the path at the iteration position
+    regular_element,
+    //! The element is the root directory, which is presented in the generic format
+    root_directory_element,
+    //! The element is the dot that is presented in place of a trailing separator in v3
+    trailing_dot_element
+};
+
+//! Returns the kind of the first element of the path and sets its position and size
+element_kind first_element_kind(const value_type* p, size_type size, size_type& pos, size_type& element_size);
+
+/*!
+ * Advances the v3 path iterator state to the next element. \a element_size is the size of the current element
+ * on input and the size of the next element on output. Returns the kind of the next element.
+ */
+element_kind increment_v3(const value_type* p, size_type size, size_type& pos, size_type& element_size);
+
+/*!
+ * Advances the v4 path iterator state to the next element. \a element_size is the size of the current element
+ * on input and the size of the next element on output. Returns the kind of the next element.
+ */
+element_kind increment_v4(const value_type* p, size_type size, size_type& pos, size_type& element_size);
+
+//! Moves the v4 path iterator state to the previous element. Returns the kind of the previous element.
+element_kind decrement_v4(const value_type* p, size_type size, size_type& pos, size_type& element_size);
+
+//! Returns pointer to the characters of the element at the given position
+const value_type* element_data(const value_type* p, size_type pos, element_kind kind);
+
+//! Compares paths element-wise, using v3 iteration semantics
+int compare_v3(const value_type* p1, size_type size1, const value_type* p2, size_type size2);
+
+//! Compares paths element-wise, using v4 iteration semantics
+int compare_v4(const value_type* p1, size_type size1, const value_type* p2, size_type size2);
+
+} // namespace path_algorithms
+
 } // unnamed namespace
 
 //--------------------------------------------------------------------------------------//
@@ -231,6 +358,100 @@ BOOST_FILESYSTEM_DECL void path::append_v4(const value_type* begin, const value_
     }
 }
 
+BOOST_FILESYSTEM_DECL void path::replace_filename_v3(const value_type* begin, const value_type* end)
+{
+    if (BOOST_LIKELY(begin < m_pathname.data() || begin >= (m_pathname.data() + m_pathname.size())))
+    {
+        remove_filename();
+        append_v3(begin, end);
+    }
+    else
+    {
+        // overlapping source
+        string_type replacement(begin, end);
+        replace_filename_v3(replacement.data(), replacement.data() + replacement.size());
+    }
+}
+
+BOOST_FILESYSTEM_DECL void path::replace_filename_v4(const value_type* begin, const value_type* end)
+{
+    if (BOOST_LIKELY(begin < m_pathname.data() || begin >= (m_pathname.data() + m_pathname.size())))
+    {
+        m_pathname.erase(m_pathname.size() - find_filename_v4_size());
+
+        // The replacement is typically a plain filename, e.g. when produced by directory iteration.
+        // In this case there is no need to analyze root names of the paths.
+        bool is_plain_filename = begin != end && !detail::is_directory_separator(*begin);
+#if defined(BOOST_WINDOWS_API)
+        if (is_plain_filename)
+        {
+            size_type root_name_size = 0;
+            find_root_directory_start(begin, end - begin, root_name_size);
+            is_plain_filename = root_name_size == 0u;
+        }
+#endif
+
+        if (BOOST_LIKELY(is_plain_filename))
+        {
+            append_separator_if_needed();
+            m_pathname.append(begin, end);
+        }
+        else
+        {
+            append_v4(begin, end);
+        }
+    }
+    else
+    {
+        // overlapping source
+        string_type replacement(begin, end);
+        replace_filename_v4(replacement.data(), replacement.data() + replacement.size());
+    }
+}
+
+BOOST_FILESYSTEM_DECL void path::join_v3(path& result, const path* const* parts, std::size_t count)
+{
+    size_type size = 0u;
+    for (std::size_t i = 0u; i < count; ++i)
+        size += parts[i]->m_pathname.size() + 1u;
+
+    result.m_pathname.reserve(size);
+    result.m_pathname.assign(parts[0]->m_pathname);
+    for (std::size_t i = 1u; i < count; ++i)
+        result.append_v3(parts[i]->m_pathname.data(), parts[i]->m_pathname.data() + parts[i]->m_pathname.size());
+}
+
+BOOST_FILESYSTEM_DECL void path::join_v4(path& result, const path* const* parts, std::size_t count)
+{
+    // Appending an absolute path replaces the result, so the parts before the last absolute part need not be appended
+    std::size_t first = count - 1u;
+    for (; first > 0u; --first)
+    {
+        string_type const& part = parts[first]->m_pathname;
+        size_type root_name_size = 0;
+        size_type root_dir_pos = find_root_directory_start(part.c_str(), part.size(), root_name_size);
+        if
+        (
+#if defined(BOOST_WINDOWS_API) && !defined(UNDER_CE)
+            root_name_size > 0 &&
+#endif
+            root_dir_pos < part.size()
+        )
+        {
+            break;
+        }
+    }
+
+    size_type size = 0u;
+    for (std::size_t i = first; i < count; ++i)
+        size += parts[i]->m_pathname.size() + 1u;
+
+    result.m_pathname.reserve(size);
+    result.m_pathname.assign(parts[first]->m_pathname);
+    for (std::size_t i = first + 1u; i < count; ++i)
+        result.append_v4(parts[i]->m_pathname.data(), parts[i]->m_pathname.data() + parts[i]->m_pathname.size());
+}
+
 #ifdef BOOST_WINDOWS_API
 
 BOOST_FILESYSTEM_DECL path path::generic_path() const
@@ -244,12 +465,12 @@ BOOST_FILESYSTEM_DECL path path::generic_path() const
 
 BOOST_FILESYSTEM_DECL int path::compare_v3(path const& p) const
 {
-    return detail::lex_compare_v3(begin(), end(), p.begin(), p.end());
+    return path_algorithms::compare_v3(m_pathname.c_str(), m_pathname.size(), p.m_pathname.c_str(), p.m_pathname.size());
 }
 
 BOOST_FILESYSTEM_DECL int path::compare_v4(path const& p) const
 {
-    return detail::lex_compare_v4(begin(), end(), p.begin(), p.end());
+    return path_algorithms::compare_v4(m_pathname.c_str(), m_pathname.size(), p.m_pathname.c_str(), p.m_pathname.size());
 }
 
 //  append_separator_if_needed  ----------------------------------------------------//
@@ -343,92 +564,27 @@ BOOST_FILESYSTEM_DECL void path::replace_extension_v4(path const& new_extension)
 
 BOOST_FILESYSTEM_DECL size_type path::find_root_name_size() const
 {
-    size_type root_name_size = 0;
-    find_root_directory_start(m_pathname.c_str(), m_pathname.size(), root_name_size);
-    return root_name_size;
+    return path_algorithms::find_root_name_size(m_pathname.c_str(), m_pathname.size());
 }
 
 BOOST_FILESYSTEM_DECL size_type path::find_root_path_size() const
 {
-    size_type root_name_size = 0;
-    size_type root_dir_pos = find_root_directory_start(m_pathname.c_str(), m_pathname.size(), root_name_size);
-
-    size_type size = root_name_size;
-    if (root_dir_pos < m_pathname.size())
-        size = root_dir_pos + 1;
-
-    return size;
+    return path_algorithms::find_root_path_size(m_pathname.c_str(), m_pathname.size());
 }
 
 BOOST_FILESYSTEM_DECL substring path::find_root_directory() const
 {
-    substring root_dir;
-    size_type root_name_size = 0;
-    root_dir.pos = find_root_directory_start(m_pathname.c_str(), m_pathname.size(), root_name_size);
-    root_dir.size = static_cast< std::size_t >(root_dir.pos < m_pathname.size());
-    return root_dir;
+    return path_algorithms::find_root_directory(m_pathname.c_str(), m_pathname.size());
 }
 
 BOOST_FILESYSTEM_DECL substring path::find_relative_path() const
 {
-    size_type root_name_size = 0;
-    size_type root_dir_pos = find_root_directory_start(m_pathname.c_str(), m_pathname.size(), root_name_size);
-
-    // Skip root name, root directory and any duplicate separators
-    size_type size = root_name_size;
-    if (root_dir_pos < m_pathname.size())
-    {
-        size = root_dir_pos + 1;
-
-        for (size_type n = m_pathname.size(); size < n; ++size)
-        {
-            if (!detail::is_directory_separator(m_pathname[size]))
-                break;
-        }
-    }
-
-    substring rel_path;
-    rel_path.pos = size;
-    rel_path.size = m_pathname.size() - size;
-
-    return rel_path;
+    return path_algorithms::find_relative_path(m_pathname.c_str(), m_pathname.size());
 }
 
 BOOST_FILESYSTEM_DECL string_type::size_type path::find_parent_path_size() const
 {
-    const size_type size = m_pathname.size();
-    size_type root_name_size = 0;
-    size_type root_dir_pos = find_root_directory_start(m_pathname.c_str(), size, root_name_size);
-
-    size_type filename_size = find_filename_size(m_pathname, root_name_size, size);
-    size_type end_pos = size - filename_size;
-    while (true)
-    {
-        if (end_pos <= root_name_size)
-        {
-            // Keep the root name as the parent path if there was a filename
-            if (filename_size == 0)
-                end_pos = 0u;
-            break;
-        }
-
-        --end_pos;
-
-        if (!detail::is_directory_separator(m_pathname[end_pos]))
-        {
-            ++end_pos;
-            break;
-        }
-
-        if (end_pos == root_dir_pos)
-        {
-            // Keep the trailing root directory if there was a filename
-            end_pos += filename_size > 0;
-            break;
-        }
-    }
-
-    return end_pos;
+    return path_algorithms::find_parent_path_size(m_pathname.c_str(), m_pathname.size());
 }
 
 BOOST_FILESYSTEM_DECL path path::filename_v3() const
@@ -437,7 +593,7 @@ BOOST_FILESYSTEM_DECL path path::filename_v3() const
     size_type root_name_size = 0;
     size_type root_dir_pos = find_root_directory_start(m_pathname.c_str(), size, root_name_size);
     size_type filename_size, pos;
-    if (root_dir_pos < size && detail::is_directory_separator(m_pathname[size - 1]) && is_root_separator(m_pathname, root_dir_pos, size - 1))
+    if (root_dir_pos < size && detail::is_directory_separator(m_pathname[size - 1]) && is_root_separator(m_pathname.c_str(), root_dir_pos, size - 1))
     {
         // Return root directory
         pos = root_dir_pos;
@@ -451,9 +607,9 @@ BOOST_FILESYSTEM_DECL path path::filename_v3() const
     }
     else
     {
-        filename_size = find_filename_size(m_pathname, root_name_size, size);
+        filename_size = find_filename_size(m_pathname.c_str(), root_name_size, size);
         pos = size - filename_size;
-        if (filename_size == 0u && pos > root_name_size && detail::is_directory_separator(m_pathname[pos - 1]) && !is_root_separator(m_pathname, root_dir_pos, pos - 1))
+        if (filename_size == 0u && pos > root_name_size && detail::is_directory_separator(m_pathname[pos - 1]) && !is_root_separator(m_pathname.c_str(), root_dir_pos, pos - 1))
             return detail::dot_path();
     }
 
@@ -463,10 +619,7 @@ BOOST_FILESYSTEM_DECL path path::filename_v3() const
 
 BOOST_FILESYSTEM_DECL string_type::size_type path::find_filename_v4_size() const
 {
-    const size_type size = m_pathname.size();
-    size_type root_name_size = 0;
-    find_root_directory_start(m_pathname.c_str(), size, root_name_size);
-    return find_filename_size(m_pathname, root_name_size, size);
+    return path_algorithms::find_filename_v4_size(m_pathname.c_str(), m_pathname.size());
 }
 
 BOOST_FILESYSTEM_DECL path path::stem_v3() const
@@ -504,78 +657,45 @@ BOOST_FILESYSTEM_DECL path path::extension_v3() const
 
 BOOST_FILESYSTEM_DECL string_type::size_type path::find_extension_v4_size() const
 {
-    const size_type size = m_pathname.size();
-    size_type root_name_size = 0;
-    find_root_directory_start(m_pathname.c_str(), size, root_name_size);
-    size_type filename_size = find_filename_size(m_pathname, root_name_size, size);
-    size_type filename_pos = size - filename_size;
-    if
-    (
-        filename_size > 0u &&
-        // Check for "." and ".." filenames
-        !(m_pathname[filename_pos] == dot &&
-            (filename_size == 1u || (filename_size == 2u && m_pathname[filename_pos + 1u] == dot)))
-    )
-    {
-        size_type ext_pos = size;
-        while (ext_pos > filename_pos)
-        {
-            --ext_pos;
-            if (m_pathname[ext_pos] == dot)
-                break;
-        }
-
-        if (ext_pos > filename_pos)
-            return size - ext_pos;
-    }
-
-    return 0u;
+    return path_algorithms::find_extension_v4_size(m_pathname.c_str(), m_pathname.size());
 }
 
 //  lexical operations  --------------------------------------------------------------//
 
-namespace detail {
-// C++14 provides a mismatch algorithm with four iterator arguments(), but earlier
-// standard libraries didn't, so provide this needed functionality.
-inline std::pair< path::iterator, path::iterator > mismatch(path::iterator it1, path::iterator it1end, path::iterator it2, path::iterator it2end)
+BOOST_FILESYSTEM_DECL path path::lexically_relative(path const& base) const
 {
-    for (; it1 != it1end && it2 != it2end && *it1 == *it2;)
+    // Iterate over views to avoid constructing a path for every element
+    const path_view this_view(*this), base_view(base);
+    path_view::iterator b = this_view.begin(), e = this_view.end(), base_b = base_view.begin(), base_e = base_view.end();
+    path_view::iterator it1 = b, it2 = base_b;
+    for (; it1 != e && it2 != base_e && it1->compare(*it2) == 0; ++it1, ++it2)
     {
-        ++it1;
-        ++it2;
     }
-    return std::make_pair(it1, it2);
-}
-} // namespace detail
 
-BOOST_FILESYSTEM_DECL path path::lexically_relative(path const& base) const
-{
-    path::iterator b = begin(), e = end(), base_b = base.begin(), base_e = base.end();
-    std::pair< path::iterator, path::iterator > mm = detail::mismatch(b, e, base_b, base_e);
-    if (mm.first == b && mm.second == base_b)
+    if (it1 == b && it2 == base_b)
         return path();
-    if (mm.first == e && mm.second == base_e)
+    if (it1 == e && it2 == base_e)
         return detail::dot_path();
 
     std::ptrdiff_t n = 0;
-    for (; mm.second != base_e; ++mm.second)
+    for (; it2 != base_e; ++it2)
     {
-        path const& p = *mm.second;
-        if (p == detail::dot_dot_path())
+        path_view const& p = *it2;
+        if (is_dot_dot_element(p))
             --n;
-        else if (!p.empty() && p != detail::dot_path())
+        else if (!p.empty() && !is_dot_element(p))
             ++n;
     }
     if (n < 0)
         return path();
-    if (n == 0 && (mm.first == e || mm.first->empty()))
+    if (n == 0 && (it1 == e || it1->empty()))
         return detail::dot_path();
 
     path tmp;
     for (; n > 0; --n)
         tmp /= detail::dot_dot_path();
-    for (; mm.first != e; ++mm.first)
-        tmp /= *mm.first;
+    for (; it1 != e; ++it1)
+        tmp /= *it1;
     return tmp;
 }
 
@@ -637,7 +757,7 @@ BOOST_FILESYSTEM_DECL path path::lexically_normal_v3() const
                 {
                     // Don't remove previous dot dot elements
                     const size_type normal_size = normal.m_pathname.size();
-                    size_type filename_size = find_filename_size(normal.m_pathname, root_path_size, normal_size);
+                    size_type filename_size = find_filename_size(normal.m_pathname.c_str(), root_path_size, normal_size);
                     size_type pos = normal_size - filename_size;
                     if (filename_size != 2u || normal.m_pathname[pos] != dot || normal.m_pathname[pos + 1] != dot)
                     {
@@ -681,103 +801,30 @@ BOOST_FILESYSTEM_DECL path path::lexically_normal_v3() const
 
 BOOST_FILESYSTEM_DECL path path::lexically_normal_v4() const
 {
-    const value_type* const pathname = m_pathname.c_str();
-    const size_type pathname_size = m_pathname.size();
-    size_type root_name_size = 0;
-    size_type root_dir_pos = find_root_directory_start(pathname, pathname_size, root_name_size);
-    path normal(pathname, pathname + root_name_size);
-
-#if defined(BOOST_WINDOWS_API)
-    for (size_type i = 0; i < root_name_size; ++i)
-    {
-        if (normal.m_pathname[i] == path::separator)
-            normal.m_pathname[i] = path::preferred_separator;
-    }
-#endif
-
-    size_type root_path_size = root_name_size;
-    if (root_dir_pos < pathname_size)
+    path normal;
+    if (!m_pathname.empty())
     {
-        root_path_size = root_dir_pos + 1;
-        normal.m_pathname.push_back(preferred_separator);
+        // The normal form is never longer than the original path
+        normal.m_pathname.resize(m_pathname.size());
+        normal.m_pathname.resize(path_algorithms::lexically_normal_v4(m_pathname.c_str(), m_pathname.size(), &normal.m_pathname[0]));
     }
 
-    size_type i = root_path_size;
+    return normal;
+}
 
-    // Skip redundant directory separators after the root directory
-    while (i < pathname_size && detail::is_directory_separator(pathname[i]))
-        ++i;
+BOOST_FILESYSTEM_DECL void path::normalize_v3()
+{
+    path tmp(lexically_normal_v3());
+    m_pathname.swap(tmp.m_pathname);
+}
 
-    if (i < pathname_size)
+BOOST_FILESYSTEM_DECL void path::normalize_v4()
+{
+    if (!m_pathname.empty())
     {
-        while (true)
-        {
-            bool last_element_was_dot = false;
-            {
-                const size_type start_pos = i;
-
-                // Find next separator
-                i += find_separator(pathname + i, pathname_size - i);
-
-                const size_type size = i - start_pos;
-
-                // Skip dot elements
-                if (size == 1u && pathname[start_pos] == dot)
-                {
-                    last_element_was_dot = true;
-                    goto skip_append;
-                }
-
-                // Process dot dot elements
-                if (size == 2u && pathname[start_pos] == dot && pathname[start_pos + 1] == dot && normal.m_pathname.size() > root_path_size)
-                {
-                    // Don't remove previous dot dot elements
-                    const size_type normal_size = normal.m_pathname.size();
-                    size_type filename_size = find_filename_size(normal.m_pathname, root_path_size, normal_size);
-                    size_type pos = normal_size - filename_size;
-                    if (filename_size != 2u || normal.m_pathname[pos] != dot || normal.m_pathname[pos + 1] != dot)
-                    {
-                        if (pos > root_path_size && detail::is_directory_separator(normal.m_pathname[pos - 1]))
-                            --pos;
-                        normal.m_pathname.erase(normal.m_pathname.begin() + pos, normal.m_pathname.end());
-                        goto skip_append;
-                    }
-                }
-
-                // Append the element
-                normal.append_separator_if_needed();
-                normal.m_pathname.append(pathname + start_pos, size);
-            }
-
-        skip_append:
-            if (i == pathname_size)
-            {
-                // If a path ends with a trailing dot after a directory element, add a trailing separator
-                if (last_element_was_dot && !normal.empty() && !normal.filename_is_dot_dot())
-                    normal.append_separator_if_needed();
-
-                break;
-            }
-
-            // Skip directory separators, including duplicates
-            while (i < pathname_size && detail::is_directory_separator(pathname[i]))
-                ++i;
-
-            if (i == pathname_size)
-            {
-                // If a path ends with a separator, add a trailing separator
-                if (!normal.empty() && !normal.filename_is_dot_dot())
-                    normal.append_separator_if_needed();
-                break;
-            }
-        }
-
-        // If the original path was not empty and normalized ended up being empty, make it a dot
-        if (normal.empty())
-            normal.m_pathname.push_back(dot);
+        value_type* const p = &m_pathname[0];
+        m_pathname.resize(path_algorithms::lexically_normal_v4(p, m_pathname.size(), p));
     }
-
-    return normal;
 }
 
 } // namespace filesystem
@@ -794,9 +841,9 @@ namespace {
 //  is_root_separator  ---------------------------------------------------------------//
 
 // pos is position of the separator
-inline bool is_root_separator(string_type const& str, size_type root_dir_pos, size_type pos)
+inline bool is_root_separator(const value_type* str, size_type root_dir_pos, size_type pos)
 {
-    BOOST_ASSERT_MSG(pos < str.size() && fs::detail::is_directory_separator(str[pos]), "precondition violation");
+    BOOST_ASSERT_MSG(fs::detail::is_directory_separator(str[pos]), "precondition violation");
 
     // root_dir_pos points at the leftmost separator, we need to skip any duplicate separators right of root dir
     while (pos > root_dir_pos && fs::detail::is_directory_separator(str[pos - 1]))
@@ -808,21 +855,19 @@ inline bool is_root_separator(string_type const& str, size_type root_dir_pos, si
 //  find_filename_size  --------------------------------------------------------------//
 
 // Returns: Size of the filename element that ends at end_pos (which is past-the-end position). 0 if no filename found.
-inline size_type find_filename_size(string_type const& str, size_type root_name_size, size_type end_pos)
+inline size_type find_filename_size(const value_type* str, size_type root_name_size, size_type end_pos)
 {
-    size_type pos = end_pos;
-    while (pos > root_name_size)
-    {
-        --pos;
+    if (end_pos <= root_name_size)
+        return 0u;
 
-        if (fs::detail::is_directory_separator(str[pos]))
-        {
-            ++pos; // filename starts past the separator
-            break;
-        }
-    }
+    const size_type size = end_pos - root_name_size;
+    size_type pos = rfind_separator(str + root_name_size, size);
+    if (pos < size)
+        ++pos; // filename starts past the separator
+    else
+        pos = 0u;
 
-    return end_pos - pos;
+    return size - pos;
 }
 
 //  find_root_directory_start  -------------------------------------------------------//
@@ -925,37 +970,735 @@ find_next_separator:
 //  first_element --------------------------------------------------------------------//
 
 //   sets pos and len of first element, excluding extra separators
-//   if src.empty(), sets pos,len, to 0,0.
-void first_element(string_type const& src, size_type& element_pos, size_type& element_size, size_type size)
+//   if src is empty, sets pos,len, to 0,0.
+bool first_element(const value_type* src, size_type size, size_type& element_pos, size_type& element_size)
 {
     element_pos = 0;
     element_size = 0;
-    if (src.empty())
-        return;
+    if (size == 0)
+        return false;
 
     size_type root_name_size = 0;
-    size_type root_dir_pos = find_root_directory_start(src.c_str(), size, root_name_size);
+    size_type root_dir_pos = find_root_directory_start(src, size, root_name_size);
 
     // First element is the root name, if there is one
     if (root_name_size > 0)
     {
         element_size = root_name_size;
-        return;
+        return false;
+    }
+
+    // Otherwise, the root directory
+    if (root_dir_pos < size)
+    {
+        element_pos = root_dir_pos;
+        element_size = 1u;
+        return true;
+    }
+
+    // Otherwise, the first filename or directory name in a relative path
+    element_size = find_separator(src, size);
+    return false;
+}
+
+namespace path_algorithms {
+
+//  decomposition  -------------------------------------------------------------------//
+
+size_type find_root_name_size(const value_type* p, size_type size)
+{
+    size_type root_name_size = 0;
+    find_root_directory_start(p, size, root_name_size);
+    return root_name_size;
+}
+
+size_type find_root_path_size(const value_type* p, size_type size)
+{
+    size_type root_name_size = 0;
+    size_type root_dir_pos = find_root_directory_start(p, size, root_name_size);
+
+    size_type root_path_size = root_name_size;
+    if (root_dir_pos < size)
+        root_path_size = root_dir_pos + 1;
+
+    return root_path_size;
+}
+
+substring find_root_directory(const value_type* p, size_type size)
+{
+    substring root_dir;
+    size_type root_name_size = 0;
+    root_dir.pos = find_root_directory_start(p, size, root_name_size);
+    root_dir.size = static_cast< std::size_t >(root_dir.pos < size);
+    return root_dir;
+}
+
+substring find_relative_path(const value_type* p, size_type size)
+{
+    size_type root_name_size = 0;
+    size_type root_dir_pos = find_root_directory_start(p, size, root_name_size);
+
+    // Skip root name, root directory and any duplicate separators
+    size_type pos = root_name_size;
+    if (root_dir_pos < size)
+    {
+        pos = root_dir_pos + 1;
+
+        for (; pos < size; ++pos)
+        {
+            if (!fs::detail::is_directory_separator(p[pos]))
+                break;
+        }
+    }
+
+    substring rel_path;
+    rel_path.pos = pos;
+    rel_path.size = size - pos;
+
+    return rel_path;
+}
+
+size_type find_parent_path_size(const value_type* p, size_type size)
+{
+    size_type root_name_size = 0;
+    size_type root_dir_pos = find_root_directory_start(p, size, root_name_size);
+
+    size_type filename_size = find_filename_size(p, root_name_size, size);
+    size_type end_pos = size - filename_size;
+    while (true)
+    {
+        if (end_pos <= root_name_size)
+        {
+            // Keep the root name as the parent path if there was a filename
+            if (filename_size == 0)
+                end_pos = 0u;
+            break;
+        }
+
+        --end_pos;
+
+        if (!fs::detail::is_directory_separator(p[end_pos]))
+        {
+            ++end_pos;
+            break;
+        }
+
+        if (end_pos == root_dir_pos)
+        {
+            // Keep the trailing root directory if there was a filename
+            end_pos += filename_size > 0;
+            break;
+        }
+    }
+
+    return end_pos;
+}
+
+size_type find_filename_v4_size(const value_type* p, size_type size)
+{
+    size_type root_name_size = 0;
+    find_root_directory_start(p, size, root_name_size);
+    return find_filename_size(p, root_name_size, size);
+}
+
+size_type find_extension_v4_size(const value_type* p, size_type size)
+{
+    size_type root_name_size = 0;
+    find_root_directory_start(p, size, root_name_size);
+    size_type filename_size = find_filename_size(p, root_name_size, size);
+    size_type filename_pos = size - filename_size;
+    if
+    (
+        filename_size > 0u &&
+        // Check for "." and ".." filenames
+        !(p[filename_pos] == path::dot &&
+            (filename_size == 1u || (filename_size == 2u && p[filename_pos + 1u] == path::dot)))
+    )
+    {
+        // A dot at the start of the filename does not start an extension
+        const size_type ext_pos = rfind_dot(p + filename_pos + 1u, filename_size - 1u);
+        if (ext_pos < filename_size - 1u)
+            return filename_size - 1u - ext_pos;
+    }
+
+    return 0u;
+}
+
+//  normal  --------------------------------------------------------------------------//
+
+//! Returns true if a directory separator must be inserted before appending an element to the normalized path
+inline bool is_separator_needed(const value_type* normal, size_type normal_size)
+{
+    return normal_size > 0u &&
+#ifdef BOOST_WINDOWS_API
+        normal[normal_size - 1u] != colon &&
+#endif
+        !fs::detail::is_directory_separator(normal[normal_size - 1u]);
+}
+
+//! Returns true if the last element of the normalized path is a dot dot
+inline bool is_filename_dot_dot(const value_type* normal, size_type normal_size)
+{
+    return normal_size >= 2u && normal[normal_size - 1u] == path::dot && normal[normal_size - 2u] == path::dot &&
+        (normal_size == 2u || fs::detail::is_element_separator(normal[normal_size - 3u]));
+}
+
+size_type lexically_normal_v4(const value_type* p, size_type size, value_type* normal)
+{
+    // The normalized path is written in a single pass over the source path. The write position never
+    // exceeds the read position, which allows the source and the target to be the same buffer.
+    typedef path::string_type::traits_type traits_type;
+
+    size_type root_name_size = 0;
+    size_type root_dir_pos = find_root_directory_start(p, size, root_name_size);
+
+    traits_type::move(normal, p, root_name_size);
+    size_type normal_size = root_name_size;
+
+#if defined(BOOST_WINDOWS_API)
+    for (size_type i = 0; i < root_name_size; ++i)
+    {
+        if (normal[i] == path::separator)
+            normal[i] = path::preferred_separator;
+    }
+#endif
+
+    size_type i = root_name_size;
+    size_type root_path_size = root_name_size;
+    if (root_dir_pos < size)
+    {
+        i = root_dir_pos + 1;
+        normal[normal_size++] = path::preferred_separator;
+        root_path_size = normal_size;
+    }
+
+    // Skip redundant directory separators after the root directory
+    while (i < size && fs::detail::is_directory_separator(p[i]))
+        ++i;
+
+    if (i < size)
+    {
+        while (true)
+        {
+            bool last_element_was_dot = false;
+            {
+                const size_type start_pos = i;
+
+                // Find next separator
+                i += find_separator(p + i, size - i);
+
+                const size_type element_size = i - start_pos;
+
+                // Skip dot elements
+                if (element_size == 1u && p[start_pos] == path::dot)
+                {
+                    last_element_was_dot = true;
+                    goto skip_append;
+                }
+
+                // Process dot dot elements
+                if (element_size == 2u && p[start_pos] == path::dot && p[start_pos + 1] == path::dot && normal_size > root_path_size)
+                {
+                    // Don't remove previous dot dot elements
+                    size_type filename_size = find_filename_size(normal, root_path_size, normal_size);
+                    size_type pos = normal_size - filename_size;
+                    if (filename_size != 2u || normal[pos] != path::dot || normal[pos + 1] != path::dot)
+                    {
+                        if (pos > root_path_size && fs::detail::is_directory_separator(normal[pos - 1]))
+                            --pos;
+                        normal_size = pos;
+                        goto skip_append;
+                    }
+                }
+
+                // Append the element
+                if (is_separator_needed(normal, normal_size))
+                    normal[normal_size++] = path::preferred_separator;
+                traits_type::move(normal + normal_size, p + start_pos, element_size);
+                normal_size += element_size;
+            }
+
+        skip_append:
+            if (i == size)
+            {
+                // If a path ends with a trailing dot after a directory element, add a trailing separator
+                if (last_element_was_dot && normal_size > 0u && !is_filename_dot_dot(normal, normal_size) && is_separator_needed(normal, normal_size))
+                    normal[normal_size++] = path::preferred_separator;
+
+                break;
+            }
+
+            // Skip directory separators, including duplicates
+            while (i < size && fs::detail::is_directory_separator(p[i]))
+                ++i;
+
+            if (i == size)
+            {
+                // If a path ends with a separator, add a trailing separator
+                if (normal_size > 0u && !is_filename_dot_dot(normal, normal_size) && is_separator_needed(normal, normal_size))
+                    normal[normal_size++] = path::preferred_separator;
+                break;
+            }
+        }
+
+        // If the original path was not empty and normalized ended up being empty, make it a dot
+        if (normal_size == 0u)
+            normal[normal_size++] = path::dot;
+    }
+
+    return normal_size;
+}
+
+//  iteration  -----------------------------------------------------------------------//
+
+//! Root directory element, in the generic format
+BOOST_CONSTEXPR_OR_CONST value_type generic_root_directory[2] = { path::separator, 0 };
+
+element_kind first_element_kind(const value_type* p, size_type size, size_type& pos, size_type& element_size)
+{
+    return first_element(p, size, pos, element_size) ? root_directory_element : regular_element;
+}
+
+element_kind increment_v3(const value_type* p, size_type size, size_type& pos, size_type& element_size)
+{
+    BOOST_ASSERT_MSG(pos < size, "path::iterator increment past end()");
+
+    // increment to position past current element; if current element is implicit dot,
+    // this will cause pos to represent the end iterator
+    pos += element_size;
+
+    // if the end is reached, we are done
+    if (pos >= size)
+    {
+        BOOST_ASSERT_MSG(pos == size, "path::iterator increment after the referenced path was modified");
+        element_size = 0u;
+        return regular_element;
+    }
+
+    // process separator (Windows drive spec is only case not a separator)
+    if (fs::detail::is_directory_separator(p[pos]))
+    {
+        size_type root_name_size = 0;
+        size_type root_dir_pos = find_root_directory_start(p, size, root_name_size);
+
+        // detect root directory and set iterator value to the separator if it is
+        if (pos == root_dir_pos && element_size == root_name_size)
+        {
+            element_size = 1u;
+            return root_directory_element;
+        }
+
+        // skip separators until pos points to the start of the next element
+        while (pos != size && fs::detail::is_directory_separator(p[pos]))
+        {
+            ++pos;
+        }
+
+        // detect trailing separator, and treat it as ".", per POSIX spec
+        if (pos == size && !is_root_separator(p, root_dir_pos, pos - 1))
+        {
+            --pos;
+            element_size = 1u;
+            return trailing_dot_element;
+        }
+    }
+
+    // get the element
+    element_size = find_separator(p + pos, size - pos);
+    return regular_element;
+}
+
+element_kind increment_v4(const value_type* p, size_type size, size_type& pos, size_type& element_size)
+{
+    BOOST_ASSERT_MSG(pos <= size, "path::iterator increment past end()");
+
+    if (element_size == 0u && (pos + 1) == size && fs::detail::is_directory_separator(p[pos]))
+    {
+        // The iterator was pointing to the last empty element of the path; set to end.
+        pos = size;
+        return regular_element;
+    }
+
+    // increment to position past current element
+    pos += element_size;
+
+    // if the end is reached, we are done
+    if (pos >= size)
+    {
+        BOOST_ASSERT_MSG(pos == size, "path::iterator increment after the referenced path was modified");
+        element_size = 0u;
+        return regular_element;
+    }
+
+    // process separator (Windows drive spec is only case not a separator)
+    if (fs::detail::is_directory_separator(p[pos]))
+    {
+        size_type root_name_size = 0;
+        size_type root_dir_pos = find_root_directory_start(p, size, root_name_size);
+
+        // detect root directory and set iterator value to the separator if it is
+        if (pos == root_dir_pos && element_size == root_name_size)
+        {
+            element_size = 1u;
+            return root_directory_element;
+        }
+
+        // skip separators until pos points to the start of the next element
+        while (pos != size && fs::detail::is_directory_separator(p[pos]))
+        {
+            ++pos;
+        }
+
+        // detect trailing separator
+        if (pos == size && !is_root_separator(p, root_dir_pos, pos - 1))
+        {
+            --pos;
+            element_size = 0u;
+            return regular_element;
+        }
+    }
+
+    // get the element
+    element_size = find_separator(p + pos, size - pos);
+    return regular_element;
+}
+
+element_kind decrement_v4(const value_type* p, size_type size, size_type& pos, size_type& element_size)
+{
+    BOOST_ASSERT_MSG(pos > 0, "path::iterator decrement past begin()");
+    BOOST_ASSERT_MSG(pos <= size, "path::iterator decrement after the referenced path was modified");
+
+    size_type root_name_size = 0;
+    size_type root_dir_pos = find_root_directory_start(p, size, root_name_size);
+
+    if (root_dir_pos < size && pos == root_dir_pos)
+    {
+        // Was pointing at root directory, decrement to root name
+    set_to_root_name:
+        pos = 0u;
+        element_size = root_name_size;
+        return regular_element;
+    }
+
+    // if at end and there was a trailing '/', return ""
+    if (pos == size &&
+        size > 1 &&
+        fs::detail::is_directory_separator(p[pos - 1]) &&
+        !is_root_separator(p, root_dir_pos, pos - 1))
+    {
+        --pos;
+        element_size = 0u;
+        return regular_element;
+    }
+
+    // skip separators unless root directory
+    size_type end_pos = pos;
+    while (end_pos > root_name_size)
+    {
+        --end_pos;
+
+        if (end_pos == root_dir_pos)
+        {
+            // Decremented to the root directory
+            pos = end_pos;
+            element_size = 1u;
+            return root_directory_element;
+        }
+
+        if (!fs::detail::is_directory_separator(p[end_pos]))
+        {
+            ++end_pos;
+            break;
+        }
+    }
+
+    if (end_pos <= root_name_size)
+        goto set_to_root_name;
+
+    element_size = find_filename_size(p, root_name_size, end_pos);
+    pos = end_pos - element_size;
+    return regular_element;
+}
+
+//  comparison  ----------------------------------------------------------------------//
+
+const value_type* element_data(const value_type* p, size_type pos, element_kind kind)
+{
+    switch (kind)
+    {
+    case root_directory_element:
+        return generic_root_directory;
+    case trailing_dot_element:
+        return dot_path_literal;
+    default:
+        return p + pos;
+    }
+}
+
+inline int compare_element(const value_type* e1, size_type size1, const value_type* e2, size_type size2)
+{
+    int res = path::string_type::traits_type::compare(e1, e2, (std::min)(size1, size2));
+    if (res == 0)
+        return size1 < size2 ? -1 : static_cast< int >(size1 > size2);
+    return res < 0 ? -1 : 1;
+}
+
+typedef element_kind increment_func_t(const value_type* p, size_type size, size_type& pos, size_type& element_size);
+
+int compare_impl(const value_type* p1, size_type size1, const value_type* p2, size_type size2, increment_func_t* increment)
+{
+    size_type pos1, element_size1, pos2, element_size2;
+    element_kind kind1 = first_element_kind(p1, size1, pos1, element_size1);
+    element_kind kind2 = first_element_kind(p2, size2, pos2, element_size2);
+    while (pos1 < size1 && pos2 < size2)
+    {
+        int res = compare_element(element_data(p1, pos1, kind1), element_size1, element_data(p2, pos2, kind2), element_size2);
+        if (res != 0)
+            return res;
+
+        kind1 = increment(p1, size1, pos1, element_size1);
+        kind2 = increment(p2, size2, pos2, element_size2);
+    }
+
+    if (pos1 >= size1 && pos2 >= size2)
+        return 0;
+    return pos1 >= size1 ? -1 : 1;
+}
+
+int compare_v3(const value_type* p1, size_type size1, const value_type* p2, size_type size2)
+{
+    return compare_impl(p1, size1, p2, size2, &increment_v3);
+}
+
+//! Returns the length of the common prefix of the strings
+inline size_type find_common_prefix_size(const value_type* p1, const value_type* p2, size_type size)
+{
+    // Compare blocks of characters with memcmp, which is vectorized in most C runtimes
+    BOOST_CONSTEXPR_OR_CONST size_type block_size = 16u;
+    size_type pos = 0u;
+    while ((size - pos) >= block_size && std::memcmp(p1 + pos, p2 + pos, block_size * sizeof(value_type)) == 0)
+        pos += block_size;
+
+    while (pos < size && p1[pos] == p2[pos])
+        ++pos;
+
+    return pos;
+}
+
+/*!
+ * Compares paths element-wise, using v4 iteration semantics, by inspecting the characters that follow
+ * the common prefix of the paths. Returns \c false if the result cannot be determined this way.
+ *
+ * The common prefix produces the same elements in both paths, as long as it extends past the root paths.
+ * The first differing elements are then the ones that contain the first differing characters, and the
+ * comparison result is determined by these characters, unless redundant separators are involved.
+ */
+bool compare_common_prefix_v4(const value_type* p1, size_type size1, const value_type* p2, size_type size2, int& result)
+{
+    const size_type prefix_size = find_common_prefix_size(p1, p2, (std::min)(size1, size2));
+    if (prefix_size == size1 && prefix_size == size2)
+    {
+        result = 0;
+        return true;
+    }
+
+    if (prefix_size <= find_root_path_size(p1, size1) || prefix_size <= find_root_path_size(p2, size2))
+        return false;
+
+    const bool is_end1 = prefix_size == size1, is_end2 = prefix_size == size2;
+    const bool is_separator1 = !is_end1 && fs::detail::is_directory_separator(p1[prefix_size]);
+    const bool is_separator2 = !is_end2 && fs::detail::is_directory_separator(p2[prefix_size]);
+    if (!is_end1 && !is_separator1 && !is_end2 && !is_separator2)
+    {
+        // The elements differ in the character
+        result = path::string_type::traits_type::lt(p1[prefix_size], p2[prefix_size]) ? -1 : 1;
+        return true;
+    }
+
+    // One of the elements ends at the differing character. If it is preceded by a separator,
+    // the separator may be redundant, or the element may be an empty trailing element.
+    const bool is_after_separator = fs::detail::is_directory_separator(p1[prefix_size - 1u]);
+    if (is_end1 || is_end2)
+    {
+        if ((is_separator1 || is_separator2) && is_after_separator)
+            return false;
+
+        // A path that ends is less, as its element is either a prefix of the other element, or it has fewer elements
+        result = is_end1 ? -1 : 1;
+        return true;
+    }
+
+    if (is_separator1 == is_separator2 || is_after_separator)
+        return false;
+
+    // The element that ends at the separator is a prefix of the other element
+    result = is_separator1 ? -1 : 1;
+    return true;
+}
+
+int compare_v4(const value_type* p1, size_type size1, const value_type* p2, size_type size2)
+{
+    int result;
+    if (BOOST_LIKELY(compare_common_prefix_v4(p1, size1, p2, size2, result)))
+        return result;
+
+    return compare_impl(p1, size1, p2, size2, &increment_v4);
+}
+
+} // namespace path_algorithms
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                   path hashing                                       //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+// The hash function is based on wyhash by Wang Yi, which reads the input 8 or 16 bytes at a time and mixes
+// the words with 64x64->128-bit multiplications. The function is not cryptographic.
+
+BOOST_CONSTEXPR_OR_CONST boost::uint64_t path_hash_k0 = 0xa0761d6478bd642full;
+BOOST_CONSTEXPR_OR_CONST boost::uint64_t path_hash_k1 = 0xe7037ed1a0b428dbull;
+BOOST_CONSTEXPR_OR_CONST boost::uint64_t path_hash_k2 = 0x8ebc6af09c88c6e3ull;
+BOOST_CONSTEXPR_OR_CONST boost::uint64_t path_hash_k3 = 0x589965cc75374cc3ull;
+
+//! Multiplies \a a and \a b and stores the low and high halves of the 128-bit product in \a a and \a b
+BOOST_FORCEINLINE void path_hash_multiply(boost::uint64_t& a, boost::uint64_t& b) BOOST_NOEXCEPT
+{
+#if defined(BOOST_HAS_INT128)
+    const boost::uint128_type r = static_cast< boost::uint128_type >(a) * b;
+    a = static_cast< boost::uint64_t >(r);
+    b = static_cast< boost::uint64_t >(r >> 64u);
+#else
+    const boost::uint64_t a_lo = static_cast< boost::uint32_t >(a), a_hi = a >> 32u;
+    const boost::uint64_t b_lo = static_cast< boost::uint32_t >(b), b_hi = b >> 32u;
+    const boost::uint64_t p0 = a_lo * b_lo, p1 = a_lo * b_hi, p2 = a_hi * b_lo, p3 = a_hi * b_hi;
+    const boost::uint64_t mid = (p0 >> 32u) + static_cast< boost::uint32_t >(p1) + static_cast< boost::uint32_t >(p2);
+    a = (mid << 32u) | static_cast< boost::uint32_t >(p0);
+    b = p3 + (p1 >> 32u) + (p2 >> 32u) + (mid >> 32u);
+#endif
+}
+
+//! Returns the 128-bit product of \a a and \a b, folded to 64 bits
+BOOST_FORCEINLINE boost::uint64_t path_hash_mix(boost::uint64_t a, boost::uint64_t b) BOOST_NOEXCEPT
+{
+    path_hash_multiply(a, b);
+    return a ^ b;
+}
+
+#if defined(BOOST_WINDOWS_API)
+
+// Paths that only differ in the kind of separators compare equal, so their hashes must be equal as well. Forward slashes
+// are replaced with backslashes in the loaded words, treating them as vectors of 16-bit characters. The words are always
+// loaded at offsets multiple of the character size, so the vector elements match the characters of the path.
+
+BOOST_FORCEINLINE boost::uint64_t path_hash_fold_separators(boost::uint64_t x) BOOST_NOEXCEPT
+{
+    const boost::uint64_t low_bits = 0x7FFF7FFF7FFF7FFFull;
+    const boost::uint64_t t = x ^ 0x002F002F002F002Full;
+    // The most significant bit of each element is set if the element is equal to L'/'
+    const boost::uint64_t matches = ~(((t & low_bits) + low_bits) | t | low_bits);
+    return x ^ ((matches >> 15u) * static_cast< boost::uint64_t >(L'/' ^ L'\\'));
+}
+
+BOOST_FORCEINLINE boost::uint32_t path_hash_fold_separators(boost::uint32_t x) BOOST_NOEXCEPT
+{
+    const boost::uint32_t low_bits = 0x7FFF7FFFu;
+    const boost::uint32_t t = x ^ 0x002F002Fu;
+    const boost::uint32_t matches = ~(((t & low_bits) + low_bits) | t | low_bits);
+    return x ^ ((matches >> 15u) * static_cast< boost::uint32_t >(L'/' ^ L'\\'));
+}
+
+#else // defined(BOOST_WINDOWS_API)
+
+BOOST_FORCEINLINE boost::uint64_t path_hash_fold_separators(boost::uint64_t x) BOOST_NOEXCEPT
+{
+    return x;
+}
+
+BOOST_FORCEINLINE boost::uint32_t path_hash_fold_separators(boost::uint32_t x) BOOST_NOEXCEPT
+{
+    return x;
+}
+
+#endif // defined(BOOST_WINDOWS_API)
+
+BOOST_FORCEINLINE boost::uint64_t path_hash_load64(const unsigned char* p) BOOST_NOEXCEPT
+{
+    boost::uint64_t x;
+    std::memcpy(&x, p, sizeof(x));
+    return path_hash_fold_separators(x);
+}
+
+BOOST_FORCEINLINE boost::uint64_t path_hash_load32(const unsigned char* p) BOOST_NOEXCEPT
+{
+    boost::uint32_t x;
+    std::memcpy(&x, p, sizeof(x));
+    return path_hash_fold_separators(x);
+}
+
+//! Computes the hash of \a size bytes starting at \a p
+boost::uint64_t path_hash_bytes(const unsigned char* p, std::size_t size) BOOST_NOEXCEPT
+{
+    boost::uint64_t seed = path_hash_k0 ^ path_hash_mix(path_hash_k0, path_hash_k1);
+    boost::uint64_t a, b;
+    if (BOOST_LIKELY(size <= 16u))
+    {
+        if (size >= 4u)
+        {
+            const std::size_t offset = (size >> 3u) << 2u;
+            a = (path_hash_load32(p) << 32u) | path_hash_load32(p + offset);
+            b = (path_hash_load32(p + size - 4u) << 32u) | path_hash_load32(p + size - 4u - offset);
+        }
+        else if (size > 0u)
+        {
+#if defined(BOOST_WINDOWS_API)
+            // A single character
+            wchar_t c;
+            std::memcpy(&c, p, sizeof(c));
+            a = static_cast< boost::uint64_t >(c == L'/' ? L'\\' : c);
+#else
+            a = (static_cast< boost::uint64_t >(p[0]) << 16u) | (static_cast< boost::uint64_t >(p[size >> 1u]) << 8u) | p[size - 1u];
+#endif
+            b = 0u;
+        }
+        else
+        {
+            a = b = 0u;
+        }
     }
-
-    // Otherwise, the root directory
-    if (root_dir_pos < size)
+    else
     {
-        element_pos = root_dir_pos;
-        element_size = 1u;
-        return;
+        std::size_t remaining = size;
+        if (remaining > 48u)
+        {
+            boost::uint64_t seed1 = seed, seed2 = seed;
+            do
+            {
+                seed = path_hash_mix(path_hash_load64(p) ^ path_hash_k1, path_hash_load64(p + 8u) ^ seed);
+                seed1 = path_hash_mix(path_hash_load64(p + 16u) ^ path_hash_k2, path_hash_load64(p + 24u) ^ seed1);
+                seed2 = path_hash_mix(path_hash_load64(p + 32u) ^ path_hash_k3, path_hash_load64(p + 40u) ^ seed2);
+                p += 48u;
+                remaining -= 48u;
+            }
+            while (remaining > 48u);
+            seed ^= seed1 ^ seed2;
+        }
+
+        while (remaining > 16u)
+        {
+            seed = path_hash_mix(path_hash_load64(p) ^ path_hash_k1, path_hash_load64(p + 8u) ^ seed);
+            p += 16u;
+            remaining -= 16u;
+        }
+
+        a = path_hash_load64(p + remaining - 16u);
+        b = path_hash_load64(p + remaining - 8u);
     }
 
-    // Otherwise, the first filename or directory name in a relative path
-    size_type end_pos = src.find_first_of(separators);
-    if (end_pos == string_type::npos)
-        end_pos = src.size();
-    element_size = end_pos;
+    a ^= path_hash_k1;
+    b ^= seed;
+    path_hash_multiply(a, b);
+    return path_hash_mix(a ^ path_hash_k0 ^ static_cast< boost::uint64_t >(size), b ^ path_hash_k1);
 }
 
 } // unnamed namespace
@@ -964,6 +1707,12 @@ namespace boost {
 namespace filesystem {
 namespace detail {
 
+BOOST_FILESYSTEM_DECL
+std::size_t hash_path(const path::value_type* str, std::size_t size) BOOST_NOEXCEPT
+{
+    return static_cast< std::size_t >(path_hash_bytes(reinterpret_cast< const unsigned char* >(str), size * sizeof(path::value_type)));
+}
+
 BOOST_FILESYSTEM_DECL
 int lex_compare_v3(path::iterator first1, path::iterator last1, path::iterator first2, path::iterator last2)
 {
@@ -1004,214 +1753,374 @@ int lex_compare_v4(path::iterator first1, path::iterator last1, path::iterator f
 
 //--------------------------------------------------------------------------------------//
 //                                                                                      //
-//                        class path::iterator implementation                           //
+//                          class path_view implementation                              //
 //                                                                                      //
 //--------------------------------------------------------------------------------------//
 
-BOOST_FILESYSTEM_DECL path::iterator path::begin() const
+BOOST_FILESYSTEM_DECL int path_view::compare(path_view const& p) const BOOST_NOEXCEPT
 {
-    iterator itr;
-    itr.m_path_ptr = this;
+    return path_algorithms::compare_v4(m_data, m_size, p.m_data, p.m_size);
+}
 
-    size_type element_size;
-    first_element(m_pathname, itr.m_pos, element_size);
+BOOST_FILESYSTEM_DECL path_view path_view::root_name() const BOOST_NOEXCEPT
+{
+    return path_view(m_data, path_algorithms::find_root_name_size(m_data, m_size));
+}
 
-    if (element_size > 0)
-    {
-        itr.m_element = m_pathname.substr(itr.m_pos, element_size);
-#ifdef BOOST_WINDOWS_API
-        if (itr.m_element.m_pathname.size() == 1u && itr.m_element.m_pathname[0] == preferred_separator)
-            itr.m_element.m_pathname[0] = separator;
-#endif
-    }
+BOOST_FILESYSTEM_DECL path_view path_view::root_directory() const BOOST_NOEXCEPT
+{
+    substring root_dir = path_algorithms::find_root_directory(m_data, m_size);
+    return path_view(m_data + root_dir.pos, root_dir.size);
+}
 
-    return itr;
+BOOST_FILESYSTEM_DECL path_view path_view::root_path() const BOOST_NOEXCEPT
+{
+    return path_view(m_data, path_algorithms::find_root_path_size(m_data, m_size));
 }
 
-BOOST_FILESYSTEM_DECL path::iterator path::end() const
+BOOST_FILESYSTEM_DECL path_view path_view::relative_path() const BOOST_NOEXCEPT
+{
+    substring rel_path = path_algorithms::find_relative_path(m_data, m_size);
+    return path_view(m_data + rel_path.pos, rel_path.size);
+}
+
+BOOST_FILESYSTEM_DECL path_view path_view::parent_path() const BOOST_NOEXCEPT
+{
+    return path_view(m_data, path_algorithms::find_parent_path_size(m_data, m_size));
+}
+
+BOOST_FILESYSTEM_DECL path_view path_view::filename() const BOOST_NOEXCEPT
+{
+    const size_type filename_size = path_algorithms::find_filename_v4_size(m_data, m_size);
+    return path_view(m_data + (m_size - filename_size), filename_size);
+}
+
+BOOST_FILESYSTEM_DECL path_view path_view::stem() const BOOST_NOEXCEPT
+{
+    path_view name(filename());
+    name.m_size -= path_algorithms::find_extension_v4_size(m_data, m_size);
+    return name;
+}
+
+BOOST_FILESYSTEM_DECL path_view path_view::extension() const BOOST_NOEXCEPT
+{
+    const size_type extension_size = path_algorithms::find_extension_v4_size(m_data, m_size);
+    return path_view(m_data + (m_size - extension_size), extension_size);
+}
+
+BOOST_FILESYSTEM_DECL path_view::iterator path_view::begin() const BOOST_NOEXCEPT
 {
     iterator itr;
-    itr.m_path_ptr = this;
-    itr.m_pos = m_pathname.size();
+    itr.m_path = *this;
+
+    size_type element_size;
+    path_algorithms::element_kind kind = path_algorithms::first_element_kind(m_data, m_size, itr.m_pos, element_size);
+    itr.m_element = path_view(path_algorithms::element_data(m_data, itr.m_pos, kind), element_size);
+
     return itr;
 }
 
-BOOST_FILESYSTEM_DECL void path::iterator::increment_v3()
+BOOST_FILESYSTEM_DECL void path_view::iterator::increment() BOOST_NOEXCEPT
 {
-    const size_type size = m_path_ptr->m_pathname.size();
-    BOOST_ASSERT_MSG(m_pos < size, "path::iterator increment past end()");
+    size_type element_size = m_element.m_size;
+    path_algorithms::element_kind kind = path_algorithms::increment_v4(m_path.m_data, m_path.m_size, m_pos, element_size);
+    m_element = path_view(path_algorithms::element_data(m_path.m_data, m_pos, kind), element_size);
+}
 
-    // increment to position past current element; if current element is implicit dot,
-    // this will cause m_pos to represent the end iterator
-    m_pos += m_element.m_pathname.size();
+BOOST_FILESYSTEM_DECL void path_view::iterator::decrement() BOOST_NOEXCEPT
+{
+    size_type element_size = 0u;
+    path_algorithms::element_kind kind = path_algorithms::decrement_v4(m_path.m_data, m_path.m_size, m_pos, element_size);
+    m_element = path_view(path_algorithms::element_data(m_path.m_data, m_pos, kind), element_size);
+}
 
-    // if the end is reached, we are done
-    if (m_pos >= size)
-    {
-        BOOST_ASSERT_MSG(m_pos == size, "path::iterator increment after the referenced path was modified");
-        m_element.clear(); // aids debugging
-        return;
-    }
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                         class static_path implementation                             //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
 
-    // process separator (Windows drive spec is only case not a separator)
-    if (detail::is_directory_separator(m_path_ptr->m_pathname[m_pos]))
+namespace detail {
+
+BOOST_FILESYSTEM_DECL path static_path_append_v4(static_path const& lhs, const path::value_type* begin, const path::value_type* end)
+{
+    typedef path::string_type string_type;
+
+    const path::value_type* const lhs_data = lhs.data();
+    const size_type lhs_size = lhs.size();
+    string_type result;
+
+    if (begin != end)
     {
-        size_type root_name_size = 0;
-        size_type root_dir_pos = find_root_directory_start(m_path_ptr->m_pathname.c_str(), size, root_name_size);
+        const size_type that_size = end - begin;
+        size_type that_root_name_size = 0;
+        size_type that_root_dir_pos = find_root_directory_start(begin, that_size, that_root_name_size);
 
-        // detect root directory and set iterator value to the separator if it is
-        if (m_pos == root_dir_pos && m_element.m_pathname.size() == root_name_size)
+        // if (p.is_absolute()) or the root names differ, the result is p
+        if
+        (
+#if defined(BOOST_WINDOWS_API) && !defined(UNDER_CE)
+            that_root_name_size > 0 &&
+#endif
+            that_root_dir_pos < that_size
+        )
         {
-            m_element.m_pathname = separator; // generic format; see docs
-            return;
+            return path(begin, end);
         }
 
-        // skip separators until m_pos points to the start of the next element
-        while (m_pos != size && detail::is_directory_separator(m_path_ptr->m_pathname[m_pos]))
+        // The root name of lhs is precomputed, no need to parse lhs again
+        const size_type this_root_name_size = lhs.root_name_size();
+        if
+        (
+            that_root_name_size > 0 &&
+            (that_root_name_size != this_root_name_size || std::memcmp(lhs_data, begin, this_root_name_size * sizeof(path::value_type)) != 0)
+        )
         {
-            ++m_pos;
+            return path(begin, end);
         }
 
-        // detect trailing separator, and treat it as ".", per POSIX spec
-        if (m_pos == size &&
-            !is_root_separator(m_path_ptr->m_pathname, root_dir_pos, m_pos - 1))
+        // If p has a root directory, it replaces the root directory (if any) and relative path of lhs
+        const size_type prefix_size = that_root_dir_pos < that_size ? this_root_name_size : lhs_size;
+        const path::value_type* const that_path = begin + that_root_name_size;
+
+        result.reserve(prefix_size + 1u + (end - that_path));
+        result.assign(lhs_data, lhs_data + prefix_size);
+        if (!detail::is_directory_separator(*that_path) && prefix_size > 0u &&
+#ifdef BOOST_WINDOWS_API
+            lhs_data[prefix_size - 1u] != colon &&
+#endif
+            !detail::is_directory_separator(lhs_data[prefix_size - 1u]))
         {
-            --m_pos;
-            m_element = detail::dot_path();
-            return;
+            result.push_back(path::preferred_separator);
         }
+        result.append(that_path, end);
+    }
+    else
+    {
+        result.reserve(lhs_size + 1u);
+        result.assign(lhs_data, lhs_data + lhs_size);
+        if (lhs.has_filename())
+            result.push_back(path::preferred_separator);
     }
 
-    // get m_element
-    size_type end_pos = m_path_ptr->m_pathname.find_first_of(separators, m_pos);
-    if (end_pos == string_type::npos)
-        end_pos = size;
-    const path::value_type* p = m_path_ptr->m_pathname.c_str();
-    m_element.m_pathname.assign(p + m_pos, p + end_pos);
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    return path(static_cast< string_type&& >(result));
+#else
+    return path(result);
+#endif
 }
 
-BOOST_FILESYSTEM_DECL void path::iterator::increment_v4()
+} // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                          class path_arena implementation                             //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+//! Header of a memory block allocated by path_arena, followed by the block contents
+struct path_arena::block
 {
-    const size_type size = m_path_ptr->m_pathname.size();
-    BOOST_ASSERT_MSG(m_pos <= size, "path::iterator increment past end()");
+    block* next;
+    //! Size of the block, including the header, in bytes
+    size_type size;
 
-    if (m_element.m_pathname.empty() && (m_pos + 1) == size && detail::is_directory_separator(m_path_ptr->m_pathname[m_pos]))
+    value_type* data() BOOST_NOEXCEPT { return reinterpret_cast< value_type* >(this + 1); }
+
+    //! Allocates a block that can hold \a capacity characters
+    static block* allocate(size_type capacity)
     {
-        // The iterator was pointing to the last empty element of the path; set to end.
-        m_pos = size;
-        return;
+        const size_type size = sizeof(block) + capacity * sizeof(value_type);
+        block* b = static_cast< block* >(detail::allocate_memory(size, boost::alignment_of< block >::value));
+        b->size = size;
+        return b;
     }
 
-    // increment to position past current element; if current element is implicit dot,
-    // this will cause m_pos to represent the end iterator
-    m_pos += m_element.m_pathname.size();
-
-    // if the end is reached, we are done
-    if (m_pos >= size)
+    static void deallocate(block* b) BOOST_NOEXCEPT
     {
-        BOOST_ASSERT_MSG(m_pos == size, "path::iterator increment after the referenced path was modified");
-        m_element.clear(); // aids debugging
-        return;
+        detail::deallocate_memory(b, b->size, boost::alignment_of< block >::value);
     }
+};
 
-    // process separator (Windows drive spec is only case not a separator)
-    if (detail::is_directory_separator(m_path_ptr->m_pathname[m_pos]))
+BOOST_FILESYSTEM_DECL path_view path_arena::store(path_view const& p)
+{
+    const size_type size = p.size() + 1u; // include the terminating zero
+    value_type* data;
+    if (BOOST_LIKELY(m_block != NULL && (m_capacity - m_pos) >= size))
     {
-        size_type root_name_size = 0;
-        size_type root_dir_pos = find_root_directory_start(m_path_ptr->m_pathname.c_str(), size, root_name_size);
-
-        // detect root directory and set iterator value to the separator if it is
-        if (m_pos == root_dir_pos && m_element.m_pathname.size() == root_name_size)
-        {
-            m_element.m_pathname = separator; // generic format; see docs
-            return;
-        }
+        data = m_block->data() + m_pos;
+        m_pos += size;
+    }
+    else
+    {
+        size_type capacity = 0u;
+        if (m_block_size > sizeof(block))
+            capacity = (m_block_size - sizeof(block)) / sizeof(value_type);
 
-        // skip separators until m_pos points to the start of the next element
-        while (m_pos != size && detail::is_directory_separator(m_path_ptr->m_pathname[m_pos]))
+        if (size <= capacity)
         {
-            ++m_pos;
+            // Start a new regular block
+            block* b = block::allocate(capacity);
+            b->next = m_block;
+            m_block = b;
+            m_capacity = capacity;
+            m_pos = size;
+            m_allocated_size += sizeof(block) + capacity * sizeof(value_type);
+            data = b->data();
         }
-
-        // detect trailing separator
-        if (m_pos == size &&
-            !is_root_separator(m_path_ptr->m_pathname, root_dir_pos, m_pos - 1))
+        else
         {
-            --m_pos;
-            m_element.m_pathname.clear();
-            return;
+            // The path doesn't fit in a regular block, allocate a dedicated block for it. Insert it behind the current block
+            // so that the remaining space in the current block can still be used.
+            block* b = block::allocate(size);
+            if (m_block)
+            {
+                b->next = m_block->next;
+                m_block->next = b;
+            }
+            else
+            {
+                b->next = NULL;
+                m_block = b;
+                m_capacity = size;
+                m_pos = size;
+            }
+            m_allocated_size += sizeof(block) + size * sizeof(value_type);
+            data = b->data();
         }
     }
 
-    // get m_element
-    size_type end_pos = m_path_ptr->m_pathname.find_first_of(separators, m_pos);
-    if (end_pos == string_type::npos)
-        end_pos = size;
-    const path::value_type* p = m_path_ptr->m_pathname.c_str();
-    m_element.m_pathname.assign(p + m_pos, p + end_pos);
+    if (p.size() > 0u)
+        path::string_type::traits_type::copy(data, p.data(), p.size());
+    data[p.size()] = static_cast< value_type >(0);
+
+    return path_view(data, p.size());
 }
 
-BOOST_FILESYSTEM_DECL void path::iterator::decrement_v3()
+BOOST_FILESYSTEM_DECL void path_arena::release() BOOST_NOEXCEPT
 {
-    const size_type size = m_path_ptr->m_pathname.size();
-    BOOST_ASSERT_MSG(m_pos > 0, "path::iterator decrement past begin()");
-    BOOST_ASSERT_MSG(m_pos <= size, "path::iterator decrement after the referenced path was modified");
-
-    size_type root_name_size = 0;
-    size_type root_dir_pos = find_root_directory_start(m_path_ptr->m_pathname.c_str(), size, root_name_size);
-
-    if (root_dir_pos < size && m_pos == root_dir_pos)
+    block* b = m_block;
+    while (b)
     {
-        // Was pointing at root directory, decrement to root name
-    set_to_root_name:
-        m_pos = 0u;
-        const path::value_type* p = m_path_ptr->m_pathname.c_str();
-        m_element.m_pathname.assign(p, p + root_name_size);
-        return;
+        block* next = b->next;
+        block::deallocate(b);
+        b = next;
     }
 
-    // if at end and there was a trailing non-root '/', return "."
-    if (m_pos == size &&
-        size > 1 &&
-        detail::is_directory_separator(m_path_ptr->m_pathname[m_pos - 1]) &&
-        !is_root_separator(m_path_ptr->m_pathname, root_dir_pos, m_pos - 1))
-    {
-        --m_pos;
-        m_element = detail::dot_path();
+    m_block = NULL;
+    m_pos = 0u;
+    m_capacity = 0u;
+    m_allocated_size = 0u;
+}
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                           class path_key implementation                              //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+BOOST_FILESYSTEM_DECL void path_key::init(path_view const& p)
+{
+    const value_type* const data = p.data();
+    const size_type size = p.size();
+    if (size == 0u)
         return;
-    }
 
-    // skip separators unless root directory
-    size_type end_pos = m_pos;
-    while (end_pos > root_name_size)
+    // The elements are joined with null characters, which sort before any other characters,
+    // so that comparing the keys as strings produces the same result as comparing the elements
+    m_key.reserve(size + 1u);
+    size_type pos, element_size;
+    path_algorithms::element_kind kind = path_algorithms::first_element_kind(data, size, pos, element_size);
+    while (pos < size)
     {
-        --end_pos;
+        if (!m_key.empty())
+            m_key.push_back(static_cast< value_type >(0));
+        const value_type* element = path_algorithms::element_data(data, pos, kind);
+        m_key.append(element, element + element_size);
+        kind = path_algorithms::increment_v4(data, size, pos, element_size);
+    }
 
-        if (end_pos == root_dir_pos)
-        {
-            // Decremented to the root directory
-            m_pos = end_pos;
-            m_element.m_pathname = separator; // generic format; see docs
-            return;
-        }
+    m_hash = detail::hash_path(m_key.data(), m_key.size());
+}
 
-        if (!detail::is_directory_separator(m_path_ptr->m_pathname[end_pos]))
+BOOST_FILESYSTEM_DECL path path_key::to_path() const
+{
+    path result;
+    const value_type* p = m_key.c_str();
+    const value_type* const end = p + m_key.size();
+    if (p != end)
+    {
+        while (true)
         {
-            ++end_pos;
-            break;
+            size_type element_size = string_type::traits_type::length(p);
+            result /= path_view(p, element_size);
+            p += element_size;
+            if (p == end)
+                break;
+            ++p; // skip the null separator
         }
     }
 
-    if (end_pos <= root_name_size)
-        goto set_to_root_name;
+    return result;
+}
 
-    size_type filename_size = find_filename_size(m_path_ptr->m_pathname, root_name_size, end_pos);
-    m_pos = end_pos - filename_size;
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                        class path::iterator implementation                           //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+BOOST_FILESYSTEM_DECL path::iterator path::begin() const
+{
+    iterator itr;
+    itr.m_path_ptr = this;
+
+    size_type element_size;
+    if (first_element(m_pathname.c_str(), m_pathname.size(), itr.m_pos, element_size))
+        itr.m_element.m_pathname = separator; // generic format; see docs
+    else if (element_size > 0)
+        itr.m_element = m_pathname.substr(itr.m_pos, element_size);
+
+    return itr;
+}
+
+BOOST_FILESYSTEM_DECL path::iterator path::end() const
+{
+    iterator itr;
+    itr.m_path_ptr = this;
+    itr.m_pos = m_pathname.size();
+    return itr;
+}
+
+BOOST_FILESYSTEM_DECL void path::iterator::increment_v3()
+{
     const path::value_type* p = m_path_ptr->m_pathname.c_str();
-    m_element.m_pathname.assign(p + m_pos, p + end_pos);
+    size_type element_size = m_element.m_pathname.size();
+    switch (path_algorithms::increment_v3(p, m_path_ptr->m_pathname.size(), m_pos, element_size))
+    {
+    case path_algorithms::root_directory_element:
+        m_element.m_pathname = separator; // generic format; see docs
+        break;
+    case path_algorithms::trailing_dot_element:
+        m_element = detail::dot_path();
+        break;
+    default:
+        m_element.m_pathname.assign(p + m_pos, p + m_pos + element_size);
+        break;
+    }
 }
 
-BOOST_FILESYSTEM_DECL void path::iterator::decrement_v4()
+BOOST_FILESYSTEM_DECL void path::iterator::increment_v4()
+{
+    const path::value_type* p = m_path_ptr->m_pathname.c_str();
+    size_type element_size = m_element.m_pathname.size();
+    if (path_algorithms::increment_v4(p, m_path_ptr->m_pathname.size(), m_pos, element_size) == path_algorithms::root_directory_element)
+        m_element.m_pathname = separator; // generic format; see docs
+    else
+        m_element.m_pathname.assign(p + m_pos, p + m_pos + element_size);
+}
+
+BOOST_FILESYSTEM_DECL void path::iterator::decrement_v3()
 {
     const size_type size = m_path_ptr->m_pathname.size();
     BOOST_ASSERT_MSG(m_pos > 0, "path::iterator decrement past begin()");
@@ -1230,14 +2139,14 @@ BOOST_FILESYSTEM_DECL void path::iterator::decrement_v4()
         return;
     }
 
-    // if at end and there was a trailing '/', return ""
+    // if at end and there was a trailing non-root '/', return "."
     if (m_pos == size &&
         size > 1 &&
         detail::is_directory_separator(m_path_ptr->m_pathname[m_pos - 1]) &&
-        !is_root_separator(m_path_ptr->m_pathname, root_dir_pos, m_pos - 1))
+        !is_root_separator(m_path_ptr->m_pathname.c_str(), root_dir_pos, m_pos - 1))
     {
         --m_pos;
-        m_element.m_pathname.clear();
+        m_element = detail::dot_path();
         return;
     }
 
@@ -1265,12 +2174,22 @@ BOOST_FILESYSTEM_DECL void path::iterator::decrement_v4()
     if (end_pos <= root_name_size)
         goto set_to_root_name;
 
-    size_type filename_size = find_filename_size(m_path_ptr->m_pathname, root_name_size, end_pos);
+    size_type filename_size = find_filename_size(m_path_ptr->m_pathname.c_str(), root_name_size, end_pos);
     m_pos = end_pos - filename_size;
     const path::value_type* p = m_path_ptr->m_pathname.c_str();
     m_element.m_pathname.assign(p + m_pos, p + end_pos);
 }
 
+BOOST_FILESYSTEM_DECL void path::iterator::decrement_v4()
+{
+    const path::value_type* p = m_path_ptr->m_pathname.c_str();
+    size_type element_size = 0u;
+    if (path_algorithms::decrement_v4(p, m_path_ptr->m_pathname.size(), m_pos, element_size) == path_algorithms::root_directory_element)
+        m_element.m_pathname = separator; // generic format; see docs
+    else
+        m_element.m_pathname.assign(p + m_pos, p + m_pos + element_size);
+}
+
 } // namespace filesystem
 } // namespace boost
 
@@ -1330,7 +2249,21 @@ std::locale default_locale()
 #endif
 }
 
-std::locale* g_path_locale = NULL;
+//! Path locale and its codecvt facet
+struct path_locale
+{
+    std::locale locale;
+    //! Pointer to the codecvt facet of the locale, cached to avoid calling use_facet() on every conversion
+    const boost::filesystem::path::codecvt_type* codecvt;
+
+    explicit path_locale(std::locale const& loc) :
+        locale(loc),
+        codecvt(&std::use_facet< boost::filesystem::path::codecvt_type >(locale))
+    {
+    }
+};
+
+path_locale* g_path_locale = NULL;
 
 void schedule_path_locale_cleanup() BOOST_NOEXCEPT;
 
@@ -1341,14 +2274,17 @@ void schedule_path_locale_cleanup() BOOST_NOEXCEPT;
 // g_path_locale is only initialized if path::codecvt() or path::imbue() are themselves
 // actually called, ensuring that an exception will only be thrown if std::locale("")
 // is really needed.
-inline std::locale& get_path_locale()
+//
+// The locale and the facet pointer are published together with a single pointer, so
+// that the conversion hot path only performs an atomic load.
+inline path_locale& get_path_locale()
 {
 #if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
-    atomic_ns::atomic_ref< std::locale* > a(g_path_locale);
-    std::locale* p = a.load(atomic_ns::memory_order_acquire);
+    atomic_ns::atomic_ref< path_locale* > a(g_path_locale);
+    path_locale* p = a.load(atomic_ns::memory_order_acquire);
     if (BOOST_UNLIKELY(!p))
     {
-        std::locale* new_p = new std::locale(default_locale());
+        path_locale* new_p = new path_locale(default_locale());
         if (a.compare_exchange_strong(p, new_p, atomic_ns::memory_order_acq_rel, atomic_ns::memory_order_acquire))
         {
             p = new_p;
@@ -1361,23 +2297,23 @@ inline std::locale& get_path_locale()
     }
     return *p;
 #else // !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
-    std::locale* p = g_path_locale;
+    path_locale* p = g_path_locale;
     if (BOOST_UNLIKELY(!p))
     {
-        g_path_locale = p = new std::locale(default_locale());
+        g_path_locale = p = new path_locale(default_locale());
         schedule_path_locale_cleanup();
     }
     return *p;
 #endif // !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
 }
 
-inline std::locale* replace_path_locale(std::locale const& loc)
+inline path_locale* replace_path_locale(std::locale const& loc)
 {
-    std::locale* new_p = new std::locale(loc);
+    path_locale* new_p = new path_locale(loc);
 #if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
-    std::locale* p = atomic_ns::atomic_ref< std::locale* >(g_path_locale).exchange(new_p, atomic_ns::memory_order_acq_rel);
+    path_locale* p = atomic_ns::atomic_ref< path_locale* >(g_path_locale).exchange(new_p, atomic_ns::memory_order_acq_rel);
 #else
-    std::locale* p = g_path_locale;
+    path_locale* p = g_path_locale;
     g_path_locale = new_p;
 #endif
     if (!p)
@@ -1562,7 +2498,7 @@ BOOST_FILESYSTEM_DECL path::codecvt_type const& path::codecvt()
 #ifdef BOOST_FILESYSTEM_DEBUG
     std::cout << "***** path::codecvt() called" << std::endl;
 #endif
-    return std::use_facet< std::codecvt< wchar_t, char, std::mbstate_t > >(get_path_locale());
+    return *get_path_locale().codecvt;
 }
 
 BOOST_FILESYSTEM_DECL std::locale path::imbue(std::locale const& loc)
@@ -1570,14 +2506,14 @@ BOOST_FILESYSTEM_DECL std::locale path::imbue(std::locale const& loc)
 #ifdef BOOST_FILESYSTEM_DEBUG
     std::cout << "***** path::imbue() called" << std::endl;
 #endif
-    std::locale* p = replace_path_locale(loc);
+    path_locale* p = replace_path_locale(loc);
     if (BOOST_LIKELY(p != NULL))
     {
         // Note: copying/moving std::locale does not throw
 #if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
-        std::locale temp(std::move(*p));
+        std::locale temp(std::move(p->locale));
 #else
-        std::locale temp(*p);
+        std::locale temp(p->locale);
 #endif
         delete p;
         return temp;
@@ -0,0 +1,384 @@
+//  path_map.cpp  ----------------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/path_view.hpp>
+#include <boost/filesystem/path_map.hpp>
+#include <boost/functional/hash.hpp>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+namespace {
+
+//! Number of nodes in a node block
+BOOST_CONSTEXPR_OR_CONST std::size_t node_block_size = 1024u;
+//! Initial number of hash table buckets
+BOOST_CONSTEXPR_OR_CONST std::size_t initial_bucket_count = 1024u;
+//! Size of blocks for storing element strings, in bytes
+BOOST_CONSTEXPR_OR_CONST std::size_t string_block_size = 65536u;
+
+//! Computes hash of the path composed of the parent path with the given hash and the element
+inline std::size_t combine_hash(std::size_t parent_hash, path_view const& element) BOOST_NOEXCEPT
+{
+    std::size_t seed = parent_hash;
+    boost::hash_combine(seed, boost::hash_range(element.data(), element.data() + element.size()));
+    return seed;
+}
+
+inline bool is_element_equal(path_trie_node const& node, path_view const& element) BOOST_NOEXCEPT
+{
+    return node.element_size == element.size() &&
+        (element.size() == 0u || path::string_type::traits_type::compare(node.element, element.data(), element.size()) == 0);
+}
+
+} // unnamed namespace
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                            class path_trie implementation                            //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+BOOST_FILESYSTEM_DECL path_trie::path_trie(std::size_t node_size) BOOST_NOEXCEPT :
+    m_node_size(node_size),
+    m_strings(string_block_size),
+    m_node_block_pos(node_block_size),
+    m_node_count(0u),
+    m_free_nodes(NULL),
+    m_first_root(NULL)
+{
+}
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+
+BOOST_FILESYSTEM_DECL path_trie::path_trie(path_trie&& that) BOOST_NOEXCEPT :
+    m_node_size(that.m_node_size),
+    m_strings(string_block_size),
+    m_node_block_pos(node_block_size),
+    m_node_count(0u),
+    m_free_nodes(NULL),
+    m_first_root(NULL)
+{
+    swap(that);
+}
+
+#endif // !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+
+BOOST_FILESYSTEM_DECL path_trie_node* path_trie::find(path_view const& p) const BOOST_NOEXCEPT
+{
+    path_trie_node* node = NULL;
+    for (path_view::iterator it = p.begin(), end = p.end(); it != end; ++it)
+    {
+        path_view const& element = *it;
+        node = find_child(node, element, combine_hash(node ? node->hash : 0u, element));
+        if (!node)
+            break;
+    }
+
+    return node;
+}
+
+BOOST_FILESYSTEM_DECL path_trie_node* path_trie::insert(path_view const& p)
+{
+    path_trie_node* node = NULL;
+    try
+    {
+        for (path_view::iterator it = p.begin(), end = p.end(); it != end; ++it)
+        {
+            path_view const& element = *it;
+            const std::size_t hash = combine_hash(node ? node->hash : 0u, element);
+            path_trie_node* child = find_child(node, element, hash);
+            if (!child)
+                child = insert_child(node, element, hash);
+            node = child;
+        }
+    }
+    catch (...)
+    {
+        // Remove the nodes inserted so far, which hold no values
+        if (node)
+            prune(node);
+        throw;
+    }
+
+    return node;
+}
+
+BOOST_FILESYSTEM_DECL path_trie_node* path_trie::longest_prefix(path_view const& p) const BOOST_NOEXCEPT
+{
+    path_trie_node* node = NULL;
+    path_trie_node* prefix = NULL;
+    for (path_view::iterator it = p.begin(), end = p.end(); it != end; ++it)
+    {
+        path_view const& element = *it;
+        node = find_child(node, element, combine_hash(node ? node->hash : 0u, element));
+        if (!node)
+            break;
+        if (node->has_value)
+            prefix = node;
+    }
+
+    return prefix;
+}
+
+BOOST_FILESYSTEM_DECL void path_trie::prune(path_trie_node* node) BOOST_NOEXCEPT
+{
+    while (node != NULL && !node->has_value && node->first_child == NULL)
+    {
+        path_trie_node* parent = node->parent;
+        unlink(node);
+        node = parent;
+    }
+}
+
+BOOST_FILESYSTEM_DECL void path_trie::remove_subtree(path_trie_node* root) BOOST_NOEXCEPT
+{
+    path_trie_node* const parent = root->parent;
+
+    // Remove the leaves one by one, so that no additional storage is needed to traverse the subtree
+    path_trie_node* node = root;
+    while (true)
+    {
+        while (node->first_child != NULL)
+            node = node->first_child;
+
+        path_trie_node* up = node->parent;
+        const bool is_root = node == root;
+        unlink(node);
+        if (is_root)
+            break;
+        node = up;
+    }
+
+    prune(parent);
+}
+
+BOOST_FILESYSTEM_DECL void path_trie::clear() BOOST_NOEXCEPT
+{
+    for (std::size_t i = 0u, n = m_node_blocks.size(); i < n; ++i)
+        ::operator delete(m_node_blocks[i]);
+
+    std::vector< void* >().swap(m_node_blocks);
+    std::vector< path_trie_node* >().swap(m_buckets);
+    m_node_block_pos = node_block_size;
+    m_node_count = 0u;
+    m_free_nodes = NULL;
+    m_first_root = NULL;
+    m_strings.release();
+}
+
+BOOST_FILESYSTEM_DECL path_trie_node* path_trie::first_in_subtree(path_trie_node* node, const path_trie_node* root) BOOST_NOEXCEPT
+{
+    if (node->has_value)
+        return node;
+    return next(node, root);
+}
+
+BOOST_FILESYSTEM_DECL path_trie_node* path_trie::next(path_trie_node* node, const path_trie_node* root) BOOST_NOEXCEPT
+{
+    do
+    {
+        if (node->first_child != NULL)
+        {
+            node = node->first_child;
+        }
+        else
+        {
+            while (true)
+            {
+                if (node == root)
+                    return NULL;
+
+                if (node->next_sibling != NULL)
+                {
+                    node = node->next_sibling;
+                    break;
+                }
+
+                node = node->parent;
+                if (node == NULL)
+                    return NULL;
+            }
+        }
+    }
+    while (!node->has_value);
+
+    return node;
+}
+
+BOOST_FILESYSTEM_DECL path path_trie::to_path(const path_trie_node* node)
+{
+    path result;
+    if (node)
+    {
+        std::vector< const path_trie_node* > nodes(node->depth);
+        std::size_t i = nodes.size();
+        for (; node != NULL; node = node->parent)
+            nodes[--i] = node;
+
+        for (i = 0u; i < nodes.size(); ++i)
+            result /= path_view(nodes[i]->element, nodes[i]->element_size);
+    }
+
+    return result;
+}
+
+BOOST_FILESYSTEM_DECL std::size_t path_trie::allocated_size() const BOOST_NOEXCEPT
+{
+    return m_strings.allocated_size() +
+        m_node_blocks.size() * node_block_size * m_node_size +
+        m_buckets.capacity() * sizeof(path_trie_node*);
+}
+
+BOOST_FILESYSTEM_DECL void path_trie::swap(path_trie& that) BOOST_NOEXCEPT
+{
+    std::size_t n = m_node_size;
+    m_node_size = that.m_node_size;
+    that.m_node_size = n;
+    m_strings.swap(that.m_strings);
+    m_node_blocks.swap(that.m_node_blocks);
+    n = m_node_block_pos;
+    m_node_block_pos = that.m_node_block_pos;
+    that.m_node_block_pos = n;
+    n = m_node_count;
+    m_node_count = that.m_node_count;
+    that.m_node_count = n;
+    path_trie_node* node = m_free_nodes;
+    m_free_nodes = that.m_free_nodes;
+    that.m_free_nodes = node;
+    node = m_first_root;
+    m_first_root = that.m_first_root;
+    that.m_first_root = node;
+    m_buckets.swap(that.m_buckets);
+}
+
+path_trie_node* path_trie::find_child(const path_trie_node* parent, path_view const& element, std::size_t hash) const BOOST_NOEXCEPT
+{
+    if (m_buckets.empty())
+        return NULL;
+
+    for (path_trie_node* node = m_buckets[hash & (m_buckets.size() - 1u)]; node != NULL; node = node->next)
+    {
+        if (node->hash == hash && node->parent == parent && is_element_equal(*node, element))
+            return node;
+    }
+
+    return NULL;
+}
+
+path_trie_node* path_trie::insert_child(path_trie_node* parent, path_view const& element, std::size_t hash)
+{
+    if (m_node_count >= m_buckets.size())
+        rehash(m_buckets.empty() ? initial_bucket_count : m_buckets.size() * 2u);
+
+    path_view stored_element = m_strings.store(element);
+
+    path_trie_node* node = m_free_nodes;
+    if (node != NULL)
+    {
+        m_free_nodes = node->next;
+    }
+    else
+    {
+        if (m_node_block_pos >= node_block_size)
+        {
+            m_node_blocks.reserve(m_node_blocks.size() + 1u);
+            m_node_blocks.push_back(::operator new(node_block_size * m_node_size));
+            m_node_block_pos = 0u;
+        }
+
+        node = static_cast< path_trie_node* >(static_cast< void* >(static_cast< unsigned char* >(m_node_blocks.back()) + m_node_block_pos * m_node_size));
+        ++m_node_block_pos;
+    }
+
+    ++m_node_count;
+
+    node->parent = parent;
+    node->first_child = NULL;
+    node->prev_sibling = NULL;
+    node->element = stored_element.data();
+    node->element_size = static_cast< boost::uint32_t >(stored_element.size());
+    node->hash = hash;
+    node->depth = parent ? parent->depth + 1u : 1u;
+    node->has_value = false;
+
+    path_trie_node*& first = parent ? parent->first_child : m_first_root;
+    node->next_sibling = first;
+    if (first != NULL)
+        first->prev_sibling = node;
+    first = node;
+
+    path_trie_node*& bucket = m_buckets[hash & (m_buckets.size() - 1u)];
+    node->next = bucket;
+    bucket = node;
+
+    return node;
+}
+
+void path_trie::unlink(path_trie_node* node) BOOST_NOEXCEPT
+{
+    if (node->prev_sibling != NULL)
+        node->prev_sibling->next_sibling = node->next_sibling;
+    else if (node->parent != NULL)
+        node->parent->first_child = node->next_sibling;
+    else
+        m_first_root = node->next_sibling;
+    if (node->next_sibling != NULL)
+        node->next_sibling->prev_sibling = node->prev_sibling;
+
+    for (path_trie_node** link = &m_buckets[node->hash & (m_buckets.size() - 1u)]; *link != NULL; link = &(*link)->next)
+    {
+        if (*link == node)
+        {
+            *link = node->next;
+            break;
+        }
+    }
+
+    node->next = m_free_nodes;
+    m_free_nodes = node;
+    --m_node_count;
+}
+
+void path_trie::rehash(std::size_t bucket_count)
+{
+    std::vector< path_trie_node* > buckets(bucket_count, static_cast< path_trie_node* >(NULL));
+    for (std::size_t i = 0u, n = m_buckets.size(); i < n; ++i)
+    {
+        path_trie_node* node = m_buckets[i];
+        while (node)
+        {
+            path_trie_node* next = node->next;
+            path_trie_node*& bucket = buckets[node->hash & (bucket_count - 1u)];
+            node->next = bucket;
+            bucket = node;
+            node = next;
+        }
+    }
+
+    m_buckets.swap(buckets);
+}
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
@@ -0,0 +1,210 @@
+//  path_pool.cpp  ---------------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/path_view.hpp>
+#include <boost/filesystem/path_pool.hpp>
+#include <boost/functional/hash.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+namespace {
+
+//! Number of nodes in a node block
+BOOST_CONSTEXPR_OR_CONST std::size_t node_block_size = 1024u;
+//! Initial number of hash table buckets
+BOOST_CONSTEXPR_OR_CONST std::size_t initial_bucket_count = 1024u;
+//! Size of blocks for storing element strings, in bytes
+BOOST_CONSTEXPR_OR_CONST std::size_t string_block_size = 65536u;
+
+//! Computes hash of the path composed of the parent path with the given hash and the element
+inline std::size_t combine_hash(std::size_t parent_hash, path_view const& element) BOOST_NOEXCEPT
+{
+    std::size_t seed = parent_hash;
+    boost::hash_combine(seed, boost::hash_range(element.data(), element.data() + element.size()));
+    return seed;
+}
+
+inline bool is_element_equal(detail::path_pool_node const& node, path_view const& element) BOOST_NOEXCEPT
+{
+    return node.element_size == element.size() &&
+        (element.size() == 0u || path::string_type::traits_type::compare(node.element, element.data(), element.size()) == 0);
+}
+
+} // unnamed namespace
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                          class interned_path implementation                          //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+BOOST_FILESYSTEM_DECL path interned_path::to_path() const
+{
+    path result;
+    if (m_node)
+    {
+        std::vector< const detail::path_pool_node* > nodes(m_node->depth);
+        std::size_t i = nodes.size();
+        for (const detail::path_pool_node* node = m_node; node != NULL; node = node->parent)
+            nodes[--i] = node;
+
+        for (i = 0u; i < nodes.size(); ++i)
+            result /= path_view(nodes[i]->element, nodes[i]->element_size);
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                            class path_pool implementation                            //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+BOOST_FILESYSTEM_DECL path_pool::path_pool() :
+    m_strings(string_block_size),
+    m_node_block_pos(node_block_size),
+    m_node_count(0u)
+{
+}
+
+BOOST_FILESYSTEM_DECL path_pool::~path_pool()
+{
+    clear();
+}
+
+BOOST_FILESYSTEM_DECL interned_path path_pool::intern(path_view const& p)
+{
+    const detail::path_pool_node* node = NULL;
+    for (path_view::iterator it = p.begin(), end = p.end(); it != end; ++it)
+    {
+        path_view const& element = *it;
+        const std::size_t hash = combine_hash(node ? node->hash : 0u, element);
+        const detail::path_pool_node* child = find_node(node, element, hash);
+        if (!child)
+            child = insert_node(node, element, hash);
+        node = child;
+    }
+
+    return interned_path(node);
+}
+
+BOOST_FILESYSTEM_DECL interned_path path_pool::find(path_view const& p) const BOOST_NOEXCEPT
+{
+    const detail::path_pool_node* node = NULL;
+    for (path_view::iterator it = p.begin(), end = p.end(); it != end; ++it)
+    {
+        path_view const& element = *it;
+        node = find_node(node, element, combine_hash(node ? node->hash : 0u, element));
+        if (!node)
+            break;
+    }
+
+    return interned_path(node);
+}
+
+BOOST_FILESYSTEM_DECL std::size_t path_pool::allocated_size() const BOOST_NOEXCEPT
+{
+    return m_strings.allocated_size() +
+        m_node_blocks.size() * node_block_size * sizeof(detail::path_pool_node) +
+        m_buckets.capacity() * sizeof(detail::path_pool_node*);
+}
+
+BOOST_FILESYSTEM_DECL void path_pool::clear() BOOST_NOEXCEPT
+{
+    for (std::size_t i = 0u, n = m_node_blocks.size(); i < n; ++i)
+        delete[] m_node_blocks[i];
+
+    std::vector< detail::path_pool_node* >().swap(m_node_blocks);
+    std::vector< detail::path_pool_node* >().swap(m_buckets);
+    m_node_block_pos = node_block_size;
+    m_node_count = 0u;
+    m_strings.release();
+}
+
+const detail::path_pool_node* path_pool::find_node(const detail::path_pool_node* parent, path_view const& element, std::size_t hash) const BOOST_NOEXCEPT
+{
+    if (m_buckets.empty())
+        return NULL;
+
+    for (const detail::path_pool_node* node = m_buckets[hash & (m_buckets.size() - 1u)]; node != NULL; node = node->next)
+    {
+        if (node->hash == hash && node->parent == parent && is_element_equal(*node, element))
+            return node;
+    }
+
+    return NULL;
+}
+
+const detail::path_pool_node* path_pool::insert_node(const detail::path_pool_node* parent, path_view const& element, std::size_t hash)
+{
+    if (m_node_count >= m_buckets.size())
+        rehash(m_buckets.empty() ? initial_bucket_count : m_buckets.size() * 2u);
+
+    if (m_node_block_pos >= node_block_size)
+    {
+        m_node_blocks.reserve(m_node_blocks.size() + 1u);
+        m_node_blocks.push_back(new detail::path_pool_node[node_block_size]);
+        m_node_block_pos = 0u;
+    }
+
+    path_view stored_element = m_strings.store(element);
+
+    detail::path_pool_node* node = m_node_blocks.back() + m_node_block_pos;
+    ++m_node_block_pos;
+    ++m_node_count;
+
+    node->parent = parent;
+    node->element = stored_element.data();
+    node->element_size = static_cast< boost::uint32_t >(stored_element.size());
+    node->hash = hash;
+    node->depth = parent ? parent->depth + 1u : 1u;
+
+    detail::path_pool_node*& bucket = m_buckets[hash & (m_buckets.size() - 1u)];
+    node->next = bucket;
+    bucket = node;
+
+    return node;
+}
+
+void path_pool::rehash(std::size_t bucket_count)
+{
+    std::vector< detail::path_pool_node* > buckets(bucket_count, static_cast< detail::path_pool_node* >(NULL));
+    for (std::size_t i = 0u, n = m_buckets.size(); i < n; ++i)
+    {
+        detail::path_pool_node* node = m_buckets[i];
+        while (node)
+        {
+            detail::path_pool_node* next = node->next;
+            detail::path_pool_node*& bucket = buckets[node->hash & (bucket_count - 1u)];
+            node->next = bucket;
+            bucket = node;
+            node = next;
+        }
+    }
+
+    m_buckets.swap(buckets);
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
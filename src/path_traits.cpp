@@ -14,13 +14,22 @@
 #include <boost/filesystem/config.hpp>
 #include <boost/filesystem/detail/path_traits.hpp>
 #include <boost/filesystem/path.hpp>
+#include <boost/filesystem/detail/utf8_codecvt_facet.hpp>
 #include <boost/system/system_error.hpp>
-#include <boost/smart_ptr/scoped_array.hpp>
+#include <boost/cstdint.hpp>
 #include <boost/assert.hpp>
 #include <string>
 #include <locale>  // for codecvt_base::result
 #include <cwchar>  // for mbstate_t
 #include <cstddef>
+#include <cstring>
+#if !defined(BOOST_NO_RTTI)
+#include <typeinfo>
+#endif
+
+#if defined(BOOST_WINDOWS_API)
+#include "windows_file_codecvt.hpp"
+#endif
 
 #include <boost/filesystem/detail/header.hpp> // must be the last #include
 
@@ -28,22 +37,13 @@ namespace pt = boost::filesystem::detail::path_traits;
 namespace fs = boost::filesystem;
 namespace bs = boost::system;
 
-//--------------------------------------------------------------------------------------//
-//                                  configuration                                       //
-//--------------------------------------------------------------------------------------//
-
-#ifndef BOOST_FILESYSTEM_CODECVT_BUF_SIZE
-#define BOOST_FILESYSTEM_CODECVT_BUF_SIZE 256
-#endif
-
 namespace {
 
-BOOST_CONSTEXPR_OR_CONST std::size_t default_codecvt_buf_size = BOOST_FILESYSTEM_CODECVT_BUF_SIZE;
-
 //--------------------------------------------------------------------------------------//
 //                                                                                      //
-//  The public convert() functions do buffer management, and then forward to the        //
-//  convert_aux() functions for the actual call to the codecvt facet.                   //
+//  The public convert() functions estimate the size of the output, and then forward    //
+//  to the convert_aux() functions for the actual call to the codecvt facet, which      //
+//  converts directly into the target string.                                           //
 //                                                                                      //
 //--------------------------------------------------------------------------------------//
 
@@ -51,14 +51,12 @@ BOOST_CONSTEXPR_OR_CONST std::size_t default_codecvt_buf_size = BOOST_FILESYSTEM
 //                      convert_aux const char* to wstring                             //
 //--------------------------------------------------------------------------------------//
 
-void convert_aux(const char* from, const char* from_end, wchar_t* to, wchar_t* to_end, std::wstring& target, pt::codecvt_type const& cvt)
+void convert_aux(const char* from, const char* from_end, std::size_t buf_size, std::wstring& target, std::size_t target_size, pt::codecvt_type const& cvt)
 {
-    //std::cout << std::hex
-    //          << " from=" << std::size_t(from)
-    //          << " from_end=" << std::size_t(from_end)
-    //          << " to=" << std::size_t(to)
-    //          << " to_end=" << std::size_t(to_end)
-    //          << std::endl;
+    // Convert directly into the spare room of the target string, so that its capacity is reused across conversions
+    const std::size_t pos = target.size();
+    target.resize(pos + buf_size);
+    wchar_t* const to = &target[0] + pos;
 
     std::mbstate_t state = std::mbstate_t(); // perhaps unneeded, but cuts bug reports
     const char* from_next;
@@ -66,26 +64,25 @@ void convert_aux(const char* from, const char* from_end, wchar_t* to, wchar_t* t
 
     std::codecvt_base::result res;
 
-    if ((res = cvt.in(state, from, from_end, from_next, to, to_end, to_next)) != std::codecvt_base::ok)
+    if ((res = cvt.in(state, from, from_end, from_next, to, to + buf_size, to_next)) != std::codecvt_base::ok)
     {
         //std::cout << " result is " << static_cast<int>(res) << std::endl;
+        // Discard the characters converted before calling the facet, if any
+        target.resize(target_size);
         BOOST_FILESYSTEM_THROW(bs::system_error(res, fs::codecvt_error_category(), "boost::filesystem::path codecvt to wstring"));
     }
-    target.append(to, to_next);
+    target.resize(pos + (to_next - to));
 }
 
 //--------------------------------------------------------------------------------------//
 //                      convert_aux const wchar_t* to string                           //
 //--------------------------------------------------------------------------------------//
 
-void convert_aux(const wchar_t* from, const wchar_t* from_end, char* to, char* to_end, std::string& target, pt::codecvt_type const& cvt)
+void convert_aux(const wchar_t* from, const wchar_t* from_end, std::size_t buf_size, std::string& target, std::size_t target_size, pt::codecvt_type const& cvt)
 {
-    //std::cout << std::hex
-    //          << " from=" << std::size_t(from)
-    //          << " from_end=" << std::size_t(from_end)
-    //          << " to=" << std::size_t(to)
-    //          << " to_end=" << std::size_t(to_end)
-    //          << std::endl;
+    const std::size_t pos = target.size();
+    target.resize(pos + buf_size);
+    char* const to = &target[0] + pos;
 
     std::mbstate_t state = std::mbstate_t(); // perhaps unneeded, but cuts bug reports
     const wchar_t* from_next;
@@ -93,12 +90,229 @@ void convert_aux(const wchar_t* from, const wchar_t* from_end, char* to, char* t
 
     std::codecvt_base::result res;
 
-    if ((res = cvt.out(state, from, from_end, from_next, to, to_end, to_next)) != std::codecvt_base::ok)
+    if ((res = cvt.out(state, from, from_end, from_next, to, to + buf_size, to_next)) != std::codecvt_base::ok)
     {
         //std::cout << " result is " << static_cast<int>(res) << std::endl;
+        // Discard the characters converted before calling the facet, if any
+        target.resize(target_size);
         BOOST_FILESYSTEM_THROW(bs::system_error(res, fs::codecvt_error_category(), "boost::filesystem::path codecvt to string"));
     }
-    target.append(to, to_next);
+    target.resize(pos + (to_next - to));
+}
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//  Conversions that bypass the codecvt facet. These are only used with the facets      //
+//  implemented by the library, whose behavior is known.                                //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+//! Kinds of codecvt facets, for which conversions can be performed without calling the facet
+enum codecvt_kind
+{
+    //! Arbitrary facet, all conversions are performed by the facet
+    unknown_codecvt,
+    //! The facet converts ASCII characters to the same code points and vice versa
+    ascii_compatible_codecvt,
+    //! utf8_codecvt_facet, which is also ASCII-compatible
+    utf8_codecvt
+};
+
+inline codecvt_kind get_codecvt_kind(pt::codecvt_type const& cvt) BOOST_NOEXCEPT
+{
+#if !defined(BOOST_NO_RTTI)
+    // Compare exact types, as derived classes may alter the conversion
+    std::type_info const& type = typeid(cvt);
+    if (type == typeid(fs::detail::utf8_codecvt_facet))
+        return utf8_codecvt;
+#if defined(BOOST_WINDOWS_API)
+    if (type == typeid(fs::detail::windows_file_codecvt))
+        return ascii_compatible_codecvt;
+#endif
+#endif // !defined(BOOST_NO_RTTI)
+    return unknown_codecvt;
+}
+
+//! Returns the number of leading ASCII characters in the string
+inline std::size_t find_ascii_prefix_size(const char* from, const char* from_end) BOOST_NOEXCEPT
+{
+    const char* p = from;
+
+    // Test a machine word at a time
+    typedef std::size_t word_type;
+    BOOST_CONSTEXPR_OR_CONST word_type high_bits = (~static_cast< word_type >(0u)) / 0xFFu * 0x80u;
+    while (static_cast< std::size_t >(from_end - p) >= sizeof(word_type))
+    {
+        word_type word;
+        std::memcpy(&word, p, sizeof(word));
+        if ((word & high_bits) != 0u)
+            break;
+        p += sizeof(word_type);
+    }
+
+    while (p != from_end && static_cast< unsigned char >(*p) < 0x80u)
+        ++p;
+
+    return static_cast< std::size_t >(p - from);
+}
+
+//! Returns the number of leading ASCII characters in the string
+inline std::size_t find_ascii_prefix_size(const wchar_t* from, const wchar_t* from_end) BOOST_NOEXCEPT
+{
+    const wchar_t* p = from;
+
+    // Test a few characters at a time, without branching on each of them
+    while (static_cast< std::size_t >(from_end - p) >= 4u)
+    {
+        const boost::uint32_t bits = static_cast< boost::uint32_t >(p[0]) | static_cast< boost::uint32_t >(p[1]) |
+            static_cast< boost::uint32_t >(p[2]) | static_cast< boost::uint32_t >(p[3]);
+        if (bits >= 0x80u)
+            break;
+        p += 4;
+    }
+
+    while (p != from_end && static_cast< boost::uint32_t >(*p) < 0x80u)
+        ++p;
+
+    return static_cast< std::size_t >(p - from);
+}
+
+//! Converts UTF-8 to wchar_t with the same result as utf8_codecvt_facet
+/*!
+ * Converts the input up to the first character that is encoded with more than 4 octets or cannot be represented
+ * by a single \c wchar_t value. For such characters, the conversion must be continued by the facet.
+ * The output buffer must have room for <tt>from_end - from</tt> characters.
+ */
+std::codecvt_base::result utf8_to_wide(const char*& from, const char* from_end, wchar_t*& to) BOOST_NOEXCEPT
+{
+    const char* p = from;
+    wchar_t* out = to;
+    while (p != from_end)
+    {
+        const boost::uint32_t lead = static_cast< unsigned char >(*p);
+        if (lead < 0x80u)
+        {
+            // Non-ASCII text usually contains runs of ASCII characters, such as path separators and extensions
+            const std::size_t ascii_size = find_ascii_prefix_size(p, from_end);
+            for (std::size_t i = 0u; i < ascii_size; ++i)
+                out[i] = static_cast< wchar_t >(p[i]);
+            out += ascii_size;
+            p += ascii_size;
+            continue;
+        }
+
+        unsigned int cont_count;
+        boost::uint32_t code;
+        if (lead < 0xC0u)
+        {
+            from = p;
+            to = out;
+            return std::codecvt_base::error;
+        }
+        else if (lead < 0xE0u)
+        {
+            cont_count = 1u;
+            code = lead - 0xC0u;
+        }
+        else if (lead < 0xF0u)
+        {
+            cont_count = 2u;
+            code = lead - 0xE0u;
+        }
+        else if (lead < 0xF8u && sizeof(wchar_t) >= 4u)
+        {
+            cont_count = 3u;
+            code = lead - 0xF0u;
+        }
+        else
+        {
+            break;
+        }
+
+        const char* q = p + 1;
+        for (unsigned int i = 0u; i < cont_count; ++i, ++q)
+        {
+            if (q == from_end)
+            {
+                from = p;
+                to = out;
+                return std::codecvt_base::partial;
+            }
+
+            const boost::uint32_t octet = static_cast< unsigned char >(*q);
+            if (octet < 0x80u || octet > 0xBFu)
+            {
+                from = p;
+                to = out;
+                return std::codecvt_base::error;
+            }
+
+            code = (code << 6u) + (octet - 0x80u);
+        }
+
+        *out++ = static_cast< wchar_t >(code);
+        p = q;
+    }
+
+    from = p;
+    to = out;
+    return std::codecvt_base::ok;
+}
+
+//! Maximum number of octets produced by wide_to_utf8 for a single character
+BOOST_CONSTEXPR_OR_CONST std::size_t utf8_max_octets = sizeof(wchar_t) >= 4u ? 4u : 3u;
+
+//! Converts wchar_t to UTF-8 with the same result as utf8_codecvt_facet
+/*!
+ * Converts the input up to the first character that would be encoded with more than 4 octets. For such characters,
+ * the conversion must be continued by the facet. The output buffer must have room for
+ * <tt>(from_end - from) * utf8_max_octets</tt> characters.
+ */
+void wide_to_utf8(const wchar_t*& from, const wchar_t* from_end, char*& to) BOOST_NOEXCEPT
+{
+    const wchar_t* p = from;
+    char* out = to;
+    while (p != from_end)
+    {
+        const boost::uint32_t code = static_cast< boost::uint32_t >(*p);
+        if (code < 0x80u)
+        {
+            const std::size_t ascii_size = find_ascii_prefix_size(p, from_end);
+            for (std::size_t i = 0u; i < ascii_size; ++i)
+                out[i] = static_cast< char >(p[i]);
+            out += ascii_size;
+            p += ascii_size;
+            continue;
+        }
+
+        if (code < 0x800u)
+        {
+            *out++ = static_cast< char >(0xC0u | (code >> 6u));
+            *out++ = static_cast< char >(0x80u | (code & 0x3Fu));
+        }
+        else if (code < 0x10000u)
+        {
+            *out++ = static_cast< char >(0xE0u | (code >> 12u));
+            *out++ = static_cast< char >(0x80u | ((code >> 6u) & 0x3Fu));
+            *out++ = static_cast< char >(0x80u | (code & 0x3Fu));
+        }
+        else if (code < 0x200000u)
+        {
+            *out++ = static_cast< char >(0xF0u | (code >> 18u));
+            *out++ = static_cast< char >(0x80u | ((code >> 12u) & 0x3Fu));
+            *out++ = static_cast< char >(0x80u | ((code >> 6u) & 0x3Fu));
+            *out++ = static_cast< char >(0x80u | (code & 0x3Fu));
+        }
+        else
+        {
+            break;
+        }
+
+        ++p;
+    }
+
+    from = p;
+    to = out;
 }
 
 } // unnamed namespace
@@ -128,19 +342,41 @@ void convert(const char* from, const char* from_end, std::wstring& to, const cod
     if (!cvt)
         cvt = &fs::path::codecvt();
 
-    std::size_t buf_size = (from_end - from) * 3; // perhaps too large, but that's OK
-
-    //  dynamically allocate a buffer only if source is unusually large
-    if (buf_size > default_codecvt_buf_size)
+    const std::size_t initial_size = to.size();
+    const codecvt_kind kind = get_codecvt_kind(*cvt);
+    if (kind != unknown_codecvt)
     {
-        boost::scoped_array< wchar_t > buf(new wchar_t[buf_size]);
-        convert_aux(from, from_end, buf.get(), buf.get() + buf_size, to, *cvt);
-    }
-    else
-    {
-        wchar_t buf[default_codecvt_buf_size];
-        convert_aux(from, from_end, buf, buf + default_codecvt_buf_size, to, *cvt);
+        const std::size_t ascii_size = find_ascii_prefix_size(from, from_end);
+        to.resize(initial_size + ascii_size);
+        for (std::size_t i = 0u; i < ascii_size; ++i)
+            to[initial_size + i] = static_cast< wchar_t >(from[i]);
+
+        from += ascii_size;
+        if (from == from_end)
+            return;
+
+        if (kind == utf8_codecvt)
+        {
+            const std::size_t pos = to.size();
+            to.resize(pos + (from_end - from));
+            wchar_t* const out_begin = &to[0] + pos;
+            wchar_t* out = out_begin;
+            std::codecvt_base::result res = utf8_to_wide(from, from_end, out);
+            if (BOOST_UNLIKELY(res != std::codecvt_base::ok))
+            {
+                to.resize(initial_size);
+                BOOST_FILESYSTEM_THROW(bs::system_error(res, fs::codecvt_error_category(), "boost::filesystem::path codecvt to wstring"));
+            }
+
+            to.resize(pos + (out - out_begin));
+
+            if (from == from_end)
+                return;
+        }
     }
+
+    const std::size_t buf_size = (from_end - from) * 3; // perhaps too large, but that's OK
+    convert_aux(from, from_end, buf_size, to, initial_size, *cvt);
 }
 
 //--------------------------------------------------------------------------------------//
@@ -159,24 +395,39 @@ void convert(const wchar_t* from, const wchar_t* from_end, std::string& to, cons
     if (!cvt)
         cvt = &fs::path::codecvt();
 
+    const std::size_t initial_size = to.size();
+    const codecvt_kind kind = get_codecvt_kind(*cvt);
+    if (kind != unknown_codecvt)
+    {
+        const std::size_t ascii_size = find_ascii_prefix_size(from, from_end);
+        to.resize(initial_size + ascii_size);
+        for (std::size_t i = 0u; i < ascii_size; ++i)
+            to[initial_size + i] = static_cast< char >(from[i]);
+
+        from += ascii_size;
+        if (from == from_end)
+            return;
+
+        if (kind == utf8_codecvt)
+        {
+            const std::size_t pos = to.size();
+            to.resize(pos + (from_end - from) * utf8_max_octets);
+            char* const out_begin = &to[0] + pos;
+            char* out = out_begin;
+            wide_to_utf8(from, from_end, out);
+            to.resize(pos + (out - out_begin));
+            if (from == from_end)
+                return;
+        }
+    }
+
     //  The codecvt length functions may not be implemented, and I don't really
     //  understand them either. Thus this code is just a guess; if it turns
     //  out the buffer is too small then an error will be reported and the code
     //  will have to be fixed.
     std::size_t buf_size = (from_end - from) * 4; // perhaps too large, but that's OK
     buf_size += 4;                                // encodings like shift-JIS need some prefix space
-
-    //  dynamically allocate a buffer only if source is unusually large
-    if (buf_size > default_codecvt_buf_size)
-    {
-        boost::scoped_array< char > buf(new char[buf_size]);
-        convert_aux(from, from_end, buf.get(), buf.get() + buf_size, to, *cvt);
-    }
-    else
-    {
-        char buf[default_codecvt_buf_size];
-        convert_aux(from, from_end, buf, buf + default_codecvt_buf_size, to, *cvt);
-    }
+    convert_aux(from, from_end, buf_size, to, initial_size, *cvt);
 }
 
 } // namespace path_traits
@@ -24,57 +24,216 @@ namespace filesystem {
 
 namespace {
 
-BOOST_CONSTEXPR_OR_CONST char windows_invalid_chars[] =
-    "\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0A\x0B\x0C\x0D\x0E\x0F"
-    "\x10\x11\x12\x13\x14\x15\x16\x17\x18\x19\x1A\x1B\x1C\x1D\x1E\x1F"
-    "<>:\"/\\|";
+//! Character classes used by the name checks
+enum char_class
+{
+    char_not_posix = 1u,       //!< Not in the POSIX portable filename character set
+    char_windows_invalid = 2u, //!< Not allowed in Windows names
+    char_slash = 4u,           //!< Forward slash
+    char_dot = 8u              //!< Dot. Must be the highest bit, it is used to count dots.
+};
+
+//! Combinations of \c char_class values for every character
+BOOST_CONSTEXPR_OR_CONST unsigned char char_classes[256] =
+{
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, // 0x00
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, // 0x10
+    1, 1, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 8, 7, // 0x20
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 1, 3, 1, 3, 1, // 0x30
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x40
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 3, 1, 1, 0, // 0x50
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x60
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 3, 1, 1, 1, // 0x70
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x80
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x90
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0xA0
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0xB0
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0xC0
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0xD0
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0xE0
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 // 0xF0
+};
+
+//! Reserved Windows device name, which may require a number suffix
+struct device_name
+{
+    char name[4];
+    bool numbered;
+};
+
+/*!
+ * Reserved Windows device names (CON, PRN, AUX, NUL, COMn, LPTn), indexed by the hash of the first three upper case characters
+ * computed by \c device_name_hash. The hash is perfect for these names.
+ */
+BOOST_CONSTEXPR_OR_CONST device_name device_names[8] =
+{
+    { "LPT", true },
+    { "NUL", false },
+    { "", false },
+    { "", false },
+    { "CON", false },
+    { "COM", true },
+    { "PRN", false },
+    { "AUX", false }
+};
+
+inline unsigned int device_name_hash(unsigned int c0, unsigned int c1, unsigned int c2) BOOST_NOEXCEPT
+{
+    return (((c0 * 3u) ^ c1 ^ c2) >> 1) & 7u;
+}
 
-BOOST_CONSTEXPR_OR_CONST char posix_valid_chars[] =
-    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789._-";
+inline unsigned int to_upper_ascii(char c) BOOST_NOEXCEPT
+{
+    const unsigned int uc = static_cast< unsigned char >(c);
+    return (uc >= 'a' && uc <= 'z') ? uc - ('a' - 'A') : uc;
+}
 
-} // unnamed namespace
+//! Returns \c true if the name, without the extension and trailing spaces, is a reserved Windows device name
+bool is_windows_device_name(const char* name, std::size_t size) BOOST_NOEXCEPT
+{
+    const char* const dot = static_cast< const char* >(std::memchr(name, '.', size));
+    std::size_t base_size = dot ? static_cast< std::size_t >(dot - name) : size;
+    while (base_size > 0u && name[base_size - 1u] == ' ')
+        --base_size;
 
-//  name_check functions  ----------------------------------------------//
+    if (base_size < 3u || base_size > 5u)
+        return false;
 
-#ifdef BOOST_WINDOWS
-BOOST_FILESYSTEM_DECL bool native(std::string const& name)
-{
-    return windows_name(name);
+    const unsigned int c0 = to_upper_ascii(name[0]), c1 = to_upper_ascii(name[1]), c2 = to_upper_ascii(name[2]);
+    device_name const& dev = device_names[device_name_hash(c0, c1, c2)];
+    if (static_cast< unsigned char >(dev.name[0]) != c0 || static_cast< unsigned char >(dev.name[1]) != c1 || static_cast< unsigned char >(dev.name[2]) != c2)
+        return false;
+
+    if (!dev.numbered)
+        return base_size == 3u;
+
+    if (base_size == 4u)
+        return name[3] >= '0' && name[3] <= '9';
+
+    // Superscript digits 1, 2 and 3 in UTF-8
+    const unsigned int d0 = static_cast< unsigned char >(name[3]), d1 = static_cast< unsigned char >(name[4]);
+    return base_size == 5u && d0 == 0xC2u && (d1 == 0xB9u || d1 == 0xB2u || d1 == 0xB3u);
 }
+
+//! Checks the name against the rules, which are a combination of \c name_rules values
+bool check_name_impl(const char* name, std::size_t size, unsigned int rules) BOOST_NOEXCEPT
+{
+    if (size == 0u)
+        return (rules & ~static_cast< unsigned int >(name_rules::no_windows_device_name)) == 0u;
+
+    // Collect the classes of all characters in one pass
+    unsigned int classes = 0u;
+    std::size_t dot_count = 0u;
+    for (std::size_t i = 0u; i < size; ++i)
+    {
+        const unsigned int c = char_classes[static_cast< unsigned char >(name[i])];
+        classes |= c;
+        dot_count += c >> 3u;
+    }
+
+    const char first = name[0], last = name[size - 1u];
+    const bool is_dot = size == 1u && first == '.';
+    const bool is_dot_dot = size == 2u && first == '.' && last == '.';
+
+    if ((rules & static_cast< unsigned int >(name_rules::native)) != 0u)
+    {
+#ifdef BOOST_WINDOWS
+        rules |= static_cast< unsigned int >(name_rules::windows);
 #else
+        if (first == ' ' || (classes & char_slash) != 0u)
+            return false;
+#endif
+    }
+
+    const bool posix_ok = (classes & char_not_posix) == 0u;
+    const bool windows_ok = first != ' ' && (classes & char_windows_invalid) == 0u && last != ' ' && (last != '.' || size == 1u || is_dot_dot);
+    const bool portable_ok = is_dot || is_dot_dot || (windows_ok && posix_ok && first != '.' && first != '-');
+
+    if ((rules & static_cast< unsigned int >(name_rules::portable_posix)) != 0u && !posix_ok)
+        return false;
+
+    if ((rules & static_cast< unsigned int >(name_rules::windows)) != 0u && !windows_ok)
+        return false;
+
+    if ((rules & static_cast< unsigned int >(name_rules::portable)) != 0u && !portable_ok)
+        return false;
+
+    if ((rules & static_cast< unsigned int >(name_rules::portable_directory)) != 0u && !(is_dot || is_dot_dot || (portable_ok && dot_count == 0u)))
+        return false;
+
+    if ((rules & static_cast< unsigned int >(name_rules::portable_file)) != 0u)
+    {
+        if (!portable_ok || is_dot || is_dot_dot || dot_count > 1u)
+            return false;
+
+        // An extension is at most 3 characters long
+        if (dot_count == 1u && static_cast< std::size_t >(static_cast< const char* >(std::memchr(name, '.', size)) - name) + 5u <= size)
+            return false;
+    }
+
+    if ((rules & static_cast< unsigned int >(name_rules::no_windows_device_name)) != 0u && is_windows_device_name(name, size))
+        return false;
+
+    return true;
+}
+
+} // unnamed namespace
+
+//  name_check functions  ----------------------------------------------//
+
 BOOST_FILESYSTEM_DECL bool native(std::string const& name)
 {
-    return !name.empty() && name[0] != ' ' && name.find('/') == std::string::npos;
+    return check_name_impl(name.data(), name.size(), static_cast< unsigned int >(name_rules::native));
 }
-#endif
 
 BOOST_FILESYSTEM_DECL bool portable_posix_name(std::string const& name)
 {
-    return !name.empty() && name.find_first_not_of(posix_valid_chars, 0, sizeof(posix_valid_chars) - 1) == std::string::npos;
+    return check_name_impl(name.data(), name.size(), static_cast< unsigned int >(name_rules::portable_posix));
 }
 
 BOOST_FILESYSTEM_DECL bool windows_name(std::string const& name)
 {
-    // note that the terminating '\0' is part of the string - thus the size below
-    // is sizeof(windows_invalid_chars) rather than sizeof(windows_invalid_chars)-1.
-    return !name.empty() && name[0] != ' ' && name.find_first_of(windows_invalid_chars, 0, sizeof(windows_invalid_chars)) == std::string::npos
-        && *(name.end() - 1) != ' ' && (*(name.end() - 1) != '.' || name.size() == 1 || name == "..");
+    return check_name_impl(name.data(), name.size(), static_cast< unsigned int >(name_rules::windows));
 }
 
 BOOST_FILESYSTEM_DECL bool portable_name(std::string const& name)
 {
-    return !name.empty() && (name == "." || name == ".." || (windows_name(name) && portable_posix_name(name) && name[0] != '.' && name[0] != '-'));
+    return check_name_impl(name.data(), name.size(), static_cast< unsigned int >(name_rules::portable));
 }
 
 BOOST_FILESYSTEM_DECL bool portable_directory_name(std::string const& name)
 {
-    return name == "." || name == ".." || (portable_name(name) && name.find('.') == std::string::npos);
+    return check_name_impl(name.data(), name.size(), static_cast< unsigned int >(name_rules::portable_directory));
 }
 
 BOOST_FILESYSTEM_DECL bool portable_file_name(std::string const& name)
 {
-    std::string::size_type pos;
-    return portable_name(name) && name != "." && name != ".." && ((pos = name.find('.')) == std::string::npos || (name.find('.', pos + 1) == std::string::npos && (pos + 5) > name.size()));
+    return check_name_impl(name.data(), name.size(), static_cast< unsigned int >(name_rules::portable_file));
+}
+
+BOOST_FILESYSTEM_DECL bool check_name(const char* name, std::size_t size, BOOST_SCOPED_ENUM_NATIVE(name_rules) rules) BOOST_NOEXCEPT
+{
+    return check_name_impl(name, size, static_cast< unsigned int >(rules));
+}
+
+BOOST_FILESYSTEM_DECL std::size_t check_names(const char* const* names, const std::size_t* sizes, std::size_t count, BOOST_SCOPED_ENUM_NATIVE(name_rules) rules, boost::uint64_t* failures) BOOST_NOEXCEPT
+{
+    std::size_t failed_count = 0u;
+    for (std::size_t pos = 0u; pos < count; pos += 64u)
+    {
+        const std::size_t n = (count - pos) < 64u ? (count - pos) : 64u;
+        boost::uint64_t word = 0u;
+        for (std::size_t i = 0u; i < n; ++i)
+        {
+            const unsigned int failed = !check_name_impl(names[pos + i], sizes[pos + i], static_cast< unsigned int >(rules));
+            word |= static_cast< boost::uint64_t >(failed) << i;
+            failed_count += failed;
+        }
+
+        failures[pos / 64u] = word;
+    }
+
+    return failed_count;
 }
 
 } // namespace filesystem
@@ -15,9 +15,24 @@
 #include "platform_config.hpp"
 #include <cerrno>
 #include <boost/filesystem/config.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <sys/types.h>
+#include <sys/stat.h>
 #ifdef BOOST_HAS_UNISTD_H
 #include <unistd.h>
 #endif
+#if defined(linux) || defined(__linux) || defined(__linux__)
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/utsname.h>
+// statx flags defined since Linux 4.11
+#if !defined(AT_STATX_FORCE_SYNC)
+#define AT_STATX_FORCE_SYNC 0x2000
+#endif
+#if !defined(AT_STATX_DONT_SYNC)
+#define AT_STATX_DONT_SYNC 0x4000
+#endif
+#endif
 
 #include <boost/filesystem/detail/header.hpp> // must be the last #include
 
@@ -31,6 +46,11 @@ struct directory_iterator_params
 #if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
     //! File descriptor of the base directory relative to which to interpret relative paths
     int basedir_fd;
+    /*!
+     * If not \c NULL, the path to the directory to open, relative to \c basedir_fd, instead of the directory path passed
+     * to the iterator. The directory path passed to the iterator is still used to compose paths of the directory entries.
+     */
+    const char* open_path;
 #endif
 #if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW)
     //! File descriptor of the directory over which the iterator iterates
@@ -72,6 +92,80 @@ inline int close_fd(int fd)
 #endif
 }
 
+//! Closes the file descriptor on destruction
+struct fd_wrapper
+{
+    int fd;
+
+    fd_wrapper() BOOST_NOEXCEPT : fd(-1) {}
+    explicit fd_wrapper(int fd) BOOST_NOEXCEPT : fd(fd) {}
+    ~fd_wrapper() BOOST_NOEXCEPT
+    {
+        if (fd >= 0)
+            close_fd(fd);
+    }
+    BOOST_DELETED_FUNCTION(fd_wrapper(fd_wrapper const&))
+    BOOST_DELETED_FUNCTION(fd_wrapper& operator=(fd_wrapper const&))
+};
+
+//! Converts file type and permissions from \c stat or \c statx structure to file status
+inline file_status make_file_status(mode_t mode) BOOST_NOEXCEPT
+{
+    const perms prms = static_cast< perms >(mode) & perms_mask;
+    if (S_ISREG(mode))
+        return file_status(regular_file, prms);
+    if (S_ISDIR(mode))
+        return file_status(directory_file, prms);
+    if (S_ISLNK(mode))
+        return file_status(symlink_file, prms);
+    if (S_ISBLK(mode))
+        return file_status(block_file, prms);
+    if (S_ISCHR(mode))
+        return file_status(character_file, prms);
+    if (S_ISFIFO(mode))
+        return file_status(fifo_file, prms);
+    if (S_ISSOCK(mode))
+        return file_status(socket_file, prms);
+
+    return file_status(type_unknown);
+}
+
+#if defined(linux) || defined(__linux) || defined(__linux__)
+
+//! Obtains the version of the running Linux kernel. Returns \c false and leaves the arguments unchanged if the version cannot be determined.
+inline bool get_linux_kernel_version(unsigned int& major_ver, unsigned int& minor_ver, unsigned int& patch_ver) BOOST_NOEXCEPT
+{
+    struct ::utsname system_info;
+    if (BOOST_UNLIKELY(::uname(&system_info) < 0))
+        return false;
+
+    unsigned int major = 0u, minor = 0u, patch = 0u;
+    int count = std::sscanf(system_info.release, "%u.%u.%u", &major, &minor, &patch);
+    if (BOOST_UNLIKELY(count < 3))
+        return false;
+
+    major_ver = major;
+    minor_ver = minor;
+    patch_ver = patch;
+    return true;
+}
+
+//! Returns the \c statx flags that request the given \c status_consistency
+inline int get_statx_sync_flags(unsigned int consistency) BOOST_NOEXCEPT
+{
+    switch (consistency)
+    {
+    case static_cast< unsigned int >(status_consistency::force_sync):
+        return AT_STATX_FORCE_SYNC;
+    case static_cast< unsigned int >(status_consistency::dont_sync):
+        return AT_STATX_DONT_SYNC;
+    default:
+        return 0;
+    }
+}
+
+#endif // defined(linux) || defined(__linux) || defined(__linux__)
+
 } // namespace detail
 } // namespace filesystem
 } // namespace boost
@@ -0,0 +1,495 @@
+//  prefetch.cpp  ----------------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <cstddef>
+#include <new> // std::bad_alloc
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#if defined(BOOST_POSIX_API)
+
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+// At least Mac OS X 10.6 and older doesn't support O_CLOEXEC
+#ifndef O_CLOEXEC
+#define O_CLOEXEC 0
+#endif
+
+#if defined(POSIX_FADV_WILLNEED) && !defined(__APPLE__) && (!defined(__ANDROID__) || __ANDROID_API__ >= 21)
+#define BOOST_FILESYSTEM_HAS_POSIX_FADVISE
+#endif
+
+#include "posix_tools.hpp"
+
+#else // BOOST_WINDOWS_API
+
+#include <boost/winapi/dll.hpp> // get_proc_address, GetModuleHandleW
+#include <windows.h>
+
+#endif // BOOST_WINDOWS_API
+
+#include "thread_tools.hpp"
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+#include <atomic>
+#endif
+
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+namespace {
+
+//! A file to prefetch
+struct prefetch_entry
+{
+    path file;
+    //! Number of bytes to prefetch from the beginning of the file
+    uintmax_t length;
+    //! Error of collecting or prefetching the file
+    system::error_code error;
+
+    prefetch_entry(path const& p, uintmax_t len) : file(p), length(len) {}
+};
+
+//! Size of the buffer used to read the files when the system does not support prefetching
+BOOST_CONSTEXPR_OR_CONST std::size_t prefetch_read_buf_size = 64u * 1024u;
+
+#if defined(BOOST_POSIX_API)
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_FADVISE) || defined(F_RDADVISE)
+//! Maximum amount of data to request with one call. Linux silently truncates readahead requests to the device readahead limit,
+//! which is 128 KiB by default, so larger requests would only prefetch the beginning of the range.
+BOOST_CONSTEXPR_OR_CONST uintmax_t prefetch_advice_size = 128u * 1024u;
+#endif
+
+//! Requests the first \a length bytes of the file \a p to be read into the page cache
+err_t prefetch_file(path const& p, uintmax_t length)
+{
+    fd_wrapper fd(::open(p.c_str(), O_RDONLY | O_NOCTTY | O_CLOEXEC));
+    if (BOOST_UNLIKELY(fd.fd < 0))
+        return errno;
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_FADVISE)
+
+    for (uintmax_t offset = 0u; offset < length; offset += prefetch_advice_size)
+    {
+        const uintmax_t size = (length - offset) < prefetch_advice_size ? (length - offset) : prefetch_advice_size;
+        // Note: posix_fadvise returns the error code instead of setting errno
+        const int err = ::posix_fadvise(fd.fd, static_cast< off_t >(offset), static_cast< off_t >(size), POSIX_FADV_WILLNEED);
+        if (BOOST_UNLIKELY(err != 0))
+        {
+            // ESPIPE or EINVAL mean the file does not support advice, fall back to reading it
+            if (err != ESPIPE && err != EINVAL)
+                return err;
+
+            goto read_data;
+        }
+    }
+
+    return 0;
+
+read_data:
+
+#elif defined(F_RDADVISE)
+
+    for (uintmax_t offset = 0u; offset < length; offset += prefetch_advice_size)
+    {
+        struct radvisory ra;
+        ra.ra_offset = static_cast< off_t >(offset);
+        ra.ra_count = static_cast< int >((length - offset) < prefetch_advice_size ? (length - offset) : prefetch_advice_size);
+        if (BOOST_UNLIKELY(::fcntl(fd.fd, F_RDADVISE, &ra) < 0))
+        {
+            const int err = errno;
+            if (err != ENOTSUP && err != EINVAL)
+                return err;
+
+            goto read_data;
+        }
+    }
+
+    return 0;
+
+read_data:
+
+#endif
+
+    // The system cannot prefetch the file in background, so read it here
+    char buf[prefetch_read_buf_size];
+    for (uintmax_t offset = 0u; offset < length;)
+    {
+        const std::size_t size = (length - offset) < sizeof(buf) ? static_cast< std::size_t >(length - offset) : sizeof(buf);
+        const ssize_t n = ::pread(fd.fd, buf, size, static_cast< off_t >(offset));
+        if (BOOST_UNLIKELY(n < 0))
+        {
+            const int err = errno;
+            if (err == EINTR)
+                continue;
+            return err;
+        }
+
+        if (n == 0)
+            break;
+
+        offset += static_cast< uintmax_t >(n);
+    }
+
+    return 0;
+}
+
+#else // defined(BOOST_POSIX_API)
+
+//! WIN32_MEMORY_RANGE_ENTRY definition from Windows SDK
+struct win32_memory_range_entry
+{
+    PVOID VirtualAddress;
+    SIZE_T NumberOfBytes;
+};
+
+//! PrefetchVirtualMemory signature. Available since Windows 8.
+typedef BOOL (WINAPI PrefetchVirtualMemory_t)(
+    /*__in*/ HANDLE hProcess,
+    /*__in*/ ULONG_PTR NumberOfEntries,
+    /*__in*/ win32_memory_range_entry* VirtualAddresses,
+    /*__in*/ ULONG Flags);
+
+//! Maximum size of a file view that is mapped to prefetch the file contents. Limits the address space use in 32-bit processes.
+BOOST_CONSTEXPR_OR_CONST uintmax_t prefetch_view_size = 64u * 1024u * 1024u;
+
+//! Closes the handle on destruction
+struct prefetch_handle_wrapper
+{
+    HANDLE handle;
+
+    explicit prefetch_handle_wrapper(HANDLE h) BOOST_NOEXCEPT : handle(h) {}
+    ~prefetch_handle_wrapper() BOOST_NOEXCEPT
+    {
+        if (handle != NULL && handle != INVALID_HANDLE_VALUE)
+            ::CloseHandle(handle);
+    }
+
+    BOOST_DELETED_FUNCTION(prefetch_handle_wrapper(prefetch_handle_wrapper const&))
+    BOOST_DELETED_FUNCTION(prefetch_handle_wrapper& operator=(prefetch_handle_wrapper const&))
+};
+
+//! Returns a pointer to PrefetchVirtualMemory, or \c NULL if not supported
+PrefetchVirtualMemory_t* get_prefetch_virtual_memory() BOOST_NOEXCEPT
+{
+    HMODULE h = ::GetModuleHandleW(L"kernel32.dll");
+    if (BOOST_UNLIKELY(h == NULL))
+        return NULL;
+
+    return (PrefetchVirtualMemory_t*)boost::winapi::get_proc_address(h, "PrefetchVirtualMemory");
+}
+
+//! Requests the first \a length bytes of the file \a p to be read into the file cache
+err_t prefetch_file(path const& p, uintmax_t length)
+{
+    prefetch_handle_wrapper file(::CreateFileW(
+        p.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        NULL));
+    if (BOOST_UNLIKELY(file.handle == INVALID_HANDLE_VALUE))
+        return ::GetLastError();
+
+    PrefetchVirtualMemory_t* prefetch_virtual_memory = get_prefetch_virtual_memory();
+    if (prefetch_virtual_memory != NULL)
+    {
+        prefetch_handle_wrapper mapping(::CreateFileMappingW(file.handle, NULL, PAGE_READONLY, 0u, 0u, NULL));
+        if (BOOST_UNLIKELY(mapping.handle == NULL))
+            return ::GetLastError();
+
+        // The prefetched pages remain in the file cache after the views are unmapped
+        for (uintmax_t offset = 0u; offset < length; offset += prefetch_view_size)
+        {
+            const std::size_t size = static_cast< std::size_t >((length - offset) < prefetch_view_size ? (length - offset) : prefetch_view_size);
+            void* addr = ::MapViewOfFile(mapping.handle, FILE_MAP_READ, static_cast< DWORD >(offset >> 32u), static_cast< DWORD >(offset), size);
+            if (BOOST_UNLIKELY(addr == NULL))
+                return ::GetLastError();
+
+            win32_memory_range_entry range;
+            range.VirtualAddress = addr;
+            range.NumberOfBytes = size;
+            prefetch_virtual_memory(::GetCurrentProcess(), 1u, &range, 0u);
+
+            ::UnmapViewOfFile(addr);
+        }
+
+        return 0u;
+    }
+
+    // Windows 7 and older cannot prefetch the file in background, so read it here
+    char buf[prefetch_read_buf_size];
+    for (uintmax_t offset = 0u; offset < length;)
+    {
+        const DWORD size = static_cast< DWORD >((length - offset) < sizeof(buf) ? (length - offset) : sizeof(buf));
+        DWORD n = 0u;
+        if (BOOST_UNLIKELY(!::ReadFile(file.handle, buf, size, &n, NULL)))
+            return ::GetLastError();
+
+        if (n == 0u)
+            break;
+
+        offset += n;
+    }
+
+    return 0u;
+}
+
+#endif // defined(BOOST_POSIX_API)
+
+//! Collects the files to prefetch, up to the byte budget
+class prefetch_collector
+{
+private:
+    std::vector< prefetch_entry >& m_entries;
+    const unsigned int m_options;
+    uintmax_t m_budget;
+
+public:
+    prefetch_collector(std::vector< prefetch_entry >& entries, unsigned int options, uintmax_t budget) BOOST_NOEXCEPT :
+        m_entries(entries),
+        m_options(options),
+        m_budget(budget)
+    {
+    }
+
+    //! Returns \c true if the budget is exhausted
+    bool is_exhausted() const BOOST_NOEXCEPT { return m_budget == 0u; }
+
+    //! Adds the path given by the user
+    void add(path const& p)
+    {
+        system::error_code ec;
+        const file_status st = detail::status(p, &ec);
+        if (BOOST_UNLIKELY(!!ec))
+        {
+            add_error(p, ec);
+            return;
+        }
+
+        if (filesystem::is_regular_file(st))
+        {
+            const uintmax_t size = detail::file_size(p, &ec);
+            if (BOOST_UNLIKELY(!!ec))
+                add_error(p, ec);
+            else
+                add_file(p, size);
+        }
+        else if (filesystem::is_directory(st) && (m_options & static_cast< unsigned int >(prefetch_options::recursive)) != 0u)
+        {
+            add_directory(p);
+        }
+    }
+
+    BOOST_DELETED_FUNCTION(prefetch_collector(prefetch_collector const&))
+    BOOST_DELETED_FUNCTION(prefetch_collector& operator=(prefetch_collector const&))
+
+private:
+    void add_file(path const& p, uintmax_t size)
+    {
+        if (size > m_budget)
+            size = m_budget;
+        m_budget -= size;
+        if (size > 0u)
+            m_entries.push_back(prefetch_entry(p, size));
+    }
+
+    void add_error(path const& p, system::error_code const& ec)
+    {
+        m_entries.push_back(prefetch_entry(p, 0u));
+        m_entries.back().error = ec;
+    }
+
+    void add_directory(path const& p)
+    {
+        unsigned int dir_options = static_cast< unsigned int >(directory_options::skip_permission_denied);
+        if ((m_options & static_cast< unsigned int >(prefetch_options::follow_directory_symlink)) != 0u)
+            dir_options |= static_cast< unsigned int >(directory_options::follow_directory_symlink);
+
+        system::error_code ec;
+        recursive_directory_iterator it(p, static_cast< BOOST_SCOPED_ENUM_NATIVE(directory_options) >(dir_options), ec);
+        while (BOOST_LIKELY(!ec) && it != recursive_directory_iterator() && m_budget > 0u)
+        {
+            directory_entry const& entry = *it;
+            const file_status st = entry.status(ec);
+            if (BOOST_LIKELY(!ec) && filesystem::is_regular_file(st))
+            {
+                const uintmax_t size = entry.file_size(ec);
+                if (BOOST_LIKELY(!ec))
+                    add_file(entry.path(), size);
+            }
+
+            if (BOOST_UNLIKELY(!!ec))
+            {
+                // Broken symlinks and files that were removed while iterating are not errors
+                if (ec != system::errc::no_such_file_or_directory)
+                    add_error(entry.path(), ec);
+                ec.clear();
+            }
+
+            it.increment(ec);
+        }
+
+        if (BOOST_UNLIKELY(!!ec))
+            add_error(p, ec);
+    }
+};
+
+//! Prefetches the file of the entry, unless collecting it failed
+void prefetch_entry_contents(prefetch_entry& entry) BOOST_NOEXCEPT
+{
+    if (!entry.error)
+    {
+        const err_t err = prefetch_file(entry.file, entry.length);
+        if (BOOST_UNLIKELY(err != 0))
+            entry.error.assign(err, system::system_category());
+    }
+}
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+//! Minimum number of files to prefetch per thread
+BOOST_CONSTEXPR_OR_CONST std::size_t prefetch_min_files_per_thread = 8u;
+
+//! Function object that prefetches files in multiple threads
+class threaded_prefetcher
+{
+private:
+    prefetch_entry* const m_entries;
+    const std::size_t m_count;
+    std::atomic< std::size_t > m_next;
+
+public:
+    threaded_prefetcher(prefetch_entry* entries, std::size_t count) BOOST_NOEXCEPT :
+        m_entries(entries),
+        m_count(count),
+        m_next(0u)
+    {
+    }
+
+    BOOST_DELETED_FUNCTION(threaded_prefetcher(threaded_prefetcher const&))
+    BOOST_DELETED_FUNCTION(threaded_prefetcher& operator=(threaded_prefetcher const&))
+
+    void operator()(unsigned int) BOOST_NOEXCEPT
+    {
+        while (true)
+        {
+            const std::size_t pos = m_next.fetch_add(1u, std::memory_order_relaxed);
+            if (pos >= m_count)
+                break;
+
+            prefetch_entry_contents(m_entries[pos]);
+        }
+    }
+};
+
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+//! Prefetches the collected files, using multiple threads, if possible
+void prefetch_entries(prefetch_entry* entries, std::size_t count, unsigned int thread_count)
+{
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+    thread_count = get_thread_count(thread_count);
+    if (static_cast< std::size_t >(thread_count) > count / prefetch_min_files_per_thread)
+        thread_count = static_cast< unsigned int >(count / prefetch_min_files_per_thread);
+
+    if (thread_count > 1u)
+    {
+        threaded_prefetcher prefetcher(entries, count);
+        run_in_threads(thread_count, prefetcher);
+        return;
+    }
+#else
+    (void)thread_count;
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+    for (std::size_t i = 0u; i < count; ++i)
+        prefetch_entry_contents(entries[i]);
+}
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL
+uintmax_t prefetch(path const* paths, std::size_t count, unsigned int options, uintmax_t max_bytes, unsigned int thread_count, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    try
+    {
+        std::vector< prefetch_entry > entries;
+        prefetch_collector collector(entries, options, max_bytes);
+        for (std::size_t i = 0u; i < count && !collector.is_exhausted(); ++i)
+            collector.add(paths[i]);
+
+        if (entries.empty())
+            return 0u;
+
+        prefetch_entries(&entries[0], entries.size(), thread_count);
+
+        uintmax_t prefetched = 0u;
+        prefetch_entry const* failed = NULL;
+        for (std::size_t i = 0u, n = entries.size(); i < n; ++i)
+        {
+            prefetch_entry const& entry = entries[i];
+            if (BOOST_LIKELY(!entry.error))
+                prefetched += entry.length;
+            else if (!failed)
+                failed = &entry;
+        }
+
+        if (BOOST_UNLIKELY(failed != NULL))
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::prefetch", failed->file, failed->error));
+            *ec = failed->error;
+        }
+
+        return prefetched;
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return 0u;
+    }
+}
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
@@ -0,0 +1,370 @@
+//  status_batch.cpp  ------------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <cstddef>
+#include <new> // std::bad_alloc
+#include <vector>
+#include <boost/system/error_code.hpp>
+
+#include "io_uring_tools.hpp"
+#include "thread_tools.hpp"
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+#include <atomic>
+#endif
+
+#include "atomic_tools.hpp"
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+namespace {
+
+//! Queries statuses of the given range of paths one by one
+struct status_range
+{
+    unsigned int consistency;
+
+    explicit status_range(unsigned int c) BOOST_NOEXCEPT : consistency(c) {}
+
+    void operator()(path const* paths, std::size_t count, file_status* results) const BOOST_NOEXCEPT
+    {
+        for (std::size_t i = 0u; i < count; ++i)
+        {
+            system::error_code ec;
+            results[i] = detail::status(paths[i], consistency, &ec);
+        }
+    }
+};
+
+//! Queries attributes of the given range of paths one by one
+struct attributes_range
+{
+    unsigned int mask;
+
+    explicit attributes_range(unsigned int m) BOOST_NOEXCEPT : mask(m) {}
+
+    void operator()(path const* paths, std::size_t count, file_attributes* results) const BOOST_NOEXCEPT
+    {
+        for (std::size_t i = 0u; i < count; ++i)
+        {
+            system::error_code ec;
+            results[i] = detail::query(paths[i], mask, &ec);
+        }
+    }
+};
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+//! Minimum number of paths to query per thread
+BOOST_CONSTEXPR_OR_CONST std::size_t status_batch_min_paths_per_thread = 256u;
+//! Number of paths a thread claims at once
+BOOST_CONSTEXPR_OR_CONST std::size_t status_batch_chunk_size = 64u;
+
+//! Function object that runs a range query in multiple threads
+template< typename RangeQuery, typename Result >
+class threaded_batch_query
+{
+private:
+    RangeQuery const m_range_query;
+    path const* const m_paths;
+    const std::size_t m_count;
+    Result* const m_results;
+    std::atomic< std::size_t > m_next;
+
+public:
+    threaded_batch_query(RangeQuery const& range_query, path const* paths, std::size_t count, Result* results) BOOST_NOEXCEPT :
+        m_range_query(range_query),
+        m_paths(paths),
+        m_count(count),
+        m_results(results),
+        m_next(0u)
+    {
+    }
+
+    BOOST_DELETED_FUNCTION(threaded_batch_query(threaded_batch_query const&))
+    BOOST_DELETED_FUNCTION(threaded_batch_query& operator=(threaded_batch_query const&))
+
+    void operator()(unsigned int) BOOST_NOEXCEPT
+    {
+        while (true)
+        {
+            const std::size_t pos = m_next.fetch_add(status_batch_chunk_size, std::memory_order_relaxed);
+            if (pos >= m_count)
+                break;
+
+            const std::size_t n = (m_count - pos) < status_batch_chunk_size ? (m_count - pos) : status_batch_chunk_size;
+            m_range_query(m_paths + pos, n, m_results + pos);
+        }
+    }
+};
+
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+//! Runs a range query using multiple threads, if possible
+template< typename RangeQuery, typename Result >
+void batch_threaded(RangeQuery const& range_query, path const* paths, std::size_t count, Result* results)
+{
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+    if (count >= status_batch_min_paths_per_thread * 2u)
+    {
+        unsigned int thread_count = get_thread_count(0u);
+        if (static_cast< std::size_t >(thread_count) > count / status_batch_min_paths_per_thread)
+            thread_count = static_cast< unsigned int >(count / status_batch_min_paths_per_thread);
+
+        if (thread_count > 1u)
+        {
+            threaded_batch_query< RangeQuery, Result > query(range_query, paths, count, results);
+            run_in_threads(thread_count, query);
+            return;
+        }
+    }
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+    range_query(paths, count, results);
+}
+
+#if defined(BOOST_FILESYSTEM_USE_IO_URING)
+
+//! Indicates whether io_uring with IORING_OP_STATX is supported by the kernel
+bool g_io_uring_statx_supported = true;
+
+//! Maximum number of statx requests in flight
+BOOST_CONSTEXPR_OR_CONST unsigned int io_uring_queue_depth = 256u;
+
+/*!
+ * Queries statuses by submitting statx requests to io_uring. Returns 0 on success, \c ENOSYS if io_uring or IORING_OP_STATX
+ * is not supported, in which case no statuses were queried, or a different error code.
+ *
+ * \a paths must support indexing with \c path const& as the result, e.g. be a pointer to an array of paths.
+ * \a sync_flags are the \c statx flags that select the consistency of the statuses.
+ */
+template< typename Paths >
+int status_batch_io_uring(Paths const& paths, std::size_t count, file_status* results, int sync_flags = 0)
+{
+    const unsigned int queue_depth = count < io_uring_queue_depth ? static_cast< unsigned int >(count) : io_uring_queue_depth;
+
+    io_uring_instance ring;
+    int err = ring.init(queue_depth);
+    if (BOOST_UNLIKELY(err != 0))
+    {
+        // io_uring may be disabled by the kernel configuration, sysctl or seccomp filters
+        if (err == ENOSYS || err == EPERM || err == EACCES || err == EINVAL)
+            return ENOSYS;
+        return err;
+    }
+
+    std::vector< struct ::statx > buffers(queue_depth);
+    std::vector< std::size_t > slot_paths(queue_depth);
+    std::vector< unsigned int > free_slots(queue_depth);
+    for (unsigned int i = 0u; i < queue_depth; ++i)
+        free_slots[i] = queue_depth - i - 1u;
+
+    // The kernel writes results into buffers asynchronously, so once a request is submitted we must not return
+    // until its completion is reaped. On errors we stop submitting new requests and drain the ones in flight.
+    std::size_t next_path = 0u, completed = 0u;
+    unsigned int unsubmitted = 0u, in_flight = 0u;
+    bool any_succeeded = false;
+    int result = 0;
+    while (result == 0 ? completed < count : in_flight > 0u)
+    {
+        if (result == 0)
+        {
+            // Fill the submission queue
+            unsigned int tail = ring.sq_tail();
+            while (next_path < count && !free_slots.empty())
+            {
+                const unsigned int slot = free_slots.back();
+                free_slots.pop_back();
+                slot_paths[slot] = next_path;
+
+                struct io_uring_sqe* sqe = ring.get_sqe(tail++);
+                std::memset(sqe, 0, sizeof(*sqe));
+                sqe->opcode = IORING_OP_STATX;
+                sqe->fd = AT_FDCWD;
+                sqe->addr = reinterpret_cast< boost::uint64_t >(paths[next_path].c_str());
+                sqe->len = STATX_TYPE | STATX_MODE;
+                sqe->off = reinterpret_cast< boost::uint64_t >(&buffers[slot]);
+                sqe->statx_flags = AT_NO_AUTOMOUNT | sync_flags;
+                sqe->user_data = slot;
+
+                ++next_path;
+                ++unsubmitted;
+            }
+            ring.set_sq_tail(tail);
+        }
+
+        // Once an error is detected, only wait for completions of the already submitted requests
+        int res = ring.enter(result == 0 ? unsubmitted : 0u, 1u);
+        if (BOOST_UNLIKELY(res < 0))
+        {
+            err = errno;
+            // EBUSY means the completion queue is full. We will reap some completions and retry.
+            if (err != EINTR && err != EAGAIN && err != EBUSY)
+            {
+                if (result != 0 || in_flight == 0u)
+                {
+                    if (in_flight > 0u)
+                    {
+                        // We cannot wait for the requests in flight. Leak the buffers, as the kernel may still write to them.
+                        std::vector< struct ::statx >* leaked = new (std::nothrow) std::vector< struct ::statx >();
+                        if (BOOST_LIKELY(leaked != NULL))
+                            leaked->swap(buffers);
+                    }
+
+                    return result != 0 ? result : err;
+                }
+
+                result = err;
+            }
+        }
+        else if (result == 0)
+        {
+            unsubmitted -= static_cast< unsigned int >(res);
+            in_flight += static_cast< unsigned int >(res);
+        }
+
+        // Reap completions
+        unsigned int head = ring.cq_head();
+        const unsigned int cq_tail = ring.cq_tail();
+        for (; head != cq_tail; ++head)
+        {
+            struct io_uring_cqe const& cqe = ring.get_cqe(head);
+            const unsigned int slot = static_cast< unsigned int >(cqe.user_data);
+            const std::size_t path_index = slot_paths[slot];
+            --in_flight;
+            free_slots.push_back(slot);
+
+            if (BOOST_UNLIKELY(result != 0))
+                continue;
+
+            if (BOOST_UNLIKELY(cqe.res == -EINVAL && !any_succeeded))
+            {
+                // The kernel supports io_uring but not IORING_OP_STATX (Linux 5.1 - 5.5)
+                result = ENOSYS;
+                continue;
+            }
+
+            results[path_index] = make_statx_status(cqe.res, buffers[slot]);
+            any_succeeded = true;
+            ++completed;
+        }
+        ring.set_cq_head(head);
+    }
+
+    return result;
+}
+
+#endif // defined(BOOST_FILESYSTEM_USE_IO_URING)
+
+//! Provides access to the target paths of an array of copy entries
+struct copy_file_targets
+{
+    copy_file_entry const* entries;
+
+    explicit copy_file_targets(copy_file_entry const* e) BOOST_NOEXCEPT : entries(e) {}
+    path const& operator[](std::size_t i) const BOOST_NOEXCEPT { return entries[i].to; }
+};
+
+} // namespace
+
+//! Queries statuses of the targets of \a count copy entries. Errors are reported as \c status_error in \a results. Used by \c copy_files.
+void copy_file_targets_status(copy_file_entry const* entries, std::size_t count, file_status* results)
+{
+    if (count == 0u)
+        return;
+
+#if defined(BOOST_FILESYSTEM_USE_IO_URING)
+    if (filesystem::detail::atomic_load_relaxed(g_io_uring_statx_supported))
+    {
+        const int err = status_batch_io_uring(copy_file_targets(entries), count, results);
+        if (BOOST_LIKELY(err == 0))
+            return;
+
+        if (err == ENOSYS)
+            filesystem::detail::atomic_store_relaxed(g_io_uring_statx_supported, false);
+    }
+#endif // defined(BOOST_FILESYSTEM_USE_IO_URING)
+
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+        system::error_code ec;
+        results[i] = detail::status(entries[i].to, &ec);
+    }
+}
+
+BOOST_FILESYSTEM_DECL
+void status_batch(path const* paths, std::size_t count, file_status* results, system::error_code* ec)
+{
+    status_batch(paths, count, results, static_cast< unsigned int >(status_consistency::system_default), ec);
+}
+
+BOOST_FILESYSTEM_DECL
+void status_batch(path const* paths, std::size_t count, file_status* results, unsigned int consistency, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    if (count == 0u)
+        return;
+
+    try
+    {
+#if defined(BOOST_FILESYSTEM_USE_IO_URING)
+        if (filesystem::detail::atomic_load_relaxed(g_io_uring_statx_supported))
+        {
+            const int err = status_batch_io_uring(paths, count, results, get_statx_sync_flags(consistency));
+            if (BOOST_LIKELY(err == 0))
+                return;
+
+            if (BOOST_UNLIKELY(err != ENOSYS))
+            {
+                emit_error(err, ec, "boost::filesystem::statuses");
+                return;
+            }
+
+            filesystem::detail::atomic_store_relaxed(g_io_uring_statx_supported, false);
+        }
+#endif // defined(BOOST_FILESYSTEM_USE_IO_URING)
+
+        batch_threaded(status_range(consistency), paths, count, results);
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+    }
+}
+
+BOOST_FILESYSTEM_DECL
+void query_batch(path const* paths, std::size_t count, unsigned int mask, file_attributes* results)
+{
+    batch_threaded(attributes_range(mask), paths, count, results);
+}
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
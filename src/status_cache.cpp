@@ -0,0 +1,209 @@
+//  status_cache.cpp  ------------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/path_key.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/status_cache.hpp>
+
+#include <cstddef>
+#include <ctime>
+#include <map>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#include "thread_tools.hpp"
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+#include <mutex>
+#endif
+
+#if !defined(BOOST_NO_CXX11_HDR_CHRONO)
+#include <chrono>
+#endif
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+namespace {
+
+//! Number of cache shards, must be a power of 2
+BOOST_CONSTEXPR_OR_CONST std::size_t shard_count = 16u;
+
+//! Returns the current time of a monotonic clock, in milliseconds
+inline boost::uint64_t get_current_time_ms() BOOST_NOEXCEPT
+{
+#if !defined(BOOST_NO_CXX11_HDR_CHRONO)
+    return static_cast< boost::uint64_t >(std::chrono::duration_cast< std::chrono::milliseconds >(std::chrono::steady_clock::now().time_since_epoch()).count());
+#else
+    return static_cast< boost::uint64_t >(std::time(NULL)) * 1000u;
+#endif
+}
+
+//! Cached status of a path
+struct cached_status
+{
+    file_status status;
+    system::error_code error;
+    boost::uint64_t timestamp;
+    bool valid;
+
+    cached_status() BOOST_NOEXCEPT : timestamp(0u), valid(false) {}
+};
+
+//! Cached statuses of a path. Index 0 is the status, index 1 is the symlink status.
+struct cache_entry
+{
+    cached_status statuses[2];
+};
+
+} // unnamed namespace
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                           class status_cache implementation                          //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+struct status_cache::shard
+{
+    typedef std::map< path_key, cache_entry > entries_t;
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+    std::mutex mutex;
+#endif
+    entries_t entries;
+};
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+#define BOOST_FILESYSTEM_STATUS_CACHE_LOCK(s) std::lock_guard< std::mutex > lock((s).mutex)
+#else
+#define BOOST_FILESYSTEM_STATUS_CACHE_LOCK(s) (void)0
+#endif
+
+BOOST_FILESYSTEM_DECL status_cache::status_cache(unsigned int ttl_ms) :
+    m_shards(new shard[shard_count]),
+    m_ttl_ms(ttl_ms)
+{
+}
+
+BOOST_FILESYSTEM_DECL status_cache::~status_cache()
+{
+    delete[] m_shards;
+}
+
+BOOST_FILESYSTEM_DECL file_status status_cache::status_impl(path const& p, bool symlink, system::error_code* ec)
+{
+    const unsigned int index = static_cast< unsigned int >(symlink);
+    path_key key;
+    shard* s = NULL;
+    try
+    {
+        key = path_key(p);
+        s = m_shards + (key.hash() & (shard_count - 1u));
+
+        BOOST_FILESYSTEM_STATUS_CACHE_LOCK(*s);
+        shard::entries_t::const_iterator it = s->entries.find(key);
+        if (it != s->entries.end())
+        {
+            cached_status const& cached = it->second.statuses[index];
+            if (cached.valid && (m_ttl_ms == infinite_ttl || (get_current_time_ms() - cached.timestamp) < m_ttl_ms))
+            {
+                if (ec)
+                    *ec = cached.error;
+                return cached.status;
+            }
+        }
+    }
+    catch (...)
+    {
+        // Fall back to uncached query if path key construction fails
+        s = NULL;
+    }
+
+    system::error_code local_ec;
+    file_status st = symlink ? detail::symlink_status(p, &local_ec) : detail::status(p, &local_ec);
+    if (st.type() != status_error)
+    {
+        if (s != NULL)
+        {
+            const boost::uint64_t now = get_current_time_ms();
+            try
+            {
+                BOOST_FILESYSTEM_STATUS_CACHE_LOCK(*s);
+                cached_status& cached = s->entries[key].statuses[index];
+                cached.status = st;
+                cached.error = local_ec;
+                cached.timestamp = now;
+                cached.valid = true;
+            }
+            catch (...)
+            {
+                // Failure to cache the status is not an error
+            }
+        }
+    }
+    else if (!ec)
+    {
+        BOOST_FILESYSTEM_THROW(filesystem_error(symlink ? "boost::filesystem::symlink_status" : "boost::filesystem::status", p, local_ec));
+    }
+
+    if (ec)
+        *ec = local_ec;
+
+    return st;
+}
+
+BOOST_FILESYSTEM_DECL void status_cache::invalidate(path const& p)
+{
+    path_key key(p);
+    shard& s = m_shards[key.hash() & (shard_count - 1u)];
+    BOOST_FILESYSTEM_STATUS_CACHE_LOCK(s);
+    s.entries.erase(key);
+}
+
+BOOST_FILESYSTEM_DECL void status_cache::clear() BOOST_NOEXCEPT
+{
+    for (std::size_t i = 0u; i < shard_count; ++i)
+    {
+        shard::entries_t entries;
+        {
+            BOOST_FILESYSTEM_STATUS_CACHE_LOCK(m_shards[i]);
+            entries.swap(m_shards[i].entries);
+        }
+    }
+}
+
+BOOST_FILESYSTEM_DECL std::size_t status_cache::size() const BOOST_NOEXCEPT
+{
+    std::size_t n = 0u;
+    for (std::size_t i = 0u; i < shard_count; ++i)
+    {
+        BOOST_FILESYSTEM_STATUS_CACHE_LOCK(m_shards[i]);
+        n += m_shards[i].entries.size();
+    }
+
+    return n;
+}
+
+#undef BOOST_FILESYSTEM_STATUS_CACHE_LOCK
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
@@ -0,0 +1,578 @@
+//  synchronize_tree.cpp  --------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory_handle.hpp>
+#include <boost/filesystem/mapped_file.hpp>
+#include <boost/filesystem/parallel_walk.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <new> // std::bad_alloc
+#include <vector>
+#include <algorithm>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#include "thread_tools.hpp"
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+#include <mutex>
+#endif
+
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+namespace {
+
+//! Attributes of the source and target files that are compared
+BOOST_CONSTEXPR_OR_CONST unsigned int sync_query_mask = static_cast< unsigned int >(file_attribute_mask::type) |
+    static_cast< unsigned int >(file_attribute_mask::permissions) | static_cast< unsigned int >(file_attribute_mask::size) |
+    static_cast< unsigned int >(file_attribute_mask::last_write_time) | static_cast< unsigned int >(file_attribute_mask::no_follow);
+
+//! Returns the path in \a to_root that corresponds to \a p in \a from_root
+path rebase_path(path const& p, path const& from_root, path const& to_root)
+{
+    // The walker constructs paths by appending file names to the root, so the root is always a prefix
+    path::string_type const& str = p.native();
+    std::size_t pos = from_root.native().size();
+    while (pos < str.size() && detail::is_directory_separator(str[pos]))
+        ++pos;
+
+    return to_root / path(str.c_str() + pos);
+}
+
+//! Queries attributes of a file relative to the open directory, if it is open, or by the full path
+inline file_attributes query_at(directory_handle const& dir, path const& p, system::error_code& ec)
+{
+    return dir.is_open() ? dir.query(p.filename(), static_cast< BOOST_SCOPED_ENUM_NATIVE(file_attribute_mask) >(sync_query_mask), ec) :
+        detail::query(p, sync_query_mask, &ec);
+}
+
+//! Returns \c true if the contents of the two files of equal size are equal
+bool contents_equal(path const& p1, path const& p2, uintmax_t size, system::error_code& ec)
+{
+    if (size == 0u)
+        return true;
+
+    mapped_file file1(p1, mapped_file_flags::sequential, ec);
+    if (BOOST_UNLIKELY(!!ec))
+        return false;
+    mapped_file file2(p2, mapped_file_flags::sequential, ec);
+    if (BOOST_UNLIKELY(!!ec))
+        return false;
+
+    return file1.size() == file2.size() && std::memcmp(file1.data(), file2.data(), file1.size()) == 0;
+}
+
+//! Common state of synchronizing a directory tree
+class synchronize_context
+{
+private:
+    path const& m_from;
+    path const& m_to;
+    const unsigned int m_options;
+    //! Options for copying changed files
+    unsigned int m_copy_options;
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+    std::mutex m_mutex;
+#endif
+    synchronize_info m_info;
+    //! Files and directories in the target tree that are not present in the source tree
+    std::vector< path > m_extra;
+    system::error_code m_error;
+    path m_error_path1;
+    path m_error_path2;
+
+public:
+    synchronize_context(path const& from, path const& to, unsigned int options) BOOST_NOEXCEPT :
+        m_from(from),
+        m_to(to),
+        m_options(options),
+        m_copy_options(static_cast< unsigned int >(copy_options::overwrite_existing))
+    {
+        if ((options & static_cast< unsigned int >(synchronize_options::delta)) != 0u)
+            m_copy_options |= static_cast< unsigned int >(copy_options::delta);
+        if ((options & static_cast< unsigned int >(synchronize_options::clone_if_possible)) != 0u)
+            m_copy_options |= static_cast< unsigned int >(copy_options::clone_if_possible);
+    }
+
+    BOOST_DELETED_FUNCTION(synchronize_context(synchronize_context const&))
+    BOOST_DELETED_FUNCTION(synchronize_context& operator=(synchronize_context const&))
+
+    synchronize_info const& info() const BOOST_NOEXCEPT { return m_info; }
+    system::error_code const& error() const BOOST_NOEXCEPT { return m_error; }
+    path const& error_path1() const BOOST_NOEXCEPT { return m_error_path1; }
+    path const& error_path2() const BOOST_NOEXCEPT { return m_error_path2; }
+
+    //! Walker batch handler for the source tree
+    static bool on_source_batch(void* context, std::vector< directory_entry >& batch)
+    {
+        return static_cast< synchronize_context* >(context)->synchronize_batch(batch);
+    }
+
+    //! Walker batch handler for the target tree
+    static bool on_target_batch(void* context, std::vector< directory_entry >& batch)
+    {
+        return static_cast< synchronize_context* >(context)->find_extra(batch);
+    }
+
+    //! Makes sure that \a target is a directory, replacing a file of a different type. Returns \c true if the directory was created.
+    bool ensure_directory(path const& source, path const& target, system::error_code& ec)
+    {
+        if (detail::create_directory(target, &source, &ec))
+            return true;
+
+        if (BOOST_LIKELY(!ec))
+            return false;
+
+        if (ec != system::errc::file_exists && ec != system::errc::not_a_directory)
+            return false;
+
+        // The target is a file of a different type. Another thread may be replacing it already, so recheck under the lock.
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        ec.clear();
+        file_status st = detail::symlink_status(target, &ec);
+        if (BOOST_UNLIKELY(!!ec))
+            return false;
+
+        if (filesystem::is_directory(st))
+            return false;
+
+        m_info.removed_count += detail::remove_all(target, &ec);
+        if (BOOST_UNLIKELY(!!ec))
+            return false;
+
+        return detail::create_directory(target, &source, &ec);
+    }
+
+    //! Removes the extra files found in the target tree
+    void remove_extra(system::error_code& ec, path const*& failed)
+    {
+        // Nested extra files follow their parent directories, and are removed with them
+        std::sort(m_extra.begin(), m_extra.end());
+        for (std::size_t i = 0u, n = m_extra.size(); i < n; ++i)
+        {
+            m_info.removed_count += detail::remove_all(m_extra[i], &ec);
+            if (BOOST_UNLIKELY(!!ec))
+            {
+                failed = &m_extra[i];
+                return;
+            }
+        }
+    }
+
+private:
+    bool synchronize_batch(std::vector< directory_entry >& batch) BOOST_NOEXCEPT
+    {
+        system::error_code ec;
+        path source, target;
+        synchronize_info info;
+        try
+        {
+            // The walker delivers the entries of a directory after the directory itself, so the target directory
+            // has already been created by the batch containing it
+            source = batch.front().path().parent_path();
+            target = rebase_path(source, m_from, m_to);
+
+            // All entries of the batch belong to the same directory, query them relative to the source and target directories
+            // to avoid resolving the whole paths for every file
+#if defined(BOOST_POSIX_API) && !defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+            directory_handle source_dir, target_dir;
+#else
+            directory_handle source_dir(source, ec);
+            if (BOOST_UNLIKELY(!!ec))
+                goto fail;
+            directory_handle target_dir(target, ec);
+            if (BOOST_UNLIKELY(!!ec))
+                goto fail;
+#endif
+
+            for (std::size_t i = 0u, n = batch.size(); i < n; ++i)
+            {
+                source = batch[i].path();
+                target = rebase_path(source, m_from, m_to);
+                if (BOOST_UNLIKELY(!synchronize_file(source_dir, source, target_dir, target, info, ec)))
+                    goto fail;
+            }
+        }
+        catch (std::bad_alloc&)
+        {
+            ec = make_error_code(system::errc::not_enough_memory);
+            goto fail;
+        }
+
+        merge(info);
+        return true;
+
+    fail:
+        merge(info);
+        set_error(ec, source, target);
+        return false;
+    }
+
+    //! Synchronizes a single file. Returns \c false in case of error.
+    bool synchronize_file(directory_handle const& source_dir, path const& source, directory_handle const& target_dir, path const& target,
+        synchronize_info& info, system::error_code& ec)
+    {
+        const file_attributes from = query_at(source_dir, source, ec);
+        if (BOOST_UNLIKELY(!!ec))
+        {
+            // The file may have been removed since the directory was read
+            if (ec == system::errc::no_such_file_or_directory)
+            {
+                ec.clear();
+                return true;
+            }
+
+            return false;
+        }
+
+        const file_type type = from.status.type();
+        if (type != regular_file && type != directory_file && type != symlink_file)
+            return true; // special files are not synchronized
+
+        ++info.file_count;
+
+        file_attributes to = query_at(target_dir, target, ec);
+        if (BOOST_UNLIKELY(!!ec))
+        {
+            if (ec != system::errc::no_such_file_or_directory)
+                return false;
+
+            ec.clear();
+        }
+
+        const file_type target_type = to.status.type();
+        if (type == directory_file)
+        {
+            if (target_type != directory_file)
+            {
+                // The walker descends into the directory after this batch is processed
+                ensure_directory(source, target, ec);
+                return !ec;
+            }
+
+            if (to.status.permissions() != from.status.permissions())
+            {
+                detail::permissions(target, from.status.permissions(), &ec);
+                if (BOOST_UNLIKELY(!!ec))
+                    return false;
+                ++info.updated_count;
+            }
+
+            return true;
+        }
+
+        if (target_type != status_error && target_type != file_not_found && target_type != type)
+        {
+            // The file type changed, remove the old target
+            info.removed_count += detail::remove_all(target, &ec);
+            if (BOOST_UNLIKELY(!!ec))
+                return false;
+            to.status = file_status(file_not_found);
+        }
+
+        if (type == symlink_file)
+        {
+            if (to.status.type() == symlink_file)
+            {
+                const path from_target = detail::read_symlink(source, &ec);
+                if (BOOST_UNLIKELY(!!ec))
+                    return false;
+                const path to_target = detail::read_symlink(target, &ec);
+                if (BOOST_UNLIKELY(!!ec))
+                    return false;
+                if (from_target == to_target)
+                    return true;
+
+                detail::remove(target, &ec);
+                if (BOOST_UNLIKELY(!!ec))
+                    return false;
+            }
+
+            detail::copy_symlink(source, target, &ec);
+            if (BOOST_UNLIKELY(!!ec))
+                return false;
+            ++info.copied_count;
+            return true;
+        }
+
+        const bool times_equal = from.precise_last_write_time() == to.precise_last_write_time();
+        bool changed = to.status.type() != regular_file || from.size != to.size;
+        if (!changed)
+        {
+            if ((m_options & static_cast< unsigned int >(synchronize_options::compare_contents)) != 0u)
+            {
+                changed = !contents_equal(source, target, from.size, ec);
+                if (BOOST_UNLIKELY(!!ec))
+                    return false;
+            }
+            else
+            {
+                changed = !times_equal;
+            }
+        }
+
+        file_attribute_set attrs;
+        unsigned int attrs_mask = 0u;
+        if (changed)
+        {
+            detail::copy_file(source, target, m_copy_options, &ec);
+            if (BOOST_UNLIKELY(!!ec))
+                return false;
+            ++info.copied_count;
+            info.copied_size += from.size;
+
+            // Preserve the last write time, so that the file is not considered changed on the next run
+            attrs_mask |= static_cast< unsigned int >(file_attribute_mask::last_write_time);
+        }
+        else
+        {
+            if (!times_equal)
+                attrs_mask |= static_cast< unsigned int >(file_attribute_mask::last_write_time);
+            if (to.status.permissions() != from.status.permissions())
+                attrs_mask |= static_cast< unsigned int >(file_attribute_mask::permissions);
+            if (attrs_mask != 0u)
+                ++info.updated_count;
+        }
+
+        if (attrs_mask != 0u)
+        {
+            attrs.mask = static_cast< BOOST_SCOPED_ENUM_NATIVE(file_attribute_mask) >(attrs_mask);
+            attrs.permissions = from.status.permissions();
+            attrs.last_write_time = from.precise_last_write_time();
+            detail::set_attributes(target, attrs, &ec);
+            if (BOOST_UNLIKELY(!!ec))
+                return false;
+        }
+
+        return true;
+    }
+
+    bool find_extra(std::vector< directory_entry >& batch) BOOST_NOEXCEPT
+    {
+        system::error_code ec;
+        path target, source;
+        std::vector< path > extra;
+        try
+        {
+            target = batch.front().path().parent_path();
+            source = rebase_path(target, m_to, m_from);
+
+#if defined(BOOST_POSIX_API) && !defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+            directory_handle source_dir;
+#else
+            directory_handle source_dir(source, ec);
+            if (BOOST_UNLIKELY(!!ec))
+            {
+                // The directory is not present in the source tree, it is removed along with its contents
+                if (ec == system::errc::no_such_file_or_directory || ec == system::errc::not_a_directory)
+                    return true;
+                goto fail;
+            }
+#endif
+
+            for (std::size_t i = 0u, n = batch.size(); i < n; ++i)
+            {
+                target = batch[i].path();
+                source = rebase_path(target, m_to, m_from);
+                file_status st = source_dir.is_open() ? source_dir.symlink_status(source.filename(), ec) : detail::symlink_status(source, &ec);
+                if (BOOST_UNLIKELY(!!ec))
+                {
+                    if (ec != system::errc::no_such_file_or_directory && ec != system::errc::not_a_directory)
+                        goto fail;
+                    ec.clear();
+                }
+
+                if (!filesystem::exists(st))
+                    extra.push_back(target);
+            }
+        }
+        catch (std::bad_alloc&)
+        {
+            ec = make_error_code(system::errc::not_enough_memory);
+            goto fail;
+        }
+
+        if (!extra.empty())
+        {
+            bool inserted = true;
+            {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+                std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+                try
+                {
+                    m_extra.insert(m_extra.end(), extra.begin(), extra.end());
+                }
+                catch (std::bad_alloc&)
+                {
+                    inserted = false;
+                }
+            }
+
+            if (BOOST_UNLIKELY(!inserted))
+            {
+                ec = make_error_code(system::errc::not_enough_memory);
+                goto fail;
+            }
+        }
+
+        return true;
+
+    fail:
+        set_error(ec, target, source);
+        return false;
+    }
+
+    //! Adds the results of a batch to the totals
+    void merge(synchronize_info const& info) BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        m_info.file_count += info.file_count;
+        m_info.copied_count += info.copied_count;
+        m_info.copied_size += info.copied_size;
+        m_info.updated_count += info.updated_count;
+        m_info.removed_count += info.removed_count;
+    }
+
+    void set_error(system::error_code const& err, path const& p1, path const& p2) BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        if (!m_error)
+        {
+            m_error = err;
+            try
+            {
+                m_error_path1 = p1;
+                m_error_path2 = p2;
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+};
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL
+synchronize_info synchronize_tree(path const& from, path const& to, unsigned int options, unsigned int thread_count, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    system::error_code local_ec;
+    path const* err_path1 = &from;
+    path const* err_path2 = &to;
+    try
+    {
+        file_status from_stat = detail::status(from, &local_ec);
+        if (BOOST_UNLIKELY(!!local_ec))
+            goto fail;
+
+        if (BOOST_UNLIKELY(!filesystem::is_directory(from_stat)))
+        {
+            local_ec = make_error_code(system::errc::not_a_directory);
+            goto fail;
+        }
+
+        synchronize_context ctx(from, to, options);
+
+        // The target root is created if needed, but an existing file is not replaced
+        detail::create_directory(to, &from, &local_ec);
+        if (BOOST_UNLIKELY(!!local_ec))
+            goto fail;
+
+        parallel_walk_params params;
+        params.thread_count = thread_count;
+        params.batch_size = parallel_directory_walker::default_batch_size;
+        params.options = static_cast< unsigned int >(directory_options::none);
+        params.exec = NULL;
+
+        detail::parallel_walk(from, params, &synchronize_context::on_source_batch, &ctx, &local_ec);
+        if (BOOST_UNLIKELY(!!local_ec))
+            goto fail;
+
+        if (BOOST_LIKELY(!ctx.error()) && (options & static_cast< unsigned int >(synchronize_options::remove_extra)) != 0u)
+        {
+            detail::parallel_walk(to, params, &synchronize_context::on_target_batch, &ctx, &local_ec);
+            if (BOOST_UNLIKELY(!!local_ec))
+            {
+                err_path1 = &to;
+                err_path2 = &from;
+                goto fail;
+            }
+
+            if (BOOST_LIKELY(!ctx.error()))
+            {
+                path const* failed = NULL;
+                ctx.remove_extra(local_ec, failed);
+                if (BOOST_UNLIKELY(!!local_ec))
+                {
+                    if (!ec)
+                        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::synchronize_tree", *failed, local_ec));
+                    *ec = local_ec;
+                    return ctx.info();
+                }
+            }
+        }
+
+        if (BOOST_UNLIKELY(!!ctx.error()))
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::synchronize_tree", ctx.error_path1(), ctx.error_path2(), ctx.error()));
+            *ec = ctx.error();
+        }
+
+        return ctx.info();
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return synchronize_info();
+    }
+
+fail:
+    if (!ec)
+        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::synchronize_tree", *err_path1, *err_path2, local_ec));
+    *ec = local_ec;
+    return synchronize_info();
+}
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
@@ -0,0 +1,136 @@
+//  thread_tools.hpp  ------------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_SRC_THREAD_TOOLS_HPP_
+#define BOOST_FILESYSTEM_SRC_THREAD_TOOLS_HPP_
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/executor.hpp>
+
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED) && !defined(BOOST_NO_CXX11_HDR_THREAD) && !defined(BOOST_NO_CXX11_HDR_MUTEX) && \
+    !defined(BOOST_NO_CXX11_HDR_CONDITION_VARIABLE) && !defined(BOOST_NO_CXX11_HDR_ATOMIC) && !defined(BOOST_NO_CXX11_HDR_SYSTEM_ERROR)
+#define BOOST_FILESYSTEM_HAS_THREADS
+#endif
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+//! Returns the default executor, which starts a new thread for every task
+executor& get_default_executor() BOOST_NOEXCEPT;
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <functional> // std::ref
+#include <system_error>
+
+#include "descriptor_budget.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+//! Runs \c fn(context, index) for every index in <tt>[0, count)</tt> using executor \a ex and the calling thread, and waits for all of them to complete.
+/*!
+ * The calling thread executes \c fn(context, 0), as well as the indices that were not started by the executor
+ * by the time the calling thread is done. \c fn must not throw.
+ */
+void run_tasks(executor& ex, unsigned int count, void (*fn)(void*, unsigned int), void* context) BOOST_NOEXCEPT;
+
+//! Resolves the number of threads to use for an operation. Zero means the concurrency of the executor \a ex, or the current executor if \c NULL.
+inline unsigned int get_thread_count(unsigned int requested, executor* ex = NULL) BOOST_NOEXCEPT
+{
+    if (requested == 0u)
+    {
+        if (!ex)
+            ex = filesystem::get_executor();
+        requested = ex->concurrency();
+        if (requested == 0u)
+            requested = 1u;
+    }
+
+    return requested;
+}
+
+//! Task function that forwards the call to the function object passed to \c run_in_threads
+template< typename Function >
+void run_in_threads_task(void* context, unsigned int index)
+{
+    (*static_cast< Function* >(context))(index);
+}
+
+//! Runs \c fn(index) in \a thread_count threads, including the calling thread, and waits for all of them to complete.
+/*!
+ * The calling thread executes \c fn(0). If fewer threads than requested could be started, the function will
+ * still run with as many threads as were started. Returns the number of threads that were actually used.
+ * \c fn must not throw. Every thread other than the calling one draws descriptors from the process-wide
+ * descriptor budget while it runs, and fewer threads are used if the budget is exhausted.
+ *
+ * The threads are obtained from executor \a ex, or the current executor if \c NULL. If an executor other than
+ * the default one is used, the indices that were not started by the executor in time are run by the calling thread
+ * after \c fn(0), so \c fn must tolerate being called after the other threads have completed their work.
+ */
+template< typename Function >
+unsigned int run_in_threads(unsigned int thread_count, Function& fn, executor* ex = NULL)
+{
+    descriptor_reservation descriptors;
+    thread_count = reserve_thread_descriptors(descriptors, thread_count);
+
+    if (!ex)
+        ex = filesystem::get_executor();
+    if (ex != &get_default_executor())
+    {
+        run_tasks(*ex, thread_count, &run_in_threads_task< Function >, &fn);
+        return thread_count;
+    }
+
+    std::vector< std::thread > threads;
+    try
+    {
+        threads.reserve(thread_count > 0u ? thread_count - 1u : 0u);
+        for (unsigned int i = 1u; i < thread_count; ++i)
+            threads.push_back(std::thread(std::ref(fn), i));
+    }
+    catch (...)
+    {
+        // Proceed with the threads that we managed to start
+    }
+
+    fn(0u);
+
+    for (std::size_t i = 0u, n = threads.size(); i < n; ++i)
+        threads[i].join();
+
+    return static_cast< unsigned int >(threads.size() + 1u);
+}
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+#endif // BOOST_FILESYSTEM_SRC_THREAD_TOOLS_HPP_
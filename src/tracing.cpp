@@ -0,0 +1,55 @@
+//  tracing.cpp  -----------------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+
+#include "tracing.hpp"
+
+#if defined(BOOST_FILESYSTEM_HAS_TRACING) && defined(BOOST_FILESYSTEM_HAS_TRACELOGGING)
+
+// {7996194d-7648-45de-a88c-f5cdbde5beb1}
+TRACELOGGING_DEFINE_PROVIDER(
+    boost_filesystem_trace_provider,
+    "Boost.Filesystem",
+    (0x7996194d, 0x7648, 0x45de, 0xa8, 0x8c, 0xf5, 0xcd, 0xbd, 0xe5, 0xbe, 0xb1));
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+namespace {
+
+//! Registers the TraceLogging provider for the lifetime of the library. Until the provider is registered
+//! and after it is unregistered the events are discarded.
+struct trace_provider_registration
+{
+    trace_provider_registration() BOOST_NOEXCEPT
+    {
+        TraceLoggingRegister(boost_filesystem_trace_provider);
+    }
+
+    ~trace_provider_registration()
+    {
+        TraceLoggingUnregister(boost_filesystem_trace_provider);
+    }
+};
+
+const trace_provider_registration g_trace_provider_registration;
+
+} // unnamed namespace
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#endif // defined(BOOST_FILESYSTEM_HAS_TRACING) && defined(BOOST_FILESYSTEM_HAS_TRACELOGGING)
@@ -0,0 +1,98 @@
+//  tracing.hpp  -----------------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_SRC_TRACING_HPP_
+#define BOOST_FILESYSTEM_SRC_TRACING_HPP_
+
+#include <boost/filesystem/config.hpp>
+
+// Static tracepoints. On Linux, the probes are USDT (SystemTap SDT) probes of provider "boost_filesystem", which can be
+// attached to with bpftrace, perf or SystemTap. On Windows, the probes are TraceLogging events of provider
+// "Boost.Filesystem". When no tracer is attached, the probes are a single nop instruction (USDT) or a check
+// of the provider enablement flag (TraceLogging).
+//
+// Probe names follow the DTrace convention: name__entry fired when the operation starts and name__return
+// when it completes, including by throwing an exception.
+
+#if !defined(BOOST_FILESYSTEM_DISABLE_TRACING)
+
+#if defined(BOOST_FILESYSTEM_HAS_SDT)
+
+#include <sys/sdt.h>
+
+#define BOOST_FILESYSTEM_HAS_TRACING
+
+#define BOOST_FILESYSTEM_TRACE(name) DTRACE_PROBE(boost_filesystem, name)
+#define BOOST_FILESYSTEM_TRACE1(name, arg1) DTRACE_PROBE1(boost_filesystem, name, arg1)
+#define BOOST_FILESYSTEM_TRACE2(name, arg1, arg2) DTRACE_PROBE2(boost_filesystem, name, arg1, arg2)
+#define BOOST_FILESYSTEM_TRACE3(name, arg1, arg2, arg3) DTRACE_PROBE3(boost_filesystem, name, arg1, arg2, arg3)
+
+#elif defined(BOOST_FILESYSTEM_HAS_TRACELOGGING)
+
+#include <windows.h>
+#include <TraceLoggingProvider.h>
+
+#define BOOST_FILESYSTEM_HAS_TRACING
+
+TRACELOGGING_DECLARE_PROVIDER(boost_filesystem_trace_provider);
+
+#define BOOST_FILESYSTEM_TRACE(name) \
+    TraceLoggingWrite(boost_filesystem_trace_provider, #name)
+#define BOOST_FILESYSTEM_TRACE1(name, arg1) \
+    TraceLoggingWrite(boost_filesystem_trace_provider, #name, TraceLoggingValue(arg1, "arg1"))
+#define BOOST_FILESYSTEM_TRACE2(name, arg1, arg2) \
+    TraceLoggingWrite(boost_filesystem_trace_provider, #name, TraceLoggingValue(arg1, "arg1"), TraceLoggingValue(arg2, "arg2"))
+#define BOOST_FILESYSTEM_TRACE3(name, arg1, arg2, arg3) \
+    TraceLoggingWrite(boost_filesystem_trace_provider, #name, TraceLoggingValue(arg1, "arg1"), TraceLoggingValue(arg2, "arg2"), TraceLoggingValue(arg3, "arg3"))
+
+#endif
+
+#endif // !defined(BOOST_FILESYSTEM_DISABLE_TRACING)
+
+#if defined(BOOST_FILESYSTEM_HAS_TRACING)
+
+//! Defines a class that fires the \c name__return probe when destroyed
+#define BOOST_FILESYSTEM_DEFINE_TRACE_SCOPE(name) \
+    struct name##_trace_scope \
+    { \
+        ~name##_trace_scope() { BOOST_FILESYSTEM_TRACE(name##__return); } \
+    }
+
+//! Fires the \c name__return probe on leaving the enclosing scope. The scope must be defined with \c BOOST_FILESYSTEM_DEFINE_TRACE_SCOPE.
+#define BOOST_FILESYSTEM_TRACE_SCOPE(name) boost::filesystem::detail::name##_trace_scope name##_trace_scope_guard
+
+#else // defined(BOOST_FILESYSTEM_HAS_TRACING)
+
+#define BOOST_FILESYSTEM_TRACE(name)
+#define BOOST_FILESYSTEM_TRACE1(name, arg1)
+#define BOOST_FILESYSTEM_TRACE2(name, arg1, arg2)
+#define BOOST_FILESYSTEM_TRACE3(name, arg1, arg2, arg3)
+
+#define BOOST_FILESYSTEM_DEFINE_TRACE_SCOPE(name) struct name##_trace_scope
+#define BOOST_FILESYSTEM_TRACE_SCOPE(name)
+
+#endif // defined(BOOST_FILESYSTEM_HAS_TRACING)
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+BOOST_FILESYSTEM_DEFINE_TRACE_SCOPE(copy_file);
+BOOST_FILESYSTEM_DEFINE_TRACE_SCOPE(remove_all);
+BOOST_FILESYSTEM_DEFINE_TRACE_SCOPE(canonical);
+BOOST_FILESYSTEM_DEFINE_TRACE_SCOPE(directory_iterator_construct);
+BOOST_FILESYSTEM_DEFINE_TRACE_SCOPE(directory_iterator_increment);
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#endif // BOOST_FILESYSTEM_SRC_TRACING_HPP_
@@ -0,0 +1,672 @@
+//  tree_digest.cpp  -------------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory_handle.hpp>
+#include <boost/filesystem/mapped_file.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/parallel_walk.hpp>
+
+#include <cstddef>
+#include <new> // std::bad_alloc
+#include <map>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#include "thread_tools.hpp"
+#include "content_hash.hpp"
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+#include <mutex>
+#include <atomic>
+#endif
+
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+namespace {
+
+//! Size of the buffer for reading file contents, unless the files are memory-mapped. Must be a multiple of 8, see content_hash.
+BOOST_CONSTEXPR_OR_CONST std::size_t digest_read_buffer_size = 65536u;
+
+//! A file found in the tree
+struct digest_entry
+{
+    path entry_path;
+    file_type type;
+    perms permissions;
+    //! Identity and version of a regular file, valid if \c has_version is \c true
+    file_version version;
+    bool has_version;
+    uint64_t digest;
+};
+
+//! A child of a directory, used to combine the digests of the children in name order
+struct digest_child
+{
+    path::string_type name;
+    std::size_t index;
+
+    bool operator< (digest_child const& that) const { return name < that.name; }
+};
+
+//! Orders directories so that every directory comes before its parent
+struct digest_bottom_up_order
+{
+    std::vector< digest_entry > const* entries;
+
+    bool operator() (std::size_t left, std::size_t right) const BOOST_NOEXCEPT
+    {
+        return (*entries)[left].entry_path.native().size() > (*entries)[right].entry_path.native().size();
+    }
+};
+
+//! Returns \c true if the error indicates that a file should be left out of the digest
+inline bool is_skippable_error(system::error_code const& ec, unsigned int options) BOOST_NOEXCEPT
+{
+    // Files removed after the tree was enumerated are skipped
+    if (ec == system::errc::no_such_file_or_directory)
+        return true;
+
+    return ec == system::errc::permission_denied && (options & static_cast< unsigned int >(tree_digest_options::skip_permission_denied)) != 0u;
+}
+
+//! Returns the tag that identifies the type of a file in the digest of its parent directory
+inline unsigned char get_type_tag(file_type type) BOOST_NOEXCEPT
+{
+    switch (type)
+    {
+    case regular_file:
+        return static_cast< unsigned char >('f');
+    case directory_file:
+        return static_cast< unsigned char >('d');
+    case symlink_file:
+        return static_cast< unsigned char >('l');
+    default:
+        return static_cast< unsigned char >('o');
+    }
+}
+
+//! Appends a 64-bit integer in little endian byte order
+inline void append_uint64(std::string& data, uint64_t value)
+{
+    for (unsigned int i = 0u; i < 8u; ++i, value >>= 8u)
+        data.push_back(static_cast< char >(value & 0xFFu));
+}
+
+//! Returns the digest of a string, e.g. the target of a symlink
+template< typename Char >
+inline uint64_t hash_string(std::basic_string< Char > const& str) BOOST_NOEXCEPT
+{
+    content_hash h;
+    h.update(reinterpret_cast< const unsigned char* >(str.data()), str.size() * sizeof(Char));
+    return h.finish(str.size() * sizeof(Char));
+}
+
+//! Common state of computing a tree digest
+class tree_digest_context
+{
+private:
+    //! File attributes needed to identify the files and to look up their hashes
+    static BOOST_CONSTEXPR_OR_CONST unsigned int query_mask = static_cast< unsigned int >(file_attribute_mask::type) |
+        static_cast< unsigned int >(file_attribute_mask::size) | static_cast< unsigned int >(file_attribute_mask::last_write_time) |
+        static_cast< unsigned int >(file_attribute_mask::inode) | static_cast< unsigned int >(file_attribute_mask::device) |
+        static_cast< unsigned int >(file_attribute_mask::no_follow);
+
+private:
+    const unsigned int m_options;
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+    std::mutex m_mutex;
+    std::atomic< std::size_t > m_next_file;
+#else
+    std::size_t m_next_file;
+#endif
+    std::vector< digest_entry > m_entries;
+    //! Indices of the entries whose contents need to be hashed
+    std::vector< std::size_t > m_files;
+    //! Hashes loaded from the cache file
+    hash_cache_map m_old_hashes;
+    //! Hashes of the files of the current tree
+    hash_cache_map m_new_hashes;
+    tree_digest_info m_info;
+    system::error_code m_error;
+    path m_error_path;
+
+public:
+    explicit tree_digest_context(unsigned int options) BOOST_NOEXCEPT :
+        m_options(options),
+        m_next_file(0u)
+    {
+    }
+
+    BOOST_DELETED_FUNCTION(tree_digest_context(tree_digest_context const&))
+    BOOST_DELETED_FUNCTION(tree_digest_context& operator=(tree_digest_context const&))
+
+public:
+    tree_digest_info const& info() const BOOST_NOEXCEPT { return m_info; }
+    system::error_code const& error() const BOOST_NOEXCEPT { return m_error; }
+    path const& error_path() const BOOST_NOEXCEPT { return m_error_path; }
+
+    hash_cache_map& old_hashes() BOOST_NOEXCEPT { return m_old_hashes; }
+    hash_cache_map const& new_hashes() const BOOST_NOEXCEPT { return m_new_hashes; }
+
+    unsigned int query_options() const BOOST_NOEXCEPT
+    {
+        unsigned int mask = query_mask;
+        if ((m_options & static_cast< unsigned int >(tree_digest_options::include_permissions)) != 0u)
+            mask |= static_cast< unsigned int >(file_attribute_mask::permissions);
+        return mask;
+    }
+
+    //! Adds the root of the tree, if it is not a directory
+    bool add_root(path const& p, file_attributes const& attrs, system::error_code& ec)
+    {
+        if (attrs.status.type() != regular_file)
+        {
+            ec = make_error_code(system::errc::invalid_argument);
+            return false;
+        }
+
+        m_entries.push_back(make_entry(p, attrs));
+        m_files.push_back(0u);
+        return true;
+    }
+
+    //! Walker batch handler
+    static bool on_batch(void* context, std::vector< directory_entry >& batch)
+    {
+        return static_cast< tree_digest_context* >(context)->add_batch(batch);
+    }
+
+    //! Returns the number of entries whose contents need to be hashed
+    std::size_t file_count() const BOOST_NOEXCEPT { return m_files.size(); }
+
+    //! Thread function, hashes files until there are no more files or an error occurs
+    void operator() (unsigned int) BOOST_NOEXCEPT
+    {
+        std::vector< unsigned char > buffer;
+        tree_digest_info info;
+        while (true)
+        {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+            const std::size_t index = m_next_file.fetch_add(1u, std::memory_order_relaxed);
+#else
+            const std::size_t index = m_next_file++;
+#endif
+            if (index >= m_files.size() || has_error())
+                break;
+
+            digest_entry& entry = m_entries[m_files[index]];
+            system::error_code ec;
+            if (!hash_entry(entry, buffer, info, ec))
+            {
+                if (is_skippable_error(ec, m_options))
+                {
+                    // The file is left out of the digest
+                    entry.type = file_not_found;
+                    continue;
+                }
+
+                set_error(ec, entry.entry_path);
+                break;
+            }
+        }
+
+        merge(info);
+    }
+
+    //! Combines the digests of the files into the digests of the directories and returns the digest of the root directory \a p
+    uint64_t combine(path const& p)
+    {
+        typedef std::map< path::string_type, std::vector< std::size_t > > children_map;
+        children_map children;
+        std::vector< std::size_t > directories;
+        for (std::size_t i = 0u, n = m_entries.size(); i < n; ++i)
+        {
+            digest_entry const& entry = m_entries[i];
+            if (entry.type == file_not_found)
+                continue;
+
+            children[entry.entry_path.parent_path().native()].push_back(i);
+            if (entry.type == directory_file)
+                directories.push_back(i);
+            else
+                ++m_info.file_count;
+        }
+
+        m_info.directory_count = directories.size() + 1u;
+
+        digest_bottom_up_order order = { &m_entries };
+        std::sort(directories.begin(), directories.end(), order);
+
+        std::vector< digest_child > sorted;
+        std::string data;
+        for (std::size_t i = 0u, n = directories.size(); i < n; ++i)
+        {
+            digest_entry& dir = m_entries[directories[i]];
+            children_map::const_iterator it = children.find(dir.entry_path.native());
+            dir.digest = it != children.end() ? combine_children(it->second, sorted, data) : combine_children(std::vector< std::size_t >(), sorted, data);
+        }
+
+        // The walker composes the paths of the entries by appending their names to the root path, so obtain the parent path
+        // of the root entries the same way. This accounts for trailing separators in the root path.
+        const path root_key((p / path("x")).parent_path());
+        children_map::const_iterator it = children.find(root_key.native());
+        return it != children.end() ? combine_children(it->second, sorted, data) : combine_children(std::vector< std::size_t >(), sorted, data);
+    }
+
+    //! Returns the digest of the root, if it is not a directory
+    uint64_t root_digest() const BOOST_NOEXCEPT
+    {
+        return m_entries.front().digest;
+    }
+
+private:
+    digest_entry make_entry(path const& p, file_attributes const& attrs)
+    {
+        digest_entry entry;
+        entry.entry_path = p;
+        entry.type = attrs.status.type();
+        entry.permissions = attrs.status.permissions();
+        entry.has_version = false;
+        entry.digest = 0u;
+
+        const unsigned int required_mask = static_cast< unsigned int >(file_attribute_mask::inode) | static_cast< unsigned int >(file_attribute_mask::device) |
+            static_cast< unsigned int >(file_attribute_mask::last_write_time);
+        if (entry.type == regular_file && (static_cast< unsigned int >(attrs.mask) & required_mask) == required_mask)
+        {
+            entry.has_version = true;
+            entry.version.device = attrs.device;
+            entry.version.inode = attrs.inode;
+            entry.version.size = attrs.size;
+            entry.version.mtime = static_cast< int64_t >(attrs.last_write_time);
+            entry.version.mtime_nsec = attrs.last_write_time_nsec;
+        }
+        else
+        {
+            entry.version.device = 0u;
+            entry.version.inode = 0u;
+            entry.version.size = attrs.size;
+            entry.version.mtime = 0;
+            entry.version.mtime_nsec = 0u;
+        }
+
+        return entry;
+    }
+
+    bool add_batch(std::vector< directory_entry >& batch) BOOST_NOEXCEPT
+    {
+        system::error_code ec;
+        path const* failed = NULL;
+        std::vector< digest_entry > entries;
+        try
+        {
+            // All entries of the batch belong to the same directory, query them relative to it to avoid resolving the whole path for every file
+#if defined(BOOST_POSIX_API) && !defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+            directory_handle dir;
+#else
+            directory_handle dir(batch.front().path().parent_path(), ec);
+#endif
+            const unsigned int mask = query_options();
+            entries.reserve(batch.size());
+            for (std::size_t i = 0u, n = batch.size(); i < n; ++i)
+            {
+                path const& p = batch[i].path();
+                const file_type type = detail::get_cached_symlink_status(batch[i]).type();
+                file_attributes attrs;
+                if (type == directory_file && (mask & static_cast< unsigned int >(file_attribute_mask::permissions)) == 0u)
+                {
+                    // Only the type of the directories is needed
+                    attrs.status.type(directory_file);
+                }
+                else
+                {
+                    attrs = dir.is_open() ? dir.query(p.filename(), static_cast< BOOST_SCOPED_ENUM_NATIVE(file_attribute_mask) >(mask), ec) :
+                        detail::query(p, mask, &ec);
+                    if (BOOST_UNLIKELY(!!ec))
+                    {
+                        if (is_skippable_error(ec, m_options))
+                        {
+                            ec.clear();
+                            continue;
+                        }
+
+                        failed = &p;
+                        goto fail;
+                    }
+                }
+
+                entries.push_back(make_entry(p, attrs));
+            }
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+            std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+            for (std::size_t i = 0u, n = entries.size(); i < n; ++i)
+            {
+                const file_type type = entries[i].type;
+                if (type == regular_file || type == symlink_file)
+                    m_files.push_back(m_entries.size() + i);
+            }
+            m_entries.insert(m_entries.end(), entries.begin(), entries.end());
+        }
+        catch (std::bad_alloc&)
+        {
+            ec = make_error_code(system::errc::not_enough_memory);
+            failed = &batch.front().path();
+            goto fail;
+        }
+
+        return true;
+
+    fail:
+        set_error(ec, *failed);
+        return false;
+    }
+
+    bool has_error() BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        return !!m_error;
+    }
+
+    //! Computes the digest of a regular file or a symlink. Returns \c false if an error occurred.
+    bool hash_entry(digest_entry& entry, std::vector< unsigned char >& buffer, tree_digest_info& info, system::error_code& ec) BOOST_NOEXCEPT
+    {
+        try
+        {
+            if (entry.type == symlink_file)
+            {
+                path target = detail::read_symlink(entry.entry_path, &ec);
+                if (BOOST_UNLIKELY(!!ec))
+                    return false;
+
+                entry.digest = hash_string(target.native());
+                return true;
+            }
+
+            if (entry.version.size == 0u)
+            {
+                entry.digest = content_hash().finish(0u);
+                return true;
+            }
+
+            if (entry.has_version)
+            {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+                std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+                hash_cache_map::const_iterator it = m_old_hashes.find(entry.version);
+                if (it != m_old_hashes.end())
+                {
+                    entry.digest = it->second;
+                    m_new_hashes[entry.version] = entry.digest;
+                    return true;
+                }
+            }
+
+            if (!hash_contents(entry.entry_path, buffer, entry.digest, ec))
+                return false;
+
+            ++info.hashed_count;
+
+            if (entry.has_version)
+            {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+                std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+                m_new_hashes[entry.version] = entry.digest;
+            }
+        }
+        catch (std::bad_alloc&)
+        {
+            ec = make_error_code(system::errc::not_enough_memory);
+            return false;
+        }
+
+        return true;
+    }
+
+    //! Reads a file and computes the hash of its contents
+    bool hash_contents(path const& p, std::vector< unsigned char >& buffer, uint64_t& digest, system::error_code& ec)
+    {
+        if ((m_options & static_cast< unsigned int >(tree_digest_options::memory_map)) != 0u)
+        {
+            mapped_file contents(p, mapped_file_flags::sequential, ec);
+            if (BOOST_UNLIKELY(!!ec))
+                return false;
+
+            content_hash h;
+            h.update(reinterpret_cast< const unsigned char* >(contents.data()), contents.size());
+            digest = h.finish(contents.size());
+            return true;
+        }
+
+        filesystem::ifstream file(p, std::ios_base::in | std::ios_base::binary);
+        if (BOOST_UNLIKELY(!file))
+        {
+            // Obtain the reason of the failure
+            detail::symlink_status(p, &ec);
+            if (!ec)
+                ec = make_error_code(system::errc::io_error);
+            return false;
+        }
+
+        buffer.resize(digest_read_buffer_size);
+        content_hash h;
+        uint64_t size = 0u;
+        while (true)
+        {
+            file.read(reinterpret_cast< char* >(&buffer[0]), static_cast< std::streamsize >(buffer.size()));
+            const std::size_t n = static_cast< std::size_t >(file.gcount());
+            h.update(&buffer[0], n);
+            size += n;
+            if (!file)
+                break;
+        }
+
+        if (BOOST_UNLIKELY(file.bad()))
+        {
+            ec = make_error_code(system::errc::io_error);
+            return false;
+        }
+
+        digest = h.finish(size);
+        return true;
+    }
+
+    //! Returns the digest of a directory, given the indices of its children
+    uint64_t combine_children(std::vector< std::size_t > const& indices, std::vector< digest_child >& sorted, std::string& data)
+    {
+        sorted.clear();
+        for (std::size_t i = 0u, n = indices.size(); i < n; ++i)
+        {
+            sorted.push_back(digest_child());
+            digest_child& child = sorted.back();
+            child.name = m_entries[indices[i]].entry_path.filename().native();
+            child.index = indices[i];
+        }
+        std::sort(sorted.begin(), sorted.end());
+
+        const bool include_permissions = (m_options & static_cast< unsigned int >(tree_digest_options::include_permissions)) != 0u;
+        data.clear();
+        for (std::size_t i = 0u, n = sorted.size(); i < n; ++i)
+        {
+            digest_entry const& entry = m_entries[sorted[i].index];
+            path::string_type const& name = sorted[i].name;
+            data.push_back(static_cast< char >(get_type_tag(entry.type)));
+            if (include_permissions && entry.type != symlink_file)
+                append_uint64(data, static_cast< uint64_t >(entry.permissions & perms_mask));
+            append_uint64(data, static_cast< uint64_t >(name.size()));
+            data.append(reinterpret_cast< const char* >(name.data()), name.size() * sizeof(path::value_type));
+            append_uint64(data, entry.digest);
+        }
+
+        content_hash h;
+        h.update(reinterpret_cast< const unsigned char* >(data.data()), data.size());
+        return h.finish(data.size());
+    }
+
+    //! Adds the results of a thread to the totals
+    void merge(tree_digest_info const& info) BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        m_info.hashed_count += info.hashed_count;
+    }
+
+    void set_error(system::error_code const& err, path const& p) BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+        std::lock_guard< std::mutex > lock(m_mutex);
+#endif
+        if (!m_error)
+        {
+            m_error = err;
+            try
+            {
+                m_error_path = p;
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+};
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL
+tree_digest_info tree_digest(path const& p, unsigned int options, path const& hash_cache, unsigned int thread_count, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    system::error_code local_ec;
+    path const* err_path = &p;
+    try
+    {
+        tree_digest_context ctx(options);
+
+        // Follow the symlink to the root directory, like directory_iterator does
+        file_attributes root_attrs = detail::query(p, ctx.query_options() & ~static_cast< unsigned int >(file_attribute_mask::no_follow), &local_ec);
+        if (BOOST_UNLIKELY(!!local_ec))
+            goto fail;
+
+        if (!hash_cache.empty())
+            load_hash_cache(hash_cache, ctx.old_hashes());
+
+        const bool is_dir = root_attrs.status.type() == directory_file;
+        if (!is_dir)
+        {
+            if (!ctx.add_root(p, root_attrs, local_ec))
+                goto fail;
+        }
+        else
+        {
+            parallel_walk_params params;
+            params.thread_count = thread_count;
+            params.batch_size = parallel_directory_walker::default_batch_size;
+            params.options = static_cast< unsigned int >(directory_options::none);
+            params.exec = NULL;
+            if ((options & static_cast< unsigned int >(tree_digest_options::skip_permission_denied)) != 0u)
+                params.options |= static_cast< unsigned int >(directory_options::skip_permission_denied);
+
+            detail::parallel_walk(p, params, &tree_digest_context::on_batch, &ctx, &local_ec);
+            if (BOOST_UNLIKELY(!!local_ec))
+                goto fail;
+        }
+
+        if (BOOST_LIKELY(!ctx.error()) && ctx.file_count() > 0u)
+        {
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+            run_in_threads(get_thread_count(thread_count), ctx);
+#else
+            ctx(0u);
+#endif
+        }
+
+        if (BOOST_UNLIKELY(!!ctx.error()))
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::tree_digest", ctx.error_path(), ctx.error()));
+            *ec = ctx.error();
+            return tree_digest_info();
+        }
+
+        tree_digest_info info;
+        if (is_dir)
+        {
+            info.digest = ctx.combine(p);
+            info.file_count = ctx.info().file_count;
+            info.directory_count = ctx.info().directory_count;
+        }
+        else
+        {
+            info.digest = ctx.root_digest();
+            info.file_count = 1u;
+        }
+        info.hashed_count = ctx.info().hashed_count;
+
+        if (!hash_cache.empty())
+        {
+            save_hash_cache(hash_cache, ctx.new_hashes(), &local_ec);
+            if (BOOST_UNLIKELY(!!local_ec))
+            {
+                err_path = &hash_cache;
+                goto fail;
+            }
+        }
+
+        return info;
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return tree_digest_info();
+    }
+
+fail:
+    if (!ec)
+        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::tree_digest", *err_path, local_ec));
+
+    *ec = local_ec;
+    return tree_digest_info();
+}
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
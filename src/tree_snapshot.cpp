@@ -0,0 +1,660 @@
+//  tree_snapshot.cpp  -----------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/path_view.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/tree_snapshot.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <new> // std::bad_alloc
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#if !defined(BOOST_NO_CXX11_HDR_CHRONO)
+#include <chrono>
+#endif
+
+#if defined(BOOST_WINDOWS_API)
+#include <windows.h>
+#endif
+
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+#if defined(BOOST_POSIX_API)
+#define BOOST_FILESYSTEM_ERROR_INVALID_DATA EINVAL
+#else
+#define BOOST_FILESYSTEM_ERROR_INVALID_DATA ERROR_INVALID_DATA
+#endif
+
+namespace boost {
+namespace filesystem {
+
+namespace {
+
+//! Snapshot image header
+struct image_header
+{
+    char signature[8];
+    boost::uint32_t version;
+    boost::uint32_t byte_order;
+    boost::uint32_t record_size;
+    boost::uint32_t char_size;
+    boost::uint64_t count;
+    //! Size of the string table, in bytes
+    boost::uint64_t strings_size;
+    boost::int64_t creation_time_ns;
+};
+
+const char image_signature[8] = { 'B', 'F', 'S', 'S', 'N', 'A', 'P', '\0' };
+BOOST_CONSTEXPR_OR_CONST boost::uint32_t image_version = 1u;
+BOOST_CONSTEXPR_OR_CONST boost::uint32_t image_byte_order = 0x01020304u;
+
+//! Directory last write times within this interval before the previous snapshot was created are not trusted. Accounts for coarse file time resolution.
+BOOST_CONSTEXPR_OR_CONST boost::int64_t untrusted_time_interval_ns = 2000000000;
+
+//! Attributes recorded in snapshots
+BOOST_CONSTEXPR_OR_CONST unsigned int snapshot_attributes =
+    static_cast< unsigned int >(file_attribute_mask::type) | static_cast< unsigned int >(file_attribute_mask::size) |
+    static_cast< unsigned int >(file_attribute_mask::last_write_time) | static_cast< unsigned int >(file_attribute_mask::inode) |
+    static_cast< unsigned int >(file_attribute_mask::device);
+
+//! Returns the current system time, in nanoseconds since the Unix epoch
+inline boost::int64_t get_current_time_ns() BOOST_NOEXCEPT
+{
+#if !defined(BOOST_NO_CXX11_HDR_CHRONO)
+    // Note: std::chrono::system_clock epoch is the Unix epoch on all supported systems
+    return static_cast< boost::int64_t >(std::chrono::duration_cast< std::chrono::nanoseconds >(std::chrono::system_clock::now().time_since_epoch()).count());
+#else
+    return static_cast< boost::int64_t >(std::time(NULL)) * 1000000000;
+#endif
+}
+
+//! Lexicographically compares native path strings
+inline int compare_native(const path::value_type* left, std::size_t left_size, const path::value_type* right, std::size_t right_size) BOOST_NOEXCEPT
+{
+    const int res = path::string_type::traits_type::compare(left, right, left_size < right_size ? left_size : right_size);
+    if (res != 0)
+        return res;
+    return left_size < right_size ? -1 : (left_size > right_size ? 1 : 0);
+}
+
+//! Returns the index of the first record in \a snapshot with the path not less than \a p
+std::size_t find_lower_bound(tree_snapshot const& snapshot, const path::value_type* p, std::size_t size) BOOST_NOEXCEPT
+{
+    std::size_t first = 0u, count = snapshot.size();
+    while (count > 0u)
+    {
+        const std::size_t step = count / 2u;
+        const std::size_t mid = first + step;
+        path_view const mid_path = snapshot[mid].relative_path();
+        if (compare_native(mid_path.data(), mid_path.size(), p, size) < 0)
+        {
+            first = mid + 1u;
+            count -= step + 1u;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+
+    return first;
+}
+
+//! Converts file attributes to a snapshot record
+void make_record(file_attributes const& attrs, detail::tree_snapshot_record& rec) BOOST_NOEXCEPT
+{
+    const unsigned int mask = static_cast< unsigned int >(attrs.mask);
+    rec.type = (mask & static_cast< unsigned int >(file_attribute_mask::type)) != 0u ? static_cast< boost::uint32_t >(attrs.status.type()) : static_cast< boost::uint32_t >(type_unknown);
+    rec.size = (rec.type == static_cast< boost::uint32_t >(regular_file) && (mask & static_cast< unsigned int >(file_attribute_mask::size)) != 0u) ?
+        static_cast< boost::uint64_t >(attrs.size) : 0u;
+    rec.last_write_time_ns = (mask & static_cast< unsigned int >(file_attribute_mask::last_write_time)) != 0u ?
+        static_cast< boost::int64_t >(attrs.last_write_time) * 1000000000 + static_cast< boost::int64_t >(attrs.last_write_time_nsec) : 0;
+    rec.inode = (mask & static_cast< unsigned int >(file_attribute_mask::inode)) != 0u ? static_cast< boost::uint64_t >(attrs.inode) : 0u;
+    rec.device = (mask & static_cast< unsigned int >(file_attribute_mask::device)) != 0u ? static_cast< boost::uint64_t >(attrs.device) : 0u;
+    rec.reserved = 0u;
+}
+
+//! Walks the directory tree and collects snapshot records
+class snapshot_builder
+{
+private:
+    path const& m_root;
+    const unsigned int m_options;
+    //! The previous snapshot or \c NULL
+    const tree_snapshot* const m_old;
+    //! Directories with last write times starting at this time are not trusted to be unchanged
+    boost::int64_t m_trusted_time_limit_ns;
+
+    //! Collected records, \c path_offset refers to \c m_strings and is in characters
+    std::vector< detail::tree_snapshot_record > m_records;
+    //! Relative paths of the collected records
+    path::string_type m_strings;
+    //! Scratch buffers
+    std::vector< path > m_paths;
+    std::vector< file_attributes > m_attrs;
+
+public:
+    snapshot_builder(path const& root, unsigned int options, const tree_snapshot* old) :
+        m_root(root),
+        m_options(options),
+        m_old(old),
+        m_trusted_time_limit_ns(old ? old->creation_time_ns() - untrusted_time_interval_ns : 0)
+    {
+    }
+
+    //! Walks the tree. Returns zero or an error code and the path that caused the error.
+    err_t walk(path& error_path)
+    {
+        system::error_code ec;
+        file_attributes attrs = detail::query(m_root, snapshot_attributes, &ec);
+        if (BOOST_UNLIKELY(!!ec))
+        {
+            error_path = m_root;
+            return static_cast< err_t >(ec.value());
+        }
+
+        detail::tree_snapshot_record rec;
+        make_record(attrs, rec);
+        if (BOOST_UNLIKELY(rec.type != static_cast< boost::uint32_t >(directory_file)))
+        {
+            error_path = m_root;
+#if defined(BOOST_POSIX_API)
+            return ENOTDIR;
+#else
+            return ERROR_DIRECTORY;
+#endif
+        }
+
+        add_record(rec, path::string_type());
+        return walk_directory(path::string_type(), rec, error_path);
+    }
+
+    //! Returns \c true if the collected paths fit in a snapshot image
+    bool is_representable() const BOOST_NOEXCEPT
+    {
+        return m_strings.size() <= static_cast< std::size_t >((std::numeric_limits< boost::uint32_t >::max)()) / sizeof(path::value_type);
+    }
+
+    //! Builds the snapshot image in \a buffer
+    void build_image(boost::int64_t creation_time_ns, std::vector< boost::uint64_t >& buffer) const
+    {
+        const std::size_t count = m_records.size();
+        std::vector< std::size_t > order(count);
+        for (std::size_t i = 0u; i < count; ++i)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), record_order(m_records, m_strings));
+
+        const std::size_t strings_size = m_strings.size() * sizeof(path::value_type);
+
+        const std::size_t image_size = sizeof(image_header) + count * sizeof(detail::tree_snapshot_record) + strings_size;
+        buffer.assign((image_size + sizeof(boost::uint64_t) - 1u) / sizeof(boost::uint64_t), 0u);
+        char* const image = reinterpret_cast< char* >(&buffer[0]);
+
+        image_header header;
+        std::memcpy(header.signature, image_signature, sizeof(header.signature));
+        header.version = image_version;
+        header.byte_order = image_byte_order;
+        header.record_size = static_cast< boost::uint32_t >(sizeof(detail::tree_snapshot_record));
+        header.char_size = static_cast< boost::uint32_t >(sizeof(path::value_type));
+        header.count = count;
+        header.strings_size = strings_size;
+        header.creation_time_ns = creation_time_ns;
+        std::memcpy(image, &header, sizeof(header));
+
+        // Strings are stored in the order of records to improve locality
+        detail::tree_snapshot_record* const records = reinterpret_cast< detail::tree_snapshot_record* >(image + sizeof(image_header));
+        path::value_type* const strings = reinterpret_cast< path::value_type* >(image + sizeof(image_header) + count * sizeof(detail::tree_snapshot_record));
+        std::size_t string_pos = 0u;
+        for (std::size_t i = 0u; i < count; ++i)
+        {
+            detail::tree_snapshot_record rec = m_records[order[i]];
+            if (rec.path_size > 0u)
+                std::memcpy(strings + string_pos, m_strings.data() + rec.path_offset, rec.path_size * sizeof(path::value_type));
+            rec.path_offset = static_cast< boost::uint32_t >(string_pos * sizeof(path::value_type));
+            string_pos += rec.path_size;
+            records[i] = rec;
+        }
+    }
+
+private:
+    //! Orders records by their paths
+    struct record_order
+    {
+        std::vector< detail::tree_snapshot_record > const& records;
+        path::string_type const& strings;
+
+        record_order(std::vector< detail::tree_snapshot_record > const& recs, path::string_type const& strs) BOOST_NOEXCEPT : records(recs), strings(strs) {}
+
+        bool operator()(std::size_t left, std::size_t right) const BOOST_NOEXCEPT
+        {
+            detail::tree_snapshot_record const& l = records[left];
+            detail::tree_snapshot_record const& r = records[right];
+            return compare_native(strings.data() + l.path_offset, l.path_size, strings.data() + r.path_offset, r.path_size) < 0;
+        }
+    };
+
+    void add_record(detail::tree_snapshot_record rec, path::string_type const& rel)
+    {
+        rec.path_offset = static_cast< boost::uint32_t >(m_strings.size());
+        rec.path_size = static_cast< boost::uint32_t >(rel.size());
+        m_strings.append(rel);
+        m_records.push_back(rec);
+    }
+
+    static path::string_type make_child_path(path::string_type const& rel, const path::value_type* name, std::size_t size)
+    {
+        path::string_type child;
+        child.reserve(rel.size() + 1u + size);
+        child = rel;
+        if (!child.empty())
+            child.push_back(path::preferred_separator);
+        child.append(name, size);
+        return child;
+    }
+
+    //! Finds the recorded immediate children of the directory with index \a index in the previous snapshot
+    void find_old_children(std::size_t index, std::vector< std::size_t >& children) const
+    {
+        tree_snapshot const& old = *m_old;
+        path_view const dir = old[index].relative_path();
+
+        // Children paths start with the directory path followed by a separator, and the paths of their descendants follow them
+        path::string_type prefix(dir.data(), dir.size());
+        if (!prefix.empty())
+            prefix.push_back(path::preferred_separator);
+
+        std::size_t pos = index + 1u;
+        while (pos < old.size())
+        {
+            path_view const p = old[pos].relative_path();
+            if (p.size() <= prefix.size() || path::string_type::traits_type::compare(p.data(), prefix.data(), prefix.size()) != 0)
+                break;
+
+            children.push_back(pos);
+
+            // Skip the descendants of the child. Their paths are less than the child path followed by the character following the separator.
+            path::string_type next(p.data(), p.size());
+            next.push_back(static_cast< path::value_type >(path::preferred_separator + 1));
+            pos = find_lower_bound(old, next.data(), next.size());
+        }
+    }
+
+    err_t walk_directory(path::string_type const& rel, detail::tree_snapshot_record const& dir_rec, path& error_path)
+    {
+        const path dir_path(rel.empty() ? m_root : m_root / path(rel));
+
+        // Check if the directory listing is known to be unchanged since the previous snapshot
+        std::vector< std::size_t > old_children;
+        bool unchanged = false;
+        if (m_old)
+        {
+            const std::size_t old_index = m_old->find(path_view(rel));
+            if (old_index != tree_snapshot::npos)
+            {
+                tree_snapshot_entry const old_dir = (*m_old)[old_index];
+                unchanged = old_dir.type() == directory_file && old_dir.inode() == dir_rec.inode && old_dir.device() == dir_rec.device &&
+                    old_dir.last_write_time_ns() == dir_rec.last_write_time_ns && dir_rec.last_write_time_ns < m_trusted_time_limit_ns;
+                if (unchanged)
+                    find_old_children(old_index, old_children);
+            }
+        }
+
+        std::vector< path::string_type > names;
+        if (unchanged)
+        {
+            names.reserve(old_children.size());
+            for (std::size_t i = 0u, n = old_children.size(); i < n; ++i)
+                names.push_back((*m_old)[old_children[i]].relative_path().filename().native());
+        }
+        else
+        {
+            system::error_code ec;
+            directory_iterator it(dir_path, directory_options::none, ec), end;
+            while (!ec && it != end)
+            {
+                names.push_back(it->path().filename().native());
+                it.increment(ec);
+            }
+
+            if (BOOST_UNLIKELY(!!ec))
+            {
+                if ((m_options & static_cast< unsigned int >(snapshot_options::skip_permission_denied)) != 0u &&
+                    ec == system::errc::permission_denied)
+                {
+                    return 0;
+                }
+
+                // The directory may have been removed after it was listed in its parent
+                if (!rel.empty() && (ec == system::errc::no_such_file_or_directory || ec == system::errc::not_a_directory))
+                    return 0;
+
+                error_path = dir_path;
+                return static_cast< err_t >(ec.value());
+            }
+        }
+
+        // Reuse the recorded files or query their attributes
+        const bool reuse_files = unchanged && (m_options & static_cast< unsigned int >(snapshot_options::skip_unchanged_files)) != 0u;
+        std::vector< path::string_type > child_paths;
+        std::vector< detail::tree_snapshot_record > child_records;
+        child_paths.reserve(names.size());
+        child_records.resize(names.size());
+
+        m_paths.clear();
+        for (std::size_t i = 0u, n = names.size(); i < n; ++i)
+        {
+            child_paths.push_back(make_child_path(rel, names[i].data(), names[i].size()));
+            if (reuse_files && (*m_old)[old_children[i]].type() != directory_file)
+                continue;
+            m_paths.push_back(dir_path / path(names[i]));
+        }
+
+        m_attrs.resize(m_paths.size());
+        if (!m_paths.empty())
+        {
+            detail::query_batch(&m_paths[0], m_paths.size(), snapshot_attributes | static_cast< unsigned int >(file_attribute_mask::no_follow), &m_attrs[0]);
+        }
+
+        std::vector< bool > present(names.size(), true);
+        for (std::size_t i = 0u, pos = 0u, n = names.size(); i < n; ++i)
+        {
+            if (reuse_files && (*m_old)[old_children[i]].type() != directory_file)
+            {
+                tree_snapshot_entry const old_entry = (*m_old)[old_children[i]];
+                detail::tree_snapshot_record& rec = child_records[i];
+                rec.type = static_cast< boost::uint32_t >(old_entry.type());
+                rec.size = static_cast< boost::uint64_t >(old_entry.size());
+                rec.last_write_time_ns = old_entry.last_write_time_ns();
+                rec.inode = static_cast< boost::uint64_t >(old_entry.inode());
+                rec.device = static_cast< boost::uint64_t >(old_entry.device());
+                rec.reserved = 0u;
+                continue;
+            }
+
+            file_attributes const& attrs = m_attrs[pos++];
+            if (attrs.mask == file_attribute_mask::none)
+            {
+                // The file was removed after listing the directory
+                present[i] = false;
+                continue;
+            }
+            make_record(attrs, child_records[i]);
+        }
+
+        for (std::size_t i = 0u, n = names.size(); i < n; ++i)
+        {
+            if (!present[i])
+                continue;
+
+            add_record(child_records[i], child_paths[i]);
+            if (child_records[i].type == static_cast< boost::uint32_t >(directory_file))
+            {
+                err_t err = walk_directory(child_paths[i], child_records[i], error_path);
+                if (BOOST_UNLIKELY(err != 0))
+                    return err;
+            }
+        }
+
+        return 0;
+    }
+};
+
+} // unnamed namespace
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                         class tree_snapshot implementation                           //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+#if defined(BOOST_NO_CXX17_INLINE_VARIABLES)
+BOOST_CONSTEXPR_OR_CONST std::size_t tree_snapshot::npos;
+#endif
+
+BOOST_FILESYSTEM_DECL void tree_snapshot::clear() BOOST_NOEXCEPT
+{
+    m_data = NULL;
+    m_count = 0u;
+    std::vector< boost::uint64_t >().swap(m_buffer);
+    m_mapping.close();
+}
+
+BOOST_FILESYSTEM_DECL const detail::tree_snapshot_record* tree_snapshot::records() const BOOST_NOEXCEPT
+{
+    return m_data ? reinterpret_cast< const detail::tree_snapshot_record* >(m_data + sizeof(image_header)) : NULL;
+}
+
+BOOST_FILESYSTEM_DECL const path::value_type* tree_snapshot::strings() const BOOST_NOEXCEPT
+{
+    return m_data ? reinterpret_cast< const path::value_type* >(m_data + sizeof(image_header) + m_count * sizeof(detail::tree_snapshot_record)) : NULL;
+}
+
+BOOST_FILESYSTEM_DECL boost::int64_t tree_snapshot::creation_time_ns() const BOOST_NOEXCEPT
+{
+    return m_data ? reinterpret_cast< const image_header* >(m_data)->creation_time_ns : 0;
+}
+
+BOOST_FILESYSTEM_DECL std::size_t tree_snapshot::data_size() const BOOST_NOEXCEPT
+{
+    if (!m_data)
+        return 0u;
+
+    const image_header* header = reinterpret_cast< const image_header* >(m_data);
+    return sizeof(image_header) + m_count * sizeof(detail::tree_snapshot_record) + static_cast< std::size_t >(header->strings_size);
+}
+
+BOOST_FILESYSTEM_DECL std::size_t tree_snapshot::find(path_view const& p) const BOOST_NOEXCEPT
+{
+    const std::size_t pos = find_lower_bound(*this, p.data(), p.size());
+    if (pos < m_count)
+    {
+        path_view const found = (*this)[pos].relative_path();
+        if (compare_native(found.data(), found.size(), p.data(), p.size()) == 0)
+            return pos;
+    }
+
+    return npos;
+}
+
+BOOST_FILESYSTEM_DECL void tree_snapshot::build_impl(path const& root, unsigned int options, bool incremental, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    try
+    {
+        const boost::int64_t creation_time_ns = get_current_time_ns();
+        snapshot_builder builder(root, options, (incremental && m_data != NULL) ? this : static_cast< const tree_snapshot* >(NULL));
+
+        path error_path;
+        const err_t err = builder.walk(error_path);
+        if (BOOST_UNLIKELY(err != 0))
+        {
+            emit_error(err, error_path, ec, "boost::filesystem::tree_snapshot::build");
+            return;
+        }
+
+        if (BOOST_UNLIKELY(!builder.is_representable()))
+        {
+#if defined(BOOST_POSIX_API)
+            emit_error(EFBIG, root, ec, "boost::filesystem::tree_snapshot::build");
+#else
+            emit_error(ERROR_FILE_TOO_LARGE, root, ec, "boost::filesystem::tree_snapshot::build");
+#endif
+            return;
+        }
+
+        std::vector< boost::uint64_t > buffer;
+        builder.build_image(creation_time_ns, buffer);
+
+        clear();
+        m_buffer.swap(buffer);
+        m_data = reinterpret_cast< const char* >(&m_buffer[0]);
+        m_count = static_cast< std::size_t >(reinterpret_cast< const image_header* >(m_data)->count);
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = system::errc::make_error_code(system::errc::not_enough_memory);
+    }
+}
+
+BOOST_FILESYSTEM_DECL void tree_snapshot::save_impl(path const& p, system::error_code* ec) const
+{
+    if (m_data)
+    {
+        detail::atomic_write_file(p, m_data, data_size(), static_cast< unsigned int >(write_file_options::synchronize), ec);
+        return;
+    }
+
+    // Save an empty image
+    image_header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.signature, image_signature, sizeof(header.signature));
+    header.version = image_version;
+    header.byte_order = image_byte_order;
+    header.record_size = static_cast< boost::uint32_t >(sizeof(detail::tree_snapshot_record));
+    header.char_size = static_cast< boost::uint32_t >(sizeof(path::value_type));
+    detail::atomic_write_file(p, &header, sizeof(header), static_cast< unsigned int >(write_file_options::synchronize), ec);
+}
+
+BOOST_FILESYSTEM_DECL void tree_snapshot::load_impl(path const& p, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    mapped_file mapping;
+    if (ec)
+    {
+        mapping.open(p, mapped_file_flags::sequential, *ec);
+        if (*ec)
+            return;
+    }
+    else
+    {
+        mapping.open(p, mapped_file_flags::sequential);
+    }
+
+    // Validate the image
+    image_header header;
+    if (mapping.size() < sizeof(header))
+    {
+    invalid_image:
+        emit_error(BOOST_FILESYSTEM_ERROR_INVALID_DATA, p, ec, "boost::filesystem::tree_snapshot::load");
+        return;
+    }
+
+    std::memcpy(&header, mapping.data(), sizeof(header));
+    if (std::memcmp(header.signature, image_signature, sizeof(header.signature)) != 0 || header.version != image_version ||
+        header.byte_order != image_byte_order || header.record_size != sizeof(detail::tree_snapshot_record) ||
+        header.char_size != sizeof(path::value_type))
+    {
+        goto invalid_image;
+    }
+
+    const std::size_t max_count = (mapping.size() - sizeof(header)) / sizeof(detail::tree_snapshot_record);
+    if (header.count > max_count)
+        goto invalid_image;
+
+    const std::size_t count = static_cast< std::size_t >(header.count);
+    const std::size_t strings_size = mapping.size() - sizeof(header) - count * sizeof(detail::tree_snapshot_record);
+    if (header.strings_size != strings_size || strings_size % sizeof(path::value_type) != 0u)
+        goto invalid_image;
+
+    const detail::tree_snapshot_record* records = reinterpret_cast< const detail::tree_snapshot_record* >(mapping.data() + sizeof(header));
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+        detail::tree_snapshot_record const& rec = records[i];
+        if (rec.path_offset > strings_size || rec.path_offset % sizeof(path::value_type) != 0u ||
+            rec.path_size > (strings_size - rec.path_offset) / sizeof(path::value_type))
+        {
+            goto invalid_image;
+        }
+    }
+
+    clear();
+    swap(m_mapping, mapping);
+    m_data = m_mapping.data();
+    m_count = count;
+}
+
+BOOST_FILESYSTEM_DECL std::vector< tree_change > diff(tree_snapshot const& from, tree_snapshot const& to)
+{
+    std::vector< tree_change > changes;
+
+    std::size_t i = 0u, j = 0u;
+    const std::size_t from_size = from.size(), to_size = to.size();
+    while (i < from_size || j < to_size)
+    {
+        int res;
+        if (i == from_size)
+        {
+            res = 1;
+        }
+        else if (j == to_size)
+        {
+            res = -1;
+        }
+        else
+        {
+            path_view const from_path = from[i].relative_path();
+            path_view const to_path = to[j].relative_path();
+            res = compare_native(from_path.data(), from_path.size(), to_path.data(), to_path.size());
+        }
+
+        if (res < 0)
+        {
+            tree_snapshot_entry const e = from[i++];
+            changes.push_back(tree_change(tree_change_kind::removed, e.type(), e.relative_path()));
+        }
+        else if (res > 0)
+        {
+            tree_snapshot_entry const e = to[j++];
+            changes.push_back(tree_change(tree_change_kind::added, e.type(), e.relative_path()));
+        }
+        else
+        {
+            tree_snapshot_entry const old_entry = from[i++];
+            tree_snapshot_entry const new_entry = to[j++];
+
+            // Changes of directory contents are reported for the directory entries, so directory times are not compared
+            const bool modified = old_entry.type() != new_entry.type() || old_entry.inode() != new_entry.inode() || old_entry.device() != new_entry.device() ||
+                (new_entry.type() != directory_file && (old_entry.size() != new_entry.size() || old_entry.last_write_time_ns() != new_entry.last_write_time_ns()));
+            if (modified)
+                changes.push_back(tree_change(tree_change_kind::modified, new_entry.type(), new_entry.relative_path()));
+        }
+    }
+
+    return changes;
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
@@ -89,12 +89,24 @@
 #endif // BOOST_POSIX_API
 
 #include <cstddef>
+#include <cstring>
+#include <boost/cstdint.hpp>
 #include <boost/filesystem/config.hpp>
 #include <boost/filesystem/operations.hpp>
 #include "private_config.hpp"
 #include "atomic_tools.hpp"
 #include "error_handling.hpp"
 
+// arc4random is already a buffered user-space generator, there is no point in adding another one on top of it
+#if !defined(BOOST_FILESYSTEM_DISABLE_BUFFERED_RANDOM) && !defined(BOOST_FILESYSTEM_HAS_ARC4RANDOM) && \
+    (defined(BOOST_FILESYSTEM_SINGLE_THREADED) || !defined(BOOST_NO_CXX11_THREAD_LOCAL))
+#define BOOST_FILESYSTEM_HAS_BUFFERED_RANDOM
+#if defined(BOOST_POSIX_API) && !defined(__wasm)
+#include <pthread.h>
+#define BOOST_FILESYSTEM_HAS_FORK_DETECTION
+#endif
+#endif
+
 #include <boost/filesystem/detail/header.hpp> // must be the last #include
 
 #if defined(BOOST_POSIX_API)
@@ -147,8 +159,10 @@ int fill_random_dev_random(void* buf, std::size_t len)
 
 typedef int fill_random_t(void* buf, std::size_t len);
 
-//! Pointer to the implementation of fill_random.
-fill_random_t* fill_random = &fill_random_dev_random;
+int fill_random_select_impl(void* buf, std::size_t len);
+
+//! Pointer to the implementation of fill_random. Initialized to the implementation selector, which is replaced on the first call.
+fill_random_t* fill_random = &fill_random_select_impl;
 
 //! Fills buffer with cryptographically random data obtained from getrandom()
 int fill_random_getrandom(void* buf, std::size_t len)
@@ -183,6 +197,20 @@ int fill_random_getrandom(void* buf, std::size_t len)
     return 0;
 }
 
+//! Selects the fill_random implementation based on the kernel version and forwards the call to it
+int fill_random_select_impl(void* buf, std::size_t len)
+{
+    fill_random_t* fr = &fill_random_dev_random;
+
+    // getrandom was added in Linux 3.17
+    unsigned int major_ver = 0u, minor_ver = 0u, patch_ver = 0u;
+    if (get_linux_kernel_version(major_ver, minor_ver, patch_ver) && (major_ver > 3u || (major_ver == 3u && minor_ver >= 17u)))
+        fr = &fill_random_getrandom;
+
+    filesystem::detail::atomic_store_relaxed(fill_random, fr);
+    return fr(buf, len);
+}
+
 #endif // defined(BOOST_FILESYSTEM_HAS_GETRANDOM) || defined(BOOST_FILESYSTEM_HAS_GETRANDOM_SYSCALL)
 
 #endif // defined(BOOST_POSIX_API) && !defined(BOOST_FILESYSTEM_HAS_ARC4RANDOM)
@@ -257,33 +285,227 @@ void system_crypt_random(void* buf, std::size_t len, boost::system::error_code*
 #endif // defined(BOOST_POSIX_API)
 }
 
-#ifdef BOOST_WINDOWS_API
-BOOST_CONSTEXPR_OR_CONST wchar_t hex[] = L"0123456789abcdef";
-BOOST_CONSTEXPR_OR_CONST wchar_t percent = L'%';
+#if defined(BOOST_FILESYSTEM_HAS_BUFFERED_RANDOM)
+
+#if defined(BOOST_FILESYSTEM_HAS_FORK_DETECTION)
+
+//! Incremented in the child process on every fork, which invalidates the generator state inherited from the parent
+unsigned int g_fork_generation = 0u;
+
+extern "C" void on_fork_child()
+{
+    filesystem::detail::atomic_store_relaxed(g_fork_generation, filesystem::detail::atomic_load_relaxed(g_fork_generation) + 1u);
+}
+
+//! Registers the fork handler on construction
+struct fork_handler_registration
+{
+    fork_handler_registration() BOOST_NOEXCEPT
+    {
+        ::pthread_atfork(NULL, NULL, &on_fork_child);
+    }
+};
+
+#endif // defined(BOOST_FILESYSTEM_HAS_FORK_DETECTION)
+
+//! ChaCha20 based random number generator, seeded from the system random number source
+/*!
+ * The generator uses fast key erasure: every refill of the keystream buffer replaces the key with the first bytes
+ * of the new keystream, and the bytes are erased from the buffer once returned to the caller. This way, the generator
+ * state cannot be used to recover the previously generated data. The generator is reseeded from the system source
+ * after producing \c reseed_interval bytes and in the child process after fork.
+ */
+class chacha20_random
+{
+private:
+    BOOST_STATIC_CONSTANT(std::size_t, block_size = 64u);
+    BOOST_STATIC_CONSTANT(std::size_t, key_size = 32u);
+    BOOST_STATIC_CONSTANT(std::size_t, buffer_size = 8u * block_size);
+    BOOST_STATIC_CONSTANT(boost::uint64_t, reseed_interval = 1024u * 1024u);
+
+private:
+    boost::uint32_t m_key[key_size / 4u];
+    unsigned char m_buffer[buffer_size];
+    std::size_t m_pos;
+    boost::uint64_t m_output_size;
+    unsigned int m_fork_generation;
+    bool m_seeded;
+
+public:
+    chacha20_random() BOOST_NOEXCEPT :
+        m_pos(buffer_size),
+        m_output_size(0u),
+        m_fork_generation(0u),
+        m_seeded(false)
+    {
+    }
+
+    ~chacha20_random()
+    {
+        secure_erase(m_key, sizeof(m_key));
+        secure_erase(m_buffer, sizeof(m_buffer));
+    }
+
+    void generate(void* buf, std::size_t len, boost::system::error_code* ec)
+    {
+        if (BOOST_UNLIKELY(!m_seeded || m_output_size >= reseed_interval || is_forked()))
+        {
+            if (!reseed(ec))
+                return;
+        }
+
+        unsigned char* p = static_cast< unsigned char* >(buf);
+        while (len > 0u)
+        {
+            if (m_pos == buffer_size)
+                refill();
+
+            std::size_t n = buffer_size - m_pos;
+            if (n > len)
+                n = len;
+            std::memcpy(p, m_buffer + m_pos, n);
+            std::memset(m_buffer + m_pos, 0, n);
+            m_pos += n;
+            m_output_size += n;
+            p += n;
+            len -= n;
+        }
+    }
+
+    BOOST_DELETED_FUNCTION(chacha20_random(chacha20_random const&))
+    BOOST_DELETED_FUNCTION(chacha20_random& operator=(chacha20_random const&))
+
+private:
+    bool is_forked() const BOOST_NOEXCEPT
+    {
+#if defined(BOOST_FILESYSTEM_HAS_FORK_DETECTION)
+        return filesystem::detail::atomic_load_relaxed(g_fork_generation) != m_fork_generation;
 #else
-BOOST_CONSTEXPR_OR_CONST char hex[] = "0123456789abcdef";
-BOOST_CONSTEXPR_OR_CONST char percent = '%';
+        return false;
 #endif
+    }
 
-} // unnamed namespace
+    bool reseed(boost::system::error_code* ec)
+    {
+#if defined(BOOST_FILESYSTEM_HAS_FORK_DETECTION)
+        static const fork_handler_registration registration;
+        (void)registration;
+        m_fork_generation = filesystem::detail::atomic_load_relaxed(g_fork_generation);
+#endif
 
-#if defined(linux) || defined(__linux) || defined(__linux__)
+        system_crypt_random(m_key, sizeof(m_key), ec);
+        if (ec && *ec)
+            return false;
 
-//! Initializes fill_random implementation pointer
-void init_fill_random_impl(unsigned int major_ver, unsigned int minor_ver, unsigned int patch_ver)
-{
-#if defined(BOOST_FILESYSTEM_HAS_INIT_PRIORITY) && \
-    (defined(BOOST_FILESYSTEM_HAS_GETRANDOM) || defined(BOOST_FILESYSTEM_HAS_GETRANDOM_SYSCALL))
-    fill_random_t* fr = &fill_random_dev_random;
+        // Discard the keystream generated with the previous key
+        std::memset(m_buffer, 0, sizeof(m_buffer));
+        m_pos = buffer_size;
+        m_output_size = 0u;
+        m_seeded = true;
+        return true;
+    }
 
-    if (major_ver > 3u || (major_ver == 3u && minor_ver >= 17u))
-        fr = &fill_random_getrandom;
+    void refill() BOOST_NOEXCEPT
+    {
+        // The key is replaced after every refill, so the block counter can start from zero each time
+        for (std::size_t i = 0u; i < buffer_size / block_size; ++i)
+            chacha20_block(static_cast< boost::uint32_t >(i), m_buffer + i * block_size);
 
-    filesystem::detail::atomic_store_relaxed(fill_random, fr);
+        std::memcpy(m_key, m_buffer, key_size);
+        std::memset(m_buffer, 0, key_size);
+        m_pos = key_size;
+    }
+
+    static BOOST_FORCEINLINE boost::uint32_t rotl(boost::uint32_t x, unsigned int n) BOOST_NOEXCEPT
+    {
+        return (x << n) | (x >> (32u - n));
+    }
+
+    static BOOST_FORCEINLINE void quarter_round(boost::uint32_t* x, unsigned int a, unsigned int b, unsigned int c, unsigned int d) BOOST_NOEXCEPT
+    {
+        x[a] += x[b];
+        x[d] = rotl(x[d] ^ x[a], 16u);
+        x[c] += x[d];
+        x[b] = rotl(x[b] ^ x[c], 12u);
+        x[a] += x[b];
+        x[d] = rotl(x[d] ^ x[a], 8u);
+        x[c] += x[d];
+        x[b] = rotl(x[b] ^ x[c], 7u);
+    }
+
+    //! Generates one keystream block for the current key, the given block counter and zero nonce
+    void chacha20_block(boost::uint32_t counter, unsigned char* out) const BOOST_NOEXCEPT
+    {
+        boost::uint32_t input[16] =
+        {
+            // "expand 32-byte k"
+            0x61707865u, 0x3320646eu, 0x79622d32u, 0x6b206574u,
+            m_key[0], m_key[1], m_key[2], m_key[3], m_key[4], m_key[5], m_key[6], m_key[7],
+            counter, 0u, 0u, 0u
+        };
+
+        boost::uint32_t x[16];
+        std::memcpy(x, input, sizeof(x));
+        for (unsigned int i = 0u; i < 10u; ++i)
+        {
+            quarter_round(x, 0u, 4u, 8u, 12u);
+            quarter_round(x, 1u, 5u, 9u, 13u);
+            quarter_round(x, 2u, 6u, 10u, 14u);
+            quarter_round(x, 3u, 7u, 11u, 15u);
+            quarter_round(x, 0u, 5u, 10u, 15u);
+            quarter_round(x, 1u, 6u, 11u, 12u);
+            quarter_round(x, 2u, 7u, 8u, 13u);
+            quarter_round(x, 3u, 4u, 9u, 14u);
+        }
+
+        for (unsigned int i = 0u; i < 16u; ++i)
+            x[i] += input[i];
+
+        // The byte order of the output does not matter since the data is only used as random bits
+        std::memcpy(out, x, block_size);
+        secure_erase(x, sizeof(x));
+        secure_erase(input, sizeof(input));
+    }
+
+    //! Clears memory in a way that is not optimized away by the compiler
+    static void secure_erase(void* p, std::size_t size) BOOST_NOEXCEPT
+    {
+        volatile unsigned char* q = static_cast< volatile unsigned char* >(p);
+        while (size > 0u)
+        {
+            *q++ = 0u;
+            --size;
+        }
+    }
+};
+
+#if defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+chacha20_random g_random;
+#else
+thread_local chacha20_random g_random;
+#endif
+
+#endif // defined(BOOST_FILESYSTEM_HAS_BUFFERED_RANDOM)
+
+//! Fills buffer with random data for unique_path
+inline void crypt_random(void* buf, std::size_t len, boost::system::error_code* ec)
+{
+#if defined(BOOST_FILESYSTEM_HAS_BUFFERED_RANDOM)
+    g_random.generate(buf, len, ec);
+#else
+    system_crypt_random(buf, len, ec);
 #endif
 }
 
-#endif // defined(linux) || defined(__linux) || defined(__linux__)
+#ifdef BOOST_WINDOWS_API
+BOOST_CONSTEXPR_OR_CONST wchar_t hex[] = L"0123456789abcdef";
+BOOST_CONSTEXPR_OR_CONST wchar_t percent = L'%';
+#else
+BOOST_CONSTEXPR_OR_CONST char hex[] = "0123456789abcdef";
+BOOST_CONSTEXPR_OR_CONST char percent = '%';
+#endif
+
+} // unnamed namespace
 
 BOOST_FILESYSTEM_DECL
 path unique_path(path const& model, system::error_code* ec)
@@ -294,6 +516,9 @@ path unique_path(path const& model, system::error_code* ec)
     // bytes and 40-7F as trailing bytes, whereas % is 25.
     // So, use string on POSIX and avoid conversions.
 
+    if (ec)
+        ec->clear();
+
     path::string_type s(model.native());
 
     char ran[16] = {};                                                    // init to avoid clang static analyzer message
@@ -307,7 +532,7 @@ path unique_path(path const& model, system::error_code* ec)
         {
             if (nibbles_used == max_nibbles)
             {
-                system_crypt_random(ran, sizeof(ran), ec);
+                crypt_random(ran, sizeof(ran), ec);
                 if (ec && *ec)
                     return path();
                 nibbles_used = 0;
@@ -318,9 +543,6 @@ path unique_path(path const& model, system::error_code* ec)
         }
     }
 
-    if (ec)
-        ec->clear();
-
     return s;
 }
 
@@ -0,0 +1,645 @@
+//  volume_scanner.cpp  ----------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/volume_scanner.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <new> // std::bad_alloc
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#if defined(BOOST_WINDOWS_API)
+#include <cwchar>
+#include <limits>
+#include <map>
+#include <string>
+#include <windows.h>
+#include <winioctl.h>
+#include "windows_tools.hpp"
+#else
+#include <cerrno>
+#endif
+
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+#if defined(BOOST_WINDOWS_API)
+
+#ifndef FSCTL_ENUM_USN_DATA
+#define FSCTL_ENUM_USN_DATA 0x900b3
+#endif
+
+#ifndef FSCTL_READ_USN_JOURNAL
+#define FSCTL_READ_USN_JOURNAL 0x900bb
+#endif
+
+#ifndef FSCTL_QUERY_USN_JOURNAL
+#define FSCTL_QUERY_USN_JOURNAL 0x900f4
+#endif
+
+#ifndef ERROR_JOURNAL_NOT_ACTIVE
+#define ERROR_JOURNAL_NOT_ACTIVE 1179L
+#endif
+
+#ifndef USN_REASON_FILE_DELETE
+#define USN_REASON_FILE_DELETE 0x00000200
+#endif
+
+#ifndef USN_REASON_RENAME_OLD_NAME
+#define USN_REASON_RENAME_OLD_NAME 0x00001000
+#endif
+
+#endif // defined(BOOST_WINDOWS_API)
+
+namespace boost {
+namespace filesystem {
+
+#if defined(BOOST_WINDOWS_API)
+
+namespace detail {
+namespace {
+
+//! Size of the buffer for the records returned by FSCTL_ENUM_USN_DATA and FSCTL_READ_USN_JOURNAL
+BOOST_CONSTEXPR_OR_CONST std::size_t usn_buffer_size = 128u * 1024u;
+
+//! MFT_ENUM_DATA_V1 definition from Windows SDK. Supported since Windows 8, MFT_ENUM_DATA_V0 only includes the first three members.
+struct mft_enum_data_v1
+{
+    DWORDLONG StartFileReferenceNumber;
+    LONGLONG LowUsn;
+    LONGLONG HighUsn;
+    WORD MinMajorVersion;
+    WORD MaxMajorVersion;
+};
+
+//! USN_JOURNAL_DATA_V0 definition from Windows SDK
+struct usn_journal_data_v0
+{
+    DWORDLONG UsnJournalID;
+    LONGLONG FirstUsn;
+    LONGLONG NextUsn;
+    LONGLONG LowestValidUsn;
+    LONGLONG MaxUsn;
+    DWORDLONG MaximumSize;
+    DWORDLONG AllocationDelta;
+};
+
+//! READ_USN_JOURNAL_DATA_V1 definition from Windows SDK. Supported since Windows 8, READ_USN_JOURNAL_DATA_V0 only includes the first six members.
+struct read_usn_journal_data_v1
+{
+    LONGLONG StartUsn;
+    DWORD ReasonMask;
+    DWORD ReturnOnlyOnClose;
+    DWORDLONG Timeout;
+    DWORDLONG BytesToWaitFor;
+    DWORDLONG UsnJournalID;
+    WORD MinMajorVersion;
+    WORD MaxMajorVersion;
+};
+
+//! USN_RECORD_COMMON_HEADER definition from Windows SDK
+struct usn_record_common_header
+{
+    DWORD RecordLength;
+    WORD MajorVersion;
+    WORD MinorVersion;
+};
+
+//! USN_RECORD_V2 definition from Windows SDK
+struct usn_record_v2
+{
+    DWORD RecordLength;
+    WORD MajorVersion;
+    WORD MinorVersion;
+    DWORDLONG FileReferenceNumber;
+    DWORDLONG ParentFileReferenceNumber;
+    LONGLONG Usn;
+    LARGE_INTEGER TimeStamp;
+    DWORD Reason;
+    DWORD SourceInfo;
+    DWORD SecurityId;
+    DWORD FileAttributes;
+    WORD FileNameLength;
+    WORD FileNameOffset;
+    WCHAR FileName[1];
+};
+
+//! USN_RECORD_V3 definition from Windows SDK. Supported since Windows 8, used by ReFS.
+struct usn_record_v3
+{
+    DWORD RecordLength;
+    WORD MajorVersion;
+    WORD MinorVersion;
+    file_id_128 FileReferenceNumber;
+    file_id_128 ParentFileReferenceNumber;
+    LONGLONG Usn;
+    LARGE_INTEGER TimeStamp;
+    DWORD Reason;
+    DWORD SourceInfo;
+    DWORD SecurityId;
+    DWORD FileAttributes;
+    WORD FileNameLength;
+    WORD FileNameOffset;
+    WCHAR FileName[1];
+};
+
+//! Fills \a rec from the USN record \a data of version 2 or 3
+template< typename Record >
+inline void fill_volume_record(Record const* data, file_identity const& id, file_identity const& parent_id, volume_record& rec)
+{
+    rec.id = id;
+    rec.parent_id = parent_id;
+    const wchar_t* name = reinterpret_cast< const wchar_t* >(reinterpret_cast< const unsigned char* >(data) + data->FileNameOffset);
+    rec.name.assign(name, name + data->FileNameLength / sizeof(wchar_t));
+    rec.attributes = data->FileAttributes;
+    if ((data->FileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0u)
+        rec.type = reparse_file;
+    else if ((data->FileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0u)
+        rec.type = directory_file;
+    else
+        rec.type = regular_file;
+    rec.reason = data->Reason;
+    rec.usn = static_cast< boost::uint64_t >(data->Usn);
+}
+
+} // unnamed namespace
+} // namespace detail
+
+struct volume_scanner::implementation
+{
+    //! A file in the index of the scanned files
+    struct node
+    {
+        file_identity parent_id;
+        std::wstring name;
+    };
+
+    typedef std::map< file_identity, node > index_map;
+
+    detail::handle_wrapper volume;
+    //! Root directory of the volume
+    path root;
+    //! Identity of the root directory
+    file_identity root_id;
+    //! Index of the scanned files
+    index_map index;
+    //! Buffer for the records returned by the volume
+    std::vector< unsigned char > buffer;
+    //! Identity of the change journal, zero if the journal is not active
+    DWORDLONG journal_id;
+    //! Next file reference number to enumerate by scan()
+    DWORDLONG next_file_reference;
+    //! USN up to which scan() enumerates the files, and from which read_changes() reads the changes
+    LONGLONG scan_usn;
+    LONGLONG next_usn;
+    //! Indicates that scan() has enumerated all files
+    bool scan_complete;
+    //! Indicates that the version 1 structures for requesting version 3 records are not supported by the system
+    bool use_v0_requests;
+
+    implementation() :
+        journal_id(0u),
+        next_file_reference(0u),
+        scan_usn(0),
+        next_usn(0),
+        scan_complete(false),
+        use_v0_requests(false)
+    {
+    }
+
+    //! Adds the record to the output and updates the index. Returns \c false if the record has an unsupported version.
+    bool add_record(const unsigned char* p, std::vector< volume_record >& records)
+    {
+        const detail::usn_record_common_header* header = reinterpret_cast< const detail::usn_record_common_header* >(p);
+        volume_record rec;
+        switch (header->MajorVersion)
+        {
+        case 2u:
+            {
+                const detail::usn_record_v2* data = reinterpret_cast< const detail::usn_record_v2* >(p);
+                detail::fill_volume_record(data, file_identity(root_id.device, data->FileReferenceNumber),
+                    file_identity(root_id.device, data->ParentFileReferenceNumber), rec);
+            }
+            break;
+
+        case 3u:
+            {
+                const detail::usn_record_v3* data = reinterpret_cast< const detail::usn_record_v3* >(p);
+                detail::fill_volume_record(data, detail::make_file_identity(root_id.device, data->FileReferenceNumber),
+                    detail::make_file_identity(root_id.device, data->ParentFileReferenceNumber), rec);
+            }
+            break;
+
+        default:
+            // USN_RECORD_V4 only describes ranges of modified data and does not carry file names
+            return false;
+        }
+
+        if ((rec.reason & USN_REASON_FILE_DELETE) != 0u)
+        {
+            index.erase(rec.id);
+        }
+        else if ((rec.reason & USN_REASON_RENAME_OLD_NAME) == 0u)
+        {
+            node& n = index[rec.id];
+            n.parent_id = rec.parent_id;
+            n.name = rec.name.native();
+        }
+
+        records.push_back(rec);
+        return true;
+    }
+
+    //! Parses the records in the buffer after the leading 8-byte next position. Returns the number of added records.
+    std::size_t add_records(DWORD size, std::vector< volume_record >& records)
+    {
+        std::size_t count = 0u;
+        DWORD pos = sizeof(DWORDLONG);
+        while ((size - pos) >= sizeof(detail::usn_record_common_header))
+        {
+            const unsigned char* p = &buffer[pos];
+            const DWORD record_length = reinterpret_cast< const detail::usn_record_common_header* >(p)->RecordLength;
+            if (BOOST_UNLIKELY(record_length < sizeof(detail::usn_record_common_header) || record_length > (size - pos)))
+                break;
+
+            if (add_record(p, records))
+                ++count;
+
+            pos += record_length;
+        }
+
+        return count;
+    }
+};
+
+BOOST_FILESYSTEM_DECL
+void volume_scanner::close() BOOST_NOEXCEPT
+{
+    delete m_impl;
+    m_impl = NULL;
+}
+
+BOOST_FILESYSTEM_DECL
+void volume_scanner::open_impl(path const& p, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    close();
+
+    implementation* impl = NULL;
+    try
+    {
+        std::wstring volume_path;
+        volume_path.resize(p.native().size() + MAX_PATH + 1u);
+        if (BOOST_UNLIKELY(!::GetVolumePathNameW(p.c_str(), &volume_path[0], static_cast< DWORD >(volume_path.size()))))
+        {
+            emit_error(::GetLastError(), p, ec, "boost::filesystem::volume_scanner::open");
+            return;
+        }
+        volume_path.resize(std::wcslen(volume_path.c_str()));
+
+        // The volume GUID path works for volumes mounted on directories as well as for drive letters
+        wchar_t volume_name[64];
+        if (BOOST_UNLIKELY(!::GetVolumeNameForVolumeMountPointW(volume_path.c_str(), volume_name, sizeof(volume_name) / sizeof(*volume_name))))
+        {
+            emit_error(::GetLastError(), p, ec, "boost::filesystem::volume_scanner::open");
+            return;
+        }
+
+        // Open the volume itself rather than its root directory, which requires removing the trailing backslash
+        std::size_t volume_name_size = std::wcslen(volume_name);
+        if (volume_name_size > 0u && volume_name[volume_name_size - 1u] == L'\\')
+            volume_name[--volume_name_size] = L'\0';
+
+        impl = new implementation();
+        impl->root = volume_path;
+
+        system::error_code local_ec;
+        impl->root_id = detail::identity(impl->root, &local_ec);
+        if (BOOST_UNLIKELY(!!local_ec))
+        {
+            delete impl;
+            emit_error(static_cast< DWORD >(local_ec.value()), p, ec, "boost::filesystem::volume_scanner::open");
+            return;
+        }
+
+        impl->volume.handle = ::CreateFileW(
+            volume_name,
+            GENERIC_READ,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL, // lpSecurityAttributes
+            OPEN_EXISTING,
+            0u,
+            NULL);
+        if (BOOST_UNLIKELY(impl->volume.handle == INVALID_HANDLE_VALUE))
+        {
+            const DWORD err = ::GetLastError();
+            delete impl;
+            emit_error(err, p, ec, "boost::filesystem::volume_scanner::open");
+            return;
+        }
+
+        // Without the change journal, the files can still be enumerated, but the changes cannot be tracked
+        detail::usn_journal_data_v0 journal = {};
+        DWORD size = 0u;
+        if (::DeviceIoControl(impl->volume.handle, FSCTL_QUERY_USN_JOURNAL, NULL, 0u, &journal, sizeof(journal), &size, NULL))
+        {
+            impl->journal_id = journal.UsnJournalID;
+            impl->scan_usn = journal.NextUsn;
+            impl->next_usn = journal.NextUsn;
+        }
+        else
+        {
+            const DWORD err = ::GetLastError();
+            if (err != ERROR_JOURNAL_NOT_ACTIVE)
+            {
+                delete impl;
+                emit_error(err, p, ec, "boost::filesystem::volume_scanner::open");
+                return;
+            }
+
+            impl->scan_usn = (std::numeric_limits< LONGLONG >::max)();
+        }
+
+        impl->buffer.resize(detail::usn_buffer_size);
+    }
+    catch (std::bad_alloc&)
+    {
+        delete impl;
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return;
+    }
+
+    m_impl = impl;
+}
+
+BOOST_FILESYSTEM_DECL
+path const& volume_scanner::volume_path() const BOOST_NOEXCEPT
+{
+    static const path empty;
+    return m_impl ? m_impl->root : empty;
+}
+
+BOOST_FILESYSTEM_DECL
+boost::uint64_t volume_scanner::next_usn() const BOOST_NOEXCEPT
+{
+    return m_impl ? static_cast< boost::uint64_t >(m_impl->next_usn) : 0u;
+}
+
+BOOST_FILESYSTEM_DECL
+std::size_t volume_scanner::scan_impl(std::vector< volume_record >& records, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    if (BOOST_UNLIKELY(!m_impl))
+    {
+        emit_error(ERROR_INVALID_HANDLE, ec, "boost::filesystem::volume_scanner::scan");
+        return 0u;
+    }
+
+    implementation& impl = *m_impl;
+    std::size_t count = 0u;
+    while (!impl.scan_complete)
+    {
+        detail::mft_enum_data_v1 request = {};
+        request.StartFileReferenceNumber = impl.next_file_reference;
+        request.LowUsn = 0;
+        request.HighUsn = impl.scan_usn;
+        request.MinMajorVersion = 2u;
+        request.MaxMajorVersion = 3u;
+
+        // MFT_ENUM_DATA_V0 is the prefix of MFT_ENUM_DATA_V1
+        const DWORD request_size = impl.use_v0_requests ? static_cast< DWORD >(3u * sizeof(LONGLONG)) : static_cast< DWORD >(sizeof(request));
+        DWORD size = 0u;
+        if (!::DeviceIoControl(impl.volume.handle, FSCTL_ENUM_USN_DATA, &request, request_size, &impl.buffer[0], static_cast< DWORD >(impl.buffer.size()), &size, NULL))
+        {
+            const DWORD err = ::GetLastError();
+            if (err == ERROR_HANDLE_EOF)
+            {
+                impl.scan_complete = true;
+                break;
+            }
+
+            if (err == ERROR_INVALID_PARAMETER && !impl.use_v0_requests)
+            {
+                // Windows 7 and older do not support MFT_ENUM_DATA_V1
+                impl.use_v0_requests = true;
+                continue;
+            }
+
+            emit_error(err, impl.root, ec, "boost::filesystem::volume_scanner::scan");
+            return count;
+        }
+
+        if (BOOST_UNLIKELY(size < sizeof(DWORDLONG)))
+        {
+            impl.scan_complete = true;
+            break;
+        }
+
+        std::memcpy(&impl.next_file_reference, &impl.buffer[0], sizeof(DWORDLONG));
+        count += impl.add_records(size, records);
+        if (count > 0u)
+            break;
+    }
+
+    return count;
+}
+
+BOOST_FILESYSTEM_DECL
+std::size_t volume_scanner::read_changes_impl(std::vector< volume_record >& records, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    if (BOOST_UNLIKELY(!m_impl))
+    {
+        emit_error(ERROR_INVALID_HANDLE, ec, "boost::filesystem::volume_scanner::read_changes");
+        return 0u;
+    }
+
+    implementation& impl = *m_impl;
+    if (BOOST_UNLIKELY(impl.journal_id == 0u))
+    {
+        emit_error(ERROR_JOURNAL_NOT_ACTIVE, impl.root, ec, "boost::filesystem::volume_scanner::read_changes");
+        return 0u;
+    }
+
+    std::size_t count = 0u;
+    while (true)
+    {
+        detail::read_usn_journal_data_v1 request = {};
+        request.StartUsn = impl.next_usn;
+        request.ReasonMask = 0xFFFFFFFFu;
+        request.ReturnOnlyOnClose = 0u;
+        request.Timeout = 0u;
+        request.BytesToWaitFor = 0u;
+        request.UsnJournalID = impl.journal_id;
+        request.MinMajorVersion = 2u;
+        request.MaxMajorVersion = 3u;
+
+        // READ_USN_JOURNAL_DATA_V0 is the prefix of READ_USN_JOURNAL_DATA_V1
+        const DWORD request_size = impl.use_v0_requests ? static_cast< DWORD >(sizeof(LONGLONG) + 2u * sizeof(DWORD) + 3u * sizeof(DWORDLONG)) : static_cast< DWORD >(sizeof(request));
+        DWORD size = 0u;
+        if (!::DeviceIoControl(impl.volume.handle, FSCTL_READ_USN_JOURNAL, &request, request_size, &impl.buffer[0], static_cast< DWORD >(impl.buffer.size()), &size, NULL))
+        {
+            const DWORD err = ::GetLastError();
+            if (err == ERROR_INVALID_PARAMETER && !impl.use_v0_requests)
+            {
+                impl.use_v0_requests = true;
+                continue;
+            }
+
+            emit_error(err, impl.root, ec, "boost::filesystem::volume_scanner::read_changes");
+            return count;
+        }
+
+        if (BOOST_UNLIKELY(size < sizeof(LONGLONG)))
+            break;
+
+        LONGLONG next_usn;
+        std::memcpy(&next_usn, &impl.buffer[0], sizeof(next_usn));
+        const bool advanced = next_usn != impl.next_usn;
+        impl.next_usn = next_usn;
+        count += impl.add_records(size, records);
+        // Records of versions that are not reported, if any, are skipped by reading further
+        if (count > 0u || !advanced)
+            break;
+    }
+
+    return count;
+}
+
+BOOST_FILESYSTEM_DECL
+path volume_scanner::full_path_impl(file_identity const& id, system::error_code* ec) const
+{
+    if (ec)
+        ec->clear();
+
+    if (BOOST_UNLIKELY(!m_impl))
+    {
+        emit_error(ERROR_INVALID_HANDLE, ec, "boost::filesystem::volume_scanner::full_path");
+        return path();
+    }
+
+    implementation const& impl = *m_impl;
+    std::vector< implementation::node const* > chain;
+    file_identity current = id;
+    while (current != impl.root_id)
+    {
+        implementation::index_map::const_iterator it = impl.index.find(current);
+        // A chain longer than the number of indexed files means that the index contains a cycle, which may happen
+        // if the journal records of a directory rename were only partially read
+        if (BOOST_UNLIKELY(it == impl.index.end() || chain.size() >= impl.index.size()))
+        {
+            emit_error(ERROR_FILE_NOT_FOUND, impl.root, ec, "boost::filesystem::volume_scanner::full_path");
+            return path();
+        }
+
+        chain.push_back(&it->second);
+        current = it->second.parent_id;
+    }
+
+    path p(impl.root);
+    for (std::size_t i = chain.size(); i > 0u; --i)
+        p /= chain[i - 1u]->name;
+
+    return p;
+}
+
+#else // defined(BOOST_WINDOWS_API)
+
+struct volume_scanner::implementation
+{
+};
+
+BOOST_FILESYSTEM_DECL
+void volume_scanner::close() BOOST_NOEXCEPT
+{
+    m_impl = NULL;
+}
+
+BOOST_FILESYSTEM_DECL
+void volume_scanner::open_impl(path const& p, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    close();
+
+    // The MFT and the USN change journal are specific to Windows
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::volume_scanner::open");
+}
+
+BOOST_FILESYSTEM_DECL
+path const& volume_scanner::volume_path() const BOOST_NOEXCEPT
+{
+    static const path empty;
+    return empty;
+}
+
+BOOST_FILESYSTEM_DECL
+boost::uint64_t volume_scanner::next_usn() const BOOST_NOEXCEPT
+{
+    return 0u;
+}
+
+BOOST_FILESYSTEM_DECL
+std::size_t volume_scanner::scan_impl(std::vector< volume_record >&, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    emit_error(EBADF, ec, "boost::filesystem::volume_scanner::scan");
+    return 0u;
+}
+
+BOOST_FILESYSTEM_DECL
+std::size_t volume_scanner::read_changes_impl(std::vector< volume_record >&, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    emit_error(EBADF, ec, "boost::filesystem::volume_scanner::read_changes");
+    return 0u;
+}
+
+BOOST_FILESYSTEM_DECL
+path volume_scanner::full_path_impl(file_identity const&, system::error_code* ec) const
+{
+    if (ec)
+        ec->clear();
+
+    emit_error(EBADF, ec, "boost::filesystem::volume_scanner::full_path");
+    return path();
+}
+
+#endif // defined(BOOST_WINDOWS_API)
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
@@ -0,0 +1,300 @@
+//  walk_scheduler.hpp  ----------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_SRC_WALK_SCHEDULER_HPP_
+#define BOOST_FILESYSTEM_SRC_WALK_SCHEDULER_HPP_
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/system/error_code.hpp>
+#include <vector>
+
+#include "thread_tools.hpp"
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <memory> // std::unique_ptr
+#endif
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+/*
+ * The schedulers below distribute the directories of a tree walk between threads. The work on each directory
+ * is performed by a \c Worker object, which must provide the following interface:
+ *
+ * \code
+ * typedef ... context_type; // Common state of the walk, shared between all threads
+ * typedef ... task_type;    // Description of a directory to process, must be swappable with the swap() member
+ *
+ * explicit Worker(context_type& ctx) noexcept;
+ *
+ * // Processes a directory. New directories are added with scheduler.schedule(task). Returns false if the walk
+ * // should be stopped, in which case err may contain the error and err_path the path it relates to.
+ * template< typename Scheduler >
+ * bool operator()(task_type& task, Scheduler& scheduler, system::error_code& err, path& err_path);
+ * \endcode
+ *
+ * One worker object is created in every thread of the walk.
+ */
+
+#if defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+//! Queue of pending directories of a worker thread
+template< typename Task >
+struct walk_queue
+{
+    std::mutex mutex;
+    std::deque< Task > dirs;
+};
+
+//! Scheduler state for the multithreaded walk
+template< typename Worker >
+class parallel_walk_scheduler
+{
+public:
+    typedef typename Worker::context_type context_type;
+    typedef typename Worker::task_type task_type;
+
+private:
+    context_type& m_context;
+    const unsigned int m_thread_count;
+    std::unique_ptr< walk_queue< task_type >[] > m_queues;
+
+    //! Number of directories that are either queued or being processed
+    std::atomic< std::size_t > m_pending;
+    //! Number of directories in the queues
+    std::atomic< std::size_t > m_queued;
+    std::atomic< bool > m_stopped;
+
+    std::mutex m_idle_mutex;
+    std::condition_variable m_idle_cond;
+    unsigned int m_idle_count;
+
+    std::mutex m_error_mutex;
+    system::error_code m_error;
+    path m_error_path;
+
+public:
+    parallel_walk_scheduler(context_type& ctx, unsigned int thread_count) :
+        m_context(ctx),
+        m_thread_count(thread_count),
+        m_queues(new walk_queue< task_type >[thread_count]),
+        m_pending(0u),
+        m_queued(0u),
+        m_stopped(false),
+        m_idle_count(0u)
+    {
+    }
+
+    BOOST_DELETED_FUNCTION(parallel_walk_scheduler(parallel_walk_scheduler const&))
+    BOOST_DELETED_FUNCTION(parallel_walk_scheduler& operator=(parallel_walk_scheduler const&))
+
+    system::error_code const& error() const BOOST_NOEXCEPT { return m_error; }
+    path const& error_path() const BOOST_NOEXCEPT { return m_error_path; }
+
+    //! Adds the root directory
+    void add_root(task_type const& root)
+    {
+        m_queues[0].dirs.push_back(root);
+        m_pending.store(1u, std::memory_order_relaxed);
+        m_queued.store(1u, std::memory_order_relaxed);
+    }
+
+    //! Worker thread function
+    void operator()(unsigned int index) BOOST_NOEXCEPT
+    {
+        worker_scheduler sched(*this, index);
+        Worker worker(m_context);
+        system::error_code err;
+        path err_path;
+        task_type dir;
+
+        while (true)
+        {
+            if (!take(index, dir))
+            {
+                if (!wait_for_work())
+                    break;
+                continue;
+            }
+
+            if (!worker(dir, sched, err, err_path))
+            {
+                if (err)
+                    set_error(err, err_path);
+                stop();
+            }
+
+            complete_one();
+        }
+    }
+
+private:
+    //! Scheduler interface for the worker, bound to a given worker thread
+    class worker_scheduler
+    {
+    private:
+        parallel_walk_scheduler& m_scheduler;
+        const unsigned int m_index;
+
+    public:
+        worker_scheduler(parallel_walk_scheduler& scheduler, unsigned int index) BOOST_NOEXCEPT :
+            m_scheduler(scheduler),
+            m_index(index)
+        {
+        }
+
+        void schedule(task_type const& dir) { m_scheduler.push(m_index, dir); }
+        bool is_stopped() const BOOST_NOEXCEPT { return m_scheduler.m_stopped.load(std::memory_order_relaxed); }
+    };
+
+    //! Pushes a directory to the worker's queue
+    void push(unsigned int index, task_type const& dir)
+    {
+        {
+            walk_queue< task_type >& queue = m_queues[index];
+            std::lock_guard< std::mutex > lock(queue.mutex);
+            queue.dirs.push_back(dir);
+        }
+
+        m_pending.fetch_add(1u, std::memory_order_relaxed);
+        m_queued.fetch_add(1u, std::memory_order_release);
+
+        std::lock_guard< std::mutex > lock(m_idle_mutex);
+        if (m_idle_count > 0u)
+            m_idle_cond.notify_one();
+    }
+
+    //! Takes a directory from the worker's own queue or steals one from a different worker
+    bool take(unsigned int index, task_type& dir)
+    {
+        if (m_stopped.load(std::memory_order_relaxed))
+            return false;
+
+        // Take the most recently added directory from our queue, this improves locality
+        {
+            walk_queue< task_type >& queue = m_queues[index];
+            std::lock_guard< std::mutex > lock(queue.mutex);
+            if (!queue.dirs.empty())
+            {
+                dir.swap(queue.dirs.back());
+                queue.dirs.pop_back();
+                m_queued.fetch_sub(1u, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        // Steal the oldest directory from a different worker, which is likely closer to the root and has more work beneath it
+        for (unsigned int i = 1u; i < m_thread_count; ++i)
+        {
+            walk_queue< task_type >& queue = m_queues[(index + i) % m_thread_count];
+            std::lock_guard< std::mutex > lock(queue.mutex);
+            if (!queue.dirs.empty())
+            {
+                dir.swap(queue.dirs.front());
+                queue.dirs.pop_front();
+                m_queued.fetch_sub(1u, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    //! Blocks until there is more work to do. Returns \c false if the walk is complete.
+    bool wait_for_work()
+    {
+        std::unique_lock< std::mutex > lock(m_idle_mutex);
+        while (true)
+        {
+            if (m_stopped.load(std::memory_order_relaxed) || m_pending.load(std::memory_order_acquire) == 0u)
+                return false;
+
+            if (m_queued.load(std::memory_order_acquire) > 0u)
+                return true;
+
+            ++m_idle_count;
+            m_idle_cond.wait(lock);
+            --m_idle_count;
+        }
+    }
+
+    //! Marks one directory as completely processed
+    void complete_one()
+    {
+        if (m_pending.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+        {
+            std::lock_guard< std::mutex > lock(m_idle_mutex);
+            m_idle_cond.notify_all();
+        }
+    }
+
+    void stop()
+    {
+        m_stopped.store(true, std::memory_order_relaxed);
+        std::lock_guard< std::mutex > lock(m_idle_mutex);
+        m_idle_cond.notify_all();
+    }
+
+    void set_error(system::error_code const& err, path const& p) BOOST_NOEXCEPT
+    {
+        std::lock_guard< std::mutex > lock(m_error_mutex);
+        if (!m_error)
+        {
+            m_error = err;
+            try
+            {
+                m_error_path = p;
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+};
+
+#endif // defined(BOOST_FILESYSTEM_HAS_THREADS)
+
+//! Scheduler for the single-threaded walk
+template< typename Task >
+class sequential_walk_scheduler
+{
+private:
+    std::vector< Task > m_dirs;
+
+public:
+    void schedule(Task const& dir) { m_dirs.push_back(dir); }
+    BOOST_CONSTEXPR bool is_stopped() const BOOST_NOEXCEPT { return false; }
+
+    bool take(Task& dir)
+    {
+        if (m_dirs.empty())
+            return false;
+        dir.swap(m_dirs.back());
+        m_dirs.pop_back();
+        return true;
+    }
+};
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_SRC_WALK_SCHEDULER_HPP_
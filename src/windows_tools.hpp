@@ -14,9 +14,13 @@
 #define BOOST_FILESYSTEM_SRC_WINDOWS_TOOLS_HPP_
 
 #include <cstddef>
+#include <cstring>
+#include <ctime>
+#include <boost/cstdint.hpp>
 #include <boost/filesystem/config.hpp>
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <boost/winapi/basic_types.hpp> // NTSTATUS_
 
 #include <windows.h>
@@ -64,6 +68,31 @@ inline boost::filesystem::perms make_permissions(boost::filesystem::path const&
     return prms;
 }
 
+// these constants come from inspecting some Microsoft sample code
+inline std::time_t to_time_t(FILETIME const& ft) BOOST_NOEXCEPT
+{
+    boost::uint64_t t = (static_cast< boost::uint64_t >(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+    t -= 116444736000000000ull;
+    t /= 10000000u;
+    return static_cast< std::time_t >(t);
+}
+
+inline boost::filesystem::file_time to_file_time(FILETIME const& ft) BOOST_NOEXCEPT
+{
+    boost::uint64_t t = (static_cast< boost::uint64_t >(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+    t -= 116444736000000000ull;
+    return boost::filesystem::file_time(static_cast< std::time_t >(t / 10000000u), static_cast< boost::uint32_t >((t % 10000000u) * 100u));
+}
+
+//! Converts a time value returned by the native API functions as \c LARGE_INTEGER
+inline boost::filesystem::file_time to_file_time(LARGE_INTEGER const& t) BOOST_NOEXCEPT
+{
+    FILETIME ft;
+    ft.dwLowDateTime = t.LowPart;
+    ft.dwHighDateTime = static_cast< DWORD >(t.HighPart);
+    return to_file_time(ft);
+}
+
 bool is_reparse_point_a_symlink_ioctl(HANDLE h);
 
 inline bool is_reparse_point_tag_a_symlink(ULONG reparse_point_tag)
@@ -185,7 +214,9 @@ typedef VOID (NTAPI* pio_apc_routine) (PVOID ApcContext, io_status_block* IoStat
 //! FILE_INFORMATION_CLASS enum entries
 enum file_information_class
 {
-    file_directory_information_class = 1
+    file_directory_information_class = 1,
+    file_names_information_class = 12,
+    file_stat_information_class = 68
 };
 
 //! NtQueryDirectoryFile signature. Available since Windows NT 4.0 (probably).
@@ -204,23 +235,53 @@ typedef boost::winapi::NTSTATUS_ (NTAPI NtQueryDirectoryFile_t)(
 
 extern NtQueryDirectoryFile_t* nt_query_directory_file_api;
 
+//! RtlGetVersion signature. Available since Windows 2000.
+typedef boost::winapi::NTSTATUS_ (NTAPI RtlGetVersion_t)(/*in, out*/ OSVERSIONINFOW* VersionInformation);
+
 #endif // !defined(UNDER_CE)
 
 //! FILE_INFO_BY_HANDLE_CLASS enum entries
 enum file_info_by_handle_class
 {
     file_basic_info_class = 0,
+    file_standard_info_class = 1,
+    file_rename_info_class = 3,
     file_disposition_info_class = 4,
+    file_allocation_info_class = 5,
     file_attribute_tag_info_class = 9,
     file_id_both_directory_info_class = 10,
     file_id_both_directory_restart_info_class = 11,
     file_full_directory_info_class = 14,
     file_full_directory_restart_info_class = 15,
+    file_id_info_class = 18,
     file_id_extd_directory_info_class = 19,
     file_id_extd_directory_restart_info_class = 20,
     file_disposition_info_ex_class = 21
 };
 
+//! FILE_STANDARD_INFO definition from Windows SDK
+struct file_standard_info
+{
+    LARGE_INTEGER AllocationSize;
+    LARGE_INTEGER EndOfFile;
+    DWORD NumberOfLinks;
+    BOOLEAN DeletePending;
+    BOOLEAN Directory;
+};
+
+//! FILE_ID_128 definition from Windows SDK
+struct file_id_128
+{
+    BYTE Identifier[16];
+};
+
+//! FILE_ID_INFO definition from Windows SDK
+struct file_id_info
+{
+    ULONGLONG VolumeSerialNumber;
+    BYTE FileId[16]; // FILE_ID_128
+};
+
 //! FILE_ATTRIBUTE_TAG_INFO definition from Windows SDK
 struct file_attribute_tag_info
 {
@@ -253,6 +314,15 @@ struct handle_wrapper
     BOOST_DELETED_FUNCTION(handle_wrapper& operator=(handle_wrapper const&))
 };
 
+//! Returns the identity of a file from the volume serial number and the 128-bit file id
+inline file_identity make_file_identity(ULONGLONG volume_serial_number, file_id_128 const& id) BOOST_NOEXCEPT
+{
+    boost::uint64_t id_low, id_high;
+    std::memcpy(&id_low, id.Identifier, sizeof(id_low));
+    std::memcpy(&id_high, id.Identifier + sizeof(id_low), sizeof(id_high));
+    return file_identity(volume_serial_number, id_low, id_high);
+}
+
 //! Creates a file handle
 inline HANDLE create_file_handle(boost::filesystem::path const& p, DWORD dwDesiredAccess, DWORD dwShareMode, LPSECURITY_ATTRIBUTES lpSecurityAttributes, DWORD dwCreationDisposition, DWORD dwFlagsAndAttributes, HANDLE hTemplateFile = NULL)
 {
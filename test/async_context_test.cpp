@@ -0,0 +1,183 @@
+//  async_context_test.cpp  ------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/async_context.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#if defined(BOOST_FILESYSTEM_HAS_ASYNC_CONTEXT)
+
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <boost/system/error_code.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+//! Records the results of an operation
+struct result_holder
+{
+    std::mutex mutex;
+    std::vector< boost::system::error_code > errors;
+    std::vector< bool > results;
+    std::vector< fs::file_status > statuses;
+};
+
+void test_status(fs::async_context& ctx, fs::path const& root)
+{
+    fs::file_status st_file, st_dir, st_missing, st_link;
+    boost::system::error_code ec_file, ec_missing;
+
+    ctx.async_status(root / "file", [&](boost::system::error_code const& ec, fs::file_status st) { ec_file = ec; st_file = st; });
+    ctx.async_status(root, [&](boost::system::error_code const&, fs::file_status st) { st_dir = st; });
+    ctx.async_status(root / "missing", [&](boost::system::error_code const& ec, fs::file_status st) { ec_missing = ec; st_missing = st; });
+    ctx.async_symlink_status(root / "file", [&](boost::system::error_code const&, fs::file_status st) { st_link = st; });
+    ctx.wait();
+
+    BOOST_TEST(!ec_file);
+    BOOST_TEST_EQ(st_file.type(), fs::regular_file);
+    BOOST_TEST_EQ(st_dir.type(), fs::directory_file);
+    BOOST_TEST(!!ec_missing);
+    BOOST_TEST_EQ(st_missing.type(), fs::file_not_found);
+    BOOST_TEST_EQ(st_link.type(), fs::regular_file);
+    BOOST_TEST(st_file.permissions() == fs::status(root / "file").permissions());
+
+    // More operations than the number of requests that can be in flight at once
+    const unsigned int count = 1000u;
+    std::atomic< unsigned int > regular_files(0u);
+    for (unsigned int i = 0u; i < count; ++i)
+    {
+        ctx.async_status(root / "file", [&](boost::system::error_code const& ec, fs::file_status st)
+        {
+            if (!ec && st.type() == fs::regular_file)
+                ++regular_files;
+        });
+    }
+    ctx.wait();
+    BOOST_TEST_EQ(regular_files.load(), count);
+}
+
+void test_modifications(fs::async_context& ctx, fs::path const& root)
+{
+    const fs::path dir = root / "dir";
+    bool created = false, created_again = true;
+    boost::system::error_code ec_created, ec_created_again, ec_missing_parent;
+    ctx.async_create_directory(dir, [&](boost::system::error_code const& ec, bool res) { ec_created = ec; created = res; });
+    ctx.wait();
+    ctx.async_create_directory(dir, [&](boost::system::error_code const& ec, bool res) { ec_created_again = ec; created_again = res; });
+    ctx.async_create_directory(root / "missing" / "dir", [&](boost::system::error_code const& ec, bool) { ec_missing_parent = ec; });
+    ctx.wait();
+    BOOST_TEST(!ec_created);
+    BOOST_TEST(created);
+    BOOST_TEST(!ec_created_again);
+    BOOST_TEST(!created_again);
+    BOOST_TEST(!!ec_missing_parent);
+    BOOST_TEST(fs::is_directory(dir));
+
+    bool copied = false;
+    boost::system::error_code ec_copy;
+    ctx.async_copy_file(root / "file", dir / "copy", [&](boost::system::error_code const& ec, bool res) { ec_copy = ec; copied = res; });
+    ctx.wait();
+    BOOST_TEST(!ec_copy);
+    BOOST_TEST(copied);
+    BOOST_TEST_EQ(fs::file_size(dir / "copy"), fs::file_size(root / "file"));
+
+    boost::system::error_code ec_rename, ec_rename_missing;
+    ctx.async_rename(dir / "copy", dir / "renamed", [&](boost::system::error_code const& ec) { ec_rename = ec; });
+    ctx.async_rename(dir / "missing", dir / "renamed2", [&](boost::system::error_code const& ec) { ec_rename_missing = ec; });
+    ctx.wait();
+    BOOST_TEST(!ec_rename);
+    BOOST_TEST(!!ec_rename_missing);
+    BOOST_TEST(!fs::exists(dir / "copy"));
+    BOOST_TEST(fs::exists(dir / "renamed"));
+
+    std::vector< fs::directory_entry > entries;
+    boost::system::error_code ec_entries, ec_entries_missing;
+    ctx.async_directory_entries(dir, [&](boost::system::error_code const& ec, std::vector< fs::directory_entry > res) { ec_entries = ec; entries.swap(res); });
+    ctx.async_directory_entries(root / "missing", [&](boost::system::error_code const& ec, std::vector< fs::directory_entry >) { ec_entries_missing = ec; });
+    ctx.wait();
+    BOOST_TEST(!ec_entries);
+    BOOST_TEST_EQ(entries.size(), 1u);
+    if (!entries.empty())
+        BOOST_TEST_EQ(entries[0].path(), dir / "renamed");
+    BOOST_TEST(!!ec_entries_missing);
+
+    // Removing a non-empty directory fails
+    bool removed_dir = true;
+    boost::system::error_code ec_removed_dir;
+    ctx.async_remove(dir, [&](boost::system::error_code const& ec, bool res) { ec_removed_dir = ec; removed_dir = res; });
+    ctx.wait();
+    BOOST_TEST(!!ec_removed_dir);
+    BOOST_TEST(!removed_dir);
+
+    // Remove the file and then, from the completion handler, the directory
+    bool removed_file = false, removed_missing = true;
+    boost::system::error_code ec_removed_file, ec_removed_missing;
+    removed_dir = false;
+    ctx.async_remove(dir / "renamed", [&](boost::system::error_code const& ec, bool res)
+    {
+        ec_removed_file = ec;
+        removed_file = res;
+        ctx.async_remove(dir, [&](boost::system::error_code const& ec2, bool res2) { ec_removed_dir = ec2; removed_dir = res2; });
+    });
+    ctx.async_remove(root / "missing", [&](boost::system::error_code const& ec, bool res) { ec_removed_missing = ec; removed_missing = res; });
+    ctx.wait();
+    BOOST_TEST(!ec_removed_file);
+    BOOST_TEST(removed_file);
+    BOOST_TEST(!ec_removed_dir);
+    BOOST_TEST(removed_dir);
+    BOOST_TEST(!ec_removed_missing);
+    BOOST_TEST(!removed_missing);
+    BOOST_TEST(!fs::exists(dir));
+}
+
+void test_destructor_waits(fs::path const& root)
+{
+    std::atomic< unsigned int > completed(0u);
+    {
+        fs::async_context ctx(2u);
+        for (unsigned int i = 0u; i < 100u; ++i)
+            ctx.async_status(root, [&](boost::system::error_code const&, fs::file_status) { ++completed; });
+    }
+    BOOST_TEST_EQ(completed.load(), 100u);
+}
+
+} // namespace
+
+int main()
+{
+    temp_test_directory temp_dir("async_context_test");
+    const fs::path& root = temp_dir.path();
+    create_file(root / "file", "contents");
+
+    fs::async_context ctx;
+    test_status(ctx, root);
+    test_modifications(ctx, root);
+    test_destructor_waits(root);
+
+    return boost::report_errors();
+}
+
+#else // defined(BOOST_FILESYSTEM_HAS_ASYNC_CONTEXT)
+
+int main()
+{
+    return boost::report_errors();
+}
+
+#endif // defined(BOOST_FILESYSTEM_HAS_ASYNC_CONTEXT)
@@ -0,0 +1,329 @@
+//  backends_test.cpp  -----------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/backends.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <iterator>
+#include <boost/system/error_code.hpp>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/seccomp.h>) && __has_include(<linux/filter.h>)
+#define BOOST_FILESYSTEM_TEST_HAS_SECCOMP
+#endif
+#endif
+
+#if defined(BOOST_FILESYSTEM_TEST_HAS_SECCOMP)
+#include <cerrno>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <linux/filter.h>
+#include <linux/seccomp.h>
+#endif
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+const std::size_t file_size = 100000u;
+
+void create_pattern_file(fs::path const& p)
+{
+    fs::ofstream file(p, std::ios_base::out | std::ios_base::binary);
+    for (std::size_t i = 0u; i < file_size; ++i)
+        file.put(static_cast< char >(i % 251u));
+}
+
+std::string load_file(fs::path const& p)
+{
+    fs::ifstream file(p, std::ios_base::in | std::ios_base::binary);
+    return std::string(std::istreambuf_iterator< char >(file), std::istreambuf_iterator< char >());
+}
+
+void test_copy_file_backends(fs::path const& root)
+{
+    const fs::path source = root / "source";
+    const fs::path target = root / "target";
+    create_pattern_file(source);
+    const std::string contents = load_file(source);
+
+    const fs::copy_file_backend::type original = fs::get_copy_file_backend();
+    const fs::copy_file_backend::type backends[] =
+    {
+        fs::copy_file_backend::read_write,
+        fs::copy_file_backend::sendfile,
+        fs::copy_file_backend::copy_file_range,
+        fs::copy_file_backend::io_uring
+    };
+
+    for (std::size_t i = 0u; i < sizeof(backends) / sizeof(*backends); ++i)
+    {
+        if (!fs::set_copy_file_backend(backends[i]))
+            continue;
+
+        BOOST_TEST_EQ(fs::get_copy_file_backend(), backends[i]);
+        fs::remove(target);
+        fs::copy_file(source, target);
+        BOOST_TEST(load_file(target) == contents);
+    }
+
+    BOOST_TEST(fs::set_copy_file_backend(fs::copy_file_backend::system_default));
+    BOOST_TEST_EQ(fs::get_copy_file_backend(), original);
+    BOOST_TEST(!fs::set_copy_file_backend(static_cast< fs::copy_file_backend::type >(100)));
+
+    fs::remove(target);
+    fs::copy_file(source, target, fs::copy_options::plain_data_copy);
+    BOOST_TEST(load_file(target) == contents);
+}
+
+void test_repeated_copies(fs::path const& root)
+{
+    // The first copy between a pair of devices detects the copying method, the following ones reuse it
+    const fs::path source = root / "source";
+    const std::string contents = load_file(source);
+    for (unsigned int i = 0u; i < 10u; ++i)
+    {
+        const fs::path target = root / fs::path(std::string("copy") + static_cast< char >('a' + i));
+        fs::copy_file(source, target);
+        BOOST_TEST(load_file(target) == contents);
+        fs::remove(target);
+    }
+
+    // Files with generated content must be copied with read/write loop, even after a successful copy from another filesystem
+    const fs::path generated("/sys/kernel/uevent_seqnum");
+    if (fs::is_regular_file(generated))
+    {
+        for (unsigned int i = 0u; i < 2u; ++i)
+        {
+            fs::copy_file(generated, root / "generated", fs::copy_options::overwrite_existing);
+            BOOST_TEST(!load_file(root / "generated").empty());
+        }
+        fs::remove(root / "generated");
+    }
+}
+
+void test_status_backends(fs::path const& root)
+{
+    const fs::path source = root / "source";
+
+    const fs::status_backend::type original = fs::get_status_backend();
+    const fs::status_backend::type backends[] =
+    {
+        fs::status_backend::stat,
+        fs::status_backend::statx
+    };
+
+    for (std::size_t i = 0u; i < sizeof(backends) / sizeof(*backends); ++i)
+    {
+        if (!fs::set_status_backend(backends[i]))
+            continue;
+
+        BOOST_TEST(fs::is_regular_file(source));
+        BOOST_TEST_EQ(fs::file_size(source), file_size);
+        BOOST_TEST(fs::is_directory(root));
+        BOOST_TEST(!fs::exists(root / "missing"));
+    }
+
+    BOOST_TEST(fs::set_status_backend(fs::status_backend::system_default));
+    BOOST_TEST_EQ(fs::get_status_backend(), original);
+}
+
+#if defined(BOOST_FILESYSTEM_TEST_HAS_SECCOMP) && defined(__NR_getdents64)
+
+/*!
+ * Makes the getdents64 syscalls with the buffer of \a buffer_size bytes fail with ENOSYS in the calling process.
+ * The C library also implements readdir with getdents64, so only the calls made by the library with its buffer are blocked.
+ */
+bool block_getdents(std::size_t buffer_size)
+{
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    const unsigned int size_offset = offsetof(struct seccomp_data, args[2]) + 4u;
+#else
+    const unsigned int size_offset = offsetof(struct seccomp_data, args[2]);
+#endif
+    struct sock_filter filter[] =
+    {
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(struct seccomp_data, nr)),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, __NR_getdents64, 0, 3),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, size_offset),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, static_cast< unsigned int >(buffer_size), 0, 1),
+        BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ERRNO | ENOSYS),
+        BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW)
+    };
+    struct sock_fprog prog = { static_cast< unsigned short >(sizeof(filter) / sizeof(*filter)), filter };
+    return ::prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) == 0 && ::prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &prog) == 0;
+}
+
+//! Exit code of the child process if seccomp filters cannot be installed
+const int getdents_fallback_skipped = 77;
+
+//! Iterates over a directory with getdents64 blocked. Returns the exit code for the child process.
+int run_getdents_fallback(fs::path const& root)
+{
+    // Use a buffer size that is distinct from the one used by readdir in the C library
+    fs::set_directory_iterator_buffer_size(40960u);
+    if (!block_getdents(fs::directory_iterator_buffer_size()))
+        return getdents_fallback_skipped;
+
+    std::size_t count = 0u;
+    boost::system::error_code ec;
+    for (fs::directory_iterator it(root / "dir", ec), end; !ec && it != end; it.increment(ec))
+        ++count;
+    if (ec || count != 100u)
+        return 1;
+
+    if (fs::is_empty(root / "dir") || !fs::is_empty(root / "empty_dir"))
+        return 2;
+
+    // The fallback applies to the failing iterator and does not change the backend selected by the user
+    if (fs::get_directory_read_backend() != fs::directory_read_backend::getdents)
+        return 3;
+
+    return 0;
+}
+
+//! Tests that directory iterators fall back to readdir if getdents64 fails at run time
+void test_getdents_fallback(fs::path const& root)
+{
+    if (!fs::set_directory_read_backend(fs::directory_read_backend::getdents))
+        return;
+
+    // The seccomp filter cannot be removed, so install it in a child process
+    const pid_t pid = ::fork();
+    if (pid == 0)
+        std::_Exit(run_getdents_fallback(root));
+
+    BOOST_TEST(pid > 0);
+    if (pid > 0)
+    {
+        int status = 0;
+        BOOST_TEST_EQ(::waitpid(pid, &status, 0), pid);
+        BOOST_TEST(WIFEXITED(status));
+        if (WIFEXITED(status) && WEXITSTATUS(status) != getdents_fallback_skipped)
+            BOOST_TEST_EQ(WEXITSTATUS(status), 0);
+    }
+
+    BOOST_TEST(fs::set_directory_read_backend(fs::directory_read_backend::system_default));
+}
+
+#endif // defined(BOOST_FILESYSTEM_TEST_HAS_SECCOMP) && defined(__NR_getdents64)
+
+void test_directory_read_backends(fs::path const& root)
+{
+    fs::create_directory(root / "dir");
+    for (unsigned int i = 0u; i < 100u; ++i)
+        create_pattern_file(root / "dir" / fs::path(std::string("file") + static_cast< char >('a' + i % 26u) + static_cast< char >('a' + i / 26u)));
+
+    fs::create_directory(root / "empty_dir");
+
+    const fs::directory_read_backend::type original = fs::get_directory_read_backend();
+    const fs::directory_read_backend::type backends[] =
+    {
+        fs::directory_read_backend::readdir,
+        fs::directory_read_backend::readdir_r,
+        fs::directory_read_backend::getdents
+    };
+
+    for (std::size_t i = 0u; i < sizeof(backends) / sizeof(*backends); ++i)
+    {
+        // Create an iterator before switching the backend, it must keep working
+        fs::directory_iterator before(root / "dir");
+
+        if (!fs::set_directory_read_backend(backends[i]))
+            continue;
+
+        BOOST_TEST_EQ(fs::get_directory_read_backend(), backends[i]);
+
+        std::size_t count = 0u;
+        for (fs::directory_iterator it(root / "dir"), end; it != end; ++it)
+        {
+            BOOST_TEST(fs::is_regular_file(it->status()));
+            ++count;
+        }
+        BOOST_TEST_EQ(count, 100u);
+
+        BOOST_TEST(!fs::is_empty(root / "dir"));
+        BOOST_TEST(fs::is_empty(root / "empty_dir"));
+
+        count = 0u;
+        for (fs::directory_iterator end; before != end; ++before)
+            ++count;
+        BOOST_TEST_EQ(count, 100u);
+    }
+
+    BOOST_TEST(fs::set_directory_read_backend(fs::directory_read_backend::system_default));
+    BOOST_TEST_EQ(fs::get_directory_read_backend(), original);
+
+#if defined(BOOST_FILESYSTEM_TEST_HAS_SECCOMP) && defined(__NR_getdents64)
+    test_getdents_fallback(root);
+#endif
+
+    fs::remove(root / "empty_dir");
+}
+
+void test_probe(fs::path const& root)
+{
+    boost::system::error_code ec;
+    fs::filesystem_capabilities caps = fs::probe_filesystem_capabilities(root, ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST(caps.clone <= fs::capability_support::supported);
+    BOOST_TEST(caps.copy_file_range <= fs::capability_support::supported);
+    BOOST_TEST(caps.directory_entry_type <= fs::capability_support::supported);
+    BOOST_TEST(caps.preallocate <= fs::capability_support::supported);
+    BOOST_TEST(caps.punch_hole <= fs::capability_support::supported);
+
+    // The probe must not leave any files behind
+    std::size_t count = 0u;
+    for (fs::directory_iterator it(root), end; it != end; ++it)
+        ++count;
+    BOOST_TEST_EQ(count, 2u); // source and dir
+
+    caps = fs::probe_filesystem_capabilities(root / "missing", ec);
+    BOOST_TEST(!!ec);
+
+    bool exception_thrown = false;
+    try
+    {
+        fs::probe_filesystem_capabilities(root / "missing");
+    }
+    catch (fs::filesystem_error&)
+    {
+        exception_thrown = true;
+    }
+    BOOST_TEST(exception_thrown);
+}
+
+} // namespace
+
+int main()
+{
+    temp_test_directory temp_dir("backends_test");
+    const fs::path& root = temp_dir.path();
+
+    test_copy_file_backends(root);
+    fs::remove(root / "target");
+    test_repeated_copies(root);
+    test_status_backends(root);
+    test_directory_read_backends(root);
+    test_probe(root);
+
+    return boost::report_errors();
+}
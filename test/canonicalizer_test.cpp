@@ -0,0 +1,134 @@
+//  canonicalizer_test.cpp  ------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/canonicalizer.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#include <cstddef>
+#include <iostream>
+#include <boost/system/error_code.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+bool symlinks_supported = false;
+
+void check_canonical(fs::canonicalizer& canon, fs::path const& p)
+{
+    const fs::path expected = fs::canonical(p);
+    BOOST_TEST_EQ(canon.canonical(p), expected);
+    // Repeat to use the cached directories
+    BOOST_TEST_EQ(canon.canonical(p), expected);
+}
+
+void check_weakly_canonical(fs::canonicalizer& canon, fs::path const& p)
+{
+    const fs::path expected = fs::weakly_canonical(p);
+    BOOST_TEST_EQ(canon.weakly_canonical(p), expected);
+    BOOST_TEST_EQ(canon.weakly_canonical(p), expected);
+}
+
+void test_canonical(fs::path const& root)
+{
+    fs::canonicalizer canon;
+    BOOST_TEST_EQ(canon.size(), 0u);
+
+    check_canonical(canon, root);
+    check_canonical(canon, root / "d1");
+    check_canonical(canon, root / "d1" / "d2" / "f1");
+    check_canonical(canon, root / "d1" / "d2" / "f2");
+    check_canonical(canon, root / "d1" / "." / "d2" / ".." / "d2" / "f1");
+    check_canonical(canon, root / "d1" / "d2" / ".." / ".." / "f0");
+    check_canonical(canon, fs::path(root.string() + "/d1/d2/"));
+    BOOST_TEST_GT(canon.size(), 0u);
+
+    if (symlinks_supported)
+    {
+        check_canonical(canon, root / "link_abs" / "f1");
+        check_canonical(canon, root / "link_rel" / "f2");
+        check_canonical(canon, root / "link_rel" / ".." / "d2" / "f1");
+        check_canonical(canon, root / "d1" / "link_up" / "d1" / "d2" / "f1");
+        check_canonical(canon, root / "link_file");
+    }
+
+    // Relative paths are resolved against the base
+    BOOST_TEST_EQ(canon.canonical("d2/f1", root / "d1"), fs::canonical(root / "d1" / "d2" / "f1"));
+
+    boost::system::error_code ec;
+    BOOST_TEST(canon.canonical(root / "d1" / "missing", ec).empty());
+    BOOST_TEST(!!ec);
+    BOOST_TEST_THROWS(canon.canonical(root / "missing" / "f1"), fs::filesystem_error);
+    BOOST_TEST_THROWS(canon.canonical(root / "f0" / "f1"), fs::filesystem_error);
+
+    if (symlinks_supported)
+    {
+        BOOST_TEST(canon.canonical(root / "loop", ec).empty());
+        BOOST_TEST(!!ec);
+        BOOST_TEST_THROWS(canon.canonical(root / "dangling"), fs::filesystem_error);
+    }
+
+    canon.clear();
+    BOOST_TEST_EQ(canon.size(), 0u);
+}
+
+void test_weakly_canonical(fs::path const& root)
+{
+    fs::canonicalizer canon;
+
+    check_weakly_canonical(canon, root / "d1" / "d2" / "f1");
+    check_weakly_canonical(canon, root / "d1" / "missing");
+    check_weakly_canonical(canon, root / "d1" / "missing" / ".." / "d2" / "f1");
+    check_weakly_canonical(canon, root / "missing" / "a" / "b");
+
+    if (symlinks_supported)
+    {
+        check_weakly_canonical(canon, root / "link_rel" / "missing" / "a");
+        check_weakly_canonical(canon, root / "dangling");
+        check_weakly_canonical(canon, root / "dangling" / "a");
+    }
+}
+
+} // namespace
+
+int main()
+{
+    temp_test_directory temp_dir("canonicalizer_test");
+    const fs::path root = fs::canonical(temp_dir.path());
+    fs::create_directories(root / "d1" / "d2");
+    create_file(root / "f0");
+    create_file(root / "d1" / "d2" / "f1");
+    create_file(root / "d1" / "d2" / "f2");
+
+    try
+    {
+        fs::create_directory_symlink(root / "d1" / "d2", root / "link_abs");
+        fs::create_directory_symlink(fs::path("d1") / "d2", root / "link_rel");
+        fs::create_directory_symlink("..", root / "d1" / "link_up");
+        fs::create_symlink(fs::path("d1") / "d2" / "f1", root / "link_file");
+        fs::create_symlink("loop", root / "loop");
+        fs::create_symlink("missing", root / "dangling");
+        symlinks_supported = true;
+    }
+    catch (fs::filesystem_error& e)
+    {
+        std::cout << "Symlinks are not supported: " << e.what() << std::endl;
+    }
+
+    test_canonical(root);
+    test_weakly_canonical(root);
+
+    return boost::report_errors();
+}
@@ -0,0 +1,169 @@
+//  compact_directory_entry_test.cpp  --------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/compact_directory_entry.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <boost/system/error_code.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+const unsigned int file_count = 40u;
+
+fs::path file_name(unsigned int i)
+{
+    return fs::path(std::string("file") + static_cast< char >('a' + i / 26u) + static_cast< char >('a' + i % 26u));
+}
+
+void create_tree(fs::path const& root)
+{
+    fs::create_directory(root / "dir");
+    for (unsigned int i = 0u; i < file_count; ++i)
+        create_file_of_size(root / "dir" / file_name(i), i);
+    fs::create_directory(root / "dir" / "sub");
+}
+
+void test_layout()
+{
+    BOOST_TEST_LE(sizeof(fs::compact_directory_entry) * 2u, sizeof(fs::directory_entry));
+
+    const fs::compact_directory_entry e;
+    BOOST_TEST(e.path().empty());
+    BOOST_TEST_EQ(e.file_type(), fs::status_error);
+    BOOST_TEST_EQ(e.symlink_file_type(), fs::status_error);
+    BOOST_TEST_EQ(e.permissions(), fs::perms_not_known);
+    BOOST_TEST(e.attributes() == NULL);
+
+    const fs::directory_entry de = e;
+    BOOST_TEST(de.path().empty());
+}
+
+void test_status(fs::path const& root)
+{
+    const fs::path dir = root / "dir";
+    fs::compact_directory_entry_storage storage;
+
+    // No status or attributes are cached
+    fs::compact_directory_entry e = storage.store(fs::directory_entry(dir / "sub"));
+    BOOST_TEST_EQ(e.path(), dir / "sub");
+    BOOST_TEST_EQ(e.path().data()[e.path().size()], static_cast< fs::path::value_type >(0));
+    BOOST_TEST_EQ(e.file_type(), fs::status_error);
+    BOOST_TEST(e.attributes() == NULL);
+    BOOST_TEST_EQ(storage.attributes_count(), 0u);
+
+    // The status is queried on construction of the directory_entry
+    fs::directory_entry de(dir / "sub");
+    de.refresh();
+    e = storage.store(de);
+    BOOST_TEST_EQ(e.file_type(), fs::directory_file);
+    BOOST_TEST_EQ(e.symlink_file_type(), fs::directory_file);
+    BOOST_TEST_EQ(e.permissions(), de.status().permissions());
+
+    fs::directory_entry converted = e;
+    BOOST_TEST_EQ(converted.path(), dir / "sub");
+    BOOST_TEST_EQ(converted.status().type(), fs::directory_file);
+    BOOST_TEST_EQ(converted.status().permissions(), de.status().permissions());
+
+    // Only the filename is stored
+    e = storage.store(de, de.path().filename());
+    BOOST_TEST_EQ(e.path(), fs::path("sub"));
+    converted = e.to_directory_entry(dir);
+    BOOST_TEST_EQ(converted.path(), dir / "sub");
+    BOOST_TEST_EQ(converted.file_type(), fs::directory_file);
+
+    BOOST_TEST_GT(storage.allocated_size(), 0u);
+    storage.release();
+    BOOST_TEST_EQ(storage.allocated_size(), 0u);
+}
+
+void test_attributes(fs::path const& root)
+{
+    const fs::path dir = root / "dir";
+    fs::compact_directory_entry_storage storage;
+    std::vector< fs::compact_directory_entry > entries;
+    for (fs::directory_iterator it(dir, fs::directory_options::prefetch_status), end; it != end; ++it)
+        entries.push_back(storage.store(*it, it->path().filename()));
+
+    BOOST_TEST_EQ(entries.size(), file_count + 1u);
+    std::sort(entries.begin(), entries.end());
+    BOOST_TEST_EQ(entries.front().path(), file_name(0u));
+    BOOST_TEST_EQ(entries.back().path(), fs::path("sub"));
+
+    for (unsigned int i = 0u; i < file_count; ++i)
+    {
+        fs::compact_directory_entry const& e = entries[i];
+        BOOST_TEST_EQ(e.path(), file_name(i));
+        BOOST_TEST_EQ(e.file_type(), fs::regular_file);
+        BOOST_TEST_EQ(e.symlink_file_type(), fs::regular_file);
+
+        fs::compact_directory_entry_attributes const* attrs = e.attributes();
+        if (BOOST_TEST(attrs != NULL))
+        {
+            BOOST_TEST_NE(attrs->flags & fs::compact_directory_entry_attributes::file_size_known, 0u);
+            BOOST_TEST_EQ(attrs->file_size, i);
+            BOOST_TEST_NE(attrs->flags & fs::compact_directory_entry_attributes::last_write_time_known, 0u);
+            BOOST_TEST_EQ(attrs->last_write_time, fs::last_write_time(dir / file_name(i)));
+        }
+    }
+
+    // The converted entries use the cached attributes and do not query the filesystem
+    std::vector< fs::directory_entry > converted;
+    for (std::size_t i = 0u; i < entries.size(); ++i)
+        converted.push_back(entries[i].to_directory_entry(dir));
+    fs::remove_all(dir);
+
+    for (unsigned int i = 0u; i < file_count; ++i)
+    {
+        fs::directory_entry const& e = converted[i];
+        BOOST_TEST_EQ(e.path(), dir / file_name(i));
+        BOOST_TEST_EQ(e.file_type(), fs::regular_file);
+        boost::system::error_code ec;
+        BOOST_TEST_EQ(e.file_size(ec), i);
+        BOOST_TEST(!ec);
+    }
+
+    BOOST_TEST_EQ(converted.back().symlink_file_type(), fs::directory_file);
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    // Entries remain valid when the storage is moved
+    fs::compact_directory_entry_storage moved(static_cast< fs::compact_directory_entry_storage&& >(storage));
+    BOOST_TEST_EQ(storage.allocated_size(), 0u);
+    BOOST_TEST_EQ(moved.attributes_count(), file_count + 1u);
+    BOOST_TEST_EQ(entries.front().path(), file_name(0u));
+#endif
+}
+
+} // namespace
+
+int main()
+{
+    temp_test_directory temp_dir("compact_directory_entry_test");
+    const fs::path& root = temp_dir.path();
+
+    create_tree(root);
+
+    test_layout();
+    test_status(root);
+    test_attributes(root);
+
+    return boost::report_errors();
+}
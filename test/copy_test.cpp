@@ -13,13 +13,30 @@
 #include <boost/filesystem/exception.hpp>
 #include <boost/filesystem/fstream.hpp> // for BOOST_FILESYSTEM_C_STR
 #include <boost/system/error_code.hpp>
+#include <boost/cstdint.hpp>
 
 #include <set>
+#include <cstddef>
 #include <string>
+#include <vector>
 #include <fstream>
+#include <sstream>
+#include <iterator>
 #include <iostream>
 #include <stdexcept>
 
+#if defined(BOOST_POSIX_API)
+#include <boost/filesystem/backends.hpp>
+#include <boost/filesystem/executor.hpp>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <cerrno>
+#if defined(__linux__) || defined(__linux) || defined(linux)
+#include <sys/xattr.h>
+#endif
+#endif
+
 #include <boost/throw_exception.hpp>
 #include <boost/exception/diagnostic_information.hpp>
 #include <boost/core/lightweight_test.hpp>
@@ -51,6 +68,14 @@ void verify_file(fs::path const& ph, std::string const& expected)
     }
 }
 
+std::string load_file(fs::path const& ph)
+{
+    std::ifstream f(BOOST_FILESYSTEM_C_STR(ph), std::ios_base::in | std::ios_base::binary);
+    if (!f)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Failed to open file: " + ph.string()));
+    return std::string(std::istreambuf_iterator< char >(f), std::istreambuf_iterator< char >());
+}
+
 fs::path create_tree()
 {
     fs::path root_dir = fs::unique_path();
@@ -115,6 +140,23 @@ void test_copy_file_default(fs::path const& root_dir)
     verify_file(target_dir / "f1", "f1");
     verify_file(target_dir / "f3", "f2");
 
+    // Compression of network traffic is only a hint
+    BOOST_TEST(fs::copy_file(root_dir / "f1", target_dir / "f4", fs::copy_options::compress_network_traffic));
+    verify_file(target_dir / "f4", "f1");
+
+    // Sizes around the limit of the files that are copied with a single read and write
+    const std::size_t sizes[] = { 65535u, 65536u, 65537u };
+    for (std::size_t i = 0u; i < sizeof(sizes) / sizeof(*sizes); ++i)
+    {
+        std::string contents(sizes[i], 'a');
+        for (std::size_t j = 0u; j < contents.size(); j += 7u)
+            contents[j] = static_cast< char >('b' + j % 23u);
+        create_file(root_dir / "small", contents);
+        BOOST_TEST(fs::copy_file(root_dir / "small", target_dir / "small", fs::copy_options::overwrite_existing));
+        BOOST_TEST(load_file(target_dir / "small") == contents);
+    }
+    fs::remove(root_dir / "small");
+
     fs::remove_all(target_dir);
 }
 
@@ -224,6 +266,38 @@ void test_copy_dir_recursive_tree(fs::path const& root_dir)
     fs::remove_all(target_dir);
 }
 
+void test_copy_dir_recursive_symlinks(fs::path const& root_dir)
+{
+    std::cout << "test_copy_dir_recursive_symlinks" << std::endl;
+
+    fs::path target_dir = fs::unique_path();
+
+    fs::copy(root_dir, target_dir, fs::copy_options::recursive | fs::copy_options::copy_symlinks);
+    BOOST_TEST(fs::is_symlink(fs::symlink_status(target_dir / "s1")));
+    BOOST_TEST_EQ(fs::read_symlink(target_dir / "s1"), fs::path("f1"));
+    verify_file(target_dir / "d1/d1/f1", "d1d1f1");
+
+    // Copying into an existing tree merges the directories and skips the existing files and symlinks
+    fs::remove(target_dir / "d1/d1/f1");
+    fs::copy(root_dir, target_dir, fs::copy_options::recursive | fs::copy_options::skip_symlinks | fs::copy_options::skip_existing);
+    verify_file(target_dir / "d1/d1/f1", "d1d1f1");
+
+    // Without overwriting, the first existing file causes an error
+    boost::system::error_code ec;
+    fs::copy(root_dir, target_dir, fs::copy_options::recursive | fs::copy_options::skip_symlinks, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST_THROWS(fs::copy(root_dir, target_dir, fs::copy_options::recursive | fs::copy_options::copy_symlinks), fs::filesystem_error);
+
+    fs::remove_all(target_dir);
+
+    // Symlinks are followed by default
+    fs::copy(root_dir, target_dir, fs::copy_options::recursive);
+    BOOST_TEST(fs::is_regular_file(fs::symlink_status(target_dir / "s1")));
+    verify_file(target_dir / "s1", "f1");
+
+    fs::remove_all(target_dir);
+}
+
 void test_copy_file_symlinks(fs::path const& root_dir)
 {
     std::cout << "test_copy_file_symlinks" << std::endl;
@@ -287,6 +361,469 @@ void test_copy_errors(fs::path const& root_dir, bool symlinks_supported)
     fs::remove_all(target_dir);
 }
 
+void test_copy_files(fs::path const& root_dir)
+{
+    std::cout << "test_copy_files" << std::endl;
+
+    fs::path target_dir = fs::unique_path();
+    fs::create_directory(target_dir);
+
+    // More files than copy_files checks in one batch
+    std::vector< fs::copy_file_entry > entries;
+    for (unsigned int i = 0u; i < 300u; ++i)
+    {
+        std::ostringstream name;
+        name << 'f' << i;
+        entries.push_back(fs::copy_file_entry(root_dir / ((i & 1u) != 0u ? "f1" : "f2"), target_dir / name.str()));
+    }
+
+    BOOST_TEST_EQ(fs::copy_files(&entries[0], entries.size()), entries.size());
+    verify_file(target_dir / "f0", "f2");
+    verify_file(target_dir / "f299", "f1");
+
+    // Existing targets are skipped, the missing ones are copied with synchronization
+    fs::remove(target_dir / "f10");
+    fs::remove(target_dir / "f257");
+    boost::system::error_code ec;
+    BOOST_TEST_EQ(fs::copy_files(&entries[0], entries.size(), fs::copy_options::skip_existing | fs::copy_options::synchronize, ec), 2u);
+    BOOST_TEST(!ec);
+    verify_file(target_dir / "f10", "f2");
+    verify_file(target_dir / "f257", "f1");
+
+    BOOST_TEST_EQ(fs::copy_files(&entries[0], entries.size(), fs::copy_options::overwrite_existing), entries.size());
+
+    // The existing targets are skipped without accessing the source
+    entries[5].from = root_dir / "non-existing";
+    BOOST_TEST_EQ(fs::copy_files(&entries[0], entries.size(), fs::copy_options::skip_existing, ec), 0u);
+    BOOST_TEST(!ec);
+
+    // Copying stops at the first error
+    fs::remove(target_dir / "f4");
+    fs::remove(target_dir / "f5");
+    fs::remove(target_dir / "f6");
+    BOOST_TEST_EQ(fs::copy_files(&entries[0], entries.size(), fs::copy_options::skip_existing, ec), 1u);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(fs::exists(target_dir / "f4"));
+    BOOST_TEST(!fs::exists(target_dir / "f6"));
+
+    bool exception_thrown = false;
+    try
+    {
+        fs::copy_files(&entries[0], entries.size(), fs::copy_options::skip_existing);
+    }
+    catch (fs::filesystem_error& e)
+    {
+        exception_thrown = true;
+        BOOST_TEST_EQ(e.path1(), entries[5].from);
+        BOOST_TEST_EQ(e.path2(), entries[5].to);
+    }
+    BOOST_TEST(exception_thrown);
+
+    BOOST_TEST_EQ(fs::copy_files(&entries[0], 0u), 0u);
+
+    fs::remove_all(target_dir);
+}
+
+#if defined(BOOST_POSIX_API)
+
+void test_copy_files_io_uring(fs::path const& root_dir)
+{
+    std::cout << "test_copy_files_io_uring" << std::endl;
+
+    if (!fs::set_copy_file_backend(fs::copy_file_backend::io_uring))
+        return;
+
+    fs::path target_dir = fs::unique_path();
+    fs::create_directory(target_dir);
+
+    // Sizes around the boundaries of the data chunks transferred by io_uring
+    const std::size_t sizes[] = { 0u, 1u, 131071u, 131072u, 131073u, 1000000u };
+    const std::size_t size_count = sizeof(sizes) / sizeof(*sizes);
+    std::vector< std::string > contents(size_count);
+    for (std::size_t i = 0u; i < size_count; ++i)
+    {
+        contents[i].resize(sizes[i]);
+        for (std::size_t j = 0u; j < sizes[i]; ++j)
+            contents[i][j] = static_cast< char >('a' + (i + j) % 26u);
+
+        std::ostringstream name;
+        name << "io_uring_source" << i;
+        create_file(root_dir / name.str(), contents[i]);
+    }
+
+    // More files than are copied concurrently
+    std::vector< fs::copy_file_entry > entries;
+    for (unsigned int i = 0u; i < 200u; ++i)
+    {
+        std::ostringstream source_name, target_name;
+        source_name << "io_uring_source" << i % size_count;
+        target_name << 'f' << i;
+        entries.push_back(fs::copy_file_entry(root_dir / source_name.str(), target_dir / target_name.str()));
+    }
+
+    BOOST_TEST_EQ(fs::copy_files(&entries[0], entries.size()), entries.size());
+    for (std::size_t i = 0u; i < entries.size(); ++i)
+        BOOST_TEST(load_file(entries[i].to) == contents[i % size_count]);
+
+    // Transfers that started before an error are completed, but no new copies are started after it
+    boost::system::error_code ec;
+    entries[150].from = root_dir / "non-existing";
+    BOOST_TEST_EQ(fs::copy_files(&entries[0], entries.size(), fs::copy_options::overwrite_existing | fs::copy_options::synchronize_data, ec), 150u);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(load_file(entries[149].to) == contents[149u % size_count]);
+
+    // A single copy uses io_uring as well
+    fs::copy_file(entries[5].from, target_dir / "single");
+    BOOST_TEST(load_file(target_dir / "single") == contents[5]);
+
+    BOOST_TEST(fs::set_copy_file_backend(fs::copy_file_backend::system_default));
+    fs::remove_all(target_dir);
+}
+
+#endif // defined(BOOST_POSIX_API)
+
+//! FNV-1a hash state for testing copy_file hashing
+struct fnv1a_state
+{
+    boost::uint64_t hash;
+    std::size_t size;
+
+    fnv1a_state() : hash(14695981039346656037ull), size(0u) {}
+};
+
+void fnv1a_update(void* state, const void* data, std::size_t size)
+{
+    fnv1a_state* st = static_cast< fnv1a_state* >(state);
+    const unsigned char* p = static_cast< const unsigned char* >(data);
+    for (std::size_t i = 0u; i < size; ++i)
+        st->hash = (st->hash ^ p[i]) * 1099511628211ull;
+    st->size += size;
+}
+
+bool fnv1a_equal(void* state1, void* state2)
+{
+    return static_cast< fnv1a_state* >(state1)->hash == static_cast< fnv1a_state* >(state2)->hash &&
+        static_cast< fnv1a_state* >(state1)->size == static_cast< fnv1a_state* >(state2)->size;
+}
+
+bool never_equal(void*, void*)
+{
+    return false;
+}
+
+void test_copy_file_hashing(fs::path const& root_dir)
+{
+    std::cout << "test_copy_file_hashing" << std::endl;
+
+    const fs::copy_file_hasher hasher = { &fnv1a_update, &fnv1a_equal };
+    const fs::path target = root_dir / "hashed";
+    std::string contents(100000u, 'x');
+    for (std::size_t i = 0u; i < contents.size(); ++i)
+        contents[i] = static_cast< char >('a' + i % 26u);
+    create_file(root_dir / "large", contents);
+
+    fnv1a_state expected;
+    fnv1a_update(&expected, contents.data(), contents.size());
+
+    boost::system::error_code ec;
+#if defined(BOOST_POSIX_API)
+    fnv1a_state source_state;
+    BOOST_TEST(fs::copy_file(root_dir / "large", target, fs::copy_options::none, hasher, &source_state));
+    BOOST_TEST_EQ(source_state.size, contents.size());
+    BOOST_TEST_EQ(source_state.hash, expected.hash);
+
+    // Verify the target, with the kernel-offload and cloning options that must not interfere with hashing
+    source_state = fnv1a_state();
+    fnv1a_state target_state;
+    BOOST_TEST(fs::copy_file(root_dir / "large", target, fs::copy_options::overwrite_existing | fs::copy_options::clone_if_possible | fs::copy_options::synchronize_data,
+        hasher, &source_state, &target_state, ec));
+    BOOST_TEST(!ec);
+    BOOST_TEST_EQ(source_state.hash, expected.hash);
+    BOOST_TEST_EQ(target_state.hash, expected.hash);
+
+    // Verification failure is reported as an error
+    const fs::copy_file_hasher mismatching_hasher = { &fnv1a_update, &never_equal };
+    source_state = fnv1a_state();
+    target_state = fnv1a_state();
+    BOOST_TEST(!fs::copy_file(root_dir / "large", target, fs::copy_options::overwrite_existing, mismatching_hasher, &source_state, &target_state, ec));
+    BOOST_TEST(ec == boost::system::errc::io_error);
+
+    // Cloned data cannot be hashed
+    source_state = fnv1a_state();
+    BOOST_TEST(!fs::copy_file(root_dir / "large", target, fs::copy_options::overwrite_existing | fs::copy_options::clone_required, hasher, &source_state, NULL, ec));
+    BOOST_TEST(!!ec);
+    BOOST_TEST_EQ(source_state.size, 0u);
+
+    // Empty files are hashed as well
+    create_file(root_dir / "empty");
+    source_state = fnv1a_state();
+    target_state = fnv1a_state();
+    BOOST_TEST(fs::copy_file(root_dir / "empty", target, fs::copy_options::overwrite_existing, hasher, &source_state, &target_state, ec));
+    BOOST_TEST(!ec);
+    BOOST_TEST_EQ(source_state.size, 0u);
+    fs::remove(root_dir / "empty");
+#else
+    fnv1a_state source_state;
+    BOOST_TEST(!fs::copy_file(root_dir / "large", target, fs::copy_options::none, hasher, &source_state, NULL, ec));
+    BOOST_TEST(ec == boost::system::errc::operation_not_supported);
+#endif
+
+    fs::remove(target);
+    fs::remove(root_dir / "large");
+}
+
+void test_copy_file_delta(fs::path const& root_dir)
+{
+    std::cout << "test_copy_file_delta" << std::endl;
+
+    const fs::path source = root_dir / "delta_source";
+    const fs::path target = root_dir / "delta_target";
+    const fs::path link = root_dir / "delta_link";
+
+    // Larger than one chunk of the comparison loop
+    std::string contents(1000000u, 'x');
+    for (std::size_t i = 0u; i < contents.size(); ++i)
+        contents[i] = static_cast< char >('a' + i % 26u);
+    create_file(source, contents);
+
+    // The target file does not exist, the whole file is copied
+    BOOST_TEST(fs::copy_file(source, target, fs::copy_options::overwrite_existing | fs::copy_options::delta));
+    BOOST_TEST(load_file(target) == contents);
+
+    // Changed blocks are written in place, so the hard link to the target sees the update
+    fs::create_hard_link(target, link);
+    contents[10] = '0';
+    contents[500000] = '1';
+    contents[contents.size() - 1u] = '2';
+    create_file(source, contents);
+    BOOST_TEST(fs::copy_file(source, target, fs::copy_options::overwrite_existing | fs::copy_options::delta));
+    BOOST_TEST(load_file(target) == contents);
+    BOOST_TEST(load_file(link) == contents);
+
+    // A larger target file is truncated, and a smaller one is extended
+    contents.resize(700000u);
+    create_file(source, contents);
+    BOOST_TEST(fs::copy_file(source, target, fs::copy_options::overwrite_existing | fs::copy_options::delta));
+    BOOST_TEST_EQ(fs::file_size(target), contents.size());
+    BOOST_TEST(load_file(link) == contents);
+
+    contents.append(400000u, 'y');
+    create_file(source, contents);
+    BOOST_TEST(fs::copy_file(source, target, fs::copy_options::overwrite_existing | fs::copy_options::delta));
+    BOOST_TEST(load_file(link) == contents);
+
+    create_file(source);
+    BOOST_TEST(fs::copy_file(source, target, fs::copy_options::overwrite_existing | fs::copy_options::delta));
+    BOOST_TEST_EQ(fs::file_size(link), 0u);
+
+    // The last write time is still checked
+    create_file(source, "newer");
+    fs::last_write_time(target, fs::last_write_time(source) + 100);
+    boost::system::error_code ec;
+    BOOST_TEST(!fs::copy_file(source, target, fs::copy_options::update_existing | fs::copy_options::delta, ec));
+    BOOST_TEST(!ec);
+    BOOST_TEST_EQ(fs::file_size(target), 0u);
+
+    // Without overwriting options, the existing target is not replaced
+    BOOST_TEST(!fs::copy_file(source, target, fs::copy_options::delta, ec));
+    BOOST_TEST(!!ec);
+
+#if defined(BOOST_POSIX_API)
+    // The target file cannot be verified by hashing in delta mode
+    const fs::copy_file_hasher hasher = { &fnv1a_update, &fnv1a_equal };
+    fnv1a_state source_state;
+    BOOST_TEST(!fs::copy_file(source, target, fs::copy_options::overwrite_existing | fs::copy_options::delta, hasher, &source_state, NULL, ec));
+    BOOST_TEST(ec == boost::system::errc::invalid_argument);
+#endif
+
+    fs::remove(link);
+    fs::remove(target);
+    fs::remove(source);
+}
+
+void test_copy_file_preserve(fs::path const& root_dir)
+{
+    std::cout << "test_copy_file_preserve" << std::endl;
+
+    const fs::path source = root_dir / "preserve_source";
+    const fs::path target = root_dir / "preserve_target";
+    create_file(source, "preserve");
+
+    fs::file_attribute_set attrs;
+    attrs.mask = fs::file_attribute_mask::last_write_time | fs::file_attribute_mask::last_access_time;
+    attrs.last_write_time = fs::file_time(1000000000, 123456000u);
+    attrs.last_access_time = fs::file_time(1100000000, 654321000u);
+    fs::set_attributes(source, attrs);
+
+    BOOST_TEST(fs::copy_file(source, target, fs::copy_options::preserve_times | fs::copy_options::preserve_owner));
+
+    // Query the attributes before reading the file, which may update the last access time
+    const fs::file_attributes source_attrs = fs::query(source, fs::file_attribute_mask::last_write_time | fs::file_attribute_mask::owner);
+    const fs::file_attributes target_attrs = fs::query(target, fs::file_attribute_mask::last_write_time | fs::file_attribute_mask::last_access_time | fs::file_attribute_mask::owner);
+    BOOST_TEST(target_attrs.precise_last_write_time() == source_attrs.precise_last_write_time());
+    // Filesystems that don't track access times may not report it
+    if ((target_attrs.mask & fs::file_attribute_mask::last_access_time) != fs::file_attribute_mask::none)
+        BOOST_TEST_EQ(target_attrs.last_access_time, attrs.last_access_time.seconds);
+#if defined(BOOST_POSIX_API)
+    BOOST_TEST_EQ(target_attrs.owner_id, source_attrs.owner_id);
+    BOOST_TEST_EQ(target_attrs.group_id, source_attrs.group_id);
+#endif
+    verify_file(target, "preserve");
+
+    // The times are also set on an overwritten target file whose data is copied by a different implementation
+    create_file(source, std::string(200000u, 'p'));
+    fs::set_attributes(source, attrs);
+    BOOST_TEST(fs::copy_file(source, target, fs::copy_options::overwrite_existing | fs::copy_options::preserve_times | fs::copy_options::parallel_data));
+    BOOST_TEST(fs::precise_last_write_time(target) == attrs.last_write_time);
+    BOOST_TEST_EQ(fs::file_size(target), 200000u);
+    fs::remove(target);
+
+    // Without the option, the target file gets the current time
+    BOOST_TEST(fs::copy_file(source, target));
+    BOOST_TEST(fs::last_write_time(target) > attrs.last_write_time.seconds);
+    fs::remove(target);
+
+#if defined(__linux__) || defined(__linux) || defined(linux)
+    if (::setxattr(source.c_str(), "user.boost_fs_test", "value", 5u, 0) == 0)
+    {
+        BOOST_TEST(fs::copy_file(source, target, fs::copy_options::preserve_xattrs));
+        char value[16] = {};
+        BOOST_TEST_EQ(::getxattr(target.c_str(), "user.boost_fs_test", value, sizeof(value)), 5);
+        BOOST_TEST_EQ(std::string(value), "value");
+        fs::remove(target);
+    }
+    else
+    {
+        std::cout << "     extended attributes are not supported by the filesystem, errno: " << errno << std::endl;
+    }
+#endif
+
+    // Files without extended attributes are copied as well
+    create_file(source, "no_attributes");
+    boost::system::error_code ec;
+    fs::copy_file(source, target, fs::copy_options::preserve_xattrs, ec);
+    if (!ec)
+        verify_file(target, "no_attributes");
+    else
+        BOOST_TEST(ec == boost::system::errc::operation_not_supported);
+
+    fs::remove(target);
+    fs::remove(source);
+}
+
+#if defined(BOOST_POSIX_API)
+
+void test_copy_data_impl(fs::path const& root_dir)
+{
+    const fs::path source = root_dir / "copy_data_source";
+    const fs::path target = root_dir / "copy_data_target";
+    std::string contents;
+    for (unsigned int i = 0u; i < 5000u; ++i)
+        contents += "0123456789abcdef"[i % 13u];
+    create_file(source, contents);
+
+    // File to file, whole file and a range
+    int from = ::open(source.c_str(), O_RDONLY);
+    int to = ::open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    BOOST_TEST(from >= 0 && to >= 0);
+    BOOST_TEST_EQ(fs::copy_data(from, to), contents.size());
+    BOOST_TEST_EQ(fs::copy_data(from, to), 0u); // at the end of the source
+    BOOST_TEST_EQ(fs::copy_data(from, to, fs::copy_data_range(100u, 1000u)), 1000u);
+    BOOST_TEST_EQ(fs::copy_data(from, to, fs::copy_data_range(4500u, fs::copy_data_range::until_end)), 500u);
+    ::close(to);
+    BOOST_TEST(load_file(target) == contents + contents.substr(100u, 1000u) + contents.substr(4500u));
+
+    // Limited size from the current position
+    ::lseek(from, 10, SEEK_SET);
+    to = ::open(target.c_str(), O_WRONLY | O_TRUNC);
+    BOOST_TEST_EQ(fs::copy_data(from, to, fs::copy_data_range(20u)), 20u);
+    ::close(to);
+    BOOST_TEST(load_file(target) == contents.substr(10u, 20u));
+
+    // File to pipe and pipe to file
+    int pipe_fds[2];
+    BOOST_TEST_EQ(::pipe(pipe_fds), 0);
+    BOOST_TEST_EQ(fs::copy_data(from, pipe_fds[1], fs::copy_data_range(0u, 3000u)), 3000u);
+    ::close(pipe_fds[1]);
+    to = ::open(target.c_str(), O_WRONLY | O_TRUNC);
+    BOOST_TEST_EQ(fs::copy_data(pipe_fds[0], to), 3000u);
+    ::close(to);
+    ::close(pipe_fds[0]);
+    BOOST_TEST(load_file(target) == contents.substr(0u, 3000u));
+
+    // File to socket and socket to file
+    int socket_fds[2];
+    BOOST_TEST_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, socket_fds), 0);
+    BOOST_TEST_EQ(fs::copy_data(from, socket_fds[0], fs::copy_data_range(2000u, 2000u)), 2000u);
+    ::shutdown(socket_fds[0], SHUT_WR);
+    to = ::open(target.c_str(), O_WRONLY | O_TRUNC);
+    BOOST_TEST_EQ(fs::copy_data(socket_fds[1], to), 2000u);
+    ::close(to);
+    ::close(socket_fds[0]);
+    ::close(socket_fds[1]);
+    BOOST_TEST(load_file(target) == contents.substr(2000u, 2000u));
+
+    // Errors are reported
+    boost::system::error_code ec;
+    to = ::open(target.c_str(), O_RDONLY);
+    BOOST_TEST_EQ(fs::copy_data(from, to, fs::copy_data_range(0u, 100u), ec), 0u);
+    BOOST_TEST(!!ec);
+    BOOST_TEST_THROWS(fs::copy_data(from, to, fs::copy_data_range(0u, 100u)), fs::filesystem_error);
+    ::close(to);
+    ::close(from);
+
+    fs::remove(target);
+    fs::remove(source);
+}
+
+void test_copy_file_parallel(fs::path const& root_dir)
+{
+    const fs::path source = root_dir / "parallel_source";
+    const fs::path target = root_dir / "parallel_target";
+
+    // Lower the thresholds so that small files are split into ranges, and use a pool of several threads
+    // regardless of the number of CPUs
+    fs::detail::set_parallel_copy_file_params(10000u, 4096u);
+    fs::thread_pool_executor pool(4u);
+    fs::executor* const prev_executor = fs::set_executor(&pool);
+
+    // Sizes below the threshold, a multiple of the range size and a partial last range
+    const std::size_t sizes[] = { 5000u, 16384u, 100001u };
+    for (std::size_t i = 0u; i < sizeof(sizes) / sizeof(*sizes); ++i)
+    {
+        std::string contents;
+        contents.reserve(sizes[i]);
+        for (std::size_t j = 0u; j < sizes[i]; ++j)
+            contents += static_cast< char >('a' + (j * 7u + j / 4096u) % 26u);
+        create_file(source, contents);
+
+        boost::system::error_code ec;
+        BOOST_TEST(fs::copy_file(source, target, fs::copy_options::overwrite_existing | fs::copy_options::parallel_data, ec));
+        BOOST_TEST(!ec);
+        BOOST_TEST_EQ(fs::file_size(target), sizes[i]);
+        BOOST_TEST(load_file(target) == contents);
+    }
+
+    fs::set_executor(prev_executor);
+    fs::detail::set_parallel_copy_file_params(0u, 0u);
+
+    fs::remove(target);
+    fs::remove(source);
+}
+
+void test_copy_data(fs::path const& root_dir)
+{
+    test_copy_data_impl(root_dir);
+
+    // The read/write loop is used if it is selected as the copy_file backend
+    const fs::copy_file_backend::type backend = fs::get_copy_file_backend();
+    BOOST_TEST(fs::set_copy_file_backend(fs::copy_file_backend::read_write));
+    test_copy_data_impl(root_dir);
+    fs::set_copy_file_backend(backend);
+}
+
+#endif // defined(BOOST_POSIX_API)
+
 } // namespace
 
 int main()
@@ -323,10 +860,22 @@ int main()
         if (symlinks_supported)
         {
             test_copy_dir_default(root_dir, true);
+            test_copy_dir_recursive_symlinks(root_dir);
             test_copy_file_symlinks(root_dir);
         }
 
         test_copy_errors(root_dir, symlinks_supported);
+        test_copy_files(root_dir);
+#if defined(BOOST_POSIX_API)
+        test_copy_files_io_uring(root_dir);
+#endif
+        test_copy_file_hashing(root_dir);
+        test_copy_file_delta(root_dir);
+        test_copy_file_preserve(root_dir);
+#if defined(BOOST_POSIX_API)
+        test_copy_file_parallel(root_dir);
+        test_copy_data(root_dir);
+#endif
 
         fs::remove_all(root_dir);
 
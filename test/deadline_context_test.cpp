@@ -0,0 +1,107 @@
+//  deadline_context_test.cpp  ---------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/deadline_context.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <boost/system/error_code.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+//! Generous timeout, so that the tests do not fail on slow systems
+const unsigned int timeout_ms = 60000u;
+
+void test_status(fs::deadline_context& ctx, fs::path const& root)
+{
+    BOOST_TEST_EQ(ctx.status(root / "file", timeout_ms).type(), fs::regular_file);
+    BOOST_TEST_EQ(ctx.status(root, timeout_ms).type(), fs::directory_file);
+    BOOST_TEST_EQ(ctx.symlink_status(root / "file", timeout_ms).type(), fs::regular_file);
+
+    // Like status, missing files are reported in the error code but do not throw
+    BOOST_TEST_EQ(ctx.status(root / "missing", timeout_ms).type(), fs::file_not_found);
+    boost::system::error_code ec;
+    BOOST_TEST_EQ(ctx.status(root / "missing", timeout_ms, ec).type(), fs::file_not_found);
+    BOOST_TEST(!!ec);
+
+    BOOST_TEST(ctx.exists(root / "file", timeout_ms));
+    BOOST_TEST(!ctx.exists(root / "missing", timeout_ms));
+    BOOST_TEST(ctx.exists(root / "file", timeout_ms, ec));
+    BOOST_TEST(!ec);
+}
+
+void test_space(fs::deadline_context& ctx, fs::path const& root)
+{
+    const fs::space_info info = ctx.space(root, timeout_ms);
+    BOOST_TEST(info.capacity > 0u);
+    BOOST_TEST(info.free <= info.capacity);
+
+    boost::system::error_code ec;
+    ctx.space(root / "missing", timeout_ms, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST_THROWS(ctx.space(root / "missing", timeout_ms), fs::filesystem_error);
+}
+
+void test_directory_entries(fs::deadline_context& ctx, fs::path const& root)
+{
+    std::vector< fs::directory_entry > entries = ctx.directory_entries(root, timeout_ms);
+    BOOST_TEST_EQ(entries.size(), 3u);
+
+    boost::system::error_code ec;
+    entries = ctx.directory_entries(root / "missing", timeout_ms, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(entries.empty());
+    BOOST_TEST_THROWS(ctx.directory_entries(root / "missing", timeout_ms), fs::filesystem_error);
+    BOOST_TEST_THROWS(ctx.directory_entries(root / "file", timeout_ms), fs::filesystem_error);
+}
+
+void test_isolation(fs::deadline_context& ctx, fs::path const& root)
+{
+    // Nothing timed out, so no mounts are isolated
+    BOOST_TEST(!ctx.is_stuck(root));
+    BOOST_TEST(!ctx.is_stuck(fs::path("relative")));
+    BOOST_TEST_EQ(ctx.blocked_operation_count(), 0u);
+
+    // A single worker thread handles many sequential operations
+    fs::deadline_context single(1u);
+    for (unsigned int i = 0u; i < 100u; ++i)
+        BOOST_TEST(single.exists(root / "file", timeout_ms));
+    BOOST_TEST_EQ(single.blocked_operation_count(), 0u);
+}
+
+} // namespace
+
+int main()
+{
+    temp_test_directory temp_dir("deadline_context_test");
+    const fs::path& root = temp_dir.path();
+
+    create_file(root / "file");
+    create_file(root / "file2");
+    fs::create_directory(root / "dir");
+
+    fs::deadline_context ctx;
+    test_status(ctx, root);
+    test_space(ctx, root);
+    test_directory_entries(ctx, root);
+    test_isolation(ctx, root);
+
+    return boost::report_errors();
+}
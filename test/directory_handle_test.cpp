@@ -0,0 +1,291 @@
+//  directory_handle_test.cpp  ---------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/directory_handle.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#include <algorithm>
+#include <vector>
+#include <boost/system/error_code.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+void test_open(fs::path const& root)
+{
+    fs::directory_handle empty;
+    BOOST_TEST(!empty.is_open());
+
+    fs::directory_handle dir(root);
+    BOOST_TEST(dir.is_open());
+
+    fs::directory_handle sub(dir, "sub");
+    BOOST_TEST(sub.is_open());
+    BOOST_TEST(sub.status("file").type() == fs::regular_file);
+
+    boost::system::error_code ec;
+    fs::directory_handle missing(dir, "missing", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(!missing.is_open());
+    BOOST_TEST_THROWS(fs::directory_handle(dir, "missing"), fs::filesystem_error);
+
+    // Regular files cannot be opened as directories
+    fs::directory_handle not_dir(dir, "file", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(!not_dir.is_open());
+
+    // Reopening closes the previously open directory
+    sub.open(dir, "sub", ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST(sub.is_open());
+    sub.open(sub, ".", ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST(sub.status("file").type() == fs::regular_file);
+
+    fs::directory_handle::native_handle_type h = sub.release();
+    BOOST_TEST(!sub.is_open());
+    sub.assign(h);
+    BOOST_TEST(sub.is_open());
+    BOOST_TEST(sub.native_handle() == h);
+
+    swap(sub, empty);
+    BOOST_TEST(!sub.is_open());
+    BOOST_TEST(empty.is_open());
+
+    empty.close();
+    BOOST_TEST(!empty.is_open());
+}
+
+void test_operations(fs::path const& root)
+{
+    fs::directory_handle dir(root);
+
+    BOOST_TEST(dir.status("file").type() == fs::regular_file);
+    BOOST_TEST(dir.status("sub").type() == fs::directory_file);
+    BOOST_TEST(dir.status("missing").type() == fs::file_not_found);
+    BOOST_TEST(dir.symlink_status("sub/file").type() == fs::regular_file);
+
+    // Absolute paths are not affected by the directory
+    BOOST_TEST(dir.status(root / "file").type() == fs::regular_file);
+
+    fs::file_attributes attrs = dir.query("sub/file", fs::file_attribute_mask::type | fs::file_attribute_mask::size);
+    BOOST_TEST((attrs.mask & fs::file_attribute_mask::type) != fs::file_attribute_mask::none);
+    BOOST_TEST_EQ(attrs.status.type(), fs::regular_file);
+    if ((attrs.mask & fs::file_attribute_mask::size) != fs::file_attribute_mask::none)
+        BOOST_TEST_EQ(attrs.size, fs::file_size(root / "sub" / "file"));
+    BOOST_TEST_EQ(dir.query("sub", fs::file_attribute_mask::type).status.type(), fs::directory_file);
+    BOOST_TEST_THROWS(dir.query("missing", fs::file_attribute_mask::type), fs::filesystem_error);
+
+    boost::system::error_code ec;
+    BOOST_TEST(dir.create_directory("new_dir", ec));
+    BOOST_TEST(!ec);
+    BOOST_TEST(fs::is_directory(root / "new_dir"));
+    BOOST_TEST(!dir.create_directory("new_dir"));
+    BOOST_TEST_THROWS(dir.create_directory("file"), fs::filesystem_error);
+
+    dir.rename("new_dir", "renamed_dir");
+    BOOST_TEST(!fs::exists(root / "new_dir"));
+    BOOST_TEST(fs::is_directory(root / "renamed_dir"));
+
+    fs::directory_handle sub(dir, "sub");
+    dir.rename("file", sub, "moved_file", ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST(!fs::exists(root / "file"));
+    BOOST_TEST(fs::is_regular_file(root / "sub" / "moved_file"));
+
+    dir.rename("missing", "missing2", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST_THROWS(dir.rename("missing", "missing2"), fs::filesystem_error);
+
+    BOOST_TEST(sub.remove("moved_file"));
+    BOOST_TEST(!fs::exists(root / "sub" / "moved_file"));
+    BOOST_TEST(!sub.remove("moved_file"));
+    BOOST_TEST(dir.remove("renamed_dir", ec));
+    BOOST_TEST(!ec);
+    BOOST_TEST(!fs::exists(root / "renamed_dir"));
+
+    // Non-empty directories are not removed
+    BOOST_TEST_THROWS(dir.remove("sub"), fs::filesystem_error);
+
+    // The handle keeps referring to the directory after it is renamed
+    fs::rename(root / "sub", root / "sub2");
+    BOOST_TEST(sub.status("file").type() == fs::regular_file);
+    fs::rename(root / "sub2", root / "sub");
+}
+
+void test_directory_iterator(fs::path const& root)
+{
+    fs::directory_handle dir(root);
+
+    std::vector< fs::path > paths;
+    for (fs::directory_iterator it(dir, "sub"), end; it != end; ++it)
+        paths.push_back(it->path());
+    std::sort(paths.begin(), paths.end());
+
+    BOOST_TEST_EQ(paths.size(), 2u);
+    if (paths.size() == 2u)
+    {
+        BOOST_TEST_EQ(paths[0], fs::path("sub") / "file");
+        BOOST_TEST_EQ(paths[1], fs::path("sub") / "file2");
+    }
+
+    fs::directory_handle sub(dir, "sub");
+    std::size_t count = 0u;
+    for (fs::directory_iterator it(sub, "."), end; it != end; ++it)
+    {
+        BOOST_TEST(it->status().type() == fs::regular_file);
+        ++count;
+    }
+    BOOST_TEST_EQ(count, 2u);
+
+    boost::system::error_code ec;
+    fs::directory_iterator it(dir, "missing", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(it == fs::directory_iterator());
+    BOOST_TEST_THROWS(fs::directory_iterator(dir, "missing"), fs::filesystem_error);
+}
+
+void test_identity(fs::path const& root)
+{
+    fs::directory_handle dir(root);
+    fs::directory_handle sub(dir, "sub");
+    fs::directory_handle sub2(root / "sub");
+
+    BOOST_TEST(dir.identity() == fs::identity(root));
+    BOOST_TEST(sub.identity() == fs::identity(root / "sub"));
+    BOOST_TEST(dir.identity("sub") == sub.identity());
+    BOOST_TEST(sub.identity("file") == fs::identity(root / "sub" / "file"));
+    BOOST_TEST(sub.identity("file") != sub.identity("file2"));
+    BOOST_TEST(fs::equivalent(sub, sub2));
+    BOOST_TEST(!fs::equivalent(dir, sub));
+
+    boost::system::error_code ec;
+    BOOST_TEST(dir.identity("missing", ec) == fs::file_identity());
+    BOOST_TEST(!!ec);
+    BOOST_TEST_THROWS(dir.identity("missing"), fs::filesystem_error);
+
+    fs::directory_handle empty;
+    BOOST_TEST(!fs::equivalent(empty, dir, ec));
+    BOOST_TEST(!!ec);
+}
+
+void test_read_symlink(fs::path const& root)
+{
+    boost::system::error_code ec;
+    fs::create_symlink("file", root / "sub" / "link", ec);
+    if (ec)
+        return; // symlinks are not supported
+
+    fs::directory_handle dir(root);
+    BOOST_TEST_EQ(dir.read_symlink("sub/link"), fs::path("file"));
+    fs::directory_handle sub(dir, "sub");
+    BOOST_TEST_EQ(sub.read_symlink("link"), fs::path("file"));
+    BOOST_TEST_EQ(sub.read_symlink(root / "sub" / "link"), fs::path("file"));
+
+    BOOST_TEST(sub.read_symlink("file", ec).empty());
+    BOOST_TEST(!!ec);
+    BOOST_TEST_THROWS(sub.read_symlink("missing"), fs::filesystem_error);
+
+    fs::remove(root / "sub" / "link");
+}
+
+void test_open_beneath(fs::path const& root)
+{
+    fs::directory_handle dir(root);
+
+    fs::directory_handle sub;
+    sub.open_beneath(dir, "sub");
+    BOOST_TEST(sub.is_open());
+    BOOST_TEST(sub.status("file").type() == fs::regular_file);
+
+    // Dot-dot elements are allowed as long as they stay beneath the base directory
+    fs::directory_handle same;
+    same.open_beneath(dir, fs::path("sub") / ".." / "sub" / ".");
+    BOOST_TEST(fs::equivalent(same, sub));
+    same.open_beneath(dir, fs::path("sub") / "..");
+    BOOST_TEST(fs::equivalent(same, dir));
+
+    boost::system::error_code ec;
+    fs::directory_handle escaped;
+    escaped.open_beneath(dir, "..", ec);
+    BOOST_TEST(ec == boost::system::errc::cross_device_link);
+    BOOST_TEST(!escaped.is_open());
+    escaped.open_beneath(sub, fs::path("..") / ".." / "sub", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(!escaped.is_open());
+    escaped.open_beneath(dir, root / "sub", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST_THROWS(escaped.open_beneath(dir, ".."), fs::filesystem_error);
+
+    escaped.open_beneath(dir, "file", ec);
+    BOOST_TEST(!!ec);
+    escaped.open_beneath(dir, "missing", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(!escaped.is_open());
+
+    // Reopening relative to the handle itself
+    sub.open_beneath(sub, ".", fs::resolve_options::no_cross_device, ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST(sub.status("file").type() == fs::regular_file);
+
+    fs::create_directory_symlink("..", root / "sub" / "up", ec);
+    if (ec)
+        return; // symlinks are not supported
+
+    fs::create_directory_symlink(fs::path("..") / "..", root / "sub" / "escape");
+    fs::create_directory_symlink(root, root / "sub" / "absolute");
+
+#if defined(BOOST_POSIX_API)
+    // Symlinks are followed as long as they stay beneath the base directory
+    same.open_beneath(dir, fs::path("sub") / "up" / "sub", ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST(fs::equivalent(same, sub));
+#endif
+
+    same.open_beneath(dir, fs::path("sub") / "up", fs::resolve_options::no_symlinks, ec);
+    BOOST_TEST(!!ec);
+    escaped.open_beneath(dir, fs::path("sub") / "escape", ec);
+    BOOST_TEST(!!ec);
+    escaped.open_beneath(dir, fs::path("sub") / "absolute", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(!escaped.is_open());
+
+    fs::remove(root / "sub" / "up");
+    fs::remove(root / "sub" / "escape");
+    fs::remove(root / "sub" / "absolute");
+}
+
+} // namespace
+
+int main()
+{
+    temp_test_directory temp_dir("directory_handle_test");
+    const fs::path& root = temp_dir.path();
+    fs::create_directory(root / "sub");
+    create_file(root / "file");
+    create_file(root / "sub" / "file");
+    create_file(root / "sub" / "file2");
+
+    test_open(root);
+    test_operations(root);
+    test_directory_iterator(root);
+    test_identity(root);
+    test_read_symlink(root);
+    test_open_beneath(root);
+
+    return boost::report_errors();
+}
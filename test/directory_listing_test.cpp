@@ -0,0 +1,115 @@
+//  directory_listing_test.cpp  --------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/directory_listing.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <boost/system/error_code.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+const unsigned int file_count = 150u;
+
+fs::path file_name(unsigned int i)
+{
+    return fs::path(std::string("file") + static_cast< char >('a' + i / 26u) + static_cast< char >('a' + i % 26u));
+}
+
+void create_tree(fs::path const& root)
+{
+    fs::create_directory(root / "dir");
+    for (unsigned int i = 0u; i < file_count; ++i)
+        create_file_of_size(root / "dir" / file_name(i), i);
+    fs::create_directory(root / "dir" / "sub");
+}
+
+void test_listing(fs::path const& root)
+{
+    const fs::path dir = root / "dir";
+    fs::directory_listing listing = fs::list_directory(dir);
+    BOOST_TEST_EQ(listing.size(), file_count + 1u);
+
+    std::vector< fs::path > names, expected;
+    for (std::size_t i = 0u; i < listing.size(); ++i)
+    {
+        fs::directory_listing_record const& rec = listing[i];
+        BOOST_TEST_EQ(listing.names()[rec.name_offset + rec.name_size], static_cast< fs::path::value_type >(0));
+        BOOST_TEST_EQ(rec.flags, 0u);
+        names.push_back(fs::path(listing.name(i).native()));
+        if (listing.type(i) != fs::status_error)
+            BOOST_TEST(listing.type(i) == fs::symlink_status(dir / names.back()).type());
+    }
+    for (fs::directory_iterator it(dir), end; it != end; ++it)
+        expected.push_back(it->path().filename());
+    std::sort(names.begin(), names.end());
+    std::sort(expected.begin(), expected.end());
+    BOOST_TEST(names == expected);
+
+    // Sorted listing with attributes
+    listing.list(dir, fs::listing_options::sort_by_name | fs::listing_options::query_attributes);
+    BOOST_TEST_EQ(listing.size(), file_count + 1u);
+    for (std::size_t i = 0u; i < listing.size(); ++i)
+    {
+        fs::directory_listing_record const& rec = listing[i];
+        const fs::path p = dir / fs::path(listing.name(i).native());
+        if (i > 0u)
+            BOOST_TEST(listing.name(i - 1u).native() < listing.name(i).native());
+        BOOST_TEST(listing.type(i) == fs::symlink_status(p).type());
+        BOOST_TEST_EQ(rec.flags, static_cast< boost::uint32_t >(fs::directory_listing_record::attributes_known));
+        if (listing.type(i) == fs::regular_file)
+            BOOST_TEST_EQ(rec.size, fs::file_size(p));
+        BOOST_TEST_EQ(rec.last_write_time, static_cast< boost::int64_t >(fs::last_write_time(p)));
+    }
+
+    boost::system::error_code ec;
+    fs::directory_listing sorted(listing);
+    listing.list(root / "missing", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(listing.empty());
+    BOOST_TEST(listing.records() == NULL);
+    BOOST_TEST_THROWS(fs::list_directory(root / "missing"), fs::filesystem_error);
+
+    fs::directory_listing empty = fs::list_directory(dir / "sub", ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST(empty.empty());
+
+    fs::directory_listing copy(sorted);
+    BOOST_TEST_EQ(copy.size(), file_count + 1u);
+    BOOST_TEST(copy.names() != sorted.names());
+    BOOST_TEST(copy.name(0u).native() == sorted.name(0u).native());
+    swap(copy, empty);
+    BOOST_TEST(copy.empty());
+    BOOST_TEST_EQ(empty.size(), file_count + 1u);
+}
+
+} // namespace
+
+int main()
+{
+    temp_test_directory temp_dir("directory_listing_test");
+    const fs::path& root = temp_dir.path();
+
+    create_tree(root);
+    test_listing(root);
+
+    return boost::report_errors();
+}
@@ -0,0 +1,223 @@
+//  directory_watcher_test.cpp  --------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/directory_watcher.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <boost/system/error_code.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+//! Reads events until an event of the given kind for the given path is received or the events stop coming
+bool wait_for_event(fs::directory_watcher& watcher, std::vector< fs::watch_event >& events, BOOST_SCOPED_ENUM_NATIVE(fs::watch_event_kind) kind, fs::path const& target)
+{
+    for (std::size_t pos = 0u; true;)
+    {
+        for (std::size_t n = events.size(); pos < n; ++pos)
+        {
+            if (events[pos].kind == kind && events[pos].target == target)
+                return true;
+        }
+
+        if (watcher.read_events(events, 2000u) == 0u)
+            return false;
+    }
+}
+
+bool has_event(std::vector< fs::watch_event > const& events, BOOST_SCOPED_ENUM_NATIVE(fs::watch_event_kind) kind, fs::path const& target)
+{
+    for (std::size_t i = 0u, n = events.size(); i < n; ++i)
+    {
+        if (events[i].kind == kind && events[i].target == target)
+            return true;
+    }
+
+    return false;
+}
+
+void test_basic_events(fs::path const& root)
+{
+    const fs::path dir = root / "basic";
+    fs::create_directory(dir);
+
+    fs::directory_watcher watcher(dir);
+    BOOST_TEST(watcher.is_open());
+    BOOST_TEST(watcher.watched_path() == dir);
+
+    std::vector< fs::watch_event > events;
+    BOOST_TEST_EQ(watcher.read_events(events, 0u), 0u);
+
+    create_file(dir / "file", "abc");
+    BOOST_TEST(wait_for_event(watcher, events, fs::watch_event_kind::created, dir / "file"));
+
+    events.clear();
+    create_file(dir / "file", "defgh");
+    BOOST_TEST(wait_for_event(watcher, events, fs::watch_event_kind::modified, dir / "file"));
+
+    events.clear();
+    fs::remove(dir / "file");
+    BOOST_TEST(wait_for_event(watcher, events, fs::watch_event_kind::removed, dir / "file"));
+
+    watcher.close();
+    BOOST_TEST(!watcher.is_open());
+    BOOST_TEST(watcher.watched_path().empty());
+}
+
+void test_coalescing(fs::path const& root)
+{
+    const fs::path dir = root / "coalescing";
+    fs::create_directory(dir);
+
+    fs::directory_watcher watcher(dir);
+
+    // A file that is created and removed before the events are read is not reported
+    create_file(dir / "temp", "abc");
+    fs::remove(dir / "temp");
+
+    // Multiple modifications are reported as one event
+    create_file(dir / "file", "abc");
+    for (unsigned int i = 0u; i < 10u; ++i)
+        create_file(dir / "file", std::string(i + 1u, 'x'));
+
+    std::vector< fs::watch_event > events;
+    BOOST_TEST(wait_for_event(watcher, events, fs::watch_event_kind::created, dir / "file"));
+    watcher.read_events(events, 200u);
+
+    BOOST_TEST(!has_event(events, fs::watch_event_kind::created, dir / "temp"));
+    BOOST_TEST(!has_event(events, fs::watch_event_kind::removed, dir / "temp"));
+
+    std::size_t count = 0u;
+    for (std::size_t i = 0u; i < events.size(); ++i)
+    {
+        if (events[i].target == dir / "file")
+            ++count;
+    }
+    BOOST_TEST_LE(count, 2u);
+}
+
+void test_recursive(fs::path const& root)
+{
+    const fs::path dir = root / "recursive";
+    fs::create_directories(dir / "sub");
+
+    fs::directory_watcher watcher(dir, fs::watch_options::recursive);
+
+    std::vector< fs::watch_event > events;
+    create_file(dir / "sub" / "file", "abc");
+    BOOST_TEST(wait_for_event(watcher, events, fs::watch_event_kind::created, dir / "sub" / "file"));
+
+    // Directories created after the watcher was open are also watched
+    events.clear();
+    fs::create_directory(dir / "new");
+    BOOST_TEST(wait_for_event(watcher, events, fs::watch_event_kind::created, dir / "new"));
+    watcher.read_events(events, 100u);
+
+    events.clear();
+    create_file(dir / "new" / "file", "abc");
+    BOOST_TEST(wait_for_event(watcher, events, fs::watch_event_kind::created, dir / "new" / "file"));
+}
+
+void test_rename(fs::path const& root)
+{
+    const fs::path dir = root / "rename";
+    fs::create_directory(dir);
+    create_file(dir / "old", "abc");
+
+    fs::directory_watcher watcher(dir);
+
+    fs::rename(dir / "old", dir / "new");
+
+    std::vector< fs::watch_event > events;
+    watcher.read_events(events, 2000u);
+    watcher.read_events(events, 100u);
+
+#if defined(linux) || defined(__linux) || defined(__linux__) || defined(BOOST_WINDOWS_API)
+    BOOST_TEST(has_event(events, fs::watch_event_kind::renamed, dir / "new"));
+    for (std::size_t i = 0u; i < events.size(); ++i)
+    {
+        if (events[i].kind == fs::watch_event_kind::renamed)
+            BOOST_TEST(events[i].source == dir / "old");
+    }
+#else
+    BOOST_TEST(has_event(events, fs::watch_event_kind::created, dir / "new"));
+    BOOST_TEST(has_event(events, fs::watch_event_kind::removed, dir / "old"));
+#endif
+}
+
+void test_overflow(fs::path const& root)
+{
+    const fs::path dir = root / "overflow";
+    fs::create_directory(dir);
+
+    fs::directory_watcher watcher(dir, fs::watch_options::none, 4u);
+
+    for (unsigned int i = 0u; i < 10u; ++i)
+        create_file(dir / (std::string("file") + static_cast< char >('0' + i)), "abc");
+
+    std::vector< fs::watch_event > events;
+    BOOST_TEST(wait_for_event(watcher, events, fs::watch_event_kind::overflow, fs::path()));
+    BOOST_TEST_LE(events.size(), 4u);
+}
+
+void test_interrupt(fs::path const& root)
+{
+    const fs::path dir = root / "interrupt";
+    fs::create_directory(dir);
+
+    fs::directory_watcher watcher(dir);
+    watcher.interrupt();
+
+    // The watcher returns without waiting for the whole timeout
+    std::vector< fs::watch_event > events;
+    BOOST_TEST_EQ(watcher.read_events(events, 60000u), 0u);
+}
+
+void test_errors(fs::path const& root)
+{
+    boost::system::error_code ec;
+    fs::directory_watcher watcher(root / "missing", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(!watcher.is_open());
+
+    BOOST_TEST_THROWS(watcher.open(root / "missing"), fs::filesystem_error);
+
+    std::vector< fs::watch_event > events;
+    watcher.read_events(events, 0u, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST_THROWS(watcher.read_events(events, 0u), fs::filesystem_error);
+}
+
+} // namespace
+
+int main()
+{
+    temp_test_directory temp_dir("directory_watcher_test");
+    const fs::path& root = temp_dir.path();
+
+    test_basic_events(root);
+    test_coalescing(root);
+    test_recursive(root);
+    test_rename(root);
+    test_overflow(root);
+    test_interrupt(root);
+    test_errors(root);
+
+    return boost::report_errors();
+}
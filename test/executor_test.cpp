@@ -0,0 +1,306 @@
+//  executor_test.cpp  -----------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/executor.hpp>
+#include <boost/filesystem/parallel_walk.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#if defined(BOOST_FILESYSTEM_HAS_PARALLEL_WALK) && !defined(BOOST_NO_CXX11_HDR_THREAD) && !defined(BOOST_NO_CXX11_HDR_MUTEX)
+
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/system/error_code.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+//! Executor that starts a thread for every task and counts the tasks
+class counting_executor :
+    public fs::executor
+{
+private:
+    const unsigned int m_concurrency;
+    std::mutex m_mutex;
+    std::vector< std::thread > m_threads;
+
+public:
+    std::atomic< unsigned int > posted;
+
+    explicit counting_executor(unsigned int concurrency) : m_concurrency(concurrency), posted(0u) {}
+
+    ~counting_executor()
+    {
+        for (std::size_t i = 0u, n = m_threads.size(); i < n; ++i)
+            m_threads[i].join();
+    }
+
+    unsigned int concurrency() const BOOST_NOEXCEPT BOOST_OVERRIDE { return m_concurrency; }
+
+    bool post(task_function* fn, void* context) BOOST_NOEXCEPT BOOST_OVERRIDE
+    {
+        ++posted;
+        std::lock_guard< std::mutex > lock(m_mutex);
+        m_threads.push_back(std::thread(fn, context));
+        return true;
+    }
+};
+
+//! Executor that refuses to run tasks
+class rejecting_executor :
+    public fs::executor
+{
+public:
+    std::atomic< unsigned int > posted;
+
+    rejecting_executor() : posted(0u) {}
+
+    unsigned int concurrency() const BOOST_NOEXCEPT BOOST_OVERRIDE { return 4u; }
+
+    bool post(task_function*, void*) BOOST_NOEXCEPT BOOST_OVERRIDE
+    {
+        ++posted;
+        return false;
+    }
+};
+
+//! Executor that accepts tasks but runs them only when asked to
+class deferred_executor :
+    public fs::executor
+{
+private:
+    std::mutex m_mutex;
+    std::vector< std::pair< task_function*, void* > > m_tasks;
+
+public:
+    unsigned int concurrency() const BOOST_NOEXCEPT BOOST_OVERRIDE { return 4u; }
+
+    bool post(task_function* fn, void* context) BOOST_NOEXCEPT BOOST_OVERRIDE
+    {
+        std::lock_guard< std::mutex > lock(m_mutex);
+        m_tasks.push_back(std::make_pair(fn, context));
+        return true;
+    }
+
+    std::size_t run_pending()
+    {
+        std::vector< std::pair< task_function*, void* > > tasks;
+        {
+            std::lock_guard< std::mutex > lock(m_mutex);
+            tasks.swap(m_tasks);
+        }
+
+        for (std::size_t i = 0u; i < tasks.size(); ++i)
+            tasks[i].first(tasks[i].second);
+
+        return tasks.size();
+    }
+};
+
+struct collector
+{
+    std::mutex* mutex;
+    std::vector< fs::path >* paths;
+
+    void operator()(std::vector< fs::directory_entry >& batch) const
+    {
+        std::lock_guard< std::mutex > lock(*mutex);
+        for (std::size_t i = 0u; i < batch.size(); ++i)
+            paths->push_back(batch[i].path());
+    }
+};
+
+void create_tree(fs::path const& root)
+{
+    fs::create_directories(root);
+    for (unsigned int i = 0u; i < 4u; ++i)
+    {
+        fs::path dir = root / ("dir" + std::to_string(i));
+        fs::create_directory(dir);
+        for (unsigned int j = 0u; j < 3u; ++j)
+        {
+            fs::path subdir = dir / ("sub" + std::to_string(j));
+            fs::create_directory(subdir);
+            for (unsigned int k = 0u; k < 5u; ++k)
+                create_file(subdir / ("file" + std::to_string(k)));
+        }
+    }
+}
+
+std::vector< fs::path > list_tree(fs::path const& root)
+{
+    std::vector< fs::path > paths;
+    for (fs::recursive_directory_iterator it(root), end; it != end; ++it)
+        paths.push_back(it->path().lexically_relative(root));
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+std::vector< fs::path > walk(fs::path const& root, unsigned int thread_count, fs::executor* ex)
+{
+    std::mutex mutex;
+    std::vector< fs::path > paths;
+    collector c = { &mutex, &paths };
+
+    fs::parallel_directory_walker walker(thread_count);
+    BOOST_TEST(walker.get_executor() == NULL);
+    walker.set_executor(ex);
+    BOOST_TEST(walker.get_executor() == ex);
+
+    boost::system::error_code ec;
+    walker.walk(root, c, ec);
+    BOOST_TEST(!ec);
+
+    for (std::size_t i = 0u; i < paths.size(); ++i)
+        paths[i] = paths[i].lexically_relative(root);
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+void test_default_executor()
+{
+    fs::executor* def = fs::get_executor();
+    BOOST_TEST(def != NULL);
+    BOOST_TEST_GE(def->concurrency(), 1u);
+
+    // Setting NULL restores the default executor
+    BOOST_TEST(fs::set_executor(NULL) == def);
+    BOOST_TEST(fs::get_executor() == def);
+}
+
+void test_global_executor(fs::path const& root, std::vector< fs::path > const& expected)
+{
+    fs::executor* def = fs::get_executor();
+    counting_executor ex(3u);
+    BOOST_TEST(fs::set_executor(&ex) == def);
+    BOOST_TEST(fs::get_executor() == &ex);
+
+    // The number of threads defaults to the concurrency of the executor
+    BOOST_TEST(walk(root, 0u, NULL) == expected);
+    BOOST_TEST_EQ(ex.posted.load(), 2u);
+
+    const fs::path target = root.parent_path() / "copy";
+    boost::system::error_code ec;
+    fs::parallel_copy(root, target, fs::copy_options::none, 4u, ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST(list_tree(target) == expected);
+    BOOST_TEST_EQ(ex.posted.load(), 5u);
+
+    const boost::uintmax_t removed = fs::parallel_remove_all(target, 0u, ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST_EQ(removed, static_cast< boost::uintmax_t >(expected.size() + 1u));
+    BOOST_TEST(!fs::exists(target));
+
+    BOOST_TEST(fs::set_executor(NULL) == &ex);
+    BOOST_TEST(fs::get_executor() == def);
+}
+
+void test_walker_executor(fs::path const& root, std::vector< fs::path > const& expected)
+{
+    // The tasks that could not be posted are run by the calling thread
+    {
+        rejecting_executor ex;
+        BOOST_TEST(walk(root, 0u, &ex) == expected);
+        BOOST_TEST_EQ(ex.posted.load(), 3u);
+        BOOST_TEST(fs::get_executor() != &ex);
+    }
+
+    // The tasks that were not started in time are run by the calling thread, and the late tasks do nothing
+    {
+        deferred_executor ex;
+        BOOST_TEST(walk(root, 4u, &ex) == expected);
+        BOOST_TEST_EQ(ex.run_pending(), 3u);
+    }
+
+    // A custom executor with fewer threads than the number of workers
+    {
+        counting_executor ex(1u);
+        BOOST_TEST(walk(root, 8u, &ex) == expected);
+        BOOST_TEST_EQ(ex.posted.load(), 7u);
+    }
+}
+
+void test_thread_pool_executor(fs::path const& root, std::vector< fs::path > const& expected)
+{
+    fs::thread_pool_executor pool(2u);
+    BOOST_TEST_EQ(pool.concurrency(), 2u);
+
+    BOOST_TEST(walk(root, 0u, &pool) == expected);
+    BOOST_TEST(walk(root, 8u, &pool) == expected);
+
+    fs::set_executor(&pool);
+    const fs::path target = root.parent_path() / "pool-copy";
+    boost::system::error_code ec;
+    fs::parallel_copy(root, target, fs::copy_options::none, 0u, ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST(list_tree(target) == expected);
+    fs::set_executor(NULL);
+
+    fs::remove_all(target);
+
+    // Multiple operations can share the pool concurrently
+    std::vector< fs::path > result1, result2;
+    std::thread t([&]() { result1 = walk(root, 4u, &pool); });
+    result2 = walk(root, 4u, &pool);
+    t.join();
+    BOOST_TEST(result1 == expected);
+    BOOST_TEST(result2 == expected);
+
+    // The default number of threads is the number of hardware threads
+    fs::thread_pool_executor hw_pool;
+    BOOST_TEST_GE(hw_pool.concurrency(), 1u);
+}
+
+} // namespace
+
+int main()
+{
+    temp_test_directory temp_dir("executor_test");
+    const fs::path root = temp_dir.path() / "tree";
+    create_tree(root);
+
+    try
+    {
+        const std::vector< fs::path > expected = list_tree(root);
+        BOOST_TEST_EQ(expected.size(), 4u * (1u + 3u * (1u + 5u)));
+
+        test_default_executor();
+        test_global_executor(root, expected);
+        test_walker_executor(root, expected);
+        test_thread_pool_executor(root, expected);
+    }
+    catch (...)
+    {
+        fs::set_executor(NULL);
+        throw;
+    }
+
+    return boost::report_errors();
+}
+
+#else // defined(BOOST_FILESYSTEM_HAS_PARALLEL_WALK) && !defined(BOOST_NO_CXX11_HDR_THREAD) && !defined(BOOST_NO_CXX11_HDR_MUTEX)
+
+int main()
+{
+    return 0;
+}
+
+#endif // defined(BOOST_FILESYSTEM_HAS_PARALLEL_WALK) && !defined(BOOST_NO_CXX11_HDR_THREAD) && !defined(BOOST_NO_CXX11_HDR_MUTEX)
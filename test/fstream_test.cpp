@@ -126,6 +126,43 @@ void test(const fs::path& p)
         tfs.open(p, std::ios_base::in | std::ios_base::out);
         BOOST_TEST(tfs.is_open());
     }
+    {
+        std::cout << " in test 16\n";
+        fs::ofstream tfs(p, std::ios_base::out | std::ios_base::binary, 65536u, fs::stream_options::sequential);
+        BOOST_TEST(tfs.is_open());
+#if defined(BOOST_FILESYSTEM_HAS_STREAM_NATIVE_HANDLE)
+        BOOST_TEST(tfs.native_handle() != fs::ofstream::native_handle_type(-1));
+#endif
+        for (unsigned int i = 0u; i < 10000u; ++i)
+            tfs << "0123456789";
+        tfs.close();
+        BOOST_TEST_EQ(fs::file_size(p), 100000u);
+    }
+    {
+        std::cout << " in test 17\n";
+        fs::ifstream tfs;
+        tfs.open(p, std::ios_base::in | std::ios_base::binary, 4096u, fs::stream_options::sequential | fs::stream_options::will_need | fs::stream_options::no_access_time);
+        BOOST_TEST(tfs.is_open());
+        std::string line;
+        std::getline(tfs, line);
+        BOOST_TEST_EQ(line.size(), 100000u);
+        BOOST_TEST_EQ(line.substr(0u, 10u), "0123456789");
+    }
+    {
+        std::cout << " in test 18\n";
+        fs::filebuf fb;
+        BOOST_TEST(fb.open(p, std::ios_base::in, 1024u, fs::stream_options::random) != NULL);
+        BOOST_TEST(fb.is_open());
+        BOOST_TEST_EQ(fb.sgetc(), '0');
+        fs::fstream tfs(p, std::ios_base::in | std::ios_base::out, 1024u);
+        BOOST_TEST(tfs.is_open());
+    }
+    {
+        std::cout << " in test 19\n";
+        fs::ifstream tfs(p / p.filename(), std::ios_base::in, 4096u); // should fail
+        BOOST_TEST(!tfs.is_open());
+        BOOST_TEST(tfs.fail());
+    }
 
     if (cleanup)
         fs::remove(p);
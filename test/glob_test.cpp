@@ -0,0 +1,243 @@
+//  glob_test.cpp  ---------------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/glob.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <boost/system/error_code.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+void create_tree(fs::path const& root)
+{
+    fs::create_directories(root / "src" / "sub");
+    fs::create_directory(root / "doc");
+    fs::create_directory(root / ".git");
+    create_file(root / "a.cpp");
+    create_file(root / "b.hpp");
+    create_file(root / ".hidden.cpp");
+    create_file(root / "src" / "c.cpp");
+    create_file(root / "src" / "d.txt");
+    create_file(root / "src" / "sub" / "e.cpp");
+    create_file(root / "doc" / "f.cpp");
+    create_file(root / ".git" / "g.cpp");
+}
+
+std::vector< fs::path > iterate(fs::path const& root, fs::glob_pattern const& pattern)
+{
+    std::vector< fs::path > result;
+    for (fs::recursive_directory_iterator it(root, pattern), end; it != end; ++it)
+        result.push_back(it->path().lexically_relative(root));
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void test_match()
+{
+    fs::glob_pattern empty;
+    BOOST_TEST(empty.empty());
+    BOOST_TEST(!empty.match("a"));
+
+    fs::glob_pattern pattern("*.cpp");
+    BOOST_TEST(!pattern.empty());
+    BOOST_TEST(pattern.pattern() == fs::path("*.cpp"));
+    BOOST_TEST(pattern.base().empty());
+    BOOST_TEST(pattern.match("a.cpp"));
+    BOOST_TEST(!pattern.match(".cpp"));
+    BOOST_TEST(!pattern.match(".hidden.cpp"));
+    BOOST_TEST(!pattern.match("a.hpp"));
+    BOOST_TEST(!pattern.match(fs::path("dir") / "a.cpp"));
+
+    pattern = fs::glob_pattern("**/*.cpp");
+    BOOST_TEST(pattern.match("a.cpp"));
+    BOOST_TEST(pattern.match(fs::path("x") / "y" / "a.cpp"));
+    BOOST_TEST(!pattern.match(fs::path(".git") / "a.cpp"));
+    BOOST_TEST(!pattern.match(fs::path("x") / "a.txt"));
+
+    pattern = fs::glob_pattern(".*");
+    BOOST_TEST(pattern.match(".hidden"));
+    BOOST_TEST(!pattern.match("visible"));
+
+    pattern = fs::glob_pattern("src/{a,b}.?pp");
+    BOOST_TEST(pattern.base() == fs::path("src"));
+    BOOST_TEST(pattern.match(fs::path("src") / "a.hpp"));
+    BOOST_TEST(pattern.match(fs::path("src") / "b.cpp"));
+    BOOST_TEST(!pattern.match(fs::path("src") / "c.cpp"));
+    BOOST_TEST(!pattern.match(fs::path("src") / "a.pp"));
+
+    // Nested brace sets and brace sets spanning separators
+    pattern = fs::glob_pattern("{a,b{c,d}/x}");
+    BOOST_TEST(pattern.match("a"));
+    BOOST_TEST(pattern.match(fs::path("bc") / "x"));
+    BOOST_TEST(pattern.match(fs::path("bd") / "x"));
+    BOOST_TEST(!pattern.match("bc"));
+
+    // Braces without commas are not expanded
+    pattern = fs::glob_pattern("{a}");
+    BOOST_TEST(pattern.match("{a}"));
+    BOOST_TEST(!pattern.match("a"));
+
+    pattern = fs::glob_pattern("[a-c]x");
+    BOOST_TEST(pattern.match("bx"));
+    BOOST_TEST(!pattern.match("dx"));
+
+    pattern = fs::glob_pattern("[!a-c]x");
+    BOOST_TEST(!pattern.match("bx"));
+    BOOST_TEST(pattern.match("dx"));
+
+    pattern = fs::glob_pattern("[]]x[");
+    BOOST_TEST(pattern.match("]x["));
+
+    pattern = fs::glob_pattern("a*b*c");
+    BOOST_TEST(pattern.match("abc"));
+    BOOST_TEST(pattern.match("aXbYbZc"));
+    BOOST_TEST(!pattern.match("aXbYcZ"));
+
+#if defined(BOOST_POSIX_API)
+    pattern = fs::glob_pattern("\\*.cpp");
+    BOOST_TEST(pattern.match("*.cpp"));
+    BOOST_TEST(!pattern.match("a.cpp"));
+
+    pattern = fs::glob_pattern("/usr/include/*.h");
+    BOOST_TEST(pattern.base() == fs::path("/usr/include"));
+    BOOST_TEST(pattern.match(fs::path("usr") / "include" / "stdio.h"));
+#endif
+}
+
+void test_iterator(fs::path const& root)
+{
+    std::vector< fs::path > result = iterate(root, fs::glob_pattern("**/*.cpp"));
+    BOOST_TEST_EQ(result.size(), 4u);
+    if (result.size() == 4u)
+    {
+        BOOST_TEST(result[0] == fs::path("a.cpp"));
+        BOOST_TEST(result[1] == fs::path("doc") / "f.cpp");
+        BOOST_TEST(result[2] == fs::path("src") / "c.cpp");
+        BOOST_TEST(result[3] == fs::path("src") / "sub" / "e.cpp");
+    }
+
+    result = iterate(root, fs::glob_pattern("src/*"));
+    BOOST_TEST_EQ(result.size(), 3u);
+    if (result.size() == 3u)
+    {
+        BOOST_TEST(result[0] == fs::path("src") / "c.cpp");
+        BOOST_TEST(result[1] == fs::path("src") / "d.txt");
+        BOOST_TEST(result[2] == fs::path("src") / "sub");
+    }
+
+    // The directories on the way to the matching entries are not produced, but the depth reflects their nesting
+    fs::recursive_directory_iterator it(root, fs::glob_pattern("src/sub/*.cpp"));
+    BOOST_TEST(it != fs::recursive_directory_iterator());
+    if (it != fs::recursive_directory_iterator())
+    {
+        BOOST_TEST(it->path() == root / "src" / "sub" / "e.cpp");
+        BOOST_TEST_EQ(it.depth(), 2);
+        ++it;
+        BOOST_TEST(it == fs::recursive_directory_iterator());
+    }
+
+    result = iterate(root, fs::glob_pattern("{src,doc}/**/*.cpp"));
+    BOOST_TEST_EQ(result.size(), 3u);
+
+    result = iterate(root, fs::glob_pattern(".*/*.cpp"));
+    BOOST_TEST_EQ(result.size(), 1u);
+    if (result.size() == 1u)
+        BOOST_TEST(result[0] == fs::path(".git") / "g.cpp");
+
+    BOOST_TEST(iterate(root, fs::glob_pattern("missing/*")).empty());
+    BOOST_TEST(iterate(root, fs::glob_pattern()).empty());
+
+    boost::system::error_code ec;
+    fs::recursive_directory_iterator missing(root / "missing", fs::glob_pattern("*"), fs::directory_options::none, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(missing == fs::recursive_directory_iterator());
+}
+
+void test_glob(fs::path const& root)
+{
+    std::vector< fs::path > result = fs::glob(root / "**" / "*.cpp");
+    BOOST_TEST_EQ(result.size(), 4u);
+    if (result.size() == 4u)
+    {
+        BOOST_TEST(result[0] == root / "a.cpp");
+        BOOST_TEST(result[1] == root / "doc" / "f.cpp");
+    }
+
+    result = fs::glob(root / "src" / "*.{cpp,txt}");
+    BOOST_TEST_EQ(result.size(), 2u);
+    if (result.size() == 2u)
+    {
+        BOOST_TEST(result[0] == root / "src" / "c.cpp");
+        BOOST_TEST(result[1] == root / "src" / "d.txt");
+    }
+
+    // Patterns without wildcards match the existing paths
+    result = fs::glob(root / "src" / "c.cpp");
+    BOOST_TEST_EQ(result.size(), 1u);
+    BOOST_TEST(fs::glob(root / "src" / "missing.cpp").empty());
+
+    // Missing base directories are not errors
+    boost::system::error_code ec;
+    result = fs::glob(root / "missing" / "*.cpp", fs::directory_options::none, ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST(result.empty());
+
+    // Relative patterns produce relative paths
+    const fs::path original_path = fs::current_path();
+    fs::current_path(root);
+    try
+    {
+        result = fs::glob("src/*.cpp");
+        BOOST_TEST_EQ(result.size(), 1u);
+        if (result.size() == 1u)
+            BOOST_TEST(result[0] == fs::path("src") / "c.cpp");
+
+        result = fs::glob("*.?pp");
+        BOOST_TEST_EQ(result.size(), 2u);
+        if (result.size() == 2u)
+        {
+            BOOST_TEST(result[0] == fs::path("a.cpp"));
+            BOOST_TEST(result[1] == fs::path("b.hpp"));
+        }
+    }
+    catch (...)
+    {
+        fs::current_path(original_path);
+        throw;
+    }
+    fs::current_path(original_path);
+}
+
+} // namespace
+
+int main()
+{
+    temp_test_directory temp_dir("glob_test");
+    const fs::path& root = temp_dir.path();
+
+    create_tree(root);
+    test_match();
+    test_iterator(root);
+    test_glob(root);
+
+    return boost::report_errors();
+}
@@ -0,0 +1,217 @@
+//  ignore_rules_test.cpp  -------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/ignore_rules.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <boost/system/error_code.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+void create_tree(fs::path const& root)
+{
+    fs::create_directories(root / "src" / "build");
+    fs::create_directories(root / "build");
+    fs::create_directories(root / "doc" / "html");
+    create_file(root / "a.cpp");
+    create_file(root / "a.o");
+    create_file(root / "keep.o");
+    create_file(root / "src" / "b.cpp");
+    create_file(root / "src" / "b.o");
+    create_file(root / "src" / "gen.cpp");
+    create_file(root / "src" / "build" / "c.o");
+    create_file(root / "build" / "d.txt");
+    create_file(root / "doc" / "index.txt");
+    create_file(root / "doc" / "html" / "index.html");
+    create_file(root / ".gitignore", "# Build artifacts\n*.o\n!keep.o\n/build/\n\ndoc/html/**\n");
+    create_file(root / "src" / ".gitignore", "gen.cpp\r\n!*.o\n");
+}
+
+std::vector< fs::path > iterate(fs::path const& root, fs::ignore_rules const& rules)
+{
+    std::vector< fs::path > result;
+    for (fs::recursive_directory_iterator it(root, rules), end; it != end; ++it)
+        result.push_back(it->path().lexically_relative(root));
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void test_match()
+{
+    fs::ignore_rules empty;
+    BOOST_TEST(empty.empty());
+    BOOST_TEST_EQ(empty.size(), 0u);
+    BOOST_TEST(!empty.is_ignored("a"));
+
+    fs::ignore_rules rules;
+    rules.add("# comment");
+    rules.add("");
+    rules.add("   ");
+    BOOST_TEST_EQ(rules.size(), 0u);
+
+    // Unanchored rules match names at any depth, including hidden names
+    rules.add("*.o");
+    BOOST_TEST_EQ(rules.size(), 1u);
+    BOOST_TEST(rules.is_ignored("a.o"));
+    BOOST_TEST(rules.is_ignored(".o"));
+    BOOST_TEST(rules.is_ignored(fs::path("x") / "y" / "a.o"));
+    BOOST_TEST(!rules.is_ignored("a.cpp"));
+    BOOST_TEST(!rules.is_ignored("a.oo"));
+
+    // Later rules win
+    rules.add("!keep.o");
+    BOOST_TEST(!rules.is_ignored("keep.o"));
+    BOOST_TEST(!rules.is_ignored(fs::path("x") / "keep.o"));
+    BOOST_TEST(rules.is_ignored("other.o"));
+
+    // Directory-only rules
+    rules.add("tmp/");
+    BOOST_TEST(rules.is_ignored("tmp", true));
+    BOOST_TEST(!rules.is_ignored("tmp", false));
+    BOOST_TEST(rules.is_ignored(fs::path("x") / "tmp", true));
+    BOOST_TEST(rules.is_ignored(fs::path("tmp") / "file"));
+
+    // Anchored rules
+    rules.add("/build");
+    rules.add("doc/*.txt");
+    BOOST_TEST(rules.is_ignored("build"));
+    BOOST_TEST(rules.is_ignored(fs::path("build") / "file"));
+    BOOST_TEST(!rules.is_ignored(fs::path("src") / "build"));
+    BOOST_TEST(rules.is_ignored(fs::path("doc") / "a.txt"));
+    BOOST_TEST(!rules.is_ignored(fs::path("x") / "doc" / "a.txt"));
+    BOOST_TEST(!rules.is_ignored(fs::path("doc") / "x" / "a.txt"));
+
+    // Globstars
+    rules.add("logs/**/*.log");
+    BOOST_TEST(rules.is_ignored(fs::path("logs") / "a.log"));
+    BOOST_TEST(rules.is_ignored(fs::path("logs") / "x" / "y" / "a.log"));
+    BOOST_TEST(!rules.is_ignored(fs::path("x") / "logs" / "a.log"));
+
+    rules.add("**/cache");
+    BOOST_TEST(rules.is_ignored("cache"));
+    BOOST_TEST(rules.is_ignored(fs::path("x") / "y" / "cache"));
+
+    rules.add("out/**");
+    BOOST_TEST(!rules.is_ignored("out", true));
+    BOOST_TEST(rules.is_ignored(fs::path("out") / "file"));
+    BOOST_TEST(rules.is_ignored(fs::path("out") / "x" / "file"));
+
+    // Escapes and trailing spaces
+    rules.add("\\#hash");
+    rules.add("\\!bang");
+    rules.add("space\\ ");
+    rules.add("trailing   ");
+    BOOST_TEST(rules.is_ignored("#hash"));
+    BOOST_TEST(rules.is_ignored("!bang"));
+    BOOST_TEST(rules.is_ignored("space "));
+    BOOST_TEST(rules.is_ignored("trailing"));
+    BOOST_TEST(!rules.is_ignored("trailing   "));
+
+    rules.add("[a-c]x?");
+    BOOST_TEST(rules.is_ignored("bxy"));
+    BOOST_TEST(!rules.is_ignored("dxy"));
+    BOOST_TEST(!rules.is_ignored("bx"));
+
+    // Files in excluded directories cannot be re-included
+    fs::ignore_rules nested;
+    nested.add("dir/");
+    nested.add("!dir/file");
+    BOOST_TEST(nested.is_ignored(fs::path("dir") / "file"));
+
+    // Modifying a copy does not affect the original
+    fs::ignore_rules copy(nested);
+    copy.add("other");
+    BOOST_TEST_EQ(copy.size(), 3u);
+    BOOST_TEST_EQ(nested.size(), 2u);
+    BOOST_TEST(copy.is_ignored("other"));
+    BOOST_TEST(!nested.is_ignored("other"));
+}
+
+void test_iterator(fs::path const& root)
+{
+    fs::ignore_rules rules;
+
+    // No rules, all entries are produced
+    std::vector< fs::path > result = iterate(root, rules);
+    BOOST_TEST_EQ(result.size(), 17u);
+
+    rules.add_rule_file_name(".gitignore");
+    BOOST_TEST(!rules.empty());
+    BOOST_TEST_EQ(rules.size(), 0u);
+    result = iterate(root, rules);
+
+    std::vector< fs::path > expected;
+    expected.push_back(".gitignore");
+    expected.push_back("a.cpp");
+    expected.push_back("doc");
+    expected.push_back(fs::path("doc") / "html");
+    expected.push_back(fs::path("doc") / "index.txt");
+    expected.push_back("keep.o");
+    expected.push_back("src");
+    expected.push_back(fs::path("src") / ".gitignore");
+    expected.push_back(fs::path("src") / "b.cpp");
+    expected.push_back(fs::path("src") / "b.o");
+    expected.push_back(fs::path("src") / "build");
+    expected.push_back(fs::path("src") / "build" / "c.o");
+    std::sort(expected.begin(), expected.end());
+    BOOST_TEST_ALL_EQ(result.begin(), result.end(), expected.begin(), expected.end());
+
+    // User-specified rules have lower precedence than rule files
+    rules.add("*.cpp");
+    rules.add("!*.o");
+    result = iterate(root, rules);
+    BOOST_TEST(std::find(result.begin(), result.end(), fs::path("a.cpp")) == result.end());
+    BOOST_TEST(std::find(result.begin(), result.end(), fs::path("a.o")) == result.end());
+    BOOST_TEST(std::find(result.begin(), result.end(), fs::path("src") / "b.cpp") == result.end());
+
+    // Rule files loaded explicitly apply to the iterated directory
+    fs::ignore_rules file_rules;
+    file_rules.add_file(root / ".gitignore");
+    BOOST_TEST_EQ(file_rules.size(), 4u);
+    result = iterate(root, file_rules);
+    BOOST_TEST(std::find(result.begin(), result.end(), fs::path("build")) == result.end());
+    BOOST_TEST(std::find(result.begin(), result.end(), fs::path("src") / "b.o") == result.end());
+    BOOST_TEST(std::find(result.begin(), result.end(), fs::path("src") / "build") != result.end());
+
+    boost::system::error_code ec;
+    file_rules.add_file(root / "missing", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST_THROWS(file_rules.add_file(root / "missing"), fs::filesystem_error);
+
+    fs::recursive_directory_iterator missing(root / "missing", rules, fs::directory_options::none, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(missing == fs::recursive_directory_iterator());
+}
+
+} // namespace
+
+int main()
+{
+    temp_test_directory temp_dir("ignore_rules_test");
+    const fs::path& root = temp_dir.path();
+
+    create_tree(root);
+    test_match();
+    test_iterator(root);
+
+    return boost::report_errors();
+}
@@ -0,0 +1,120 @@
+//  instrumentation_test.cpp  ----------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/instrumentation.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <boost/cstdint.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+boost::uint64_t histogram_sum(fs::instrumentation_counters const& counters)
+{
+    boost::uint64_t sum = 0u;
+    for (std::size_t i = 0u; i < fs::instrumentation_histogram_size; ++i)
+        sum += counters.histogram[i];
+    return sum;
+}
+
+boost::uint64_t stat_calls(fs::instrumentation_snapshot const& snapshot)
+{
+    return snapshot[fs::instrumented_operation::stat].calls + snapshot[fs::instrumented_operation::statx].calls;
+}
+
+void test_names()
+{
+    for (unsigned int i = 0u; i < fs::instrumented_operation::count; ++i)
+    {
+        const char* name = fs::get_instrumented_operation_name(i);
+        BOOST_TEST(name != NULL);
+        if (name)
+            BOOST_TEST(std::strlen(name) > 0u);
+    }
+
+    BOOST_TEST(fs::get_instrumented_operation_name(fs::instrumented_operation::count) == NULL);
+    BOOST_TEST_EQ(std::strcmp(fs::get_instrumented_operation_name(fs::instrumented_operation::statx), "statx"), 0);
+
+    BOOST_TEST_EQ(fs::instrumentation_histogram_bound(0u), 1000u);
+    BOOST_TEST_EQ(fs::instrumentation_histogram_bound(1u), 4000u);
+    BOOST_TEST_EQ(fs::instrumentation_histogram_bound(fs::instrumentation_histogram_size - 1u), ~static_cast< boost::uint64_t >(0u));
+}
+
+void test_counters(fs::path const& root)
+{
+    fs::create_directory(root / "dir");
+    {
+        fs::ofstream file(root / "dir" / "file", std::ios_base::out | std::ios_base::binary);
+        file << "abc";
+    }
+
+    fs::reset_instrumentation();
+    fs::instrumentation_snapshot snapshot;
+    fs::get_instrumentation_snapshot(snapshot);
+    for (unsigned int i = 0u; i < fs::instrumented_operation::count; ++i)
+    {
+        BOOST_TEST_EQ(snapshot.operations[i].calls, 0u);
+        BOOST_TEST_EQ(histogram_sum(snapshot.operations[i]), 0u);
+    }
+
+    for (unsigned int i = 0u; i < 10u; ++i)
+        fs::status(root / "dir" / "file");
+    for (fs::directory_iterator it(root / "dir"), end; it != end; ++it)
+        it->status();
+    fs::copy_file(root / "dir" / "file", root / "copy");
+    fs::remove_all(root / "dir");
+
+    fs::get_instrumentation_snapshot(snapshot);
+    if (fs::instrumentation_enabled())
+    {
+        BOOST_TEST_GE(stat_calls(snapshot), 10u);
+        BOOST_TEST_GE(snapshot[fs::instrumented_operation::open_directory].calls, 1u);
+        BOOST_TEST_GE(snapshot[fs::instrumented_operation::unlink].calls, 2u);
+#if defined(BOOST_POSIX_API)
+        BOOST_TEST_GE(snapshot[fs::instrumented_operation::getdents].calls + snapshot[fs::instrumented_operation::readdir].calls, 1u);
+        BOOST_TEST_GE(snapshot[fs::instrumented_operation::copy_read_write].calls + snapshot[fs::instrumented_operation::copy_sendfile].calls +
+            snapshot[fs::instrumented_operation::copy_file_range].calls, 1u);
+#endif
+
+        // Events without duration are not included in the histograms
+        for (unsigned int i = 0u; i < fs::instrumented_operation::implementation_fallback; ++i)
+            BOOST_TEST_EQ(histogram_sum(snapshot.operations[i]), snapshot.operations[i].calls);
+
+        fs::reset_instrumentation();
+        fs::get_instrumentation_snapshot(snapshot);
+        BOOST_TEST_EQ(stat_calls(snapshot), 0u);
+    }
+    else
+    {
+        for (unsigned int i = 0u; i < fs::instrumented_operation::count; ++i)
+            BOOST_TEST_EQ(snapshot.operations[i].calls, 0u);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    temp_test_directory temp_dir("instrumentation_test");
+    const fs::path& root = temp_dir.path();
+
+    test_names();
+    test_counters(root);
+
+    return boost::report_errors();
+}
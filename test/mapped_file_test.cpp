@@ -0,0 +1,106 @@
+//  mapped_file_test.cpp  --------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/mapped_file.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#include <cstddef>
+#include <string>
+#include <boost/system/error_code.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+void test_mapping(fs::path const& root)
+{
+    std::string contents;
+    for (unsigned int i = 0u; i < 10000u; ++i)
+        contents += static_cast< char >('a' + i % 26u);
+    const fs::path file = root / "file";
+    create_file(file, contents);
+
+    fs::mapped_file mf;
+    BOOST_TEST(!mf.is_open());
+    BOOST_TEST(mf.empty());
+
+    mf.open(file);
+    BOOST_TEST(mf.is_open());
+    BOOST_TEST_EQ(mf.size(), contents.size());
+    BOOST_TEST(mf.data() != NULL);
+    BOOST_TEST(std::string(mf.begin(), mf.end()) == contents);
+
+    mf.advise(fs::mapped_file_flags::random | fs::mapped_file_flags::will_need);
+    BOOST_TEST(std::string(mf.data(), mf.size()) == contents);
+
+    mf.close();
+    BOOST_TEST(!mf.is_open());
+    BOOST_TEST(mf.data() == NULL);
+
+    fs::mapped_file mf2(file, fs::mapped_file_flags::sequential | fs::mapped_file_flags::populate | fs::mapped_file_flags::huge_pages);
+    BOOST_TEST(std::string(mf2.begin(), mf2.end()) == contents);
+
+    fs::mapped_file mf3;
+    swap(mf2, mf3);
+    BOOST_TEST(!mf2.is_open());
+    BOOST_TEST_EQ(mf3.size(), contents.size());
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    fs::mapped_file mf4(static_cast< fs::mapped_file&& >(mf3));
+    BOOST_TEST(!mf3.is_open());
+    BOOST_TEST(std::string(mf4.begin(), mf4.end()) == contents);
+#endif
+}
+
+void test_empty_file(fs::path const& root)
+{
+    const fs::path file = root / "empty";
+    create_file(file, std::string());
+
+    fs::mapped_file mf(file);
+    BOOST_TEST(mf.is_open());
+    BOOST_TEST(mf.empty());
+    BOOST_TEST(mf.data() == NULL);
+    BOOST_TEST(mf.begin() == mf.end());
+}
+
+void test_errors(fs::path const& root)
+{
+    boost::system::error_code ec;
+    fs::mapped_file mf(root / "missing", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(!mf.is_open());
+
+    BOOST_TEST_THROWS(mf.open(root / "missing"), fs::filesystem_error);
+
+    // Directories cannot be mapped
+    mf.open(root, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(!mf.is_open());
+}
+
+} // namespace
+
+int main()
+{
+    temp_test_directory temp_dir("mapped_file_test");
+    const fs::path& root = temp_dir.path();
+
+    test_mapping(root);
+    test_empty_file(root);
+    test_errors(root);
+
+    return boost::report_errors();
+}
@@ -0,0 +1,131 @@
+//  memory_allocator_test.cpp  ---------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/memory_allocator.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/path_arena.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#include <cstddef>
+#include <string>
+#include <boost/system/error_code.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+fs::memory_allocator const* default_allocator = NULL;
+std::size_t allocation_count = 0u;
+std::size_t deallocation_count = 0u;
+std::size_t allocated_size = 0u;
+
+void* counting_allocate(std::size_t size, std::size_t alignment)
+{
+    void* p = default_allocator->allocate(size, alignment);
+    if (p)
+    {
+        ++allocation_count;
+        allocated_size += size;
+    }
+    return p;
+}
+
+void counting_deallocate(void* p, std::size_t size, std::size_t alignment)
+{
+    ++deallocation_count;
+    allocated_size -= size;
+    default_allocator->deallocate(p, size, alignment);
+}
+
+const fs::memory_allocator counting_allocator = { &counting_allocate, &counting_deallocate };
+
+void test_allocations(fs::path const& root)
+{
+    fs::create_directories(root / "a" / "b" / "c");
+    create_file_of_size(root / "a" / "file", 100u);
+    create_file_of_size(root / "a" / "b" / "file", 200000u);
+
+    fs::set_memory_allocator(&counting_allocator);
+    BOOST_TEST(fs::get_memory_allocator() == &counting_allocator);
+
+    // Directory iterators and the stack of the recursive directory iterator
+    std::size_t count = 0u;
+    for (fs::recursive_directory_iterator it(root), end; it != end; ++it)
+        ++count;
+    BOOST_TEST_EQ(count, 5u);
+    BOOST_TEST_GT(allocation_count, 0u);
+
+    // Copy buffers, unless the data is copied by the kernel
+    fs::copy_file(root / "a" / "b" / "file", root / "copy");
+    BOOST_TEST_EQ(fs::file_size(root / "copy"), 200000u);
+
+    // Paths of the exceptions
+    std::size_t last_count = allocation_count;
+    try
+    {
+        fs::file_size(root / "nonexistent");
+        BOOST_ERROR("file_size did not throw");
+    }
+    catch (fs::filesystem_error& e)
+    {
+        BOOST_TEST_EQ(e.path1(), root / "nonexistent");
+        BOOST_TEST_GT(allocation_count, last_count);
+    }
+
+    // Blocks of path arenas
+    {
+        fs::path_arena arena(256u);
+        last_count = allocation_count;
+        for (unsigned int i = 0u; i < 10u; ++i)
+            BOOST_TEST_EQ(arena.store(fs::path_view("some/rather/long/path/to/store/in/the/arena")), fs::path_view("some/rather/long/path/to/store/in/the/arena"));
+        BOOST_TEST_GT(allocation_count, last_count);
+    }
+
+    // The memory is deallocated with the allocator it was allocated with, the cached memory is released once the library notices the change
+    fs::set_memory_allocator(NULL);
+    BOOST_TEST(fs::get_memory_allocator() != &counting_allocator);
+    last_count = allocation_count;
+    for (fs::directory_iterator it(root), end; it != end; ++it)
+    {
+    }
+    fs::copy_file(root / "a" / "b" / "file", root / "copy2");
+
+    BOOST_TEST_EQ(allocation_count, last_count);
+    BOOST_TEST_EQ(deallocation_count, allocation_count);
+    BOOST_TEST_EQ(allocated_size, 0u);
+}
+
+} // namespace
+
+int main()
+{
+    default_allocator = fs::get_memory_allocator();
+    BOOST_TEST(default_allocator != NULL);
+
+    temp_test_directory temp_dir("memory_allocator_test");
+    const fs::path& root = temp_dir.path();
+
+    try
+    {
+        test_allocations(root);
+    }
+    catch (...)
+    {
+        fs::set_memory_allocator(NULL);
+        throw;
+    }
+
+    return boost::report_errors();
+}
@@ -22,8 +22,11 @@
 #include <boost/filesystem/exception.hpp>
 #include <boost/filesystem/file_status.hpp>
 #include <boost/filesystem/fstream.hpp> // for BOOST_FILESYSTEM_C_STR
+#include <boost/filesystem/backends.hpp>
+#include <boost/filesystem/executor.hpp>
 
 #include <boost/cerrno.hpp>
+#include <boost/cstdint.hpp>
 #include <boost/system/error_code.hpp>
 #include <boost/system/system_error.hpp>
 #include <boost/system/system_category.hpp>
@@ -37,22 +40,28 @@ using boost::system::system_error;
 
 #include <fstream>
 #include <iostream>
+#include <iterator>
 
 using std::cout;
 using std::endl;
 
 #include <string>
+#include <utility>
 #include <vector>
+#include <set>
 #include <algorithm>
 #include <cstring> // for strncmp, etc.
 #include <ctime>
 #include <cstdlib> // for system(), getenv(), etc.
 #ifdef BOOST_POSIX_API
 #include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 #endif
 
 #ifdef BOOST_WINDOWS_API
 #include <windows.h>
+#include <malloc.h> // _aligned_malloc, _aligned_free
 
 inline std::wstring convert(const char* c)
 {
@@ -181,6 +190,56 @@ void verify_file(const fs::path& ph, const std::string& expected)
         throw fs::filesystem_error("operations_test verify_file contents \"" + contents + "\" != \"" + expected + "\"", ph, error_code());
 }
 
+unsigned int copy_buffer_allocations = 0u;
+unsigned int copy_buffer_deallocations = 0u;
+
+void* test_copy_buffer_allocate(std::size_t size, std::size_t alignment)
+{
+    ++copy_buffer_allocations;
+
+    // The buffers may be used for direct I/O, so the allocator must honour the requested alignment
+    BOOST_TEST_NE(alignment, 0u);
+    BOOST_TEST_EQ(alignment & (alignment - 1u), 0u);
+
+    void* buf = NULL;
+#if defined(BOOST_WINDOWS_API)
+    buf = _aligned_malloc(size, alignment);
+#else
+    if (posix_memalign(&buf, alignment < sizeof(void*) ? sizeof(void*) : alignment, size) != 0)
+        buf = NULL;
+#endif
+    BOOST_TEST(buf != NULL);
+    BOOST_TEST_EQ(reinterpret_cast< boost::uintptr_t >(buf) % alignment, 0u);
+    return buf;
+}
+
+void test_copy_buffer_deallocate(void* buf, std::size_t, std::size_t)
+{
+    ++copy_buffer_deallocations;
+#if defined(BOOST_WINDOWS_API)
+    _aligned_free(buf);
+#else
+    std::free(buf);
+#endif
+}
+
+struct copy_progress_state
+{
+    unsigned int calls;
+    boost::uintmax_t bytes_copied;
+    boost::uintmax_t total_bytes;
+    bool cancel;
+};
+
+bool test_copy_progress(const fs::path&, const fs::path&, boost::uintmax_t bytes_copied, boost::uintmax_t total_bytes, void* context)
+{
+    copy_progress_state* state = static_cast< copy_progress_state* >(context);
+    ++state->calls;
+    state->bytes_copied = bytes_copied;
+    state->total_bytes = total_bytes;
+    return !state->cancel;
+}
+
 template< typename F >
 bool throws_fs_error(F func, errno_t en, int line)
 {
@@ -275,6 +334,11 @@ void bad_space()
     fs::space("no-such-path");
 }
 
+void bad_query()
+{
+    fs::query("no-such-path", fs::file_attribute_mask::all);
+}
+
 class renamer
 {
 public:
@@ -420,6 +484,27 @@ void exception_tests()
         BOOST_TEST(ex.path1().string() == " no-way, Jose");
     }
 
+    // exceptions without paths describe the error the same way as system_error
+    {
+        const error_code ec(ENOENT, boost::system::system_category());
+        const system_error sys_ex(ec, "boost::filesystem::test");
+        const fs::filesystem_error ex1("boost::filesystem::test", ec);
+        BOOST_TEST(ex1.path1().empty());
+        BOOST_TEST(ex1.path2().empty());
+        BOOST_TEST_EQ(std::string(ex1.what()), std::string(sys_ex.what()));
+
+        const fs::filesystem_error ex2("boost::filesystem::test", fs::path(), fs::path(), ec);
+        BOOST_TEST(ex2.path1().empty());
+        BOOST_TEST_EQ(std::string(ex2.what()), std::string(sys_ex.what()));
+
+        fs::filesystem_error ex3("boost::filesystem::test", fs::path(), "p2", ec);
+        BOOST_TEST(ex3.path1().empty());
+        BOOST_TEST_EQ(ex3.path2().string(), std::string("p2"));
+        ex3 = ex1;
+        BOOST_TEST(ex3.path2().empty());
+        BOOST_TEST_EQ(std::string(ex3.what()), std::string(sys_ex.what()));
+    }
+
     cout << "  exception_tests complete" << endl;
 }
 
@@ -456,6 +541,7 @@ void create_tree()
     BOOST_TEST(!fs::is_directory(d1f1));
     BOOST_TEST(fs::is_regular_file(d1f1));
     BOOST_TEST(fs::is_empty(d1f1));
+    BOOST_TEST(!fs::is_empty(d1));
     BOOST_TEST(fs::file_size(d1f1) == 0);
     BOOST_TEST(fs::hard_link_count(d1f1) == 1);
 
@@ -682,6 +768,26 @@ int walk_tree(bool recursive)
     return d1f1_count;
 }
 
+struct exclude_by_name
+{
+    fs::path name;
+
+    explicit exclude_by_name(fs::path const& n) : name(n) {}
+
+    bool operator()(fs::path_view const& entry_name, fs::file_type) const
+    {
+        return entry_name == fs::path_view(name);
+    }
+};
+
+struct exclude_directories
+{
+    bool operator()(fs::path_view const&, fs::file_type type) const
+    {
+        return type == fs::directory_file;
+    }
+};
+
 void recursive_directory_iterator_tests()
 {
     cout << "recursive_directory_iterator_tests..." << endl;
@@ -707,9 +813,768 @@ void recursive_directory_iterator_tests()
     BOOST_TEST_EQ(d1f1_count, 1);
     BOOST_TEST(it == it2); // verify single pass shallow copy semantics
 
+    //  test exclusion predicates
+    cout << "  with exclusion predicate" << endl;
+    d1f1_count = 0;
+    int f0_count = 0, d1_count = 0;
+    for (fs::recursive_directory_iterator it3(dir, fs::directory_options::none, exclude_by_name("d1"), ec), end; it3 != end; it3.increment(ec))
+    {
+        if (it3->path().filename() == "d1f1")
+            ++d1f1_count;
+        else if (it3->path().filename() == "f0")
+            ++f0_count;
+        else if (it3->path().filename() == "d1")
+            ++d1_count;
+    }
+    BOOST_TEST(!ec);
+    BOOST_TEST_EQ(d1_count, 0);
+    BOOST_TEST_EQ(d1f1_count, 0);
+    BOOST_TEST_EQ(f0_count, 1);
+
+    d1f1_count = 0;
+    for (fs::recursive_directory_iterator it3(dir, fs::directory_options::none, exclude_by_name("f0")), end; it3 != end; ++it3)
+    {
+        BOOST_TEST(it3->path().filename() != "f0");
+        if (it3->path().filename() == "d1f1")
+            ++d1f1_count;
+    }
+    BOOST_TEST_EQ(d1f1_count, 1);
+
+    // Files are never excluded by type when only directories are
+    f0_count = 0;
+    for (fs::recursive_directory_iterator it3(dir, fs::directory_options::none, exclude_directories()), end; it3 != end; ++it3)
+    {
+        if (it3->path().filename() == "f0")
+            ++f0_count;
+    }
+    BOOST_TEST_EQ(f0_count, 1);
+
+    if (create_symlink_ok)
+    {
+        // Directory symlink cycles are detected by the identities of the directories
+        cout << "  with directory cycles" << endl;
+        const fs::path cycle = dir / "cycle";
+        fs::create_directories(cycle / "a");
+        fs::create_directory(cycle / "c");
+        create_file(cycle / "a" / "f", "");
+        fs::create_directory_symlink(cycle, cycle / "a" / "loop");
+        fs::create_directory_symlink(cycle / "a", cycle / "c" / "alias");
+
+        int f_count = 0, loop_count = 0;
+        for (fs::recursive_directory_iterator it3(cycle, fs::directory_options::follow_directory_symlink | fs::directory_options::skip_directory_cycles), end; it3 != end; ++it3)
+        {
+            BOOST_TEST(it3.depth() < 3);
+            if (it3->path().filename() == "f")
+                ++f_count;
+            else if (it3->path().filename() == "loop")
+                ++loop_count;
+        }
+        BOOST_TEST_EQ(f_count, 2); // a/f and c/alias/f
+        BOOST_TEST_EQ(loop_count, 2);
+
+        f_count = 0;
+        int alias_count = 0;
+        for (fs::recursive_directory_iterator it3(cycle, fs::directory_options::follow_directory_symlink | fs::directory_options::skip_visited_directories, ec), end; it3 != end; it3.increment(ec))
+        {
+            BOOST_TEST(it3.depth() < 3);
+            if (it3->path().filename() == "f")
+                ++f_count;
+            else if (it3->path().filename() == "alias")
+                ++alias_count;
+        }
+        BOOST_TEST(!ec);
+        BOOST_TEST_EQ(f_count, 1);
+        BOOST_TEST_EQ(alias_count, 1);
+
+        fs::remove_all(cycle);
+    }
+
     cout << "  recursive_directory_iterator_tests complete" << endl;
 }
 
+//  recursive_directory_iterator_traversal_tests  -------------------------------------//
+
+std::vector< fs::path > walk_paths(fs::path const& root, fs::directory_options opts)
+{
+    std::vector< fs::path > paths;
+    for (fs::recursive_directory_iterator it(root, opts), end; it != end; ++it)
+        paths.push_back(it->path());
+    return paths;
+}
+
+std::vector< fs::path > sorted_paths(std::vector< fs::path > paths)
+{
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+int path_depth(fs::path const& root, fs::path const& p)
+{
+    int depth = -1;
+    for (fs::path::iterator it = p.begin(), end = p.end(); it != end; ++it)
+        ++depth;
+    for (fs::path::iterator it = root.begin(), end = root.end(); it != end; ++it)
+        --depth;
+    return depth;
+}
+
+void recursive_directory_iterator_traversal_tests()
+{
+    cout << "recursive_directory_iterator_traversal_tests..." << endl;
+
+    const fs::path root = dir / "traversal";
+    fs::path level = root;
+    for (unsigned int i = 0u; i < 6u; ++i)
+    {
+        fs::create_directories(level / "sub");
+        create_file(level / "file", "");
+        fs::create_directory(level / "empty");
+        level /= "sub";
+    }
+
+    const std::vector< fs::path > depth_first = walk_paths(root, fs::directory_options::none);
+    BOOST_TEST_EQ(depth_first.size(), 18u);
+
+    // Breadth-first iteration produces all entries with non-decreasing depth
+    std::vector< fs::path > breadth_first;
+    int last_depth = 0;
+    for (fs::recursive_directory_iterator it(root, fs::directory_options::breadth_first), end; it != end; ++it)
+    {
+        BOOST_TEST(it.depth() >= last_depth);
+        BOOST_TEST_EQ(it.depth(), path_depth(root, it->path()));
+        last_depth = it.depth();
+        breadth_first.push_back(it->path());
+    }
+    BOOST_TEST_EQ(last_depth, 5);
+    BOOST_TEST(sorted_paths(breadth_first) == sorted_paths(depth_first));
+
+    // pop() finishes the current directory and continues with the pending ones
+    std::size_t count = 0u;
+    for (fs::recursive_directory_iterator it(root, fs::directory_options::breadth_first), end; it != end; ++count)
+    {
+        if (it.depth() > 0)
+            it.pop();
+        else
+            ++it;
+    }
+    BOOST_TEST_EQ(count, 3u + 1u);
+
+    // When the queue of pending directories is full, the directories are iterated depth-first
+    fs::set_recursive_directory_iterator_pending_directories_limit(1u);
+    BOOST_TEST_EQ(fs::recursive_directory_iterator_pending_directories_limit(), 1u);
+    breadth_first = walk_paths(root, fs::directory_options::breadth_first);
+    fs::set_recursive_directory_iterator_pending_directories_limit(0u);
+    BOOST_TEST(fs::recursive_directory_iterator_pending_directories_limit() > 1u);
+    BOOST_TEST(sorted_paths(breadth_first) == sorted_paths(depth_first));
+
+    // Closing and reopening the directories doesn't change the order of iteration
+    const std::size_t limits[] = { 1u, 2u, 5u };
+    for (std::size_t i = 0u; i < sizeof(limits) / sizeof(*limits); ++i)
+    {
+        fs::set_recursive_directory_iterator_open_directories_limit(limits[i]);
+        BOOST_TEST_EQ(fs::recursive_directory_iterator_open_directories_limit(), limits[i]);
+        BOOST_TEST(walk_paths(root, fs::directory_options::limit_open_directories) == depth_first);
+        breadth_first = walk_paths(root, fs::directory_options::limit_open_directories | fs::directory_options::breadth_first);
+        BOOST_TEST(sorted_paths(breadth_first) == sorted_paths(depth_first));
+    }
+
+    fs::set_recursive_directory_iterator_open_directories_limit(1u);
+    count = 0u;
+    for (fs::recursive_directory_iterator it(root, fs::directory_options::limit_open_directories), end; it != end; ++count)
+    {
+        if (it.depth() == 3)
+            it.pop();
+        else
+            ++it;
+    }
+    BOOST_TEST_EQ(count, 3u * 3u + 1u);
+    fs::set_recursive_directory_iterator_open_directories_limit(0u);
+
+    // The open directories draw descriptors from the process-wide budget and are closed when the budget is exhausted
+    BOOST_TEST_EQ(fs::descriptor_budget(), 0u);
+    fs::set_descriptor_budget(3u);
+    BOOST_TEST_EQ(fs::descriptor_budget(), 3u);
+    {
+        fs::recursive_directory_iterator deep(root), end;
+        while (deep != end && deep.depth() < 5)
+            ++deep;
+        BOOST_TEST(deep != end);
+        BOOST_TEST_EQ(fs::descriptor_budget_used(), 3u);
+
+        // The budget is exhausted, the other iterator only keeps one directory open
+        std::vector< fs::path > paths;
+        for (fs::recursive_directory_iterator it(root); it != end; ++it)
+        {
+            BOOST_TEST_EQ(fs::descriptor_budget_used(), 3u);
+            paths.push_back(it->path());
+        }
+        BOOST_TEST(paths == depth_first);
+
+        for (; deep != end; ++deep)
+            BOOST_TEST(fs::descriptor_budget_used() <= 3u);
+    }
+    BOOST_TEST_EQ(fs::descriptor_budget_used(), 0u);
+    fs::set_descriptor_budget(0u);
+
+    fs::remove_all(root);
+
+    cout << "  recursive_directory_iterator_traversal_tests complete" << endl;
+}
+
+//  recursive_directory_iterator_observer_tests  --------------------------------------//
+
+struct observed_event
+{
+    fs::recursive_directory_iterator_event::type event;
+    fs::path dir_path;
+    fs::directory_iteration_stats stats;
+};
+
+void record_observed_event(fs::recursive_directory_iterator_event::type event, fs::path const& dir_path, fs::directory_iteration_stats const& stats, void* context)
+{
+    observed_event e;
+    e.event = event;
+    e.dir_path = dir_path;
+    e.stats = stats;
+    static_cast< std::vector< observed_event >* >(context)->push_back(e);
+}
+
+// Verifies that every directory is pushed and popped once, in stack order, and returns the popped directories
+std::vector< observed_event > check_observed_events(fs::path const& root, std::vector< observed_event > const& events)
+{
+    std::vector< fs::path > stack;
+    std::vector< observed_event > popped;
+    for (std::size_t i = 0u; i < events.size(); ++i)
+    {
+        observed_event const& e = events[i];
+        BOOST_TEST_EQ(static_cast< int >(e.stats.depth), path_depth(root, e.dir_path) + 1);
+        if (e.event == fs::recursive_directory_iterator_event::push)
+        {
+            stack.push_back(e.dir_path);
+        }
+        else
+        {
+            BOOST_TEST(!stack.empty());
+            if (stack.empty())
+                break;
+            BOOST_TEST_EQ(e.dir_path, stack.back());
+            stack.pop_back();
+            popped.push_back(e);
+        }
+    }
+    BOOST_TEST(stack.empty());
+    return popped;
+}
+
+void recursive_directory_iterator_observer_tests()
+{
+    cout << "recursive_directory_iterator_observer_tests..." << endl;
+
+    const fs::path root = dir / "observer";
+    fs::create_directories(root / "a" / "b");
+    create_file(root / "a" / "f1", "");
+    create_file(root / "a" / "f2", "");
+    create_file(root / "a" / "b" / "f3", "");
+    fs::create_directory(root / "empty");
+    create_file(root / "file", "");
+
+    std::vector< observed_event > events;
+    std::size_t count = 0u;
+    {
+        fs::recursive_directory_iterator it(root), end;
+        it.set_observer(&record_observed_event, &events);
+        // The root directory is reported when the observer is set
+        BOOST_TEST_EQ(events.size(), 1u);
+        for (; it != end; ++it)
+            ++count;
+    }
+    BOOST_TEST_EQ(count, 7u);
+
+    std::vector< observed_event > popped = check_observed_events(root, events);
+    BOOST_TEST_EQ(popped.size(), 4u);
+    for (std::size_t i = 0u; i < popped.size(); ++i)
+    {
+        observed_event const& e = popped[i];
+        if (e.dir_path == root / "a")
+        {
+            BOOST_TEST_EQ(e.stats.entry_count, 3u);
+            // The amount of the directory listing data is known when the entries are read in bulk
+            if (fs::get_directory_read_backend() == fs::directory_read_backend::getdents)
+                BOOST_TEST(e.stats.bytes_read > 0u);
+        }
+        else if (e.dir_path == root / "a" / "b")
+        {
+            BOOST_TEST_EQ(e.stats.entry_count, 1u);
+            BOOST_TEST_EQ(e.stats.depth, 2u);
+        }
+        else if (e.dir_path == root / "empty")
+        {
+            BOOST_TEST_EQ(e.stats.entry_count, 0u);
+        }
+        else
+        {
+            BOOST_TEST_EQ(e.dir_path, root);
+            // The current entry at the time the observer was set is not counted
+            BOOST_TEST_EQ(e.stats.entry_count, 2u);
+        }
+    }
+
+    // The same directories are reported when directories are closed and reopened or iterated breadth-first
+    const fs::directory_options opts[] = { fs::directory_options::limit_open_directories, fs::directory_options::breadth_first, fs::directory_options::sort_by_name };
+    fs::set_recursive_directory_iterator_open_directories_limit(1u);
+    for (std::size_t i = 0u; i < sizeof(opts) / sizeof(*opts); ++i)
+    {
+        events.clear();
+        fs::recursive_directory_iterator it(root, opts[i]), end;
+        it.set_observer(&record_observed_event, &events);
+        for (; it != end; ++it)
+        {
+        }
+
+        popped = check_observed_events(root, events);
+        BOOST_TEST_EQ(popped.size(), 4u);
+        boost::uintmax_t entry_count = 0u;
+        for (std::size_t j = 0u; j < popped.size(); ++j)
+            entry_count += popped[j].stats.entry_count;
+        BOOST_TEST_EQ(entry_count, 6u);
+    }
+    fs::set_recursive_directory_iterator_open_directories_limit(0u);
+
+    // pop() reports the directory as popped, and removing the observer stops reporting
+    events.clear();
+    {
+        fs::recursive_directory_iterator it(root), end;
+        it.set_observer(&record_observed_event, &events);
+        while (it != end && it.depth() == 0)
+            ++it;
+        BOOST_TEST(it != end);
+        const std::size_t pushed = events.size();
+        const fs::path popped_dir = it->path().parent_path();
+        it.pop();
+        // The parent directory is also popped if the popped directory was its last entry
+        BOOST_TEST(events.size() > pushed);
+        if (events.size() > pushed)
+        {
+            BOOST_TEST(events[pushed].event == fs::recursive_directory_iterator_event::pop);
+            BOOST_TEST_EQ(events[pushed].dir_path, popped_dir);
+        }
+
+        it.set_observer(NULL);
+        const std::size_t reported = events.size();
+        for (; it != end; ++it)
+        {
+        }
+        BOOST_TEST_EQ(events.size(), reported);
+    }
+
+    fs::remove_all(root);
+
+    cout << "  recursive_directory_iterator_observer_tests complete" << endl;
+}
+
+//  recursive_directory_iterator_checkpoint_tests  ------------------------------------//
+
+// Verifies that an iterator resumed from a checkpoint made at every position produces the remaining entries
+void check_resume_at_every_position(fs::path const& root, fs::directory_options opts)
+{
+    const std::vector< fs::path > reference = walk_paths(root, opts);
+    std::size_t index = 0u;
+    for (fs::recursive_directory_iterator it(root, opts), end; it != end; ++it, ++index)
+    {
+        const fs::recursive_directory_iterator_checkpoint cp = it.checkpoint();
+        BOOST_TEST(!cp.empty());
+
+        // The checkpoint survives serialization
+        fs::recursive_directory_iterator resumed(fs::recursive_directory_iterator_checkpoint(cp.data()));
+        BOOST_TEST_EQ(resumed.depth(), it.depth());
+
+        std::vector< fs::path > rest;
+        for (; resumed != end; ++resumed)
+            rest.push_back(resumed->path());
+        BOOST_TEST(rest == std::vector< fs::path >(reference.begin() + index, reference.end()));
+    }
+    BOOST_TEST_EQ(index, reference.size());
+}
+
+void recursive_directory_iterator_checkpoint_tests()
+{
+    cout << "recursive_directory_iterator_checkpoint_tests..." << endl;
+
+    const fs::path root = dir / "checkpoint";
+    fs::path level = root;
+    for (unsigned int i = 0u; i < 4u; ++i)
+    {
+        fs::create_directories(level / "sub");
+        create_file(level / "file1", "");
+        create_file(level / "file2", "");
+        fs::create_directory(level / "empty");
+        level /= "sub";
+    }
+
+    check_resume_at_every_position(root, fs::directory_options::none);
+    check_resume_at_every_position(root, fs::directory_options::breadth_first);
+    check_resume_at_every_position(root, fs::directory_options::skip_directory_cycles);
+    check_resume_at_every_position(root, fs::directory_options::skip_visited_directories | fs::directory_options::sort_by_name);
+
+    fs::set_recursive_directory_iterator_open_directories_limit(1u);
+    check_resume_at_every_position(root, fs::directory_options::limit_open_directories);
+    fs::set_recursive_directory_iterator_open_directories_limit(0u);
+
+    fs::recursive_directory_iterator end;
+
+    // End iterators produce empty checkpoints, which resume to end iterators
+    BOOST_TEST(end.checkpoint().empty());
+    BOOST_TEST(fs::recursive_directory_iterator(fs::recursive_directory_iterator_checkpoint()) == end);
+
+    // The state of recursion into the current entry is preserved
+    {
+        fs::recursive_directory_iterator it(root, fs::directory_options::sort_by_name);
+        while (it->path().filename() != "sub")
+            ++it;
+        it.disable_recursion_pending();
+        fs::recursive_directory_iterator resumed(it.checkpoint());
+        BOOST_TEST(!resumed.recursion_pending());
+        BOOST_TEST_EQ(resumed->path(), root / "sub");
+        ++resumed;
+        BOOST_TEST(resumed == end);
+    }
+
+    // If the current entry was removed, the iteration of its directory restarts
+    {
+        fs::recursive_directory_iterator it(root, fs::directory_options::sort_by_name);
+        while (it->path().filename() != "file2")
+            ++it;
+        const fs::recursive_directory_iterator_checkpoint cp = it.checkpoint();
+        it = end;
+        fs::remove(root / "file2");
+        fs::recursive_directory_iterator resumed(cp);
+        BOOST_TEST_EQ(resumed->path(), root / "empty");
+        create_file(root / "file2", "");
+    }
+
+    // If a directory on the stack was emptied, the iteration continues with the next entry of its parent
+    {
+        const fs::path subdir = root / "sub" / "sub" / "sub";
+        fs::recursive_directory_iterator it(root / "sub", fs::directory_options::sort_by_name);
+        while (it.depth() < 2)
+            ++it;
+        BOOST_TEST_EQ(it->path().parent_path(), subdir);
+        const fs::recursive_directory_iterator_checkpoint cp = it.checkpoint();
+        it = end;
+
+        const std::vector< fs::path > children = walk_paths(subdir, fs::directory_options::none);
+        for (std::size_t i = 0u; i < children.size(); ++i)
+            fs::remove_all(children[i]);
+        fs::recursive_directory_iterator resumed(cp);
+        BOOST_TEST(resumed == end);
+
+        // If the directory was removed, the iteration of its parent restarts
+        fs::remove(subdir);
+        fs::recursive_directory_iterator restarted(cp);
+        BOOST_TEST(restarted != end);
+        BOOST_TEST_EQ(restarted->path(), root / "sub" / "sub" / "empty");
+    }
+
+    // Invalid checkpoints are rejected
+    {
+        BOOST_TEST_THROWS(fs::recursive_directory_iterator(fs::recursive_directory_iterator_checkpoint("invalid")), fs::filesystem_error);
+
+        fs::recursive_directory_iterator it(root);
+        std::string data = it.checkpoint().data();
+        data.resize(data.size() - 1u);
+        error_code ec;
+        fs::recursive_directory_iterator resumed(fs::recursive_directory_iterator_checkpoint(data), ec);
+        BOOST_TEST(!!ec);
+        BOOST_TEST(resumed == end);
+    }
+
+    // Iterators with entry filters cannot be checkpointed
+    {
+        fs::recursive_directory_iterator it(root, fs::directory_options::none, exclude_by_name("empty"));
+        error_code ec;
+        BOOST_TEST(it.checkpoint(ec).empty());
+        BOOST_TEST(!!ec);
+        BOOST_TEST_THROWS(it.checkpoint(), fs::filesystem_error);
+    }
+
+    fs::remove_all(root);
+
+    cout << "  recursive_directory_iterator_checkpoint_tests complete" << endl;
+}
+
+//  directory_iterator_buffer_size_tests  ---------------------------------------------//
+
+void directory_iterator_buffer_size_tests()
+{
+    cout << "directory_iterator_buffer_size_tests..." << endl;
+
+    const std::size_t default_size = fs::directory_iterator_buffer_size();
+    BOOST_TEST_GT(default_size, 0u);
+
+    fs::path bsdir = dir / "buffer_size";
+    fs::create_directory(bsdir);
+    std::string name(200, 'x');
+    name.append(2u, 'a');
+    for (unsigned int i = 0u; i < 300u; ++i)
+    {
+        name[name.size() - 2u] = static_cast< char >('a' + i / 26u);
+        name[name.size() - 1u] = static_cast< char >('a' + i % 26u);
+        create_file(bsdir / name);
+    }
+
+    const std::size_t sizes[] = { 1u, default_size * 4u, static_cast< std::size_t >(-1) };
+    for (std::size_t i = 0u; i < sizeof(sizes) / sizeof(*sizes); ++i)
+    {
+        fs::set_directory_iterator_buffer_size(sizes[i]);
+        BOOST_TEST_GT(fs::directory_iterator_buffer_size(), 0u);
+
+        unsigned int count = 0u;
+        for (fs::directory_iterator it(bsdir), end; it != end; ++it)
+            ++count;
+        BOOST_TEST_EQ(count, 300u);
+    }
+
+    fs::set_directory_iterator_buffer_size(0u);
+    BOOST_TEST_EQ(fs::directory_iterator_buffer_size(), default_size);
+
+    fs::remove_all(bsdir);
+}
+
+//  sorted_directory_iterator_tests  -------------------------------------------------//
+
+void sorted_directory_iterator_tests()
+{
+    cout << "sorted_directory_iterator_tests..." << endl;
+
+    fs::path sdir = dir / "sorted";
+    fs::create_directories(sdir / "sub" / "sub2");
+    const char* const names[] = { "m", "b", "z", "a", "k", "c" };
+    for (std::size_t i = 0u; i < sizeof(names) / sizeof(*names); ++i)
+    {
+        create_file(sdir / names[i]);
+        create_file(sdir / "sub" / names[i]);
+    }
+
+#if defined(BOOST_POSIX_API)
+    std::vector< fs::path > listing;
+    for (fs::directory_iterator it(sdir, fs::directory_options::sort_by_name), end; it != end; ++it)
+        listing.push_back(it->path().filename());
+    BOOST_TEST_EQ(listing.size(), 7u);
+    for (std::size_t i = 1u; i < listing.size(); ++i)
+        BOOST_TEST(listing[i - 1u] < listing[i]);
+
+    listing.clear();
+    for (fs::recursive_directory_iterator it(sdir, fs::directory_options::sort_by_name), end; it != end; ++it)
+        listing.push_back(it->path().lexically_relative(sdir));
+    BOOST_TEST_EQ(listing.size(), 14u);
+    if (listing.size() == 14u)
+    {
+        // Subdirectories are also sorted and iterated in place
+        BOOST_TEST(listing[5] == fs::path("sub"));
+        BOOST_TEST(listing[6] == fs::path("sub") / "a");
+        BOOST_TEST(listing[11] == fs::path("sub") / "sub2");
+        BOOST_TEST(listing[13] == fs::path("z"));
+    }
+
+    boost::uintmax_t prev_inode = 0u;
+    unsigned int count = 0u;
+    for (fs::directory_iterator it(sdir, fs::directory_options::sort_by_inode), end; it != end; ++it, ++count)
+    {
+        const boost::uintmax_t inode = fs::query(it->path(), fs::file_attribute_mask::inode).inode;
+        BOOST_TEST_LE(prev_inode, inode);
+        prev_inode = inode;
+    }
+    BOOST_TEST_EQ(count, 7u);
+#endif
+
+    fs::remove_all(sdir);
+}
+
+//  prefetch_directory_iterator_tests  -----------------------------------------------//
+
+void prefetch_directory_iterator_tests()
+{
+    cout << "prefetch_directory_iterator_tests..." << endl;
+
+    // More entries than are read in one batch
+    fs::path pdir = dir / "prefetch";
+    fs::create_directories(pdir / "sub");
+    for (unsigned int i = 0u; i < 150u; ++i)
+        create_file(pdir / fs::path(std::string("file") + static_cast< char >('a' + i / 26u) + static_cast< char >('a' + i % 26u)), std::string(i, 'x'));
+    create_file(pdir / "sub" / "nested", "nested");
+    error_code ec;
+    // harmless if these fail:
+    fs::create_symlink(pdir / "fileaa", pdir / "symlink", ec);
+    fs::create_symlink(pdir / "no such file", pdir / "dangling_symlink", ec);
+
+    unsigned int count = 0u;
+    for (fs::directory_iterator it(pdir, fs::directory_options::prefetch_status), end; it != end; ++it, ++count)
+    {
+        BOOST_TEST(fs::status(it->path()).type() == it->status().type());
+        BOOST_TEST(fs::symlink_status(it->path()).type() == it->symlink_status().type());
+        if (fs::is_regular_file(it->status()))
+        {
+            BOOST_TEST_EQ(it->file_size(), fs::file_size(it->path()));
+            BOOST_TEST_EQ(it->hard_link_count(), fs::hard_link_count(it->path()));
+            BOOST_TEST_EQ(it->last_write_time(), fs::last_write_time(it->path()));
+        }
+        if (fs::exists(it->status()))
+            BOOST_TEST(fs::equivalent(*it, it->path()));
+    }
+    BOOST_TEST_EQ(count, 150u + 1u + (fs::exists(pdir / "symlink") ? 1u : 0u) + (fs::is_symlink(pdir / "dangling_symlink") ? 1u : 0u));
+
+    // Destroying the iterator in the middle of a batch
+    {
+        fs::directory_iterator it(pdir, fs::directory_options::prefetch_status);
+        for (unsigned int i = 0u; i < 10u; ++i)
+            ++it;
+        BOOST_TEST(it != fs::directory_iterator());
+    }
+
+    count = 0u;
+    for (fs::recursive_directory_iterator it(pdir, fs::directory_options::prefetch_status), end; it != end; ++it, ++count)
+        BOOST_TEST(fs::symlink_status(it->path()).type() == it->symlink_status().type());
+    unsigned int expected = 0u;
+    for (fs::recursive_directory_iterator it(pdir), end; it != end; ++it)
+        ++expected;
+    BOOST_TEST_EQ(count, expected);
+
+    fs::remove_all(pdir);
+}
+
+//  for_each_name_tests  -------------------------------------------------------------//
+
+struct name_counter
+{
+    unsigned int* count;
+    unsigned int* directories;
+    std::vector< fs::path >* names;
+    unsigned int limit;
+
+    bool operator()(fs::path_view const& name, fs::file_type type) const
+    {
+        names->push_back(fs::path(name.native()));
+        if (type == fs::directory_file)
+            ++*directories;
+        return ++*count < limit;
+    }
+};
+
+void for_each_name_tests()
+{
+    cout << "for_each_name_tests..." << endl;
+
+    unsigned int count = 0u, directories = 0u;
+    std::vector< fs::path > names;
+    name_counter counter = { &count, &directories, &names, ~0u };
+    fs::for_each_name(dir, counter);
+
+    std::vector< fs::path > expected;
+    unsigned int expected_directories = 0u;
+    for (fs::directory_iterator it(dir), end; it != end; ++it)
+    {
+        expected.push_back(it->path().filename());
+        if (fs::is_directory(it->symlink_status()))
+            ++expected_directories;
+    }
+    std::sort(names.begin(), names.end());
+    std::sort(expected.begin(), expected.end());
+    BOOST_TEST(names == expected);
+    // The type may be unknown without querying the filesystem
+    BOOST_TEST_LE(directories, expected_directories);
+
+    // The enumeration stops when the callback returns false
+    count = 0u;
+    names.clear();
+    counter.limit = 2u;
+    fs::for_each_name(dir, fs::directory_options::none, counter);
+    BOOST_TEST_EQ(count, 2u);
+
+    error_code ec;
+    fs::for_each_name(dir / "no such directory", counter, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST_EQ(count, 2u);
+    BOOST_TEST_THROWS(fs::for_each_name(dir / "no such directory", counter), fs::filesystem_error);
+}
+
+//  directory_cursor_tests  ----------------------------------------------------------//
+
+void directory_cursor_tests()
+{
+    cout << "directory_cursor_tests..." << endl;
+
+    std::vector< fs::path > expected;
+    for (fs::directory_iterator it(dir), end; it != end; ++it)
+        expected.push_back(it->path());
+
+    std::vector< fs::path > paths;
+    for (fs::directory_cursor cur(dir); !cur.done(); cur.next())
+        paths.push_back(cur.entry().path());
+    BOOST_TEST(paths == expected);
+
+    // The cursor can be moved and swapped, and can give up its state to a directory iterator
+    fs::directory_cursor cur(dir, fs::directory_options::none);
+    BOOST_TEST(!cur.done());
+    fs::directory_cursor other;
+    BOOST_TEST(other.done());
+    swap(cur, other);
+    BOOST_TEST(cur.done());
+    BOOST_TEST(!other.done());
+
+    error_code ec;
+    other.next(ec);
+    BOOST_TEST(!ec);
+    paths.assign(1u, expected.front());
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    cur = static_cast< fs::directory_cursor&& >(other);
+    BOOST_TEST(other.done());
+#else
+    cur.swap(other);
+#endif
+    for (fs::directory_iterator it = cur.release(), end; it != end; ++it)
+        paths.push_back(it->path());
+    BOOST_TEST(cur.done());
+    BOOST_TEST(paths == expected);
+
+    fs::directory_cursor bad(dir / "no such directory", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(bad.done());
+    BOOST_TEST_THROWS(fs::directory_cursor(dir / "no such directory"), fs::filesystem_error);
+}
+
+//  directory_entry_count_hint_tests  ------------------------------------------------//
+
+void directory_entry_count_hint_tests()
+{
+    cout << "directory_entry_count_hint_tests..." << endl;
+
+    error_code ec;
+    fs::directory_entry_count_hint(dir, ec);
+    BOOST_TEST(!ec);
+
+    fs::directory_entry_count_hint(dir / "no such directory", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST_THROWS(fs::directory_entry_count_hint(dir / "no such directory"), fs::filesystem_error);
+
+    create_file(dir / "count_hint_file");
+    BOOST_TEST_EQ(fs::directory_entry_count_hint(dir / "count_hint_file", ec), 0u);
+    BOOST_TEST(!!ec);
+    fs::remove(dir / "count_hint_file");
+
+#if defined(BOOST_POSIX_API)
+    // The entries are reserved in sorted listings
+    fs::path hdir = dir / "count_hint";
+    fs::create_directory(hdir);
+    for (unsigned int i = 0u; i < 200u; ++i)
+        create_file(hdir / fs::path(std::string("file") + static_cast< char >('a' + i / 26u) + static_cast< char >('a' + i % 26u)));
+    unsigned int count = 0u;
+    for (fs::directory_iterator it(hdir, fs::directory_options::sort_by_name), end; it != end; ++it)
+        ++count;
+    BOOST_TEST_EQ(count, 200u);
+    fs::remove_all(hdir);
+#endif
+}
+
 //  iterator_status_tests  -----------------------------------------------------------//
 
 void iterator_status_tests()
@@ -774,6 +1639,75 @@ void iterator_status_tests()
     }
 }
 
+//  iterator_attribute_tests  --------------------------------------------------------//
+
+void iterator_attribute_tests()
+{
+    cout << "iterator_attribute_tests..." << endl;
+
+    for (fs::directory_iterator it(dir);
+         it != fs::directory_iterator(); ++it)
+    {
+        error_code ec;
+        if (fs::is_regular_file(it->status()))
+        {
+            BOOST_TEST_EQ(it->file_size(), fs::file_size(it->path()));
+            BOOST_TEST_EQ(it->file_size(ec), fs::file_size(it->path()));
+            BOOST_TEST(!ec);
+        }
+        else if (fs::is_directory(it->status()))
+        {
+            it->file_size(ec);
+            BOOST_TEST(!!ec);
+        }
+
+        if (fs::exists(it->status()))
+        {
+            BOOST_TEST_EQ(it->last_write_time(), fs::last_write_time(it->path()));
+            BOOST_TEST_EQ(it->hard_link_count(), fs::hard_link_count(it->path()));
+            BOOST_TEST_NE(it->inode(ec), 0u);
+            BOOST_TEST(!ec);
+        }
+        else
+        {
+            // dangling symlinks
+            it->file_size(ec);
+            BOOST_TEST(!!ec);
+            BOOST_TEST_THROWS(it->last_write_time(), fs::filesystem_error);
+        }
+    }
+
+    // The inode numbers reported by the directory listing are the same as reported by stat
+    for (fs::directory_iterator it(dir); it != fs::directory_iterator(); ++it)
+    {
+        error_code ec;
+        const boost::uintmax_t ino = it->inode(ec);
+        if (!ec)
+            BOOST_TEST_EQ(ino, fs::directory_entry(it->path()).inode());
+    }
+
+    // Attributes are cached until refresh
+    fs::path p(dir / "attr_file");
+    create_file(p, "1234");
+    fs::directory_entry e(p);
+    BOOST_TEST_EQ(e.file_size(), 4u);
+    BOOST_TEST_EQ(e.inode(), fs::directory_entry(p).inode());
+    create_file(p, "12345678");
+    BOOST_TEST_EQ(e.file_size(), 4u);
+    e.refresh();
+    BOOST_TEST_EQ(e.file_size(), 8u);
+    BOOST_TEST(fs::is_regular_file(e.status()));
+
+    fs::remove(p);
+    error_code ec;
+    e.refresh(ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST(e.status().type() == fs::file_not_found);
+    e.file_size(ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST_THROWS(e.hard_link_count(), fs::filesystem_error);
+}
+
 //  recursive_iterator_status_tests  -------------------------------------------------//
 
 void recursive_iterator_status_tests()
@@ -873,6 +1807,33 @@ void create_symlink_tests()
         BOOST_TEST(fs::equivalent(from_ph, f1x));
         BOOST_TEST(fs::read_symlink(from_ph) == f1x);
 
+        // Targets longer than the initial buffer
+        const fs::path long_target(std::string(3000u, 'x'));
+        fs::create_symlink(long_target, dir / "long_symlink");
+        BOOST_TEST(fs::read_symlink(dir / "long_symlink") == long_target);
+
+        // Batched reading, with errors reported for individual symlinks
+        std::vector< fs::path > links(1000u, from_ph);
+        links[1] = dir / "long_symlink";
+        links[2] = dir / "missing";
+        links[3] = f1x;
+        std::vector< fs::path > targets(links.size(), fs::path("stale"));
+        std::vector< boost::system::error_code > results(links.size());
+        fs::read_symlinks(&links[0], links.size(), &targets[0], &results[0]);
+        BOOST_TEST(!results[0]);
+        BOOST_TEST(targets[0] == f1x);
+        BOOST_TEST(!results[1]);
+        BOOST_TEST(targets[1] == long_target);
+        BOOST_TEST(!!results[2]);
+        BOOST_TEST(targets[2].empty());
+        BOOST_TEST(!!results[3]);
+        BOOST_TEST(targets[3].empty());
+        std::size_t read_count = 0u;
+        for (std::size_t i = 4u; i < links.size(); ++i)
+            read_count += !results[i] && targets[i] == f1x;
+        BOOST_TEST_EQ(read_count, links.size() - 4u);
+        fs::remove(dir / "long_symlink");
+
         fs::file_status stat = fs::symlink_status(from_ph);
         BOOST_TEST(fs::exists(stat));
         BOOST_TEST(!fs::is_directory(stat));
@@ -1200,6 +2161,19 @@ void current_directory_tests()
     fs::current_path(original_dir.string());
     BOOST_TEST(fs::current_path() == original_dir);
     BOOST_TEST(fs::current_path() != dir);
+
+    // changes of the current directory not made by the library are observed after refreshing the cached paths
+#if defined(BOOST_POSIX_API)
+    BOOST_TEST_EQ(::chdir(dir.c_str()), 0);
+#else
+    BOOST_TEST(::SetCurrentDirectoryW(dir.c_str()) != 0);
+#endif
+    fs::refresh_cached_paths();
+    BOOST_TEST(fs::current_path() == dir);
+    BOOST_TEST(fs::absolute("foo") == dir / "foo");
+    fs::current_path(original_dir);
+    BOOST_TEST(fs::current_path() == original_dir);
+    BOOST_TEST(fs::absolute("foo") == original_dir / "foo");
 }
 
 //  create_directories_tests  --------------------------------------------------------//
@@ -1251,6 +2225,24 @@ void create_directories_tests()
     BOOST_TEST(fs::exists(p));
     BOOST_TEST(fs::is_directory(p));
 
+    // Several missing levels
+    p = dir / "cd_level1" / "cd_level2" / "cd_level3" / "cd_level4";
+    BOOST_TEST(fs::create_directories(p));
+    BOOST_TEST(fs::is_directory(p));
+    BOOST_TEST(!fs::create_directories(p));
+    BOOST_TEST(fs::create_directories(p / "cd_level5" / "cd_level6"));
+    BOOST_TEST(fs::is_directory(p / "cd_level5" / "cd_level6"));
+    fs::remove_all(dir / "cd_level1");
+
+    // A file in place of one of the parent directories
+    ec.clear();
+    BOOST_TEST(!fs::create_directories(f0 / "cd_level1" / "cd_level2", ec));
+    BOOST_TEST(ec);
+    BOOST_TEST(fs::is_regular_file(f0));
+    ec.clear();
+    BOOST_TEST(!fs::create_directories(f0, ec));
+    BOOST_TEST(ec);
+
     if (fs::exists("/permissions_test"))
     {
         BOOST_TEST(!fs::create_directories("/permissions_test", ec));
@@ -1259,6 +2251,72 @@ void create_directories_tests()
     }
 }
 
+//  create_directories_batch_tests  --------------------------------------------------//
+
+void create_directories_batch_tests()
+{
+    cout << "create_directories_batch_tests..." << endl;
+
+    const fs::path root = dir / "cdb";
+    std::vector< fs::path > paths;
+    paths.push_back(root / "a" / "b" / "c");
+    paths.push_back(root / "a" / "b" / "d");
+    paths.push_back(root / "a" / "b");
+    paths.push_back(root / "x" / "." / "y");
+    paths.push_back(root / "a" / "b" / "c");
+    paths.push_back(root / "z" / "..");
+
+    // Shared parents are created once, duplicates and existing directories are not counted
+    BOOST_TEST_EQ(fs::create_directories(&paths[0], paths.size()), 8u);
+    BOOST_TEST(fs::is_directory(root / "a" / "b" / "c"));
+    BOOST_TEST(fs::is_directory(root / "a" / "b" / "d"));
+    BOOST_TEST(fs::is_directory(root / "x" / "y"));
+    BOOST_TEST(fs::is_directory(root / "z"));
+    BOOST_TEST_EQ(fs::create_directories(&paths[0], paths.size()), 0u);
+
+    error_code ec;
+    BOOST_TEST_EQ(fs::create_directories(&paths[0], 0u, ec), 0u);
+    BOOST_TEST(!ec);
+
+    // A file in place of a directory
+    create_file(root / "a" / "file");
+    paths.clear();
+    paths.push_back(root / "a" / "e");
+    paths.push_back(root / "a" / "file" / "f");
+    BOOST_TEST_EQ(fs::create_directories(&paths[0], paths.size(), ec), 1u);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(fs::is_directory(root / "a" / "e"));
+    paths[1] = root / "a" / "file";
+    BOOST_TEST_THROWS(fs::create_directories(&paths[0], paths.size()), fs::filesystem_error);
+
+    // Empty paths are rejected before creating any directories
+    paths[1] = fs::path();
+    paths.push_back(root / "g");
+    BOOST_TEST_EQ(fs::create_directories(&paths[0], paths.size(), ec), 0u);
+    BOOST_TEST(ec == boost::system::errc::invalid_argument);
+    BOOST_TEST(!fs::exists(root / "g"));
+
+    // Many independent subtrees, possibly created in parallel
+    paths.clear();
+    for (char i = 'a'; i < 'a' + 8; ++i)
+    {
+        for (unsigned int j = 0u; j < 100u; ++j)
+        {
+            std::string name("leaf");
+            name.push_back(static_cast< char >('0' + j / 10u));
+            name.push_back(static_cast< char >('0' + j % 10u));
+            paths.push_back(root / "many" / "sub" / std::string(1u, i) / name);
+        }
+    }
+    BOOST_TEST_EQ(fs::create_directories(&paths[0], paths.size(), 4u, ec), paths.size() + 8u + 2u);
+    BOOST_TEST(!ec);
+    for (std::size_t i = 0u; i < paths.size(); ++i)
+        BOOST_TEST(fs::is_directory(paths[i]));
+    BOOST_TEST_EQ(fs::create_directories(&paths[0], paths.size(), 0u), 0u);
+
+    fs::remove_all(root);
+}
+
 //  resize_file_tests  ---------------------------------------------------------------//
 
 void resize_file_tests()
@@ -1284,6 +2342,109 @@ void resize_file_tests()
     BOOST_TEST(ec);
 }
 
+//  file_range_tests  ----------------------------------------------------------------//
+
+void file_range_tests()
+{
+    cout << "file_range_tests..." << endl;
+
+    fs::path p(dir / "file_range_test.txt");
+
+    fs::remove(p);
+    create_file(p, "1234567890");
+
+    error_code ec;
+    fs::preallocate(p, 0u, 4096u, fs::preallocate_options::keep_size, ec);
+    if (!ec)
+        BOOST_TEST_EQ(fs::file_size(p), 10U);
+    else
+        BOOST_TEST(ec == boost::system::errc::not_supported);
+
+    fs::preallocate(p, 5u, 20u, ec);
+    if (!ec)
+    {
+        BOOST_TEST_EQ(fs::file_size(p), 25U);
+        verify_file(p, std::string("1234567890") + std::string(15u, '\0'));
+    }
+    else
+    {
+        BOOST_TEST(ec == boost::system::errc::not_supported);
+    }
+    fs::resize_file(p, 10u);
+
+    // Zeroing ranges is emulated if the filesystem does not support it
+    fs::zero_range(p, 2u, 3u);
+    BOOST_TEST_EQ(fs::file_size(p), 10U);
+    verify_file(p, std::string("12") + std::string(3u, '\0') + "67890");
+    fs::zero_range(p, 8u, 100u);
+    BOOST_TEST_EQ(fs::file_size(p), 10U);
+    verify_file(p, std::string("12") + std::string(3u, '\0') + "678" + std::string(2u, '\0'));
+
+    fs::punch_hole(p, 5u, 2u, ec);
+    if (!ec)
+    {
+        BOOST_TEST_EQ(fs::file_size(p), 10U);
+        verify_file(p, std::string("12") + std::string(5u, '\0') + "8" + std::string(2u, '\0'));
+    }
+    else
+    {
+        BOOST_TEST(ec == boost::system::errc::not_supported);
+    }
+
+    // Empty ranges are not an error
+    fs::preallocate(p, 100u, 0u);
+    fs::punch_hole(p, 100u, 0u);
+    BOOST_TEST_EQ(fs::file_size(p), 10U);
+
+    fs::preallocate("no such file", 0u, 10u, ec);
+    BOOST_TEST(ec);
+    BOOST_TEST_THROWS(fs::punch_hole("no such file", 0u, 10u), fs::filesystem_error);
+    BOOST_TEST_THROWS(fs::zero_range(p, 1u, ~static_cast< boost::uintmax_t >(0u)), fs::filesystem_error);
+
+    fs::remove(p);
+}
+
+//  prefetch_tests  ------------------------------------------------------------------//
+
+void prefetch_tests()
+{
+    cout << "prefetch_tests..." << endl;
+
+    fs::path root(dir / "prefetch_test");
+    fs::create_directories(root / "sub");
+    create_file(root / "a", "0123456789");
+    create_file(root / "sub" / "b", "01234567890123456789");
+    fs::path f(dir / "prefetch_test_file");
+    create_file(f, "01234");
+
+    BOOST_TEST_EQ(fs::prefetch(&f, 1u), 5U);
+    BOOST_TEST_EQ(fs::prefetch(&root, 1u), 0U);
+    BOOST_TEST_EQ(fs::prefetch(&root, 1u, fs::prefetch_options::recursive), 30U);
+
+    // The byte budget is consumed in the order of the paths
+    fs::path paths[3] = { f, root, "no such file" };
+    BOOST_TEST_EQ(fs::prefetch(paths, 2u, fs::prefetch_options::recursive, 12u), 12U);
+    BOOST_TEST_EQ(fs::prefetch(paths, 2u, fs::prefetch_options::recursive, 100u, 4u), 35U);
+
+    // Errors do not prevent prefetching the other files
+    error_code ec;
+    BOOST_TEST_EQ(fs::prefetch(paths, 3u, fs::prefetch_options::recursive, ec), 35U);
+    BOOST_TEST(ec);
+    BOOST_TEST_THROWS(fs::prefetch(paths + 2, 1u), fs::filesystem_error);
+
+    for (unsigned int i = 0u; i < 32u; ++i)
+    {
+        std::string name("f");
+        name.push_back(static_cast< char >('a' + i / 16u));
+        name.push_back(static_cast< char >('a' + i % 16u));
+        create_file(root / "sub" / name, "abc");
+    }
+    BOOST_TEST_EQ(fs::prefetch(&root, 1u, fs::prefetch_options::recursive, ~static_cast< boost::uintmax_t >(0u), 4u), 126U);
+
+    fs::remove_all(root);
+    fs::remove(f);
+}
+
 //  status_of_nonexistent_tests  -----------------------------------------------------//
 
 void status_of_nonexistent_tests()
@@ -1316,6 +2477,96 @@ void status_of_nonexistent_tests()
     //cout << "error_code value: " << ec.value() << endl;
 }
 
+//  statuses_tests  ------------------------------------------------------------------//
+
+void statuses_tests()
+{
+    cout << "statuses_tests..." << endl;
+
+    std::vector< fs::path > paths;
+    for (fs::recursive_directory_iterator it(dir), end; it != end; ++it)
+        paths.push_back(it->path());
+    paths.push_back(dir / "no-such-file");
+    paths.push_back(dir / "no-such-directory" / "bar");
+    paths.push_back(dir);
+
+    // Make sure there are enough paths to exercise batching
+    const std::size_t unique_count = paths.size();
+    while (paths.size() < 1000u)
+        paths.push_back(paths[paths.size() % unique_count]);
+
+    std::vector< fs::file_status > results(paths.size());
+    error_code ec;
+    fs::statuses(&paths[0], paths.size(), &results[0], ec);
+    BOOST_TEST(!ec);
+    for (std::size_t i = 0u; i < paths.size(); ++i)
+    {
+        fs::file_status expected = fs::status(paths[i], ec);
+        BOOST_TEST_EQ(results[i].type(), expected.type());
+        BOOST_TEST_EQ(results[i].permissions(), expected.permissions());
+    }
+
+    BOOST_TEST_EQ(results[unique_count - 3u].type(), fs::file_not_found);
+    BOOST_TEST_EQ(results[unique_count - 2u].type(), fs::file_not_found);
+    BOOST_TEST_EQ(results[unique_count - 1u].type(), fs::directory_file);
+
+    // Empty input
+    fs::statuses(&paths[0], 0u, &results[0]);
+    fs::statuses(&paths[0], 1u, &results[0]);
+    BOOST_TEST(results[0].type() != fs::status_error);
+}
+
+//  status_consistency_tests  --------------------------------------------------------//
+
+void status_consistency_tests()
+{
+    cout << "status_consistency_tests..." << endl;
+
+    // Local filesystems return the same results regardless of the consistency
+    const fs::status_consistency consistencies[] = { fs::status_consistency::system_default, fs::status_consistency::force_sync, fs::status_consistency::dont_sync };
+    const fs::file_attribute_mask modifiers[] = { fs::file_attribute_mask::none, fs::file_attribute_mask::force_sync, fs::file_attribute_mask::dont_sync };
+    std::vector< fs::path > paths;
+    paths.push_back(dir);
+    paths.push_back(dir / "no-such-file");
+    for (fs::directory_iterator it(dir), end; it != end && paths.size() < 8u; ++it)
+        paths.push_back(it->path());
+
+    for (std::size_t i = 0u; i < sizeof(consistencies) / sizeof(*consistencies); ++i)
+    {
+        error_code ec;
+        for (std::size_t j = 0u; j < paths.size(); ++j)
+        {
+            const fs::file_status expected = fs::status(paths[j], ec);
+            fs::file_status st = fs::status(paths[j], consistencies[i], ec);
+            BOOST_TEST_EQ(st.type(), expected.type());
+            BOOST_TEST_EQ(st.permissions(), expected.permissions());
+            st = fs::symlink_status(paths[j], consistencies[i], ec);
+            BOOST_TEST_EQ(st.type(), fs::symlink_status(paths[j], ec).type());
+
+            fs::directory_entry entry(paths[j]);
+            entry.refresh(consistencies[i], ec);
+            BOOST_TEST(!ec);
+            BOOST_TEST_EQ(entry.status().type(), expected.type());
+
+            if (expected.type() != fs::file_not_found)
+            {
+                fs::file_attributes attrs = fs::query(paths[j], fs::file_attribute_mask::type | fs::file_attribute_mask::size | modifiers[i], ec);
+                BOOST_TEST(!ec);
+                BOOST_TEST_EQ(attrs.status.type(), expected.type());
+            }
+        }
+
+        std::vector< fs::file_status > results(paths.size());
+        fs::statuses(&paths[0], paths.size(), &results[0], consistencies[i], ec);
+        BOOST_TEST(!ec);
+        for (std::size_t j = 0u; j < paths.size(); ++j)
+            BOOST_TEST_EQ(results[j].type(), fs::status(paths[j]).type());
+    }
+
+    // Nonexistent files are not errors
+    BOOST_TEST_EQ(fs::status(dir / "no-such-directory" / "bar", fs::status_consistency::force_sync).type(), fs::file_not_found);
+}
+
 //  status_error_reporting_tests  ----------------------------------------------------//
 
 void status_error_reporting_tests()
@@ -1406,17 +2657,162 @@ void remove_tests(const fs::path& dirx)
     BOOST_TEST(!fs::exists(f1x));
 #endif // defined(BOOST_WINDOWS_API)
 
-    // remove() directory
-    fs::path d1x = dirx / "shortlife_dir";
+    // remove() directory
+    fs::path d1x = dirx / "shortlife_dir";
+    BOOST_TEST(!fs::exists(d1x));
+    fs::create_directory(d1x);
+    BOOST_TEST(fs::exists(d1x));
+    BOOST_TEST(fs::is_directory(d1x));
+    BOOST_TEST(fs::is_empty(d1x));
+    bad_remove_dir = dirx;
+    BOOST_TEST(CHECK_EXCEPTION(bad_remove, ENOTEMPTY));
+    BOOST_TEST(fs::remove(d1x));
+    BOOST_TEST(!fs::exists(d1x));
+}
+
+//  gradual_remove_tests  ------------------------------------------------------------//
+
+//! Executor that runs the posted tasks immediately and counts them
+class counting_executor :
+    public fs::executor
+{
+public:
+    unsigned int posted;
+
+    counting_executor() : posted(0u) {}
+
+    unsigned int concurrency() const BOOST_NOEXCEPT BOOST_OVERRIDE { return 1u; }
+    bool post(task_function* fn, void* context) BOOST_NOEXCEPT BOOST_OVERRIDE
+    {
+        ++posted;
+        fn(context);
+        return true;
+    }
+};
+
+//! Executor that keeps the posted tasks until they are run explicitly
+class deferring_executor :
+    public fs::executor
+{
+public:
+    std::vector< std::pair< task_function*, void* > > tasks;
+
+    unsigned int concurrency() const BOOST_NOEXCEPT BOOST_OVERRIDE { return 1u; }
+    bool post(task_function* fn, void* context) BOOST_NOEXCEPT BOOST_OVERRIDE
+    {
+        tasks.push_back(std::make_pair(fn, context));
+        return true;
+    }
+
+    void run()
+    {
+        for (std::size_t i = 0u; i < tasks.size(); ++i)
+            tasks[i].first(tasks[i].second);
+        tasks.clear();
+    }
+};
+
+void gradual_remove_tests(const fs::path& dirx)
+{
+    cout << "gradual_remove_tests..." << endl;
+
+    fs::gradual_remove_params params;
+    BOOST_TEST_EQ(fs::get_gradual_remove_params().min_file_size, 0u);
+    params.min_file_size = 1000u;
+    params.step_size = 3000u;
+    params.step_interval = 1u;
+    fs::set_gradual_remove_params(params);
+    BOOST_TEST_EQ(fs::get_gradual_remove_params().min_file_size, 1000u);
+    BOOST_TEST_EQ(fs::get_gradual_remove_params().step_size, 3000u);
+
+    // Small files are removed as usual
+    fs::path f1x = dirx / "gradual_small";
+    create_file(f1x, "small");
+    BOOST_TEST(fs::remove(f1x));
+    BOOST_TEST(!fs::exists(f1x));
+
+    // Large files are truncated in steps
+    create_file(f1x, std::string(10000u, 'x'));
+    BOOST_TEST(fs::remove(f1x));
+    BOOST_TEST(!fs::exists(f1x));
+
+    // Files that are still open are not truncated, their data remains accessible through the open descriptors
+    create_file(f1x, std::string(10000u, 'x'));
+    {
+        std::ifstream file(BOOST_FILESYSTEM_C_STR(f1x), std::ios_base::in | std::ios_base::binary);
+        BOOST_TEST(fs::remove(f1x));
+        BOOST_TEST(!fs::exists(f1x));
+        const std::string contents((std::istreambuf_iterator< char >(file)), std::istreambuf_iterator< char >());
+        BOOST_TEST_EQ(contents.size(), 10000u);
+    }
+
+    // The other links to the file are not affected
+    fs::path f2x = dirx / "gradual_link";
+    create_file(f1x, std::string(10000u, 'x'));
+    error_code ec;
+    fs::create_hard_link(f1x, f2x, ec);
+    if (!ec)
+    {
+        BOOST_TEST(fs::remove(f1x));
+        BOOST_TEST(!fs::exists(f1x));
+        BOOST_TEST_EQ(fs::file_size(f2x), 10000u);
+        BOOST_TEST(fs::remove(f2x));
+    }
+    else
+    {
+        fs::remove(f1x);
+    }
+
+    // Files in a tree removed by remove_all, truncated in the background
+    counting_executor exec;
+    fs::executor* prev_exec = fs::set_executor(&exec);
+    params.background = true;
+    fs::set_gradual_remove_params(params);
+
+    fs::path d1x = dirx / "gradual_dir";
+    fs::create_directory(d1x);
+    create_file(d1x / "large", std::string(10000u, 'x'));
+    create_file(d1x / "small", "small");
+    BOOST_TEST_EQ(fs::remove_all(d1x), 3u);
     BOOST_TEST(!fs::exists(d1x));
+#if defined(BOOST_POSIX_API)
+    BOOST_TEST_EQ(exec.posted, 1u);
+#endif
+
+    // The files are truncated one by one by a single task, their descriptors are drawn from the descriptor budget
+    deferring_executor deferred;
+    fs::set_executor(&deferred);
+    fs::set_descriptor_budget(100u);
     fs::create_directory(d1x);
-    BOOST_TEST(fs::exists(d1x));
-    BOOST_TEST(fs::is_directory(d1x));
-    BOOST_TEST(fs::is_empty(d1x));
-    bad_remove_dir = dirx;
-    BOOST_TEST(CHECK_EXCEPTION(bad_remove, ENOTEMPTY));
-    BOOST_TEST(fs::remove(d1x));
+    for (unsigned int i = 0u; i < 3u; ++i)
+        create_file(d1x / ("large" + std::string(1u, static_cast< char >('0' + i))), std::string(10000u, 'x'));
+    BOOST_TEST_EQ(fs::remove_all(d1x), 4u);
+    BOOST_TEST(!fs::exists(d1x));
+#if defined(BOOST_POSIX_API)
+    BOOST_TEST_EQ(deferred.tasks.size(), 1u);
+    BOOST_TEST_EQ(fs::descriptor_budget_used(), 3u);
+#endif
+    deferred.run();
+    BOOST_TEST_EQ(fs::descriptor_budget_used(), 0u);
+
+    // When the budget is exhausted, the files are truncated by the removing thread
+    fs::set_descriptor_budget(1u);
+    fs::create_directory(d1x);
+    for (unsigned int i = 0u; i < 3u; ++i)
+        create_file(d1x / ("large" + std::string(1u, static_cast< char >('0' + i))), std::string(10000u, 'x'));
+    BOOST_TEST_EQ(fs::remove_all(d1x), 4u);
     BOOST_TEST(!fs::exists(d1x));
+#if defined(BOOST_POSIX_API)
+    BOOST_TEST_EQ(deferred.tasks.size(), 1u);
+    BOOST_TEST_EQ(fs::descriptor_budget_used(), 1u);
+#endif
+    deferred.run();
+    BOOST_TEST_EQ(fs::descriptor_budget_used(), 0u);
+    fs::set_descriptor_budget(0u);
+
+    fs::set_executor(prev_exec);
+    fs::set_gradual_remove_params(fs::gradual_remove_params());
+    BOOST_TEST_EQ(fs::get_gradual_remove_params().min_file_size, 0u);
 }
 
 //  remove_symlink_tests  ------------------------------------------------------------//
@@ -1646,6 +3042,15 @@ void absolute_tests()
     BOOST_TEST_EQ(fs::absolute("foo", fs::current_path()), fs::current_path() / "foo");
     BOOST_TEST_EQ(fs::absolute("bar", "foo"), fs::current_path() / "foo" / "bar");
     BOOST_TEST_EQ(fs::absolute("/foo"), fs::current_path().root_path().string() + "foo");
+    {
+        const fs::path abs_path = fs::current_path() / "foo";
+        fs::path p(abs_path);
+        BOOST_TEST_EQ(fs::absolute(p), abs_path);
+        BOOST_TEST_EQ(fs::absolute(fs::path(abs_path)), abs_path);
+        error_code ec(1, boost::system::generic_category());
+        BOOST_TEST_EQ(fs::absolute(p, ec), abs_path);
+        BOOST_TEST(!ec);
+    }
 
 #ifdef BOOST_WINDOWS_API
     BOOST_TEST_EQ(fs::absolute("a:foo", "b:/bar"), fs::path(L"a:/bar/foo"));
@@ -1970,6 +3375,236 @@ void copy_file_tests(const fs::path& f1x, const fs::path& d1x)
     BOOST_TEST(file_copied);
     verify_file(d1x / "f2", "file-f1");
 
+    // Cloning falls back to copying if not supported by the filesystem
+    fs::remove(d1x / "f2");
+    file_copied = false;
+    copy_ex_ok = true;
+    try
+    {
+        file_copied = fs::copy_file(f1x, d1x / "f2", fs::copy_options::clone_if_possible);
+    }
+    catch (const fs::filesystem_error&)
+    {
+        copy_ex_ok = false;
+    }
+    BOOST_TEST(copy_ex_ok);
+    BOOST_TEST(file_copied);
+    verify_file(d1x / "f2", "file-f1");
+
+    file_copied = true;
+    copy_ex_ok = true;
+    try
+    {
+        file_copied = fs::copy_file(f1x, d1x / "f2", fs::copy_options::clone_if_possible | fs::copy_options::skip_existing);
+    }
+    catch (const fs::filesystem_error&)
+    {
+        copy_ex_ok = false;
+    }
+    BOOST_TEST(copy_ex_ok);
+    BOOST_TEST(!file_copied);
+
+    // Cloning may or may not be supported, but if it succeeds, the contents must match
+    {
+        error_code ec;
+        file_copied = fs::copy_file(f1x, d1x / "f2", fs::copy_options::clone_required | fs::copy_options::overwrite_existing, ec);
+        BOOST_TEST_EQ(file_copied, !ec);
+        verify_file(d1x / "f2", "file-f1");
+
+        // If cloning fails, the target file is removed only if it was created by copy_file
+        const fs::path clone_path = d1x / "f2-clone";
+        file_copied = fs::copy_file(f1x, clone_path, fs::copy_options::clone_required | fs::copy_options::overwrite_existing, ec);
+        BOOST_TEST_EQ(file_copied, !ec);
+        BOOST_TEST_EQ(fs::exists(clone_path), file_copied);
+        if (file_copied)
+            verify_file(clone_path, "file-f1");
+        fs::remove(clone_path);
+    }
+
+    // Copy a file with a hole in the middle
+    {
+        const fs::path sparse_path = d1x / "sparse";
+        const fs::path sparse_copy_path = d1x / "sparse-copy";
+        {
+            std::ofstream f(BOOST_FILESYSTEM_C_STR(sparse_path), std::ios_base::out | std::ios_base::binary);
+            f << "head";
+            f.seekp(4 * 1024 * 1024, std::ios_base::cur);
+            f << "tail";
+        }
+
+        error_code ec;
+        file_copied = fs::copy_file(sparse_path, sparse_copy_path, fs::copy_options::preserve_sparse, ec);
+        BOOST_TEST(!ec);
+        BOOST_TEST(file_copied);
+        BOOST_TEST_EQ(fs::file_size(sparse_copy_path), fs::file_size(sparse_path));
+
+        std::ifstream f1(BOOST_FILESYSTEM_C_STR(sparse_path), std::ios_base::in | std::ios_base::binary);
+        std::ifstream f2(BOOST_FILESYSTEM_C_STR(sparse_copy_path), std::ios_base::in | std::ios_base::binary);
+        BOOST_TEST(std::equal(std::istreambuf_iterator< char >(f1), std::istreambuf_iterator< char >(), std::istreambuf_iterator< char >(f2)));
+        f1.close();
+        f2.close();
+
+        fs::remove(sparse_copy_path);
+        fs::remove(sparse_path);
+    }
+
+    // Copy a file in multiple threads. Small files are copied normally.
+    {
+        error_code ec;
+        file_copied = fs::copy_file(f1x, d1x / "f3-parallel", fs::copy_options::parallel_data, ec);
+        BOOST_TEST(!ec);
+        BOOST_TEST(file_copied);
+        verify_file(d1x / "f3-parallel", "file-f1");
+        fs::remove(d1x / "f3-parallel");
+    }
+
+    // Copy a file with preallocation of the target file and without retaining the copied data in the file cache
+    {
+        error_code ec;
+        file_copied = fs::copy_file(f1x, d1x / "f3-preallocate", fs::copy_options::preallocate, ec);
+        BOOST_TEST(!ec);
+        BOOST_TEST(file_copied);
+        BOOST_TEST_EQ(fs::file_size(d1x / "f3-preallocate"), fs::file_size(f1x));
+        verify_file(d1x / "f3-preallocate", "file-f1");
+        fs::remove(d1x / "f3-preallocate");
+
+        file_copied = fs::copy_file(f1x, d1x / "f3-drop-cache", fs::copy_options::preallocate | fs::copy_options::drop_cache, ec);
+        BOOST_TEST(!ec);
+        BOOST_TEST(file_copied);
+        verify_file(d1x / "f3-drop-cache", "file-f1");
+        fs::remove(d1x / "f3-drop-cache");
+    }
+
+    // Copy a file bypassing the file cache. Test a file that is larger than the internal buffer and is not a multiple of the block size.
+    {
+        const fs::path large_path = d1x / "large";
+        const fs::path large_copy_path = d1x / "large-unbuffered";
+        {
+            std::ofstream f(BOOST_FILESYSTEM_C_STR(large_path), std::ios_base::out | std::ios_base::binary);
+            for (unsigned int i = 0u; i < 3u * 1024u * 1024u + 123u; ++i)
+                f.put(static_cast< char >(i % 251u));
+        }
+
+        error_code ec;
+        file_copied = fs::copy_file(large_path, large_copy_path, fs::copy_options::unbuffered, ec);
+        BOOST_TEST(!ec);
+        BOOST_TEST(file_copied);
+        BOOST_TEST_EQ(fs::file_size(large_copy_path), fs::file_size(large_path));
+
+        std::ifstream f1(BOOST_FILESYSTEM_C_STR(large_path), std::ios_base::in | std::ios_base::binary);
+        std::ifstream f2(BOOST_FILESYSTEM_C_STR(large_copy_path), std::ios_base::in | std::ios_base::binary);
+        BOOST_TEST(std::equal(std::istreambuf_iterator< char >(f1), std::istreambuf_iterator< char >(), std::istreambuf_iterator< char >(f2)));
+        f1.close();
+        f2.close();
+
+        fs::remove(large_copy_path);
+
+        file_copied = fs::copy_file(f1x, d1x / "f3-unbuffered", fs::copy_options::unbuffered, ec);
+        BOOST_TEST(!ec);
+        BOOST_TEST(file_copied);
+        verify_file(d1x / "f3-unbuffered", "file-f1");
+        fs::remove(d1x / "f3-unbuffered");
+        fs::remove(large_path);
+    }
+
+    // Report progress and cancel copying
+    {
+        copy_progress_state state = {};
+        error_code ec;
+        file_copied = fs::copy_file(f1x, d1x / "f3-progress", fs::copy_options::none, &test_copy_progress, &state, ec);
+        BOOST_TEST(!ec);
+        BOOST_TEST(file_copied);
+        BOOST_TEST_GE(state.calls, 1u);
+        BOOST_TEST_EQ(state.total_bytes, fs::file_size(f1x));
+        BOOST_TEST_EQ(state.bytes_copied, state.total_bytes);
+        verify_file(d1x / "f3-progress", "file-f1");
+        fs::remove(d1x / "f3-progress");
+
+        state.calls = 0u;
+        state.cancel = true;
+        file_copied = fs::copy_file(f1x, d1x / "f3-progress", fs::copy_options::none, &test_copy_progress, &state, ec);
+        BOOST_TEST(!!ec);
+        BOOST_TEST(!file_copied);
+        BOOST_TEST_EQ(state.calls, 1u);
+        BOOST_TEST(!fs::exists(d1x / "f3-progress"));
+        BOOST_TEST_THROWS(fs::copy_file(f1x, d1x / "f3-progress", fs::copy_options::none, &test_copy_progress, &state), fs::filesystem_error);
+        fs::remove(d1x / "f3-progress");
+
+        // Progress is reported for every file copied by recursive copy
+        const fs::path src_dir = d1x / "progress-src";
+        const fs::path dst_dir = d1x / "progress-dst";
+        fs::create_directories(src_dir / "sub");
+        create_file(src_dir / "a", "file-a");
+        create_file(src_dir / "sub" / "b", "file-b");
+        state.calls = 0u;
+        state.cancel = false;
+        fs::copy(src_dir, dst_dir, fs::copy_options::recursive, &test_copy_progress, &state, ec);
+        BOOST_TEST(!ec);
+        BOOST_TEST_GE(state.calls, 2u);
+        verify_file(dst_dir / "sub" / "b", "file-b");
+        fs::remove_all(dst_dir);
+
+        state.cancel = true;
+        fs::copy(src_dir, dst_dir, fs::copy_options::recursive, &test_copy_progress, &state, ec);
+        BOOST_TEST(!!ec);
+        fs::remove_all(dst_dir);
+        fs::remove_all(src_dir);
+    }
+
+    // Synchronize multiple copied files at once
+    {
+        fs::sync_group group;
+        error_code ec;
+        file_copied = fs::copy_file(f1x, d1x / "f3-group1", fs::copy_options::none, group, ec);
+        BOOST_TEST(!ec);
+        BOOST_TEST(file_copied);
+        file_copied = fs::copy_file(f1x, d1x / "f3-group2", fs::copy_options::synchronize, group);
+        BOOST_TEST(file_copied);
+        group.add(f1x, ec);
+        BOOST_TEST(!ec);
+        group.commit(ec);
+        BOOST_TEST(!ec);
+        verify_file(d1x / "f3-group1", "file-f1");
+        verify_file(d1x / "f3-group2", "file-f1");
+
+        // Committing an empty group is not an error
+        group.commit();
+
+        group.add(d1x / "nonexistent", ec);
+        BOOST_TEST(!!ec);
+        BOOST_TEST_THROWS(group.add(d1x / "nonexistent"), fs::filesystem_error);
+
+        fs::remove(d1x / "f3-group1");
+        fs::remove(d1x / "f3-group2");
+    }
+
+    // Copy buffers are allocated with the user-provided allocator
+    {
+        const fs::copy_buffer_allocator allocator = { &test_copy_buffer_allocate, &test_copy_buffer_deallocate };
+        fs::set_copy_buffer_allocator(&allocator);
+
+        error_code ec;
+        // copy_options::drop_cache forces copying through a buffer on POSIX systems
+        file_copied = fs::copy_file(f1x, d1x / "f3-allocator", fs::copy_options::drop_cache, ec);
+        BOOST_TEST(!ec);
+        BOOST_TEST(file_copied);
+        verify_file(d1x / "f3-allocator", "file-f1");
+        fs::remove(d1x / "f3-allocator");
+
+        fs::set_copy_buffer_allocator(NULL);
+
+        // Buffers allocated with the previous allocator are released when the buffer is needed again
+        file_copied = fs::copy_file(f1x, d1x / "f3-allocator", fs::copy_options::drop_cache, ec);
+        BOOST_TEST(!ec);
+        BOOST_TEST(file_copied);
+        fs::remove(d1x / "f3-allocator");
+
+#if defined(BOOST_POSIX_API)
+        BOOST_TEST_GT(copy_buffer_allocations, 0u);
+#endif
+        BOOST_TEST_EQ(copy_buffer_deallocations, copy_buffer_allocations);
+    }
+
     // Test copy_file with special files with generated content. Such files have zero size,
     // but have contents.
     if (fs::is_regular_file("/proc/self/cmdline"))
@@ -2225,6 +3860,368 @@ void creation_time_tests(const fs::path& dirx)
     fs::remove(f1x);
 }
 
+//  query_tests  ---------------------------------------------------------------------//
+
+void query_tests(const fs::path& dirx)
+{
+    cout << "query_tests..." << endl;
+
+    fs::path f1x = dirx / "query_file";
+    create_file(f1x, "query_file");
+
+    fs::file_attributes attrs = fs::query(f1x, fs::file_attribute_mask::all);
+    BOOST_TEST((attrs.mask & fs::file_attribute_mask::type) != fs::file_attribute_mask::none);
+    BOOST_TEST_EQ(attrs.status.type(), fs::regular_file);
+    if ((attrs.mask & fs::file_attribute_mask::permissions) != fs::file_attribute_mask::none)
+        BOOST_TEST_EQ(attrs.status.permissions(), fs::status(f1x).permissions());
+    if ((attrs.mask & fs::file_attribute_mask::size) != fs::file_attribute_mask::none)
+        BOOST_TEST_EQ(attrs.size, fs::file_size(f1x));
+    if ((attrs.mask & fs::file_attribute_mask::hard_link_count) != fs::file_attribute_mask::none)
+        BOOST_TEST_EQ(attrs.hard_link_count, fs::hard_link_count(f1x));
+    if ((attrs.mask & fs::file_attribute_mask::last_write_time) != fs::file_attribute_mask::none)
+        BOOST_TEST_EQ(attrs.last_write_time, fs::last_write_time(f1x));
+
+    // Only the requested attributes are reported
+    attrs = fs::query(f1x, fs::file_attribute_mask::size);
+    BOOST_TEST((attrs.mask & fs::file_attribute_mask::size) != fs::file_attribute_mask::none);
+    BOOST_TEST((attrs.mask & ~fs::file_attribute_mask::size) == fs::file_attribute_mask::none);
+    BOOST_TEST_EQ(attrs.size, 10u);
+
+    attrs = fs::query(dirx, fs::file_attribute_mask::type | fs::file_attribute_mask::inode);
+    BOOST_TEST_EQ(attrs.status.type(), fs::directory_file);
+
+    if (create_symlink_ok)
+    {
+        fs::path s1x = dirx / "query_symlink";
+        fs::create_symlink(f1x, s1x);
+        attrs = fs::query(s1x, fs::file_attribute_mask::type);
+        BOOST_TEST_EQ(attrs.status.type(), fs::regular_file);
+        attrs = fs::query(s1x, fs::file_attribute_mask::type | fs::file_attribute_mask::no_follow);
+        BOOST_TEST_EQ(attrs.status.type(), fs::symlink_file);
+        fs::remove(s1x);
+    }
+
+    error_code ec;
+    attrs = fs::query(dirx / "no-such-file", fs::file_attribute_mask::all, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(attrs.mask == fs::file_attribute_mask::none);
+    BOOST_TEST(CHECK_EXCEPTION(bad_query, ENOENT));
+
+    // Precise file times
+    fs::last_write_time(f1x, fs::file_time(1000000000, 123456789u));
+    fs::file_time t = fs::precise_last_write_time(f1x);
+    BOOST_TEST_EQ(t.seconds, 1000000000);
+    // The filesystem may not support nanosecond precision
+    BOOST_TEST_LE(t.nanoseconds, 123456789u);
+    BOOST_TEST_EQ(fs::last_write_time(f1x), 1000000000);
+    attrs = fs::query(f1x, fs::file_attribute_mask::last_write_time);
+    BOOST_TEST(attrs.precise_last_write_time() == t);
+
+    // Bulk query
+    fs::path paths[3] = { f1x, dirx, dirx / "no-such-file" };
+    fs::file_attributes results[3];
+    fs::query(paths, 3u, fs::file_attribute_mask::type | fs::file_attribute_mask::last_write_time, results);
+    BOOST_TEST_EQ(results[0].status.type(), fs::regular_file);
+    BOOST_TEST(results[0].precise_last_write_time() == t);
+    BOOST_TEST_EQ(results[1].status.type(), fs::directory_file);
+    BOOST_TEST(results[2].mask == fs::file_attribute_mask::none);
+
+    fs::remove(f1x);
+}
+
+//  set_attributes_tests  ------------------------------------------------------------//
+
+void set_attributes_tests(const fs::path& dirx)
+{
+    cout << "set_attributes_tests..." << endl;
+
+    fs::path f1x = dirx / "set_attributes_file";
+    create_file(f1x, "set_attributes_file");
+
+    fs::file_attribute_set attrs;
+    attrs.mask = fs::file_attribute_mask::last_write_time | fs::file_attribute_mask::last_access_time;
+    attrs.last_write_time = fs::file_time(1000000000, 500000000u);
+    attrs.last_access_time = fs::file_time(1100000000);
+    fs::set_attributes(f1x, attrs);
+    BOOST_TEST_EQ(fs::last_write_time(f1x), 1000000000);
+
+    if (create_symlink_ok) // POSIX-like permissions only if symlinks are supported
+    {
+        attrs.mask = fs::file_attribute_mask::permissions;
+        attrs.permissions = fs::owner_read | fs::owner_write | fs::group_read;
+        fs::set_attributes(f1x, attrs);
+        BOOST_TEST_EQ(fs::status(f1x).permissions(), fs::owner_read | fs::owner_write | fs::group_read);
+        // Modification time is preserved when not selected
+        BOOST_TEST_EQ(fs::last_write_time(f1x), 1000000000);
+    }
+
+    fs::file_attributes current = fs::query(f1x, fs::file_attribute_mask::owner);
+    if ((current.mask & fs::file_attribute_mask::owner) != fs::file_attribute_mask::none)
+    {
+        // Changing the ownership to the current owner is always permitted
+        attrs.mask = fs::file_attribute_mask::owner;
+        attrs.owner_id = current.owner_id;
+        attrs.group_id = fs::file_attribute_set::unchanged_id;
+        fs::set_attributes(f1x, attrs);
+        BOOST_TEST_EQ(fs::query(f1x, fs::file_attribute_mask::owner).owner_id, current.owner_id);
+    }
+
+    // Bulk application
+    fs::path paths[2] = { f1x, dirx / "no-such-file" };
+    fs::file_attribute_set batch_attrs[2];
+    batch_attrs[0].mask = batch_attrs[1].mask = fs::file_attribute_mask::last_write_time;
+    batch_attrs[0].last_write_time = batch_attrs[1].last_write_time = fs::file_time(1200000000);
+    error_code results[2];
+    fs::set_attributes(paths, batch_attrs, 2u, results);
+    BOOST_TEST(!results[0]);
+    BOOST_TEST(!!results[1]);
+    BOOST_TEST_EQ(fs::last_write_time(f1x), 1200000000);
+
+    error_code ec;
+    fs::set_attributes(dirx / "no-such-file", batch_attrs[1], ec);
+    BOOST_TEST(!!ec);
+
+    fs::remove(f1x);
+}
+
+//  read_write_file_tests  -----------------------------------------------------------//
+
+void read_write_file_tests(const fs::path& dirx)
+{
+    cout << "read_write_file_tests..." << endl;
+
+    fs::path f1x = dirx / "read_write_file";
+    std::string contents;
+    for (unsigned int i = 0u; i < 10000u; ++i)
+        contents += static_cast< char >('a' + i % 26u);
+
+    fs::write_file(f1x, contents);
+    BOOST_TEST_EQ(fs::file_size(f1x), contents.size());
+    BOOST_TEST(fs::read_file(f1x) == contents);
+
+    // Existing contents are truncated
+    fs::write_file(f1x, "abc", 3u);
+    std::string buffer("previous contents");
+    fs::read_file(f1x, buffer);
+    BOOST_TEST_EQ(buffer, "abc");
+
+    fs::write_file(f1x, std::string("def"), fs::write_file_options::append | fs::write_file_options::synchronize_data);
+    BOOST_TEST_EQ(fs::read_file(f1x), "abcdef");
+
+    fs::write_file(f1x, std::string(), fs::write_file_options::none);
+    BOOST_TEST(fs::read_file(f1x).empty());
+
+    // Atomic replacement leaves no temporary files behind
+    fs::write_file(f1x, contents, fs::write_file_options::atomic_replace | fs::write_file_options::synchronize);
+    BOOST_TEST(fs::read_file(f1x) == contents);
+    unsigned int file_count = 0u;
+    for (fs::directory_iterator it(dirx), end; it != end; ++it)
+    {
+        if (it->path().filename().string().find("read_write_file") != std::string::npos)
+            ++file_count;
+    }
+    BOOST_TEST_EQ(file_count, 1u);
+
+    error_code ec;
+    fs::write_file(f1x, contents, fs::write_file_options::atomic_replace | fs::write_file_options::append, ec);
+    BOOST_TEST(!!ec);
+    fs::read_file(dirx / "no-such-file", buffer, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(buffer.empty());
+    fs::read_file(dirx, buffer, ec);
+    BOOST_TEST(!!ec);
+    fs::write_file(dirx / "no-such-dir" / "file", contents, ec);
+    BOOST_TEST(!!ec);
+
+#if defined(BOOST_POSIX_API) && (defined(linux) || defined(__linux) || defined(__linux__))
+    // Files with generated contents report zero size
+    if (fs::exists("/proc/self/status"))
+    {
+        buffer = fs::read_file("/proc/self/status");
+        BOOST_TEST(!buffer.empty());
+    }
+#endif
+
+    fs::remove(f1x);
+}
+
+//  atomic_write_tests  --------------------------------------------------------------//
+
+void atomic_write_tests(const fs::path& dirx)
+{
+    cout << "atomic_write_tests..." << endl;
+
+    const fs::path d1 = dirx / "atomic_write";
+    fs::create_directory(d1);
+    fs::create_directory(d1 / "sub");
+
+    fs::atomic_write_file(d1 / "f1", std::string("first"));
+    BOOST_TEST_EQ(fs::read_file(d1 / "f1"), "first");
+    fs::atomic_write_file(d1 / "f1", "second", 6u, fs::write_file_options::none);
+    BOOST_TEST_EQ(fs::read_file(d1 / "f1"), "second");
+
+    const std::string c1("config"), c2("manifest"), c3("data");
+    fs::atomic_write_entry entries[3] =
+    {
+        fs::atomic_write_entry(d1 / "f1", c1),
+        fs::atomic_write_entry(d1 / "f2", c2),
+        fs::atomic_write_entry(d1 / "sub" / "f3", c3.data(), c3.size())
+    };
+    fs::atomic_commit(entries, 3u);
+    BOOST_TEST_EQ(fs::read_file(d1 / "f1"), c1);
+    BOOST_TEST_EQ(fs::read_file(d1 / "f2"), c2);
+    BOOST_TEST_EQ(fs::read_file(d1 / "sub" / "f3"), c3);
+
+    // No temporary files are left behind
+    BOOST_TEST_EQ(std::distance(fs::directory_iterator(d1), fs::directory_iterator()), 3);
+    BOOST_TEST_EQ(std::distance(fs::directory_iterator(d1 / "sub"), fs::directory_iterator()), 1);
+
+    // If one of the temporary files cannot be created, none of the files are replaced
+    error_code ec;
+    entries[0].data = "changed";
+    entries[0].size = 7u;
+    entries[2].target = d1 / "no-such-dir" / "f3";
+    fs::atomic_commit(entries, 3u, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST_EQ(fs::read_file(d1 / "f1"), c1);
+    BOOST_TEST_EQ(std::distance(fs::directory_iterator(d1), fs::directory_iterator()), 3);
+    BOOST_TEST_THROWS(fs::atomic_commit(entries, 3u, fs::write_file_options::none), fs::filesystem_error);
+
+    fs::atomic_commit(entries, 0u, ec);
+    BOOST_TEST(!ec);
+    fs::atomic_write_file(d1 / "f1", c1, fs::write_file_options::append, ec);
+    BOOST_TEST(!!ec);
+
+    fs::remove_all(d1);
+}
+
+//  move_tests  ----------------------------------------------------------------------//
+
+void move_tests(const fs::path& dirx)
+{
+    cout << "move_tests..." << endl;
+
+    const fs::path d1 = dirx / "move";
+    fs::create_directories(d1 / "tree" / "sub");
+    create_file(d1 / "tree" / "f1", "file-f1");
+    create_file(d1 / "tree" / "sub" / "f2", "file-f2");
+    create_file(d1 / "f3", "file-f3");
+    create_file(d1 / "f4", "file-f4");
+
+    // Within a filesystem, move is a rename
+    fs::move(d1 / "tree", d1 / "moved");
+    BOOST_TEST(!fs::exists(d1 / "tree"));
+    verify_file(d1 / "moved" / "sub" / "f2", "file-f2");
+
+    fs::move(d1 / "f3", d1 / "f4");
+    BOOST_TEST(!fs::exists(d1 / "f3"));
+    verify_file(d1 / "f4", "file-f3");
+
+    error_code ec;
+    fs::move(d1 / "nonexistent", d1 / "f5", fs::move_options::none, 0u, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST_THROWS(fs::move(d1 / "nonexistent", d1 / "f5"), fs::filesystem_error);
+    fs::move(d1 / "f4", d1 / "f5", fs::move_options::no_replace | fs::move_options::exchange, 0u, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(fs::exists(d1 / "f4"));
+
+    // no_replace and exchange may not be supported by the system or the filesystem
+    create_file(d1 / "f6", "file-f6");
+    fs::move(d1 / "f6", d1 / "f4", fs::move_options::no_replace, 0u, ec);
+    BOOST_TEST(!!ec);
+    verify_file(d1 / "f4", "file-f3");
+    fs::move(d1 / "f6", d1 / "f7", fs::move_options::no_replace, 0u, ec);
+    if (!ec)
+    {
+        BOOST_TEST(!fs::exists(d1 / "f6"));
+        verify_file(d1 / "f7", "file-f6");
+    }
+    else
+    {
+        fs::rename(d1 / "f6", d1 / "f7");
+    }
+
+    fs::move(d1 / "f4", d1 / "f7", fs::move_options::exchange, 0u, ec);
+    if (!ec)
+    {
+        verify_file(d1 / "f4", "file-f6");
+        verify_file(d1 / "f7", "file-f3");
+    }
+
+    // exchange falls back to renames if atomic exchange is not supported
+    fs::create_directories(d1 / "blue");
+    create_file(d1 / "blue" / "version", "blue");
+    fs::exchange(d1 / "moved", d1 / "blue");
+    verify_file(d1 / "moved" / "version", "blue");
+    verify_file(d1 / "blue" / "f1", "file-f1");
+    fs::exchange(d1 / "moved", d1 / "blue", ec);
+    BOOST_TEST(!ec);
+    verify_file(d1 / "blue" / "version", "blue");
+    BOOST_TEST_EQ(std::distance(fs::directory_iterator(d1), fs::directory_iterator()), 4);
+    fs::exchange(d1 / "moved", d1 / "nonexistent", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(fs::exists(d1 / "moved" / "f1"));
+    BOOST_TEST_THROWS(fs::exchange(d1 / "nonexistent", d1 / "moved"), fs::filesystem_error);
+    fs::remove_all(d1 / "blue");
+
+    // Moving to a different filesystem copies the files, if there is another filesystem to test with
+    const fs::path other = fs::path("/dev/shm");
+    if (fs::is_directory(other, ec) &&
+        fs::query(other, fs::file_attribute_mask::device, ec).device != fs::query(d1, fs::file_attribute_mask::device).device && !ec)
+    {
+        const fs::path target = other / fs::unique_path("boost_fs_move_test-%%%%-%%%%");
+        fs::move(d1 / "moved", target, fs::move_options::no_copy, 0u, ec);
+        BOOST_TEST(!!ec);
+        BOOST_TEST(fs::exists(d1 / "moved"));
+        fs::move(d1 / "moved", target, fs::move_options::exchange, 0u, ec);
+        BOOST_TEST(!!ec);
+
+        fs::move(d1 / "moved", target, fs::move_options::none, 2u);
+        BOOST_TEST(!fs::exists(d1 / "moved"));
+        verify_file(target / "f1", "file-f1");
+        verify_file(target / "sub" / "f2", "file-f2");
+
+        // A non-empty directory is not replaced
+        fs::create_directories(d1 / "moved" / "sub");
+        fs::move(d1 / "moved", target, fs::move_options::none, 0u, ec);
+        BOOST_TEST(!!ec);
+        BOOST_TEST(fs::exists(d1 / "moved" / "sub"));
+
+        fs::remove(d1 / "moved" / "sub");
+        fs::move(target, d1 / "moved");
+        BOOST_TEST(!fs::exists(target));
+        verify_file(d1 / "moved" / "sub" / "f2", "file-f2");
+
+        fs::move(d1 / "f7", target / "f7", fs::move_options::none, 0u, ec);
+        BOOST_TEST(!!ec); // no parent directory
+        create_file(target, "existing");
+        fs::move(d1 / "f7", target, fs::move_options::no_replace, 0u, ec);
+        BOOST_TEST(!!ec);
+        verify_file(target, "existing");
+        fs::move(d1 / "f7", target);
+        BOOST_TEST(!fs::exists(d1 / "f7"));
+        fs::remove(target);
+
+#if defined(BOOST_POSIX_API)
+        // The existing target is kept if the copy fails
+        create_file(target, "existing");
+        if (::mkfifo((d1 / "fifo").c_str(), S_IRUSR | S_IWUSR) == 0)
+        {
+            fs::move(d1 / "fifo", target, fs::move_options::none, 0u, ec);
+            BOOST_TEST(!!ec);
+            BOOST_TEST(fs::exists(d1 / "fifo"));
+            verify_file(target, "existing");
+            for (fs::directory_iterator it(other), end; it != end; ++it)
+                BOOST_TEST(it->path().filename().string().compare(0u, target.filename().string().size() + 1u, "." + target.filename().string()) != 0);
+            fs::remove(d1 / "fifo");
+        }
+        fs::remove(target);
+#endif
+    }
+
+    fs::remove_all(d1);
+}
+
 //  write_time_tests  ----------------------------------------------------------------//
 
 void write_time_tests(const fs::path& dirx)
@@ -2446,6 +4443,39 @@ void equivalent_tests(const fs::path& f1x)
     BOOST_TEST(!fs::equivalent(ng, dir));
     BOOST_TEST(!fs::equivalent(f1x, ng));
     BOOST_TEST(!fs::equivalent(ng, f1x));
+
+    // File identities
+    BOOST_TEST(fs::identity(f1x) == fs::identity(dir / "f1"));
+    BOOST_TEST(fs::identity(dir) == fs::identity(d1 / ".."));
+    BOOST_TEST(fs::identity(f1x) != fs::identity(dir));
+    BOOST_TEST_EQ(hash_value(fs::identity(f1x)), hash_value(fs::identity(dir / "f1")));
+    BOOST_TEST(fs::identity(d1) < fs::identity(d2) || fs::identity(d2) < fs::identity(d1));
+    error_code ec;
+    BOOST_TEST(fs::identity(ng, ec) == fs::file_identity());
+    BOOST_TEST(!!ec);
+
+    // Directory entries use the cached identities
+    const fs::directory_entry e_f1(f1x), e_dir(dir), e_ng(ng);
+    BOOST_TEST(fs::equivalent(e_f1, fs::directory_entry(dir / "f1")));
+    BOOST_TEST(fs::equivalent(e_dir, fs::directory_entry(d1 / "..")));
+    BOOST_TEST(!fs::equivalent(e_f1, e_dir));
+    BOOST_TEST(!fs::equivalent(e_dir, e_ng));
+    BOOST_TEST(!fs::equivalent(e_ng, e_f1));
+    BOOST_TEST(e_f1.identity() == fs::identity(f1x));
+    fs::equivalent(e_ng, fs::directory_entry(dir / "also-missing"), ec);
+    BOOST_TEST(!!ec);
+
+    bool found = false;
+    for (fs::directory_iterator it(dir), end; it != end; ++it)
+    {
+        if (it->path().filename() == "f1")
+        {
+            BOOST_TEST(it->identity() == fs::identity(f1x));
+            BOOST_TEST(fs::equivalent(*it, e_f1));
+            found = true;
+        }
+    }
+    BOOST_TEST(found);
 }
 
 //  temp_directory_path_tests  -------------------------------------------------------//
@@ -2556,6 +4586,29 @@ void temp_directory_path_tests()
         }
         remove(ph);
         BOOST_TEST(!exists(ph));
+
+        // The returned directory is checked to exist on every call, even if the path is cached
+        {
+            fs::path p = fs::temp_directory_path() / fs::unique_path("temp_directory_path_test_%%%%_%%%%");
+            fs::create_directory(p);
+#if defined(BOOST_WINDOWS_API)
+            guarded_env_var tmp_guard("TMP", p.string().c_str());
+#else
+            guarded_env_var tmp_guard("TMPDIR", p.string().c_str());
+#endif
+            BOOST_TEST_EQ(fs::temp_directory_path(), p);
+            fs::remove(p);
+
+            error_code ec;
+            fs::path tmp_path = fs::temp_directory_path(ec);
+#if defined(BOOST_WINDOWS_API)
+            // The next candidate directory is selected instead
+            BOOST_TEST(!ec);
+            BOOST_TEST_NE(tmp_path, p);
+#else
+            BOOST_TEST(ec);
+#endif
+        }
     }
 
     fs::path test_temp_dir = temp_dir;
@@ -2649,6 +4702,56 @@ void temp_directory_path_tests()
 #endif
 }
 
+//  unique_path_tests  ---------------------------------------------------------------//
+
+void unique_path_tests()
+{
+    cout << "unique_path_tests..." << endl;
+
+    // Generate enough names to exhaust the internal random buffers several times
+    std::set< fs::path > names;
+    for (unsigned int i = 0u; i < 10000u; ++i)
+    {
+        fs::path name = fs::unique_path("%%%%-%%%%-%%%%-%%%%-%%%%-%%%%-%%%%-%%%%-%%%%");
+        BOOST_TEST_EQ(name.string().size(), 44u);
+        BOOST_TEST(names.insert(name).second);
+    }
+
+    error_code ec(1, boost::system::system_category());
+    fs::path name = fs::unique_path("no-placeholders", ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST_EQ(name, fs::path("no-placeholders"));
+
+#if defined(BOOST_POSIX_API) && !defined(__wasm)
+    // A child process must not generate the same names as the parent
+    int fds[2];
+    if (::pipe(fds) == 0)
+    {
+        fs::unique_path("%%%%"); // make sure the generator is initialized before fork
+        pid_t pid = ::fork();
+        if (pid == 0)
+        {
+            std::string child_name = fs::unique_path("%%%%%%%%%%%%%%%%").string();
+            ssize_t written = ::write(fds[1], child_name.data(), child_name.size());
+            ::_exit(written == static_cast< ssize_t >(child_name.size()) ? 0 : 1);
+        }
+        else if (pid > 0)
+        {
+            std::string parent_name = fs::unique_path("%%%%%%%%%%%%%%%%").string();
+            char child_name[16];
+            ssize_t n = ::read(fds[0], child_name, sizeof(child_name));
+            int status = 0;
+            ::waitpid(pid, &status, 0);
+            BOOST_TEST_EQ(n, static_cast< ssize_t >(sizeof(child_name)));
+            if (n == static_cast< ssize_t >(sizeof(child_name)))
+                BOOST_TEST_NE(parent_name, std::string(child_name, sizeof(child_name)));
+        }
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+#endif
+}
+
 //  weakly_canonical_basic_tests  ----------------------------------------------------//
 
 void weakly_canonical_basic_tests()
@@ -2780,6 +4883,7 @@ int cpp_main(int argc, char* argv[])
     status_error_reporting_tests();
     directory_iterator_tests();
     create_directories_tests(); // must run AFTER directory_iterator_tests
+    create_directories_batch_tests();
 
     bad_create_directory_path = f1;
     BOOST_TEST(CHECK_EXCEPTION(bad_create_directory, EEXIST));
@@ -2795,6 +4899,8 @@ int cpp_main(int argc, char* argv[])
     create_hard_link_tests();
     create_symlink_tests();
     resize_file_tests();
+    file_range_tests();
+    prefetch_tests();
     absolute_tests();
     canonical_basic_tests();
     weakly_canonical_basic_tests();
@@ -2809,19 +4915,38 @@ int cpp_main(int argc, char* argv[])
     }
     iterator_status_tests(); // lots of cases by now, so a good time to test
                              //  dump_tree(dir);
+    iterator_attribute_tests();
+    directory_iterator_buffer_size_tests();
+    sorted_directory_iterator_tests();
+    prefetch_directory_iterator_tests();
+    for_each_name_tests();
+    directory_cursor_tests();
+    directory_entry_count_hint_tests();
+    statuses_tests();
+    status_consistency_tests();
     recursive_directory_iterator_tests();
+    recursive_directory_iterator_traversal_tests();
+    recursive_directory_iterator_observer_tests();
+    recursive_directory_iterator_checkpoint_tests();
     recursive_iterator_status_tests(); // lots of cases by now, so a good time to test
     rename_tests();
     remove_tests(dir);
     remove_all_tests(dir);
+    gradual_remove_tests(dir);
     if (create_symlink_ok) // only if symlinks supported
     {
         remove_symlink_tests();
         remove_all_symlink_tests(dir);
     }
     creation_time_tests(dir);
+    query_tests(dir);
+    set_attributes_tests(dir);
+    read_write_file_tests(dir);
+    atomic_write_tests(dir);
+    move_tests(dir);
     write_time_tests(dir);
     temp_directory_path_tests();
+    unique_path_tests();
 
     platform_specific_tests(); // do these last since they take a lot of time on Windows,
                                // and that's a pain during manual testing
@@ -0,0 +1,738 @@
+//  parallel_walk_test.cpp  ------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/parallel_walk.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/backends.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#if defined(BOOST_FILESYSTEM_HAS_PARALLEL_WALK)
+
+#include <cstddef>
+#include <algorithm>
+#include <mutex>
+#include <future>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+struct collector
+{
+    std::mutex* mutex;
+    std::vector< fs::path >* paths;
+    std::size_t* largest_batch;
+
+    void operator()(std::vector< fs::directory_entry >& batch) const
+    {
+        std::lock_guard< std::mutex > lock(*mutex);
+        if (batch.size() > *largest_batch)
+            *largest_batch = batch.size();
+        for (std::size_t i = 0u; i < batch.size(); ++i)
+            paths->push_back(batch[i].path());
+    }
+};
+
+struct throwing_handler
+{
+    void operator()(std::vector< fs::directory_entry >&) const
+    {
+        throw std::runtime_error("test");
+    }
+};
+
+struct attributes_collector
+{
+    std::mutex* mutex;
+    std::vector< fs::file_attributes >* attrs;
+
+    void operator()(std::vector< fs::file_attributes >& batch) const
+    {
+        std::lock_guard< std::mutex > lock(*mutex);
+        attrs->insert(attrs->end(), batch.begin(), batch.end());
+    }
+};
+
+void create_tree(fs::path const& root)
+{
+    fs::create_directories(root);
+    for (unsigned int i = 0u; i < 5u; ++i)
+    {
+        fs::path dir = root / ("dir" + std::to_string(i));
+        fs::create_directory(dir);
+        for (unsigned int j = 0u; j < 4u; ++j)
+        {
+            fs::path subdir = dir / ("sub" + std::to_string(j));
+            fs::create_directory(subdir);
+            for (unsigned int k = 0u; k < 7u; ++k)
+                create_file(subdir / ("file" + std::to_string(k)));
+        }
+        create_file(dir / "file");
+    }
+    create_file(root / "file");
+}
+
+//! Creates a tree of many narrow branches, so that directories several levels deep are enumerated concurrently
+void create_deep_tree(fs::path const& root)
+{
+    for (unsigned int i = 0u; i < 300u; ++i)
+    {
+        fs::path dir = root / ("a" + std::to_string(i)) / "b" / "c";
+        fs::create_directories(dir);
+        create_file(dir / "f");
+    }
+}
+
+std::vector< fs::path > list_tree(fs::path const& root)
+{
+    std::vector< fs::path > paths;
+    for (fs::recursive_directory_iterator it(root), end; it != end; ++it)
+        paths.push_back(it->path());
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+void test_walk(fs::path const& root, std::vector< fs::path > const& expected, unsigned int thread_count, std::size_t batch_size)
+{
+    std::mutex mutex;
+    std::vector< fs::path > paths;
+    std::size_t largest_batch = 0u;
+    collector c = { &mutex, &paths, &largest_batch };
+
+    fs::parallel_directory_walker walker(thread_count);
+    walker.set_batch_size(batch_size);
+    BOOST_TEST_EQ(walker.thread_count(), thread_count);
+    BOOST_TEST_EQ(walker.batch_size(), batch_size);
+
+    boost::system::error_code ec;
+    walker.walk(root, c, ec);
+    BOOST_TEST(!ec);
+
+    std::sort(paths.begin(), paths.end());
+    BOOST_TEST(paths == expected);
+    BOOST_TEST_LE(largest_batch, batch_size);
+}
+
+std::vector< fs::path > list_tree_relative(fs::path const& root)
+{
+    std::vector< fs::path > paths;
+    for (fs::recursive_directory_iterator it(root), end; it != end; ++it)
+        paths.push_back(it->path().lexically_relative(root));
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+void test_copy(fs::path const& root, fs::path const& target, unsigned int thread_count)
+{
+    boost::system::error_code ec;
+    fs::parallel_copy(root, target, fs::copy_options::none, thread_count, ec);
+    BOOST_TEST(!ec);
+
+    const std::vector< fs::path > expected = list_tree_relative(root);
+    const std::vector< fs::path > copied = list_tree_relative(target);
+    BOOST_TEST(copied == expected);
+    for (std::size_t i = 0u; i < copied.size(); ++i)
+    {
+        if (fs::is_regular_file(target / copied[i]))
+            BOOST_TEST_EQ(fs::file_size(target / copied[i]), fs::file_size(root / copied[i]));
+    }
+
+    fs::remove_all(target);
+}
+
+} // namespace
+
+int main()
+{
+    temp_test_directory temp_dir("parallel_walk_test");
+    const fs::path root = temp_dir.path() / "tree";
+    const fs::path deep_root = temp_dir.path() / "deep";
+    create_tree(root);
+    create_deep_tree(deep_root);
+
+    const std::vector< fs::path > expected = list_tree(root);
+    BOOST_TEST_EQ(expected.size(), 5u * (1u + 4u * (1u + 7u) + 1u) + 1u);
+
+    test_walk(root, expected, 1u, fs::parallel_directory_walker::default_batch_size);
+    test_walk(root, expected, 4u, fs::parallel_directory_walker::default_batch_size);
+    test_walk(root, expected, 4u, 3u);
+    test_walk(root, expected, 0u, 1u);
+
+    // Exceptions from the handler are propagated to the caller
+    {
+        fs::parallel_directory_walker walker(4u);
+        BOOST_TEST_THROWS(walker.walk(root, throwing_handler()), std::runtime_error);
+    }
+
+    // Parallel copy
+    {
+        const fs::path target = temp_dir.path() / "copy";
+        test_copy(root, target, 1u);
+        test_copy(root, target, 4u);
+
+        // The operations use fewer threads when the descriptor budget is exhausted
+        fs::set_descriptor_budget(1u);
+        test_copy(root, target, 4u);
+        BOOST_TEST_EQ(fs::descriptor_budget_used(), 0u);
+        fs::set_descriptor_budget(0u);
+
+        // Nested directories are created before their entries are copied
+        for (unsigned int i = 0u; i < 10u; ++i)
+            test_copy(deep_root, target, 16u);
+
+        boost::system::error_code ec;
+        fs::parallel_copy(root / "nonexistent", target, fs::copy_options::none, 2u, ec);
+        BOOST_TEST(!!ec);
+        BOOST_TEST(!fs::exists(target));
+
+        // Copying over existing files reports an error, unless overwriting is requested
+        fs::parallel_copy(root, target);
+        BOOST_TEST_THROWS(fs::parallel_copy(root, target, fs::copy_options::none, 2u), fs::filesystem_error);
+        fs::parallel_copy(root, target, fs::copy_options::overwrite_existing, 2u, ec);
+        BOOST_TEST(!ec);
+        fs::remove_all(target);
+    }
+
+    // Parallel remove_all
+    {
+        const fs::path target = temp_dir.path() / "remove";
+        fs::parallel_copy(root, target);
+        const std::size_t file_count = list_tree(target).size() + 1u;
+        BOOST_TEST_EQ(fs::parallel_remove_all(target, 4u), file_count);
+        BOOST_TEST(!fs::exists(target));
+
+        fs::parallel_copy(root, target);
+        boost::system::error_code ec;
+        BOOST_TEST_EQ(fs::parallel_remove_all(target, 1u, ec), file_count);
+        BOOST_TEST(!ec);
+        BOOST_TEST(!fs::exists(target));
+
+        BOOST_TEST_EQ(fs::parallel_remove_all(target, 4u, ec), 0u);
+        BOOST_TEST(!ec);
+
+        create_file(target);
+        BOOST_TEST_EQ(fs::parallel_remove_all(target, 4u), 1u);
+        BOOST_TEST(!fs::exists(target));
+
+        // Nested directories are removed in parallel as they are discovered, and each directory after its entries
+        for (unsigned int i = 0u; i < 10u; ++i)
+        {
+            fs::parallel_copy(root, target);
+            fs::parallel_copy(deep_root, target / "deep");
+            const std::size_t deep_count = list_tree(target).size() + 1u;
+            BOOST_TEST_EQ(fs::parallel_remove_all(target, 16u, ec), deep_count);
+            BOOST_TEST(!ec);
+            BOOST_TEST(!fs::exists(target));
+        }
+    }
+
+    // Disk usage
+    {
+        const fs::path target = temp_dir.path() / "du";
+        fs::parallel_copy(root, target);
+
+        fs::disk_usage_info info = fs::disk_usage(target, fs::disk_usage_options::none, 4u);
+        BOOST_TEST_EQ(info.file_count, 5u * (4u * 7u + 1u) + 1u);
+        BOOST_TEST_EQ(info.directory_count, 1u + 5u * (1u + 4u));
+        BOOST_TEST_EQ(info.apparent_size, info.file_count);
+        boost::uintmax_t allocated_size = fs::query(target, fs::file_attribute_mask::allocated_size).allocated_size;
+        for (fs::recursive_directory_iterator it(target), end; it != end; ++it)
+            allocated_size += fs::query(it->path(), fs::file_attribute_mask::allocated_size | fs::file_attribute_mask::no_follow).allocated_size;
+        BOOST_TEST_EQ(info.allocated_size, allocated_size);
+
+        // Hard links are counted once, unless requested otherwise
+        fs::create_hard_link(target / "file", target / "link");
+        boost::system::error_code ec;
+        fs::disk_usage_info linked_info = fs::disk_usage(target, fs::disk_usage_options::none, 1u, ec);
+        BOOST_TEST(!ec);
+        BOOST_TEST_EQ(linked_info.file_count, info.file_count);
+        BOOST_TEST_EQ(linked_info.apparent_size, info.apparent_size);
+        linked_info = fs::disk_usage(target, fs::disk_usage_options::count_hard_links);
+        BOOST_TEST_EQ(linked_info.file_count, info.file_count + 1u);
+        BOOST_TEST_EQ(linked_info.apparent_size, info.apparent_size + 1u);
+
+        // A single file
+        info = fs::disk_usage(target / "file");
+        BOOST_TEST_EQ(info.file_count, 1u);
+        BOOST_TEST_EQ(info.directory_count, 0u);
+        BOOST_TEST_EQ(info.apparent_size, 1u);
+
+        info = fs::disk_usage(target / "nonexistent", fs::disk_usage_options::none, 2u, ec);
+        BOOST_TEST(!!ec);
+        BOOST_TEST_EQ(info.file_count, 0u);
+        BOOST_TEST_THROWS(fs::disk_usage(target / "nonexistent"), fs::filesystem_error);
+
+        fs::remove_all(target);
+    }
+
+    // Linking a directory tree
+    {
+        const fs::path target = temp_dir.path() / "links";
+        fs::create_directory(root / "empty");
+        const std::vector< fs::path > expected = list_tree_relative(root);
+        const std::size_t file_count = 5u * (4u * 7u + 1u) + 1u;
+
+        BOOST_TEST_EQ(fs::link_tree(root, target, fs::link_tree_mode::hard_links, 4u), file_count);
+        BOOST_TEST(list_tree_relative(target) == expected);
+        BOOST_TEST(fs::is_directory(target / "empty"));
+        BOOST_TEST(fs::equivalent(target / "dir3" / "sub2" / "file5", root / "dir3" / "sub2" / "file5"));
+        BOOST_TEST_EQ(fs::hard_link_count(root / "file"), 2u);
+
+        // Nested directories are created before their entries are linked
+        for (unsigned int i = 0u; i < 10u; ++i)
+        {
+            BOOST_TEST_EQ(fs::link_tree(deep_root, target / "deep", fs::link_tree_mode::hard_links, 16u), 300u);
+            BOOST_TEST(list_tree_relative(target / "deep") == list_tree_relative(deep_root));
+            fs::remove_all(target / "deep");
+        }
+
+        // Existing files are not replaced
+        boost::system::error_code ec;
+        fs::link_tree(root, target, fs::link_tree_mode::hard_links, 2u, ec);
+        BOOST_TEST(!!ec);
+        BOOST_TEST_THROWS(fs::link_tree(root, target), fs::filesystem_error);
+        fs::remove_all(target);
+
+        fs::link_tree(root, target, fs::link_tree_mode::symlinks, 1u, ec);
+        if (!ec)
+        {
+            BOOST_TEST(list_tree_relative(target) == expected);
+            BOOST_TEST(fs::is_symlink(target / "dir1" / "sub0" / "file0"));
+            BOOST_TEST(!fs::is_symlink(target / "dir1" / "sub0"));
+            BOOST_TEST(fs::read_symlink(target / "dir1" / "file").is_absolute());
+            BOOST_TEST(fs::equivalent(target / "dir1" / "file", root / "dir1" / "file"));
+        }
+        fs::remove_all(target);
+
+        // A single file
+        BOOST_TEST_EQ(fs::link_tree(root / "file", target), 1u);
+        BOOST_TEST(fs::equivalent(target, root / "file"));
+        fs::remove(target);
+
+        BOOST_TEST_EQ(fs::link_tree(root / "nonexistent", target, fs::link_tree_mode::hard_links, 2u, ec), 0u);
+        BOOST_TEST(!!ec);
+        BOOST_TEST(!fs::exists(target));
+        fs::remove(root / "empty");
+    }
+
+    // Deduplication
+    {
+        const fs::path target = temp_dir.path() / "dedup";
+        const fs::path cache = temp_dir.path() / "dedup.cache";
+        fs::create_directories(target / "a" / "b");
+        {
+            fs::ofstream(target / "one") << "duplicate";
+            fs::ofstream(target / "a" / "two") << "duplicate";
+            fs::ofstream(target / "a" / "b" / "three") << "duplicate";
+            // Same size, different contents
+            fs::ofstream(target / "a" / "other") << "different";
+            fs::ofstream(target / "unique") << "unique";
+        }
+        fs::create_hard_link(target / "one", target / "a" / "b" / "link");
+        fs::create_directory(target / "empty");
+        fs::ofstream(target / "empty" / "1");
+        fs::ofstream(target / "empty" / "2");
+
+        fs::deduplicate_info info = fs::deduplicate(target, fs::deduplicate_options::dry_run, cache, 4u);
+        BOOST_TEST_EQ(info.file_count, 6u);
+        BOOST_TEST_EQ(info.hashed_count, 4u);
+        BOOST_TEST_EQ(info.replaced_count, 2u);
+        BOOST_TEST_EQ(info.replaced_size, 18u);
+        BOOST_TEST(!fs::equivalent(target / "one", target / "a" / "two"));
+        BOOST_TEST(fs::exists(cache));
+
+        // Unchanged files are not hashed again
+        boost::system::error_code ec;
+        info = fs::deduplicate(target, fs::deduplicate_options::none, cache, 1u, ec);
+        BOOST_TEST(!ec);
+        BOOST_TEST_EQ(info.hashed_count, 0u);
+        BOOST_TEST_EQ(info.replaced_count, 2u);
+        BOOST_TEST(fs::equivalent(target / "one", target / "a" / "two"));
+        BOOST_TEST(fs::equivalent(target / "one", target / "a" / "b" / "three"));
+        BOOST_TEST(fs::equivalent(target / "one", target / "a" / "b" / "link"));
+        BOOST_TEST(!fs::equivalent(target / "one", target / "a" / "other"));
+        BOOST_TEST(!fs::equivalent(target / "empty" / "1", target / "empty" / "2"));
+        BOOST_TEST_EQ(fs::hard_link_count(target / "one"), 4u);
+        BOOST_TEST_EQ(list_tree(target).size(), 11u); // no temporary files left
+
+        info = fs::deduplicate(target);
+        BOOST_TEST_EQ(info.replaced_count, 0u);
+        BOOST_TEST_EQ(info.hashed_count, 2u); // the hard links are hashed once
+
+        // A corrupted cache is ignored
+        fs::ofstream(cache) << "garbage";
+        fs::ofstream(target / "a" / "two2") << "duplicate";
+        info = fs::deduplicate(target, fs::deduplicate_options::none, cache, 2u);
+        BOOST_TEST_EQ(info.replaced_count, 1u);
+        BOOST_TEST_EQ(info.hashed_count, 3u);
+
+        info = fs::deduplicate(target / "nonexistent", fs::deduplicate_options::none, fs::path(), 2u, ec);
+        BOOST_TEST(!!ec);
+        BOOST_TEST_THROWS(fs::deduplicate(target / "nonexistent"), fs::filesystem_error);
+
+        fs::remove(cache);
+        fs::remove_all(target);
+    }
+
+    // Tree digests
+    {
+        const fs::path target = temp_dir.path() / "digest";
+        const fs::path cache = temp_dir.path() / "digest.cache";
+        fs::copy(root, target, fs::copy_options::recursive);
+        fs::create_directory(target / "empty");
+
+        const std::size_t file_count = 5u * (4u * 7u + 1u) + 1u;
+        fs::tree_digest_info info = fs::tree_digest(target, fs::tree_digest_options::none, cache, 4u);
+        BOOST_TEST_EQ(info.file_count, file_count);
+        BOOST_TEST_EQ(info.directory_count, 1u + 5u * (1u + 4u) + 1u);
+        BOOST_TEST_EQ(info.hashed_count, file_count);
+        const boost::uint64_t digest = info.digest;
+
+        // The digest does not depend on the number of threads, the way the files are read or trailing separators
+        boost::system::error_code ec;
+        info = fs::tree_digest(target, fs::tree_digest_options::memory_map, fs::path(), 1u, ec);
+        BOOST_TEST(!ec);
+        BOOST_TEST_EQ(info.digest, digest);
+        info = fs::tree_digest(target / "");
+        BOOST_TEST_EQ(info.digest, digest);
+
+        // Unchanged files are not hashed again
+        info = fs::tree_digest(target, fs::tree_digest_options::none, cache, 2u);
+        BOOST_TEST_EQ(info.digest, digest);
+        BOOST_TEST_EQ(info.hashed_count, 0u);
+
+        // Contents, names and entries are reflected in the digest
+        fs::ofstream(target / "dir2" / "sub1" / "file3") << "y";
+        info = fs::tree_digest(target, fs::tree_digest_options::none, cache, 2u);
+        BOOST_TEST_NE(info.digest, digest);
+        BOOST_TEST_EQ(info.hashed_count, 1u);
+        fs::ofstream(target / "dir2" / "sub1" / "file3") << "x";
+        BOOST_TEST_EQ(fs::tree_digest(target).digest, digest);
+
+        fs::rename(target / "dir3" / "file", target / "dir3" / "file2");
+        BOOST_TEST_NE(fs::tree_digest(target).digest, digest);
+        fs::rename(target / "dir3" / "file2", target / "dir3" / "file");
+
+        fs::remove(target / "empty");
+        BOOST_TEST_NE(fs::tree_digest(target).digest, digest);
+        fs::create_directory(target / "empty");
+        BOOST_TEST_EQ(fs::tree_digest(target).digest, digest);
+
+        // Symlinks are hashed by their targets
+        fs::create_symlink("file", target / "link", ec);
+        if (!ec)
+        {
+            info = fs::tree_digest(target);
+            BOOST_TEST_EQ(info.file_count, file_count + 1u);
+            const boost::uint64_t link_digest = info.digest;
+            BOOST_TEST_NE(link_digest, digest);
+            fs::remove(target / "link");
+            fs::create_symlink("dir0", target / "link");
+            BOOST_TEST_NE(fs::tree_digest(target).digest, link_digest);
+            fs::remove(target / "link");
+        }
+
+        // A single file
+        info = fs::tree_digest(target / "file");
+        BOOST_TEST_EQ(info.file_count, 1u);
+        BOOST_TEST_EQ(info.directory_count, 0u);
+        BOOST_TEST_EQ(info.digest, fs::tree_digest(root / "file").digest);
+
+        info = fs::tree_digest(target / "nonexistent", fs::tree_digest_options::none, fs::path(), 2u, ec);
+        BOOST_TEST(!!ec);
+        BOOST_TEST_THROWS(fs::tree_digest(target / "nonexistent"), fs::filesystem_error);
+
+        fs::remove(cache);
+        fs::remove_all(target);
+    }
+
+    // Bulk metadata scan
+    {
+        const fs::path target = temp_dir.path() / "bulk";
+        fs::parallel_copy(root, target);
+        fs::create_hard_link(target / "dir0" / "file", target / "dir1" / "hard_link");
+        const std::vector< fs::path > paths = list_tree(target);
+
+        const fs::bulk_scan_backend::type backend = fs::get_bulk_scan_backend();
+        BOOST_TEST(backend == fs::bulk_scan_backend::system_default || backend == fs::bulk_scan_backend::tree_walk ||
+            backend == fs::bulk_scan_backend::xfs_bulkstat);
+
+        for (unsigned int i = 0u; i < 2u; ++i)
+        {
+            std::mutex mutex;
+            std::vector< fs::file_attributes > attrs;
+            attributes_collector c = { &mutex, &attrs };
+
+            // The root is reported and the hard link is reported once
+            boost::system::error_code ec;
+            const boost::uintmax_t count = fs::bulk_metadata_scan(target, c, 4u, ec);
+            BOOST_TEST(!ec);
+            BOOST_TEST_EQ(count, paths.size());
+            BOOST_TEST_EQ(attrs.size(), paths.size());
+
+            std::vector< boost::uintmax_t > inodes;
+            for (std::size_t j = 0u; j < attrs.size(); ++j)
+            {
+                BOOST_TEST((attrs[j].mask & fs::file_attribute_mask::inode) != fs::file_attribute_mask::none);
+                inodes.push_back(attrs[j].inode);
+            }
+            std::sort(inodes.begin(), inodes.end());
+            BOOST_TEST(std::adjacent_find(inodes.begin(), inodes.end()) == inodes.end());
+            for (std::size_t j = 0u; j < paths.size(); ++j)
+                BOOST_TEST(std::binary_search(inodes.begin(), inodes.end(), fs::directory_entry(paths[j]).inode()));
+            BOOST_TEST(std::binary_search(inodes.begin(), inodes.end(), fs::directory_entry(target).inode()));
+
+            // The tree walk gives the same results
+            BOOST_TEST(fs::set_bulk_scan_backend(fs::bulk_scan_backend::tree_walk));
+        }
+        BOOST_TEST(fs::set_bulk_scan_backend(backend));
+
+        std::mutex mutex;
+        std::vector< fs::file_attributes > attrs;
+        attributes_collector c = { &mutex, &attrs };
+        boost::system::error_code ec;
+        fs::bulk_metadata_scan(target / "nonexistent", c, 2u, ec);
+        BOOST_TEST(!!ec);
+        BOOST_TEST(attrs.empty());
+        BOOST_TEST_THROWS(fs::bulk_metadata_scan(target / "nonexistent", c), fs::filesystem_error);
+
+        fs::remove_all(target);
+    }
+
+    // Synchronizing directory trees
+    {
+        const fs::path target = temp_dir.path() / "sync";
+        const std::size_t file_count = list_tree(root).size();
+        fs::synchronize_info info = fs::synchronize_tree(root, target, fs::synchronize_options::none, 4u);
+        BOOST_TEST_EQ(info.file_count, file_count);
+        BOOST_TEST_EQ(info.copied_count, 5u * (4u * 7u + 1u) + 1u);
+        BOOST_TEST_EQ(info.copied_size, info.copied_count);
+        BOOST_TEST(list_tree_relative(target) == list_tree_relative(root));
+
+        // Nothing is copied when the trees are in sync
+        info = fs::synchronize_tree(root, target);
+        BOOST_TEST_EQ(info.file_count, file_count);
+        BOOST_TEST_EQ(info.copied_count, 0u);
+        BOOST_TEST_EQ(info.updated_count, 0u);
+
+        // Changes of size and modification time are detected
+        fs::ofstream(target / "dir0" / "file") << "longer";
+        fs::last_write_time(target / "dir1" / "file", fs::last_write_time(root / "dir1" / "file") - 100);
+        info = fs::synchronize_tree(root, target, fs::synchronize_options::none, 2u);
+        BOOST_TEST_EQ(info.copied_count, 2u);
+        BOOST_TEST_EQ(info.removed_count, 0u);
+        BOOST_TEST_EQ(fs::file_size(target / "dir0" / "file"), 1u);
+        BOOST_TEST_EQ(fs::last_write_time(target / "dir1" / "file"), fs::last_write_time(root / "dir1" / "file"));
+
+        // With compare_contents, files with equal contents are not copied, only their times are updated
+        fs::last_write_time(target / "dir2" / "file", fs::last_write_time(root / "dir2" / "file") - 100);
+        fs::ofstream(target / "dir3" / "file") << "y";
+        info = fs::synchronize_tree(root, target, fs::synchronize_options::compare_contents | fs::synchronize_options::delta, 2u);
+        BOOST_TEST_EQ(info.copied_count, 1u);
+        BOOST_TEST_EQ(info.updated_count, 1u);
+        BOOST_TEST_EQ(fs::last_write_time(target / "dir2" / "file"), fs::last_write_time(root / "dir2" / "file"));
+        {
+            fs::ifstream f(target / "dir3" / "file");
+            std::string str;
+            f >> str;
+            BOOST_TEST_EQ(str, "x");
+        }
+
+        // Extra files are only removed with remove_extra, files of different types are replaced
+        fs::create_directories(target / "extra" / "nested");
+        create_file(target / "extra" / "nested" / "file");
+        create_file(target / "dir4" / "extra_file");
+        fs::remove(target / "dir0" / "sub0" / "file0");
+        fs::create_directory(target / "dir0" / "sub0" / "file0");
+        fs::remove_all(target / "dir1" / "sub1");
+        create_file(target / "dir1" / "sub1");
+        info = fs::synchronize_tree(root, target, fs::synchronize_options::none, 2u);
+        BOOST_TEST_EQ(info.copied_count, 1u + 7u);
+        BOOST_TEST(fs::exists(target / "extra"));
+        BOOST_TEST(fs::is_regular_file(target / "dir0" / "sub0" / "file0"));
+        BOOST_TEST(fs::is_directory(target / "dir1" / "sub1"));
+
+        info = fs::synchronize_tree(root, target, fs::synchronize_options::remove_extra, 4u);
+        BOOST_TEST_EQ(info.copied_count, 0u);
+        BOOST_TEST_EQ(info.removed_count, 4u);
+        BOOST_TEST(list_tree_relative(target) == list_tree_relative(root));
+
+#if defined(BOOST_POSIX_API)
+        // Symlinks are copied as symlinks
+        fs::create_symlink("dir0/file", root / "link");
+        info = fs::synchronize_tree(root, target);
+        BOOST_TEST_EQ(info.copied_count, 1u);
+        BOOST_TEST(fs::is_symlink(target / "link"));
+        BOOST_TEST_EQ(fs::read_symlink(target / "link"), fs::path("dir0/file"));
+        fs::remove(target / "link");
+        fs::create_symlink("dir1/file", target / "link");
+        info = fs::synchronize_tree(root, target);
+        BOOST_TEST_EQ(info.copied_count, 1u);
+        BOOST_TEST_EQ(fs::read_symlink(target / "link"), fs::path("dir0/file"));
+        fs::remove(root / "link");
+        info = fs::synchronize_tree(root, target, fs::synchronize_options::remove_extra);
+        BOOST_TEST_EQ(info.removed_count, 1u);
+        BOOST_TEST(!fs::is_symlink(target / "link"));
+#endif
+
+        // Nested directories are created before their entries are synchronized
+        for (unsigned int i = 0u; i < 10u; ++i)
+        {
+            info = fs::synchronize_tree(deep_root, target / "deep", fs::synchronize_options::none, 16u);
+            BOOST_TEST_EQ(info.copied_count, 300u);
+            BOOST_TEST(list_tree_relative(target / "deep") == list_tree_relative(deep_root));
+            fs::remove_all(target / "deep");
+        }
+
+        boost::system::error_code ec;
+        info = fs::synchronize_tree(root / "nonexistent", target, fs::synchronize_options::none, 2u, ec);
+        BOOST_TEST(!!ec);
+        BOOST_TEST_THROWS(fs::synchronize_tree(root / "file", target), fs::filesystem_error);
+
+        fs::remove_all(target);
+    }
+
+    // Comparing files and directory trees
+    {
+        const fs::path target = temp_dir.path() / "compare";
+        fs::parallel_copy(root, target);
+        BOOST_TEST(fs::trees_equal(root, target, fs::trees_equal_options::none, 4u));
+        BOOST_TEST(fs::trees_equal(root, target / "", fs::trees_equal_options::memory_map, 1u));
+        BOOST_TEST(fs::trees_equal(root, root));
+        BOOST_TEST(fs::files_equal(root / "file", target / "file"));
+        BOOST_TEST(fs::files_equal(root / "file", root / "file"));
+
+        // Files of equal size with different contents
+        fs::ofstream(target / "dir2" / "sub3" / "file6") << "y";
+        BOOST_TEST(!fs::trees_equal(root, target, fs::trees_equal_options::none, 2u));
+        BOOST_TEST(!fs::trees_equal(root, target, fs::trees_equal_options::memory_map, 2u));
+        BOOST_TEST(!fs::files_equal(root / "dir2" / "sub3" / "file6", target / "dir2" / "sub3" / "file6"));
+        BOOST_TEST(!fs::trees_equal(root / "dir2" / "sub3" / "file6", target / "dir2" / "sub3" / "file6"));
+        create_file(target / "dir2" / "sub3" / "file6");
+        BOOST_TEST(fs::trees_equal(root, target));
+
+        // Files of different sizes, missing and extra files and files of different types
+        fs::ofstream(target / "dir0" / "file") << "longer";
+        BOOST_TEST(!fs::files_equal(root / "dir0" / "file", target / "dir0" / "file"));
+        BOOST_TEST(!fs::trees_equal(root, target));
+        create_file(target / "dir0" / "file");
+        create_file(target / "dir1" / "extra");
+        BOOST_TEST(!fs::trees_equal(root, target));
+        BOOST_TEST(!fs::trees_equal(target, root));
+        fs::remove(target / "dir1" / "extra");
+        fs::remove(target / "dir3" / "sub0" / "file0");
+        fs::create_directory(target / "dir3" / "sub0" / "file0");
+        BOOST_TEST(!fs::trees_equal(root, target));
+        fs::remove(target / "dir3" / "sub0" / "file0");
+        create_file(target / "dir3" / "sub0" / "file0");
+        BOOST_TEST(fs::trees_equal(root, target));
+
+#if defined(BOOST_POSIX_API)
+        // Symlinks are compared by their targets, permissions are only compared on request
+        fs::create_symlink("dir0/file", root / "link");
+        fs::create_symlink("dir1/file", target / "link");
+        BOOST_TEST(!fs::trees_equal(root, target));
+        fs::remove(target / "link");
+        fs::create_symlink("dir0/file", target / "link");
+        BOOST_TEST(fs::trees_equal(root, target));
+        fs::remove(root / "link");
+        fs::remove(target / "link");
+
+        fs::permissions(target / "dir4" / "file", fs::perms::remove_perms | fs::perms::owner_write);
+        BOOST_TEST(fs::trees_equal(root, target));
+        BOOST_TEST(!fs::trees_equal(root, target, fs::trees_equal_options::compare_permissions));
+        fs::permissions(target / "dir4" / "file", fs::perms::add_perms | fs::perms::owner_write);
+        BOOST_TEST(fs::trees_equal(root, target, fs::trees_equal_options::compare_permissions));
+#endif
+
+        boost::system::error_code ec;
+        BOOST_TEST(!fs::trees_equal(root / "nonexistent", target, fs::trees_equal_options::none, 2u, ec));
+        BOOST_TEST(!!ec);
+        BOOST_TEST_THROWS(fs::trees_equal(root, target / "nonexistent"), fs::filesystem_error);
+        BOOST_TEST(!fs::files_equal(root / "file", root / "nonexistent", ec));
+        BOOST_TEST(!!ec);
+        BOOST_TEST_THROWS(fs::files_equal(root, target), fs::filesystem_error);
+
+        fs::remove_all(target);
+    }
+
+#if defined(BOOST_FILESYSTEM_HAS_REMOVE_ALL_ASYNC)
+    // Asynchronous remove_all
+    {
+        const fs::path target = temp_dir.path() / "remove-async";
+        fs::parallel_copy(root, target);
+        const std::size_t file_count = list_tree(target).size() + 1u;
+        std::future< boost::uintmax_t > result = fs::remove_all_async(target);
+        // The target is renamed before remove_all_async returns
+        BOOST_TEST(!fs::exists(target));
+        BOOST_TEST_EQ(result.get(), file_count);
+
+        boost::system::error_code ec;
+        result = fs::remove_all_async(target, ec);
+        BOOST_TEST(!ec);
+        BOOST_TEST_EQ(result.get(), 0u);
+
+        // Discarding the result does not wait for the removal
+        const fs::path parent = temp_dir.path() / "remove-async-parent";
+        fs::create_directory(parent);
+        fs::parallel_copy(root, parent / "tree");
+        fs::parallel_copy(deep_root, parent / "tree" / "deep");
+        fs::remove_all_async(parent / "tree");
+        BOOST_TEST(!fs::exists(parent / "tree"));
+        for (unsigned int i = 0u; i < 3000u && !fs::is_empty(parent); ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        BOOST_TEST(fs::is_empty(parent));
+        fs::remove(parent);
+
+        result = fs::remove_all_async(root / "..", ec);
+        BOOST_TEST(!!ec);
+        BOOST_TEST_THROWS(fs::remove_all_async(root / "."), fs::filesystem_error);
+    }
+#endif // defined(BOOST_FILESYSTEM_HAS_REMOVE_ALL_ASYNC)
+
+    // Errors are reported
+    {
+        fs::parallel_directory_walker walker(2u);
+        std::mutex mutex;
+        std::vector< fs::path > paths;
+        std::size_t largest_batch = 0u;
+        collector c = { &mutex, &paths, &largest_batch };
+
+        boost::system::error_code ec;
+        walker.walk(root / "nonexistent", c, ec);
+        BOOST_TEST(!!ec);
+        BOOST_TEST(paths.empty());
+
+        BOOST_TEST_THROWS(walker.walk(root / "nonexistent", c), fs::filesystem_error);
+    }
+
+    return boost::report_errors();
+}
+
+#else // defined(BOOST_FILESYSTEM_HAS_PARALLEL_WALK)
+
+int main()
+{
+    return 0;
+}
+
+#endif // defined(BOOST_FILESYSTEM_HAS_PARALLEL_WALK)
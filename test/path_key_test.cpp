@@ -0,0 +1,109 @@
+//  path_key_test.cpp  -----------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/path_key.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+int sign(int x)
+{
+    return x < 0 ? -1 : static_cast< int >(x > 0);
+}
+
+void basic_tests()
+{
+    fs::path_key empty;
+    BOOST_TEST(empty.empty());
+    BOOST_TEST(empty == fs::path_key(fs::path()));
+    BOOST_TEST_EQ(empty.hash(), fs::path_key(fs::path()).hash());
+    BOOST_TEST(empty.to_path().empty());
+
+    fs::path_key k1(fs::path("/foo/bar/baz.txt"));
+    BOOST_TEST(!k1.empty());
+    BOOST_TEST_EQ(k1.to_path(), fs::path("/foo/bar/baz.txt"));
+    BOOST_TEST_EQ(boost::hash< fs::path_key >()(k1), k1.hash());
+
+    // Keys of equal paths are equal
+    fs::path_key k2(fs::path("/foo//bar/baz.txt"));
+    BOOST_TEST(k1 == k2);
+    BOOST_TEST_EQ(k1.hash(), k2.hash());
+    BOOST_TEST_EQ(k1.compare(k2), 0);
+
+    fs::path_key dir(fs::path("/foo/bar/"));
+    BOOST_TEST(dir != fs::path_key(fs::path("/foo/bar")));
+    BOOST_TEST_EQ(dir.to_path(), fs::path("/foo/bar/"));
+
+    fs::path_key rel(fs::path("foo/bar"));
+    BOOST_TEST(rel != fs::path_key(fs::path("/foo/bar")));
+    BOOST_TEST_EQ(rel.to_path(), fs::path("foo/bar"));
+
+    swap(k1, rel);
+    BOOST_TEST_EQ(k1.to_path(), fs::path("foo/bar"));
+    BOOST_TEST_EQ(rel.to_path(), fs::path("/foo/bar/baz.txt"));
+}
+
+void ordering_tests()
+{
+    const char* const paths[] =
+    {
+        "", "/", "//", "a", "a/", "a//", "a/b", "a//b", "a-b", "a.b", "a/.", "a/..", "/a", "//a", "/a/b", "a b",
+        "//net", "//net/", "//net/a", "c:", "c:/", "c:a", "c:/a", "..", "./a", "a/b/", "b"
+    };
+    const std::size_t count = sizeof(paths) / sizeof(*paths);
+
+    // Keys compare the same way as paths
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+        const fs::path p1(paths[i]);
+        const fs::path_key k1(p1);
+        for (std::size_t j = 0u; j < count; ++j)
+        {
+            const fs::path p2(paths[j]);
+            const fs::path_key k2(p2);
+            BOOST_TEST_EQ(sign(k1.compare(k2)), sign(p1.compare(p2)));
+            BOOST_TEST_EQ(k1 == k2, p1 == p2);
+            BOOST_TEST_EQ(k1 < k2, p1 < p2);
+            if (k1 == k2)
+                BOOST_TEST_EQ(k1.hash(), k2.hash());
+        }
+    }
+
+    std::map< fs::path_key, std::size_t > key_map;
+    std::map< fs::path, std::size_t > path_map;
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+        key_map.insert(std::make_pair(fs::path_key(fs::path(paths[i])), i));
+        path_map.insert(std::make_pair(fs::path(paths[i]), i));
+    }
+
+    BOOST_TEST_EQ(key_map.size(), path_map.size());
+    std::map< fs::path_key, std::size_t >::const_iterator key_it = key_map.begin();
+    for (std::map< fs::path, std::size_t >::const_iterator it = path_map.begin(), end = path_map.end(); it != end; ++it, ++key_it)
+        BOOST_TEST_EQ(key_it->second, it->second);
+}
+
+} // namespace
+
+int main()
+{
+    basic_tests();
+    ordering_tests();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,261 @@
+//  path_map_test.cpp  -----------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/path_map.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include <cstddef>
+#include <algorithm>
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+std::string make_name(const char* prefix, unsigned int n)
+{
+    std::ostringstream strm;
+    strm << prefix << n;
+    return strm.str();
+}
+
+//! Returns the sorted paths of the values in the range
+template< typename Iterator >
+std::vector< fs::path > collect_keys(Iterator begin, Iterator end)
+{
+    std::vector< fs::path > keys;
+    for (; begin != end; ++begin)
+        keys.push_back(begin.key());
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+void basic_tests()
+{
+    fs::path_map< int > map;
+    BOOST_TEST(map.empty());
+    BOOST_TEST_EQ(map.size(), 0u);
+    BOOST_TEST(map.begin() == map.end());
+
+    std::pair< fs::path_map< int >::iterator, bool > res = map.insert(fs::path("/usr"), 1);
+    BOOST_TEST(res.second);
+    BOOST_TEST_EQ(*res.first, 1);
+    BOOST_TEST_EQ(res.first.key(), fs::path("/usr"));
+    BOOST_TEST_EQ(res.first.depth(), 2u);
+
+    res = map.insert(fs::path("/usr"), 2);
+    BOOST_TEST(!res.second);
+    BOOST_TEST_EQ(*res.first, 1);
+
+    map[fs::path("/usr/lib")] = 2;
+    map[fs::path("/usr/lib/x86_64")] = 3;
+    map[fs::path("/var//log")] = 4;
+    map[fs::path("relative/path")] = 5;
+    BOOST_TEST_EQ(map.size(), 5u);
+    BOOST_TEST_EQ(map[fs::path("/usr/lib")], 2);
+    BOOST_TEST_EQ(map.size(), 5u);
+
+    // Empty paths cannot be inserted
+    res = map.insert(fs::path(), 6);
+    BOOST_TEST(!res.second);
+    BOOST_TEST(res.first == map.end());
+
+    // Exact lookup
+    BOOST_TEST(map.find(fs::path("/var/log")) != map.end());
+    BOOST_TEST_EQ(*map.find(fs::path("/var/log")), 4);
+    BOOST_TEST(map.find(fs::path("/var")) == map.end());
+    BOOST_TEST(map.find(fs::path("/usr/li")) == map.end());
+    BOOST_TEST(map.find(fs::path()) == map.end());
+    BOOST_TEST_EQ(map.count(fs::path("relative/path")), 1u);
+    BOOST_TEST_EQ(map.count(fs::path("/relative/path")), 0u);
+
+    // Longest prefix match is performed in terms of path elements
+    fs::path_map< int > const& cmap = map;
+    BOOST_TEST_EQ(*cmap.longest_prefix(fs::path("/usr/lib/x86_64/libc.so")), 3);
+    BOOST_TEST_EQ(*cmap.longest_prefix(fs::path("/usr/lib/i386/libc.so")), 2);
+    BOOST_TEST_EQ(*cmap.longest_prefix(fs::path("/usr/lib")), 2);
+    BOOST_TEST_EQ(*cmap.longest_prefix(fs::path("/usr/library")), 1);
+    BOOST_TEST_EQ(cmap.longest_prefix(fs::path("/usr/lib/x86_64/libc.so")).key(), fs::path("/usr/lib/x86_64"));
+    BOOST_TEST(cmap.longest_prefix(fs::path("/var")) == cmap.end());
+    BOOST_TEST(cmap.longest_prefix(fs::path("/opt/usr")) == cmap.end());
+
+    // Iteration visits every value once
+    std::vector< fs::path > keys = collect_keys(map.begin(), map.end());
+    BOOST_TEST_EQ(keys.size(), 5u);
+    int sum = 0;
+    for (fs::path_map< int >::const_iterator it = cmap.begin(), end = cmap.end(); it != end; ++it)
+        sum += *it;
+    BOOST_TEST_EQ(sum, 1 + 2 + 3 + 4 + 5);
+
+    // Parents are visited before children
+    std::vector< fs::path > order;
+    for (fs::path_map< int >::iterator it = map.begin(), end = map.end(); it != end; ++it)
+        order.push_back(it.key());
+    const std::size_t usr_pos = std::find(order.begin(), order.end(), fs::path("/usr")) - order.begin();
+    const std::size_t lib_pos = std::find(order.begin(), order.end(), fs::path("/usr/lib")) - order.begin();
+    const std::size_t arch_pos = std::find(order.begin(), order.end(), fs::path("/usr/lib/x86_64")) - order.begin();
+    BOOST_TEST_LT(usr_pos, lib_pos);
+    BOOST_TEST_LT(lib_pos, arch_pos);
+
+    // Subtree ranges
+    std::pair< fs::path_map< int >::iterator, fs::path_map< int >::iterator > range = map.subtree(fs::path("/usr/lib"));
+    keys = collect_keys(range.first, range.second);
+    BOOST_TEST_EQ(keys.size(), 2u);
+    if (keys.size() == 2u)
+    {
+        BOOST_TEST_EQ(keys[0], fs::path("/usr/lib"));
+        BOOST_TEST_EQ(keys[1], fs::path("/usr/lib/x86_64"));
+    }
+
+    // The root of the subtree does not need to hold a value
+    range = map.subtree(fs::path("/var"));
+    keys = collect_keys(range.first, range.second);
+    BOOST_TEST_EQ(keys.size(), 1u);
+    BOOST_TEST(range.first != range.second && *range.first == 4);
+
+    range = map.subtree(fs::path("/"));
+    BOOST_TEST_EQ(collect_keys(range.first, range.second).size(), 4u);
+    range = map.subtree(fs::path("/none"));
+    BOOST_TEST(range.first == range.second);
+
+    // Values are modifiable through iterators
+    for (range = map.subtree(fs::path("/usr")); range.first != range.second; ++range.first)
+        *range.first += 10;
+    BOOST_TEST_EQ(map[fs::path("/usr")], 11);
+    BOOST_TEST_EQ(map[fs::path("/usr/lib/x86_64")], 13);
+
+    // Removal
+    BOOST_TEST_EQ(map.erase(fs::path("/usr/lib")), 1u);
+    BOOST_TEST_EQ(map.erase(fs::path("/usr/lib")), 0u);
+    BOOST_TEST_EQ(map.size(), 4u);
+    BOOST_TEST(map.find(fs::path("/usr/lib/x86_64")) != map.end());
+    BOOST_TEST_EQ(*map.longest_prefix(fs::path("/usr/lib/i386")), 11);
+
+    BOOST_TEST_EQ(map.erase_subtree(fs::path("/usr")), 2u);
+    BOOST_TEST_EQ(map.size(), 2u);
+    BOOST_TEST(map.find(fs::path("/usr")) == map.end());
+    BOOST_TEST(map.longest_prefix(fs::path("/usr/lib/x86_64")) == map.end());
+    BOOST_TEST_EQ(map.erase_subtree(fs::path("/usr")), 0u);
+
+    BOOST_TEST_EQ(map.erase(fs::path("/var/log")), 1u);
+    BOOST_TEST(map.subtree(fs::path("/")).first == map.end());
+    BOOST_TEST_EQ(collect_keys(map.begin(), map.end()).size(), 1u);
+
+    BOOST_TEST_GT(map.allocated_size(), 0u);
+    map.clear();
+    BOOST_TEST(map.empty());
+    BOOST_TEST(map.begin() == map.end());
+    BOOST_TEST(map.find(fs::path("relative/path")) == map.end());
+}
+
+//! A value that counts its instances
+struct counted
+{
+    static int instances;
+    std::string value;
+
+    explicit counted(std::string const& v = std::string()) : value(v) { ++instances; }
+    counted(counted const& that) : value(that.value)
+    {
+        if (that.value == "throw")
+            throw std::runtime_error("copy");
+        ++instances;
+    }
+    ~counted() { --instances; }
+};
+
+int counted::instances = 0;
+
+void lifetime_tests()
+{
+    {
+        fs::path_map< counted > map;
+        map.insert(fs::path("/a/b"), counted("ab"));
+        map.insert(fs::path("/a/c"), counted("ac"));
+        map.insert(fs::path("/a/c/d"), counted("acd"));
+        BOOST_TEST_EQ(counted::instances, 3);
+
+        map.erase(fs::path("/a/b"));
+        BOOST_TEST_EQ(counted::instances, 2);
+
+        // A failed insertion leaves the map unchanged
+        BOOST_TEST_THROWS(map.insert(fs::path("/x/y/z"), counted("throw")), std::runtime_error);
+        BOOST_TEST_EQ(map.size(), 2u);
+        BOOST_TEST(map.subtree(fs::path("/x")).first == map.end());
+        BOOST_TEST_EQ(counted::instances, 2);
+
+        fs::path_map< counted > other;
+        other.insert(fs::path("/other"), counted("other"));
+        swap(map, other);
+        BOOST_TEST_EQ(map.size(), 1u);
+        BOOST_TEST_EQ(map.find(fs::path("/other"))->value, "other");
+        BOOST_TEST_EQ(other.find(fs::path("/a/c/d"))->value, "acd");
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+        fs::path_map< counted > moved(std::move(other));
+        BOOST_TEST(other.empty());
+        BOOST_TEST_EQ(moved.size(), 2u);
+        map = std::move(moved);
+        BOOST_TEST_EQ(map.size(), 2u);
+        BOOST_TEST_EQ(counted::instances, 2);
+#endif
+    }
+    BOOST_TEST_EQ(counted::instances, 0);
+}
+
+void many_paths_tests()
+{
+    fs::path_map< unsigned int > map;
+    for (unsigned int i = 0u; i < 50u; ++i)
+    {
+        for (unsigned int j = 0u; j < 100u; ++j)
+            map[fs::path("/root") / make_name("dir", i) / make_name("file", j)] = i * 100u + j;
+    }
+
+    BOOST_TEST_EQ(map.size(), 5000u);
+    for (unsigned int i = 0u; i < 50u; ++i)
+    {
+        std::pair< fs::path_map< unsigned int >::iterator, fs::path_map< unsigned int >::iterator > range =
+            map.subtree(fs::path("/root") / make_name("dir", i));
+        std::size_t count = 0u;
+        for (; range.first != range.second; ++range.first, ++count)
+            BOOST_TEST_EQ(*range.first / 100u, i);
+        BOOST_TEST_EQ(count, 100u);
+    }
+
+    for (unsigned int i = 0u; i < 50u; i += 2u)
+        BOOST_TEST_EQ(map.erase_subtree(fs::path("/root") / make_name("dir", i)), 100u);
+    BOOST_TEST_EQ(map.size(), 2500u);
+
+    // Removed nodes are reused
+    const std::size_t allocated_size = map.allocated_size();
+    for (unsigned int i = 0u; i < 50u; i += 2u)
+        map[fs::path("/root") / make_name("dir", i)] = i;
+    BOOST_TEST_EQ(map.size(), 2525u);
+    BOOST_TEST_EQ(*map.longest_prefix(fs::path("/root/dir4/file7")), 4u);
+    BOOST_TEST_EQ(*map.longest_prefix(fs::path("/root/dir5/file7")), 507u);
+    BOOST_TEST_LE(map.allocated_size(), allocated_size + fs::path_arena::default_block_size);
+}
+
+} // namespace
+
+int main()
+{
+    basic_tests();
+    lifetime_tests();
+    many_paths_tests();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,121 @@
+//  path_pool_test.cpp  ----------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/path_pool.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include <cstddef>
+#include <string>
+#include <sstream>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+std::string make_name(const char* prefix, unsigned int n)
+{
+    std::ostringstream strm;
+    strm << prefix << n;
+    return strm.str();
+}
+
+void basic_tests()
+{
+    fs::path_pool pool;
+    BOOST_TEST_EQ(pool.node_count(), 0u);
+
+    fs::interned_path empty = pool.intern(fs::path());
+    BOOST_TEST(empty.empty());
+    BOOST_TEST(empty == fs::interned_path());
+    BOOST_TEST(empty.to_path().empty());
+
+    fs::interned_path p1 = pool.intern(fs::path("/foo/bar/baz.txt"));
+    BOOST_TEST(!p1.empty());
+    BOOST_TEST_EQ(p1.depth(), 4u);
+    BOOST_TEST_EQ(pool.node_count(), 4u);
+    BOOST_TEST_EQ(p1.to_path(), fs::path("/foo/bar/baz.txt"));
+    BOOST_TEST(p1.element().native() == fs::path("baz.txt").native());
+
+    // Equal paths are interned to the same object
+    fs::interned_path p2 = pool.intern(fs::path("/foo//bar/baz.txt"));
+    BOOST_TEST(p1 == p2);
+    BOOST_TEST_EQ(p1.hash(), p2.hash());
+    BOOST_TEST_EQ(boost::hash< fs::interned_path >()(p1), p1.hash());
+    BOOST_TEST_EQ(pool.node_count(), 4u);
+
+    // Common prefixes are shared
+    fs::interned_path p3 = pool.intern(fs::path("/foo/bar/qux.txt"));
+    BOOST_TEST(p3 != p1);
+    BOOST_TEST(p3.parent_path() == p1.parent_path());
+    BOOST_TEST_EQ(pool.node_count(), 5u);
+
+    fs::interned_path parent = pool.intern(fs::path("/foo/bar"));
+    BOOST_TEST(parent == p1.parent_path());
+    BOOST_TEST_EQ(pool.node_count(), 5u);
+    BOOST_TEST(parent.parent_path().parent_path().parent_path().empty());
+
+    // Trailing separators are preserved
+    fs::interned_path dir = pool.intern(fs::path("/foo/bar/"));
+    BOOST_TEST(dir != parent);
+    BOOST_TEST(dir.parent_path() == parent);
+    BOOST_TEST_EQ(dir.to_path(), fs::path("/foo/bar/"));
+
+    fs::interned_path rel = pool.intern(fs::path("foo/bar"));
+    BOOST_TEST(rel != parent);
+    BOOST_TEST_EQ(rel.to_path(), fs::path("foo/bar"));
+
+    // Lookup without interning
+    BOOST_TEST(pool.find(fs::path("/foo/bar/baz.txt")) == p1);
+    BOOST_TEST(pool.find(fs::path("/foo/bar/none")).empty());
+    BOOST_TEST(pool.find(fs::path("/none/bar")).empty());
+    BOOST_TEST_GT(pool.allocated_size(), 0u);
+
+    pool.clear();
+    BOOST_TEST_EQ(pool.node_count(), 0u);
+    BOOST_TEST(pool.find(fs::path("/foo/bar")).empty());
+}
+
+void many_paths_tests()
+{
+    fs::path_pool pool;
+    std::vector< fs::path > paths;
+    std::vector< fs::interned_path > interned;
+    for (unsigned int i = 0u; i < 50u; ++i)
+    {
+        for (unsigned int j = 0u; j < 100u; ++j)
+        {
+            fs::path p = fs::path("/root") / make_name("dir", i) / make_name("file", j);
+            paths.push_back(p);
+            interned.push_back(pool.intern(p));
+        }
+    }
+
+    // root + "/" + 50 directories + 5000 files
+    BOOST_TEST_EQ(pool.node_count(), 2u + 50u + 5000u);
+    for (std::size_t i = 0u; i < paths.size(); ++i)
+    {
+        BOOST_TEST(pool.intern(paths[i]) == interned[i]);
+        BOOST_TEST_EQ(interned[i].to_path(), paths[i]);
+    }
+    BOOST_TEST_EQ(pool.node_count(), 2u + 50u + 5000u);
+}
+
+} // namespace
+
+int main()
+{
+    basic_tests();
+    many_paths_tests();
+
+    return boost::report_errors();
+}
@@ -2461,6 +2461,79 @@ void name_function_tests()
     BOOST_TEST(!fs::portable_file_name(std::string("foo.")));
 }
 
+//  bulk_name_check_tests  -----------------------------------------------------------//
+
+void bulk_name_check_tests()
+{
+    std::cout << "bulk_name_check_tests..." << std::endl;
+
+    // The bulk checks agree with the individual name checks
+    const char* const names[] =
+    {
+        "x", ".", "..", "", " ", ":", "-", "foo bar", " bar", "foo ", "foo.bar", "foo.barf", ".foo", "foo.", "a/b", "foo.b.c",
+        "a\\b", "CON", "con.txt", "Nul", "COM1", "lpt9.log", "COM", "COM10", "console", "AUX .txt", "prn", "LPT\xC2\xB9"
+    };
+    const std::size_t count = sizeof(names) / sizeof(*names);
+    std::size_t sizes[count];
+    for (std::size_t i = 0u; i < count; ++i)
+        sizes[i] = std::strlen(names[i]);
+
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+        const std::string name(names[i]);
+        BOOST_TEST_EQ(fs::check_name(names[i], sizes[i], fs::name_rules::native), fs::native(name));
+        BOOST_TEST_EQ(fs::check_name(names[i], sizes[i], fs::name_rules::portable_posix), fs::portable_posix_name(name));
+        BOOST_TEST_EQ(fs::check_name(names[i], sizes[i], fs::name_rules::windows), fs::windows_name(name));
+        BOOST_TEST_EQ(fs::check_name(names[i], sizes[i], fs::name_rules::portable), fs::portable_name(name));
+        BOOST_TEST_EQ(fs::check_name(names[i], sizes[i], fs::name_rules::portable_directory), fs::portable_directory_name(name));
+        BOOST_TEST_EQ(fs::check_name(names[i], sizes[i], fs::name_rules::portable_file), fs::portable_file_name(name));
+        BOOST_TEST_EQ(fs::check_name(names[i], sizes[i], fs::name_rules::windows | fs::name_rules::portable_posix), fs::windows_name(name) && fs::portable_posix_name(name));
+    }
+
+    BOOST_TEST(fs::check_name("foo\0bar", 7u, fs::name_rules::portable_posix) == false);
+    BOOST_TEST(fs::check_name("foo\0bar", 7u, fs::name_rules::windows) == false);
+
+    // Reserved Windows device names
+    BOOST_TEST(!fs::check_name("CON", 3u, fs::name_rules::no_windows_device_name));
+    BOOST_TEST(!fs::check_name("con.txt", 7u, fs::name_rules::no_windows_device_name));
+    BOOST_TEST(!fs::check_name("Nul", 3u, fs::name_rules::no_windows_device_name));
+    BOOST_TEST(!fs::check_name("COM1", 4u, fs::name_rules::no_windows_device_name));
+    BOOST_TEST(!fs::check_name("lpt9.log", 8u, fs::name_rules::no_windows_device_name));
+    BOOST_TEST(!fs::check_name("AUX .txt", 8u, fs::name_rules::no_windows_device_name));
+    BOOST_TEST(!fs::check_name("LPT\xC2\xB9", 5u, fs::name_rules::no_windows_device_name));
+    BOOST_TEST(fs::check_name("COM", 3u, fs::name_rules::no_windows_device_name));
+    BOOST_TEST(fs::check_name("COM10", 5u, fs::name_rules::no_windows_device_name));
+    BOOST_TEST(fs::check_name("console", 7u, fs::name_rules::no_windows_device_name));
+    BOOST_TEST(fs::check_name("xCON", 4u, fs::name_rules::no_windows_device_name));
+    BOOST_TEST(fs::check_name("", 0u, fs::name_rules::no_windows_device_name));
+    BOOST_TEST(!fs::check_name("", 0u, fs::name_rules::no_windows_device_name | fs::name_rules::windows));
+
+    // More names than fit in one word of the failure bitmap
+    std::vector< const char* > many_names;
+    std::vector< std::size_t > many_sizes;
+    for (std::size_t i = 0u; i < 150u; ++i)
+    {
+        const std::size_t index = i % count;
+        many_names.push_back(names[index]);
+        many_sizes.push_back(sizes[index]);
+    }
+
+    const fs::name_rules rules = fs::name_rules::portable_file | fs::name_rules::no_windows_device_name;
+    boost::uint64_t failures[3] = { ~static_cast< boost::uint64_t >(0u), 0u, ~static_cast< boost::uint64_t >(0u) };
+    const std::size_t failed_count = fs::check_names(&many_names[0], &many_sizes[0], many_names.size(), rules, failures);
+    std::size_t expected_failed_count = 0u;
+    for (std::size_t i = 0u; i < many_names.size(); ++i)
+    {
+        const bool failed = !fs::check_name(many_names[i], many_sizes[i], rules);
+        expected_failed_count += failed;
+        BOOST_TEST_EQ(((failures[i / 64u] >> (i % 64u)) & 1u) != 0u, failed);
+    }
+    BOOST_TEST_EQ(failed_count, expected_failed_count);
+    BOOST_TEST_EQ(failures[2] >> (150u - 128u), 0u);
+
+    BOOST_TEST_EQ(fs::check_names(NULL, NULL, 0u, rules, NULL), 0u);
+}
+
 //  replace_extension_tests  ---------------------------------------------------------//
 
 void replace_extension_tests()
@@ -2653,6 +2726,95 @@ void lexically_normal_tests()
     }
 }
 
+//  normalize_tests  -----------------------------------------------------------------//
+
+void normalize_tests()
+{
+    std::cout << "normalize_tests..." << std::endl;
+
+    // In-place normalization produces the same result as lexically_normal
+    const char* const paths[] =
+    {
+        "", "/", "//", "///", "foo", "foo/", "/./foo/.", "foo/../../", "foo/./bar/../", "foo/bar/blah/../../bletch",
+        "//net//foo//..//", "///net///foo///bar///", "c:foo/../", "c:/../../foo/", "c:..", "../a/../", "./.", "a/./b/./"
+    };
+
+    for (std::size_t i = 0u; i < sizeof(paths) / sizeof(*paths); ++i)
+    {
+        path p(paths[i]);
+        path& res = p.normalize();
+        BOOST_TEST_EQ(&res, &p);
+        PATH_TEST_EQ(p, path(paths[i]).lexically_normal().string());
+    }
+}
+
+//  join_tests  ----------------------------------------------------------------------//
+
+void join_tests()
+{
+    std::cout << "join_tests..." << std::endl;
+
+    // join produces the same result as chained appends
+    const char* const paths[] = { "", "/", "foo", "foo/", "/bar", "bar", "//net", "c:", "c:/", "c:baz", "." };
+    const std::size_t count = sizeof(paths) / sizeof(*paths);
+
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+        for (std::size_t j = 0u; j < count; ++j)
+        {
+            path a(paths[i]), b(paths[j]);
+            PATH_TEST_EQ(path::join(a, b), (a / b).string());
+
+            for (std::size_t k = 0u; k < count; ++k)
+            {
+                path c(paths[k]);
+                PATH_TEST_EQ(path::join(a, b, c), (a / b / c).string());
+                PATH_TEST_EQ(path::join(c, a, b, c), (c / a / b / c).string());
+            }
+        }
+    }
+
+    PATH_TEST_EQ(path::join(path("foo"), path("bar"), path("baz"), path("x"), path("y")), "foo" BOOST_DIR_SEP "bar" BOOST_DIR_SEP "baz" BOOST_DIR_SEP "x" BOOST_DIR_SEP "y");
+#if BOOST_FILESYSTEM_VERSION == 3
+    PATH_TEST_EQ(path::join(path("foo"), path("/bar"), path("baz")), "foo/bar" BOOST_DIR_SEP "baz");
+#else
+    PATH_TEST_EQ(path::join(path("foo"), path("/bar"), path("baz")), "/bar" BOOST_DIR_SEP "baz");
+#endif
+}
+
+//  replace_filename_tests  ----------------------------------------------------------//
+
+void replace_filename_tests()
+{
+    std::cout << "replace_filename_tests..." << std::endl;
+
+    PATH_TEST_EQ(path().replace_filename("bar"), "bar");
+    PATH_TEST_EQ(path("foo").replace_filename("bar"), "bar");
+    PATH_TEST_EQ(path("foo").replace_filename(""), "");
+    PATH_TEST_EQ(path("dir/foo").replace_filename("bar"), "dir/bar");
+    PATH_TEST_EQ(path("dir/.").replace_filename("bar"), "dir/bar");
+    PATH_TEST_EQ(path("dir/..").replace_filename("bar"), "dir/bar");
+    PATH_TEST_EQ(path("dir/foo.txt").replace_filename("bar/baz"), "dir/bar/baz");
+
+    path p("dir/foo");
+    path& res = p.replace_filename("bar");
+    BOOST_TEST_EQ(&res, &p);
+    p.replace_filename(p);
+    PATH_TEST_EQ(p, "dir/dir/bar");
+
+    // The result is the same as remove_filename followed by append in v3 and
+    // the same as removing the filename while keeping the trailing separator followed by append in v4
+#if BOOST_FILESYSTEM_VERSION == 3
+    PATH_TEST_EQ(path("/dir/foo").replace_filename("/bar"), "/dir/bar");
+    PATH_TEST_EQ(path("/").replace_filename("bar"), "bar");
+    PATH_TEST_EQ(path("dir/").replace_filename("bar"), "dir" BOOST_DIR_SEP "bar");
+#else
+    PATH_TEST_EQ(path("/dir/foo").replace_filename("/bar"), "/bar");
+    PATH_TEST_EQ(path("/").replace_filename("bar"), "/bar");
+    PATH_TEST_EQ(path("dir/").replace_filename("bar"), "dir/bar");
+#endif
+}
+
 //  compare_tests  -------------------------------------------------------------------//
 
 #define COMPARE_TEST(pth1, pth2)\
@@ -2696,6 +2858,44 @@ void compare_tests()
         COMPARE_TEST("c:\\foo", "d:\\foo")
         COMPARE_TEST("c:\\foo", "c:\\zoo")
     }
+
+    // Verify that the comparison result is the same as comparing the path elements, for all short paths
+    // made of characters that sort before and after separators, dots and separators
+    std::vector< std::string > paths(1u);
+    const char chars[] = { 'a', '-', '.', '/' };
+    for (std::size_t begin = 0u, end = paths.size(), length = 0u; length < 5u; ++length)
+    {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            for (std::size_t j = 0u; j < sizeof(chars); ++j)
+                paths.push_back(paths[i] + chars[j]);
+        }
+
+        begin = end;
+        end = paths.size();
+    }
+
+    for (std::size_t i = 0u; i < paths.size(); ++i)
+    {
+        const fs::path p1(paths[i]);
+        for (std::size_t j = 0u; j < paths.size(); ++j)
+        {
+            const fs::path p2(paths[j]);
+            fs::path::iterator it1 = p1.begin(), end1 = p1.end(), it2 = p2.begin(), end2 = p2.end();
+            int expected = 0;
+            for (; it1 != end1 && it2 != end2 && expected == 0; ++it1, ++it2)
+                expected = it1->native().compare(it2->native());
+            if (expected == 0)
+                expected = it1 != end1 ? 1 : (it2 != end2 ? -1 : 0);
+
+            const int result = p1.compare(p2);
+            if ((result < 0) != (expected < 0) || (result > 0) != (expected > 0))
+            {
+                std::cout << "compare mismatch: \"" << paths[i] << "\" vs \"" << paths[j] << "\": " << result << " != " << expected << std::endl;
+                BOOST_ERROR("path::compare result differs from element-wise comparison");
+            }
+        }
+    }
 }
 
 inline void odr_use(const path::value_type& c)
@@ -2744,9 +2944,13 @@ int cpp_main(int, char*[])
     non_member_tests();
     exception_tests();
     name_function_tests();
+    bulk_name_check_tests();
     replace_extension_tests();
     make_preferred_tests();
     lexically_normal_tests();
+    normalize_tests();
+    join_tests();
+    replace_filename_tests();
     compare_tests();
 
     // verify deprecated names still available
@@ -49,6 +49,36 @@ nanosecond_type time_ctor(const STD_STRING& s)
     return elapsed.user + elapsed.system;
 }
 
+nanosecond_type time_compare(const fs::path& p1, const fs::path& p2)
+{
+    boost::timer::auto_cpu_timer tmr;
+    boost::int64_t count = 0;
+    int res = 0;
+    do
+    {
+        res += p1.compare(p2);
+        ++count;
+    } while (count < max_cycles);
+
+    boost::timer::cpu_times elapsed = tmr.elapsed();
+    cout << "  result: " << res << endl;
+    return elapsed.user + elapsed.system;
+}
+
+nanosecond_type time_lexically_relative(const fs::path& p, const fs::path& base)
+{
+    boost::timer::auto_cpu_timer tmr;
+    boost::int64_t count = 0;
+    do
+    {
+        fs::path rel(p.lexically_relative(base));
+        ++count;
+    } while (count < max_cycles);
+
+    boost::timer::cpu_times elapsed = tmr.elapsed();
+    return elapsed.user + elapsed.system;
+}
+
 nanosecond_type time_loop()
 {
     boost::timer::auto_cpu_timer tmr;
@@ -92,6 +122,15 @@ int cpp_main(int argc, char* argv[])
     else
         cout << "wide/narrow CPU-time ratio = " << long double(w) / s << endl;
 
+    const fs::path deep1("/usr/local/include/boost/filesystem/detail/path_traits.hpp");
+    const fs::path deep2("/usr/local/include/boost/filesystem/detail/utf8_codecvt_facet.hpp");
+
+    cout << "time_compare with deep paths" << endl;
+    time_compare(deep1, deep2);
+
+    cout << "time_lexically_relative with deep paths" << endl;
+    time_lexically_relative(deep1, deep2.parent_path().parent_path());
+
     cout << "returning from main()" << endl;
     return 0;
 }
@@ -507,8 +507,34 @@ void test_relationals()
     // this is a critical use case to meet user expectations
     CHECK(path("c:\\abc") == path("c:/abc"));
     CHECK(hash(path("c:\\abc")) == hash(path("c:/abc")));
+    // separators at any position, in paths of every length class used by the hash function
+    CHECK(hash(path("/")) == hash(path("\\")));
+    CHECK(hash(path("a/b")) == hash(path("a\\b")));
+    CHECK(hash(path("c:/dir/file.txt")) == hash(path("c:\\dir\\file.txt")));
+    CHECK(hash(path("c:/program files/vendor/product/bin/executable.exe")) == hash(path("c:\\program files\\vendor\\product\\bin\\executable.exe")));
 #endif
 
+    // the hash is computed over the whole path, including the tail that doesn't fill a complete word
+    {
+        std::string str = "/usr/local/share/boost/filesystem/test/data/";
+        for (unsigned int i = 0u; i < 64u; ++i)
+        {
+            str += static_cast< char >('a' + i % 26u);
+            const path q(str);
+            CHECK(hash(q) == hash(path(str)));
+            CHECK(hash(q) != hash(q.parent_path()));
+            std::string other = str;
+            other[other.size() - 1u] = '.';
+            CHECK(hash(q) != hash(path(other)));
+            other = str;
+            other[0] = '.';
+            CHECK(hash(q) != hash(path(other)));
+        }
+        CHECK(hash(path()) != hash(path("a")));
+        CHECK(hash(path("a")) != hash(path("b")));
+        CHECK(hash(path("ab")) != hash(path("ba")));
+    }
+
     const path p("bar");
     const path p2("baz");
 
@@ -874,6 +900,155 @@ void test_imbue_locale()
     std::cout << "  locale testing complete" << std::endl;
 }
 
+//  test_utf8_conversion  ------------------------------------------------------------//
+
+//  Conversions with utf8_codecvt_facet bypass the facet, verify that the results are the same
+
+std::wstring to_wide(std::string const& s, path::codecvt_type const& cvt)
+{
+#ifdef BOOST_WINDOWS_API
+    return path(s, cvt).native();
+#else
+    return path(s).wstring(cvt);
+#endif
+}
+
+std::string to_narrow(std::wstring const& ws, path::codecvt_type const& cvt)
+{
+#ifdef BOOST_WINDOWS_API
+    return path(ws).string(cvt);
+#else
+    return path(ws, cvt).native();
+#endif
+}
+
+std::codecvt_base::result facet_to_wide(std::string const& s, std::wstring& ws, path::codecvt_type const& cvt)
+{
+    std::mbstate_t state = std::mbstate_t();
+    std::vector< wchar_t > buf(s.size() + 1u);
+    const char* from_next = s.data();
+    wchar_t* to_next = &buf[0];
+    std::codecvt_base::result res = cvt.in(state, s.data(), s.data() + s.size(), from_next, &buf[0], &buf[0] + buf.size(), to_next);
+    ws.assign(&buf[0], to_next);
+    return res;
+}
+
+std::string facet_to_narrow(std::wstring const& ws, path::codecvt_type const& cvt)
+{
+    std::mbstate_t state = std::mbstate_t();
+    std::vector< char > buf(ws.size() * 6u + 1u);
+    const wchar_t* from_next = ws.data();
+    char* to_next = &buf[0];
+    BOOST_TEST(cvt.out(state, ws.data(), ws.data() + ws.size(), from_next, &buf[0], &buf[0] + buf.size(), to_next) == std::codecvt_base::ok);
+    return std::string(&buf[0], to_next);
+}
+
+void test_utf8_conversion()
+{
+    std::cout << "testing UTF-8 conversion..." << std::endl;
+
+    fs::detail::utf8_codecvt_facet cvt(1u);
+
+    const char* const valid[] =
+    {
+        "abc",
+        "/usr/local/include/boost/filesystem",
+        "\xE2\x9C\xA2",
+        "/home/\xD0\xBF\xD0\xBE\xD0\xBB\xD1\x8C\xD0\xB7\xD0\xBE\xD0\xB2\xD0\xB0\xD1\x82\xD0\xB5\xD0\xBB\xD1\x8C/file.txt",
+        "prefix_longer_than_a_word/\xC3\xA9t\xC3\xA9/\xE6\x96\x87\xE4\xBB\xB6",
+        "\xF0\x9F\x98\x80 emoji",
+        // ASCII runs between non-ASCII characters
+        "\xC3\xA9/usr/local/include/boost/\xC3\xA9/filesystem/path.hpp\xE6\x96\x87",
+        // Sequences longer than 4 octets are converted by the facet
+        "abc\xF8\x88\x80\x80\x80"
+    };
+
+    for (std::size_t i = 0u; i < sizeof(valid) / sizeof(*valid); ++i)
+    {
+        const std::string s(valid[i]);
+        std::wstring expected;
+        if (facet_to_wide(s, expected, cvt) != std::codecvt_base::ok)
+            continue; // the character is not representable in wchar_t by the facet
+
+        const std::wstring ws = to_wide(s, cvt);
+        BOOST_TEST(ws == expected);
+        BOOST_TEST(to_narrow(ws, cvt) == facet_to_narrow(ws, cvt));
+    }
+
+    const char* const invalid[] =
+    {
+        "abc\x80",
+        "abcdefghijklmnop\xBF",
+        "\xE2\x41\xA2",
+        "abc\xE2\x9C",
+        "\xF0\x9F\x98",
+        "\xC3\xA9" "abcdefghijklmnop\x80",
+        "\xC3\xA9" "abcdefghijklmnop\xE2\x9C"
+    };
+
+    for (std::size_t i = 0u; i < sizeof(invalid) / sizeof(*invalid); ++i)
+    {
+        const std::string s(invalid[i]);
+        std::wstring ws;
+        const std::codecvt_base::result expected = facet_to_wide(s, ws, cvt);
+
+        bool exception_thrown = false;
+        try
+        {
+            to_wide(s, cvt);
+        }
+        catch (const bs::system_error& ex)
+        {
+            exception_thrown = true;
+            BOOST_TEST_EQ(ex.code(), bs::error_code(expected, fs::codecvt_error_category()));
+        }
+        BOOST_TEST(exception_thrown);
+    }
+}
+
+//  test_conversion_into  ------------------------------------------------------------//
+
+void test_conversion_into()
+{
+    std::cout << "testing conversion into caller-supplied strings..." << std::endl;
+
+    fs::detail::utf8_codecvt_facet cvt(1u);
+
+    std::string s("previous contents, which must be replaced");
+    std::wstring ws(L"previous contents, which must be replaced");
+
+    path p("/usr/local/include/boost/filesystem/path.hpp");
+    p.string_into(s);
+    p.wstring_into(ws);
+    BOOST_TEST(s == p.string());
+    BOOST_TEST(ws == p.wstring());
+
+    // Shorter paths reuse the storage
+    const std::size_t capacity = ws.capacity();
+    path("abc").wstring_into(ws);
+    BOOST_TEST(ws == L"abc");
+    BOOST_TEST_EQ(ws.capacity(), capacity);
+
+    path().string_into(s);
+    path().wstring_into(ws);
+    BOOST_TEST(s.empty());
+    BOOST_TEST(ws.empty());
+
+    p = path(std::string("/home/\xD0\xBF\xD0\xBE\xD0\xBB\xD1\x8C/file.txt"), cvt);
+    p.string_into(s, cvt);
+    p.wstring_into(ws, cvt);
+    BOOST_TEST(s == p.string(cvt));
+    BOOST_TEST(ws == p.wstring(cvt));
+    BOOST_TEST(s == "/home/\xD0\xBF\xD0\xBE\xD0\xBB\xD1\x8C/file.txt");
+
+#ifndef BOOST_WINDOWS_API
+    // On failure, the target is left empty
+    ws = L"previous contents";
+    BOOST_TEST_THROWS(path("abc\xE2\x41\xA2").wstring_into(ws, cvt), bs::system_error);
+    BOOST_TEST(ws.empty());
+#endif
+}
+
 //  test_codecvt_argument  -----------------------------------------------------------//
 
 void test_codecvt_argument()
@@ -1189,6 +1364,8 @@ int test_main(int, char*[])
     test_decompositions();
     test_queries();
     test_imbue_locale();
+    test_utf8_conversion();
+    test_conversion_into();
     test_codecvt_argument();
     test_error_handling();
 
@@ -0,0 +1,216 @@
+//  path_view_test.cpp  ----------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/path_view.hpp>
+#include <boost/filesystem/path_arena.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+#define PATH_TEST_EQ(view, expected) BOOST_TEST_EQ(fs::path((view).native()), (expected))
+
+// Verifies that path_view decomposition matches v4 path decomposition
+void check_decomposition(fs::path const& p)
+{
+    const fs::path_view v(p);
+    BOOST_TEST_EQ(v.data(), p.c_str());
+    BOOST_TEST_EQ(v.size(), p.size());
+    BOOST_TEST_EQ(v.empty(), p.empty());
+
+    PATH_TEST_EQ(v.root_name(), p.root_name());
+    PATH_TEST_EQ(v.root_directory(), p.root_directory());
+    PATH_TEST_EQ(v.root_path(), p.root_path());
+    PATH_TEST_EQ(v.relative_path(), p.relative_path());
+    PATH_TEST_EQ(v.parent_path(), p.parent_path());
+    PATH_TEST_EQ(v.filename(), p.filename());
+    PATH_TEST_EQ(v.stem(), p.stem());
+    PATH_TEST_EQ(v.extension(), p.extension());
+
+    BOOST_TEST_EQ(v.has_root_name(), p.has_root_name());
+    BOOST_TEST_EQ(v.has_root_directory(), p.has_root_directory());
+    BOOST_TEST_EQ(v.has_root_path(), p.has_root_path());
+    BOOST_TEST_EQ(v.has_relative_path(), p.has_relative_path());
+    BOOST_TEST_EQ(v.has_parent_path(), p.has_parent_path());
+    BOOST_TEST_EQ(v.has_filename(), p.has_filename());
+    BOOST_TEST_EQ(v.has_stem(), p.has_stem());
+    BOOST_TEST_EQ(v.has_extension(), p.has_extension());
+    BOOST_TEST_EQ(v.is_absolute(), p.is_absolute());
+    BOOST_TEST_EQ(v.is_relative(), p.is_relative());
+    BOOST_TEST_EQ(v.filename_is_dot(), p.filename_is_dot());
+    BOOST_TEST_EQ(v.filename_is_dot_dot(), p.filename_is_dot_dot());
+
+    // Forward iteration
+    std::vector< fs::path > elements;
+    for (fs::path::iterator it = p.begin(), end = p.end(); it != end; ++it)
+        elements.push_back(*it);
+
+    std::size_t i = 0u;
+    for (fs::path_view::iterator it = v.begin(), end = v.end(); it != end; ++it, ++i)
+    {
+        if (BOOST_TEST_LT(i, elements.size()))
+            PATH_TEST_EQ(*it, elements[i]);
+    }
+    BOOST_TEST_EQ(i, elements.size());
+
+    // Backward iteration
+    elements.clear();
+    for (fs::path::iterator it = p.end(), begin = p.begin(); it != begin;)
+        elements.push_back(*--it);
+
+    i = 0u;
+    for (fs::path_view::iterator it = v.end(), begin = v.begin(); it != begin; ++i)
+    {
+        --it;
+        if (BOOST_TEST_LT(i, elements.size()))
+            PATH_TEST_EQ(*it, elements[i]);
+    }
+    BOOST_TEST_EQ(i, elements.size());
+}
+
+void decomposition_tests()
+{
+    const char* const paths[] =
+    {
+        "", ".", "..", "/", "//", "///", "foo", "foo/", "foo//", "/foo", "//foo", "///foo",
+        "foo/bar", "foo//bar", "/foo/bar/", "foo/.", "foo/..", "./foo", "../foo", "/.", "/..",
+        "foo.bar", ".bar", "foo.", "foo.bar.baz", "/foo/bar.baz", "foo/.bar", "foo/bar.",
+        "//net", "//net/", "//net/foo", "//net//foo/bar"
+#if defined(BOOST_WINDOWS_API)
+        , "c:", "c:/", "c:foo", "c:/foo", "c:\\foo\\bar.txt", "\\\\net\\foo", "\\\\?\\c:\\foo",
+        "\\??\\c:\\foo", "\\\\.\\c:", "c:..", "\\foo\\bar\\"
+#endif
+    };
+
+    for (std::size_t i = 0u; i < sizeof(paths) / sizeof(*paths); ++i)
+        check_decomposition(fs::path(paths[i]));
+}
+
+void construction_tests()
+{
+    const fs::path p("/foo/bar.baz");
+    const fs::path::string_type& s = p.native();
+
+    fs::path_view v1;
+    BOOST_TEST(v1.empty());
+    BOOST_TEST(v1.begin() == v1.end());
+
+    fs::path_view v2(s.c_str());
+    BOOST_TEST_EQ(v2.size(), s.size());
+
+    // Views need not be null-terminated
+    fs::path_view v3(s.c_str(), 4u);
+    BOOST_TEST(v3.native() == s.substr(0u, 4u));
+    BOOST_TEST(v3.filename().native() == s.substr(1u, 3u));
+
+    fs::path_view v4(s);
+    BOOST_TEST_EQ(v4.data(), s.c_str());
+    BOOST_TEST_EQ(v4.size(), s.size());
+
+    // Views are path sources
+    fs::path p2(v4);
+    BOOST_TEST_EQ(p2, p);
+    p2 = v3;
+    BOOST_TEST_EQ(p2, fs::path(s.substr(0u, 4u)));
+    p2 /= fs::path_view(p.filename().native());
+    BOOST_TEST_EQ(p2, fs::path("/foo/bar.baz"));
+}
+
+void comparison_tests()
+{
+    const fs::path a("/foo/bar"), b("/foo//bar"), c("/foo/baz"), d("/foo/bar/");
+
+    BOOST_TEST(fs::path_view(a) == fs::path_view(b));
+    BOOST_TEST(fs::path_view(a) != fs::path_view(c));
+    BOOST_TEST(fs::path_view(a) < fs::path_view(c));
+    BOOST_TEST(fs::path_view(c) > fs::path_view(a));
+    BOOST_TEST(fs::path_view(a) <= fs::path_view(b));
+    BOOST_TEST(fs::path_view(a) >= fs::path_view(b));
+    BOOST_TEST(fs::path_view(a) < fs::path_view(d));
+
+    BOOST_TEST(fs::path_view(a) == b);
+    BOOST_TEST(a == fs::path_view(b));
+    BOOST_TEST(a < fs::path_view(c));
+    BOOST_TEST(fs::path_view(c) > a);
+
+    // Results match path::compare
+    const fs::path paths[] = { a, b, c, d, fs::path(), fs::path("foo"), fs::path("/"), fs::path("/a"), fs::path("/foo/bar.") };
+    const std::size_t count = sizeof(paths) / sizeof(*paths);
+    for (std::size_t i = 0u; i < count; ++i)
+    {
+        for (std::size_t j = 0u; j < count; ++j)
+        {
+            const int expected = paths[i].compare(paths[j]);
+            const int result = fs::path_view(paths[i]).compare(fs::path_view(paths[j]));
+            BOOST_TEST_EQ(result < 0, expected < 0);
+            BOOST_TEST_EQ(result > 0, expected > 0);
+        }
+    }
+}
+
+void arena_tests()
+{
+    fs::path_arena arena(256u);
+    BOOST_TEST_EQ(arena.block_size(), 256u);
+    BOOST_TEST_EQ(arena.allocated_size(), 0u);
+
+    std::vector< fs::path > paths;
+    std::vector< fs::path_view > views;
+    for (unsigned int i = 0u; i < 100u; ++i)
+    {
+        fs::path p("/foo/bar");
+        p /= std::string(i % 7u + 1u, static_cast< char >('a' + i % 26u));
+        if (i % 10u == 0u)
+            p /= std::string(300u, 'x'); // longer than the block size
+        paths.push_back(p);
+        views.push_back(arena.store(p));
+    }
+
+    BOOST_TEST_GT(arena.allocated_size(), 0u);
+    for (std::size_t i = 0u; i < paths.size(); ++i)
+    {
+        BOOST_TEST(views[i].native() == paths[i].native());
+        BOOST_TEST_NE(views[i].data(), paths[i].c_str());
+        // Stored paths are null-terminated
+        BOOST_TEST_EQ(views[i].data()[views[i].size()], static_cast< fs::path::value_type >(0));
+    }
+
+    fs::path_view empty = arena.store(fs::path_view());
+    BOOST_TEST(empty.empty());
+    BOOST_TEST_EQ(empty.data()[0], static_cast< fs::path::value_type >(0));
+
+    arena.release();
+    BOOST_TEST_EQ(arena.allocated_size(), 0u);
+
+    // A zero block size results in a dedicated block for every path
+    fs::path_arena small_arena(0u);
+    fs::path_view v = small_arena.store(paths[1]);
+    BOOST_TEST(v.native() == paths[1].native());
+    v = small_arena.store(paths[2]);
+    BOOST_TEST(v.native() == paths[2].native());
+}
+
+} // namespace
+
+int main()
+{
+    decomposition_tests();
+    construction_tests();
+    comparison_tests();
+    arena_tests();
+
+    return boost::report_errors();
+}
@@ -0,0 +1,149 @@
+//  static_path_test.cpp  --------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/static_path.hpp>
+#include <boost/filesystem/path_view.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include <cstddef>
+#include <string>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+#define PATH_TEST_EQ(view, expected) BOOST_TEST_EQ(fs::path((view).native()), fs::path((expected).native()))
+
+// Verifies that the precomputed decomposition matches path_view decomposition
+void check_decomposition(fs::path const& p)
+{
+    const fs::static_path sp(p.c_str(), p.size());
+    const fs::path_view v(p);
+    BOOST_TEST_EQ(sp.data(), p.c_str());
+    BOOST_TEST_EQ(sp.size(), p.size());
+
+    PATH_TEST_EQ(sp.root_name(), v.root_name());
+    PATH_TEST_EQ(sp.root_directory(), v.root_directory());
+    PATH_TEST_EQ(sp.root_path(), v.root_path());
+    PATH_TEST_EQ(sp.relative_path(), v.relative_path());
+    PATH_TEST_EQ(sp.filename(), v.filename());
+    PATH_TEST_EQ(sp.stem(), v.stem());
+    PATH_TEST_EQ(sp.extension(), v.extension());
+
+    BOOST_TEST_EQ(sp.has_root_name(), v.has_root_name());
+    BOOST_TEST_EQ(sp.has_root_directory(), v.has_root_directory());
+    BOOST_TEST_EQ(sp.has_root_path(), v.has_root_path());
+    BOOST_TEST_EQ(sp.has_relative_path(), v.has_relative_path());
+    BOOST_TEST_EQ(sp.has_filename(), v.has_filename());
+    BOOST_TEST_EQ(sp.has_stem(), v.has_stem());
+    BOOST_TEST_EQ(sp.has_extension(), v.has_extension());
+    BOOST_TEST_EQ(sp.is_absolute(), v.is_absolute());
+    BOOST_TEST_EQ(sp.is_relative(), v.is_relative());
+    BOOST_TEST_EQ(sp.root_name_size(), v.root_name().size());
+
+    // Members that are not precomputed are inherited from path_view
+    PATH_TEST_EQ(sp.parent_path(), v.parent_path());
+}
+
+// Verifies that appending to a static_path produces the same result as appending to a path
+void check_append(fs::path const& lhs, fs::path const& rhs)
+{
+    const fs::static_path sp(lhs.c_str(), lhs.size());
+    fs::path expected(lhs);
+    expected /= rhs;
+    BOOST_TEST_EQ(sp / rhs, expected);
+    BOOST_TEST_EQ(sp / rhs.native(), expected);
+    BOOST_TEST_EQ(sp / rhs.c_str(), expected);
+}
+
+void test_decomposition()
+{
+    const char* const paths[] =
+    {
+        "", ".", "..", "/", "//", "///", "foo", "foo/", "/foo", "/foo/", "foo/bar", "/foo/bar", "foo//bar",
+        "//net", "//net/", "//net/foo", "///foo", "foo.txt", "foo.tar.gz", ".hidden", ".hidden.txt", "foo.", "foo/.",
+        "foo/..", "/foo/bar.baz/qux", "a.b/c"
+#ifdef BOOST_WINDOWS_API
+        , "c:", "c:foo", "c:/", "c:/foo", "c:\\foo\\bar.txt", "\\\\?\\c:\\foo", "\\\\.\\device", "\\??\\c:\\foo", "prn:", "\\\\net\\share"
+#endif
+    };
+
+    for (std::size_t i = 0u; i < sizeof(paths) / sizeof(*paths); ++i)
+        check_decomposition(fs::path(paths[i]));
+
+    // Conversion to path copies the characters
+    const fs::path source("/foo/bar");
+    const fs::static_path sp(source.c_str(), source.size());
+    BOOST_TEST_EQ(fs::path(sp), fs::path("/foo/bar"));
+    fs::path p;
+    p = sp;
+    BOOST_TEST_EQ(p, fs::path("/foo/bar"));
+}
+
+void test_append()
+{
+    const char* const lhs[] = { "", "foo", "foo/", "/foo", "/", "//net", "//net/foo", "foo/bar.txt"
+#ifdef BOOST_WINDOWS_API
+        , "c:", "c:foo", "c:/foo", "\\\\net\\share"
+#endif
+    };
+    const char* const rhs[] = { "", "bar", "/bar", "bar/baz", "//net", "//net/bar", "//other/bar", "."
+#ifdef BOOST_WINDOWS_API
+        , "c:", "c:bar", "c:/bar", "d:bar", "\\bar"
+#endif
+    };
+
+    for (std::size_t i = 0u; i < sizeof(lhs) / sizeof(*lhs); ++i)
+    {
+        for (std::size_t j = 0u; j < sizeof(rhs) / sizeof(*rhs); ++j)
+            check_append(fs::path(lhs[i]), fs::path(rhs[j]));
+    }
+}
+
+void test_constexpr()
+{
+#if !defined(BOOST_NO_CXX14_CONSTEXPR) && defined(BOOST_POSIX_API)
+    constexpr fs::static_path sp("/usr/lib/libfoo.so");
+    static_assert(sp.size() == 18u, "size");
+    static_assert(sp.has_root_directory() && !sp.has_root_name(), "root");
+    static_assert(sp.is_absolute(), "is_absolute");
+    static_assert(sp.relative_path().size() == 17u, "relative_path");
+    static_assert(sp.filename().size() == 9u, "filename");
+    static_assert(sp.stem().size() == 6u, "stem");
+    static_assert(sp.extension().size() == 3u, "extension");
+
+    constexpr fs::static_path net("//net/foo");
+    static_assert(net.root_name_size() == 5u, "root_name");
+    static_assert(net.filename().size() == 3u, "filename");
+
+    BOOST_TEST_EQ(fs::path(sp.filename().native()), fs::path("libfoo.so"));
+    BOOST_TEST_EQ(sp / "bar", fs::path("/usr/lib/libfoo.so/bar"));
+#endif
+
+#if !defined(BOOST_NO_CXX11_USER_DEFINED_LITERALS) && defined(BOOST_POSIX_API)
+    using namespace fs::literals;
+    const fs::static_path lit = "/etc/app.conf"_path;
+    BOOST_TEST_EQ(lit.size(), 13u);
+    BOOST_TEST_EQ(fs::path(lit.extension().native()), fs::path(".conf"));
+    BOOST_TEST_EQ(lit / "x", fs::path("/etc/app.conf") / "x");
+#endif
+}
+
+} // namespace
+
+int main()
+{
+    test_decomposition();
+    test_append();
+    test_constexpr();
+
+    return boost::report_errors();
+}
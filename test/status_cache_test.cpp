@@ -0,0 +1,90 @@
+//  status_cache_test.cpp  -------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/status_cache.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#include <boost/system/error_code.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+void test_caching(fs::path const& root)
+{
+    fs::status_cache cache;
+    BOOST_TEST(cache.ttl() == fs::status_cache::infinite_ttl);
+    BOOST_TEST_EQ(cache.size(), 0u);
+
+    const fs::path file = root / "file";
+    BOOST_TEST(cache.status(file).type() == fs::regular_file);
+    BOOST_TEST(cache.symlink_status(file).type() == fs::regular_file);
+    BOOST_TEST(cache.status(root).type() == fs::directory_file);
+    BOOST_TEST_EQ(cache.size(), 2u);
+
+    // Paths that differ in redundant separators share the cached status
+    BOOST_TEST(cache.status(fs::path(root.string() + "//file")).type() == fs::regular_file);
+    BOOST_TEST_EQ(cache.size(), 2u);
+
+    // The cached status is returned after the file is removed
+    fs::remove(file);
+    BOOST_TEST(cache.status(file).type() == fs::regular_file);
+
+    cache.invalidate(file);
+    BOOST_TEST_EQ(cache.size(), 1u);
+    boost::system::error_code ec;
+    BOOST_TEST(cache.status(file, ec).type() == fs::file_not_found);
+    fs::file_status uncached = fs::status(file, ec);
+    BOOST_TEST(uncached.type() == fs::file_not_found);
+
+    // Non-existing files are cached, along with the error code
+    create_file(file);
+    boost::system::error_code cached_ec;
+    BOOST_TEST(cache.status(file, cached_ec).type() == fs::file_not_found);
+    BOOST_TEST_EQ(cached_ec, ec);
+    BOOST_TEST(cache.status(file).type() == fs::file_not_found);
+
+    cache.clear();
+    BOOST_TEST_EQ(cache.size(), 0u);
+    BOOST_TEST(cache.status(file).type() == fs::regular_file);
+}
+
+void test_ttl(fs::path const& root)
+{
+    fs::status_cache cache(0u);
+    BOOST_TEST_EQ(cache.ttl(), 0u);
+
+    // With zero TTL, statuses expire immediately
+    const fs::path file = root / "ttl_file";
+    BOOST_TEST(cache.status(file).type() == fs::file_not_found);
+    create_file(file);
+    BOOST_TEST(cache.status(file).type() == fs::regular_file);
+    fs::remove(file);
+    BOOST_TEST(cache.status(file).type() == fs::file_not_found);
+}
+
+} // namespace
+
+int main()
+{
+    temp_test_directory temp_dir("status_cache_test");
+    const fs::path& root = temp_dir.path();
+    create_file(root / "file");
+
+    test_caching(root);
+    test_ttl(root);
+
+    return boost::report_errors();
+}
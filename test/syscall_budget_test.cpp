@@ -0,0 +1,244 @@
+//  syscall_budget_test.cpp  -----------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//  The test verifies the maximum number of system calls issued by the common operations, as reported by
+//  the instrumentation counters. The budgets are only checked if the library is built with instrumentation.
+
+#include <boost/filesystem/instrumentation.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#include <cstddef>
+#include <string>
+#include <boost/cstdint.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+//! Number of files in the large directory
+const unsigned int file_count = 300u;
+
+boost::uint64_t stat_calls(fs::instrumentation_snapshot const& snapshot)
+{
+    return snapshot[fs::instrumented_operation::stat].calls + snapshot[fs::instrumented_operation::statx].calls;
+}
+
+boost::uint64_t calls(fs::instrumentation_snapshot const& snapshot, unsigned int op)
+{
+    return snapshot.operations[op].calls;
+}
+
+fs::instrumentation_snapshot take_snapshot()
+{
+    fs::instrumentation_snapshot snapshot;
+    fs::get_instrumentation_snapshot(snapshot);
+    return snapshot;
+}
+
+std::string file_name(unsigned int i)
+{
+    std::string name("f");
+    for (unsigned int j = 0u; j < 4u; ++j, i /= 10u)
+        name.push_back(static_cast< char >('0' + i % 10u));
+    return name;
+}
+
+void create_files(fs::path const& dir, unsigned int count)
+{
+    fs::create_directory(dir);
+    for (unsigned int i = 0u; i < count; ++i)
+        fs::ofstream file(dir / file_name(i));
+}
+
+//! Creates a binary tree of directories of the given depth, each containing 2 files, and returns the number of directories
+unsigned int create_tree(fs::path const& root, unsigned int depth)
+{
+    create_files(root, 2u);
+    unsigned int dir_count = 1u;
+    if (depth > 0u)
+    {
+        dir_count += create_tree(root / "a", depth - 1u);
+        dir_count += create_tree(root / "b", depth - 1u);
+    }
+    return dir_count;
+}
+
+void test_directory_iteration(fs::path const& dir)
+{
+    fs::set_directory_iterator_buffer_size(4096u);
+    const std::size_t buffer_size = fs::directory_iterator_buffer_size();
+
+    fs::reset_instrumentation();
+    unsigned int n = 0u, regular_files = 0u;
+    for (fs::directory_iterator it(dir), end; it != end; ++it)
+    {
+        ++n;
+        if (fs::is_regular_file(*it) && !fs::is_symlink(*it))
+        {
+            ++regular_files;
+            // On POSIX systems the inode number is provided in d_ino, on Windows in the file id
+            BOOST_TEST_NE(it->inode(), 0u);
+        }
+    }
+    fs::instrumentation_snapshot snapshot = take_snapshot();
+
+    BOOST_TEST_EQ(n, file_count);
+    BOOST_TEST_EQ(regular_files, file_count);
+    BOOST_TEST_EQ(calls(snapshot, fs::instrumented_operation::open_directory), 1u);
+
+#if defined(__linux__)
+    // The file types are provided in d_type and the inode numbers in d_ino, no stat calls are needed to query them
+    BOOST_TEST_EQ(stat_calls(snapshot), 0u);
+
+    const boost::uint64_t getdents_calls = calls(snapshot, fs::instrumented_operation::getdents);
+    if (getdents_calls > 0u)
+    {
+        // Every linux_dirent64 record for the file names used in the test, as well as for dot and dot-dot, takes at most 32 bytes.
+        // Every read fills a batch, and one more read detects the end of the directory.
+        const std::size_t batch_size = buffer_size / 32u;
+        const std::size_t max_reads = (file_count + 2u + batch_size - 1u) / batch_size + 1u;
+        BOOST_TEST_GE(getdents_calls, 2u);
+        BOOST_TEST_LE(getdents_calls, max_reads);
+        BOOST_TEST_EQ(calls(snapshot, fs::instrumented_operation::readdir), 0u);
+    }
+#else
+    (void)buffer_size;
+#endif
+
+    fs::set_directory_iterator_buffer_size(0u);
+}
+
+void test_recursive_iteration(fs::path const& root, unsigned int dir_count)
+{
+    fs::reset_instrumentation();
+    unsigned int n = 0u, dirs = 0u;
+    for (fs::recursive_directory_iterator it(root), end; it != end; ++it)
+    {
+        ++n;
+        if (fs::is_directory(*it))
+            ++dirs;
+    }
+    fs::instrumentation_snapshot snapshot = take_snapshot();
+
+    BOOST_TEST_EQ(n, dir_count * 3u - 1u);
+    BOOST_TEST_EQ(dirs, dir_count - 1u);
+    // Every directory is opened exactly once
+    BOOST_TEST_EQ(calls(snapshot, fs::instrumented_operation::open_directory), dir_count);
+#if defined(__linux__)
+    // Descending into subdirectories only requires the file types from d_type
+    BOOST_TEST_EQ(stat_calls(snapshot), 0u);
+#endif
+}
+
+void test_single_file_operations(fs::path const& root)
+{
+    const fs::path file = root / "file";
+    {
+        fs::ofstream f(file);
+        f << "abc";
+    }
+
+    fs::reset_instrumentation();
+    BOOST_TEST(fs::exists(file));
+    fs::instrumentation_snapshot snapshot = take_snapshot();
+    BOOST_TEST_EQ(stat_calls(snapshot), 1u);
+
+    fs::reset_instrumentation();
+    BOOST_TEST(fs::is_regular_file(file));
+    BOOST_TEST_EQ(fs::file_size(file), 3u);
+    snapshot = take_snapshot();
+    BOOST_TEST_EQ(stat_calls(snapshot), 2u);
+
+    fs::create_directory(root / "empty");
+    fs::reset_instrumentation();
+    BOOST_TEST(fs::is_empty(root / "empty"));
+    snapshot = take_snapshot();
+    BOOST_TEST_LE(stat_calls(snapshot), 1u);
+    BOOST_TEST_EQ(calls(snapshot, fs::instrumented_operation::open_directory), 1u);
+#if defined(__linux__)
+    BOOST_TEST_LE(calls(snapshot, fs::instrumented_operation::getdents) + calls(snapshot, fs::instrumented_operation::readdir), 3u);
+#endif
+
+    // Small files are copied with a single read and write, without selecting the copying method for the filesystem
+    fs::reset_instrumentation();
+    BOOST_TEST(fs::copy_file(file, root / "copy"));
+    snapshot = take_snapshot();
+    BOOST_TEST_EQ(calls(snapshot, fs::instrumented_operation::copy_read_write), 1u);
+    BOOST_TEST_EQ(calls(snapshot, fs::instrumented_operation::copy_file_range), 0u);
+    BOOST_TEST_EQ(calls(snapshot, fs::instrumented_operation::copy_sendfile), 0u);
+    BOOST_TEST_EQ(fs::file_size(root / "copy"), 3u);
+    fs::remove(root / "copy");
+
+    fs::reset_instrumentation();
+    BOOST_TEST(fs::remove(file));
+    snapshot = take_snapshot();
+    BOOST_TEST_LE(stat_calls(snapshot), 1u);
+    BOOST_TEST_EQ(calls(snapshot, fs::instrumented_operation::unlink), 1u);
+}
+
+void test_remove_all(fs::path const& dir, fs::path const& tree, unsigned int dir_count)
+{
+    fs::reset_instrumentation();
+    BOOST_TEST_EQ(fs::remove_all(dir), static_cast< boost::uintmax_t >(file_count + 1u));
+    fs::instrumentation_snapshot snapshot = take_snapshot();
+
+    // One unlink per file plus one for the directory itself, and the file types come from the directory listing
+    BOOST_TEST_EQ(calls(snapshot, fs::instrumented_operation::unlink), file_count + 1u);
+    BOOST_TEST_EQ(calls(snapshot, fs::instrumented_operation::open_directory), 1u);
+#if defined(__linux__)
+    BOOST_TEST_LE(stat_calls(snapshot), 1u);
+#endif
+
+    fs::reset_instrumentation();
+    BOOST_TEST_EQ(fs::remove_all(tree), static_cast< boost::uintmax_t >(dir_count * 3u));
+    snapshot = take_snapshot();
+
+    BOOST_TEST_EQ(calls(snapshot, fs::instrumented_operation::unlink), dir_count * 3u);
+    BOOST_TEST_EQ(calls(snapshot, fs::instrumented_operation::open_directory), dir_count);
+#if defined(__linux__)
+    BOOST_TEST_LE(stat_calls(snapshot), 1u);
+#endif
+}
+
+} // namespace
+
+int main()
+{
+    if (!fs::instrumentation_enabled())
+        return 0;
+
+    temp_test_directory temp_dir("syscall_budget_test");
+    const fs::path& root = temp_dir.path();
+
+    try
+    {
+        const fs::path dir = root / "files";
+        create_files(dir, file_count);
+        const fs::path tree = root / "tree";
+        const unsigned int dir_count = create_tree(tree, 2u);
+
+        test_directory_iteration(dir);
+        test_recursive_iteration(tree, dir_count);
+        test_single_file_operations(root);
+        test_remove_all(dir, tree, dir_count);
+    }
+    catch (...)
+    {
+        fs::set_directory_iterator_buffer_size(0u);
+        throw;
+    }
+
+    return boost::report_errors();
+}
@@ -0,0 +1,68 @@
+//  temp_directory.hpp  ----------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#ifndef BOOST_FILESYSTEM_TEST_TEMP_DIRECTORY_HPP
+#define BOOST_FILESYSTEM_TEST_TEMP_DIRECTORY_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/config.hpp>
+#include <cstddef>
+#include <string>
+
+//------------------------------------------------------------------------------------//
+//                                                                                    //
+//                            class temp_test_directory                               //
+//                                                                                    //
+//  Creates a uniquely named directory in the temporary directory and removes it      //
+//  with all its contents on destruction. The name is "boost_fs_<name>-XXXX-XXXX".    //
+//                                                                                    //
+//------------------------------------------------------------------------------------//
+
+class temp_test_directory
+{
+private:
+    boost::filesystem::path m_path;
+
+public:
+    explicit temp_test_directory(const char* name) :
+        m_path(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path(std::string("boost_fs_") + name + "-%%%%-%%%%"))
+    {
+        boost::filesystem::create_directory(m_path);
+    }
+
+    ~temp_test_directory()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(m_path, ec);
+    }
+
+    BOOST_DELETED_FUNCTION(temp_test_directory(temp_test_directory const&))
+    BOOST_DELETED_FUNCTION(temp_test_directory& operator=(temp_test_directory const&))
+
+    boost::filesystem::path const& path() const BOOST_NOEXCEPT { return m_path; }
+};
+
+//! Creates a file with the given contents, a one-byte file by default
+inline void create_file(boost::filesystem::path const& p, std::string const& contents = std::string("x"))
+{
+    boost::filesystem::ofstream file(p, std::ios_base::out | std::ios_base::binary);
+    file << contents;
+}
+
+//! Creates a file of the given size
+inline void create_file_of_size(boost::filesystem::path const& p, std::size_t size)
+{
+    create_file(p, std::string(size, 'x'));
+}
+
+#endif // BOOST_FILESYSTEM_TEST_TEMP_DIRECTORY_HPP
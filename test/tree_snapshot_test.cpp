@@ -0,0 +1,230 @@
+//  tree_snapshot_test.cpp  ------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/tree_snapshot.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#include <cstddef>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <boost/system/error_code.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+const fs::tree_change* find_change(std::vector< fs::tree_change > const& changes, fs::path const& p)
+{
+    for (std::size_t i = 0u, n = changes.size(); i < n; ++i)
+    {
+        if (changes[i].relative_path == p)
+            return &changes[i];
+    }
+
+    return NULL;
+}
+
+void create_tree(fs::path const& root)
+{
+    fs::create_directories(root / "a" / "b");
+    fs::create_directory(root / "c");
+    create_file(root / "file1", "abc");
+    create_file(root / "a" / "file2", "defgh");
+    create_file(root / "a" / "b" / "file3", "");
+    create_file(root / "c" / "file4", "xyz");
+}
+
+void test_build(fs::path const& root)
+{
+    const fs::path tree = root / "build";
+    create_tree(tree);
+
+    fs::tree_snapshot snapshot;
+    BOOST_TEST(snapshot.empty());
+
+    snapshot.build(tree);
+    BOOST_TEST_EQ(snapshot.size(), 8u);
+
+    // The root directory is recorded with an empty path, and the entries are sorted
+    BOOST_TEST(snapshot[0].relative_path().empty());
+    BOOST_TEST_EQ(snapshot[0].type(), fs::directory_file);
+    for (std::size_t i = 1u; i < snapshot.size(); ++i)
+        BOOST_TEST(snapshot[i - 1u].relative_path().native() < snapshot[i].relative_path().native());
+
+    std::size_t pos = snapshot.find(fs::path("a") / "file2");
+    BOOST_TEST_NE(pos, fs::tree_snapshot::npos);
+    if (pos != fs::tree_snapshot::npos)
+    {
+        fs::tree_snapshot_entry e = snapshot[pos];
+        BOOST_TEST_EQ(e.type(), fs::regular_file);
+        BOOST_TEST_EQ(e.size(), 5u);
+        BOOST_TEST(e.last_write_time() == fs::precise_last_write_time(tree / "a" / "file2"));
+    }
+
+    pos = snapshot.find(fs::path("a") / "b");
+    BOOST_TEST_NE(pos, fs::tree_snapshot::npos);
+    if (pos != fs::tree_snapshot::npos)
+        BOOST_TEST_EQ(snapshot[pos].type(), fs::directory_file);
+
+    BOOST_TEST_EQ(snapshot.find(fs::path("missing")), fs::tree_snapshot::npos);
+
+    // Comparing a snapshot with itself produces no changes
+    BOOST_TEST(fs::diff(snapshot, snapshot).empty());
+
+    boost::system::error_code ec;
+    snapshot.build(root / "missing", fs::snapshot_options::none, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST_EQ(snapshot.size(), 8u);
+    BOOST_TEST_THROWS(snapshot.build(tree / "file1"), fs::filesystem_error);
+}
+
+void test_diff(fs::path const& root)
+{
+    const fs::path tree = root / "diff";
+    create_tree(tree);
+
+    fs::tree_snapshot before;
+    before.build(tree);
+
+    create_file(tree / "a" / "new_file", "new");
+    fs::remove(tree / "c" / "file4");
+    fs::remove(tree / "c");
+    create_file(tree / "file1", "modified contents");
+
+    fs::tree_snapshot after;
+    after.build(tree);
+
+    std::vector< fs::tree_change > changes = fs::diff(before, after);
+    BOOST_TEST_EQ(changes.size(), 4u);
+
+    const fs::tree_change* change = find_change(changes, fs::path("a") / "new_file");
+    BOOST_TEST(change != NULL && change->kind == fs::tree_change_kind::added && change->type == fs::regular_file);
+    change = find_change(changes, fs::path("c"));
+    BOOST_TEST(change != NULL && change->kind == fs::tree_change_kind::removed && change->type == fs::directory_file);
+    change = find_change(changes, fs::path("c") / "file4");
+    BOOST_TEST(change != NULL && change->kind == fs::tree_change_kind::removed);
+    change = find_change(changes, fs::path("file1"));
+    BOOST_TEST(change != NULL && change->kind == fs::tree_change_kind::modified);
+}
+
+void test_update(fs::path const& root)
+{
+    const fs::path tree = root / "update";
+    create_tree(tree);
+
+    // Make the directories look old enough to be trusted
+    const std::time_t old_time = std::time(NULL) - 3600;
+    fs::last_write_time(tree / "a", old_time);
+    fs::last_write_time(tree / "a" / "b", old_time);
+    fs::last_write_time(tree / "c", old_time);
+    fs::last_write_time(tree, old_time);
+
+    fs::tree_snapshot snapshot;
+    snapshot.build(tree);
+
+    fs::tree_snapshot before;
+    before.build(tree);
+
+    // Modify a file without changing the directory listing and add a file
+    create_file(tree / "a" / "file2", "modified contents");
+    create_file(tree / "a" / "b" / "new_file", "new");
+
+    snapshot.update(tree);
+    std::vector< fs::tree_change > changes = fs::diff(before, snapshot);
+    BOOST_TEST_EQ(changes.size(), 2u);
+    const fs::tree_change* change = find_change(changes, fs::path("a") / "file2");
+    BOOST_TEST(change != NULL && change->kind == fs::tree_change_kind::modified);
+    change = find_change(changes, fs::path("a") / "b" / "new_file");
+    BOOST_TEST(change != NULL && change->kind == fs::tree_change_kind::added);
+
+    // Updating without changes produces the same snapshot
+    fs::tree_snapshot updated;
+    updated.build(tree);
+    updated.update(tree);
+    BOOST_TEST(fs::diff(snapshot, updated).empty());
+
+    // With skip_unchanged_files, files in unchanged directories are not queried
+    fs::last_write_time(tree / "a" / "b", old_time);
+    updated.build(tree);
+    create_file(tree / "a" / "b" / "file3", "modified contents");
+    updated.update(tree, fs::snapshot_options::skip_unchanged_files);
+    BOOST_TEST(find_change(fs::diff(snapshot, updated), fs::path("a") / "b" / "file3") == NULL);
+
+    updated.update(tree);
+    changes = fs::diff(snapshot, updated);
+    change = find_change(changes, fs::path("a") / "b" / "file3");
+    BOOST_TEST(change != NULL && change->kind == fs::tree_change_kind::modified);
+}
+
+void test_save_load(fs::path const& root)
+{
+    const fs::path tree = root / "save";
+    create_tree(tree);
+
+    fs::tree_snapshot snapshot;
+    snapshot.build(tree);
+    snapshot.save(root / "snapshot.bin");
+    BOOST_TEST_EQ(fs::file_size(root / "snapshot.bin"), snapshot.data_size());
+
+    fs::tree_snapshot loaded;
+    loaded.load(root / "snapshot.bin");
+    BOOST_TEST_EQ(loaded.size(), snapshot.size());
+    BOOST_TEST_EQ(loaded.creation_time_ns(), snapshot.creation_time_ns());
+    BOOST_TEST(fs::diff(snapshot, loaded).empty());
+    BOOST_TEST_NE(loaded.find(fs::path("c") / "file4"), fs::tree_snapshot::npos);
+
+    // A loaded snapshot can be updated
+    create_file(tree / "c" / "new_file", "new");
+    loaded.update(tree);
+    std::vector< fs::tree_change > changes = fs::diff(snapshot, loaded);
+    const fs::tree_change* change = find_change(changes, fs::path("c") / "new_file");
+    BOOST_TEST(change != NULL && change->kind == fs::tree_change_kind::added);
+
+    // Empty snapshots can be saved and loaded
+    fs::tree_snapshot empty;
+    empty.save(root / "empty.bin");
+    loaded.load(root / "empty.bin");
+    BOOST_TEST(loaded.empty());
+
+    // Invalid images are rejected
+    create_file(root / "invalid.bin", "not a snapshot");
+    boost::system::error_code ec;
+    snapshot.load(root / "invalid.bin", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(!snapshot.empty());
+    BOOST_TEST_THROWS(snapshot.load(root / "missing.bin"), fs::filesystem_error);
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    fs::tree_snapshot moved(static_cast< fs::tree_snapshot&& >(snapshot));
+    BOOST_TEST(snapshot.empty());
+    BOOST_TEST_EQ(moved.size(), 8u);
+#endif
+}
+
+} // namespace
+
+int main()
+{
+    temp_test_directory temp_dir("tree_snapshot_test");
+    const fs::path& root = temp_dir.path();
+
+    test_build(root);
+    test_diff(root);
+    test_update(root);
+    test_save_load(root);
+
+    return boost::report_errors();
+}
@@ -0,0 +1,206 @@
+//  unique_file_test.cpp  --------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/unique_file.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#include <cstddef>
+#include <string>
+#include <iterator>
+#include <boost/system/error_code.hpp>
+
+#if defined(BOOST_POSIX_API)
+#include <unistd.h>
+#else
+#include <windows.h>
+#endif
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+//! Writes a string to the file
+bool write_string(fs::unique_file const& file, std::string const& str)
+{
+#if defined(BOOST_POSIX_API)
+    return ::write(file.native_handle(), str.data(), str.size()) == static_cast< ssize_t >(str.size());
+#else
+    DWORD written = 0u;
+    return ::WriteFile(file.native_handle(), str.data(), static_cast< DWORD >(str.size()), &written, NULL) && written == str.size();
+#endif
+}
+
+std::string load_file(fs::path const& p)
+{
+    fs::ifstream file(p, std::ios_base::in | std::ios_base::binary);
+    return std::string(std::istreambuf_iterator< char >(file), std::istreambuf_iterator< char >());
+}
+
+std::size_t count_entries(fs::path const& dir)
+{
+    std::size_t count = 0u;
+    for (fs::directory_iterator it(dir), end; it != end; ++it)
+        ++count;
+    return count;
+}
+
+void test_named_files(fs::path const& root)
+{
+    fs::unique_file empty;
+    BOOST_TEST(!empty.is_open());
+    BOOST_TEST(empty.path().empty());
+
+    fs::path name;
+    {
+        fs::unique_file file(root / "file-%%%%-%%%%");
+        BOOST_TEST(file.is_open());
+        BOOST_TEST(!file.is_anonymous());
+        BOOST_TEST(!file.is_removed_on_close());
+        BOOST_TEST(fs::is_regular_file(file.path()));
+        BOOST_TEST(write_string(file, "test"));
+        name = file.path();
+    }
+    BOOST_TEST_EQ(load_file(name), std::string("test"));
+
+    // Files created from the same model get different names
+    fs::unique_file file1(root / "%%%%%%%%%%%%%%%%"), file2(root / "%%%%%%%%%%%%%%%%");
+    BOOST_TEST(file1.path() != file2.path());
+
+    // A model without placeholders only succeeds once
+    boost::system::error_code ec;
+    fs::unique_file fixed(name, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(!fixed.is_open());
+    BOOST_TEST_THROWS(fs::unique_file(root / "missing" / "%%%%"), fs::filesystem_error);
+
+    // When all names are taken, the creation fails after a number of attempts
+    for (unsigned int i = 0u; i < 16u; ++i)
+        fs::ofstream(root / fs::path(std::string("x") + "0123456789abcdef"[i]));
+    fs::unique_file exhausted(root / "x%", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(!exhausted.is_open());
+
+    fs::path removed;
+    {
+        fs::unique_file file(root / "removed-%%%%-%%%%", fs::unique_file_flags::remove_on_close);
+        BOOST_TEST(file.is_removed_on_close());
+        removed = file.path();
+        BOOST_TEST(fs::exists(removed));
+    }
+    BOOST_TEST(!fs::exists(removed));
+
+    // Linking a named file renames it and keeps it on close
+    {
+        fs::unique_file file(root / "linked-%%%%-%%%%", fs::unique_file_flags::remove_on_close);
+        const fs::path old_name = file.path();
+        BOOST_TEST(write_string(file, "linked"));
+        file.link(root / "linked");
+        BOOST_TEST_EQ(file.path(), root / "linked");
+        BOOST_TEST(!file.is_removed_on_close());
+        BOOST_TEST(!fs::exists(old_name));
+
+        // Linking to an existing file fails
+        file.link(name, ec);
+        BOOST_TEST(!!ec);
+        BOOST_TEST_EQ(file.path(), root / "linked");
+    }
+    BOOST_TEST_EQ(load_file(root / "linked"), std::string("linked"));
+
+    // Released files are not removed
+    {
+        fs::unique_file file(root / "released-%%%%", fs::unique_file_flags::remove_on_close);
+        removed = file.path();
+        fs::unique_file::native_handle_type h = file.release();
+        BOOST_TEST(!file.is_open());
+#if defined(BOOST_POSIX_API)
+        ::close(h);
+#else
+        ::CloseHandle(h);
+#endif
+    }
+    BOOST_TEST(fs::exists(removed));
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    {
+        fs::unique_file file = fs::create_unique_file(root / "moved-%%%%", fs::unique_file_flags::remove_on_close);
+        removed = file.path();
+        fs::unique_file moved(static_cast< fs::unique_file&& >(file));
+        BOOST_TEST(!file.is_open());
+        BOOST_TEST(moved.is_open());
+        BOOST_TEST_EQ(moved.path(), removed);
+    }
+    BOOST_TEST(!fs::exists(removed));
+#endif
+}
+
+void test_anonymous_files(fs::path const& root)
+{
+    fs::create_directory(root / "anon");
+    const std::size_t count = count_entries(root / "anon");
+    {
+        fs::unique_file file(root / "anon" / "tmp-%%%%-%%%%", fs::unique_file_flags::anonymous);
+        BOOST_TEST(file.is_open());
+        BOOST_TEST(file.is_removed_on_close());
+        if (file.is_anonymous())
+        {
+            BOOST_TEST(file.path().empty());
+            BOOST_TEST_EQ(count_entries(root / "anon"), count);
+        }
+        BOOST_TEST(write_string(file, "anonymous"));
+    }
+    BOOST_TEST_EQ(count_entries(root / "anon"), count);
+
+    {
+        fs::unique_file file(root / "anon" / "tmp-%%%%-%%%%", fs::unique_file_flags::anonymous);
+        BOOST_TEST(write_string(file, "anonymous"));
+        boost::system::error_code ec;
+        file.link(root / "anon" / "named", ec);
+        BOOST_TEST(!ec);
+        BOOST_TEST(!file.is_anonymous());
+        BOOST_TEST_EQ(file.path(), root / "anon" / "named");
+    }
+    BOOST_TEST_EQ(count_entries(root / "anon"), count + 1u);
+    BOOST_TEST_EQ(load_file(root / "anon" / "named"), std::string("anonymous"));
+}
+
+void test_unique_directories(fs::path const& root)
+{
+    const fs::path dir1 = fs::create_unique_directory(root / "dir-%%%%-%%%%");
+    const fs::path dir2 = fs::create_unique_directory(root / "dir-%%%%-%%%%");
+    BOOST_TEST(dir1 != dir2);
+    BOOST_TEST(fs::is_directory(dir1));
+    BOOST_TEST(fs::is_directory(dir2));
+
+    boost::system::error_code ec;
+    const fs::path fixed = fs::create_unique_directory(dir1, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(fixed.empty());
+    BOOST_TEST_THROWS(fs::create_unique_directory(root / "missing" / "%%%%"), fs::filesystem_error);
+}
+
+} // namespace
+
+int main()
+{
+    temp_test_directory temp_dir("unique_file_test");
+    const fs::path& root = temp_dir.path();
+
+    test_named_files(root);
+    test_anonymous_files(root);
+    test_unique_directories(root);
+
+    return boost::report_errors();
+}
@@ -0,0 +1,117 @@
+//  volume_handle_test.cpp  ------------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/volume_handle.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#include <boost/system/error_code.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+void test_open(fs::path const& root)
+{
+    fs::volume_handle empty;
+    BOOST_TEST(!empty.is_open());
+    BOOST_TEST_EQ(empty.max_staleness(), 0u);
+
+    boost::system::error_code ec;
+    fs::space_info info = empty.space(ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST_EQ(info.capacity, static_cast< boost::uintmax_t >(-1));
+    BOOST_TEST_THROWS(empty.space(), fs::filesystem_error);
+
+    fs::volume_handle missing(root / "missing", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(!missing.is_open());
+    BOOST_TEST_THROWS(fs::volume_handle(root / "missing"), fs::filesystem_error);
+
+    // Both directories and files can be opened
+    fs::volume_handle dir(root);
+    BOOST_TEST(dir.is_open());
+    fs::volume_handle file(root / "file", 1000u);
+    BOOST_TEST(file.is_open());
+    BOOST_TEST_EQ(file.max_staleness(), 1000u);
+
+    swap(dir, file);
+    BOOST_TEST_EQ(dir.max_staleness(), 1000u);
+    BOOST_TEST_EQ(file.max_staleness(), 0u);
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    fs::volume_handle moved(static_cast< fs::volume_handle&& >(dir));
+    BOOST_TEST(!dir.is_open());
+    BOOST_TEST(moved.is_open());
+    BOOST_TEST_EQ(moved.max_staleness(), 1000u);
+#endif
+
+    file.close();
+    BOOST_TEST(!file.is_open());
+    file.open(root, ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST(file.is_open());
+}
+
+void test_space(fs::path const& root)
+{
+    const fs::space_info expected = fs::space(root);
+
+    fs::volume_handle dir(root);
+    boost::system::error_code ec;
+    fs::space_info info = dir.space(ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST_EQ(info.capacity, expected.capacity);
+    BOOST_TEST(info.free <= info.capacity);
+    BOOST_TEST(info.available <= info.free);
+
+    fs::volume_handle file(root / "file");
+    BOOST_TEST_EQ(file.space().capacity, expected.capacity);
+
+    // Cached results are reused until they expire or are invalidated
+    fs::volume_handle cached(root, 3600000u);
+    info = cached.space();
+    BOOST_TEST_EQ(info.capacity, expected.capacity);
+    {
+        fs::ofstream f(root / "file2");
+        f << "more data";
+    }
+    fs::space_info cached_info = cached.space();
+    BOOST_TEST_EQ(cached_info.capacity, info.capacity);
+    BOOST_TEST_EQ(cached_info.free, info.free);
+    BOOST_TEST_EQ(cached_info.available, info.available);
+
+    cached.invalidate();
+    info = cached.space(ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST_EQ(info.capacity, expected.capacity);
+}
+
+} // namespace
+
+int main()
+{
+    temp_test_directory temp_dir("volume_handle_test");
+    const fs::path& root = temp_dir.path();
+
+    {
+        fs::ofstream file(root / "file");
+        file << "test";
+    }
+
+    test_open(root);
+    test_space(root);
+
+    return boost::report_errors();
+}
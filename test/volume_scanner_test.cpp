@@ -0,0 +1,143 @@
+//  volume_scanner_test.cpp  -----------------------------------------------------------//
+
+//  Copyright 2026 agent
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/filesystem/volume_scanner.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <boost/core/lightweight_test.hpp>
+
+#include "temp_directory.hpp"
+
+#include <cstddef>
+#include <vector>
+#include <boost/system/error_code.hpp>
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+void test_closed(fs::path const& root)
+{
+    fs::volume_scanner empty;
+    BOOST_TEST(!empty.is_open());
+    BOOST_TEST(empty.volume_path().empty());
+    BOOST_TEST_EQ(empty.next_usn(), 0u);
+
+    std::vector< fs::volume_record > records;
+    boost::system::error_code ec;
+    BOOST_TEST_EQ(empty.scan(records, ec), 0u);
+    BOOST_TEST(!!ec);
+    BOOST_TEST_EQ(empty.read_changes(records, ec), 0u);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(empty.full_path(fs::identity(root), ec).empty());
+    BOOST_TEST(!!ec);
+    BOOST_TEST_THROWS(empty.scan(records), fs::filesystem_error);
+    BOOST_TEST(records.empty());
+
+    fs::volume_scanner missing(root / "missing" / "file", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(!missing.is_open());
+}
+
+#if defined(BOOST_WINDOWS_API)
+
+//! Returns the index of the record of \a id, or \c records.size() if not found
+std::size_t find_record(std::vector< fs::volume_record > const& records, fs::file_identity const& id)
+{
+    std::size_t i = 0u;
+    for (std::size_t n = records.size(); i < n; ++i)
+    {
+        if (records[i].id == id)
+            break;
+    }
+    return i;
+}
+
+void test_scan(fs::path const& root)
+{
+    // Opening a volume requires administrative privileges and a filesystem with the MFT
+    boost::system::error_code ec;
+    fs::volume_scanner scanner(root, ec);
+    if (ec)
+        return;
+
+    BOOST_TEST(scanner.is_open());
+    BOOST_TEST(!scanner.volume_path().empty());
+
+    const fs::file_identity dir_id = fs::identity(root / "dir");
+    const fs::file_identity file_id = fs::identity(root / "dir" / "file");
+
+    std::vector< fs::volume_record > records;
+    while (scanner.scan(records) > 0u)
+    {
+    }
+
+    const std::size_t file_pos = find_record(records, file_id);
+    BOOST_TEST_LT(file_pos, records.size());
+    if (file_pos < records.size())
+    {
+        BOOST_TEST_EQ(records[file_pos].name, fs::path("file"));
+        BOOST_TEST(records[file_pos].parent_id == dir_id);
+        BOOST_TEST_EQ(records[file_pos].type, fs::regular_file);
+        BOOST_TEST_EQ(records[file_pos].reason, 0u);
+    }
+
+    const std::size_t dir_pos = find_record(records, dir_id);
+    BOOST_TEST_LT(dir_pos, records.size());
+    if (dir_pos < records.size())
+        BOOST_TEST_EQ(records[dir_pos].type, fs::directory_file);
+
+    BOOST_TEST(fs::equivalent(scanner.full_path(file_id), root / "dir" / "file"));
+    BOOST_TEST_EQ(scanner.scan(records), 0u);
+
+    // Changes made after the volume was opened are read from the journal and update the index
+    fs::rename(root / "dir" / "file", root / "dir" / "renamed");
+    records.clear();
+    while (scanner.read_changes(records, ec) > 0u)
+    {
+    }
+
+    if (!ec)
+    {
+        BOOST_TEST_LT(find_record(records, file_id), records.size());
+        BOOST_TEST(fs::equivalent(scanner.full_path(file_id), root / "dir" / "renamed"));
+    }
+}
+
+#endif // defined(BOOST_WINDOWS_API)
+
+} // namespace
+
+int main()
+{
+    temp_test_directory temp_dir("volume_scanner_test");
+    const fs::path& root = temp_dir.path();
+
+    fs::create_directory(root / "dir");
+    {
+        fs::ofstream file(root / "dir" / "file");
+        file << "test";
+    }
+
+    test_closed(root);
+#if defined(BOOST_WINDOWS_API)
+    test_scan(root);
+#else
+    // The volume metadata is only available on Windows
+    boost::system::error_code ec;
+    fs::volume_scanner scanner(root, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(!scanner.is_open());
+    BOOST_TEST_THROWS(scanner.open(root), fs::filesystem_error);
+#endif
+
+    return boost::report_errors();
+}